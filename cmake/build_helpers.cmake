@@ -65,6 +65,25 @@ macro(findLibraries)
     else()
         set(MAGIC_INCLUDE_DIRS ${MAGIC_INCLUDEDIR})
     endif()
+
+    find_package(ZLIB REQUIRED)
+
+    # xz and zstd support for compressed files is optional
+    pkg_search_module(LZMA liblzma)
+    if(LZMA_FOUND)
+        set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -DIMHEX_LZMA_SUPPORT")
+    endif()
+
+    pkg_search_module(ZSTD libzstd)
+    if(ZSTD_FOUND)
+        set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -DIMHEX_ZSTD_SUPPORT")
+    endif()
+
+    # LZ4 is used by the data processor's decompression nodes and the compressed data search
+    pkg_search_module(LZ4 liblz4)
+    if(LZ4_FOUND)
+        set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -DIMHEX_LZ4_SUPPORT")
+    endif()
 endmacro()
 
 # Detect current OS / System
@@ -217,16 +236,32 @@ macro(createPackage)
         endif ()
     endif ()
 
-    # Compile the imhex-specific magicdb
-    add_custom_target(magic_dbs ALL
-            SOURCES ${MAGICDBS}
-            )
-    add_custom_command(TARGET magic_dbs
-            COMMAND file -C -m ${CMAKE_SOURCE_DIR}/magic_dbs
-            )
+    # Compile the imhex-specific magicdb so it doesn't get parsed again every time ImHex loads it. It only gets rebuilt when one of its sources changed
+    # and is copied into a magic folder next to the executable as well, which is where it gets looked for when running from the build directory
+    option(IMHEX_COMPILE_MAGICDBS "Compile the magic databases at build time" ON)
+    find_program(FILE_EXECUTABLE file)
+
+    if (IMHEX_COMPILE_MAGICDBS AND FILE_EXECUTABLE)
+        add_custom_command(OUTPUT ${CMAKE_CURRENT_BINARY_DIR}/magic_dbs.mgc
+                COMMAND ${FILE_EXECUTABLE} -C -m ${CMAKE_SOURCE_DIR}/magic_dbs
+                COMMAND ${CMAKE_COMMAND} -E make_directory ${CMAKE_CURRENT_BINARY_DIR}/magic
+                COMMAND ${CMAKE_COMMAND} -E copy ${CMAKE_CURRENT_BINARY_DIR}/magic_dbs.mgc ${CMAKE_CURRENT_BINARY_DIR}/magic/imhex.mgc
+                WORKING_DIRECTORY ${CMAKE_CURRENT_BINARY_DIR}
+                DEPENDS ${MAGICDBS}
+                COMMENT "Compiling magic databases"
+                )
+        add_custom_target(magic_dbs ALL
+                DEPENDS ${CMAKE_CURRENT_BINARY_DIR}/magic_dbs.mgc
+                SOURCES ${MAGICDBS}
+                )
 
-    # Install the magicdb files.
-    install(FILES ${CMAKE_CURRENT_BINARY_DIR}/magic_dbs.mgc DESTINATION ${MAGIC_INSTALL_LOCATION} RENAME imhex.mgc)
+        # Install the magicdb files.
+        install(FILES ${CMAKE_CURRENT_BINARY_DIR}/magic_dbs.mgc DESTINATION ${MAGIC_INSTALL_LOCATION} RENAME imhex.mgc)
+    else ()
+        # libmagic can load the sources as well, it just has to parse them every time
+        message(STATUS "Not compiling the magic databases, installing their sources instead")
+        install(FILES ${MAGICDBS} DESTINATION ${MAGIC_INSTALL_LOCATION})
+    endif ()
 
     if (CREATE_BUNDLE)
         include(PostprocessBundle)
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <functional>
+#include <string>
 
 #include <imgui.h>
 
@@ -14,9 +15,14 @@ namespace ImGui {
 
     void Disabled(const std::function<void()> &widgets, bool disabled);
     void TextSpinner(const char* label);
+    bool IsAnimationActive();
 
     void Header(const char *label, bool firstEntry = false);
 
+    /* Text fields that grow their string as needed instead of being limited to a fixed size buffer */
+    bool InputText(const char* label, std::string &buffer, ImGuiInputTextFlags flags = ImGuiInputTextFlags_None);
+    bool InputTextMultiline(const char* label, std::string &buffer, const ImVec2& size = ImVec2(0, 0), ImGuiInputTextFlags flags = ImGuiInputTextFlags_None);
+
     enum ImGuiCustomCol {
         ImGuiCustomCol_DescButton,
         ImGuiCustomCol_DescButtonHovered,
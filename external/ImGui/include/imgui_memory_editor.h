@@ -50,6 +50,8 @@
 
 #include <hex/views/view.hpp>
 
+#include <imgui_internal.h>
+
 #include <string>
 
 #ifdef _MSC_VER
@@ -91,7 +93,9 @@ struct MemoryEditor
     bool            OptShowAscii;                               // = true   // display ASCII representation on the right side.
     bool            OptShowAdvancedDecoding;                    // = true   // display advanced decoding data on the right side.
     bool            OptGreyOutZeroes;                           // = true   // display null/zero bytes using the TextDisabled color.
+    bool            OptDrawGrid;                                // = false  // hand the hex cells to GridFn instead of drawing them as text.
     bool            OptUpperCaseHex;                            // = true   // display hexadecimal values as "FF" instead of "ff".
+    bool            ScrollToEnd;                                // = false  // scroll to the last line on the next frame, gets reset once done.
     int             OptMidColsCount;                            // = 8      // set to 0 to disable extra spacing between every mid-cols.
     int             OptAddrDigitsCount;                         // = 0      // number of addr digits to display (default calculated based on maximum displayed addr).
     ImU32           HighlightColor;                             //          // background color of highlighted bytes.
@@ -100,6 +104,25 @@ struct MemoryEditor
     bool            (*HighlightFn)(const ImU8* data, size_t off, bool next);//= 0      // optional handler to return Highlight property (to support non-contiguous highlighting).
     void            (*HoverFn)(const ImU8 *data, size_t off);
     DecodeData      (*DecodeFn)(const ImU8 *data, size_t off);
+    void            (*PrefetchFn)(const ImU8 *data, size_t off, size_t size); // = 0  // optional handler called once per frame with the visible range before any ReadFn call.
+    float           MinimapWidth;                               // = 0      // width of the column right of the scrolling region that MinimapFn draws into.
+    void            (*MinimapFn)(const ImU8 *data, size_t visible_start, size_t visible_end, ImVec2 size); // = 0  // optional handler drawing an overview of the data next to the scrolling region.
+
+    // Hex cells of the visible lines, handed to GridFn instead of being drawn as text. Glyphs holds the two characters to show (7 bits each),
+    // whether they use the disabled color (bit 14) and how wide the highlight is (bits 15-16: two glyphs, one cell, one cell and the mid-cols spacing)
+    struct GridCell
+    {
+        ImU32   Glyphs;
+        ImU32   HighlightColor;     // 0 if not highlighted
+        int     PosX, PosY;         // screen position, in whole pixels like text
+    };
+    struct GridData
+    {
+        ImU32   TextColor, DisabledColor;
+        float   GlyphWidth, CellWidth, MidColsSpacing, LineHeight;
+        ImVector<GridCell> Cells;
+    };
+    void            (*GridFn)(const ImU8 *data, ImDrawList *draw_list, const GridData &grid); // = 0  // optional handler drawing all hex cells at once, ImGui then only handles interacting with them.
 
     // [Internal State]
     bool            ContentsWidthChanged;
@@ -115,6 +138,14 @@ struct MemoryEditor
     size_t          HighlightMin, HighlightMax;
     int             PreviewEndianess;
     ImGuiDataType   PreviewDataType;
+    GridData        Grid;
+
+    // Virtual scrolling. ImGui's float scroll positions can't tell the lines of large data apart anymore, so the first visible line is kept
+    // as a 64-bit line number and only how far it's scrolled out of view is a float
+    size_t          ScrollLine;
+    float           ScrollLineOffset;   // [0, LineHeight)
+    size_t          VisibleLineCount;   // lines that fully fit into the scrolling region, as of the last frame
+    float           PendingScroll;      // pixels to scroll by at the end of the frame
 
     MemoryEditor()
     {
@@ -126,7 +157,9 @@ struct MemoryEditor
         OptShowAscii = true;
         OptShowAdvancedDecoding = true;
         OptGreyOutZeroes = true;
+        OptDrawGrid = false;
         OptUpperCaseHex = true;
+        ScrollToEnd = false;
         OptMidColsCount = 8;
         OptAddrDigitsCount = 0;
         HighlightColor = IM_COL32(255, 255, 255, 50);
@@ -135,6 +168,10 @@ struct MemoryEditor
         HighlightFn = NULL;
         HoverFn = NULL;
         DecodeFn = NULL;
+        PrefetchFn = NULL;
+        MinimapWidth = 0.0f;
+        MinimapFn = NULL;
+        GridFn = NULL;
 
         // State/Internals
         ContentsWidthChanged = false;
@@ -147,6 +184,41 @@ struct MemoryEditor
         HighlightMin = HighlightMax = (size_t)-1;
         PreviewEndianess = 0;
         PreviewDataType = ImGuiDataType_S32;
+        ScrollLine = 0;
+        ScrollLineOffset = 0.0f;
+        VisibleLineCount = 0;
+        PendingScroll = 0.0f;
+    }
+
+    size_t GetMaxScrollLine(size_t line_total_count) const
+    {
+        return line_total_count > VisibleLineCount ? line_total_count - VisibleLineCount : 0;
+    }
+
+    void ScrollToLine(size_t line, size_t line_total_count)
+    {
+        ScrollLine = std::min(line, GetMaxScrollLine(line_total_count));
+        ScrollLineOffset = 0.0f;
+    }
+
+    // Scrolls by whole lines first so the float only ever has to hold less than a line
+    void ScrollBy(float pixels, float line_height, size_t line_total_count)
+    {
+        float position = ScrollLineOffset + pixels;
+        s64 lines = (s64)floorf(position / line_height);
+
+        if (lines < 0 && (size_t)-lines > ScrollLine)
+        {
+            ScrollLine = 0;
+            ScrollLineOffset = 0.0f;
+            return;
+        }
+
+        ScrollLine += lines;
+        ScrollLineOffset = position - lines * line_height;
+
+        if (ScrollLine >= GetMaxScrollLine(line_total_count))
+            ScrollToLine(ScrollLine, line_total_count);
     }
 
     void GotoAddrAndHighlight(size_t addr_min, size_t addr_max)
@@ -211,6 +283,8 @@ struct MemoryEditor
             s.PosDecodingEnd = s.PosDecodingStart + Cols * s.GlyphWidth;
         }
         s.WindowWidth = s.PosAsciiEnd + style.ScrollbarSize + style.WindowPadding.x * 2 + s.GlyphWidth;
+        if (MinimapFn && MinimapWidth > 0)
+            s.WindowWidth += MinimapWidth + style.ItemSpacing.x;
     }
 
     // Standalone Memory Editor window
@@ -223,7 +297,8 @@ struct MemoryEditor
         {
             if (DataPreviewAddr != DataPreviewAddrOld || DataPreviewAddrEnd != DataPreviewAddrEndOld) {
                 hex::Region selectionRegion = { std::min(DataPreviewAddr, DataPreviewAddrEnd), std::max(DataPreviewAddr, DataPreviewAddrEnd) - std::min(DataPreviewAddr, DataPreviewAddrEnd) };
-                hex::View::postEvent(hex::Events::RegionSelected, selectionRegion);
+                // While a selection is being dragged, views only get told about it once it stopped changing for a moment
+                hex::View::postEventCoalesced(hex::Events::RegionSelected, selectionRegion, ImGui::IsMouseDown(ImGuiMouseButton_Left) ? std::chrono::milliseconds(100) : std::chrono::milliseconds(0));
             }
 
             DataPreviewAddrOld = DataPreviewAddr;
@@ -269,24 +344,52 @@ struct MemoryEditor
         }
         ImGui::EndChild();
 
-        ImGui::BeginChild("##scrolling", ImVec2(0, -footer_height), false, ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoNav);
+        const bool show_minimap = MinimapFn && MinimapWidth > 0;
+        ImGui::BeginChild("##scrolling", ImVec2(show_minimap ? -(MinimapWidth + style.ItemSpacing.x) : 0, -footer_height), false, ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoNav | ImGuiWindowFlags_NoScrollbar | ImGuiWindowFlags_NoScrollWithMouse);
 
         ImGui::PushStyleVar(ImGuiStyleVar_FramePadding, ImVec2(0, 0));
         ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(0, 0));
 
 
 
-        // We are not really using the clipper API correctly here, because we rely on visible_start_addr/visible_end_addr for our scrolling function.
-        ImGuiListClipper clipper;
+        // Only the visible lines exist as far as ImGui is concerned, scrolling through them is done here instead of by ImGui
         ImDrawList* draw_list = ImGui::GetWindowDrawList();
+        ImGuiWindow* scrolling_window = ImGui::GetCurrentWindow();
 
-        const int line_total_count = (int)((mem_size + Cols - 1) / Cols);
-        clipper.Begin(line_total_count, s.LineHeight);
-        clipper.Step();
-        const size_t visible_start_addr = clipper.DisplayStart * Cols;
-        const size_t visible_end_addr = clipper.DisplayEnd * Cols;
+        const size_t line_total_count = (mem_size + Cols - 1) / Cols;
+        const float scrolling_height = ImGui::GetContentRegionAvail().y;
+        VisibleLineCount = (size_t)std::max(1.0f, floorf(scrolling_height / s.LineHeight));
+
+        if (ImGui::IsWindowHovered() && ImGui::GetIO().MouseWheel != 0.0f)
+            ScrollBy(-ImGui::GetIO().MouseWheel * ImFloor(ImMin(5 * s.LineHeight, scrolling_height * 0.67f)), s.LineHeight, line_total_count);
+        if (ScrollToEnd)
+        {
+            ScrollToLine(line_total_count, line_total_count);
+            ScrollToEnd = false;
+        }
+        if (ScrollLine > GetMaxScrollLine(line_total_count))
+            ScrollToLine(ScrollLine, line_total_count);
+
+        {
+            // The grab only needs to be as precise as a pixel, so handing the line numbers over as floats is good enough
+            const ImRect& inner_rect = scrolling_window->InnerRect;
+            ImRect scrollbar_rect(inner_rect.Max.x - style.ScrollbarSize, inner_rect.Min.y, inner_rect.Max.x, inner_rect.Max.y);
+            float scroll_position = (float)ScrollLine;
+            if (ImGui::ScrollbarEx(scrollbar_rect, ImGui::GetID("##virtual_scrollbar"), ImGuiAxis_Y, &scroll_position, (float)VisibleLineCount, (float)line_total_count, ImDrawCornerFlags_None))
+                ScrollToLine((size_t)std::max(0.0f, scroll_position), line_total_count);
+        }
+
+        const size_t line_start = ScrollLine;
+        const size_t line_end = std::min(line_total_count, line_start + VisibleLineCount + 2);
+        ImGui::SetCursorPosY(ImGui::GetCursorPosY() - ScrollLineOffset);
+
+        const size_t visible_start_addr = line_start * Cols;
+        const size_t visible_end_addr = line_end * Cols;
         const size_t visible_count = visible_end_addr - visible_start_addr;
 
+        if (PrefetchFn && visible_start_addr < mem_size)
+            PrefetchFn(mem_data, visible_start_addr, std::min(visible_end_addr, mem_size) - visible_start_addr);
+
         bool data_next = false;
 
         if (DataEditingAddr >= mem_size)
@@ -329,18 +432,18 @@ struct MemoryEditor
         if (data_preview_addr_next != (size_t)-1 && (data_preview_addr_next / Cols) != (data_preview_addr_backup / Cols))
         {
             // Track cursor movements
-            const int scroll_offset = ((int)(data_preview_addr_next / Cols) - (int)(data_preview_addr_backup / Cols));
+            const s64 scroll_offset = ((s64)(data_preview_addr_next / Cols) - (s64)(data_preview_addr_backup / Cols));
             const bool scroll_desired = (scroll_offset < 0 && data_preview_addr_next < visible_start_addr + Cols * 2) || (scroll_offset > 0 && data_preview_addr_next > visible_end_addr - Cols * 2);
             if (scroll_desired)
-                ImGui::SetScrollY(ImGui::GetScrollY() + scroll_offset * s.LineHeight);
+                PendingScroll += scroll_offset * s.LineHeight;
         }
         if (data_editing_addr_next != (size_t)-1 && (data_editing_addr_next / Cols) != (data_editing_addr_backup / Cols))
         {
             // Track cursor movements
-            const int scroll_offset = ((int)(data_editing_addr_next / Cols) - (int)(data_editing_addr_backup / Cols));
+            const s64 scroll_offset = ((s64)(data_editing_addr_next / Cols) - (s64)(data_editing_addr_backup / Cols));
             const bool scroll_desired = (scroll_offset < 0 && data_editing_addr_next < visible_start_addr + Cols * 2) || (scroll_offset > 0 && data_editing_addr_next > visible_end_addr - Cols * 2);
             if (scroll_desired)
-                ImGui::SetScrollY(ImGui::GetScrollY() + scroll_offset * s.LineHeight);
+                PendingScroll += scroll_offset * s.LineHeight;
         }
 
         // Draw vertical separator
@@ -358,10 +461,20 @@ struct MemoryEditor
         const char* format_byte = OptUpperCaseHex ? "%02X" : "%02x";
         const char* format_byte_space = OptUpperCaseHex ? "%02X " : "%02x ";
 
+        const bool draw_grid = OptDrawGrid && GridFn != NULL;
+        const float cell_item_width = ImGui::CalcTextSize("FF ").x;
+        Grid.Cells.resize(0);
+        Grid.TextColor = color_text;
+        Grid.DisabledColor = ImGui::GetColorU32(ImGuiCol_TextDisabled);
+        Grid.GlyphWidth = s.GlyphWidth;
+        Grid.CellWidth = s.HexCellWidth;
+        Grid.MidColsSpacing = s.SpacingBetweenMidCols;
+        Grid.LineHeight = s.LineHeight;
+
         bool tooltipShown = false;
-        for (int line_i = clipper.DisplayStart; line_i < clipper.DisplayEnd; line_i++) // display only visible lines
+        for (size_t line_i = line_start; line_i < line_end; line_i++) // display only visible lines
         {
-            size_t addr = (size_t)(line_i * Cols);
+            size_t addr = line_i * Cols;
             ImGui::Text(format_address, s.AddrDigitsCount, base_display_addr + addr);
 
             // Draw Hexadecimal
@@ -372,6 +485,16 @@ struct MemoryEditor
                     byte_pos_x += (float)(n / OptMidColsCount) * s.SpacingBetweenMidCols;
                 ImGui::SameLine(byte_pos_x);
 
+                // The input of the byte being edited is drawn by ImGui, the grid would end up on top of it
+                const bool is_grid_cell = draw_grid && DataEditingAddr != addr;
+                GridCell cell = { 0, 0, 0, 0 };
+                if (draw_grid)
+                {
+                    ImVec2 pos = ImGui::GetCursorScreenPos();
+                    cell.PosX = (int)floorf(pos.x);
+                    cell.PosY = (int)floorf(pos.y);
+                }
+
                 // Draw highlight
                 bool is_highlight_from_user_range = (addr >= HighlightMin && addr < HighlightMax);
                 bool is_highlight_from_user_func = (HighlightFn && HighlightFn(mem_data, addr, false));
@@ -380,6 +503,7 @@ struct MemoryEditor
                 {
                     ImVec2 pos = ImGui::GetCursorScreenPos();
                     float highlight_width = s.GlyphWidth * 2;
+                    ImU32 highlight_width_code = 0;
                     bool is_next_byte_highlighted = (addr + 1 < mem_size) &&
                                                     ((HighlightMax != (size_t)-1 && addr + 1 < HighlightMax) ||
                                                     (HighlightFn && HighlightFn(mem_data, addr + 1, true)) ||
@@ -387,15 +511,25 @@ struct MemoryEditor
                     if (is_next_byte_highlighted)
                     {
                         highlight_width = s.HexCellWidth;
+                        highlight_width_code = 1;
                         if (OptMidColsCount > 0 && n > 0 && (n + 1) < Cols && ((n + 1) % OptMidColsCount) == 0)
+                        {
                             highlight_width += s.SpacingBetweenMidCols;
+                            highlight_width_code = 2;
+                        }
                     }
 
                     ImU32 color = HighlightColor;
                     if ((is_highlight_from_user_range + is_highlight_from_user_func + is_highlight_from_preview) > 1)
                         color = (ImAlphaBlendColors(HighlightColor, 0x60C08080) & 0x00FFFFFF) | 0x90000000;
 
-                    draw_list->AddRectFilled(pos, ImVec2(pos.x + highlight_width, pos.y + s.LineHeight), color);
+                    if (is_grid_cell)
+                    {
+                        cell.HighlightColor = color;
+                        cell.Glyphs |= highlight_width_code << 15;
+                    }
+                    else
+                        draw_list->AddRectFilled(pos, ImVec2(pos.x + highlight_width, pos.y + s.LineHeight), color);
                 }
 
                 if (DataEditingAddr == addr)
@@ -462,7 +596,25 @@ struct MemoryEditor
                     // NB: The trailing space is not visible but ensure there's no gap that the mouse cannot click on.
                     ImU8 b = ReadFn ? ReadFn(mem_data, addr) : mem_data[addr];
 
-                    if (OptShowHexII)
+                    if (draw_grid)
+                    {
+                        // Same characters as the text below, without formatting or laying out any of them
+                        const char* digits = OptUpperCaseHex ? "0123456789ABCDEF" : "0123456789abcdef";
+                        ImU32 first = digits[b >> 4], second = digits[b & 0x0F], disabled = 0;
+
+                        if (OptShowHexII)
+                        {
+                            if (b >= 32 && b < 128)                     { first = '.'; second = b; }
+                            else if (b == 0xFF && OptGreyOutZeroes)     { first = second = '#'; disabled = 1; }
+                            else if (b == 0x00)                         { first = second = 0; }
+                        }
+                        else if (b == 0 && OptGreyOutZeroes)
+                            disabled = 1;
+
+                        cell.Glyphs |= (first & 0x7F) | ((second & 0x7F) << 7) | (disabled << 14);
+                        ImGui::Dummy(ImVec2(cell_item_width, s.LineHeight));
+                    }
+                    else if (OptShowHexII)
                     {
                         if ((b >= 32 && b < 128))
                             ImGui::Text(".%c ", b);
@@ -500,6 +652,9 @@ struct MemoryEditor
                         }
                     }
                 }
+
+                if (is_grid_cell && (cell.Glyphs != 0 || cell.HighlightColor != 0))
+                    Grid.Cells.push_back(cell);
             }
 
             if (OptShowAscii)
@@ -540,7 +695,7 @@ struct MemoryEditor
                     }
 
 
-                    ImGui::PushID(line_i * Cols + n);
+                    ImGui::PushID((int)(line_i * Cols + n));
                     ImGui::SameLine();
                     ImGui::Dummy(ImVec2(s.GlyphWidth, s.LineHeight));
 
@@ -612,7 +767,7 @@ struct MemoryEditor
                     }
 
 
-                    ImGui::PushID(line_i * Cols + n);
+                    ImGui::PushID((int)(line_i * Cols + n));
                     ImGui::SameLine();
                     ImGui::Dummy(ImVec2(glyphWidth, s.LineHeight));
 
@@ -645,11 +800,25 @@ struct MemoryEditor
                 }
             }
         }
-        IM_ASSERT(clipper.Step() == false);
-        clipper.End();
+        if (draw_grid && !Grid.Cells.empty())
+            GridFn(mem_data, draw_list, Grid);
+        if (PendingScroll != 0.0f)
+        {
+            // Cursor movements scroll once this frame is drawn, the lines above were laid out for the old position
+            ScrollBy(PendingScroll, s.LineHeight, line_total_count);
+            PendingScroll = 0.0f;
+        }
         ImGui::PopStyleVar(2);
         ImGui::EndChild();
 
+        if (show_minimap)
+        {
+            ImGui::SameLine();
+            ImGui::BeginChild("##minimap", ImVec2(MinimapWidth, -footer_height), false, ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoNav | ImGuiWindowFlags_NoScrollbar);
+            MinimapFn(mem_data, visible_start_addr, std::min(visible_end_addr, mem_size), ImGui::GetContentRegionAvail());
+            ImGui::EndChild();
+        }
+
         if (data_next && DataEditingAddr < mem_size)
         {
             DataEditingAddr = DataPreviewAddr = DataEditingAddr + 1;
@@ -712,9 +881,9 @@ struct MemoryEditor
         {
             if (GotoAddr < mem_size)
             {
-                ImGui::BeginChild("##scrolling");
-                ImGui::SetScrollFromPosY(ImGui::GetCursorStartPos().y + (GotoAddr / Cols) * ImGui::GetTextLineHeight());
-                ImGui::EndChild();
+                // The line ends up in the middle of the scrolling region
+                const size_t goto_line = GotoAddr / Cols;
+                ScrollToLine(goto_line > VisibleLineCount / 2 ? goto_line - VisibleLineCount / 2 : 0, (mem_size + Cols - 1) / Cols);
                 DataEditingAddr = DataPreviewAddr = HighlightMin;
                 DataPreviewAddrEnd = HighlightMax;
                 DataEditingTakeFocus = true;
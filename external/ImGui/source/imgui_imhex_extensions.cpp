@@ -153,10 +153,18 @@ namespace ImGui {
         }
     }
 
+    static int s_lastAnimationFrame = -1;
+
     void TextSpinner(const char* label) {
+        s_lastAnimationFrame = ImGui::GetFrameCount();
         ImGui::Text("[%c] %s", "|/-\\"[ImU32(ImGui::GetTime() * 20) % 4], label);
     }
 
+    // Whether something that has to move on its own got drawn this frame
+    bool IsAnimationActive() {
+        return s_lastAnimationFrame == ImGui::GetFrameCount();
+    }
+
     void Header(const char *label, bool firstEntry) {
         if (!firstEntry)
             ImGui::NewLine();
@@ -164,6 +172,25 @@ namespace ImGui {
         ImGui::Separator();
     }
 
+    static int UpdateStringSizeCallback(ImGuiInputTextCallbackData *data) {
+        if (data->EventFlag == ImGuiInputTextFlags_CallbackResize) {
+            auto &string = *static_cast<std::string*>(data->UserData);
+
+            string.resize(data->BufTextLen);
+            data->Buf = string.data();
+        }
+
+        return 0;
+    }
+
+    bool InputText(const char *label, std::string &buffer, ImGuiInputTextFlags flags) {
+        return ImGui::InputText(label, buffer.data(), buffer.size() + 1, ImGuiInputTextFlags_CallbackResize | flags, UpdateStringSizeCallback, &buffer);
+    }
+
+    bool InputTextMultiline(const char *label, std::string &buffer, const ImVec2 &size, ImGuiInputTextFlags flags) {
+        return ImGui::InputTextMultiline(label, buffer.data(), buffer.size() + 1, size, ImGuiInputTextFlags_CallbackResize | flags, UpdateStringSizeCallback, &buffer);
+    }
+
     ImU32 GetCustomColorU32(ImGuiCustomCol idx, float alpha_mul) {
         auto& customData = *static_cast<ImHexCustomData*>(GImGui->IO.UserData);
         ImVec4 c = customData.Colors[idx];
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <vector>
+
+namespace hex {
+
+    namespace lang { class PatternData; }
+
+    /* Providers and views of ImHex itself, the UI benchmark registers the same ones as the application */
+    void registerProviders();
+    void registerViews(std::vector<lang::PatternData*> &patternData);
+
+}
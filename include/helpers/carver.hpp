@@ -0,0 +1,44 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+namespace hex {
+
+    namespace prv { class Provider; }
+
+    /* A file found somewhere inside of the data. Only where it starts is known, not where it ends */
+    struct CarvedFile {
+        u64 address;
+        std::string signature;
+        std::string description;
+    };
+
+    /*
+        Finds files embedded at any offset in the data. The header signatures of all known formats get searched for in a
+        single parallel pass, libmagic then only has to look at the offsets they were found at to confirm and describe them
+    */
+    class Carver {
+    public:
+        Carver() = delete;
+
+        /* Files are sorted by address, which is absolute. Returns nothing if the run got cancelled */
+        static std::vector<CarvedFile> carve(prv::Provider *provider, const std::atomic<bool> &cancelled, std::atomic<u64> *processedBytes = nullptr);
+
+    private:
+        struct Signature {
+            const char *name;
+            std::vector<u8> bytes;
+            u64 offset;     // Of the signature from the start of the file
+        };
+
+        static const std::vector<Signature>& getSignatures();
+
+        // libmagic identifies nearly every format from its first few kilobytes, the rest of the data up to the next file is of no use to it
+        constexpr static size_t ConfirmationSize = 0x1'0000;
+    };
+
+}
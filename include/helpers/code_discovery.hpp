@@ -0,0 +1,50 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include "helpers/disassembler.hpp"
+
+#include <functional>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace hex::prv { class Provider; }
+
+namespace hex {
+
+    /*
+        Recursive descent disassembly. Starting from entry points it follows branches and calls instead of decoding the whole region,
+        so data mixed into the code doesn't get decoded as instructions. Addresses still to be decoded are spread over all cores,
+        idle workers steal them from the others. Bytes get claimed in a shared bitmap, so every instruction is only decoded once
+    */
+    class CodeDiscovery {
+    public:
+        CodeDiscovery() = delete;
+
+        struct Result {
+            /* One bit per byte of the region, set for the first byte of every instruction that was found */
+            std::vector<u64> instructionStarts;
+            /* One bit per byte of the region, set for every byte that's part of an instruction */
+            std::vector<u64> codeBytes;
+            u64 instructionCount = 0;
+
+            /* Target and source address of every direct branch and call that was found, unsorted */
+            std::vector<std::pair<u64, u64>> references;
+        };
+
+        /* Entry points are addresses, offsets into the region are at baseAddress. Nothing is returned once isCancelled returned true */
+        [[nodiscard]] static std::optional<Result> discover(prv::Provider *provider, cs_arch architecture, cs_mode mode, u64 regionStart, u64 regionSize, u64 baseAddress,
+                                                            const std::vector<u64> &entryPoints, u32 threadCount, const std::function<bool()> &isCancelled);
+
+        /* Target of a direct branch or call. Capstone already turns relative targets into absolute addresses. Needs instruction details */
+        [[nodiscard]] static std::optional<u64> getBranchTarget(csh capstoneHandle, cs_arch architecture, const cs_insn &instruction);
+
+        /* Whether execution never continues with the next instruction, apart from a delay slot. Needs instruction details */
+        [[nodiscard]] static bool endsBlock(csh capstoneHandle, cs_arch architecture, const cs_insn &instruction);
+
+        /* Offset of the first bit set at or after offset */
+        [[nodiscard]] static std::optional<u64> findNextSet(const std::vector<u64> &bitmap, u64 offset);
+    };
+
+}
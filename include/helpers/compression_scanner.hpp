@@ -0,0 +1,72 @@
+#pragma once
+
+#include <hex.hpp>
+#include <hex/helpers/utils.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <string_view>
+#include <vector>
+
+namespace hex {
+
+    namespace prv { class Provider; }
+
+    enum class CompressionFormat : u8 {
+        Zlib,
+        Gzip,
+        RawDeflate,
+        Xz,
+        Lzma,
+        Zstd,
+        LZ4
+    };
+
+    /* A stream that got decompressed successfully */
+    struct CompressedRegion {
+        u64 address;
+        u64 size;               // Compressed size. Streams that ran out of budget reach up to the end of the high entropy region they're in
+        u64 decompressedSize;   // As much as got decompressed, a lower bound if the stream didn't end
+        CompressionFormat format;
+        bool complete;          // Whether the end of the stream was reached and its checksum, if it has one, matched
+    };
+
+    /*
+        Tells compressed data apart from encrypted data, which have the same entropy, by trying to decompress it. Only the given regions
+        get looked at, meant to be the high entropy blocks of the data. Every offset in them with the header of a known format gets probed,
+        raw deflate has no header and gets probed at every offset near the start of a region instead, where the entropy rises.
+        Regions are split up into chunks handled by all task manager workers in parallel. Every probe stops as soon as the data fails to
+        decompress, random data does so within a few bytes, and no probe decompresses for longer than its time and size budget
+    */
+    class CompressionScanner {
+    public:
+        CompressionScanner() = delete;
+
+        /* Regions are sorted by address, which is absolute. Returns nothing if the run got cancelled */
+        static std::vector<CompressedRegion> scan(prv::Provider *provider, const std::vector<Region> &regions, const std::atomic<bool> &cancelled,
+                                                  std::atomic<u64> *processedBytes = nullptr);
+
+        [[nodiscard]] static std::string_view getFormatName(CompressionFormat format);
+
+        /* Compressed data usually starts somewhere in the block before the entropy rises, raw deflate gets probed at every offset this far into a region */
+        constexpr static size_t RawDeflateSearchSize = 0x1000;
+
+    private:
+        class Decoder;
+
+        constexpr static size_t ChunkSize = 0x40'0000;
+
+        /* Budget of every probe. Anything that decompresses this far without an error is confirmed, even if it didn't end yet */
+        constexpr static size_t ProbeOutputLimit = 0x100'0000;
+        constexpr static auto ProbeTimeLimit = std::chrono::milliseconds(20);
+
+        /* Random data with a valid header sometimes decodes to a few hundred bytes before failing, streams that end have to produce at least this much */
+        constexpr static size_t MinimumDecompressedSize = 0x40;
+        constexpr static size_t MinimumUncheckedSize = 0x100;
+        constexpr static size_t ConfirmedDecompressedSize = 0x4000;
+
+        static void scanChunk(prv::Provider *provider, Decoder &decoder, u64 address, size_t size, u64 regionEnd, bool regionStart,
+                              const std::atomic<bool> &cancelled, std::vector<CompressedRegion> &results);
+    };
+
+}
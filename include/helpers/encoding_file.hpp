@@ -2,18 +2,16 @@
 
 #include <hex.hpp>
 
+#include <array>
+#include <limits>
 #include <map>
+#include <optional>
+#include <span>
+#include <string>
 #include <vector>
 
 namespace hex {
 
-    template<typename T>
-    struct SizeSorter {
-        bool operator() (const T& lhs, const T& rhs) const {
-            return lhs.size() < rhs.size();
-        }
-    };
-
     class EncodingFile {
     public:
         enum class Type {
@@ -24,14 +22,41 @@ namespace hex {
         EncodingFile() = default;
         EncodingFile(Type type, std::string_view path);
 
-        std::pair<std::string_view, size_t> getEncodingFor(const std::vector<u8> &buffer) const;
+        /* Decodes the longest sequence the buffer starts with, unknown bytes decode to a single "." */
+        std::pair<std::string_view, size_t> getEncodingFor(std::span<const u8> buffer) const;
         size_t getLongestSequence() const { return this->m_longestSequence; }
 
+        /*
+            Decodes data that's handed over in pieces and appends it to result. Returns how many bytes got decoded, the remaining ones
+            may be the start of a sequence that continues in the next piece and have to be passed again. The last piece gets decoded fully
+        */
+        size_t decode(std::span<const u8> data, bool last, std::string &result) const;
+
+        /* Encodes text through the reverse table, longest match first. Nothing if some part of it has no encoding */
+        std::optional<std::vector<u8>> encode(std::string_view text) const;
+
     private:
         void parseThingyFile(std::ifstream &content);
+        void addMapping(const std::vector<u8> &from, std::string to);
 
-        std::map<u32, std::map<std::vector<u8>, std::string>> m_mapping;
+        constexpr static u32 NoValue = std::numeric_limits<u32>::max();
+
+        /* Follows the byte to the next node, 0 if no longer sequence starts with it. Value is the decoding of the sequence ending in the byte */
+        struct Transition {
+            u32 next = 0;
+            u32 value = NoValue;
+        };
+
+        /*
+            Byte trie of all sequences, the root is the first node. Only sequences that continue past a byte need a node of their own,
+            so tables made of mostly single and double byte sequences stay small
+        */
+        std::vector<std::array<Transition, 0x100>> m_trie;
+        std::vector<std::string> m_values;
         size_t m_longestSequence = 0;
+
+        std::map<std::string, std::vector<u8>, std::less<>> m_reverseMapping;
+        size_t m_longestValue = 0;
     };
 
 }
\ No newline at end of file
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+
+#if defined(OS_WINDOWS)
+#include <windows.h>
+#endif
+
+namespace hex {
+
+    /*
+        Watches a single file for changes made by anybody, including it being replaced by a new file of the same name.
+        inotify and ReadDirectoryChangesW watch the directory the file is in, other systems get the file's modification time polled.
+        The callback runs on the watcher's own thread, once as soon as the watch is in place and then every time the file stopped changing for a moment
+    */
+    class FileWatcher {
+    public:
+        FileWatcher(std::string path, std::function<void()> callback);
+        ~FileWatcher();
+
+        FileWatcher(const FileWatcher&) = delete;
+        FileWatcher& operator=(const FileWatcher&) = delete;
+
+    private:
+        /* Writers rarely finish in one go, the callback only runs once no more changes came in for this long */
+        constexpr static auto SettleTime = std::chrono::milliseconds(250);
+        constexpr static auto PollInterval = std::chrono::seconds(1);
+
+        enum class WaitResult { Changed, Settled, Stopped };
+
+        bool setup();
+        void cleanup();
+        WaitResult waitForChange(std::optional<std::chrono::milliseconds> timeout);
+        void run();
+
+        std::string m_path;
+        std::string m_fileName;
+        std::function<void()> m_callback;
+
+        #if defined(OS_WINDOWS)
+        HANDLE m_directory = INVALID_HANDLE_VALUE;
+        HANDLE m_stopEvent = nullptr;
+        OVERLAPPED m_overlapped = { };
+        bool m_readPending = false;
+        alignas(DWORD) u8 m_changes[0x1000] = { };
+        #elif defined(OS_LINUX)
+        int m_inotify = -1;
+        int m_stopPipe[2] = { -1, -1 };
+        #else
+        std::optional<std::pair<std::filesystem::file_time_type, std::uintmax_t>> m_lastState;
+        #endif
+
+        std::mutex m_stopMutex;
+        std::condition_variable m_stopSignal;
+        bool m_stop = false;
+        std::thread m_thread;
+    };
+
+}
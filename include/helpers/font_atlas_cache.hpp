@@ -0,0 +1,34 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <hex/helpers/analysis_cache.hpp>
+
+#include <imgui.h>
+
+#include <filesystem>
+#include <optional>
+
+namespace hex {
+
+    /*
+        Baked font atlases kept in the cache directory, so startup doesn't have to rasterize thousands of glyphs again.
+        Atlases are keyed by the font file, its size and the glyph ranges in it, changing any of them builds a new one
+    */
+    class FontAtlasCache {
+    public:
+        FontAtlasCache() = delete;
+
+        [[nodiscard]] static u64 getKey(const std::filesystem::path &fontPath, float fontSize, const ImVector<ImWchar> &ranges);
+
+        /* Texture and glyph metrics of all fonts in a built atlas */
+        [[nodiscard]] static AnalysisCache::Writer serialize(ImFontAtlas *atlas);
+
+        /* Replaces the fonts of the atlas with serialized ones, the atlas counts as built afterwards. Leaves the atlas empty if the data is broken */
+        static bool deserialize(ImFontAtlas *atlas, AnalysisCache::Reader &reader);
+
+        static void store(u64 key, const AnalysisCache::Writer &writer);
+        [[nodiscard]] static std::optional<AnalysisCache::Reader> load(u64 key);
+    };
+
+}
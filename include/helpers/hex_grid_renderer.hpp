@@ -0,0 +1,64 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <imgui.h>
+#include <imgui_memory_editor.h>
+
+namespace hex {
+
+    /*
+        Draws the hex cells of the memory editor with a single instanced draw call. The visible cells get uploaded into a small integer texture,
+        the shader looks up their glyphs in ImGui's font atlas and draws highlights and text together.
+        Drawing happens through a draw list callback, so it ends up in the same place ImGui would have drawn the text
+    */
+    class HexGridRenderer {
+    public:
+        HexGridRenderer() = default;
+        ~HexGridRenderer();
+
+        HexGridRenderer(const HexGridRenderer&) = delete;
+        HexGridRenderer& operator=(const HexGridRenderer&) = delete;
+
+        /* Builds the shaders on first use, false if the GPU can't draw the grid and the cells need to be drawn as text. Main thread only */
+        bool isSupported();
+
+        /* Uploads the cells and queues drawing them into the draw list */
+        void draw(ImDrawList *drawList, const MemoryEditor::GridData &grid);
+
+    private:
+        constexpr static u32 CellTextureWidth = 256;
+        constexpr static u32 GlyphCount = 128;
+
+        bool initialize();
+        void updateGlyphs();
+        void render(const ImDrawCmd *command);
+
+        static void renderCallback(const ImDrawList *drawList, const ImDrawCmd *command);
+
+        bool m_initialized = false;
+        bool m_failed = false;
+
+        u32 m_program = 0;
+        u32 m_vertexArray = 0;
+        u32 m_cellTexture = 0;
+        u32 m_cellTextureRows = 0;
+        u32 m_glyphTexture = 0;
+
+        struct {
+            s32 projection, cells, font, glyphs, cellSize, advance, textColor, disabledColor, highlightWidths;
+        } m_uniforms = { };
+
+        // Font the glyph table was built for
+        ImFont *m_font = nullptr;
+        float m_fontSize = 0;
+        ImTextureID m_fontTexture = nullptr;
+        float m_advance = 0;
+
+        u32 m_cellCount = 0;
+        ImVec4 m_textColor, m_disabledColor;
+        ImVec4 m_highlightWidths;
+        ImVec2 m_cellSize;
+    };
+
+}
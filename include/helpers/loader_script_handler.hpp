@@ -1,7 +1,13 @@
 #pragma once
 
+#include <hex.hpp>
+#include <hex/api/task.hpp>
+#include <hex/helpers/utils.hpp>
+
+#include <memory>
 #include <string>
 #include <string_view>
+#include <vector>
 
 struct _object;
 typedef struct _object PyObject;
@@ -10,24 +16,55 @@ namespace hex {
 
     namespace prv { class Provider; }
 
+    /*
+        Runs loader scripts on the task system, so long running scripts neither freeze the interface nor can't be stopped.
+        Patches and bookmarks of a script are collected while it runs and get applied together once it finished. Cancelling it discards them
+    */
     class LoaderScript {
     public:
         LoaderScript() = delete;
 
-        static bool processFile(std::string_view scriptPath);
+        /* Starts the script on the provider, does nothing if another one is still running. Main thread only */
+        static void processFile(std::string_view scriptPath, std::string_view filePath, std::shared_ptr<prv::Provider> provider);
+
+        [[nodiscard]] static bool isRunning() { return LoaderScript::s_task.isRunning(); }
 
-        static void setFilePath(std::string_view filePath) { LoaderScript::s_filePath = filePath; }
-        static void setDataProvider(prv::Provider* provider) { LoaderScript::s_dataProvider = provider; }
     private:
+        struct Patch {
+            u64 address;
+            std::vector<u8> bytes;
+        };
+
+        struct Bookmark {
+            Region region;
+            std::string name, comment;
+        };
+
+        static void run(Task &task, const std::string &scriptPath);
+        static void apply(std::shared_ptr<prv::Provider> provider, std::vector<Patch> &&patches, std::vector<Bookmark> &&bookmarks, std::string &&code);
+
+        static inline TaskHolder s_task;
+
+        // Only used by the task running the script
+        static inline Task *s_currentTask = nullptr;
         static inline std::string s_filePath;
-        static inline prv::Provider* s_dataProvider;
+        static inline std::shared_ptr<prv::Provider> s_dataProvider;
+        static inline std::vector<Patch> s_patches;
+        static inline std::vector<size_t> s_transactionStarts;
+        static inline std::vector<Bookmark> s_bookmarks;
 
         static PyObject* Py_getFilePath(PyObject *self, PyObject *args);
+        static PyObject* Py_getData(PyObject *self, PyObject *args);
         static PyObject* Py_addPatch(PyObject *self, PyObject *args);
+        static PyObject* Py_beginTransaction(PyObject *self, PyObject *args);
+        static PyObject* Py_commitTransaction(PyObject *self, PyObject *args);
+        static PyObject* Py_rollbackTransaction(PyObject *self, PyObject *args);
         static PyObject* Py_addBookmark(PyObject *self, PyObject *args);
+        static PyObject* Py_setProgress(PyObject *self, PyObject *args);
+        static PyObject* Py_isCancelled(PyObject *self, PyObject *args);
 
         static PyObject* Py_addStruct(PyObject *self, PyObject *args);
         static PyObject* Py_addUnion(PyObject *self, PyObject *args);
     };
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <memory>
+#include <mutex>
+#include <string>
+
+struct magic_set;
+
+namespace hex {
+
+    namespace prv { class Provider; }
+
+    /*
+        Runs libmagic over the start of the current page.
+        The magic databases are loaded once into a single cookie that's kept for the rest of the session, only its flags change between calls
+    */
+    class Magic {
+    public:
+        Magic() = delete;
+
+        static std::string identify(prv::Provider *provider, int flags);
+
+        /* Identifies data starting at an absolute address instead, looking at no more than size bytes of it */
+        static std::string identify(prv::Provider *provider, u64 address, size_t size, int flags);
+
+        /* False if no magic database could be found or loaded */
+        static bool hasDatabase();
+
+        /* Loads the databases right away so the first identification doesn't have to wait for it */
+        static void preload();
+
+        static std::string getDescription(prv::Provider *provider);
+        static std::string getMIMEType(prv::Provider *provider);
+
+    private:
+        struct CookieDeleter {
+            void operator()(magic_set *cookie) const;
+        };
+
+        using Cookie = std::unique_ptr<magic_set, CookieDeleter>;
+
+        static magic_set* getCookie(int flags);
+
+        static inline std::mutex s_mutex;
+        static inline Cookie s_cookie;
+        static inline bool s_loaded = false;
+    };
+
+}
\ No newline at end of file
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <hex/api/task.hpp>
+#include <hex/helpers/entropy.hpp>
+#include <hex/helpers/utils.hpp>
+
+#include <imgui.h>
+
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace hex::prv { class Provider; }
+
+namespace hex {
+
+    /*
+        Overview of all of the data, one row per slice of it showing its byte classes on the left and its entropy on the right.
+        Rows get counted in the background and end up in a texture, so drawing the minimap costs the same no matter how large the data is.
+        Edits only get their own rows recounted and uploaded again
+    */
+    class Minimap {
+    public:
+        constexpr static u32 MaxRowCount = 1024;
+        constexpr static size_t MinRowSize = 0x1000;
+
+        Minimap() = default;
+        ~Minimap();
+
+        Minimap(const Minimap&) = delete;
+        Minimap& operator=(const Minimap&) = delete;
+
+        /* Throws away all rows, they get counted again for the current provider on the next frame */
+        void reset();
+
+        /* Absolute region whose data changed */
+        void markChanged(Region region);
+
+        /*
+            Draws the minimap into the given size with the absolute visible region marked on it. Called on the main thread every frame.
+            Returns the absolute address that got clicked or dragged to
+        */
+        std::optional<u64> draw(ImVec2 size, Region visible);
+
+    private:
+        struct Rows {
+            size_t dataSize = 0;
+            size_t rowSize = 0;
+            std::vector<EntropyMap::Node> nodes;
+            std::vector<u32> pixels;    // Two per row, RGBA
+
+            // Rows that changed since the texture got last updated
+            u32 firstDirtyRow = 0, lastDirtyRow = 0;
+            bool dirty = false;
+        };
+
+        void startCounting(u32 firstRow, u32 lastRow);
+        void uploadRows();
+
+        static void colorRow(Rows &rows, u32 row);
+
+        std::mutex m_rowsMutex;
+        std::shared_ptr<Rows> m_rows;
+
+        std::mutex m_changesMutex;
+        std::vector<Region> m_changedRegions;
+        bool m_resetPending = true;
+
+        TaskHolder m_countingTask;
+
+        u32 m_texture = 0;
+        u32 m_textureRows = 0;
+    };
+
+}
@@ -2,16 +2,32 @@
 
 #include <hex.hpp>
 
-#include <map>
-#include <vector>
+#include <hex/providers/patch_store.hpp>
+
+#include <iosfwd>
+#include <optional>
+
+namespace hex::prv { class Provider; }
 
 namespace hex {
 
-    using Patches = std::map<u64, u8>;
+    enum class PatchFormat : u8 {
+        IPS,
+        IPS32,
+        UPS,
+        BPS
+    };
+
+    /*
+        Patches are streamed record by record, nothing but the records currently being worked on is kept in memory.
+        UPS and BPS patches describe the whole data and carry checksums, the provider supplies the unpatched data for them.
+        The provider is only read through readRaw, so both can run on a worker thread with a snapshot of the patches
+    */
+
+    /* Fails if the patches can't be represented in the format, such as addresses past what IPS can address */
+    bool writePatch(PatchFormat format, std::ostream &stream, prv::Provider *provider, const prv::PatchStore &patches);
 
-    std::vector<u8> generateIPSPatch(const Patches &patches);
-    std::vector<u8> generateIPS32Patch(const Patches &patches);
+    /* Fails on malformed patches and on UPS and BPS patches made for different data or resizing it */
+    std::optional<prv::PatchStore> readPatch(PatchFormat format, std::istream &stream, prv::Provider *provider);
 
-    Patches loadIPSPatch(const std::vector<u8> &ipsPatch);
-    Patches loadIPS32Patch(const std::vector<u8> &ipsPatch);
 }
\ No newline at end of file
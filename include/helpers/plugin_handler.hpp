@@ -6,23 +6,39 @@
 #include <hex/providers/provider.hpp>
 #include <hex/helpers/utils.hpp>
 
+#include <string>
 #include <string_view>
+#include <utility>
+#include <vector>
 #include <dlfcn.h>
 
 namespace hex {
 
+    /*
+        A plugin can come with a manifest next to it, named like the plugin with an added .json extension. It holds the
+        plugin's name, author and description, so they can be shown without opening the plugin. Plugins that only add data
+        processor nodes can be marked as lazy and list their nodes there, they then only get opened once one of them is used:
+        { "name": "...", "author": "...", "description": "...", "lazy": true, "nodes": [ { "category": "...", "name": "..." } ] }
+    */
     class Plugin {
     public:
-        Plugin(std::string_view path);
+        explicit Plugin(std::string_view path);
         Plugin(const Plugin&) = delete;
         Plugin(Plugin &&other) noexcept;
         ~Plugin();
 
+        /* Opens the plugin's library. Different plugins can be opened from different threads at the same time */
+        void load();
+        [[nodiscard]] bool isLoaded() const;
+        [[nodiscard]] bool isLazy() const;
+
         void initializePlugin() const;
         std::string getPluginName() const;
         std::string getPluginAuthor() const;
         std::string getPluginDescription() const;
 
+        /* Category and name of every node a lazy plugin adds */
+        [[nodiscard]] const std::vector<std::pair<std::string, std::string>>& getProvidedNodes() const;
 
     private:
         using InitializePluginFunc      = void(*)();
@@ -30,8 +46,13 @@ namespace hex {
         using GetPluginAuthorFunc       = const char*(*)();
         using GetPluginDescriptionFunc  = const char*(*)();
 
+        std::string m_path;
         void *m_handle = nullptr;
 
+        bool m_lazy = false;
+        std::string m_manifestName, m_manifestAuthor, m_manifestDescription;
+        std::vector<std::pair<std::string, std::string>> m_providedNodes;
+
         InitializePluginFunc m_initializePluginFunction             = nullptr;
         GetPluginNameFunc m_getPluginNameFunction                   = nullptr;
         GetPluginAuthorFunc m_getPluginAuthorFunction               = nullptr;
@@ -48,15 +69,25 @@ namespace hex {
     public:
         PluginHandler() = delete;
 
+        /* Opens all plugins in the folder that aren't lazy, in parallel */
         static void load(std::string_view pluginFolder);
         static void unload();
         static void reload();
 
+        /*
+            Runs the initialization functions of the opened plugins one after another, they all add to the same unsynchronized
+            registries. Lazy plugins get placeholders for their nodes instead, which open and initialize the plugin when used.
+            Placeholders get replaced while they run, so callers have to call a copy of the creator function
+        */
+        static void initializePlugins();
+
         static const auto& getPlugins() {
             return PluginHandler::s_plugins;
         }
 
     private:
+        static bool loadLazyPlugin(size_t index);
+
         static inline std::string s_pluginFolder;
         static inline std::vector<Plugin> s_plugins;
     };
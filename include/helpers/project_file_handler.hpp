@@ -1,14 +1,25 @@
 #pragma once
 
+#include <chrono>
 #include <list>
+#include <map>
+#include <optional>
 #include <string>
 #include <string_view>
+#include <vector>
 
-#include "patches.hpp"
 #include <hex/api/imhex_api.hpp>
+#include <hex/api/task.hpp>
+#include <hex/providers/patch_store.hpp>
 
 namespace hex {
 
+    /*
+        Projects are stored in a binary container made of typed sections. Saving writes every section once, edits made
+        afterwards get appended to the file by autosave() as records describing only the changed sections and regions.
+        Loading only indexes the sections, their content gets read once something asks for it.
+        Older JSON projects can still be loaded, they get converted the next time the project is saved
+    */
     class ProjectFile {
     public:
         ProjectFile() = delete;
@@ -16,30 +27,72 @@ namespace hex {
         static bool load(std::string_view filePath);
         static bool store(std::string_view filePath = "");
 
+        /*
+            Called every frame, once the autosave interval passed it collects the current project state and appends what
+            changed to the project file on a background task
+        */
+        static void autosave();
+
+        /* Drops everything autosave() appended since the project was last loaded or saved */
+        static void discardAutosave();
+
         [[nodiscard]] static bool hasUnsavedChanges()       { return ProjectFile::s_hasUnsavedChanged; }
         static void markDirty()                             { if (!ProjectFile::s_currProjectFilePath.empty()) ProjectFile::s_hasUnsavedChanged = true; }
 
         [[nodiscard]] static std::string getProjectFilePath() { return ProjectFile::s_currProjectFilePath; }
 
-        [[nodiscard]] static std::string getFilePath()      { return ProjectFile::s_filePath; }
-        static void setFilePath(std::string_view filePath)  { ProjectFile::s_hasUnsavedChanged = true; ProjectFile::s_filePath = filePath; }
+        [[nodiscard]] static std::string getFilePath();
+        static void setFilePath(std::string_view filePath);
 
-        [[nodiscard]] static std::string getPattern()       { return ProjectFile::s_pattern; }
-        static void setPattern(std::string_view pattern)    { ProjectFile::s_hasUnsavedChanged = true; ProjectFile::s_pattern = pattern; }
+        [[nodiscard]] static std::string getPattern();
+        static void setPattern(std::string_view pattern);
 
-        [[nodiscard]] static const Patches& getPatches()    { return ProjectFile::s_patches; }
-        static void setPatches(const Patches &patches)      { ProjectFile::s_hasUnsavedChanged = true; ProjectFile::s_patches = patches; }
+        [[nodiscard]] static const prv::PatchStore& getPatches();
+        static void setPatches(const prv::PatchStore &patches);
 
-        [[nodiscard]] static const std::list<ImHexApi::Bookmarks::Entry>& getBookmarks()  { return ProjectFile::s_bookmarks; }
-        static void setBookmarks(const std::list<ImHexApi::Bookmarks::Entry> &bookmarks)  { ProjectFile::s_hasUnsavedChanged = true; ProjectFile::s_bookmarks = bookmarks; }
+        [[nodiscard]] static const std::list<ImHexApi::Bookmarks::Entry>& getBookmarks();
+        static void setBookmarks(const std::list<ImHexApi::Bookmarks::Entry> &bookmarks);
 
     private:
+        enum class Section : u8 {
+            FilePath    = 0x01,
+            Pattern     = 0x02,
+            Bookmarks   = 0x03,
+            Patches     = 0x04,
+            PatchChange = 0x05
+        };
+
+        struct Record {
+            Section section;
+            u64 offset, size;
+        };
+
+        constexpr static auto AutosaveInterval = std::chrono::seconds(10);
+
+        static void loadSection(Section section);
+        static std::vector<u8> readRecord(const Record &record);
+        static std::vector<u8> serializeSection(Section section);
+
+        static void waitForAutosave();
+
         static inline std::string s_currProjectFilePath;
         static inline bool s_hasUnsavedChanged = false;
 
+        static inline std::vector<Record> s_records;
+        static inline std::vector<Section> s_loadedSections;
+        static inline bool s_isBinary = false;
+        static inline u64 s_committedSize = 0;
+
+        // What the project file contains right now, only touched by the autosave task while it's running
+        static inline std::optional<prv::PatchStore> s_filePatches;
+        static inline std::map<Section, std::vector<u8>> s_fileSections;
+
+        static inline TaskHolder s_autosaveTask;
+        static inline std::chrono::steady_clock::time_point s_lastAutosave;
+
         static inline std::string s_filePath;
         static inline std::string s_pattern;
-        static inline Patches s_patches;
+        static inline prv::PatchStore s_patches;
         static inline std::list<ImHexApi::Bookmarks::Entry> s_bookmarks;
     };
 
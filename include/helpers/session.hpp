@@ -0,0 +1,60 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace hex {
+
+    namespace prv { class Provider; }
+
+    /*
+        Remembers the file or project that was open when ImHex got closed and which analyses had results for it, so the next start
+        continues where the last one left off. Restoring reruns all of these analyses in the background. Those that keep their results in
+        the analysis cache only load them from there, the data only gets processed again if it changed since
+    */
+    class Session {
+    public:
+        Session() = delete;
+
+        /* Reopens the last session once the first frame is up, opening the file doesn't hold up the window showing up */
+        static void restore();
+
+        /* What the provider was opened from is what gets reopened on the next start. Without a path there's nothing to reopen */
+        static void setFile(prv::Provider *provider, std::string_view filePath, std::string_view projectFilePath);
+        static void closeProvider(prv::Provider *provider);
+
+        /* Starts an analysis again for the current provider, with the argument its results were added with */
+        using RerunFunction = std::function<void(const std::string &argument)>;
+
+        static void registerAnalysis(std::string_view name, const RerunFunction &rerun);
+        static void unregisterAnalysis(std::string_view name);
+
+        /* Called once an analysis has results for a provider. Only those of the session's provider are kept, replacing older ones of the same name */
+        static void addAnalysis(prv::Provider *provider, std::string_view name, std::string_view argument = "");
+
+    private:
+        struct Analysis {
+            std::string name;
+            std::string argument;
+        };
+
+        constexpr static auto SessionFileName = "session.bin";
+
+        /* Has to be called with the mutex held */
+        static void store();
+
+        static inline std::mutex s_mutex;
+        static inline prv::Provider *s_provider = nullptr;
+        static inline std::string s_filePath, s_projectFilePath;
+        static inline std::vector<Analysis> s_analyses;
+
+        static inline std::map<std::string, RerunFunction, std::less<>> s_rerunFunctions;
+    };
+
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <hex/api/task.hpp>
+#include <hex/helpers/arena.hpp>
+#include <hex/helpers/table_sorter.hpp>
+
+#include <atomic>
+#include <bit>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace hex::lang { class PatternData; class PatternDataStaticArray; }
+namespace hex::prv { class Provider; }
+
+namespace hex {
+
+    /*
+        Shows an array of structs as a table with one column per member, members of nested structs get columns of their own.
+        Every entry of a static array is laid out the same way, so a column gets decoded for many entries at once straight from the
+        provider instead of going through a pattern per entry. Drawing only decodes the visible rows, sorting and filtering decode
+        whole columns on the task system
+    */
+    class StructArrayTable {
+    public:
+        StructArrayTable() = default;
+        ~StructArrayTable();
+
+        StructArrayTable(const StructArrayTable&) = delete;
+        StructArrayTable& operator=(const StructArrayTable&) = delete;
+
+        /* Static arrays whose entries are structs */
+        [[nodiscard]] static bool isSupported(const lang::PatternData *pattern);
+
+        /* The layout of the array gets copied, so the table doesn't depend on the patterns staying around. Passing nullptr clears it */
+        void setArray(const lang::PatternDataStaticArray *array);
+        [[nodiscard]] const lang::PatternDataStaticArray* getArray() const { return this->m_array; }
+
+        /* Drops everything decoded so far, has to be called whenever the data changed */
+        void invalidate();
+
+        void draw();
+
+    private:
+        /* ImGui tables can't have more columns than this, the first one shows the index of the entry */
+        constexpr static size_t MaximumColumnCount = 64;
+        constexpr static size_t MaximumCachedRows = 0x1000;
+        constexpr static size_t ReadSize = 0x10'0000;
+
+        enum class ValueKind { Unsigned, Signed, Float, Other };
+
+        struct Column {
+            std::string name;
+            u64 offset;     // From the start of an entry
+            size_t size;
+            std::endian endian;
+            ValueKind kind;
+            const lang::PatternData *member;    // Owned by the layout's arena
+        };
+
+        /* Shared with the sorting and filtering tasks, so they can keep going with it after the array changed */
+        struct Layout {
+            Arena arena;
+            u64 offset = 0;
+            size_t entrySize = 0;
+            u32 entryCount = 0;
+            std::vector<Column> columns;
+        };
+
+        static void addColumns(Layout &layout, const lang::PatternData *pattern, u64 entryOffset, const std::string &prefix);
+
+        /* Values of a column for count entries starting at first, packed one after another and converted to native endianess */
+        static void decodeColumn(prv::Provider *provider, const Layout &layout, const Column &column, u64 first, u64 count, std::vector<u8> &values);
+        static std::string formatValue(const Column &column, const u8 *value);
+
+        void decodeRows(prv::Provider *provider, const std::vector<u32> &entries);
+        void startFilter();
+        void updateRows();
+
+        std::shared_ptr<const Layout> m_layout;
+        const lang::PatternDataStaticArray *m_array = nullptr;
+
+        /* Formatted values of every column, for the rows drawn recently */
+        std::unordered_map<u32, std::vector<std::string>> m_cachedRows;
+        std::vector<u8> m_entryBuffer, m_valueBuffer;
+
+        TableSorter m_sorter;
+        bool m_sortDirty = false;
+
+        std::vector<char> m_filter = std::vector<char>(0x100, 0x00);
+        u32 m_filterColumn = 0;
+        bool m_filterDirty = false;
+        TaskHolder m_filterTask;
+        std::atomic<u64> m_filterGeneration = 0;
+        std::mutex m_filterMutex;
+        /* Whether every entry matches the filter, nothing if there's no filter */
+        std::shared_ptr<const std::vector<u8>> m_filterMatches;
+
+        /* Entries in the order they're shown, rebuilt whenever the sort order or the filter result changes */
+        std::vector<u32> m_rows;
+        std::shared_ptr<const std::vector<u32>> m_rowsOrder;
+        std::shared_ptr<const std::vector<u8>> m_rowsMatches;
+        bool m_rowsDirty = true;
+    };
+
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <hex/providers/provider.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+#if defined(OS_WINDOWS)
+#include <windows.h>
+#endif
+
+namespace hex::prv {
+
+    /*
+        Reads files with plain asynchronous I/O instead of mapping them. Meant for data that can't be mapped sensibly,
+        such as files on network shares, block devices or files that are still being appended to.
+        Every read gets split into blocks of which up to the queue depth are in flight at the same time
+    */
+    class AsyncFileProvider : public Provider {
+    public:
+        constexpr static u32 DefaultQueueDepth = 32;
+        constexpr static size_t DefaultBlockSize = 0x2'0000;
+
+        explicit AsyncFileProvider(std::string_view path, u32 queueDepth = DefaultQueueDepth, size_t blockSize = DefaultBlockSize);
+        ~AsyncFileProvider() override;
+
+        bool isAvailable() override;
+        bool isReadable() override;
+        bool isWritable() override;
+
+        void readRaw(u64 offset, void *buffer, size_t size) override;
+        void writeRaw(u64 offset, const void *buffer, size_t size) override;
+        size_t getRawSize() override;
+        Capability getCapabilities() override;
+
+        std::vector<std::pair<std::string, std::string>> getDataInformation() override;
+        std::string getName() override;
+        std::string getFilePath() override;
+
+    private:
+        /* The size of files that are being appended to changes, it's looked up again once it's older than this */
+        constexpr static auto SizeRefreshInterval = std::chrono::milliseconds(250);
+
+        void refreshSize();
+        void readBlocks(u64 offset, u8 *buffer, size_t size);
+        void readSynchronous(u64 offset, u8 *buffer, size_t size);
+
+        #if defined(OS_WINDOWS)
+        HANDLE m_file = INVALID_HANDLE_VALUE;
+        std::vector<HANDLE> m_events;
+        #else
+        int m_file = -1;
+        #endif
+
+        #if defined(OS_LINUX)
+        /* Submission and completion rings shared with the kernel, set up once when the file gets opened */
+        struct Ring {
+            int fd = -1;
+            u32 entries = 0;
+
+            void *submissionRing = nullptr, *completionRing = nullptr;
+            size_t submissionRingSize = 0, completionRingSize = 0;
+            void *submissionEntries = nullptr;
+            size_t submissionEntriesSize = 0;
+
+            u32 *submissionHead, *submissionTail, *submissionMask, *submissionArray;
+            u32 *completionHead, *completionTail, *completionMask;
+            void *completionEntries;
+        };
+
+        bool setupRing();
+        void destroyRing();
+        bool readRing(u64 offset, u8 *buffer, size_t size);
+
+        Ring m_ring;
+        #endif
+
+        std::string m_path;
+        u32 m_queueDepth;
+        size_t m_blockSize;
+
+        bool m_readable = false, m_writable = false;
+
+        std::mutex m_ioMutex;
+        std::atomic<u64> m_fileSize = 0;
+        std::atomic<s64> m_lastSizeRefresh = 0;
+    };
+
+}
\ No newline at end of file
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <hex/providers/provider.hpp>
+
+#include "providers/file_provider.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <zlib.h>
+
+#if defined(IMHEX_LZMA_SUPPORT)
+#include <lzma.h>
+#endif
+
+#if defined(IMHEX_ZSTD_SUPPORT)
+#include <zstd.h>
+#endif
+
+namespace hex::prv {
+
+    /*
+        Provides the decompressed contents of gzip, xz and zstd files without decompressing them to disk first.
+        Random reads start decoding at the closest checkpoint before them instead of at the start of the file.
+        xz files and seekable zstd files bring their own index of independent blocks, for everything else the checkpoints
+        get collected by decompressing the file once in the background. That index is stored next to the file and reused
+    */
+    class CompressedFileProvider : public Provider {
+    public:
+        constexpr static size_t CompressedCacheSize = 0x400'0000;
+
+        explicit CompressedFileProvider(std::string_view path);
+        ~CompressedFileProvider() override;
+
+        bool isAvailable() override;
+        bool isReadable() override;
+        bool isWritable() override;
+
+        void readRaw(u64 offset, void *buffer, size_t size) override;
+        void writeRaw(u64 offset, const void *buffer, size_t size) override;
+        size_t getRawSize() override;
+
+        std::vector<std::pair<std::string, std::string>> getDataInformation() override;
+        std::string getName() override;
+        std::string getFilePath() override;
+
+    private:
+        enum class Format : u8 { Unknown, Gzip, Xz, Zstd };
+
+        /* gzip checkpoints need the last 32 KiB of output to resume, xz blocks and zstd frames can be decoded on their own */
+        constexpr static size_t GzipWindowSize = 0x8000;
+        constexpr static u64 CheckpointSpacing = 0x10'0000;
+        constexpr static size_t InputChunkSize = 0x1'0000;
+
+        constexpr static u32 IndexMagic = 0x58444948;
+        constexpr static u32 IndexVersion = 1;
+
+        struct Checkpoint {
+            u64 uncompressedOffset;
+            u64 compressedOffset;
+            /* Number of bits of the byte before compressedOffset that still belong to the next gzip block, or the xz block's check type */
+            u32 flags;
+            std::vector<u8> dictionary;
+        };
+
+        /* State of an ongoing decompression. Sequential reads continue where the last one stopped instead of seeking again */
+        struct Cursor {
+            bool valid = false;
+            size_t checkpoint = 0;
+            u64 uncompressedOffset = 0, compressedOffset = 0;
+
+            std::vector<u8> input;
+            size_t inputPosition = 0, inputSize = 0;
+
+            z_stream zlib = { };
+            bool zlibInitialized = false, rawDeflate = false;
+
+            #if defined(IMHEX_LZMA_SUPPORT)
+            lzma_stream lzma = LZMA_STREAM_INIT;
+            #endif
+
+            #if defined(IMHEX_ZSTD_SUPPORT)
+            ZSTD_DCtx *zstd = nullptr;
+            #endif
+        };
+
+        static Format detectFormat(const u8 *magic, size_t size);
+
+        std::string getIndexPath() const;
+        bool loadIndex();
+        void saveIndex();
+
+        void buildGzipIndex();
+        #if defined(IMHEX_LZMA_SUPPORT)
+        bool buildXzIndex();
+        #endif
+        #if defined(IMHEX_ZSTD_SUPPORT)
+        bool buildZstdSeekTable();
+        void buildZstdIndex();
+        #endif
+
+        void addCheckpoint(Checkpoint &&checkpoint);
+
+        bool fillInput(Cursor &cursor);
+        bool seekCursor(Cursor &cursor, size_t checkpoint);
+        size_t decode(Cursor &cursor, u8 *buffer, size_t size);
+        void resetCursor(Cursor &cursor);
+
+        FileProvider m_file;
+        std::string m_path;
+        Format m_format = Format::Unknown;
+        u64 m_compressedSize = 0;
+
+        std::mutex m_indexMutex;
+        std::vector<Checkpoint> m_checkpoints;
+        std::atomic<u64> m_uncompressedSize = 0;
+        std::atomic<bool> m_indexComplete = false, m_indexFailed = false, m_stopIndexing = false;
+        std::thread m_indexer;
+
+        std::mutex m_cursorMutex;
+        Cursor m_cursor;
+    };
+
+}
\ No newline at end of file
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <hex/providers/provider.hpp>
+
+#include <mutex>
+#include <string_view>
+
+#if defined(OS_WINDOWS)
+#include <windows.h>
+#endif
+
+namespace hex::prv {
+
+    /*
+        Provides whole disks, partitions and disk images. Their size gets queried from the device itself since block devices
+        don't report one through stat. Reads bypass the page cache and always cover whole sectors, the block cache keeps
+        recently used sectors around instead so scanning a large disk doesn't evict everything else from memory
+    */
+    class DiskProvider : public Provider {
+    public:
+        constexpr static size_t SectorCacheSize = 0x200'0000;
+
+        explicit DiskProvider(std::string_view path);
+        ~DiskProvider() override;
+
+        bool isAvailable() override;
+        bool isReadable() override;
+        bool isWritable() override;
+
+        void readRaw(u64 offset, void *buffer, size_t size) override;
+        void writeRaw(u64 offset, const void *buffer, size_t size) override;
+        size_t getRawSize() override;
+
+        std::vector<std::pair<std::string, std::string>> getDataInformation() override;
+        std::string getName() override;
+
+    private:
+        /* Unbuffered I/O needs buffers aligned to the sector size, this one is reused for every request */
+        constexpr static size_t TransferSize = 0x10'0000;
+
+        bool readSectors(u64 offset, u8 *buffer, size_t size);
+        bool writeSectors(u64 offset, const u8 *buffer, size_t size);
+
+        #if defined(OS_WINDOWS)
+        HANDLE m_disk = INVALID_HANDLE_VALUE;
+        #else
+        int m_disk = -1;
+        #endif
+
+        std::string m_path;
+        u64 m_diskSize = 0;
+        u32 m_sectorSize = 512;
+        bool m_unbuffered = false;
+
+        bool m_readable = false, m_writable = false;
+
+        std::mutex m_transferMutex;
+        u8 *m_transferBuffer = nullptr;
+    };
+
+}
\ No newline at end of file
@@ -2,6 +2,13 @@
 
 #include <hex/providers/provider.hpp>
 
+#include "helpers/file_watcher.hpp"
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <string_view>
 
 #include <sys/stat.h>
@@ -18,37 +25,109 @@ namespace hex::prv {
 
     class FileProvider : public Provider {
     public:
-        explicit FileProvider(std::string_view path);
+        /* Read-only files are mapped without write access. Edits stay in the patch layer until they get saved back to the file */
+        explicit FileProvider(std::string_view path, bool readOnly = false);
         ~FileProvider() override;
 
         bool isAvailable() override;
         bool isReadable() override;
         bool isWritable() override;
 
-        void read(u64 offset, void *buffer, size_t size) override;
-        void write(u64 offset, const void *buffer, size_t size) override;
-
         void readRaw(u64 offset, void *buffer, size_t size) override;
         void writeRaw(u64 offset, const void *buffer, size_t size) override;
-        size_t getActualSize() override;
+        size_t getRawSize() override;
+        const u8* getMappedData() override;
+        Capability getCapabilities() override;
+        void adviseAccess(u64 address, size_t size, AccessHint hint) override;
+        bool saveAs(const std::string &path) override;
+        std::vector<Region> getChangedRegions() override;
+
+        bool canFollow() override;
+        void setFollowing(bool following) override;
 
         std::vector<std::pair<std::string, std::string>> getDataInformation() override;
+        std::string getName() override;
+        std::string getFilePath() override;
 
     private:
+        /*
+            Files that can't be mapped as a whole, either because they're too big for the address space or because the mapping failed,
+            get mapped in fixed size windows on demand instead. Only the most recently used windows stay mapped
+        */
+        constexpr static size_t WindowSize = 0x400'0000;
+        constexpr static size_t MaximumWindowCount = 16;
+        constexpr static u64 FullMappingLimit = sizeof(void*) > 4 ? 0x100'0000'0000 : 0x1000'0000;
+
+        struct MappedWindow {
+            u64 index;
+            u8 *data;
+            size_t size;
+        };
+
+        /*
+            Changes other programs make to the file are found by comparing hashes of blocks of it. Only the changed ranges get mapped again,
+            appended data only extends the mapping and the file only gets opened again if it was replaced or cut off.
+            Larger files would have to be read for minutes just to hash them, they only get watched while following them.
+            Following assumes everything but the last block stays the same, so only the end of the file gets hashed
+        */
+        constexpr static size_t WatchedBlockSize = 0x1'0000;
+        constexpr static u64 MaximumWatchedSize = 0x4'0000'0000;
+
+        void openFile();
+        void reload();
+        void grow(u64 size);
+        void remapRegions(const std::vector<Region> &regions);
+        void watch();
+        void checkForChanges();
+        bool hashFile(std::vector<size_t> &hashes, u64 &firstBlock, u64 &size, std::optional<u64> &fileId, u64 previousSize, std::optional<size_t> &previousTailHash);
+        [[nodiscard]] void* mapWholeFile(size_t size);
+
+        std::shared_ptr<MappedWindow> getWindow(u64 index);
+        [[nodiscard]] u8* mapWindow(u64 offset, size_t size);
+        void unmapWindow(u8 *data, size_t size);
+        void copyWindowed(u64 offset, u8 *buffer, size_t size, bool toFile);
+        void writeToFile(u64 offset, const void *buffer, size_t size);
+
         #if defined(OS_WINDOWS)
         HANDLE m_file;
         HANDLE m_mapping;
+        HANDLE m_writeFile = nullptr;
         #else
         int m_file;
+        int m_writeFile = -1;
         #endif
         std::string m_path;
-        void *m_mappedFile;
+        void *m_mappedFile = nullptr;
         size_t m_fileSize;
 
         bool m_fileStatsValid = false;
         struct stat m_fileStats = { 0 };
 
         bool m_readable, m_writable;
+        bool m_readOnly;
+
+        bool m_windowed = false;
+        std::mutex m_windowMutex;
+        std::list<std::shared_ptr<MappedWindow>> m_windows;
+
+        std::unique_ptr<FileWatcher> m_watcher;
+        std::atomic<bool> m_closing = false;
+
+        // State of the file as of the last check, only used by the watcher thread. The file id changes when the file gets replaced.
+        // Hashes start at the first hashed block, files being followed only keep the hashes of their end
+        std::vector<size_t> m_blockHashes;
+        u64 m_firstHashedBlock = 0;
+        u64 m_hashedSize = 0;
+        std::optional<u64> m_hashedFileId;
+        bool m_hashed = false;
+
+        std::mutex m_changeMutex;
+        std::vector<Region> m_changedRegions;
+        bool m_reloadNeeded = false;
+        std::optional<u64> m_grownSize;
+
+        /* Mappings from before the file got reloaded. Other threads may still be reading from them, so they only get unmapped along with the provider */
+        std::vector<std::pair<void*, size_t>> m_retiredMappings;
     };
 
 }
\ No newline at end of file
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <hex/providers/provider.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#if defined(OS_WINDOWS)
+#include <windows.h>
+#endif
+
+namespace hex::prv {
+
+    /*
+        Provides the memory of a running process. Addresses are the process' virtual addresses, only the parts of a read
+        that lie inside of mapped regions get requested from the process and everything in between reads as zeros
+    */
+    class ProcessMemoryProvider : public Provider {
+    public:
+        constexpr static auto ChangeCheckInterval = std::chrono::milliseconds(500);
+        constexpr static size_t MemoryCacheSize = 0x100'0000;
+
+        explicit ProcessMemoryProvider(u32 processId);
+        ~ProcessMemoryProvider() override;
+
+        bool isAvailable() override;
+        bool isReadable() override;
+        bool isWritable() override;
+
+        void readRaw(u64 offset, void *buffer, size_t size) override;
+        void writeRaw(u64 offset, const void *buffer, size_t size) override;
+        size_t getRawSize() override;
+        Capability getCapabilities() override;
+
+        std::vector<Region> getChangedRegions() override;
+
+        std::vector<std::pair<std::string, std::string>> getDataInformation() override;
+        std::string getName() override;
+
+    private:
+        struct MemoryRegion {
+            u64 start, end;
+            bool writable;
+        };
+
+        /* Blocks that were read recently get hashed again periodically, that's how changes show up without rereading everything */
+        constexpr static size_t WatchedBlockSize = BlockCacheBlockSize;
+        constexpr static size_t MaximumWatchedBlocks = MemoryCacheSize / WatchedBlockSize;
+
+        void updateRegions();
+        void transfer(u64 address, u8 *buffer, size_t size, bool write);
+        void watchBlocks(u64 address, const u8 *buffer, size_t size);
+        void checkForChanges();
+
+        static size_t hashBlock(const u8 *data, size_t size);
+
+        u32 m_processId;
+        std::string m_processName;
+
+        #if defined(OS_WINDOWS)
+        HANDLE m_process = nullptr;
+        #endif
+
+        bool m_available = false, m_writable = false;
+
+        std::mutex m_regionMutex;
+        std::vector<MemoryRegion> m_regions;
+
+        std::mutex m_watchMutex;
+        std::list<u64> m_watchOrder;
+        std::unordered_map<u64, std::pair<size_t, std::list<u64>::iterator>> m_watchedBlocks;
+        std::vector<Region> m_changedRegions;
+
+        std::mutex m_watcherMutex;
+        std::condition_variable m_watcherSignal;
+        bool m_stopWatcher = false;
+        std::thread m_watcher;
+    };
+
+}
\ No newline at end of file
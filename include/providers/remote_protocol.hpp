@@ -0,0 +1,113 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <algorithm>
+
+#if defined(OS_WINDOWS)
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+/*
+    Protocol spoken between the remote provider and imhex-remote-server over TCP.
+    Requests are a command byte, a 64 bit offset and a 64 bit size, writes are followed by the data to write.
+    Responses are a status byte and the 64 bit size of the data that follows them. All numbers are little endian.
+    The server answers requests in the order they arrived, so clients may send as many as they like without waiting
+*/
+namespace hex::prv::remote {
+
+    constexpr static u32 ProtocolMagic = 0x58454852;
+    constexpr static u32 ProtocolVersion = 1;
+    constexpr static u16 DefaultPort = 31140;
+
+    /* Larger requests get rejected so a broken client can't make the server allocate arbitrary amounts of memory */
+    constexpr static u64 MaximumTransferSize = 0x100'0000;
+
+    constexpr static size_t RequestHeaderSize = 17;
+    constexpr static size_t ResponseHeaderSize = 9;
+
+    enum class Command : u8 {
+        Hello   = 0x00,     // offset = ProtocolMagic, size = ProtocolVersion. Answered with the u64 data size and a u8 writable flag
+        Read    = 0x01,
+        Write   = 0x02,
+        Size    = 0x03      // Answered with the u64 data size
+    };
+
+    enum class Status : u8 {
+        Ok      = 0x00,
+        Error   = 0x01
+    };
+
+    #if defined(OS_WINDOWS)
+    using Socket = SOCKET;
+    constexpr static Socket InvalidSocket = INVALID_SOCKET;
+    #else
+    using Socket = int;
+    constexpr static Socket InvalidSocket = -1;
+    #endif
+
+    inline void encodeLE(u8 *destination, u64 value, size_t size) {
+        for (size_t i = 0; i < size; i++)
+            destination[i] = (value >> (i * 8)) & 0xFF;
+    }
+
+    inline u64 decodeLE(const u8 *source, size_t size) {
+        u64 value = 0;
+        for (size_t i = 0; i < size; i++)
+            value |= u64(source[i]) << (i * 8);
+
+        return value;
+    }
+
+    inline void encodeRequest(u8 *header, Command command, u64 offset, u64 size) {
+        header[0] = u8(command);
+        encodeLE(header + 1, offset, sizeof(u64));
+        encodeLE(header + 9, size, sizeof(u64));
+    }
+
+    inline void encodeResponse(u8 *header, Status status, u64 size) {
+        header[0] = u8(status);
+        encodeLE(header + 1, size, sizeof(u64));
+    }
+
+    inline bool sendAll(Socket socket, const void *buffer, size_t size) {
+        auto data = reinterpret_cast<const char*>(buffer);
+        while (size > 0) {
+            auto sent = ::send(socket, data, std::min<size_t>(size, 0x4000'0000), 0);
+            if (sent <= 0)
+                return false;
+
+            data += sent;
+            size -= sent;
+        }
+
+        return true;
+    }
+
+    inline bool receiveAll(Socket socket, void *buffer, size_t size) {
+        auto data = reinterpret_cast<char*>(buffer);
+        while (size > 0) {
+            auto received = ::recv(socket, data, std::min<size_t>(size, 0x4000'0000), 0);
+            if (received <= 0)
+                return false;
+
+            data += received;
+            size -= received;
+        }
+
+        return true;
+    }
+
+    inline void closeSocket(Socket socket) {
+        #if defined(OS_WINDOWS)
+        closesocket(socket);
+        #else
+        close(socket);
+        #endif
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <hex/providers/provider.hpp>
+
+#include "providers/remote_protocol.hpp"
+
+#include <deque>
+#include <list>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace hex::prv {
+
+    /*
+        Provides data served by imhex-remote-server on another machine. Data is transferred in blocks which are kept in a
+        local cache. Requests for all missing blocks of a read are sent at once without waiting for each answer in between,
+        and sequential reads additionally request the blocks after them ahead of time, more the longer the sequence gets
+    */
+    class RemoteProvider : public Provider {
+    public:
+        constexpr static size_t RemoteCacheSize = 0x1000'0000;
+
+        /* Address in the form of host:port, the port may be left out */
+        explicit RemoteProvider(std::string_view address);
+        ~RemoteProvider() override;
+
+        bool isAvailable() override;
+        bool isReadable() override;
+        bool isWritable() override;
+
+        void readRaw(u64 offset, void *buffer, size_t size) override;
+        void writeRaw(u64 offset, const void *buffer, size_t size) override;
+        size_t getRawSize() override;
+
+        std::vector<std::pair<std::string, std::string>> getDataInformation() override;
+        std::string getName() override;
+
+    private:
+        constexpr static size_t BlockSize = 0x1'0000;
+        constexpr static size_t MaximumRequestSize = 0x10'0000;
+        constexpr static size_t MinimumReadAhead = 0x4'0000;
+        constexpr static size_t MaximumReadAhead = 0x200'0000;
+
+        /* Requests that were sent but not answered yet, in the order the answers are going to arrive in */
+        struct PendingRequest {
+            remote::Command command;
+            u64 firstBlock;
+            u64 blockCount;
+        };
+
+        bool connect();
+        void disconnect();
+
+        void requestBlocks(u64 firstBlock, u64 lastBlock, std::vector<u8> &requests);
+        bool receiveResponse();
+        void cacheBlock(u64 block, std::vector<u8> &&data);
+
+        std::string m_address;
+        remote::Socket m_socket = remote::InvalidSocket;
+
+        u64 m_dataSize = 0;
+        bool m_writable = false;
+
+        std::mutex m_requestMutex;
+        std::deque<PendingRequest> m_pendingRequests;
+        std::unordered_set<u64> m_pendingBlocks;
+
+        std::list<u64> m_cacheOrder;
+        std::unordered_map<u64, std::pair<std::vector<u8>, std::list<u64>::iterator>> m_cache;
+
+        u64 m_lastReadStart = 0, m_lastReadEnd = 0;
+        size_t m_readAhead = 0;
+
+        u64 m_bytesReceived = 0, m_requestCount = 0;
+    };
+
+}
\ No newline at end of file
@@ -2,8 +2,12 @@
 
 #include <hex/views/view.hpp>
 
-#include <vector>
+#include <hex/api/imhex_api.hpp>
+
 #include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 #include <hex/helpers/utils.hpp>
 
@@ -18,6 +22,26 @@ namespace hex {
 
         void drawContent() override;
         void drawMenu() override;
+
+    private:
+        using Bookmark = ImHexApi::Bookmarks::Entry;
+
+        void updateSortedBookmarks(ImGuiTableSortSpecs *sortSpecs);
+        const std::string& getPreview(const Bookmark &bookmark);
+        void drawBookmarkList();
+        void drawBookmarkDetails(Bookmark &bookmark);
+
+        // Bookmarks matching the filter in the order the table is sorted by, only rows that are visible get drawn
+        std::vector<Bookmark*> m_sortedBookmarks;
+        bool m_sortedBookmarksDirty = true;
+        std::string m_filter;
+
+        Bookmark *m_selectedBookmark = nullptr;
+
+        // Preview bytes are read the first time a row becomes visible and kept until the data or the page changes
+        std::unordered_map<const Bookmark*, std::string> m_previews;
+        prv::Provider *m_lastProvider = nullptr;
+        u32 m_lastPage = 0;
     };
 
 }
\ No newline at end of file
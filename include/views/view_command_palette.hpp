@@ -2,6 +2,7 @@
 
 #include <hex.hpp>
 #include <hex/views/view.hpp>
+#include <hex/helpers/fuzzy_index.hpp>
 
 #include <imgui.h>
 #include <hex/lang/pattern_data.hpp>
@@ -16,7 +17,7 @@ namespace hex {
 
     class ViewCommandPalette : public View {
     public:
-        ViewCommandPalette();
+        explicit ViewCommandPalette(std::vector<lang::PatternData*> &patternData);
         ~ViewCommandPalette() override;
 
         void drawContent() override;
@@ -44,6 +45,18 @@ namespace hex {
             std::function<void(std::string)> executeCallback;
         };
 
+        /* Everything that can be jumped to from the palette besides commands, indexed once every time the palette opens */
+        struct IndexedItem {
+            std::string displayResult;
+            std::function<void()> executeCallback;
+        };
+
+        constexpr static size_t MaxIndexedResults = 50;
+
+        std::vector<lang::PatternData*> &m_patternData;
+        std::vector<IndexedItem> m_indexedItems;
+        FuzzyIndex m_index;
+
         bool m_commandPaletteOpen = false;
         bool m_justOpened = false;
         bool m_focusInputTextBox = false;
@@ -56,6 +69,8 @@ namespace hex {
             this->m_focusInputTextBox = true;
         }
 
+        void buildIndex();
+        void indexPattern(lang::PatternData *pattern, const std::string &path);
         std::vector<CommandResult> getCommandResults(std::string_view command);
     };
 
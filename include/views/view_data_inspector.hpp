@@ -3,10 +3,15 @@
 #include <hex/views/view.hpp>
 
 #include <hex/api/content_registry.hpp>
+#include <hex/api/task.hpp>
+#include <hex/helpers/value_statistics.hpp>
 
+#include <array>
+#include <atomic>
 #include <bit>
 #include <cstdio>
 #include <string>
+#include <vector>
 
 namespace hex {
 
@@ -21,19 +26,47 @@ namespace hex {
         void drawMenu() override;
 
     private:
+        void updateValues();
+
+        void startStatistics();
+        void updateStatisticsRows();
+        void drawStatistics();
+
+        /* Formatted value of the registry entry with the same index. The strings are kept around so updating them doesn't allocate */
         struct InspectorCacheEntry {
-            std::string unlocalizedName;
-            ContentRegistry::DataInspector::DisplayFunction displayFunction;
+            bool valid = false;
+            std::string value;
         };
 
-        bool m_shouldInvalidate = true;
-
         std::endian m_endian = std::endian::native;
         ContentRegistry::DataInspector::NumberDisplayStyle m_numberDisplayStyle =ContentRegistry::DataInspector::NumberDisplayStyle::Decimal;
 
         u64 m_startAddress = 0;
         size_t m_validBytes = 0;
+        std::array<u8, ContentRegistry::DataInspector::MaxRequiredSize> m_buffer = { };
         std::vector<InspectorCacheEntry> m_cachedData;
+
+        /* Formatted statistics of the registry entry with the given index */
+        struct StatisticsRow {
+            u32 entry;
+            std::string minimum, maximum, mean;
+            std::array<float, ValueStatistics::BinCount> histogram;
+        };
+
+        /* Selection mode decodes the whole selection as every entry with a value type, instead of only the bytes at its start */
+        bool m_selectionMode = false;
+        u64 m_selectionAddress = 0;
+        size_t m_selectionSize = 0;
+
+        bool m_statisticsDirty = false;
+        TaskHolder m_statisticsTask;
+        std::atomic<u64> m_statisticsBytes = 0;
+        std::atomic<bool> m_statisticsDone = false;
+        std::vector<u32> m_statisticsEntries;
+        std::vector<ValueStatistics> m_statistics;
+
+        bool m_statisticsRowsDirty = false;
+        std::vector<StatisticsRow> m_statisticsRows;
     };
 
 }
\ No newline at end of file
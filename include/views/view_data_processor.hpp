@@ -4,11 +4,16 @@
 
 #include <imgui.h>
 #include <hex/views/view.hpp>
+#include <hex/api/task.hpp>
 #include <hex/data_processor/node.hpp>
 #include <hex/data_processor/link.hpp>
 
 #include <array>
+#include <memory>
+#include <optional>
+#include <set>
 #include <string>
+#include <vector>
 
 namespace hex {
 
@@ -34,9 +39,39 @@ namespace hex {
 
         std::optional<dp::Node::NodeError> m_currNodeError;
 
+        /* Steps that need processing, in an order where every step comes after the ones it reads from. A step is a single node or a fused chain of streamable nodes */
+        struct ProcessingJob {
+            std::vector<std::vector<dp::Node*>> steps;
+            std::vector<std::vector<size_t>> dependents;
+            std::vector<u32> pendingInputs;
+            std::vector<bool> processed;
+            std::shared_ptr<prv::Provider> provider;
+            bool failed = false;
+            std::optional<dp::Node::NodeError> error;
+
+            /* Steps that only get processed for the preview region, set for chains that can be limited to part of their data in preview mode */
+            std::vector<bool> windowed;
+            std::optional<Region> previewRegion;
+
+            /* Full runs following a preview, they get interrupted by anything that needs processing again */
+            bool background = false;
+        };
+
+        ProcessingJob m_job;
+        TaskHolder m_processingTask;
+        bool m_jobPending = false;
+
+        /* In preview mode changes first only get processed around the data visible in the hex editor, the full run follows in the background */
+        bool m_previewMode = false;
+        std::set<dp::Node*> m_previewedNodes;
+        std::optional<Region> m_lastPreviewRegion;
+
         void eraseLink(u32 id);
         void eraseNodes(const std::vector<int> &ids);
         void processNodes();
+        void runJob(Task &task);
+        void waitForProcessing();
+        void publishResults();
     };
 
 }
\ No newline at end of file
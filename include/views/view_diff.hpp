@@ -0,0 +1,49 @@
+#pragma once
+
+#include <hex/views/view.hpp>
+#include <hex/api/task.hpp>
+#include <hex/helpers/diff.hpp>
+
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace hex {
+
+    namespace prv { class Provider; }
+
+    class ViewDiff : public View {
+    public:
+        explicit ViewDiff();
+        ~ViewDiff() override;
+
+        void drawContent() override;
+        void drawMenu() override;
+
+    private:
+        void openCompareFile(const std::string &path);
+        void startDiff();
+        void cancelDiff();
+        void collectDifferences();
+        void updateHighlights();
+
+        void drawDifferenceList();
+
+        std::string m_comparePath;
+        std::shared_ptr<prv::Provider> m_compareProvider;
+
+        TaskHolder m_diffTask;
+
+        /* Differences found so far, handed over from the diff task and appended to the list by the UI thread */
+        std::mutex m_differencesMutex;
+        std::vector<BinaryDiffer::Difference> m_pendingDifferences;
+
+        std::vector<BinaryDiffer::Difference> m_differences;
+        bool m_outdated = false;
+        bool m_highlightsDirty = false;
+        std::optional<size_t> m_selectedDifference;
+    };
+
+}
\ No newline at end of file
@@ -1,36 +1,47 @@
 #pragma once
 
 #include <hex/views/view.hpp>
+#include <hex/api/imhex_api.hpp>
+#include <hex/api/task.hpp>
+#include <hex/helpers/memory_budget.hpp>
 
 #include "helpers/disassembler.hpp"
 
+#include <atomic>
 #include <cstdio>
+#include <list>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
 namespace hex {
 
     namespace prv { class Provider; }
+    namespace lang { class PatternData; }
 
+    /* A decoded instruction. The text of the bytes, mnemonic and operands columns lives in a shared string pool */
     struct Disassembly {
         u64 address;
         u64 offset;
-        size_t size;
-        std::string bytes;
-        std::string mnemonic;
-        std::string operators;
+        u32 size;
+        u32 bytes;
+        u32 mnemonic;
+        u32 operators;
     };
 
     class ViewDisassembler : public View {
     public:
-        explicit ViewDisassembler();
+        explicit ViewDisassembler(std::vector<lang::PatternData*> &patternData);
         ~ViewDisassembler() override;
 
         void drawContent() override;
         void drawMenu() override;
 
     private:
-        bool m_disassembling = false;
+        std::vector<lang::PatternData*> &m_patternData;
+
+        TaskHolder m_disassemblerTask;
 
         u64 m_baseAddress = 0;
         u64 m_codeRegion[2] = { 0 };
@@ -40,9 +51,130 @@ namespace hex {
         cs_mode m_modeBasicARM = cs_mode(0), m_modeExtraARM = cs_mode(0), m_modeBasicMIPS = cs_mode(0), m_modeBasicPPC = cs_mode(0), m_modeBasicX86 = cs_mode(0);
         bool m_littleEndianMode = true, m_micoMode = false, m_sparcV9Mode = false;
 
-        std::vector<Disassembly> m_disassembly;
+        /* Recursive descent only decodes what's reachable from the entry points, instead of everything in the code region */
+        bool m_recursiveDescent = false;
+        std::vector<u64> m_entryPoints;
+        u64 m_newEntryPoint = 0;
+
+        /*
+            Row and offset into the code region of about every IndexInterval-th instruction, built in the background.
+            Only the instructions around the visible rows get decoded and formatted
+        */
+        struct IndexEntry {
+            u64 row;
+            u64 offset;
+        };
+
+        constexpr static u64 IndexInterval = 256;
+        std::vector<IndexEntry> m_instructionIndex;
+
+        /* Regions at least this big get indexed on all cores */
+        constexpr static u64 ParallelIndexThreshold = 0x10'0000;
+        constexpr static u64 MinimumIndexChunkSize = 0x4'0000;
+        std::atomic<u64> m_instructionCount = 0;
+        std::atomic<u64> m_indexGeneration = 0;
+        std::mutex m_indexMutex;
+
+        /*
+            Targets of all direct branches and calls together with the addresses of the instructions referring to them, sorted by target
+            and then source. Built in the background after the instruction index, finding the references to an address is a binary search
+        */
+        struct References {
+            std::vector<u64> targets;
+            std::vector<u64> sources;
+        };
+
+        References m_references;
+
+        /*
+            Offsets of all instructions grouped by capstone instruction id, the ones of id i are offsets[starts[i]] to offsets[starts[i + 1]],
+            each group sorted. Built together with the references, finding every instruction with a mnemonic doesn't decode anything
+        */
+        struct MnemonicIndex {
+            std::vector<u64> starts;
+            std::vector<u64> offsets;
+        };
+
+        std::shared_ptr<const MnemonicIndex> m_mnemonicIndex;
+
+        /*
+            Only set by recursive descent. One bit per byte of the code region marking the first byte of every instruction found,
+            rows then only get decoded at those bytes. The highlights mark which bytes of the code region are code and which are data
+        */
+        std::vector<u64> m_instructionStarts;
+        std::vector<ImHexApi::Highlighting::Entry> m_codeHighlights;
+
+        /* Changes whenever the references or highlights got replaced */
+        std::atomic<u64> m_resultsVersion = 0;
+        u64 m_highlightsVersion = 0;
+
+        u64 m_referenceTarget = 0;
+        u64 m_referenceResultsVersion = 0;
+        std::vector<u64> m_referenceResults;
+
+        /* Handle and code region the current index was built with, used to decode the visible rows */
+        csh m_capstoneHandle = 0;
+        bool m_capstoneHandleOpen = false;
+        u64 m_indexedRegionStart = 0, m_indexedRegionSize = 0, m_indexedBaseAddress = 0;
+
+        /* Indices of the most recently disassembled regions, most recently used first */
+        struct CacheKey {
+            prv::Provider *provider;
+            u32 page;
+            cs_arch architecture;
+            cs_mode mode;
+            u64 baseAddress, regionStart, regionSize;
+            /* Empty for a linear sweep over the region */
+            std::vector<u64> entryPoints;
+
+            bool operator==(const CacheKey&) const = default;
+        };
+
+        struct CacheEntry {
+            CacheKey key;
+            std::vector<IndexEntry> index;
+            u64 instructionCount;
+            References references;
+            std::shared_ptr<const MnemonicIndex> mnemonicIndex;
+            std::vector<u64> instructionStarts;
+            std::vector<ImHexApi::Highlighting::Entry> codeHighlights;
+        };
+
+        constexpr static size_t CacheSize = 8;
+        std::list<CacheEntry> m_cache;
+        MemoryBudget::Cache m_memoryBudget;
+
+        /* Instructions found by their mnemonic and a pattern their operands have to match, as offsets into the code region */
+        std::string m_searchMnemonic, m_searchOperands, m_searchError;
+        TaskHolder m_searchTask;
+        std::mutex m_searchMutex;
+        std::vector<u64> m_searchResults;
+
+        u64 m_windowStart = 0;
+        std::vector<Disassembly> m_window;
+        std::string m_windowStrings;
 
-        void disassemble();
+        cs_mode getMode() const;
+        u32 getInstructionAlignment() const;
+        void indexInstructions(const Task &task, prv::Provider *provider, u64 generation, cs_arch architecture, cs_mode mode, u64 regionStart, u64 regionSize, u64 baseAddress);
+        void indexInstructionsParallel(const Task &task, prv::Provider *provider, u64 generation, cs_arch architecture, cs_mode mode, u32 alignment, u64 regionStart, u64 regionSize, u64 baseAddress, u32 threadCount);
+        void indexDetails(const Task &task, prv::Provider *provider, u64 generation, const CacheKey &key, u32 threadCount);
+        void discoverCode(const Task &task, prv::Provider *provider, u64 generation, const CacheKey &key, u32 threadCount);
+        [[nodiscard]] std::vector<u64> getEntryPoints() const;
+        [[nodiscard]] bool isIndexOutdated(const Task &task, u64 generation) const;
+        /* Starts indexing the code region in the background. With onlyCached set, nothing is shown unless the index was cached */
+        void disassemble(bool onlyCached = false);
+        void decodeWindow(u64 firstRow, u64 rowCount);
+        void findReferences(u64 target);
+        void drawReferences();
+        void searchInstructions();
+        void drawSearch();
+        void drawEntryPoints();
+        void updateHighlights();
+        void invalidateCache(const Region *region);
+        size_t evictCache(size_t bytes);
+        /* Has to be called with the index mutex locked */
+        void updateMemoryUsage();
     };
 
 }
\ No newline at end of file
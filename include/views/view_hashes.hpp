@@ -1,28 +1,100 @@
 #pragma once
 
 #include <hex/views/view.hpp>
+#include <hex/api/task.hpp>
+#include <hex/helpers/crypto.hpp>
 
+#include <atomic>
+#include <chrono>
 #include <cstdio>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 namespace hex {
 
     namespace prv { class Provider; }
+    namespace lang { class PatternData; }
 
     class ViewHashes : public View {
     public:
-        explicit ViewHashes();
+        explicit ViewHashes(std::vector<lang::PatternData*> &patternData);
         ~ViewHashes() override;
 
         void drawContent() override;
         void drawMenu() override;
 
     private:
+        struct HashJob {
+            u32 id;
+            crypt::HashRequest request;
+            std::optional<std::vector<u8>> result;
+            std::shared_ptr<crypt::HashTree> tree;
+        };
+
         bool m_shouldInvalidate = true;
         int m_currHashFunction = 0;
+        int m_polynomial = 0, m_init = 0;
         u64 m_hashRegion[2] = { 0 };
         bool m_shouldMatchSelection = false;
 
-        static constexpr const char* HashFunctionNames[] = { "CRC16", "CRC32", "MD5", "SHA-1", "SHA-224", "SHA-256", "SHA-384", "SHA-512" };
+        std::vector<HashJob> m_hashJobs;
+        u32 m_nextJobId = 0;
+
+        bool m_shouldHash = false;
+        std::chrono::steady_clock::time_point m_lastRegionChange;
+        TaskHolder m_hashingTask;
+        std::atomic<u64> m_hashedBytes = 0;
+        u64 m_hashingSize = 0;
+        u64 m_hashGeneration = 0;
+
+        std::mutex m_hashResultsMutex;
+        std::vector<std::tuple<u32, std::vector<u8>, std::shared_ptr<crypt::HashTree>>> m_pendingHashResults;
+        std::vector<Region> m_changedRegions;
+        u64 m_pendingHashGeneration = 0;
+
+        /* Region and results of the providers that aren't the current one. The list of hash functions is shared by all of them */
+        struct CachedHashes {
+            u64 hashRegion[2];
+            std::vector<HashJob> hashJobs;
+        };
+
+        std::map<prv::Provider*, CachedHashes> m_cachedHashes;
+
+        /* Digests of a whole list of regions at once, using the hash functions that were in the list above when the batch got started */
+        struct BatchEntry {
+            std::string name;
+            Region region;
+            std::vector<std::vector<u8>> results;
+        };
+
+        std::vector<lang::PatternData*> &m_patternData;
+
+        std::vector<std::string> m_batchFunctionNames;
+        std::vector<BatchEntry> m_batchEntries;
+        std::vector<u32> m_batchSortOrder;
+        bool m_batchSortDirty = false;
+        TaskHolder m_batchTask;
+        std::atomic<u64> m_batchHashedRegions = 0;
+
+        void startHashing();
+        void startBatch(std::vector<std::pair<std::string, Region>> &&regions);
+        void stopBatch();
+        void drawBatch();
+        void exportBatch(const std::string &path);
+        [[nodiscard]] std::vector<std::pair<std::string, Region>> getPatternRegions() const;
+        [[nodiscard]] static std::string getHashFunctionName(const crypt::HashRequest &request);
+        void collectHashResults();
+        void switchProvider(prv::Provider *previous);
+        void applyDataChanges(prv::Provider *provider);
+
+        static constexpr size_t MaxIncrementalRehashSize = 16 * crypt::HashTree::LeafSize;
+        static constexpr auto RegionChangeDebounceTime = std::chrono::milliseconds(250);
+        static constexpr const char* HashFunctionNames[] = { "CRC16", "CRC32", "MD5", "SHA-1", "SHA-224", "SHA-256", "SHA-384", "SHA-512", "SHA-256 Tree" };
     };
 
 }
\ No newline at end of file
@@ -1,14 +1,25 @@
 #pragma once
 
 #include <hex/helpers/utils.hpp>
+#include <hex/helpers/byte_operations.hpp>
+#include <hex/helpers/search_results.hpp>
+#include <hex/helpers/value_search.hpp>
 #include <hex/views/view.hpp>
+#include <hex/api/task.hpp>
 #include "helpers/encoding_file.hpp"
+#include "helpers/hex_grid_renderer.hpp"
+#include "helpers/minimap.hpp"
+#include "helpers/patches.hpp"
 
 #include <imgui_memory_editor.h>
 
+#include <functional>
 #include <list>
+#include <mutex>
+#include <optional>
 #include <tuple>
 #include <random>
+#include <string_view>
 #include <vector>
 
 #include <hex/lang/pattern_data.hpp>
@@ -17,7 +28,8 @@ namespace hex {
 
     namespace prv { class Provider; }
 
-    using SearchFunction = std::vector<std::pair<u64, u64>> (*)(prv::Provider* &provider, std::string string);
+    /* Turns the search input into the bytes to search for and their mask. An empty mask means all bits have to match */
+    using SearchFunction = std::function<std::pair<std::vector<u8>, std::vector<u8>>(std::string string)>;
 
     class ViewHexEditor : public View {
     public:
@@ -31,23 +43,77 @@ namespace hex {
 
     private:
         MemoryEditor m_memoryEditor;
+        Minimap m_minimap;
+        bool m_showMinimap = true;
+        HexGridRenderer m_gridRenderer;
+        bool m_drawGrid = false;
 
         std::vector<lang::PatternData*> &m_patternData;
 
-        std::map<u64, u32> m_highlightedBytes;
+        std::vector<lang::HighlightRange> m_highlightedRanges;
+
+        /* Non-overlapping, sorted spans of the final bookmark and pattern colors. Rebuilt lazily when either changes */
+        struct HighlightSpan {
+            u64 start, end;
+            u32 color;
+        };
+
+        std::vector<HighlightSpan> m_highlightSpans;
+        size_t m_highlightCursor = 0;
+        bool m_highlightSpansDirty = true;
+
+        std::vector<u8> m_visibleData;
+        u64 m_visibleDataOffset = 0;
 
         std::vector<char> m_searchStringBuffer;
         std::vector<char> m_searchHexBuffer;
+        std::vector<char> m_searchEncodedBuffer;
+        std::vector<char> m_searchRegexBuffer;
+        bool m_regexCaseInsensitive = false;
+        std::string m_regexError;
+
+        /* Numeric value search, exact or within a range or tolerance. Errors in the values are shown the same way as regex errors */
+        enum class ValueSearchMode : int { Exact, Range, Tolerance };
+        std::vector<char> m_searchValueBuffer;
+        std::vector<char> m_searchValueLimitBuffer;
+        ValueType m_valueSearchType = ValueType::U32;
+        ValueSearchMode m_valueSearchMode = ValueSearchMode::Exact;
+        std::endian m_valueSearchEndian = std::endian::little;
+        bool m_valueSearchAligned = false;
+        std::string m_valueSearchError;
+
+        /* Type the value results were found as, so they keep being shown the same way when the inputs change */
+        ValueType m_valueResultType = ValueType::U32;
+        std::endian m_valueResultEndian = std::endian::little;
         SearchFunction m_searchFunction = nullptr;
-        std::vector<std::pair<u64, u64>> *m_lastSearchBuffer;
+        SearchResults *m_lastSearchBuffer;
 
         s64 m_lastSearchIndex = 0;
-        std::vector<std::pair<u64, u64>> m_lastStringSearch;
-        std::vector<std::pair<u64, u64>> m_lastHexSearch;
+        SearchResults m_lastStringSearch;
+        SearchResults m_lastHexSearch;
+        SearchResults m_lastEncodedSearch;
+        SearchResults m_lastRegexSearch;
+        SearchResults m_lastValueSearch;
+        std::string m_narrowError;
+
+        TaskHolder m_searchTask;
+
+        /* Results of finished chunks handed over from the search threads, merged into the result list by the UI thread */
+        std::mutex m_searchResultsMutex;
+        struct PendingSearchResults {
+            SearchResults *results;
+            std::vector<u64> addresses;
+            std::vector<u32> sizes;
+            std::vector<u8> snapshot;
+        };
+        std::vector<PendingSearchResults> m_pendingSearchResults;
 
         s64 m_gotoAddress = 0;
 
         char m_baseAddressBuffer[0x20] = { 0 };
+        char m_diskPathBuffer[0x200] = { 0 };
+        char m_processIdBuffer[0x10] = { 0 };
+        char m_remoteAddressBuffer[0x100] = { 0 };
 
         std::vector<u8> m_dataToSave;
 
@@ -55,21 +121,57 @@ namespace hex {
         std::string m_loaderScriptFilePath;
 
         hex::EncodingFile m_currEncodingFile;
-
+        std::vector<u8> m_encodingBuffer;
+        TaskHolder m_exportTask;
+        TaskHolder m_patchTask;
+
+        /* Operation applied to the whole selection at once */
+        ByteOperation m_modifyOperation = ByteOperation::Fill;
+        char m_modifyOperandBuffer[0x100] = { 0 };
+        u8 m_modifyWidth = 1;
+        std::endian m_modifyEndian = std::endian::little;
+        std::string m_modifyError;
+        TaskHolder m_modifyTask;
+
+        /* Set when the current provider changed without its tab being clicked, until the tab bar shows it as selected */
+        bool m_selectProviderTab = false;
+
+        void drawProviderTabs();
         void drawSearchPopup();
+        void startSearch(const std::pair<std::vector<u8>, std::vector<u8>> &sequence);
+        void startRegexSearch(const std::string &pattern);
+        std::optional<ValueSearcher> makeValueSearcher();
+        void startValueSearch();
+        void narrowSearchResults(SearchResults::Filter filter, const char *input);
+        void drawValueSearchResults();
+        void cancelSearch();
+        void collectSearchResults();
+        void collectProviderChanges();
+        void gotoSearchResult(const std::pair<u64, u64> &result);
+        void gotoBookmark(bool next);
         void drawGotoPopup();
         void drawEditPopup();
 
-        void openFile(std::string path);
+        void undo();
+        void redo();
+        void modifySelection(ByteOperator byteOperator);
+
+        void rebuildHighlightSpans();
+        std::optional<u32> getHighlightColor(u64 address);
+
+        void openFile(std::string path, std::string_view providerName = "hex.provider.file");
         bool saveToFile(std::string path, const std::vector<u8>& data);
         bool loadFromFile(std::string path, std::vector<u8>& data);
-
-        enum class Language { C, Cpp, CSharp, Rust, Python, Java, JavaScript };
-        void copyBytes();
+        void exportDecoded(const std::string &path, Region region);
+        void importPatch(const std::string &path, PatchFormat format);
+        void exportPatch(const std::string &path, PatchFormat format);
+
+        enum class CopyFormat { Bytes, C, Cpp, CSharp, Rust, Python, Java, JavaScript, HexView, HexViewHTML };
+        [[nodiscard]] Region getSelection() const;
+        static void formatSelection(prv::Provider *provider, Region region, CopyFormat format, const std::function<void(std::string_view)> &output, Task *task = nullptr);
+        void copySelection(CopyFormat format);
         void copyString();
-        void copyLanguageArray(Language language);
-        void copyHexView();
-        void copyHexViewHTML();
+        void exportSelection(const std::string &path, CopyFormat format);
 
     };
 
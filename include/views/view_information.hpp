@@ -1,9 +1,19 @@
 #pragma once
 
 #include <hex/views/view.hpp>
+#include <hex/api/task.hpp>
+#include <hex/helpers/duplicates.hpp>
+#include <hex/helpers/entropy.hpp>
+#include <hex/helpers/memory_budget.hpp>
+
+#include "helpers/carver.hpp"
+#include "helpers/compression_scanner.hpp"
 
 #include <array>
+#include <atomic>
 #include <cstdio>
+#include <map>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -21,20 +31,88 @@ namespace hex {
 
     private:
         bool m_dataValid = false;
-        u32 m_blockSize = 0;
+        bool m_distributionOutdated = false;
+        bool m_resetEntropyPlot = false;
         float m_averageEntropy = 0;
         float m_highestBlockEntropy = 0;
-        std::vector<float> m_blockEntropy;
+        u64 m_highestEntropyBlockAddress = 0;
+        EntropyMap m_entropyMap;
+
+        std::mutex m_changedRegionsMutex;
+        std::vector<Region> m_changedRegions;
 
         std::array<ImU64, 256> m_valueCounts = { 0 };
-        bool m_analyzing = false;
+        std::vector<float> m_digraphHeatmap;
+        TaskHolder m_analyzerTask;
 
         std::pair<u64, u64> m_analyzedRegion = { 0, 0 };
 
         std::string m_fileDescription;
         std::string m_mimeType;
 
-        void analyze();
+        /* Finished analyses of the providers that aren't the current one */
+        struct CachedAnalysis {
+            bool distributionOutdated;
+            float averageEntropy;
+            float highestBlockEntropy;
+            u64 highestEntropyBlockAddress;
+            EntropyMap entropyMap;
+            std::array<ImU64, 256> valueCounts;
+            std::vector<float> digraphHeatmap;
+            std::pair<u64, u64> analyzedRegion;
+            std::string fileDescription;
+            std::string mimeType;
+
+            u64 cachedAt;
+        };
+
+        /* The analyses cached longest get evicted first once the memory budget is exceeded */
+        std::map<prv::Provider*, CachedAnalysis> m_cachedAnalyses;
+        u64 m_cacheCounter = 0;
+        MemoryBudget::Cache m_memoryBudget;
+
+        /* Results of earlier runs on the same file are kept in the analysis cache, the first check for them happens without being asked */
+        bool m_cacheChecked = false;
+
+        TaskHolder m_magicLoaderTask;
+        TaskHolder m_carverTask;
+        std::atomic<u64> m_carvedBytes = 0;
+        std::vector<CarvedFile> m_carvedFiles;
+        bool m_carvingDone = false;
+
+        TaskHolder m_compressionTask;
+        std::atomic<u64> m_compressionBytes = 0;
+        u64 m_compressionTotalBytes = 0;
+        std::vector<CompressedRegion> m_compressedRegions;
+        bool m_compressionDone = false;
+
+        TaskHolder m_duplicatesTask;
+        std::atomic<u64> m_duplicatesBytes = 0;
+        std::vector<DuplicateGroup> m_duplicateGroups;
+        std::vector<std::pair<u32, u32>> m_duplicateRows;     // Group and address index of every table row
+        bool m_duplicatesDone = false;
+
+        size_t evictCachedAnalyses(size_t bytes);
+        void updateMemoryUsage();
+        void analyze(bool onlyCached = false);
+        void storeAnalysis(prv::Provider *provider);
+        bool loadCachedAnalysis(prv::Provider *provider);
+        void resetAnalysis();
+        void switchProvider(prv::Provider *previous);
+        void applyDataChanges(prv::Provider *provider);
+        void updateHighestEntropyBlock();
+        void drawEntropyPlot();
+
+        void carve();
+        void bookmarkCarvedFiles();
+        void drawCarvedFiles();
+
+        void findCompressedRegions();
+        void bookmarkCompressedRegions();
+        void drawCompressedRegions();
+
+        void findDuplicates();
+        void drawDuplicates();
     };
 
 }
\ No newline at end of file
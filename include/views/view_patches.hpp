@@ -6,6 +6,7 @@
 #include <hex/views/view.hpp>
 
 #include <optional>
+#include <vector>
 
 namespace hex {
 
@@ -20,7 +21,20 @@ namespace hex {
         void drawMenu() override;
 
     private:
+        struct PatchRun {
+            u64 address;
+            const std::vector<u8> *data;
+        };
+
+        void updatePatchRuns(prv::Provider *provider);
+
+        // Random access to the runs for the list clipper, only rebuilt once the patches changed
+        std::vector<PatchRun> m_patchRuns;
+        prv::Provider *m_lastProvider = nullptr;
+        u64 m_lastGeneration = 0;
+
         u64 m_selectedPatch;
+        size_t m_selectedPatchSize;
     };
 
 }
\ No newline at end of file
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <hex/views/view.hpp>
+#include <hex/api/task.hpp>
+#include <hex/helpers/memory_budget.hpp>
 #include <hex/lang/evaluator.hpp>
 #include <hex/lang/pattern_language.hpp>
 
@@ -8,8 +10,10 @@
 
 #include <cstring>
 #include <filesystem>
+#include <map>
+#include <mutex>
+#include <optional>
 #include <string_view>
-#include <thread>
 #include <vector>
 
 #include <TextEditor.h>
@@ -25,6 +29,8 @@ namespace hex {
         void drawAlwaysVisible() override;
         void drawContent() override;
 
+        void loadPatternFile(std::string_view path);
+
     private:
         lang::PatternLanguage *m_patternLanguageRuntime;
         std::vector<lang::PatternData*> &m_patternData;
@@ -32,13 +38,40 @@ namespace hex {
         int m_selectedPatternFile = 0;
         bool m_runAutomatically = false;
         bool m_evaluatorRunning = false;
+        TaskHolder m_evaluatorTask;
+        std::optional<std::string> m_pendingPattern;
+
+        std::mutex m_changedRegionsMutex;
+        std::vector<Region> m_changedRegions;
+        bool m_rerunPattern = false;
 
         TextEditor m_textEditor;
         std::vector<std::pair<lang::LogConsole::Level, std::string>> m_console;
 
-        void loadPatternFile(std::string_view path);
+        /*
+            Every provider gets its own runtime since that's what owns the patterns it created. Results of evaluations
+            that were started before switching to another provider are dropped
+        */
+        struct CachedPatterns {
+            lang::PatternLanguage *runtime;
+            std::vector<lang::PatternData*> patternData;
+            std::vector<std::pair<lang::LogConsole::Level, std::string>> console;
+            bool outdated;
+            u64 cachedAt;
+        };
+
+        /* Evicting patterns to stay within the memory budget drops their runtime, they get evaluated again once their provider is selected */
+        std::map<prv::Provider*, CachedPatterns> m_cachedPatterns;
+        u64 m_cacheCounter = 0;
+        MemoryBudget::Cache m_memoryBudget;
+        u64 m_evaluationGeneration = 0;
+
+        void switchProvider(prv::Provider *previous);
+        size_t evictCachedPatterns(size_t bytes);
+        void updateMemoryUsage();
         void clearPatternData();
         void parsePattern(char *buffer);
+        void applyDataChanges();
     };
 
 }
\ No newline at end of file
@@ -6,6 +6,9 @@
 #include <hex/views/view.hpp>
 #include <hex/lang/pattern_data.hpp>
 
+#include "helpers/struct_table.hpp"
+
+#include <string>
 #include <vector>
 #include <tuple>
 #include <cstdio>
@@ -26,6 +29,17 @@ namespace hex {
 
         std::vector<lang::PatternData*> &m_patternData;
         std::vector<lang::PatternData*> m_sortedPatternData;
+
+        prv::Provider *m_lastProvider = nullptr;
+        u32 m_lastPage = 0;
+
+        /* Arrays of structs that can be shown as a table, with the path of names that leads to them */
+        std::vector<std::pair<std::string, const lang::PatternDataStaticArray*>> m_tableArrays;
+        bool m_tableArraysDirty = true;
+        StructArrayTable m_structTable;
+
+        void collectTableArrays(const std::vector<lang::PatternData*> &patterns, const std::string &prefix);
+        void drawTable();
     };
 
 }
\ No newline at end of file
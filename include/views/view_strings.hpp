@@ -1,18 +1,28 @@
 #pragma once
 
 #include <hex/views/view.hpp>
+#include <hex/api/task.hpp>
+#include <hex/helpers/memory_budget.hpp>
+#include <hex/helpers/string_search.hpp>
+#include <hex/helpers/table_sorter.hpp>
 
+#include <atomic>
 #include <cstdio>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <unordered_map>
 
 namespace hex {
 
     namespace prv { class Provider; }
 
-    struct FoundString {
-        std::string string;
-        u64 offset;
-        size_t size;
+    /* Maps every trigram of the decoded strings to the sorted list of strings containing it */
+    struct StringIndex {
+        std::shared_ptr<const FoundStrings> strings;
+        std::unordered_map<u32, std::vector<u32>> trigrams;
     };
 
     class ViewStrings : public View {
@@ -24,17 +34,83 @@ namespace hex {
         void drawMenu() override;
 
     private:
-        bool m_searching = false;
+        std::atomic<bool> m_searching = false;
+        TaskHolder m_searchTask;
 
-        std::vector<FoundString> m_foundStrings;
+        /* Whether the analysis cache was checked for strings found with the current settings */
+        bool m_cacheChecked = false;
+
+        /* Strings always get extracted with the lowest minimum length, any higher one only hides the shorter strings */
+        constexpr static int LowestMinimumLength = 4;
+
+        std::shared_ptr<const FoundStrings> m_foundStrings = std::make_shared<FoundStrings>();
+
+        /* Order the strings are shown in, nothing while they're unsorted. It belongs to the sorted strings, which may not be the latest ones yet */
+        std::shared_ptr<const std::vector<u32>> m_sortOrder;
+        std::shared_ptr<const FoundStrings> m_sortedStrings;
         int m_minimumLength = 5;
+        StringSearchMode m_searchMode = StringSearchMode::ASCII;
+
+        /* End of the data the found strings cover. Data appended behind it only needs to be searched from there on */
+        u64 m_searchedSize = 0;
+        bool m_appendPending = false;
+
         std::vector<char> m_filter;
+        std::vector<u32> m_filteredIndices;
+        bool m_filterDirty = false;
+
+        std::atomic<bool> m_filtering = false;
+        TaskHolder m_filterTask;
+        std::atomic<u64> m_filterGeneration = 0;
+        std::mutex m_filterMutex;
+        std::shared_ptr<const StringIndex> m_stringIndex;
+        std::vector<u32> m_pendingFilterMatches;
+        bool m_pendingFilterDone = false;
+
+        /* Results of the providers that aren't the current one, switching back to them doesn't need another search */
+        struct CachedResults {
+            std::shared_ptr<const FoundStrings> foundStrings;
+            std::shared_ptr<const StringIndex> stringIndex;
+            std::shared_ptr<const std::vector<u32>> sortOrder;
+            int minimumLength;
+            StringSearchMode searchMode;
+
+            size_t memoryUsage;
+            u64 cachedAt;
+        };
+
+        /* Only the results of other providers count towards the memory budget, the ones cached longest get evicted first */
+        std::map<prv::Provider*, CachedResults> m_cachedResults;
+        u64 m_cacheCounter = 0;
+        MemoryBudget::Cache m_memoryBudget;
 
         std::string m_selectedString;
         std::string m_demangledName;
 
-        void searchStrings();
+        std::mutex m_demangleMutex;
+        TaskHolder m_demangleTask;
+        std::atomic<u64> m_demangleGeneration = 0;
+        std::unordered_map<u64, std::optional<std::string>> m_demangledNames;
+        std::vector<std::pair<u64, std::string>> m_demangleQueue;
+
+        void clearResults();
+        void stopTasks();
+        void switchProvider(prv::Provider *previous);
+        void searchStrings(bool onlyCached = false);
+        void searchAppended();
+        size_t evictCachedResults(size_t bytes);
+        void updateMemoryUsage();
+        void buildIndex(prv::Provider *provider, std::shared_ptr<const FoundStrings> strings, std::shared_ptr<const StringIndex> previous = nullptr, u32 keptStrings = 0);
+        void updateFilter();
+        void collectFilterResults();
+        std::vector<u32> applySortOrder(std::vector<u32> &&matches) const;
+        std::string readString(const FoundString &foundString);
+        std::optional<std::string> getDemangledName(const FoundString &foundString, const std::string &string);
+        void demangleQueuedStrings();
         void createStringContextMenu(const FoundString &foundString);
+
+        /* Declared last so it's destroyed first, its sorting task may still use the found strings */
+        TableSorter m_sorter;
     };
 
 }
\ No newline at end of file
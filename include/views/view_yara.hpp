@@ -4,12 +4,24 @@
 
 #include <imgui.h>
 #include <hex/views/view.hpp>
+#include <hex/api/task.hpp>
+#include <hex/helpers/table_sorter.hpp>
+
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <set>
+
+struct YR_RULES;
 
 namespace hex {
 
+    namespace lang { class PatternData; }
+
     class ViewYara : public View {
     public:
-        ViewYara();
+        explicit ViewYara(std::vector<lang::PatternData*> &patternData);
         ~ViewYara() override;
 
         void drawContent() override;
@@ -18,19 +30,75 @@ namespace hex {
     private:
         struct YaraMatch {
             std::string identifier;
+            std::string ruleFile;
             s64 address;
             s32 size;
             bool wholeDataMatch;
+
+            /* Index of the scope region the match was found in, nothing for matches of scans over all of the data */
+            std::optional<u32> scopeRegion;
         };
 
+        /* Parts of the data that get scanned, each region of a scope is scanned on its own as if it was all of the data */
+        enum class ScanScope : u8 {
+            WholeData,
+            Selection,
+            Bookmarks,
+            Patterns
+        };
+
+        std::vector<lang::PatternData*> &m_patternData;
+
+        ScanScope m_scanScope = ScanScope::WholeData;
+        Region m_selection = { 0, 0 };
+
         std::vector<std::string> m_rules;
         std::vector<YaraMatch> m_matches;
-        u32 m_selectedRule = 0;
-        bool m_matching = false;
+        std::mutex m_matchesMutex;
+
+        /* Counts changes to the matches, they only get sorted again once they changed since the last time */
+        u64 m_matchesGeneration = 0;
+        std::optional<u64> m_sortedGeneration;
+        std::set<std::string> m_selectedRules;
+        TaskHolder m_matchingTask;
         std::vector<char> m_errorMessage;
+        bool m_initialized = false;
+
+        /* Rule files and scope of the last scan and edits made since then, which only need the data around them to be scanned again */
+        std::vector<std::string> m_scannedRules;
+        ScanScope m_scannedScope = ScanScope::WholeData;
+        std::vector<Region> m_scopeRegions;
+        std::vector<Region> m_changedRegions;
+        bool m_rescanAll = false;
+        std::mutex m_changedRegionsMutex;
+
+        /* Compiled rules of every rule file that has been used so far, recompiled once the file changes */
+        struct CompiledRules {
+            std::filesystem::file_time_type lastWriteTime;
+            YR_RULES *rules;
+            std::optional<size_t> localMatchMargin;
+        };
 
+        std::map<std::string, CompiledRules> m_compiledRules;
+        std::mutex m_compiledRulesMutex;
+
+        /* Sets up libyara and looks for rule files, in fast start mode this only happens once the view gets opened */
+        void initialize();
         void reloadRules();
         void applyRules();
+        void applyDataChanges();
+        void scanRuleFiles(std::vector<std::string> paths, std::optional<std::vector<Region>> changedRegions);
+        void scanScopeRegions(std::vector<std::string> paths, std::optional<std::vector<Region>> changedRegions);
+        std::vector<Region> getScopeRegions(ScanScope scope) const;
+        std::optional<CompiledRules> getCompiledRules(const std::string &path);
+        static std::vector<YaraMatch> scanRules(prv::Provider *provider, YR_RULES *rules, const std::string &ruleFile, u64 address, size_t size, std::optional<u32> scopeRegion = std::nullopt);
+
+        static std::string getCacheEntryName(prv::Provider *provider, const std::string &rulePath, std::filesystem::file_time_type lastWriteTime);
+        static std::optional<std::vector<YaraMatch>> loadCachedMatches(prv::Provider *provider, const std::string &entryName, const std::string &ruleFile);
+        static void storeMatches(prv::Provider *provider, const std::string &entryName, const std::vector<YaraMatch> &matches);
+
+        /* Declared last so it's destroyed first, its sorting tasks read the matches */
+        TableSorter m_sorter;
     };
 
 }
\ No newline at end of file
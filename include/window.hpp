@@ -1,25 +1,41 @@
 #pragma once
 
 #include <filesystem>
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
 
+#include <hex/api/task.hpp>
 #include <hex/helpers/utils.hpp>
 #include <hex/views/view.hpp>
 
+#include <mutex>
+#include <optional>
+
 struct GLFWwindow;
+struct ImGuiIO;
 struct ImGuiSettingsHandler;
 
 namespace hex {
 
     class Window {
     public:
-        Window(int &argc, char **&argv);
+        /*
+            Offscreen windows are hidden and render as fast as possible instead of waiting for input or the display. They start with the
+            default settings and never write any settings or layout back, so the UI benchmark measures the same thing every time
+        */
+        Window(int &argc, char **&argv, bool offscreen = false);
         ~Window();
 
         void loop();
 
+        /* Draws a single frame, loop() calls this until the window gets closed */
+        void frame();
+
+        /* Called every frame after the real input was read and before ImGui uses it, lets the UI benchmark replay its own */
+        void setInputOverride(std::function<void(ImGuiIO&)> callback) { this->m_inputOverride = std::move(callback); }
+
         friend void *ImHexSettingsHandler_ReadOpenFn(ImGuiContext *ctx, ImGuiSettingsHandler *, const char *);
         friend void ImHexSettingsHandler_ReadLine(ImGuiContext*, ImGuiSettingsHandler *handler, void *, const char* line);
         friend void ImHexSettingsHandler_ApplyAll(ImGuiContext *ctx, ImGuiSettingsHandler *handler);
@@ -32,10 +48,18 @@ namespace hex {
     private:
         void frameBegin();
         void frameEnd();
+        bool hasActivity();
+        void drawProfiler();
+        void drawMemoryUsage();
+        void drawIOStatistics();
+        void drawTracing();
 
         void drawWelcomeScreen();
         void resetLayout();
 
+        void uploadFontAtlas();
+        void swapFontAtlas();
+
         void createDirectories() const;
         void initGLFW();
         void initImGui();
@@ -43,15 +67,28 @@ namespace hex {
         void deinitImGui();
 
         GLFWwindow* m_window = nullptr;
+        bool m_offscreen = false;
+        std::function<void(ImGuiIO&)> m_inputOverride;
 
         float m_globalScale = 1.0f, m_fontScale = 1.0f;
         bool m_fpsVisible = false;
+        bool m_profilerVisible = false;
         bool m_demoWindowOpen = false;
         bool m_layoutConfigured = false;
 
+        /* ImGui needs a few frames to settle after something happened, e.g. to move hover highlights or resize popups */
+        constexpr static u32 ActiveFrameCount = 5;
+        constexpr static double IdleRedrawInterval = 1.0;
+        u32 m_framesToRender = ActiveFrameCount;
+
         static inline std::tuple<int, int> s_currShortcut = { -1, -1 };
 
         std::list<std::string> m_recentFiles;
+
+        // Atlas with all glyph ranges, built in the background when no cached one was found
+        TaskHolder m_fontAtlasTask;
+        std::mutex m_fontAtlasMutex;
+        std::optional<std::vector<u8>> m_pendingFontAtlas;
     };
 
 }
\ No newline at end of file
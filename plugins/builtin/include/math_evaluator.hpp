@@ -2,12 +2,16 @@
 
 #include <hex.hpp>
 
+#include <bit>
 #include <string>
 #include <vector>
 #include <queue>
 #include <unordered_map>
 #include <functional>
 #include <optional>
+#include <span>
+
+namespace hex::prv { class Provider; }
 
 namespace hex {
 
@@ -59,15 +63,71 @@ namespace hex {
         Operator op;
         BracketType bracketType;
         std::string name;
-        std::vector<long double> arguments;
+        std::vector<std::vector<Token>> arguments;    // Every argument of a function call in postfix order
     };
 
     class MathEvaluator {
     public:
         MathEvaluator() = default;
 
+        /*
+            An expression parsed and converted to postfix once so it can be evaluated many times. Variables are turned into
+            slots that get their values from the caller. Functions are looked up while compiling, so a program only works
+            with the evaluator that compiled it
+        */
+        struct Program {
+            enum class InstructionType : u8 {
+                PushNumber,
+                PushVariable,
+                ApplyOperator,
+                ArgumentBegin,      // Marks where a function argument's instructions start, they're evaluated on their own
+                Call
+            };
+
+            struct Instruction {
+                InstructionType type;
+                Operator op;
+                u32 index;          // Variable slot or number of function arguments
+                long double number;
+                const std::function<std::optional<long double>(std::vector<long double>)> *function;
+            };
+
+            std::vector<Instruction> instructions;
+            std::vector<std::string> variables;    // Variable name of every slot
+            std::string resultVariable = "ans";
+
+            [[nodiscard]] std::optional<size_t> getSlot(std::string_view name) const;
+        };
+
         std::optional<long double> evaluate(std::string input);
 
+        Program compile(const std::string &input);
+
+        /* Takes variable values from slots and doesn't store the result anywhere, meant to be called in a loop */
+        std::optional<long double> evaluate(const Program &program, std::span<const long double> slots) const;
+
+        /* Takes variable values from the evaluator's variables and stores the result in the program's result variable */
+        std::optional<long double> evaluate(const Program &program);
+
+        /* Number of values a batch evaluation works on at once, every stack entry holds a whole column of them */
+        constexpr static size_t BatchSize = 256;
+
+        enum class ValueType : u8 {
+            Unsigned,
+            Signed,
+            Float
+        };
+
+        /*
+            Evaluates program once for every value in inputs, with the slot inputSlot set to that value and every other slot taken
+            from slots. Every instruction gets applied to a whole column of values before moving on to the next one, so each
+            expression is only interpreted once per BatchSize values. Functions that don't return a value produce NaN here
+        */
+        void evaluateBatch(const Program &program, size_t inputSlot, std::span<const long double> slots, std::span<const long double> inputs, std::span<long double> outputs) const;
+
+        /* Same as evaluateBatch with the inputs being count values of valueSize bytes each, read from the provider with patches applied */
+        std::vector<long double> evaluateRange(const Program &program, size_t inputSlot, std::span<const long double> slots, prv::Provider *provider, u64 address, size_t count, size_t valueSize, ValueType valueType, std::endian endian = std::endian::little) const;
+
         void registerStandardVariables();
         void registerStandardFunctions();
 
@@ -78,8 +138,8 @@ namespace hex {
 
     private:
         std::queue<Token> parseInput(const char *input);
-        std::queue<Token> toPostfix(std::queue<Token> inputQueue);
-        std::optional<long double> evaluate(std::queue<Token> postfixTokens);
+        std::vector<Token> toPostfix(std::queue<Token> inputQueue);
+        void compileTokens(const std::vector<Token> &postfixTokens, Program &program) const;
 
         std::unordered_map<std::string, long double> m_variables;
         std::unordered_map<std::string, std::function<std::optional<long double>(std::vector<long double>)>> m_functions;
@@ -2,8 +2,12 @@
 
 #include <hex/helpers/utils.hpp>
 
+#include <algorithm>
+#include <array>
+#include <bit>
 #include <cstring>
 #include <ctime>
+#include <span>
 
 #include <imgui_internal.h>
 
@@ -16,176 +20,148 @@ namespace hex::plugin::builtin {
         u8  data4[8];
     };
 
-    void registerDataInspectorEntries() {
+    using Style = hex::ContentRegistry::DataInspector::NumberDisplayStyle;
 
-        using Style = hex::ContentRegistry::DataInspector::NumberDisplayStyle;
+    /* Decodes a value stored with a fixed endianess. Swapping the bytes compiles down to a single instruction */
+    template<typename T, std::endian Endian>
+    T decode(std::span<const u8> buffer) {
+        std::array<u8, sizeof(T)> bytes;
+        std::memcpy(bytes.data(), buffer.data(), sizeof(T));
 
-        hex::ContentRegistry::DataInspector::add("hex.builtin.inspector.binary", sizeof(u8), [](auto buffer, auto endian, auto style) {
-            std::string binary;
-            for (u8 i = 0; i < 8; i++)
-                binary += ((buffer[0] << i) & 0x80) == 0 ? '0' : '1';
+        if constexpr (Endian != std::endian::native)
+            std::reverse(bytes.begin(), bytes.end());
 
-            return [binary] {
-                ImGui::TextUnformatted(binary.c_str());
-                return binary;
-            };
-        });
+        return std::bit_cast<T>(bytes);
+    }
 
-        hex::ContentRegistry::DataInspector::add("hex.builtin.inspector.u8", sizeof(u8), [](auto buffer, auto endian, auto style) {
-            auto format = (style == Style::Decimal) ? "{0:d}" : ((style == Style::Hexadecimal) ? "0x{0:X}" : "{0:#o}");
-            auto value = hex::format(format, *reinterpret_cast<u8*>(buffer.data()));
-            return [value] { ImGui::TextUnformatted(value.c_str()); return value; };
-        });
+    template<typename T>
+    T decode(std::span<const u8> buffer, std::endian endian) {
+        if (endian == std::endian::little)
+            return decode<T, std::endian::little>(buffer);
+        else
+            return decode<T, std::endian::big>(buffer);
+    }
 
-        hex::ContentRegistry::DataInspector::add("hex.builtin.inspector.s8", sizeof(s8), [](auto buffer, auto endian, auto style) {
-            auto format = (style == Style::Decimal) ? "{0:d}" : ((style == Style::Hexadecimal) ? "0x{0:X}" : "{0:#o}");
-            auto value = hex::format(format, *reinterpret_cast<s8*>(buffer.data()));
-            return [value] { ImGui::TextUnformatted(value.c_str()); return value; };
-        });
+    template<typename T>
+    void addIntegerEntry(std::string_view unlocalizedName, hex::ValueType valueType) {
+        hex::ContentRegistry::DataInspector::add(unlocalizedName, valueType, [](auto buffer, auto endian, auto style, auto &value) {
+            auto number = decode<T>(buffer, endian);
 
-        hex::ContentRegistry::DataInspector::add("hex.builtin.inspector.u16", sizeof(u16), [](auto buffer, auto endian, auto style) {
-            auto format = (style == Style::Decimal) ? "{0:d}" : ((style == Style::Hexadecimal) ? "0x{0:X}" : "{0:#o}");
-            auto value = hex::format(format, hex::changeEndianess(*reinterpret_cast<u16*>(buffer.data()), endian));
-            return [value] { ImGui::TextUnformatted(value.c_str()); return value; };
+            switch (style) {
+                case Style::Decimal:        hex::formatTo(value, "{0:d}", number);  break;
+                case Style::Hexadecimal:    hex::formatTo(value, "0x{0:X}", number); break;
+                case Style::Octal:          hex::formatTo(value, "{0:#o}", number); break;
+            }
         });
+    }
 
-        hex::ContentRegistry::DataInspector::add("hex.builtin.inspector.s16", sizeof(s16), [](auto buffer, auto endian, auto style) {
-            auto format = (style == Style::Decimal) ? "{0:d}" : ((style == Style::Hexadecimal) ? "0x{0:X}" : "{0:#o}");
-            auto value = hex::format(format, hex::changeEndianess(*reinterpret_cast<s16*>(buffer.data()), endian));
-            return [value] { ImGui::TextUnformatted(value.c_str()); return value; };
-        });
+    template<typename T>
+    void formatTime(T time, std::string &value) {
+#if defined(OS_WINDOWS) && defined(ARCH_64_BIT)
+        struct tm *ptm;
+        if constexpr (sizeof(T) == sizeof(__time32_t))
+            ptm = _localtime32(&time);
+        else
+            ptm = _localtime64(&time);
+#else
+        struct tm *ptm = localtime(&time);
+#endif
 
-        hex::ContentRegistry::DataInspector::add("hex.builtin.inspector.u32", sizeof(u32), [](auto buffer, auto endian, auto style) {
-            auto format = (style == Style::Decimal) ? "{0:d}" : ((style == Style::Hexadecimal) ? "0x{0:X}" : "{0:#o}");
-            auto value = hex::format(format, hex::changeEndianess(*reinterpret_cast<u32*>(buffer.data()), endian));
-            return [value] { ImGui::TextUnformatted(value.c_str()); return value; };
-        });
+        if (ptm != nullptr)
+            hex::formatTo(value, "{0:%a, %d.%m.%Y %H:%M:%S}", *ptm);
+        else
+            value += "Invalid";
+    }
 
-        hex::ContentRegistry::DataInspector::add("hex.builtin.inspector.s32", sizeof(s32), [](auto buffer, auto endian, auto style) {
-            auto format = (style == Style::Decimal) ? "{0:d}" : ((style == Style::Hexadecimal) ? "0x{0:X}" : "{0:#o}");
-            auto value = hex::format(format, hex::changeEndianess(*reinterpret_cast<s32*>(buffer.data()), endian));
-            return [value] { ImGui::TextUnformatted(value.c_str()); return value; };
-        });
+    void registerDataInspectorEntries() {
 
-        hex::ContentRegistry::DataInspector::add("hex.builtin.inspector.u64", sizeof(u64), [](auto buffer, auto endian, auto style) {
-            auto format = (style == Style::Decimal) ? "{0:d}" : ((style == Style::Hexadecimal) ? "0x{0:X}" : "{0:#o}");
-            auto value = hex::format(format, hex::changeEndianess(*reinterpret_cast<u64*>(buffer.data()), endian));
-            return [value] { ImGui::TextUnformatted(value.c_str()); return value; };
+        hex::ContentRegistry::DataInspector::add("hex.builtin.inspector.binary", sizeof(u8), [](auto buffer, auto endian, auto style, auto &value) {
+            for (u8 i = 0; i < 8; i++)
+                value += ((buffer[0] << i) & 0x80) == 0 ? '0' : '1';
         });
 
-        hex::ContentRegistry::DataInspector::add("hex.builtin.inspector.s64", sizeof(s64), [](auto buffer, auto endian, auto style) {
-            auto format = (style == Style::Decimal) ? "{0:d}" : ((style == Style::Hexadecimal) ? "0x{0:X}" : "{0:#o}");
-            auto value = hex::format(format, hex::changeEndianess(*reinterpret_cast<s64*>(buffer.data()), endian));
-            return [value] { ImGui::TextUnformatted(value.c_str()); return value; };
-        });
+        addIntegerEntry<u8>("hex.builtin.inspector.u8", hex::ValueType::U8);
+        addIntegerEntry<s8>("hex.builtin.inspector.s8", hex::ValueType::S8);
+        addIntegerEntry<u16>("hex.builtin.inspector.u16", hex::ValueType::U16);
+        addIntegerEntry<s16>("hex.builtin.inspector.s16", hex::ValueType::S16);
+        addIntegerEntry<u32>("hex.builtin.inspector.u32", hex::ValueType::U32);
+        addIntegerEntry<s32>("hex.builtin.inspector.s32", hex::ValueType::S32);
+        addIntegerEntry<u64>("hex.builtin.inspector.u64", hex::ValueType::U64);
+        addIntegerEntry<s64>("hex.builtin.inspector.s64", hex::ValueType::S64);
 
-        hex::ContentRegistry::DataInspector::add("hex.builtin.inspector.float", sizeof(float), [](auto buffer, auto endian, auto style) {
-            auto value = hex::format("{0:E}", hex::changeEndianess(*reinterpret_cast<float*>(buffer.data()), endian));
-            return [value] { ImGui::TextUnformatted(value.c_str()); return value; };
+        hex::ContentRegistry::DataInspector::add("hex.builtin.inspector.float", hex::ValueType::Float, [](auto buffer, auto endian, auto style, auto &value) {
+            hex::formatTo(value, "{0:E}", decode<float>(buffer, endian));
         });
 
-        hex::ContentRegistry::DataInspector::add("hex.builtin.inspector.double", sizeof(double), [](auto buffer, auto endian, auto style) {
-            auto value = hex::format("{0:E}", hex::changeEndianess(*reinterpret_cast<float*>(buffer.data()), endian));
-            return [value] { ImGui::TextUnformatted(value.c_str()); return value; };
+        hex::ContentRegistry::DataInspector::add("hex.builtin.inspector.double", hex::ValueType::Double, [](auto buffer, auto endian, auto style, auto &value) {
+            hex::formatTo(value, "{0:E}", decode<double>(buffer, endian));
         });
 
-        hex::ContentRegistry::DataInspector::add("hex.builtin.inspector.ascii", sizeof(char8_t), [](auto buffer, auto endian, auto style) {
-            auto value = hex::format("'{0}'", makePrintable(*reinterpret_cast<char8_t*>(buffer.data())).c_str());
-            return [value] { ImGui::TextUnformatted(value.c_str()); return value; };
+        hex::ContentRegistry::DataInspector::add("hex.builtin.inspector.ascii", sizeof(char8_t), [](auto buffer, auto endian, auto style, auto &value) {
+            hex::formatTo(value, "'{0}'", makePrintable(buffer[0]).c_str());
         });
 
-        hex::ContentRegistry::DataInspector::add("hex.builtin.inspector.wide", sizeof(char16_t), [](auto buffer, auto endian, auto style) {
-            auto c = *reinterpret_cast<char16_t*>(buffer.data());
-            auto value = hex::format("'{0}'", c == 0 ? '\x01' : char16_t(hex::changeEndianess(c, endian)));
-            return [value] { ImGui::TextUnformatted(value.c_str()); return value; };
+        hex::ContentRegistry::DataInspector::add("hex.builtin.inspector.wide", sizeof(char16_t), [](auto buffer, auto endian, auto style, auto &value) {
+            auto c = decode<char16_t>(buffer, endian);
+            hex::formatTo(value, "'{0}'", c == 0 ? '\x01' : c);
         });
 
-        hex::ContentRegistry::DataInspector::add("hex.builtin.inspector.utf8", sizeof(char8_t) * 4, [](auto buffer, auto endian, auto style) {
+        hex::ContentRegistry::DataInspector::add("hex.builtin.inspector.utf8", sizeof(char8_t) * 4, [](auto buffer, auto endian, auto style, auto &value) {
             char utf8Buffer[5] = { 0 };
             char codepointString[5] = { 0 };
             u32 codepoint = 0;
 
-            std::memcpy(utf8Buffer, reinterpret_cast<char8_t*>(buffer.data()), 4);
+            std::memcpy(utf8Buffer, buffer.data(), 4);
             u8 codepointSize = ImTextCharFromUtf8(&codepoint, utf8Buffer, utf8Buffer + 4);
 
             std::memcpy(codepointString, &codepoint, std::min(codepointSize, u8(4)));
-            auto value = hex::format("'{0}' (U+0x{1:04X})",  codepoint == 0xFFFD ? "Invalid" :
-                                                        codepoint < 0xFF ? makePrintable(codepoint).c_str() :
-                                                        codepointString,
-                                     codepoint);
-
-            return [value] { ImGui::TextUnformatted(value.c_str()); return value; };
+            hex::formatTo(value, "'{0}' (U+0x{1:04X})",  codepoint == 0xFFFD ? "Invalid" :
+                                                    codepoint < 0xFF ? makePrintable(codepoint).c_str() :
+                                                    codepointString,
+                                 codepoint);
         });
 
 #if defined(OS_WINDOWS) && defined(ARCH_64_BIT)
 
-        hex::ContentRegistry::DataInspector::add("hex.builtin.inspector.time32", sizeof(__time32_t), [](auto buffer, auto endian, auto style) {
-                auto endianAdjustedTime = hex::changeEndianess(*reinterpret_cast<__time32_t*>(buffer.data()), endian);
-                struct tm *ptm = _localtime32(&endianAdjustedTime);
-                std::string value;
-                if (ptm != nullptr)
-                    value = hex::format("{0:%a, %d.%m.%Y %H:%M:%S}", *ptm);
-                else
-                    value = "Invalid";
-
-                return [value] { ImGui::TextUnformatted(value.c_str()); return value; };
-            });
-
-            hex::ContentRegistry::DataInspector::add("hex.builtin.inspector.time64", sizeof(__time64_t), [](auto buffer, auto endian, auto style) {
-                auto endianAdjustedTime = hex::changeEndianess(*reinterpret_cast<__time64_t*>(buffer.data()), endian);
-                struct tm *ptm = _localtime64(&endianAdjustedTime);
-                std::string value;
-                if (ptm != nullptr)
-                    value = hex::format("{0:%a, %d.%m.%Y %H:%M:%S}", *ptm);
-                else
-                    value = "Invalid";
-
-                return [value] { ImGui::TextUnformatted(value.c_str()); return value; };
-            });
+        hex::ContentRegistry::DataInspector::add("hex.builtin.inspector.time32", sizeof(__time32_t), [](auto buffer, auto endian, auto style, auto &value) {
+            formatTime(decode<__time32_t>(buffer, endian), value);
+        });
 
-#else
+        hex::ContentRegistry::DataInspector::add("hex.builtin.inspector.time64", sizeof(__time64_t), [](auto buffer, auto endian, auto style, auto &value) {
+            formatTime(decode<__time64_t>(buffer, endian), value);
+        });
 
-        hex::ContentRegistry::DataInspector::add("hex.builtin.inspector.time", sizeof(time_t), [](auto buffer, auto endian, auto style) {
-            auto endianAdjustedTime = hex::changeEndianess(*reinterpret_cast<time_t*>(buffer.data()), endian);
-            struct tm *ptm = localtime(&endianAdjustedTime);
-            std::string value;
-            if (ptm != nullptr)
-                value = hex::format("{0:%a, %d.%m.%Y %H:%M:%S}", *ptm);
-            else
-                value = "Invalid";
+#else
 
-            return [value] { ImGui::TextUnformatted(value.c_str()); return value; };
+        hex::ContentRegistry::DataInspector::add("hex.builtin.inspector.time", sizeof(time_t), [](auto buffer, auto endian, auto style, auto &value) {
+            formatTime(decode<time_t>(buffer, endian), value);
         });
 
 #endif
 
-        hex::ContentRegistry::DataInspector::add("hex.builtin.inspector.guid", sizeof(GUID), [](auto buffer, auto endian, auto style) {
-            GUID guid;
-            std::memcpy(&guid, buffer.data(), sizeof(GUID));
-            auto value = hex::format("{}{{{:08X}-{:04X}-{:04X}-{:02X}{:02X}-{:02X}{:02X}{:02X}{:02X}{:02X}{:02X}}}",
-                                     (hex::changeEndianess(guid.data3, endian) >> 12) <= 5 && ((guid.data4[0] >> 4) >= 8 || (guid.data4[0] >> 4) == 0) ? "" : "Invalid ",
-                                     hex::changeEndianess(guid.data1, endian),
-                                     hex::changeEndianess(guid.data2, endian),
-                                     hex::changeEndianess(guid.data3, endian),
-                                     guid.data4[0], guid.data4[1], guid.data4[2], guid.data4[3],
-                                     guid.data4[4], guid.data4[5], guid.data4[6], guid.data4[7]);
-
-            return [value] { ImGui::TextUnformatted(value.c_str()); return value; };
-        });
+        hex::ContentRegistry::DataInspector::add("hex.builtin.inspector.guid", sizeof(GUID), [](auto buffer, auto endian, auto style, auto &value) {
+            auto data1 = decode<u32>(buffer.subspan(offsetof(GUID, data1)), endian);
+            auto data2 = decode<u16>(buffer.subspan(offsetof(GUID, data2)), endian);
+            auto data3 = decode<u16>(buffer.subspan(offsetof(GUID, data3)), endian);
+            auto data4 = buffer.subspan(offsetof(GUID, data4), 8);
 
-        hex::ContentRegistry::DataInspector::add("hex.builtin.inspector.rgba8", sizeof(u32), [](auto buffer, auto endian, auto style) {
-            ImColor value(hex::changeEndianess(*reinterpret_cast<u32*>(buffer.data()), endian));
+            hex::formatTo(value, "{}{{{:08X}-{:04X}-{:04X}-{:02X}{:02X}-{:02X}{:02X}{:02X}{:02X}{:02X}{:02X}}}",
+                          (data3 >> 12) <= 5 && ((data4[0] >> 4) >= 8 || (data4[0] >> 4) == 0) ? "" : "Invalid ",
+                          data1, data2, data3,
+                          data4[0], data4[1], data4[2], data4[3],
+                          data4[4], data4[5], data4[6], data4[7]);
+        });
 
-            auto stringValue = hex::format("(0x{:02X}, 0x{:02X}, 0x{:02X}, 0x{:02X})", u8(0xFF * (value.Value.x)), u8(0xFF * (value.Value.y)), u8(0xFF * (value.Value.z)), u8(0xFF * (value.Value.w)));
+        hex::ContentRegistry::DataInspector::add("hex.builtin.inspector.rgba8", sizeof(u32), [](auto buffer, auto endian, auto style, auto &value) {
+            ImColor color(decode<u32>(buffer, endian));
 
-            return [value, stringValue] {
-                ImGui::ColorButton("##inspectorColor", value,
-                                   ImGuiColorEditFlags_None,
-                                   ImVec2(ImGui::GetColumnWidth(), ImGui::GetTextLineHeight()));
-                return stringValue;
-            };
+            hex::formatTo(value, "(0x{:02X}, 0x{:02X}, 0x{:02X}, 0x{:02X})", u8(0xFF * (color.Value.x)), u8(0xFF * (color.Value.y)), u8(0xFF * (color.Value.z)), u8(0xFF * (color.Value.w)));
+        }, [](auto buffer, auto endian, const auto &value) {
+            ImGui::ColorButton("##inspectorColor", ImColor(decode<u32>(buffer, endian)),
+                               ImGuiColorEditFlags_None,
+                               ImVec2(ImGui::GetColumnWidth(), ImGui::GetTextLineHeight()));
         });
 
     }
 
-}
\ No newline at end of file
+}
@@ -2,10 +2,156 @@
 
 #include <hex/helpers/crypto.hpp>
 
+#include "math_evaluator.hpp"
+
+#include <algorithm>
+#include <array>
 #include <cctype>
+#include <cstring>
+#include <limits>
+#include <span>
+
+#include <zlib.h>
+
+#if defined(IMHEX_LZMA_SUPPORT)
+    #include <lzma.h>
+#endif
+
+#if defined(IMHEX_ZSTD_SUPPORT)
+    #include <zstd.h>
+#endif
+
+#if defined(IMHEX_LZ4_SUPPORT)
+    #include <lz4frame.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+    #include <immintrin.h>
+#endif
 
 namespace hex::plugin::builtin {
 
+    namespace {
+
+        enum class BitwiseOperation { AND, OR, XOR };
+
+        template<BitwiseOperation Operation>
+        constexpr u8 applyBitwise(u8 left, u8 right) {
+            if constexpr (Operation == BitwiseOperation::AND)
+                return left & right;
+            else if constexpr (Operation == BitwiseOperation::OR)
+                return left | right;
+            else
+                return left ^ right;
+        }
+
+    #if defined(__x86_64__) || defined(__i386__)
+
+        template<BitwiseOperation Operation>
+        __attribute__((target("avx2")))
+        size_t applyBitwiseAVX2(u8 *data, const u8 *operand, size_t size) {
+            size_t offset = 0;
+            for (; offset + 32 <= size; offset += 32) {
+                auto left = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + offset));
+                auto right = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(operand + offset));
+
+                if constexpr (Operation == BitwiseOperation::AND)
+                    left = _mm256_and_si256(left, right);
+                else if constexpr (Operation == BitwiseOperation::OR)
+                    left = _mm256_or_si256(left, right);
+                else
+                    left = _mm256_xor_si256(left, right);
+
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(data + offset), left);
+            }
+
+            return offset;
+        }
+
+        template<BitwiseOperation Operation>
+        __attribute__((target("sse2")))
+        size_t applyBitwiseSSE2(u8 *data, const u8 *operand, size_t size) {
+            size_t offset = 0;
+            for (; offset + 16 <= size; offset += 16) {
+                auto left = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + offset));
+                auto right = _mm_loadu_si128(reinterpret_cast<const __m128i*>(operand + offset));
+
+                if constexpr (Operation == BitwiseOperation::AND)
+                    left = _mm_and_si128(left, right);
+                else if constexpr (Operation == BitwiseOperation::OR)
+                    left = _mm_or_si128(left, right);
+                else
+                    left = _mm_xor_si128(left, right);
+
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(data + offset), left);
+            }
+
+            return offset;
+        }
+
+        bool isAVX2Supported() {
+            static bool supported = __builtin_cpu_supports("avx2");
+            return supported;
+        }
+
+    #endif
+
+        /* Combines size bytes of data in place with the same number of bytes of operand */
+        template<BitwiseOperation Operation>
+        void applyBitwise(u8 *data, const u8 *operand, size_t size) {
+            size_t offset = 0;
+
+        #if defined(__x86_64__) || defined(__i386__)
+            offset = isAVX2Supported() ? applyBitwiseAVX2<Operation>(data, operand, size) : applyBitwiseSSE2<Operation>(data, operand, size);
+        #endif
+
+            for (; offset < size; offset++)
+                data[offset] = applyBitwise<Operation>(data[offset], operand[offset]);
+        }
+
+        /* Combines data in place with a key that gets repeated over all of it */
+        template<BitwiseOperation Operation>
+        void applyBitwiseRepeating(u8 *data, size_t size, const u8 *key, size_t keySize) {
+            constexpr static size_t VectorSize = 32;
+
+            // Short keys get repeated up to a multiple of the vector size first so whole vectors can be combined at once
+            std::array<u8, VectorSize * VectorSize> repeatedKey;
+            if (keySize < VectorSize) {
+                for (size_t i = 0; i < keySize * VectorSize; i++)
+                    repeatedKey[i] = key[i % keySize];
+
+                key = repeatedKey.data();
+                keySize *= VectorSize;
+            }
+
+            for (size_t offset = 0; offset < size; offset += keySize)
+                applyBitwise<Operation>(data + offset, key, std::min(keySize, size - offset));
+        }
+
+        /* Combines streamed blocks with the matching part of an operand buffer, the stream ends together with the operand */
+        template<BitwiseOperation Operation>
+        class BitwiseOperandStream {
+        public:
+            void begin(const std::vector<u8> &operand, u64 offset) {
+                this->m_operand = &operand;
+                this->m_offset = std::min<u64>(offset, operand.size());
+            }
+
+            bool apply(std::vector<u8> &block) {
+                block.resize(std::min<size_t>(block.size(), this->m_operand->size() - this->m_offset));
+                applyBitwise<Operation>(block.data(), this->m_operand->data() + this->m_offset, block.size());
+                this->m_offset += block.size();
+
+                return this->m_offset < this->m_operand->size();
+            }
+
+        private:
+            const std::vector<u8> *m_operand = nullptr;
+            size_t m_offset = 0;
+        };
+
+    }
+
     class NodeNullptr : public dp::Node {
     public:
         NodeNullptr() : Node("hex.builtin.nodes.constants.nullptr.header", {
@@ -27,7 +173,8 @@ namespace hex::plugin::builtin {
             constexpr int StepSize = 1, FastStepSize = 10;
 
             ImGui::PushItemWidth(100);
-            ImGui::InputScalar("hex.builtin.nodes.constants.buffer.size"_lang, ImGuiDataType_U32, &this->m_size, &StepSize, &FastStepSize);
+            if (ImGui::InputScalar("hex.builtin.nodes.constants.buffer.size"_lang, ImGuiDataType_U32, &this->m_size, &StepSize, &FastStepSize))
+                this->markDirty();
             ImGui::PopItemWidth();
         }
 
@@ -53,7 +200,8 @@ namespace hex::plugin::builtin {
 
         void drawNode() override {
             ImGui::PushItemWidth(100);
-            ImGui::InputText("##string", reinterpret_cast<char*>(this->m_value.data()), this->m_value.size() - 1);
+            if (ImGui::InputText("##string", reinterpret_cast<char*>(this->m_value.data()), this->m_value.size() - 1))
+                this->markDirty();
             ImGui::PopItemWidth();
         }
 
@@ -63,7 +211,7 @@ namespace hex::plugin::builtin {
 
             output.pop_back();
 
-            this->setBufferOnOutput(0, output);
+            this->setBufferOnOutput(0, std::move(output));
         }
 
     private:
@@ -79,7 +227,8 @@ namespace hex::plugin::builtin {
         void drawNode() override {
             ImGui::TextUnformatted("0x"); ImGui::SameLine(0, 0);
             ImGui::PushItemWidth(100);
-            ImGui::InputScalar("##integerValue", ImGuiDataType_U64, &this->m_value, nullptr, nullptr, "%llx", ImGuiInputTextFlags_CharsHexadecimal);
+            if (ImGui::InputScalar("##integerValue", ImGuiDataType_U64, &this->m_value, nullptr, nullptr, "%llx", ImGuiInputTextFlags_CharsHexadecimal))
+                this->markDirty();
             ImGui::PopItemWidth();
         }
 
@@ -87,7 +236,7 @@ namespace hex::plugin::builtin {
             std::vector<u8> data(sizeof(this->m_value), 0);
 
             std::memcpy(data.data(), &this->m_value, sizeof(u64));
-            this->setBufferOnOutput(0, data);
+            this->setBufferOnOutput(0, std::move(data));
         }
 
     private:
@@ -102,7 +251,8 @@ namespace hex::plugin::builtin {
 
         void drawNode() override {
             ImGui::PushItemWidth(100);
-            ImGui::InputScalar("##floatValue", ImGuiDataType_Float, &this->m_value, nullptr, nullptr, "%f", ImGuiInputTextFlags_CharsDecimal);
+            if (ImGui::InputScalar("##floatValue", ImGuiDataType_Float, &this->m_value, nullptr, nullptr, "%f", ImGuiInputTextFlags_CharsDecimal))
+                this->markDirty();
             ImGui::PopItemWidth();
         }
 
@@ -111,7 +261,7 @@ namespace hex::plugin::builtin {
             data.resize(sizeof(this->m_value));
 
             std::copy(&this->m_value, &this->m_value + 1, data.data());
-            this->setBufferOnOutput(0, data);
+            this->setBufferOnOutput(0, std::move(data));
         }
 
     private:
@@ -128,7 +278,8 @@ namespace hex::plugin::builtin {
 
         void drawNode() override {
             ImGui::PushItemWidth(200);
-            ImGui::ColorPicker4("##colorPicker", &this->m_color.Value.x, ImGuiColorEditFlags_AlphaBar);
+            if (ImGui::ColorPicker4("##colorPicker", &this->m_color.Value.x, ImGuiColorEditFlags_AlphaBar))
+                this->markDirty();
             ImGui::PopItemWidth();
         }
 
@@ -223,13 +374,23 @@ namespace hex::plugin::builtin {
             dp::Attribute(dp::Attribute::IOType::Out, dp::Attribute::Type::Buffer, "hex.builtin.nodes.bitwise.not.output") }) {}
 
         void process() override {
-            auto input = this->getBufferOnInput(0);
+            const auto &input = this->getBufferOnInput(0);
+
+            constexpr static u8 AllBitsSet = 0xFF;
 
             std::vector<u8> output = input;
-            for (auto &byte : output)
-                byte = ~byte;
+            applyBitwiseRepeating<BitwiseOperation::XOR>(output.data(), output.size(), &AllBitsSet, 1);
+
+            this->setBufferOnOutput(1, std::move(output));
+        }
+
+        std::optional<Stream> getStream() override { return Stream{ 0, 1, true }; }
+
+        bool streamBlock(std::vector<u8> &block, bool) override {
+            constexpr static u8 AllBitsSet = 0xFF;
 
-            this->setBufferOnOutput(1, output);
+            applyBitwiseRepeating<BitwiseOperation::XOR>(block.data(), block.size(), &AllBitsSet, 1);
+            return true;
         }
     };
 
@@ -241,16 +402,21 @@ namespace hex::plugin::builtin {
             dp::Attribute(dp::Attribute::IOType::Out, dp::Attribute::Type::Buffer, "hex.builtin.nodes.bitwise.and.output") }) {}
 
         void process() override {
-            auto inputA = this->getBufferOnInput(0);
-            auto inputB = this->getBufferOnInput(1);
+            const auto &inputA = this->getBufferOnInput(0);
+            const auto &inputB = this->getBufferOnInput(1);
 
-            std::vector<u8> output(std::min(inputA.size(), inputB.size()), 0x00);
+            std::vector<u8> output(inputA.begin(), inputA.begin() + std::min(inputA.size(), inputB.size()));
+            applyBitwise<BitwiseOperation::AND>(output.data(), inputB.data(), output.size());
 
-            for (u32 i = 0; i < output.size(); i++)
-                output[i] = inputA[i] & inputB[i];
-
-            this->setBufferOnOutput(2, output);
+            this->setBufferOnOutput(2, std::move(output));
         }
+
+        std::optional<Stream> getStream() override { return Stream{ 0, 2, true }; }
+        void beginStream() override { this->m_stream.begin(this->getBufferOnInput(1), this->getStreamWindow().address); }
+        bool streamBlock(std::vector<u8> &block, bool) override { return this->m_stream.apply(block); }
+
+    private:
+        BitwiseOperandStream<BitwiseOperation::AND> m_stream;
     };
 
     class NodeBitwiseOR : public dp::Node {
@@ -261,16 +427,21 @@ namespace hex::plugin::builtin {
             dp::Attribute(dp::Attribute::IOType::Out, dp::Attribute::Type::Buffer, "hex.builtin.nodes.bitwise.or.output") }) {}
 
         void process() override {
-            auto inputA = this->getBufferOnInput(0);
-            auto inputB = this->getBufferOnInput(1);
-
-            std::vector<u8> output(std::min(inputA.size(), inputB.size()), 0x00);
+            const auto &inputA = this->getBufferOnInput(0);
+            const auto &inputB = this->getBufferOnInput(1);
 
-            for (u32 i = 0; i < output.size(); i++)
-                output[i] = inputA[i] | inputB[i];
+            std::vector<u8> output(inputA.begin(), inputA.begin() + std::min(inputA.size(), inputB.size()));
+            applyBitwise<BitwiseOperation::OR>(output.data(), inputB.data(), output.size());
 
-            this->setBufferOnOutput(2, output);
+            this->setBufferOnOutput(2, std::move(output));
         }
+
+        std::optional<Stream> getStream() override { return Stream{ 0, 2, true }; }
+        void beginStream() override { this->m_stream.begin(this->getBufferOnInput(1), this->getStreamWindow().address); }
+        bool streamBlock(std::vector<u8> &block, bool) override { return this->m_stream.apply(block); }
+
+    private:
+        BitwiseOperandStream<BitwiseOperation::OR> m_stream;
     };
 
     class NodeBitwiseXOR : public dp::Node {
@@ -281,16 +452,70 @@ namespace hex::plugin::builtin {
             dp::Attribute(dp::Attribute::IOType::Out, dp::Attribute::Type::Buffer, "hex.builtin.nodes.bitwise.xor.output") }) {}
 
         void process() override {
-            auto inputA = this->getBufferOnInput(0);
-            auto inputB = this->getBufferOnInput(1);
+            const auto &inputA = this->getBufferOnInput(0);
+            const auto &inputB = this->getBufferOnInput(1);
 
-            std::vector<u8> output(std::min(inputA.size(), inputB.size()), 0x00);
+            std::vector<u8> output(inputA.begin(), inputA.begin() + std::min(inputA.size(), inputB.size()));
+            applyBitwise<BitwiseOperation::XOR>(output.data(), inputB.data(), output.size());
 
-            for (u32 i = 0; i < output.size(); i++)
-                output[i] = inputA[i] ^ inputB[i];
+            this->setBufferOnOutput(2, std::move(output));
+        }
+
+        std::optional<Stream> getStream() override { return Stream{ 0, 2, true }; }
+        void beginStream() override { this->m_stream.begin(this->getBufferOnInput(1), this->getStreamWindow().address); }
+        bool streamBlock(std::vector<u8> &block, bool) override { return this->m_stream.apply(block); }
+
+    private:
+        BitwiseOperandStream<BitwiseOperation::XOR> m_stream;
+    };
+
+    class NodeBitwiseXORKey : public dp::Node {
+    public:
+        NodeBitwiseXORKey() : Node("hex.builtin.nodes.bitwise.xor_key.header", {
+            dp::Attribute(dp::Attribute::IOType::In, dp::Attribute::Type::Buffer, "hex.builtin.nodes.bitwise.xor_key.input"),
+            dp::Attribute(dp::Attribute::IOType::In, dp::Attribute::Type::Buffer, "hex.builtin.nodes.bitwise.xor_key.key"),
+            dp::Attribute(dp::Attribute::IOType::Out, dp::Attribute::Type::Buffer, "hex.builtin.nodes.bitwise.xor_key.output") }) {}
+
+        void process() override {
+            const auto &input = this->getBufferOnInput(0);
+            const auto &key = this->getBufferOnInput(1);
 
-            this->setBufferOnOutput(2, output);
+            if (key.empty())
+                throwNodeError("Key cannot be empty");
+
+            std::vector<u8> output = input;
+            applyBitwiseRepeating<BitwiseOperation::XOR>(output.data(), output.size(), key.data(), key.size());
+
+            this->setBufferOnOutput(2, std::move(output));
         }
+
+        std::optional<Stream> getStream() override { return Stream{ 0, 2, true }; }
+
+        void beginStream() override {
+            this->m_key = &this->getBufferOnInput(1);
+            this->m_streamOffset = this->getStreamWindow().address;
+
+            if (this->m_key->empty())
+                throwNodeError("Key cannot be empty");
+        }
+
+        bool streamBlock(std::vector<u8> &block, bool) override {
+            const auto &key = *this->m_key;
+
+            // Finish the key repetition the previous block stopped in before the rest lines up with the key again
+            auto phase = this->m_streamOffset % key.size();
+            auto head = std::min(block.size(), key.size() - phase);
+
+            applyBitwise<BitwiseOperation::XOR>(block.data(), key.data() + phase, head);
+            applyBitwiseRepeating<BitwiseOperation::XOR>(block.data() + head, block.size() - head, key.data(), key.size());
+
+            this->m_streamOffset += block.size();
+            return true;
+        }
+
+    private:
+        const std::vector<u8> *m_key = nullptr;
+        u64 m_streamOffset = 0;
     };
 
     class NodeReadData : public dp::Node {
@@ -308,10 +533,34 @@ namespace hex::plugin::builtin {
             std::vector<u8> data;
             data.resize(size);
 
-            SharedData::currentProvider->readRaw(address, data.data(), size);
+            this->getProvider()->readRaw(address, data.data(), size);
 
-            this->setBufferOnOutput(2, data);
+            this->setBufferOnOutput(2, std::move(data));
         }
+
+        std::optional<Stream> getStream() override { return Stream{ std::nullopt, 2, true }; }
+
+        void beginStream() override {
+            auto size = this->getIntegerOnInput(1);
+            auto &window = this->getStreamWindow();
+            auto start = std::min<u64>(window.address, size);
+
+            this->m_streamAddress = this->getIntegerOnInput(0) + start;
+            this->m_streamRemaining = std::min<u64>(size - start, window.size);
+        }
+
+        bool streamBlock(std::vector<u8> &block, bool) override {
+            block.resize(std::min<u64>(this->m_streamRemaining, StreamBlockSize));
+            this->getProvider()->readRaw(this->m_streamAddress, block.data(), block.size());
+
+            this->m_streamAddress += block.size();
+            this->m_streamRemaining -= block.size();
+
+            return this->m_streamRemaining > 0;
+        }
+
+    private:
+        u64 m_streamAddress = 0, m_streamRemaining = 0;
     };
 
     class NodeWriteData : public dp::Node {
@@ -322,10 +571,35 @@ namespace hex::plugin::builtin {
 
         void process() override {
             auto address = this->getIntegerOnInput(0);
-            auto data = this->getBufferOnInput(1);
+            const auto &data = this->getBufferOnInput(1);
 
             this->setOverlayData(address, data);
         }
+
+        std::optional<Stream> getStream() override { return Stream{ 1, std::nullopt, true }; }
+        std::optional<u64> getStreamAddress() override { return this->getIntegerOnInput(0); }
+
+        void beginStream() override {
+            this->m_streamAddress = this->getIntegerOnInput(0) + this->getStreamWindow().address;
+            this->m_streamedData = { };
+        }
+
+        bool streamBlock(std::vector<u8> &block, bool) override {
+            // Large outputs go to a temporary file block by block, they never have to fit into memory as a whole
+            if (!this->m_streamedData.append(block.data(), block.size()))
+                throwNodeError("Failed to store data in a temporary file");
+
+            return true;
+        }
+
+        void endStream() override {
+            this->setOverlayData(this->m_streamAddress, std::move(this->m_streamedData));
+            this->m_streamedData = { };
+        }
+
+    private:
+        u64 m_streamAddress = 0;
+        prv::OverlayData m_streamedData;
     };
 
     class NodeCastIntegerToBuffer : public dp::Node {
@@ -340,7 +614,7 @@ namespace hex::plugin::builtin {
             std::vector<u8> output(sizeof(u64), 0x00);
             std::memcpy(output.data(), &input, sizeof(u64));
 
-            this->setBufferOnOutput(1, output);
+            this->setBufferOnOutput(1, std::move(output));
         }
     };
 
@@ -351,7 +625,7 @@ namespace hex::plugin::builtin {
             dp::Attribute(dp::Attribute::IOType::Out, dp::Attribute::Type::Integer, "hex.builtin.nodes.casting.buffer_to_int.output") }) {}
 
         void process() override {
-            auto input = this->getBufferOnInput(0);
+            const auto &input = this->getBufferOnInput(0);
 
             u64 output;
             std::memcpy(&output, input.data(), sizeof(u64));
@@ -370,8 +644,8 @@ namespace hex::plugin::builtin {
 
         void process() override {
             auto cond = this->getIntegerOnInput(0);
-            auto trueData = this->getBufferOnInput(1);
-            auto falseData = this->getBufferOnInput(2);
+            const auto &trueData = this->getBufferOnInput(1);
+            const auto &falseData = this->getBufferOnInput(2);
 
             if (cond != 0)
                 this->setBufferOnOutput(3, trueData);
@@ -480,16 +754,18 @@ namespace hex::plugin::builtin {
 
         void drawNode() override {
             ImGui::PushItemWidth(100);
-            ImGui::Combo("hex.builtin.nodes.crypto.aes.mode"_lang, &this->m_mode, "ECB\0CBC\0CFB128\0CTR\0GCM\0CCM\0OFB\0");
-            ImGui::Combo("hex.builtin.nodes.crypto.aes.key_length"_lang, &this->m_keyLength, "128 Bits\000192 Bits\000256 Bits\000");
+            if (ImGui::Combo("hex.builtin.nodes.crypto.aes.mode"_lang, &this->m_mode, "ECB\0CBC\0CFB128\0CTR\0GCM\0CCM\0OFB\0XTS\0"))
+                this->markDirty();
+            if (ImGui::Combo("hex.builtin.nodes.crypto.aes.key_length"_lang, &this->m_keyLength, "128 Bits\000192 Bits\000256 Bits\000"))
+                this->markDirty();
             ImGui::PopItemWidth();
         }
 
         void process() override {
-            auto key = this->getBufferOnInput(0);
-            auto iv = this->getBufferOnInput(1);
-            auto nonce = this->getBufferOnInput(2);
-            auto input = this->getBufferOnInput(3);
+            const auto &key = this->getBufferOnInput(0);
+            const auto &iv = this->getBufferOnInput(1);
+            const auto &nonce = this->getBufferOnInput(2);
+            const auto &input = this->getBufferOnInput(3);
 
             if (key.empty())
                 throwNodeError("Key cannot be empty");
@@ -503,8 +779,10 @@ namespace hex::plugin::builtin {
             std::copy(nonce.begin(), nonce.end(), nonceData.begin());
 
             auto output = crypt::aesDecrypt(static_cast<crypt::AESMode>(this->m_mode), static_cast<crypt::KeyLength>(this->m_keyLength), key, nonceData, ivData, input);
+            if (output.empty())
+                throwNodeError("Invalid key length or unsupported mode");
 
-            this->setBufferOnOutput(4, output);
+            this->setBufferOnOutput(4, std::move(output));
         }
 
     private:
@@ -519,12 +797,65 @@ namespace hex::plugin::builtin {
             dp::Attribute(dp::Attribute::IOType::Out, dp::Attribute::Type::Buffer, "hex.builtin.nodes.decoding.base64.output") }) {}
 
         void process() override {
-            auto input = this->getBufferOnInput(0);
+            const auto &input = this->getBufferOnInput(0);
+
+            std::vector<u8> output(crypt::getMaxDecoded64Size(input.size()));
+            auto written = crypt::decode64(input, output.data());
+            if (!written.has_value())
+                throwNodeError("Can't decode non-base64 character");
 
-            auto output = crypt::decode64(input);
+            output.resize(*written);
 
-            this->setBufferOnOutput(1, output);
+            this->setBufferOnOutput(1, std::move(output));
         }
+
+        std::optional<Stream> getStream() override { return Stream{ 0, 1 }; }
+
+        void beginStream() override {
+            this->m_pending.clear();
+        }
+
+        bool streamBlock(std::vector<u8> &block, bool last) override {
+            std::span<const u8> input = block;
+            if (!this->m_pending.empty()) {
+                this->m_pending.insert(this->m_pending.end(), block.begin(), block.end());
+                input = this->m_pending;
+            }
+
+            // Only whole groups of four characters get decoded, the rest waits for the next block. Padding ends the data so everything after it is kept until the end
+            size_t split = input.size();
+            if (!last) {
+                constexpr static auto isWhitespace = [](u8 c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; };
+
+                if (auto padding = std::memchr(input.data(), '=', input.size()); padding != nullptr)
+                    split = static_cast<const u8*>(padding) - input.data();
+
+                auto characters = split - std::count_if(input.begin(), input.begin() + split, isWhitespace);
+                for (; characters % 4 != 0; split--) {
+                    if (!isWhitespace(input[split - 1]))
+                        characters--;
+                }
+            }
+
+            this->m_decoded.resize(crypt::getMaxDecoded64Size(split));
+            auto written = crypt::decode64(input.first(split), this->m_decoded.data());
+            if (!written.has_value())
+                throwNodeError("Can't decode non-base64 character");
+
+            this->m_decoded.resize(*written);
+            this->m_pending = std::vector<u8>(input.begin() + split, input.end());
+
+            std::swap(block, this->m_decoded);
+            return true;
+        }
+
+        void endStream() override {
+            this->m_pending = { };
+            this->m_decoded = { };
+        }
+
+    private:
+        std::vector<u8> m_pending, m_decoded;
     };
 
     class NodeDecodingHex : public dp::Node {
@@ -534,35 +865,394 @@ namespace hex::plugin::builtin {
                 dp::Attribute(dp::Attribute::IOType::Out, dp::Attribute::Type::Buffer, "hex.builtin.nodes.decoding.hex.output") }) {}
 
         void process() override {
-            auto input = this->getBufferOnInput(0);
+            const auto &input = this->getBufferOnInput(0);
 
             if (input.size() % 2 != 0)
                 throwNodeError("Can't decode odd number of hex characters");
 
-            std::vector<u8> output;
-            for (u32 i = 0; i < input.size(); i += 2) {
-                char c1 = static_cast<char>(std::tolower(input[i]));
-                char c2 = static_cast<char>(std::tolower(input[i + 1]));
+            std::vector<u8> output(input.size() / 2);
+            if (!crypt::decodeHex(input, output.data()).has_value())
+                throwNodeError("Can't decode non-hexadecimal character");
+
+            this->setBufferOnOutput(1, std::move(output));
+        }
 
-                if (!std::isxdigit(c1) || !isxdigit(c2))
+        std::optional<Stream> getStream() override { return Stream{ 0, 1 }; }
+
+        void beginStream() override {
+            this->m_pending.reset();
+        }
+
+        bool streamBlock(std::vector<u8> &block, bool last) override {
+            std::span<const u8> input = block;
+            size_t written = 0;
+
+            this->m_decoded.resize((block.size() + 1) / 2);
+
+            // A character left over from the previous block gets paired with the first one of this block
+            if (this->m_pending.has_value() && !input.empty()) {
+                std::array<u8, 2> pair = { *this->m_pending, input.front() };
+                if (!crypt::decodeHex(pair, this->m_decoded.data()).has_value())
                     throwNodeError("Can't decode non-hexadecimal character");
 
-                u8 value;
-                if (std::isdigit(c1))
-                    value = (c1 - '0') << 4;
-                else
-                    value = ((c1 - 'a') + 0x0A) << 4;
+                this->m_pending.reset();
+                input = input.subspan(1);
+                written++;
+            }
 
-                if (std::isdigit(c2))
-                    value |= c2 - '0';
-                else
-                    value |= (c2 - 'a') + 0x0A;
+            if (this->m_pending.has_value() || input.size() % 2 != 0) {
+                if (last)
+                    throwNodeError("Can't decode odd number of hex characters");
 
-                output.push_back(value);
+                if (!this->m_pending.has_value()) {
+                    this->m_pending = input.back();
+                    input = input.first(input.size() - 1);
+                }
             }
 
-            this->setBufferOnOutput(1, output);
+            if (!crypt::decodeHex(input, this->m_decoded.data() + written).has_value())
+                throwNodeError("Can't decode non-hexadecimal character");
+
+            this->m_decoded.resize(written + input.size() / 2);
+
+            std::swap(block, this->m_decoded);
+            return true;
+        }
+
+        void endStream() override {
+            this->m_decoded = { };
+        }
+
+    private:
+        std::optional<u8> m_pending;
+        std::vector<u8> m_decoded;
+    };
+
+    /*
+        Base of all decompression nodes. Decompressors never write more than one stream block at once,
+        so while streaming even a huge output only ever needs a block worth of memory in this node
+    */
+    class NodeDecompression : public dp::Node {
+    public:
+        explicit NodeDecompression(std::string_view unlocalizedName) : Node(unlocalizedName, {
+            dp::Attribute(dp::Attribute::IOType::In, dp::Attribute::Type::Buffer, "hex.builtin.nodes.decompression.input"),
+            dp::Attribute(dp::Attribute::IOType::Out, dp::Attribute::Type::Buffer, "hex.builtin.nodes.decompression.output") }) {}
+
+        void process() override {
+            std::span<const u8> input = this->getBufferOnInput(0);
+
+            this->beginDecompression();
+
+            std::vector<u8> output;
+            bool finished = false;
+            while (!finished) {
+                auto offset = output.size();
+                output.resize(offset + StreamBlockSize);
+
+                size_t written = StreamBlockSize;
+                finished = this->decompress(input, output.data() + offset, written);
+                output.resize(offset + written);
+
+                if (!finished && input.empty() && written == 0)
+                    throwNodeError("Compressed data ended unexpectedly");
+            }
+
+            this->endDecompression();
+
+            this->setBufferOnOutput(1, std::move(output));
+        }
+
+        std::optional<Stream> getStream() override { return Stream{ 0, 1 }; }
+
+        void beginStream() override {
+            this->m_input.clear();
+            this->m_remaining = { };
+            this->m_finished = this->m_last = this->m_outputFull = false;
+
+            this->beginDecompression();
+        }
+
+        bool streamBlock(std::vector<u8> &block, bool last) override {
+            if (this->m_finished) {
+                block.clear();
+                return false;
+            }
+
+            // The input block is kept until all of it got decompressed, its buffer gets reused for the output instead
+            if (!block.empty()) {
+                std::swap(this->m_input, block);
+                this->m_remaining = this->m_input;
+            }
+
+            block.resize(StreamBlockSize);
+
+            size_t written = block.size();
+            this->m_finished = this->decompress(this->m_remaining, block.data(), written);
+            block.resize(written);
+
+            this->m_outputFull = written == StreamBlockSize;
+            this->m_last = last;
+
+            if (!this->m_finished && last && this->m_remaining.empty() && written == 0)
+                throwNodeError("Compressed data ended unexpectedly");
+
+            return !this->m_finished;
         }
+
+        bool hasPendingOutput() override {
+            return !this->m_finished && (this->m_last || this->m_outputFull || !this->m_remaining.empty());
+        }
+
+        void endStream() override {
+            this->endDecompression();
+
+            this->m_input = { };
+            this->m_remaining = { };
+        }
+
+    protected:
+        virtual void beginDecompression() = 0;
+
+        /* Consumes data from the front of input and writes at most outputSize bytes, which then gets set to the number of bytes written. Returns true once the compressed data ended */
+        virtual bool decompress(std::span<const u8> &input, u8 *output, size_t &outputSize) = 0;
+
+        virtual void endDecompression() = 0;
+
+    private:
+        std::vector<u8> m_input;
+        std::span<const u8> m_remaining;
+        bool m_finished = false, m_last = false, m_outputFull = false;
+    };
+
+    class NodeDecompressionZlib : public NodeDecompression {
+    public:
+        NodeDecompressionZlib() : NodeDecompression("hex.builtin.nodes.decompression.zlib.header") {}
+        ~NodeDecompressionZlib() override { this->endDecompression(); }
+
+        void drawNode() override {
+            ImGui::PushItemWidth(100);
+            if (ImGui::Combo("hex.builtin.nodes.decompression.zlib.format"_lang, &this->m_format, "zlib / gzip\0Raw deflate\0"))
+                this->markDirty();
+            ImGui::PopItemWidth();
+        }
+
+    protected:
+        void beginDecompression() override {
+            this->endDecompression();
+
+            // zlib detects whether the data has a zlib or a gzip header by itself, raw deflate streams have none at all
+            this->m_stream = { };
+            if (inflateInit2(&this->m_stream, this->m_format == 0 ? MAX_WBITS + 32 : -MAX_WBITS) != Z_OK)
+                throwNodeError("Failed to initialize decompressor");
+
+            this->m_initialized = true;
+        }
+
+        bool decompress(std::span<const u8> &input, u8 *output, size_t &outputSize) override {
+            auto inputSize = std::min<size_t>(input.size(), std::numeric_limits<uInt>::max());
+
+            this->m_stream.next_in = const_cast<u8*>(input.data());
+            this->m_stream.avail_in = inputSize;
+            this->m_stream.next_out = output;
+            this->m_stream.avail_out = outputSize;
+
+            int result = inflate(&this->m_stream, Z_NO_FLUSH);
+
+            input = input.subspan(inputSize - this->m_stream.avail_in);
+            outputSize -= this->m_stream.avail_out;
+
+            if (result != Z_OK && result != Z_STREAM_END && result != Z_BUF_ERROR)
+                throwNodeError("Invalid compressed data");
+
+            return result == Z_STREAM_END;
+        }
+
+        void endDecompression() override {
+            if (this->m_initialized)
+                inflateEnd(&this->m_stream);
+
+            this->m_initialized = false;
+        }
+
+    private:
+        int m_format = 0;
+        z_stream m_stream = { };
+        bool m_initialized = false;
+    };
+
+#if defined(IMHEX_LZMA_SUPPORT)
+    class NodeDecompressionLZMA : public NodeDecompression {
+    public:
+        NodeDecompressionLZMA() : NodeDecompression("hex.builtin.nodes.decompression.lzma.header") {}
+        ~NodeDecompressionLZMA() override { this->endDecompression(); }
+
+    protected:
+        void beginDecompression() override {
+            // Handles both .xz and legacy .lzma streams
+            if (lzma_auto_decoder(&this->m_stream, UINT64_MAX, 0) != LZMA_OK)
+                throwNodeError("Failed to initialize decompressor");
+        }
+
+        bool decompress(std::span<const u8> &input, u8 *output, size_t &outputSize) override {
+            this->m_stream.next_in = input.data();
+            this->m_stream.avail_in = input.size();
+            this->m_stream.next_out = output;
+            this->m_stream.avail_out = outputSize;
+
+            lzma_ret result = lzma_code(&this->m_stream, LZMA_RUN);
+
+            input = input.subspan(input.size() - this->m_stream.avail_in);
+            outputSize -= this->m_stream.avail_out;
+
+            if (result != LZMA_OK && result != LZMA_STREAM_END && result != LZMA_BUF_ERROR)
+                throwNodeError("Invalid compressed data");
+
+            return result == LZMA_STREAM_END;
+        }
+
+        void endDecompression() override {
+            lzma_end(&this->m_stream);
+        }
+
+    private:
+        lzma_stream m_stream = LZMA_STREAM_INIT;
+    };
+#endif
+
+#if defined(IMHEX_ZSTD_SUPPORT)
+    class NodeDecompressionZstd : public NodeDecompression {
+    public:
+        NodeDecompressionZstd() : NodeDecompression("hex.builtin.nodes.decompression.zstd.header") {}
+        ~NodeDecompressionZstd() override { ZSTD_freeDCtx(this->m_context); }
+
+    protected:
+        void beginDecompression() override {
+            if (this->m_context == nullptr)
+                this->m_context = ZSTD_createDCtx();
+
+            if (this->m_context == nullptr)
+                throwNodeError("Failed to initialize decompressor");
+
+            ZSTD_DCtx_reset(this->m_context, ZSTD_reset_session_only);
+        }
+
+        bool decompress(std::span<const u8> &input, u8 *output, size_t &outputSize) override {
+            ZSTD_inBuffer in = { input.data(), input.size(), 0 };
+            ZSTD_outBuffer out = { output, outputSize, 0 };
+
+            size_t result = ZSTD_decompressStream(this->m_context, &out, &in);
+            if (ZSTD_isError(result))
+                throwNodeError("Invalid compressed data");
+
+            input = input.subspan(in.pos);
+            outputSize = out.pos;
+
+            return result == 0;
+        }
+
+        void endDecompression() override { }
+
+    private:
+        ZSTD_DCtx *m_context = nullptr;
+    };
+#endif
+
+#if defined(IMHEX_LZ4_SUPPORT)
+    class NodeDecompressionLZ4 : public NodeDecompression {
+    public:
+        NodeDecompressionLZ4() : NodeDecompression("hex.builtin.nodes.decompression.lz4.header") {}
+        ~NodeDecompressionLZ4() override { LZ4F_freeDecompressionContext(this->m_context); }
+
+    protected:
+        void beginDecompression() override {
+            LZ4F_freeDecompressionContext(this->m_context);
+            this->m_context = nullptr;
+
+            if (LZ4F_isError(LZ4F_createDecompressionContext(&this->m_context, LZ4F_VERSION)))
+                throwNodeError("Failed to initialize decompressor");
+        }
+
+        bool decompress(std::span<const u8> &input, u8 *output, size_t &outputSize) override {
+            size_t inputSize = input.size();
+
+            size_t result = LZ4F_decompress(this->m_context, output, &outputSize, input.data(), &inputSize, nullptr);
+            if (LZ4F_isError(result))
+                throwNodeError("Invalid compressed data");
+
+            input = input.subspan(inputSize);
+
+            return result == 0;
+        }
+
+        void endDecompression() override { }
+
+    private:
+        LZ4F_dctx *m_context = nullptr;
+    };
+#endif
+
+    class NodeMathExpression : public dp::Node {
+    public:
+        NodeMathExpression() : Node("hex.builtin.nodes.math.expression.header", {
+                dp::Attribute(dp::Attribute::IOType::In, dp::Attribute::Type::Buffer, "hex.builtin.nodes.math.expression.input"),
+                dp::Attribute(dp::Attribute::IOType::Out, dp::Attribute::Type::Buffer, "hex.builtin.nodes.math.expression.output") }) {
+            this->m_expression.resize(0xFF, 0x00);
+            std::strcpy(this->m_expression.data(), "x");
+
+            this->m_evaluator.registerStandardFunctions();
+        }
+
+        void drawNode() override {
+            ImGui::PushItemWidth(150);
+            if (ImGui::InputText("hex.builtin.nodes.math.expression.formula"_lang, this->m_expression.data(), this->m_expression.size() - 1))
+                this->markDirty();
+            if (ImGui::Combo("hex.builtin.nodes.math.expression.value_size"_lang, &this->m_valueSize, "1 Byte " "2 Bytes " "4 Bytes " "8 Bytes "))
+                this->markDirty();
+            ImGui::PopItemWidth();
+        }
+
+        void process() override {
+            const auto &input = this->getBufferOnInput(0);
+            const size_t valueSize = 1U << this->m_valueSize;
+
+            if (input.size() % valueSize != 0)
+                throwNodeError("Input size isn't a multiple of the value size");
+
+            // Values are the element x of the formula, unsigned and little endian
+            std::vector<long double> values(input.size() / valueSize);
+            for (size_t i = 0; i < values.size(); i++) {
+                u64 value = 0;
+                std::memcpy(&value, input.data() + i * valueSize, valueSize);
+                values[i] = value;
+            }
+
+            std::vector<long double> results(values.size());
+            try {
+                auto program = this->m_evaluator.compile(this->m_expression.c_str());
+
+                auto slot = program.getSlot("x");
+                if (!slot.has_value())
+                    throwNodeError("Formula doesn't use x");
+
+                std::vector<long double> slots(program.variables.size(), 0);
+                this->m_evaluator.evaluateBatch(program, slot.value(), slots, values, results);
+            } catch (std::invalid_argument &e) {
+                throwNodeError(e.what());
+            }
+
+            std::vector<u8> output(input.size());
+            for (size_t i = 0; i < results.size(); i++) {
+                u64 value = results[i] < 0 ? u64(s64(results[i])) : u64(results[i]);
+                std::memcpy(output.data() + i * valueSize, &value, valueSize);
+            }
+
+            this->setBufferOnOutput(1, std::move(output));
+        }
+
+    private:
+        std::string m_expression;
+        int m_valueSize = 0;
+        MathEvaluator m_evaluator;
     };
 
     void registerDataProcessorNodes() {
@@ -594,12 +1284,26 @@ namespace hex::plugin::builtin {
         ContentRegistry::DataProcessorNode::add<NodeBitwiseAND>("hex.builtin.nodes.bitwise", "hex.builtin.nodes.bitwise.and");
         ContentRegistry::DataProcessorNode::add<NodeBitwiseOR>("hex.builtin.nodes.bitwise", "hex.builtin.nodes.bitwise.or");
         ContentRegistry::DataProcessorNode::add<NodeBitwiseXOR>("hex.builtin.nodes.bitwise", "hex.builtin.nodes.bitwise.xor");
+        ContentRegistry::DataProcessorNode::add<NodeBitwiseXORKey>("hex.builtin.nodes.bitwise", "hex.builtin.nodes.bitwise.xor_key");
         ContentRegistry::DataProcessorNode::add<NodeBitwiseNOT>("hex.builtin.nodes.bitwise", "hex.builtin.nodes.bitwise.not");
 
         ContentRegistry::DataProcessorNode::add<NodeDecodingBase64>("hex.builtin.nodes.decoding", "hex.builtin.nodes.decoding.base64");
         ContentRegistry::DataProcessorNode::add<NodeDecodingHex>("hex.builtin.nodes.decoding", "hex.builtin.nodes.decoding.hex");
 
         ContentRegistry::DataProcessorNode::add<NodeCryptoAESDecrypt>("hex.builtin.nodes.crypto", "hex.builtin.nodes.crypto.aes");
+
+        ContentRegistry::DataProcessorNode::add<NodeDecompressionZlib>("hex.builtin.nodes.decompression", "hex.builtin.nodes.decompression.zlib");
+    #if defined(IMHEX_LZMA_SUPPORT)
+        ContentRegistry::DataProcessorNode::add<NodeDecompressionLZMA>("hex.builtin.nodes.decompression", "hex.builtin.nodes.decompression.lzma");
+    #endif
+    #if defined(IMHEX_ZSTD_SUPPORT)
+        ContentRegistry::DataProcessorNode::add<NodeDecompressionZstd>("hex.builtin.nodes.decompression", "hex.builtin.nodes.decompression.zstd");
+    #endif
+    #if defined(IMHEX_LZ4_SUPPORT)
+        ContentRegistry::DataProcessorNode::add<NodeDecompressionLZ4>("hex.builtin.nodes.decompression", "hex.builtin.nodes.decompression.lz4");
+    #endif
+
+        ContentRegistry::DataProcessorNode::add<NodeMathExpression>("hex.builtin.nodes.math", "hex.builtin.nodes.math.expression");
     }
 
 }
\ No newline at end of file
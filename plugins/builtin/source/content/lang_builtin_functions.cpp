@@ -4,14 +4,63 @@
 #include <hex/lang/log_console.hpp>
 #include <hex/lang/evaluator.hpp>
 
+#include <hex/helpers/crypto.hpp>
+#include <hex/helpers/search.hpp>
 #include <hex/helpers/utils.hpp>
 
+#include <algorithm>
+#include <array>
+#include <cstring>
 #include <vector>
 
 namespace hex::plugin::builtin {
 
     #define LITERAL_COMPARE(literal, cond) std::visit([&](auto &&literal) { return (cond) != 0; }, literal)
     #define AS_TYPE(type, value) ctx.template asType<type>(value)
+    #define AS_U64(param) std::visit([](auto &&value) -> u64 { return value; }, AS_TYPE(ASTNodeIntegerLiteral, param)->getValue())
+
+    namespace {
+
+        constexpr size_t SumBlockSize = 0x10'0000;
+
+        template<typename T>
+        u64 sumWords(const u8 *data, size_t size, std::endian endian) {
+            u64 sum = 0;
+            for (size_t i = 0; i < size; i += sizeof(T)) {
+                T word;
+                std::memcpy(&word, data + i, sizeof(T));
+                sum += hex::changeEndianess(word, endian);
+            }
+
+            return sum;
+        }
+
+        /* Sum of all words of the region, wrapping around at 64 bits. Offsets are absolute */
+        u64 sumRegion(prv::Provider *provider, u64 offset, size_t size, u8 width, std::endian endian) {
+            const auto sumBlock = [&](const u8 *data, size_t blockSize) {
+                switch (width) {
+                    case 1:  return sumWords<u8>(data, blockSize, endian);
+                    case 2:  return sumWords<u16>(data, blockSize, endian);
+                    case 4:  return sumWords<u32>(data, blockSize, endian);
+                    default: return sumWords<u64>(data, blockSize, endian);
+                }
+            };
+
+            if (auto view = provider->getAbsoluteDirectView(offset, size); view.has_value())
+                return sumBlock(view->data(), view->size());
+
+            u64 sum = 0;
+            std::vector<u8> buffer(std::min(SumBlockSize, size));
+            for (u64 blockOffset = 0; blockOffset < size; blockOffset += buffer.size()) {
+                size_t blockSize = std::min<u64>(buffer.size(), size - blockOffset);
+                provider->readAbsolute(offset + blockOffset, buffer.data(), blockSize);
+                sum += sumBlock(buffer.data(), blockSize);
+            }
+
+            return sum;
+        }
+
+    }
 
     void registerPatternLanguageFunctions() {
         using namespace hex::lang;
@@ -29,30 +78,37 @@ namespace hex::plugin::builtin {
                }, AS_TYPE(ASTNodeIntegerLiteral, params[i])->getValue()));
            }
 
-           std::vector<u8> bytes(sequence.size(), 0x00);
-           u32 occurrences = 0;
-           for (u64 offset = 0; offset < SharedData::currentProvider->getSize() - sequence.size(); offset++) {
-               SharedData::currentProvider->read(offset, bytes.data(), bytes.size());
-
-               if (bytes == sequence) {
-                   if (LITERAL_COMPARE(occurrenceIndex, occurrences < occurrenceIndex)) {
-                       occurrences++;
-                       continue;
-                   }
+           auto index = std::visit([](auto &&value) -> u64 { return value; }, occurrenceIndex);
+           const auto &occurrences = ctx.getSequenceOccurrences(sequence);
 
-                   return new ASTNodeIntegerLiteral({ Token::ValueType::Unsigned64Bit, offset });
-               }
-           }
+           if (index < occurrences.size())
+               return new ASTNodeIntegerLiteral({ Token::ValueType::Unsigned64Bit, occurrences[index] });
 
            ctx.getConsole().abortEvaluation("failed to find sequence");
        });
 
+        /* findSignature(occurrenceIndex, signature) */
+        ContentRegistry::PatternLanguageFunctions::add("findSignature", 2, [](auto &ctx, auto params) {
+            auto occurrenceIndex = std::visit([](auto &&value) -> u64 { return value; }, AS_TYPE(ASTNodeIntegerLiteral, params[0])->getValue());
+            auto signature = AS_TYPE(ASTNodeStringLiteral, params[1])->getString();
+
+            std::vector<u8> bytes, mask;
+            if (!SequenceSearcher::parseHexPattern(signature, bytes, mask) || bytes.empty())
+                ctx.getConsole().abortEvaluation("invalid signature");
+
+            const auto &occurrences = ctx.getSequenceOccurrences(bytes, mask);
+            if (occurrenceIndex >= occurrences.size())
+                ctx.getConsole().abortEvaluation("failed to find signature");
+
+            return new ASTNodeIntegerLiteral({ Token::ValueType::Unsigned64Bit, occurrences[occurrenceIndex] });
+        });
+
         /* readUnsigned(address, size) */
         ContentRegistry::PatternLanguageFunctions::add("readUnsigned", 2, [](auto &ctx, auto params) {
             auto address = AS_TYPE(ASTNodeIntegerLiteral, params[0])->getValue();
             auto size = AS_TYPE(ASTNodeIntegerLiteral, params[1])->getValue();
 
-            if (LITERAL_COMPARE(address, address >= SharedData::currentProvider->getActualSize()))
+            if (LITERAL_COMPARE(address, address >= ctx.getProvider()->getActualSize()))
                 ctx.getConsole().abortEvaluation("address out of range");
 
             return std::visit([&](auto &&address, auto &&size) {
@@ -60,7 +116,7 @@ namespace hex::plugin::builtin {
                     ctx.getConsole().abortEvaluation("invalid read size");
 
                 u8 value[(u8)size];
-                SharedData::currentProvider->read(address, value, size);
+                ctx.readData(address, value, size);
 
                 switch ((u8)size) {
                 case 1:  return new ASTNodeIntegerLiteral({ Token::ValueType::Unsigned8Bit,   *reinterpret_cast<u8*>(value)   });
@@ -78,7 +134,7 @@ namespace hex::plugin::builtin {
             auto address = AS_TYPE(ASTNodeIntegerLiteral, params[0])->getValue();
             auto size = AS_TYPE(ASTNodeIntegerLiteral, params[1])->getValue();
 
-            if (LITERAL_COMPARE(address, address >= SharedData::currentProvider->getActualSize()))
+            if (LITERAL_COMPARE(address, address >= ctx.getProvider()->getActualSize()))
                 ctx.getConsole().abortEvaluation("address out of range");
 
             return std::visit([&](auto &&address, auto &&size) {
@@ -86,7 +142,7 @@ namespace hex::plugin::builtin {
                     ctx.getConsole().abortEvaluation("invalid read size");
 
                 u8 value[(u8)size];
-                SharedData::currentProvider->read(address, value, size);
+                ctx.readData(address, value, size);
 
                 switch ((u8)size) {
                 case 1:  return new ASTNodeIntegerLiteral({ Token::ValueType::Signed8Bit,   *reinterpret_cast<s8*>(value)   });
@@ -111,7 +167,7 @@ namespace hex::plugin::builtin {
         });
 
         /* warnAssert(condition, message) */
-        ContentRegistry::PatternLanguageFunctions::add("warnAssert", 2, [](auto ctx, auto params) {
+        ContentRegistry::PatternLanguageFunctions::add("warnAssert", 2, [](auto &ctx, auto params) {
             auto condition = AS_TYPE(ASTNodeIntegerLiteral, params[0])->getValue();
             auto message = AS_TYPE(ASTNodeStringLiteral, params[1])->getString();
 
@@ -196,9 +252,55 @@ namespace hex::plugin::builtin {
             return new ASTNodeIntegerLiteral({ Token::ValueType::Unsigned64Bit, u64(result) });
         });
 
+        /* crc32(address, size, polynomial) */
+        ContentRegistry::PatternLanguageFunctions::add("crc32", 3, [](auto &ctx, auto params) -> ASTNode* {
+            auto address = AS_U64(params[0]);
+            auto size = AS_U64(params[1]);
+            auto polynomial = AS_U64(params[2]);
+
+            // The polynomial is in reflected form, like everywhere else, e.g. 0xEDB88320 for the common CRC-32
+            auto provider = ctx.getProvider();
+            auto crc = crypt::crc32(provider, ctx.useRegion(address, size), size, u32(polynomial), 0xFFFF'FFFF);
+
+            return new ASTNodeIntegerLiteral({ Token::ValueType::Unsigned32Bit, crc });
+        });
+
+        /* sha256(address, size, digestAddress) */
+        ContentRegistry::PatternLanguageFunctions::add("sha256", 3, [](auto &ctx, auto params) -> ASTNode* {
+            auto address = AS_U64(params[0]);
+            auto size = AS_U64(params[1]);
+            auto digestAddress = AS_U64(params[2]);
+
+            // Digests don't fit into an integer, the one stored in the data gets compared instead
+            std::array<u8, 32> expected;
+            ctx.readData(digestAddress, expected.data(), expected.size());
+
+            auto provider = ctx.getProvider();
+            auto digest = crypt::sha256(provider, ctx.useRegion(address, size), size);
+
+            return new ASTNodeIntegerLiteral({ Token::ValueType::Boolean, s32(digest == expected) });
+        });
+
+        /* sum(address, size, width) */
+        ContentRegistry::PatternLanguageFunctions::add("sum", 3, [](auto &ctx, auto params) -> ASTNode* {
+            auto address = AS_U64(params[0]);
+            auto size = AS_U64(params[1]);
+            auto width = AS_U64(params[2]);
+
+            if (width != 1 && width != 2 && width != 4 && width != 8)
+                ctx.getConsole().abortEvaluation("invalid word width");
+            if (size % width != 0)
+                ctx.getConsole().abortEvaluation("size needs to be a multiple of the word width");
+
+            auto sum = sumRegion(ctx.getProvider(), ctx.useRegion(address, size), size, width, ctx.getCurrentEndian());
+
+            return new ASTNodeIntegerLiteral({ Token::ValueType::Unsigned64Bit, sum });
+        });
+
         /* dataSize() */
         ContentRegistry::PatternLanguageFunctions::add("dataSize", ContentRegistry::PatternLanguageFunctions::NoParameters, [](auto &ctx, auto params) -> ASTNode* {
-            return new ASTNodeIntegerLiteral({ Token::ValueType::Unsigned64Bit, u64(SharedData::currentProvider->getActualSize()) });
+            ctx.recordEndOfData();
+            return new ASTNodeIntegerLiteral({ Token::ValueType::Unsigned64Bit, u64(ctx.getProvider()->getActualSize()) });
         });
     }
 
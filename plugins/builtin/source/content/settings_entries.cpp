@@ -4,6 +4,39 @@ namespace hex::plugin::builtin {
 
     void registerSettings() {
 
+        ContentRegistry::Settings::add("hex.builtin.setting.imhex", "hex.builtin.setting.imhex.fast_start", 0, [](auto name, nlohmann::json &setting) {
+            static bool fastStart = static_cast<int>(setting) != 0;
+
+            if (ImGui::Checkbox(name.data(), &fastStart)) {
+                setting = static_cast<int>(fastStart);
+                return true;
+            }
+
+            return false;
+        });
+
+        ContentRegistry::Settings::add("hex.builtin.setting.imhex", "hex.builtin.setting.imhex.restore_session", 1, [](auto name, nlohmann::json &setting) {
+            static bool restoreSession = static_cast<int>(setting) != 0;
+
+            if (ImGui::Checkbox(name.data(), &restoreSession)) {
+                setting = static_cast<int>(restoreSession);
+                return true;
+            }
+
+            return false;
+        });
+
+        ContentRegistry::Settings::add("hex.builtin.setting.imhex", "hex.builtin.setting.imhex.memory_budget", 2048, [](auto name, nlohmann::json &setting) {
+            static int budget = setting;
+
+            if (ImGui::SliderInt(name.data(), &budget, 64, 65536, "%d MiB", ImGuiSliderFlags_Logarithmic)) {
+                setting = budget;
+                return true;
+            }
+
+            return false;
+        });
+
         ContentRegistry::Settings::add("hex.builtin.setting.interface", "hex.builtin.setting.interface.color", 0, [](auto name, nlohmann::json &setting) {
             static int selection = setting;
 
@@ -61,6 +94,61 @@ namespace hex::plugin::builtin {
             return false;
         });
 
+        ContentRegistry::Settings::add("hex.builtin.setting.hex_editor", "hex.builtin.setting.hex_editor.undo_history", 16, [](auto name, nlohmann::json &setting) {
+            static int budget = setting;
+
+            if (ImGui::SliderInt(name.data(), &budget, 1, 1024, "%d MiB")) {
+                setting = budget;
+                return true;
+            }
+
+            return false;
+        });
+
+        ContentRegistry::Settings::add("hex.builtin.setting.hex_editor", "hex.builtin.setting.hex_editor.async_queue_depth", 32, [](auto name, nlohmann::json &setting) {
+            static int queueDepth = setting;
+
+            if (ImGui::SliderInt(name.data(), &queueDepth, 1, 256)) {
+                setting = queueDepth;
+                return true;
+            }
+
+            return false;
+        });
+
+        ContentRegistry::Settings::add("hex.builtin.setting.hex_editor", "hex.builtin.setting.hex_editor.async_block_size", 128, [](auto name, nlohmann::json &setting) {
+            static int blockSize = setting;
+
+            if (ImGui::SliderInt(name.data(), &blockSize, 4, 4096, "%d KiB")) {
+                setting = blockSize;
+                return true;
+            }
+
+            return false;
+        });
+
+        ContentRegistry::Settings::add("hex.builtin.setting.hex_editor", "hex.builtin.setting.hex_editor.minimap", 1, [](auto name, nlohmann::json &setting) {
+            static bool minimap = static_cast<int>(setting) != 0;
+
+            if (ImGui::Checkbox(name.data(), &minimap)) {
+                setting = static_cast<int>(minimap);
+                return true;
+            }
+
+            return false;
+        });
+
+        ContentRegistry::Settings::add("hex.builtin.setting.hex_editor", "hex.builtin.setting.hex_editor.gpu_grid", 0, [](auto name, nlohmann::json &setting) {
+            static bool gpuGrid = static_cast<int>(setting) != 0;
+
+            if (ImGui::Checkbox(name.data(), &gpuGrid)) {
+                setting = static_cast<int>(gpuGrid);
+                return true;
+            }
+
+            return false;
+        });
+
     }
 
 }
\ No newline at end of file
@@ -1,7 +1,12 @@
 #include <hex/plugin.hpp>
+#include <hex/api/task.hpp>
 
+#include <chrono>
+#include <mutex>
 #include <regex>
 
+#include <imgui_imhex_extensions.h>
+
 #include <llvm/Demangle/Demangle.h>
 #include "math_evaluator.hpp"
 
@@ -75,24 +80,87 @@ namespace hex::plugin::builtin {
         }
 
         void drawRegexReplacer() {
-            static std::vector<char> regexInput(0xF'FFFF, 0x00);;
-            static std::vector<char> regexPattern(0xF'FFFF, 0x00);;
-            static std::vector<char> replacePattern(0xF'FFFF, 0x00);;
-            static std::string regexOutput(0xF'FFFF, 0x00);;
+            constexpr static auto EvaluationDelay = std::chrono::milliseconds(250);
+
+            static std::string regexInput, regexPattern, replacePattern;
+            static std::string regexOutput, regexError;
+
+            // Compiling the pattern is the expensive part, it only happens again once the pattern text itself changed
+            static std::string compiledPattern;
+            static std::shared_ptr<const std::regex> compiledRegex;
+
+            static TaskHolder replaceTask;
+            static std::mutex resultMutex;
+            static std::optional<std::string> pendingOutput;
+
+            static bool evaluationPending = false;
+            static std::chrono::steady_clock::time_point lastChange;
 
             bool shouldInvalidate;
 
-            shouldInvalidate = ImGui::InputText("hex.builtin.tools.regex_replacer.pattern"_lang, regexPattern.data(), regexPattern.size());
-            shouldInvalidate = ImGui::InputText("hex.builtin.tools.regex_replacer.replace"_lang, replacePattern.data(), replacePattern.size()) || shouldInvalidate;
-            shouldInvalidate = ImGui::InputTextMultiline("hex.builtin.tools.regex_replacer.input"_lang, regexInput.data(), regexInput.size())  || shouldInvalidate;
+            shouldInvalidate = ImGui::InputText("hex.builtin.tools.regex_replacer.pattern"_lang, regexPattern);
+            shouldInvalidate = ImGui::InputText("hex.builtin.tools.regex_replacer.replace"_lang, replacePattern) || shouldInvalidate;
+            shouldInvalidate = ImGui::InputTextMultiline("hex.builtin.tools.regex_replacer.input"_lang, regexInput) || shouldInvalidate;
 
+            // Results of an outdated evaluation are useless, it gets stopped and another one starts once typing paused
             if (shouldInvalidate) {
-                try {
-                    regexOutput = std::regex_replace(regexInput.data(), std::regex(regexPattern.data()), replacePattern.data());
-                } catch (std::regex_error&) {}
+                replaceTask.interrupt();
+                evaluationPending = true;
+                lastChange = std::chrono::steady_clock::now();
             }
 
-            ImGui::InputTextMultiline("hex.builtin.tools.regex_replacer.input"_lang, regexOutput.data(), regexOutput.size(), ImVec2(0, 0), ImGuiInputTextFlags_ReadOnly);
+            {
+                std::scoped_lock lock(resultMutex);
+                if (pendingOutput.has_value()) {
+                    regexOutput = std::move(pendingOutput.value());
+                    pendingOutput.reset();
+                }
+            }
+
+            if (evaluationPending && !replaceTask.isRunning() && std::chrono::steady_clock::now() - lastChange >= EvaluationDelay) {
+                evaluationPending = false;
+
+                if (compiledRegex == nullptr || compiledPattern != regexPattern) {
+                    try {
+                        compiledRegex = std::make_shared<const std::regex>(regexPattern);
+                        compiledPattern = regexPattern;
+                        regexError.clear();
+                    } catch (const std::regex_error &e) {
+                        compiledRegex = nullptr;
+                        regexError = e.what();
+                    }
+                }
+
+                if (compiledRegex != nullptr) {
+                    replaceTask = TaskManager::createTask("hex.builtin.tools.regex_replacer.replacing", 0, [regex = compiledRegex, input = regexInput, replace = replacePattern](Task &task) {
+                        const auto &interrupted = task.getInterruptFlag();
+
+                        // Same as std::regex_replace, but stops as soon as the inputs changed again
+                        std::string output;
+                        auto last = input.cbegin();
+                        for (auto it = std::sregex_iterator(input.cbegin(), input.cend(), *regex); it != std::sregex_iterator(); ++it) {
+                            if (interrupted)
+                                return;
+
+                            output.append(last, (*it)[0].first);
+                            output += it->format(replace);
+                            last = (*it)[0].second;
+                        }
+                        output.append(last, input.cend());
+
+                        std::scoped_lock lock(resultMutex);
+                        pendingOutput = std::move(output);
+                    });
+                }
+            }
+
+            ImGui::InputTextMultiline("hex.builtin.tools.regex_replacer.output"_lang, regexOutput, ImVec2(0, 0), ImGuiInputTextFlags_ReadOnly);
+
+            if (evaluationPending || replaceTask.isRunning())
+                ImGui::TextSpinner("hex.builtin.tools.regex_replacer.replacing"_lang);
+            else if (!regexError.empty())
+                ImGui::TextColored(ImVec4(0.92F, 0.25F, 0.2F, 1.0F), "%s", regexError.c_str());
+
             ImGui::NewLine();
         }
 
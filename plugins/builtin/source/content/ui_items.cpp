@@ -0,0 +1,55 @@
+#include <hex/plugin.hpp>
+
+#include <hex/api/task.hpp>
+
+#include <imgui_imhex_extensions.h>
+
+namespace hex::plugin::builtin {
+
+    void registerFooterItems() {
+
+        ContentRegistry::Interface::addFooterItem([] {
+            auto tasks = TaskManager::getRunningTasks();
+            if (tasks.empty())
+                return;
+
+            // Only the newest task fits into the footer, the rest are listed when hovering it
+            auto &task = tasks.back();
+            auto progress = task->getProgress();
+
+            ImGui::BeginGroup();
+            if (progress < 0) {
+                ImGui::TextSpinner(LangEntry(task->getUnlocalizedName()));
+            } else {
+                ImGui::TextUnformatted(LangEntry(task->getUnlocalizedName()));
+                ImGui::SameLine();
+                ImGui::ProgressBar(progress, ImVec2(150, ImGui::GetTextLineHeight()), "");
+            }
+
+            if (tasks.size() > 1) {
+                ImGui::SameLine();
+                ImGui::TextUnformatted(hex::format("hex.footer.tasks.more"_lang, tasks.size() - 1).c_str());
+            }
+            ImGui::EndGroup();
+
+            if (ImGui::IsItemHovered()) {
+                ImGui::BeginTooltip();
+                for (const auto &runningTask : tasks) {
+                    if (auto taskProgress = runningTask->getProgress(); taskProgress < 0)
+                        ImGui::TextUnformatted(LangEntry(runningTask->getUnlocalizedName()));
+                    else
+                        ImGui::TextUnformatted(hex::format("{} ({:.0f}%)", LangEntry(runningTask->getUnlocalizedName()).get(), taskProgress * 100).c_str());
+                }
+                ImGui::EndTooltip();
+            }
+
+            ImGui::SameLine();
+            ImGui::PushID(task.get());
+            if (ImGui::SmallButton("hex.common.cancel"_lang))
+                task->interrupt();
+            ImGui::PopID();
+        });
+
+    }
+
+}
\ No newline at end of file
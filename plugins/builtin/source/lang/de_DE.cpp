@@ -11,9 +11,52 @@ namespace hex::plugin::builtin {
                 { "hex.menu.edit", "Bearbeiten" },
                 { "hex.menu.view", "Ansicht" },
                     { "hex.menu.view.fps", "FPS anzeigen" },
+                    { "hex.menu.view.profiler", "Profiler anzeigen" },
                     { "hex.menu.view.demo", "ImGui Demo anzeigen" },
                 { "hex.menu.help", "Hilfe" },
 
+                { "hex.profiler.title", "Profiler" },
+                    { "hex.profiler.section", "Abschnitt" },
+                    { "hex.profiler.time", "Durchschnittliche Zeit" },
+                    { "hex.profiler.peak", "Höchste Zeit" },
+                    { "hex.profiler.allocations", "Allokationen pro Frame" },
+                    { "hex.profiler.reads", "Lesezugriffe pro Frame" },
+                    { "hex.profiler.read_bytes", "Gelesen pro Frame" },
+                    { "hex.profiler.sections", "Abschnitte" },
+                    { "hex.profiler.memory", "Speicher" },
+                    { "hex.profiler.memory.total", "{0} von {1} durch Caches belegt" },
+                    { "hex.profiler.memory.subsystem", "Bereich" },
+                    { "hex.profiler.memory.caches", "Caches" },
+                    { "hex.profiler.memory.usage", "Belegt" },
+                    { "hex.profiler.memory.evicted", "Verworfen" },
+                    { "hex.profiler.io", "E/A" },
+                    { "hex.profiler.io.description", "Lesezugriffe auf den aktuellen Provider solange der Profiler offen ist" },
+                    { "hex.profiler.io.reset", "Zurücksetzen" },
+                    { "hex.profiler.io.cause", "Verursacht durch" },
+                    { "hex.profiler.io.untagged", "Andere" },
+                    { "hex.profiler.io.reads", "Lesezugriffe" },
+                    { "hex.profiler.io.read_bytes", "Gelesen" },
+                    { "hex.profiler.io.patch_hits", "Gepatchte Lesezugriffe" },
+                    { "hex.profiler.io.cache_hits", "Cache-Treffer" },
+                    { "hex.profiler.io.cache_misses", "Cache-Fehlzugriffe" },
+                    { "hex.profiler.io.raw_reads", "Direkte Lesezugriffe" },
+                    { "hex.profiler.io.raw_read_bytes", "Direkt gelesen" },
+                    { "hex.profiler.io.raw_read_time", "Zeit für direkte Lesezugriffe" },
+                    { "hex.profiler.trace", "Trace" },
+                    { "hex.profiler.trace.description", "Zeichnet auf, was jeder Thread tut, zum Anzeigen in chrome://tracing oder Perfetto" },
+                    { "hex.profiler.trace.record", "Aufzeichnen" },
+                    { "hex.profiler.trace.events", "{0} Ereignisse aufgezeichnet" },
+                    { "hex.profiler.trace.export", "Exportieren..." },
+                    { "hex.profiler.trace.export_error", "Trace konnte nicht geschrieben werden!" },
+
+                { "hex.memory.block_cache", "Block-Cache der Provider" },
+                { "hex.memory.strings", "Strings anderer Provider" },
+                { "hex.memory.information", "Analysen anderer Provider" },
+                { "hex.memory.patterns", "Patterns anderer Provider" },
+                { "hex.memory.disassembly", "Disassembly-Index" },
+
+                { "hex.footer.tasks.more", "+{0} weitere" },
+
                 { "hex.welcome.header.main", "Wilkommen zu ImHex" },
                 { "hex.welcome.header.start", "Start" },
                     { "hex.welcome.start.open_file", "Datei Öffnen" },
@@ -60,6 +103,10 @@ namespace hex::plugin::builtin {
                 { "hex.common.load", "Laden" },
                 { "hex.common.cancel", "Abbrechen" },
                 { "hex.common.set", "Setzen" },
+                { "hex.common.autosaving", "Projekt wird automatisch gespeichert" },
+                { "hex.common.storing_settings", "Einstellungen werden gespeichert" },
+                { "hex.common.font_atlas.building", "Schriftatlas wird erstellt" },
+                { "hex.common.sorting", "Sortieren" },
 
                 { "hex.view.bookmarks.name", "Lesezeichen" },
                     { "hex.view.bookmarks.default_title", "Lesezeichen [0x{0:X} - 0x{1:X}]" },
@@ -71,17 +118,31 @@ namespace hex::plugin::builtin {
                     { "hex.view.bookmarks.header.name", "Name" },
                     { "hex.view.bookmarks.header.color", "Farbe" },
                     { "hex.view.bookmarks.header.comment", "Kommentar" },
+                    { "hex.view.bookmarks.header.preview", "Vorschau" },
 
                 { "hex.view.command_palette.name", "Befehlspalette" },
+                    { "hex.view.command_palette.file", "Datei" },
+                    { "hex.view.command_palette.bookmark", "Lesezeichen" },
+                    { "hex.view.command_palette.pattern", "Pattern" },
 
                 { "hex.view.data_inspector.name", "Dateninspektor" },
                     { "hex.view.data_inspector.table.name", "Name" },
                     { "hex.view.data_inspector.table.value", "Wert" },
+                    { "hex.view.data_inspector.selection", "Auswahlstatistik" },
+                    { "hex.view.data_inspector.statistics.calculating", "Statistik wird berechnet..." },
+                    { "hex.view.data_inspector.statistics.region", "0x{0:X} - 0x{1:X} ({2} Bytes)" },
+                    { "hex.view.data_inspector.statistics.minimum", "Minimum" },
+                    { "hex.view.data_inspector.statistics.maximum", "Maximum" },
+                    { "hex.view.data_inspector.statistics.mean", "Mittelwert" },
+                    { "hex.view.data_inspector.statistics.histogram", "Histogramm" },
 
                 { "hex.view.data_processor.name", "Datenprozessor" },
                     { "hex.view.data_processor.menu.remove_selection", "Auswahl entfernen" },
                     { "hex.view.data_processor.menu.remove_node", "Knoten entfernen" },
                     { "hex.view.data_processor.menu.remove_link", "Link entfernen" },
+                    { "hex.view.data_processor.processing", "Verarbeiten..." },
+                    { "hex.view.data_processor.preview", "Vorschau sichtbarer Daten" },
+                    { "hex.view.data_processor.preview.tooltip", "Änderungen werden zuerst nur um die im Hex Editor sichtbaren Daten verarbeitet, der Rest folgt im Hintergrund" },
 
                 { "hex.view.disassembler.name", "Disassembler" },
                     { "hex.view.disassembler.position", "Position" },
@@ -115,13 +176,36 @@ namespace hex::plugin::builtin {
                         { "hex.view.disassembler.disassembly.address", "Adresse" },
                         { "hex.view.disassembler.disassembly.offset", "Offset" },
                         { "hex.view.disassembler.disassembly.bytes", "Byte" },
+                    { "hex.view.disassembler.references.title", "Referenzen" },
+                    { "hex.view.disassembler.references.target", "Zieladresse" },
+                    { "hex.view.disassembler.references.find", "Referenzen suchen" },
+                    { "hex.view.disassembler.references.count", "{} Referenzen" },
+                    { "hex.view.disassembler.references.indexing", "Referenzen werden indexiert" },
+                    { "hex.view.disassembler.recursive", "Rekursiv ab Einsprungpunkten" },
+                    { "hex.view.disassembler.entry_points.add", "Einsprungpunkt hinzufügen" },
+                    { "hex.view.disassembler.entry_points.none", "Keine Einsprungpunkte hinzugefügt, mit [[entry_point]] markierte Patterns und der Anfang der Region werden verwendet" },
+                    { "hex.view.disassembler.search.title", "Instruktionssuche" },
+                    { "hex.view.disassembler.search.mnemonic", "Mnemonic" },
+                    { "hex.view.disassembler.search.operands", "Operandenmuster" },
+                    { "hex.view.disassembler.search.find", "Suchen" },
+                    { "hex.view.disassembler.search.searching", "Instruktionen werden gesucht" },
+                    { "hex.view.disassembler.search.count", "{} Instruktionen gefunden" },
 
                 { "hex.view.hashes.name", "Hashes" },
                     { "hex.view.hashes.settings", "Einstellungen" },
                     { "hex.view.hashes.function", "Hash Funktion" },
                     { "hex.view.hashes.iv", "Startwert" },
                     { "hex.view.hashes.poly", "Polynomial" },
+                    { "hex.view.hashes.add", "Hinzufügen" },
                     { "hex.view.hashes.result", "Resultat" },
+                    { "hex.view.hashes.hashing", "Hashen..." },
+                    { "hex.view.hashes.batch", "Stapel" },
+                    { "hex.view.hashes.batch.bookmarks", "Lesezeichen hashen" },
+                    { "hex.view.hashes.batch.patterns", "Patterns hashen" },
+                    { "hex.view.hashes.batch.hashing", "Regionen hashen..." },
+                    { "hex.view.hashes.batch.name", "Name" },
+                    { "hex.view.hashes.batch.export", "Exportieren..." },
+                    { "hex.view.hashes.batch.export.error", "Schreiben der Resultate fehlgeschlagen!" },
 
                 { "hex.view.help.name", "Hilfe" },
                     { "hex.view.help.about.name", "Über ImHex" },
@@ -130,18 +214,32 @@ namespace hex::plugin::builtin {
                         { "hex.view.help.about.donations", "Spenden" },
                         { "hex.view.help.about.thanks", "Wenn dir meine Arbeit gefällt, bitte ziehe eine Spende in Betracht, um das Projekt am Laufen zu halten. Vielen Dank <3" },
                         { "hex.view.help.about.libs", "Benutzte Libraries" },
+                        { "hex.view.help.about.startup", "Startzeit" },
+                        { "hex.view.help.about.startup.deferred", "bei erster Benutzung" },
                     { "hex.view.help.pattern_cheat_sheet", "Pattern Language Cheat Sheet"},
                     { "hex.view.help.calc_cheat_sheet", "Rechner Cheat Sheet" },
 
                 { "hex.view.hexeditor.name", "Hex editor" },
                     { "hex.view.hexeditor.save_changes", "Änderungen sichern" },
                     { "hex.view.hexeditor.open_file", "Datei öffnen" },
+                    { "hex.view.hexeditor.open_disk.title", "Datenträger öffnen" },
+                    { "hex.view.hexeditor.open_disk.desc", "Pfad eines Datenträgers, einer Partition oder eines Abbilds. Zum Beispiel /dev/sda oder \\\\.\\PhysicalDrive0" },
+                    { "hex.view.hexeditor.attach_process.title", "An Prozess anhängen" },
+                    { "hex.view.hexeditor.attach_process.desc", "ID des Prozesses, dessen Speicher geöffnet werden soll. Der Zugriff erfordert entsprechende Berechtigungen" },
+                    { "hex.view.hexeditor.open_remote.title", "Entfernte Datei öffnen" },
+                    { "hex.view.hexeditor.open_remote.desc", "Adresse eines Rechners, auf dem imhex-remote-server läuft. Zum Beispiel analysis-server:31140" },
                     { "hex.view.hexeditor.open_project", "Projekt öffnen" },
                     { "hex.view.hexeditor.save_project", "Projekt speichern" },
                     { "hex.view.hexeditor.save_data", "Daten speichern" },
                     { "hex.view.hexeditor.open_base64", "Base64 Datei öffnen" },
                     { "hex.view.hexeditor.load_enconding_file", "Custom encoding Datei laden" },
-                    { "hex.view.hexeditor.page", "Seite {0} / {1}" },
+                    { "hex.view.hexeditor.io.read_fn", "Hex-Editor-Zellen" },
+                    { "hex.view.hexeditor.io.decode_fn", "Hex-Editor-Dekodierung" },
+                    { "hex.view.hexeditor.minimap.counting", "Zähle Minimap-Zeilen" },
+                    { "hex.view.hexeditor.minimap.entropy", "Entropie: {:.3f}" },
+                    { "hex.view.hexeditor.minimap.printable", "Druckbar: {:.1f}%" },
+                    { "hex.view.hexeditor.minimap.zeros", "Nullen: {:.1f}%" },
+                    { "hex.view.hexeditor.unnamed", "Unbenannt" },
                     { "hex.view.hexeditor.save_as", "Speichern unter" },
                     { "hex.view.hexeditor.save_changes.title", "Änderung sichern" },
                     { "hex.view.hexeditor.save_changes.desc", "Es wurden ungespeicherte Änderungen an diesem Projekt vorgenommen\nBist du sicher, dass du ImHex schliessen willst?" },
@@ -151,8 +249,15 @@ namespace hex::plugin::builtin {
                         { "hex.view.hexeditor.script.script.title", "Loader Script: Skript öffnen" },
                     { "hex.view.hexeditor.script.file", "Datei" },
                     { "hex.view.hexeditor.script.file.title", "Loader Script: Datei öffnen" },
+                    { "hex.view.hexeditor.script.running", "Loader Skript wird ausgeführt" },
 
                     { "hex.view.hexeditor.menu.file.open_file", "Datei öffnen..." },
+                    { "hex.view.hexeditor.menu.file.open_file_read_only", "Datei schreibgeschützt öffnen..." },
+                    { "hex.view.hexeditor.menu.file.open_file_async", "Datei mit asynchroner E/A öffnen..." },
+                    { "hex.view.hexeditor.menu.file.open_compressed", "Komprimierte Datei öffnen..." },
+                    { "hex.view.hexeditor.menu.file.open_disk", "Datenträger öffnen..." },
+                    { "hex.view.hexeditor.menu.file.open_remote", "Entfernte Datei öffnen..." },
+                    { "hex.view.hexeditor.menu.file.attach_process", "An Prozess anhängen..." },
                     { "hex.view.hexeditor.menu.file.save", "Speichern" },
                     { "hex.view.hexeditor.menu.file.save_as", "Speichern unter..." },
                     { "hex.view.hexeditor.menu.file.open_project", "Projekt öffnen..." },
@@ -164,24 +269,61 @@ namespace hex::plugin::builtin {
                         { "hex.view.hexeditor.file_open_error", "Öffnen der Datei fehlgeschlagen!" },
                         { "hex.view.hexeditor.menu.file.import.ips", "IPS Patch" },
                         { "hex.view.hexeditor.menu.file.import.ips32", "IPS32 Patch" },
+                        { "hex.view.hexeditor.menu.file.import.ups", "UPS Patch" },
+                        { "hex.view.hexeditor.menu.file.import.bps", "BPS Patch" },
+                        { "hex.view.hexeditor.patch.importing", "Patch importieren..." },
+                        { "hex.view.hexeditor.patch.import_error", "Patch konnte nicht importiert werden! Er ist fehlerhaft oder wurde für andere Daten erstellt." },
                         { "hex.view.hexeditor.menu.file.import.script", "Datei mit Loader Script" },
 
                     { "hex.view.hexeditor.menu.file.export", "Exportieren..." },
                         { "hex.view.hexeditor.menu.file.export.title", "Datei exportieren" },
                         { "hex.view.hexeditor.menu.file.export.ips", "IPS Patch" },
                         { "hex.view.hexeditor.menu.file.export.ips32", "IPS32 Patch" },
+                        { "hex.view.hexeditor.menu.file.export.ups", "UPS Patch" },
+                        { "hex.view.hexeditor.menu.file.export.bps", "BPS Patch" },
+                        { "hex.view.hexeditor.patch.exporting", "Patch exportieren..." },
+                        { "hex.view.hexeditor.patch.export_error", "Patch konnte nicht exportiert werden! Die Datei konnte nicht geschrieben werden oder die Patches passen nicht in das Format." },
+                        { "hex.view.hexeditor.menu.file.export.decoded", "Dekodierter Text" },
+                        { "hex.view.hexeditor.export.decoding", "Dekodierten Text exportieren..." },
+                        { "hex.view.hexeditor.export.decoded.error", "Dekodierter Text konnte nicht geschrieben werden!" },
+                        { "hex.view.hexeditor.export.selection.exporting", "Auswahl wird exportiert..." },
+                        { "hex.view.hexeditor.export.selection.error", "Auswahl konnte nicht geschrieben werden!" },
                     { "hex.view.hexeditor.menu.file.search", "Suchen" },
                         { "hex.view.hexeditor.search.string", "String" },
                         { "hex.view.hexeditor.search.hex", "Hex" },
+                        { "hex.view.hexeditor.search.encoding", "Benutzerdefinierte Kodierung" },
+                        { "hex.view.hexeditor.search.regex", "Regex" },
+                        { "hex.view.hexeditor.search.regex.case_insensitive", "Gross-/Kleinschreibung ignorieren" },
+                        { "hex.view.hexeditor.search.value", "Wert" },
+                        { "hex.view.hexeditor.search.value.type", "Typ" },
+                        { "hex.view.hexeditor.search.value.exact", "Exakt" },
+                        { "hex.view.hexeditor.search.value.range", "Bereich" },
+                        { "hex.view.hexeditor.search.value.tolerance", "Toleranz" },
+                        { "hex.view.hexeditor.search.value.aligned", "Ausgerichtet" },
+                        { "hex.view.hexeditor.search.value.value", "Wert" },
+                        { "hex.view.hexeditor.search.value.min", "Minimum" },
+                        { "hex.view.hexeditor.search.value.max", "Maximum" },
+                        { "hex.view.hexeditor.search.value.invalid", "Kein gültiger {0} Wert!" },
+                        { "hex.view.hexeditor.search.value.previous", "Vorher" },
+                        { "hex.view.hexeditor.search.narrow", "Eingrenzen:" },
+                        { "hex.view.hexeditor.search.narrow.matching", "Weiterhin passend" },
+                        { "hex.view.hexeditor.search.narrow.changed", "Verändert" },
+                        { "hex.view.hexeditor.search.narrow.unchanged", "Unverändert" },
+                        { "hex.view.hexeditor.search.narrow.size_mismatch", "Eingrenzen benötigt eine Sucheingabe von {0} Bytes, gleich gross wie die Treffer!" },
                         { "hex.view.hexeditor.search.find", "Suchen" },
                         { "hex.view.hexeditor.search.find_next", "Nächstes" },
                         { "hex.view.hexeditor.search.find_prev", "Vorheriges" },
+                        { "hex.view.hexeditor.search.matches", "{0} Treffer" },
+                        { "hex.view.hexeditor.search.searching", "Suchen..." },
                     { "hex.view.hexeditor.menu.file.goto", "Sprung" },
                         { "hex.view.hexeditor.goto.offset.current", "Momentan" },
                         { "hex.view.hexeditor.goto.offset.begin", "Beginn" },
                         { "hex.view.hexeditor.goto.offset.end", "Ende" },
                     { "hex.view.hexeditor.error.read_only", "Schreibzugriff konnte nicht erlangt werden. Datei wurde im Lesemodus geöffnet." },
                     { "hex.view.hexeditor.error.open", "Öffnen der Datei fehlgeschlagen!" },
+                    { "hex.view.hexeditor.error.save", "Speichern der Datei fehlgeschlagen!" },
+                    { "hex.view.hexeditor.menu.edit.undo", "Rückgängig" },
+                    { "hex.view.hexeditor.menu.edit.redo", "Wiederholen" },
                     { "hex.view.hexeditor.menu.edit.copy", "Kopieren als..." },
                         { "hex.view.hexeditor.copy.bytes", "Bytes" },
                         { "hex.view.hexeditor.copy.hex", "Hex String" },
@@ -194,8 +336,27 @@ namespace hex::plugin::builtin {
                         { "hex.view.hexeditor.copy.js", "JavaScript Array" },
                         { "hex.view.hexeditor.copy.ascii", "ASCII Art" },
                         { "hex.view.hexeditor.copy.html", "HTML" },
+                    { "hex.view.hexeditor.menu.edit.export_selection", "Auswahl exportieren als..." },
                     { "hex.view.hexeditor.menu.edit.bookmark", "Lesezeichen erstellen" },
+                    { "hex.view.hexeditor.menu.edit.next_bookmark", "Zum nächsten Lesezeichen springen" },
+                    { "hex.view.hexeditor.menu.edit.previous_bookmark", "Zum vorherigen Lesezeichen springen" },
                     { "hex.view.hexeditor.menu.edit.set_base", "Basisadresse setzen" },
+                    { "hex.view.hexeditor.menu.edit.modify", "Auswahl verändern..." },
+                    { "hex.view.hexeditor.modify.operation", "Operation" },
+                    { "hex.view.hexeditor.modify.fill", "Mit Muster füllen" },
+                    { "hex.view.hexeditor.modify.xor", "XOR mit Schlüssel" },
+                    { "hex.view.hexeditor.modify.and", "AND mit Schlüssel" },
+                    { "hex.view.hexeditor.modify.or", "OR mit Schlüssel" },
+                    { "hex.view.hexeditor.modify.add", "Wert addieren" },
+                    { "hex.view.hexeditor.modify.swap_endian", "Endianess tauschen" },
+                    { "hex.view.hexeditor.modify.reverse", "Umkehren" },
+                    { "hex.view.hexeditor.modify.pattern", "Bytes" },
+                    { "hex.view.hexeditor.modify.value", "Wert" },
+                    { "hex.view.hexeditor.modify.width", "{0} Bit" },
+                    { "hex.view.hexeditor.modify.apply", "Anwenden" },
+                    { "hex.view.hexeditor.modify.invalid", "Ungültige Eingabe" },
+                    { "hex.view.hexeditor.modify.running", "Verändere Auswahl..." },
+                    { "hex.view.hexeditor.menu.edit.follow", "Ende der Daten folgen" },
 
                 { "hex.view.information.name", "Dateninformationen" },
                     { "hex.view.information.control", "Einstellungen" },
@@ -207,12 +368,44 @@ namespace hex::plugin::builtin {
                     { "hex.view.information.mime", "MIME Typ:" },
                     { "hex.view.information.info_analysis", "Informationsanalysis" },
                     { "hex.view.information.distribution", "Byte Verteilung" },
+                    { "hex.view.information.outdated", "Byteverteilung und Dateientropie sind veraltet, erneut analysieren um sie zu aktualisieren" },
+                    { "hex.view.information.digraph", "Bytepaar Verteilung" },
                     { "hex.view.information.entropy", "Entropie" },
                     { "hex.view.information.block_size", "Blockgrösse" },
                     { "hex.view.information.block_size.desc", "{0} Blöcke min {1} bytes" },
                     { "hex.view.information.file_entropy", "Dateientropie" },
                     { "hex.view.information.highest_entropy", "Höchste Blockentropie" },
+                    { "hex.view.information.highest_entropy_address", "Adresse der höchsten Blockentropie" },
+                    { "hex.view.information.byte_classes", "Byteklassen" },
+                    { "hex.view.information.byte_classes.zero", "Null Bytes" },
+                    { "hex.view.information.byte_classes.printable", "Druckbares ASCII" },
+                    { "hex.view.information.byte_classes.control", "Steuerzeichen" },
+                    { "hex.view.information.byte_classes.high", "Hohe Bytes" },
                     { "hex.view.information.encrypted", "Diese Daten sind vermutlich verschlüsselt oder komprimiert!" },
+                    { "hex.view.information.loading_magic", "Magic Datenbanken laden..." },
+                    { "hex.view.information.carving", "Eingebettete Dateien" },
+                    { "hex.view.information.carving.search", "Nach eingebetteten Dateien suchen" },
+                    { "hex.view.information.carving.searching", "Suche nach eingebetteten Dateien..." },
+                    { "hex.view.information.carving.none", "Keine eingebetteten Dateien gefunden" },
+                    { "hex.view.information.carving.bookmark", "Alle als Lesezeichen speichern" },
+                    { "hex.view.information.carving.type", "Typ" },
+                    { "hex.view.information.carving.description", "Beschreibung" },
+                    { "hex.view.information.compression", "Komprimierte Daten" },
+                    { "hex.view.information.compression.search", "Nach komprimierten Daten suchen" },
+                    { "hex.view.information.compression.searching", "Suche nach komprimierten Daten..." },
+                    { "hex.view.information.compression.none", "Keine komprimierten Daten in den Bereichen mit hoher Entropie gefunden" },
+                    { "hex.view.information.compression.bookmark", "Alle als Lesezeichen" },
+                    { "hex.view.information.compression.format", "Format" },
+                    { "hex.view.information.compression.decompressed_size", "Dekomprimierte Grösse" },
+                    { "hex.view.information.compression.comment", "Wird zu {0} Bytes dekomprimiert" },
+                    { "hex.view.information.compression.comment_partial", "Wird zu mehr als {0} Bytes dekomprimiert" },
+                    { "hex.view.information.duplicates", "Doppelte Daten" },
+                    { "hex.view.information.duplicates.search", "Nach doppelten Daten suchen" },
+                    { "hex.view.information.duplicates.searching", "Suche nach doppelten Daten..." },
+                    { "hex.view.information.duplicates.none", "Keine doppelten Daten gefunden" },
+                    { "hex.view.information.duplicates.summary", "{0} Gruppen identischer Bereiche, {1} Bytes in wiederholten Kopien" },
+                    { "hex.view.information.duplicates.group", "Gruppe" },
+                    { "hex.view.information.duplicates.copies", "Kopien" },
 
                 { "hex.view.patches.name", "Patches" },
                     { "hex.view.patches.offset", "Offset" },
@@ -220,14 +413,30 @@ namespace hex::plugin::builtin {
                     { "hex.view.patches.patch", "Patchwert"},
                     { "hex.view.patches.remove", "Patch entfernen" },
 
+                { "hex.view.diff.name", "Vergleich" },
+                    { "hex.view.diff.open_file", "Datei zum Vergleichen öffnen..." },
+                    { "hex.view.diff.open_error", "Datei zum Vergleichen konnte nicht geöffnet werden!" },
+                    { "hex.view.diff.no_file", "Keine Datei zum Vergleichen" },
+                    { "hex.view.diff.compare", "Vergleichen" },
+                    { "hex.view.diff.comparing", "Daten vergleichen..." },
+                    { "hex.view.diff.differences", "{0} Unterschiede" },
+                    { "hex.view.diff.outdated", "Die Daten haben sich seit dem Vergleich verändert" },
+                    { "hex.view.diff.type", "Typ" },
+                    { "hex.view.diff.type.changed", "Geändert" },
+                    { "hex.view.diff.type.inserted", "Eingefügt" },
+                    { "hex.view.diff.type.removed", "Entfernt" },
+                    { "hex.view.diff.address.current", "Aktuelle Adresse" },
+                    { "hex.view.diff.address.compared", "Verglichene Adresse" },
+
                 { "hex.view.pattern.name", "Pattern Editor" },
+                    { "hex.view.pattern.running", "Pattern ausführen..." },
                 { "hex.view.pattern.accept_pattern", "Pattern akzeptieren" },
                     { "hex.view.pattern.accept_pattern.desc", "Ein oder mehrere kompatible Pattern wurden für diesen Dateityp gefunden" },
                     { "hex.view.pattern.accept_pattern.patterns", "Pattern" },
                     { "hex.view.pattern.accept_pattern.question", "Ausgewähltes Pattern anwenden?" },
                 { "hex.view.pattern.menu.file.load_pattern", "Pattern laden..." },
                 { "hex.view.pattern.open_pattern", "Pattern öffnen" },
-                { "hex.view.pattern.evaluating", "Evaluieren..." },
+                { "hex.view.pattern.evaluating", "Evaluieren... ({0} Patterns)" },
                 { "hex.view.pattern.auto", "Auto evaluieren" },
 
                 { "hex.view.pattern_data.name", "Pattern Daten" },
@@ -237,6 +446,15 @@ namespace hex::plugin::builtin {
                     { "hex.view.pattern_data.size", "Grösse" },
                     { "hex.view.pattern_data.type", "Typ" },
                     { "hex.view.pattern_data.value", "Wert" },
+                    { "hex.view.pattern_data.more_entries", "... {0} weitere Einträge" },
+                    { "hex.view.pattern_data.tree", "Baum" },
+                    { "hex.view.pattern_data.table", "Tabelle" },
+                    { "hex.view.pattern_data.table.array", "Array" },
+                    { "hex.view.pattern_data.table.none", "Keine Arrays von Structs" },
+                    { "hex.view.pattern_data.table.index", "Index" },
+                    { "hex.view.pattern_data.table.filter", "Filter" },
+                    { "hex.view.pattern_data.table.filtering", "Filtere Tabelle..." },
+                    { "hex.view.pattern_data.table.updating", "Aktualisiere..." },
 
                 { "hex.view.settings.name", "Einstellungen" },
 
@@ -247,9 +465,14 @@ namespace hex::plugin::builtin {
                     { "hex.view.strings.filter", "Filter" },
                     { "hex.view.strings.extract", "Extrahieren" },
                     { "hex.view.strings.searching", "Suchen..." },
+                    { "hex.view.strings.filtering", "Filtern..." },
+                    { "hex.view.strings.demangling", "Demanglen..." },
                     { "hex.view.strings.offset", "Offset" },
                     { "hex.view.strings.size", "Grösse" },
                     { "hex.view.strings.string", "String" },
+                    { "hex.view.strings.demangled", "Demangled" },
+                    { "hex.view.strings.encoding", "Kodierung" },
+                    { "hex.view.strings.encoding.all", "Alle" },
                     { "hex.view.strings.demangle.title", "Demangled Namen" },
                     { "hex.view.strings.demangle.copy", "Kopieren" },
 
@@ -257,14 +480,22 @@ namespace hex::plugin::builtin {
 
                 { "hex.view.yara.name", "Yara Regeln" },
                     { "hex.view.yara.header.rules", "Regeln" },
+                        { "hex.view.yara.select_all", "Alle auswählen" },
                         { "hex.view.yara.reload", "Neu laden" },
                         { "hex.view.yara.match", "Regeln anwenden" },
                         { "hex.view.yara.matching", "Anwenden..." },
+                        { "hex.view.yara.scope", "Bereich" },
+                        { "hex.view.yara.scope.whole_data", "Alle Daten" },
+                        { "hex.view.yara.scope.selection", "Auswahl" },
+                        { "hex.view.yara.scope.bookmarks", "Lesezeichen" },
+                        { "hex.view.yara.scope.patterns", "Patterns" },
                         { "hex.view.yara.error", "Yara Kompilerfehler: " },
                     { "hex.view.yara.header.matches", "Funde" },
                         { "hex.view.yara.matches.identifier", "Kennung" },
+                        { "hex.view.yara.matches.file", "Datei" },
                         { "hex.view.yara.whole_data", "Gesammte Daten Übereinstimmung!" },
                         { "hex.view.yara.no_rules", "Keine Yara Regeln gefunden. Platziere sie in ImHex' 'yara' Ordner" },
+                        { "hex.view.yara.hash_matches", "Funde hashen" },
 
             /* Builtin plugin features */
 
@@ -400,6 +631,11 @@ namespace hex::plugin::builtin {
                         { "hex.builtin.nodes.bitwise.xor.input.a", "Input A" },
                         { "hex.builtin.nodes.bitwise.xor.input.b", "Input B" },
                         { "hex.builtin.nodes.bitwise.xor.output", "Output" },
+                    { "hex.builtin.nodes.bitwise.xor_key", "Exklusiv ODER mit Schlüssel" },
+                        { "hex.builtin.nodes.bitwise.xor_key.header", "Bitweise Exklusiv ODER mit wiederholtem Schlüssel" },
+                        { "hex.builtin.nodes.bitwise.xor_key.input", "Input" },
+                        { "hex.builtin.nodes.bitwise.xor_key.key", "Schlüssel" },
+                        { "hex.builtin.nodes.bitwise.xor_key.output", "Output" },
                     { "hex.builtin.nodes.bitwise.not", "Nicht" },
                         { "hex.builtin.nodes.bitwise.not.header", "Bitweise Nicht" },
                         { "hex.builtin.nodes.bitwise.not.input", "Input" },
@@ -426,6 +662,27 @@ namespace hex::plugin::builtin {
                         { "hex.builtin.nodes.crypto.aes.mode", "Modus" },
                         { "hex.builtin.nodes.crypto.aes.key_length", "Schlüssellänge" },
 
+                { "hex.builtin.nodes.decompression", "Dekomprimieren" },
+                    { "hex.builtin.nodes.decompression.input", "Input" },
+                    { "hex.builtin.nodes.decompression.output", "Output" },
+                    { "hex.builtin.nodes.decompression.zlib", "zlib / gzip" },
+                        { "hex.builtin.nodes.decompression.zlib.header", "zlib Dekompressor" },
+                        { "hex.builtin.nodes.decompression.zlib.format", "Format" },
+                    { "hex.builtin.nodes.decompression.lzma", "LZMA / XZ" },
+                        { "hex.builtin.nodes.decompression.lzma.header", "LZMA Dekompressor" },
+                    { "hex.builtin.nodes.decompression.zstd", "Zstandard" },
+                        { "hex.builtin.nodes.decompression.zstd.header", "Zstandard Dekompressor" },
+                    { "hex.builtin.nodes.decompression.lz4", "LZ4" },
+                        { "hex.builtin.nodes.decompression.lz4.header", "LZ4 Dekompressor" },
+
+                { "hex.builtin.nodes.math", "Mathematik" },
+                    { "hex.builtin.nodes.math.expression", "Ausdruck" },
+                        { "hex.builtin.nodes.math.expression.header", "Mathematischer Ausdruck" },
+                        { "hex.builtin.nodes.math.expression.input", "Input" },
+                        { "hex.builtin.nodes.math.expression.output", "Output" },
+                        { "hex.builtin.nodes.math.expression.formula", "Formel" },
+                        { "hex.builtin.nodes.math.expression.value_size", "Wertgrösse" },
+
 
 
                 { "hex.builtin.tools.demangler", "Itanium/MSVC demangler" },
@@ -438,6 +695,7 @@ namespace hex::plugin::builtin {
                     { "hex.builtin.tools.regex_replacer.replace", "Ersatz pattern" },
                     { "hex.builtin.tools.regex_replacer.input", "Input" },
                     { "hex.builtin.tools.regex_replacer.output", "Output" },
+                    { "hex.builtin.tools.regex_replacer.replacing", "Ersetzen..." },
                 { "hex.builtin.tools.color", "Farbwähler" },
                 { "hex.builtin.tools.calc", "Rechner" },
                     { "hex.builtin.tools.input", "Input" },
@@ -457,6 +715,9 @@ namespace hex::plugin::builtin {
 
                 { "hex.builtin.setting.imhex", "ImHex" },
                     { "hex.builtin.setting.imhex.recent_files", "Kürzlich geöffnete Dateien" },
+                    { "hex.builtin.setting.imhex.fast_start", "Schnellstart (aufwändige Funktionen erst bei Benutzung vorbereiten)" },
+                    { "hex.builtin.setting.imhex.restore_session", "Zuletzt geöffnete Datei beim Start wieder öffnen" },
+                    { "hex.builtin.setting.imhex.memory_budget", "Speicherlimit für Caches" },
                 { "hex.builtin.setting.interface", "Aussehen" },
                     { "hex.builtin.setting.interface.color", "Farbthema" },
                         { "hex.builtin.setting.interface.color.dark", "Dunkel" },
@@ -464,11 +725,41 @@ namespace hex::plugin::builtin {
                         { "hex.builtin.setting.interface.color.classic", "Klassisch" },
                     { "hex.builtin.setting.interface.language", "Sprache" },
 
+                { "hex.builtin.setting.hex_editor", "Hex Editor" },
+                    { "hex.builtin.setting.hex_editor.undo_history", "Speicherlimit für Rückgängig" },
+                    { "hex.builtin.setting.hex_editor.async_queue_depth", "Warteschlangentiefe für asynchrone E/A" },
+                    { "hex.builtin.setting.hex_editor.async_block_size", "Blockgrösse für asynchrone E/A" },
+                    { "hex.builtin.setting.hex_editor.minimap", "Minimap anzeigen" },
+                    { "hex.builtin.setting.hex_editor.gpu_grid", "Hex-Zellen auf der GPU zeichnen" },
+
                 { "hex.builtin.provider.file.path", "Dateipfad" },
                 { "hex.builtin.provider.file.size", "Größe" },
                 { "hex.builtin.provider.file.creation", "Erstellungszeit" },
                 { "hex.builtin.provider.file.access", "Letzte Zugriffszeit" },
                 { "hex.builtin.provider.file.modification", "Letzte Modifikationszeit" },
+
+                { "hex.builtin.provider.disk.path", "Datenträgerpfad" },
+                { "hex.builtin.provider.disk.size", "Größe" },
+                { "hex.builtin.provider.disk.sector_size", "Sektorgrösse" },
+                { "hex.builtin.provider.disk.unbuffered", "Umgeht Seitencache" },
+                { "hex.builtin.provider.process.id", "Prozess ID" },
+                { "hex.builtin.provider.process.name", "Prozessname" },
+                { "hex.builtin.provider.process.regions", "Speicherbereiche" },
+                { "hex.builtin.provider.process.mapped_size", "Abgebildete Grösse" },
+                { "hex.builtin.provider.compressed.path", "Dateipfad" },
+                { "hex.builtin.provider.compressed.format", "Format" },
+                { "hex.builtin.provider.compressed.compressed_size", "Komprimierte Grösse" },
+                { "hex.builtin.provider.compressed.size", "Entpackte Grösse" },
+                { "hex.builtin.provider.compressed.checkpoints", "Checkpoints" },
+                { "hex.builtin.provider.compressed.index", "Suchindex" },
+                { "hex.builtin.provider.compressed.index.complete", "Vollständig" },
+                { "hex.builtin.provider.compressed.index.building", "Wird erstellt..." },
+                { "hex.builtin.provider.compressed.index.failed", "Fehlgeschlagen, Datei ist beschädigt" },
+                { "hex.builtin.provider.remote.address", "Serveradresse" },
+                { "hex.builtin.provider.remote.size", "Grösse" },
+                { "hex.builtin.provider.remote.cached", "Lokal zwischengespeichert" },
+                { "hex.builtin.provider.remote.received", "Übertragen" },
+                { "hex.builtin.provider.remote.requests", "Anfragen" },
         });
     }
 
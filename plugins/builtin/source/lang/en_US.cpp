@@ -11,9 +11,52 @@ namespace hex::plugin::builtin {
                 { "hex.menu.edit", "Edit" },
                 { "hex.menu.view", "View" },
                     { "hex.menu.view.fps", "Display FPS" },
+                    { "hex.menu.view.profiler", "Show Profiler" },
                     { "hex.menu.view.demo", "Show ImGui Demo" },
                 { "hex.menu.help", "Help" },
 
+                { "hex.profiler.title", "Profiler" },
+                    { "hex.profiler.section", "Section" },
+                    { "hex.profiler.time", "Average time" },
+                    { "hex.profiler.peak", "Peak time" },
+                    { "hex.profiler.allocations", "Allocations per frame" },
+                    { "hex.profiler.reads", "Reads per frame" },
+                    { "hex.profiler.read_bytes", "Read per frame" },
+                    { "hex.profiler.sections", "Sections" },
+                    { "hex.profiler.memory", "Memory" },
+                    { "hex.profiler.memory.total", "{0} of {1} used by caches" },
+                    { "hex.profiler.memory.subsystem", "Subsystem" },
+                    { "hex.profiler.memory.caches", "Caches" },
+                    { "hex.profiler.memory.usage", "Usage" },
+                    { "hex.profiler.memory.evicted", "Evicted" },
+                    { "hex.profiler.io", "I/O" },
+                    { "hex.profiler.io.description", "Reads of the current provider while the profiler is open" },
+                    { "hex.profiler.io.reset", "Reset" },
+                    { "hex.profiler.io.cause", "Caused by" },
+                    { "hex.profiler.io.untagged", "Other" },
+                    { "hex.profiler.io.reads", "Reads" },
+                    { "hex.profiler.io.read_bytes", "Read" },
+                    { "hex.profiler.io.patch_hits", "Patched reads" },
+                    { "hex.profiler.io.cache_hits", "Cache hits" },
+                    { "hex.profiler.io.cache_misses", "Cache misses" },
+                    { "hex.profiler.io.raw_reads", "Raw reads" },
+                    { "hex.profiler.io.raw_read_bytes", "Raw read" },
+                    { "hex.profiler.io.raw_read_time", "Raw read time" },
+                    { "hex.profiler.trace", "Trace" },
+                    { "hex.profiler.trace.description", "Records what every thread does, to be looked at in chrome://tracing or Perfetto" },
+                    { "hex.profiler.trace.record", "Record" },
+                    { "hex.profiler.trace.events", "{0} events recorded" },
+                    { "hex.profiler.trace.export", "Export..." },
+                    { "hex.profiler.trace.export_error", "Failed to write the trace!" },
+
+                { "hex.memory.block_cache", "Provider block cache" },
+                { "hex.memory.strings", "Strings of other providers" },
+                { "hex.memory.information", "Analyses of other providers" },
+                { "hex.memory.patterns", "Patterns of other providers" },
+                { "hex.memory.disassembly", "Disassembly index" },
+
+                { "hex.footer.tasks.more", "+{0} more" },
+
                 { "hex.welcome.header.main", "Welcome to ImHex" },
                 { "hex.welcome.header.start", "Start" },
                     { "hex.welcome.start.open_file", "Open File" },
@@ -60,6 +103,10 @@ namespace hex::plugin::builtin {
                 { "hex.common.load", "Load" },
                 { "hex.common.cancel", "Cancel" },
                 { "hex.common.set", "Set" },
+                { "hex.common.autosaving", "Autosaving project" },
+                { "hex.common.storing_settings", "Storing settings" },
+                { "hex.common.font_atlas.building", "Building font atlas" },
+                { "hex.common.sorting", "Sorting" },
 
                 { "hex.view.bookmarks.name", "Bookmarks" },
                     { "hex.view.bookmarks.default_title", "Bookmark [0x{0:X} - 0x{1:X}]" },
@@ -71,17 +118,31 @@ namespace hex::plugin::builtin {
                     { "hex.view.bookmarks.header.name", "Name" },
                     { "hex.view.bookmarks.header.color", "Color" },
                     { "hex.view.bookmarks.header.comment", "Comment" },
+                    { "hex.view.bookmarks.header.preview", "Preview" },
 
                 { "hex.view.command_palette.name", "Command Palette" },
+                    { "hex.view.command_palette.file", "File" },
+                    { "hex.view.command_palette.bookmark", "Bookmark" },
+                    { "hex.view.command_palette.pattern", "Pattern" },
 
                 { "hex.view.data_inspector.name", "Data Inspector" },
                     { "hex.view.data_inspector.table.name", "Name" },
                     { "hex.view.data_inspector.table.value", "Value" },
+                    { "hex.view.data_inspector.selection", "Selection statistics" },
+                    { "hex.view.data_inspector.statistics.calculating", "Calculating statistics..." },
+                    { "hex.view.data_inspector.statistics.region", "0x{0:X} - 0x{1:X} ({2} bytes)" },
+                    { "hex.view.data_inspector.statistics.minimum", "Minimum" },
+                    { "hex.view.data_inspector.statistics.maximum", "Maximum" },
+                    { "hex.view.data_inspector.statistics.mean", "Mean" },
+                    { "hex.view.data_inspector.statistics.histogram", "Histogram" },
 
                 { "hex.view.data_processor.name", "Data Processor" },
                     { "hex.view.data_processor.menu.remove_selection", "Remove Selected" },
                     { "hex.view.data_processor.menu.remove_node", "Remove Node" },
                     { "hex.view.data_processor.menu.remove_link", "Remove Link" },
+                    { "hex.view.data_processor.processing", "Processing..." },
+                    { "hex.view.data_processor.preview", "Preview visible data" },
+                    { "hex.view.data_processor.preview.tooltip", "Changes first only get processed around the data visible in the hex editor, everything else follows in the background" },
 
                 { "hex.view.disassembler.name", "Disassembler" },
                     { "hex.view.disassembler.position", "Position" },
@@ -115,13 +176,36 @@ namespace hex::plugin::builtin {
                         { "hex.view.disassembler.disassembly.address", "Address" },
                         { "hex.view.disassembler.disassembly.offset", "Offset" },
                         { "hex.view.disassembler.disassembly.bytes", "Byte" },
+                    { "hex.view.disassembler.references.title", "References" },
+                    { "hex.view.disassembler.references.target", "Target address" },
+                    { "hex.view.disassembler.references.find", "Find references" },
+                    { "hex.view.disassembler.references.count", "{} references" },
+                    { "hex.view.disassembler.references.indexing", "Indexing references" },
+                    { "hex.view.disassembler.recursive", "Recursive descent from entry points" },
+                    { "hex.view.disassembler.entry_points.add", "Add entry point" },
+                    { "hex.view.disassembler.entry_points.none", "No entry points added, patterns marked [[entry_point]] and the start of the region are used" },
+                    { "hex.view.disassembler.search.title", "Instruction search" },
+                    { "hex.view.disassembler.search.mnemonic", "Mnemonic" },
+                    { "hex.view.disassembler.search.operands", "Operand pattern" },
+                    { "hex.view.disassembler.search.find", "Search" },
+                    { "hex.view.disassembler.search.searching", "Searching instructions" },
+                    { "hex.view.disassembler.search.count", "{} instructions found" },
 
                 { "hex.view.hashes.name", "Hashes" },
                     { "hex.view.hashes.settings", "Settings" },
                     { "hex.view.hashes.function", "Hash function" },
                     { "hex.view.hashes.iv", "Initial value" },
                     { "hex.view.hashes.poly", "Polynomial" },
+                    { "hex.view.hashes.add", "Add" },
                     { "hex.view.hashes.result", "Result" },
+                    { "hex.view.hashes.hashing", "Hashing..." },
+                    { "hex.view.hashes.batch", "Batch" },
+                    { "hex.view.hashes.batch.bookmarks", "Hash bookmarks" },
+                    { "hex.view.hashes.batch.patterns", "Hash patterns" },
+                    { "hex.view.hashes.batch.hashing", "Hashing regions..." },
+                    { "hex.view.hashes.batch.name", "Name" },
+                    { "hex.view.hashes.batch.export", "Export..." },
+                    { "hex.view.hashes.batch.export.error", "Failed to write the batch results!" },
 
                 { "hex.view.help.name", "Help" },
                     { "hex.view.help.about.name", "About" },
@@ -130,18 +214,32 @@ namespace hex::plugin::builtin {
                         { "hex.view.help.about.donations", "Donations" },
                         { "hex.view.help.about.thanks", "If you like my work, please consider donating to keep the project going. Thanks a lot <3" },
                         { "hex.view.help.about.libs", "Libraries used" },
+                        { "hex.view.help.about.startup", "Startup time" },
+                        { "hex.view.help.about.startup.deferred", "on first use" },
                     { "hex.view.help.pattern_cheat_sheet", "Pattern Language Cheat Sheet"},
                     { "hex.view.help.calc_cheat_sheet", "Calculator Cheat Sheet" },
 
                 { "hex.view.hexeditor.name", "Hex editor" },
                     { "hex.view.hexeditor.save_changes", "Save Changes" },
                     { "hex.view.hexeditor.open_file", "Open File" },
+                    { "hex.view.hexeditor.open_disk.title", "Open Disk" },
+                    { "hex.view.hexeditor.open_disk.desc", "Path of a disk, partition or disk image. For example /dev/sda or \\\\.\\PhysicalDrive0" },
+                    { "hex.view.hexeditor.attach_process.title", "Attach to Process" },
+                    { "hex.view.hexeditor.attach_process.desc", "ID of the process whose memory should be opened. Access requires the necessary permissions" },
+                    { "hex.view.hexeditor.open_remote.title", "Open Remote File" },
+                    { "hex.view.hexeditor.open_remote.desc", "Address of a machine running imhex-remote-server, for example analysis-server:31140" },
                     { "hex.view.hexeditor.open_project", "Open Project" },
                     { "hex.view.hexeditor.save_project", "Save Project" },
                     { "hex.view.hexeditor.save_data", "Save Data" },
                     { "hex.view.hexeditor.open_base64", "Open Base64 File" },
                     { "hex.view.hexeditor.load_enconding_file", "Load custom encoding File" },
-                    { "hex.view.hexeditor.page", "Page {0} / {1}" },
+                    { "hex.view.hexeditor.io.read_fn", "Hex editor cells" },
+                    { "hex.view.hexeditor.io.decode_fn", "Hex editor decoding" },
+                    { "hex.view.hexeditor.minimap.counting", "Counting minimap rows" },
+                    { "hex.view.hexeditor.minimap.entropy", "Entropy: {:.3f}" },
+                    { "hex.view.hexeditor.minimap.printable", "Printable: {:.1f}%" },
+                    { "hex.view.hexeditor.minimap.zeros", "Zeros: {:.1f}%" },
+                    { "hex.view.hexeditor.unnamed", "Unnamed" },
                     { "hex.view.hexeditor.save_as", "Save As" },
                     { "hex.view.hexeditor.save_changes.title", "Save Changes" },
                     { "hex.view.hexeditor.save_changes.desc", "You have unsaved changes made to your Project.\nAre you sure you want to exit?" },
@@ -151,8 +249,15 @@ namespace hex::plugin::builtin {
                         { "hex.view.hexeditor.script.script.title", "Loader Script: Open Script" },
                     { "hex.view.hexeditor.script.file", "File" },
                     { "hex.view.hexeditor.script.file.title", "Loader Script: Open File" },
+                    { "hex.view.hexeditor.script.running", "Running loader script" },
 
                     { "hex.view.hexeditor.menu.file.open_file", "Open File..." },
+                    { "hex.view.hexeditor.menu.file.open_file_read_only", "Open File read-only..." },
+                    { "hex.view.hexeditor.menu.file.open_file_async", "Open File with async I/O..." },
+                    { "hex.view.hexeditor.menu.file.open_compressed", "Open Compressed File..." },
+                    { "hex.view.hexeditor.menu.file.open_disk", "Open Disk..." },
+                    { "hex.view.hexeditor.menu.file.open_remote", "Open Remote File..." },
+                    { "hex.view.hexeditor.menu.file.attach_process", "Attach to Process..." },
                     { "hex.view.hexeditor.menu.file.save", "Save" },
                     { "hex.view.hexeditor.menu.file.save_as", "Save As..." },
                     { "hex.view.hexeditor.menu.file.open_project", "Open Project..." },
@@ -164,24 +269,61 @@ namespace hex::plugin::builtin {
                         { "hex.view.hexeditor.file_open_error", "Failed to open file!" },
                         { "hex.view.hexeditor.menu.file.import.ips", "IPS Patch" },
                         { "hex.view.hexeditor.menu.file.import.ips32", "IPS32 Patch" },
+                        { "hex.view.hexeditor.menu.file.import.ups", "UPS Patch" },
+                        { "hex.view.hexeditor.menu.file.import.bps", "BPS Patch" },
+                        { "hex.view.hexeditor.patch.importing", "Importing patch..." },
+                        { "hex.view.hexeditor.patch.import_error", "Failed to import the patch! It is malformed or was made for different data." },
                         { "hex.view.hexeditor.menu.file.import.script", "File with Loader Script" },
 
                     { "hex.view.hexeditor.menu.file.export", "Export..." },
                         { "hex.view.hexeditor.menu.file.export.title", "Export File" },
                         { "hex.view.hexeditor.menu.file.export.ips", "IPS Patch" },
                         { "hex.view.hexeditor.menu.file.export.ips32", "IPS32 Patch" },
+                        { "hex.view.hexeditor.menu.file.export.ups", "UPS Patch" },
+                        { "hex.view.hexeditor.menu.file.export.bps", "BPS Patch" },
+                        { "hex.view.hexeditor.patch.exporting", "Exporting patch..." },
+                        { "hex.view.hexeditor.patch.export_error", "Failed to export the patch! The file couldn't be written or the patches don't fit the format." },
+                        { "hex.view.hexeditor.menu.file.export.decoded", "Decoded text" },
+                        { "hex.view.hexeditor.export.decoding", "Exporting decoded text..." },
+                        { "hex.view.hexeditor.export.decoded.error", "Failed to write the decoded text!" },
+                        { "hex.view.hexeditor.export.selection.exporting", "Exporting selection..." },
+                        { "hex.view.hexeditor.export.selection.error", "Failed to write the selection!" },
                     { "hex.view.hexeditor.menu.file.search", "Search" },
                         { "hex.view.hexeditor.search.string", "String" },
                         { "hex.view.hexeditor.search.hex", "Hex" },
+                        { "hex.view.hexeditor.search.encoding", "Custom encoding" },
+                        { "hex.view.hexeditor.search.regex", "Regex" },
+                        { "hex.view.hexeditor.search.regex.case_insensitive", "Case insensitive" },
+                        { "hex.view.hexeditor.search.value", "Value" },
+                        { "hex.view.hexeditor.search.value.type", "Type" },
+                        { "hex.view.hexeditor.search.value.exact", "Exact" },
+                        { "hex.view.hexeditor.search.value.range", "Range" },
+                        { "hex.view.hexeditor.search.value.tolerance", "Tolerance" },
+                        { "hex.view.hexeditor.search.value.aligned", "Aligned" },
+                        { "hex.view.hexeditor.search.value.value", "Value" },
+                        { "hex.view.hexeditor.search.value.min", "Minimum" },
+                        { "hex.view.hexeditor.search.value.max", "Maximum" },
+                        { "hex.view.hexeditor.search.value.invalid", "Not a valid {0} value!" },
+                        { "hex.view.hexeditor.search.value.previous", "Previous" },
+                        { "hex.view.hexeditor.search.narrow", "Narrow down:" },
+                        { "hex.view.hexeditor.search.narrow.matching", "Still matching" },
+                        { "hex.view.hexeditor.search.narrow.changed", "Changed" },
+                        { "hex.view.hexeditor.search.narrow.unchanged", "Unchanged" },
+                        { "hex.view.hexeditor.search.narrow.size_mismatch", "Narrowing needs a search input of {0} bytes, the same size as the results!" },
                         { "hex.view.hexeditor.search.find", "Find" },
                         { "hex.view.hexeditor.search.find_next", "Find next" },
                         { "hex.view.hexeditor.search.find_prev", "Find previous" },
+                        { "hex.view.hexeditor.search.matches", "{0} matches" },
+                        { "hex.view.hexeditor.search.searching", "Searching..." },
                     { "hex.view.hexeditor.menu.file.goto", "Goto" },
                         { "hex.view.hexeditor.goto.offset.current", "Current" },
                         { "hex.view.hexeditor.goto.offset.begin", "Begin" },
                         { "hex.view.hexeditor.goto.offset.end", "End" },
                     { "hex.view.hexeditor.error.read_only", "Couldn't get write access. File opened in read-only mode." },
                     { "hex.view.hexeditor.error.open", "Failed to open file!" },
+                    { "hex.view.hexeditor.error.save", "Failed to save file!" },
+                    { "hex.view.hexeditor.menu.edit.undo", "Undo" },
+                    { "hex.view.hexeditor.menu.edit.redo", "Redo" },
                     { "hex.view.hexeditor.menu.edit.copy", "Copy as..." },
                         { "hex.view.hexeditor.copy.bytes", "Bytes" },
                         { "hex.view.hexeditor.copy.hex", "Hex String" },
@@ -194,8 +336,27 @@ namespace hex::plugin::builtin {
                         { "hex.view.hexeditor.copy.js", "JavaScript Array" },
                         { "hex.view.hexeditor.copy.ascii", "ASCII Art" },
                         { "hex.view.hexeditor.copy.html", "HTML" },
+                    { "hex.view.hexeditor.menu.edit.export_selection", "Export selection as..." },
                     { "hex.view.hexeditor.menu.edit.bookmark", "Create bookmark" },
+                    { "hex.view.hexeditor.menu.edit.next_bookmark", "Jump to next bookmark" },
+                    { "hex.view.hexeditor.menu.edit.previous_bookmark", "Jump to previous bookmark" },
                     { "hex.view.hexeditor.menu.edit.set_base", "Set base address" },
+                    { "hex.view.hexeditor.menu.edit.modify", "Modify selection..." },
+                    { "hex.view.hexeditor.modify.operation", "Operation" },
+                    { "hex.view.hexeditor.modify.fill", "Fill with pattern" },
+                    { "hex.view.hexeditor.modify.xor", "XOR with key" },
+                    { "hex.view.hexeditor.modify.and", "AND with key" },
+                    { "hex.view.hexeditor.modify.or", "OR with key" },
+                    { "hex.view.hexeditor.modify.add", "Add value" },
+                    { "hex.view.hexeditor.modify.swap_endian", "Swap endianess" },
+                    { "hex.view.hexeditor.modify.reverse", "Reverse" },
+                    { "hex.view.hexeditor.modify.pattern", "Bytes" },
+                    { "hex.view.hexeditor.modify.value", "Value" },
+                    { "hex.view.hexeditor.modify.width", "{0} bit" },
+                    { "hex.view.hexeditor.modify.apply", "Apply" },
+                    { "hex.view.hexeditor.modify.invalid", "Invalid input" },
+                    { "hex.view.hexeditor.modify.running", "Modifying selection..." },
+                    { "hex.view.hexeditor.menu.edit.follow", "Follow end of data" },
 
                 { "hex.view.information.name", "Data Information" },
                     { "hex.view.information.control", "Control" },
@@ -207,12 +368,44 @@ namespace hex::plugin::builtin {
                     { "hex.view.information.mime", "MIME Type:" },
                     { "hex.view.information.info_analysis", "Information analysis" },
                     { "hex.view.information.distribution", "Byte distribution" },
+                    { "hex.view.information.outdated", "Byte distribution and file entropy are outdated, analyze again to update them" },
+                    { "hex.view.information.digraph", "Byte pair distribution" },
                     { "hex.view.information.entropy", "Entropy" },
                     { "hex.view.information.block_size", "Block size" },
                     { "hex.view.information.block_size.desc", "{0} blocks of {1} bytes" },
                     { "hex.view.information.file_entropy", "File entropy" },
                     { "hex.view.information.highest_entropy", "Highest entropy block" },
+                    { "hex.view.information.highest_entropy_address", "Highest entropy block address" },
+                    { "hex.view.information.byte_classes", "Byte classes" },
+                    { "hex.view.information.byte_classes.zero", "Zero bytes" },
+                    { "hex.view.information.byte_classes.printable", "Printable ASCII" },
+                    { "hex.view.information.byte_classes.control", "Control characters" },
+                    { "hex.view.information.byte_classes.high", "High bytes" },
                     { "hex.view.information.encrypted", "This data is most likely encrypted or compressed!" },
+                    { "hex.view.information.loading_magic", "Loading magic databases..." },
+                    { "hex.view.information.carving", "Embedded files" },
+                    { "hex.view.information.carving.search", "Search for embedded files" },
+                    { "hex.view.information.carving.searching", "Searching for embedded files..." },
+                    { "hex.view.information.carving.none", "No embedded files found" },
+                    { "hex.view.information.carving.bookmark", "Bookmark all" },
+                    { "hex.view.information.carving.type", "Type" },
+                    { "hex.view.information.carving.description", "Description" },
+                    { "hex.view.information.compression", "Compressed data" },
+                    { "hex.view.information.compression.search", "Search for compressed data" },
+                    { "hex.view.information.compression.searching", "Searching for compressed data..." },
+                    { "hex.view.information.compression.none", "No compressed data found in the high entropy regions" },
+                    { "hex.view.information.compression.bookmark", "Bookmark all" },
+                    { "hex.view.information.compression.format", "Format" },
+                    { "hex.view.information.compression.decompressed_size", "Decompressed size" },
+                    { "hex.view.information.compression.comment", "Decompresses to {0} bytes" },
+                    { "hex.view.information.compression.comment_partial", "Decompresses to more than {0} bytes" },
+                    { "hex.view.information.duplicates", "Duplicated data" },
+                    { "hex.view.information.duplicates.search", "Search for duplicated data" },
+                    { "hex.view.information.duplicates.searching", "Searching for duplicated data..." },
+                    { "hex.view.information.duplicates.none", "No duplicated data found" },
+                    { "hex.view.information.duplicates.summary", "{0} groups of identical regions, {1} bytes in repeated copies" },
+                    { "hex.view.information.duplicates.group", "Group" },
+                    { "hex.view.information.duplicates.copies", "Copies" },
 
                 { "hex.view.patches.name", "Patches" },
                     { "hex.view.patches.offset", "Offset" },
@@ -220,14 +413,30 @@ namespace hex::plugin::builtin {
                     { "hex.view.patches.patch", "Patched value"},
                     { "hex.view.patches.remove", "Remove patch" },
 
+                { "hex.view.diff.name", "Diff" },
+                    { "hex.view.diff.open_file", "Open file to compare..." },
+                    { "hex.view.diff.open_error", "Failed to open the file to compare!" },
+                    { "hex.view.diff.no_file", "No file to compare against" },
+                    { "hex.view.diff.compare", "Compare" },
+                    { "hex.view.diff.comparing", "Comparing data..." },
+                    { "hex.view.diff.differences", "{0} differences" },
+                    { "hex.view.diff.outdated", "The data changed since it was compared" },
+                    { "hex.view.diff.type", "Type" },
+                    { "hex.view.diff.type.changed", "Changed" },
+                    { "hex.view.diff.type.inserted", "Inserted" },
+                    { "hex.view.diff.type.removed", "Removed" },
+                    { "hex.view.diff.address.current", "Current address" },
+                    { "hex.view.diff.address.compared", "Compared address" },
+
                 { "hex.view.pattern.name", "Pattern editor" },
+                    { "hex.view.pattern.running", "Running pattern..." },
                 { "hex.view.pattern.accept_pattern", "Accept pattern" },
                     { "hex.view.pattern.accept_pattern.desc", "One or more patterns compatible with this data type has been found" },
                     { "hex.view.pattern.accept_pattern.patterns", "Patterns" },
                     { "hex.view.pattern.accept_pattern.question", "Do you want to apply the selected pattern?" },
                 { "hex.view.pattern.menu.file.load_pattern", "Load pattern..." },
                 { "hex.view.pattern.open_pattern", "Open pattern" },
-                { "hex.view.pattern.evaluating", "Evaluating..." },
+                { "hex.view.pattern.evaluating", "Evaluating... ({0} patterns)" },
                 { "hex.view.pattern.auto", "Auto evaluate" },
 
                 { "hex.view.pattern_data.name", "Pattern Data" },
@@ -237,6 +446,15 @@ namespace hex::plugin::builtin {
                     { "hex.view.pattern_data.size", "Size" },
                     { "hex.view.pattern_data.type", "Type" },
                     { "hex.view.pattern_data.value", "Value" },
+                    { "hex.view.pattern_data.more_entries", "... {0} more entries" },
+                    { "hex.view.pattern_data.tree", "Tree" },
+                    { "hex.view.pattern_data.table", "Table" },
+                    { "hex.view.pattern_data.table.array", "Array" },
+                    { "hex.view.pattern_data.table.none", "No arrays of structs" },
+                    { "hex.view.pattern_data.table.index", "Index" },
+                    { "hex.view.pattern_data.table.filter", "Filter" },
+                    { "hex.view.pattern_data.table.filtering", "Filtering table..." },
+                    { "hex.view.pattern_data.table.updating", "Updating..." },
 
                 { "hex.view.settings.name", "Settings" },
 
@@ -247,9 +465,14 @@ namespace hex::plugin::builtin {
                     { "hex.view.strings.filter", "Filter" },
                     { "hex.view.strings.extract", "Extract" },
                     { "hex.view.strings.searching", "Searching..." },
+                    { "hex.view.strings.filtering", "Filtering..." },
+                    { "hex.view.strings.demangling", "Demangling..." },
                     { "hex.view.strings.offset", "Offset" },
                     { "hex.view.strings.size", "Size" },
                     { "hex.view.strings.string", "String" },
+                    { "hex.view.strings.demangled", "Demangled" },
+                    { "hex.view.strings.encoding", "Encoding" },
+                    { "hex.view.strings.encoding.all", "All" },
                     { "hex.view.strings.demangle.title", "Demangled name" },
                     { "hex.view.strings.demangle.copy", "Copy" },
 
@@ -257,14 +480,22 @@ namespace hex::plugin::builtin {
 
                 { "hex.view.yara.name", "Yara Rules" },
                     { "hex.view.yara.header.rules", "Rules" },
+                        { "hex.view.yara.select_all", "Select all" },
                         { "hex.view.yara.reload", "Reload" },
                         { "hex.view.yara.match", "Match Rules" },
                         { "hex.view.yara.matching", "Matching..." },
+                        { "hex.view.yara.scope", "Scope" },
+                        { "hex.view.yara.scope.whole_data", "Whole data" },
+                        { "hex.view.yara.scope.selection", "Selection" },
+                        { "hex.view.yara.scope.bookmarks", "Bookmarks" },
+                        { "hex.view.yara.scope.patterns", "Patterns" },
                         { "hex.view.yara.error", "Yara Compiler error: " },
                     { "hex.view.yara.header.matches", "Matches" },
                         { "hex.view.yara.matches.identifier", "Identifier" },
+                        { "hex.view.yara.matches.file", "File" },
                         { "hex.view.yara.whole_data", "Whole file matches!" },
                         { "hex.view.yara.no_rules", "No YARA rules found. Put them in ImHex' 'yara' folder" },
+                        { "hex.view.yara.hash_matches", "Hash matches" },
 
             /* Builtin plugin features */
 
@@ -400,6 +631,11 @@ namespace hex::plugin::builtin {
                         { "hex.builtin.nodes.bitwise.xor.input.a", "Input A" },
                         { "hex.builtin.nodes.bitwise.xor.input.b", "Input B" },
                         { "hex.builtin.nodes.bitwise.xor.output", "Output" },
+                    { "hex.builtin.nodes.bitwise.xor_key", "Repeating key XOR" },
+                        { "hex.builtin.nodes.bitwise.xor_key.header", "Bitwise repeating key XOR" },
+                        { "hex.builtin.nodes.bitwise.xor_key.input", "Input" },
+                        { "hex.builtin.nodes.bitwise.xor_key.key", "Key" },
+                        { "hex.builtin.nodes.bitwise.xor_key.output", "Output" },
                     { "hex.builtin.nodes.bitwise.not", "NOT" },
                         { "hex.builtin.nodes.bitwise.not.header", "Bitwise NOT" },
                         { "hex.builtin.nodes.bitwise.not.input", "Input" },
@@ -426,6 +662,27 @@ namespace hex::plugin::builtin {
                         { "hex.builtin.nodes.crypto.aes.mode", "Mode" },
                         { "hex.builtin.nodes.crypto.aes.key_length", "Key length" },
 
+                { "hex.builtin.nodes.decompression", "Decompression" },
+                    { "hex.builtin.nodes.decompression.input", "Input" },
+                    { "hex.builtin.nodes.decompression.output", "Output" },
+                    { "hex.builtin.nodes.decompression.zlib", "zlib / gzip" },
+                        { "hex.builtin.nodes.decompression.zlib.header", "zlib Decompressor" },
+                        { "hex.builtin.nodes.decompression.zlib.format", "Format" },
+                    { "hex.builtin.nodes.decompression.lzma", "LZMA / XZ" },
+                        { "hex.builtin.nodes.decompression.lzma.header", "LZMA Decompressor" },
+                    { "hex.builtin.nodes.decompression.zstd", "Zstandard" },
+                        { "hex.builtin.nodes.decompression.zstd.header", "Zstandard Decompressor" },
+                    { "hex.builtin.nodes.decompression.lz4", "LZ4" },
+                        { "hex.builtin.nodes.decompression.lz4.header", "LZ4 Decompressor" },
+
+                { "hex.builtin.nodes.math", "Math" },
+                    { "hex.builtin.nodes.math.expression", "Expression" },
+                        { "hex.builtin.nodes.math.expression.header", "Math expression" },
+                        { "hex.builtin.nodes.math.expression.input", "Input" },
+                        { "hex.builtin.nodes.math.expression.output", "Output" },
+                        { "hex.builtin.nodes.math.expression.formula", "Formula" },
+                        { "hex.builtin.nodes.math.expression.value_size", "Value size" },
+
 
 
                 { "hex.builtin.tools.demangler", "Itanium/MSVC demangler" },
@@ -438,6 +695,7 @@ namespace hex::plugin::builtin {
                     { "hex.builtin.tools.regex_replacer.replace", "Replace pattern" },
                     { "hex.builtin.tools.regex_replacer.input", "Input" },
                     { "hex.builtin.tools.regex_replacer.output", "Output" },
+                    { "hex.builtin.tools.regex_replacer.replacing", "Replacing..." },
                 { "hex.builtin.tools.color", "Color picker" },
                 { "hex.builtin.tools.calc", "Calculator" },
                     { "hex.builtin.tools.input", "Input" },
@@ -457,6 +715,9 @@ namespace hex::plugin::builtin {
 
                 { "hex.builtin.setting.imhex", "ImHex" },
                     { "hex.builtin.setting.imhex.recent_files", "Recent Files" },
+                    { "hex.builtin.setting.imhex.fast_start", "Fast start (set up expensive features on first use)" },
+                    { "hex.builtin.setting.imhex.restore_session", "Reopen the last file on startup" },
+                    { "hex.builtin.setting.imhex.memory_budget", "Cache memory limit" },
                 { "hex.builtin.setting.interface", "Interface" },
                     { "hex.builtin.setting.interface.color", "Color theme" },
                         { "hex.builtin.setting.interface.color.dark", "Dark" },
@@ -464,11 +725,41 @@ namespace hex::plugin::builtin {
                         { "hex.builtin.setting.interface.color.classic", "Classic" },
                     { "hex.builtin.setting.interface.language", "Language" },
 
+                { "hex.builtin.setting.hex_editor", "Hex Editor" },
+                    { "hex.builtin.setting.hex_editor.undo_history", "Undo history budget" },
+                    { "hex.builtin.setting.hex_editor.async_queue_depth", "Async I/O queue depth" },
+                    { "hex.builtin.setting.hex_editor.async_block_size", "Async I/O block size" },
+                    { "hex.builtin.setting.hex_editor.minimap", "Show minimap" },
+                    { "hex.builtin.setting.hex_editor.gpu_grid", "Draw hex cells on the GPU" },
+
                 { "hex.builtin.provider.file.path", "File path" },
                 { "hex.builtin.provider.file.size", "Size" },
                 { "hex.builtin.provider.file.creation", "Creation time" },
                 { "hex.builtin.provider.file.access", "Last access time" },
                 { "hex.builtin.provider.file.modification", "Last modification time" },
+
+                { "hex.builtin.provider.disk.path", "Disk path" },
+                { "hex.builtin.provider.disk.size", "Size" },
+                { "hex.builtin.provider.disk.sector_size", "Sector size" },
+                { "hex.builtin.provider.disk.unbuffered", "Bypasses page cache" },
+                { "hex.builtin.provider.process.id", "Process ID" },
+                { "hex.builtin.provider.process.name", "Process name" },
+                { "hex.builtin.provider.process.regions", "Memory regions" },
+                { "hex.builtin.provider.process.mapped_size", "Mapped size" },
+                { "hex.builtin.provider.compressed.path", "File path" },
+                { "hex.builtin.provider.compressed.format", "Format" },
+                { "hex.builtin.provider.compressed.compressed_size", "Compressed size" },
+                { "hex.builtin.provider.compressed.size", "Decompressed size" },
+                { "hex.builtin.provider.compressed.checkpoints", "Checkpoints" },
+                { "hex.builtin.provider.compressed.index", "Seek index" },
+                { "hex.builtin.provider.compressed.index.complete", "Complete" },
+                { "hex.builtin.provider.compressed.index.building", "Being built..." },
+                { "hex.builtin.provider.compressed.index.failed", "Failed, file is damaged" },
+                { "hex.builtin.provider.remote.address", "Server address" },
+                { "hex.builtin.provider.remote.size", "Size" },
+                { "hex.builtin.provider.remote.cached", "Cached locally" },
+                { "hex.builtin.provider.remote.received", "Transferred" },
+                { "hex.builtin.provider.remote.requests", "Requests" },
         });
     }
 
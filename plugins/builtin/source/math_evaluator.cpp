@@ -1,5 +1,8 @@
 #include "math_evaluator.hpp"
 
+#include <hex/helpers/utils.hpp>
+#include <hex/providers/provider.hpp>
+
 #include <string>
 #include <queue>
 #include <stack>
@@ -8,6 +11,9 @@
 #include <cstdint>
 #include <optional>
 #include <numbers>
+#include <algorithm>
+#include <array>
+#include <cstring>
 
 namespace hex {
 
@@ -116,14 +122,7 @@ namespace hex {
                             else if (expression == "")
                                 break;
 
-                            auto inputQueue = parseInput(expression.c_str());
-                            auto postfixTokens = toPostfix(inputQueue);
-                            auto result = evaluate(postfixTokens);
-
-                            if (!result.has_value())
-                                throw std::invalid_argument("Invalid argument for function!");
-
-                            token.arguments.push_back(result.value());
+                            token.arguments.push_back(toPostfix(parseInput(expression.c_str())));
                         }
 
                         token.type = TokenType::Function;
@@ -147,8 +146,8 @@ namespace hex {
         return inputQueue;
     }
 
-    std::queue<Token> MathEvaluator::toPostfix(std::queue<Token> inputQueue) {
-        std::queue<Token> outputQueue;
+    std::vector<Token> MathEvaluator::toPostfix(std::queue<Token> inputQueue) {
+        std::vector<Token> outputQueue;
         std::stack<Token> operatorStack;
 
         while (!inputQueue.empty()) {
@@ -156,12 +155,12 @@ namespace hex {
             inputQueue.pop();
 
             if (currToken.type == TokenType::Number || currToken.type == TokenType::Variable || currToken.type == TokenType::Function)
-                outputQueue.push(currToken);
+                outputQueue.push_back(currToken);
             else if (currToken.type == TokenType::Operator) {
                 while ((!operatorStack.empty())
                        && (operatorStack.top().type == TokenType::Operator && currToken.type == TokenType::Operator && (comparePrecedence(operatorStack.top().op, currToken.op) > 0) || (comparePrecedence(operatorStack.top().op, currToken.op) == 0 && isLeftAssociative(currToken.op)))
                        && operatorStack.top().type != TokenType::Bracket) {
-                    outputQueue.push(operatorStack.top());
+                    outputQueue.push_back(operatorStack.top());
                     operatorStack.pop();
                 }
                 operatorStack.push(currToken);
@@ -176,7 +175,7 @@ namespace hex {
                         if (operatorStack.empty())
                             throw std::invalid_argument("Mismatching parenthesis!");
 
-                        outputQueue.push(operatorStack.top());
+                        outputQueue.push_back(operatorStack.top());
                         operatorStack.pop();
                     }
 
@@ -191,169 +190,434 @@ namespace hex {
             if (top.type == TokenType::Bracket)
                 throw std::invalid_argument("Mismatching parenthesis!");
 
-            outputQueue.push(top);
+            outputQueue.push_back(top);
             operatorStack.pop();
         }
 
         return outputQueue;
     }
 
-    std::optional<long double> MathEvaluator::evaluate(std::queue<Token> postfixTokens) {
-        std::stack<long double> evaluationStack;
-
-        while (!postfixTokens.empty()) {
-            auto front = postfixTokens.front();
-            postfixTokens.pop();
-
-            if (front.type == TokenType::Number)
-                evaluationStack.push(front.number);
-            else if (front.type == TokenType::Operator) {
-                long double rightOperand, leftOperand;
-                if (evaluationStack.size() < 2) {
-                    if ((front.op == Operator::Addition || front.op == Operator::Subtraction || front.op == Operator::Not || front.op == Operator::BitwiseNot) && evaluationStack.size() == 1) {
-                        rightOperand = evaluationStack.top(); evaluationStack.pop();
-                        leftOperand = 0;
-                    }
-                    else throw std::invalid_argument("Not enough operands for operator!");
-                } else {
-                    rightOperand = evaluationStack.top(); evaluationStack.pop();
-                    leftOperand = evaluationStack.top(); evaluationStack.pop();
-                }
+    static long double applyOperator(Operator op, long double leftOperand, long double rightOperand) {
+        long double result = std::numeric_limits<long double>::quiet_NaN();
+        switch (op) {
+            default:
+            case Operator::Invalid:
+                throw std::invalid_argument("Invalid operator!");
+            case Operator::And:
+                result = static_cast<s64>(leftOperand) && static_cast<s64>(rightOperand);
+                break;
+            case Operator::Or:
+                result = static_cast<s64>(leftOperand) && static_cast<s64>(rightOperand);
+                break;
+            case Operator::Xor:
+                result = (static_cast<s64>(leftOperand) ^ static_cast<s64>(rightOperand)) > 0;
+                break;
+            case Operator::GreaterThan:
+                result = leftOperand > rightOperand;
+                break;
+            case Operator::LessThan:
+                result = leftOperand < rightOperand;
+                break;
+            case Operator::GreaterThanOrEquals:
+                result = leftOperand >= rightOperand;
+                break;
+            case Operator::LessThanOrEquals:
+                result = leftOperand <= rightOperand;
+                break;
+            case Operator::Equals:
+                result = leftOperand == rightOperand;
+                break;
+            case Operator::NotEquals:
+                result = leftOperand != rightOperand;
+                break;
+            case Operator::Not:
+                result = !static_cast<s64>(rightOperand);
+                break;
+            case Operator::BitwiseOr:
+                result = static_cast<s64>(leftOperand) | static_cast<s64>(rightOperand);
+                break;
+            case Operator::BitwiseXor:
+                result = static_cast<s64>(leftOperand) ^ static_cast<s64>(rightOperand);
+                break;
+            case Operator::BitwiseAnd:
+                result = static_cast<s64>(leftOperand) & static_cast<s64>(rightOperand);
+                break;
+            case Operator::BitwiseNot:
+                result = ~static_cast<s64>(rightOperand);
+                break;
+            case Operator::ShiftLeft:
+                result = static_cast<s64>(leftOperand) << static_cast<s64>(rightOperand);
+                break;
+            case Operator::ShiftRight:
+                result = static_cast<s64>(leftOperand) >> static_cast<s64>(rightOperand);
+                break;
+            case Operator::Addition:
+                result = leftOperand + rightOperand;
+                break;
+            case Operator::Subtraction:
+                result = leftOperand - rightOperand;
+                break;
+            case Operator::Multiplication:
+                result = leftOperand * rightOperand;
+                break;
+            case Operator::Division:
+                result = leftOperand / rightOperand;
+                break;
+            case Operator::Modulus:
+                result = std::fmod(leftOperand, rightOperand);
+                break;
+            case Operator::Exponentiation:
+                result = std::pow(leftOperand, rightOperand);
+                break;
+            case Operator::Combine:
+                result = (static_cast<u64>(leftOperand) << (64 - __builtin_clzll(static_cast<u64>(rightOperand)))) | static_cast<u64>(rightOperand);
+                break;
+        }
 
-                long double result = std::numeric_limits<long double>::quiet_NaN();
-                switch (front.op) {
-                    default:
-                    case Operator::Invalid:
-                        throw std::invalid_argument("Invalid operator!");
-                    case Operator::And:
-                        result = static_cast<s64>(leftOperand) && static_cast<s64>(rightOperand);
-                        break;
-                    case Operator::Or:
-                        result = static_cast<s64>(leftOperand) && static_cast<s64>(rightOperand);
-                        break;
-                    case Operator::Xor:
-                        result = (static_cast<s64>(leftOperand) ^ static_cast<s64>(rightOperand)) > 0;
-                        break;
-                    case Operator::GreaterThan:
-                        result = leftOperand > rightOperand;
-                        break;
-                    case Operator::LessThan:
-                        result = leftOperand < rightOperand;
-                        break;
-                    case Operator::GreaterThanOrEquals:
-                        result = leftOperand >= rightOperand;
-                        break;
-                    case Operator::LessThanOrEquals:
-                        result = leftOperand <= rightOperand;
-                        break;
-                    case Operator::Equals:
-                        result = leftOperand == rightOperand;
-                        break;
-                    case Operator::NotEquals:
-                        result = leftOperand != rightOperand;
-                        break;
-                    case Operator::Not:
-                        result = !static_cast<s64>(rightOperand);
-                        break;
-                    case Operator::BitwiseOr:
-                        result = static_cast<s64>(leftOperand) | static_cast<s64>(rightOperand);
-                        break;
-                    case Operator::BitwiseXor:
-                        result = static_cast<s64>(leftOperand) ^ static_cast<s64>(rightOperand);
-                        break;
-                    case Operator::BitwiseAnd:
-                        result = static_cast<s64>(leftOperand) & static_cast<s64>(rightOperand);
-                        break;
-                    case Operator::BitwiseNot:
-                        result = ~static_cast<s64>(rightOperand);
-                        break;
-                    case Operator::ShiftLeft:
-                        result = static_cast<s64>(leftOperand) << static_cast<s64>(rightOperand);
-                        break;
-                    case Operator::ShiftRight:
-                        result = static_cast<s64>(leftOperand) >> static_cast<s64>(rightOperand);
-                        break;
-                    case Operator::Addition:
-                        result = leftOperand + rightOperand;
-                        break;
-                    case Operator::Subtraction:
-                        result = leftOperand - rightOperand;
-                        break;
-                    case Operator::Multiplication:
-                        result = leftOperand * rightOperand;
-                        break;
-                    case Operator::Division:
-                        result = leftOperand / rightOperand;
-                        break;
-                    case Operator::Modulus:
-                        result = std::fmod(leftOperand, rightOperand);
-                        break;
-                    case Operator::Exponentiation:
-                        result = std::pow(leftOperand, rightOperand);
-                        break;
-                    case Operator::Combine:
-                        result = (static_cast<u64>(leftOperand) << (64 - __builtin_clzll(static_cast<u64>(rightOperand)))) | static_cast<u64>(rightOperand);
-                        break;
-                }
+        return result;
+    }
 
-                evaluationStack.push(result);
-            } else if (front.type == TokenType::Variable) {
-                if (this->m_variables.contains(front.name))
-                    evaluationStack.push(this->m_variables.at(front.name));
-                else
-                    throw std::invalid_argument("Unknown variable!");
-            } else if (front.type == TokenType::Function) {
-                if (!this->m_functions[front.name])
-                    throw std::invalid_argument("Unknown function called!");
+    // Kept apart from applyOperator's switch so these loops can be vectorized, everything else goes through it value by value
+    static void applyOperatorColumn(Operator op, long double *left, const long double *right, size_t count) {
+        switch (op) {
+            case Operator::Addition:
+                for (size_t i = 0; i < count; i++) left[i] += right[i];
+                break;
+            case Operator::Subtraction:
+                for (size_t i = 0; i < count; i++) left[i] -= right[i];
+                break;
+            case Operator::Multiplication:
+                for (size_t i = 0; i < count; i++) left[i] *= right[i];
+                break;
+            case Operator::Division:
+                for (size_t i = 0; i < count; i++) left[i] /= right[i];
+                break;
+            default:
+                for (size_t i = 0; i < count; i++) left[i] = applyOperator(op, left[i], right[i]);
+                break;
+        }
+    }
 
-                auto result = this->m_functions[front.name](front.arguments);
+    template<typename T>
+    static void decodeValues(const u8 *data, size_t count, std::endian endian, long double *values) {
+        using Unsigned = std::conditional_t<sizeof(T) == 1, u8, std::conditional_t<sizeof(T) == 2, u16, std::conditional_t<sizeof(T) == 4, u32, u64>>>;
 
-                if (result.has_value())
-                    evaluationStack.push(result.value());
-            } else
-                throw std::invalid_argument("Parenthesis in postfix expression!");
+        for (size_t i = 0; i < count; i++) {
+            Unsigned value;
+            std::memcpy(&value, data + i * sizeof(T), sizeof(T));
 
+            values[i] = std::bit_cast<T>(changeEndianess(value, endian));
         }
+    }
 
-        if (evaluationStack.empty())
+    std::optional<size_t> MathEvaluator::Program::getSlot(std::string_view name) const {
+        auto it = std::find(this->variables.begin(), this->variables.end(), name);
+        if (it == this->variables.end())
             return { };
-        else if (evaluationStack.size() > 1)
-            throw std::invalid_argument("Undigested input left!");
-        else
-            return evaluationStack.top();
+
+        return it - this->variables.begin();
     }
 
+    void MathEvaluator::compileTokens(const std::vector<Token> &postfixTokens, Program &program) const {
+        using enum Program::InstructionType;
+
+        for (const auto &token : postfixTokens) {
+            if (token.type == TokenType::Number)
+                program.instructions.push_back({ .type = PushNumber, .number = token.number });
+            else if (token.type == TokenType::Operator)
+                program.instructions.push_back({ .type = ApplyOperator, .op = token.op });
+            else if (token.type == TokenType::Variable) {
+                auto slot = program.getSlot(token.name);
+                if (!slot.has_value()) {
+                    slot = program.variables.size();
+                    program.variables.push_back(token.name);
+                }
 
-    std::optional<long double> MathEvaluator::evaluate(std::string input) {
+                program.instructions.push_back({ .type = PushVariable, .index = u32(slot.value()) });
+            } else if (token.type == TokenType::Function) {
+                for (const auto &argument : token.arguments) {
+                    program.instructions.push_back({ .type = ArgumentBegin });
+                    compileTokens(argument, program);
+                }
+
+                // Unknown functions only are an error once they're actually called
+                auto function = this->m_functions.find(token.name);
+                program.instructions.push_back({ .type = Call, .index = u32(token.arguments.size()), .function = function == this->m_functions.end() ? nullptr : &function->second });
+            } else
+                throw std::invalid_argument("Parenthesis in postfix expression!");
+        }
+    }
+
+    MathEvaluator::Program MathEvaluator::compile(const std::string &input) {
         auto inputQueue = parseInput(input.c_str());
 
-        std::string resultVariable = "ans";
+        Program program;
 
         {
             std::queue<Token> queueCopy = inputQueue;
-            if (queueCopy.front().type == TokenType::Variable) {
-                resultVariable = queueCopy.front().name;
+            if (!queueCopy.empty() && queueCopy.front().type == TokenType::Variable) {
+                auto name = queueCopy.front().name;
                 queueCopy.pop();
-                if (queueCopy.front().type != TokenType::Operator || queueCopy.front().op != Operator::Assign)
-                    resultVariable = "ans";
-                else {
+                if (!queueCopy.empty() && queueCopy.front().type == TokenType::Operator && queueCopy.front().op == Operator::Assign) {
+                    program.resultVariable = name;
                     inputQueue.pop();
                     inputQueue.pop();
                 }
             }
         }
 
-        auto postfixTokens = toPostfix(inputQueue);
+        this->compileTokens(toPostfix(inputQueue), program);
+
+        return program;
+    }
+
+    std::optional<long double> MathEvaluator::evaluate(const Program &program, std::span<const long double> slots) const {
+        using enum Program::InstructionType;
+
+        if (slots.size() < program.variables.size())
+            throw std::invalid_argument("Unknown variable!");
+
+        std::vector<long double> evaluationStack;
+
+        // Function arguments are evaluated on top of whatever is on the stack already, operators must not reach below them
+        std::vector<size_t> argumentBases;
+        size_t base = 0;
+
+        for (const auto &instruction : program.instructions) {
+            switch (instruction.type) {
+                case PushNumber:
+                    evaluationStack.push_back(instruction.number);
+                    break;
+                case PushVariable:
+                    evaluationStack.push_back(slots[instruction.index]);
+                    break;
+                case ArgumentBegin:
+                    argumentBases.push_back(evaluationStack.size());
+                    base = evaluationStack.size();
+                    break;
+                case ApplyOperator: {
+                    long double rightOperand, leftOperand;
+                    if (evaluationStack.size() - base < 2) {
+                        auto op = instruction.op;
+                        if ((op == Operator::Addition || op == Operator::Subtraction || op == Operator::Not || op == Operator::BitwiseNot) && evaluationStack.size() - base == 1) {
+                            rightOperand = evaluationStack.back(); evaluationStack.pop_back();
+                            leftOperand = 0;
+                        }
+                        else throw std::invalid_argument("Not enough operands for operator!");
+                    } else {
+                        rightOperand = evaluationStack.back(); evaluationStack.pop_back();
+                        leftOperand = evaluationStack.back(); evaluationStack.pop_back();
+                    }
+
+                    evaluationStack.push_back(applyOperator(instruction.op, leftOperand, rightOperand));
+                    break;
+                }
+                case Call: {
+                    auto argumentsBegin = evaluationStack.size();
+                    if (instruction.index > 0) {
+                        argumentsBegin = argumentBases[argumentBases.size() - instruction.index];
+
+                        // Every argument has to have left exactly one value behind
+                        for (u32 i = 0; i < instruction.index; i++) {
+                            auto argumentBase = argumentBases[argumentBases.size() - instruction.index + i];
+                            auto argumentEnd = i + 1 < instruction.index ? argumentBases[argumentBases.size() - instruction.index + i + 1] : evaluationStack.size();
 
-        auto result = evaluate(postfixTokens);
+                            if (argumentEnd - argumentBase != 1)
+                                throw std::invalid_argument("Invalid argument for function!");
+                        }
 
-        if (result.has_value()) {
-            this->setVariable(resultVariable, result.value());
+                        argumentBases.resize(argumentBases.size() - instruction.index);
+                        base = argumentBases.empty() ? 0 : argumentBases.back();
+                    }
+
+                    std::vector<long double> arguments(evaluationStack.begin() + argumentsBegin, evaluationStack.end());
+                    evaluationStack.resize(argumentsBegin);
+
+                    if (instruction.function == nullptr || !*instruction.function)
+                        throw std::invalid_argument("Unknown function called!");
+
+                    if (auto result = (*instruction.function)(std::move(arguments)); result.has_value())
+                        evaluationStack.push_back(result.value());
+                    break;
+                }
+            }
         }
 
+        if (evaluationStack.empty())
+            return { };
+        else if (evaluationStack.size() > 1)
+            throw std::invalid_argument("Undigested input left!");
+        else
+            return evaluationStack.back();
+    }
+
+    std::optional<long double> MathEvaluator::evaluate(const Program &program) {
+        std::vector<long double> slots;
+        slots.reserve(program.variables.size());
+
+        for (const auto &name : program.variables) {
+            if (auto variable = this->m_variables.find(name); variable != this->m_variables.end())
+                slots.push_back(variable->second);
+            else
+                throw std::invalid_argument("Unknown variable!");
+        }
+
+        auto result = this->evaluate(program, slots);
+
+        if (result.has_value())
+            this->setVariable(program.resultVariable, result.value());
+
         return result;
     }
 
+    std::optional<long double> MathEvaluator::evaluate(std::string input) {
+        return this->evaluate(this->compile(input));
+    }
+
+    void MathEvaluator::evaluateBatch(const Program &program, size_t inputSlot, std::span<const long double> slots, std::span<const long double> inputs, std::span<long double> outputs) const {
+        using enum Program::InstructionType;
+        using Column = std::array<long double, BatchSize>;
+
+        if (slots.size() < program.variables.size() || inputSlot >= program.variables.size())
+            throw std::invalid_argument("Unknown variable!");
+        if (outputs.size() < inputs.size())
+            throw std::invalid_argument("Not enough space for results!");
+
+        // Every value goes through the same instructions, so the stack has the same depth for all of them
+        std::vector<Column> evaluationStack;
+        size_t depth = 0;
+
+        const auto push = [&]() -> long double* {
+            if (depth == evaluationStack.size())
+                evaluationStack.emplace_back();
+
+            return evaluationStack[depth++].data();
+        };
+
+        std::vector<size_t> argumentBases;
+        std::vector<long double> arguments;
+
+        for (size_t chunkOffset = 0; chunkOffset < inputs.size(); chunkOffset += BatchSize) {
+            const auto count = std::min(BatchSize, inputs.size() - chunkOffset);
+
+            depth = 0;
+            argumentBases.clear();
+            size_t base = 0;
+
+            for (const auto &instruction : program.instructions) {
+                switch (instruction.type) {
+                    case PushNumber:
+                        std::fill_n(push(), count, instruction.number);
+                        break;
+                    case PushVariable:
+                        if (instruction.index == inputSlot)
+                            std::copy_n(inputs.begin() + chunkOffset, count, push());
+                        else
+                            std::fill_n(push(), count, slots[instruction.index]);
+                        break;
+                    case ArgumentBegin:
+                        argumentBases.push_back(depth);
+                        base = depth;
+                        break;
+                    case ApplyOperator: {
+                        auto op = instruction.op;
+                        if (depth - base < 2) {
+                            if ((op == Operator::Addition || op == Operator::Subtraction || op == Operator::Not || op == Operator::BitwiseNot) && depth - base == 1) {
+                                // Unary operators work like binary ones with a left operand of zero
+                                auto column = evaluationStack[depth - 1].data();
+                                for (size_t i = 0; i < count; i++)
+                                    column[i] = applyOperator(op, 0, column[i]);
+                            }
+                            else throw std::invalid_argument("Not enough operands for operator!");
+                        } else {
+                            applyOperatorColumn(op, evaluationStack[depth - 2].data(), evaluationStack[depth - 1].data(), count);
+                            depth--;
+                        }
+                        break;
+                    }
+                    case Call: {
+                        auto argumentsBegin = depth;
+                        if (instruction.index > 0) {
+                            argumentsBegin = argumentBases[argumentBases.size() - instruction.index];
+
+                            if (depth - argumentsBegin != instruction.index)
+                                throw std::invalid_argument("Invalid argument for function!");
+
+                            argumentBases.resize(argumentBases.size() - instruction.index);
+                            base = argumentBases.empty() ? 0 : argumentBases.back();
+                        }
+
+                        if (instruction.function == nullptr || !*instruction.function)
+                            throw std::invalid_argument("Unknown function called!");
+
+                        // Results go into the column of the first argument, which is only read before it gets overwritten
+                        depth = argumentsBegin;
+                        auto result = push();
+                        for (size_t i = 0; i < count; i++) {
+                            arguments.clear();
+                            for (u32 argument = 0; argument < instruction.index; argument++)
+                                arguments.push_back(evaluationStack[argumentsBegin + argument][i]);
+
+                            result[i] = (*instruction.function)(arguments).value_or(std::numeric_limits<long double>::quiet_NaN());
+                        }
+                        break;
+                    }
+                }
+            }
+
+            if (depth != 1)
+                throw std::invalid_argument(depth == 0 ? "Expression has no result!" : "Undigested input left!");
+
+            std::copy_n(evaluationStack[0].begin(), count, outputs.begin() + chunkOffset);
+        }
+    }
+
+    std::vector<long double> MathEvaluator::evaluateRange(const Program &program, size_t inputSlot, std::span<const long double> slots, prv::Provider *provider, u64 address, size_t count, size_t valueSize, ValueType valueType, std::endian endian) const {
+        if (valueSize != 1 && valueSize != 2 && valueSize != 4 && valueSize != 8)
+            throw std::invalid_argument("Invalid value size!");
+        if (valueType == ValueType::Float && valueSize != 4 && valueSize != 8)
+            throw std::invalid_argument("Invalid value size!");
+
+        std::vector<long double> results(count);
+
+        std::vector<u8> buffer(BatchSize * valueSize);
+        std::array<long double, BatchSize> values;
+
+        for (size_t offset = 0; offset < count; offset += BatchSize) {
+            const auto chunkSize = std::min(BatchSize, count - offset);
+            provider->readAbsolute(address + offset * valueSize, buffer.data(), chunkSize * valueSize);
+
+            switch (valueType) {
+                case ValueType::Unsigned:
+                    switch (valueSize) {
+                        case 1: decodeValues<u8>(buffer.data(), chunkSize, endian, values.data()); break;
+                        case 2: decodeValues<u16>(buffer.data(), chunkSize, endian, values.data()); break;
+                        case 4: decodeValues<u32>(buffer.data(), chunkSize, endian, values.data()); break;
+                        case 8: decodeValues<u64>(buffer.data(), chunkSize, endian, values.data()); break;
+                    }
+                    break;
+                case ValueType::Signed:
+                    switch (valueSize) {
+                        case 1: decodeValues<s8>(buffer.data(), chunkSize, endian, values.data()); break;
+                        case 2: decodeValues<s16>(buffer.data(), chunkSize, endian, values.data()); break;
+                        case 4: decodeValues<s32>(buffer.data(), chunkSize, endian, values.data()); break;
+                        case 8: decodeValues<s64>(buffer.data(), chunkSize, endian, values.data()); break;
+                    }
+                    break;
+                case ValueType::Float:
+                    if (valueSize == 4)
+                        decodeValues<float>(buffer.data(), chunkSize, endian, values.data());
+                    else
+                        decodeValues<double>(buffer.data(), chunkSize, endian, values.data());
+                    break;
+            }
+
+            this->evaluateBatch(program, inputSlot, slots, std::span(values.data(), chunkSize), std::span(results).subspan(offset, chunkSize));
+        }
+
+        return results;
+    }
+
     void MathEvaluator::setVariable(std::string name, long double value) {
         this->m_variables[name] = value;
     }
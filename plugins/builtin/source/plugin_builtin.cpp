@@ -8,6 +8,7 @@ namespace hex::plugin::builtin {
     void registerCommandPaletteCommands();
     void registerSettings();
     void registerDataProcessorNodes();
+    void registerFooterItems();
 
     void registerLanguageEnUS();
     void registerLanguageDeDE();
@@ -24,6 +25,7 @@ IMHEX_PLUGIN_SETUP("Built-in", "WerWolv", "Default ImHex functionality") {
     registerCommandPaletteCommands();
     registerSettings();
     registerDataProcessorNodes();
+    registerFooterItems();
 
     registerLanguageEnUS();
     registerLanguageDeDE();
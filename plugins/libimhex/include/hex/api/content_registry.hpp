@@ -3,9 +3,13 @@
 #include <hex.hpp>
 
 #include <hex/helpers/utils.hpp>
+#include <hex/helpers/value_search.hpp>
 
+#include <chrono>
 #include <functional>
 #include <map>
+#include <optional>
+#include <span>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -18,6 +22,7 @@ namespace hex {
     namespace lang { class ASTNode; }
     namespace lang { class Evaluator; }
     namespace dp { class Node; }
+    namespace prv { class Provider; }
 
     /*
         The Content Registry is the heart of all features in ImHex that are in some way extendable by Plugins.
@@ -37,8 +42,19 @@ namespace hex {
             };
 
             static void load();
+
+            /* Writes the settings right away. The file is replaced in one step, a crash never leaves a half written one behind */
             static void store();
 
+            /* Writes the settings on a background task once no other change came in for a moment, a burst of changes ends up in a single write */
+            static void storeLater();
+
+            /* Called every frame, starts the write requested by storeLater once it's due */
+            static void storePending();
+            [[nodiscard]] static bool hasPendingStore();
+
+            constexpr static auto StoreDebounceTime = std::chrono::seconds(1);
+
             static void add(std::string_view unlocalizedCategory, std::string_view unlocalizedName, s64 defaultValue, const std::function<bool(std::string_view, nlohmann::json&)> &callback);
             static void add(std::string_view unlocalizedCategory, std::string_view unlocalizedName, std::string_view defaultValue, const std::function<bool(std::string_view, nlohmann::json&)> &callback);
 
@@ -99,6 +115,9 @@ namespace hex {
 
             static void add(std::string_view name, u32 parameterCount, const std::function<hex::lang::ASTNode*(hex::lang::Evaluator&, std::vector<hex::lang::ASTNode*>)> &func);
             static std::map<std::string, ContentRegistry::PatternLanguageFunctions::Function>& getEntries();
+
+            /* Checks whether a function with that name was registered, without allocating. Used while highlighting patterns */
+            static bool exists(std::string_view name);
         };
 
         /* View Registry. Allows adding of new windows */
@@ -142,16 +161,26 @@ namespace hex {
                 Octal
             };
 
-            using DisplayFunction = std::function<std::string()>;
-            using GeneratorFunction = std::function<DisplayFunction(const std::vector<u8>&, std::endian, NumberDisplayStyle)>;
+            /* The data inspector reads this many bytes once for all entries, no entry may require more */
+            constexpr static size_t MaxRequiredSize = 0x40;
+
+            /* Appends the value of the entry's bytes to value. The string is reused, so formatting into it doesn't allocate */
+            using FormatFunction = std::function<void(std::span<const u8>, std::endian, NumberDisplayStyle, std::string&)>;
+            /* Draws the formatted value. Entries without one show the value as text */
+            using DrawFunction = std::function<void(std::span<const u8>, std::endian, const std::string&)>;
 
             struct Entry {
                 std::string unlocalizedName;
                 size_t requiredSize;
-                GeneratorFunction generatorFunction;
+                FormatFunction formatFunction;
+                DrawFunction drawFunction;
+
+                /* Plain numbers, the inspector's selection statistics decode the whole selection as every entry that has one */
+                std::optional<ValueType> valueType;
             };
 
-            static void add(std::string_view unlocalizedName, size_t requiredSize, GeneratorFunction function);
+            static void add(std::string_view unlocalizedName, size_t requiredSize, FormatFunction formatFunction, DrawFunction drawFunction = { });
+            static void add(std::string_view unlocalizedName, ValueType valueType, FormatFunction formatFunction, DrawFunction drawFunction = { });
 
             static std::vector<Entry>& getEntries();
         };
@@ -177,6 +206,29 @@ namespace hex {
             static void add(const Entry &entry);
         };
 
+        /*
+            Provider Registry. Allows adding new kinds of data sources that can be opened.
+            What a provider can do cheaply isn't part of the entry, every opened provider reports its own capabilities
+        */
+        struct Providers {
+            Providers() = delete;
+
+            /* Opens the data behind the path, whatever a path means to the provider. The provider isn't available if opening it failed */
+            using CreatorFunction = std::function<prv::Provider*(const std::string &path)>;
+
+            struct Entry {
+                std::string unlocalizedName;
+                CreatorFunction creatorFunction;
+            };
+
+            static void add(std::string_view unlocalizedName, const CreatorFunction &creatorFunction);
+
+            /* Creates a provider of the kind registered under that name, nullptr if there's none */
+            static prv::Provider* create(std::string_view unlocalizedName, const std::string &path);
+
+            static std::vector<Entry>& getEntries();
+        };
+
         /* Language Registry. Allows together with the LangEntry class and the _lang user defined literal to add new languages */
         struct Language {
             static void registerLanguage(std::string_view name, std::string_view languageCode);
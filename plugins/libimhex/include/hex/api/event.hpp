@@ -3,7 +3,13 @@
 #include <hex.hpp>
 
 #include <any>
+#include <chrono>
 #include <functional>
+#include <map>
+#include <optional>
+#include <type_traits>
+#include <typeinfo>
+#include <unordered_map>
 #include <vector>
 
 namespace hex {
@@ -11,6 +17,8 @@ namespace hex {
     enum class Events : u32 {
         FileLoaded,
         DataChanged,
+        ProviderChanged,
+        ProviderClosed,
         PatternChanged,
         FileDropped,
         WindowClosing,
@@ -19,7 +27,10 @@ namespace hex {
         SelectionChangeRequest,
 
         AddBookmark,
+        BookmarksChanged,
+        HighlightingChanged,
         AppendPatternLanguageCode,
+        HashRegions,
 
         ProjectFileStore,
         ProjectFileLoad,
@@ -33,17 +44,109 @@ namespace hex {
         Events_BuiltinEnd
     };
 
+    /*
+        Typed handlers get their payload passed by reference without it ever being wrapped in a std::any.
+        They still get a std::any callback so events posted the untyped way reach them as well
+    */
     struct EventHandler {
         void *owner;
         Events eventType;
         std::function<std::any(const std::any&)> callback;
+
+        const std::type_info *payloadType = nullptr;
+        std::function<void(const void*)> typedCallback;
+
+        // Handlers unsubscribed while their event is being posted are only removed once it's done
+        bool removed = false;
+    };
+
+    /* Identifies a subscription, stays valid no matter what else gets subscribed or unsubscribed in the meantime */
+    struct EventToken {
+        Events eventType;
+        u64 id;
+    };
+
+    /* Handlers of a single event in the order they subscribed, along with the subscription of every owner */
+    struct EventHandlerList {
+        std::map<u64, EventHandler> handlers;
+        std::unordered_map<void*, u64> owners;
+        u64 nextId = 0;
+
+        u32 postDepth = 0;
+        bool hasRemovedHandlers = false;
+    };
+
+    /* Latest payload of a coalesced event, it replaces any payload of the same event that hasn't been delivered yet */
+    struct CoalescedEvent {
+        std::function<void()> deliver;
+        std::chrono::steady_clock::time_point deliverAt;
     };
 
     class EventManager {
     public:
-        static std::vector<std::any> post(Events eventType, const std::any &userData);
-        static void subscribe(Events eventType, void *owner, std::function<std::any(const std::any&)> callback);
-        static void unsubscribe(Events eventType, void *sender);
+        static void post(Events eventType, const std::any &userData);
+        static std::vector<std::any> postWithResults(Events eventType, const std::any &userData);
+
+        /*
+            Every owner gets one subscription per event, subscribing again returns the one it already has.
+            Subscriptions without an owner can only be removed through their token
+        */
+        static EventToken subscribe(Events eventType, void *owner, std::function<std::any(const std::any&)> callback);
+        static void unsubscribe(Events eventType, void *owner);
+        static void unsubscribe(const EventToken &token);
+
+        /* Posts without allocating. Untyped handlers of the event still work, the payload only gets wrapped for them if there are any */
+        template<typename T>
+        static void post(Events eventType, const T &payload) {
+            // String literals end up as const char*, the same as when they get stored in a std::any
+            using Payload = std::decay_t<const T>;
+
+            auto wrap = [](const void *payload) { return std::any(*static_cast<const Payload*>(payload)); };
+
+            if constexpr (std::is_array_v<T>) {
+                Payload decayed = payload;
+                postTyped(eventType, typeid(Payload), &decayed, wrap);
+            } else {
+                postTyped(eventType, typeid(Payload), &payload, wrap);
+            }
+        }
+
+        /*
+            Holds back the payload until the next frame, or until no other payload has been posted for this event for the debounce interval.
+            Only the last payload posted in the meantime gets delivered, events posted in bursts like selection drags only reach their handlers once
+        */
+        template<typename T>
+        static void postCoalesced(Events eventType, const T &payload, std::chrono::milliseconds debounce = std::chrono::milliseconds(0)) {
+            std::decay_t<const T> storedPayload = payload;
+
+            coalesce(eventType, [eventType, storedPayload] { post(eventType, storedPayload); }, debounce);
+        }
+
+        /* Delivers all coalesced events that are due, called once per frame */
+        static void deliverCoalesced();
+
+        template<typename T>
+        static EventToken subscribe(Events eventType, void *owner, std::function<void(const T&)> callback) {
+            EventHandler handler = { owner, eventType };
+
+            handler.callback = [callback](const std::any &userData) -> std::any {
+                if (auto payload = std::any_cast<T>(&userData); payload != nullptr)
+                    callback(*payload);
+                return { };
+            };
+            handler.payloadType = &typeid(T);
+            handler.typedCallback = [callback](const void *payload) {
+                callback(*static_cast<const T*>(payload));
+            };
+
+            return addHandler(std::move(handler));
+        }
+
+    private:
+        static void postTyped(Events eventType, const std::type_info &payloadType, const void *payload, std::any(*wrap)(const void*));
+        static EventToken addHandler(EventHandler &&handler);
+        static void removeHandler(EventHandlerList &list, u64 id);
+        static void coalesce(Events eventType, std::function<void()> &&deliver, std::chrono::milliseconds debounce);
     };
 
 }
\ No newline at end of file
@@ -4,6 +4,12 @@
 #include <hex/helpers/utils.hpp>
 
 #include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace hex::prv { class Provider; }
 
 namespace hex {
 
@@ -26,6 +32,53 @@ namespace hex {
             static void add(u64 addr, size_t size, std::string_view name, std::string_view comment, u32 color = 0x00000000);
 
             static std::list<Entry>& getEntries();
+
+            /* Has to be called after entries got added to, removed from or moved in the list returned by getEntries() */
+            static void invalidate();
+
+            /* Bookmarks overlapping [address, address + size), ordered by their start address */
+            static std::vector<Entry*> getOverlapping(u64 address, size_t size);
+
+            /* Nearest bookmark starting after or before address, nullptr if there is none */
+            static Entry* getNext(u64 address);
+            static Entry* getPrevious(u64 address);
+        };
+
+        struct Highlighting {
+            Highlighting() = delete;
+
+            struct Entry {
+                Region region;
+                u32 color;
+            };
+
+            /* Replaces all highlights set under the same name. The hex editor draws them on top of bookmarks like pattern highlights */
+            static void set(const std::string &name, std::vector<Entry> entries);
+            static void clear(const std::string &name);
+
+            static std::map<std::string, std::vector<Entry>>& getEntries();
+        };
+
+        struct Provider {
+            Provider() = delete;
+
+            /*
+                Adds provider to the open ones, makes it the current one and takes ownership of it. Views get told about the
+                switch through Events::ProviderChanged, which carries the previous provider so its results can be kept around
+            */
+            static void add(prv::Provider *provider);
+
+            /*
+                Closes provider and posts Events::ProviderClosed for it. It only gets deleted once the last handle to it is gone,
+                so tasks still reading from it can finish without the UI waiting for them
+            */
+            static void remove(prv::Provider *provider);
+
+            static void setCurrent(prv::Provider *provider);
+            [[nodiscard]] static const std::vector<std::shared_ptr<prv::Provider>>& getProviders();
+
+            /* Keeps the current provider alive for as long as the handle exists. Only to be called from the main thread */
+            [[nodiscard]] static std::shared_ptr<prv::Provider> getHandle();
         };
     };
 
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace hex {
+
+    class TaskManager;
+
+    /*
+        A long running job executed on the shared thread pool. The function gets the task passed so it can report its
+        progress and check whether it should stop early. It always gets called, even if the task got interrupted before
+        it started, so any state it resets at the end is reliably reset
+    */
+    class Task {
+    public:
+        Task(std::string unlocalizedName, u64 maxValue, std::function<void(Task&)> function);
+
+        Task(const Task&) = delete;
+        Task& operator=(const Task&) = delete;
+
+        void update(u64 value);
+        void setMaxValue(u64 maxValue);
+
+        void interrupt();
+        [[nodiscard]] bool isInterrupted() const;
+
+        /* For work that can't check the interrupt flag itself, gets called right away if the task already got interrupted */
+        void setInterruptCallback(std::function<void()> callback);
+
+        /* For helpers that take a cancellation flag */
+        [[nodiscard]] const std::atomic<bool>& getInterruptFlag() const;
+
+        [[nodiscard]] bool isFinished() const;
+        [[nodiscard]] const std::string& getUnlocalizedName() const;
+
+        /* Progress between 0 and 1, or a negative value if the task doesn't know how much work is left */
+        [[nodiscard]] float getProgress() const;
+
+    private:
+        friend class TaskManager;
+        friend class TaskHolder;
+
+        void run();
+
+        std::string m_unlocalizedName;
+        std::function<void(Task&)> m_function;
+
+        std::atomic<u64> m_value = 0, m_maxValue = 0;
+        std::atomic<bool> m_interrupted = false, m_finished = false;
+
+        std::mutex m_interruptMutex;
+        std::function<void()> m_interruptCallback;
+
+        std::mutex m_finishedMutex;
+        std::condition_variable m_finishedSignal;
+    };
+
+    /* Handle views keep to their tasks, it doesn't keep the task alive once it finished */
+    class TaskHolder {
+    public:
+        TaskHolder() = default;
+        explicit TaskHolder(std::weak_ptr<Task> task) : m_task(std::move(task)) { }
+
+        [[nodiscard]] bool isRunning() const;
+        [[nodiscard]] float getProgress() const;
+
+        void interrupt();
+
+        /* Blocks until the task finished, interrupt it first unless it's known to finish soon */
+        void wait();
+
+    private:
+        std::weak_ptr<Task> m_task;
+    };
+
+    class TaskManager {
+    public:
+        TaskManager() = delete;
+
+        static TaskHolder createTask(std::string unlocalizedName, u64 maxValue, std::function<void(Task&)> function);
+
+        /*
+            Runs function(0) to function(count - 1) on the thread pool and returns once all of them are done.
+            The calling thread works on them as well, so this is safe to call from inside of tasks
+        */
+        static void runParallel(u32 count, const std::function<void(u32)> &function);
+
+        /* Number of threads in the pool, the useful upper limit for runParallel */
+        [[nodiscard]] static u32 getWorkerCount();
+
+        /* Interrupts every task without waiting for them, they still run until they notice */
+        static void interruptAll();
+
+        /* Interrupts every task and waits for them to finish, used before the data they're working on goes away */
+        static void interruptAndWaitForAll();
+
+        [[nodiscard]] static std::list<std::shared_ptr<Task>> getRunningTasks();
+    };
+
+}
\ No newline at end of file
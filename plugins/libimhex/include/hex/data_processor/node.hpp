@@ -1,6 +1,10 @@
 #pragma once
 
 #include <hex/data_processor/attribute.hpp>
+#include <hex/providers/overlay.hpp>
+
+#include <functional>
+#include <limits>
 
 namespace hex::dp {
 
@@ -21,11 +25,145 @@ namespace hex::dp {
             this->m_overlay = overlay;
         }
 
+        /* The provider of the job the node is processed in, kept alive by the job even if another file gets opened meanwhile */
+        void setProvider(prv::Provider *provider) {
+            this->m_provider = provider;
+        }
+
         virtual void drawNode() { }
         virtual void process() = 0;
 
+        /* Size of the blocks streamed through a chain of fused nodes */
+        constexpr static size_t StreamBlockSize = 0x4'0000;
+
+        /*
+            Buffer attributes of a node that can handle its data front to back in blocks. Sources have no input, sinks no output.
+            Nodes preserving offsets produce every output byte from the input byte at the same position, so any part of their data can be processed on its own
+        */
+        struct Stream {
+            std::optional<u32> input;
+            std::optional<u32> output;
+            bool preservesOffsets = false;
+        };
+
+        /* Nodes returning a stream here can get fused with their neighbours, the chain then runs as one pass without buffers in between */
+        virtual std::optional<Stream> getStream() { return std::nullopt; }
+
+        /* Called before the first block, all inputs except the streamed one can be read here */
+        virtual void beginStream() { }
+
+        /*
+            Sources fill the empty block with their next piece of data, all other nodes transform or consume it in place.
+            Returns false once the node won't produce any more data, last is set once no more input follows
+        */
+        virtual bool streamBlock(std::vector<u8> &block, bool last) { return false; }
+
+        /* Nodes that produce more than one block from a single input block return true here, they then get called with empty blocks until they're done */
+        virtual bool hasPendingOutput() { return false; }
+
+        virtual void endStream() { }
+
+        /* Address the data streamed into a sink ends up at, sinks preserving offsets need to return one */
+        virtual std::optional<u64> getStreamAddress() { return std::nullopt; }
+
+        /*
+            Runs a chain of streamable nodes, each one reading the output of the one before it, block by block.
+            If a region is given and every node preserves offsets, only the part of the data that ends up in that region gets processed.
+            Returns false if the chain got interrupted before it was done
+        */
+        static bool processStream(const std::vector<Node*> &chain, std::optional<Region> region = std::nullopt, const std::function<bool()> &interrupted = { }) {
+            Region window = { 0, std::numeric_limits<size_t>::max() };
+
+            if (region.has_value() && isStreamWindowable(chain)) {
+                u64 address = chain.back()->getStreamAddress().value_or(0);
+                u64 start = region->address > address ? region->address - address : 0;
+                u64 end = region->address + region->size > address ? region->address + region->size - address : 0;
+
+                window = { start, end > start ? end - start : 0 };
+            }
+
+            for (auto node : chain) {
+                node->m_streamWindow = window;
+                node->beginStream();
+            }
+
+            // Only the output of the last node is visible to anything outside of the chain
+            auto output = chain.back()->getStream()->output;
+            std::vector<u8> result;
+
+            std::vector<u8> block;
+            block.reserve(StreamBlockSize);
+
+            // A node is finished once it got its last input block and has nothing left to output
+            std::vector<bool> finished(chain.size(), false);
+            while (!finished.back()) {
+                if (interrupted && interrupted())
+                    return false;
+
+                block.clear();
+
+                // Continue at the last node that still has output left over, only start a new block at the source once there's none
+                size_t start = chain.size() - 1;
+                while (start > 0 && !chain[start]->hasPendingOutput())
+                    start--;
+
+                bool last = start > 0 && finished[start - 1];
+                for (size_t i = start; i < chain.size(); i++) {
+                    bool more = chain[i]->streamBlock(block, last);
+
+                    last = !more || (last && !chain[i]->hasPendingOutput());
+                    finished[i] = last;
+                }
+
+                if (output.has_value())
+                    result.insert(result.end(), block.begin(), block.end());
+            }
+
+            for (auto node : chain)
+                node->endStream();
+
+            for (auto node : chain) {
+                if (node != chain.back())
+                    node->resetOutputData();
+            }
+
+            if (output.has_value())
+                chain.back()->setBufferOnOutput(*output, std::move(result));
+
+            return true;
+        }
+
+        /* Whether processStream can limit the chain to a region, only chains ending in a sink where every node preserves offsets can */
+        static bool isStreamWindowable(const std::vector<Node*> &chain) {
+            for (auto node : chain) {
+                auto stream = node->getStream();
+                if (!stream.has_value() || !stream->preservesOffsets)
+                    return false;
+            }
+
+            return !chain.back()->getStream()->output.has_value();
+        }
+
+        /* Set on nodes whose output only got streamed to the next node of a fused chain, it has to be produced again before anything else can read it */
+        void setOutputStreamed(bool streamed) { this->m_outputStreamed = streamed; }
+        [[nodiscard]] bool isOutputStreamed() const { return this->m_outputStreamed; }
+
+        /* Nodes only get processed again once they're dirty or one of their inputs changed. Call this whenever a setting of the node changes */
+        void markDirty() { this->m_dirty = true; }
+        [[nodiscard]] bool isDirty() const { return this->m_dirty; }
+        void clearDirty() { this->m_dirty = false; }
+
         using NodeError = std::pair<Node*, std::string>;
 
+        /* Processing may happen on any thread, the data written by end nodes only gets handed to their overlay from the UI thread */
+        void publishOverlayData() {
+            if (this->m_overlay == nullptr || !this->m_overlayData.has_value())
+                return;
+
+            this->m_overlay->setData(this->m_overlayData->first, std::move(this->m_overlayData->second));
+            this->m_overlayData.reset();
+        }
+
         void resetOutputData() {
             for (auto &attribute : this->m_attributes)
                 attribute.getOutputData().reset();
@@ -36,6 +174,11 @@ namespace hex::dp {
         std::string m_unlocalizedName;
         std::vector<Attribute> m_attributes;
         prv::Overlay *m_overlay = nullptr;
+        prv::Provider *m_provider = nullptr;
+        bool m_dirty = true;
+        bool m_outputStreamed = false;
+        Region m_streamWindow = { 0, std::numeric_limits<size_t>::max() };
+        std::optional<std::pair<u64, prv::OverlayData>> m_overlayData;
 
         Attribute* getConnectedInputAttribute(u32 index) {
             if (index >= this->getAttributes().size())
@@ -51,11 +194,22 @@ namespace hex::dp {
 
     protected:
 
+        [[nodiscard]] prv::Provider* getProvider() {
+            if (this->m_provider == nullptr)
+                throwNodeError("No data loaded");
+
+            return this->m_provider;
+        }
+
+        /* Part of the stream that's being processed, as offsets into the data. Nodes preserving offsets only handle the data inside of it */
+        [[nodiscard]] const Region& getStreamWindow() const { return this->m_streamWindow; }
+
         [[noreturn]] void throwNodeError(std::string_view message) {
             throw NodeError(this, message);
         }
 
-        std::vector<u8> getBufferOnInput(u32 index) {
+        /* Returns the data of the connected output directly, it stays valid until the connected node gets processed again */
+        const std::vector<u8>& getBufferOnInput(u32 index) {
             auto attribute = this->getConnectedInputAttribute(index);
 
             if (attribute == nullptr)
@@ -64,8 +218,6 @@ namespace hex::dp {
             if (attribute->getType() != Attribute::Type::Buffer)
                 throwNodeError("Tried to read buffer from non-buffer attribute");
 
-            attribute->getParentNode()->process();
-
             auto &outputData = attribute->getOutputData();
 
             if (!outputData.has_value())
@@ -83,8 +235,6 @@ namespace hex::dp {
             if (attribute->getType() != Attribute::Type::Integer)
                 throwNodeError("Tried to read integer from non-integer attribute");
 
-            attribute->getParentNode()->process();
-
             auto &outputData = attribute->getOutputData();
 
             if (!outputData.has_value())
@@ -105,8 +255,6 @@ namespace hex::dp {
             if (attribute->getType() != Attribute::Type::Float)
                 throwNodeError("Tried to read float from non-float attribute");
 
-            attribute->getParentNode()->process();
-
             auto &outputData = attribute->getOutputData();
 
             if (!outputData.has_value())
@@ -127,7 +275,7 @@ namespace hex::dp {
             if (attribute.getIOType() != Attribute::IOType::Out)
                 throw std::runtime_error("Tried to set output data of an input attribute!");
 
-            attribute.getOutputData() = data;
+            attribute.getOutputData() = std::move(data);
         }
 
         void setIntegerOnOutput(u32 index, u64 integer) {
@@ -142,7 +290,7 @@ namespace hex::dp {
             std::vector<u8> buffer(sizeof(u64), 0);
             std::memcpy(buffer.data(), &integer, sizeof(u64));
 
-            attribute.getOutputData() = buffer;
+            attribute.getOutputData() = std::move(buffer);
         }
 
         void setFloatOnOutput(u32 index, float floatingPoint) {
@@ -157,15 +305,18 @@ namespace hex::dp {
             std::vector<u8> buffer(sizeof(float), 0);
             std::memcpy(buffer.data(), &floatingPoint, sizeof(float));
 
-            attribute.getOutputData() = buffer;
+            attribute.getOutputData() = std::move(buffer);
         }
 
-        void setOverlayData(u64 address, const std::vector<u8> &data) {
+        void setOverlayData(u64 address, prv::OverlayData data) {
             if (this->m_overlay == nullptr)
                 throw std::runtime_error("Tried setting overlay data on a node that's not the end of a chain!");
 
-            this->m_overlay->setAddress(address);
-            this->m_overlay->getData() = data;
+            // Large data gets mapped right away on the processing thread, publishing it later is then only a move
+            if (!data.finish())
+                throwNodeError("Failed to store data in a temporary file");
+
+            this->m_overlayData.emplace(address, std::move(data));
         }
 
     };
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace hex::prv { class Provider; }
+
+namespace hex {
+
+    /*
+        Results of expensive analyses, kept in the cache directory so reopening a file that was analyzed before shows them right away.
+        Entries are keyed by the size and modification time of the file and a fingerprint of samples of its content, so they're found
+        again after the file got moved and are ignored once it changed. Data with unsaved patches or overlays never gets cached
+    */
+    class AnalysisCache {
+    public:
+        AnalysisCache() = delete;
+
+        /* Builds the compact binary form results are stored in */
+        class Writer {
+        public:
+            template<typename T> requires std::is_trivially_copyable_v<T>
+            void write(const T &value) {
+                auto bytes = reinterpret_cast<const u8*>(&value);
+                this->m_data.insert(this->m_data.end(), bytes, bytes + sizeof(T));
+            }
+
+            template<typename T> requires std::is_trivially_copyable_v<T>
+            void writeVector(const std::vector<T> &values) {
+                this->write<u64>(values.size());
+
+                auto bytes = reinterpret_cast<const u8*>(values.data());
+                this->m_data.insert(this->m_data.end(), bytes, bytes + values.size() * sizeof(T));
+            }
+
+            void writeString(std::string_view string) {
+                this->write<u64>(string.size());
+                this->m_data.insert(this->m_data.end(), string.begin(), string.end());
+            }
+
+            [[nodiscard]] const std::vector<u8>& getData() const { return this->m_data; }
+
+        private:
+            std::vector<u8> m_data;
+        };
+
+        /* Reads results back in the order they were written. Every read fails once the data ran out */
+        class Reader {
+        public:
+            explicit Reader(std::vector<u8> &&data) : m_data(std::move(data)) { }
+
+            template<typename T> requires std::is_trivially_copyable_v<T>
+            bool read(T &value) {
+                if (sizeof(T) > this->m_data.size() - this->m_offset)
+                    return false;
+
+                std::memcpy(&value, this->m_data.data() + this->m_offset, sizeof(T));
+                this->m_offset += sizeof(T);
+
+                return true;
+            }
+
+            template<typename T> requires std::is_trivially_copyable_v<T>
+            bool readVector(std::vector<T> &values) {
+                u64 count;
+                if (!this->read(count) || count > (this->m_data.size() - this->m_offset) / sizeof(T))
+                    return false;
+
+                values.resize(count);
+                std::memcpy(values.data(), this->m_data.data() + this->m_offset, count * sizeof(T));
+                this->m_offset += count * sizeof(T);
+
+                return true;
+            }
+
+            bool readString(std::string &string) {
+                u64 size;
+                if (!this->read(size) || size > this->m_data.size() - this->m_offset)
+                    return false;
+
+                string.assign(reinterpret_cast<const char*>(this->m_data.data() + this->m_offset), size);
+                this->m_offset += size;
+
+                return true;
+            }
+
+        private:
+            std::vector<u8> m_data;
+            size_t m_offset = 0;
+        };
+
+        /* Stores the results of an analysis of the provider's data. Nothing is stored if the data can't be cached */
+        static void store(prv::Provider *provider, std::string_view analysis, const Writer &writer);
+
+        /* Results stored earlier for the provider's data, if they're still intact */
+        [[nodiscard]] static std::optional<Reader> load(prv::Provider *provider, std::string_view analysis);
+
+        [[nodiscard]] static bool contains(prv::Provider *provider, std::string_view analysis);
+
+        /* Entries that aren't tied to a provider's data, for anything else worth keeping between runs. Paths are relative to the cache directory */
+        static void storeFile(const std::filesystem::path &path, const Writer &writer);
+        [[nodiscard]] static std::optional<Reader> loadFile(const std::filesystem::path &path);
+
+    private:
+        struct Fingerprint {
+            u64 size;
+            s64 modificationTime;
+            u64 contentHash;
+        };
+
+        /* Directory holding the entries of the provider's data, nothing if the data can't be cached */
+        static std::optional<std::filesystem::path> getEntryDirectory(prv::Provider *provider);
+
+        static u64 hashSamples(prv::Provider *provider, u64 size);
+
+        static void writeEntry(const std::filesystem::path &path, const Writer &writer);
+        static std::optional<Reader> readEntry(const std::filesystem::path &path);
+
+        // Sampling a huge file takes a moment, fingerprints are remembered for as long as the file doesn't change
+        static inline std::mutex s_mutex;
+        static inline std::map<std::string, Fingerprint> s_fingerprints;
+    };
+
+}
\ No newline at end of file
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace hex {
+
+    /*
+        Monotonic allocator that owns every object created through it. Objects are never freed one by one,
+        memory is handed out from a few large blocks and given back all at once when the arena gets cleared
+    */
+    class Arena {
+    public:
+        Arena() = default;
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        ~Arena() {
+            this->clear();
+        }
+
+        template<typename T, typename ... Args>
+        T* create(Args&& ... args) {
+            auto object = new (this->allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+
+            if constexpr (!std::is_trivially_destructible_v<T>)
+                this->m_destructors.push_back({ object, [](void *object) { static_cast<T*>(object)->~T(); } });
+
+            return object;
+        }
+
+        void* allocate(size_t size, size_t alignment) {
+            auto address = reinterpret_cast<std::uintptr_t>(this->m_current);
+            auto aligned = (address + alignment - 1) & ~(alignment - 1);
+
+            if (this->m_current == nullptr || aligned + size > reinterpret_cast<std::uintptr_t>(this->m_end)) {
+                this->addBlock(size + alignment);
+
+                address = reinterpret_cast<std::uintptr_t>(this->m_current);
+                aligned = (address + alignment - 1) & ~(alignment - 1);
+            }
+
+            this->m_current = reinterpret_cast<std::byte*>(aligned + size);
+
+            return reinterpret_cast<void*>(aligned);
+        }
+
+        void clear() {
+            // Run destructors in reverse so objects are torn down before anything created earlier that they may refer to
+            for (auto it = this->m_destructors.rbegin(); it != this->m_destructors.rend(); it++)
+                it->destroy(it->object);
+            this->m_destructors.clear();
+
+            // Keep the biggest block around so the next user doesn't have to allocate again
+            if (!this->m_blocks.empty()) {
+                auto biggest = std::max_element(this->m_blocks.begin(), this->m_blocks.end(), [](const auto &left, const auto &right) { return left.size < right.size; });
+                auto block = std::move(*biggest);
+
+                this->m_blocks.clear();
+                this->m_blocks.push_back(std::move(block));
+
+                this->m_current = this->m_blocks.back().data.get();
+                this->m_end = this->m_current + this->m_blocks.back().size;
+            }
+        }
+
+        [[nodiscard]] size_t getReservedSize() const {
+            size_t result = 0;
+            for (const auto &block : this->m_blocks)
+                result += block.size;
+
+            return result;
+        }
+
+    private:
+        constexpr static size_t MinimumBlockSize = 0x1'0000;
+        constexpr static size_t MaximumBlockSize = 0x100'0000;
+
+        struct Block {
+            std::unique_ptr<std::byte[]> data;
+            size_t size;
+        };
+
+        struct Destructor {
+            void *object;
+            void (*destroy)(void*);
+        };
+
+        void addBlock(size_t minimumSize) {
+            size_t size = this->m_blocks.empty() ? MinimumBlockSize : std::min(this->m_blocks.back().size * 2, MaximumBlockSize);
+            size = std::max(size, minimumSize);
+
+            this->m_blocks.push_back({ std::unique_ptr<std::byte[]>(new std::byte[size]), size });
+
+            this->m_current = this->m_blocks.back().data.get();
+            this->m_end = this->m_current + size;
+        }
+
+        std::vector<Block> m_blocks;
+        std::vector<Destructor> m_destructors;
+        std::byte *m_current = nullptr, *m_end = nullptr;
+    };
+
+}
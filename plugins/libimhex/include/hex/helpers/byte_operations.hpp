@@ -0,0 +1,62 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <bit>
+#include <vector>
+
+namespace hex {
+
+    enum class ByteOperation : int { Fill, Xor, And, Or, Add, SwapEndian, Reverse };
+
+    /*
+        Changes all bytes of a selection at once. Fill, Xor, And and Or repeat the operand over the data, starting at the first byte.
+        Add adds the operand, the bytes of a native u64, to every value of the given width and endianess. SwapEndian reverses the bytes of
+        every value of the given width. Values that don't fit at the end are left alone. Reverse reverses the order of all bytes.
+        Uses AVX2 where the CPU has it
+    */
+    class ByteOperator {
+    public:
+        ByteOperator(ByteOperation operation, std::vector<u8> operand, u8 width = 1, std::endian endian = std::endian::little);
+
+        /* Fill, Xor, And and Or need an operand, Add and SwapEndian a width of 1, 2, 4 or 8 bytes */
+        [[nodiscard]] bool isValid() const;
+
+        /* Applies the operation to the data in place. Large data is split up between all task manager workers */
+        void apply(u8 *data, size_t size) const;
+
+    private:
+        constexpr static size_t VectorSize = 32;
+        constexpr static size_t MinimumPartSize = 0x10'0000;
+
+        /* Offset is where the data starts within all of the data the operation is applied to, only used for the operand pattern */
+        void applyPart(u8 *data, size_t size, u64 offset) const;
+        void reverse(u8 *front, u8 *back, size_t size) const;
+
+        template<ByteOperation Operation>
+        void applyPattern(u8 *data, size_t size, u64 offset) const;
+        template<size_t Width>
+        void applyValues(u8 *data, size_t size) const;
+
+    #if defined(__x86_64__) || defined(__i386__)
+        template<ByteOperation Operation>
+        size_t applyPatternVectorized(u8 *data, size_t size, u64 offset) const;
+        template<size_t Width>
+        size_t applyValuesVectorized(u8 *data, size_t size) const;
+        size_t reverseVectorized(u8 *front, u8 *back, size_t size) const;
+    #endif
+
+        ByteOperation m_operation;
+        std::vector<u8> m_operand;
+        u8 m_width;
+        std::endian m_endian;
+
+        /* The operand repeated over a multiple of both its own length and the vector size, plus one more vector so reads never wrap */
+        std::vector<u8> m_pattern;
+        size_t m_period = 0;
+
+        /* Add's operand as a native value */
+        u64 m_addend = 0;
+    };
+
+}
@@ -3,7 +3,10 @@
 #include <hex.hpp>
 
 #include <array>
+#include <atomic>
+#include <memory>
 #include <optional>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -14,6 +17,26 @@ namespace hex::crypt {
     void initialize();
     void exit();
 
+    /* Reflected CRC that can be fed data in multiple steps. Uses carry-less multiplication where the CPU supports it */
+    template<typename T>
+    class Crc {
+    public:
+        Crc(T polynomial, T init);
+
+        void process(const u8 *data, size_t size);
+        [[nodiscard]] T getValue() const { return this->m_value; }
+
+    private:
+        void processSliced(const u8 *data, size_t size);
+
+        T m_value;
+        std::array<std::array<T, 256>, 8> m_table;
+        std::array<u64, 4> m_foldConstants;
+    };
+
+    extern template class Crc<u16>;
+    extern template class Crc<u32>;
+
     u16 crc16(prv::Provider* &data, u64 offset, size_t size, u16 polynomial, u16 init);
     u32 crc32(prv::Provider* &data, u64 offset, size_t size, u32 polynomial, u32 init);
 
@@ -24,6 +47,109 @@ namespace hex::crypt {
     std::array<u8, 48> sha384(prv::Provider* &data, u64 offset, size_t size);
     std::array<u8, 64> sha512(prv::Provider* &data, u64 offset, size_t size);
 
+    enum class HashFunction : u8 {
+        CRC16,
+        CRC32,
+        MD5,
+        SHA1,
+        SHA224,
+        SHA256,
+        SHA384,
+        SHA512,
+        SHA256Tree
+    };
+
+    class HashTree;
+
+    struct HashRequest {
+        HashFunction function;
+        u32 polynomial = 0;
+        u32 init = 0;
+
+        // If set, the tree gets filled in while hashing and the result is taken from it
+        std::shared_ptr<HashTree> tree;
+    };
+
+    /*
+        Digests of fixed size leaves of a region, combined pairwise up to a root. After an edit only the affected leaves
+        and their path to the root have to be hashed again. Works for CRCs, which can be combined using the length of
+        the data, and for SHA-256 Tree, which hashes the children's digests
+    */
+    class HashTree {
+    public:
+        constexpr static size_t LeafSize = 0x10'0000;
+
+        HashTree(HashFunction function, u32 polynomial, u32 init, size_t size);
+
+        [[nodiscard]] static bool isSupported(HashFunction function);
+
+        void process(const u8 *data, size_t size);
+        void finish();
+
+        void rehash(prv::Provider* &data, u64 regionOffset, u64 offset, size_t size);
+
+        [[nodiscard]] std::vector<u8> getResult() const;
+        [[nodiscard]] size_t getLeafCount() const { return this->m_leafCount; }
+
+    private:
+        struct Node {
+            std::vector<u8> digest;
+            u64 size = 0;
+        };
+
+        [[nodiscard]] Node hashLeaf(const u8 *data, size_t size) const;
+        [[nodiscard]] Node combine(const Node &left, const Node &right) const;
+        void setLeaf(size_t leaf, Node &&node, bool updatePath);
+
+        HashFunction m_function;
+        u32 m_polynomial, m_init;
+        size_t m_size;
+
+        size_t m_leafCount, m_firstLeaf = 1;
+        std::vector<Node> m_nodes;
+
+        std::vector<u8> m_pendingLeaf;
+        size_t m_processedLeaves = 0;
+    };
+
+    class Hasher;
+
+    /* Hash calculation that can be fed in steps, from memory or out of a provider in blocks of a chosen size */
+    class Digest {
+    public:
+        constexpr static size_t DefaultBlockSize = 0x10'0000;
+
+        // The size of all data is only needed for tree hashes
+        explicit Digest(const HashRequest &request, size_t size = 0);
+        ~Digest();
+
+        void update(std::span<const u8> data);
+        void update(prv::Provider* &data, u64 offset, size_t size, size_t blockSize = DefaultBlockSize);
+        [[nodiscard]] std::vector<u8> finish();
+
+    private:
+        std::unique_ptr<Hasher> m_hasher;
+    };
+
+    /*
+        Reads the region once in large blocks and feeds it to all requested hash functions, each of them on its own thread.
+        Results are returned in request order with CRCs stored big endian. Returns nothing if the run got cancelled.
+        Offsets are absolute so the region isn't limited to the current page
+    */
+    std::vector<std::vector<u8>> hashRegion(prv::Provider* &data, u64 offset, size_t size, const std::vector<HashRequest> &requests, const std::atomic<bool> &cancelled, std::atomic<u64> *processedBytes = nullptr);
+
+    /*
+        Base64 and hex codecs writing into a buffer provided by the caller, whole blocks get converted 16 characters at a time with SSSE3 where the CPU supports it.
+        Base64 decoding skips whitespace and takes the padding as optional, anything outside of the alphabet makes decoding fail
+    */
+    [[nodiscard]] constexpr size_t getEncoded64Size(size_t size) { return 4 * ((size + 2) / 3); }
+    [[nodiscard]] constexpr size_t getMaxDecoded64Size(size_t size) { return 3 * (size / 4) + size % 4; }
+
+    size_t encode64(std::span<const u8> input, u8 *output);
+    std::optional<size_t> decode64(std::span<const u8> input, u8 *output);
+    size_t encodeHex(std::span<const u8> input, u8 *output);
+    std::optional<size_t> decodeHex(std::span<const u8> input, u8 *output);
+
     std::vector<u8> decode64(const std::vector<u8> &input);
     std::vector<u8> encode64(const std::vector<u8> &input);
 
@@ -44,5 +170,41 @@ namespace hex::crypt {
         Key256Bits = 2
     };
 
+    class AESContext;
+
+    /*
+        AES decryption that can be fed data in pieces of any size, so large data can be streamed through a small buffer. The key
+        schedule is only set up once and reused for all pieces. Blocks in ECB, CBC, CTR and XTS mode don't depend on each other's
+        decrypted data, large pieces in those get split across threads. XTS takes a key twice the key length and decrypts data units
+        of XTSDataUnitSize bytes, the nonce followed by the IV is the tweak of the first one. CCM isn't supported
+    */
+    class AESDecryptor {
+    public:
+        constexpr static size_t XTSDataUnitSize = 0x200;
+
+        AESDecryptor(AESMode mode, KeyLength keyLength, std::span<const u8> key, std::array<u8, 8> nonce, std::array<u8, 8> iv);
+        ~AESDecryptor();
+
+        [[nodiscard]] bool isValid() const;
+
+        /* Starts over with a new nonce and IV, keeping the key schedule */
+        void reset(std::array<u8, 8> nonce, std::array<u8, 8> iv);
+
+        /* Number of bytes the next update will write. Incomplete blocks and data units are held back until the rest of them arrives */
+        [[nodiscard]] size_t getOutputSize(size_t inputSize) const;
+
+        /* The output must not overlap the input. Returns the number of bytes written */
+        size_t update(std::span<const u8> input, u8 *output);
+
+        /* Decrypts what's still held back where the mode allows it, incomplete ECB and CBC blocks get dropped */
+        size_t finish(u8 *output);
+
+    private:
+        std::unique_ptr<AESContext> m_context;
+    };
+
+    /* Whether mbedtls uses the CPU's AES instructions */
+    [[nodiscard]] bool hasAESAcceleration();
+
     std::vector<u8> aesDecrypt(AESMode mode, KeyLength keyLength, const std::vector<u8> &key, std::array<u8, 8> nonce, std::array<u8, 8> iv, const std::vector<u8> &input);
 }
\ No newline at end of file
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <hex.hpp>
+#include <hex/helpers/utils.hpp>
+
+#include <atomic>
+#include <functional>
+#include <optional>
+#include <vector>
+
+namespace hex::prv { class Provider; }
+
+namespace hex {
+
+    /*
+        Compares two providers in a single streaming pass. Identical stretches are skipped with a vectorized compare,
+        after a mismatch both sides get realigned by looking for the closest pair of positions at which a window of
+        bytes matches again, found through rolling hashes. That way insertions and removals only show up as a single
+        difference instead of making everything after them differ
+    */
+    class BinaryDiffer {
+    public:
+        enum class DifferenceType : u8 {
+            Changed,
+            Inserted,
+            Removed
+        };
+
+        /* Inserted differences have an empty left region, removed ones an empty right region */
+        struct Difference {
+            Region left, right;
+            DifferenceType type;
+        };
+
+        /* Called for every difference in ascending order. Return false to stop comparing */
+        using Callback = std::function<bool(const Difference &difference)>;
+
+        /* Called regularly with how far the comparison got on the left side */
+        using ProgressCallback = std::function<void(u64 leftOffset)>;
+
+        constexpr static size_t ChunkSize   = 0x10'0000;
+
+        /* Number of bytes that need to match for both sides to count as aligned again */
+        constexpr static size_t WindowSize  = 32;
+
+        /* How far ahead realigning is attempted. Data that can't be realigned within it is treated as changed */
+        constexpr static size_t MaxShift    = 0x10'0000;
+
+        /* Offset of the first byte that differs between both buffers, size if they're the same */
+        static size_t findMismatch(const u8 *left, const u8 *right, size_t size);
+
+        /* Compares the data with patches applied. Returns false if it was cancelled or the callback stopped it */
+        bool diff(prv::Provider *left, prv::Provider *right, const Callback &callback, const ProgressCallback &progress, const std::atomic<bool> &cancelled);
+
+    private:
+        /* Buffers a sliding part of a provider's data */
+        class Reader {
+        public:
+            explicit Reader(prv::Provider *provider);
+
+            /* Makes size bytes starting at address available and returns them. size gets clamped to the end of the data */
+            const u8* fetch(u64 address, size_t &size);
+
+            [[nodiscard]] u64 getSize() const { return this->m_size; }
+
+            /* Number of bytes starting at address that are available without reading */
+            [[nodiscard]] size_t getBuffered(u64 address) const {
+                if (address < this->m_bufferAddress || address >= this->m_bufferAddress + this->m_buffer.size())
+                    return 0;
+
+                return this->m_bufferAddress + this->m_buffer.size() - address;
+            }
+
+        private:
+            prv::Provider *m_provider;
+            u64 m_size;
+
+            u64 m_bufferAddress = 0;
+            std::vector<u8> m_buffer;
+        };
+
+        /* Open addressing table from window hashes to the first offset they were seen at */
+        class WindowIndex {
+        public:
+            void reset(size_t count);
+            void insert(u64 hash, u32 offset);
+            [[nodiscard]] std::optional<u32> find(u64 hash) const;
+
+        private:
+            // Only part of the hash is kept, matches get verified anyway
+            struct Entry {
+                u32 tag;
+                u32 offset;
+            };
+
+            std::vector<Entry> m_entries;
+            u8 m_shift = 0;
+        };
+
+        /*
+            Number of bytes to skip on either side so they match again, found by trying larger and larger distances.
+            Nothing is returned if they don't match again within MaxShift
+        */
+        std::optional<std::pair<size_t, size_t>> realign(Reader &left, u64 leftAddress, Reader &right, u64 rightAddress);
+
+        WindowIndex m_windowIndex;
+    };
+
+}
\ No newline at end of file
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <array>
+#include <atomic>
+#include <vector>
+
+namespace hex::prv { class Provider; }
+
+namespace hex {
+
+    /* Regions of the same size and content. Addresses are absolute and sorted */
+    struct DuplicateGroup {
+        u64 size;
+        std::vector<u64> addresses;
+    };
+
+    /*
+        Finds data that shows up more than once without comparing regions pairwise. The data gets split into chunks wherever a Gear
+        rolling hash of the last 64 bytes hits a pattern, so identical data gets split up the same way no matter where it is. Chunks are
+        identified by their SHA-256 and runs of chunks that always appear in the same order get merged into one larger region.
+        Groups are sorted by the number of bytes their copies take up. Returns nothing if the run got cancelled
+    */
+    class DuplicateFinder {
+    public:
+        DuplicateFinder() = delete;
+
+        static std::vector<DuplicateGroup> find(prv::Provider *provider, u64 offset, size_t size, const std::atomic<bool> &cancelled, std::atomic<u64> *processedBytes = nullptr);
+
+        /* Anything smaller than this only shows up at the end of the data or of a run of chunks and isn't reported */
+        constexpr static size_t MinimumChunkSize = 0x400;
+        constexpr static size_t MaximumChunkSize = 0x1'0000;
+
+    private:
+        struct Chunk {
+            u64 address;
+            u32 size;
+            std::array<u8, 32> digest;
+        };
+
+        constexpr static size_t WindowSize = 64;
+        constexpr static size_t WorkSize = 16 * 1024 * 1024;
+
+        // Twelve bits have to be clear for a cut, chunks end up about 4 KiB past the minimum size on average
+        constexpr static u64 CutMask = 0xFFFull << 52;
+
+        static const std::array<u64, 256>& getGearTable();
+        static std::vector<Chunk> chunkRegion(prv::Provider *provider, u64 offset, u64 end, u64 workOffset);
+        static std::vector<DuplicateGroup> groupChunks(const std::vector<Chunk> &chunks);
+    };
+
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <array>
+#include <atomic>
+#include <vector>
+
+namespace hex::prv { class Provider; }
+
+namespace hex {
+
+    using ByteCounts = std::array<u64, 256>;
+
+    /* Byte pair counts, indexed by (first << 8) | second */
+    using DigraphCounts = std::vector<u64>;
+    constexpr size_t DigraphCount = 256 * 256;
+
+    /* Adds the number of occurrences of every byte value in data to counts */
+    void countBytes(const u8 *data, size_t size, ByteCounts &counts);
+
+    /* Adds every pair of adjacent bytes in data to counts, counts needs to hold DigraphCount entries */
+    void countDigraphs(const u8 *data, size_t size, DigraphCounts &counts);
+
+    /* Shannon entropy of the counted bytes, scaled to the range 0 to 1 */
+    [[nodiscard]] float calculateEntropy(const ByteCounts &counts, u64 byteCount);
+
+    struct EntropyAnalysis {
+        ByteCounts valueCounts = { 0 };
+        std::vector<float> blockEntropy;
+
+        float averageEntropy = 0;
+        float highestBlockEntropy = 0;
+        u64 highestEntropyBlock = 0;
+    };
+
+    /*
+        Calculates the byte distribution, the entropy of every block and the block with the highest entropy in a single pass.
+        Runs of blocks are spread over all cores, each worker keeps its own counts which get merged at the end
+    */
+    EntropyAnalysis analyzeEntropy(prv::Provider *provider, u64 offset, size_t size, size_t blockSize, const std::atomic<bool> &cancelled, u32 threadCount = 0);
+
+    /*
+        Byte distribution of every block of the region. Unlike with analyzeEntropy, blocks can be as large as needed since they get counted
+        in chunks spread over all cores and never have to be in memory at once. Meant for blocks of at least a few KiB
+    */
+    std::vector<ByteCounts> countBlocks(prv::Provider *provider, u64 offset, size_t size, size_t blockSize, const std::atomic<bool> &cancelled, u32 threadCount = 0);
+
+    enum class ByteClass : u8 {
+        Zero,
+        Printable,
+        Control,
+        High
+    };
+
+    /*
+        Multi-resolution map of the entropy of a region.
+        Level 0 holds the exact entropy of every 4 KiB block, every further level combines Fanout nodes of the level below.
+        Plots can pick whichever level fits the visible range and edits only recompute the blocks they touched
+    */
+    class EntropyMap {
+    public:
+        constexpr static size_t BlockSize = 0x1000;
+        constexpr static size_t Fanout = 4;
+
+        struct Node {
+            float averageEntropy = 0;
+            float minEntropy = 0;
+            float maxEntropy = 0;
+            u64 size = 0;
+            std::array<u64, 4> classCounts = { 0 };
+
+            [[nodiscard]] float getClassRatio(ByteClass byteClass) const {
+                return this->size == 0 ? 0.0F : float(this->classCounts[u8(byteClass)]) / float(this->size);
+            }
+        };
+
+        EntropyMap() = default;
+
+        struct Statistics {
+            ByteCounts valueCounts = { 0 };
+            DigraphCounts digraphCounts;
+        };
+
+        /* Scans the whole region and returns the byte and byte pair distributions found in it. Offsets are absolute, not page relative */
+        Statistics build(prv::Provider *provider, u64 offset, size_t size, const std::atomic<bool> &cancelled, u32 threadCount = 0);
+
+        /* Recomputes the blocks overlapping the changed range and everything above them */
+        void update(prv::Provider *provider, u64 changedOffset, size_t changedSize);
+
+        /* Extends the region to a larger size for data that got appended to it, only the blocks from the old end on get computed */
+        void grow(prv::Provider *provider, size_t size);
+
+        /* Rebuilds the map from the leaves of an earlier build, the levels above them get recomputed. Fails if they don't cover the region */
+        bool restore(u64 offset, size_t size, std::vector<Node> &&leaves);
+
+        void clear();
+
+        [[nodiscard]] bool empty() const { return this->m_levels.empty(); }
+        [[nodiscard]] u64 getOffset() const { return this->m_offset; }
+        [[nodiscard]] size_t getSize() const { return this->m_size; }
+
+        [[nodiscard]] size_t getLevelCount() const { return this->m_levels.size(); }
+        [[nodiscard]] const std::vector<Node>& getLevel(size_t level) const { return this->m_levels[level]; }
+        [[nodiscard]] static u64 getBlockSize(size_t level);
+
+        /* Finest level that shows the given range with no more than maxNodes nodes */
+        [[nodiscard]] size_t selectLevel(u64 rangeSize, size_t maxNodes) const;
+
+        [[nodiscard]] const Node& getRoot() const { return this->m_levels.back().front(); }
+        [[nodiscard]] u64 getHighestEntropyBlock() const;
+
+        /* Node of a single block with the given byte distribution */
+        [[nodiscard]] static Node createLeaf(const ByteCounts &counts, size_t size);
+
+        [[nodiscard]] size_t getMemoryUsage() const {
+            size_t usage = 0;
+            for (const auto &level : this->m_levels)
+                usage += level.capacity() * sizeof(Node);
+
+            return usage;
+        }
+
+    private:
+        void allocateLevels();
+        void updateParents(size_t firstNode, size_t lastNode);
+
+        static Node combine(const Node *children, size_t count);
+
+        u64 m_offset = 0;
+        size_t m_size = 0;
+        std::vector<std::vector<Node>> m_levels;
+    };
+
+}
\ No newline at end of file
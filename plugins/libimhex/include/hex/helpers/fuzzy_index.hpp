@@ -0,0 +1,55 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace hex {
+
+    /*
+        Case insensitive fuzzy lookup of names, built once and queried many times. A query matches every name that
+        contains its characters in order. Names starting with the query rank above everything else, the others are ranked
+        by how closely together and how close to word starts the characters were found
+    */
+    class FuzzyIndex {
+    public:
+        struct Match {
+            u32 id;
+            s32 score;
+        };
+
+        void clear();
+
+        /* The id is handed back in matches, it usually is an index into the caller's own list of things that got indexed */
+        void add(std::string_view name, u32 id);
+
+        /* Has to be called after adding names and before querying the index */
+        void build();
+
+        /* Best matches first. An empty query matches every name, in the order they were added in */
+        [[nodiscard]] std::vector<Match> find(std::string_view query, size_t maxResults) const;
+
+        [[nodiscard]] size_t size() const { return this->m_entries.size(); }
+
+    private:
+        struct Entry {
+            u32 nameOffset;
+            u32 nameSize;
+            u64 characters;     // One bit per character value, lets most names get skipped without looking at them
+            u32 id;
+        };
+
+        [[nodiscard]] std::string_view getName(const Entry &entry) const {
+            return std::string_view(this->m_names).substr(entry.nameOffset, entry.nameSize);
+        }
+
+        [[nodiscard]] static s32 scoreSubsequence(std::string_view name, std::string_view query);
+
+        std::string m_names;                // All names lowercased, back to back
+        std::vector<Entry> m_entries;
+        std::vector<u32> m_sortedEntries;   // Entries ordered by name, names with the same prefix are next to each other
+    };
+
+}
\ No newline at end of file
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <algorithm>
+#include <optional>
+#include <vector>
+
+namespace hex {
+
+    /*
+        Static interval tree over half open address ranges. The intervals are kept sorted by their start and the sorted
+        array doubles as an implicit balanced search tree, every node additionally knowing the largest end in its subtree.
+        That lets queries skip whole subtrees that end before the queried range, so they take O(log n + matches).
+        Has to be rebuilt after the intervals changed
+    */
+    template<typename T>
+    class IntervalTree {
+    public:
+        struct Interval {
+            u64 start, end;
+            T value;
+        };
+
+        void clear() {
+            this->m_intervals.clear();
+            this->m_maxEnds.clear();
+        }
+
+        void build(std::vector<Interval> intervals) {
+            this->m_intervals = std::move(intervals);
+            std::stable_sort(this->m_intervals.begin(), this->m_intervals.end(), [](const auto &left, const auto &right) {
+                return left.start < right.start;
+            });
+
+            this->m_maxEnds.resize(this->m_intervals.size());
+            this->buildMaxEnds(0, this->m_intervals.size());
+        }
+
+        [[nodiscard]] bool empty() const { return this->m_intervals.empty(); }
+        [[nodiscard]] size_t size() const { return this->m_intervals.size(); }
+
+        /* Calls callback for every interval overlapping [start, end), ordered by their start */
+        template<typename Callback>
+        void forEachOverlapping(u64 start, u64 end, Callback &&callback) const {
+            if (start < end)
+                this->query(0, this->m_intervals.size(), start, end, callback);
+        }
+
+        template<typename Callback>
+        void forEachContaining(u64 address, Callback &&callback) const {
+            this->forEachOverlapping(address, address + 1, callback);
+        }
+
+        /* The first interval starting after address */
+        [[nodiscard]] const Interval* findNext(u64 address) const {
+            auto it = std::upper_bound(this->m_intervals.begin(), this->m_intervals.end(), address, [](u64 value, const auto &interval) {
+                return value < interval.start;
+            });
+
+            return it == this->m_intervals.end() ? nullptr : &*it;
+        }
+
+        /* The last interval starting before address */
+        [[nodiscard]] const Interval* findPrevious(u64 address) const {
+            auto it = std::lower_bound(this->m_intervals.begin(), this->m_intervals.end(), address, [](const auto &interval, u64 value) {
+                return interval.start < value;
+            });
+
+            return it == this->m_intervals.begin() ? nullptr : &*(it - 1);
+        }
+
+    private:
+        u64 buildMaxEnds(size_t begin, size_t end) {
+            if (begin >= end)
+                return 0;
+
+            auto middle = begin + (end - begin) / 2;
+            auto maxEnd = std::max({ this->m_intervals[middle].end, this->buildMaxEnds(begin, middle), this->buildMaxEnds(middle + 1, end) });
+
+            this->m_maxEnds[middle] = maxEnd;
+            return maxEnd;
+        }
+
+        template<typename Callback>
+        void query(size_t begin, size_t end, u64 start, u64 queryEnd, Callback &callback) const {
+            if (begin >= end)
+                return;
+
+            auto middle = begin + (end - begin) / 2;
+            if (this->m_maxEnds[middle] <= start)
+                return;
+
+            this->query(begin, middle, start, queryEnd, callback);
+
+            // Everything from here on starts too late to overlap
+            const auto &interval = this->m_intervals[middle];
+            if (interval.start >= queryEnd)
+                return;
+
+            if (interval.end > start)
+                callback(interval.value);
+
+            this->query(middle + 1, end, start, queryEnd, callback);
+        }
+
+        std::vector<Interval> m_intervals;
+        std::vector<u64> m_maxEnds;
+    };
+
+}
\ No newline at end of file
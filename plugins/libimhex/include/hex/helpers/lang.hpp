@@ -1,27 +1,40 @@
 #pragma once
 
+#include <cstdint>
 #include <initializer_list>
 #include <map>
 #include <string>
 #include <string_view>
+#include <vector>
 
 namespace hex {
 
     class LanguageDefinition {
     public:
+        /* Unlocalized strings get hashed once when they're registered, lookups afterwards only compare hashes */
+        struct Entry {
+            std::uint64_t hash;
+            std::string unlocalizedString;
+            std::string localizedString;
+        };
+
         LanguageDefinition(std::initializer_list<std::pair<std::string, std::string>> entries);
 
-        const std::map<std::string, std::string>& getEntries() const;
+        const std::vector<Entry>& getEntries() const;
 
     private:
-        std::map<std::string, std::string> m_entries;
+        std::vector<Entry> m_entries;
     };
 
+    /*
+        Looks up the localized version of a string in the loaded language through the string's hash.
+        Entries only reference the unlocalized string without copying it, so they're meant to be used as temporaries
+    */
     class LangEntry {
     public:
-        explicit LangEntry(const char *unlocalizedString);
-        explicit LangEntry(const std::string &unlocalizedString);
-        explicit LangEntry(std::string_view unlocalizedString);
+        constexpr explicit LangEntry(const char *unlocalizedString) : LangEntry(std::string_view(unlocalizedString)) { }
+        explicit LangEntry(const std::string &unlocalizedString) : LangEntry(std::string_view(unlocalizedString)) { }
+        constexpr explicit LangEntry(std::string_view unlocalizedString) : m_unlocalizedString(unlocalizedString), m_hash(hash(unlocalizedString)) { }
 
         operator std::string() const;
         operator std::string_view() const;
@@ -32,8 +45,19 @@ namespace hex {
         static void loadLanguage(std::string_view language);
         static const std::map<std::string, std::string>& getSupportedLanguages();
 
+        /* FNV-1a, evaluated at compile time for _lang literals */
+        // Only fixed size types from the standard library here, hex.hpp includes this header before it defines its own
+        [[nodiscard]] constexpr static std::uint64_t hash(std::string_view string) {
+            std::uint64_t result = 0xCBF2'9CE4'8422'2325;
+            for (char c : string)
+                result = (result ^ std::uint8_t(c)) * 0x100'0000'01B3;
+
+            return result;
+        }
+
     private:
-        std::string m_unlocalizedString;
+        std::string_view m_unlocalizedString;
+        std::uint64_t m_hash;
     };
 
     std::string operator+(const std::string &&left, const LangEntry &&right);
@@ -46,8 +70,8 @@ namespace hex {
 
     namespace lang_literals {
 
-        inline LangEntry operator""_lang(const char *string, size_t) {
-            return LangEntry(string);
+        consteval LangEntry operator""_lang(const char *string, size_t size) {
+            return LangEntry(std::string_view(string, size));
         }
 
     }
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace hex {
+
+    /*
+        One limit for the memory all caches take up together. Caches register under the name of their subsystem and report how much
+        memory they use. Once the total exceeds the limit, the caches that were used least recently get asked to free memory first,
+        no matter which subsystem they belong to. Eviction only ever happens on the main thread, once per frame
+    */
+    class MemoryBudget {
+    public:
+        MemoryBudget() = delete;
+
+        constexpr static size_t DefaultLimit = 0x8000'0000;
+
+        /* Frees at least the given number of bytes if possible, oldest entries first, and returns how much was freed */
+        using EvictionCallback = std::function<size_t(size_t bytes)>;
+
+        /*
+            A registered cache, it unregisters once it gets destroyed. Usage can be reported from any thread without locking.
+            The eviction callback runs on the main thread and must not report usage itself, the freed bytes get subtracted for it
+        */
+        class Cache {
+        public:
+            Cache(std::string subsystem, EvictionCallback evict);
+            ~Cache();
+
+            Cache(const Cache&) = delete;
+            Cache& operator=(const Cache&) = delete;
+
+            /* Sets how much memory the cache uses right now and counts as using it */
+            void update(size_t usage);
+            /* Counts as using the cache without its size changing */
+            void touch();
+
+            struct Entry;
+        private:
+            std::shared_ptr<Entry> m_entry;
+        };
+
+        struct SubsystemUsage {
+            std::string subsystem;
+            u32 caches;
+            size_t usage;
+            u64 evicted;
+        };
+
+        static void setLimit(size_t limit);
+        [[nodiscard]] static size_t getLimit();
+        [[nodiscard]] static size_t getTotalUsage();
+
+        /* Current usage of every subsystem that has registered a cache so far, sorted by name */
+        [[nodiscard]] static std::vector<SubsystemUsage> getUsage();
+
+        /* Evicts from the least recently used caches until everything fits into the limit again. Called once per frame by the main loop */
+        static void enforce();
+    };
+
+}
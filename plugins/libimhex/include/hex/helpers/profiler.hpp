@@ -0,0 +1,105 @@
+#pragma once
+
+#include <hex.hpp>
+#include <hex/helpers/utils.hpp>
+
+#include <array>
+#include <chrono>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace hex {
+
+    /*
+        Per frame measurements of named sections of the main thread, meant to find out what makes a frame slow.
+        Every view's drawing is a section of its own, plugins can measure their own code with PROFILE_SCOPE("name").
+        Nothing gets recorded while the profiler is disabled
+    */
+    class Profiler {
+    public:
+        Profiler() = delete;
+
+        constexpr static size_t HistorySize = 256;
+
+        struct Counters {
+            double time = 0;    // Milliseconds
+            double allocations = 0;
+            double readCalls = 0;
+            double readBytes = 0;
+        };
+
+        struct Section {
+            Counters current;
+            std::array<Counters, HistorySize> history = { };
+        };
+
+        /* Section timings get recorded in the destructor, sections with the same name add up. The name has to outlive the timer */
+        class ScopedTimer {
+        public:
+            explicit ScopedTimer(std::string_view name);
+            ~ScopedTimer();
+
+            ScopedTimer(const ScopedTimer&) = delete;
+            ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+        private:
+            std::string_view m_name;
+            bool m_active;
+
+            std::chrono::steady_clock::time_point m_start;
+            u64 m_allocations = 0, m_readCalls = 0, m_readBytes = 0;
+        };
+
+        /* How long one step of getting ImHex started took. Phases recorded after startup finished are deferred initialization */
+        struct StartupPhase {
+            std::string name;
+            double time;    // Milliseconds
+            bool deferred;
+        };
+
+        /* Records a startup phase in its destructor, unlike sections these are measured whether the profiler is enabled or not */
+        class StartupTimer {
+        public:
+            explicit StartupTimer(std::string_view name);
+            ~StartupTimer();
+
+            StartupTimer(const StartupTimer&) = delete;
+            StartupTimer& operator=(const StartupTimer&) = delete;
+
+        private:
+            std::string_view m_name;
+            std::chrono::steady_clock::time_point m_start;
+        };
+
+        static void setEnabled(bool enabled);
+        [[nodiscard]] static bool isEnabled();
+
+        /* Moves this frame's measurements into the history of every section, called once per frame by the main loop */
+        static void nextFrame();
+
+        [[nodiscard]] static const std::map<std::string, Section, std::less<>>& getSections();
+
+        /* Index of the oldest entry in the section histories */
+        [[nodiscard]] static size_t getHistoryOffset();
+
+        /* Called by providers for every read, only reads done by the thread that's measuring are counted */
+        static void countRead(size_t size);
+
+        /* Allocations are counted by the executable replacing operator new, it hands a function returning this thread's count over here */
+        static void setAllocationCounter(u64(*counter)());
+
+        /* Called once the first frame is about to be drawn, phases recorded after this count as deferred */
+        static void finishStartup();
+
+        [[nodiscard]] static const std::vector<StartupPhase>& getStartupPhases();
+
+        /* Time from the process starting up until finishStartup got called */
+        [[nodiscard]] static double getStartupTime();
+    };
+
+    #define PROFILE_SCOPE(name) ::hex::Profiler::ScopedTimer TOKEN_CONCAT(profilerScope, __COUNTER__)(name)
+    #define PROFILE_STARTUP(name) ::hex::Profiler::StartupTimer TOKEN_CONCAT(startupPhase, __COUNTER__)(name)
+
+}
\ No newline at end of file
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string_view>
+
+namespace hex::prv { class Provider; }
+
+namespace hex {
+
+    /*
+        Searches binary data for a regular expression in time linear to the size of the data. Patterns match bytes, not
+        characters, and get compiled into automatons which are turned into DFAs lazily while searching.
+        Supported are literals, escapes like \x00, '.' which matches every byte, character classes, \d \w \s and their
+        negations, groups, alternations and all the usual quantifiers. Anchors, backreferences and lookarounds are not.
+        Matches are leftmost-first like in Perl and never overlap, patterns that can match nothing at all are rejected
+    */
+    class RegexSearcher {
+    public:
+        /* Called for every match with its address and size. Return false to stop searching */
+        using Callback = std::function<bool(u64 address, size_t size)>;
+
+        constexpr static size_t ChunkSize = 0x10'0000;
+
+        /* Throws std::invalid_argument describing the problem if the pattern can't be used */
+        explicit RegexSearcher(std::string_view pattern, bool caseInsensitive = false);
+        ~RegexSearcher();
+
+        RegexSearcher(const RegexSearcher&) = delete;
+        RegexSearcher& operator=(const RegexSearcher&) = delete;
+
+        /* DFA states get built while searching, so neither of these may be called from multiple threads at once */
+        bool searchBuffer(const u8 *data, size_t size, u64 baseAddress, const Callback &callback);
+
+        /* Searches the provider with patches applied, matches are reported in ascending order. progress gets the number of bytes searched so far */
+        bool search(prv::Provider* &provider, u64 offset, size_t size, const Callback &callback, const std::atomic<bool> &cancelled, const std::function<void(u64)> &progress = { });
+
+    private:
+        class Dfa;
+        class Reader;
+
+        std::optional<u64> findMatchEnd(Reader &reader, u64 position, u64 end);
+        u64 findMatchStart(Reader &reader, u64 matchEnd, u64 position);
+        bool search(Reader &forwardReader, Reader &backwardReader, u64 offset, u64 end, const Callback &callback);
+
+        // The forward DFA finds where the leftmost-first match ends, the reverse one runs backwards from there to find its start
+        std::unique_ptr<Dfa> m_forward, m_reverse;
+    };
+
+}
\ No newline at end of file
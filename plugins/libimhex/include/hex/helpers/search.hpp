@@ -0,0 +1,90 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace hex::prv { class Provider; }
+
+namespace hex {
+
+    /*
+        Searches for any number of byte sequences in a single pass over the data.
+        Every occurrence is reported, including overlapping ones. Needles may have a mask in which
+        only set bits have to match, which allows byte and nibble wildcards.
+        Large sets of needles, like file signatures, are matched with an Aho-Corasick automaton instead of being filtered one by one
+    */
+    class SequenceSearcher {
+    public:
+        /* Called for every occurrence with its address and the index of the matching needle. Return false to stop searching */
+        using Callback = std::function<bool(u64 address, size_t needle)>;
+
+        /* Called once per finished chunk with all of its occurrences sorted by address, from whichever worker thread searched it */
+        using ChunkCallback = std::function<void(u64 chunkOffset, size_t chunkSize, std::vector<std::pair<u64, size_t>> &&occurrences)>;
+
+        constexpr static size_t ChunkSize = 0x10'0000;
+
+        explicit SequenceSearcher(std::vector<std::vector<u8>> needles);
+        SequenceSearcher(std::vector<std::vector<u8>> needles, std::vector<std::vector<u8>> masks);
+
+        /* Parses a hex string like "48 8B ?? ?4 89" into bytes and a mask. Returns false on invalid characters */
+        static bool parseHexPattern(std::string_view string, std::vector<u8> &bytes, std::vector<u8> &mask);
+
+        [[nodiscard]] const std::vector<std::vector<u8>>& getNeedles() const { return this->m_needles; }
+        [[nodiscard]] size_t getLongestNeedleSize() const { return this->m_longestNeedleSize; }
+
+        /* Checks whether the needle occurs right at data, which has to hold at least as many bytes as the needle */
+        [[nodiscard]] bool matches(const u8 *data, size_t needle) const;
+
+        /*
+            Searches data for occurrences fully contained in the buffer that start before startLimit.
+            Occurrences are reported in ascending order for a single needle, in no particular order otherwise
+        */
+        bool searchBuffer(const u8 *data, size_t size, size_t startLimit, u64 baseAddress, const Callback &callback) const;
+
+        /* Searches the provider in chunks, with patches applied. Addresses are absolute and not limited to the current page */
+        bool search(prv::Provider* &provider, u64 offset, size_t size, const Callback &callback) const;
+
+        /* Same as search but splits the work across multiple threads. Blocks until done or cancelled */
+        void searchParallel(prv::Provider* &provider, u64 offset, size_t size, const ChunkCallback &callback, const std::atomic<bool> &cancelled, u32 threadCount = 0) const;
+
+    private:
+        /* The longest run of bytes in a needle without any wildcards. It's searched for first, the rest gets verified afterwards */
+        struct Anchor {
+            size_t offset = 0;
+            size_t size = 0;
+        };
+
+        bool searchSingle(const u8 *data, size_t size, size_t startLimit, u64 baseAddress, const Callback &callback) const;
+        bool searchMultiple(const u8 *data, size_t size, size_t startLimit, u64 baseAddress, const Callback &callback) const;
+        bool searchAutomaton(const u8 *data, size_t size, size_t startLimit, u64 baseAddress, const Callback &callback) const;
+
+        void buildAutomaton();
+
+        std::vector<std::vector<u8>> m_needles;
+        std::vector<std::vector<u8>> m_masks;
+        std::vector<Anchor> m_anchors;
+        size_t m_longestNeedleSize = 0;
+        size_t m_longestAnchorOffset = 0;
+
+        // Filters for searching multiple needles. Candidate positions are found by looking at the first two anchor bytes
+        std::array<std::vector<size_t>, 256> m_needlesByFirstByte;
+        std::vector<size_t> m_unanchoredNeedles;
+        std::vector<bool> m_firstBytes, m_firstPairs;
+
+        // The automaton matches all anchors at once. Every state has a full row of transitions, so scanning is one table lookup per byte.
+        // Needles ending in a state are m_outputs[m_outputOffsets[state]] up to m_outputs[m_outputOffsets[state + 1]]
+        constexpr static size_t AutomatonMinNeedles = 8;
+        constexpr static size_t AutomatonMaxStates = 0x1000;
+        constexpr static u32 AutomatonOutputFlag = 0x8000'0000;
+
+        std::vector<u32> m_transitions;
+        std::vector<u32> m_outputOffsets, m_outputs;
+    };
+
+}
\ No newline at end of file
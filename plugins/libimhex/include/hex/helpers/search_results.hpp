@@ -0,0 +1,67 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <functional>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace hex::prv { class Provider; }
+
+namespace hex {
+
+    /*
+        Sorted addresses of search results. Results of fixed size searches also keep the bytes found at each address when they were last checked,
+        so the results can be narrowed down by re-reading only those bytes instead of searching all of the data again.
+        Results of searches with varying sizes, like regex ones, store one size per result and can't be narrowed
+    */
+    class SearchResults {
+    public:
+        enum class Filter : u8 {
+            Matching,   // The bytes still match the given predicate
+            Changed,    // The bytes differ from the ones found last time
+            Unchanged
+        };
+
+        using Predicate = std::function<bool(const u8 *data)>;
+
+        /* Drops all results. A result size of 0 means every result has its own size */
+        void clear(size_t resultSize = 0);
+
+        /*
+            Adds a chunk of sorted results that doesn't overlap any other chunk. Sizes are only given for results without a fixed size,
+            the snapshot holds the bytes of all results of a fixed size back to back
+        */
+        void insert(std::vector<u64> &&addresses, std::vector<u32> &&sizes, std::vector<u8> &&snapshot);
+
+        [[nodiscard]] size_t size() const { return this->m_addresses.size(); }
+        [[nodiscard]] bool empty() const { return this->m_addresses.empty(); }
+
+        /* Start and end address of the result */
+        [[nodiscard]] std::pair<u64, u64> operator[](size_t index) const;
+
+        [[nodiscard]] size_t getResultSize() const { return this->m_resultSize; }
+        [[nodiscard]] bool canNarrow() const { return this->m_resultSize != 0; }
+
+        /* Bytes found at the result the last time it was checked */
+        [[nodiscard]] const u8* getSnapshot(size_t index) const { return this->m_snapshot.data() + index * this->m_resultSize; }
+
+        /* Keeps only the results passing the filter and updates the snapshot of the remaining ones. Returns how many results were dropped */
+        size_t narrow(prv::Provider *provider, Filter filter, const Predicate &predicate = nullptr);
+
+        /* Reads the bytes at all the sorted addresses for a snapshot, with nearby results read together */
+        static std::vector<u8> readSnapshot(prv::Provider *provider, std::span<const u64> addresses, size_t resultSize);
+
+    private:
+        /* Calls the callback with the bytes at every address in order, or with nullptr if the result doesn't fit into the data anymore */
+        template<typename Callback>
+        static void readResults(prv::Provider *provider, std::span<const u64> addresses, size_t resultSize, Callback &&callback);
+
+        std::vector<u64> m_addresses;
+        std::vector<u32> m_sizes;
+        std::vector<u8> m_snapshot;
+        size_t m_resultSize = 0;
+    };
+
+}
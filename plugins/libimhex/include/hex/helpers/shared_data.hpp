@@ -1,15 +1,21 @@
 #pragma once
 
 #include <any>
+#include <atomic>
 #include <functional>
 #include <list>
 #include <map>
 #include <memory>
+#include <optional>
+#include <string_view>
+#include <unordered_set>
 #include <vector>
 
 #include <hex/api/content_registry.hpp>
 #include <hex/api/imhex_api.hpp>
 #include <hex/api/event.hpp>
+#include <hex/api/task.hpp>
+#include <hex/helpers/interval_tree.hpp>
 #include <hex/views/view.hpp>
 
 #include <imgui.h>
@@ -37,35 +43,72 @@ namespace hex {
         friend class Window;
 
         template<typename T>
-        static T& getVariable(std::string variableName) {
-            return std::any_cast<T&>(SharedData::sharedVariables[variableName]);
+        static T& getVariable(std::string_view variableName) {
+            auto variable = SharedData::sharedVariables.find(variableName);
+            if (variable == SharedData::sharedVariables.end())
+                variable = SharedData::sharedVariables.emplace(variableName, std::any()).first;
+
+            return std::any_cast<T&>(variable->second);
         }
 
         template<typename T>
-        static void setVariable(std::string variableName, T value) {
-            SharedData::sharedVariables[variableName] = value;
+        static void setVariable(std::string_view variableName, T value) {
+            auto variable = SharedData::sharedVariables.find(variableName);
+            if (variable == SharedData::sharedVariables.end()) {
+                SharedData::sharedVariables.emplace(variableName, std::move(value));
+                return;
+            }
+
+            // Assigned in place if the type stays the same, so handles to the variable stay valid
+            if (auto currentValue = std::any_cast<T>(&variable->second); currentValue != nullptr)
+                *currentValue = std::move(value);
+            else
+                variable->second = std::move(value);
+        }
+
+        /*
+            Looks the variable up once and returns a pointer to it that stays valid as long as the variable keeps its type,
+            meant to be kept around by code that reads the variable often. The variable gets created with the default value
+            if it doesn't exist yet, nullptr is returned if it holds a different type
+        */
+        template<typename T>
+        static T* getVariableHandle(std::string_view variableName, T defaultValue = { }) {
+            auto variable = SharedData::sharedVariables.find(variableName);
+            if (variable == SharedData::sharedVariables.end())
+                variable = SharedData::sharedVariables.emplace(variableName, std::move(defaultValue)).first;
+
+            return std::any_cast<T>(&variable->second);
         }
 
     public:
-        static std::vector<EventHandler> eventHandlers;
+        static std::map<Events, EventHandlerList> eventHandlers;
+        static std::map<Events, CoalescedEvent> coalescedEvents;
         static std::vector<std::function<void()>> deferredCalls;
         static prv::Provider *currentProvider;
+        static std::shared_ptr<prv::Provider> currentProviderHandle;
+        static std::vector<std::shared_ptr<prv::Provider>> providers;
         static std::map<std::string, std::vector<ContentRegistry::Settings::Entry>> settingsEntries;
         static nlohmann::json settingsJson;
+        static std::optional<std::chrono::steady_clock::time_point> settingsStoreTime;
+        static TaskHolder settingsStoreTask;
         static std::map<std::string, Events> customEvents;
         static u32 customEventsLastId;
         static std::vector<ContentRegistry::CommandPaletteCommands::Entry> commandPaletteCommands;
         static std::map<std::string, ContentRegistry::PatternLanguageFunctions::Function> patternLanguageFunctions;
+        static std::unordered_set<std::string, StringHash, std::equal_to<>> patternLanguageFunctionNames;
         static std::vector<std::unique_ptr<View>> views;
         static std::vector<ContentRegistry::Tools::Entry> toolsEntries;
         static std::vector<ContentRegistry::DataInspector::Entry> dataInspectorEntries;
         static u32 patternPaletteOffset;
         static std::string errorPopupMessage;
         static std::list<ImHexApi::Bookmarks::Entry> bookmarkEntries;
+        static IntervalTree<ImHexApi::Bookmarks::Entry*> bookmarkTree;
+        static bool bookmarkTreeValid;
+        static std::map<std::string, std::vector<ImHexApi::Highlighting::Entry>> highlightEntries;
 
         static std::map<std::string, std::string> languageNames;
         static std::map<std::string, std::vector<LanguageDefinition>> languageDefinitions;
-        static std::map<std::string, std::string> loadedLanguageStrings;
+        static std::vector<LanguageDefinition::Entry> loadedLanguageStrings;
 
         static std::vector<ContentRegistry::Interface::DrawCallback> welcomeScreenEntries;
         static std::vector<ContentRegistry::Interface::DrawCallback> footerItems;
@@ -73,14 +116,25 @@ namespace hex {
         static std::vector<ContentRegistry::DataProcessorNode::Entry> dataProcessorNodes;
         static u32 dataProcessorNodeIdCounter;
 
+        static std::vector<ContentRegistry::Providers::Entry> providerEntries;
+
         static int mainArgc;
         static char **mainArgv;
 
+        /* Views put off setting up expensive subsystems until they're first used */
+        static bool fastStart;
+
+        static std::atomic<bool> redrawRequested;
+        static void(*wakeUpMainLoop)();
+
         static ImVec2 windowPos;
         static ImVec2 windowSize;
 
+        /* Absolute addresses of the bytes the hex editor showed last frame */
+        static Region hexEditorVisibleRegion;
+
     private:
-        static std::map<std::string, std::any> sharedVariables;
+        static std::map<std::string, std::any, std::less<>> sharedVariables;
     };
 
 }
\ No newline at end of file
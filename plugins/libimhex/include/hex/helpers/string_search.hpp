@@ -0,0 +1,61 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <string>
+#include <vector>
+
+namespace hex::prv { class Provider; }
+
+namespace hex {
+
+    enum class StringEncoding : u8 {
+        ASCII,
+        UTF8,
+        UTF16LE,
+        UTF16BE
+    };
+
+    enum class StringSearchMode : u8 {
+        ASCII,
+        UTF8,
+        UTF16LE,
+        UTF16BE,
+        All
+    };
+
+    constexpr static const char* StringEncodingNames[] = { "ASCII", "UTF-8", "UTF-16LE", "UTF-16BE" };
+
+    /* Strings aren't copied out of the data, they get read back from the provider when they're needed */
+    struct FoundString {
+        u64 offset;
+        u32 size;
+        StringEncoding encoding;
+
+        /* Number of characters, saturated so it still fits into the padding of the struct */
+        u16 characters;
+    };
+
+    using FoundStrings = std::vector<FoundString>;
+
+    /*
+        Finds printable strings in the data. The data is split into chunks which can be searched independently of each other,
+        joining the results of all chunks in order gives the same strings as searching everything at once
+    */
+    class StringSearcher {
+    public:
+        StringSearcher() = delete;
+
+        constexpr static size_t ChunkSize = 0x10'0000;
+
+        /*
+            Finds all strings starting inside of one chunk, sorted by offset. Strings running in from the previous chunk
+            are left to that chunk, strings running past the end of the chunk get finished by reading ahead. Offsets are absolute
+        */
+        static FoundStrings searchChunk(prv::Provider *provider, u64 chunkOffset, size_t chunkSize, size_t minimumLength, StringSearchMode mode);
+
+        /* Decodes the string's bytes to UTF-8 */
+        static std::string decode(const u8 *data, const FoundString &foundString);
+    };
+
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <hex/api/task.hpp>
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace hex {
+
+    /*
+        Sorts the rows of large tables on the task system. Only a permutation of the row indices gets sorted, split up between all cores
+        and merged afterwards. Every sort key keeps its permutation until the rows change, so switching back to an earlier order is instant
+    */
+    class TableSorter {
+    public:
+        /* Orders two rows, gets called from worker threads */
+        using Comparator = std::function<bool(u32 left, u32 right)>;
+
+        /* Runs on the sorting task before the rows get sorted. Returning no comparator means the rows changed in the meantime, nothing gets sorted then */
+        using ComparatorFactory = std::function<Comparator()>;
+
+        TableSorter() = default;
+        ~TableSorter();
+
+        TableSorter(const TableSorter&) = delete;
+        TableSorter& operator=(const TableSorter&) = delete;
+
+        /* Drops all permutations, has to be called whenever the rows change */
+        void invalidate();
+
+        /*
+            Switches to the order of the key. A permutation sorted earlier is used right away, otherwise the rows get sorted in the background
+            and the order that was used before stays in place until that's done
+        */
+        void sort(u64 key, u32 rowCount, ComparatorFactory factory);
+
+        /* Permutation of the rows for the last key that finished sorting, nothing while the rows are unsorted */
+        [[nodiscard]] std::shared_ptr<const std::vector<u32>> getOrder() const;
+
+        [[nodiscard]] bool isSorting() const;
+
+    private:
+        constexpr static u32 MinimumPartSize = 0x1'0000;
+
+        static void sortParallel(std::vector<u32> &order, const Comparator &comparator, Task &task);
+
+        /* Shared with the sorting tasks so replaced ones can still finish on their own */
+        struct State {
+            std::mutex mutex;
+            std::map<u64, std::shared_ptr<const std::vector<u32>>> orders;
+            std::optional<u64> currentKey;
+            std::shared_ptr<const std::vector<u32>> currentOrder;
+            u64 generation = 0;
+        };
+
+        std::shared_ptr<State> m_state = std::make_shared<State>();
+
+        /* Sorting tasks that may still be running, the last one is the current one. They're all waited for before the sorter goes away */
+        std::vector<TaskHolder> m_sortTasks;
+    };
+
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <hex.hpp>
+#include <hex/helpers/utils.hpp>
+
+#include <atomic>
+#include <limits>
+#include <string>
+#include <string_view>
+
+namespace hex {
+
+    /*
+        Records what every thread did and when as a timeline, to be looked at in chrome://tracing or Perfetto. Every thread writes its events
+        into a ring buffer of its own without taking any lock, so only the newest events of each thread are kept. Unlike the profiler this
+        covers background tasks and worker threads too. Nothing gets recorded while tracing is disabled
+    */
+    class Tracing {
+    public:
+        Tracing() = delete;
+
+        constexpr static size_t EventsPerThread = 0x4000;
+        constexpr static size_t MaxNameLength = 63;
+        constexpr static u64 NoArgument = std::numeric_limits<u64>::max();
+
+        /* Records the time between its construction and destruction as one event. The category has to be a string literal, the name gets copied */
+        class Scope {
+        public:
+            explicit Scope(std::string_view name, const char *category, u64 argument = NoArgument);
+            ~Scope();
+
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+
+        private:
+            std::string_view m_name;
+            const char *m_category;
+            u64 m_argument;
+            u64 m_start = 0;
+            bool m_active;
+        };
+
+        /* Events recorded before tracing got enabled the last time aren't exported */
+        static void setEnabled(bool enabled);
+        [[nodiscard]] static bool isEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+        /* Shown for the calling thread instead of its number */
+        static void setThreadName(std::string_view name);
+
+        /* Events recorded since tracing got enabled that weren't overwritten yet */
+        [[nodiscard]] static u64 getEventCount();
+
+        /* Writes the recorded events of all threads as a Chrome trace event JSON file */
+        static bool exportTrace(const std::string &path);
+
+    private:
+        static inline std::atomic<bool> s_enabled = false;
+    };
+
+    #define TRACE_SCOPE(...) ::hex::Tracing::Scope TOKEN_CONCAT(traceScope, __COUNTER__)(__VA_ARGS__)
+
+}
@@ -5,9 +5,12 @@
 #include <array>
 #include <cstring>
 #include <functional>
+#include <iterator>
 #include <memory>
 #include <optional>
+#include <span>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <vector>
 
@@ -92,6 +95,12 @@ namespace hex {
         return fmt::format(format, args...);
     }
 
+    /* Appends to output instead of returning a new string, so a string that's reused keeps its memory */
+    template<typename ... Args>
+    inline void formatTo(std::string &output, std::string_view format, Args ... args) {
+        fmt::format_to(std::back_inserter(output), format, args...);
+    }
+
     template<typename ... Args>
     inline void print(std::string_view format, Args ... args) {
         fmt::print(format, args...);
@@ -113,6 +122,13 @@ namespace hex {
     template<typename T>
     struct always_false : std::false_type {};
 
+    /* Lets containers keyed by std::string be searched with a std::string_view without building a string first */
+    struct StringHash {
+        using is_transparent = void;
+
+        size_t operator()(std::string_view string) const { return std::hash<std::string_view>{}(string); }
+    };
+
     template<typename T>
     constexpr T changeEndianess(T value, std::endian endian) {
         if (endian == std::endian::native)
@@ -151,6 +167,9 @@ namespace hex {
             throw std::invalid_argument("Invalid value size!");
     }
 
+    /* Converts count consecutive values of size bytes each between the given and the native endianess in place */
+    void changeEndianess(void *data, size_t count, size_t size, std::endian endian);
+
     template< class T >
     constexpr T bit_width(T x) noexcept {
         return std::numeric_limits<T>::digits - std::countl_zero(x);
@@ -168,6 +187,9 @@ namespace hex {
 
     std::string toEngineeringString(double value);
 
+    /* Appends every byte as two uppercase hex digits behind prefix, with separator between bytes. Grows the string only once */
+    void appendHexString(std::string &string, std::span<const u8> bytes, std::string_view prefix = "", std::string_view separator = " ");
+
     std::vector<u8> readFile(std::string_view path);
 
     template<typename T>
@@ -178,22 +200,8 @@ namespace hex {
         return bytes;
     }
 
-    inline std::vector<u8> parseByteString(std::string_view string) {
-        auto byteString = std::string(string);
-        byteString.erase(std::remove(byteString.begin(), byteString.end(), ' '), byteString.end());
-
-        if ((byteString.length() % 2) != 0) return { };
-
-        std::vector<u8> result;
-        for (u32 i = 0; i < byteString.length(); i += 2) {
-            if (!std::isxdigit(byteString[i]) || !std::isxdigit(byteString[i + 1]))
-                return { };
-
-            result.push_back(std::strtoul(byteString.substr(i, 2).c_str(), nullptr, 16));
-        }
-
-        return result;
-    }
+    /* Parses hex digits into bytes, spaces between them are ignored. Returns nothing if the string isn't made of whole bytes */
+    std::vector<u8> parseByteString(std::string_view string);
 
     inline std::string toBinaryString(hex::integral auto number) {
         if (number == 0) return "0";
@@ -230,7 +238,8 @@ namespace hex {
         Plugins,
         Yara,
         Config,
-        Resources
+        Resources,
+        Cache
     };
 
     std::vector<std::string> getPath(ImHexPath path);
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <atomic>
+#include <bit>
+#include <functional>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace hex::prv { class Provider; }
+
+namespace hex {
+
+    enum class ValueType : u8 {
+        U8, S8,
+        U16, S16,
+        U32, S32,
+        U64, S64,
+        Float, Double
+    };
+
+    constexpr static const char* ValueTypeNames[] = { "u8", "s8", "u16", "s16", "u32", "s32", "u64", "s64", "float", "double" };
+
+    /*
+        Finds integers and floats with a value inside of an inclusive range, either at every offset or only at offsets aligned to a multiple of the alignment.
+        Exact values and values within a tolerance are searched as ranges as well. With AVX2 the values at all offsets of a 32 byte block
+        get compared at once, the loaded bytes get spread out into one lane per offset
+    */
+    class ValueSearcher {
+    public:
+        /* Called for every value found with its address. Return false to stop searching */
+        using Callback = std::function<bool(u64 address)>;
+
+        /* Called once per finished chunk with the addresses of all values in it in ascending order, from whichever worker thread searched it */
+        using ChunkCallback = std::function<void(u64 chunkOffset, size_t chunkSize, std::vector<u64> &&addresses)>;
+
+        constexpr static size_t ChunkSize = 0x10'0000;
+
+        /* Bounds of integer types. Signed ones are given as their two's complement bits and get clamped to what the type can hold */
+        ValueSearcher(ValueType type, std::endian endian, u32 alignment, u64 minimum, u64 maximum);
+
+        /* Bounds of floating point types. NaNs never match */
+        ValueSearcher(ValueType type, std::endian endian, u32 alignment, double minimum, double maximum);
+
+        [[nodiscard]] static size_t getSize(ValueType type);
+        [[nodiscard]] static bool isSigned(ValueType type) { return type == ValueType::S8 || type == ValueType::S16 || type == ValueType::S32 || type == ValueType::S64; }
+        [[nodiscard]] static bool isFloatingPoint(ValueType type) { return type == ValueType::Float || type == ValueType::Double; }
+
+        /* Parses a value of the type, integers may be decimal or prefixed hex and octal. Fails on anything the type can't hold */
+        [[nodiscard]] static std::optional<u64> parseInteger(ValueType type, std::string_view string);
+        [[nodiscard]] static std::optional<double> parseFloat(std::string_view string);
+
+        [[nodiscard]] size_t getSize() const { return this->m_size; }
+
+        /* Searches data for values fully contained in the buffer that start before startLimit, in ascending order */
+        bool searchBuffer(const u8 *data, size_t size, size_t startLimit, u64 baseAddress, const Callback &callback) const;
+
+        /* Splits the search across multiple threads, with patches applied. Addresses are absolute. Blocks until done or cancelled */
+        void searchParallel(prv::Provider* &provider, u64 offset, size_t size, const ChunkCallback &callback, const std::atomic<bool> &cancelled, u32 threadCount = 0) const;
+
+        /* Checks whether the value right at data is in range, data has to hold at least getSize() bytes */
+        [[nodiscard]] bool matches(const u8 *data) const;
+
+    private:
+        /* Compares the values at all offsets of 32 byte blocks at once, for as long as whole blocks are left. Position is where the rest has to continue */
+        template<size_t Size, bool FloatingPoint>
+        bool searchVectorized(const u8 *data, size_t size, size_t startLimit, u64 baseAddress, const Callback &callback, size_t &position) const;
+
+        ValueType m_type;
+        size_t m_size;
+        std::endian m_endian;
+        u32 m_alignment;
+        bool m_empty = false;
+
+        // Integers are in range if ((bits ^ flip) - low) <= span, all in the type's width. The flip turns signed order into unsigned order
+        u64 m_flip = 0, m_low = 0, m_span = 0;
+
+        // Bounds of floats are rounded inwards to the closest float so all values of the type compare the same in single precision
+        double m_lowFloat = 0, m_highFloat = 0;
+    };
+
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <hex/helpers/value_search.hpp>
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <span>
+#include <variant>
+#include <vector>
+
+namespace hex::prv { class Provider; }
+
+namespace hex {
+
+    /* Statistics over all values of one type in a region, taken one after another from its start */
+    struct ValueStatistics {
+        constexpr static size_t BinCount = 64;
+
+        /* Integers keep their exact value, floats are widened to double */
+        using Number = std::variant<u64, s64, double>;
+
+        ValueType type;
+
+        /* Values that went into everything below. NaNs and infinities are only counted as skipped */
+        u64 count = 0;
+        u64 skipped = 0;
+
+        Number minimum, maximum;
+        double mean = 0;
+
+        /* Evenly spaced bins from the minimum up to and including the maximum */
+        std::array<u64, BinCount> histogram = { };
+    };
+
+    /*
+        Decodes a region as every given type at once and gathers the minimum, maximum, mean and a histogram of each. The region is read in
+        chunks, split up between the task manager workers, and read a second time for the histograms once the range of every type is known.
+        With AVX2 the minimum, maximum and sum of a whole vector of values get updated at once. Returns nothing if the run got cancelled
+    */
+    class ValueStatisticsCalculator {
+    public:
+        ValueStatisticsCalculator() = delete;
+
+        static std::vector<ValueStatistics> calculate(prv::Provider *provider, u64 address, size_t size, std::span<const ValueType> types, std::endian endian,
+                                                      const std::atomic<bool> &cancelled, std::atomic<u64> *processedBytes = nullptr);
+
+        constexpr static size_t ChunkSize = 0x10'0000;
+    };
+
+}
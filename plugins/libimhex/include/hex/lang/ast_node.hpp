@@ -29,6 +29,11 @@ namespace hex::lang {
         std::vector<ASTNodeAttribute*> m_attributes;
     };
 
+    /*
+        Nodes don't own the nodes they refer to. The whole tree is owned by the arena it was parsed into,
+        so nodes may be shared between several parents and copies share their children with the original.
+        Names of declarations refer to the symbol table of the lexer, which lives as long as the tree does
+    */
     class ASTNode {
     public:
         constexpr ASTNode() = default;
@@ -71,17 +76,6 @@ namespace hex::lang {
         ASTNodeNumericExpression(ASTNode *left, ASTNode *right, Token::Operator op)
                 : ASTNode(), m_left(left), m_right(right), m_operator(op) { }
 
-        ~ASTNodeNumericExpression() override {
-            delete this->m_left;
-            delete this->m_right;
-        }
-
-        ASTNodeNumericExpression(const ASTNodeNumericExpression &other) : ASTNode(other) {
-            this->m_operator = other.m_operator;
-            this->m_left = other.m_left->clone();
-            this->m_right = other.m_right->clone();
-        }
-
         [[nodiscard]] ASTNode* clone() const override {
             return new ASTNodeNumericExpression(*this);
         }
@@ -100,19 +94,6 @@ namespace hex::lang {
         ASTNodeTernaryExpression(ASTNode *first, ASTNode *second, ASTNode *third, Token::Operator op)
                 : ASTNode(), m_first(first), m_second(second), m_third(third), m_operator(op) { }
 
-        ~ASTNodeTernaryExpression() override {
-            delete this->m_first;
-            delete this->m_second;
-            delete this->m_third;
-        }
-
-        ASTNodeTernaryExpression(const ASTNodeTernaryExpression &other) : ASTNode(other) {
-            this->m_operator = other.m_operator;
-            this->m_first = other.m_first->clone();
-            this->m_second = other.m_second->clone();
-            this->m_third = other.m_third->clone();
-        }
-
         [[nodiscard]] ASTNode* clone() const override {
             return new ASTNodeTernaryExpression(*this);
         }
@@ -147,16 +128,6 @@ namespace hex::lang {
         ASTNodeTypeDecl(std::string_view name, ASTNode *type, std::optional<std::endian> endian = { })
                 : ASTNode(), m_name(name), m_type(type), m_endian(endian) { }
 
-        ASTNodeTypeDecl(const ASTNodeTypeDecl& other) : ASTNode(other), Attributable(other) {
-            this->m_name = other.m_name;
-            this->m_type = other.m_type->clone();
-            this->m_endian = other.m_endian;
-        }
-
-        ~ASTNodeTypeDecl() override {
-            delete this->m_type;
-        }
-
         [[nodiscard]] ASTNode* clone() const override {
             return new ASTNodeTypeDecl(*this);
         }
@@ -166,7 +137,7 @@ namespace hex::lang {
         [[nodiscard]] std::optional<std::endian> getEndian() const { return this->m_endian; }
 
     private:
-        std::string m_name;
+        std::string_view m_name;
         ASTNode *m_type;
         std::optional<std::endian> m_endian;
     };
@@ -176,21 +147,6 @@ namespace hex::lang {
         ASTNodeVariableDecl(std::string_view name, ASTNode *type, ASTNode *placementOffset = nullptr)
                 : ASTNode(), m_name(name), m_type(type), m_placementOffset(placementOffset) { }
 
-        ASTNodeVariableDecl(const ASTNodeVariableDecl &other) : ASTNode(other), Attributable(other) {
-            this->m_name = other.m_name;
-            this->m_type = other.m_type->clone();
-
-            if (other.m_placementOffset != nullptr)
-                this->m_placementOffset = other.m_placementOffset->clone();
-            else
-                this->m_placementOffset = nullptr;
-        }
-
-        ~ASTNodeVariableDecl() override {
-            delete this->m_type;
-            delete this->m_placementOffset;
-        }
-
         [[nodiscard]] ASTNode* clone() const override {
             return new ASTNodeVariableDecl(*this);
         }
@@ -200,7 +156,7 @@ namespace hex::lang {
         [[nodiscard]] constexpr auto getPlacementOffset() const { return this->m_placementOffset; }
 
     private:
-        std::string m_name;
+        std::string_view m_name;
         ASTNode *m_type;
         ASTNode *m_placementOffset;
     };
@@ -210,26 +166,6 @@ namespace hex::lang {
         ASTNodeArrayVariableDecl(std::string_view name, ASTNode *type, ASTNode *size, ASTNode *placementOffset = nullptr)
                 : ASTNode(), m_name(name), m_type(type), m_size(size), m_placementOffset(placementOffset) { }
 
-        ASTNodeArrayVariableDecl(const ASTNodeArrayVariableDecl &other) : ASTNode(other), Attributable(other) {
-            this->m_name = other.m_name;
-            this->m_type = other.m_type->clone();
-            if (other.m_size != nullptr)
-                this->m_size = other.m_size->clone();
-            else
-                this->m_size = nullptr;
-
-            if (other.m_placementOffset != nullptr)
-                this->m_placementOffset = other.m_placementOffset->clone();
-            else
-                this->m_placementOffset = nullptr;
-        }
-
-        ~ASTNodeArrayVariableDecl() override {
-            delete this->m_type;
-            delete this->m_size;
-            delete this->m_placementOffset;
-        }
-
         [[nodiscard]] ASTNode* clone() const override {
             return new ASTNodeArrayVariableDecl(*this);
         }
@@ -240,7 +176,7 @@ namespace hex::lang {
         [[nodiscard]] constexpr auto getPlacementOffset() const { return this->m_placementOffset; }
 
     private:
-        std::string m_name;
+        std::string_view m_name;
         ASTNode *m_type;
         ASTNode *m_size;
         ASTNode *m_placementOffset;
@@ -251,23 +187,6 @@ namespace hex::lang {
         ASTNodePointerVariableDecl(std::string_view name, ASTNode *type, ASTNode *sizeType, ASTNode *placementOffset = nullptr)
                 : ASTNode(), m_name(name), m_type(type), m_sizeType(sizeType), m_placementOffset(placementOffset) { }
 
-        ASTNodePointerVariableDecl(const ASTNodePointerVariableDecl &other) : ASTNode(other), Attributable(other) {
-            this->m_name = other.m_name;
-            this->m_type = other.m_type->clone();
-            this->m_sizeType = other.m_sizeType->clone();
-
-            if (other.m_placementOffset != nullptr)
-                this->m_placementOffset = other.m_placementOffset->clone();
-            else
-                this->m_placementOffset = nullptr;
-        }
-
-        ~ASTNodePointerVariableDecl() override {
-            delete this->m_type;
-            delete this->m_sizeType;
-            delete this->m_placementOffset;
-        }
-
         [[nodiscard]] ASTNode* clone() const override {
             return new ASTNodePointerVariableDecl(*this);
         }
@@ -278,7 +197,7 @@ namespace hex::lang {
         [[nodiscard]] constexpr auto getPlacementOffset() const { return this->m_placementOffset; }
 
     private:
-        std::string m_name;
+        std::string_view m_name;
         ASTNode *m_type;
         ASTNode *m_sizeType;
         ASTNode *m_placementOffset;
@@ -288,16 +207,6 @@ namespace hex::lang {
     public:
         ASTNodeStruct() : ASTNode() { }
 
-        ASTNodeStruct(const ASTNodeStruct &other) : ASTNode(other), Attributable(other) {
-            for (const auto &otherMember : other.getMembers())
-                this->m_members.push_back(otherMember->clone());
-        }
-
-        ~ASTNodeStruct() override {
-            for (auto &member : this->m_members)
-                delete member;
-        }
-
         [[nodiscard]] ASTNode* clone() const override {
             return new ASTNodeStruct(*this);
         }
@@ -313,16 +222,6 @@ namespace hex::lang {
     public:
         ASTNodeUnion() : ASTNode() { }
 
-        ASTNodeUnion(const ASTNodeUnion &other) : ASTNode(other), Attributable(other) {
-            for (const auto &otherMember : other.getMembers())
-                this->m_members.push_back(otherMember->clone());
-        }
-
-        ~ASTNodeUnion() override {
-            for (auto &member : this->m_members)
-                delete member;
-        }
-
         [[nodiscard]] ASTNode* clone() const override {
             return new ASTNodeUnion(*this);
         }
@@ -338,18 +237,6 @@ namespace hex::lang {
     public:
         explicit ASTNodeEnum(ASTNode *underlyingType) : ASTNode(), m_underlyingType(underlyingType) { }
 
-        ASTNodeEnum(const ASTNodeEnum &other) : ASTNode(other), Attributable(other) {
-            for (const auto &[name, entry] : other.getEntries())
-                this->m_entries.insert({ name, entry->clone() });
-            this->m_underlyingType = other.m_underlyingType->clone();
-        }
-
-        ~ASTNodeEnum() override {
-            for (auto &[name, expr] : this->m_entries)
-                delete expr;
-            delete this->m_underlyingType;
-        }
-
         [[nodiscard]] ASTNode* clone() const override {
             return new ASTNodeEnum(*this);
         }
@@ -368,16 +255,6 @@ namespace hex::lang {
     public:
         ASTNodeBitfield() : ASTNode() { }
 
-        ASTNodeBitfield(const ASTNodeBitfield &other) : ASTNode(other), Attributable(other) {
-            for (const auto &[name, entry] : other.getEntries())
-                this->m_entries.emplace_back(name, entry->clone());
-        }
-
-        ~ASTNodeBitfield() override {
-            for (auto &[name, expr] : this->m_entries)
-                delete expr;
-        }
-
         [[nodiscard]] ASTNode* clone() const override {
             return new ASTNodeBitfield(*this);
         }
@@ -430,24 +307,6 @@ namespace hex::lang {
         explicit ASTNodeConditionalStatement(ASTNode *condition, std::vector<ASTNode*> trueBody, std::vector<ASTNode*> falseBody)
             : ASTNode(), m_condition(condition), m_trueBody(std::move(trueBody)), m_falseBody(std::move(falseBody)) { }
 
-        ~ASTNodeConditionalStatement() override {
-            delete this->m_condition;
-
-            for (auto &statement : this->m_trueBody)
-                delete statement;
-            for (auto &statement : this->m_falseBody)
-                delete statement;
-        }
-
-        ASTNodeConditionalStatement(const ASTNodeConditionalStatement &other) : ASTNode(other) {
-            this->m_condition = other.m_condition->clone();
-
-            for (auto &statement : other.m_trueBody)
-                this->m_trueBody.push_back(statement->clone());
-            for (auto &statement : other.m_falseBody)
-                this->m_falseBody.push_back(statement->clone());
-        }
-
         [[nodiscard]] ASTNode* clone() const override {
             return new ASTNodeConditionalStatement(*this);
         }
@@ -474,18 +333,6 @@ namespace hex::lang {
         explicit ASTNodeFunctionCall(std::string_view functionName, std::vector<ASTNode*> params)
                 : ASTNode(), m_functionName(functionName), m_params(std::move(params)) { }
 
-        ~ASTNodeFunctionCall() override {
-            for (auto &param : this->m_params)
-                delete param;
-        }
-
-        ASTNodeFunctionCall(const ASTNodeFunctionCall &other) : ASTNode(other) {
-            this->m_functionName = other.m_functionName;
-
-            for (auto &param : other.m_params)
-                this->m_params.push_back(param->clone());
-        }
-
         [[nodiscard]] ASTNode* clone() const override {
             return new ASTNodeFunctionCall(*this);
         }
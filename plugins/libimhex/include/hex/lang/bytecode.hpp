@@ -0,0 +1,46 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <hex/lang/token.hpp>
+
+#include <string>
+#include <vector>
+
+namespace hex::lang { class ASTNode; }
+
+namespace hex::lang::bytecode {
+
+    enum class Opcode : u8 {
+        LoadConstant,   // registers[destination] = constants[operand]
+        LoadOffset,     // registers[destination] = $
+        LoadVariable,   // registers[destination] = value of the rvalue nodes[operand]
+        Call,           // registers[destination] = result of the function call nodes[operand]
+        Operator,       // registers[destination] = registers[left] op registers[right]
+        JumpIfZero,     // if registers[left] == 0 jump to instruction operand
+        Jump,           // jump to instruction operand
+        Abort           // abort the evaluation with messages[operand]
+    };
+
+    struct Instruction {
+        Opcode opcode;
+        Token::Operator op = Token::Operator::Plus;
+        u16 destination = 0;
+        u16 left = 0;
+        u16 right = 0;
+        u32 operand = 0;
+    };
+
+    /*
+        A numeric expression compiled for the evaluator's register machine.
+        The result of the expression ends up in register 0
+    */
+    struct Program {
+        std::vector<Instruction> instructions;
+        std::vector<Token::IntegerLiteral> constants;
+        std::vector<ASTNode*> nodes;
+        std::vector<std::string> messages;
+        u16 registerCount = 1;
+    };
+
+}
\ No newline at end of file
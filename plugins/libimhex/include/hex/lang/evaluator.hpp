@@ -3,32 +3,80 @@
 #include <hex.hpp>
 
 #include <hex/providers/provider.hpp>
+#include <hex/helpers/arena.hpp>
 #include <hex/helpers/utils.hpp>
 #include <hex/lang/pattern_data.hpp>
 #include <hex/lang/ast_node.hpp>
+#include <hex/lang/bytecode.hpp>
 #include <hex/lang/log_console.hpp>
 
+#include <atomic>
 #include <bit>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <optional>
+#include <span>
 #include <string>
+#include <tuple>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace hex::lang {
 
     class Evaluator {
     public:
-        Evaluator() = default;
+        /* All patterns created by an evaluation are owned by the arena and stay valid until it's cleared */
+        explicit Evaluator(Arena &arena) : m_arena(arena) { }
 
         std::optional<std::vector<PatternData*>> evaluate(const std::vector<ASTNode*>& ast);
 
+        /*
+            Re-evaluates only the top-level variables whose layout depended on one of the changed regions, either directly
+            or through another global they reference. Requires the AST of the last evaluation to still be alive.
+            Returns nothing if the changes can't be applied incrementally and a full evaluation is needed instead
+        */
+        std::optional<std::vector<PatternData*>> reevaluate(const std::vector<Region> &changedRegions);
+
         LogConsole& getConsole() { return this->m_console; }
 
         void setDefaultEndian(std::endian endian) { this->m_defaultDataEndian = endian; }
-        void setProvider(prv::Provider *provider) { this->m_provider = provider; }
+        void setProvider(prv::Provider *provider) { this->m_provider = provider; this->m_readWindow = { }; }
+        [[nodiscard]] prv::Provider* getProvider() const { return this->m_provider; }
         [[nodiscard]] std::endian getCurrentEndian() const { return this->m_endianStack.back(); }
 
+        /* Can be called from any thread, the evaluation stops the next time it creates a pattern or reads a chunk of data */
+        void abort() { this->m_aborted = true; }
+        void setPatternLimit(u64 limit) { this->m_patternLimit = limit; }
+        void setArrayLimit(u64 limit) { this->m_arrayLimit = limit; }
+        void setEvaluationDepth(u32 depth) { this->m_evaluationDepth = depth; }
+        void setProfiling(bool enabled) { this->m_profiling = enabled; }
+
+        /*
+            Isolated evaluations don't touch any state shared with other evaluators, so several of them can run on different threads at once.
+            They don't spread out onto worker threads themselves and color their patterns as if the palette got reset right before
+        */
+        void setIsolated(bool isolated) { this->m_isolated = isolated; }
+
+        /* Takes over the default endianness, limits and profiling of another evaluator, like those set by pragmas */
+        void copySettings(const Evaluator &other);
+        [[nodiscard]] u64 getCreatedPatternCount() const { return this->m_createdPatterns; }
+
         PatternData* patternFromName(const std::vector<std::string> &name);
 
+        /* Reads data from the provider and remembers the region so edits to it cause a re-evaluation */
+        void readData(u64 address, void *buffer, size_t size);
+
+        /* Absolute address of a region of the data, remembering the region like readData does. For functions that process large regions at once */
+        u64 useRegion(u64 address, size_t size);
+
+        /* Remembers that the result depends on the size of the data, so appending to it causes a re-evaluation */
+        void recordEndOfData();
+
+        /* Addresses of all occurrences of a sequence. The data is only searched once per sequence and evaluation */
+        const std::vector<u64>& getSequenceOccurrences(const std::vector<u8> &sequence, const std::vector<u8> &mask = { });
+
         template<typename T>
         T* asType(ASTNode *param) {
             if (auto evaluatedParam = dynamic_cast<T*>(param); evaluatedParam != nullptr)
@@ -37,7 +85,12 @@ namespace hex::lang {
                 this->getConsole().abortEvaluation("function got wrong type of parameter");
         }
 
+        constexpr static u64 DefaultPatternLimit = 0x100'0000;
+        constexpr static u64 DefaultArrayLimit = 0x100'0000;
+        constexpr static u32 DefaultEvaluationDepth = 32;
+
     private:
+        Arena &m_arena;
         std::map<std::string, ASTNode*> m_types;
         prv::Provider* m_provider = nullptr;
         std::endian m_defaultDataEndian = std::endian::native;
@@ -46,16 +99,130 @@ namespace hex::lang {
         std::vector<PatternData*> m_globalMembers;
         std::vector<std::vector<PatternData*>*> m_currMembers;
         LogConsole m_console;
+        std::atomic<bool> m_aborted = false;
+        std::atomic<u64> m_createdPatterns = 0;
+        u64 m_patternLimit = DefaultPatternLimit;
+        u64 m_arrayLimit = DefaultArrayLimit;
+        u32 m_evaluationDepth = DefaultEvaluationDepth;
+        u32 m_currDepth = 0;
+
+        /* Data following the last read. Points straight into the provider's memory if it's mapped and unpatched */
+        constexpr static size_t ReadWindowSize = 0x1'0000;
+        std::vector<u8> m_readBuffer;
+        std::span<const u8> m_readWindow;
+        u64 m_readWindowAddress = 0;
+
+        /* Inclusive time, data reads and created patterns per type, array and function, collected while profiling */
+        struct ProfileEntry {
+            u64 evaluations = 0;
+            std::chrono::steady_clock::duration time { };
+            u64 bytesRead = 0;
+            u64 patterns = 0;
+        };
+
+        struct ProfileSnapshot {
+            std::chrono::steady_clock::time_point start;
+            u64 bytesRead;
+            u64 patterns;
+        };
+
+        bool m_profiling = false;
+        bool m_isolated = false;
+        u64 m_bytesRead = 0;
+        std::map<std::string, ProfileEntry> m_profile;
+        std::map<std::pair<std::vector<u8>, std::vector<u8>>, std::vector<u64>> m_sequenceOccurrences;
+
+        /* Expressions get compiled the first time they're evaluated and reused for the rest of the evaluation */
+        std::unordered_map<ASTNode*, bytecode::Program> m_programs;
+        std::vector<Token::IntegerLiteral> m_registers;
+
+        /* Types whose layout doesn't depend on the data or their position, so arrays of them only need to be evaluated once */
+        std::unordered_map<ASTNode*, bool> m_staticLayouts;
+
+        /* Evaluated instance of a static layout type per endianness. Later instances are clones of it moved to their own offset */
+        struct StaticLayoutPattern {
+            PatternData *pattern = nullptr;
+            u64 patternCount = 0;
+        };
+        std::map<std::pair<ASTNode*, std::endian>, StaticLayoutPattern> m_staticLayoutPatterns;
+
+        /* Constants of every enum type evaluated so far, owned by the arena */
+        std::unordered_map<ASTNodeEnum*, const EnumValues*> m_enumValues;
+
+        /* Type names and bitfield layouts are created once in the arena and shared by all patterns that use them */
+        std::unordered_map<std::string_view, const std::string*> m_typeNames;
+        std::unordered_map<ASTNodeBitfield*, const PatternDataBitfield::Fields*> m_bitfieldFields;
+
+        /*
+            Patterns pointers led to, by statement, address, type and endianness. Pointers to the same data share a single pattern.
+            Entries are null while their pattern is still being evaluated, a pointer leading back to one of them closes a cycle
+        */
+        std::map<std::tuple<size_t, u64, ASTNode*, std::endian>, PatternData*> m_pointedAtPatterns;
+
+        /* Member index every path component of an rvalue resolved to last time, tried first on the next lookup */
+        std::unordered_map<ASTNodeRValue*, std::vector<u32>> m_nameSlots;
+
+        /* Consecutive placed globals that can't refer to other globals get evaluated on worker threads with their own context */
+        Evaluator *m_parent = nullptr;
+        std::vector<std::unique_ptr<Arena>> m_workerArenas;
+        std::unordered_set<std::string> m_globalNames;
+        std::unordered_map<ASTNode*, bool> m_globalReferences;
+
+        /* Everything a top-level statement's result depends on, used to find out what needs to be re-evaluated after an edit */
+        struct StatementDependencies {
+            ASTNode *node;
+            std::optional<size_t> globalIndex;
+            std::vector<Region> reads;
+            bool readsAllData = false;
+            std::vector<size_t> globalReferences;
+            u32 paletteOffset = 0;
+        };
+
+        constexpr static size_t MaxTrackedReads = 0x1000;
+
+        std::vector<StatementDependencies> m_statements;
+        std::optional<size_t> m_currStatement;
+
+        template<typename T, typename ... Args>
+        T* create(Args&& ... args) {
+            this->handleAbort();
+            this->countPatterns(1);
+
+            return this->m_arena.create<T>(std::forward<Args>(args)...);
+        }
 
+        void countPatterns(u64 count) {
+            // Patterns created on worker threads count towards the limit of the whole evaluation
+            auto createdPatterns = this->m_createdPatterns += count;
+            if (this->m_parent != nullptr)
+                createdPatterns = this->m_parent->m_createdPatterns += count;
 
+            if (createdPatterns > this->m_patternLimit)
+                this->getConsole().abortEvaluation(hex::format("exceeded the limit of {0} patterns", this->m_patternLimit));
+        }
+
+        void handleAbort() {
+            if (this->m_aborted || (this->m_parent != nullptr && this->m_parent->m_aborted))
+                this->getConsole().abortEvaluation("evaluation was aborted");
+        }
 
-        ASTNodeIntegerLiteral* evaluateScopeResolution(ASTNodeScopeResolution *node);
-        ASTNodeIntegerLiteral* evaluateRValue(ASTNodeRValue *node);
+        PatternData* patternFromName(const std::vector<std::string> &path, std::vector<u32> *slots);
+        Token::IntegerLiteral evaluateRValue(ASTNodeRValue *node);
         ASTNode* evaluateFunctionCall(ASTNodeFunctionCall *node);
-        ASTNodeIntegerLiteral* evaluateOperator(ASTNodeIntegerLiteral *left, ASTNodeIntegerLiteral *right, Token::Operator op);
-        ASTNodeIntegerLiteral* evaluateOperand(ASTNode *node);
-        ASTNodeIntegerLiteral* evaluateTernaryExpression(ASTNodeTernaryExpression *node);
-        ASTNodeIntegerLiteral* evaluateMathematicalExpression(ASTNodeNumericExpression *node);
+        static Token::ValueType getResultType(Token::ValueType left, Token::ValueType right);
+        template<typename T>
+        std::optional<Token::IntegerLiteral> evaluateIntegerOperator(Token::ValueType type, T left, T right, Token::Operator op);
+        Token::IntegerLiteral evaluateOperator(const Token::IntegerLiteral &left, const Token::IntegerLiteral &right, Token::Operator op);
+        Token::IntegerLiteral evaluateExpression(ASTNode *node);
+
+        void compileOperand(ASTNode *node, bytecode::Program &program, u16 destination);
+        const bytecode::Program& getProgram(ASTNode *node);
+        Token::IntegerLiteral execute(const bytecode::Program &program);
+
+        bool isConstantExpression(ASTNode *node);
+        bool hasStaticLayout(ASTNode *node);
+
+        const std::string* getTypeName(std::string_view name);
 
         PatternData* evaluateAttributes(ASTNode *currNode, PatternData *currPattern);
         PatternData* evaluateBuiltinType(ASTNodeBuiltinType *node);
@@ -68,6 +235,21 @@ namespace hex::lang {
         PatternData* evaluateVariable(ASTNodeVariableDecl *node);
         PatternData* evaluateArray(ASTNodeArrayVariableDecl *node);
         PatternData* evaluatePointer(ASTNodePointerVariableDecl *node);
+        PatternData* evaluateGlobalVariable(ASTNode *node);
+
+        bool mayReferenceGlobals(ASTNode *node);
+        bool canEvaluateConcurrently(ASTNode *node);
+        void evaluateConcurrently(const std::vector<ASTNode*> &statements);
+        /* Swaps the numbered placeholder colors of patterns created on worker threads for palette colors, starting at the given offset */
+        static void assignPaletteColors(PatternData *pattern, u32 paletteOffset);
+
+        std::optional<ProfileSnapshot> beginProfiling() const;
+        void endProfiling(std::string_view kind, std::string_view name, const std::optional<ProfileSnapshot> &snapshot);
+        void logProfile();
+
+        std::span<const u8> getReadWindow(u64 address, size_t minimumSize);
+        void recordRead(u64 address, size_t size);
+        bool isAffected(const StatementDependencies &statement, const std::vector<Region> &changedRegions, const std::vector<bool> &dirtyGlobals) const;
     };
 
 }
\ No newline at end of file
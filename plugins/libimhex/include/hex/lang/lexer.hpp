@@ -4,8 +4,11 @@
 
 #include "token.hpp"
 
+#include <functional>
 #include <optional>
+#include <set>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace hex::lang {
@@ -16,12 +19,18 @@ namespace hex::lang {
 
         Lexer();
 
-        std::optional<std::vector<Token>> lex(const std::string& code);
+        /* The returned tokens stay valid until the next call */
+        std::optional<std::vector<Token>> lex(std::string_view code);
         const LexerError& getError() { return this->m_error; }
 
     private:
         LexerError m_error;
 
+        /* Every distinct identifier and string literal is only stored once */
+        std::set<std::string, std::less<>> m_symbols;
+
+        std::string_view intern(std::string_view symbol);
+
         [[noreturn]] void throwLexerError(std::string_view error, u32 lineNumber) const {
             throw LexerError(lineNumber, "Lexer: " + std::string(error));
         }
@@ -32,6 +32,10 @@ namespace hex::lang {
             }
         }
 
+        void append(const LogConsole &other) {
+            this->m_consoleLog.insert(this->m_consoleLog.end(), other.m_consoleLog.begin(), other.m_consoleLog.end());
+        }
+
         [[noreturn]] void abortEvaluation(std::string_view message) {
             throw EvaluateError(message);
         }
@@ -5,6 +5,7 @@
 #include "token.hpp"
 #include "ast_node.hpp"
 
+#include <hex/helpers/arena.hpp>
 #include <hex/helpers/utils.hpp>
 
 #include <unordered_map>
@@ -19,18 +20,22 @@ namespace hex::lang {
         using TokenIter = std::vector<Token>::const_iterator;
         using ParseError = std::pair<u32, std::string>;
 
-        Parser() = default;
+        /* All nodes of the parsed AST are owned by the arena and stay valid until it's cleared */
+        explicit Parser(Arena &arena) : m_arena(arena) { }
         ~Parser() = default;
 
         std::optional<std::vector<ASTNode*>> parse(const std::vector<Token> &tokens);
         const ParseError& getError() { return this->m_error; }
 
     private:
+        Arena &m_arena;
         ParseError m_error;
         TokenIter m_curr;
         TokenIter m_originalPosition;
 
-        std::unordered_map<std::string, ASTNode*> m_types;
+        std::unordered_map<std::string_view, ASTNode*> m_types;
+        /* Struct or union whose members are being parsed */
+        ASTNode *m_currTypeDecl = nullptr;
         std::vector<TokenIter> m_matchedOptionals;
 
         u32 getLineNumber(s32 index) const {
@@ -47,10 +52,25 @@ namespace hex::lang {
             return *value;
         }
 
+        /* Tokens only refer to their text, AST nodes get their own copy */
+        std::string getString(s32 index) const {
+            return std::string(this->getValue<std::string_view>(index));
+        }
+
+        /* Declared names are kept as they were interned by the lexer, equal names are always the same string */
+        std::string_view getIdentifier(s32 index) const {
+            return this->getValue<std::string_view>(index);
+        }
+
         Token::Type getType(s32 index) const {
             return this->m_curr[index].type;
         }
 
+        template<typename T, typename ... Args>
+        T* create(Args&& ... args) {
+            return this->m_arena.create<T>(std::forward<Args>(args)...);
+        }
+
         ASTNode* parseFunctionCall();
         ASTNode* parseStringLiteral();
         ASTNode* parseScopeResolution(std::vector<std::string> &path);
@@ -91,7 +111,6 @@ namespace hex::lang {
 
         std::vector<ASTNode*> parseTillToken(Token::Type endTokenType, const auto value) {
             std::vector<ASTNode*> program;
-            ScopeExit guard([&]{ for (auto &node : program) delete node; });
 
             while (this->m_curr->type != endTokenType || (*this->m_curr) != value) {
                 program.push_back(parseStatement());
@@ -99,8 +118,6 @@ namespace hex::lang {
 
             this->m_curr++;
 
-            guard.release();
-
             return program;
         }
 
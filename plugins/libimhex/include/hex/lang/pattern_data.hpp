@@ -5,17 +5,24 @@
 #include <imgui.h>
 
 #include <hex/providers/provider.hpp>
+#include <hex/helpers/arena.hpp>
+#include <hex/helpers/lang.hpp>
 #include <hex/helpers/utils.hpp>
 #include <hex/lang/token.hpp>
 #include <hex/views/view.hpp>
 
 #include <cstring>
+#include <limits>
+#include <numeric>
 #include <random>
 #include <string>
+#include <thread>
+#include <variant>
 
 namespace hex::lang {
 
     using namespace ::std::literals::string_literals;
+    using namespace hex::lang_literals;
 
     namespace {
 
@@ -36,15 +43,95 @@ namespace hex::lang {
 
     }
 
+    /* A range of highlighted bytes [start, end). Earlier entries in a list take priority over later ones where they overlap */
+    struct HighlightRange {
+        u64 start, end;
+        u32 color;
+    };
+
+    class PatternData;
+
+    /* Value of a pattern in the column the pattern data table is sorted by */
+    struct SortKey {
+        std::variant<u64, const std::string*, std::vector<u8>> value;
+        bool nativeEndian = true;
+
+        enum class Column { None, Name, Offset, Size, Value, Type, Color };
+
+        static Column getColumn(ImGuiID columnId) {
+            if (columnId == ImGui::GetID("name"))           return Column::Name;
+            else if (columnId == ImGui::GetID("offset"))    return Column::Offset;
+            else if (columnId == ImGui::GetID("size"))      return Column::Size;
+            else if (columnId == ImGui::GetID("value"))     return Column::Value;
+            else if (columnId == ImGui::GetID("type"))      return Column::Type;
+            else if (columnId == ImGui::GetID("color"))     return Column::Color;
+            else                                            return Column::None;
+        }
+
+        static SortKey create(Column column, prv::Provider *provider, PatternData *pattern);
+
+        static bool compare(const SortKey &left, const SortKey &right) {
+            if (left.value.index() != right.value.index())
+                return left.value.index() < right.value.index();
+
+            if (auto leftString = std::get_if<const std::string*>(&left.value); leftString != nullptr)
+                return **leftString < *std::get<const std::string*>(right.value);
+            else if (auto leftBytes = std::get_if<std::vector<u8>>(&left.value); leftBytes != nullptr)
+                return compareBytes(left, *leftBytes, right, std::get<std::vector<u8>>(right.value));
+            else
+                return std::get<u64>(left.value) < std::get<u64>(right.value);
+        }
+
+    private:
+        /*
+            Values are compared as if both were zero extended to the bigger size, with non-native ones reversed afterwards.
+            Non-native values therefore end up aligned to the right and native ones to the left
+        */
+        static bool compareBytes(const SortKey &left, const std::vector<u8> &leftBytes, const SortKey &right, const std::vector<u8> &rightBytes) {
+            size_t biggerSize = std::max(leftBytes.size(), rightBytes.size());
+
+            auto byteAt = [biggerSize](const SortKey &key, const std::vector<u8> &bytes, size_t index) -> u8 {
+                if (key.nativeEndian)
+                    return index < bytes.size() ? bytes[index] : 0x00;
+                else
+                    return index >= biggerSize - bytes.size() ? bytes[biggerSize - 1 - index] : 0x00;
+            };
+
+            for (size_t i = 0; i < biggerSize; i++) {
+                auto leftByte = byteAt(left, leftBytes, i), rightByte = byteAt(right, rightBytes, i);
+                if (leftByte != rightByte)
+                    return leftByte < rightByte;
+            }
+
+            return false;
+        }
+    };
+
+    /*
+        Patterns don't own the patterns they contain. All patterns of an evaluation are owned by the evaluator's arena,
+        clones get created in an arena too, together with copies of all patterns they contain
+    */
     class PatternData {
     public:
+        constexpr static size_t ParallelSortThreshold = 0x1'0000;
+        constexpr static u32 Palette[] = { 0x70b4771f, 0x700e7fff, 0x702ca02c, 0x702827d6, 0x70bd6794, 0x704b568c, 0x70c277e3, 0x707f7f7f, 0x7022bdbc, 0x70cfbe17 };
+
+        /*
+            Set while evaluating on a worker thread. Patterns created there get numbered placeholder colors without an alpha channel,
+            which are swapped for palette colors once their results are merged in declaration order
+        */
+        static inline thread_local u32 *placeholderColorCount = nullptr;
+
         PatternData(u64 offset, size_t size, u32 color = 0)
         : m_offset(offset), m_size(size), m_color(color) {
-            constexpr u32 Palette[] = { 0x70b4771f, 0x700e7fff, 0x702ca02c, 0x702827d6, 0x70bd6794, 0x704b568c, 0x70c277e3, 0x707f7f7f, 0x7022bdbc, 0x70cfbe17 };
-
             if (color != 0)
                 return;
 
+            if (placeholderColorCount != nullptr) {
+                this->m_color = ++(*placeholderColorCount);
+                return;
+            }
+
             this->m_color = Palette[SharedData::patternPaletteOffset++];
 
             if (SharedData::patternPaletteOffset >= (sizeof(Palette) / sizeof(u32)))
@@ -52,9 +139,14 @@ namespace hex::lang {
         }
         virtual ~PatternData() = default;
 
-        virtual PatternData* clone() = 0;
+        virtual PatternData* clone(Arena &arena) const = 0;
 
         [[nodiscard]] u64 getOffset() const { return this->m_offset; }
+        virtual void setOffset(u64 offset) {
+            this->m_offset = offset;
+            this->m_highlightedAddresses.clear();
+            this->m_cachedValueValid = false;
+        }
         [[nodiscard]] size_t getSize() const { return this->m_size; }
 
         [[nodiscard]] const std::string& getVariableName() const { return this->m_variableName; }
@@ -63,8 +155,9 @@ namespace hex::lang {
         [[nodiscard]] const std::optional<std::string>& getComment() const { return this->m_comment; }
         void setComment(std::string comment) { this->m_comment = std::move(comment); }
 
-        [[nodiscard]] const std::string& getTypeName() const { return this->m_typeName; }
-        void setTypeName(std::string name) { this->m_typeName = std::move(name); }
+        /* Type names aren't owned by the patterns, all patterns of a type point to the same name */
+        [[nodiscard]] const std::string& getTypeName() const { return *this->m_typeName; }
+        void setTypeName(const std::string *name) { this->m_typeName = name; }
 
         [[nodiscard]] u32 getColor() const { return this->m_color; }
         void setColor(u32 color) { this->m_color = color; }
@@ -72,9 +165,39 @@ namespace hex::lang {
         [[nodiscard]] std::endian getEndian() const { return this->m_endian; }
         void setEndian(std::endian endian) { this->m_endian = endian; }
 
+        /* Set by the entry_point attribute, the disassembler starts decoding code from these patterns */
+        [[nodiscard]] bool isEntryPoint() const { return this->m_entryPoint; }
+        void setEntryPoint(bool entryPoint) { this->m_entryPoint = entryPoint; }
+
         virtual void createEntry(prv::Provider* &provider) = 0;
+        [[nodiscard]] virtual bool isExpandable() const { return false; }
+        [[nodiscard]] virtual bool isHidden() const { return false; }
         [[nodiscard]] virtual std::string getFormattedName() const = 0;
 
+        /* Formats the value of builtin types from bytes that were already converted to native endianess */
+        [[nodiscard]] virtual std::optional<std::string> formatValue(const u8 *data) const { return std::nullopt; }
+
+        /* Sets the value shown the next time the pattern gets drawn, for values that were decoded elsewhere */
+        void setCachedValue(std::string_view value) {
+            this->m_cachedValue.assign(value);
+            this->m_cachedValueValid = true;
+            this->m_cachedValueGeneration = PatternData::s_valueCacheGeneration;
+        }
+
+        /* The value shown when the pattern was drawn last, if it's still up to date */
+        [[nodiscard]] const std::string* getDisplayedValue() const {
+            if (!this->m_cachedValueValid || this->m_cachedValueGeneration != PatternData::s_valueCacheGeneration)
+                return nullptr;
+
+            return &this->m_cachedValue;
+        }
+
+        /* Makes patterns whose bytes overlap the region format their value again the next time they get drawn */
+        virtual void invalidateValues(const Region &region) {
+            if (region.address < this->getOffset() + this->getSize() && region.address + region.size > this->getOffset())
+                this->m_cachedValueValid = false;
+        }
+
         virtual std::optional<u32> highlightBytes(size_t offset) {
             auto currOffset = this->getOffset();
             if (offset >= currOffset && offset < (currOffset + this->getSize()))
@@ -83,77 +206,148 @@ namespace hex::lang {
                 return { };
         }
 
-        virtual std::map<u64, u32> getHighlightedAddresses() {
-            if (this->m_highlightedAddresses.empty()) {
-                for (u64 i = 0; i < this->getSize(); i++)
-                    this->m_highlightedAddresses.insert({ this->getOffset() + i, this->getColor() });
-            }
+        virtual const std::vector<HighlightRange>& getHighlightedAddresses() {
+            if (this->m_highlightedAddresses.empty() && this->getSize() > 0)
+                this->m_highlightedAddresses.push_back({ this->getOffset(), this->getOffset() + this->getSize(), this->getColor() });
 
             return this->m_highlightedAddresses;
         }
 
         virtual void sort(ImGuiTableSortSpecs *sortSpecs, prv::Provider *provider) { }
 
-        static bool sortPatternDataTable(ImGuiTableSortSpecs *sortSpecs, prv::Provider *provider, lang::PatternData* left, lang::PatternData* right) {
-            if (sortSpecs->Specs->ColumnUserID == ImGui::GetID("name")) {
-                if (sortSpecs->Specs->SortDirection == ImGuiSortDirection_Ascending)
-                    return left->getVariableName() > right->getVariableName();
-                else
-                    return left->getVariableName() < right->getVariableName();
-            }
-            else if (sortSpecs->Specs->ColumnUserID == ImGui::GetID("offset")) {
-                if (sortSpecs->Specs->SortDirection == ImGuiSortDirection_Ascending)
-                    return left->getOffset() > right->getOffset();
-                else
-                    return left->getOffset() < right->getOffset();
-            }
-            else if (sortSpecs->Specs->ColumnUserID == ImGui::GetID("size")) {
-                if (sortSpecs->Specs->SortDirection == ImGuiSortDirection_Ascending)
-                    return left->getSize() > right->getSize();
-                else
-                    return left->getSize() < right->getSize();
-            }
-            else if (sortSpecs->Specs->ColumnUserID == ImGui::GetID("value")) {
-                size_t biggerSize = std::max(left->getSize(), right->getSize());
-                std::vector<u8> leftBuffer(biggerSize, 0x00), rightBuffer(biggerSize, 0x00);
+        /*
+            Sorts patterns by the column selected in the pattern data table. The value of every pattern in that column is extracted once up front,
+            so comparisons don't need to read from the provider. Large lists get their keys extracted and sorted in chunks on multiple threads
+        */
+        static void sortPatterns(ImGuiTableSortSpecs *sortSpecs, prv::Provider *provider, std::vector<PatternData*> &patterns) {
+            if (sortSpecs == nullptr || sortSpecs->SpecsCount == 0 || patterns.size() < 2)
+                return;
 
-                provider->read(left->getOffset(), leftBuffer.data(), left->getSize());
-                provider->read(right->getOffset(), rightBuffer.data(), right->getSize());
+            // Looking up column IDs depends on ImGui's state, so that can only be done here and not on the worker threads
+            auto column = SortKey::getColumn(sortSpecs->Specs->ColumnUserID);
+            if (column == SortKey::Column::None)
+                return;
 
-                if (left->m_endian != std::endian::native)
-                    std::reverse(leftBuffer.begin(), leftBuffer.end());
-                if (right->m_endian != std::endian::native)
-                    std::reverse(rightBuffer.begin(), rightBuffer.end());
+            bool ascending = sortSpecs->Specs->SortDirection == ImGuiSortDirection_Ascending;
 
-                if (sortSpecs->Specs->SortDirection == ImGuiSortDirection_Ascending)
-                    return leftBuffer > rightBuffer;
-                else
-                    return leftBuffer < rightBuffer;
-            }
-            else if (sortSpecs->Specs->ColumnUserID == ImGui::GetID("type")) {
-                if (sortSpecs->Specs->SortDirection == ImGuiSortDirection_Ascending)
-                    return left->getTypeName() > right->getTypeName();
-                else
-                    return left->getTypeName() < right->getTypeName();
-            }
-            else if (sortSpecs->Specs->ColumnUserID == ImGui::GetID("color")) {
-                if (sortSpecs->Specs->SortDirection == ImGuiSortDirection_Ascending)
-                    return left->getColor() > right->getColor();
-                else
-                    return left->getColor() < right->getColor();
+            std::vector<SortKey> keys(patterns.size());
+            std::vector<u32> order(patterns.size());
+            std::iota(order.begin(), order.end(), 0);
+
+            auto compare = [&](u32 left, u32 right) {
+                return ascending ? SortKey::compare(keys[right], keys[left]) : SortKey::compare(keys[left], keys[right]);
+            };
+
+            auto sortRange = [&](size_t start, size_t end) {
+                for (size_t i = start; i < end; i++)
+                    keys[i] = SortKey::create(column, provider, patterns[i]);
+
+                std::stable_sort(order.begin() + start, order.begin() + end, compare);
+            };
+
+            size_t chunkCount = 1;
+            if (patterns.size() >= ParallelSortThreshold)
+                chunkCount = std::clamp<size_t>(std::thread::hardware_concurrency(), 1, patterns.size() / (ParallelSortThreshold / 2));
+
+            if (chunkCount == 1)
+                sortRange(0, patterns.size());
+            else {
+                std::vector<size_t> bounds;
+                for (size_t i = 0; i <= chunkCount; i++)
+                    bounds.push_back(patterns.size() * i / chunkCount);
+
+                std::vector<std::thread> threads;
+                for (size_t i = 0; i < chunkCount; i++)
+                    threads.emplace_back(sortRange, bounds[i], bounds[i + 1]);
+
+                for (auto &thread : threads)
+                    thread.join();
+
+                // Merge neighbouring chunks until only one sorted run is left
+                for (size_t width = 1; width < chunkCount; width *= 2) {
+                    for (size_t i = 0; i + width < chunkCount; i += width * 2)
+                        std::inplace_merge(order.begin() + bounds[i], order.begin() + bounds[i + width], order.begin() + bounds[std::min(i + width * 2, chunkCount)], compare);
+                }
             }
 
-            return false;
+            std::vector<PatternData*> sorted;
+            sorted.reserve(patterns.size());
+            for (auto index : order)
+                sorted.push_back(patterns[index]);
+
+            patterns = std::move(sorted);
         }
 
         static void resetPalette() { SharedData::patternPaletteOffset = 0; }
 
+        /* Makes every pattern format its value again the next time it gets drawn, e.g. after the data changed */
+        static void invalidateValueCache() { PatternData::s_valueCacheGeneration++; }
+
     protected:
+        constexpr static u64 DisplayChunkSize = 50;
+
+        /* Formatted values are kept until the pattern is moved or the value cache gets invalidated */
+        template<typename Formatter>
+        const std::string& getCachedValue(Formatter &&formatter) {
+            if (this->getDisplayedValue() == nullptr) {
+                this->m_cachedValue = formatter();
+                this->m_cachedValueValid = true;
+                this->m_cachedValueGeneration = PatternData::s_valueCacheGeneration;
+            }
+
+            return this->m_cachedValue;
+        }
+
+        [[nodiscard]] static u64 getValueCacheGeneration() { return PatternData::s_valueCacheGeneration; }
+
+        /* Rows are told apart by the offset of their pattern. Hashing the offset directly doesn't need to build an ID string every frame */
+        bool drawRowSelectable(ImGuiSelectableFlags flags) const {
+            u64 offset = this->getOffset();
+
+            ImGui::PushID(reinterpret_cast<const char*>(&offset), reinterpret_cast<const char*>(&offset) + sizeof(offset));
+            bool clicked = ImGui::Selectable("##PatternDataLine", false, flags);
+            ImGui::PopID();
+
+            return clicked;
+        }
+
+        /*
+            Draws the entries of an opened pattern. If none of them can be expanded all rows have the same height and only the visible ones are drawn,
+            otherwise the entries are shown in chunks
+        */
+        static void createEntries(prv::Provider* &provider, const std::vector<PatternData*> &entries, bool leafEntries, u64 &displayEnd) {
+            if (leafEntries) {
+                ImGuiListClipper clipper;
+                clipper.Begin(std::min<u64>(entries.size(), std::numeric_limits<int>::max()));
+
+                while (clipper.Step()) {
+                    for (u64 i = clipper.DisplayStart; i < clipper.DisplayEnd; i++)
+                        entries[i]->createEntry(provider);
+                }
+            } else {
+                auto end = std::min<u64>(displayEnd, entries.size());
+                for (u64 i = 0; i < end; i++)
+                    entries[i]->createEntry(provider);
+
+                if (end < entries.size()) {
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+                    if (ImGui::Selectable(hex::format("hex.view.pattern_data.more_entries"_lang, entries.size() - end).c_str(), false, ImGuiSelectableFlags_SpanAllColumns))
+                        displayEnd += DisplayChunkSize;
+                }
+            }
+        }
+
+        /* Whether every entry takes up exactly one row in the table */
+        static bool areLeafEntries(const std::vector<PatternData*> &entries) {
+            return std::none_of(entries.begin(), entries.end(), [](auto entry) { return entry->isExpandable() || entry->isHidden(); });
+        }
+
         void createDefaultEntry(std::string_view value) const {
             ImGui::TableNextRow();
             ImGui::TreeNodeEx(this->getVariableName().c_str(), ImGuiTreeNodeFlags_Leaf | ImGuiTreeNodeFlags_NoTreePushOnOpen | ImGuiTreeNodeFlags_SpanFullWidth | ImGuiTreeNodeFlags_AllowItemOverlap);
             ImGui::TableNextColumn();
-            if (ImGui::Selectable(("##PatternDataLine"s + std::to_string(this->getOffset())).c_str(), false, ImGuiSelectableFlags_SpanAllColumns | ImGuiSelectableFlags_AllowItemOverlap)) {
+            if (this->drawRowSelectable(ImGuiSelectableFlags_SpanAllColumns | ImGuiSelectableFlags_AllowItemOverlap)) {
                 Region selectRegion = { this->getOffset(), this->getSize() };
                 View::postEvent(Events::SelectionChangeRequest, selectRegion);
             }
@@ -169,7 +363,7 @@ namespace hex::lang {
             ImGui::TableNextColumn();
             ImGui::TextColored(ImColor(0xFF9BC64D), "%s", this->getFormattedName().c_str());
             ImGui::TableNextColumn();
-            ImGui::Text("%s", value.data());
+            ImGui::TextUnformatted(value.data(), value.data() + value.size());
         }
 
         void drawCommentTooltip() const {
@@ -182,24 +376,64 @@ namespace hex::lang {
 
     protected:
         std::endian m_endian = std::endian::native;
-        std::map<u64, u32> m_highlightedAddresses;
+        std::vector<HighlightRange> m_highlightedAddresses;
+
+        void addHighlightedAddresses(const std::vector<HighlightRange> &ranges) {
+            for (const auto &range : ranges) {
+                // Coalesce directly adjacent ranges of the same color, e.g. the entries of an array
+                if (!this->m_highlightedAddresses.empty()) {
+                    auto &last = this->m_highlightedAddresses.back();
+                    if (last.end == range.start && last.color == range.color) {
+                        last.end = range.end;
+                        continue;
+                    }
+                }
+
+                this->m_highlightedAddresses.push_back(range);
+            }
+        }
 
     private:
+        static inline u64 s_valueCacheGeneration = 0;
+        static inline const std::string s_noTypeName;
+
+        std::string m_cachedValue;
+        u64 m_cachedValueGeneration = 0;
+        bool m_cachedValueValid = false;
+
         u64 m_offset;
         size_t m_size;
 
         u32 m_color;
         std::string m_variableName;
         std::optional<std::string> m_comment;
-        std::string m_typeName;
+        bool m_entryPoint = false;
+        const std::string *m_typeName = &PatternData::s_noTypeName;
     };
 
+    inline SortKey SortKey::create(Column column, prv::Provider *provider, PatternData *pattern) {
+        switch (column) {
+            case Column::Name:      return { &pattern->getVariableName() };
+            case Column::Offset:    return { pattern->getOffset() };
+            case Column::Size:      return { pattern->getSize() };
+            case Column::Type:      return { &pattern->getTypeName() };
+            case Column::Color:     return { pattern->getColor() };
+            case Column::Value: {
+                std::vector<u8> buffer(pattern->getSize(), 0x00);
+                provider->read(pattern->getOffset(), buffer.data(), buffer.size());
+
+                return { std::move(buffer), pattern->getEndian() == std::endian::native };
+            }
+            default:                return { };
+        }
+    }
+
     class PatternDataPadding : public PatternData {
     public:
         PatternDataPadding(u64 offset, size_t size) : PatternData(offset, size, 0xFF000000) { }
 
-        PatternData* clone() override {
-            return new PatternDataPadding(*this);
+        PatternData* clone(Arena &arena) const override {
+            return arena.create<PatternDataPadding>(*this);
         }
 
         void createEntry(prv::Provider* &provider) override {
@@ -208,31 +442,42 @@ namespace hex::lang {
         [[nodiscard]] std::string getFormattedName() const override {
             return "";
         }
+
+        [[nodiscard]] bool isHidden() const override { return true; }
     };
 
+    /*
+        Pointers to the same data and type share the pattern they point at. The pointed at pattern is null if the pointer leads back
+        into one of the patterns containing it, the pointer's type name is the one of its target then
+    */
     class PatternDataPointer : public PatternData {
     public:
         PatternDataPointer(u64 offset, size_t size, PatternData *pointedAt, u32 color = 0)
         : PatternData(offset, size, color), m_pointedAt(pointedAt) {
-            this->m_pointedAt->setVariableName("*" + this->m_pointedAt->getVariableName());
+            if (this->m_pointedAt != nullptr && !this->m_pointedAt->getVariableName().starts_with('*'))
+                this->m_pointedAt->setVariableName("*" + this->m_pointedAt->getVariableName());
         }
 
-        ~PatternDataPointer() override {
-            delete this->m_pointedAt;
-        }
+        PatternData* clone(Arena &arena) const override {
+            auto pattern = arena.create<PatternDataPointer>(*this);
+            if (this->m_pointedAt != nullptr)
+                pattern->m_pointedAt = this->m_pointedAt->clone(arena);
 
-        PatternData* clone() override {
-            return new PatternDataPointer(*this);
+            return pattern;
         }
 
         void createEntry(prv::Provider* &provider) override {
-            u64 data = 0;
-            provider->read(this->getOffset(), &data, this->getSize());
-            data = hex::changeEndianess(data, this->getSize(), this->getEndian());
+            const auto &value = this->getCachedValue([&] {
+                u64 data = 0;
+                provider->read(this->getOffset(), &data, this->getSize());
+                data = hex::changeEndianess(data, this->getSize(), this->getEndian());
+
+                return hex::format("*(0x{0:X})", data);
+            });
 
             ImGui::TableNextRow();
             ImGui::TableNextColumn();
-            bool open = ImGui::TreeNodeEx(this->getVariableName().c_str(), ImGuiTreeNodeFlags_SpanFullWidth | ImGuiTreeNodeFlags_AllowItemOverlap);
+            bool open = ImGui::TreeNodeEx(this->getVariableName().c_str(), ImGuiTreeNodeFlags_SpanFullWidth | ImGuiTreeNodeFlags_AllowItemOverlap | (this->m_pointedAt == nullptr ? ImGuiTreeNodeFlags_Leaf : 0));
             this->drawCommentTooltip();
             ImGui::TableNextColumn();
             ImGui::ColorButton("color", ImColor(this->getColor()), ImGuiColorEditFlags_NoTooltip, ImVec2(ImGui::GetColumnWidth(), ImGui::GetTextLineHeight()));
@@ -241,11 +486,13 @@ namespace hex::lang {
             ImGui::TableNextColumn();
             ImGui::Text("0x%04llX", this->getSize());
             ImGui::TableNextColumn();
-            ImGui::TextColored(ImColor(0xFF9BC64D), "%s*", this->m_pointedAt->getFormattedName().c_str());
+            ImGui::TextColored(ImColor(0xFF9BC64D), "%s*", this->m_pointedAt != nullptr ? this->m_pointedAt->getFormattedName().c_str() : this->getTypeName().c_str());
             ImGui::TableNextColumn();
-            ImGui::Text("*(0x%llX)", data);
+            ImGui::TextUnformatted(value.c_str());
 
-            if (open) {
+            if (open && this->m_pointedAt == nullptr)
+                ImGui::TreePop();
+            else if (open) {
                 this->m_pointedAt->createEntry(provider);
 
                 ImGui::TreePop();
@@ -255,27 +502,35 @@ namespace hex::lang {
         std::optional<u32> highlightBytes(size_t offset) override {
             if (offset >= this->getOffset() && offset < (this->getOffset() + this->getSize()))
                 return this->getColor();
+            else if (this->m_pointedAt == nullptr)
+                return { };
             else if (auto color = this->m_pointedAt->highlightBytes(offset); color.has_value())
                 return color.value();
             else
                 return { };
         }
 
-        std::map<u64, u32> getHighlightedAddresses() override {
+        const std::vector<HighlightRange>& getHighlightedAddresses() override {
             if (this->m_highlightedAddresses.empty()) {
-                auto ownAddresses = PatternData::getHighlightedAddresses();
-                auto pointedToAddresses = this->m_pointedAt->getHighlightedAddresses();
-
-                ownAddresses.merge(pointedToAddresses);
-                this->m_highlightedAddresses = ownAddresses;
+                PatternData::getHighlightedAddresses();
+                if (this->m_pointedAt != nullptr)
+                    this->addHighlightedAddresses(this->m_pointedAt->getHighlightedAddresses());
             }
 
             return this->m_highlightedAddresses;
         }
+        void invalidateValues(const Region &region) override {
+            PatternData::invalidateValues(region);
+            if (this->m_pointedAt != nullptr)
+                this->m_pointedAt->invalidateValues(region);
+        }
+
         [[nodiscard]] std::string getFormattedName() const override {
             return "Pointer";
         }
 
+        [[nodiscard]] bool isExpandable() const override { return this->m_pointedAt != nullptr; }
+
         [[nodiscard]] PatternData* getPointedAtPattern() {
             return this->m_pointedAt;
         }
@@ -289,16 +544,25 @@ namespace hex::lang {
         PatternDataUnsigned(u64 offset, size_t size, u32 color = 0)
             : PatternData(offset, size, color) { }
 
-        PatternData* clone() override {
-            return new PatternDataUnsigned(*this);
+        PatternData* clone(Arena &arena) const override {
+            return arena.create<PatternDataUnsigned>(*this);
         }
 
         void createEntry(prv::Provider* &provider) override {
-            u64 data = 0;
-            provider->read(this->getOffset(), &data, this->getSize());
-            data = hex::changeEndianess(data, this->getSize(), this->getEndian());
+            this->createDefaultEntry(this->getCachedValue([&] {
+                u64 data = 0;
+                provider->read(this->getOffset(), &data, this->getSize());
+                data = hex::changeEndianess(data, this->getSize(), this->getEndian());
+
+                return *this->formatValue(reinterpret_cast<const u8*>(&data));
+            }));
+        }
+
+        [[nodiscard]] std::optional<std::string> formatValue(const u8 *data) const override {
+            u64 value = 0;
+            std::memcpy(&value, data, std::min(this->getSize(), sizeof(value)));
 
-            this->createDefaultEntry(hex::format("{:d} (0x{:0{}X})", data, data, this->getSize() * 2));
+            return hex::format("{:d} (0x{:0{}X})", value, value, this->getSize() * 2);
         }
 
         [[nodiscard]] std::string getFormattedName() const override {
@@ -318,18 +582,27 @@ namespace hex::lang {
         PatternDataSigned(u64 offset, size_t size, u32 color = 0)
             : PatternData(offset, size, color) { }
 
-        PatternData* clone() override {
-            return new PatternDataSigned(*this);
+        PatternData* clone(Arena &arena) const override {
+            return arena.create<PatternDataSigned>(*this);
+        }
+
+        void createEntry(prv::Provider* &provider) override {
+            this->createDefaultEntry(this->getCachedValue([&] {
+                u64 data = 0;
+                provider->read(this->getOffset(), &data, this->getSize());
+                data = hex::changeEndianess(data, this->getSize(), this->getEndian());
+
+                return *this->formatValue(reinterpret_cast<const u8*>(&data));
+            }));
         }
 
-       void createEntry(prv::Provider* &provider) override {
-            u64 data = 0;
-            provider->read(this->getOffset(), &data, this->getSize());
-            data = hex::changeEndianess(data, this->getSize(), this->getEndian());
+        [[nodiscard]] std::optional<std::string> formatValue(const u8 *data) const override {
+            u64 value = 0;
+            std::memcpy(&value, data, std::min(this->getSize(), sizeof(value)));
 
-            s64 signedData = hex::signExtend(data, this->getSize(), 64);
+            s64 signedValue = hex::signExtend(value, this->getSize(), 64);
 
-           this->createDefaultEntry(hex::format("{:d} (0x{:0{}X})", signedData, data, this->getSize() * 2));
+            return hex::format("{:d} (0x{:0{}X})", signedValue, value, this->getSize() * 2);
         }
 
         [[nodiscard]] std::string getFormattedName() const override {
@@ -349,24 +622,36 @@ namespace hex::lang {
         PatternDataFloat(u64 offset, size_t size, u32 color = 0)
             : PatternData(offset, size, color) { }
 
-        PatternData* clone() override {
-            return new PatternDataFloat(*this);
+        PatternData* clone(Arena &arena) const override {
+            return arena.create<PatternDataFloat>(*this);
         }
 
         void createEntry(prv::Provider* &provider) override {
+            if (this->getSize() != 4 && this->getSize() != 8)
+                return;
+
+            this->createDefaultEntry(this->getCachedValue([&] {
+                u64 data = 0;
+                provider->read(this->getOffset(), &data, this->getSize());
+                hex::changeEndianess(&data, 1, this->getSize(), this->getEndian());
+
+                return *this->formatValue(reinterpret_cast<const u8*>(&data));
+            }));
+        }
+
+        [[nodiscard]] std::optional<std::string> formatValue(const u8 *data) const override {
             if (this->getSize() == 4) {
-                u32 data = 0;
-                provider->read(this->getOffset(), &data, 4);
-                data = hex::changeEndianess(data, 4, this->getEndian());
+                u32 value = 0;
+                std::memcpy(&value, data, 4);
 
-                this->createDefaultEntry(hex::format("{:e} (0x{:0{}X})", *reinterpret_cast<float*>(&data), data, this->getSize() * 2));
+                return hex::format("{:e} (0x{:0{}X})", *reinterpret_cast<float*>(&value), value, this->getSize() * 2);
             } else if (this->getSize() == 8) {
-                u64 data = 0;
-                provider->read(this->getOffset(), &data, 8);
-                data = hex::changeEndianess(data, 8, this->getEndian());
+                u64 value = 0;
+                std::memcpy(&value, data, 8);
 
-                this->createDefaultEntry(hex::format("{:e} (0x{:0{}X})", *reinterpret_cast<double*>(&data), data, this->getSize() * 2));
-            }
+                return hex::format("{:e} (0x{:0{}X})", *reinterpret_cast<double*>(&value), value, this->getSize() * 2);
+            } else
+                return std::nullopt;
         }
 
         [[nodiscard]] std::string getFormattedName() const override {
@@ -383,20 +668,22 @@ namespace hex::lang {
         explicit PatternDataBoolean(u64 offset, u32 color = 0)
                 : PatternData(offset, 1, color) { }
 
-        PatternData* clone() override {
-            return new PatternDataBoolean(*this);
+        PatternData* clone(Arena &arena) const override {
+            return arena.create<PatternDataBoolean>(*this);
         }
 
         void createEntry(prv::Provider* &provider) override {
-            u8 boolean;
-            provider->read(this->getOffset(), &boolean, 1);
-
-            if (boolean == 0)
-                this->createDefaultEntry("false");
-            else if (boolean == 1)
-                this->createDefaultEntry("true");
-            else
-                this->createDefaultEntry("true*");
+            this->createDefaultEntry(this->getCachedValue([&] {
+                u8 boolean;
+                provider->read(this->getOffset(), &boolean, 1);
+
+                if (boolean == 0)
+                    return "false"s;
+                else if (boolean == 1)
+                    return "true"s;
+                else
+                    return "true*"s;
+            }));
         }
 
         [[nodiscard]] std::string getFormattedName() const override {
@@ -409,15 +696,17 @@ namespace hex::lang {
         explicit PatternDataCharacter(u64 offset, u32 color = 0)
             : PatternData(offset, 1, color) { }
 
-        PatternData* clone() override {
-            return new PatternDataCharacter(*this);
+        PatternData* clone(Arena &arena) const override {
+            return arena.create<PatternDataCharacter>(*this);
         }
 
         void createEntry(prv::Provider* &provider) override {
-            char character;
-            provider->read(this->getOffset(), &character, 1);
+            this->createDefaultEntry(this->getCachedValue([&] {
+                char character;
+                provider->read(this->getOffset(), &character, 1);
 
-            this->createDefaultEntry(hex::format("'{0}'", character));
+                return hex::format("'{0}'", character);
+            }));
         }
 
         [[nodiscard]] std::string getFormattedName() const override {
@@ -430,16 +719,18 @@ namespace hex::lang {
         PatternDataString(u64 offset, size_t size, u32 color = 0)
             : PatternData(offset, size, color) { }
 
-        PatternData* clone() override {
-            return new PatternDataString(*this);
+        PatternData* clone(Arena &arena) const override {
+            return arena.create<PatternDataString>(*this);
         }
 
         void createEntry(prv::Provider* &provider) override {
-            std::vector<u8> buffer(this->getSize() + 1, 0x00);
-            provider->read(this->getOffset(), buffer.data(), this->getSize());
-            buffer[this->getSize()] = '\0';
+            this->createDefaultEntry(this->getCachedValue([&] {
+                std::vector<u8> buffer(this->getSize() + 1, 0x00);
+                provider->read(this->getOffset(), buffer.data(), this->getSize());
+                buffer[this->getSize()] = '\0';
 
-            this->createDefaultEntry(hex::format("\"{0}\"", makeDisplayable(buffer.data(), this->getSize()).c_str()));
+                return hex::format("\"{0}\"", makeDisplayable(buffer.data(), this->getSize()).c_str());
+            }));
         }
 
         [[nodiscard]] std::string getFormattedName() const override {
@@ -454,20 +745,27 @@ namespace hex::lang {
 
             for (auto &entry : entries)
                 entry->setColor(color);
+
+            this->m_leafEntries = PatternData::areLeafEntries(this->m_entries);
         }
 
-        PatternDataArray(const PatternDataArray &other) : PatternData(other.getOffset(), other.getSize(), other.getColor()) {
-            for (const auto &entry : other.m_entries)
-                this->m_entries.push_back(entry->clone());
+        PatternData* clone(Arena &arena) const override {
+            auto pattern = arena.create<PatternDataArray>(*this);
+            for (auto &entry : pattern->m_entries)
+                entry = entry->clone(arena);
+
+            return pattern;
         }
 
-        ~PatternDataArray() override {
-            for (const auto &entry : this->m_entries)
-                delete entry;
+        [[nodiscard]] const std::vector<PatternData*>& getEntries() const {
+            return this->m_entries;
         }
 
-        PatternData* clone() override {
-            return new PatternDataArray(*this);
+        void setOffset(u64 offset) override {
+            for (auto &entry : this->m_entries)
+                entry->setOffset(entry->getOffset() - this->getOffset() + offset);
+
+            PatternData::setOffset(offset);
         }
 
         void createEntry(prv::Provider* &provider) override {
@@ -498,8 +796,7 @@ namespace hex::lang {
             ImGui::Text("%s", "{ ... }");
 
             if (open) {
-                for (auto &member : this->m_entries)
-                    member->createEntry(provider);
+                PatternData::createEntries(provider, this->m_entries, this->m_leafEntries, this->m_displayEnd);
 
                 ImGui::TreePop();
             }
@@ -514,40 +811,55 @@ namespace hex::lang {
             return { };
         }
 
-        std::map<u64, u32> getHighlightedAddresses() override {
+        const std::vector<HighlightRange>& getHighlightedAddresses() override {
             if (this->m_highlightedAddresses.empty()) {
                 for (auto &entry : this->m_entries) {
-                    this->m_highlightedAddresses.merge(entry->getHighlightedAddresses());
+                    this->addHighlightedAddresses(entry->getHighlightedAddresses());
                 }
             }
 
             return this->m_highlightedAddresses;
         }
+        void invalidateValues(const Region &region) override {
+            PatternData::invalidateValues(region);
+
+            for (auto &entry : this->m_entries)
+                entry->invalidateValues(region);
+        }
+
         [[nodiscard]] std::string getFormattedName() const override {
             return this->m_entries[0]->getTypeName() + "[" + std::to_string(this->m_entries.size()) + "]";
         }
 
+        [[nodiscard]] bool isExpandable() const override { return true; }
+
     private:
         std::vector<PatternData*> m_entries;
+        bool m_leafEntries;
+        u64 m_displayEnd = DisplayChunkSize;
     };
 
     class PatternDataStruct : public PatternData {
     public:
         PatternDataStruct(u64 offset, size_t size, const std::vector<PatternData*> & members, u32 color = 0)
-                : PatternData(offset, size, color), m_members(members), m_sortedMembers(members) { }
-
-        PatternDataStruct(const PatternDataStruct &other) : PatternData(other.getOffset(), other.getSize(), other.getColor()) {
-            for (const auto &member : other.m_members)
-                this->m_members.push_back(member->clone());
+                : PatternData(offset, size, color), m_members(members), m_sortedMembers(members) {
+            this->m_leafMembers = PatternData::areLeafEntries(this->m_members);
         }
 
-        ~PatternDataStruct() override {
-            for (const auto &member : this->m_members)
-                delete member;
+        PatternData* clone(Arena &arena) const override {
+            auto pattern = arena.create<PatternDataStruct>(*this);
+            for (auto &member : pattern->m_members)
+                member = member->clone(arena);
+            pattern->m_sortedMembers = pattern->m_members;
+
+            return pattern;
         }
 
-        PatternData* clone() override {
-            return new PatternDataStruct(*this);
+        void setOffset(u64 offset) override {
+            for (auto &member : this->m_members)
+                member->setOffset(member->getOffset() - this->getOffset() + offset);
+
+            PatternData::setOffset(offset);
         }
 
         void createEntry(prv::Provider* &provider) override {
@@ -566,8 +878,7 @@ namespace hex::lang {
             ImGui::Text("%s", "{ ... }");
 
             if (open) {
-                for (auto &member : this->m_sortedMembers)
-                    member->createEntry(provider);
+                PatternData::createEntries(provider, this->m_sortedMembers, this->m_leafMembers, this->m_displayEnd);
 
                 ImGui::TreePop();
             }
@@ -583,22 +894,28 @@ namespace hex::lang {
             return { };
         }
 
-        std::map<u64, u32> getHighlightedAddresses() override {
+        const std::vector<HighlightRange>& getHighlightedAddresses() override {
             if (this->m_highlightedAddresses.empty()) {
                 for (auto &member : this->m_members) {
-                    this->m_highlightedAddresses.merge(member->getHighlightedAddresses());
+                    this->addHighlightedAddresses(member->getHighlightedAddresses());
                 }
             }
 
             return this->m_highlightedAddresses;
         }
 
+        void invalidateValues(const Region &region) override {
+            PatternData::invalidateValues(region);
+
+            // Members aren't checked against the range of the struct, pointers inside of it can point anywhere
+            for (auto &member : this->m_members)
+                member->invalidateValues(region);
+        }
+
         void sort(ImGuiTableSortSpecs *sortSpecs, prv::Provider *provider) override {
             this->m_sortedMembers = this->m_members;
 
-            std::sort(this->m_sortedMembers.begin(), this->m_sortedMembers.end(), [&sortSpecs, &provider](PatternData *left, PatternData *right) {
-                return PatternData::sortPatternDataTable(sortSpecs, provider, left, right);
-            });
+            PatternData::sortPatterns(sortSpecs, provider, this->m_sortedMembers);
 
             for (auto &member : this->m_members)
                 member->sort(sortSpecs, provider);
@@ -612,28 +929,36 @@ namespace hex::lang {
             return this->m_members;
         }
 
+        [[nodiscard]] bool isExpandable() const override { return true; }
+
     private:
         std::vector<PatternData*> m_members;
         std::vector<PatternData*> m_sortedMembers;
+        bool m_leafMembers;
+        u64 m_displayEnd = DisplayChunkSize;
     };
 
     class PatternDataUnion : public PatternData {
     public:
         PatternDataUnion(u64 offset, size_t size, const std::vector<PatternData*> & members, u32 color = 0)
-                : PatternData(offset, size, color), m_members(members), m_sortedMembers(members) { }
-
-        PatternDataUnion(const PatternDataUnion &other) : PatternData(other.getOffset(), other.getSize(), other.getColor()) {
-            for (const auto &member : other.m_members)
-                this->m_members.push_back(member->clone());
+                : PatternData(offset, size, color), m_members(members), m_sortedMembers(members) {
+            this->m_leafMembers = PatternData::areLeafEntries(this->m_members);
         }
 
-        ~PatternDataUnion() override {
-            for (const auto &member : this->m_members)
-                delete member;
+        PatternData* clone(Arena &arena) const override {
+            auto pattern = arena.create<PatternDataUnion>(*this);
+            for (auto &member : pattern->m_members)
+                member = member->clone(arena);
+            pattern->m_sortedMembers = pattern->m_members;
+
+            return pattern;
         }
 
-        PatternData* clone() override {
-            return new PatternDataUnion(*this);
+        void setOffset(u64 offset) override {
+            for (auto &member : this->m_members)
+                member->setOffset(member->getOffset() - this->getOffset() + offset);
+
+            PatternData::setOffset(offset);
         }
 
         void createEntry(prv::Provider* &provider) override {
@@ -653,8 +978,7 @@ namespace hex::lang {
             ImGui::Text("%s", "{ ... }");
 
             if (open) {
-                for (auto &member : this->m_sortedMembers)
-                    member->createEntry(provider);
+                PatternData::createEntries(provider, this->m_sortedMembers, this->m_leafMembers, this->m_displayEnd);
 
                 ImGui::TreePop();
             }
@@ -670,22 +994,27 @@ namespace hex::lang {
             return { };
         }
 
-        std::map<u64, u32> getHighlightedAddresses() override {
+        const std::vector<HighlightRange>& getHighlightedAddresses() override {
             if (this->m_highlightedAddresses.empty()) {
                 for (auto &member : this->m_members) {
-                    this->m_highlightedAddresses.merge(member->getHighlightedAddresses());
+                    this->addHighlightedAddresses(member->getHighlightedAddresses());
                 }
             }
 
             return this->m_highlightedAddresses;
         }
 
+        void invalidateValues(const Region &region) override {
+            PatternData::invalidateValues(region);
+
+            for (auto &member : this->m_members)
+                member->invalidateValues(region);
+        }
+
         void sort(ImGuiTableSortSpecs *sortSpecs, prv::Provider *provider) override {
             this->m_sortedMembers = this->m_members;
 
-            std::sort(this->m_sortedMembers.begin(), this->m_sortedMembers.end(), [&sortSpecs, &provider](PatternData *left, PatternData *right) {
-                return PatternData::sortPatternDataTable(sortSpecs, provider, left, right);
-            });
+            PatternData::sortPatterns(sortSpecs, provider, this->m_sortedMembers);
 
             for (auto &member : this->m_members)
                 member->sort(sortSpecs, provider);
@@ -699,50 +1028,88 @@ namespace hex::lang {
             return this->m_members;
         }
 
+        [[nodiscard]] bool isExpandable() const override { return true; }
+
     private:
         std::vector<PatternData*> m_members;
         std::vector<PatternData*> m_sortedMembers;
+        bool m_leafMembers;
+        u64 m_displayEnd = DisplayChunkSize;
+    };
+
+    /*
+        Constants of an enum type, created once per type and evaluation and shared by all patterns of it.
+        Values are kept sorted so looking one up doesn't need to go through all of them
+    */
+    class EnumValues {
+    public:
+        explicit EnumValues(std::vector<std::pair<Token::IntegerLiteral, std::string>> entries) : m_entries(std::move(entries)) {
+            for (const auto &[literal, name] : this->m_entries) {
+                // Only constants that compare equal to some u64 can ever match a value read from the data
+                auto key = std::visit([](auto &&value) -> std::optional<u64> {
+                    using Type = std::decay_t<decltype(value)>;
+
+                    if constexpr (std::is_same_v<Type, u128> || std::is_same_v<Type, s128>) {
+                        if (value < 0 || value > std::numeric_limits<u64>::max())
+                            return std::nullopt;
+                        return u64(value);
+                    } else if constexpr (std::is_floating_point_v<Type>) {
+                        if (value < 0 || value >= 0x1p64 || value != Type(u64(value)))
+                            return std::nullopt;
+                        return u64(value);
+                    } else
+                        return u64(value);
+                }, literal.second);
+
+                if (key.has_value())
+                    this->m_lookup.emplace_back(*key, &name);
+            }
+
+            // If multiple constants have the same value, the one declared first is shown
+            std::stable_sort(this->m_lookup.begin(), this->m_lookup.end(), [](const auto &left, const auto &right) { return left.first < right.first; });
+            this->m_lookup.erase(std::unique(this->m_lookup.begin(), this->m_lookup.end(), [](const auto &left, const auto &right) { return left.first == right.first; }), this->m_lookup.end());
+        }
+
+        [[nodiscard]] const std::string* find(u64 value) const {
+            auto it = std::lower_bound(this->m_lookup.begin(), this->m_lookup.end(), value, [](const auto &entry, u64 value) { return entry.first < value; });
+            if (it == this->m_lookup.end() || it->first != value)
+                return nullptr;
+
+            return it->second;
+        }
+
+        [[nodiscard]] const auto& getEntries() const { return this->m_entries; }
+
+    private:
+        std::vector<std::pair<Token::IntegerLiteral, std::string>> m_entries;
+        std::vector<std::pair<u64, const std::string*>> m_lookup;
     };
 
     class PatternDataEnum : public PatternData {
     public:
-        PatternDataEnum(u64 offset, size_t size, std::vector<std::pair<Token::IntegerLiteral, std::string>> enumValues, u32 color = 0)
-            : PatternData(offset, size, color), m_enumValues(std::move(enumValues)) { }
+        PatternDataEnum(u64 offset, size_t size, const EnumValues *enumValues, u32 color = 0)
+            : PatternData(offset, size, color), m_enumValues(enumValues) { }
 
-        PatternData* clone() override {
-            return new PatternDataEnum(*this);
+        PatternData* clone(Arena &arena) const override {
+            return arena.create<PatternDataEnum>(*this);
         }
 
         void createEntry(prv::Provider* &provider) override {
-            u64 value = 0;
-            provider->read(this->getOffset(), &value, this->getSize());
-            value = hex::changeEndianess(value, this->getSize(), this->getEndian());
-
-            std::string valueString = PatternData::getTypeName() + "::";
-
-            bool foundValue = false;
-            for (auto &[entryValueLiteral, entryName] : this->m_enumValues) {
-                bool matches = std::visit([&, name = entryName](auto &&entryValue) {
-                    if (value == entryValue) {
-                        valueString += name;
-                        foundValue = true;
-                        return true;
-                    }
+            const auto &formattedValue = this->getCachedValue([&] {
+                u64 value = 0;
+                provider->read(this->getOffset(), &value, this->getSize());
+                value = hex::changeEndianess(value, this->getSize(), this->getEndian());
 
-                    return false;
-                }, entryValueLiteral.second);
-                if (matches)
-                    break;
-            }
+                auto name = this->m_enumValues->find(value);
 
-            if (!foundValue)
-                valueString += "???";
+                return hex::format("{}::{} (0x{:0{}X})", PatternData::getTypeName(), name != nullptr ? *name : "???", value, this->getSize() * 2);
+            });
 
             ImGui::TableNextRow();
             ImGui::TreeNodeEx(this->getVariableName().c_str(), ImGuiTreeNodeFlags_Leaf | ImGuiTreeNodeFlags_NoTreePushOnOpen | ImGuiTreeNodeFlags_SpanFullWidth | ImGuiTreeNodeFlags_AllowItemOverlap);
             this->drawCommentTooltip();
             ImGui::TableNextColumn();
-            if (ImGui::Selectable(("##PatternDataLine"s + std::to_string(this->getOffset())).c_str(), false, ImGuiSelectableFlags_SpanAllColumns)) {
+            if (this->drawRowSelectable(ImGuiSelectableFlags_SpanAllColumns)) {
                 Region selectRegion = { this->getOffset(), this->getSize() };
                 View::postEvent(Events::SelectionChangeRequest, selectRegion);
             }
@@ -757,7 +1124,7 @@ namespace hex::lang {
             ImGui::TableNextColumn();
             ImGui::TextColored(ImColor(0xFFD69C56), "enum"); ImGui::SameLine(); ImGui::Text("%s", PatternData::getTypeName().c_str());
             ImGui::TableNextColumn();
-            ImGui::Text("%s", hex::format("{} (0x{:0{}X})", valueString.c_str(), value, this->getSize() * 2).c_str());
+            ImGui::TextUnformatted(formattedValue.c_str());
         }
 
         [[nodiscard]] std::string getFormattedName() const override {
@@ -765,28 +1132,65 @@ namespace hex::lang {
         }
 
         const auto& getEnumValues() const {
-            return this->m_enumValues;
+            return this->m_enumValues->getEntries();
+        }
+
+        /* Name of the constant with the given value, if there is one */
+        [[nodiscard]] const std::string* getValueName(u64 value) const {
+            return this->m_enumValues->find(value);
         }
 
     private:
-        std::vector<std::pair<Token::IntegerLiteral, std::string>> m_enumValues;
+        const EnumValues *m_enumValues;
     };
 
     class PatternDataBitfield : public PatternData {
     public:
-        PatternDataBitfield(u64 offset, size_t size, std::vector<std::pair<std::string, size_t>> fields, u32 color = 0)
-                : PatternData(offset, size, color), m_fields(std::move(fields)) { }
+        /* Where a field lies in the backing bytes, worked out once per layout so decoding a field is a single load, shift and mask */
+        struct Field {
+            Field(std::string name, size_t size, size_t bitOffset)
+                : name(std::move(name)), size(size), bitOffset(bitOffset), byteOffset(bitOffset / 8), shift(bitOffset % 8),
+                  loadSize((bitOffset % 8 + size + 7) / 8), mask(size >= 64 ? ~u64(0) : (u64(1) << size) - 1) { }
+
+            bool operator==(const Field &other) const = default;
+
+            std::string name;
+            size_t size;
+            size_t bitOffset;
+            size_t byteOffset;
+            u8 shift;
+            u8 loadSize;
+            u64 mask;
+        };
+
+        using Fields = std::vector<Field>;
+
+        /* Bytes are the whole backing storage of the bitfield, in little endian */
+        [[nodiscard]] static u64 decodeField(const Field &field, const u8 *bytes) {
+            u128 value = 0;
+            std::memcpy(&value, bytes + field.byteOffset, field.loadSize);
 
-        PatternData* clone() override {
-            return new PatternDataBitfield(*this);
+            return u64(value >> field.shift) & field.mask;
+        }
+
+        /* Fields are shared by all bitfields with the same layout */
+        PatternDataBitfield(u64 offset, size_t size, const Fields *fields, u32 color = 0)
+                : PatternData(offset, size, color), m_fields(fields) { }
+
+        PatternData* clone(Arena &arena) const override {
+            return arena.create<PatternDataBitfield>(*this);
         }
 
         void createEntry(prv::Provider* &provider) override {
-            std::vector<u8> value(this->getSize(), 0);
-            provider->read(this->getOffset(), &value[0], value.size());
+            const auto readValue = [&] {
+                std::vector<u8> value(this->getSize(), 0);
+                provider->read(this->getOffset(), &value[0], value.size());
 
-            if (this->m_endian == std::endian::big)
-                std::reverse(value.begin(), value.end());
+                if (this->m_endian == std::endian::big)
+                    std::reverse(value.begin(), value.end());
+
+                return value;
+            };
 
             ImGui::TableNextRow();
             ImGui::TableNextColumn();
@@ -801,38 +1205,38 @@ namespace hex::lang {
             ImGui::TextColored(ImColor(0xFFD69C56), "bitfield"); ImGui::SameLine(); ImGui::Text("%s", PatternData::getTypeName().c_str());
             ImGui::TableNextColumn();
 
-            std::string valueString = "{ ";
-            for (u64 i = 0; i < value.size(); i++)
-                valueString += hex::format("{0:02X} ", value[i]);
-            valueString += "}";
+            ImGui::TextUnformatted(this->getCachedValue([&] {
+                auto value = readValue();
+
+                std::string valueString = "{ ";
+                for (u64 i = 0; i < value.size(); i++)
+                    valueString += hex::format("{0:02X} ", value[i]);
+                valueString += "}";
 
-            ImGui::TextUnformatted(valueString.c_str());
+                return valueString;
+            }).c_str());
 
             if (open) {
-                u16 bitOffset = 0;
-                for (auto &[entryName, entrySize] : this->m_fields) {
+                auto value = readValue();
+
+                for (const auto &field : *this->m_fields) {
                     ImGui::TableNextRow();
                     ImGui::TreeNodeEx(this->getVariableName().c_str(), ImGuiTreeNodeFlags_Leaf | ImGuiTreeNodeFlags_NoTreePushOnOpen | ImGuiTreeNodeFlags_SpanFullWidth | ImGuiTreeNodeFlags_AllowItemOverlap);
                     ImGui::TableNextColumn();
-                    ImGui::Text("%s", entryName.c_str());
+                    ImGui::Text("%s", field.name.c_str());
                     ImGui::TableNextColumn();
                     ImGui::ColorButton("color", ImColor(this->getColor()), ImGuiColorEditFlags_NoTooltip, ImVec2(ImGui::GetColumnWidth(), ImGui::GetTextLineHeight()));
                     ImGui::TableNextColumn();
-                    ImGui::Text("0x%08llX : 0x%08llX", this->getOffset() + (bitOffset >> 3), this->getOffset() + ((bitOffset + entrySize) >> 3));
+                    ImGui::Text("0x%08llX : 0x%08llX", this->getOffset() + field.byteOffset, this->getOffset() + ((field.bitOffset + field.size) >> 3));
                     ImGui::TableNextColumn();
-                    if (entrySize == 1)
-                        ImGui::Text("%llu bit", entrySize);
+                    if (field.size == 1)
+                        ImGui::Text("%llu bit", field.size);
                     else
-                        ImGui::Text("%llu bits", entrySize);
+                        ImGui::Text("%llu bits", field.size);
                     ImGui::TableNextColumn();
                     ImGui::TextColored(ImColor(0xFF9BC64D), "bits");
                     ImGui::TableNextColumn();
-                    {
-                        u128 fieldValue = 0;
-                        std::memcpy(&fieldValue, value.data() + (bitOffset / 8), (entrySize / 8) + 1);
-                        ImGui::Text("%llX", hex::extract((bitOffset + entrySize) - 1 - ((bitOffset / 8) * 8), bitOffset - ((bitOffset / 8) * 8), fieldValue));
-                    }
-                    bitOffset += entrySize;
+                    ImGui::Text("%llX", PatternDataBitfield::decodeField(field, value.data()));
                 }
 
                 ImGui::TreePop();
@@ -845,12 +1249,252 @@ namespace hex::lang {
         }
 
         const auto& getFields() const {
-            return this->m_fields;
+            return *this->m_fields;
+        }
+
+        [[nodiscard]] bool isExpandable() const override { return true; }
+
+    private:
+        const Fields *m_fields;
+    };
+
+    /*
+        Array whose elements all share the same layout, e.g. arrays of builtin types or fixed-size structs.
+        Only a single template entry is kept which gets moved to each element that's currently being drawn or highlighted,
+        so large arrays don't need a whole pattern tree per element
+    */
+    class PatternDataStaticArray : public PatternData {
+    public:
+        PatternDataStaticArray(u64 offset, size_t size, PatternData *templateEntry, u64 entryCount, u32 color = 0)
+            : PatternData(offset, size, color), m_template(templateEntry), m_entryCount(entryCount) {
+
+            this->m_template->setColor(this->getColor());
+            this->m_leafEntries = !templateEntry->isExpandable();
+            this->m_builtinEntries = dynamic_cast<PatternDataUnsigned*>(templateEntry) != nullptr
+                                  || dynamic_cast<PatternDataSigned*>(templateEntry) != nullptr
+                                  || dynamic_cast<PatternDataFloat*>(templateEntry) != nullptr;
+        }
+
+        PatternData* clone(Arena &arena) const override {
+            auto pattern = arena.create<PatternDataStaticArray>(*this);
+            pattern->m_template = this->m_template->clone(arena);
+
+            return pattern;
+        }
+
+        void createEntry(prv::Provider* &provider) override {
+            if (this->m_entryCount == 0)
+                return;
+
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            bool open = ImGui::TreeNodeEx(this->getVariableName().c_str(), ImGuiTreeNodeFlags_SpanFullWidth | ImGuiTreeNodeFlags_AllowItemOverlap);
+            this->drawCommentTooltip();
+            ImGui::TableNextColumn();
+            ImGui::ColorButton("color", ImColor(this->getColor()), ImGuiColorEditFlags_NoTooltip, ImVec2(ImGui::GetColumnWidth(), ImGui::GetTextLineHeight()));
+            ImGui::TableNextColumn();
+            ImGui::Text("0x%08llX : 0x%08llX", this->getOffset(), this->getOffset() + this->getSize() - 1);
+            ImGui::TableNextColumn();
+            ImGui::Text("0x%04llX", this->getSize());
+            ImGui::TableNextColumn();
+            ImGui::TextColored(ImColor(0xFF9BC64D), "%s", this->m_template->getTypeName().c_str());
+            ImGui::SameLine(0, 0);
+
+            ImGui::TextUnformatted("[");
+            ImGui::SameLine(0, 0);
+            ImGui::TextColored(ImColor(0xFF00FF00), "%llu", this->m_entryCount);
+            ImGui::SameLine(0, 0);
+            ImGui::TextUnformatted("]");
+
+            ImGui::TableNextColumn();
+            ImGui::Text("%s", "{ ... }");
+
+            if (open) {
+                if (this->m_leafEntries) {
+                    // All rows have the same height so only the visible ones need to be drawn
+                    ImGuiListClipper clipper;
+                    clipper.Begin(std::min<u64>(this->m_entryCount, std::numeric_limits<int>::max()));
+
+                    while (clipper.Step())
+                        this->drawLeafEntries(provider, clipper.DisplayStart, clipper.DisplayEnd);
+                } else {
+                    // Entries can be expanded, show them in chunks instead
+                    auto displayEnd = std::min(this->m_displayEnd, this->m_entryCount);
+                    for (u64 i = 0; i < displayEnd; i++)
+                        this->drawEntry(provider, i);
+
+                    if (displayEnd < this->m_entryCount) {
+                        ImGui::TableNextRow();
+                        ImGui::TableNextColumn();
+                        if (ImGui::Selectable(hex::format("hex.view.pattern_data.more_entries"_lang, this->m_entryCount - displayEnd).c_str(), false, ImGuiSelectableFlags_SpanAllColumns))
+                            this->m_displayEnd += DisplayChunkSize;
+                    }
+                }
+
+                ImGui::TreePop();
+            }
+        }
+
+        std::optional<u32> highlightBytes(size_t offset) override {
+            if (offset < this->getOffset() || offset >= this->getOffset() + this->getSize())
+                return { };
+
+            auto entrySize = this->m_template->getSize();
+            auto entryOffset = offset - (offset - this->getOffset()) % entrySize;
+
+            this->m_template->setOffset(entryOffset);
+            return this->m_template->highlightBytes(offset);
+        }
+
+        const std::vector<HighlightRange>& getHighlightedAddresses() override {
+            if (this->m_highlightedAddresses.empty() && this->getSize() > 0) {
+                auto entrySize = this->m_template->getSize();
+
+                this->m_template->setOffset(this->getOffset());
+                const auto &entryRanges = this->m_template->getHighlightedAddresses();
+
+                if (entryRanges.size() == 1 && entryRanges[0].start == this->getOffset() && entryRanges[0].end == this->getOffset() + entrySize) {
+                    // Entries are highlighted in a single color, the whole array is one range
+                    this->m_highlightedAddresses.push_back({ this->getOffset(), this->getOffset() + this->getSize(), entryRanges[0].color });
+                } else {
+                    for (u64 i = 0; i < this->m_entryCount; i++) {
+                        this->m_template->setOffset(this->getOffset() + i * entrySize);
+                        this->addHighlightedAddresses(this->m_template->getHighlightedAddresses());
+                    }
+                }
+            }
+
+            return this->m_highlightedAddresses;
         }
 
+        void invalidateValues(const Region &region) override {
+            PatternData::invalidateValues(region);
+
+            auto entrySize = this->m_template->getSize();
+            for (auto &row : this->m_cachedRows) {
+                if (row.index == InvalidRow)
+                    continue;
+
+                u64 entryOffset = this->getOffset() + row.index * entrySize;
+                if (region.address < entryOffset + entrySize && region.address + region.size > entryOffset)
+                    row.index = InvalidRow;
+            }
+        }
+
+        [[nodiscard]] std::string getFormattedName() const override {
+            return this->m_template->getTypeName() + "[" + std::to_string(this->m_entryCount) + "]";
+        }
+
+        [[nodiscard]] bool isExpandable() const override { return true; }
+
+        [[nodiscard]] PatternData* getTemplate() const { return this->m_template; }
+        [[nodiscard]] u64 getEntryCount() const { return this->m_entryCount; }
+
     private:
-        std::vector<std::pair<std::string, size_t>> m_fields;
+        void drawEntry(prv::Provider* &provider, u64 index) {
+            this->m_template->setOffset(this->getOffset() + index * this->m_template->getSize());
+            this->m_template->setVariableName(hex::format("[{0}]", index));
+            this->m_template->createEntry(provider);
+        }
+
+        /* Name and value of a leaf entry as it was drawn last */
+        struct CachedRow {
+            u64 index;
+            std::string name, value;
+        };
+
+        constexpr static u64 CachedRowCount = 256;
+        constexpr static u64 InvalidRow = std::numeric_limits<u64>::max();
+
+        /* The clipper measures the first row every frame, it gets its own slot so it doesn't push out one of the visible rows */
+        CachedRow& getCachedRow(u64 index) {
+            return this->m_cachedRows[index == 0 ? CachedRowCount : index % CachedRowCount];
+        }
+
+        /* Only rows that were scrolled into view or whose data changed get formatted, all others are drawn from the row cache */
+        void drawLeafEntries(prv::Provider* &provider, u64 start, u64 end) {
+            if (this->m_cachedRows.empty() || this->m_cachedRowsGeneration != PatternData::getValueCacheGeneration() || this->m_cachedRowsOffset != this->getOffset()) {
+                this->m_cachedRows.resize(CachedRowCount + 1);
+                for (auto &row : this->m_cachedRows)
+                    row.index = InvalidRow;
+
+                this->m_cachedRowsGeneration = PatternData::getValueCacheGeneration();
+                this->m_cachedRowsOffset = this->getOffset();
+            }
+
+            if (this->m_builtinEntries)
+                this->formatBuiltinRows(provider, start, end);
+
+            auto entrySize = this->m_template->getSize();
+            for (u64 i = start; i < end; i++) {
+                auto &row = this->getCachedRow(i);
+                bool cached = row.index == i;
+
+                if (!cached) {
+                    row.index = i;
+                    row.name = hex::format("[{0}]", i);
+                }
+
+                this->m_template->setOffset(this->getOffset() + i * entrySize);
+                this->m_template->setVariableName(row.name);
+                if (cached)
+                    this->m_template->setCachedValue(row.value);
+
+                this->m_template->createEntry(provider);
+
+                if (!cached) {
+                    if (auto value = this->m_template->getDisplayedValue(); value != nullptr)
+                        row.value = *value;
+                    else
+                        row.index = InvalidRow;
+                }
+            }
+        }
+
+        /* Reads all rows that aren't cached yet at once and converts them to native endianess in one go instead of entry by entry */
+        void formatBuiltinRows(prv::Provider* &provider, u64 start, u64 end) {
+            u64 missingStart = end, missingEnd = start;
+            for (u64 i = start; i < end; i++) {
+                if (this->getCachedRow(i).index != i) {
+                    missingStart = std::min(missingStart, i);
+                    missingEnd = i + 1;
+                }
+            }
+
+            if (missingStart >= missingEnd)
+                return;
+
+            auto entrySize = this->m_template->getSize();
+            this->m_entryBuffer.resize((missingEnd - missingStart) * entrySize);
+            provider->read(this->getOffset() + missingStart * entrySize, this->m_entryBuffer.data(), this->m_entryBuffer.size());
+            hex::changeEndianess(this->m_entryBuffer.data(), missingEnd - missingStart, entrySize, this->m_template->getEndian());
+
+            for (u64 i = missingStart; i < missingEnd; i++) {
+                auto &row = this->getCachedRow(i);
+                if (row.index == i)
+                    continue;
+
+                this->m_template->setOffset(this->getOffset() + i * entrySize);
+                if (auto value = this->m_template->formatValue(this->m_entryBuffer.data() + (i - missingStart) * entrySize); value.has_value()) {
+                    row.index = i;
+                    row.name = hex::format("[{0}]", i);
+                    row.value = std::move(*value);
+                }
+            }
+        }
+
+        PatternData *m_template;
+        u64 m_entryCount;
+        bool m_leafEntries;
+        bool m_builtinEntries;
+        std::vector<u8> m_entryBuffer;
+        u64 m_displayEnd = DisplayChunkSize;
+
+        std::vector<CachedRow> m_cachedRows;
+        u64 m_cachedRowsGeneration = 0;
+        u64 m_cachedRowsOffset = 0;
     };
 
 
+
 }
\ No newline at end of file
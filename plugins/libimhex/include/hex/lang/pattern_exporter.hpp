@@ -0,0 +1,96 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <hex/helpers/utils.hpp>
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace hex::prv { class Provider; }
+
+namespace hex::lang {
+
+    class PatternData;
+
+    /*
+        Writes evaluated patterns out for other tools while walking the pattern tree. Output is collected in a small buffer
+        and handed to the writer whenever it's full, so memory use doesn't grow with the number of patterns.
+        Entries of static arrays are produced by moving the array's template entry along, like the pattern data view does,
+        so the patterns must not be drawn or highlighted at the same time
+    */
+    class PatternExporter {
+    public:
+        enum class Format : u8 {
+            /* One JSON object per line for every value, with its path (e.g. header.entries[3].size), type, offset, size and value */
+            JSONLines,
+            /* One row per array entry and one column per value inside of an entry, the first entry decides the columns */
+            CSV,
+            /*
+                Header "IMHXPAT\0" and a u8 version, followed by records starting with a u8 kind. All numbers are unsigned LEB128.
+                  Name   (0): length, bytes. Defines a string later records refer to by id, the strings are numbered from 0 in order
+                  Begin  (1): name id, type id, offset, size. Starts a struct, union, array, bitfield or pointer
+                  End    (2): Ends the last begun pattern
+                  Value  (3): name id, type id, u8 value kind, offset, size, length, bytes
+                Array entries have an empty name. Integers, floats, enums, bitfield fields and pointers are stored in little endian,
+                enums with their constant's name appended, strings and characters as they are. Bitfield fields have their size in bits
+            */
+            Binary
+        };
+
+        enum class ValueKind : u8 {
+            Unsigned, Signed, Float, Boolean, Character, String, Enum, Bits, Pointer
+        };
+
+        /* Gets called with every chunk of output. Return false to stop exporting */
+        using Writer = std::function<bool(const char *data, size_t size)>;
+
+        PatternExporter(prv::Provider *provider, Format format, Writer writer);
+
+        /* Returns false if the writer stopped the export or it got cancelled. CSV takes a single array, anything else becomes a single row */
+        bool exportPatterns(const std::vector<PatternData*> &patterns, const std::atomic<bool> &cancelled);
+
+        /* Finds a pattern by the names of the structs and unions leading to it, e.g. header.entries */
+        [[nodiscard]] static PatternData* findPattern(const std::vector<PatternData*> &patterns, std::string_view path);
+
+    private:
+        constexpr static size_t FlushSize = 0x1'0000;
+        constexpr static u64 ArrayReadEntries = 0x1000;
+
+        void walk(PatternData *pattern, std::string_view name, bool arrayEntry, u64 index);
+        void walkStaticArray(PatternData *pattern);
+        /* Values of numbers are in native endianess */
+        void writeValue(PatternData *pattern, ValueKind kind, std::string_view type, std::string_view name, u64 offset, u64 size, const u8 *data);
+        void beginPattern(PatternData *pattern, std::string_view name);
+        void endPattern();
+
+        void writeCSV(PatternData *pattern);
+        void formatValue(std::string &output, ValueKind kind, u64 size, const u8 *data) const;
+
+        void writeNumber(u64 value);
+        u64 getNameId(std::string_view name);
+        void flush();
+
+        prv::Provider *m_provider;
+        Format m_format;
+        Writer m_writer;
+        const std::atomic<bool> *m_cancelled = nullptr;
+        bool m_stopped = false;
+
+        std::string m_buffer;
+        std::string m_path;
+
+        /* Strings already defined in the binary format */
+        std::unordered_map<std::string, u64, StringHash, std::equal_to<>> m_nameIds;
+
+        /* Columns of the CSV header by path relative to the array entry, and the cells of the current row */
+        std::unordered_map<std::string, size_t, StringHash, std::equal_to<>> m_columns;
+        std::vector<std::string> m_columnNames, m_row;
+        bool m_collectColumns = false;
+    };
+
+}
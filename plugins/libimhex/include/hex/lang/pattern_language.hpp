@@ -2,12 +2,17 @@
 
 #include <hex.hpp>
 
+#include <atomic>
 #include <bit>
+#include <functional>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <string_view>
 #include <vector>
 
+#include <hex/helpers/arena.hpp>
+#include <hex/helpers/utils.hpp>
 #include <hex/lang/pattern_data.hpp>
 #include <hex/lang/log_console.hpp>
 
@@ -20,19 +25,50 @@ namespace hex::lang {
     class Parser;
     class Validator;
     class Evaluator;
+    class ASTNode;
 
     class PatternLanguage {
     public:
         PatternLanguage();
         ~PatternLanguage();
 
+        /* The returned patterns are owned by the runtime and stay valid until the next execution */
         std::optional<std::vector<PatternData*>> executeString(prv::Provider *provider, std::string_view string);
         std::optional<std::vector<PatternData*>> executeFile(prv::Provider *provider, std::string_view path);
 
+        /*
+            Updates the patterns of the last successful execution after the given regions of the data changed.
+            Returns nothing if the last execution has to be repeated from scratch instead
+        */
+        std::optional<std::vector<PatternData*>> reevaluate(prv::Provider *provider, const std::vector<Region> &changedRegions);
+
+        /* Called as soon as the evaluation of a provider finished. The patterns are only valid until the call returns */
+        using BatchCallback = std::function<void(u32 index, const std::optional<std::vector<PatternData*>> &patterns,
+                                                 const std::vector<std::pair<LogConsole::Level, std::string>> &consoleLog)>;
+
+        /*
+            Compiles the code once and evaluates it on every provider, spread out over the task manager's workers. Every worker has its own
+            evaluator and arena and works through the providers one after another, so the callback gets called from several threads at once.
+            Returns false if the code failed to compile. Aborting stops the running evaluations and skips the remaining providers
+        */
+        bool executeBatch(const std::vector<prv::Provider*> &providers, std::string_view string, const BatchCallback &callback);
+
+        /* Stops a running execution from another thread, it then fails with an error in the console */
+        void abort();
+        [[nodiscard]] u64 getCreatedPatternCount() const;
+        /* Bytes reserved for the patterns of the last execution */
+        [[nodiscard]] size_t getPatternMemoryUsage() const;
+
         const std::vector<std::pair<LogConsole::Level, std::string>>& getConsoleLog();
         const std::optional<std::pair<u32, std::string>>& getError();
 
     private:
+        /* Preprocesses the code and compiles it, unless it's the same as last time. The resulting AST is the cached one */
+        bool compile(std::string_view string);
+
+        Arena m_astArena;
+        Arena m_patternArena;
+
         Preprocessor *m_preprocessor;
         Lexer *m_lexer;
         Parser *m_parser;
@@ -43,6 +79,20 @@ namespace hex::lang {
         std::endian m_defaultEndian;
 
         std::optional<std::pair<u32, std::string>> m_currError;
+
+        constexpr static size_t MaxReevaluationArenaSize = 0x100'0000;
+
+        /* AST of the last successfully parsed code, it lives in the AST arena */
+        std::string m_cachedCode;
+        std::optional<std::vector<ASTNode*>> m_cachedAst;
+
+        bool m_evaluated = false;
+        size_t m_evaluatedArenaSize = 0;
+
+        /* Evaluators of the workers of a running batch, so it can be aborted */
+        std::mutex m_batchMutex;
+        std::vector<Evaluator*> m_batchEvaluators;
+        std::atomic<bool> m_batchAborted = false;
     };
 
 }
\ No newline at end of file
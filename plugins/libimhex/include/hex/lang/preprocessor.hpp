@@ -4,11 +4,14 @@
 
 #include "token.hpp"
 
+#include <filesystem>
 #include <functional>
+#include <map>
 #include <set>
 #include <string>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 namespace hex::lang {
 
@@ -36,6 +39,27 @@ namespace hex::lang {
         std::set<std::pair<std::string, std::string>> m_pragmas;
 
         std::pair<u32, std::string> m_error;
+
+        /* Preprocessed include files, reused as long as neither they nor anything they include changed */
+        struct CachedInclude {
+            std::filesystem::file_time_type lastWriteTime;
+            size_t contentHash;
+            std::string content;
+            std::set<std::pair<std::string, std::string>> defines;
+            std::set<std::pair<std::string, std::string>> pragmas;
+            std::vector<std::string> includes;
+        };
+
+        std::map<std::string, CachedInclude> m_includeCache;
+        std::vector<std::string> m_includes;
+
+        /* Paths include names were found at, and the includes already checked against the file system during the current run */
+        std::map<std::string, std::string> m_resolvedIncludes;
+        std::set<std::string> m_validatedIncludes;
+
+        std::string resolveInclude(const std::string &name);
+        std::string preprocessInclude(const std::string &path, u32 lineNumber);
+        bool isIncludeUpToDate(const std::string &path);
     };
 
 }
\ No newline at end of file
@@ -6,6 +6,7 @@
 
 #include <utility>
 #include <string>
+#include <string_view>
 #include <variant>
 
 namespace hex::lang {
@@ -103,7 +104,8 @@ namespace hex::lang {
         };
 
         using IntegerLiteral = std::pair<ValueType, std::variant<u8, s8, u16, s16, u32, s32, u64, s64, u128, s128, float, double>>;
-        using ValueTypes = std::variant<Keyword, std::string, Operator, IntegerLiteral, ValueType, Separator>;
+        /* Identifiers and string literals refer to the symbol table of the lexer that produced them */
+        using ValueTypes = std::variant<Keyword, std::string_view, Operator, IntegerLiteral, ValueType, Separator>;
 
         Token(Type type, auto value, u32 lineNumber) : type(type), value(value), lineNumber(lineNumber) {
 
@@ -14,6 +14,11 @@ namespace hex::lang {
     public:
         Validator();
 
+        /*
+            Checks that no name is declared twice in the same scope. Names are interned by the lexer, so they're compared by their address.
+            Structs and unions are only declared at the top level, their members are checked once for each declaration and in parallel
+            for large programs. The error of the first declaration in the code that has one is reported
+        */
         bool validate(const std::vector<ASTNode*>& ast);
         void printAST(const std::vector<ASTNode*>& ast);
 
@@ -24,6 +29,16 @@ namespace hex::lang {
 
         using ValidatorError = std::pair<u32, std::string>;
 
+        /* Below this many declarations handing them out to other threads takes longer than checking them all on this one */
+        constexpr static size_t ParallelDeclarationCount = 0x400;
+        constexpr static size_t DeclarationsPerJob = 0x100;
+
+        /* Index of the first node whose name got declared before already, the number of nodes if there's none */
+        static size_t findRedefinition(const std::vector<ASTNode*> &nodes);
+        void checkRedefinitions(const std::vector<ASTNode*> &nodes) const;
+        [[noreturn]] void throwRedefinitionError(ASTNode *node) const;
+        void checkMembers(ASTNode *declaration) const;
+
         [[noreturn]] void throwValidateError(std::string_view error, u32 lineNumber) const {
             throw ValidatorError(lineNumber, error);
         }
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <hex.hpp>
+#include <hex/helpers/utils.hpp>
+
+#include <array>
+#include <atomic>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace hex::prv {
+
+    /*
+        Counts the reads of a provider, broken down by whatever caused them. The cause is a tag set for the current thread, tasks are tagged
+        with their name, views with theirs while they're being drawn and anything else can tag itself with PROVIDER_IO_SCOPE("name").
+        Parallel work started through the task manager inherits the tag. Nothing gets counted while the statistics are disabled
+    */
+    class IOStatistics {
+    public:
+        /* Tags past this many all get counted as the last one */
+        constexpr static u32 MaxTags = 64;
+        constexpr static u32 UntaggedTag = 0;
+
+        struct Counters {
+            u64 readCalls = 0;
+            u64 bytesRead = 0;
+            u64 patchHits = 0;
+            u64 cacheHits = 0;
+            u64 cacheMisses = 0;
+            u64 rawReadCalls = 0;
+            u64 rawBytesRead = 0;
+            u64 rawReadTime = 0;    // Nanoseconds
+        };
+
+        /* Tags the current thread until it goes out of scope */
+        class Scope {
+        public:
+            explicit Scope(u32 tag);
+            explicit Scope(std::string_view name) : Scope(IOStatistics::getTag(name)) { }
+            ~Scope();
+
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+
+        private:
+            u32 m_previousTag;
+        };
+
+        static void setEnabled(bool enabled);
+        [[nodiscard]] static bool isEnabled() { return IOStatistics::s_enabled.load(std::memory_order_relaxed); }
+
+        /* The same name always gives the same tag */
+        [[nodiscard]] static u32 getTag(std::string_view name);
+        [[nodiscard]] static std::string getTagName(u32 tag);
+        [[nodiscard]] static u32 getCurrentTag();
+
+        void countRead(size_t size, bool patched);
+        void countCacheAccess(u64 hits, u64 misses);
+        void countRawRead(size_t size, u64 time);
+
+        /* Counters of every tag that caused any reads so far, along with the tag's name */
+        [[nodiscard]] std::vector<std::pair<std::string, Counters>> getCounters() const;
+        void reset();
+
+    private:
+        struct AtomicCounters {
+            std::atomic<u64> readCalls = 0;
+            std::atomic<u64> bytesRead = 0;
+            std::atomic<u64> patchHits = 0;
+            std::atomic<u64> cacheHits = 0;
+            std::atomic<u64> cacheMisses = 0;
+            std::atomic<u64> rawReadCalls = 0;
+            std::atomic<u64> rawBytesRead = 0;
+            std::atomic<u64> rawReadTime = 0;
+        };
+
+        std::array<AtomicCounters, MaxTags> m_counters;
+
+        static std::atomic<bool> s_enabled;
+    };
+
+    #define PROVIDER_IO_SCOPE(name) static const u32 TOKEN_CONCAT(ioTag, __LINE__) = ::hex::prv::IOStatistics::getTag(name); ::hex::prv::IOStatistics::Scope TOKEN_CONCAT(ioScope, __LINE__)(TOKEN_CONCAT(ioTag, __LINE__))
+
+}
@@ -2,23 +2,74 @@
 
 #include <hex.hpp>
 
+#include <cstdio>
 #include <vector>
 
 namespace hex::prv {
 
+    class Provider;
+
+    /*
+        Data of an overlay. Small data stays on the heap, anything larger gets written to an anonymous temporary file which is then mapped,
+        so the system can drop it from RAM whenever it needs to. Chunks that are all zeros never get written, they stay holes in the file
+    */
+    class OverlayData {
+    public:
+        OverlayData() = default;
+        OverlayData(std::vector<u8> data);
+        OverlayData(OverlayData &&other) noexcept;
+        OverlayData& operator=(OverlayData &&other) noexcept;
+        ~OverlayData();
+
+        OverlayData(const OverlayData&) = delete;
+        OverlayData& operator=(const OverlayData&) = delete;
+
+        /* Returns false if the data couldn't be stored, nothing can be appended anymore once the data was finished */
+        [[nodiscard]] bool append(const u8 *data, size_t size);
+
+        /* Writes out whatever is left and maps the data, has to be called before it can be read */
+        [[nodiscard]] bool finish();
+
+        [[nodiscard]] u64 getSize() const { return this->m_size; }
+        [[nodiscard]] bool isSpilled() const { return this->m_file != nullptr; }
+
+        void read(u64 offset, u8 *buffer, size_t size) const;
+
+    private:
+        constexpr static size_t SpillThreshold = 16 * 1024 * 1024;
+        constexpr static size_t ChunkSize = 1024 * 1024;
+
+        bool writeChunks(bool all);
+        void release();
+
+        u64 m_size = 0;
+        bool m_finished = false;
+
+        /* All of the data while it's small, otherwise only what wasn't written to the file yet */
+        std::vector<u8> m_buffer;
+
+        std::FILE *m_file = nullptr;
+        u64 m_fileSize = 0;
+        const u8 *m_mapping = nullptr;
+        void *m_mappingHandle = nullptr;
+    };
+
+    /* Data shown on top of a provider's data. Changes get picked up by the provider's overlay index right away */
     class Overlay {
     public:
-        Overlay() { }
+        explicit Overlay(Provider *provider) : m_provider(provider) { }
 
-        void setAddress(u64 address) { this->m_address = address; }
+        void setAddress(u64 address);
         [[nodiscard]] u64 getAddress() const { return this->m_address; }
 
-        [[nodiscard]] u64 getSize() const { return this->m_data.size(); }
-        [[nodiscard]] std::vector<u8>& getData() { return this->m_data; }
+        void setData(u64 address, OverlayData data);
+        [[nodiscard]] u64 getSize() const { return this->m_data.getSize(); }
+        [[nodiscard]] const OverlayData& getData() const { return this->m_data; }
 
     private:
+        Provider *m_provider;
         u64 m_address = 0;
-        std::vector<u8> m_data;
+        OverlayData m_data;
     };
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <map>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace hex::prv {
+
+    /*
+        Stores patched bytes as coalesced runs of contiguous data keyed by their absolute start offset.
+        Runs never overlap or touch each other, so any range can be merged into a read buffer with one lookup.
+        Copies share their runs until one of them gets modified, so snapshots for background work are cheap to take.
+    */
+    class PatchStore {
+    public:
+        PatchStore() = default;
+        PatchStore(const PatchStore&) = default;
+        PatchStore& operator=(const PatchStore&) = default;
+
+        void write(u64 address, const u8 *data, size_t size);
+        void erase(u64 address, size_t size = 1);
+        void clear();
+
+        /* Moves all runs at or after the address by the distance, for data that got inserted or removed in front of them. Removed ranges have to be erased first */
+        void move(u64 address, s64 distance);
+
+        [[nodiscard]] std::optional<u8> get(u64 address) const;
+        [[nodiscard]] bool contains(u64 address) const;
+
+        /* Copies the patched bytes of the range into the buffer, returns whether there were any */
+        bool overlay(u64 address, u8 *buffer, size_t size) const;
+        [[nodiscard]] bool overlaps(u64 address, size_t size) const;
+
+        [[nodiscard]] bool empty() const { return this->m_runs->empty(); }
+        [[nodiscard]] size_t size() const { return this->m_byteCount; }
+
+        [[nodiscard]] const std::map<u64, std::vector<u8>>& getRuns() const { return *this->m_runs; }
+
+        /* Changes with every modification and is shared by copies, so anything derived from the runs can tell when it's outdated */
+        [[nodiscard]] u64 getGeneration() const { return this->m_generation; }
+
+        [[nodiscard]] std::map<u64, u8> toByteMap() const;
+        static PatchStore fromByteMap(const std::map<u64, u8> &bytes);
+
+    private:
+        using Runs = std::map<u64, std::vector<u8>>;
+        using RunIterator = Runs::const_iterator;
+        [[nodiscard]] RunIterator findFirstRunEndingAfter(u64 address) const;
+
+        /* Gives this store its own runs before they get modified */
+        Runs& detach();
+
+        // Never null, moving only copies the pointer as well so a moved from store stays usable
+        std::shared_ptr<Runs> m_runs = std::make_shared<Runs>();
+        size_t m_byteCount = 0;
+        u64 m_generation = 0;
+    };
+
+}
\ No newline at end of file
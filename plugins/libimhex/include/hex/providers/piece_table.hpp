@@ -0,0 +1,87 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <functional>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace hex::prv {
+
+    /*
+        Describes the data as a sequence of pieces, each either a range of the original data or of a buffer all inserted bytes get appended to.
+        The pieces are kept in a treap ordered by their position in the data, so inserting, removing and finding an offset all take logarithmic time
+        no matter how large the data is or how many edits were made. The original data itself is never touched
+    */
+    class PieceTable {
+    public:
+        struct Piece {
+            u64 offset;     // Into the original data or the added data
+            size_t size;
+            bool added;
+        };
+
+        explicit PieceTable(size_t originalSize = 0);
+        ~PieceTable();
+
+        /* Copies all pieces and the added data, so the copy can be edited without touching the original */
+        PieceTable(const PieceTable &other);
+        PieceTable& operator=(const PieceTable&) = delete;
+
+        /* Drops all edits and starts over with a single piece covering the original data */
+        void reset(size_t originalSize);
+
+        void insert(u64 offset, const u8 *data, size_t size);
+        void erase(u64 offset, size_t size);
+
+        /* Original data that grew behind its old end shows up behind everything else */
+        void appendOriginal(u64 offset, size_t size);
+
+        [[nodiscard]] size_t getSize() const;
+
+        /* False until the first insert or erase, as long as it's false every offset maps to the same original offset */
+        [[nodiscard]] bool isModified() const { return this->m_modified; }
+
+        /* Calls the callback for every piece covering the range, in order and cut down to the range */
+        void forEachPiece(u64 offset, size_t size, const std::function<void(const Piece&)> &callback) const;
+
+        /* Fills the buffer from the pieces, ranges of the original data get requested from the callback */
+        void read(u64 offset, u8 *buffer, size_t size, const std::function<void(u64, u8*, size_t)> &readOriginal) const;
+
+        /* Original offset of the range if all of it lies within a single piece of the original data */
+        [[nodiscard]] std::optional<u64> getOriginalOffset(u64 offset, size_t size) const;
+
+        [[nodiscard]] const std::vector<u8>& getAddedData() const { return this->m_addedData; }
+
+    private:
+        struct Node {
+            Piece piece;
+            u32 priority;
+            size_t subtreeSize;
+            std::unique_ptr<Node> left, right;
+        };
+
+        using NodePtr = std::unique_ptr<Node>;
+
+        static void update(Node *node);
+        static size_t sizeOf(const NodePtr &node) { return node == nullptr ? 0 : node->subtreeSize; }
+
+        /* Splits the tree into the first offset bytes and the rest, cutting a piece in two if the offset falls inside of it */
+        std::pair<NodePtr, NodePtr> split(NodePtr node, u64 offset);
+        static NodePtr merge(NodePtr left, NodePtr right);
+        static NodePtr copy(const Node *node);
+
+        NodePtr createNode(const Piece &piece);
+        static bool extendLast(Node *node, const Piece &piece);
+
+        void visit(const Node *node, u64 nodeStart, u64 offset, u64 end, const std::function<void(const Piece&)> &callback) const;
+
+        NodePtr m_root;
+        std::vector<u8> m_addedData;
+        bool m_modified = false;
+
+        u32 m_randomState = 0x9E37'79B9;
+    };
+
+}
@@ -2,19 +2,51 @@
 
 #include <hex.hpp>
 
+#include <atomic>
+#include <deque>
+#include <list>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <optional>
+#include <span>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
+#include <hex/helpers/memory_budget.hpp>
 #include <hex/helpers/shared_data.hpp>
+#include <hex/helpers/utils.hpp>
+#include <hex/providers/io_statistics.hpp>
 #include <hex/providers/overlay.hpp>
+#include <hex/providers/patch_store.hpp>
+#include <hex/providers/piece_table.hpp>
 
 namespace hex::prv {
 
     class Provider {
     public:
-        constexpr static size_t PageSize = 0x1000'0000;
+        /* The hex editor scrolls through all of the data, so a single page covers everything. Pages are only kept around for existing callers */
+        constexpr static size_t PageSize = 0x1000'0000'0000'0000;
+        constexpr static size_t DefaultUndoHistoryBudget = 0x100'0000;
+        constexpr static size_t BlockCacheBlockSize = 0x1'0000;
+        constexpr static size_t SaveBlockSize = 0x100'0000;
+
+        enum class AccessHint {
+            Normal,
+            Sequential,
+            Random,
+            WillNeed
+        };
+
+        /* What a provider can do cheaply, so analyses can pick the fastest way of reading its data */
+        enum class Capability : u32 {
+            None                = 0,
+            DirectAccess        = 1 << 0,   // getMappedData returns the data, it can be used in place without copying it
+            AsyncReads          = 1 << 1,   // Large reads get split up and run asynchronously, few large reads are faster than many small ones
+            ThreadSafeReads     = 1 << 2,   // Reads from several threads run at the same time instead of waiting for each other
+            CheapRandomAccess   = 1 << 3    // Jumping around in the data costs about as much as reading it in order
+        };
 
         Provider();
         virtual ~Provider();
@@ -23,16 +55,111 @@ namespace hex::prv {
         virtual bool isReadable() = 0;
         virtual bool isWritable() = 0;
 
+        /*
+            Reads are safe from any number of threads at once, even while another thread edits the data. Every read sees either all or none
+            of an edit and reads never wait for each other. Edits lock each other out, but transactions and the undo history belong to whichever
+            thread edits, usually the main thread. Because of that, readRaw of every provider has to be safe to call from several threads at once
+        */
+
+        /* Offsets passed to read and write are relative to the current page, patches and then overlays are applied on top of the raw data */
         virtual void read(u64 offset, void *buffer, size_t size);
         virtual void write(u64 offset, const void *buffer, size_t size);
 
+        /* Same as read and write but with an absolute address, so analyses can cover the whole data without stepping through the pages */
+        void readAbsolute(u64 address, void *buffer, size_t size);
+        void writeAbsolute(u64 address, const void *buffer, size_t size);
+
+        /* Offsets passed to readRaw and writeRaw are absolute offsets into the underlying data, which doesn't know about inserted or removed bytes */
         virtual void readRaw(u64 offset, void *buffer, size_t size) = 0;
         virtual void writeRaw(u64 offset, const void *buffer, size_t size) = 0;
-        virtual size_t getActualSize() = 0;
+        virtual size_t getRawSize() = 0;
+
+        /* Size of the data as the editor sees it, including inserted and removed bytes */
+        size_t getActualSize();
+
+        /* Tells the provider how an absolute range is about to be read so it can prepare the underlying data. Providers are free to ignore it */
+        virtual void adviseAccess(u64 address, size_t size, AccessHint hint) { }
+
+        /* Absolute regions whose data changed behind the editor's back since the last call, for providers whose data is live */
+        virtual std::vector<Region> getChangedRegions() { return { }; }
+
+        /*
+            Following is meant for data that keeps growing, like logs or captures that are still being written.
+            Providers that support it only look for appended data and the editor keeps the end of the data in view
+        */
+        virtual bool canFollow() { return false; }
+        virtual void setFollowing(bool following) { this->m_following = following; }
+        [[nodiscard]] bool isFollowing() const { return this->m_following; }
+
+        /* Start of the raw data for providers that keep all of it in memory, such as memory mapped files */
+        virtual const u8* getMappedData() { return nullptr; }
+
+        /* Capabilities can change while the provider is open, such as a file that stops being mapped, so they shouldn't be cached for long */
+        virtual Capability getCapabilities() { return Capability::None; }
+        [[nodiscard]] bool hasCapability(Capability capability);
+
+        /*
+            Number of workers worth reading the data in parallel, at most the given count or one per task manager worker if it's 0.
+            Providers whose reads wait for each other get two, so one of them can process its data while the other one reads
+        */
+        [[nodiscard]] u32 getReadWorkerCount(u32 workers = 0);
+
+        /* Page relative view straight into the mapped data. Only available if no patches or overlays cover any of the range */
+        [[nodiscard]] std::optional<std::span<const u8>> getDirectView(u64 offset, size_t size);
+        [[nodiscard]] std::optional<std::span<const u8>> getAbsoluteDirectView(u64 address, size_t size);
 
-        std::map<u64, u8>& getPatches();
+        /* Copy of the patches that shares their runs, so it's cheap to take and stays valid while the data gets edited */
+        [[nodiscard]] PatchStore getPatches();
+        /* Both change the patches without going through the undo history */
+        void setPatches(const PatchStore &patches);
+        void erasePatches(u64 address, size_t size);
         void applyPatches();
 
+        /*
+            Inserts or removes bytes at an absolute address, moving all data behind it. The underlying data stays untouched,
+            a piece table maps the addresses instead until the data gets saved to a new file. Both clear the undo history
+        */
+        void insert(u64 address, const void *buffer, size_t size);
+        void remove(u64 address, size_t size);
+        [[nodiscard]] bool hasStructuralChanges();
+        /* Pieces as the editing thread sees them, other threads must not use them */
+        [[nodiscard]] const PieceTable& getPieces() const;
+
+        /*
+            Writes the data with all patches applied to a new file in one sequential pass, streaming the pieces out in order if bytes were inserted or removed.
+            Overlays only change what's shown and don't get saved
+        */
+        virtual bool saveAs(const std::string &path);
+
+        /* Both return the absolute region of the data that changed */
+        Region undo();
+        Region redo();
+        [[nodiscard]] bool canUndo() const;
+        [[nodiscard]] bool canRedo() const;
+        void clearUndoHistory();
+
+        /*
+            Edits made until the matching commit only get collected, committing applies all of them as a single undo step.
+            Transactions can be nested, only the outermost commit applies the edits. Rolling back discards all of them
+        */
+        void beginTransaction();
+        void commitTransaction();
+        void rollbackTransaction();
+        [[nodiscard]] bool isInTransaction() const;
+
+        void setUndoHistoryBudget(size_t budget);
+        [[nodiscard]] size_t getUndoHistoryBudget() const;
+
+        /* Caches raw data in fixed size blocks. Useful for providers whose readRaw is expensive, disabled when set to 0 */
+        void setBlockCacheSize(size_t size);
+        [[nodiscard]] size_t getBlockCacheSize() const;
+        void invalidateBlockCache();
+        void invalidateBlockCache(u64 offset, size_t size);
+        [[nodiscard]] u64 getBlockCacheHits() const;
+        [[nodiscard]] u64 getBlockCacheMisses() const;
+
+        [[nodiscard]] IOStatistics& getIOStatistics() { return this->m_ioStatistics; }
+
         [[nodiscard]] Overlay* newOverlay();
         void deleteOverlay(Overlay *overlay);
         [[nodiscard]] const std::list<Overlay*>& getOverlays();
@@ -48,12 +175,136 @@ namespace hex::prv {
 
         virtual std::vector<std::pair<std::string, std::string>> getDataInformation() = 0;
 
+        /* Short name to tell open providers apart, like the name of the file */
+        virtual std::string getName() { return ""; }
+
+        /* Path of the regular file the data comes from, empty if there's none. Used to recognize data that was analyzed before */
+        virtual std::string getFilePath() { return ""; }
+
     protected:
-        u32 m_currPage = 0;
+        void addPatch(u64 offset, const void *buffer, size_t size);
+
+        /* Called by providers whose raw data grew, the new data shows up behind everything else even if bytes were inserted or removed */
+        void appendRawData(size_t oldSize);
+
+        std::atomic<u32> m_currPage = 0;
         u64 m_baseAddress = 0;
 
-        std::vector<std::map<u64, u8>> m_patches;
+        PatchStore m_patches;
         std::list<Overlay*> m_overlays;
+
+        std::atomic<bool> m_following = false;
+
+    private:
+        /* A single undo step, made of one edit per contiguous range. Old values are empty if the byte wasn't patched before the edit */
+        struct EditRecord {
+            struct Edit {
+                u64 offset;
+                std::vector<std::optional<u8>> oldValues;
+                std::vector<u8> newValues;
+            };
+
+            std::vector<Edit> edits;
+
+            [[nodiscard]] size_t getMemoryUsage() const {
+                size_t usage = sizeof(EditRecord);
+                for (const auto &edit : this->edits)
+                    usage += sizeof(Edit) + edit.oldValues.size() * sizeof(std::optional<u8>) + edit.newValues.size();
+
+                return usage;
+            }
+
+            [[nodiscard]] Region getRegion() const;
+        };
+
+        /* Patches the range and returns the edit needed to undo it */
+        EditRecord::Edit applyEdit(u64 offset, const u8 *data, size_t size);
+        void pushEditRecord(EditRecord &&record);
+        void trimUndoHistory();
+
+        /*
+            Everything reads need besides the raw data. Edits only change the editing thread's own patches and pieces and mark the state as outdated,
+            the next read publishes a new one. Readers keep using the state they loaded without holding any lock, states share everything that didn't change
+        */
+        struct ReadState {
+            PatchStore patches;
+            PatchStore transactionPatches;
+            std::shared_ptr<const PieceTable> pieces;   // Null until the first insert or remove
+        };
+
+        [[nodiscard]] std::shared_ptr<const ReadState> getReadState();
+        [[nodiscard]] size_t getActualSize(const ReadState &state);
+        /* Size of the data as the edits see it, only used while holding the edit lock */
+        [[nodiscard]] size_t getEditedSize();
+        /* Gives the edits their own pieces before they get modified, if a published state still uses them */
+        PieceTable& detachPieces();
+
+        /* Reads the data through the state's pieces, without any patches or overlays applied */
+        void readData(const ReadState &state, u64 address, u8 *buffer, size_t size);
+        void readCached(u64 offset, void *buffer, size_t size);
+        /* Calls readRaw, timing it while the I/O statistics are enabled */
+        void readRawCounted(u64 offset, void *buffer, size_t size);
+        void trimBlockCache();
+        size_t evictBlockCache(size_t bytes);
+
+        friend class Overlay;
+        void rebuildOverlayIndex();
+        void applyOverlays(u64 offset, u8 *buffer, size_t size);
+        [[nodiscard]] bool overlaysOverlap(u64 offset, size_t size);
+
+        std::deque<EditRecord> m_editLog;
+        size_t m_editLogPosition = 0;
+        size_t m_editLogMemoryUsage = 0;
+        size_t m_undoHistoryBudget = DefaultUndoHistoryBudget;
+
+        PatchStore m_transactionPatches;
+        u32 m_transactionDepth = 0;
+
+        // Stays empty until the first insert or remove, reads go straight to the raw data until then
+        std::shared_ptr<PieceTable> m_pieces = std::make_shared<PieceTable>();
+
+        // Held by every edit. Recursive since edits check the size of the data, which may publish a new state
+        std::recursive_mutex m_editMutex;
+        // Only ever accessed through std::atomic_load and std::atomic_store
+        std::shared_ptr<const ReadState> m_readState;
+        std::atomic<bool> m_readStateOutdated = true;
+
+        struct CacheBlock {
+            u64 index;
+            std::vector<u8> data;
+        };
+
+        std::mutex m_blockCacheMutex;
+        std::list<CacheBlock> m_blockCache;
+        std::unordered_map<u64, std::list<CacheBlock>::iterator> m_blockCacheLookup;
+        size_t m_blockCacheSize = 0;
+        u64 m_blockCacheHits = 0, m_blockCacheMisses = 0;
+
+        IOStatistics m_ioStatistics;
+
+        // Destroyed before the cache itself so eviction can't run on a cache that's already gone
+        MemoryBudget::Cache m_blockCacheBudget;
+
+        /*
+            Non-overlapping ranges of absolute addresses, each taken from the most recently added overlay covering it.
+            Rebuilt whenever an overlay changes so reads only have to do a single range query
+        */
+        struct OverlaySegment {
+            u64 end;
+            const Overlay *overlay;
+        };
+
+        std::mutex m_overlayMutex;
+        std::map<u64, OverlaySegment> m_overlayIndex;
+        std::atomic<bool> m_hasOverlayData = false;
     };
 
+    constexpr Provider::Capability operator|(Provider::Capability left, Provider::Capability right) {
+        return Provider::Capability(u32(left) | u32(right));
+    }
+
+    constexpr Provider::Capability operator&(Provider::Capability left, Provider::Capability right) {
+        return Provider::Capability(u32(left) & u32(right));
+    }
+
 }
\ No newline at end of file
@@ -40,7 +40,20 @@ namespace hex {
         static void doLater(std::function<void()> &&function);
         static std::vector<std::function<void()>>& getDeferedCalls();
 
-        static std::vector<std::any> postEvent(Events eventType, const std::any &userData = { });
+        /* The main loop sleeps while nothing happens, background tasks call this from any thread once they have something new to show */
+        static void requestRedraw();
+
+        static void postEvent(Events eventType, const std::any &userData = { });
+
+        template<typename T>
+        static void postEvent(Events eventType, const T &payload) {
+            EventManager::post(eventType, payload);
+        }
+
+        template<typename T>
+        static void postEventCoalesced(Events eventType, const T &payload, std::chrono::milliseconds debounce = std::chrono::milliseconds(0)) {
+            EventManager::postCoalesced(eventType, payload, debounce);
+        }
 
         static void drawCommonInterfaces();
 
@@ -52,16 +65,37 @@ namespace hex {
 
         bool& getWindowOpenState();
 
+        /* Whether the window of the view was shown in the last frame. Closed and collapsed windows and tabs in the background of a dock aren't */
+        [[nodiscard]] bool isVisible() const { return this->m_visible; }
+
+        /* Gets called by the main loop once the view was drawn, whether it got processed or not */
+        void updateVisibility();
+
         std::string_view getUnlocalizedName() const;
 
     protected:
         void subscribeEvent(Events eventType, const std::function<std::any(const std::any&)> &callback);
         void subscribeEvent(Events eventType, const std::function<void(const std::any&)> &callback);
 
+        /* Handlers for events that get posted often, the payload doesn't have to be unpacked from a std::any */
+        template<typename T>
+        void subscribeEvent(Events eventType, const std::function<void(const T&)> &callback) {
+            EventManager::subscribe<T>(eventType, this, callback);
+        }
+
         void unsubscribeEvent(Events eventType);
 
         void discardNavigationRequests();
 
+        /*
+            Marks the content of the view as outdated. Events only invalidate it, the refresh itself happens in refreshContent which gets called
+            from inside of the view's window. A hidden view never gets there, so any number of invalidations turn into a single refresh once it's shown
+        */
+        void invalidateContent() { this->m_contentInvalidated = true; }
+
+        /* Runs the refresh if the content got invalidated since the last one. Returns whether it ran */
+        bool refreshContent(const std::function<void()> &refresh);
+
         void confirmButtons(const char *textLeft, const char *textRight, const std::function<void()> &leftButtonFn, const std::function<void()> &rightButtonFn);
 
         static inline std::string toWindowName(std::string_view unlocalizedName) {
@@ -71,6 +105,8 @@ namespace hex {
     private:
         std::string m_unlocalizedViewName;
         bool m_windowOpen = this->hasViewMenuItemEntry();
+        bool m_visible = false;
+        bool m_contentInvalidated = true;
     };
 
 }
\ No newline at end of file
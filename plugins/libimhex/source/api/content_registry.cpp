@@ -4,6 +4,7 @@
 
 #include <filesystem>
 #include <fstream>
+#include <stdexcept>
 
 namespace hex {
 
@@ -20,15 +21,69 @@ namespace hex {
         }
     }
 
-    void ContentRegistry::Settings::store() {
-        for (const auto &dir : hex::getPath(ImHexPath::Config)) {
-            std::ofstream settingsFile(dir + "/settings.json", std::ios::trunc);
+    namespace {
 
-            if (settingsFile.good()) {
-                settingsFile << getSettingsData();
-                break;
+        /* Written under a temporary name first and then renamed over the old file, so it's either completely old or completely new */
+        void writeSettingsFile(const std::string &content) {
+            for (const auto &dir : hex::getPath(ImHexPath::Config)) {
+                auto path = std::filesystem::path(dir) / "settings.json";
+                auto temporaryPath = std::filesystem::path(dir) / "settings.json.tmp";
+
+                std::error_code error;
+                {
+                    std::ofstream settingsFile(temporaryPath, std::ios::trunc);
+                    if (!settingsFile.good())
+                        continue;
+
+                    settingsFile << content;
+                    settingsFile.close();
+
+                    if (!settingsFile) {
+                        std::filesystem::remove(temporaryPath, error);
+                        continue;
+                    }
+                }
+
+                std::filesystem::rename(temporaryPath, path, error);
+                if (!error)
+                    break;
+
+                std::filesystem::remove(temporaryPath, error);
             }
         }
+
+    }
+
+    void ContentRegistry::Settings::store() {
+        // A write that's still running would otherwise replace this one with older settings
+        SharedData::settingsStoreTask.wait();
+        SharedData::settingsStoreTime.reset();
+
+        writeSettingsFile(getSettingsData().dump());
+    }
+
+    void ContentRegistry::Settings::storeLater() {
+        SharedData::settingsStoreTime = std::chrono::steady_clock::now() + StoreDebounceTime;
+    }
+
+    void ContentRegistry::Settings::storePending() {
+        if (!SharedData::settingsStoreTime.has_value() || std::chrono::steady_clock::now() < *SharedData::settingsStoreTime)
+            return;
+
+        // Writes happen one after another, the next frame tries again once the last one is done
+        if (SharedData::settingsStoreTask.isRunning())
+            return;
+
+        SharedData::settingsStoreTime.reset();
+
+        // The settings are only ever touched on the main thread, the task gets a finished copy of them
+        SharedData::settingsStoreTask = TaskManager::createTask("hex.common.storing_settings", 0, [content = getSettingsData().dump()](Task &) {
+            writeSettingsFile(content);
+        });
+    }
+
+    bool ContentRegistry::Settings::hasPendingStore() {
+        return SharedData::settingsStoreTime.has_value();
     }
 
     void ContentRegistry::Settings::add(std::string_view unlocalizedCategory, std::string_view unlocalizedName, s64 defaultValue, const std::function<bool(std::string_view, nlohmann::json&)> &callback) {
@@ -60,6 +115,8 @@ namespace hex {
             json[unlocalizedCategory.data()] = nlohmann::json::object();
 
         json[unlocalizedCategory.data()][unlocalizedName.data()] = value;
+
+        storeLater();
     }
 
     void ContentRegistry::Settings::write(std::string_view unlocalizedCategory, std::string_view unlocalizedName, std::string_view value) {
@@ -69,6 +126,8 @@ namespace hex {
             json[unlocalizedCategory.data()] = nlohmann::json::object();
 
         json[unlocalizedCategory.data()][unlocalizedName.data()] = value;
+
+        storeLater();
     }
 
     void ContentRegistry::Settings::write(std::string_view unlocalizedCategory, std::string_view unlocalizedName, const std::vector<std::string>& value) {
@@ -78,6 +137,8 @@ namespace hex {
             json[unlocalizedCategory.data()] = nlohmann::json::object();
 
         json[unlocalizedCategory.data()][unlocalizedName.data()] = value;
+
+        storeLater();
     }
 
 
@@ -163,12 +224,17 @@ namespace hex {
 
     void ContentRegistry::PatternLanguageFunctions::add(std::string_view name, u32 parameterCount, const std::function<hex::lang::ASTNode*(hex::lang::Evaluator&, std::vector<hex::lang::ASTNode*>)> &func) {
         getEntries()[name.data()] = Function{ parameterCount, func };
+        SharedData::patternLanguageFunctionNames.emplace(name);
     }
 
     std::map<std::string, ContentRegistry::PatternLanguageFunctions::Function>& ContentRegistry::PatternLanguageFunctions::getEntries() {
         return SharedData::patternLanguageFunctions;
     }
 
+    bool ContentRegistry::PatternLanguageFunctions::exists(std::string_view name) {
+        return SharedData::patternLanguageFunctionNames.contains(name);
+    }
+
 
     /* Views */
 
@@ -194,8 +260,15 @@ namespace hex {
 
     /* Data Inspector */
 
-    void ContentRegistry::DataInspector::add(std::string_view unlocalizedName, size_t requiredSize, ContentRegistry::DataInspector::GeneratorFunction function) {
-        getEntries().push_back({ unlocalizedName.data(), requiredSize, std::move(function) });
+    void ContentRegistry::DataInspector::add(std::string_view unlocalizedName, size_t requiredSize, ContentRegistry::DataInspector::FormatFunction formatFunction, ContentRegistry::DataInspector::DrawFunction drawFunction) {
+        if (requiredSize > MaxRequiredSize)
+            throw std::invalid_argument("Data inspector entry requires too many bytes!");
+
+        getEntries().push_back({ unlocalizedName.data(), requiredSize, std::move(formatFunction), std::move(drawFunction), std::nullopt });
+    }
+
+    void ContentRegistry::DataInspector::add(std::string_view unlocalizedName, ValueType valueType, ContentRegistry::DataInspector::FormatFunction formatFunction, ContentRegistry::DataInspector::DrawFunction drawFunction) {
+        getEntries().push_back({ unlocalizedName.data(), ValueSearcher::getSize(valueType), std::move(formatFunction), std::move(drawFunction), valueType });
     }
 
     std::vector<ContentRegistry::DataInspector::Entry>& ContentRegistry::DataInspector::getEntries() {
@@ -216,6 +289,25 @@ namespace hex {
         return SharedData::dataProcessorNodes;
     }
 
+    /* Providers */
+
+    void ContentRegistry::Providers::add(std::string_view unlocalizedName, const CreatorFunction &creatorFunction) {
+        getEntries().push_back(Entry{ unlocalizedName.data(), creatorFunction });
+    }
+
+    prv::Provider* ContentRegistry::Providers::create(std::string_view unlocalizedName, const std::string &path) {
+        for (const auto &entry : getEntries()) {
+            if (entry.unlocalizedName == unlocalizedName)
+                return entry.creatorFunction(path);
+        }
+
+        return nullptr;
+    }
+
+    std::vector<ContentRegistry::Providers::Entry>& ContentRegistry::Providers::getEntries() {
+        return SharedData::providerEntries;
+    }
+
     /* Languages */
 
     void ContentRegistry::Language::registerLanguage(std::string_view name, std::string_view languageCode) {
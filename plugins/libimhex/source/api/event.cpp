@@ -2,29 +2,149 @@
 
 #include <hex/helpers/shared_data.hpp>
 
+#include <algorithm>
+
 namespace hex {
 
-    std::vector<std::any> EventManager::post(Events eventType, const std::any &userData) {
+    namespace {
+
+        /*
+            Handlers may subscribe and unsubscribe while the event is being posted. The next handler gets looked up by its id so that
+            never invalidates anything, handlers that subscribed in the meantime don't get the event anymore
+        */
+        template<typename Function>
+        void forEachHandler(Events eventType, Function &&function) {
+            auto list = SharedData::eventHandlers.find(eventType);
+            if (list == SharedData::eventHandlers.end() || list->second.handlers.empty())
+                return;
+
+            auto &[handlers, owners, nextId, postDepth, hasRemovedHandlers] = list->second;
+            u64 lastId = handlers.rbegin()->first;
+
+            postDepth++;
+            for (auto it = handlers.begin(); it != handlers.end() && it->first <= lastId; it = handlers.upper_bound(it->first)) {
+                if (!it->second.removed)
+                    function(it->second);
+            }
+            postDepth--;
+
+            if (postDepth == 0 && hasRemovedHandlers) {
+                std::erase_if(handlers, [](const auto &entry) { return entry.second.removed; });
+                hasRemovedHandlers = false;
+            }
+        }
+
+    }
+
+    void EventManager::post(Events eventType, const std::any &userData) {
+        forEachHandler(eventType, [&](EventHandler &handler) {
+            handler.callback(userData);
+        });
+    }
+
+    std::vector<std::any> EventManager::postWithResults(Events eventType, const std::any &userData) {
         std::vector<std::any> results;
-        for (auto &handler : SharedData::eventHandlers)
-            if (eventType == handler.eventType)
-                results.push_back(handler.callback(userData));
+
+        forEachHandler(eventType, [&](EventHandler &handler) {
+            results.push_back(handler.callback(userData));
+        });
 
         return results;
     }
 
-    void EventManager::subscribe(Events eventType, void *owner, std::function<std::any(const std::any&)> callback) {
-        for (auto &handler : SharedData::eventHandlers)
-            if (eventType == handler.eventType && owner == handler.owner)
+    void EventManager::postTyped(Events eventType, const std::type_info &payloadType, const void *payload, std::any(*wrap)(const void*)) {
+        std::optional<std::any> wrappedPayload;
+        forEachHandler(eventType, [&](EventHandler &handler) {
+            if (handler.payloadType != nullptr) {
+                if (*handler.payloadType == payloadType)
+                    handler.typedCallback(payload);
                 return;
+            }
+
+            if (!wrappedPayload.has_value())
+                wrappedPayload = wrap(payload);
 
-        SharedData::eventHandlers.push_back(EventHandler { owner, eventType, callback });
+            handler.callback(*wrappedPayload);
+        });
+    }
+
+    void EventManager::coalesce(Events eventType, std::function<void()> &&deliver, std::chrono::milliseconds debounce) {
+        SharedData::coalescedEvents[eventType] = CoalescedEvent { std::move(deliver), std::chrono::steady_clock::now() + debounce };
     }
 
-    void EventManager::unsubscribe(Events eventType, void *sender) {
-        std::erase_if(SharedData::eventHandlers, [&eventType, &sender](EventHandler handler) {
-            return eventType == handler.eventType && sender == handler.owner;
+    void EventManager::deliverCoalesced() {
+        if (SharedData::coalescedEvents.empty())
+            return;
+
+        auto now = std::chrono::steady_clock::now();
+
+        // Handlers may post coalesced events again, so everything that's due gets taken out of the map first
+        std::vector<std::function<void()>> dueEvents;
+        std::erase_if(SharedData::coalescedEvents, [&](auto &entry) {
+            auto &[eventType, event] = entry;
+            if (event.deliverAt > now)
+                return false;
+
+            dueEvents.push_back(std::move(event.deliver));
+            return true;
         });
+
+        for (auto &deliver : dueEvents)
+            deliver();
+    }
+
+    EventToken EventManager::subscribe(Events eventType, void *owner, std::function<std::any(const std::any&)> callback) {
+        return addHandler(EventHandler { owner, eventType, std::move(callback) });
+    }
+
+    EventToken EventManager::addHandler(EventHandler &&handler) {
+        auto &list = SharedData::eventHandlers[handler.eventType];
+
+        if (handler.owner != nullptr) {
+            if (auto existing = list.owners.find(handler.owner); existing != list.owners.end())
+                return { handler.eventType, existing->second };
+
+            list.owners[handler.owner] = list.nextId;
+        }
+
+        EventToken token = { handler.eventType, list.nextId++ };
+        list.handlers.emplace(token.id, std::move(handler));
+
+        return token;
+    }
+
+    void EventManager::removeHandler(EventHandlerList &list, u64 id) {
+        auto handler = list.handlers.find(id);
+        if (handler == list.handlers.end() || handler->second.removed)
+            return;
+
+        if (handler->second.owner != nullptr)
+            list.owners.erase(handler->second.owner);
+
+        // The handler might be the one that's running right now
+        if (list.postDepth > 0) {
+            handler->second.removed = true;
+            list.hasRemovedHandlers = true;
+        } else {
+            list.handlers.erase(handler);
+        }
+    }
+
+    void EventManager::unsubscribe(Events eventType, void *owner) {
+        auto list = SharedData::eventHandlers.find(eventType);
+        if (list == SharedData::eventHandlers.end())
+            return;
+
+        if (auto id = list->second.owners.find(owner); id != list->second.owners.end())
+            removeHandler(list->second, id->second);
+    }
+
+    void EventManager::unsubscribe(const EventToken &token) {
+        auto list = SharedData::eventHandlers.find(token.eventType);
+        if (list == SharedData::eventHandlers.end())
+            return;
+
+        removeHandler(list->second, token.id);
     }
 
 }
\ No newline at end of file
@@ -2,6 +2,9 @@
 
 #include <hex/api/event.hpp>
 #include <hex/helpers/shared_data.hpp>
+#include <hex/providers/provider.hpp>
+
+#include <algorithm>
 
 namespace hex {
 
@@ -29,4 +32,105 @@ namespace hex {
         return SharedData::bookmarkEntries;
     }
 
+    void ImHexApi::Bookmarks::invalidate() {
+        SharedData::bookmarkTreeValid = false;
+    }
+
+    static const IntervalTree<ImHexApi::Bookmarks::Entry*>& getBookmarkTree() {
+        if (!SharedData::bookmarkTreeValid) {
+            std::vector<IntervalTree<ImHexApi::Bookmarks::Entry*>::Interval> intervals;
+            intervals.reserve(SharedData::bookmarkEntries.size());
+
+            for (auto &entry : SharedData::bookmarkEntries)
+                intervals.push_back({ entry.region.address, entry.region.address + entry.region.size, &entry });
+
+            SharedData::bookmarkTree.build(std::move(intervals));
+            SharedData::bookmarkTreeValid = true;
+        }
+
+        return SharedData::bookmarkTree;
+    }
+
+    std::vector<ImHexApi::Bookmarks::Entry*> ImHexApi::Bookmarks::getOverlapping(u64 address, size_t size) {
+        std::vector<Entry*> entries;
+        getBookmarkTree().forEachOverlapping(address, address + size, [&entries](Entry *entry) {
+            entries.push_back(entry);
+        });
+
+        return entries;
+    }
+
+    ImHexApi::Bookmarks::Entry* ImHexApi::Bookmarks::getNext(u64 address) {
+        auto interval = getBookmarkTree().findNext(address);
+        return interval == nullptr ? nullptr : interval->value;
+    }
+
+    ImHexApi::Bookmarks::Entry* ImHexApi::Bookmarks::getPrevious(u64 address) {
+        auto interval = getBookmarkTree().findPrevious(address);
+        return interval == nullptr ? nullptr : interval->value;
+    }
+
+    void ImHexApi::Highlighting::set(const std::string &name, std::vector<Entry> entries) {
+        SharedData::highlightEntries[name] = std::move(entries);
+        EventManager::post(Events::HighlightingChanged, { });
+    }
+
+    void ImHexApi::Highlighting::clear(const std::string &name) {
+        if (SharedData::highlightEntries.erase(name) > 0)
+            EventManager::post(Events::HighlightingChanged, { });
+    }
+
+    std::map<std::string, std::vector<ImHexApi::Highlighting::Entry>>& ImHexApi::Highlighting::getEntries() {
+        return SharedData::highlightEntries;
+    }
+
+    void ImHexApi::Provider::add(prv::Provider *provider) {
+        SharedData::providers.emplace_back(provider);
+        Provider::setCurrent(provider);
+    }
+
+    void ImHexApi::Provider::remove(prv::Provider *provider) {
+        auto &providers = SharedData::providers;
+
+        auto it = std::find_if(providers.begin(), providers.end(), [provider](const auto &entry) { return entry.get() == provider; });
+        if (it == providers.end())
+            return;
+
+        // The handle keeps the provider alive until everyone got told it's gone
+        auto handle = *it;
+        it = providers.erase(it);
+
+        if (SharedData::currentProvider == provider) {
+            if (it != providers.end())
+                Provider::setCurrent(it->get());
+            else
+                Provider::setCurrent(providers.empty() ? nullptr : providers.back().get());
+        }
+
+        EventManager::post(Events::ProviderClosed, provider);
+    }
+
+    void ImHexApi::Provider::setCurrent(prv::Provider *provider) {
+        auto previous = SharedData::currentProvider;
+        if (previous == provider)
+            return;
+
+        auto it = std::find_if(SharedData::providers.begin(), SharedData::providers.end(), [provider](const auto &entry) { return entry.get() == provider; });
+        if (it == SharedData::providers.end() && provider != nullptr)
+            return;
+
+        SharedData::currentProvider = provider;
+        SharedData::currentProviderHandle = provider != nullptr ? *it : nullptr;
+
+        EventManager::post(Events::ProviderChanged, previous);
+    }
+
+    const std::vector<std::shared_ptr<prv::Provider>>& ImHexApi::Provider::getProviders() {
+        return SharedData::providers;
+    }
+
+    std::shared_ptr<prv::Provider> ImHexApi::Provider::getHandle() {
+        return SharedData::currentProviderHandle;
+    }
+
 }
\ No newline at end of file
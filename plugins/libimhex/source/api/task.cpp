@@ -0,0 +1,329 @@
+#include <hex/api/task.hpp>
+
+#include <hex/views/view.hpp>
+#include <hex/helpers/tracing.hpp>
+#include <hex/providers/io_statistics.hpp>
+
+#include <algorithm>
+#include <deque>
+#include <thread>
+#include <vector>
+
+namespace hex {
+
+    namespace {
+
+        /*
+            Work stealing thread pool. Every worker has its own queue it takes jobs from the back of, jobs submitted from
+            outside of the pool go into a shared queue. Idle workers take from the shared queue first and steal from the
+            front of the other workers' queues after that, so nested parallel work stays on the worker that created it
+        */
+        class ThreadPool {
+        public:
+            struct Job {
+                std::function<void()> function;
+                const void *group = nullptr;
+            };
+
+            ThreadPool() {
+                auto workerCount = std::max(std::thread::hardware_concurrency(), 2U);
+
+                for (u32 i = 0; i < workerCount; i++)
+                    this->m_queues.push_back(std::make_unique<Queue>());
+
+                for (u32 i = 0; i < workerCount; i++)
+                    this->m_workers.emplace_back([this, i] { this->work(i); });
+            }
+
+            void submit(Job &&job) {
+                auto &queue = s_workerIndex >= 0 ? *this->m_queues[s_workerIndex] : this->m_sharedQueue;
+
+                {
+                    std::scoped_lock lock(queue.mutex);
+                    queue.jobs.push_back(std::move(job));
+                }
+
+                {
+                    std::scoped_lock lock(this->m_sleepMutex);
+                    this->m_pendingJobs++;
+                }
+                this->m_wakeUp.notify_one();
+            }
+
+            /* Runs one queued job, if group is set only a job belonging to it */
+            bool runPendingJob(const void *group = nullptr) {
+                Job job;
+                if (!this->takeJob(job, group))
+                    return false;
+
+                job.function();
+                return true;
+            }
+
+            [[nodiscard]] u32 getWorkerCount() const {
+                return this->m_workers.size();
+            }
+
+        private:
+            struct Queue {
+                std::mutex mutex;
+                std::deque<Job> jobs;
+
+                bool take(Job &job, bool fromBack, const void *group) {
+                    std::scoped_lock lock(this->mutex);
+
+                    if (group != nullptr) {
+                        auto it = std::find_if(this->jobs.begin(), this->jobs.end(), [group](const Job &job) { return job.group == group; });
+                        if (it == this->jobs.end())
+                            return false;
+
+                        job = std::move(*it);
+                        this->jobs.erase(it);
+                        return true;
+                    }
+
+                    if (this->jobs.empty())
+                        return false;
+
+                    if (fromBack) {
+                        job = std::move(this->jobs.back());
+                        this->jobs.pop_back();
+                    } else {
+                        job = std::move(this->jobs.front());
+                        this->jobs.pop_front();
+                    }
+
+                    return true;
+                }
+            };
+
+            bool takeJob(Job &job, const void *group) {
+                bool found = false;
+
+                if (s_workerIndex >= 0)
+                    found = this->m_queues[s_workerIndex]->take(job, true, group);
+
+                if (!found)
+                    found = this->m_sharedQueue.take(job, false, group);
+
+                for (size_t i = 0; i < this->m_queues.size() && !found; i++) {
+                    if (int(i) != s_workerIndex)
+                        found = this->m_queues[i]->take(job, false, group);
+                }
+
+                if (found)
+                    this->m_pendingJobs--;
+
+                return found;
+            }
+
+            void work(u32 index) {
+                s_workerIndex = index;
+                Tracing::setThreadName(hex::format("Worker {}", index));
+
+                while (true) {
+                    if (this->runPendingJob())
+                        continue;
+
+                    std::unique_lock lock(this->m_sleepMutex);
+                    this->m_wakeUp.wait(lock, [this] { return this->m_pendingJobs > 0; });
+                }
+            }
+
+            static thread_local int s_workerIndex;
+
+            std::vector<std::unique_ptr<Queue>> m_queues;
+            Queue m_sharedQueue;
+
+            std::mutex m_sleepMutex;
+            std::condition_variable m_wakeUp;
+            std::atomic<size_t> m_pendingJobs = 0;
+
+            std::vector<std::thread> m_workers;
+        };
+
+        thread_local int ThreadPool::s_workerIndex = -1;
+
+        // Never destroyed, tasks may still be running while the program exits
+        ThreadPool& getThreadPool() {
+            static auto pool = new ThreadPool();
+            return *pool;
+        }
+
+        std::mutex tasksMutex;
+        std::list<std::shared_ptr<Task>> runningTasks;
+
+    }
+
+
+    Task::Task(std::string unlocalizedName, u64 maxValue, std::function<void(Task&)> function)
+        : m_unlocalizedName(std::move(unlocalizedName)), m_function(std::move(function)), m_maxValue(maxValue) { }
+
+    void Task::update(u64 value) {
+        this->m_value = value;
+    }
+
+    void Task::setMaxValue(u64 maxValue) {
+        this->m_maxValue = maxValue;
+    }
+
+    void Task::interrupt() {
+        std::scoped_lock lock(this->m_interruptMutex);
+
+        this->m_interrupted = true;
+        if (this->m_interruptCallback)
+            this->m_interruptCallback();
+    }
+
+    void Task::setInterruptCallback(std::function<void()> callback) {
+        std::scoped_lock lock(this->m_interruptMutex);
+
+        this->m_interruptCallback = std::move(callback);
+        if (this->m_interrupted && this->m_interruptCallback)
+            this->m_interruptCallback();
+    }
+
+    bool Task::isInterrupted() const {
+        return this->m_interrupted;
+    }
+
+    const std::atomic<bool>& Task::getInterruptFlag() const {
+        return this->m_interrupted;
+    }
+
+    bool Task::isFinished() const {
+        return this->m_finished;
+    }
+
+    const std::string& Task::getUnlocalizedName() const {
+        return this->m_unlocalizedName;
+    }
+
+    float Task::getProgress() const {
+        if (this->m_maxValue == 0)
+            return -1.0F;
+
+        return std::min(float(this->m_value) / float(this->m_maxValue), 1.0F);
+    }
+
+    void Task::run() {
+        {
+            TRACE_SCOPE(this->m_unlocalizedName, "task");
+            this->m_function(*this);
+        }
+        this->m_function = nullptr;
+
+        {
+            std::scoped_lock lock(this->m_interruptMutex);
+            this->m_interruptCallback = nullptr;
+        }
+
+        {
+            std::scoped_lock lock(this->m_finishedMutex);
+            this->m_finished = true;
+        }
+        this->m_finishedSignal.notify_all();
+    }
+
+
+    bool TaskHolder::isRunning() const {
+        auto task = this->m_task.lock();
+        return task != nullptr && !task->isFinished();
+    }
+
+    float TaskHolder::getProgress() const {
+        auto task = this->m_task.lock();
+        return task == nullptr ? 1.0F : task->getProgress();
+    }
+
+    void TaskHolder::interrupt() {
+        if (auto task = this->m_task.lock(); task != nullptr)
+            task->interrupt();
+    }
+
+    void TaskHolder::wait() {
+        auto task = this->m_task.lock();
+        if (task == nullptr)
+            return;
+
+        std::unique_lock lock(task->m_finishedMutex);
+        task->m_finishedSignal.wait(lock, [&task] { return task->isFinished(); });
+    }
+
+
+    TaskHolder TaskManager::createTask(std::string unlocalizedName, u64 maxValue, std::function<void(Task&)> function) {
+        auto task = std::make_shared<Task>(std::move(unlocalizedName), maxValue, std::move(function));
+
+        {
+            std::scoped_lock lock(tasksMutex);
+            runningTasks.push_back(task);
+        }
+
+        getThreadPool().submit({ [task] {
+            // Reads done by the task get counted under its name
+            prv::IOStatistics::Scope ioScope(prv::IOStatistics::isEnabled() ? prv::IOStatistics::getTag(task->getUnlocalizedName()) : prv::IOStatistics::UntaggedTag);
+
+            task->run();
+
+            {
+                std::scoped_lock lock(tasksMutex);
+                runningTasks.remove(task);
+            }
+
+            View::requestRedraw();
+        } });
+
+        return TaskHolder(task);
+    }
+
+    void TaskManager::runParallel(u32 count, const std::function<void(u32)> &function) {
+        if (count == 0)
+            return;
+
+        auto &pool = getThreadPool();
+
+        std::atomic<u32> remaining = count;
+        for (u32 i = 1; i < count; i++) {
+            pool.submit({ [&, i, tag = prv::IOStatistics::getCurrentTag()] {
+                prv::IOStatistics::Scope ioScope(tag);
+                TRACE_SCOPE("Parallel job", "task", i);
+                function(i);
+                remaining--;
+            }, &remaining });
+        }
+
+        function(0);
+        remaining--;
+
+        // Only this call's jobs get picked up while waiting, anything else might take far longer than they do
+        while (remaining > 0) {
+            if (!pool.runPendingJob(&remaining))
+                std::this_thread::yield();
+        }
+    }
+
+    u32 TaskManager::getWorkerCount() {
+        return getThreadPool().getWorkerCount();
+    }
+
+    void TaskManager::interruptAll() {
+        for (auto &task : getRunningTasks())
+            task->interrupt();
+    }
+
+    void TaskManager::interruptAndWaitForAll() {
+        auto tasks = getRunningTasks();
+
+        for (auto &task : tasks)
+            task->interrupt();
+
+        for (auto &task : tasks)
+            TaskHolder(task).wait();
+    }
+
+    std::list<std::shared_ptr<Task>> TaskManager::getRunningTasks() {
+        std::scoped_lock lock(tasksMutex);
+        return runningTasks;
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,206 @@
+#include <hex/helpers/analysis_cache.hpp>
+
+#include <hex/providers/provider.hpp>
+#include <hex/helpers/crypto.hpp>
+#include <hex/helpers/utils.hpp>
+
+#include <algorithm>
+#include <fstream>
+
+namespace hex {
+
+    namespace {
+
+        constexpr char EntryMagic[8] = { 'I', 'M', 'H', 'X', 'C', 'A', 'C', 'H' };
+        constexpr u32 EntryVersion = 1;
+
+        /* Precedes the payload of every entry. The checksum catches entries that were only partially written */
+        struct EntryHeader {
+            char magic[8];
+            u32 version;
+            u32 checksum;
+            u64 payloadSize;
+        };
+
+        // Fingerprints hash this many evenly spread samples, always including the start and the end of the data
+        constexpr u64 SampleCount = 64;
+        constexpr u64 SampleSize  = 0x4000;
+
+        u32 calculateChecksum(const std::vector<u8> &data) {
+            crypt::Crc<u32> crc(0xEDB8'8320, 0xFFFF'FFFF);
+            crc.process(data.data(), data.size());
+
+            return crc.getValue();
+        }
+
+    }
+
+    u64 AnalysisCache::hashSamples(prv::Provider *provider, u64 size) {
+        // Two different polynomials together give a 64 bit hash
+        crypt::Crc<u32> first(0xEDB8'8320, 0xFFFF'FFFF), second(0x82F6'3B78, 0xFFFF'FFFF);
+
+        std::vector<u8> buffer(SampleSize);
+        const auto hashRange = [&](u64 offset, u64 rangeSize) {
+            for (u64 end = offset + rangeSize; offset < end; offset += buffer.size()) {
+                size_t readSize = std::min<u64>(buffer.size(), end - offset);
+                provider->readRaw(offset, buffer.data(), readSize);
+
+                first.process(buffer.data(), readSize);
+                second.process(buffer.data(), readSize);
+            }
+        };
+
+        if (size <= SampleCount * SampleSize) {
+            hashRange(0, size);
+        } else {
+            for (u64 sample = 0; sample < SampleCount; sample++)
+                hashRange((size - SampleSize) / (SampleCount - 1) * sample, SampleSize);
+        }
+
+        return (u64(first.getValue()) << 32) | second.getValue();
+    }
+
+    std::optional<std::filesystem::path> AnalysisCache::getEntryDirectory(prv::Provider *provider) {
+        if (provider == nullptr || !provider->isReadable() || !provider->getPatches().empty() || !provider->getOverlays().empty())
+            return { };
+
+        auto path = provider->getFilePath();
+        if (path.empty())
+            return { };
+
+        std::error_code error;
+        auto modificationTime = std::filesystem::last_write_time(path, error);
+        if (error)
+            return { };
+
+        Fingerprint fingerprint = { provider->getActualSize(), s64(modificationTime.time_since_epoch().count()), 0 };
+
+        bool known = false;
+        {
+            std::scoped_lock lock(AnalysisCache::s_mutex);
+
+            if (auto it = AnalysisCache::s_fingerprints.find(path); it != AnalysisCache::s_fingerprints.end()) {
+                if (it->second.size == fingerprint.size && it->second.modificationTime == fingerprint.modificationTime) {
+                    fingerprint.contentHash = it->second.contentHash;
+                    known = true;
+                }
+            }
+        }
+
+        if (!known) {
+            fingerprint.contentHash = hashSamples(provider, fingerprint.size);
+
+            std::scoped_lock lock(AnalysisCache::s_mutex);
+            AnalysisCache::s_fingerprints[path] = fingerprint;
+        }
+
+        auto cacheDirs = hex::getPath(ImHexPath::Cache);
+        if (cacheDirs.empty())
+            return { };
+
+        return std::filesystem::path(cacheDirs.front()) / "analysis" / hex::format("{:016X}-{:016X}-{:016X}", fingerprint.size, u64(fingerprint.modificationTime), fingerprint.contentHash);
+    }
+
+    void AnalysisCache::writeEntry(const std::filesystem::path &path, const Writer &writer) {
+        std::error_code error;
+        std::filesystem::create_directories(path.parent_path(), error);
+        if (error)
+            return;
+
+        EntryHeader header = { };
+        std::copy(std::begin(EntryMagic), std::end(EntryMagic), header.magic);
+        header.version = EntryVersion;
+        header.checksum = calculateChecksum(writer.getData());
+        header.payloadSize = writer.getData().size();
+
+        // Written under a temporary name first so no other instance ever sees a half written entry
+        auto temporaryPath = std::filesystem::path(path).replace_extension(".tmp");
+        {
+            std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+            if (!file)
+                return;
+
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(reinterpret_cast<const char*>(writer.getData().data()), writer.getData().size());
+
+            if (!file) {
+                file.close();
+                std::filesystem::remove(temporaryPath, error);
+                return;
+            }
+        }
+
+        std::filesystem::rename(temporaryPath, path, error);
+        if (error)
+            std::filesystem::remove(temporaryPath, error);
+    }
+
+    std::optional<AnalysisCache::Reader> AnalysisCache::readEntry(const std::filesystem::path &path) {
+        std::error_code error;
+        auto fileSize = std::filesystem::file_size(path, error);
+        if (error || fileSize < sizeof(EntryHeader))
+            return { };
+
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+            return { };
+
+        EntryHeader header = { };
+        if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+            return { };
+
+        if (!std::equal(std::begin(EntryMagic), std::end(EntryMagic), header.magic) || header.version != EntryVersion || header.payloadSize != fileSize - sizeof(header))
+            return { };
+
+        std::vector<u8> payload(header.payloadSize);
+        if (!file.read(reinterpret_cast<char*>(payload.data()), payload.size()))
+            return { };
+
+        if (calculateChecksum(payload) != header.checksum)
+            return { };
+
+        return Reader(std::move(payload));
+    }
+
+    void AnalysisCache::store(prv::Provider *provider, std::string_view analysis, const Writer &writer) {
+        auto directory = getEntryDirectory(provider);
+        if (!directory.has_value())
+            return;
+
+        writeEntry(directory.value() / (std::string(analysis) + ".bin"), writer);
+    }
+
+    std::optional<AnalysisCache::Reader> AnalysisCache::load(prv::Provider *provider, std::string_view analysis) {
+        auto directory = getEntryDirectory(provider);
+        if (!directory.has_value())
+            return { };
+
+        return readEntry(directory.value() / (std::string(analysis) + ".bin"));
+    }
+
+    void AnalysisCache::storeFile(const std::filesystem::path &path, const Writer &writer) {
+        auto cacheDirs = hex::getPath(ImHexPath::Cache);
+        if (cacheDirs.empty())
+            return;
+
+        writeEntry(std::filesystem::path(cacheDirs.front()) / path, writer);
+    }
+
+    std::optional<AnalysisCache::Reader> AnalysisCache::loadFile(const std::filesystem::path &path) {
+        auto cacheDirs = hex::getPath(ImHexPath::Cache);
+        if (cacheDirs.empty())
+            return { };
+
+        return readEntry(std::filesystem::path(cacheDirs.front()) / path);
+    }
+
+    bool AnalysisCache::contains(prv::Provider *provider, std::string_view analysis) {
+        auto directory = getEntryDirectory(provider);
+        if (!directory.has_value())
+            return false;
+
+        std::error_code error;
+        return std::filesystem::is_regular_file(directory.value() / (std::string(analysis) + ".bin"), error);
+    }
+
+}
\ No newline at end of file
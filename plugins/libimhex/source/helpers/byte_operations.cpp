@@ -0,0 +1,305 @@
+#include <hex/helpers/byte_operations.hpp>
+
+#include <hex/api/task.hpp>
+#include <hex/helpers/utils.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <numeric>
+#include <tuple>
+
+#if defined(__x86_64__) || defined(__i386__)
+    #include <immintrin.h>
+#endif
+
+namespace hex {
+
+    namespace {
+
+        template<size_t Width>
+        using UnsignedOfWidth = std::tuple_element_t<std::countr_zero(Width), std::tuple<u8, u16, u32, u64>>;
+
+        constexpr std::endian ForeignEndian = std::endian::native == std::endian::little ? std::endian::big : std::endian::little;
+
+        bool isPatternOperation(ByteOperation operation) {
+            return operation == ByteOperation::Fill || operation == ByteOperation::Xor || operation == ByteOperation::And || operation == ByteOperation::Or;
+        }
+
+    #if defined(__x86_64__) || defined(__i386__)
+
+        bool isAVX2Supported() {
+            static bool supported = __builtin_cpu_supports("avx2");
+            return supported;
+        }
+
+        /* Shuffle that reverses the bytes of every value of the given width within a 16 byte lane */
+        template<size_t Width>
+        constexpr std::array<u8, 16> makeSwapPattern() {
+            std::array<u8, 16> pattern = { };
+
+            for (size_t i = 0; i < 16; i++)
+                pattern[i] = (i / Width) * Width + (Width - 1 - i % Width);
+
+            return pattern;
+        }
+
+    #endif
+
+    }
+
+    ByteOperator::ByteOperator(ByteOperation operation, std::vector<u8> operand, u8 width, std::endian endian)
+        : m_operation(operation), m_operand(std::move(operand)), m_width(width), m_endian(endian) {
+
+        if (isPatternOperation(operation) && !this->m_operand.empty()) {
+            this->m_period = std::lcm(this->m_operand.size(), VectorSize);
+            this->m_pattern.resize(this->m_period + VectorSize);
+
+            for (size_t i = 0; i < this->m_pattern.size(); i++)
+                this->m_pattern[i] = this->m_operand[i % this->m_operand.size()];
+        }
+
+        if (operation == ByteOperation::Add)
+            std::memcpy(&this->m_addend, this->m_operand.data(), std::min(this->m_operand.size(), sizeof(this->m_addend)));
+    }
+
+    bool ByteOperator::isValid() const {
+        switch (this->m_operation) {
+            case ByteOperation::Fill:
+            case ByteOperation::Xor:
+            case ByteOperation::And:
+            case ByteOperation::Or:
+                return !this->m_operand.empty();
+            case ByteOperation::Add:
+                return this->m_width == 1 || this->m_width == 2 || this->m_width == 4 || this->m_width == 8;
+            case ByteOperation::SwapEndian:
+                return this->m_width == 2 || this->m_width == 4 || this->m_width == 8;
+            case ByteOperation::Reverse:
+                return true;
+        }
+
+        return false;
+    }
+
+    void ByteOperator::apply(u8 *data, size_t size) const {
+        if (!this->isValid() || size == 0)
+            return;
+
+        // Every part of the front half swaps places with the mirrored part of the back half
+        if (this->m_operation == ByteOperation::Reverse) {
+            size_t half = size / 2;
+            u32 parts = std::clamp<u64>(half / MinimumPartSize, 1, TaskManager::getWorkerCount());
+
+            TaskManager::runParallel(parts, [&](u32 part) {
+                size_t start = half * part / parts;
+                size_t end = half * (part + 1) / parts;
+
+                this->reverse(data + start, data + size - end, end - start);
+            });
+
+            return;
+        }
+
+        // Parts start on a vector boundary, so values never get split between two of them
+        u32 parts = std::clamp<u64>(size / MinimumPartSize, 1, TaskManager::getWorkerCount());
+
+        TaskManager::runParallel(parts, [&](u32 part) {
+            size_t start = (size * part / parts) & ~(VectorSize - 1);
+            size_t end = part + 1 == parts ? size : (size * (part + 1) / parts) & ~(VectorSize - 1);
+
+            this->applyPart(data + start, end - start, start);
+        });
+    }
+
+    void ByteOperator::applyPart(u8 *data, size_t size, u64 offset) const {
+        switch (this->m_operation) {
+            case ByteOperation::Fill:   this->applyPattern<ByteOperation::Fill>(data, size, offset); break;
+            case ByteOperation::Xor:    this->applyPattern<ByteOperation::Xor>(data, size, offset);  break;
+            case ByteOperation::And:    this->applyPattern<ByteOperation::And>(data, size, offset);  break;
+            case ByteOperation::Or:     this->applyPattern<ByteOperation::Or>(data, size, offset);   break;
+            case ByteOperation::Add:
+            case ByteOperation::SwapEndian:
+                switch (this->m_width) {
+                    case 1: this->applyValues<1>(data, size); break;
+                    case 2: this->applyValues<2>(data, size); break;
+                    case 4: this->applyValues<4>(data, size); break;
+                    case 8: this->applyValues<8>(data, size); break;
+                }
+                break;
+            case ByteOperation::Reverse:
+                break;
+        }
+    }
+
+    template<ByteOperation Operation>
+    void ByteOperator::applyPattern(u8 *data, size_t size, u64 offset) const {
+        size_t position = 0;
+
+    #if defined(__x86_64__) || defined(__i386__)
+        if (isAVX2Supported())
+            position = this->applyPatternVectorized<Operation>(data, size, offset);
+    #endif
+
+        size_t patternOffset = (offset + position) % this->m_period;
+        for (; position < size; position++) {
+            u8 pattern = this->m_pattern[patternOffset];
+
+            if constexpr (Operation == ByteOperation::Fill)
+                data[position] = pattern;
+            else if constexpr (Operation == ByteOperation::Xor)
+                data[position] ^= pattern;
+            else if constexpr (Operation == ByteOperation::And)
+                data[position] &= pattern;
+            else if constexpr (Operation == ByteOperation::Or)
+                data[position] |= pattern;
+
+            if (++patternOffset == this->m_period)
+                patternOffset = 0;
+        }
+    }
+
+    template<size_t Width>
+    void ByteOperator::applyValues(u8 *data, size_t size) const {
+        using T = UnsignedOfWidth<Width>;
+
+        size_t position = 0;
+
+    #if defined(__x86_64__) || defined(__i386__)
+        if (isAVX2Supported())
+            position = this->applyValuesVectorized<Width>(data, size);
+    #endif
+
+        for (; position + Width <= size; position += Width) {
+            T value;
+            std::memcpy(&value, data + position, Width);
+
+            if (this->m_operation == ByteOperation::Add)
+                value = changeEndianess(T(changeEndianess(value, this->m_endian) + T(this->m_addend)), this->m_endian);
+            else
+                value = changeEndianess(value, ForeignEndian);
+
+            std::memcpy(data + position, &value, Width);
+        }
+    }
+
+    void ByteOperator::reverse(u8 *front, u8 *back, size_t size) const {
+        size_t position = 0;
+
+    #if defined(__x86_64__) || defined(__i386__)
+        if (isAVX2Supported())
+            position = this->reverseVectorized(front, back, size);
+    #endif
+
+        for (; position < size; position++)
+            std::swap(front[position], back[size - 1 - position]);
+    }
+
+#if defined(__x86_64__) || defined(__i386__)
+
+    template<ByteOperation Operation>
+    __attribute__((target("avx2")))
+    size_t ByteOperator::applyPatternVectorized(u8 *data, size_t size, u64 offset) const {
+        size_t patternOffset = offset % this->m_period;
+        size_t position = 0;
+
+        for (; position + VectorSize <= size; position += VectorSize) {
+            auto address = reinterpret_cast<__m256i*>(data + position);
+            auto pattern = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(this->m_pattern.data() + patternOffset));
+
+            if constexpr (Operation == ByteOperation::Fill)
+                _mm256_storeu_si256(address, pattern);
+            else if constexpr (Operation == ByteOperation::Xor)
+                _mm256_storeu_si256(address, _mm256_xor_si256(_mm256_loadu_si256(address), pattern));
+            else if constexpr (Operation == ByteOperation::And)
+                _mm256_storeu_si256(address, _mm256_and_si256(_mm256_loadu_si256(address), pattern));
+            else if constexpr (Operation == ByteOperation::Or)
+                _mm256_storeu_si256(address, _mm256_or_si256(_mm256_loadu_si256(address), pattern));
+
+            // The period is a multiple of the vector size, so this lands on the same spot in the operand again
+            patternOffset += VectorSize;
+            if (patternOffset >= this->m_period)
+                patternOffset -= this->m_period;
+        }
+
+        return position;
+    }
+
+    template<size_t Width>
+    __attribute__((target("avx2")))
+    size_t ByteOperator::applyValuesVectorized(u8 *data, size_t size) const {
+        static constexpr auto SwapPattern = makeSwapPattern<Width>();
+        const __m256i swap = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(SwapPattern.data())));
+
+        // Values that aren't stored in native order get swapped before and after adding to them
+        const bool add = this->m_operation == ByteOperation::Add;
+        const bool swapBefore = add && Width > 1 && this->m_endian != std::endian::native;
+
+        __m256i addend;
+        if constexpr (Width == 1)
+            addend = _mm256_set1_epi8(char(this->m_addend));
+        else if constexpr (Width == 2)
+            addend = _mm256_set1_epi16(short(this->m_addend));
+        else if constexpr (Width == 4)
+            addend = _mm256_set1_epi32(int(this->m_addend));
+        else
+            addend = _mm256_set1_epi64x(static_cast<long long>(this->m_addend));
+
+        size_t position = 0;
+        for (; position + VectorSize <= size; position += VectorSize) {
+            auto address = reinterpret_cast<__m256i*>(data + position);
+            auto value = _mm256_loadu_si256(address);
+
+            if (!add) {
+                value = _mm256_shuffle_epi8(value, swap);
+            } else {
+                if (swapBefore)
+                    value = _mm256_shuffle_epi8(value, swap);
+
+                if constexpr (Width == 1)
+                    value = _mm256_add_epi8(value, addend);
+                else if constexpr (Width == 2)
+                    value = _mm256_add_epi16(value, addend);
+                else if constexpr (Width == 4)
+                    value = _mm256_add_epi32(value, addend);
+                else
+                    value = _mm256_add_epi64(value, addend);
+
+                if (swapBefore)
+                    value = _mm256_shuffle_epi8(value, swap);
+            }
+
+            _mm256_storeu_si256(address, value);
+        }
+
+        return position;
+    }
+
+    __attribute__((target("avx2")))
+    size_t ByteOperator::reverseVectorized(u8 *front, u8 *back, size_t size) const {
+        static constexpr auto ReversePattern = makeSwapPattern<16>();
+        const __m256i reversePattern = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ReversePattern.data())));
+
+        // Reversing the bytes within both lanes and then swapping the lanes reverses the whole vector
+        auto reverseVector = [&](__m256i value) __attribute__((target("avx2"))) {
+            value = _mm256_shuffle_epi8(value, reversePattern);
+            return _mm256_permute2x128_si256(value, value, 0x01);
+        };
+
+        size_t position = 0;
+        for (; position + VectorSize <= size; position += VectorSize) {
+            auto frontAddress = reinterpret_cast<__m256i*>(front + position);
+            auto backAddress = reinterpret_cast<__m256i*>(back + size - VectorSize - position);
+
+            auto frontValue = _mm256_loadu_si256(frontAddress);
+            auto backValue = _mm256_loadu_si256(backAddress);
+
+            _mm256_storeu_si256(frontAddress, reverseVector(backValue));
+            _mm256_storeu_si256(backAddress, reverseVector(frontValue));
+        }
+
+        return position;
+    }
+
+#endif
+
+}
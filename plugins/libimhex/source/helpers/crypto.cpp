@@ -2,297 +2,1350 @@
 
 #include <hex/providers/provider.hpp>
 
-#include <mbedtls/base64.h>
 #include <mbedtls/md5.h>
 #include <mbedtls/sha1.h>
 #include <mbedtls/sha256.h>
 #include <mbedtls/sha512.h>
 #include <mbedtls/aes.h>
 #include <mbedtls/cipher.h>
+#include <mbedtls/gcm.h>
 
+#if defined(MBEDTLS_AESNI_C)
+    #include <mbedtls/aesni.h>
+#endif
+
+#include <algorithm>
 #include <array>
+#include <barrier>
+#include <bit>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <optional>
 #include <span>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+    #include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRYPTO)
+    #include <arm_neon.h>
+#endif
 
 namespace hex::crypt {
 
-    u16 crc16(prv::Provider* &data, u64 offset, size_t size, u16 polynomial, u16 init) {
-        const auto table = [polynomial] {
-            std::array<u16, 256> table;
+    namespace {
+
+        constexpr size_t CrcReadBlockSize = 0x10'0000;
+
+        template<typename T>
+        constexpr u8 Width = sizeof(T) * 8;
+
+        template<typename T>
+        T reflect(u64 value) {
+            T result = 0;
+            for (u8 i = 0; i < Width<T>; i++) {
+                if (value & (u64(1) << i))
+                    result |= T(1) << (Width<T> - 1 - i);
+            }
+
+            return result;
+        }
+
+        /*
+            Constant to fold a reflected 64 bit half of the CRC state forward by exponent + 1 bits.
+            x^exponent mod P gets computed in normal bit order and gets reflected into the top of a qword afterwards.
+            Multiplying two reflected values loses one bit, which is made up for by folding one bit less than needed
+        */
+        template<typename T>
+        u64 getFoldConstant(T polynomial, u32 exponent) {
+            const u64 top = u64(1) << Width<T>;
+            const u64 normalPolynomial = reflect<T>(polynomial);
+
+            u64 remainder = 1;
+            for (u32 i = 0; i < exponent; i++) {
+                remainder <<= 1;
+                if (remainder & top)
+                    remainder ^= top | normalPolynomial;
+            }
+
+            return u64(reflect<T>(remainder)) << (64 - Width<T>);
+        }
+
+    #if defined(__x86_64__) || defined(__i386__)
+
+        __attribute__((target("pclmul,sse2")))
+        inline __m128i fold(__m128i value, __m128i next, __m128i constants) {
+            return _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(value, constants, 0x00), _mm_clmulepi64_si128(value, constants, 0x11)), next);
+        }
+
+        /* Folds all whole 16 byte blocks of data into a single one and returns how many bytes were used up */
+        __attribute__((target("pclmul,sse2")))
+        size_t foldBlocks(const u8 *data, size_t size, u32 crc, const std::array<u64, 4> &constants, std::array<u8, 16> &remainder) {
+            if (size < 64)
+                return 0;
+
+            const __m128i fold128 = _mm_set_epi64x(constants[1], constants[0]);
+            const __m128i fold512 = _mm_set_epi64x(constants[3], constants[2]);
+
+            auto load = [data](size_t offset) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + offset)); };
+
+            __m128i x0 = _mm_xor_si128(load(0), _mm_cvtsi32_si128(crc));
+            __m128i x1 = load(16), x2 = load(32), x3 = load(48);
+
+            size_t offset = 64;
+            for (; offset + 64 <= size; offset += 64) {
+                x0 = fold(x0, load(offset +  0), fold512);
+                x1 = fold(x1, load(offset + 16), fold512);
+                x2 = fold(x2, load(offset + 32), fold512);
+                x3 = fold(x3, load(offset + 48), fold512);
+            }
+
+            x3 = fold(fold(fold(x0, x1, fold128), x2, fold128), x3, fold128);
+            for (; offset + 16 <= size; offset += 16)
+                x3 = fold(x3, load(offset), fold128);
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(remainder.data()), x3);
+
+            return offset;
+        }
+
+        bool isCarrylessMultiplySupported() {
+            static bool supported = __builtin_cpu_supports("pclmul");
+            return supported;
+        }
+
+    #elif defined(__aarch64__) && defined(__ARM_FEATURE_CRYPTO)
+
+        inline uint64x2_t fold(uint64x2_t value, uint64x2_t next, uint64x2_t constants) {
+            uint64x2_t low = vreinterpretq_u64_p128(vmull_p64(poly64_t(vgetq_lane_u64(value, 0)), poly64_t(vgetq_lane_u64(constants, 0))));
+            uint64x2_t high = vreinterpretq_u64_p128(vmull_p64(poly64_t(vgetq_lane_u64(value, 1)), poly64_t(vgetq_lane_u64(constants, 1))));
+
+            return veorq_u64(veorq_u64(low, high), next);
+        }
+
+        size_t foldBlocks(const u8 *data, size_t size, u32 crc, const std::array<u64, 4> &constants, std::array<u8, 16> &remainder) {
+            if (size < 64)
+                return 0;
+
+            const uint64x2_t fold128 = { constants[0], constants[1] };
+            const uint64x2_t fold512 = { constants[2], constants[3] };
+
+            auto load = [data](size_t offset) { return vreinterpretq_u64_u8(vld1q_u8(data + offset)); };
+
+            uint64x2_t x0 = veorq_u64(load(0), uint64x2_t{ crc, 0 });
+            uint64x2_t x1 = load(16), x2 = load(32), x3 = load(48);
+
+            size_t offset = 64;
+            for (; offset + 64 <= size; offset += 64) {
+                x0 = fold(x0, load(offset +  0), fold512);
+                x1 = fold(x1, load(offset + 16), fold512);
+                x2 = fold(x2, load(offset + 32), fold512);
+                x3 = fold(x3, load(offset + 48), fold512);
+            }
+
+            x3 = fold(fold(fold(x0, x1, fold128), x2, fold128), x3, fold128);
+            for (; offset + 16 <= size; offset += 16)
+                x3 = fold(x3, load(offset), fold128);
+
+            vst1q_u8(remainder.data(), vreinterpretq_u8_u64(x3));
+
+            return offset;
+        }
+
+        constexpr bool isCarrylessMultiplySupported() {
+            return true;
+        }
+
+    #else
+
+        size_t foldBlocks(const u8 *, size_t, u32, const std::array<u64, 4> &, std::array<u8, 16> &) {
+            return 0;
+        }
+
+        constexpr bool isCarrylessMultiplySupported() {
+            return false;
+        }
+
+    #endif
+
+        template<typename T>
+        T calculateCrc(prv::Provider* &data, u64 offset, size_t size, T polynomial, T init) {
+            Crc<T> crc(polynomial, init);
+
+            // Mapped data without patches gets processed where it is
+            if (auto view = data->getAbsoluteDirectView(offset, size); view.has_value()) {
+                crc.process(view->data(), view->size());
+                return crc.getValue();
+            }
+
+            std::vector<u8> buffer(std::min<size_t>(CrcReadBlockSize, size));
+            for (u64 bufferOffset = 0; bufferOffset < size; bufferOffset += buffer.size()) {
+                const u64 readSize = std::min(u64(buffer.size()), size - bufferOffset);
+                data->readAbsolute(offset + bufferOffset, buffer.data(), readSize);
+                crc.process(buffer.data(), readSize);
+            }
+
+            return crc.getValue();
+        }
+
+    }
+
+    template<typename T>
+    Crc<T>::Crc(T polynomial, T init) : m_value(init) {
+        for (u16 i = 0; i < 256; i++) {
+            T c = i;
+            for (u8 j = 0; j < 8; j++)
+                c = (c & 1) ? T((c >> 1) ^ polynomial) : T(c >> 1);
 
+            this->m_table[0][i] = c;
+        }
+
+        // Slicing tables, entry i of table n is the CRC of byte i followed by n zero bytes
+        for (u8 n = 1; n < this->m_table.size(); n++) {
             for (u16 i = 0; i < 256; i++) {
-                u16 crc = 0;
-                u16 c = i;
+                T previous = this->m_table[n - 1][i];
+                this->m_table[n][i] = T(previous >> 8) ^ this->m_table[0][previous & 0xFF];
+            }
+        }
 
-                for (u16 j = 0; j < 8; j++) {
-                    if (((crc ^ c) & 0x0001U) != 0)
-                        crc = (crc >> 1U) ^ polynomial;
-                    else
-                        crc >>= 1U;
+        this->m_foldConstants = {
+            getFoldConstant<T>(polynomial, 128 + 64 - 1), getFoldConstant<T>(polynomial, 128 - 1),
+            getFoldConstant<T>(polynomial, 512 + 64 - 1), getFoldConstant<T>(polynomial, 512 - 1)
+        };
+    }
 
-                    c >>= 1U;
-                }
+    template<typename T>
+    void Crc<T>::process(const u8 *data, size_t size) {
+        if (isCarrylessMultiplySupported()) {
+            std::array<u8, 16> remainder = { 0 };
+
+            if (size_t folded = foldBlocks(data, size, this->m_value, this->m_foldConstants, remainder); folded > 0) {
+                // The remainder is congruent to all the data folded so far, running it through the tables yields the state
+                this->m_value = 0;
+                this->processSliced(remainder.data(), remainder.size());
 
-                table[i] = crc;
+                data += folded;
+                size -= folded;
             }
+        }
 
-            return table;
-        }();
+        this->processSliced(data, size);
+    }
 
-        u16 crc = init;
+    template<typename T>
+    void Crc<T>::processSliced(const u8 *data, size_t size) {
+        const auto &table = this->m_table;
+        T crc = this->m_value;
 
-        std::array<u8, 512> buffer = { 0 };
+        for (; size >= sizeof(u64); data += sizeof(u64), size -= sizeof(u64)) {
+            u64 word;
+            std::memcpy(&word, data, sizeof(u64));
+            if constexpr (std::endian::native == std::endian::big)
+                word = __builtin_bswap64(word);
 
-        for (u64 bufferOffset = 0; offset < size; offset += buffer.size()) {
-            const u64 readSize = std::min(u64(buffer.size()), size - bufferOffset);
-            data->read(offset + bufferOffset, buffer.data(), readSize);
+            word ^= crc;
+
+            crc = table[7][word & 0xFF]         ^ table[6][(word >> 8) & 0xFF]  ^
+                  table[5][(word >> 16) & 0xFF] ^ table[4][(word >> 24) & 0xFF] ^
+                  table[3][(word >> 32) & 0xFF] ^ table[2][(word >> 40) & 0xFF] ^
+                  table[1][(word >> 48) & 0xFF] ^ table[0][word >> 56];
+        }
+
+        for (; size > 0; data++, size--)
+            crc = T(crc >> 8) ^ table[0][(crc ^ *data) & 0xFF];
+
+        this->m_value = crc;
+    }
+
+    template class Crc<u16>;
+    template class Crc<u32>;
+
+    namespace {
+
+        /* Multiplies two polynomials in normal bit order modulo the CRC polynomial */
+        template<typename T>
+        u64 multiplyModulo(u64 left, u64 right, u64 normalPolynomial) {
+            const u64 top = u64(1) << Width<T>;
+
+            u64 result = 0;
+            for (s8 i = Width<T> - 1; i >= 0; i--) {
+                result <<= 1;
+                if (result & top)
+                    result ^= top | normalPolynomial;
+
+                if ((right >> i) & 1)
+                    result ^= left;
+            }
+
+            return result;
+        }
+
+        /* State of a CRC after feeding it length zero bytes, calculated in logarithmic time */
+        template<typename T>
+        T shiftCrc(T polynomial, T crc, u64 length) {
+            const u64 normalPolynomial = reflect<T>(polynomial);
 
-            for (size_t i = 0; i < readSize; i++) {
-                crc = (crc >> 8) ^ table[(crc ^ u16(buffer[i])) & 0x00FF];
+            u64 power = 1, base = 2;
+            for (u64 exponent = length * 8; exponent > 0; exponent >>= 1) {
+                if (exponent & 1)
+                    power = multiplyModulo<T>(power, base, normalPolynomial);
+                base = multiplyModulo<T>(base, base, normalPolynomial);
             }
+
+            return reflect<T>(multiplyModulo<T>(reflect<T>(crc), power, normalPolynomial));
+        }
+
+        template<typename T>
+        T getCrcDigest(const std::vector<u8> &digest) {
+            T value;
+            std::memcpy(&value, digest.data(), sizeof(T));
+            return value;
+        }
+
+        template<typename T>
+        std::vector<u8> makeCrcDigest(T value) {
+            std::vector<u8> digest(sizeof(T));
+            std::memcpy(digest.data(), &value, sizeof(T));
+            return digest;
+        }
+
+        template<typename T>
+        std::vector<u8> toBigEndian(T value) {
+            std::vector<u8> result(sizeof(T));
+            for (u8 i = 0; i < sizeof(T); i++)
+                result[i] = u8(value >> ((sizeof(T) - 1 - i) * 8));
+
+            return result;
+        }
+
+        std::vector<u8> sha256(std::span<const u8> prefix, std::span<const u8> data, std::span<const u8> suffix = { }) {
+            std::vector<u8> result(32);
+
+            mbedtls_sha256_context ctx;
+            mbedtls_sha256_init(&ctx);
+            mbedtls_sha256_starts_ret(&ctx, false);
+            mbedtls_sha256_update_ret(&ctx, prefix.data(), prefix.size());
+            mbedtls_sha256_update_ret(&ctx, data.data(), data.size());
+            mbedtls_sha256_update_ret(&ctx, suffix.data(), suffix.size());
+            mbedtls_sha256_finish_ret(&ctx, result.data());
+            mbedtls_sha256_free(&ctx);
+
+            return result;
+        }
+
+        // Domain separation so a leaf can never be mistaken for an inner node
+        constexpr std::array<u8, 1> LeafPrefix = { 0x00 }, NodePrefix = { 0x01 };
+
+    }
+
+    HashTree::HashTree(HashFunction function, u32 polynomial, u32 init, size_t size)
+        : m_function(function), m_polynomial(polynomial), m_init(init), m_size(size) {
+
+        this->m_leafCount = (size + LeafSize - 1) / LeafSize;
+        while (this->m_firstLeaf < this->m_leafCount)
+            this->m_firstLeaf *= 2;
+
+        // Heap layout, the children of node i are 2i and 2i + 1. Unused leaves stay empty and get skipped when combining
+        this->m_nodes.resize(this->m_firstLeaf * 2);
+    }
+
+    bool HashTree::isSupported(HashFunction function) {
+        return function == HashFunction::CRC16 || function == HashFunction::CRC32 || function == HashFunction::SHA256Tree;
+    }
+
+    void HashTree::process(const u8 *data, size_t size) {
+        while (size > 0) {
+            size_t leafSize = std::min<u64>(LeafSize, this->m_size - this->m_processedLeaves * LeafSize);
+
+            if (this->m_pendingLeaf.empty() && size >= leafSize) {
+                this->setLeaf(this->m_processedLeaves++, this->hashLeaf(data, leafSize), false);
+                data += leafSize;
+                size -= leafSize;
+                continue;
+            }
+
+            size_t copySize = std::min(size, leafSize - this->m_pendingLeaf.size());
+            this->m_pendingLeaf.insert(this->m_pendingLeaf.end(), data, data + copySize);
+            data += copySize;
+            size -= copySize;
+
+            if (this->m_pendingLeaf.size() == leafSize) {
+                this->setLeaf(this->m_processedLeaves++, this->hashLeaf(this->m_pendingLeaf.data(), leafSize), false);
+                this->m_pendingLeaf.clear();
+            }
+        }
+    }
+
+    void HashTree::finish() {
+        for (size_t i = this->m_firstLeaf - 1; i > 0; i--)
+            this->m_nodes[i] = this->combine(this->m_nodes[i * 2], this->m_nodes[i * 2 + 1]);
+    }
+
+    void HashTree::rehash(prv::Provider* &data, u64 regionOffset, u64 offset, size_t size) {
+        if (size == 0 || offset >= this->m_size)
+            return;
+
+        size_t firstLeaf = offset / LeafSize;
+        size_t lastLeaf = (std::min<u64>(offset + size, this->m_size) - 1) / LeafSize;
+
+        std::vector<u8> buffer;
+        for (size_t leaf = firstLeaf; leaf <= lastLeaf; leaf++) {
+            buffer.resize(std::min<u64>(LeafSize, this->m_size - leaf * LeafSize));
+            data->readAbsolute(regionOffset + leaf * LeafSize, buffer.data(), buffer.size());
+
+            this->setLeaf(leaf, this->hashLeaf(buffer.data(), buffer.size()), true);
+        }
+    }
+
+    std::vector<u8> HashTree::getResult() const {
+        const auto &root = this->m_nodes[1];
+
+        switch (this->m_function) {
+            case HashFunction::CRC16: {
+                u16 crc = shiftCrc<u16>(this->m_polynomial, this->m_init, this->m_size);
+                if (!root.digest.empty())
+                    crc ^= getCrcDigest<u16>(root.digest);
+
+                return toBigEndian(crc);
+            }
+            case HashFunction::CRC32: {
+                u32 crc = shiftCrc<u32>(this->m_polynomial, this->m_init, this->m_size);
+                if (!root.digest.empty())
+                    crc ^= getCrcDigest<u32>(root.digest);
+
+                return toBigEndian(~crc);
+            }
+            case HashFunction::SHA256Tree:
+                return root.digest.empty() ? sha256(LeafPrefix, { }) : root.digest;
+            default:
+                return { };
+        }
+    }
+
+    HashTree::Node HashTree::hashLeaf(const u8 *data, size_t size) const {
+        switch (this->m_function) {
+            case HashFunction::CRC16: {
+                Crc<u16> crc(this->m_polynomial, 0);
+                crc.process(data, size);
+                return { makeCrcDigest(crc.getValue()), size };
+            }
+            case HashFunction::CRC32: {
+                Crc<u32> crc(this->m_polynomial, 0);
+                crc.process(data, size);
+                return { makeCrcDigest(crc.getValue()), size };
+            }
+            case HashFunction::SHA256Tree:
+                return { sha256(LeafPrefix, { data, size }), size };
+            default:
+                return { };
+        }
+    }
+
+    HashTree::Node HashTree::combine(const Node &left, const Node &right) const {
+        if (left.digest.empty())
+            return right;
+        if (right.digest.empty())
+            return left;
+
+        // CRC(A + B) is CRC(A) advanced over as many zero bytes as B is long, xor CRC(B), with both starting at zero
+        switch (this->m_function) {
+            case HashFunction::CRC16:
+                return { makeCrcDigest<u16>(shiftCrc<u16>(this->m_polynomial, getCrcDigest<u16>(left.digest), right.size) ^ getCrcDigest<u16>(right.digest)), left.size + right.size };
+            case HashFunction::CRC32:
+                return { makeCrcDigest<u32>(shiftCrc<u32>(this->m_polynomial, getCrcDigest<u32>(left.digest), right.size) ^ getCrcDigest<u32>(right.digest)), left.size + right.size };
+            case HashFunction::SHA256Tree:
+                return { sha256(NodePrefix, left.digest, right.digest), left.size + right.size };
+            default:
+                return { };
+        }
+    }
+
+    void HashTree::setLeaf(size_t leaf, Node &&node, bool updatePath) {
+        size_t index = this->m_firstLeaf + leaf;
+        this->m_nodes[index] = std::move(node);
+
+        if (updatePath) {
+            for (index /= 2; index > 0; index /= 2)
+                this->m_nodes[index] = this->combine(this->m_nodes[index * 2], this->m_nodes[index * 2 + 1]);
         }
+    }
 
-        return crc;
+    u16 crc16(prv::Provider* &data, u64 offset, size_t size, u16 polynomial, u16 init) {
+        return calculateCrc<u16>(data, offset, size, polynomial, init);
     }
 
     u32 crc32(prv::Provider* &data, u64 offset, size_t size, u32 polynomial, u32 init) {
-        const auto table = [polynomial] {
-            std::array<uint32_t, 256> table = {0};
-
-            for (uint32_t i = 0; i < 256; i++) {
-                uint32_t c = i;
-                for (size_t j = 0; j < 8; j++) {
-                    if (c & 1)
-                        c = polynomial ^ (c >> 1);
-                    else
-                        c >>= 1;
-                }
-                table[i] = c;
+        return ~calculateCrc<u32>(data, offset, size, polynomial, init);
+    }
+
+    class Hasher {
+    public:
+        virtual ~Hasher() = default;
+
+        virtual void update(const u8 *data, size_t size) = 0;
+        virtual std::vector<u8> finish() = 0;
+    };
+
+    namespace {
+
+        class TreeHasher : public Hasher {
+        public:
+            explicit TreeHasher(std::shared_ptr<HashTree> tree) : m_tree(std::move(tree)) { }
+
+            void update(const u8 *data, size_t size) override { this->m_tree->process(data, size); }
+            std::vector<u8> finish() override {
+                this->m_tree->finish();
+                return this->m_tree->getResult();
             }
 
-            return table;
-        }();
+        private:
+            std::shared_ptr<HashTree> m_tree;
+        };
 
-        uint32_t c = init;
-        std::array<u8, 512> buffer = { 0 };
+        template<typename T>
+        class CrcHasher : public Hasher {
+        public:
+            CrcHasher(T polynomial, T init, T finalXor) : m_crc(polynomial, init), m_finalXor(finalXor) { }
 
-        for (u64 bufferOffset = 0; offset < size; offset += buffer.size()) {
-            const u64 readSize = std::min(u64(buffer.size()), size - bufferOffset);
-            data->read(offset + bufferOffset, buffer.data(), readSize);
+            void update(const u8 *data, size_t size) override { this->m_crc.process(data, size); }
+
+            std::vector<u8> finish() override {
+                T value = this->m_crc.getValue() ^ this->m_finalXor;
+
+                return toBigEndian(value);
+            }
 
-            for (size_t i = 0; i < readSize; i++) {
-                c = table[(c ^ buffer[i]) & 0xFF] ^ (c >> 8);
+        private:
+            Crc<T> m_crc;
+            T m_finalXor;
+        };
+
+        class MD5Hasher : public Hasher {
+        public:
+            MD5Hasher() { mbedtls_md5_init(&this->m_ctx); mbedtls_md5_starts_ret(&this->m_ctx); }
+            ~MD5Hasher() override { mbedtls_md5_free(&this->m_ctx); }
+
+            void update(const u8 *data, size_t size) override { mbedtls_md5_update_ret(&this->m_ctx, data, size); }
+            std::vector<u8> finish() override {
+                std::vector<u8> result(16);
+                mbedtls_md5_finish_ret(&this->m_ctx, result.data());
+                return result;
             }
+
+        private:
+            mbedtls_md5_context m_ctx;
+        };
+
+        class SHA1Hasher : public Hasher {
+        public:
+            SHA1Hasher() { mbedtls_sha1_init(&this->m_ctx); mbedtls_sha1_starts_ret(&this->m_ctx); }
+            ~SHA1Hasher() override { mbedtls_sha1_free(&this->m_ctx); }
+
+            void update(const u8 *data, size_t size) override { mbedtls_sha1_update_ret(&this->m_ctx, data, size); }
+            std::vector<u8> finish() override {
+                std::vector<u8> result(20);
+                mbedtls_sha1_finish_ret(&this->m_ctx, result.data());
+                return result;
+            }
+
+        private:
+            mbedtls_sha1_context m_ctx;
+        };
+
+        class SHA256Hasher : public Hasher {
+        public:
+            explicit SHA256Hasher(bool is224) : m_resultSize(is224 ? 28 : 32) { mbedtls_sha256_init(&this->m_ctx); mbedtls_sha256_starts_ret(&this->m_ctx, is224); }
+            ~SHA256Hasher() override { mbedtls_sha256_free(&this->m_ctx); }
+
+            void update(const u8 *data, size_t size) override { mbedtls_sha256_update_ret(&this->m_ctx, data, size); }
+            std::vector<u8> finish() override {
+                std::vector<u8> result(32);
+                mbedtls_sha256_finish_ret(&this->m_ctx, result.data());
+                result.resize(this->m_resultSize);
+                return result;
+            }
+
+        private:
+            mbedtls_sha256_context m_ctx;
+            size_t m_resultSize;
+        };
+
+        class SHA512Hasher : public Hasher {
+        public:
+            explicit SHA512Hasher(bool is384) : m_resultSize(is384 ? 48 : 64) { mbedtls_sha512_init(&this->m_ctx); mbedtls_sha512_starts_ret(&this->m_ctx, is384); }
+            ~SHA512Hasher() override { mbedtls_sha512_free(&this->m_ctx); }
+
+            void update(const u8 *data, size_t size) override { mbedtls_sha512_update_ret(&this->m_ctx, data, size); }
+            std::vector<u8> finish() override {
+                std::vector<u8> result(64);
+                mbedtls_sha512_finish_ret(&this->m_ctx, result.data());
+                result.resize(this->m_resultSize);
+                return result;
+            }
+
+        private:
+            mbedtls_sha512_context m_ctx;
+            size_t m_resultSize;
+        };
+
+        std::unique_ptr<Hasher> createHasher(const HashRequest &request, size_t size) {
+            if (request.tree != nullptr)
+                return std::make_unique<TreeHasher>(request.tree);
+
+            switch (request.function) {
+                case HashFunction::CRC16:   return std::make_unique<CrcHasher<u16>>(request.polynomial, request.init, 0x0000);
+                case HashFunction::CRC32:   return std::make_unique<CrcHasher<u32>>(request.polynomial, request.init, 0xFFFF'FFFF);
+                case HashFunction::MD5:     return std::make_unique<MD5Hasher>();
+                case HashFunction::SHA1:    return std::make_unique<SHA1Hasher>();
+                case HashFunction::SHA224:  return std::make_unique<SHA256Hasher>(true);
+                case HashFunction::SHA256:  return std::make_unique<SHA256Hasher>(false);
+                case HashFunction::SHA384:  return std::make_unique<SHA512Hasher>(true);
+                case HashFunction::SHA512:  return std::make_unique<SHA512Hasher>(false);
+                case HashFunction::SHA256Tree: return std::make_unique<TreeHasher>(std::make_shared<HashTree>(HashFunction::SHA256Tree, 0, 0, size));
+            }
+
+            return nullptr;
         }
 
-        return ~c;
     }
 
-    std::array<u8, 16> md5(prv::Provider* &data, u64 offset, size_t size) {
-        std::array<u8, 16> result = { 0 };
+    std::vector<std::vector<u8>> hashRegion(prv::Provider* &data, u64 offset, size_t size, const std::vector<HashRequest> &requests, const std::atomic<bool> &cancelled, std::atomic<u64> *processedBytes) {
+        std::vector<std::unique_ptr<Hasher>> hashers;
+        for (const auto &request : requests)
+            hashers.push_back(createHasher(request, size));
+
+        // Double buffered, the next block gets read while the hashers are busy with the current one.
+        // Blocks of mapped data without any patches in them get hashed straight out of the mapping instead
+        std::array<std::vector<u8>, 2> buffers;
+        std::array<std::span<const u8>, 2> blocks;
+        const u64 blockCount = (size + CrcReadBlockSize - 1) / CrcReadBlockSize;
+
+        data->adviseAccess(offset, size, prv::Provider::AccessHint::Sequential);
+        SCOPE_EXIT( data->adviseAccess(offset, size, prv::Provider::AccessHint::Normal); );
+
+        auto readBlock = [&](u64 block) {
+            u64 blockOffset = offset + block * CrcReadBlockSize;
+            size_t blockSize = std::min<u64>(CrcReadBlockSize, size - block * CrcReadBlockSize);
+
+            if (auto view = data->getAbsoluteDirectView(blockOffset, blockSize); view.has_value()) {
+                blocks[block % 2] = *view;
+            } else {
+                auto &buffer = buffers[block % 2];
+                buffer.resize(blockSize);
+                data->readAbsolute(blockOffset, buffer.data(), buffer.size());
+                blocks[block % 2] = buffer;
+            }
+        };
 
-        mbedtls_md5_context ctx;
-        mbedtls_md5_init(&ctx);
+        if (blockCount > 0)
+            readBlock(0);
 
-        mbedtls_md5_starts_ret(&ctx);
+        bool stop = false;
+        std::barrier sync(hashers.size() + 1);
 
-        std::array<u8, 512> buffer = { 0 };
-        for (u64 bufferOffset = 0; bufferOffset < size; bufferOffset += buffer.size()) {
-            const u64 readSize = std::min(u64(buffer.size()), size - bufferOffset);
-            data->read(offset + bufferOffset, buffer.data(), readSize);
-            mbedtls_md5_update_ret(&ctx, buffer.data(), readSize);
+        std::vector<std::thread> threads;
+        for (auto &hasher : hashers) {
+            threads.emplace_back([&, hasher = hasher.get()] {
+                for (u64 block = 0; block < blockCount; block++) {
+                    hasher->update(blocks[block % 2].data(), blocks[block % 2].size());
+                    sync.arrive_and_wait();
+
+                    if (stop)
+                        break;
+                }
+            });
         }
 
-        mbedtls_md5_finish_ret(&ctx, result.data());
+        for (u64 block = 0; block < blockCount; block++) {
+            if (block + 1 < blockCount && !cancelled)
+                readBlock(block + 1);
 
-        mbedtls_md5_free(&ctx);
+            // Written before the barrier so all hashers see it once they're through
+            stop = cancelled;
+            sync.arrive_and_wait();
 
-        return result;
+            if (processedBytes != nullptr)
+                *processedBytes += blocks[block % 2].size();
+
+            if (stop)
+                break;
+        }
+
+        for (auto &thread : threads)
+            thread.join();
+
+        if (stop)
+            return { };
+
+        std::vector<std::vector<u8>> results;
+        for (auto &hasher : hashers)
+            results.push_back(hasher->finish());
+
+        return results;
     }
 
-    std::array<u8, 20> sha1(prv::Provider* &data, u64 offset, size_t size) {
-        std::array<u8, 20> result = { 0 };
+    Digest::Digest(const HashRequest &request, size_t size) : m_hasher(createHasher(request, size)) { }
 
-        mbedtls_sha1_context ctx;
-        mbedtls_sha1_init(&ctx);
+    Digest::~Digest() = default;
 
-        mbedtls_sha1_starts_ret(&ctx);
+    void Digest::update(std::span<const u8> data) {
+        this->m_hasher->update(data.data(), data.size());
+    }
+
+    void Digest::update(prv::Provider* &data, u64 offset, size_t size, size_t blockSize) {
+        if (auto view = data->getAbsoluteDirectView(offset, size); view.has_value()) {
+            this->update(*view);
+            return;
+        }
 
-        std::array<u8, 512> buffer = { 0 };
+        std::vector<u8> buffer(std::min(std::max<size_t>(blockSize, 1), size));
         for (u64 bufferOffset = 0; bufferOffset < size; bufferOffset += buffer.size()) {
             const u64 readSize = std::min(u64(buffer.size()), size - bufferOffset);
-            data->read(offset + bufferOffset, buffer.data(), readSize);
-            mbedtls_sha1_update_ret(&ctx, buffer.data(), readSize);
+            data->readAbsolute(offset + bufferOffset, buffer.data(), readSize);
+            this->m_hasher->update(buffer.data(), readSize);
         }
+    }
+
+    std::vector<u8> Digest::finish() {
+        return this->m_hasher->finish();
+    }
 
-        mbedtls_sha1_finish_ret(&ctx, result.data());
+    template<size_t Size>
+    static std::array<u8, Size> calculateHash(HashFunction function, prv::Provider* &data, u64 offset, size_t size) {
+        Digest digest({ function }, size);
+        digest.update(data, offset, size);
 
-        mbedtls_sha1_free(&ctx);
+        auto digestResult = digest.finish();
+
+        std::array<u8, Size> result = { 0 };
+        std::copy_n(digestResult.begin(), std::min(Size, digestResult.size()), result.begin());
 
         return result;
     }
 
+    std::array<u8, 16> md5(prv::Provider* &data, u64 offset, size_t size) {
+        return calculateHash<16>(HashFunction::MD5, data, offset, size);
+    }
+
+    std::array<u8, 20> sha1(prv::Provider* &data, u64 offset, size_t size) {
+        return calculateHash<20>(HashFunction::SHA1, data, offset, size);
+    }
+
     std::array<u8, 28> sha224(prv::Provider* &data, u64 offset, size_t size) {
-        std::array<u8, 28> result = { 0 };
+        return calculateHash<28>(HashFunction::SHA224, data, offset, size);
+    }
 
-        mbedtls_sha256_context ctx;
-        mbedtls_sha256_init(&ctx);
+    std::array<u8, 32> sha256(prv::Provider* &data, u64 offset, size_t size) {
+        return calculateHash<32>(HashFunction::SHA256, data, offset, size);
+    }
 
-        mbedtls_sha256_starts_ret(&ctx, true);
+    std::array<u8, 48> sha384(prv::Provider* &data, u64 offset, size_t size) {
+        return calculateHash<48>(HashFunction::SHA384, data, offset, size);
+    }
 
-        std::array<u8, 512> buffer = { 0 };
-        for (u64 bufferOffset = 0; bufferOffset < size; bufferOffset += buffer.size()) {
-            const u64 readSize = std::min(u64(buffer.size()), size - bufferOffset);
-            data->read(offset + bufferOffset, buffer.data(), readSize);
-            mbedtls_sha256_update_ret(&ctx, buffer.data(), readSize);
+    std::array<u8, 64> sha512(prv::Provider* &data, u64 offset, size_t size) {
+        return calculateHash<64>(HashFunction::SHA512, data, offset, size);
+    }
+
+    namespace {
+
+        constexpr u8 InvalidSextet = 0xFF;
+
+        constexpr auto Base64Alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        constexpr auto HexDigits = "0123456789ABCDEF";
+
+        constexpr auto Base64Sextets = [] {
+            std::array<u8, 256> table = { };
+            table.fill(InvalidSextet);
+
+            for (u8 i = 0; i < 64; i++)
+                table[u8(Base64Alphabet[i])] = i;
+
+            return table;
+        }();
+
+        constexpr auto HexNibbles = [] {
+            std::array<u8, 256> table = { };
+            table.fill(InvalidSextet);
+
+            for (u8 i = 0; i < 10; i++)
+                table['0' + i] = i;
+            for (u8 i = 0; i < 6; i++) {
+                table['A' + i] = 0x0A + i;
+                table['a' + i] = 0x0A + i;
+            }
+
+            return table;
+        }();
+
+        constexpr bool isBase64Whitespace(u8 c) {
+            return c == ' ' || c == '\t' || c == '\r' || c == '\n';
         }
 
-        mbedtls_sha256_finish_ret(&ctx, result.data());
+    #if defined(__x86_64__) || defined(__i386__)
 
-        mbedtls_sha256_free(&ctx);
+        bool isSSSE3Supported() {
+            static bool supported = __builtin_cpu_supports("ssse3");
+            return supported;
+        }
 
-        return result;
-    }
+        /* Bytes in [low, high], compared signed so everything from 0x80 up never matches */
+        __attribute__((target("ssse3")))
+        inline __m128i inRange(__m128i value, char low, char high) {
+            return _mm_and_si128(_mm_cmpgt_epi8(value, _mm_set1_epi8(low - 1)), _mm_cmpgt_epi8(_mm_set1_epi8(high + 1), value));
+        }
 
-    std::array<u8, 32> sha256(prv::Provider* &data, u64 offset, size_t size) {
-        std::array<u8, 32> result = { 0 };
+        /* Turns 12 bytes into 16 characters, reads 16 bytes of input */
+        __attribute__((target("ssse3")))
+        void encode64Block(const u8 *input, u8 *output) {
+            __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input));
+
+            // Spread every 3 bytes over 4 lanes and move each 6 bit group to the bottom of its own byte
+            data = _mm_shuffle_epi8(data, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+            __m128i high = _mm_mulhi_epu16(_mm_and_si128(data, _mm_set1_epi32(0x0FC0'FC00)), _mm_set1_epi32(0x0400'0040));
+            __m128i low = _mm_mullo_epi16(_mm_and_si128(data, _mm_set1_epi32(0x003F'03F0)), _mm_set1_epi32(0x0100'0010));
+            __m128i sextets = _mm_or_si128(high, low);
+
+            // Each range of the alphabet is a constant offset from its sextets
+            __m128i offsets = _mm_and_si128(inRange(sextets, 0, 25), _mm_set1_epi8('A'));
+            offsets = _mm_or_si128(offsets, _mm_and_si128(inRange(sextets, 26, 51), _mm_set1_epi8('a' - 26)));
+            offsets = _mm_or_si128(offsets, _mm_and_si128(inRange(sextets, 52, 61), _mm_set1_epi8('0' - 52)));
+            offsets = _mm_or_si128(offsets, _mm_and_si128(_mm_cmpeq_epi8(sextets, _mm_set1_epi8(62)), _mm_set1_epi8('+' - 62)));
+            offsets = _mm_or_si128(offsets, _mm_and_si128(_mm_cmpeq_epi8(sextets, _mm_set1_epi8(63)), _mm_set1_epi8('/' - 63)));
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output), _mm_add_epi8(sextets, offsets));
+        }
 
-        mbedtls_sha256_context ctx;
-        mbedtls_sha256_init(&ctx);
+        /* Turns 16 characters into 12 bytes. Fails without writing anything if any of them isn't part of the alphabet */
+        __attribute__((target("ssse3")))
+        bool decode64Block(const u8 *input, u8 *output) {
+            __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input));
 
-        mbedtls_sha256_starts_ret(&ctx, false);
+            __m128i upper = inRange(data, 'A', 'Z'), lower = inRange(data, 'a', 'z'), digit = inRange(data, '0', '9');
+            __m128i plus = _mm_cmpeq_epi8(data, _mm_set1_epi8('+')), slash = _mm_cmpeq_epi8(data, _mm_set1_epi8('/'));
 
-        std::array<u8, 512> buffer = { 0 };
-        for (u64 bufferOffset = 0; bufferOffset < size; bufferOffset += buffer.size()) {
-            const u64 readSize = std::min(u64(buffer.size()), size - bufferOffset);
-            data->read(offset + bufferOffset, buffer.data(), readSize);
-            mbedtls_sha256_update_ret(&ctx, buffer.data(), readSize);
+            __m128i valid = _mm_or_si128(_mm_or_si128(_mm_or_si128(upper, lower), _mm_or_si128(digit, plus)), slash);
+            if (_mm_movemask_epi8(valid) != 0xFFFF)
+                return false;
+
+            __m128i offsets = _mm_and_si128(upper, _mm_set1_epi8(-'A'));
+            offsets = _mm_or_si128(offsets, _mm_and_si128(lower, _mm_set1_epi8(26 - 'a')));
+            offsets = _mm_or_si128(offsets, _mm_and_si128(digit, _mm_set1_epi8(52 - '0')));
+            offsets = _mm_or_si128(offsets, _mm_and_si128(plus, _mm_set1_epi8(62 - '+')));
+            offsets = _mm_or_si128(offsets, _mm_and_si128(slash, _mm_set1_epi8(63 - '/')));
+            __m128i sextets = _mm_add_epi8(data, offsets);
+
+            // Merge pairs of sextets into 12 bits, then pairs of those into 24 bits and pack the three bytes of each lane
+            __m128i merged = _mm_madd_epi16(_mm_maddubs_epi16(sextets, _mm_set1_epi32(0x0140'0140)), _mm_set1_epi32(0x0001'1000));
+            merged = _mm_shuffle_epi8(merged, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(output), merged);
+            u32 tail = _mm_cvtsi128_si32(_mm_srli_si128(merged, 8));
+            std::memcpy(output + 8, &tail, sizeof(tail));
+
+            return true;
         }
 
-        mbedtls_sha256_finish_ret(&ctx, result.data());
+        /* Turns 16 bytes into 32 characters */
+        __attribute__((target("ssse3")))
+        void encodeHexBlock(const u8 *input, u8 *output) {
+            __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input));
+            __m128i digits = _mm_loadu_si128(reinterpret_cast<const __m128i*>(HexDigits));
 
-        mbedtls_sha256_free(&ctx);
+            __m128i high = _mm_shuffle_epi8(digits, _mm_and_si128(_mm_srli_epi16(data, 4), _mm_set1_epi8(0x0F)));
+            __m128i low = _mm_shuffle_epi8(digits, _mm_and_si128(data, _mm_set1_epi8(0x0F)));
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output), _mm_unpacklo_epi8(high, low));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output + 16), _mm_unpackhi_epi8(high, low));
+        }
+
+        /* Turns 16 characters into 8 bytes. Fails without writing anything if any of them isn't a hex digit */
+        __attribute__((target("ssse3")))
+        bool decodeHexBlock(const u8 *input, u8 *output) {
+            __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input));
+
+            __m128i digit = inRange(data, '0', '9'), upper = inRange(data, 'A', 'F'), lower = inRange(data, 'a', 'f');
+            if (_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(digit, upper), lower)) != 0xFFFF)
+                return false;
+
+            __m128i offsets = _mm_and_si128(digit, _mm_set1_epi8(-'0'));
+            offsets = _mm_or_si128(offsets, _mm_and_si128(upper, _mm_set1_epi8(10 - 'A')));
+            offsets = _mm_or_si128(offsets, _mm_and_si128(lower, _mm_set1_epi8(10 - 'a')));
+            __m128i nibbles = _mm_add_epi8(data, offsets);
+
+            // High nibble times 16 plus low nibble for every pair
+            __m128i bytes = _mm_maddubs_epi16(nibbles, _mm_set1_epi16(0x0110));
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(output), _mm_packus_epi16(bytes, bytes));
+
+            return true;
+        }
+
+    #else
+
+        constexpr bool isSSSE3Supported() {
+            return false;
+        }
+
+        void encode64Block(const u8 *, u8 *) { }
+        bool decode64Block(const u8 *, u8 *) { return false; }
+        void encodeHexBlock(const u8 *, u8 *) { }
+        bool decodeHexBlock(const u8 *, u8 *) { return false; }
+
+    #endif
 
-        return result;
     }
 
-    std::array<u8, 48> sha384(prv::Provider* &data, u64 offset, size_t size) {
-        std::array<u8, 48> result = { 0 };
+    size_t encode64(std::span<const u8> input, u8 *output) {
+        const u8 *data = input.data();
+        size_t size = input.size(), offset = 0;
+        u8 *start = output;
 
-        mbedtls_sha512_context ctx;
-        mbedtls_sha512_init(&ctx);
+        // Blocks read 16 bytes but only use 12, the last few always go through the scalar loop
+        if (isSSSE3Supported()) {
+            for (; offset + 16 <= size; offset += 12, output += 16)
+                encode64Block(data + offset, output);
+        }
 
-        mbedtls_sha512_starts_ret(&ctx, true);
+        for (; offset + 3 <= size; offset += 3, output += 4) {
+            u32 bits = (data[offset] << 16) | (data[offset + 1] << 8) | data[offset + 2];
 
-        std::array<u8, 512> buffer = { 0 };
-        for (u64 bufferOffset = 0; bufferOffset < size; bufferOffset += buffer.size()) {
-            const u64 readSize = std::min(u64(buffer.size()), size - bufferOffset);
-            data->read(offset + bufferOffset, buffer.data(), readSize);
-            mbedtls_sha512_update_ret(&ctx, buffer.data(), readSize);
+            output[0] = Base64Alphabet[(bits >> 18) & 0x3F];
+            output[1] = Base64Alphabet[(bits >> 12) & 0x3F];
+            output[2] = Base64Alphabet[(bits >>  6) & 0x3F];
+            output[3] = Base64Alphabet[bits & 0x3F];
         }
 
-        mbedtls_sha512_finish_ret(&ctx, result.data());
+        if (offset < size) {
+            u32 bits = data[offset] << 16;
+            if (offset + 1 < size)
+                bits |= data[offset + 1] << 8;
 
-        mbedtls_sha512_free(&ctx);
+            output[0] = Base64Alphabet[(bits >> 18) & 0x3F];
+            output[1] = Base64Alphabet[(bits >> 12) & 0x3F];
+            output[2] = offset + 1 < size ? Base64Alphabet[(bits >> 6) & 0x3F] : '=';
+            output[3] = '=';
+            output += 4;
+        }
 
-        return result;
+        return output - start;
     }
 
-    std::array<u8, 64> sha512(prv::Provider* &data, u64 offset, size_t size) {
-        std::array<u8, 64> result = { 0 };
+    std::optional<size_t> decode64(std::span<const u8> input, u8 *output) {
+        const u8 *data = input.data();
+        size_t size = input.size(), offset = 0;
+        u8 *start = output;
+
+        u32 bits = 0;
+        u8 sextetCount = 0;
+        bool simd = isSSSE3Supported();
+
+        while (offset < size) {
+            // Whole blocks only fit while no group of four characters has been started yet
+            if (simd && sextetCount == 0 && offset + 16 <= size && decode64Block(data + offset, output)) {
+                offset += 16;
+                output += 12;
+                continue;
+            }
 
-        mbedtls_sha512_context ctx;
-        mbedtls_sha512_init(&ctx);
+            u8 c = data[offset++];
+            if (isBase64Whitespace(c))
+                continue;
+            if (c == '=')
+                break;
+
+            u8 sextet = Base64Sextets[c];
+            if (sextet == InvalidSextet)
+                return { };
+
+            bits = (bits << 6) | sextet;
+            if (++sextetCount == 4) {
+                output[0] = bits >> 16;
+                output[1] = bits >> 8;
+                output[2] = bits;
+                output += 3;
+
+                bits = 0;
+                sextetCount = 0;
+            }
+        }
 
-        mbedtls_sha512_starts_ret(&ctx, false);
+        // Padding is optional, but nothing but more padding may follow it
+        for (; offset < size; offset++) {
+            if (data[offset] != '=' && !isBase64Whitespace(data[offset]))
+                return { };
+        }
 
-        std::array<u8, 512> buffer = { 0 };
-        for (u64 bufferOffset = 0; bufferOffset < size; bufferOffset += buffer.size()) {
-            const u64 readSize = std::min(u64(buffer.size()), size - bufferOffset);
-            data->read(offset + bufferOffset, buffer.data(), readSize);
-            mbedtls_sha512_update_ret(&ctx, buffer.data(), readSize);
+        switch (sextetCount) {
+            case 1:
+                return { };
+            case 2:
+                *output++ = bits >> 4;
+                break;
+            case 3:
+                *output++ = bits >> 10;
+                *output++ = bits >> 2;
+                break;
+            default:
+                break;
         }
 
-        mbedtls_sha512_finish_ret(&ctx, result.data());
+        return output - start;
+    }
 
-        mbedtls_sha512_free(&ctx);
+    size_t encodeHex(std::span<const u8> input, u8 *output) {
+        size_t offset = 0;
 
-        return result;
+        if (isSSSE3Supported()) {
+            for (; offset + 16 <= input.size(); offset += 16)
+                encodeHexBlock(input.data() + offset, output + offset * 2);
+        }
+
+        for (; offset < input.size(); offset++) {
+            output[offset * 2 + 0] = HexDigits[input[offset] >> 4];
+            output[offset * 2 + 1] = HexDigits[input[offset] & 0x0F];
+        }
+
+        return input.size() * 2;
+    }
+
+    std::optional<size_t> decodeHex(std::span<const u8> input, u8 *output) {
+        if (input.size() % 2 != 0)
+            return { };
+
+        size_t offset = 0;
+
+        if (isSSSE3Supported()) {
+            for (; offset + 16 <= input.size(); offset += 16) {
+                if (!decodeHexBlock(input.data() + offset, output + offset / 2))
+                    return { };
+            }
+        }
+
+        for (; offset < input.size(); offset += 2) {
+            u8 high = HexNibbles[input[offset]], low = HexNibbles[input[offset + 1]];
+            if (high == InvalidSextet || low == InvalidSextet)
+                return { };
+
+            output[offset / 2] = (high << 4) | low;
+        }
+
+        return input.size() / 2;
     }
 
     std::vector<u8> decode64(const std::vector<u8> &input) {
-        size_t outputSize = (3 * input.size()) / 4;
-        std::vector<u8> output(outputSize + 1, 0x00);
+        std::vector<u8> output(getMaxDecoded64Size(input.size()));
 
-        size_t written = 0;
-        if (mbedtls_base64_decode(output.data(), output.size(), &written, reinterpret_cast<const unsigned char *>(input.data()), input.size()))
+        auto written = decode64(input, output.data());
+        if (!written.has_value())
             return { };
 
+        output.resize(*written);
+
         return output;
     }
 
     std::vector<u8> encode64(const std::vector<u8> &input) {
-        size_t outputSize = 4 * ((input.size() + 2) / 3);
-        std::vector<u8> output(outputSize + 1, 0x00);
-
-        size_t written = 0;
-        if (mbedtls_base64_encode(output.data(), output.size(), &written, reinterpret_cast<const unsigned char *>(input.data()), input.size()))
-            return { };
+        std::vector<u8> output(getEncoded64Size(input.size()));
+        encode64(input, output.data());
 
         return output;
     }
 
-    static std::vector<u8> aes(mbedtls_cipher_type_t type, mbedtls_operation_t operation, const std::vector<u8> &key, std::array<u8, 8> nonce, std::array<u8, 8> iv, const std::vector<u8> &input) {
-        std::vector<u8> output;
+    namespace {
 
-        if (input.empty())
-            return { };
+        // Threads only get involved once each of them has at least this much data to decrypt
+        constexpr size_t AESParallelSliceSize = 0x10'0000;
 
-        mbedtls_cipher_context_t ctx;
-        auto cipherInfo = mbedtls_cipher_info_from_type(type);
+        /* Adds to a 128 bit counter, CTR counts big endian while XTS tweaks count little endian */
+        std::array<u8, 16> addToCounter(std::array<u8, 16> counter, u64 value, std::endian endian) {
+            for (u8 i = 0; i < 16 && value != 0; i++) {
+                auto &byte = counter[endian == std::endian::big ? 15 - i : i];
 
+                u64 sum = byte + (value & 0xFF);
+                byte = u8(sum);
+                value = (value >> 8) + (sum >> 8);
+            }
 
-        mbedtls_cipher_setup(&ctx, cipherInfo);
-        mbedtls_cipher_setkey(&ctx, key.data(), key.size() * 8, operation);
+            return counter;
+        }
 
-        std::array<u8, 16> nonceCounter = { 0 };
-        std::copy(nonce.begin(), nonce.end(), nonceCounter.begin());
-        std::copy(iv.begin(), iv.end(), nonceCounter.begin() + 8);
+        /* Hands the units to the callback in slices, one per thread if there are enough of them to make that worth it */
+        void forEachSlice(u64 unitCount, size_t unitSize, const std::function<void(u64, u64)> &callback) {
+            u64 threadCount = std::min<u64>(std::max(std::thread::hardware_concurrency(), 1U), (unitCount * unitSize) / AESParallelSliceSize);
+            if (threadCount <= 1) {
+                callback(0, unitCount);
+                return;
+            }
 
-        size_t outputSize = input.size() + cipherInfo->block_size;
-        output.resize(outputSize, 0x00);
-        mbedtls_cipher_crypt(&ctx, nonceCounter.data(), nonceCounter.size(), input.data(), input.size(), output.data(), &outputSize);
+            u64 unitsPerThread = (unitCount + threadCount - 1) / threadCount;
 
-        mbedtls_cipher_free(&ctx);
+            std::vector<std::thread> threads;
+            for (u64 first = 0; first < unitCount; first += unitsPerThread)
+                threads.emplace_back(callback, first, std::min(unitsPerThread, unitCount - first));
 
-        output.resize(input.size());
+            for (auto &thread : threads)
+                thread.join();
+        }
 
-        return output;
     }
 
-    std::vector<u8> aesDecrypt(AESMode mode, KeyLength keyLength, const std::vector<u8> &key, std::array<u8, 8> nonce, std::array<u8, 8> iv, const std::vector<u8> &input) {
+    bool hasAESAcceleration() {
+        #if defined(MBEDTLS_AESNI_C) && defined(MBEDTLS_HAVE_X86_64)
+            return mbedtls_aesni_has_support(MBEDTLS_AESNI_AES) != 0;
+        #else
+            return false;
+        #endif
+    }
+
+    class AESContext {
+    public:
+        AESContext() {
+            mbedtls_aes_init(&this->aes);
+            mbedtls_aes_xts_init(&this->xts);
+            mbedtls_gcm_init(&this->gcm);
+        }
+
+        ~AESContext() {
+            mbedtls_aes_free(&this->aes);
+            mbedtls_aes_xts_free(&this->xts);
+            mbedtls_gcm_free(&this->gcm);
+        }
+
+        /* Decrypts whole units, or any amount of data in the modes that work on a stream */
+        void decrypt(const u8 *input, u8 *output, size_t size) {
+            switch (this->mode) {
+                case AESMode::ECB:
+                    forEachSlice(size / 16, 16, [&](u64 first, u64 count) {
+                        for (u64 block = first; block < first + count; block++)
+                            mbedtls_aes_crypt_ecb(&this->aes, MBEDTLS_AES_DECRYPT, input + block * 16, output + block * 16);
+                    });
+                    break;
+                case AESMode::CBC: {
+                    // Every block only needs the ciphertext in front of it, so each slice can start with that as its IV
+                    std::array<u8, 16> nextIv;
+                    std::memcpy(nextIv.data(), input + size - 16, 16);
+
+                    forEachSlice(size / 16, 16, [&](u64 first, u64 count) {
+                        std::array<u8, 16> iv = this->iv;
+                        if (first > 0)
+                            std::memcpy(iv.data(), input + (first - 1) * 16, 16);
+
+                        mbedtls_aes_crypt_cbc(&this->aes, MBEDTLS_AES_DECRYPT, count * 16, iv.data(), input + first * 16, output + first * 16);
+                    });
+
+                    this->iv = nextIv;
+                    break;
+                }
+                case AESMode::CFB128:
+                    mbedtls_aes_crypt_cfb128(&this->aes, MBEDTLS_AES_DECRYPT, size, &this->offset, this->iv.data(), input, output);
+                    break;
+                case AESMode::OFB:
+                    mbedtls_aes_crypt_ofb(&this->aes, size, &this->offset, this->iv.data(), input, output);
+                    break;
+                case AESMode::CTR: {
+                    // Use up the rest of the current key stream block first so the slices all start on a fresh counter
+                    size_t head = std::min<size_t>((16 - this->offset) % 16, size);
+                    mbedtls_aes_crypt_ctr(&this->aes, head, &this->offset, this->iv.data(), this->streamBlock.data(), input, output);
+                    input += head;
+                    output += head;
+                    size -= head;
+
+                    u64 blockCount = size / 16;
+                    forEachSlice(blockCount, 16, [&](u64 first, u64 count) {
+                        auto counter = addToCounter(this->iv, first, std::endian::big);
+                        std::array<u8, 16> streamBlock = { };
+                        size_t offset = 0;
+
+                        mbedtls_aes_crypt_ctr(&this->aes, count * 16, &offset, counter.data(), streamBlock.data(), input + first * 16, output + first * 16);
+                    });
+
+                    this->iv = addToCounter(this->iv, blockCount, std::endian::big);
+                    mbedtls_aes_crypt_ctr(&this->aes, size % 16, &this->offset, this->iv.data(), this->streamBlock.data(), input + blockCount * 16, output + blockCount * 16);
+                    break;
+                }
+                case AESMode::GCM:
+                    mbedtls_gcm_update(&this->gcm, size, input, output);
+                    break;
+                case AESMode::XTS: {
+                    u64 unitCount = size / AESDecryptor::XTSDataUnitSize;
+                    forEachSlice(unitCount, AESDecryptor::XTSDataUnitSize, [&](u64 first, u64 count) {
+                        for (u64 unit = first; unit < first + count; unit++) {
+                            auto tweak = addToCounter(this->iv, unit, std::endian::little);
+                            auto offset = unit * AESDecryptor::XTSDataUnitSize;
+
+                            mbedtls_aes_crypt_xts(&this->xts, MBEDTLS_AES_DECRYPT, AESDecryptor::XTSDataUnitSize, tweak.data(), input + offset, output + offset);
+                        }
+                    });
+
+                    this->iv = addToCounter(this->iv, unitCount, std::endian::little);
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+
+        AESMode mode = AESMode::ECB;
+        bool valid = false;
+
+        // Size of the units the mode works on, data is held back until a whole unit is there. Zero for modes that work on a stream
+        size_t unitSize = 0;
+        std::vector<u8> pending;
+
+        mbedtls_aes_context aes;
+        mbedtls_aes_xts_context xts;
+        mbedtls_gcm_context gcm;
+
+        // IV, counter or tweak depending on the mode, updated after every piece
+        std::array<u8, 16> iv = { };
+        std::array<u8, 16> streamBlock = { };
+        size_t offset = 0;
+    };
+
+    AESDecryptor::AESDecryptor(AESMode mode, KeyLength keyLength, std::span<const u8> key, std::array<u8, 8> nonce, std::array<u8, 8> iv) : m_context(std::make_unique<AESContext>()) {
+        auto &context = *this->m_context;
+        context.mode = mode;
+
+        u32 keyBits;
         switch (keyLength) {
-            case KeyLength::Key128Bits: if (key.size() != 128 / 8) return { }; break;
-            case KeyLength::Key192Bits: if (key.size() != 192 / 8) return { }; break;
-            case KeyLength::Key256Bits: if (key.size() != 256 / 8) return { }; break;
-            default: return { };
+            case KeyLength::Key128Bits: keyBits = 128; break;
+            case KeyLength::Key192Bits: keyBits = 192; break;
+            case KeyLength::Key256Bits: keyBits = 256; break;
+            default: return;
         }
 
-        mbedtls_cipher_type_t type;
+        // XTS uses one key for the data and another one for the tweak, mbedtls only supports it with 128 and 256 bit keys
+        size_t expectedKeySize = mode == AESMode::XTS ? keyBits / 4 : keyBits / 8;
+        if (key.size() != expectedKeySize || (mode == AESMode::XTS && keyLength == KeyLength::Key192Bits))
+            return;
+
+        // Detects the AES instructions once, before any threads use the context
+        hasAESAcceleration();
+
+        int result;
         switch (mode) {
-            case AESMode::ECB:      type = MBEDTLS_CIPHER_AES_128_ECB;      break;
-            case AESMode::CBC:      type = MBEDTLS_CIPHER_AES_128_CBC;      break;
-            case AESMode::CFB128:   type = MBEDTLS_CIPHER_AES_128_CFB128;   break;
-            case AESMode::CTR:      type = MBEDTLS_CIPHER_AES_128_CTR;      break;
-            case AESMode::GCM:      type = MBEDTLS_CIPHER_AES_128_GCM;      break;
-            case AESMode::CCM:      type = MBEDTLS_CIPHER_AES_128_CCM;      break;
-            case AESMode::OFB:      type = MBEDTLS_CIPHER_AES_128_OFB;      break;
-            case AESMode::XTS:      type = MBEDTLS_CIPHER_AES_128_XTS;      break;
-            default: return { };
+            case AESMode::ECB:
+            case AESMode::CBC:
+                result = mbedtls_aes_setkey_dec(&context.aes, key.data(), keyBits);
+                context.unitSize = 16;
+                break;
+            case AESMode::CFB128:
+            case AESMode::CTR:
+            case AESMode::OFB:
+                // These only ever run the block cipher forwards to produce the key stream
+                result = mbedtls_aes_setkey_enc(&context.aes, key.data(), keyBits);
+                break;
+            case AESMode::GCM:
+                result = mbedtls_gcm_setkey(&context.gcm, MBEDTLS_CIPHER_ID_AES, key.data(), keyBits);
+                context.unitSize = 16;
+                break;
+            case AESMode::XTS:
+                result = mbedtls_aes_xts_setkey_dec(&context.xts, key.data(), keyBits * 2);
+                context.unitSize = XTSDataUnitSize;
+                break;
+            default:
+                return;
+        }
+
+        context.valid = result == 0;
+        this->reset(nonce, iv);
+    }
+
+    AESDecryptor::~AESDecryptor() = default;
+
+    bool AESDecryptor::isValid() const {
+        return this->m_context->valid;
+    }
+
+    void AESDecryptor::reset(std::array<u8, 8> nonce, std::array<u8, 8> iv) {
+        auto &context = *this->m_context;
+
+        std::copy(nonce.begin(), nonce.end(), context.iv.begin());
+        std::copy(iv.begin(), iv.end(), context.iv.begin() + 8);
+        context.streamBlock = { };
+        context.offset = 0;
+        context.pending.clear();
+
+        if (context.valid && context.mode == AESMode::GCM)
+            mbedtls_gcm_starts(&context.gcm, MBEDTLS_GCM_DECRYPT, context.iv.data(), context.iv.size(), nullptr, 0);
+    }
+
+    size_t AESDecryptor::getOutputSize(size_t inputSize) const {
+        const auto &context = *this->m_context;
+
+        if (context.unitSize == 0)
+            return inputSize;
+        else
+            return ((context.pending.size() + inputSize) / context.unitSize) * context.unitSize;
+    }
+
+    size_t AESDecryptor::update(std::span<const u8> input, u8 *output) {
+        auto &context = *this->m_context;
+        if (!context.valid)
+            return 0;
+
+        if (context.unitSize == 0) {
+            context.decrypt(input.data(), output, input.size());
+            return input.size();
         }
 
-        type = mbedtls_cipher_type_t(type + u8(keyLength));
+        size_t written = 0;
 
-        return aes(type, MBEDTLS_DECRYPT, key, nonce, iv, input);
+        // Complete the unit that was held back by the last piece first
+        if (!context.pending.empty()) {
+            size_t missing = std::min(context.unitSize - context.pending.size(), input.size());
+            context.pending.insert(context.pending.end(), input.begin(), input.begin() + missing);
+            input = input.subspan(missing);
+
+            if (context.pending.size() < context.unitSize)
+                return 0;
+
+            context.decrypt(context.pending.data(), output, context.unitSize);
+            context.pending.clear();
+            written = context.unitSize;
+        }
+
+        size_t wholeUnits = input.size() - input.size() % context.unitSize;
+        if (wholeUnits > 0)
+            context.decrypt(input.data(), output + written, wholeUnits);
+
+        context.pending.assign(input.begin() + wholeUnits, input.end());
+
+        return written + wholeUnits;
+    }
+
+    size_t AESDecryptor::finish(u8 *output) {
+        auto &context = *this->m_context;
+        if (!context.valid || context.pending.empty())
+            return 0;
+
+        size_t written = 0;
+        if (context.mode == AESMode::GCM) {
+            written = context.pending.size();
+            mbedtls_gcm_update(&context.gcm, written, context.pending.data(), output);
+        } else if (context.mode == AESMode::XTS && context.pending.size() >= 16) {
+            // The last data unit may be shorter, ciphertext stealing takes care of its incomplete block
+            written = context.pending.size();
+            mbedtls_aes_crypt_xts(&context.xts, MBEDTLS_AES_DECRYPT, written, context.iv.data(), context.pending.data(), output);
+        }
+
+        context.pending.clear();
+
+        return written;
+    }
+
+    std::vector<u8> aesDecrypt(AESMode mode, KeyLength keyLength, const std::vector<u8> &key, std::array<u8, 8> nonce, std::array<u8, 8> iv, const std::vector<u8> &input) {
+        AESDecryptor decryptor(mode, keyLength, key, nonce, iv);
+        if (!decryptor.isValid() || input.empty())
+            return { };
+
+        std::vector<u8> output(input.size());
+        size_t written = decryptor.update(input, output.data());
+        written += decryptor.finish(output.data() + written);
+
+        output.resize(written);
+
+        return output;
     }
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,285 @@
+#include <hex/helpers/diff.hpp>
+
+#include <hex/providers/provider.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <optional>
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+namespace hex {
+
+    namespace {
+
+        constexpr u64 HashBase      = 0x100'0000'01B3;
+        constexpr u64 HashMixer     = 0x9E37'79B9'7F4A'7C15;
+        constexpr u32 EmptyOffset   = 0xFFFF'FFFF;
+
+        // Every how many bytes a window gets indexed while realigning
+        constexpr size_t IndexStep  = 8;
+
+        /* Polynomial hashes of every window of WindowSize bytes in the data, passed to callback with the window's offset */
+        template<typename Callback>
+        void forEachWindowHash(const u8 *data, size_t count, Callback &&callback) {
+            u64 highestPower = 1;
+            for (size_t i = 1; i < BinaryDiffer::WindowSize; i++)
+                highestPower *= HashBase;
+
+            u64 hash = 0;
+            for (size_t i = 0; i < BinaryDiffer::WindowSize; i++)
+                hash = hash * HashBase + data[i];
+
+            for (size_t offset = 0; offset < count; offset++) {
+                if (!callback(offset, hash))
+                    break;
+
+                hash = (hash - data[offset] * highestPower) * HashBase + data[offset + BinaryDiffer::WindowSize];
+            }
+        }
+
+    }
+
+    BinaryDiffer::Reader::Reader(prv::Provider *provider) : m_provider(provider), m_size(provider->getActualSize()) { }
+
+    const u8* BinaryDiffer::Reader::fetch(u64 address, size_t &size) {
+        size = std::min<u64>(size, this->m_size - address);
+
+        if (address < this->m_bufferAddress || address + size > this->m_bufferAddress + this->m_buffer.size()) {
+            this->m_bufferAddress = address;
+            this->m_buffer.resize(std::min<u64>(std::max(size, ChunkSize), this->m_size - address));
+            this->m_provider->readAbsolute(address, this->m_buffer.data(), this->m_buffer.size());
+        }
+
+        return this->m_buffer.data() + (address - this->m_bufferAddress);
+    }
+
+    size_t BinaryDiffer::findMismatch(const u8 *left, const u8 *right, size_t size) {
+        size_t offset = 0;
+
+#if defined(__SSE2__)
+        // Four vectors are checked at once, the exact position only gets searched for once they differ
+        for (; offset + 64 <= size; offset += 64) {
+            __m128i equal = _mm_set1_epi8(-1);
+            for (u8 i = 0; i < 64; i += 16) {
+                auto leftVector  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(left + offset + i));
+                auto rightVector = _mm_loadu_si128(reinterpret_cast<const __m128i*>(right + offset + i));
+                equal = _mm_and_si128(equal, _mm_cmpeq_epi8(leftVector, rightVector));
+            }
+
+            if (_mm_movemask_epi8(equal) != 0xFFFF)
+                break;
+        }
+
+        for (; offset + 16 <= size; offset += 16) {
+            auto leftVector  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(left + offset));
+            auto rightVector = _mm_loadu_si128(reinterpret_cast<const __m128i*>(right + offset));
+
+            u32 differing = ~u32(_mm_movemask_epi8(_mm_cmpeq_epi8(leftVector, rightVector))) & 0xFFFF;
+            if (differing != 0)
+                return offset + std::countr_zero(differing);
+        }
+#endif
+
+        for (; offset + sizeof(u64) <= size; offset += sizeof(u64)) {
+            u64 leftWord, rightWord;
+            std::memcpy(&leftWord, left + offset, sizeof(u64));
+            std::memcpy(&rightWord, right + offset, sizeof(u64));
+
+            if (leftWord != rightWord) {
+                if constexpr (std::endian::native == std::endian::little)
+                    return offset + std::countr_zero(leftWord ^ rightWord) / 8;
+                else
+                    return offset + std::countl_zero(leftWord ^ rightWord) / 8;
+            }
+        }
+
+        for (; offset < size; offset++) {
+            if (left[offset] != right[offset])
+                return offset;
+        }
+
+        return size;
+    }
+
+    void BinaryDiffer::WindowIndex::reset(size_t count) {
+        auto size = std::bit_ceil(std::max<size_t>(count * 2, 16));
+
+        this->m_entries.assign(size, { 0, EmptyOffset });
+        this->m_shift = 64 - std::countr_zero(size);
+    }
+
+    void BinaryDiffer::WindowIndex::insert(u64 hash, u32 offset) {
+        const size_t mask = this->m_entries.size() - 1;
+
+        const u32 tag = hash >> 32;
+
+        for (size_t slot = (hash * HashMixer) >> this->m_shift;; slot = (slot + 1) & mask) {
+            auto &entry = this->m_entries[slot];
+
+            if (entry.offset == EmptyOffset) {
+                entry = { tag, offset };
+                return;
+            } else if (entry.tag == tag) {
+                return;
+            }
+        }
+    }
+
+    std::optional<u32> BinaryDiffer::WindowIndex::find(u64 hash) const {
+        const size_t mask = this->m_entries.size() - 1;
+
+        const u32 tag = hash >> 32;
+
+        for (size_t slot = (hash * HashMixer) >> this->m_shift;; slot = (slot + 1) & mask) {
+            const auto &entry = this->m_entries[slot];
+
+            if (entry.offset == EmptyOffset)
+                return { };
+            else if (entry.tag == tag)
+                return entry.offset;
+        }
+    }
+
+    std::optional<std::pair<size_t, size_t>> BinaryDiffer::realign(Reader &left, u64 leftAddress, Reader &right, u64 rightAddress) {
+        for (size_t distance = 0x100;; distance = std::min(distance * 4, MaxShift)) {
+            size_t leftSize = distance + WindowSize, rightSize = distance + WindowSize;
+            const u8 *leftData  = left.fetch(leftAddress, leftSize);
+            const u8 *rightData = right.fetch(rightAddress, rightSize);
+
+            if (leftSize < WindowSize || rightSize < WindowSize)
+                return { };
+
+            // Only every few left windows get indexed. Matches are extended backwards afterwards to find where they really start
+            size_t leftWindows = leftSize - WindowSize + 1;
+            this->m_windowIndex.reset(leftWindows / IndexStep + 1);
+            forEachWindowHash(leftData, leftWindows, [this](size_t offset, u64 hash) {
+                if (offset % IndexStep == 0)
+                    this->m_windowIndex.insert(hash, offset);
+                return true;
+            });
+
+            // The pair with the fewest skipped bytes in total wins, so no right position much past the best total needs checking
+            std::optional<std::pair<size_t, size_t>> best;
+            forEachWindowHash(rightData, rightSize - WindowSize + 1, [&](size_t offset, u64 hash) {
+                if (best.has_value() && offset >= best->first + best->second + IndexStep)
+                    return false;
+
+                auto position = this->m_windowIndex.find(hash);
+                if (!position.has_value())
+                    return true;
+
+                size_t leftOffset = position.value(), rightOffset = offset;
+                if (std::memcmp(leftData + leftOffset, rightData + rightOffset, WindowSize) != 0)
+                    return true;
+
+                while (leftOffset > 0 && rightOffset > 0 && leftData[leftOffset - 1] == rightData[rightOffset - 1]) {
+                    leftOffset--;
+                    rightOffset--;
+                }
+
+                if (!best.has_value() || leftOffset + rightOffset < best->first + best->second)
+                    best = { leftOffset, rightOffset };
+
+                return true;
+            });
+
+            if (best.has_value())
+                return best;
+
+            bool leftEnded  = leftSize < distance + WindowSize;
+            bool rightEnded = rightSize < distance + WindowSize;
+            if ((leftEnded && rightEnded) || distance == MaxShift)
+                return { };
+        }
+    }
+
+    bool BinaryDiffer::diff(prv::Provider *left, prv::Provider *right, const Callback &callback, const ProgressCallback &progress, const std::atomic<bool> &cancelled) {
+        Reader leftReader(left), rightReader(right);
+        const u64 leftSize = leftReader.getSize(), rightSize = rightReader.getSize();
+
+        // Data that can't be realigned gets skipped in blocks, adjacent differences get merged into a single one before being reported
+        std::optional<Difference> pending;
+        const auto report = [&](Region leftRegion, Region rightRegion) {
+            // Fewer matching bytes than a window in between don't count as both sides being aligned again
+            if (pending.has_value()) {
+                u64 leftGap  = leftRegion.address - (pending->left.address + pending->left.size);
+                u64 rightGap = rightRegion.address - (pending->right.address + pending->right.size);
+
+                if (leftGap == rightGap && leftGap < WindowSize) {
+                    pending->left.size += leftGap + leftRegion.size;
+                    pending->right.size += rightGap + rightRegion.size;
+                } else {
+                    if (!callback(pending.value()))
+                        return false;
+
+                    pending = { leftRegion, rightRegion, DifferenceType::Changed };
+                }
+            } else {
+                pending = { leftRegion, rightRegion, DifferenceType::Changed };
+            }
+
+            if (pending->left.size == 0)
+                pending->type = DifferenceType::Inserted;
+            else if (pending->right.size == 0)
+                pending->type = DifferenceType::Removed;
+            else
+                pending->type = DifferenceType::Changed;
+
+            return true;
+        };
+
+        u64 leftAddress = 0, rightAddress = 0;
+        u64 lastProgress = 0;
+
+        while (leftAddress < leftSize && rightAddress < rightSize) {
+            if (cancelled)
+                return false;
+
+            // Only what's buffered already gets compared, so data that was read for realigning doesn't get read again
+            size_t size = std::min<u64>({ leftSize - leftAddress, rightSize - rightAddress, ChunkSize });
+            size = std::min<size_t>({ size, std::max(leftReader.getBuffered(leftAddress), WindowSize), std::max(rightReader.getBuffered(rightAddress), WindowSize) });
+
+            const u8 *leftData  = leftReader.fetch(leftAddress, size);
+            const u8 *rightData = rightReader.fetch(rightAddress, size);
+
+            auto same = findMismatch(leftData, rightData, size);
+            leftAddress += same;
+            rightAddress += same;
+
+            if (same < size) {
+                auto skipped = this->realign(leftReader, leftAddress, rightReader, rightAddress).value_or(std::pair<size_t, size_t> {
+                    std::min<u64>(MaxShift, leftSize - leftAddress), std::min<u64>(MaxShift, rightSize - rightAddress)
+                });
+
+                if (!report({ leftAddress, skipped.first }, { rightAddress, skipped.second }))
+                    return false;
+
+                leftAddress += skipped.first;
+                rightAddress += skipped.second;
+            }
+
+            if (leftAddress - lastProgress >= ChunkSize) {
+                progress(leftAddress);
+                lastProgress = leftAddress;
+            }
+        }
+
+        // One side ended early, the rest of the other one is extra data
+        if (leftAddress < leftSize || rightAddress < rightSize) {
+            if (!report({ leftAddress, leftSize - leftAddress }, { rightAddress, rightSize - rightAddress }))
+                return false;
+        }
+
+        if (pending.has_value() && !callback(pending.value()))
+            return false;
+
+        progress(leftSize);
+
+        return true;
+    }
+
+}
\ No newline at end of file
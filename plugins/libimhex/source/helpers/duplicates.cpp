@@ -0,0 +1,239 @@
+#include <hex/helpers/duplicates.hpp>
+
+#include <hex/api/task.hpp>
+#include <hex/helpers/crypto.hpp>
+#include <hex/helpers/utils.hpp>
+#include <hex/providers/provider.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <unordered_map>
+
+namespace hex {
+
+    namespace {
+
+        constexpr u64 splitMix64(u64 &state) {
+            u64 value = (state += 0x9E37'79B9'7F4A'7C15);
+            value = (value ^ (value >> 30)) * 0xBF58'476D'1CE4'E5B9;
+            value = (value ^ (value >> 27)) * 0x94D0'49BB'1331'11EB;
+            return value ^ (value >> 31);
+        }
+
+        struct DigestHash {
+            size_t operator()(const std::array<u8, 32> &digest) const {
+                size_t value;
+                std::memcpy(&value, digest.data(), sizeof(value));
+                return value;
+            }
+        };
+
+    }
+
+    const std::array<u64, 256>& DuplicateFinder::getGearTable() {
+        static constexpr auto table = [] {
+            std::array<u64, 256> table = { };
+
+            // Over a run of the same byte the hash settles on the negated table entry. Entries that would make that a cut are
+            // skipped, otherwise padding would get split up at every single byte once the minimum chunk size is reached
+            u64 state = 0x496D'4865'78;
+            for (auto &entry : table) {
+                do {
+                    entry = splitMix64(state);
+                } while (((0 - entry) & CutMask) == 0);
+            }
+
+            return table;
+        }();
+
+        return table;
+    }
+
+    std::vector<DuplicateFinder::Chunk> DuplicateFinder::chunkRegion(prv::Provider *provider, u64 offset, u64 end, u64 workOffset) {
+        const auto &gear = getGearTable();
+
+        u64 workEnd = std::min<u64>(workOffset + WorkSize, end);
+
+        // The hash needs the bytes in front of the work chunk and the first cut after it can be up to a whole chunk past its end
+        u64 readOffset = workOffset == offset ? offset : workOffset - WindowSize;
+        u64 readEnd = std::min<u64>(workEnd + MaximumChunkSize, end);
+
+        std::vector<u8> buffer(readEnd - readOffset);
+        provider->readAbsolute(readOffset, buffer.data(), buffer.size());
+
+        auto byteAt = [&](u64 address) { return buffer[address - readOffset]; };
+
+        // Only the last 64 bytes are left in the hash, so wherever it starts, it's the same for the same data from the 64th byte on
+        auto findCut = [&](u64 from, u64 limit) -> std::optional<u64> {
+            u64 hash = 0;
+            for (u64 address = from - WindowSize; address < from; address++)
+                hash = (hash << 1) + gear[byteAt(address)];
+
+            for (u64 address = from; address < limit; address++) {
+                if ((hash & CutMask) == 0)
+                    return address;
+
+                hash = (hash << 1) + gear[byteAt(address)];
+            }
+
+            return std::nullopt;
+        };
+
+        // Work chunks start at the first cut after their start, which the previous work chunk finds the same way to know where it ends
+        auto firstCut = [&](u64 address) {
+            if (address == offset || address >= end)
+                return std::min(address, end);
+
+            return findCut(address, std::min<u64>(address + MaximumChunkSize, end)).value_or(address);
+        };
+
+        u64 chunkStart = firstCut(workOffset);
+        u64 stop = firstCut(workEnd);
+
+        std::vector<Chunk> chunks;
+        while (chunkStart < stop) {
+            u64 limit = std::min<u64>(chunkStart + MaximumChunkSize, stop);
+
+            u64 chunkEnd = limit;
+            if (limit - chunkStart > MinimumChunkSize)
+                chunkEnd = findCut(chunkStart + MinimumChunkSize, limit).value_or(limit);
+
+            crypt::Digest digest({ crypt::HashFunction::SHA256 });
+            digest.update({ &buffer[chunkStart - readOffset], size_t(chunkEnd - chunkStart) });
+            auto result = digest.finish();
+
+            auto &chunk = chunks.emplace_back(Chunk { chunkStart, u32(chunkEnd - chunkStart), { } });
+            std::copy_n(result.begin(), chunk.digest.size(), chunk.digest.begin());
+
+            chunkStart = chunkEnd;
+        }
+
+        return chunks;
+    }
+
+    std::vector<DuplicateGroup> DuplicateFinder::groupChunks(const std::vector<Chunk> &chunks) {
+        constexpr static u32 Unset = std::numeric_limits<u32>::max();
+        constexpr static u32 Mixed = Unset - 1;
+
+        // Chunks with the same content share an id
+        std::unordered_map<std::array<u8, 32>, u32, DigestHash> idsByDigest;
+        std::vector<u32> ids;
+        std::vector<u32> sizes, counts;
+
+        ids.reserve(chunks.size());
+        for (const auto &chunk : chunks) {
+            auto [it, inserted] = idsByDigest.try_emplace(chunk.digest, u32(sizes.size()));
+            if (inserted) {
+                sizes.push_back(chunk.size);
+                counts.push_back(0);
+            }
+
+            ids.push_back(it->second);
+            counts[it->second]++;
+        }
+
+        // Which chunk always comes after and in front of the chunks of an id, if it's always the same one
+        std::vector<u32> next(sizes.size(), Unset), previous(sizes.size(), Unset);
+        auto setNeighbour = [](u32 &neighbour, u32 id) {
+            if (neighbour == Unset)
+                neighbour = id;
+            else if (neighbour != id)
+                neighbour = Mixed;
+        };
+
+        for (size_t i = 0; i < ids.size(); i++) {
+            setNeighbour(next[ids[i]], i + 1 < ids.size() ? ids[i + 1] : Mixed);
+            setNeighbour(previous[ids[i]], i > 0 ? ids[i - 1] : Mixed);
+        }
+
+        // If every copy of a chunk is followed by the same other chunk and that one never shows up anywhere else, both belong to the same region
+        auto linked = [&](u32 id) {
+            return counts[id] > 1 && next[id] < Mixed && next[id] != id && previous[next[id]] == id;
+        };
+
+        std::vector<bool> covered(sizes.size(), false);
+        std::vector<std::optional<u32>> groupIndices(sizes.size());
+        std::vector<DuplicateGroup> groups;
+
+        auto startGroup = [&](u32 head) {
+            u64 size = 0;
+            for (u32 id = head; ; id = next[id]) {
+                covered[id] = true;
+                size += sizes[id];
+
+                if (!linked(id) || covered[next[id]])
+                    break;
+            }
+
+            groupIndices[head] = u32(groups.size());
+            groups.push_back({ size, { } });
+        };
+
+        for (u32 id = 0; id < sizes.size(); id++) {
+            if (counts[id] > 1 && !(previous[id] < Mixed && linked(previous[id])))
+                startGroup(id);
+        }
+
+        // Chunks that only ever repeat each other in a cycle have no start, each of them gets a group of its own
+        for (u32 id = 0; id < sizes.size(); id++) {
+            if (counts[id] > 1 && !covered[id]) {
+                covered[id] = true;
+                groupIndices[id] = u32(groups.size());
+                groups.push_back({ sizes[id], { } });
+            }
+        }
+
+        for (size_t i = 0; i < ids.size(); i++) {
+            if (auto group = groupIndices[ids[i]]; group.has_value())
+                groups[*group].addresses.push_back(chunks[i].address);
+        }
+
+        std::erase_if(groups, [](const auto &group) { return group.size < MinimumChunkSize; });
+
+        std::sort(groups.begin(), groups.end(), [](const auto &left, const auto &right) {
+            return left.size * (left.addresses.size() - 1) > right.size * (right.addresses.size() - 1);
+        });
+
+        return groups;
+    }
+
+    std::vector<DuplicateGroup> DuplicateFinder::find(prv::Provider *provider, u64 offset, size_t size, const std::atomic<bool> &cancelled, std::atomic<u64> *processedBytes) {
+        size_t dataSize = provider->getActualSize();
+        if (offset >= dataSize)
+            return { };
+
+        u64 end = std::min<u64>(offset + size, dataSize);
+        u64 workCount = (end - offset + WorkSize - 1) / WorkSize;
+
+        provider->adviseAccess(offset, end - offset, prv::Provider::AccessHint::Sequential);
+        SCOPE_EXIT( provider->adviseAccess(offset, end - offset, prv::Provider::AccessHint::Normal); );
+
+        // Work chunks get chunked and hashed on their own, their results are put back together in order afterwards
+        std::vector<std::vector<Chunk>> workChunks(workCount);
+        std::atomic<u64> nextWork = 0;
+
+        TaskManager::runParallel(std::min<u64>(provider->getReadWorkerCount(), workCount), [&](u32) {
+            for (u64 work = nextWork++; work < workCount && !cancelled; work = nextWork++) {
+                u64 workOffset = offset + work * WorkSize;
+                workChunks[work] = chunkRegion(provider, offset, end, workOffset);
+
+                if (processedBytes != nullptr)
+                    *processedBytes += std::min<u64>(WorkSize, end - workOffset);
+            }
+        });
+
+        if (cancelled)
+            return { };
+
+        std::vector<Chunk> chunks;
+        for (auto &workChunk : workChunks) {
+            chunks.insert(chunks.end(), workChunk.begin(), workChunk.end());
+            workChunk = { };
+        }
+
+        return groupChunks(chunks);
+    }
+
+}
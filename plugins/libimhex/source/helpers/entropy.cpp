@@ -0,0 +1,466 @@
+#include <hex/helpers/entropy.hpp>
+
+#include <hex/api/task.hpp>
+#include <hex/providers/provider.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <mutex>
+
+namespace hex {
+
+    namespace {
+
+        constexpr size_t WorkerChunkSize = 0x10'0000;
+
+        // Below this, clearing the interleaved tables costs more than the stalls they avoid
+        constexpr size_t InterleaveThreshold = 0x1000;
+
+        // Limits how much gets counted at a time so the 32 bit sub-histograms can't overflow
+        constexpr size_t MaxCountRunSize = 0x4000'0000;
+
+    }
+
+    void countBytes(const u8 *data, size_t size, ByteCounts &counts) {
+        if (size < InterleaveThreshold) {
+            for (size_t i = 0; i < size; i++)
+                counts[data[i]]++;
+            return;
+        }
+
+        while (size > 0) {
+            size_t runSize = std::min(size, MaxCountRunSize);
+
+            /*
+                Incrementing the same counter for consecutive equal bytes makes every increment wait for the previous store.
+                Spreading consecutive bytes over four separate tables lets those increments run independently
+            */
+            std::array<std::array<u32, 256>, 4> tables = { };
+
+            size_t i = 0;
+            for (; i + sizeof(u64) <= runSize; i += sizeof(u64)) {
+                u64 word;
+                std::memcpy(&word, data + i, sizeof(u64));
+
+                tables[0][u8(word >>  0)]++;
+                tables[1][u8(word >>  8)]++;
+                tables[2][u8(word >> 16)]++;
+                tables[3][u8(word >> 24)]++;
+                tables[0][u8(word >> 32)]++;
+                tables[1][u8(word >> 40)]++;
+                tables[2][u8(word >> 48)]++;
+                tables[3][u8(word >> 56)]++;
+            }
+
+            for (; i < runSize; i++)
+                tables[0][data[i]]++;
+
+            for (u16 value = 0; value < 256; value++)
+                counts[value] += u64(tables[0][value]) + tables[1][value] + tables[2][value] + tables[3][value];
+
+            data += runSize;
+            size -= runSize;
+        }
+    }
+
+    void countDigraphs(const u8 *data, size_t size, DigraphCounts &counts) {
+        if (size < 2)
+            return;
+
+        u16 pair = data[0];
+        for (size_t i = 1; i < size; i++) {
+            pair = (pair << 8) | data[i];
+            counts[pair]++;
+        }
+    }
+
+    float calculateEntropy(const ByteCounts &counts, u64 byteCount) {
+        if (byteCount == 0)
+            return 0.0F;
+
+        double entropy = 0;
+        for (u64 count : counts) {
+            if (count == 0)
+                continue;
+
+            double probability = double(count) / double(byteCount);
+            entropy -= probability * std::log2(probability);
+        }
+
+        return float(entropy / 8);
+    }
+
+    namespace {
+
+        // previous points to the byte right in front of the block, or is null for the first block of the region
+        using BlockCallback = std::function<void(u32 worker, u64 block, const u8 *data, size_t size, const u8 *previous)>;
+
+        void processBlocks(prv::Provider *provider, u64 offset, size_t size, size_t blockSize, const std::atomic<bool> &cancelled, u32 threadCount, const BlockCallback &callback) {
+            const u64 blockCount = (size + blockSize - 1) / blockSize;
+
+            // Workers grab runs of whole blocks so no block is ever split between two of them
+            const u64 blocksPerChunk = std::max<u64>(1, WorkerChunkSize / blockSize);
+            const u64 chunkCount = (blockCount + blocksPerChunk - 1) / blocksPerChunk;
+
+            std::atomic<u64> nextChunk = 0;
+
+            auto worker = [&](u32 workerIndex) {
+                std::vector<u8> buffer;
+
+                u8 chunkPrevious = 0x00;
+
+                for (u64 chunk = nextChunk++; chunk < chunkCount && !cancelled; chunk = nextChunk++) {
+                    u64 firstBlock = chunk * blocksPerChunk;
+                    u64 lastBlock = std::min(firstBlock + blocksPerChunk, blockCount);
+
+                    u64 chunkOffset = firstBlock * blockSize;
+                    size_t chunkSize = std::min<u64>((lastBlock - firstBlock) * blockSize, size - chunkOffset);
+
+                    const u8 *data;
+                    if (auto view = provider->getAbsoluteDirectView(offset + chunkOffset, chunkSize); view.has_value()) {
+                        data = view->data();
+                    } else {
+                        buffer.resize(chunkSize);
+                        provider->readAbsolute(offset + chunkOffset, buffer.data(), chunkSize);
+                        data = buffer.data();
+                    }
+
+                    if (chunkOffset > 0)
+                        provider->readAbsolute(offset + chunkOffset - 1, &chunkPrevious, sizeof(u8));
+
+                    for (u64 block = firstBlock; block < lastBlock; block++) {
+                        u64 blockOffset = (block - firstBlock) * blockSize;
+
+                        const u8 *previous = nullptr;
+                        if (blockOffset > 0)
+                            previous = data + blockOffset - 1;
+                        else if (chunkOffset > 0)
+                            previous = &chunkPrevious;
+
+                        callback(workerIndex, block, data + blockOffset, std::min<u64>(blockSize, chunkSize - blockOffset), previous);
+                    }
+                }
+            };
+
+            TaskManager::runParallel(threadCount, worker);
+        }
+
+        u32 getThreadCount(prv::Provider *provider, u32 threadCount, size_t size, size_t blockSize) {
+            const u64 blockCount = (size + blockSize - 1) / blockSize;
+            const u64 blocksPerChunk = std::max<u64>(1, WorkerChunkSize / blockSize);
+            const u64 chunkCount = (blockCount + blocksPerChunk - 1) / blocksPerChunk;
+
+            return std::clamp<u64>(provider->getReadWorkerCount(threadCount), 1, chunkCount);
+        }
+
+        void mergeCounts(ByteCounts &into, const ByteCounts &counts) {
+            for (u16 value = 0; value < 256; value++)
+                into[value] += counts[value];
+        }
+
+    }
+
+    EntropyAnalysis analyzeEntropy(prv::Provider *provider, u64 offset, size_t size, size_t blockSize, const std::atomic<bool> &cancelled, u32 threadCount) {
+        EntropyAnalysis result;
+
+        if (size == 0 || blockSize == 0)
+            return result;
+
+        result.blockEntropy.resize((size + blockSize - 1) / blockSize, 0.0F);
+
+        threadCount = getThreadCount(provider, threadCount, size, blockSize);
+        std::vector<ByteCounts> workerCounts(threadCount, ByteCounts{ 0 });
+
+        processBlocks(provider, offset, size, blockSize, cancelled, threadCount, [&](u32 worker, u64 block, const u8 *data, size_t blockSize, const u8 *) {
+            ByteCounts blockCounts = { 0 };
+            countBytes(data, blockSize, blockCounts);
+
+            mergeCounts(workerCounts[worker], blockCounts);
+            result.blockEntropy[block] = calculateEntropy(blockCounts, blockSize);
+        });
+
+        for (const auto &counts : workerCounts)
+            mergeCounts(result.valueCounts, counts);
+
+        auto highestBlock = std::max_element(result.blockEntropy.begin(), result.blockEntropy.end());
+        result.highestEntropyBlock = std::distance(result.blockEntropy.begin(), highestBlock);
+        result.highestBlockEntropy = *highestBlock;
+        result.averageEntropy = calculateEntropy(result.valueCounts, size);
+
+        return result;
+    }
+
+    std::vector<ByteCounts> countBlocks(prv::Provider *provider, u64 offset, size_t size, size_t blockSize, const std::atomic<bool> &cancelled, u32 threadCount) {
+        if (size == 0 || blockSize == 0)
+            return { };
+
+        std::vector<ByteCounts> result((size + blockSize - 1) / blockSize, ByteCounts{ 0 });
+
+        const u64 chunkCount = (size + WorkerChunkSize - 1) / WorkerChunkSize;
+        threadCount = std::clamp<u64>(provider->getReadWorkerCount(threadCount), 1, chunkCount);
+
+        std::mutex resultMutex;
+        std::atomic<u64> nextChunk = 0;
+
+        TaskManager::runParallel(threadCount, [&](u32) {
+            std::vector<u8> buffer;
+
+            for (u64 chunk = nextChunk++; chunk < chunkCount && !cancelled; chunk = nextChunk++) {
+                u64 chunkOffset = chunk * WorkerChunkSize;
+                size_t chunkSize = std::min<u64>(WorkerChunkSize, size - chunkOffset);
+
+                const u8 *data;
+                if (auto view = provider->getAbsoluteDirectView(offset + chunkOffset, chunkSize); view.has_value()) {
+                    data = view->data();
+                } else {
+                    buffer.resize(chunkSize);
+                    provider->readAbsolute(offset + chunkOffset, buffer.data(), chunkSize);
+                    data = buffer.data();
+                }
+
+                // Chunks don't line up with the blocks, one may end a block and start the next one
+                for (u64 position = chunkOffset; position < chunkOffset + chunkSize;) {
+                    u64 block = position / blockSize;
+                    size_t partSize = std::min<u64>((block + 1) * blockSize, chunkOffset + chunkSize) - position;
+
+                    ByteCounts counts = { 0 };
+                    countBytes(data + (position - chunkOffset), partSize, counts);
+
+                    {
+                        std::scoped_lock lock(resultMutex);
+                        mergeCounts(result[block], counts);
+                    }
+
+                    position += partSize;
+                }
+            }
+        });
+
+        return result;
+    }
+
+    EntropyMap::Statistics EntropyMap::build(prv::Provider *provider, u64 offset, size_t size, const std::atomic<bool> &cancelled, u32 threadCount) {
+        this->m_offset = offset;
+        this->m_size = size;
+        this->allocateLevels();
+
+        Statistics result;
+        result.digraphCounts.resize(DigraphCount, 0);
+        if (size == 0)
+            return result;
+
+        threadCount = getThreadCount(provider, threadCount, size, BlockSize);
+        std::vector<Statistics> workerStatistics(threadCount);
+        for (auto &statistics : workerStatistics)
+            statistics.digraphCounts.resize(DigraphCount, 0);
+
+        auto &leaves = this->m_levels.front();
+        processBlocks(provider, offset, size, BlockSize, cancelled, threadCount, [&](u32 worker, u64 block, const u8 *data, size_t blockSize, const u8 *previous) {
+            auto &statistics = workerStatistics[worker];
+
+            ByteCounts blockCounts = { 0 };
+            countBytes(data, blockSize, blockCounts);
+            mergeCounts(statistics.valueCounts, blockCounts);
+
+            countDigraphs(data, blockSize, statistics.digraphCounts);
+            if (previous != nullptr)
+                statistics.digraphCounts[(u16(*previous) << 8) | data[0]]++;
+
+            leaves[block] = createLeaf(blockCounts, blockSize);
+        });
+
+        for (const auto &statistics : workerStatistics) {
+            mergeCounts(result.valueCounts, statistics.valueCounts);
+
+            for (size_t pair = 0; pair < DigraphCount; pair++)
+                result.digraphCounts[pair] += statistics.digraphCounts[pair];
+        }
+
+        this->updateParents(0, leaves.size() - 1);
+
+        return result;
+    }
+
+    void EntropyMap::update(prv::Provider *provider, u64 changedOffset, size_t changedSize) {
+        if (this->empty() || changedSize == 0)
+            return;
+
+        u64 start = std::max(changedOffset, this->m_offset);
+        u64 end = std::min<u64>(changedOffset + changedSize, this->m_offset + this->m_size);
+        if (start >= end)
+            return;
+
+        size_t firstLeaf = (start - this->m_offset) / BlockSize;
+        size_t lastLeaf = (end - 1 - this->m_offset) / BlockSize;
+
+        std::vector<u8> buffer(BlockSize);
+        for (size_t leaf = firstLeaf; leaf <= lastLeaf; leaf++) {
+            u64 leafOffset = this->m_offset + leaf * BlockSize;
+            size_t leafSize = std::min<u64>(BlockSize, this->m_offset + this->m_size - leafOffset);
+
+            provider->readAbsolute(leafOffset, buffer.data(), leafSize);
+
+            ByteCounts counts = { 0 };
+            countBytes(buffer.data(), leafSize, counts);
+            this->m_levels.front()[leaf] = createLeaf(counts, leafSize);
+        }
+
+        this->updateParents(firstLeaf, lastLeaf);
+    }
+
+    void EntropyMap::grow(prv::Provider *provider, size_t size) {
+        if (this->empty() || size <= this->m_size)
+            return;
+
+        size_t oldSize = this->m_size;
+        auto leaves = std::move(this->m_levels.front());
+
+        this->m_size = size;
+        this->allocateLevels();
+        std::move(leaves.begin(), leaves.end(), this->m_levels.front().begin());
+
+        // The levels above the leaves got allocated again, all of them need to be combined anew
+        this->update(provider, this->m_offset + oldSize, size - oldSize);
+        this->updateParents(0, this->m_levels.front().size() - 1);
+    }
+
+    bool EntropyMap::restore(u64 offset, size_t size, std::vector<Node> &&leaves) {
+        this->m_offset = offset;
+        this->m_size = size;
+        this->allocateLevels();
+
+        if (leaves.size() != this->m_levels.front().size()) {
+            this->clear();
+            return false;
+        }
+
+        this->m_levels.front() = std::move(leaves);
+        this->updateParents(0, this->m_levels.front().size() - 1);
+
+        return true;
+    }
+
+    void EntropyMap::clear() {
+        this->m_offset = 0;
+        this->m_size = 0;
+        this->m_levels.clear();
+    }
+
+    u64 EntropyMap::getBlockSize(size_t level) {
+        u64 blockSize = BlockSize;
+        for (size_t i = 0; i < level; i++)
+            blockSize *= Fanout;
+
+        return blockSize;
+    }
+
+    size_t EntropyMap::selectLevel(u64 rangeSize, size_t maxNodes) const {
+        if (this->empty())
+            return 0;
+
+        maxNodes = std::max<size_t>(maxNodes, 1);
+
+        size_t level = 0;
+        while (level + 1 < this->m_levels.size() && (rangeSize + getBlockSize(level) - 1) / getBlockSize(level) > maxNodes)
+            level++;
+
+        return level;
+    }
+
+    u64 EntropyMap::getHighestEntropyBlock() const {
+        if (this->empty())
+            return 0;
+
+        // Follow the child holding the maximum down from the root instead of scanning every block
+        size_t node = 0;
+        for (size_t level = this->m_levels.size() - 1; level > 0; level--) {
+            const auto &children = this->m_levels[level - 1];
+            float maxEntropy = this->m_levels[level][node].maxEntropy;
+
+            size_t firstChild = node * Fanout;
+            size_t lastChild = std::min(firstChild + Fanout, children.size());
+
+            node = firstChild;
+            for (size_t child = firstChild; child < lastChild; child++) {
+                if (children[child].maxEntropy == maxEntropy) {
+                    node = child;
+                    break;
+                }
+            }
+        }
+
+        return node;
+    }
+
+    void EntropyMap::allocateLevels() {
+        this->m_levels.clear();
+
+        size_t nodeCount = std::max<size_t>((this->m_size + BlockSize - 1) / BlockSize, 1);
+        this->m_levels.emplace_back(nodeCount);
+
+        while (nodeCount > 1) {
+            nodeCount = (nodeCount + Fanout - 1) / Fanout;
+            this->m_levels.emplace_back(nodeCount);
+        }
+    }
+
+    void EntropyMap::updateParents(size_t firstNode, size_t lastNode) {
+        for (size_t level = 1; level < this->m_levels.size(); level++) {
+            firstNode /= Fanout;
+            lastNode /= Fanout;
+
+            const auto &children = this->m_levels[level - 1];
+            for (size_t node = firstNode; node <= lastNode; node++) {
+                size_t firstChild = node * Fanout;
+                this->m_levels[level][node] = combine(&children[firstChild], std::min(Fanout, children.size() - firstChild));
+            }
+        }
+    }
+
+    EntropyMap::Node EntropyMap::createLeaf(const ByteCounts &counts, size_t size) {
+        Node node;
+        node.averageEntropy = node.minEntropy = node.maxEntropy = calculateEntropy(counts, size);
+        node.size = size;
+
+        for (u16 value = 0; value < 256; value++) {
+            ByteClass byteClass;
+            if (value == 0x00)
+                byteClass = ByteClass::Zero;
+            else if (value >= 0x80)
+                byteClass = ByteClass::High;
+            else if (std::isprint(value) || std::isspace(value))
+                byteClass = ByteClass::Printable;
+            else
+                byteClass = ByteClass::Control;
+
+            node.classCounts[u8(byteClass)] += counts[value];
+        }
+
+        return node;
+    }
+
+    EntropyMap::Node EntropyMap::combine(const Node *children, size_t count) {
+        Node node = children[0];
+
+        double weightedEntropy = double(children[0].averageEntropy) * children[0].size;
+        for (size_t i = 1; i < count; i++) {
+            const auto &child = children[i];
+
+            weightedEntropy += double(child.averageEntropy) * child.size;
+            node.minEntropy = std::min(node.minEntropy, child.minEntropy);
+            node.maxEntropy = std::max(node.maxEntropy, child.maxEntropy);
+            node.size += child.size;
+
+            for (u8 byteClass = 0; byteClass < node.classCounts.size(); byteClass++)
+                node.classCounts[byteClass] += child.classCounts[byteClass];
+        }
+
+        node.averageEntropy = node.size == 0 ? 0.0F : float(weightedEntropy / node.size);
+
+        return node;
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,142 @@
+#include <hex/helpers/fuzzy_index.hpp>
+
+#include <algorithm>
+#include <limits>
+
+namespace hex {
+
+    namespace {
+
+        constexpr s32 PrefixBonus       = 1'000'000;
+        constexpr s32 ConsecutiveBonus  = 16;
+        constexpr s32 WordStartBonus    = 24;
+        constexpr s32 MaxGapPenalty     = 8;
+
+        char toLower(char c) {
+            return (c >= 'A' && c <= 'Z') ? char(c - 'A' + 'a') : c;
+        }
+
+        u64 getCharacterMask(std::string_view string) {
+            u64 mask = 0;
+            for (char c : string)
+                mask |= u64(1) << (u8(c) % 64);
+
+            return mask;
+        }
+
+        bool isSeparator(char c) {
+            return c == ' ' || c == '.' || c == '_' || c == '-' || c == '/' || c == '\\' || c == ':' || c == '[' || c == '(';
+        }
+
+    }
+
+    void FuzzyIndex::clear() {
+        this->m_names.clear();
+        this->m_entries.clear();
+        this->m_sortedEntries.clear();
+    }
+
+    void FuzzyIndex::add(std::string_view name, u32 id) {
+        auto offset = this->m_names.size();
+        for (char c : name)
+            this->m_names.push_back(toLower(c));
+
+        auto lowerName = std::string_view(this->m_names).substr(offset);
+        this->m_entries.push_back({ u32(offset), u32(lowerName.size()), getCharacterMask(lowerName), id });
+    }
+
+    void FuzzyIndex::build() {
+        this->m_sortedEntries.resize(this->m_entries.size());
+        for (u32 i = 0; i < this->m_sortedEntries.size(); i++)
+            this->m_sortedEntries[i] = i;
+
+        std::stable_sort(this->m_sortedEntries.begin(), this->m_sortedEntries.end(), [this](u32 left, u32 right) {
+            return this->getName(this->m_entries[left]) < this->getName(this->m_entries[right]);
+        });
+    }
+
+    s32 FuzzyIndex::scoreSubsequence(std::string_view name, std::string_view query) {
+        s32 score = 0;
+        size_t position = 0;
+        size_t lastMatch = std::numeric_limits<size_t>::max();
+
+        for (char c : query) {
+            auto found = name.find(c, position);
+            if (found == std::string_view::npos)
+                return std::numeric_limits<s32>::min();
+
+            if (lastMatch != std::numeric_limits<size_t>::max() && found == lastMatch + 1)
+                score += ConsecutiveBonus;
+            else
+                score -= s32(std::min<size_t>(found - position, MaxGapPenalty));
+
+            if (found == 0 || isSeparator(name[found - 1]))
+                score += WordStartBonus;
+
+            lastMatch = found;
+            position = found + 1;
+        }
+
+        // Shorter names are closer to what was typed
+        return score - s32(std::min<size_t>(name.size(), 0xFF));
+    }
+
+    std::vector<FuzzyIndex::Match> FuzzyIndex::find(std::string_view query, size_t maxResults) const {
+        std::vector<Match> matches;
+
+        if (query.empty()) {
+            for (size_t i = 0; i < this->m_entries.size() && matches.size() < maxResults; i++)
+                matches.push_back({ this->m_entries[i].id, 0 });
+
+            return matches;
+        }
+
+        std::string lowerQuery;
+        for (char c : query)
+            lowerQuery.push_back(toLower(c));
+
+        const auto byRank = [](const Match &left, const Match &right) {
+            return left.score != right.score ? left.score > right.score : left.id < right.id;
+        };
+
+        // Prefix matches are one contiguous range of the sorted entries and outrank everything else
+        auto prefixBegin = std::lower_bound(this->m_sortedEntries.begin(), this->m_sortedEntries.end(), lowerQuery, [this](u32 entry, const std::string &value) {
+            return this->getName(this->m_entries[entry]) < value;
+        });
+        auto prefixEnd = prefixBegin;
+        while (prefixEnd != this->m_sortedEntries.end() && this->getName(this->m_entries[*prefixEnd]).starts_with(lowerQuery))
+            ++prefixEnd;
+
+        for (auto it = prefixBegin; it != prefixEnd; ++it) {
+            const auto &entry = this->m_entries[*it];
+            matches.push_back({ entry.id, PrefixBonus - s32(entry.nameSize) });
+        }
+
+        // Enough prefix matches means nothing else could make it into the results anyway
+        if (matches.size() < maxResults) {
+            const auto queryMask = getCharacterMask(lowerQuery);
+
+            for (const auto &entry : this->m_entries) {
+                if ((entry.characters & queryMask) != queryMask)
+                    continue;
+
+                auto name = this->getName(entry);
+                if (name.starts_with(lowerQuery))
+                    continue;
+
+                if (auto score = scoreSubsequence(name, lowerQuery); score != std::numeric_limits<s32>::min())
+                    matches.push_back({ entry.id, score });
+            }
+        }
+
+        if (matches.size() > maxResults) {
+            std::partial_sort(matches.begin(), matches.begin() + maxResults, matches.end(), byRank);
+            matches.resize(maxResults);
+        } else {
+            std::sort(matches.begin(), matches.end(), byRank);
+        }
+
+        return matches;
+    }
+
+}
\ No newline at end of file
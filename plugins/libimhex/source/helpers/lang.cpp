@@ -2,21 +2,21 @@
 
 #include "hex/helpers/shared_data.hpp"
 
+#include <bit>
+
 namespace hex {
 
     LanguageDefinition::LanguageDefinition(std::initializer_list<std::pair<std::string, std::string>> entries) {
-        for (auto pair : entries)
-            this->m_entries.insert(pair);
+        this->m_entries.reserve(entries.size());
+
+        for (auto &[unlocalizedString, localizedString] : entries)
+            this->m_entries.push_back({ LangEntry::hash(unlocalizedString), unlocalizedString, localizedString });
     }
 
-    const std::map<std::string, std::string>& LanguageDefinition::getEntries() const {
+    const std::vector<LanguageDefinition::Entry>& LanguageDefinition::getEntries() const {
         return this->m_entries;
     }
 
-    LangEntry::LangEntry(const char *unlocalizedString) : m_unlocalizedString(unlocalizedString) { }
-    LangEntry::LangEntry(const std::string &unlocalizedString) : m_unlocalizedString(unlocalizedString) { }
-    LangEntry::LangEntry(std::string_view unlocalizedString) : m_unlocalizedString(unlocalizedString) { }
-
     LangEntry::operator std::string() const {
         return std::string(get());
     }
@@ -58,29 +58,57 @@ namespace hex {
     }
 
     std::string_view LangEntry::get() const {
-        auto &lang = SharedData::loadedLanguageStrings;
-        if (lang.find(this->m_unlocalizedString) != lang.end())
-            return lang[this->m_unlocalizedString];
-        else
+        auto &table = SharedData::loadedLanguageStrings;
+        if (table.empty())
             return this->m_unlocalizedString;
+
+        // Open addressing with linear probing, the table is never more than half full so there's always an empty slot to stop at
+        auto mask = table.size() - 1;
+        for (auto index = this->m_hash & mask; !table[index].unlocalizedString.empty(); index = (index + 1) & mask) {
+            if (table[index].hash == this->m_hash && table[index].unlocalizedString == this->m_unlocalizedString)
+                return table[index].localizedString;
+        }
+
+        return this->m_unlocalizedString;
     }
 
     void LangEntry::loadLanguage(std::string_view language) {
         constexpr auto DefaultLanguage = "en-US";
 
-        SharedData::loadedLanguageStrings.clear();
+        auto &table = SharedData::loadedLanguageStrings;
+        table.clear();
 
         auto &definitions = ContentRegistry::Language::getLanguageDefinitions();
 
         if (!definitions.contains(language.data()))
             return;
 
+        std::vector<const LanguageDefinition*> loadedDefinitions;
         for (auto &definition : definitions[language.data()])
-            SharedData::loadedLanguageStrings.insert(definition.getEntries().begin(), definition.getEntries().end());
+            loadedDefinitions.push_back(&definition);
 
         if (language != DefaultLanguage) {
             for (auto &definition : definitions[DefaultLanguage])
-                SharedData::loadedLanguageStrings.insert(definition.getEntries().begin(), definition.getEntries().end());
+                loadedDefinitions.push_back(&definition);
+        }
+
+        size_t entryCount = 0;
+        for (auto definition : loadedDefinitions)
+            entryCount += definition->getEntries().size();
+
+        table.resize(std::bit_ceil(entryCount * 2 + 1));
+        auto mask = table.size() - 1;
+
+        // Strings that were already added take priority, so the selected language wins over the default one
+        for (auto definition : loadedDefinitions) {
+            for (auto &entry : definition->getEntries()) {
+                auto index = entry.hash & mask;
+                while (!table[index].unlocalizedString.empty() && table[index].unlocalizedString != entry.unlocalizedString)
+                    index = (index + 1) & mask;
+
+                if (table[index].unlocalizedString.empty())
+                    table[index] = entry;
+            }
         }
     }
 
@@ -0,0 +1,120 @@
+#include <hex/helpers/memory_budget.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <mutex>
+
+namespace hex {
+
+    struct MemoryBudget::Cache::Entry {
+        std::string subsystem;
+        EvictionCallback evict;
+
+        std::atomic<size_t> usage = 0;
+        std::atomic<u64> lastUse = 0;
+    };
+
+    namespace {
+
+        // Guards the registry and is held while evicting, so caches can't unregister while their callback runs
+        std::mutex registryMutex;
+        std::vector<std::shared_ptr<MemoryBudget::Cache::Entry>> caches;
+        std::map<std::string, u64, std::less<>> evictedBytes;
+
+        std::atomic<size_t> limit = MemoryBudget::DefaultLimit;
+
+        // Counts up on every use of any cache, comparing the values of two caches tells which one was used more recently
+        std::atomic<u64> useCounter = 0;
+
+    }
+
+    MemoryBudget::Cache::Cache(std::string subsystem, EvictionCallback evict) : m_entry(std::make_shared<Entry>()) {
+        this->m_entry->subsystem = std::move(subsystem);
+        this->m_entry->evict = std::move(evict);
+        this->m_entry->lastUse = ++useCounter;
+
+        std::scoped_lock lock(registryMutex);
+        caches.push_back(this->m_entry);
+        evictedBytes.try_emplace(this->m_entry->subsystem, 0);
+    }
+
+    MemoryBudget::Cache::~Cache() {
+        std::scoped_lock lock(registryMutex);
+        std::erase(caches, this->m_entry);
+    }
+
+    void MemoryBudget::Cache::update(size_t usage) {
+        this->m_entry->usage = usage;
+        this->m_entry->lastUse = ++useCounter;
+    }
+
+    void MemoryBudget::Cache::touch() {
+        this->m_entry->lastUse = ++useCounter;
+    }
+
+    void MemoryBudget::setLimit(size_t newLimit) {
+        limit = newLimit;
+    }
+
+    size_t MemoryBudget::getLimit() {
+        return limit;
+    }
+
+    size_t MemoryBudget::getTotalUsage() {
+        std::scoped_lock lock(registryMutex);
+
+        size_t total = 0;
+        for (const auto &cache : caches)
+            total += cache->usage;
+
+        return total;
+    }
+
+    std::vector<MemoryBudget::SubsystemUsage> MemoryBudget::getUsage() {
+        std::scoped_lock lock(registryMutex);
+
+        std::vector<SubsystemUsage> result;
+        for (const auto &[subsystem, evicted] : evictedBytes)
+            result.push_back({ subsystem, 0, 0, evicted });
+
+        for (const auto &cache : caches) {
+            auto it = std::lower_bound(result.begin(), result.end(), cache->subsystem, [](const SubsystemUsage &usage, const std::string &subsystem) { return usage.subsystem < subsystem; });
+            it->caches++;
+            it->usage += cache->usage;
+        }
+
+        return result;
+    }
+
+    void MemoryBudget::enforce() {
+        std::scoped_lock lock(registryMutex);
+
+        size_t total = 0;
+        for (const auto &cache : caches)
+            total += cache->usage;
+
+        if (total <= limit)
+            return;
+
+        // Every cache gets asked once, oldest first. Whatever the most recently used ones can't free stays over the limit until the next frame
+        auto order = caches;
+        std::sort(order.begin(), order.end(), [](const auto &left, const auto &right) { return left->lastUse < right->lastUse; });
+
+        for (const auto &cache : order) {
+            if (total <= limit)
+                break;
+
+            size_t usage = cache->usage;
+            if (usage == 0)
+                continue;
+
+            size_t freed = std::min(cache->evict(total - limit), usage);
+
+            cache->usage -= std::min<size_t>(freed, cache->usage);
+            evictedBytes[cache->subsystem] += freed;
+            total -= std::min(freed, total);
+        }
+    }
+
+}
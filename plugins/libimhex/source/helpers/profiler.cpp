@@ -0,0 +1,125 @@
+#include <hex/helpers/profiler.hpp>
+
+#include <thread>
+
+namespace hex {
+
+    namespace {
+
+        bool profilerEnabled = false;
+        std::thread::id mainThread;
+
+        std::map<std::string, Profiler::Section, std::less<>> sections;
+        size_t historyOffset = 0;
+
+        u64(*allocationCounter)() = nullptr;
+
+        // Libraries get initialized before main runs, this is as close to the start of the process as it gets
+        const auto processStart = std::chrono::steady_clock::now();
+        std::vector<Profiler::StartupPhase> startupPhases;
+        bool startupFinished = false;
+        double startupTime = 0;
+
+        thread_local u64 readCalls = 0;
+        thread_local u64 readBytes = 0;
+
+        u64 getAllocationCount() {
+            return allocationCounter == nullptr ? 0 : allocationCounter();
+        }
+
+    }
+
+    Profiler::ScopedTimer::ScopedTimer(std::string_view name) : m_name(name) {
+        // Sections are only kept for the main thread, anything else would need locking on every frame
+        this->m_active = profilerEnabled && std::this_thread::get_id() == mainThread;
+        if (!this->m_active)
+            return;
+
+        this->m_allocations = getAllocationCount();
+        this->m_readCalls = readCalls;
+        this->m_readBytes = readBytes;
+        this->m_start = std::chrono::steady_clock::now();
+    }
+
+    Profiler::ScopedTimer::~ScopedTimer() {
+        if (!this->m_active)
+            return;
+
+        auto end = std::chrono::steady_clock::now();
+
+        auto section = sections.find(this->m_name);
+        if (section == sections.end())
+            section = sections.emplace(std::string(this->m_name), Section()).first;
+
+        auto &counters = section->second.current;
+        counters.time += std::chrono::duration<double, std::milli>(end - this->m_start).count();
+        counters.allocations += getAllocationCount() - this->m_allocations;
+        counters.readCalls += readCalls - this->m_readCalls;
+        counters.readBytes += readBytes - this->m_readBytes;
+    }
+
+    Profiler::StartupTimer::StartupTimer(std::string_view name) : m_name(name), m_start(std::chrono::steady_clock::now()) { }
+
+    Profiler::StartupTimer::~StartupTimer() {
+        auto time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - this->m_start).count();
+
+        startupPhases.push_back({ std::string(this->m_name), time, startupFinished });
+    }
+
+    void Profiler::setEnabled(bool enabled) {
+        if (enabled && !profilerEnabled)
+            mainThread = std::this_thread::get_id();
+
+        profilerEnabled = enabled;
+    }
+
+    bool Profiler::isEnabled() {
+        return profilerEnabled;
+    }
+
+    void Profiler::nextFrame() {
+        if (!profilerEnabled)
+            return;
+
+        for (auto &[name, section] : sections) {
+            section.history[historyOffset] = section.current;
+            section.current = { };
+        }
+
+        historyOffset = (historyOffset + 1) % HistorySize;
+    }
+
+    const std::map<std::string, Profiler::Section, std::less<>>& Profiler::getSections() {
+        return sections;
+    }
+
+    size_t Profiler::getHistoryOffset() {
+        return historyOffset;
+    }
+
+    void Profiler::countRead(size_t size) {
+        readCalls++;
+        readBytes += size;
+    }
+
+    void Profiler::setAllocationCounter(u64(*counter)()) {
+        allocationCounter = counter;
+    }
+
+    void Profiler::finishStartup() {
+        if (startupFinished)
+            return;
+
+        startupTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - processStart).count();
+        startupFinished = true;
+    }
+
+    const std::vector<Profiler::StartupPhase>& Profiler::getStartupPhases() {
+        return startupPhases;
+    }
+
+    double Profiler::getStartupTime() {
+        return startupTime;
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,763 @@
+#include <hex/helpers/regex.hpp>
+
+#include <hex/providers/provider.hpp>
+#include <hex/helpers/utils.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cctype>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace hex {
+
+    namespace {
+
+        using ByteSet = std::bitset<256>;
+
+        constexpr u32 Unbounded         = std::numeric_limits<u32>::max();
+        constexpr u32 MaxRepetitions    = 1000;
+        constexpr size_t MaxInstructions = 0x10'0000;
+
+        /* Syntax tree of a pattern */
+        struct Node {
+            enum class Type : u8 { Bytes, Concat, Alternate, Repeat } type;
+
+            ByteSet bytes;
+            std::vector<Node> children;
+            u32 min = 0, max = 0;
+            bool greedy = true;
+        };
+
+        class Parser {
+        public:
+            Parser(std::string_view pattern, bool caseInsensitive) : m_pattern(pattern), m_caseInsensitive(caseInsensitive) { }
+
+            Node parse() {
+                auto node = this->parseAlternation();
+                if (!this->atEnd())
+                    throw std::invalid_argument("Unmatched ')'");
+
+                return node;
+            }
+
+        private:
+            [[nodiscard]] bool atEnd() const { return this->m_position >= this->m_pattern.size(); }
+            [[nodiscard]] char peek() const { return this->m_pattern[this->m_position]; }
+
+            char next() {
+                if (this->atEnd())
+                    throw std::invalid_argument("Unexpected end of pattern");
+
+                return this->m_pattern[this->m_position++];
+            }
+
+            bool consume(char c) {
+                if (this->atEnd() || this->peek() != c)
+                    return false;
+
+                this->m_position++;
+                return true;
+            }
+
+            void addByte(ByteSet &set, u8 byte) const {
+                set.set(byte);
+
+                if (this->m_caseInsensitive && std::isalpha(byte)) {
+                    set.set(std::tolower(byte));
+                    set.set(std::toupper(byte));
+                }
+            }
+
+            static Node makeBytes(const ByteSet &bytes) {
+                Node node = { Node::Type::Bytes };
+                node.bytes = bytes;
+
+                return node;
+            }
+
+            Node parseAlternation() {
+                std::vector<Node> alternatives;
+                alternatives.push_back(this->parseConcatenation());
+
+                while (this->consume('|'))
+                    alternatives.push_back(this->parseConcatenation());
+
+                if (alternatives.size() == 1)
+                    return std::move(alternatives.front());
+
+                Node node = { Node::Type::Alternate };
+                node.children = std::move(alternatives);
+
+                return node;
+            }
+
+            Node parseConcatenation() {
+                Node node = { Node::Type::Concat };
+
+                while (!this->atEnd() && this->peek() != '|' && this->peek() != ')')
+                    node.children.push_back(this->parseRepetition());
+
+                return node;
+            }
+
+            std::optional<u32> parseNumber() {
+                if (this->atEnd() || !std::isdigit(this->peek()))
+                    return { };
+
+                u32 value = 0;
+                while (!this->atEnd() && std::isdigit(this->peek())) {
+                    value = value * 10 + (this->next() - '0');
+
+                    if (value > MaxRepetitions)
+                        throw std::invalid_argument(hex::format("Repetitions are limited to {}", MaxRepetitions));
+                }
+
+                return value;
+            }
+
+            Node parseRepetition() {
+                auto node = this->parseAtom();
+
+                while (!this->atEnd()) {
+                    u32 min, max;
+
+                    if (this->consume('*'))
+                        min = 0, max = Unbounded;
+                    else if (this->consume('+'))
+                        min = 1, max = Unbounded;
+                    else if (this->consume('?'))
+                        min = 0, max = 1;
+                    else if (this->consume('{')) {
+                        auto lower = this->parseNumber();
+                        if (!lower.has_value())
+                            throw std::invalid_argument("Expected a number after '{'");
+
+                        min = max = lower.value();
+                        if (this->consume(','))
+                            max = this->parseNumber().value_or(Unbounded);
+
+                        if (!this->consume('}'))
+                            throw std::invalid_argument("Expected '}'");
+                        if (max < min)
+                            throw std::invalid_argument("Invalid repetition range");
+                    } else
+                        break;
+
+                    Node repetition = { Node::Type::Repeat };
+                    repetition.min = min;
+                    repetition.max = max;
+                    repetition.greedy = !this->consume('?');
+                    repetition.children.push_back(std::move(node));
+
+                    node = std::move(repetition);
+                }
+
+                return node;
+            }
+
+            Node parseAtom() {
+                auto c = this->next();
+
+                switch (c) {
+                    case '(': {
+                        if (this->consume('?')) {
+                            if (!this->consume(':'))
+                                throw std::invalid_argument("Lookarounds and group options aren't supported");
+                        }
+
+                        auto node = this->parseAlternation();
+                        if (!this->consume(')'))
+                            throw std::invalid_argument("Expected ')'");
+
+                        return node;
+                    }
+                    case '[':
+                        return makeBytes(this->parseClass());
+                    case '.':
+                        return makeBytes(ByteSet().set());
+                    case '^':
+                    case '$':
+                        throw std::invalid_argument("Anchors aren't supported");
+                    case '*':
+                    case '+':
+                    case '?':
+                    case '{':
+                        throw std::invalid_argument(hex::format("Nothing to repeat before '{}'", c));
+                    case '\\':
+                        return makeBytes(this->parseEscape(false));
+                    default: {
+                        ByteSet bytes;
+                        this->addByte(bytes, c);
+
+                        return makeBytes(bytes);
+                    }
+                }
+            }
+
+            static ByteSet getShorthandClass(char c) {
+                ByteSet bytes;
+
+                for (u32 byte = 0; byte < 0x100; byte++) {
+                    switch (std::tolower(c)) {
+                        case 'd': bytes[byte] = byte >= '0' && byte <= '9'; break;
+                        case 'w': bytes[byte] = byte < 0x80 && (std::isalnum(byte) || byte == '_'); break;
+                        case 's': bytes[byte] = byte == ' ' || (byte >= '\t' && byte <= '\r'); break;
+                    }
+                }
+
+                return std::isupper(c) ? ~bytes : bytes;
+            }
+
+            /* Parses whatever follows a backslash, single bytes get returned as a set containing only them */
+            ByteSet parseEscape(bool inClass) {
+                auto c = this->next();
+                ByteSet bytes;
+
+                switch (c) {
+                    case 'd': case 'D':
+                    case 'w': case 'W':
+                    case 's': case 'S':
+                        return getShorthandClass(c);
+                    case 'x': {
+                        u8 value = 0;
+                        for (u8 i = 0; i < 2; i++) {
+                            auto digit = this->next();
+                            if (!std::isxdigit(digit))
+                                throw std::invalid_argument("Expected two hex digits after \\x");
+
+                            value = (value << 4) | (std::isdigit(digit) ? digit - '0' : std::tolower(digit) - 'a' + 10);
+                        }
+
+                        bytes.set(value);
+                        return bytes;
+                    }
+                    case 'n': bytes.set('\n'); return bytes;
+                    case 'r': bytes.set('\r'); return bytes;
+                    case 't': bytes.set('\t'); return bytes;
+                    case 'f': bytes.set('\f'); return bytes;
+                    case 'v': bytes.set('\v'); return bytes;
+                    case '0': bytes.set(0x00); return bytes;
+                    case 'b':
+                        if (inClass) {
+                            bytes.set('\b');
+                            return bytes;
+                        }
+
+                        throw std::invalid_argument("Word boundaries aren't supported");
+                    default:
+                        if (std::isdigit(c))
+                            throw std::invalid_argument("Backreferences aren't supported");
+                        if (std::isalnum(c))
+                            throw std::invalid_argument(hex::format("Unknown escape sequence \\{}", c));
+
+                        this->addByte(bytes, c);
+                        return bytes;
+                }
+            }
+
+            static u8 getSingleByte(const ByteSet &bytes) {
+                for (u32 byte = 0; byte < 0x100; byte++) {
+                    if (bytes[byte])
+                        return byte;
+                }
+
+                return 0x00;
+            }
+
+            ByteSet parseClass() {
+                ByteSet bytes;
+                bool negated = this->consume('^');
+
+                // A closing bracket right at the start is a literal one
+                bool first = true;
+                while (first || !this->consume(']')) {
+                    first = false;
+
+                    std::optional<u8> rangeStart;
+                    if (this->consume('\\')) {
+                        auto escaped = this->parseEscape(true);
+                        if (escaped.count() != 1) {
+                            bytes |= escaped;
+                            continue;
+                        }
+
+                        rangeStart = getSingleByte(escaped);
+                    } else
+                        rangeStart = this->next();
+
+                    if (this->m_position + 1 < this->m_pattern.size() && this->peek() == '-' && this->m_pattern[this->m_position + 1] != ']') {
+                        this->m_position++;
+
+                        u8 rangeEnd;
+                        if (this->consume('\\')) {
+                            auto escaped = this->parseEscape(true);
+                            if (escaped.count() != 1)
+                                throw std::invalid_argument("Invalid character class range");
+
+                            rangeEnd = getSingleByte(escaped);
+                        } else
+                            rangeEnd = this->next();
+
+                        if (rangeEnd < rangeStart.value())
+                            throw std::invalid_argument("Invalid character class range");
+
+                        for (u32 byte = rangeStart.value(); byte <= rangeEnd; byte++)
+                            this->addByte(bytes, byte);
+                    } else
+                        this->addByte(bytes, rangeStart.value());
+                }
+
+                return negated ? ~bytes : bytes;
+            }
+
+            std::string_view m_pattern;
+            size_t m_position = 0;
+            bool m_caseInsensitive;
+        };
+
+        struct Instruction {
+            enum class Type : u8 { Bytes, Split, Match } type;
+
+            u32 next = 0;
+            u32 alternative = 0;    // Splits try next first, which is what makes quantifiers greedy or lazy
+            u32 byteSet = 0;
+        };
+
+        struct Program {
+            std::vector<Instruction> instructions;
+            std::vector<ByteSet> byteSets;
+            u32 start = 0;
+        };
+
+        /* Thompson construction, built back to front so every fragment already knows where it continues */
+        class Compiler {
+        public:
+            explicit Compiler(bool reversed) : m_reversed(reversed) { }
+
+            Program compile(const Node &node, bool unanchored) {
+                auto match = this->add({ Instruction::Type::Match });
+                auto start = this->emit(node, match);
+
+                // Skips any number of bytes in front of a match, with the lowest priority so the leftmost match wins
+                if (unanchored) {
+                    auto loop = this->add({ Instruction::Type::Split });
+                    auto skip = this->addBytes(ByteSet().set(), loop);
+
+                    this->m_program.instructions[loop].next = start;
+                    this->m_program.instructions[loop].alternative = skip;
+                    start = loop;
+                }
+
+                this->m_program.start = start;
+
+                return std::move(this->m_program);
+            }
+
+        private:
+            u32 add(Instruction instruction) {
+                if (this->m_program.instructions.size() >= MaxInstructions)
+                    throw std::invalid_argument("Pattern is too large");
+
+                this->m_program.instructions.push_back(instruction);
+                return this->m_program.instructions.size() - 1;
+            }
+
+            u32 addBytes(const ByteSet &bytes, u32 next) {
+                this->m_program.byteSets.push_back(bytes);
+                return this->add({ Instruction::Type::Bytes, next, 0, u32(this->m_program.byteSets.size() - 1) });
+            }
+
+            u32 addSplit(u32 preferred, u32 other) {
+                return this->add({ Instruction::Type::Split, preferred, other });
+            }
+
+            u32 emit(const Node &node, u32 next) {
+                switch (node.type) {
+                    case Node::Type::Bytes:
+                        return this->addBytes(node.bytes, next);
+                    case Node::Type::Concat:
+                        // The reverse program reads the data backwards, so concatenations are reversed as well
+                        if (this->m_reversed) {
+                            for (const auto &child : node.children)
+                                next = this->emit(child, next);
+                        } else {
+                            for (auto child = node.children.rbegin(); child != node.children.rend(); ++child)
+                                next = this->emit(*child, next);
+                        }
+
+                        return next;
+                    case Node::Type::Alternate: {
+                        auto entry = this->emit(node.children.back(), next);
+                        for (auto child = node.children.rbegin() + 1; child != node.children.rend(); ++child)
+                            entry = this->addSplit(this->emit(*child, next), entry);
+
+                        return entry;
+                    }
+                    case Node::Type::Repeat: {
+                        const auto &child = node.children.front();
+                        auto result = next;
+
+                        if (node.max == Unbounded) {
+                            auto loop = this->addSplit(0, 0);
+                            auto body = this->emit(child, loop);
+
+                            auto &split = this->m_program.instructions[loop];
+                            split.next = node.greedy ? body : next;
+                            split.alternative = node.greedy ? next : body;
+                            result = loop;
+                        } else {
+                            // x{2,4} becomes xx(x(x)?)?, every optional copy can skip straight to what follows
+                            for (u32 i = node.min; i < node.max; i++) {
+                                auto body = this->emit(child, result);
+                                result = node.greedy ? this->addSplit(body, next) : this->addSplit(next, body);
+                            }
+                        }
+
+                        for (u32 i = 0; i < node.min; i++)
+                            result = this->emit(child, result);
+
+                        return result;
+                    }
+                }
+
+                return next;
+            }
+
+            Program m_program;
+            bool m_reversed;
+        };
+
+    }
+
+    /*
+        DFA built from a program while searching. Every state is the list of program instructions that are waiting for the
+        next byte, in priority order. Leftmost-first DFAs drop everything after a match from that list, which stops threads
+        that started later than the match from continuing and makes the DFA die once the longest preferred match ended
+    */
+    class RegexSearcher::Dfa {
+    public:
+        constexpr static u32 DeadState = 0;
+
+        Dfa(Program program, bool leftmostFirst) : m_program(std::move(program)), m_leftmostFirst(leftmostFirst) {
+            // Bytes that every instruction treats the same way share one column in the transition table
+            std::bitset<256> boundaries;
+            for (const auto &bytes : this->m_program.byteSets) {
+                for (u32 byte = 1; byte < 0x100; byte++) {
+                    if (bytes[byte] != bytes[byte - 1])
+                        boundaries.set(byte);
+                }
+            }
+
+            u32 byteClass = 0;
+            for (u32 byte = 0; byte < 0x100; byte++) {
+                if (boundaries[byte])
+                    byteClass++;
+
+                this->m_byteClasses[byte] = byteClass;
+            }
+            this->m_classCount = byteClass + 1;
+
+            this->m_visited.resize(this->m_program.instructions.size(), 0);
+            this->addClosure(this->m_program.start, this->m_startState);
+            this->truncate(this->m_startState);
+
+            this->clearCache();
+        }
+
+        u32 getStartState() {
+            return this->intern(this->m_startState);
+        }
+
+        [[nodiscard]] bool isMatch(u32 state) const {
+            return this->m_matching[state];
+        }
+
+        u32 next(u32 state, u8 byte) {
+            auto target = this->m_transitions[state * this->m_classCount + this->m_byteClasses[byte]];
+
+            return target != UnknownState ? target : this->computeTransition(state, byte);
+        }
+
+    private:
+        constexpr static u32 UnknownState = std::numeric_limits<u32>::max();
+        constexpr static size_t MaxStates = 0x2000;
+
+        void addClosure(u32 instruction, std::vector<u32> &state) {
+            this->m_stack.push_back(instruction);
+
+            while (!this->m_stack.empty()) {
+                auto current = this->m_stack.back();
+                this->m_stack.pop_back();
+
+                if (this->m_visited[current] == this->m_generation)
+                    continue;
+                this->m_visited[current] = this->m_generation;
+
+                const auto &[type, next, alternative, byteSet] = this->m_program.instructions[current];
+                if (type == Instruction::Type::Split) {
+                    this->m_stack.push_back(alternative);
+                    this->m_stack.push_back(next);
+                } else
+                    state.push_back(current);
+            }
+        }
+
+        void truncate(std::vector<u32> &state) const {
+            if (!this->m_leftmostFirst)
+                return;
+
+            auto match = std::find_if(state.begin(), state.end(), [this](u32 instruction) {
+                return this->m_program.instructions[instruction].type == Instruction::Type::Match;
+            });
+
+            if (match != state.end())
+                state.erase(match + 1, state.end());
+        }
+
+        u32 intern(const std::vector<u32> &state) {
+            if (auto it = this->m_stateIds.find(state); it != this->m_stateIds.end())
+                return it->second;
+
+            bool matching = std::any_of(state.begin(), state.end(), [this](u32 instruction) {
+                return this->m_program.instructions[instruction].type == Instruction::Type::Match;
+            });
+
+            u32 id = this->m_matching.size();
+            this->m_stateIds.emplace(state, id);
+            this->m_states.push_back(state);
+            this->m_matching.push_back(matching);
+            this->m_transitions.resize(this->m_transitions.size() + this->m_classCount, UnknownState);
+
+            return id;
+        }
+
+        // Memory stays bounded for patterns with huge numbers of states, the ones still needed simply get built again
+        void clearCache() {
+            this->m_stateIds.clear();
+            this->m_states.clear();
+            this->m_matching.clear();
+            this->m_transitions.clear();
+
+            this->intern({ });
+        }
+
+        u32 computeTransition(u32 state, u8 byte) {
+            std::vector<u32> target;
+
+            this->m_generation++;
+            for (auto instruction : this->m_states[state]) {
+                const auto &[type, next, alternative, byteSet] = this->m_program.instructions[instruction];
+
+                if (type == Instruction::Type::Bytes && this->m_program.byteSets[byteSet][byte])
+                    this->addClosure(next, target);
+            }
+            this->truncate(target);
+
+            if (!this->m_stateIds.contains(target) && this->m_states.size() >= MaxStates) {
+                auto source = this->m_states[state];
+                this->clearCache();
+                state = this->intern(source);
+            }
+
+            auto id = this->intern(target);
+            this->m_transitions[state * this->m_classCount + this->m_byteClasses[byte]] = id;
+
+            return id;
+        }
+
+        Program m_program;
+        bool m_leftmostFirst;
+
+        std::array<u8, 256> m_byteClasses = { };
+        u32 m_classCount = 1;
+
+        std::vector<u32> m_startState;
+        std::map<std::vector<u32>, u32> m_stateIds;
+        std::vector<std::vector<u32>> m_states;
+        std::vector<bool> m_matching;
+        std::vector<u32> m_transitions;
+
+        std::vector<u32> m_stack;
+        std::vector<u32> m_visited;
+        u32 m_generation = 1;
+    };
+
+    /* Hands out the data around an address, either straight from memory or read from the provider in chunks */
+    class RegexSearcher::Reader {
+    public:
+        Reader(const u8 *data, u64 begin, u64 end) : m_data(data), m_begin(begin), m_end(end) { }
+
+        Reader(prv::Provider *provider, u64 begin, u64 end, const std::atomic<bool> &cancelled, const std::function<void(u64)> &progress)
+            : m_provider(provider), m_begin(begin), m_end(end), m_cancelled(&cancelled), m_progress(&progress) { }
+
+        [[nodiscard]] bool isCancelled() const {
+            return this->m_cancelled != nullptr && *this->m_cancelled;
+        }
+
+        /* Returns a pointer to the byte at address and how many bytes after it are available */
+        std::pair<const u8*, size_t> getForward(u64 address) {
+            if (this->m_data != nullptr)
+                return { this->m_data + (address - this->m_begin), this->m_end - address };
+
+            if (address < this->m_bufferStart || address >= this->m_bufferStart + this->m_buffer.size()) {
+                this->load(address, std::min<u64>(ChunkSize, this->m_end - address));
+
+                auto searched = this->m_bufferStart + this->m_buffer.size() - this->m_begin;
+                if (searched > this->m_searched && this->m_progress != nullptr && *this->m_progress) {
+                    this->m_searched = searched;
+                    (*this->m_progress)(searched);
+                }
+            }
+
+            return { this->m_buffer.data() + (address - this->m_bufferStart), this->m_bufferStart + this->m_buffer.size() - address };
+        }
+
+        /* Returns a pointer to the byte at address and how many bytes before and including it are available */
+        std::pair<const u8*, size_t> getBackward(u64 address) {
+            if (this->m_data != nullptr)
+                return { this->m_data + (address - this->m_begin), address - this->m_begin + 1 };
+
+            if (address < this->m_bufferStart || address >= this->m_bufferStart + this->m_buffer.size()) {
+                auto start = address + 1 - std::min<u64>(ChunkSize, address + 1 - this->m_begin);
+                this->load(start, address + 1 - start);
+            }
+
+            return { this->m_buffer.data() + (address - this->m_bufferStart), address - this->m_bufferStart + 1 };
+        }
+
+    private:
+        void load(u64 address, size_t size) {
+            this->m_buffer.resize(size);
+            this->m_provider->readAbsolute(address, this->m_buffer.data(), size);
+            this->m_bufferStart = address;
+        }
+
+        const u8 *m_data = nullptr;
+        prv::Provider *m_provider = nullptr;
+        u64 m_begin, m_end;
+
+        std::vector<u8> m_buffer;
+        u64 m_bufferStart = 0;
+
+        const std::atomic<bool> *m_cancelled = nullptr;
+        const std::function<void(u64)> *m_progress = nullptr;
+        u64 m_searched = 0;
+    };
+
+
+    RegexSearcher::RegexSearcher(std::string_view pattern, bool caseInsensitive) {
+        if (pattern.empty())
+            throw std::invalid_argument("Pattern is empty");
+
+        auto node = Parser(pattern, caseInsensitive).parse();
+
+        this->m_forward = std::make_unique<Dfa>(Compiler(false).compile(node, true), true);
+        this->m_reverse = std::make_unique<Dfa>(Compiler(true).compile(node, false), false);
+
+        // The reverse DFA is anchored, so its start state only matches if the pattern matches nothing at all
+        if (this->m_reverse->isMatch(this->m_reverse->getStartState()))
+            throw std::invalid_argument("Pattern matches empty data");
+    }
+
+    RegexSearcher::~RegexSearcher() = default;
+
+    std::optional<u64> RegexSearcher::findMatchEnd(Reader &reader, u64 position, u64 end) {
+        auto &dfa = *this->m_forward;
+
+        auto state = dfa.getStartState();
+        std::optional<u64> matchEnd;
+
+        for (u64 address = position; address < end;) {
+            if (reader.isCancelled())
+                return { };
+
+            auto [data, available] = reader.getForward(address);
+
+            for (size_t i = 0; i < available; i++) {
+                state = dfa.next(state, data[i]);
+
+                if (state == Dfa::DeadState)
+                    return matchEnd;
+                if (dfa.isMatch(state))
+                    matchEnd = address + i + 1;
+            }
+
+            address += available;
+        }
+
+        return matchEnd;
+    }
+
+    u64 RegexSearcher::findMatchStart(Reader &reader, u64 matchEnd, u64 position) {
+        auto &dfa = *this->m_reverse;
+
+        // The leftmost-first match starts at the leftmost position any match ending here starts at
+        auto state = dfa.getStartState();
+        u64 matchStart = matchEnd;
+
+        for (u64 address = matchEnd; address > position;) {
+            auto [data, available] = reader.getBackward(address - 1);
+            available = std::min<u64>(available, address - position);
+
+            for (size_t i = 0; i < available; i++) {
+                state = dfa.next(state, *(data - i));
+
+                if (state == Dfa::DeadState)
+                    return matchStart;
+                if (dfa.isMatch(state))
+                    matchStart = address - 1 - i;
+            }
+
+            address -= available;
+        }
+
+        return matchStart;
+    }
+
+    bool RegexSearcher::search(Reader &forwardReader, Reader &backwardReader, u64 offset, u64 end, const Callback &callback) {
+        for (u64 position = offset; position < end;) {
+            auto matchEnd = this->findMatchEnd(forwardReader, position, end);
+            if (forwardReader.isCancelled())
+                return false;
+            if (!matchEnd.has_value())
+                break;
+
+            auto matchStart = this->findMatchStart(backwardReader, matchEnd.value(), position);
+            if (!callback(matchStart, matchEnd.value() - matchStart))
+                return false;
+
+            position = matchEnd.value();
+        }
+
+        return true;
+    }
+
+    bool RegexSearcher::searchBuffer(const u8 *data, size_t size, u64 baseAddress, const Callback &callback) {
+        Reader reader(data, baseAddress, baseAddress + size);
+
+        return this->search(reader, reader, baseAddress, baseAddress + size, callback);
+    }
+
+    bool RegexSearcher::search(prv::Provider* &provider, u64 offset, size_t size, const Callback &callback, const std::atomic<bool> &cancelled, const std::function<void(u64)> &progress) {
+        size_t dataSize = provider->getActualSize();
+        if (offset >= dataSize)
+            return true;
+
+        u64 end = std::min<u64>(offset + size, dataSize);
+
+        provider->adviseAccess(offset, end - offset, prv::Provider::AccessHint::Sequential);
+        SCOPE_EXIT( provider->adviseAccess(offset, end - offset, prv::Provider::AccessHint::Normal); );
+
+        // Matches are searched for backwards from where they end, which mustn't throw away the chunk the forward search is in
+        Reader forwardReader(provider, offset, end, cancelled, progress);
+        Reader backwardReader(provider, offset, end, cancelled, progress);
+
+        return this->search(forwardReader, backwardReader, offset, end, callback);
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,488 @@
+#include <hex/helpers/search.hpp>
+
+#include <hex/api/task.hpp>
+#include <hex/providers/provider.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <optional>
+
+namespace hex {
+
+    namespace {
+
+        /* Calls the callback with every position the needle occurs at in the haystack, in ascending order */
+        template<typename Function>
+        bool forEachOccurrence(const u8 *haystack, size_t haystackSize, const u8 *needle, size_t needleSize, Function &&callback) {
+            if (needleSize == 0 || needleSize > haystackSize)
+                return true;
+
+            // Single bytes are best handled by memchr which is vectorized by every libc
+            if (needleSize == 1) {
+                const u8 *curr = haystack;
+                const u8 *end = haystack + haystackSize;
+
+                while (curr < end) {
+                    curr = static_cast<const u8*>(std::memchr(curr, needle[0], end - curr));
+                    if (curr == nullptr)
+                        break;
+
+                    if (!callback(size_t(curr - haystack)))
+                        return false;
+
+                    curr++;
+                }
+
+                return true;
+            }
+
+            std::boyer_moore_horspool_searcher searcher(needle, needle + needleSize);
+
+            const u8 *curr = haystack;
+            const u8 *end = haystack + haystackSize;
+            while (true) {
+                auto [matchBegin, matchEnd] = searcher(curr, end);
+                if (matchBegin == end)
+                    break;
+
+                if (!callback(size_t(matchBegin - haystack)))
+                    return false;
+
+                // Advance by a single byte only so overlapping occurrences get found as well
+                curr = matchBegin + 1;
+            }
+
+            return true;
+        }
+
+        /* Compares eight bytes at once where possible */
+        bool maskedCompare(const u8 *data, const u8 *bytes, const u8 *mask, size_t size) {
+            size_t i = 0;
+            for (; i + sizeof(u64) <= size; i += sizeof(u64)) {
+                u64 dataWord, bytesWord, maskWord;
+                std::memcpy(&dataWord, data + i, sizeof(u64));
+                std::memcpy(&bytesWord, bytes + i, sizeof(u64));
+                std::memcpy(&maskWord, mask + i, sizeof(u64));
+
+                if (((dataWord ^ bytesWord) & maskWord) != 0)
+                    return false;
+            }
+
+            for (; i < size; i++) {
+                if (((data[i] ^ bytes[i]) & mask[i]) != 0)
+                    return false;
+            }
+
+            return true;
+        }
+
+    }
+
+    SequenceSearcher::SequenceSearcher(std::vector<std::vector<u8>> needles) : SequenceSearcher(std::move(needles), { }) {
+
+    }
+
+    SequenceSearcher::SequenceSearcher(std::vector<std::vector<u8>> needles, std::vector<std::vector<u8>> masks) {
+        masks.resize(needles.size());
+
+        for (size_t i = 0; i < needles.size(); i++) {
+            if (needles[i].empty())
+                continue;
+
+            auto &mask = masks[i];
+            if (mask.empty())
+                mask.resize(needles[i].size(), 0xFF);
+            else
+                mask.resize(needles[i].size(), 0x00);
+
+            // Bytes that are cleared by the mask are irrelevant, clear them as well so they can be compared directly
+            for (size_t j = 0; j < needles[i].size(); j++)
+                needles[i][j] &= mask[j];
+
+            this->m_needles.push_back(std::move(needles[i]));
+            this->m_masks.push_back(std::move(mask));
+        }
+
+        this->m_firstBytes.resize(0x100, false);
+        this->m_firstPairs.resize(0x1'0000, false);
+
+        for (size_t i = 0; i < this->m_needles.size(); i++) {
+            const auto &needle = this->m_needles[i];
+            const auto &mask = this->m_masks[i];
+
+            Anchor anchor;
+            for (size_t start = 0; start < needle.size();) {
+                size_t end = start;
+                while (end < needle.size() && mask[end] == 0xFF)
+                    end++;
+
+                if (end - start > anchor.size)
+                    anchor = { start, end - start };
+
+                start = end + 1;
+            }
+
+            this->m_anchors.push_back(anchor);
+            this->m_longestNeedleSize = std::max(this->m_longestNeedleSize, needle.size());
+            this->m_longestAnchorOffset = std::max(this->m_longestAnchorOffset, anchor.offset);
+
+            if (anchor.size == 0) {
+                this->m_unanchoredNeedles.push_back(i);
+                continue;
+            }
+
+            const u8 *anchorBytes = needle.data() + anchor.offset;
+            this->m_needlesByFirstByte[anchorBytes[0]].push_back(i);
+
+            if (anchor.size == 1)
+                this->m_firstBytes[anchorBytes[0]] = true;
+            else
+                this->m_firstPairs[(u16(anchorBytes[0]) << 8) | anchorBytes[1]] = true;
+        }
+
+        // With many needles too many pairs pass the filter for it to help much
+        if (this->m_needles.size() >= AutomatonMinNeedles)
+            this->buildAutomaton();
+    }
+
+    void SequenceSearcher::buildAutomaton() {
+        // Trie of all anchors first. Nothing leads back to the root in a trie, so a transition to it means there's no edge yet
+        std::vector<std::vector<u32>> stateOutputs(1);
+        this->m_transitions.assign(0x100, 0);
+
+        for (size_t needleIndex = 0; needleIndex < this->m_needles.size(); needleIndex++) {
+            const auto &anchor = this->m_anchors[needleIndex];
+            if (anchor.size == 0)
+                continue;
+
+            u32 state = 0;
+            for (size_t i = 0; i < anchor.size; i++) {
+                size_t transition = state * 0x100 + this->m_needles[needleIndex][anchor.offset + i];
+
+                if (this->m_transitions[transition] == 0) {
+                    // Too many distinct anchors would make the table larger than the caches, the filters do better there
+                    if (stateOutputs.size() >= AutomatonMaxStates) {
+                        this->m_transitions.clear();
+                        return;
+                    }
+
+                    this->m_transitions[transition] = stateOutputs.size();
+                    this->m_transitions.resize(this->m_transitions.size() + 0x100, 0);
+                    stateOutputs.emplace_back();
+                }
+
+                state = this->m_transitions[transition];
+            }
+
+            stateOutputs[state].push_back(needleIndex);
+        }
+
+        // Breadth first, so the state of the longest proper suffix of every state is complete before the state itself gets visited.
+        // Missing transitions continue from that suffix state and its outputs end in the state as well
+        std::vector<u32> suffixes(stateOutputs.size(), 0);
+        std::vector<u32> queue;
+
+        for (u32 byte = 0; byte < 0x100; byte++) {
+            if (u32 next = this->m_transitions[byte]; next != 0)
+                queue.push_back(next);
+        }
+
+        for (size_t head = 0; head < queue.size(); head++) {
+            u32 state = queue[head];
+            u32 suffix = suffixes[state];
+
+            stateOutputs[state].insert(stateOutputs[state].end(), stateOutputs[suffix].begin(), stateOutputs[suffix].end());
+
+            for (u32 byte = 0; byte < 0x100; byte++) {
+                u32 &next = this->m_transitions[state * 0x100 + byte];
+                u32 suffixNext = this->m_transitions[suffix * 0x100 + byte];
+
+                if (next != 0) {
+                    suffixes[next] = suffixNext;
+                    queue.push_back(next);
+                } else {
+                    next = suffixNext;
+                }
+            }
+        }
+
+        this->m_outputOffsets.clear();
+        this->m_outputs.clear();
+        for (const auto &outputs : stateOutputs) {
+            this->m_outputOffsets.push_back(this->m_outputs.size());
+            this->m_outputs.insert(this->m_outputs.end(), outputs.begin(), outputs.end());
+        }
+        this->m_outputOffsets.push_back(this->m_outputs.size());
+
+        // Transitions point straight at the row of the next state and flag states that have outputs, which keeps the scanning loop down to a lookup and a test
+        for (auto &next : this->m_transitions)
+            next = (next * 0x100) | (stateOutputs[next].empty() ? 0 : AutomatonOutputFlag);
+    }
+
+    bool SequenceSearcher::parseHexPattern(std::string_view string, std::vector<u8> &bytes, std::vector<u8> &mask) {
+        bytes.clear();
+        mask.clear();
+
+        // Every whitespace separated token is parsed on its own. Tokens with an odd number of nibbles get a leading zero
+        size_t tokenStart = 0;
+        while (tokenStart < string.size()) {
+            if (std::isspace(string[tokenStart])) {
+                tokenStart++;
+                continue;
+            }
+
+            size_t tokenEnd = tokenStart;
+            while (tokenEnd < string.size() && !std::isspace(string[tokenEnd]))
+                tokenEnd++;
+
+            std::vector<std::optional<u8>> nibbles;
+            if (((tokenEnd - tokenStart) % 2) == 1)
+                nibbles.emplace_back(0x0);
+
+            for (char c : string.substr(tokenStart, tokenEnd - tokenStart)) {
+                if (c == '?')
+                    nibbles.emplace_back();
+                else if (std::isxdigit(c))
+                    nibbles.emplace_back(std::isdigit(c) ? c - '0' : std::tolower(c) - 'a' + 0xA);
+                else
+                    return false;
+            }
+
+            for (size_t i = 0; i < nibbles.size(); i += 2) {
+                u8 byte = 0x00, byteMask = 0x00;
+
+                if (nibbles[i].has_value()) {
+                    byte |= nibbles[i].value() << 4;
+                    byteMask |= 0xF0;
+                }
+                if (nibbles[i + 1].has_value()) {
+                    byte |= nibbles[i + 1].value();
+                    byteMask |= 0x0F;
+                }
+
+                bytes.push_back(byte);
+                mask.push_back(byteMask);
+            }
+
+            tokenStart = tokenEnd;
+        }
+
+        return true;
+    }
+
+    bool SequenceSearcher::matches(const u8 *data, size_t needle) const {
+        const auto &bytes = this->m_needles[needle];
+        const auto &anchor = this->m_anchors[needle];
+
+        if (anchor.size == bytes.size())
+            return std::memcmp(data, bytes.data(), bytes.size()) == 0;
+        else
+            return maskedCompare(data, bytes.data(), this->m_masks[needle].data(), bytes.size());
+    }
+
+    bool SequenceSearcher::searchBuffer(const u8 *data, size_t size, size_t startLimit, u64 baseAddress, const Callback &callback) const {
+        startLimit = std::min(startLimit, size);
+
+        if (this->m_needles.empty() || startLimit == 0)
+            return true;
+
+        if (this->m_needles.size() == 1)
+            return this->searchSingle(data, size, startLimit, baseAddress, callback);
+        else if (!this->m_transitions.empty())
+            return this->searchAutomaton(data, size, startLimit, baseAddress, callback);
+        else
+            return this->searchMultiple(data, size, startLimit, baseAddress, callback);
+    }
+
+    bool SequenceSearcher::searchSingle(const u8 *data, size_t size, size_t startLimit, u64 baseAddress, const Callback &callback) const {
+        const auto &needle = this->m_needles.front();
+        const auto &anchor = this->m_anchors.front();
+
+        if (needle.size() > size)
+            return true;
+
+        // Nothing to anchor on, every position needs to be compared
+        if (anchor.size == 0) {
+            for (size_t start = 0; start < startLimit && start + needle.size() <= size; start++) {
+                if (this->matches(data + start, 0) && !callback(baseAddress + start, 0))
+                    return false;
+            }
+
+            return true;
+        }
+
+        // Look for the anchor only in the part of the buffer where a full occurrence can still fit around it
+        const u8 *haystack = data + anchor.offset;
+        size_t haystackSize = size - needle.size() + anchor.size;
+
+        bool stopped = false;
+        forEachOccurrence(haystack, haystackSize, needle.data() + anchor.offset, anchor.size, [&](size_t position) {
+            if (position >= startLimit)
+                return false;
+
+            if (anchor.size == needle.size() || this->matches(data + position, 0)) {
+                if (!callback(baseAddress + position, 0)) {
+                    stopped = true;
+                    return false;
+                }
+            }
+
+            return true;
+        });
+
+        return !stopped;
+    }
+
+    bool SequenceSearcher::searchMultiple(const u8 *data, size_t size, size_t startLimit, u64 baseAddress, const Callback &callback) const {
+        size_t anchorLimit = std::min(size, startLimit + this->m_longestAnchorOffset);
+
+        for (size_t i = 0; i < anchorLimit; i++) {
+            bool singleByteMatch = this->m_firstBytes[data[i]];
+            bool pairMatch = (i + 1) < size && this->m_firstPairs[(u16(data[i]) << 8) | data[i + 1]];
+
+            if (singleByteMatch || pairMatch) {
+                for (auto needleIndex : this->m_needlesByFirstByte[data[i]]) {
+                    const auto &anchor = this->m_anchors[needleIndex];
+
+                    if (anchor.offset > i)
+                        continue;
+
+                    size_t start = i - anchor.offset;
+                    if (start >= startLimit || this->m_needles[needleIndex].size() > size - start)
+                        continue;
+
+                    if (this->matches(data + start, needleIndex) && !callback(baseAddress + start, needleIndex))
+                        return false;
+                }
+            }
+
+            if (i < startLimit) {
+                for (auto needleIndex : this->m_unanchoredNeedles) {
+                    if (this->m_needles[needleIndex].size() > size - i)
+                        continue;
+
+                    if (this->matches(data + i, needleIndex) && !callback(baseAddress + i, needleIndex))
+                        return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    bool SequenceSearcher::searchAutomaton(const u8 *data, size_t size, size_t startLimit, u64 baseAddress, const Callback &callback) const {
+        u32 row = 0;
+
+        for (size_t i = 0; i < size; i++) {
+            row = this->m_transitions[(row & ~AutomatonOutputFlag) + data[i]];
+
+            // Anchors are reported where they end, the needle around them still needs to fit and to match the bytes outside of the anchor
+            if ((row & AutomatonOutputFlag) != 0) [[unlikely]] {
+                u32 state = (row & ~AutomatonOutputFlag) / 0x100;
+
+                for (u32 output = this->m_outputOffsets[state]; output < this->m_outputOffsets[state + 1]; output++) {
+                    u32 needleIndex = this->m_outputs[output];
+                    const auto &anchor = this->m_anchors[needleIndex];
+
+                    size_t anchorStart = i + 1 - anchor.size;
+                    if (anchorStart < anchor.offset)
+                        continue;
+
+                    size_t start = anchorStart - anchor.offset;
+                    if (start >= startLimit || this->m_needles[needleIndex].size() > size - start)
+                        continue;
+
+                    if ((anchor.size == this->m_needles[needleIndex].size() || this->matches(data + start, needleIndex)) && !callback(baseAddress + start, needleIndex))
+                        return false;
+                }
+            }
+
+            if (i < startLimit) {
+                for (auto needleIndex : this->m_unanchoredNeedles) {
+                    if (this->m_needles[needleIndex].size() > size - i)
+                        continue;
+
+                    if (this->matches(data + i, needleIndex) && !callback(baseAddress + i, needleIndex))
+                        return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    bool SequenceSearcher::search(prv::Provider* &provider, u64 offset, size_t size, const Callback &callback) const {
+        if (this->m_needles.empty())
+            return true;
+
+        size_t dataSize = provider->getActualSize();
+        if (offset >= dataSize)
+            return true;
+
+        u64 end = std::min<u64>(offset + size, dataSize);
+
+        provider->adviseAccess(offset, end - offset, prv::Provider::AccessHint::Sequential);
+        SCOPE_EXIT( provider->adviseAccess(offset, end - offset, prv::Provider::AccessHint::Normal); );
+
+        // Chunks overlap by the length of the longest needle so no occurrence on a chunk boundary gets lost
+        std::vector<u8> buffer(ChunkSize + this->m_longestNeedleSize - 1);
+        for (u64 chunkOffset = offset; chunkOffset < end; chunkOffset += ChunkSize) {
+            size_t readSize = std::min<u64>(buffer.size(), end - chunkOffset);
+            provider->readAbsolute(chunkOffset, buffer.data(), readSize);
+
+            if (!this->searchBuffer(buffer.data(), readSize, ChunkSize, chunkOffset, callback))
+                return false;
+        }
+
+        return true;
+    }
+
+    void SequenceSearcher::searchParallel(prv::Provider* &provider, u64 offset, size_t size, const ChunkCallback &callback, const std::atomic<bool> &cancelled, u32 threadCount) const {
+        if (this->m_needles.empty())
+            return;
+
+        size_t dataSize = provider->getActualSize();
+        if (offset >= dataSize)
+            return;
+
+        u64 end = std::min<u64>(offset + size, dataSize);
+        u64 chunkCount = (end - offset + ChunkSize - 1) / ChunkSize;
+
+        // Workers grab the chunks in order, so the data still gets read front to back overall
+        provider->adviseAccess(offset, end - offset, prv::Provider::AccessHint::Sequential);
+        SCOPE_EXIT( provider->adviseAccess(offset, end - offset, prv::Provider::AccessHint::Normal); );
+
+        threadCount = std::min<u64>(provider->getReadWorkerCount(threadCount), chunkCount);
+
+        // Every worker keeps grabbing the next unsearched chunk until there are none left
+        std::atomic<u64> nextChunk = 0;
+        auto worker = [&] {
+            std::vector<u8> buffer(ChunkSize + this->m_longestNeedleSize - 1);
+            std::vector<std::pair<u64, size_t>> occurrences;
+
+            for (u64 chunk = nextChunk++; chunk < chunkCount && !cancelled; chunk = nextChunk++) {
+                u64 chunkOffset = offset + chunk * ChunkSize;
+                size_t readSize = std::min<u64>(buffer.size(), end - chunkOffset);
+                provider->readAbsolute(chunkOffset, buffer.data(), readSize);
+
+                occurrences.clear();
+                bool finished = this->searchBuffer(buffer.data(), readSize, ChunkSize, chunkOffset, [&](u64 address, size_t needle) {
+                    occurrences.emplace_back(address, needle);
+                    return !cancelled;
+                });
+
+                if (!finished)
+                    break;
+
+                if (!std::is_sorted(occurrences.begin(), occurrences.end()))
+                    std::sort(occurrences.begin(), occurrences.end());
+
+                callback(chunkOffset, std::min<u64>(ChunkSize, end - chunkOffset), std::move(occurrences));
+            }
+        };
+
+        TaskManager::runParallel(threadCount, [&](u32) { worker(); });
+    }
+
+}
\ No newline at end of file
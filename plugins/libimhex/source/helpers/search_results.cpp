@@ -0,0 +1,139 @@
+#include <hex/helpers/search_results.hpp>
+
+#include <hex/providers/provider.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+namespace hex {
+
+    namespace {
+
+        template<typename T>
+        bool equalAs(const u8 *left, const u8 *right) {
+            T leftValue, rightValue;
+            std::memcpy(&leftValue, left, sizeof(T));
+            std::memcpy(&rightValue, right, sizeof(T));
+
+            return leftValue == rightValue;
+        }
+
+        /* Results mostly are single values, comparing those directly saves a library call per result */
+        bool equal(const u8 *left, const u8 *right, size_t size) {
+            switch (size) {
+                case 1:  return left[0] == right[0];
+                case 2:  return equalAs<u16>(left, right);
+                case 4:  return equalAs<u32>(left, right);
+                case 8:  return equalAs<u64>(left, right);
+                default: return std::memcmp(left, right, size) == 0;
+            }
+        }
+
+    }
+
+    template<typename Callback>
+    void SearchResults::readResults(prv::Provider *provider, std::span<const u64> addresses, size_t resultSize, Callback &&callback) {
+        // Results close to each other get read with a single call, one read per result would cost far more than the compare itself
+        constexpr static size_t WindowSize = 0x1'0000;
+        constexpr static size_t MaxGap = 0x400;
+
+        size_t dataSize = provider->getActualSize();
+        std::vector<u8> buffer(std::max(WindowSize, resultSize));
+
+        for (size_t first = 0; first < addresses.size();) {
+            u64 start = addresses[first];
+            u64 end = start + resultSize;
+
+            size_t last = first + 1;
+            while (last < addresses.size() && addresses[last] + resultSize - start <= buffer.size() && addresses[last] <= end + MaxGap) {
+                end = std::max(end, addresses[last] + resultSize);
+                last++;
+            }
+
+            // Edits may have shrunk the data since the results were found
+            if (start < dataSize)
+                provider->readAbsolute(start, buffer.data(), std::min<u64>(end, dataSize) - start);
+
+            for (size_t index = first; index < last; index++) {
+                u64 address = addresses[index];
+                callback(index, address + resultSize <= dataSize ? buffer.data() + (address - start) : nullptr);
+            }
+
+            first = last;
+        }
+    }
+
+    void SearchResults::clear(size_t resultSize) {
+        this->m_addresses.clear();
+        this->m_sizes.clear();
+        this->m_snapshot.clear();
+        this->m_resultSize = resultSize;
+    }
+
+    void SearchResults::insert(std::vector<u64> &&addresses, std::vector<u32> &&sizes, std::vector<u8> &&snapshot) {
+        if (addresses.empty())
+            return;
+
+        // Chunks finish in any order but never overlap, so each one can be inserted as a whole
+        auto position = std::upper_bound(this->m_addresses.begin(), this->m_addresses.end(), addresses.front());
+        auto index = std::distance(this->m_addresses.begin(), position);
+
+        if (this->m_resultSize == 0)
+            this->m_sizes.insert(this->m_sizes.begin() + index, sizes.begin(), sizes.end());
+        else
+            this->m_snapshot.insert(this->m_snapshot.begin() + index * this->m_resultSize, snapshot.begin(), snapshot.end());
+
+        this->m_addresses.insert(position, addresses.begin(), addresses.end());
+    }
+
+    std::pair<u64, u64> SearchResults::operator[](size_t index) const {
+        u64 address = this->m_addresses[index];
+
+        return { address, address + (this->m_resultSize == 0 ? this->m_sizes[index] : this->m_resultSize) };
+    }
+
+    size_t SearchResults::narrow(prv::Provider *provider, Filter filter, const Predicate &predicate) {
+        if (!this->canNarrow())
+            return 0;
+
+        // Compacts in place, results are only ever moved to an index at or before the one being checked
+        size_t kept = 0;
+        readResults(provider, this->m_addresses, this->m_resultSize, [&, this](size_t index, const u8 *data) {
+            if (data == nullptr)
+                return;
+
+            bool keep;
+            switch (filter) {
+                case Filter::Matching:  keep = predicate(data); break;
+                case Filter::Changed:   keep = !equal(data, this->getSnapshot(index), this->m_resultSize); break;
+                case Filter::Unchanged: keep = equal(data, this->getSnapshot(index), this->m_resultSize); break;
+                default:                keep = true; break;
+            }
+
+            if (keep) {
+                this->m_addresses[kept] = this->m_addresses[index];
+                std::memcpy(this->m_snapshot.data() + kept * this->m_resultSize, data, this->m_resultSize);
+                kept++;
+            }
+        });
+
+        size_t dropped = this->m_addresses.size() - kept;
+        this->m_addresses.resize(kept);
+        this->m_snapshot.resize(kept * this->m_resultSize);
+
+        return dropped;
+    }
+
+    std::vector<u8> SearchResults::readSnapshot(prv::Provider *provider, std::span<const u64> addresses, size_t resultSize) {
+        std::vector<u8> snapshot(addresses.size() * resultSize);
+
+        readResults(provider, addresses, resultSize, [&](size_t index, const u8 *data) {
+            if (data != nullptr)
+                std::memcpy(snapshot.data() + index * resultSize, data, resultSize);
+        });
+
+        return snapshot;
+    }
+
+
+}
@@ -2,25 +2,34 @@
 
 namespace hex {
 
-    std::vector<EventHandler> SharedData::eventHandlers;
+    std::map<Events, EventHandlerList> SharedData::eventHandlers;
+    std::map<Events, CoalescedEvent> SharedData::coalescedEvents;
     std::vector<std::function<void()>> SharedData::deferredCalls;
     prv::Provider *SharedData::currentProvider;
+    std::shared_ptr<prv::Provider> SharedData::currentProviderHandle;
+    std::vector<std::shared_ptr<prv::Provider>> SharedData::providers;
     std::map<std::string, std::vector<ContentRegistry::Settings::Entry>> SharedData::settingsEntries;
     nlohmann::json SharedData::settingsJson;
+    std::optional<std::chrono::steady_clock::time_point> SharedData::settingsStoreTime;
+    TaskHolder SharedData::settingsStoreTask;
     std::map<std::string, Events> SharedData::customEvents;
     u32 SharedData::customEventsLastId;
     std::vector<ContentRegistry::CommandPaletteCommands::Entry> SharedData::commandPaletteCommands;
     std::map<std::string, ContentRegistry::PatternLanguageFunctions::Function> SharedData::patternLanguageFunctions;
+    std::unordered_set<std::string, StringHash, std::equal_to<>> SharedData::patternLanguageFunctionNames;
     std::vector<std::unique_ptr<View>> SharedData::views;
     std::vector<ContentRegistry::Tools::Entry> SharedData::toolsEntries;
     std::vector<ContentRegistry::DataInspector::Entry> SharedData::dataInspectorEntries;
     u32 SharedData::patternPaletteOffset;
     std::string SharedData::errorPopupMessage;
     std::list<ImHexApi::Bookmarks::Entry> SharedData::bookmarkEntries;
+    IntervalTree<ImHexApi::Bookmarks::Entry*> SharedData::bookmarkTree;
+    bool SharedData::bookmarkTreeValid = false;
+    std::map<std::string, std::vector<ImHexApi::Highlighting::Entry>> SharedData::highlightEntries;
 
     std::map<std::string, std::string> SharedData::languageNames;
     std::map<std::string, std::vector<LanguageDefinition>> SharedData::languageDefinitions;
-    std::map<std::string, std::string> SharedData::loadedLanguageStrings;
+    std::vector<LanguageDefinition::Entry> SharedData::loadedLanguageStrings;
 
     std::vector<ContentRegistry::Interface::DrawCallback> SharedData::welcomeScreenEntries;
     std::vector<ContentRegistry::Interface::DrawCallback> SharedData::footerItems;
@@ -28,11 +37,19 @@ namespace hex {
     std::vector<ContentRegistry::DataProcessorNode::Entry> SharedData::dataProcessorNodes;
     u32 SharedData::dataProcessorNodeIdCounter = 1;
 
+    std::vector<ContentRegistry::Providers::Entry> SharedData::providerEntries;
+
     int SharedData::mainArgc;
     char **SharedData::mainArgv;
+    bool SharedData::fastStart = false;
+
+    std::atomic<bool> SharedData::redrawRequested;
+    void(*SharedData::wakeUpMainLoop)() = nullptr;
 
     ImVec2 SharedData::windowPos;
     ImVec2 SharedData::windowSize;
 
-    std::map<std::string, std::any> SharedData::sharedVariables;
+    Region SharedData::hexEditorVisibleRegion = { 0, 0 };
+
+    std::map<std::string, std::any, std::less<>> SharedData::sharedVariables;
 }
\ No newline at end of file
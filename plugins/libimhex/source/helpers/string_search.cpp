@@ -0,0 +1,347 @@
+#include <hex/helpers/string_search.hpp>
+
+#include <hex/providers/provider.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <optional>
+
+namespace hex {
+
+    namespace {
+
+        constexpr u64 LowBits  = 0x7F7F'7F7F'7F7F'7F7F;
+        constexpr u64 HighBits = 0x8080'8080'8080'8080;
+
+        // Bytes holding the low and the high half of each UTF-16 code unit in a word loaded in native byte order
+        constexpr u64 EvenBytes = std::endian::native == std::endian::little ? 0x00FF'00FF'00FF'00FF : 0xFF00'FF00'FF00'FF00;
+        constexpr u64 OddBytes  = ~EvenBytes;
+
+        /* Sets the highest bit of every byte in the word that's a printable ASCII character */
+        constexpr u64 printableMask(u64 word) {
+            // Only the low seven bits take part in the additions so no carry can cross into the next byte
+            u64 low = word & LowBits;
+            u64 atLeastSpace = (low + 0x6060'6060'6060'6060) & HighBits;
+            u64 belowDelete = ~(low + 0x0101'0101'0101'0101) & HighBits;
+
+            return atLeastSpace & belowDelete & ~word & HighBits;
+        }
+
+        void appendUTF8(std::string &string, u32 codepoint) {
+            if (codepoint < 0x80) {
+                string += char(codepoint);
+            } else if (codepoint < 0x800) {
+                string += char(0xC0 | (codepoint >> 6));
+                string += char(0x80 | (codepoint & 0x3F));
+            } else if (codepoint < 0x1'0000) {
+                string += char(0xE0 | (codepoint >> 12));
+                string += char(0x80 | ((codepoint >> 6) & 0x3F));
+                string += char(0x80 | (codepoint & 0x3F));
+            } else {
+                string += char(0xF0 | (codepoint >> 18));
+                string += char(0x80 | ((codepoint >> 12) & 0x3F));
+                string += char(0x80 | ((codepoint >> 6) & 0x3F));
+                string += char(0x80 | (codepoint & 0x3F));
+            }
+        }
+
+        /*
+            Finds all strings starting inside of one chunk of data. Strings running in from the previous chunk
+            are left to that chunk, strings running past the end of the chunk get finished by reading ahead
+        */
+        class StringScanner {
+        public:
+            StringScanner(prv::Provider *provider, u64 chunkOffset, size_t chunkSize, size_t minimumLength)
+                : m_provider(provider), m_chunkOffset(chunkOffset), m_chunkEnd(chunkOffset + chunkSize), m_minimumLength(minimumLength) {
+
+                this->m_dataSize = provider->getActualSize();
+
+                // Keep a few bytes before the chunk around to tell if the first string started earlier
+                this->m_bufferOffset = chunkOffset - std::min<u64>(chunkOffset, 4);
+                this->load(this->m_chunkEnd + 0x1000);
+            }
+
+            void scan(StringEncoding encoding, u8 alignment) {
+                u64 offset = this->m_chunkOffset + alignment;
+                u32 codepoint;
+
+                if (this->continuesFromPreviousChunk(encoding, offset)) {
+                    while (u8 size = this->getCharacterSize(encoding, offset, codepoint))
+                        offset += size;
+                }
+
+                while (offset < this->m_chunkEnd) {
+                    if (this->getCharacterSize(encoding, offset, codepoint) == 0) {
+                        offset = this->skipInvalid(encoding, offset);
+                        continue;
+                    }
+
+                    u64 stringOffset = offset;
+                    size_t characters = 0;
+                    bool asciiOnly = true;
+
+                    while (true) {
+                        if (size_t fastCharacters = this->skipPrintable(encoding, offset); fastCharacters > 0) {
+                            characters += fastCharacters;
+                            continue;
+                        }
+
+                        u8 size = this->getCharacterSize(encoding, offset, codepoint);
+                        if (size == 0)
+                            break;
+
+                        asciiOnly = asciiOnly && codepoint < 0x80;
+                        characters++;
+                        offset += size;
+                    }
+
+                    if (characters >= this->m_minimumLength) {
+                        auto stringEncoding = (encoding == StringEncoding::UTF8 && asciiOnly) ? StringEncoding::ASCII : encoding;
+                        this->m_results.push_back({ stringOffset, u32(offset - stringOffset), stringEncoding, u16(std::min<size_t>(characters, 0xFFFF)) });
+                    }
+                }
+            }
+
+            std::vector<FoundString>& getResults() { return this->m_results; }
+
+        private:
+            prv::Provider *m_provider;
+            u64 m_chunkOffset, m_chunkEnd, m_dataSize;
+            size_t m_minimumLength;
+
+            std::vector<u8> m_buffer;
+            u64 m_bufferOffset;
+
+            std::vector<FoundString> m_results;
+
+            void load(u64 end) {
+                end = std::min(end, this->m_dataSize);
+
+                u64 bufferEnd = this->m_bufferOffset + this->m_buffer.size();
+                if (end <= bufferEnd)
+                    return;
+
+                this->m_buffer.resize(end - this->m_bufferOffset);
+                this->m_provider->readAbsolute(bufferEnd, this->m_buffer.data() + (bufferEnd - this->m_bufferOffset), end - bufferEnd);
+            }
+
+            /* Returns a pointer to count bytes at offset, reading more data if needed. Null if the data ends before that */
+            const u8* get(u64 offset, size_t count) {
+                if (offset < this->m_bufferOffset || offset + count > this->m_dataSize)
+                    return nullptr;
+
+                if (offset + count > this->m_bufferOffset + this->m_buffer.size())
+                    this->load(std::max(offset + count, this->m_bufferOffset + this->m_buffer.size() * 2));
+
+                return this->m_buffer.data() + (offset - this->m_bufferOffset);
+            }
+
+            u8 getCharacterSize(StringEncoding encoding, u64 offset, u32 &codepoint) {
+                switch (encoding) {
+                    case StringEncoding::ASCII: {
+                        auto data = this->get(offset, 1);
+                        if (data == nullptr || data[0] < 0x20 || data[0] > 0x7E)
+                            return 0;
+
+                        codepoint = data[0];
+                        return 1;
+                    }
+                    case StringEncoding::UTF8: {
+                        auto data = this->get(offset, 1);
+                        if (data == nullptr)
+                            return 0;
+
+                        u8 size;
+                        if (data[0] >= 0x20 && data[0] <= 0x7E) { codepoint = data[0]; return 1; }
+                        else if (data[0] >= 0xC2 && data[0] <= 0xDF) { size = 2; codepoint = data[0] & 0x1F; }
+                        else if (data[0] >= 0xE0 && data[0] <= 0xEF) { size = 3; codepoint = data[0] & 0x0F; }
+                        else if (data[0] >= 0xF0 && data[0] <= 0xF4) { size = 4; codepoint = data[0] & 0x07; }
+                        else return 0;
+
+                        data = this->get(offset, size);
+                        if (data == nullptr)
+                            return 0;
+
+                        for (u8 i = 1; i < size; i++) {
+                            if ((data[i] & 0xC0) != 0x80)
+                                return 0;
+                            codepoint = (codepoint << 6) | (data[i] & 0x3F);
+                        }
+
+                        // Reject overlong encodings, surrogates, C1 control characters and anything out of range
+                        constexpr u32 MinimumCodepoint[] = { 0, 0, 0xA0, 0x800, 0x1'0000 };
+                        if (codepoint < MinimumCodepoint[size] || (codepoint >= 0xD800 && codepoint <= 0xDFFF) || codepoint > 0x10'FFFF)
+                            return 0;
+
+                        return size;
+                    }
+                    case StringEncoding::UTF16LE:
+                    case StringEncoding::UTF16BE: {
+                        auto data = this->get(offset, 2);
+                        if (data == nullptr)
+                            return 0;
+
+                        u16 unit = encoding == StringEncoding::UTF16LE ? (data[0] | (data[1] << 8)) : ((data[0] << 8) | data[1]);
+
+                        // Only ASCII and Latin-1 characters, anything wider matches random data way too often
+                        if ((unit < 0x20 || unit > 0x7E) && (unit < 0xA0 || unit > 0xFF))
+                            return 0;
+
+                        codepoint = unit;
+                        return 2;
+                    }
+                }
+
+                return 0;
+            }
+
+            /* Skips a whole word of printable ASCII characters at once if possible and returns how many were skipped */
+            size_t skipPrintable(StringEncoding encoding, u64 &offset) {
+                auto data = this->get(offset, sizeof(u64));
+                if (data == nullptr)
+                    return 0;
+
+                u64 word;
+                std::memcpy(&word, data, sizeof(u64));
+
+                if (encoding == StringEncoding::ASCII || encoding == StringEncoding::UTF8) {
+                    if (printableMask(word) != HighBits)
+                        return 0;
+
+                    offset += sizeof(u64);
+                    return sizeof(u64);
+                } else {
+                    u64 lowBytes = encoding == StringEncoding::UTF16LE ? EvenBytes : OddBytes;
+
+                    if ((word & ~lowBytes) != 0 || (printableMask(word) & lowBytes) != (HighBits & lowBytes))
+                        return 0;
+
+                    offset += sizeof(u64);
+                    return sizeof(u64) / 2;
+                }
+            }
+
+            /* Skips over data that can't contain the start of a string, a whole word at a time if possible */
+            u64 skipInvalid(StringEncoding encoding, u64 offset) {
+                if (auto data = this->get(offset, sizeof(u64)); data != nullptr) {
+                    u64 word;
+                    std::memcpy(&word, data, sizeof(u64));
+
+                    bool canSkip = printableMask(word) == 0x00;
+                    if (encoding != StringEncoding::ASCII)
+                        canSkip = canSkip && (word & HighBits) == 0x00;
+
+                    if (canSkip)
+                        return offset + sizeof(u64);
+                }
+
+                return offset + ((encoding == StringEncoding::UTF16LE || encoding == StringEncoding::UTF16BE) ? 2 : 1);
+            }
+
+            bool continuesFromPreviousChunk(StringEncoding encoding, u64 offset) {
+                if (offset == 0)
+                    return false;
+
+                u32 codepoint;
+                switch (encoding) {
+                    case StringEncoding::ASCII:
+                        return this->getCharacterSize(encoding, offset - 1, codepoint) != 0;
+                    case StringEncoding::UTF8:
+                        for (u8 size = 1; size <= 4 && size <= offset; size++) {
+                            if (this->getCharacterSize(encoding, offset - size, codepoint) == size)
+                                return true;
+                        }
+                        return false;
+                    case StringEncoding::UTF16LE:
+                    case StringEncoding::UTF16BE:
+                        return offset >= 2 && this->getCharacterSize(encoding, offset - 2, codepoint) != 0;
+                }
+
+                return false;
+            }
+        };
+
+        /* ASCII text stored as UTF-16 is also valid UTF-16 of the other endianness when shifted by one byte. Keep the longer string of such overlaps */
+        void removeOverlappingWideStrings(std::vector<FoundString> &strings) {
+            auto isWide = [](const FoundString &string) { return string.encoding == StringEncoding::UTF16LE || string.encoding == StringEncoding::UTF16BE; };
+
+            std::vector<bool> removed(strings.size(), false);
+            std::optional<size_t> lastWide;
+
+            for (size_t i = 0; i < strings.size(); i++) {
+                if (!isWide(strings[i]))
+                    continue;
+
+                if (lastWide.has_value()) {
+                    auto &previous = strings[*lastWide];
+                    if (previous.encoding != strings[i].encoding && strings[i].offset < previous.offset + previous.size) {
+                        if (strings[i].size > previous.size)
+                            removed[*lastWide] = true;
+                        else {
+                            removed[i] = true;
+                            continue;
+                        }
+                    }
+                }
+
+                lastWide = i;
+            }
+
+            size_t index = 0;
+            std::erase_if(strings, [&](const auto&) { return removed[index++]; });
+        }
+
+    }
+
+    FoundStrings StringSearcher::searchChunk(prv::Provider *provider, u64 chunkOffset, size_t chunkSize, size_t minimumLength, StringSearchMode mode) {
+        StringScanner scanner(provider, chunkOffset, chunkSize, minimumLength);
+
+        switch (mode) {
+            case StringSearchMode::ASCII:
+                scanner.scan(StringEncoding::ASCII, 0);
+                break;
+            case StringSearchMode::UTF8:
+                scanner.scan(StringEncoding::UTF8, 0);
+                break;
+            case StringSearchMode::UTF16LE:
+            case StringSearchMode::UTF16BE: {
+                auto encoding = mode == StringSearchMode::UTF16LE ? StringEncoding::UTF16LE : StringEncoding::UTF16BE;
+                scanner.scan(encoding, 0);
+                scanner.scan(encoding, 1);
+                break;
+            }
+            case StringSearchMode::All:
+                scanner.scan(StringEncoding::UTF8, 0);
+                for (auto encoding : { StringEncoding::UTF16LE, StringEncoding::UTF16BE }) {
+                    scanner.scan(encoding, 0);
+                    scanner.scan(encoding, 1);
+                }
+                break;
+        }
+
+        auto &results = scanner.getResults();
+        std::stable_sort(results.begin(), results.end(), [](const auto &left, const auto &right) { return left.offset < right.offset; });
+
+        if (mode == StringSearchMode::All)
+            removeOverlappingWideStrings(results);
+
+        return std::move(results);
+    }
+
+    std::string StringSearcher::decode(const u8 *data, const FoundString &foundString) {
+        if (foundString.encoding == StringEncoding::ASCII || foundString.encoding == StringEncoding::UTF8)
+            return std::string(reinterpret_cast<const char*>(data), foundString.size);
+
+        std::string string;
+        for (size_t i = 0; i + 1 < foundString.size; i += 2) {
+            if (foundString.encoding == StringEncoding::UTF16LE)
+                appendUTF8(string, data[i] | (data[i + 1] << 8));
+            else
+                appendUTF8(string, (data[i] << 8) | data[i + 1]);
+        }
+
+        return string;
+    }
+
+}
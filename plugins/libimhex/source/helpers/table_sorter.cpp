@@ -0,0 +1,105 @@
+#include <hex/helpers/table_sorter.hpp>
+
+#include <algorithm>
+#include <numeric>
+
+namespace hex {
+
+    TableSorter::~TableSorter() {
+        for (auto &task : this->m_sortTasks)
+            task.interrupt();
+
+        // The comparator factories may use whatever owns the sorter
+        for (auto &task : this->m_sortTasks)
+            task.wait();
+    }
+
+    void TableSorter::invalidate() {
+        std::scoped_lock lock(this->m_state->mutex);
+
+        this->m_state->generation++;
+        this->m_state->orders.clear();
+        this->m_state->currentKey.reset();
+        this->m_state->currentOrder.reset();
+
+        for (auto &task : this->m_sortTasks)
+            task.interrupt();
+    }
+
+    void TableSorter::sort(u64 key, u32 rowCount, ComparatorFactory factory) {
+        std::scoped_lock lock(this->m_state->mutex);
+
+        this->m_state->currentKey = key;
+
+        for (auto &task : this->m_sortTasks)
+            task.interrupt();
+        std::erase_if(this->m_sortTasks, [](const auto &task) { return !task.isRunning(); });
+
+        if (auto it = this->m_state->orders.find(key); it != this->m_state->orders.end()) {
+            this->m_state->currentOrder = it->second;
+            return;
+        }
+
+        this->m_sortTasks.push_back(TaskManager::createTask("hex.common.sorting", 0, [state = this->m_state, key, rowCount, factory = std::move(factory), generation = this->m_state->generation](Task &task) {
+            if (task.isInterrupted())
+                return;
+
+            auto comparator = factory();
+            if (!comparator || task.isInterrupted())
+                return;
+
+            auto order = std::make_shared<std::vector<u32>>(rowCount);
+            std::iota(order->begin(), order->end(), 0);
+
+            sortParallel(*order, comparator, task);
+            if (task.isInterrupted())
+                return;
+
+            std::scoped_lock lock(state->mutex);
+            if (state->generation != generation)
+                return;
+
+            state->orders[key] = order;
+            if (state->currentKey == key)
+                state->currentOrder = std::move(order);
+        }));
+    }
+
+    bool TableSorter::isSorting() const {
+        return !this->m_sortTasks.empty() && this->m_sortTasks.back().isRunning();
+    }
+
+    std::shared_ptr<const std::vector<u32>> TableSorter::getOrder() const {
+        std::scoped_lock lock(this->m_state->mutex);
+
+        return this->m_state->currentOrder;
+    }
+
+    void TableSorter::sortParallel(std::vector<u32> &order, const Comparator &comparator, Task &task) {
+        u32 parts = std::clamp<u64>(order.size() / MinimumPartSize, 1, TaskManager::getWorkerCount());
+
+        // Every part gets sorted on its own, then neighbouring parts get merged until only one is left
+        std::vector<size_t> bounds(parts + 1);
+        for (u32 i = 0; i <= parts; i++)
+            bounds[i] = order.size() * i / parts;
+
+        TaskManager::runParallel(parts, [&](u32 part) {
+            std::sort(order.begin() + bounds[part], order.begin() + bounds[part + 1], comparator);
+        });
+
+        while (bounds.size() > 2 && !task.isInterrupted()) {
+            TaskManager::runParallel((bounds.size() - 1) / 2, [&](u32 pair) {
+                std::inplace_merge(order.begin() + bounds[pair * 2], order.begin() + bounds[pair * 2 + 1], order.begin() + bounds[pair * 2 + 2], comparator);
+            });
+
+            std::vector<size_t> merged;
+            for (size_t i = 0; i < bounds.size(); i += 2)
+                merged.push_back(bounds[i]);
+            if (merged.back() != bounds.back())
+                merged.push_back(bounds.back());
+
+            bounds = std::move(merged);
+        }
+    }
+
+}
@@ -0,0 +1,199 @@
+#include <hex/helpers/tracing.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+namespace hex {
+
+    namespace {
+
+        struct Event {
+            u64 start, duration;    // Nanoseconds since the process started
+            u64 argument;
+            const char *category;
+            char name[Tracing::MaxNameLength + 1];
+        };
+
+        /*
+            Only the thread owning the buffer writes to it. An event is written first and counted after that, so everything below the count
+            is complete. Exporting reads the buffer while its thread keeps going and throws away whatever got overwritten in the meantime
+        */
+        struct ThreadBuffer {
+            u32 id;
+            std::string name;   // Guarded by the buffers mutex
+            std::array<Event, Tracing::EventsPerThread> events;
+            std::atomic<u64> written = 0;
+            std::atomic<u64> writtenWhenEnabled = 0;
+        };
+
+        const auto processStart = std::chrono::steady_clock::now();
+
+        // Buffers outlive their threads, events of workers that are gone by now still get exported
+        std::mutex buffersMutex;
+        std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+
+        // Buffers are only created once a thread records its first event, most threads never do unless tracing got enabled
+        thread_local ThreadBuffer *threadBuffer = nullptr;
+        thread_local std::string threadName;
+
+        u64 getTimestamp() {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - processStart).count();
+        }
+
+        ThreadBuffer& getThreadBuffer() {
+            if (threadBuffer == nullptr) {
+                auto buffer = std::make_shared<ThreadBuffer>();
+
+                std::scoped_lock lock(buffersMutex);
+                buffer->id = buffers.size() + 1;
+                buffer->name = threadName;
+                buffers.push_back(buffer);
+                threadBuffer = buffer.get();
+            }
+
+            return *threadBuffer;
+        }
+
+        /* Copies the events of a buffer that are still complete, oldest first */
+        std::vector<Event> collectEvents(const ThreadBuffer &buffer) {
+            u64 end = buffer.written.load(std::memory_order_acquire);
+            u64 begin = std::min(std::max(end > Tracing::EventsPerThread ? end - Tracing::EventsPerThread : 0, buffer.writtenWhenEnabled.load()), end);
+
+            std::vector<Event> events;
+            events.reserve(end - begin);
+            for (u64 i = begin; i < end; i++)
+                events.push_back(buffer.events[i % Tracing::EventsPerThread]);
+
+            // The thread may be writing the slot after the newest event already, that overwrites the one a whole buffer further back
+            u64 writtenSince = buffer.written.load(std::memory_order_acquire);
+            u64 firstIntact = writtenSince + 1 > Tracing::EventsPerThread ? writtenSince + 1 - Tracing::EventsPerThread : 0;
+            if (firstIntact > begin)
+                events.erase(events.begin(), events.begin() + std::min(firstIntact - begin, events.size()));
+
+            return events;
+        }
+
+    }
+
+    Tracing::Scope::Scope(std::string_view name, const char *category, u64 argument) : m_name(name), m_category(category), m_argument(argument) {
+        this->m_active = Tracing::isEnabled();
+        if (this->m_active)
+            this->m_start = getTimestamp();
+    }
+
+    Tracing::Scope::~Scope() {
+        if (!this->m_active)
+            return;
+
+        auto end = getTimestamp();
+
+        auto &buffer = getThreadBuffer();
+        u64 index = buffer.written.load(std::memory_order_relaxed);
+
+        auto &event = buffer.events[index % EventsPerThread];
+        event.start = this->m_start;
+        event.duration = end - this->m_start;
+        event.argument = this->m_argument;
+        event.category = this->m_category;
+
+        auto length = std::min(this->m_name.size(), MaxNameLength);
+        std::memcpy(event.name, this->m_name.data(), length);
+        event.name[length] = '\0';
+
+        buffer.written.store(index + 1, std::memory_order_release);
+    }
+
+    void Tracing::setEnabled(bool enabled) {
+        if (enabled && !isEnabled()) {
+            std::scoped_lock lock(buffersMutex);
+            for (auto &buffer : buffers)
+                buffer->writtenWhenEnabled = buffer->written.load();
+        }
+
+        s_enabled = enabled;
+    }
+
+    void Tracing::setThreadName(std::string_view name) {
+        threadName = name;
+
+        if (threadBuffer != nullptr) {
+            std::scoped_lock lock(buffersMutex);
+            threadBuffer->name = name;
+        }
+    }
+
+    u64 Tracing::getEventCount() {
+        std::scoped_lock lock(buffersMutex);
+
+        u64 count = 0;
+        for (const auto &buffer : buffers)
+            count += std::min<u64>(buffer->written - buffer->writtenWhenEnabled, EventsPerThread);
+
+        return count;
+    }
+
+    bool Tracing::exportTrace(const std::string &path) {
+        std::ofstream file(path);
+        if (!file.is_open())
+            return false;
+
+        std::vector<std::shared_ptr<ThreadBuffer>> threads;
+        {
+            std::scoped_lock lock(buffersMutex);
+            threads = buffers;
+        }
+
+        // Events get written one by one, a whole trace as a single JSON value would take many times the memory of the buffers
+        file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+        bool first = true;
+        auto writeEvent = [&](const nlohmann::json &event) {
+            if (!first)
+                file << ",\n";
+            // Names cut off at their maximum length may end in the middle of a character
+            file << event.dump(-1, ' ', false, nlohmann::json::error_handler_t::replace);
+            first = false;
+        };
+
+        for (const auto &thread : threads) {
+            std::string name;
+            {
+                std::scoped_lock lock(buffersMutex);
+                name = thread->name.empty() ? hex::format("Thread {}", thread->id) : thread->name;
+            }
+
+            writeEvent({ { "ph", "M" }, { "name", "thread_name" }, { "pid", 1 }, { "tid", thread->id }, { "args", { { "name", name } } } });
+
+            for (const auto &event : collectEvents(*thread)) {
+                // Chrome traces count in microseconds
+                nlohmann::json entry = {
+                    { "ph", "X" },
+                    { "name", std::string(event.name) },
+                    { "cat", event.category },
+                    { "pid", 1 },
+                    { "tid", thread->id },
+                    { "ts", event.start / 1000.0 },
+                    { "dur", event.duration / 1000.0 }
+                };
+
+                if (event.argument != NoArgument)
+                    entry["args"] = { { "value", event.argument } };
+
+                writeEvent(entry);
+            }
+        }
+
+        file << "\n]}\n";
+
+        return file.good();
+    }
+
+}
@@ -1,6 +1,10 @@
 #include <hex/helpers/utils.hpp>
 
+#include <hex/helpers/crypto.hpp>
+
+#include <algorithm>
 #include <cstdio>
+#include <cstring>
 #include <codecvt>
 #include <locale>
 #include <filesystem>
@@ -16,6 +20,41 @@
 
 namespace hex {
 
+    namespace {
+
+        template<typename T>
+        void swapEach(u8 *data, size_t count) {
+            constexpr auto foreign = std::endian::native == std::endian::little ? std::endian::big : std::endian::little;
+
+            // Fixed size loads and stores let the compiler turn this into vector shuffles
+            for (size_t i = 0; i < count; i++) {
+                T value;
+                std::memcpy(&value, data + i * sizeof(T), sizeof(T));
+                value = hex::changeEndianess(value, foreign);
+                std::memcpy(data + i * sizeof(T), &value, sizeof(T));
+            }
+        }
+
+    }
+
+    void changeEndianess(void *data, size_t count, size_t size, std::endian endian) {
+        if (endian == std::endian::native)
+            return;
+
+        auto bytes = static_cast<u8*>(data);
+        switch (size) {
+            case 1:  break;
+            case 2:  swapEach<u16>(bytes, count); break;
+            case 4:  swapEach<u32>(bytes, count); break;
+            case 8:  swapEach<u64>(bytes, count); break;
+            case 16: swapEach<u128>(bytes, count); break;
+            default:
+                for (size_t i = 0; i < count; i++)
+                    std::reverse(bytes + i * size, bytes + (i + 1) * size);
+                break;
+        }
+    }
+
     std::string to_string(u128 value) {
         char data[45] = { 0 };
 
@@ -131,6 +170,42 @@ namespace hex {
         return res;
     }
 
+    void appendHexString(std::string &string, std::span<const u8> bytes, std::string_view prefix, std::string_view separator) {
+        if (bytes.empty())
+            return;
+
+        constexpr static auto Digits = "0123456789ABCDEF";
+
+        auto offset = string.size();
+        string.resize(offset + bytes.size() * (prefix.size() + 2 + separator.size()) - separator.size());
+
+        auto output = string.data() + offset;
+        for (size_t i = 0; i < bytes.size(); i++) {
+            if (i != 0) {
+                std::memcpy(output, separator.data(), separator.size());
+                output += separator.size();
+            }
+
+            std::memcpy(output, prefix.data(), prefix.size());
+            output += prefix.size();
+
+            output[0] = Digits[bytes[i] >> 4];
+            output[1] = Digits[bytes[i] & 0x0F];
+            output += 2;
+        }
+    }
+
+    std::vector<u8> parseByteString(std::string_view string) {
+        std::string byteString(string);
+        byteString.erase(std::remove(byteString.begin(), byteString.end(), ' '), byteString.end());
+
+        std::vector<u8> result(byteString.size() / 2);
+        if (!crypt::decodeHex({ reinterpret_cast<const u8*>(byteString.data()), byteString.size() }, result.data()).has_value())
+            return { };
+
+        return result;
+    }
+
     std::string toEngineeringString(double value) {
         constexpr std::array Suffixes = { "a", "f", "p", "n", "u", "m", "", "k", "M", "G", "T", "P", "E" };
 
@@ -212,6 +287,8 @@ namespace hex {
                     return { (appDataDir / "imhex" / "config").string() };
                 case ImHexPath::Resources:
                     return { (parentDir / "resources").string() };
+                case ImHexPath::Cache:
+                    return { (appDataDir / "imhex" / "cache").string() };
                 default: __builtin_unreachable();
             }
         #elif defined(OS_MACOS)
@@ -258,6 +335,8 @@ namespace hex {
                     std::transform(dataDirs.begin(), dataDirs.end(), std::back_inserter(result),
                         [](auto p) { return (p / "imhex" / "resources").string(); });
                     return result;
+                case ImHexPath::Cache:
+                    return { (xdg::CacheHomeDir() / "imhex").string() };
                 default: __builtin_unreachable();
             }
         #endif
@@ -43,6 +43,9 @@
                     case ImHexPath::Resources:
                         result = [appSupportDir URLByAppendingPathComponent:@"/imhex/resources"];
                         break;
+                    case ImHexPath::Cache:
+                        result = [appSupportDir URLByAppendingPathComponent:@"/imhex/cache"];
+                        break;
                 }
 
                 if (result == nil) {
@@ -0,0 +1,410 @@
+#include <hex/helpers/value_search.hpp>
+
+#include <hex/api/task.hpp>
+#include <hex/helpers/utils.hpp>
+#include <hex/providers/provider.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+    #include <immintrin.h>
+#endif
+
+namespace hex {
+
+    namespace {
+
+        template<typename T>
+        T load(const u8 *data, std::endian endian) {
+            T value;
+            std::memcpy(&value, data, sizeof(T));
+
+            return changeEndianess(value, endian);
+        }
+
+        u64 getTypeMask(size_t size) {
+            return size == sizeof(u64) ? std::numeric_limits<u64>::max() : (u64(1) << (size * 8)) - 1;
+        }
+
+        std::string trim(std::string_view string) {
+            while (!string.empty() && std::isspace(string.front()))
+                string.remove_prefix(1);
+            while (!string.empty() && std::isspace(string.back()))
+                string.remove_suffix(1);
+
+            return std::string(string);
+        }
+
+    #if defined(__x86_64__) || defined(__i386__)
+
+        bool isAVX2Supported() {
+            static bool supported = __builtin_cpu_supports("avx2");
+            return supported;
+        }
+
+        /* Shuffle that spreads 16 loaded bytes out into the values at consecutive offsets, reversing the bytes of every value for big endian */
+        template<size_t Size>
+        constexpr std::array<u8, 16> makeSpreadPattern(bool reversed) {
+            std::array<u8, 16> pattern = { };
+
+            for (size_t value = 0; value < 16 / Size; value++) {
+                for (size_t byte = 0; byte < Size; byte++)
+                    pattern[value * Size + byte] = value + (reversed ? Size - 1 - byte : byte);
+            }
+
+            return pattern;
+        }
+
+    #endif
+
+    }
+
+    ValueSearcher::ValueSearcher(ValueType type, std::endian endian, u32 alignment, u64 minimum, u64 maximum)
+        : m_type(type), m_size(getSize(type)), m_endian(endian), m_alignment(std::max<u32>(alignment, 1)) {
+
+        const u64 mask = getTypeMask(this->m_size);
+
+        if (isSigned(type)) {
+            const s64 typeMax = s64(mask >> 1);
+            const s64 typeMin = -typeMax - 1;
+
+            s64 low = std::max(s64(minimum), typeMin);
+            s64 high = std::min(s64(maximum), typeMax);
+
+            this->m_empty = low > high;
+            this->m_flip = u64(typeMin) & mask;
+            this->m_low = (u64(low) & mask) ^ this->m_flip;
+            this->m_span = ((u64(high) & mask) ^ this->m_flip) - this->m_low;
+        } else {
+            u64 high = std::min(maximum, mask);
+
+            this->m_empty = minimum > high;
+            this->m_low = minimum;
+            this->m_span = high - minimum;
+        }
+    }
+
+    ValueSearcher::ValueSearcher(ValueType type, std::endian endian, u32 alignment, double minimum, double maximum)
+        : m_type(type), m_size(getSize(type)), m_endian(endian), m_alignment(std::max<u32>(alignment, 1)) {
+
+        if (type == ValueType::Float) {
+            float low = float(minimum);
+            if (double(low) < minimum)
+                low = std::nextafter(low, std::numeric_limits<float>::infinity());
+
+            float high = float(maximum);
+            if (double(high) > maximum)
+                high = std::nextafter(high, -std::numeric_limits<float>::infinity());
+
+            this->m_lowFloat = low;
+            this->m_highFloat = high;
+        } else {
+            this->m_lowFloat = minimum;
+            this->m_highFloat = maximum;
+        }
+
+        // Also catches NaN bounds
+        this->m_empty = !(this->m_lowFloat <= this->m_highFloat);
+    }
+
+    size_t ValueSearcher::getSize(ValueType type) {
+        switch (type) {
+            case ValueType::U8:
+            case ValueType::S8:
+                return 1;
+            case ValueType::U16:
+            case ValueType::S16:
+                return 2;
+            case ValueType::U32:
+            case ValueType::S32:
+            case ValueType::Float:
+                return 4;
+            case ValueType::U64:
+            case ValueType::S64:
+            case ValueType::Double:
+                return 8;
+        }
+
+        return 1;
+    }
+
+    std::optional<u64> ValueSearcher::parseInteger(ValueType type, std::string_view string) {
+        auto trimmed = trim(string);
+        if (trimmed.empty() || isFloatingPoint(type))
+            return { };
+
+        const u64 mask = getTypeMask(getSize(type));
+        char *end = nullptr;
+        errno = 0;
+
+        if (isSigned(type)) {
+            s64 value = std::strtoll(trimmed.c_str(), &end, 0);
+
+            const s64 typeMax = s64(mask >> 1);
+            if (errno != 0 || *end != '\0' || value > typeMax || value < -typeMax - 1)
+                return { };
+
+            return u64(value);
+        } else {
+            // strtoull happily negates values, which no unsigned type can hold
+            if (trimmed.front() == '-')
+                return { };
+
+            u64 value = std::strtoull(trimmed.c_str(), &end, 0);
+            if (errno != 0 || *end != '\0' || value > mask)
+                return { };
+
+            return value;
+        }
+    }
+
+    std::optional<double> ValueSearcher::parseFloat(std::string_view string) {
+        auto trimmed = trim(string);
+        if (trimmed.empty())
+            return { };
+
+        char *end = nullptr;
+        double value = std::strtod(trimmed.c_str(), &end);
+        if (*end != '\0' || std::isnan(value))
+            return { };
+
+        return value;
+    }
+
+    bool ValueSearcher::matches(const u8 *data) const {
+        u64 bits;
+        switch (this->m_size) {
+            case 1:  bits = data[0]; break;
+            case 2:  bits = load<u16>(data, this->m_endian); break;
+            case 4:  bits = load<u32>(data, this->m_endian); break;
+            default: bits = load<u64>(data, this->m_endian); break;
+        }
+
+        if (this->m_type == ValueType::Float) {
+            auto value = std::bit_cast<float>(u32(bits));
+            return value >= this->m_lowFloat && value <= this->m_highFloat;
+        } else if (this->m_type == ValueType::Double) {
+            auto value = std::bit_cast<double>(bits);
+            return value >= this->m_lowFloat && value <= this->m_highFloat;
+        } else {
+            return (((bits ^ this->m_flip) - this->m_low) & getTypeMask(this->m_size)) <= this->m_span;
+        }
+    }
+
+#if defined(__x86_64__) || defined(__i386__)
+
+    template<size_t Size, bool FloatingPoint>
+    __attribute__((target("avx2")))
+    bool ValueSearcher::searchVectorized(const u8 *data, size_t size, size_t startLimit, u64 baseAddress, const Callback &callback, size_t &position) const {
+        // One lane per offset. Wider values are spread out from two overlapping 16 byte loads, one for each half of the register
+        constexpr size_t Offsets = Size == 1 ? 32 : 32 / Size;
+        constexpr size_t HalfOffsets = Offsets / 2;
+
+        static constexpr auto LittleEndianPattern = makeSpreadPattern<Size>(false);
+        static constexpr auto BigEndianPattern = makeSpreadPattern<Size>(true);
+        const __m256i spread = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(this->m_endian == std::endian::big ? BigEndianPattern.data() : LittleEndianPattern.data())));
+
+        // Offsets that aren't aligned get masked out, which ones those are depends on where the block starts
+        std::array<u32, 32> alignmentMasks = { };
+        for (u32 phase = 0; phase < this->m_alignment; phase++) {
+            for (u32 offset = 0; offset < Offsets; offset++) {
+                if ((phase + offset) % this->m_alignment == 0)
+                    alignmentMasks[phase] |= u32(1) << offset;
+            }
+        }
+
+        __m256i flip, low, span;
+        if constexpr (Size == 1) {
+            flip = _mm256_set1_epi8(char(this->m_flip));
+            low = _mm256_set1_epi8(char(this->m_low));
+            span = _mm256_set1_epi8(char(this->m_span));
+        } else if constexpr (Size == 2) {
+            flip = _mm256_set1_epi16(short(this->m_flip));
+            low = _mm256_set1_epi16(short(this->m_low));
+            span = _mm256_set1_epi16(short(this->m_span));
+        } else if constexpr (Size == 4) {
+            flip = _mm256_set1_epi32(int(this->m_flip));
+            low = _mm256_set1_epi32(int(this->m_low));
+            span = _mm256_set1_epi32(int(this->m_span));
+        } else {
+            // There's no unsigned 64 bit compare, flipping the sign bit of both sides turns it into a signed one
+            const __m256i sign = _mm256_set1_epi64x(std::numeric_limits<s64>::min());
+            flip = _mm256_set1_epi64x(s64(this->m_flip));
+            low = _mm256_set1_epi64x(s64(this->m_low));
+            span = _mm256_xor_si256(_mm256_set1_epi64x(s64(this->m_span)), sign);
+        }
+
+        const __m256 lowFloat = _mm256_set1_ps(float(this->m_lowFloat)), highFloat = _mm256_set1_ps(float(this->m_highFloat));
+        const __m256d lowDouble = _mm256_set1_pd(this->m_lowFloat), highDouble = _mm256_set1_pd(this->m_highFloat);
+
+        // Advanced along with the position, a division per block would cost more than the compare itself
+        const u32 phaseStep = Offsets % this->m_alignment;
+        u32 phase = (baseAddress + position) % this->m_alignment;
+
+        for (; position < startLimit && position + 32 <= size; position += Offsets) {
+            __m256i values;
+            if constexpr (Size == 1) {
+                values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + position));
+            } else {
+                __m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + position));
+                __m128i second = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + position + HalfOffsets));
+                values = _mm256_shuffle_epi8(_mm256_inserti128_si256(_mm256_castsi128_si256(first), second, 1), spread);
+            }
+
+            u32 mask;
+            if constexpr (FloatingPoint && Size == 4) {
+                __m256 floats = _mm256_castsi256_ps(values);
+                mask = _mm256_movemask_ps(_mm256_and_ps(_mm256_cmp_ps(floats, lowFloat, _CMP_GE_OQ), _mm256_cmp_ps(floats, highFloat, _CMP_LE_OQ)));
+            } else if constexpr (FloatingPoint) {
+                __m256d doubles = _mm256_castsi256_pd(values);
+                mask = _mm256_movemask_pd(_mm256_and_pd(_mm256_cmp_pd(doubles, lowDouble, _CMP_GE_OQ), _mm256_cmp_pd(doubles, highDouble, _CMP_LE_OQ)));
+            } else {
+                __m256i distance;
+
+                if constexpr (Size == 1) {
+                    distance = _mm256_sub_epi8(_mm256_xor_si256(values, flip), low);
+                    mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_max_epu8(distance, span), span));
+                } else if constexpr (Size == 2) {
+                    distance = _mm256_sub_epi16(_mm256_xor_si256(values, flip), low);
+
+                    // Packing keeps one byte per value, in order within each half of the register
+                    u32 bytes = _mm256_movemask_epi8(_mm256_packs_epi16(_mm256_cmpeq_epi16(_mm256_max_epu16(distance, span), span), _mm256_setzero_si256()));
+                    mask = (bytes & 0xFF) | ((bytes >> 8) & 0xFF00);
+                } else if constexpr (Size == 4) {
+                    distance = _mm256_sub_epi32(_mm256_xor_si256(values, flip), low);
+                    mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_max_epu32(distance, span), span)));
+                } else {
+                    const __m256i sign = _mm256_set1_epi64x(std::numeric_limits<s64>::min());
+                    distance = _mm256_xor_si256(_mm256_sub_epi64(_mm256_xor_si256(values, flip), low), sign);
+                    mask = ~u32(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(distance, span)))) & 0xF;
+                }
+            }
+
+            mask &= alignmentMasks[phase];
+            phase += phaseStep;
+            if (phase >= this->m_alignment)
+                phase -= this->m_alignment;
+
+            if (position + Offsets > startLimit)
+                mask &= (u32(1) << (startLimit - position)) - 1;
+
+            while (mask != 0) {
+                u32 offset = std::countr_zero(mask);
+                mask &= mask - 1;
+
+                if (!callback(baseAddress + position + offset))
+                    return false;
+            }
+        }
+
+        return true;
+    }
+
+#endif
+
+    bool ValueSearcher::searchBuffer(const u8 *data, size_t size, size_t startLimit, u64 baseAddress, const Callback &callback) const {
+        if (this->m_empty || size < this->m_size)
+            return true;
+
+        // Values have to fit into the buffer entirely
+        startLimit = std::min(startLimit, size - this->m_size + 1);
+        size_t position = 0;
+
+    #if defined(__x86_64__) || defined(__i386__)
+        if (this->m_alignment <= 32 && isAVX2Supported()) {
+            bool finished;
+            switch (this->m_type) {
+                case ValueType::U8:
+                case ValueType::S8:
+                    finished = this->searchVectorized<1, false>(data, size, startLimit, baseAddress, callback, position);
+                    break;
+                case ValueType::U16:
+                case ValueType::S16:
+                    finished = this->searchVectorized<2, false>(data, size, startLimit, baseAddress, callback, position);
+                    break;
+                case ValueType::U32:
+                case ValueType::S32:
+                    finished = this->searchVectorized<4, false>(data, size, startLimit, baseAddress, callback, position);
+                    break;
+                case ValueType::U64:
+                case ValueType::S64:
+                    finished = this->searchVectorized<8, false>(data, size, startLimit, baseAddress, callback, position);
+                    break;
+                case ValueType::Float:
+                    finished = this->searchVectorized<4, true>(data, size, startLimit, baseAddress, callback, position);
+                    break;
+                case ValueType::Double:
+                    finished = this->searchVectorized<8, true>(data, size, startLimit, baseAddress, callback, position);
+                    break;
+            }
+
+            if (!finished)
+                return false;
+        }
+    #endif
+
+        // The end of the buffer and CPUs without AVX2 compare one value at a time, starting from the first aligned offset
+        if (u64 misalignment = (baseAddress + position) % this->m_alignment; misalignment != 0)
+            position += this->m_alignment - misalignment;
+
+        for (; position < startLimit; position += this->m_alignment) {
+            if (this->matches(data + position) && !callback(baseAddress + position))
+                return false;
+        }
+
+        return true;
+    }
+
+    void ValueSearcher::searchParallel(prv::Provider* &provider, u64 offset, size_t size, const ChunkCallback &callback, const std::atomic<bool> &cancelled, u32 threadCount) const {
+        if (this->m_empty)
+            return;
+
+        size_t dataSize = provider->getActualSize();
+        if (offset >= dataSize)
+            return;
+
+        u64 end = std::min<u64>(offset + size, dataSize);
+        u64 chunkCount = (end - offset + ChunkSize - 1) / ChunkSize;
+
+        provider->adviseAccess(offset, end - offset, prv::Provider::AccessHint::Sequential);
+        SCOPE_EXIT( provider->adviseAccess(offset, end - offset, prv::Provider::AccessHint::Normal); );
+
+        threadCount = std::min<u64>(provider->getReadWorkerCount(threadCount), chunkCount);
+
+        // Chunks overlap by the size of a value so values on a chunk boundary are found by the chunk they start in
+        std::atomic<u64> nextChunk = 0;
+        auto worker = [&] {
+            std::vector<u8> buffer(ChunkSize + this->m_size - 1);
+            std::vector<u64> addresses;
+
+            for (u64 chunk = nextChunk++; chunk < chunkCount && !cancelled; chunk = nextChunk++) {
+                u64 chunkOffset = offset + chunk * ChunkSize;
+                size_t readSize = std::min<u64>(buffer.size(), end - chunkOffset);
+                provider->readAbsolute(chunkOffset, buffer.data(), readSize);
+
+                addresses.clear();
+                bool finished = this->searchBuffer(buffer.data(), readSize, ChunkSize, chunkOffset, [&](u64 address) {
+                    addresses.push_back(address);
+                    return !cancelled;
+                });
+
+                if (!finished)
+                    break;
+
+                callback(chunkOffset, std::min<u64>(ChunkSize, end - chunkOffset), std::move(addresses));
+                addresses = { };
+            }
+        };
+
+        TaskManager::runParallel(threadCount, [&](u32) { worker(); });
+    }
+
+}
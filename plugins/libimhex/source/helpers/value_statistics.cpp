@@ -0,0 +1,523 @@
+#include <hex/helpers/value_statistics.hpp>
+
+#include <hex/api/task.hpp>
+#include <hex/helpers/utils.hpp>
+#include <hex/providers/provider.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <tuple>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(__i386__)
+    #include <immintrin.h>
+#endif
+
+namespace hex {
+
+    namespace {
+
+        constexpr size_t VectorSize = 32;
+
+        constexpr std::endian ForeignEndian = std::endian::native == std::endian::little ? std::endian::big : std::endian::little;
+
+        template<typename T>
+        using UnsignedOf = std::tuple_element_t<std::countr_zero(sizeof(T)), std::tuple<u8, u16, u32, u64>>;
+
+        /* Sums of values up to 32 bits wide can't overflow within a chunk, 64 bit ones are summed with 128 bits */
+        template<typename T>
+        using SumOf = std::conditional_t<std::is_floating_point_v<T>, double,
+                      std::conditional_t<sizeof(T) == 8, std::conditional_t<std::is_signed_v<T>, s128, u128>,
+                      std::conditional_t<std::is_signed_v<T>, s64, u64>>>;
+
+        /* A chunk holds at most 2^17 doubles, scaled down like this their sum stays below the largest double */
+        constexpr double DoubleSumScale = 0x1p-20;
+
+        template<typename T>
+        using NumberOf = std::conditional_t<std::is_floating_point_v<T>, double, std::conditional_t<std::is_signed_v<T>, s64, u64>>;
+
+        template<typename Function>
+        void visitType(ValueType type, Function &&function) {
+            switch (type) {
+                case ValueType::U8:     function(u8());     break;
+                case ValueType::S8:     function(s8());     break;
+                case ValueType::U16:    function(u16());    break;
+                case ValueType::S16:    function(s16());    break;
+                case ValueType::U32:    function(u32());    break;
+                case ValueType::S32:    function(s32());    break;
+                case ValueType::U64:    function(u64());    break;
+                case ValueType::S64:    function(s64());    break;
+                case ValueType::Float:  function(float());  break;
+                case ValueType::Double: function(double()); break;
+            }
+        }
+
+        double toDouble(const ValueStatistics::Number &number) {
+            return std::visit([](auto value) { return double(value); }, number);
+        }
+
+        /* NaNs and infinities would make the mean and the histogram range useless */
+        template<typename T>
+        bool isFinite(T value) {
+            if constexpr (std::is_floating_point_v<T>)
+                return std::isfinite(value);
+            else
+                return true;
+        }
+
+        template<typename T>
+        T loadValue(const u8 *data, bool swap) {
+            UnsignedOf<T> value;
+            std::memcpy(&value, data, sizeof(value));
+
+            if (swap)
+                value = changeEndianess(value, ForeignEndian);
+
+            return std::bit_cast<T>(value);
+        }
+
+        /* Results of the first pass of one worker for one type */
+        struct Partial {
+            u64 count = 0;
+            u64 skipped = 0;
+            ValueStatistics::Number minimum, maximum;
+            double mean = 0;
+        };
+
+        /* Weights both means by their counts, without a difference or sum that could overflow */
+        void mergeMean(double &mean, u64 &count, double otherMean, u64 otherCount) {
+            double weight = double(otherCount) / double(count + otherCount);
+
+            mean = mean * (1 - weight) + otherMean * weight;
+            count += otherCount;
+        }
+
+        template<typename T>
+        struct Reduction {
+            T minimum = std::numeric_limits<T>::max();
+            T maximum = std::numeric_limits<T>::lowest();
+            SumOf<T> sum = 0;
+            u64 skipped = 0;
+        };
+
+        template<typename T>
+        void reduceValues(const u8 *data, size_t count, bool swap, Reduction<T> &reduction) {
+            for (size_t i = 0; i < count; i++) {
+                T value = loadValue<T>(data + i * sizeof(T), swap);
+
+                if (!isFinite(value)) {
+                    reduction.skipped++;
+                    continue;
+                }
+
+                reduction.minimum = std::min(reduction.minimum, value);
+                reduction.maximum = std::max(reduction.maximum, value);
+                if constexpr (std::is_same_v<T, double>)
+                    reduction.sum += value * DoubleSumScale;
+                else
+                    reduction.sum += SumOf<T>(value);
+            }
+        }
+
+    #if defined(__x86_64__) || defined(__i386__)
+
+        bool isAVX2Supported() {
+            static bool supported = __builtin_cpu_supports("avx2");
+            return supported;
+        }
+
+        /* Shuffle that reverses the bytes of every value of the given width within a 16 byte lane */
+        template<size_t Width>
+        constexpr std::array<u8, 16> makeSwapPattern() {
+            std::array<u8, 16> pattern = { };
+
+            for (size_t i = 0; i < 16; i++)
+                pattern[i] = (i / Width) * Width + (Width - 1 - i % Width);
+
+            return pattern;
+        }
+
+        template<typename T>
+        __attribute__((target("avx2")))
+        __m256i broadcast(T value) {
+            if constexpr (sizeof(T) == 1)
+                return _mm256_set1_epi8(char(value));
+            else if constexpr (sizeof(T) == 2)
+                return _mm256_set1_epi16(short(value));
+            else if constexpr (sizeof(T) == 4)
+                return _mm256_set1_epi32(int(value));
+            else
+                return _mm256_set1_epi64x(static_cast<long long>(value));
+        }
+
+        /* There's no unsigned 64 bit comparison, flipping the sign bits of both sides turns it into a signed one */
+        template<typename T>
+        __attribute__((target("avx2")))
+        __m256i greaterThan64(__m256i left, __m256i right) {
+            if constexpr (std::is_signed_v<T>)
+                return _mm256_cmpgt_epi64(left, right);
+            else {
+                const __m256i signBits = _mm256_set1_epi64x(std::numeric_limits<s64>::min());
+                return _mm256_cmpgt_epi64(_mm256_xor_si256(left, signBits), _mm256_xor_si256(right, signBits));
+            }
+        }
+
+        template<typename T>
+        __attribute__((target("avx2")))
+        __m256i minimumOf(__m256i left, __m256i right) {
+            if constexpr (std::is_same_v<T, u8>)        return _mm256_min_epu8(left, right);
+            else if constexpr (std::is_same_v<T, s8>)   return _mm256_min_epi8(left, right);
+            else if constexpr (std::is_same_v<T, u16>)  return _mm256_min_epu16(left, right);
+            else if constexpr (std::is_same_v<T, s16>)  return _mm256_min_epi16(left, right);
+            else if constexpr (std::is_same_v<T, u32>)  return _mm256_min_epu32(left, right);
+            else if constexpr (std::is_same_v<T, s32>)  return _mm256_min_epi32(left, right);
+            else                                        return _mm256_blendv_epi8(left, right, greaterThan64<T>(left, right));
+        }
+
+        template<typename T>
+        __attribute__((target("avx2")))
+        __m256i maximumOf(__m256i left, __m256i right) {
+            if constexpr (std::is_same_v<T, u8>)        return _mm256_max_epu8(left, right);
+            else if constexpr (std::is_same_v<T, s8>)   return _mm256_max_epi8(left, right);
+            else if constexpr (std::is_same_v<T, u16>)  return _mm256_max_epu16(left, right);
+            else if constexpr (std::is_same_v<T, s16>)  return _mm256_max_epi16(left, right);
+            else if constexpr (std::is_same_v<T, u32>)  return _mm256_max_epu32(left, right);
+            else if constexpr (std::is_same_v<T, s32>)  return _mm256_max_epi32(left, right);
+            else                                        return _mm256_blendv_epi8(right, left, greaterThan64<T>(left, right));
+        }
+
+        /* What sumOf adds to every value, it has to be taken off the sum again afterwards */
+        template<typename T>
+        constexpr s64 SumBias = std::is_same_v<T, s8> ? 0x80 : std::is_same_v<T, u16> ? -0x8000 : 0;
+
+        /* Sums of the values of a vector of values up to 32 bits wide, as four 64 bit integers */
+        template<typename T>
+        __attribute__((target("avx2")))
+        __m256i sumOf(__m256i value) {
+            if constexpr (sizeof(T) == 1) {
+                // Sums of absolute differences to zero add up the unsigned bytes of every 64 bit lane
+                if constexpr (std::is_signed_v<T>)
+                    value = _mm256_xor_si256(value, _mm256_set1_epi8(char(0x80)));
+
+                return _mm256_sad_epu8(value, _mm256_setzero_si256());
+            } else if constexpr (sizeof(T) == 2) {
+                // Multiplying by one and adding neighbours is a signed operation, unsigned values get moved into its range first
+                if constexpr (!std::is_signed_v<T>)
+                    value = _mm256_xor_si256(value, _mm256_set1_epi16(short(0x8000)));
+
+                value = _mm256_madd_epi16(value, _mm256_set1_epi16(1));
+                return _mm256_add_epi64(_mm256_cvtepi32_epi64(_mm256_castsi256_si128(value)), _mm256_cvtepi32_epi64(_mm256_extracti128_si256(value, 1)));
+            } else {
+                if constexpr (std::is_signed_v<T>)
+                    return _mm256_add_epi64(_mm256_cvtepi32_epi64(_mm256_castsi256_si128(value)), _mm256_cvtepi32_epi64(_mm256_extracti128_si256(value, 1)));
+                else
+                    return _mm256_add_epi64(_mm256_cvtepu32_epi64(_mm256_castsi256_si128(value)), _mm256_cvtepu32_epi64(_mm256_extracti128_si256(value, 1)));
+            }
+        }
+
+        /* Reduces whole vectors of values and returns how many values that were, reduceValues takes care of the rest */
+        template<typename T>
+        __attribute__((target("avx2")))
+        size_t reduceValuesVectorized(const u8 *data, size_t count, bool swap, Reduction<T> &reduction) {
+            constexpr size_t ValuesPerVector = VectorSize / sizeof(T);
+
+            static constexpr auto SwapPattern = makeSwapPattern<sizeof(T)>();
+            const __m256i swapPattern = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(SwapPattern.data())));
+
+            auto load = [&](size_t vector) __attribute__((target("avx2"))) {
+                auto value = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + vector * VectorSize));
+                return swap ? _mm256_shuffle_epi8(value, swapPattern) : value;
+            };
+
+            size_t vectorCount = count / ValuesPerVector;
+            if (vectorCount == 0)
+                return 0;
+
+            alignas(VectorSize) std::array<T, ValuesPerVector> minimums, maximums;
+
+            if constexpr (std::is_same_v<T, float>) {
+                const __m256 absoluteMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFF'FFFF));
+                const __m256 largest = _mm256_set1_ps(std::numeric_limits<float>::max());
+                const __m256 lowest = _mm256_set1_ps(std::numeric_limits<float>::lowest());
+
+                __m256 minimum = largest, maximum = lowest;
+                __m256d sum = _mm256_setzero_pd();
+                u64 finiteCount = 0;
+
+                for (size_t vector = 0; vector < vectorCount; vector++) {
+                    __m256 value = _mm256_castsi256_ps(load(vector));
+
+                    // NaNs fail the ordered comparison the same way infinities do, values that aren't finite get replaced by neutral ones
+                    __m256 finite = _mm256_cmp_ps(_mm256_and_ps(value, absoluteMask), largest, _CMP_LE_OQ);
+                    minimum = _mm256_min_ps(minimum, _mm256_blendv_ps(largest, value, finite));
+                    maximum = _mm256_max_ps(maximum, _mm256_blendv_ps(lowest, value, finite));
+
+                    __m256 kept = _mm256_and_ps(value, finite);
+                    sum = _mm256_add_pd(sum, _mm256_add_pd(_mm256_cvtps_pd(_mm256_castps256_ps128(kept)), _mm256_cvtps_pd(_mm256_extractf128_ps(kept, 1))));
+                    finiteCount += std::popcount(u32(_mm256_movemask_ps(finite)));
+                }
+
+                alignas(VectorSize) std::array<double, 4> sums;
+                _mm256_store_pd(sums.data(), sum);
+                _mm256_store_ps(minimums.data(), minimum);
+                _mm256_store_ps(maximums.data(), maximum);
+
+                reduction.sum += std::accumulate(sums.begin(), sums.end(), 0.0);
+                reduction.skipped += vectorCount * ValuesPerVector - finiteCount;
+            } else if constexpr (std::is_same_v<T, double>) {
+                const __m256d absoluteMask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7FFF'FFFF'FFFF'FFFF));
+                const __m256d largest = _mm256_set1_pd(std::numeric_limits<double>::max());
+                const __m256d lowest = _mm256_set1_pd(std::numeric_limits<double>::lowest());
+                const __m256d scale = _mm256_set1_pd(DoubleSumScale);
+
+                __m256d minimum = largest, maximum = lowest;
+                __m256d sum = _mm256_setzero_pd();
+                u64 finiteCount = 0;
+
+                for (size_t vector = 0; vector < vectorCount; vector++) {
+                    __m256d value = _mm256_castsi256_pd(load(vector));
+
+                    __m256d finite = _mm256_cmp_pd(_mm256_and_pd(value, absoluteMask), largest, _CMP_LE_OQ);
+                    minimum = _mm256_min_pd(minimum, _mm256_blendv_pd(largest, value, finite));
+                    maximum = _mm256_max_pd(maximum, _mm256_blendv_pd(lowest, value, finite));
+
+                    sum = _mm256_add_pd(sum, _mm256_mul_pd(_mm256_and_pd(value, finite), scale));
+                    finiteCount += std::popcount(u32(_mm256_movemask_pd(finite)));
+                }
+
+                alignas(VectorSize) std::array<double, 4> sums;
+                _mm256_store_pd(sums.data(), sum);
+                _mm256_store_pd(minimums.data(), minimum);
+                _mm256_store_pd(maximums.data(), maximum);
+
+                reduction.sum += std::accumulate(sums.begin(), sums.end(), 0.0);
+                reduction.skipped += vectorCount * ValuesPerVector - finiteCount;
+            } else {
+                __m256i minimum = broadcast<T>(std::numeric_limits<T>::max());
+                __m256i maximum = broadcast<T>(std::numeric_limits<T>::lowest());
+                __m256i sum = _mm256_setzero_si256();
+                __m256i carries = _mm256_setzero_si256();
+
+                for (size_t vector = 0; vector < vectorCount; vector++) {
+                    __m256i value = load(vector);
+
+                    minimum = minimumOf<T>(minimum, value);
+                    maximum = maximumOf<T>(maximum, value);
+
+                    if constexpr (sizeof(T) < 8) {
+                        sum = _mm256_add_epi64(sum, sumOf<T>(value));
+                    } else {
+                        // 64 bit values are summed with 128 bits, the upper halves count the carries and the sign extension of negative values
+                        __m256i newSum = _mm256_add_epi64(sum, value);
+                        carries = _mm256_sub_epi64(carries, greaterThan64<u64>(value, newSum));
+
+                        if constexpr (std::is_signed_v<T>)
+                            carries = _mm256_add_epi64(carries, _mm256_cmpgt_epi64(_mm256_setzero_si256(), value));
+
+                        sum = newSum;
+                    }
+                }
+
+                alignas(VectorSize) std::array<u64, 4> sums, upperSums;
+                _mm256_store_si256(reinterpret_cast<__m256i*>(sums.data()), sum);
+                _mm256_store_si256(reinterpret_cast<__m256i*>(upperSums.data()), carries);
+                _mm256_store_si256(reinterpret_cast<__m256i*>(minimums.data()), minimum);
+                _mm256_store_si256(reinterpret_cast<__m256i*>(maximums.data()), maximum);
+
+                if constexpr (sizeof(T) < 8) {
+                    s64 total = -SumBias<T> * s64(vectorCount * ValuesPerVector);
+                    for (auto laneSum : sums)
+                        total += s64(laneSum);
+
+                    reduction.sum += SumOf<T>(total);
+                } else {
+                    for (size_t lane = 0; lane < sums.size(); lane++)
+                        reduction.sum += SumOf<T>(u128(upperSums[lane]) << 64 | sums[lane]);
+                }
+            }
+
+            reduction.minimum = std::min(reduction.minimum, *std::min_element(minimums.begin(), minimums.end()));
+            reduction.maximum = std::max(reduction.maximum, *std::max_element(maximums.begin(), maximums.end()));
+
+            return vectorCount * ValuesPerVector;
+        }
+
+    #endif
+
+        template<typename T>
+        void reduceChunk(const u8 *data, size_t size, std::endian endian, Partial &partial) {
+            Reduction<T> reduction;
+
+            bool swap = sizeof(T) > 1 && endian != std::endian::native;
+            size_t count = size / sizeof(T);
+            size_t position = 0;
+
+        #if defined(__x86_64__) || defined(__i386__)
+            if (isAVX2Supported())
+                position = reduceValuesVectorized<T>(data, count, swap, reduction);
+        #endif
+
+            reduceValues<T>(data + position * sizeof(T), count - position, swap, reduction);
+
+            partial.skipped += reduction.skipped;
+
+            u64 valueCount = count - reduction.skipped;
+            if (valueCount == 0)
+                return;
+
+            if (partial.count == 0) {
+                partial.minimum = NumberOf<T>(reduction.minimum);
+                partial.maximum = NumberOf<T>(reduction.maximum);
+            } else {
+                partial.minimum = std::min(std::get<NumberOf<T>>(partial.minimum), NumberOf<T>(reduction.minimum));
+                partial.maximum = std::max(std::get<NumberOf<T>>(partial.maximum), NumberOf<T>(reduction.maximum));
+            }
+
+            double mean = double(reduction.sum) / double(valueCount);
+            if constexpr (std::is_same_v<T, double>)
+                mean /= DoubleSumScale;
+
+            mergeMean(partial.mean, partial.count, mean, valueCount);
+        }
+
+        /* Incrementing scattered bins doesn't vectorize without AVX-512, so the histogram is filled one value at a time */
+        template<typename T>
+        void binChunk(const u8 *data, size_t size, std::endian endian, double minimum, double scale, u64 *bins) {
+            bool swap = sizeof(T) > 1 && endian != std::endian::native;
+            size_t count = size / sizeof(T);
+
+            auto binOf = [&](T value) {
+                return std::min<size_t>((double(value) / 2 - minimum) * scale, ValueStatistics::BinCount - 1);
+            };
+
+            if constexpr (sizeof(T) <= 2) {
+                // Narrow values get counted first, so the bin only has to be worked out once for every possible value
+                std::vector<u32> occurrences(1 << (sizeof(T) * 8), 0);
+                for (size_t i = 0; i < count; i++)
+                    occurrences[std::bit_cast<UnsignedOf<T>>(loadValue<T>(data + i * sizeof(T), swap))]++;
+
+                for (size_t value = 0; value < occurrences.size(); value++) {
+                    if (occurrences[value] != 0)
+                        bins[binOf(std::bit_cast<T>(UnsignedOf<T>(value)))] += occurrences[value];
+                }
+            } else {
+                for (size_t i = 0; i < count; i++) {
+                    T value = loadValue<T>(data + i * sizeof(T), swap);
+                    if (isFinite(value))
+                        bins[binOf(value)]++;
+                }
+            }
+        }
+
+    }
+
+    std::vector<ValueStatistics> ValueStatisticsCalculator::calculate(prv::Provider *provider, u64 address, size_t size, std::span<const ValueType> types, std::endian endian,
+                                                                      const std::atomic<bool> &cancelled, std::atomic<u64> *processedBytes) {
+        size_t dataSize = provider->getActualSize();
+        if (address >= dataSize || types.empty())
+            return { };
+
+        u64 end = std::min<u64>(address + size, dataSize);
+        u64 chunkCount = (end - address + ChunkSize - 1) / ChunkSize;
+        u32 workerCount = std::min<u64>(provider->getReadWorkerCount(), chunkCount);
+
+        provider->adviseAccess(address, end - address, prv::Provider::AccessHint::Sequential);
+        SCOPE_EXIT( provider->adviseAccess(address, end - address, prv::Provider::AccessHint::Normal); );
+
+        // Chunks start at a multiple of the chunk size from the start of the region, so no value is ever split between two of them
+        auto forEachChunk = [&](auto &&function) {
+            std::atomic<u64> nextChunk = 0;
+
+            TaskManager::runParallel(workerCount, [&](u32 worker) {
+                std::vector<u8> buffer(ChunkSize);
+
+                for (u64 chunk = nextChunk++; chunk < chunkCount && !cancelled; chunk = nextChunk++) {
+                    u64 chunkAddress = address + chunk * ChunkSize;
+                    size_t chunkSize = std::min<u64>(ChunkSize, end - chunkAddress);
+
+                    provider->readAbsolute(chunkAddress, buffer.data(), chunkSize);
+                    function(worker, buffer.data(), chunkSize);
+
+                    if (processedBytes != nullptr)
+                        *processedBytes += chunkSize;
+                }
+            });
+        };
+
+        // The first pass finds the range of every type, which the histograms need
+        std::vector<std::vector<Partial>> partials(workerCount, std::vector<Partial>(types.size()));
+        forEachChunk([&](u32 worker, const u8 *data, size_t chunkSize) {
+            for (size_t i = 0; i < types.size(); i++) {
+                visitType(types[i], [&](auto type) {
+                    reduceChunk<decltype(type)>(data, chunkSize, endian, partials[worker][i]);
+                });
+            }
+        });
+
+        if (cancelled)
+            return { };
+
+        std::vector<ValueStatistics> statistics(types.size());
+        for (size_t i = 0; i < types.size(); i++) {
+            auto &result = statistics[i];
+            result.type = types[i];
+
+            for (const auto &workerPartials : partials) {
+                const auto &partial = workerPartials[i];
+
+                result.skipped += partial.skipped;
+                if (partial.count == 0)
+                    continue;
+
+                if (result.count == 0) {
+                    result.minimum = partial.minimum;
+                    result.maximum = partial.maximum;
+                } else {
+                    result.minimum = std::min(result.minimum, partial.minimum);
+                    result.maximum = std::max(result.maximum, partial.maximum);
+                }
+
+                mergeMean(result.mean, result.count, partial.mean, partial.count);
+            }
+        }
+
+        // The second pass sorts the values into bins between the minimum and maximum of their type. Everything is halved, otherwise the
+        // range of doubles could be larger than the largest double
+        std::vector<double> minimums(types.size()), scales(types.size());
+        for (size_t i = 0; i < types.size(); i++) {
+            double range = toDouble(statistics[i].maximum) / 2 - toDouble(statistics[i].minimum) / 2;
+
+            minimums[i] = toDouble(statistics[i].minimum) / 2;
+            scales[i] = range > 0 ? double(ValueStatistics::BinCount) / range : 0;
+        }
+
+        using Histogram = std::array<u64, ValueStatistics::BinCount>;
+        std::vector<std::vector<Histogram>> histograms(workerCount, std::vector<Histogram>(types.size()));
+        forEachChunk([&](u32 worker, const u8 *data, size_t chunkSize) {
+            for (size_t i = 0; i < types.size(); i++) {
+                if (statistics[i].count == 0)
+                    continue;
+
+                visitType(types[i], [&](auto type) {
+                    binChunk<decltype(type)>(data, chunkSize, endian, minimums[i], scales[i], histograms[worker][i].data());
+                });
+            }
+        });
+
+        if (cancelled)
+            return { };
+
+        for (const auto &workerHistograms : histograms) {
+            for (size_t i = 0; i < types.size(); i++) {
+                for (size_t bin = 0; bin < ValueStatistics::BinCount; bin++)
+                    statistics[i].histogram[bin] += workerHistograms[i][bin];
+            }
+        }
+
+        return statistics;
+    }
+
+}
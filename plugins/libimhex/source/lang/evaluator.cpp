@@ -2,64 +2,90 @@
 
 #include <hex/lang/token.hpp>
 #include <hex/helpers/utils.hpp>
+#include <hex/helpers/shared_data.hpp>
 #include <hex/api/content_registry.hpp>
+#include <hex/helpers/search.hpp>
 
 #include <bit>
+#include <functional>
 #include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <thread>
 
 #include <unistd.h>
 
 namespace hex::lang {
 
-    ASTNodeIntegerLiteral* Evaluator::evaluateScopeResolution(ASTNodeScopeResolution *node) {
-        ASTNode *currScope = nullptr;
-        for (const auto &identifier : node->getPath()) {
-            if (currScope == nullptr) {
-                if (!this->m_types.contains(identifier))
-                    break;
+    PatternData* Evaluator::patternFromName(const std::vector<std::string> &path) {
+        return this->patternFromName(path, nullptr);
+    }
 
-                currScope = this->m_types[identifier.data()];
-            } else if (auto enumNode = dynamic_cast<ASTNodeEnum*>(currScope); enumNode != nullptr) {
-                if (!enumNode->getEntries().contains(identifier))
-                    break;
-                else
-                    return evaluateMathematicalExpression(static_cast<ASTNodeNumericExpression*>(enumNode->getEntries().at(identifier)));
-            }
-        }
+    PatternData* Evaluator::patternFromName(const std::vector<std::string> &path, std::vector<u32> *slots) {
+        if (slots != nullptr)
+            slots->resize(path.size());
 
-        this->getConsole().abortEvaluation("failed to find identifier");
-    }
+        // Names almost always resolve to the same member index as last time, check that one before searching all members
+        auto findMember = [](const std::vector<PatternData*> *members, const std::string &identifier, u32 &slot, size_t count) -> PatternData* {
+            if (members == nullptr)
+                return nullptr;
 
-    PatternData* Evaluator::patternFromName(const std::vector<std::string> &path) {
-        std::vector<PatternData*> currMembers;
+            count = std::min(count, members->size());
 
-        if (!this->m_currMembers.empty())
-            std::copy(this->m_currMembers.back()->begin(), this->m_currMembers.back()->end(), std::back_inserter(currMembers));
-        if (!this->m_globalMembers.empty())
-            std::copy(this->m_globalMembers.begin(), this->m_globalMembers.end(), std::back_inserter(currMembers));
+            if (slot < count && (*members)[slot]->getVariableName() == identifier)
+                return (*members)[slot];
+
+            for (u32 i = 0; i < count; i++) {
+                if ((*members)[i]->getVariableName() == identifier) {
+                    slot = i;
+                    return (*members)[i];
+                }
+            }
+
+            return nullptr;
+        };
 
         PatternData *currPattern = nullptr;
         for (u32 i = 0; i < path.size(); i++) {
             const auto &identifier = path[i];
 
-            if (auto structPattern = dynamic_cast<PatternDataStruct*>(currPattern); structPattern != nullptr)
-                currMembers = structPattern->getMembers();
+            PatternData *candidate = nullptr;
+            u32 unresolvedSlot = 0;
+            u32 &slot = slots != nullptr ? (*slots)[i] : unresolvedSlot;
+            if (currPattern == nullptr) {
+                // Members of the current scope shadow global variables
+                if (!this->m_currMembers.empty())
+                    candidate = findMember(this->m_currMembers.back(), identifier, slot, this->m_currMembers.back()->size());
+                if (candidate == nullptr) {
+                    // Only globals declared before the current statement are visible, even when re-evaluating it later on
+                    size_t globalCount = this->m_globalMembers.size();
+                    if (this->m_currStatement.has_value())
+                        globalCount = this->m_statements[*this->m_currStatement].globalIndex.value_or(globalCount);
+
+                    candidate = findMember(&this->m_globalMembers, identifier, slot, globalCount);
+
+                    if (candidate != nullptr && this->m_currStatement.has_value())
+                        this->m_statements[*this->m_currStatement].globalReferences.push_back(slot);
+                }
+            }
+            else if (auto structPattern = dynamic_cast<PatternDataStruct*>(currPattern); structPattern != nullptr)
+                candidate = findMember(&structPattern->getMembers(), identifier, slot, structPattern->getMembers().size());
             else if (auto unionPattern = dynamic_cast<PatternDataUnion*>(currPattern); unionPattern != nullptr)
-                currMembers = unionPattern->getMembers();
+                candidate = findMember(&unionPattern->getMembers(), identifier, slot, unionPattern->getMembers().size());
             else if (auto pointerPattern = dynamic_cast<PatternDataPointer*>(currPattern); pointerPattern != nullptr) {
                 currPattern = pointerPattern->getPointedAtPattern();
+                if (currPattern == nullptr)
+                    this->getConsole().abortEvaluation(hex::format("pointer leading to '{0}' is part of a cycle", identifier.c_str()));
+
                 i--;
                 continue;
             }
-            else if (currPattern != nullptr)
+            else
                 this->getConsole().abortEvaluation("tried to access member of a non-struct/union type");
 
-            auto candidate = std::find_if(currMembers.begin(), currMembers.end(), [&](auto member) {
-                return member->getVariableName() == identifier;
-            });
-
-            if (candidate != currMembers.end())
-                currPattern = *candidate;
+            if (candidate != nullptr)
+                currPattern = candidate;
             else
                 this->getConsole().abortEvaluation(hex::format("could not find identifier '{0}'", identifier.c_str()));
         }
@@ -70,52 +96,44 @@ namespace hex::lang {
         return currPattern;
     }
 
-    ASTNodeIntegerLiteral* Evaluator::evaluateRValue(ASTNodeRValue *node) {
+    Token::IntegerLiteral Evaluator::evaluateRValue(ASTNodeRValue *node) {
         if (this->m_currMembers.empty() && this->m_globalMembers.empty())
             this->getConsole().abortEvaluation("no variables available");
 
-        if (node->getPath().size() == 1 && node->getPath()[0] == "$")
-            return new ASTNodeIntegerLiteral({ Token::ValueType::Unsigned64Bit, this->m_currOffset });
-
-        auto currPattern = this->patternFromName(node->getPath());
+        auto currPattern = this->patternFromName(node->getPath(), &this->m_nameSlots[node]);
 
-        if (auto unsignedPattern = dynamic_cast<PatternDataUnsigned*>(currPattern); unsignedPattern != nullptr) {
-            u8 value[unsignedPattern->getSize()];
-            this->m_provider->read(unsignedPattern->getOffset(), value, unsignedPattern->getSize());
+        auto readValue = [this](PatternData *pattern, bool isSigned) -> Token::IntegerLiteral {
+            u8 value[pattern->getSize()];
+            this->readData(pattern->getOffset(), value, pattern->getSize());
 
-            switch (unsignedPattern->getSize()) {
-                case 1:  return new ASTNodeIntegerLiteral({ Token::ValueType::Unsigned8Bit,   hex::changeEndianess(*reinterpret_cast<u8*>(value),   1,  unsignedPattern->getEndian()) });
-                case 2:  return new ASTNodeIntegerLiteral({ Token::ValueType::Unsigned16Bit,  hex::changeEndianess(*reinterpret_cast<u16*>(value),  2,  unsignedPattern->getEndian()) });
-                case 4:  return new ASTNodeIntegerLiteral({ Token::ValueType::Unsigned32Bit,  hex::changeEndianess(*reinterpret_cast<u32*>(value),  4,  unsignedPattern->getEndian()) });
-                case 8:  return new ASTNodeIntegerLiteral({ Token::ValueType::Unsigned64Bit,  hex::changeEndianess(*reinterpret_cast<u64*>(value),  8,  unsignedPattern->getEndian()) });
-                case 16: return new ASTNodeIntegerLiteral({ Token::ValueType::Unsigned128Bit, hex::changeEndianess(*reinterpret_cast<u128*>(value), 16, unsignedPattern->getEndian()) });
-                default: this->getConsole().abortEvaluation("invalid rvalue size");
-            }
-        } else if (auto signedPattern = dynamic_cast<PatternDataSigned*>(currPattern); signedPattern != nullptr) {
-            u8 value[signedPattern->getSize()];
-            this->m_provider->read(signedPattern->getOffset(), value, signedPattern->getSize());
-
-            switch (signedPattern->getSize()) {
-                case 1:  return new ASTNodeIntegerLiteral({ Token::ValueType::Signed8Bit,   hex::changeEndianess(*reinterpret_cast<s8*>(value),   1,  signedPattern->getEndian()) });
-                case 2:  return new ASTNodeIntegerLiteral({ Token::ValueType::Signed16Bit,  hex::changeEndianess(*reinterpret_cast<s16*>(value),  2,  signedPattern->getEndian()) });
-                case 4:  return new ASTNodeIntegerLiteral({ Token::ValueType::Signed32Bit,  hex::changeEndianess(*reinterpret_cast<s32*>(value),  4,  signedPattern->getEndian()) });
-                case 8:  return new ASTNodeIntegerLiteral({ Token::ValueType::Signed64Bit,  hex::changeEndianess(*reinterpret_cast<s64*>(value),  8,  signedPattern->getEndian()) });
-                case 16: return new ASTNodeIntegerLiteral({ Token::ValueType::Signed128Bit, hex::changeEndianess(*reinterpret_cast<s128*>(value), 16, signedPattern->getEndian()) });
-                default: this->getConsole().abortEvaluation("invalid rvalue size");
-            }
-        } else if (auto enumPattern = dynamic_cast<PatternDataEnum*>(currPattern); enumPattern != nullptr) {
-            u8 value[enumPattern->getSize()];
-            this->m_provider->read(enumPattern->getOffset(), value, enumPattern->getSize());
-
-            switch (enumPattern->getSize()) {
-                case 1:  return new ASTNodeIntegerLiteral({ Token::ValueType::Unsigned8Bit,   hex::changeEndianess(*reinterpret_cast<u8*>(value),   1,  enumPattern->getEndian()) });
-                case 2:  return new ASTNodeIntegerLiteral({ Token::ValueType::Unsigned16Bit,  hex::changeEndianess(*reinterpret_cast<u16*>(value),  2,  enumPattern->getEndian()) });
-                case 4:  return new ASTNodeIntegerLiteral({ Token::ValueType::Unsigned32Bit,  hex::changeEndianess(*reinterpret_cast<u32*>(value),  4,  enumPattern->getEndian()) });
-                case 8:  return new ASTNodeIntegerLiteral({ Token::ValueType::Unsigned64Bit,  hex::changeEndianess(*reinterpret_cast<u64*>(value),  8,  enumPattern->getEndian()) });
-                case 16: return new ASTNodeIntegerLiteral({ Token::ValueType::Unsigned128Bit, hex::changeEndianess(*reinterpret_cast<u128*>(value), 16, enumPattern->getEndian()) });
-                default: this->getConsole().abortEvaluation("invalid rvalue size");
+            if (isSigned) {
+                switch (pattern->getSize()) {
+                    case 1:  return { Token::ValueType::Signed8Bit,   hex::changeEndianess(*reinterpret_cast<s8*>(value),   1,  pattern->getEndian()) };
+                    case 2:  return { Token::ValueType::Signed16Bit,  hex::changeEndianess(*reinterpret_cast<s16*>(value),  2,  pattern->getEndian()) };
+                    case 4:  return { Token::ValueType::Signed32Bit,  hex::changeEndianess(*reinterpret_cast<s32*>(value),  4,  pattern->getEndian()) };
+                    case 8:  return { Token::ValueType::Signed64Bit,  hex::changeEndianess(*reinterpret_cast<s64*>(value),  8,  pattern->getEndian()) };
+                    case 16: return { Token::ValueType::Signed128Bit, hex::changeEndianess(*reinterpret_cast<s128*>(value), 16, pattern->getEndian()) };
+                    default: this->getConsole().abortEvaluation("invalid rvalue size");
+                }
+            } else {
+                switch (pattern->getSize()) {
+                    case 1:  return { Token::ValueType::Unsigned8Bit,   hex::changeEndianess(*reinterpret_cast<u8*>(value),   1,  pattern->getEndian()) };
+                    case 2:  return { Token::ValueType::Unsigned16Bit,  hex::changeEndianess(*reinterpret_cast<u16*>(value),  2,  pattern->getEndian()) };
+                    case 4:  return { Token::ValueType::Unsigned32Bit,  hex::changeEndianess(*reinterpret_cast<u32*>(value),  4,  pattern->getEndian()) };
+                    case 8:  return { Token::ValueType::Unsigned64Bit,  hex::changeEndianess(*reinterpret_cast<u64*>(value),  8,  pattern->getEndian()) };
+                    case 16: return { Token::ValueType::Unsigned128Bit, hex::changeEndianess(*reinterpret_cast<u128*>(value), 16, pattern->getEndian()) };
+                    default: this->getConsole().abortEvaluation("invalid rvalue size");
+                }
             }
-        } else
+        };
+
+        if (auto unsignedPattern = dynamic_cast<PatternDataUnsigned*>(currPattern); unsignedPattern != nullptr)
+            return readValue(unsignedPattern, false);
+        else if (auto signedPattern = dynamic_cast<PatternDataSigned*>(currPattern); signedPattern != nullptr)
+            return readValue(signedPattern, true);
+        else if (auto enumPattern = dynamic_cast<PatternDataEnum*>(currPattern); enumPattern != nullptr)
+            return readValue(enumPattern, false);
+        else
             this->getConsole().abortEvaluation("tried to use non-integer value in numeric expression");
     }
 
@@ -128,7 +146,7 @@ namespace hex::lang {
 
         for (auto &param : node->getParams()) {
             if (auto numericExpression = dynamic_cast<ASTNodeNumericExpression*>(param); numericExpression != nullptr)
-                evaluatedParams.push_back(this->evaluateMathematicalExpression(numericExpression));
+                evaluatedParams.push_back(new ASTNodeIntegerLiteral(this->evaluateExpression(numericExpression)));
             else if (auto stringLiteral = dynamic_cast<ASTNodeStringLiteral*>(param); stringLiteral != nullptr)
                 evaluatedParams.push_back(stringLiteral->clone());
         }
@@ -151,6 +169,9 @@ namespace hex::lang {
             this->getConsole().abortEvaluation(hex::format("invalid number of parameters for function '{0}'. Expected {1}", node->getFunctionName().data(), function.parameterCount));
         }
 
+        auto profile = this->beginProfiling();
+        SCOPE_EXIT( this->endProfiling("function", node->getFunctionName(), profile); );
+
         return function.func(*this, evaluatedParams);
     }
 
@@ -190,143 +211,333 @@ namespace hex::lang {
             return left % right;
         }
 
+        /* Type both operands of a binary operation on integers of up to 64 bits get converted to, following C++'s usual arithmetic conversions */
+        enum class CommonType : u8 { Signed32Bit, Unsigned32Bit, Signed64Bit, Unsigned64Bit, None };
+
+        constexpr CommonType getCommonType(size_t leftIndex, size_t rightIndex) {
+            // Variant alternatives in order: u8, s8, u16, s16, u32, s32, u64, s64. Everything smaller than 32 bits gets promoted to s32
+            constexpr CommonType Promoted[] = {
+                CommonType::Signed32Bit, CommonType::Signed32Bit, CommonType::Signed32Bit, CommonType::Signed32Bit,
+                CommonType::Unsigned32Bit, CommonType::Signed32Bit, CommonType::Unsigned64Bit, CommonType::Signed64Bit
+            };
+
+            if (leftIndex >= std::size(Promoted) || rightIndex >= std::size(Promoted))
+                return CommonType::None;
+
+            auto left = Promoted[leftIndex], right = Promoted[rightIndex];
+            auto is64Bit  = [](CommonType type) { return type == CommonType::Signed64Bit || type == CommonType::Unsigned64Bit; };
+            auto isSigned = [](CommonType type) { return type == CommonType::Signed32Bit || type == CommonType::Signed64Bit; };
+
+            if (left == right)
+                return left;
+            else if (is64Bit(left) != is64Bit(right))
+                // The wider type wins, s64 can hold every u32
+                return is64Bit(left) ? left : right;
+            else
+                // Same width, different signedness
+                return is64Bit(left) ? CommonType::Unsigned64Bit : CommonType::Unsigned32Bit;
+        }
+
+        template<typename T>
+        T toInteger(const Token::IntegerLiteral &literal) {
+            return std::visit([](auto &&value) { return static_cast<T>(value); }, literal.second);
+        }
+
     }
 
-    ASTNodeIntegerLiteral* Evaluator::evaluateOperator(ASTNodeIntegerLiteral *left, ASTNodeIntegerLiteral *right, Token::Operator op) {
-        auto newType = [&] {
-            #define CHECK_TYPE(type) if (left->getType() == (type) || right->getType() == (type)) return (type)
-            #define DEFAULT_TYPE(type) return (type)
+    Token::ValueType Evaluator::getResultType(Token::ValueType left, Token::ValueType right) {
+        #define CHECK_TYPE(type) if (left == (type) || right == (type)) return (type)
+        #define DEFAULT_TYPE(type) return (type)
+
+        if (left == Token::ValueType::Any && right != Token::ValueType::Any)
+            return right;
+        if (left != Token::ValueType::Any && right == Token::ValueType::Any)
+            return left;
+
+        CHECK_TYPE(Token::ValueType::Double);
+        CHECK_TYPE(Token::ValueType::Float);
+        CHECK_TYPE(Token::ValueType::Unsigned128Bit);
+        CHECK_TYPE(Token::ValueType::Signed128Bit);
+        CHECK_TYPE(Token::ValueType::Unsigned64Bit);
+        CHECK_TYPE(Token::ValueType::Signed64Bit);
+        CHECK_TYPE(Token::ValueType::Unsigned32Bit);
+        CHECK_TYPE(Token::ValueType::Signed32Bit);
+        CHECK_TYPE(Token::ValueType::Unsigned16Bit);
+        CHECK_TYPE(Token::ValueType::Signed16Bit);
+        CHECK_TYPE(Token::ValueType::Unsigned8Bit);
+        CHECK_TYPE(Token::ValueType::Signed8Bit);
+        CHECK_TYPE(Token::ValueType::Character);
+        CHECK_TYPE(Token::ValueType::Boolean);
+        DEFAULT_TYPE(Token::ValueType::Signed32Bit);
+
+        #undef CHECK_TYPE
+        #undef DEFAULT_TYPE
+    }
 
-            if (left->getType() == Token::ValueType::Any && right->getType() != Token::ValueType::Any)
-                return right->getType();
-            if (left->getType() != Token::ValueType::Any && right->getType() == Token::ValueType::Any)
-                return left->getType();
+    template<typename T>
+    std::optional<Token::IntegerLiteral> Evaluator::evaluateIntegerOperator(Token::ValueType type, T left, T right, Token::Operator op) {
+        switch (op) {
+            case Token::Operator::Plus:                     return Token::IntegerLiteral(type, T(left + right));
+            case Token::Operator::Minus:                    return Token::IntegerLiteral(type, T(left - right));
+            case Token::Operator::Star:                     return Token::IntegerLiteral(type, T(left * right));
+            case Token::Operator::Slash:
+                if (right == 0)
+                    this->getConsole().abortEvaluation("Division by zero");
+                return Token::IntegerLiteral(type, T(left / right));
+            case Token::Operator::Percent:
+                if (right == 0)
+                    this->getConsole().abortEvaluation("Division by zero");
+                return Token::IntegerLiteral(type, T(left % right));
+            case Token::Operator::BitAnd:                   return Token::IntegerLiteral(type, T(left & right));
+            case Token::Operator::BitXor:                   return Token::IntegerLiteral(type, T(left ^ right));
+            case Token::Operator::BitOr:                    return Token::IntegerLiteral(type, T(left | right));
+            case Token::Operator::BoolEquals:               return Token::IntegerLiteral(type, left == right);
+            case Token::Operator::BoolNotEquals:            return Token::IntegerLiteral(type, left != right);
+            case Token::Operator::BoolGreaterThan:          return Token::IntegerLiteral(type, left > right);
+            case Token::Operator::BoolLessThan:             return Token::IntegerLiteral(type, left < right);
+            case Token::Operator::BoolGreaterThanOrEquals:  return Token::IntegerLiteral(type, left >= right);
+            case Token::Operator::BoolLessThanOrEquals:     return Token::IntegerLiteral(type, left <= right);
+            case Token::Operator::BoolAnd:                  return Token::IntegerLiteral(type, left && right);
+            case Token::Operator::BoolXor:                  return Token::IntegerLiteral(type, left && !right || !left && right);
+            case Token::Operator::BoolOr:                   return Token::IntegerLiteral(type, left || right);
+            default:                                        return std::nullopt;
+        }
+    }
 
-            CHECK_TYPE(Token::ValueType::Double);
-            CHECK_TYPE(Token::ValueType::Float);
-            CHECK_TYPE(Token::ValueType::Unsigned128Bit);
-            CHECK_TYPE(Token::ValueType::Signed128Bit);
-            CHECK_TYPE(Token::ValueType::Unsigned64Bit);
-            CHECK_TYPE(Token::ValueType::Signed64Bit);
-            CHECK_TYPE(Token::ValueType::Unsigned32Bit);
-            CHECK_TYPE(Token::ValueType::Signed32Bit);
-            CHECK_TYPE(Token::ValueType::Unsigned16Bit);
-            CHECK_TYPE(Token::ValueType::Signed16Bit);
-            CHECK_TYPE(Token::ValueType::Unsigned8Bit);
-            CHECK_TYPE(Token::ValueType::Signed8Bit);
-            CHECK_TYPE(Token::ValueType::Character);
-            CHECK_TYPE(Token::ValueType::Boolean);
-            DEFAULT_TYPE(Token::ValueType::Signed32Bit);
+    Token::IntegerLiteral Evaluator::evaluateOperator(const Token::IntegerLiteral &left, const Token::IntegerLiteral &right, Token::Operator op) {
+        auto newType = getResultType(left.first, right.first);
+
+        // Almost all values fit into 64 bits. Operations on those get done directly in their common type instead of visiting every combination of types
+        std::optional<Token::IntegerLiteral> result;
+        switch (getCommonType(left.second.index(), right.second.index())) {
+            case CommonType::Signed32Bit:   result = this->evaluateIntegerOperator(newType, toInteger<s32>(left), toInteger<s32>(right), op); break;
+            case CommonType::Unsigned32Bit: result = this->evaluateIntegerOperator(newType, toInteger<u32>(left), toInteger<u32>(right), op); break;
+            case CommonType::Signed64Bit:   result = this->evaluateIntegerOperator(newType, toInteger<s64>(left), toInteger<s64>(right), op); break;
+            case CommonType::Unsigned64Bit: result = this->evaluateIntegerOperator(newType, toInteger<u64>(left), toInteger<u64>(right), op); break;
+            case CommonType::None:          break;
+        }
 
-            #undef CHECK_TYPE
-            #undef DEFAULT_TYPE
-        }();
+        if (result.has_value())
+            return *result;
 
         try {
-            return std::visit([&](auto &&leftValue, auto &&rightValue) -> ASTNodeIntegerLiteral * {
+            return std::visit([&](auto &&leftValue, auto &&rightValue) -> Token::IntegerLiteral {
                 switch (op) {
                     case Token::Operator::Plus:
-                        return new ASTNodeIntegerLiteral({ newType, leftValue + rightValue });
+                        return Token::IntegerLiteral(newType, leftValue + rightValue);
                     case Token::Operator::Minus:
-                        return new ASTNodeIntegerLiteral({ newType, leftValue - rightValue });
+                        return Token::IntegerLiteral(newType, leftValue - rightValue);
                     case Token::Operator::Star:
-                        return new ASTNodeIntegerLiteral({ newType, leftValue * rightValue });
+                        return Token::IntegerLiteral(newType, leftValue * rightValue);
                     case Token::Operator::Slash:
                         if (rightValue == 0)
                             this->getConsole().abortEvaluation("Division by zero");
-                        return new ASTNodeIntegerLiteral({ newType, leftValue / rightValue });
+                        return Token::IntegerLiteral(newType, leftValue / rightValue);
                     case Token::Operator::Percent:
                         if (rightValue == 0)
                             this->getConsole().abortEvaluation("Division by zero");
-                        return new ASTNodeIntegerLiteral({ newType, modulus(leftValue, rightValue) });
+                        return Token::IntegerLiteral(newType, modulus(leftValue, rightValue));
                     case Token::Operator::ShiftLeft:
-                        return new ASTNodeIntegerLiteral({ newType, shiftLeft(leftValue, rightValue) });
+                        return Token::IntegerLiteral(newType, shiftLeft(leftValue, rightValue));
                     case Token::Operator::ShiftRight:
-                        return new ASTNodeIntegerLiteral({ newType, shiftRight(leftValue, rightValue) });
+                        return Token::IntegerLiteral(newType, shiftRight(leftValue, rightValue));
                     case Token::Operator::BitAnd:
-                        return new ASTNodeIntegerLiteral({ newType, bitAnd(leftValue, rightValue) });
+                        return Token::IntegerLiteral(newType, bitAnd(leftValue, rightValue));
                     case Token::Operator::BitXor:
-                        return new ASTNodeIntegerLiteral({ newType, bitXor(leftValue, rightValue) });
+                        return Token::IntegerLiteral(newType, bitXor(leftValue, rightValue));
                     case Token::Operator::BitOr:
-                        return new ASTNodeIntegerLiteral({ newType, bitOr(leftValue, rightValue) });
+                        return Token::IntegerLiteral(newType, bitOr(leftValue, rightValue));
                     case Token::Operator::BitNot:
-                        return new ASTNodeIntegerLiteral({ newType, bitNot(leftValue, rightValue) });
+                        return Token::IntegerLiteral(newType, bitNot(leftValue, rightValue));
                     case Token::Operator::BoolEquals:
-                        return new ASTNodeIntegerLiteral({ newType, leftValue == rightValue });
+                        return Token::IntegerLiteral(newType, leftValue == rightValue);
                     case Token::Operator::BoolNotEquals:
-                        return new ASTNodeIntegerLiteral({ newType, leftValue != rightValue });
+                        return Token::IntegerLiteral(newType, leftValue != rightValue);
                     case Token::Operator::BoolGreaterThan:
-                        return new ASTNodeIntegerLiteral({ newType, leftValue > rightValue });
+                        return Token::IntegerLiteral(newType, leftValue > rightValue);
                     case Token::Operator::BoolLessThan:
-                        return new ASTNodeIntegerLiteral({ newType, leftValue < rightValue });
+                        return Token::IntegerLiteral(newType, leftValue < rightValue);
                     case Token::Operator::BoolGreaterThanOrEquals:
-                        return new ASTNodeIntegerLiteral({ newType, leftValue >= rightValue });
+                        return Token::IntegerLiteral(newType, leftValue >= rightValue);
                     case Token::Operator::BoolLessThanOrEquals:
-                        return new ASTNodeIntegerLiteral({ newType, leftValue <= rightValue });
+                        return Token::IntegerLiteral(newType, leftValue <= rightValue);
                     case Token::Operator::BoolAnd:
-                        return new ASTNodeIntegerLiteral({ newType, leftValue && rightValue });
+                        return Token::IntegerLiteral(newType, leftValue && rightValue);
                     case Token::Operator::BoolXor:
-                        return new ASTNodeIntegerLiteral({ newType, leftValue && !rightValue || !leftValue && rightValue });
+                        return Token::IntegerLiteral(newType, leftValue && !rightValue || !leftValue && rightValue);
                     case Token::Operator::BoolOr:
-                        return new ASTNodeIntegerLiteral({ newType, leftValue || rightValue });
+                        return Token::IntegerLiteral(newType, leftValue || rightValue);
                     case Token::Operator::BoolNot:
-                        return new ASTNodeIntegerLiteral({ newType, !rightValue });
+                        return Token::IntegerLiteral(newType, !rightValue);
                     default:
                         this->getConsole().abortEvaluation("invalid operator used in mathematical expression");
                 }
 
-            }, left->getValue(), right->getValue());
+            }, left.second, right.second);
         } catch (std::runtime_error &e) {
             this->getConsole().abortEvaluation("bitwise operations on floating point numbers are forbidden");
         }
     }
 
-    ASTNodeIntegerLiteral* Evaluator::evaluateOperand(ASTNode *node) {
-        if (auto exprLiteral = dynamic_cast<ASTNodeIntegerLiteral*>(node); exprLiteral != nullptr)
-            return exprLiteral;
-        else if (auto exprExpression = dynamic_cast<ASTNodeNumericExpression*>(node); exprExpression != nullptr)
-            return evaluateMathematicalExpression(exprExpression);
-        else if (auto exprRvalue = dynamic_cast<ASTNodeRValue*>(node); exprRvalue != nullptr)
-            return evaluateRValue(exprRvalue);
-        else if (auto exprScopeResolution = dynamic_cast<ASTNodeScopeResolution*>(node); exprScopeResolution != nullptr)
-            return evaluateScopeResolution(exprScopeResolution);
-        else if (auto exprTernary = dynamic_cast<ASTNodeTernaryExpression*>(node); exprTernary != nullptr)
-            return evaluateTernaryExpression(exprTernary);
-        else if (auto exprFunctionCall = dynamic_cast<ASTNodeFunctionCall*>(node); exprFunctionCall != nullptr) {
-            auto returnValue = evaluateFunctionCall(exprFunctionCall);
-
-            if (returnValue == nullptr)
-                this->getConsole().abortEvaluation("function returning void used in expression");
-            else if (auto integerNode = dynamic_cast<ASTNodeIntegerLiteral*>(returnValue); integerNode != nullptr)
-                return integerNode;
+    void Evaluator::compileOperand(ASTNode *node, bytecode::Program &program, u16 destination) {
+        using namespace bytecode;
+
+        auto emit = [&](Instruction instruction) {
+            program.instructions.push_back(instruction);
+            return program.instructions.size() - 1;
+        };
+
+        auto emitAbort = [&](const std::string &message) {
+            program.messages.push_back(message);
+            emit({ .opcode = Opcode::Abort, .operand = u32(program.messages.size() - 1) });
+        };
+
+        program.registerCount = std::max<u16>(program.registerCount, destination + 1);
+
+        if (auto literal = dynamic_cast<ASTNodeIntegerLiteral*>(node); literal != nullptr) {
+            program.constants.emplace_back(literal->getType(), literal->getValue());
+            emit({ .opcode = Opcode::LoadConstant, .destination = destination, .operand = u32(program.constants.size() - 1) });
+        } else if (auto expression = dynamic_cast<ASTNodeNumericExpression*>(node); expression != nullptr) {
+            // The right operand goes into the next register so nested expressions never overwrite a live value
+            u16 right = destination + 1;
+            if (right == 0)
+                this->getConsole().abortEvaluation("expression nested too deeply");
+
+            this->compileOperand(expression->getLeftOperand(), program, destination);
+            this->compileOperand(expression->getRightOperand(), program, right);
+            emit({ .opcode = Opcode::Operator, .op = expression->getOperator(), .destination = destination, .left = destination, .right = right });
+        } else if (auto rvalue = dynamic_cast<ASTNodeRValue*>(node); rvalue != nullptr) {
+            if (rvalue->getPath().size() == 1 && rvalue->getPath()[0] == "$")
+                emit({ .opcode = Opcode::LoadOffset, .destination = destination });
+            else {
+                program.nodes.push_back(rvalue);
+                emit({ .opcode = Opcode::LoadVariable, .destination = destination, .operand = u32(program.nodes.size() - 1) });
+            }
+        } else if (auto scopeResolution = dynamic_cast<ASTNodeScopeResolution*>(node); scopeResolution != nullptr) {
+            // Types are all declared by the time an expression gets compiled, so enum constants get inlined
+            ASTNode *currScope = nullptr;
+            ASTNode *entry = nullptr;
+            for (const auto &identifier : scopeResolution->getPath()) {
+                if (currScope == nullptr) {
+                    if (!this->m_types.contains(identifier))
+                        break;
+
+                    currScope = this->m_types[identifier];
+                } else if (auto enumNode = dynamic_cast<ASTNodeEnum*>(currScope); enumNode != nullptr) {
+                    if (enumNode->getEntries().contains(identifier))
+                        entry = enumNode->getEntries().at(identifier);
+                    break;
+                }
+            }
+
+            if (entry != nullptr)
+                this->compileOperand(entry, program, destination);
             else
-                this->getConsole().abortEvaluation("function not returning a numeric value used in expression");
-        }
-        else
-            this->getConsole().abortEvaluation("invalid operand");
+                emitAbort("failed to find identifier");
+        } else if (auto ternary = dynamic_cast<ASTNodeTernaryExpression*>(node); ternary != nullptr) {
+            if (ternary->getOperator() != Token::Operator::TernaryConditional) {
+                emitAbort("invalid operator used in ternary expression");
+                return;
+            }
+
+            this->compileOperand(ternary->getFirstOperand(), program, destination);
+            auto jumpToFalse = emit({ .opcode = Opcode::JumpIfZero, .left = destination });
+
+            this->compileOperand(ternary->getSecondOperand(), program, destination);
+            auto jumpToEnd = emit({ .opcode = Opcode::Jump });
+
+            program.instructions[jumpToFalse].operand = program.instructions.size();
+            this->compileOperand(ternary->getThirdOperand(), program, destination);
+            program.instructions[jumpToEnd].operand = program.instructions.size();
+        } else if (auto functionCall = dynamic_cast<ASTNodeFunctionCall*>(node); functionCall != nullptr) {
+            program.nodes.push_back(functionCall);
+            emit({ .opcode = Opcode::Call, .destination = destination, .operand = u32(program.nodes.size() - 1) });
+        } else
+            emitAbort("invalid operand");
     }
 
-    ASTNodeIntegerLiteral* Evaluator::evaluateTernaryExpression(ASTNodeTernaryExpression *node) {
-        switch (node->getOperator()) {
-            case Token::Operator::TernaryConditional: {
-                auto condition = this->evaluateOperand(node->getFirstOperand());
-                SCOPE_EXIT( delete condition; );
+    const bytecode::Program& Evaluator::getProgram(ASTNode *node) {
+        if (auto it = this->m_programs.find(node); it != this->m_programs.end())
+            return it->second;
 
-                if (std::visit([](auto &&value){ return value != 0; }, condition->getValue()))
-                    return this->evaluateOperand(node->getSecondOperand());
-                else
-                    return this->evaluateOperand(node->getThirdOperand());
+        bytecode::Program program;
+        this->compileOperand(node, program, 0);
+
+        return this->m_programs.emplace(node, std::move(program)).first->second;
+    }
+
+    Token::IntegerLiteral Evaluator::execute(const bytecode::Program &program) {
+        using namespace bytecode;
+
+        // Nested programs run by function calls get their own window at the end of the register file.
+        // Aborting leaves the window behind, evaluate() resets the register file before every run
+        const size_t base = this->m_registers.size();
+        this->m_registers.resize(base + program.registerCount);
+
+        auto reg = [this, base](u16 index) -> Token::IntegerLiteral& {
+            return this->m_registers[base + index];
+        };
+
+        const auto &instructions = program.instructions;
+        for (size_t pc = 0; pc < instructions.size(); pc++) {
+            const auto &instruction = instructions[pc];
+
+            switch (instruction.opcode) {
+                case Opcode::LoadConstant:
+                    reg(instruction.destination) = program.constants[instruction.operand];
+                    break;
+                case Opcode::LoadOffset:
+                    reg(instruction.destination) = { Token::ValueType::Unsigned64Bit, this->m_currOffset };
+                    break;
+                case Opcode::LoadVariable:
+                    reg(instruction.destination) = this->evaluateRValue(static_cast<ASTNodeRValue*>(program.nodes[instruction.operand]));
+                    break;
+                case Opcode::Call: {
+                    auto returnValue = this->evaluateFunctionCall(static_cast<ASTNodeFunctionCall*>(program.nodes[instruction.operand]));
+                    SCOPE_EXIT( delete returnValue; );
+
+                    if (returnValue == nullptr)
+                        this->getConsole().abortEvaluation("function returning void used in expression");
+                    else if (auto integerNode = dynamic_cast<ASTNodeIntegerLiteral*>(returnValue); integerNode != nullptr)
+                        reg(instruction.destination) = { integerNode->getType(), integerNode->getValue() };
+                    else
+                        this->getConsole().abortEvaluation("function not returning a numeric value used in expression");
+                    break;
+                }
+                case Opcode::Operator:
+                    reg(instruction.destination) = this->evaluateOperator(reg(instruction.left), reg(instruction.right), instruction.op);
+                    break;
+                case Opcode::JumpIfZero:
+                    if (!std::visit([](auto &&value) { return value != 0; }, reg(instruction.left).second))
+                        pc = instruction.operand - 1;
+                    break;
+                case Opcode::Jump:
+                    pc = instruction.operand - 1;
+                    break;
+                case Opcode::Abort:
+                    this->getConsole().abortEvaluation(program.messages[instruction.operand]);
             }
-            default:
-                this->getConsole().abortEvaluation("invalid operator used in ternary expression");
         }
+
+        auto result = reg(0);
+        this->m_registers.resize(base);
+
+        return result;
+    }
+
+    Token::IntegerLiteral Evaluator::evaluateExpression(ASTNode *node) {
+        return this->execute(this->getProgram(node));
     }
 
-    ASTNodeIntegerLiteral* Evaluator::evaluateMathematicalExpression(ASTNodeNumericExpression *node) {
-        auto leftInteger  = this->evaluateOperand(node->getLeftOperand());
-        auto rightInteger = this->evaluateOperand(node->getRightOperand());
+    const std::string* Evaluator::getTypeName(std::string_view name) {
+        if (auto it = this->m_typeNames.find(name); it != this->m_typeNames.end())
+            return it->second;
 
-        return evaluateOperator(leftInteger, rightInteger, node->getOperator());
+        // Keyed by the arena's copy, the name that was looked up may not live as long
+        auto typeName = this->m_arena.create<std::string>(name);
+        this->m_typeNames.emplace(*typeName, typeName);
+
+        return typeName;
     }
 
     PatternData* Evaluator::evaluateAttributes(ASTNode *currNode, PatternData *currPattern) {
@@ -342,6 +553,8 @@ namespace hex::lang {
                 currPattern->setVariableName(value->data());
             else if (attribute == "comment" && value.has_value())
                 currPattern->setComment(value->data());
+            else if (attribute == "entry_point" && !value.has_value())
+                currPattern->setEntryPoint(true);
             else
                 this->getConsole().abortEvaluation("unknown or invalid attribute");
 
@@ -382,21 +595,21 @@ namespace hex::lang {
         PatternData *pattern;
 
         if (type == Token::ValueType::Character)
-            pattern = new PatternDataCharacter(this->m_currOffset);
+            pattern = this->create<PatternDataCharacter>(this->m_currOffset);
         else if (type == Token::ValueType::Boolean)
-            pattern = new PatternDataBoolean(this->m_currOffset);
+            pattern = this->create<PatternDataBoolean>(this->m_currOffset);
         else if (Token::isUnsigned(type))
-            pattern = new PatternDataUnsigned(this->m_currOffset, typeSize);
+            pattern = this->create<PatternDataUnsigned>(this->m_currOffset, typeSize);
         else if (Token::isSigned(type))
-            pattern = new PatternDataSigned(this->m_currOffset, typeSize);
+            pattern = this->create<PatternDataSigned>(this->m_currOffset, typeSize);
         else if (Token::isFloatingPoint(type))
-            pattern = new PatternDataFloat(this->m_currOffset, typeSize);
+            pattern = this->create<PatternDataFloat>(this->m_currOffset, typeSize);
         else
             this->getConsole().abortEvaluation("invalid builtin type");
 
         this->m_currOffset += typeSize;
 
-        pattern->setTypeName(Token::getTypeName(type));
+        pattern->setTypeName(this->getTypeName(Token::getTypeName(type)));
         pattern->setEndian(this->getCurrentEndian());
 
         return pattern;
@@ -412,9 +625,9 @@ namespace hex::lang {
         else if (auto memberPointerNode = dynamic_cast<ASTNodePointerVariableDecl*>(node); memberPointerNode != nullptr)
             currMembers.push_back(this->evaluatePointer(memberPointerNode));
         else if (auto conditionalNode = dynamic_cast<ASTNodeConditionalStatement*>(node); conditionalNode != nullptr) {
-            auto condition = this->evaluateMathematicalExpression(static_cast<ASTNodeNumericExpression*>(conditionalNode->getCondition()));
+            auto condition = this->evaluateExpression(conditionalNode->getCondition());
 
-            if (std::visit([](auto &&value) { return value != 0; }, condition->getValue())) {
+            if (std::visit([](auto &&value) { return value != 0; }, condition.second)) {
                 for (auto &statement : conditionalNode->getTrueBody()) {
                     this->evaluateMember(statement, currMembers, increaseOffset);
                 }
@@ -423,8 +636,6 @@ namespace hex::lang {
                     this->evaluateMember(statement, currMembers, increaseOffset);
                 }
             }
-
-            delete condition;
         }
         else
             this->getConsole().abortEvaluation("invalid struct member");
@@ -444,7 +655,7 @@ namespace hex::lang {
             this->evaluateMember(member, memberPatterns, true);
         }
 
-        return this->evaluateAttributes(node, new PatternDataStruct(startOffset, this->m_currOffset - startOffset, memberPatterns));
+        return this->evaluateAttributes(node, this->create<PatternDataStruct>(startOffset, this->m_currOffset - startOffset, memberPatterns));
     }
 
     PatternData* Evaluator::evaluateUnion(ASTNodeUnion *node) {
@@ -465,22 +676,27 @@ namespace hex::lang {
 
         this->m_currOffset += size;
 
-        return this->evaluateAttributes(node, new PatternDataUnion(startOffset, size, memberPatterns));
+        return this->evaluateAttributes(node, this->create<PatternDataUnion>(startOffset, size, memberPatterns));
     }
 
     PatternData* Evaluator::evaluateEnum(ASTNodeEnum *node) {
-        std::vector<std::pair<Token::IntegerLiteral, std::string>> entryPatterns;
-
         auto startOffset = this->m_currOffset;
-        for (auto &[name, value] : node->getEntries()) {
-            auto expression = dynamic_cast<ASTNodeNumericExpression*>(value);
-            if (expression == nullptr)
-                this->getConsole().abortEvaluation("invalid expression in enum value");
 
-            auto valueNode = evaluateMathematicalExpression(expression);
-            SCOPE_EXIT( delete valueNode; );
+        auto &enumValues = this->m_enumValues[node];
+        if (enumValues == nullptr) {
+            std::vector<std::pair<Token::IntegerLiteral, std::string>> entries;
+
+            for (auto &[name, value] : node->getEntries()) {
+                auto expression = dynamic_cast<ASTNodeNumericExpression*>(value);
+                if (expression == nullptr)
+                    this->getConsole().abortEvaluation("invalid expression in enum value");
+
+                auto literal = this->evaluateExpression(expression);
+
+                entries.push_back({ literal, name });
+            }
 
-            entryPatterns.push_back({{ valueNode->getType(), valueNode->getValue() }, name });
+            enumValues = this->m_arena.create<EnumValues>(std::move(entries));
         }
 
         auto underlyingType = dynamic_cast<ASTNodeTypeDecl*>(node->getUnderlyingType());
@@ -495,52 +711,94 @@ namespace hex::lang {
 
         this->m_currOffset += size;
 
-        return this->evaluateAttributes(node, new PatternDataEnum(startOffset, size, entryPatterns));
+        return this->evaluateAttributes(node, this->create<PatternDataEnum>(startOffset, size, enumValues));
     }
 
     PatternData* Evaluator::evaluateBitfield(ASTNodeBitfield *node) {
-        std::vector<std::pair<std::string, size_t>> entryPatterns;
-
         auto startOffset = this->m_currOffset;
+
+        // Layouts whose field sizes are constant only get worked out the first time the type is used
+        if (auto it = this->m_bitfieldFields.find(node); it != this->m_bitfieldFields.end() && !it->second->empty() && this->hasStaticLayout(node)) {
+            const auto &lastField = it->second->back();
+            size_t size = (lastField.bitOffset + lastField.size + 7) / 8;
+            this->m_currOffset += size;
+
+            return this->evaluateAttributes(node, this->create<PatternDataBitfield>(startOffset, size, it->second));
+        }
+
+        PatternDataBitfield::Fields entryPatterns;
         size_t bits = 0;
         for (auto &[name, value] : node->getEntries()) {
             auto expression = dynamic_cast<ASTNodeNumericExpression*>(value);
             if (expression == nullptr)
                 this->getConsole().abortEvaluation("invalid expression in bitfield field size");
 
-            auto valueNode = evaluateMathematicalExpression(expression);
-            SCOPE_EXIT( delete valueNode; );
+            auto literal = this->evaluateExpression(expression);
 
-            auto fieldBits = std::visit([this, node, type = valueNode->getType()] (auto &&value) {
+            auto fieldBits = std::visit([this, node, type = literal.first] (auto &&value) {
                 if (Token::isFloatingPoint(type))
                     this->getConsole().abortEvaluation("bitfield entry size must be an integer value");
                 return static_cast<s128>(value);
-            }, valueNode->getValue());
+            }, literal.second);
 
             if (fieldBits > 64 || fieldBits <= 0)
                 this->getConsole().abortEvaluation("bitfield entry must occupy between 1 and 64 bits");
 
-            bits += fieldBits;
+            entryPatterns.emplace_back(name, fieldBits, bits);
 
-            entryPatterns.emplace_back(name, fieldBits);
+            bits += fieldBits;
         }
 
         size_t size = (bits + 7) / 8;
         this->m_currOffset += size;
 
-        return this->evaluateAttributes(node, new PatternDataBitfield(startOffset, size, entryPatterns));
+        // Field sizes may depend on the data, only bitfields that end up with the same layout share it
+        auto &fields = this->m_bitfieldFields[node];
+        if (fields == nullptr || *fields != entryPatterns)
+            fields = this->m_arena.create<PatternDataBitfield::Fields>(std::move(entryPatterns));
+
+        return this->evaluateAttributes(node, this->create<PatternDataBitfield>(startOffset, size, fields));
     }
 
     PatternData* Evaluator::evaluateType(ASTNodeTypeDecl *node) {
         auto type = node->getType();
 
+        if (++this->m_currDepth > this->m_evaluationDepth)
+            this->getConsole().abortEvaluation(hex::format("evaluation depth exceeded the limit of {0}", this->m_evaluationDepth));
+
+        auto profile = node->getName().empty() ? std::nullopt : this->beginProfiling();
+        SCOPE_EXIT(
+            this->m_currDepth--;
+            this->endProfiling("type", node->getName(), profile);
+        );
+
         this->m_endianStack.push_back(node->getEndian().value_or(this->m_defaultDataEndian));
 
         PatternData *pattern;
 
         if (auto builtinTypeNode = dynamic_cast<ASTNodeBuiltinType*>(type); builtinTypeNode != nullptr)
             return this->evaluateBuiltinType(builtinTypeNode);
-        else if (auto typeDeclNode = dynamic_cast<ASTNodeTypeDecl*>(type); typeDeclNode != nullptr)
+
+        // Every use of a type goes through an unnamed declaration, static layouts are looked up there so nested types don't get cached twice
+        bool staticLayout = node->getName().empty() && this->hasStaticLayout(type);
+        auto createdPatterns = this->m_createdPatterns.load();
+
+        if (staticLayout) {
+            if (auto it = this->m_staticLayoutPatterns.find({ type, this->getCurrentEndian() }); it != this->m_staticLayoutPatterns.end() && it->second.pattern != nullptr) {
+                this->handleAbort();
+                this->countPatterns(it->second.patternCount);
+
+                pattern = it->second.pattern->clone(this->m_arena);
+                pattern->setOffset(this->m_currOffset);
+                this->m_currOffset += pattern->getSize();
+
+                this->m_endianStack.pop_back();
+
+                return pattern;
+            }
+        }
+
+        if (auto typeDeclNode = dynamic_cast<ASTNodeTypeDecl*>(type); typeDeclNode != nullptr)
             pattern = this->evaluateType(typeDeclNode);
         else if (auto structNode = dynamic_cast<ASTNodeStruct*>(type); structNode != nullptr)
             pattern = this->evaluateStruct(structNode);
@@ -554,10 +812,16 @@ namespace hex::lang {
             this->getConsole().abortEvaluation("type could not be evaluated");
 
         if (!node->getName().empty())
-            pattern->setTypeName(node->getName().data());
+            pattern->setTypeName(this->getTypeName(node->getName()));
 
         pattern->setEndian(this->getCurrentEndian());
 
+        // Most types are only used once, a copy to clone from is only kept once a type is used a second time
+        if (staticLayout) {
+            if (auto [it, inserted] = this->m_staticLayoutPatterns.try_emplace({ type, this->getCurrentEndian() }); !inserted)
+                it->second = { pattern->clone(this->m_arena), this->m_createdPatterns - createdPatterns };
+        }
+
         this->m_endianStack.pop_back();
 
         return pattern;
@@ -566,14 +830,13 @@ namespace hex::lang {
     PatternData* Evaluator::evaluateVariable(ASTNodeVariableDecl *node) {
 
         if (auto offset = dynamic_cast<ASTNodeNumericExpression*>(node->getPlacementOffset()); offset != nullptr) {
-            auto valueNode = evaluateMathematicalExpression(offset);
-            SCOPE_EXIT( delete valueNode; );
+            auto literal = this->evaluateExpression(offset);
 
-            this->m_currOffset = std::visit([this, node, type = valueNode->getType()] (auto &&value) {
+            this->m_currOffset = std::visit([this, node, type = literal.first] (auto &&value) {
                 if (Token::isFloatingPoint(type))
                     this->getConsole().abortEvaluation("placement offset must be an integer value");
                 return static_cast<u64>(value);
-            }, valueNode->getValue());
+            }, literal.second);
         }
         if (this->m_currOffset >= this->m_provider->getActualSize())
             this->getConsole().abortEvaluation("variable placed out of range");
@@ -591,60 +854,138 @@ namespace hex::lang {
         return this->evaluateAttributes(node, pattern);
     }
 
+    bool Evaluator::isConstantExpression(ASTNode *node) {
+        if (dynamic_cast<ASTNodeIntegerLiteral*>(node) != nullptr || dynamic_cast<ASTNodeScopeResolution*>(node) != nullptr)
+            return true;
+        else if (auto numericExpression = dynamic_cast<ASTNodeNumericExpression*>(node); numericExpression != nullptr)
+            return this->isConstantExpression(numericExpression->getLeftOperand()) && this->isConstantExpression(numericExpression->getRightOperand());
+        else if (auto ternaryExpression = dynamic_cast<ASTNodeTernaryExpression*>(node); ternaryExpression != nullptr)
+            return this->isConstantExpression(ternaryExpression->getFirstOperand()) && this->isConstantExpression(ternaryExpression->getSecondOperand()) && this->isConstantExpression(ternaryExpression->getThirdOperand());
+        else
+            return false;
+    }
+
+    bool Evaluator::hasStaticLayout(ASTNode *node) {
+        if (auto it = this->m_staticLayouts.find(node); it != this->m_staticLayouts.end())
+            return it->second;
+
+        bool result = false;
+        if (dynamic_cast<ASTNodeBuiltinType*>(node) != nullptr)
+            result = true;
+        else if (auto typeDecl = dynamic_cast<ASTNodeTypeDecl*>(node); typeDecl != nullptr)
+            result = this->hasStaticLayout(typeDecl->getType());
+        else if (auto variableDecl = dynamic_cast<ASTNodeVariableDecl*>(node); variableDecl != nullptr)
+            result = variableDecl->getPlacementOffset() == nullptr && this->hasStaticLayout(variableDecl->getType());
+        else if (auto arrayDecl = dynamic_cast<ASTNodeArrayVariableDecl*>(node); arrayDecl != nullptr)
+            result = arrayDecl->getPlacementOffset() == nullptr && arrayDecl->getSize() != nullptr && this->isConstantExpression(arrayDecl->getSize()) && this->hasStaticLayout(arrayDecl->getType());
+        else if (auto structNode = dynamic_cast<ASTNodeStruct*>(node); structNode != nullptr)
+            result = std::all_of(structNode->getMembers().begin(), structNode->getMembers().end(), [this](auto member) { return this->hasStaticLayout(member); });
+        else if (auto unionNode = dynamic_cast<ASTNodeUnion*>(node); unionNode != nullptr)
+            result = std::all_of(unionNode->getMembers().begin(), unionNode->getMembers().end(), [this](auto member) { return this->hasStaticLayout(member); });
+        else if (auto enumNode = dynamic_cast<ASTNodeEnum*>(node); enumNode != nullptr)
+            result = std::all_of(enumNode->getEntries().begin(), enumNode->getEntries().end(), [this](auto &entry) { return this->isConstantExpression(entry.second); });
+        else if (auto bitfieldNode = dynamic_cast<ASTNodeBitfield*>(node); bitfieldNode != nullptr)
+            result = std::all_of(bitfieldNode->getEntries().begin(), bitfieldNode->getEntries().end(), [this](auto &entry) { return this->isConstantExpression(entry.second); });
+
+        this->m_staticLayouts[node] = result;
+
+        return result;
+    }
+
     PatternData* Evaluator::evaluateArray(ASTNodeArrayVariableDecl *node) {
+        auto profile = this->beginProfiling();
+        SCOPE_EXIT( this->endProfiling("array", node->getName(), profile); );
 
         if (auto offset = dynamic_cast<ASTNodeNumericExpression*>(node->getPlacementOffset()); offset != nullptr) {
-            auto valueNode = evaluateMathematicalExpression(offset);
-            SCOPE_EXIT( delete valueNode; );
+            auto literal = this->evaluateExpression(offset);
 
-            this->m_currOffset = std::visit([this, node, type = valueNode->getType()] (auto &&value) {
+            this->m_currOffset = std::visit([this, node, type = literal.first] (auto &&value) {
                 if (Token::isFloatingPoint(type))
                     this->getConsole().abortEvaluation("placement offset must be an integer value");
                 return static_cast<u64>(value);
-            }, valueNode->getValue());
+            }, literal.second);
         }
 
         auto startOffset = this->m_currOffset;
 
-        ASTNodeIntegerLiteral *valueNode;
+        Token::IntegerLiteral literal;
         u64 arraySize = 0;
 
         if (node->getSize() != nullptr) {
             if (auto sizeNumericExpression = dynamic_cast<ASTNodeNumericExpression*>(node->getSize()); sizeNumericExpression != nullptr)
-                valueNode = evaluateMathematicalExpression(sizeNumericExpression);
+                literal = this->evaluateExpression(sizeNumericExpression);
             else
                 this->getConsole().abortEvaluation("array size not a numeric expression");
 
-            SCOPE_EXIT( delete valueNode; );
-
-            arraySize = std::visit([this, node, type = valueNode->getType()] (auto &&value) {
+            arraySize = std::visit([this, node, type = literal.first] (auto &&value) {
                 if (Token::isFloatingPoint(type))
                     this->getConsole().abortEvaluation("array size must be an integer value");
                 return static_cast<u64>(value);
-            }, valueNode->getValue());
+            }, literal.second);
 
-            if (auto typeDecl = dynamic_cast<ASTNodeTypeDecl*>(node->getType()); typeDecl != nullptr) {
-                if (auto builtinType = dynamic_cast<ASTNodeBuiltinType*>(typeDecl->getType()); builtinType != nullptr) {
-                    if (builtinType->getType() == Token::ValueType::Padding) {
-                        this->m_currOffset += arraySize;
-                        return new PatternDataPadding(startOffset, arraySize);
-                    }
-                }
+            auto typeDecl = dynamic_cast<ASTNodeTypeDecl*>(node->getType());
+            auto builtinType = dynamic_cast<ASTNodeBuiltinType*>(typeDecl != nullptr ? typeDecl->getType() : node->getType());
+
+            if (builtinType != nullptr && builtinType->getType() == Token::ValueType::Padding) {
+                this->m_currOffset += arraySize;
+                return this->create<PatternDataPadding>(startOffset, arraySize);
+            }
+
+            // Arrays of types with a static layout only need their first entry to be evaluated, all others are laid out the same way
+            bool isString = builtinType != nullptr && builtinType->getType() == Token::ValueType::Character;
+            if (!isString && arraySize > 0 && this->hasStaticLayout(node->getType())) {
+                PatternData *entry;
+                if (typeDecl != nullptr)
+                    entry = this->evaluateType(typeDecl);
+                else if (builtinType != nullptr)
+                    entry = this->evaluateBuiltinType(builtinType);
+                else
+                    this->getConsole().abortEvaluation("ASTNodeArrayVariableDecl had an invalid type. This is a bug!");
+
+                entry->setEndian(this->getCurrentEndian());
+
+                auto entrySize = entry->getSize();
+                if (startOffset > this->m_provider->getActualSize() || entrySize != 0 && arraySize > (this->m_provider->getActualSize() - startOffset) / entrySize)
+                    this->getConsole().abortEvaluation("array exceeds size of file");
+
+                this->m_currOffset = startOffset + arraySize * entrySize;
+
+                auto pattern = this->create<PatternDataStaticArray>(startOffset, arraySize * entrySize, entry, arraySize, entry->getColor());
+                pattern->setVariableName(node->getName().data());
+
+                return this->evaluateAttributes(node, pattern);
             }
         } else {
-            u8 currByte = 0x00;
+            // Search for the terminator a whole window at a time instead of reading byte by byte
             u64 offset = startOffset;
+            bool terminated = false;
+            while (offset < this->m_provider->getSize()) {
+                this->handleAbort();
+
+                auto window = this->getReadWindow(offset, 1);
+                if (auto terminator = std::memchr(window.data(), 0x00, window.size()); terminator != nullptr) {
+                    offset += (static_cast<const u8*>(terminator) - window.data()) + 1;
+                    terminated = true;
+                    break;
+                }
 
-            do {
-                this->m_provider->read(offset, &currByte, sizeof(u8));
-                offset += sizeof(u8);
-                arraySize += sizeof(u8);
-            } while (currByte != 0x00 && offset < this->m_provider->getSize());
+                offset += window.size();
+            }
+
+            // Without a terminator the array ends with the data, so data appended to it changes the array as well
+            this->m_bytesRead += offset - startOffset;
+            this->recordRead(startOffset, offset - startOffset + (terminated ? 0 : 1));
+
+            // A string always contains at least its terminator, even if it starts past the end of the data
+            arraySize = std::max<u64>(offset - startOffset, 1);
         }
 
+        if (arraySize > this->m_arrayLimit)
+            this->getConsole().abortEvaluation(hex::format("array grew past the limit of {0} entries", this->m_arrayLimit));
+
         std::vector<PatternData*> entries;
         std::optional<u32> color;
-        for (s128 i = 0; i < arraySize; i++) {
+        for (u64 i = 0; i < arraySize; i++) {
             PatternData *entry;
             if (auto typeDecl = dynamic_cast<ASTNodeTypeDecl*>(node->getType()); typeDecl != nullptr)
                 entry = this->evaluateType(typeDecl);
@@ -654,7 +995,7 @@ namespace hex::lang {
             else
                 this->getConsole().abortEvaluation("ASTNodeVariableDecl had an invalid type. This is a bug!");
 
-            entry->setVariableName(hex::format("[{0}]", (u64)i));
+            entry->setVariableName(hex::format("[{0}]", i));
             entry->setEndian(this->getCurrentEndian());
 
             if (!color.has_value())
@@ -669,14 +1010,14 @@ namespace hex::lang {
 
         PatternData *pattern;
         if (entries.empty()) {
-            pattern = new PatternDataPadding(startOffset, 0);
+            pattern = this->create<PatternDataPadding>(startOffset, 0);
         }
         else if (dynamic_cast<PatternDataCharacter*>(entries[0]))
-            pattern = new PatternDataString(startOffset, (this->m_currOffset - startOffset), color.value_or(0));
+            pattern = this->create<PatternDataString>(startOffset, (this->m_currOffset - startOffset), color.value_or(0));
         else {
             if (node->getSize() == nullptr)
                 this->getConsole().abortEvaluation("no bounds provided for array");
-            pattern = new PatternDataArray(startOffset, (this->m_currOffset - startOffset), entries, color.value_or(0));
+            pattern = this->create<PatternDataArray>(startOffset, (this->m_currOffset - startOffset), entries, color.value_or(0));
         }
 
         pattern->setVariableName(node->getName().data());
@@ -687,14 +1028,13 @@ namespace hex::lang {
     PatternData* Evaluator::evaluatePointer(ASTNodePointerVariableDecl *node) {
         s128 pointerOffset;
         if (auto offset = dynamic_cast<ASTNodeNumericExpression*>(node->getPlacementOffset()); offset != nullptr) {
-            auto valueNode = evaluateMathematicalExpression(offset);
-            SCOPE_EXIT( delete valueNode; );
+            auto literal = this->evaluateExpression(offset);
 
-            pointerOffset = std::visit([this, node, type = valueNode->getType()] (auto &&value) {
+            pointerOffset = std::visit([this, node, type = literal.first] (auto &&value) {
                 if (Token::isFloatingPoint(type))
                     this->getConsole().abortEvaluation("pointer offset must be an integer value");
                 return static_cast<s128>(value);
-            }, valueNode->getValue());
+            }, literal.second);
             this->m_currOffset = pointerOffset;
         } else {
             pointerOffset = this->m_currOffset;
@@ -714,26 +1054,50 @@ namespace hex::lang {
         size_t pointerSize = sizeType->getSize();
 
         u128 pointedAtOffset = 0;
-        this->m_provider->read(pointerOffset, &pointedAtOffset, pointerSize);
+        this->readData(pointerOffset, &pointedAtOffset, pointerSize);
         this->m_currOffset = hex::changeEndianess(pointedAtOffset, pointerSize, underlyingType->getEndian().value_or(this->m_defaultDataEndian));
 
-        delete sizeType;
-
-
         if (this->m_currOffset > this->m_provider->getActualSize())
             this->getConsole().abortEvaluation("pointer points past the end of the data");
 
-        PatternData *pointedAt;
-        if (auto typeDecl = dynamic_cast<ASTNodeTypeDecl*>(node->getType()); typeDecl != nullptr)
-            pointedAt = this->evaluateType(typeDecl);
-        else if (auto builtinTypeDecl = dynamic_cast<ASTNodeBuiltinType*>(node->getType()); builtinTypeDecl != nullptr)
-            pointedAt = this->evaluateBuiltinType(builtinTypeDecl);
-        else
-            this->getConsole().abortEvaluation("ASTNodeVariableDecl had an invalid type. This is a bug!");
+        // Every use of a type goes through its own unnamed declaration, the type it refers to and its endianness identify the target.
+        // Statements get re-evaluated on their own, so targets are only shared within one of them
+        ASTNode *targetType = node->getType();
+        std::endian targetEndian = this->getCurrentEndian();
+        if (auto typeDecl = dynamic_cast<ASTNodeTypeDecl*>(targetType); typeDecl != nullptr) {
+            targetType = typeDecl->getType();
+            targetEndian = typeDecl->getEndian().value_or(this->m_defaultDataEndian);
+        }
+
+        auto key = std::make_tuple(this->m_currStatement.value_or(std::numeric_limits<size_t>::max()), this->m_currOffset, targetType, targetEndian);
+
+        PatternData *pointedAt = nullptr;
+        bool cycle = false;
+        if (auto it = this->m_pointedAtPatterns.find(key); it != this->m_pointedAtPatterns.end()) {
+            pointedAt = it->second;
+            cycle = pointedAt == nullptr;
+        } else {
+            this->m_pointedAtPatterns.emplace(key, nullptr);
+
+            if (auto typeDecl = dynamic_cast<ASTNodeTypeDecl*>(node->getType()); typeDecl != nullptr)
+                pointedAt = this->evaluateType(typeDecl);
+            else if (auto builtinTypeDecl = dynamic_cast<ASTNodeBuiltinType*>(node->getType()); builtinTypeDecl != nullptr)
+                pointedAt = this->evaluateBuiltinType(builtinTypeDecl);
+            else
+                this->getConsole().abortEvaluation("ASTNodeVariableDecl had an invalid type. This is a bug!");
+
+            this->m_pointedAtPatterns[key] = pointedAt;
+        }
 
         this->m_currOffset = pointerOffset + pointerSize;
 
-        auto pattern = new PatternDataPointer(pointerOffset, pointerSize, pointedAt);
+        auto pattern = this->create<PatternDataPointer>(pointerOffset, pointerSize, pointedAt);
+
+        // The target is one of the patterns containing this pointer, following it would never end
+        if (cycle) {
+            if (auto typeDecl = dynamic_cast<ASTNodeTypeDecl*>(node->getType()); typeDecl != nullptr)
+                pattern->setTypeName(this->getTypeName(typeDecl->getName()));
+        }
 
         pattern->setVariableName(node->getName().data());
         pattern->setEndian(this->getCurrentEndian());
@@ -741,24 +1105,450 @@ namespace hex::lang {
         return this->evaluateAttributes(node, pattern);
     }
 
+    const std::vector<u64>& Evaluator::getSequenceOccurrences(const std::vector<u8> &sequence, const std::vector<u8> &mask) {
+        // The result depends on every byte of the data
+        if (this->m_currStatement.has_value())
+            this->m_statements[*this->m_currStatement].readsAllData = true;
+
+        auto key = std::make_pair(sequence, mask);
+        if (auto it = this->m_sequenceOccurrences.find(key); it != this->m_sequenceOccurrences.end())
+            return it->second;
+
+        // Chunks finish out of order, sort them by their offset before joining them together
+        std::mutex chunkMutex;
+        std::map<u64, std::vector<u64>> chunks;
+        // The searcher works on absolute addresses, patterns only see the current page
+        u64 pageStart = u64(this->m_provider->getCurrentPage()) * prv::Provider::PageSize;
+
+        SequenceSearcher searcher({ sequence }, { mask });
+        searcher.searchParallel(this->m_provider, pageStart, this->m_provider->getSize(), [&](u64 chunkOffset, size_t, auto &&occurrences) {
+            std::vector<u64> addresses;
+            addresses.reserve(occurrences.size());
+            for (const auto &[address, needle] : occurrences)
+                addresses.push_back(address - pageStart);
+
+            std::scoped_lock lock(chunkMutex);
+            chunks.emplace(chunkOffset, std::move(addresses));
+        }, this->m_aborted);
+
+        this->handleAbort();
+        this->m_bytesRead += this->m_provider->getSize();
+
+        auto &result = this->m_sequenceOccurrences[key];
+        for (const auto &[chunkOffset, addresses] : chunks)
+            result.insert(result.end(), addresses.begin(), addresses.end());
+
+        return result;
+    }
+
+    void Evaluator::readData(u64 address, void *buffer, size_t size) {
+        this->m_bytesRead += size;
+        this->recordRead(address, size);
+
+        if (size <= ReadWindowSize) {
+            if (auto window = this->getReadWindow(address, size); window.size() >= size) {
+                std::memcpy(buffer, window.data(), size);
+                return;
+            }
+        }
+
+        this->m_provider->read(address, buffer, size);
+    }
+
+    u64 Evaluator::useRegion(u64 address, size_t size) {
+        auto providerSize = this->m_provider->getSize();
+        if (address > providerSize || size > providerSize - address)
+            this->getConsole().abortEvaluation("region out of range");
+
+        this->m_bytesRead += size;
+        this->recordRead(address, size);
+
+        return u64(this->m_provider->getCurrentPage()) * prv::Provider::PageSize + address;
+    }
+
+    std::span<const u8> Evaluator::getReadWindow(u64 address, size_t minimumSize) {
+        auto providerSize = this->m_provider->getSize();
+        if (address >= providerSize)
+            return { };
+
+        // Refill the window starting at the requested address if it doesn't contain the whole range yet
+        if (address < this->m_readWindowAddress || address + minimumSize > this->m_readWindowAddress + this->m_readWindow.size()) {
+            size_t size = std::min<u64>(ReadWindowSize, providerSize - address);
+
+            if (auto view = this->m_provider->getDirectView(address, size); view.has_value())
+                this->m_readWindow = view.value();
+            else {
+                this->m_readBuffer.resize(size);
+                this->m_provider->read(address, this->m_readBuffer.data(), size);
+                this->m_readWindow = this->m_readBuffer;
+            }
+
+            this->m_readWindowAddress = address;
+        }
+
+        return this->m_readWindow.subspan(address - this->m_readWindowAddress);
+    }
+
+    std::optional<Evaluator::ProfileSnapshot> Evaluator::beginProfiling() const {
+        if (!this->m_profiling)
+            return { };
+
+        return ProfileSnapshot { std::chrono::steady_clock::now(), this->m_bytesRead, this->m_createdPatterns };
+    }
+
+    void Evaluator::endProfiling(std::string_view kind, std::string_view name, const std::optional<ProfileSnapshot> &snapshot) {
+        if (!snapshot.has_value())
+            return;
+
+        auto &entry = this->m_profile[hex::format("{0} {1}", kind, name)];
+        entry.evaluations++;
+        entry.time += std::chrono::steady_clock::now() - snapshot->start;
+        entry.bytesRead += this->m_bytesRead - snapshot->bytesRead;
+        entry.patterns += this->m_createdPatterns - snapshot->patterns;
+    }
+
+    void Evaluator::logProfile() {
+        if (!this->m_profiling)
+            return;
+
+        std::vector<std::pair<std::string, ProfileEntry>> entries(this->m_profile.begin(), this->m_profile.end());
+        std::sort(entries.begin(), entries.end(), [](const auto &left, const auto &right) {
+            return left.second.time > right.second.time;
+        });
+
+        this->getConsole().log(LogConsole::Level::Info, "profile (times include nested evaluations):");
+        for (const auto &[name, entry] : entries) {
+            auto milliseconds = std::chrono::duration<double, std::milli>(entry.time).count();
+            this->getConsole().log(LogConsole::Level::Info, hex::format("  {0}: {1}x, {2:.3f} ms, {3} bytes read, {4} patterns", name, entry.evaluations, milliseconds, entry.bytesRead, entry.patterns));
+        }
+    }
+
+    void Evaluator::recordEndOfData() {
+        this->recordRead(this->m_provider->getActualSize(), 1);
+    }
+
+    void Evaluator::recordRead(u64 address, size_t size) {
+        if (!this->m_currStatement.has_value() || size == 0)
+            return;
+
+        auto &reads = this->m_statements[*this->m_currStatement].reads;
+
+        // Most reads continue where the last one stopped, merge them so the list stays short
+        if (!reads.empty()) {
+            auto &last = reads.back();
+            if (address <= last.address + last.size && address + size >= last.address) {
+                u64 end = std::max(last.address + last.size, address + size);
+                last.address = std::min(last.address, address);
+                last.size = end - last.address;
+                return;
+            }
+        }
+
+        // Too many scattered reads, fall back to a single region covering all of them
+        if (reads.size() >= MaxTrackedReads) {
+            u64 start = address, end = address + size;
+            for (const auto &read : reads) {
+                start = std::min(start, read.address);
+                end = std::max(end, read.address + read.size);
+            }
+
+            reads = { Region { start, end - start } };
+            return;
+        }
+
+        reads.push_back({ address, size });
+    }
+
+    bool Evaluator::isAffected(const StatementDependencies &statement, const std::vector<Region> &changedRegions, const std::vector<bool> &dirtyGlobals) const {
+        if (statement.readsAllData)
+            return true;
+
+        for (auto global : statement.globalReferences)
+            if (dirtyGlobals[global])
+                return true;
+
+        for (const auto &read : statement.reads) {
+            for (const auto &change : changedRegions) {
+                if (read.address < change.address + change.size && change.address < read.address + read.size)
+                    return true;
+            }
+        }
+
+        return false;
+    }
+
+    PatternData* Evaluator::evaluateGlobalVariable(ASTNode *node) {
+        if (auto variableDeclNode = dynamic_cast<ASTNodeVariableDecl*>(node); variableDeclNode != nullptr)
+            return this->evaluateVariable(variableDeclNode);
+        else if (auto arrayDeclNode = dynamic_cast<ASTNodeArrayVariableDecl*>(node); arrayDeclNode != nullptr)
+            return this->evaluateArray(arrayDeclNode);
+        else if (auto pointerDeclNode = dynamic_cast<ASTNodePointerVariableDecl*>(node); pointerDeclNode != nullptr)
+            return this->evaluatePointer(pointerDeclNode);
+        else
+            return nullptr;
+    }
+
+    /* Conservative check whether evaluating a node might look up a global variable by name */
+    bool Evaluator::mayReferenceGlobals(ASTNode *node) {
+        if (node == nullptr)
+            return false;
+
+        if (auto it = this->m_globalReferences.find(node); it != this->m_globalReferences.end())
+            return it->second;
+
+        // Guards against types that contain themselves through a pointer
+        this->m_globalReferences[node] = false;
+
+        auto anyOf = [this](const auto &nodes) {
+            return std::any_of(nodes.begin(), nodes.end(), [this](auto node) { return this->mayReferenceGlobals(node); });
+        };
+
+        bool result = false;
+        if (auto rvalue = dynamic_cast<ASTNodeRValue*>(node); rvalue != nullptr)
+            result = !rvalue->getPath().empty() && this->m_globalNames.contains(rvalue->getPath()[0]);
+        else if (auto numericExpression = dynamic_cast<ASTNodeNumericExpression*>(node); numericExpression != nullptr)
+            result = this->mayReferenceGlobals(numericExpression->getLeftOperand()) || this->mayReferenceGlobals(numericExpression->getRightOperand());
+        else if (auto ternary = dynamic_cast<ASTNodeTernaryExpression*>(node); ternary != nullptr)
+            result = this->mayReferenceGlobals(ternary->getFirstOperand()) || this->mayReferenceGlobals(ternary->getSecondOperand()) || this->mayReferenceGlobals(ternary->getThirdOperand());
+        else if (auto typeDecl = dynamic_cast<ASTNodeTypeDecl*>(node); typeDecl != nullptr)
+            result = this->mayReferenceGlobals(typeDecl->getType());
+        else if (auto variableDecl = dynamic_cast<ASTNodeVariableDecl*>(node); variableDecl != nullptr)
+            result = this->mayReferenceGlobals(variableDecl->getType()) || this->mayReferenceGlobals(variableDecl->getPlacementOffset());
+        else if (auto arrayDecl = dynamic_cast<ASTNodeArrayVariableDecl*>(node); arrayDecl != nullptr)
+            result = this->mayReferenceGlobals(arrayDecl->getType()) || this->mayReferenceGlobals(arrayDecl->getSize()) || this->mayReferenceGlobals(arrayDecl->getPlacementOffset());
+        else if (auto pointerDecl = dynamic_cast<ASTNodePointerVariableDecl*>(node); pointerDecl != nullptr)
+            result = this->mayReferenceGlobals(pointerDecl->getType()) || this->mayReferenceGlobals(pointerDecl->getSizeType()) || this->mayReferenceGlobals(pointerDecl->getPlacementOffset());
+        else if (auto structNode = dynamic_cast<ASTNodeStruct*>(node); structNode != nullptr)
+            result = anyOf(structNode->getMembers());
+        else if (auto unionNode = dynamic_cast<ASTNodeUnion*>(node); unionNode != nullptr)
+            result = anyOf(unionNode->getMembers());
+        else if (auto enumNode = dynamic_cast<ASTNodeEnum*>(node); enumNode != nullptr)
+            result = std::any_of(enumNode->getEntries().begin(), enumNode->getEntries().end(), [this](auto &entry) { return this->mayReferenceGlobals(entry.second); });
+        else if (auto bitfieldNode = dynamic_cast<ASTNodeBitfield*>(node); bitfieldNode != nullptr)
+            result = std::any_of(bitfieldNode->getEntries().begin(), bitfieldNode->getEntries().end(), [this](auto &entry) { return this->mayReferenceGlobals(entry.second); });
+        else if (auto conditional = dynamic_cast<ASTNodeConditionalStatement*>(node); conditional != nullptr)
+            result = this->mayReferenceGlobals(conditional->getCondition()) || anyOf(conditional->getTrueBody()) || anyOf(conditional->getFalseBody());
+        else if (auto functionCall = dynamic_cast<ASTNodeFunctionCall*>(node); functionCall != nullptr) {
+            // Functions may look up patterns by a name passed as a string
+            result = std::any_of(functionCall->getParams().begin(), functionCall->getParams().end(), [this](auto param) {
+                return dynamic_cast<ASTNodeStringLiteral*>(param) != nullptr || this->mayReferenceGlobals(param);
+            });
+        }
+
+        this->m_globalReferences[node] = result;
+
+        return result;
+    }
+
+    bool Evaluator::canEvaluateConcurrently(ASTNode *node) {
+        ASTNode *placementOffset;
+        if (auto variableDecl = dynamic_cast<ASTNodeVariableDecl*>(node); variableDecl != nullptr)
+            placementOffset = variableDecl->getPlacementOffset();
+        else if (auto arrayDecl = dynamic_cast<ASTNodeArrayVariableDecl*>(node); arrayDecl != nullptr)
+            placementOffset = arrayDecl->getPlacementOffset();
+        else if (auto pointerDecl = dynamic_cast<ASTNodePointerVariableDecl*>(node); pointerDecl != nullptr)
+            placementOffset = pointerDecl->getPlacementOffset();
+        else
+            return false;
+
+        // A placement relative to '$' depends on where the previous variable ended
+        std::function<bool(ASTNode*)> usesCurrentOffset = [&](ASTNode *node) -> bool {
+            if (auto rvalue = dynamic_cast<ASTNodeRValue*>(node); rvalue != nullptr)
+                return rvalue->getPath().size() == 1 && rvalue->getPath()[0] == "$";
+            else if (auto numericExpression = dynamic_cast<ASTNodeNumericExpression*>(node); numericExpression != nullptr)
+                return usesCurrentOffset(numericExpression->getLeftOperand()) || usesCurrentOffset(numericExpression->getRightOperand());
+            else if (auto ternary = dynamic_cast<ASTNodeTernaryExpression*>(node); ternary != nullptr)
+                return usesCurrentOffset(ternary->getFirstOperand()) || usesCurrentOffset(ternary->getSecondOperand()) || usesCurrentOffset(ternary->getThirdOperand());
+            else if (auto functionCall = dynamic_cast<ASTNodeFunctionCall*>(node); functionCall != nullptr)
+                return std::any_of(functionCall->getParams().begin(), functionCall->getParams().end(), usesCurrentOffset);
+            else
+                return false;
+        };
+
+        return placementOffset != nullptr && !usesCurrentOffset(placementOffset) && !this->mayReferenceGlobals(node);
+    }
+
+    void Evaluator::evaluateConcurrently(const std::vector<ASTNode*> &statements) {
+        struct WorkerResult {
+            std::unique_ptr<Evaluator> evaluator;
+            PatternData *pattern = nullptr;
+            std::optional<LogConsole::EvaluateError> error;
+            u32 colorCount = 0;
+        };
+
+        std::vector<WorkerResult> results(statements.size());
+        std::atomic<size_t> nextStatement = 0;
+
+        size_t workerCount = std::min<size_t>(statements.size(), std::thread::hardware_concurrency());
+        while (this->m_workerArenas.size() < workerCount)
+            this->m_workerArenas.push_back(std::make_unique<Arena>());
+
+        std::vector<std::thread> workers;
+        for (size_t i = 0; i < workerCount; i++) {
+            workers.emplace_back([&, &arena = *this->m_workerArenas[i]] {
+                for (size_t index; (index = nextStatement++) < statements.size();) {
+                    auto &result = results[index];
+                    result.evaluator = std::make_unique<Evaluator>(arena);
+
+                    auto &worker = *result.evaluator;
+                    worker.m_parent = this;
+                    worker.m_provider = this->m_provider;
+                    worker.m_types = this->m_types;
+                    worker.copySettings(*this);
+
+                    worker.m_statements.push_back({ statements[index] });
+                    worker.m_currStatement = 0;
+                    worker.m_endianStack.push_back(worker.m_defaultDataEndian);
+
+                    PatternData::placeholderColorCount = &result.colorCount;
+                    try {
+                        result.pattern = worker.evaluateGlobalVariable(statements[index]);
+                    } catch (LogConsole::EvaluateError &e) {
+                        result.error = e;
+                    }
+                    PatternData::placeholderColorCount = nullptr;
+                }
+            });
+        }
+
+        for (auto &worker : workers)
+            worker.join();
+
+        // Merge the results in declaration order, making it look like everything was evaluated one after another
+        constexpr auto PaletteSize = sizeof(PatternData::Palette) / sizeof(u32);
+
+        for (auto &result : results) {
+            auto &worker = *result.evaluator;
+
+            this->m_console.append(worker.m_console);
+            this->m_bytesRead += worker.m_bytesRead;
+            for (const auto &[name, entry] : worker.m_profile) {
+                auto &profile = this->m_profile[name];
+                profile.evaluations += entry.evaluations;
+                profile.time += entry.time;
+                profile.bytesRead += entry.bytesRead;
+                profile.patterns += entry.patterns;
+            }
+
+            if (result.error.has_value())
+                this->getConsole().abortEvaluation(result.error.value());
+
+            auto paletteOffset = SharedData::patternPaletteOffset;
+            assignPaletteColors(result.pattern, paletteOffset);
+            SharedData::patternPaletteOffset = (paletteOffset + result.colorCount) % PaletteSize;
+
+            auto &statement = this->m_statements.emplace_back(std::move(worker.m_statements.front()));
+            statement.paletteOffset = paletteOffset;
+            statement.globalIndex = this->m_globalMembers.size();
+
+            this->m_globalMembers.push_back(result.pattern);
+            this->m_currOffset = worker.m_currOffset;
+        }
+    }
+
+    void Evaluator::assignPaletteColors(PatternData *pattern, u32 paletteOffset) {
+        constexpr auto PaletteSize = sizeof(PatternData::Palette) / sizeof(u32);
+
+        if (auto color = pattern->getColor(); color != 0 && (color & 0xFF00'0000) == 0)
+            pattern->setColor(PatternData::Palette[(paletteOffset + color - 1) % PaletteSize]);
+
+        if (auto structPattern = dynamic_cast<PatternDataStruct*>(pattern); structPattern != nullptr)
+            for (auto member : structPattern->getMembers()) assignPaletteColors(member, paletteOffset);
+        else if (auto unionPattern = dynamic_cast<PatternDataUnion*>(pattern); unionPattern != nullptr)
+            for (auto member : unionPattern->getMembers()) assignPaletteColors(member, paletteOffset);
+        else if (auto arrayPattern = dynamic_cast<PatternDataArray*>(pattern); arrayPattern != nullptr)
+            for (auto entry : arrayPattern->getEntries()) assignPaletteColors(entry, paletteOffset);
+        else if (auto staticArrayPattern = dynamic_cast<PatternDataStaticArray*>(pattern); staticArrayPattern != nullptr)
+            assignPaletteColors(staticArrayPattern->getTemplate(), paletteOffset);
+        else if (auto pointerPattern = dynamic_cast<PatternDataPointer*>(pattern); pointerPattern != nullptr && pointerPattern->getPointedAtPattern() != nullptr)
+            assignPaletteColors(pointerPattern->getPointedAtPattern(), paletteOffset);
+    }
+
+    void Evaluator::copySettings(const Evaluator &other) {
+        this->m_defaultDataEndian = other.m_defaultDataEndian;
+        this->m_patternLimit = other.m_patternLimit;
+        this->m_arrayLimit = other.m_arrayLimit;
+        this->m_evaluationDepth = other.m_evaluationDepth;
+        this->m_profiling = other.m_profiling;
+    }
+
     std::optional<std::vector<PatternData*>> Evaluator::evaluate(const std::vector<ASTNode *> &ast) {
 
         this->m_globalMembers.clear();
         this->m_currMembers.clear();
         this->m_types.clear();
         this->m_endianStack.clear();
+        this->m_sequenceOccurrences.clear();
+        this->m_programs.clear();
+        this->m_nameSlots.clear();
+        this->m_registers.clear();
+        this->m_staticLayouts.clear();
+        this->m_staticLayoutPatterns.clear();
+        this->m_enumValues.clear();
+        this->m_typeNames.clear();
+        this->m_bitfieldFields.clear();
+        this->m_pointedAtPatterns.clear();
+        this->m_statements.clear();
+        this->m_currStatement.reset();
         this->m_currOffset = 0;
+        this->m_readWindow = { };
+        this->m_aborted = false;
+        this->m_createdPatterns = 0;
+        this->m_currDepth = 0;
+        this->m_bytesRead = 0;
+        this->m_profile.clear();
+        this->m_globalNames.clear();
+        this->m_globalReferences.clear();
+
+        for (auto &arena : this->m_workerArenas)
+            arena->clear();
+
+        for (const auto &node : ast) {
+            if (auto variableDecl = dynamic_cast<ASTNodeVariableDecl*>(node); variableDecl != nullptr)
+                this->m_globalNames.emplace(variableDecl->getName());
+            else if (auto arrayDecl = dynamic_cast<ASTNodeArrayVariableDecl*>(node); arrayDecl != nullptr)
+                this->m_globalNames.emplace(arrayDecl->getName());
+            else if (auto pointerDecl = dynamic_cast<ASTNodePointerVariableDecl*>(node); pointerDecl != nullptr)
+                this->m_globalNames.emplace(pointerDecl->getName());
+        }
+
+        SCOPE_EXIT( this->logProfile(); );
+
+        // Isolated evaluations number the colors of their patterns themselves instead of taking them from the shared palette
+        u32 isolatedColorCount = 0;
+        if (this->m_isolated)
+            PatternData::placeholderColorCount = &isolatedColorCount;
+        SCOPE_EXIT(
+            if (this->m_isolated)
+                PatternData::placeholderColorCount = nullptr;
+        );
 
         try {
-            for (const auto& node : ast) {
+            for (size_t i = 0; i < ast.size(); i++) {
+                const auto &node = ast[i];
+
+                // Evaluate runs of placed variables that can't depend on each other concurrently
+                if (!this->m_isolated && std::thread::hardware_concurrency() > 1) {
+                    size_t end = i;
+                    while (end < ast.size() && this->canEvaluateConcurrently(ast[end]))
+                        end++;
+
+                    if (end - i >= 2) {
+                        this->evaluateConcurrently({ ast.begin() + i, ast.begin() + end });
+                        i = end - 1;
+                        continue;
+                    }
+                }
+
                 this->m_endianStack.push_back(this->m_defaultDataEndian);
 
-                if (auto variableDeclNode = dynamic_cast<ASTNodeVariableDecl*>(node); variableDeclNode != nullptr) {
-                    this->m_globalMembers.push_back(this->evaluateVariable(variableDeclNode));
-                } else if (auto arrayDeclNode = dynamic_cast<ASTNodeArrayVariableDecl*>(node); arrayDeclNode != nullptr) {
-                    this->m_globalMembers.push_back(this->evaluateArray(arrayDeclNode));
-                } else if (auto pointerDeclNode = dynamic_cast<ASTNodePointerVariableDecl*>(node); pointerDeclNode != nullptr) {
-                    this->m_globalMembers.push_back(this->evaluatePointer(pointerDeclNode));
+                this->m_statements.push_back({ node });
+                this->m_statements.back().paletteOffset = this->m_isolated ? 0 : SharedData::patternPaletteOffset;
+                this->m_currStatement = this->m_statements.size() - 1;
+
+                if (auto pattern = this->evaluateGlobalVariable(node); pattern != nullptr) {
+                    this->m_statements.back().globalIndex = this->m_globalMembers.size();
+                    this->m_globalMembers.push_back(pattern);
                 } else if (auto typeDeclNode = dynamic_cast<ASTNodeTypeDecl*>(node); typeDeclNode != nullptr) {
                     this->m_types[typeDeclNode->getName().data()] = typeDeclNode->getType();
                 } else if (auto functionCallNode = dynamic_cast<ASTNodeFunctionCall*>(node); functionCallNode != nullptr) {
@@ -770,6 +1560,67 @@ namespace hex::lang {
             }
         } catch (LogConsole::EvaluateError &e) {
             this->getConsole().log(LogConsole::Level::Error, e);
+            this->m_currStatement.reset();
+
+            return { };
+        }
+
+        this->m_currStatement.reset();
+
+        if (this->m_isolated) {
+            for (auto pattern : this->m_globalMembers)
+                assignPaletteColors(pattern, 0);
+        }
+
+        return this->m_globalMembers;
+    }
+
+    std::optional<std::vector<PatternData*>> Evaluator::reevaluate(const std::vector<Region> &changedRegions) {
+        this->m_currMembers.clear();
+        this->m_endianStack.clear();
+        this->m_sequenceOccurrences.clear();
+        this->m_pointedAtPatterns.clear();
+        this->m_readWindow = { };
+        this->m_aborted = false;
+        this->m_createdPatterns = 0;
+        this->m_currDepth = 0;
+
+        // Keep the colors of re-evaluated patterns the same as they were during the full evaluation
+        auto paletteOffset = SharedData::patternPaletteOffset;
+        SCOPE_EXIT(
+            SharedData::patternPaletteOffset = paletteOffset;
+            this->m_currStatement.reset();
+            this->m_endianStack.clear();
+        );
+
+        std::vector<bool> dirtyGlobals(this->m_globalMembers.size(), false);
+
+        try {
+            for (size_t i = 0; i < this->m_statements.size(); i++) {
+                auto &statement = this->m_statements[i];
+
+                if (!this->isAffected(statement, changedRegions, dirtyGlobals))
+                    continue;
+
+                // Anything other than a variable may have had side effects, don't try to repeat them
+                if (!statement.globalIndex.has_value())
+                    return { };
+
+                statement.reads.clear();
+                statement.readsAllData = false;
+                statement.globalReferences.clear();
+
+                SharedData::patternPaletteOffset = statement.paletteOffset;
+                this->m_currStatement = i;
+                this->m_endianStack.push_back(this->m_defaultDataEndian);
+
+                this->m_globalMembers[*statement.globalIndex] = this->evaluateGlobalVariable(statement.node);
+                dirtyGlobals[*statement.globalIndex] = true;
+
+                this->m_endianStack.clear();
+            }
+        } catch (LogConsole::EvaluateError &e) {
+            this->getConsole().log(LogConsole::Level::Error, e);
 
             return { };
         }
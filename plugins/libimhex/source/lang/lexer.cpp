@@ -12,22 +12,17 @@ namespace hex::lang {
 
     Lexer::Lexer() { }
 
-    std::string matchTillInvalid(const char* characters, std::function<bool(char)> predicate) {
-        std::string ret;
+    std::string_view matchTillInvalid(std::string_view characters, std::function<bool(char)> predicate) {
+        size_t length = 1;
 
-        while (*characters != 0x00) {
-            ret += *characters;
-            characters++;
+        while (length < characters.length() && characters[length] != 0x00 && predicate(characters[length]))
+            length++;
 
-            if (!predicate(*characters))
-                break;
-        }
-
-        return ret;
+        return characters.substr(0, length);
     }
 
     size_t getIntegerLiteralLength(std::string_view string) {
-        return string.find_first_not_of("0123456789ABCDEFabcdef.xUL");
+        return std::min(string.find_first_not_of("0123456789ABCDEFabcdef.xUL"), string.length());
     }
 
     std::optional<Token::IntegerLiteral> parseIntegerLiteral(std::string_view string) {
@@ -240,7 +235,16 @@ namespace hex::lang {
         return {{ c, charSize + 2 }};
     }
 
-    std::optional<std::vector<Token>> Lexer::lex(const std::string& code) {
+    std::string_view Lexer::intern(std::string_view symbol) {
+        if (auto it = this->m_symbols.find(symbol); it != this->m_symbols.end())
+            return *it;
+
+        return *this->m_symbols.emplace(symbol).first;
+    }
+
+    std::optional<std::vector<Token>> Lexer::lex(std::string_view code) {
+        this->m_symbols.clear();
+
         std::vector<Token> tokens;
         u32 offset = 0;
 
@@ -383,10 +387,10 @@ namespace hex::lang {
 
                     auto [s, stringSize] = string.value();
 
-                    tokens.emplace_back(VALUE_TOKEN(String, s));
+                    tokens.emplace_back(VALUE_TOKEN(String, this->intern(s)));
                     offset += stringSize;
                 } else if (std::isalpha(c)) {
-                    std::string identifier = matchTillInvalid(&code[offset], [](char c) -> bool { return std::isalnum(c) || c == '_'; });
+                    auto identifier = matchTillInvalid(code.substr(offset), [](char c) -> bool { return std::isalnum(c) || c == '_'; });
 
                     // Check for reserved keywords
 
@@ -448,18 +452,18 @@ namespace hex::lang {
                     // If it's not a keyword and a builtin type, it has to be an identifier
 
                     else
-                        tokens.emplace_back(VALUE_TOKEN(Identifier, identifier));
+                        tokens.emplace_back(VALUE_TOKEN(Identifier, this->intern(identifier)));
 
                     offset += identifier.length();
                 } else if (std::isdigit(c)) {
-                    auto integer = parseIntegerLiteral(&code[offset]);
+                    auto integer = parseIntegerLiteral(code.substr(offset));
 
                     if (!integer.has_value())
                         throwLexerError("invalid integer literal", lineNumber);
 
 
                     tokens.emplace_back(VALUE_TOKEN(Integer, integer.value()));
-                    offset += getIntegerLiteralLength(&code[offset]);
+                    offset += getIntegerLiteralLength(code.substr(offset));
                 } else
                     throwLexerError("unknown token", lineNumber);
 
@@ -5,7 +5,7 @@
 
 #define MATCHES(x) (begin() && x)
 
-#define TO_NUMERIC_EXPRESSION(node) new ASTNodeNumericExpression((node), new ASTNodeIntegerLiteral({ Token::ValueType::Any, s32(0) }), Token::Operator::Plus)
+#define TO_NUMERIC_EXPRESSION(node) this->create<ASTNodeNumericExpression>((node), this->create<ASTNodeIntegerLiteral>(Token::IntegerLiteral(Token::ValueType::Any, s32(0))), Token::Operator::Plus)
 
 // Definition syntax:
 // [A]          : Either A or no token
@@ -20,12 +20,8 @@ namespace hex::lang {
 
     // Identifier([(parseMathematicalExpression)|<(parseMathematicalExpression),...>(parseMathematicalExpression)]
     ASTNode* Parser::parseFunctionCall() {
-        auto functionName = getValue<std::string>(-2);
+        auto functionName = getString(-2);
         std::vector<ASTNode*> params;
-        ScopeExit paramCleanup([&]{
-            for (auto &param : params)
-                delete param;
-        });
 
         while (!MATCHES(sequence(SEPARATOR_ROUNDBRACKETCLOSE))) {
             if (MATCHES(sequence(STRING)))
@@ -42,19 +38,17 @@ namespace hex::lang {
 
         }
 
-        paramCleanup.release();
-
-        return new ASTNodeFunctionCall(functionName, params);
+        return this->create<ASTNodeFunctionCall>(functionName, params);
     }
 
     ASTNode* Parser::parseStringLiteral() {
-        return new ASTNodeStringLiteral(getValue<std::string>(-1));
+        return this->create<ASTNodeStringLiteral>(getString(-1));
     }
 
     // Identifier::<Identifier[::]...>
     ASTNode* Parser::parseScopeResolution(std::vector<std::string> &path) {
         if (peek(IDENTIFIER, -1))
-            path.push_back(getValue<std::string>(-1));
+            path.push_back(getString(-1));
 
         if (MATCHES(sequence(SEPARATOR_SCOPE_RESOLUTION))) {
             if (MATCHES(sequence(IDENTIFIER)))
@@ -62,13 +56,13 @@ namespace hex::lang {
             else
                 throwParseError("expected member name", -1);
         } else
-            return TO_NUMERIC_EXPRESSION(new ASTNodeScopeResolution(path));
+            return TO_NUMERIC_EXPRESSION(this->create<ASTNodeScopeResolution>(path));
     }
 
     // <Identifier[.]...>
     ASTNode* Parser::parseRValue(std::vector<std::string> &path) {
         if (peek(IDENTIFIER, -1))
-            path.push_back(getValue<std::string>(-1));
+            path.push_back(getString(-1));
 
         if (MATCHES(sequence(SEPARATOR_DOT))) {
             if (MATCHES(sequence(IDENTIFIER)))
@@ -76,13 +70,13 @@ namespace hex::lang {
             else
                 throwParseError("expected member name", -1);
         } else
-            return TO_NUMERIC_EXPRESSION(new ASTNodeRValue(path));
+            return TO_NUMERIC_EXPRESSION(this->create<ASTNodeRValue>(path));
     }
 
     // <Integer|((parseMathematicalExpression))>
     ASTNode* Parser::parseFactor() {
         if (MATCHES(sequence(INTEGER)))
-            return TO_NUMERIC_EXPRESSION(new ASTNodeIntegerLiteral(getValue<Token::IntegerLiteral>(-1)));
+            return TO_NUMERIC_EXPRESSION(this->create<ASTNodeIntegerLiteral>(getValue<Token::IntegerLiteral>(-1)));
         else if (MATCHES(sequence(SEPARATOR_ROUNDBRACKETOPEN))) {
             auto node = this->parseMathematicalExpression();
             if (!MATCHES(sequence(SEPARATOR_ROUNDBRACKETCLOSE)))
@@ -98,7 +92,7 @@ namespace hex::lang {
             std::vector<std::string> path;
             return this->parseRValue(path);
         } else if (MATCHES(sequence(OPERATOR_DOLLAR))) {
-            return new ASTNodeRValue({ "$" });
+            return this->create<ASTNodeRValue>(std::vector<std::string>{ "$" });
         } else
             throwParseError("expected integer or parenthesis");
     }
@@ -108,7 +102,7 @@ namespace hex::lang {
         if (MATCHES(oneOf(OPERATOR_PLUS, OPERATOR_MINUS, OPERATOR_BOOLNOT, OPERATOR_BITNOT))) {
             auto op = getValue<Token::Operator>(-1);
 
-            return new ASTNodeNumericExpression(new ASTNodeIntegerLiteral({ Token::ValueType::Any, 0 }), this->parseFactor(), op);
+            return this->create<ASTNodeNumericExpression>(this->create<ASTNodeIntegerLiteral>(Token::IntegerLiteral(Token::ValueType::Any, 0)), this->parseFactor(), op);
         }
 
         return this->parseFactor();
@@ -118,15 +112,11 @@ namespace hex::lang {
     ASTNode* Parser::parseMultiplicativeExpression() {
         auto node = this->parseUnaryExpression();
 
-        ScopeExit nodeCleanup([&]{ delete node; });
-
         while (MATCHES(oneOf(OPERATOR_STAR, OPERATOR_SLASH, OPERATOR_PERCENT))) {
             auto op = getValue<Token::Operator>(-1);
-            node = new ASTNodeNumericExpression(node, this->parseUnaryExpression(), op);
+            node = this->create<ASTNodeNumericExpression>(node, this->parseUnaryExpression(), op);
         }
 
-        nodeCleanup.release();
-
         return node;
     }
 
@@ -134,15 +124,11 @@ namespace hex::lang {
     ASTNode* Parser::parseAdditiveExpression() {
         auto node = this->parseMultiplicativeExpression();
 
-        ScopeExit nodeCleanup([&]{ delete node; });
-
         while (MATCHES(variant(OPERATOR_PLUS, OPERATOR_MINUS))) {
             auto op = getValue<Token::Operator>(-1);
-            node = new ASTNodeNumericExpression(node, this->parseMultiplicativeExpression(), op);
+            node = this->create<ASTNodeNumericExpression>(node, this->parseMultiplicativeExpression(), op);
         }
 
-        nodeCleanup.release();
-
         return node;
     }
 
@@ -150,15 +136,11 @@ namespace hex::lang {
     ASTNode* Parser::parseShiftExpression() {
         auto node = this->parseAdditiveExpression();
 
-        ScopeExit nodeCleanup([&]{ delete node; });
-
         while (MATCHES(variant(OPERATOR_SHIFTLEFT, OPERATOR_SHIFTRIGHT))) {
             auto op = getValue<Token::Operator>(-1);
-            node = new ASTNodeNumericExpression(node, this->parseAdditiveExpression(), op);
+            node = this->create<ASTNodeNumericExpression>(node, this->parseAdditiveExpression(), op);
         }
 
-        nodeCleanup.release();
-
         return node;
     }
 
@@ -166,15 +148,11 @@ namespace hex::lang {
     ASTNode* Parser::parseRelationExpression() {
         auto node = this->parseShiftExpression();
 
-        ScopeExit nodeCleanup([&]{ delete node; });
-
         while (MATCHES(sequence(OPERATOR_BOOLGREATERTHAN) || sequence(OPERATOR_BOOLLESSTHAN) || sequence(OPERATOR_BOOLGREATERTHANOREQUALS) || sequence(OPERATOR_BOOLLESSTHANOREQUALS))) {
             auto op = getValue<Token::Operator>(-1);
-            node = new ASTNodeNumericExpression(node, this->parseShiftExpression(), op);
+            node = this->create<ASTNodeNumericExpression>(node, this->parseShiftExpression(), op);
         }
 
-        nodeCleanup.release();
-
         return node;
     }
 
@@ -182,15 +160,11 @@ namespace hex::lang {
     ASTNode* Parser::parseEqualityExpression() {
         auto node = this->parseRelationExpression();
 
-        ScopeExit nodeCleanup([&]{ delete node; });
-
         while (MATCHES(sequence(OPERATOR_BOOLEQUALS) || sequence(OPERATOR_BOOLNOTEQUALS))) {
             auto op = getValue<Token::Operator>(-1);
-            node = new ASTNodeNumericExpression(node, this->parseRelationExpression(), op);
+            node = this->create<ASTNodeNumericExpression>(node, this->parseRelationExpression(), op);
         }
 
-        nodeCleanup.release();
-
         return node;
     }
 
@@ -198,14 +172,10 @@ namespace hex::lang {
     ASTNode* Parser::parseBinaryAndExpression() {
         auto node = this->parseEqualityExpression();
 
-        ScopeExit nodeCleanup([&]{ delete node; });
-
         while (MATCHES(sequence(OPERATOR_BITAND))) {
-            node = new ASTNodeNumericExpression(node, this->parseEqualityExpression(), Token::Operator::BitAnd);
+            node = this->create<ASTNodeNumericExpression>(node, this->parseEqualityExpression(), Token::Operator::BitAnd);
         }
 
-        nodeCleanup.release();
-
         return node;
     }
 
@@ -213,14 +183,10 @@ namespace hex::lang {
     ASTNode* Parser::parseBinaryXorExpression() {
         auto node = this->parseBinaryAndExpression();
 
-        ScopeExit nodeCleanup([&]{ delete node; });
-
         while (MATCHES(sequence(OPERATOR_BITXOR))) {
-            node = new ASTNodeNumericExpression(node, this->parseBinaryAndExpression(), Token::Operator::BitXor);
+            node = this->create<ASTNodeNumericExpression>(node, this->parseBinaryAndExpression(), Token::Operator::BitXor);
         }
 
-        nodeCleanup.release();
-
         return node;
     }
 
@@ -228,14 +194,10 @@ namespace hex::lang {
     ASTNode* Parser::parseBinaryOrExpression() {
         auto node = this->parseBinaryXorExpression();
 
-        ScopeExit nodeCleanup([&]{ delete node; });
-
         while (MATCHES(sequence(OPERATOR_BITOR))) {
-            node = new ASTNodeNumericExpression(node, this->parseBinaryXorExpression(), Token::Operator::BitOr);
+            node = this->create<ASTNodeNumericExpression>(node, this->parseBinaryXorExpression(), Token::Operator::BitOr);
         }
 
-        nodeCleanup.release();
-
         return node;
     }
 
@@ -243,14 +205,10 @@ namespace hex::lang {
     ASTNode* Parser::parseBooleanAnd() {
         auto node = this->parseBinaryOrExpression();
 
-        ScopeExit nodeCleanup([&]{ delete node; });
-
         while (MATCHES(sequence(OPERATOR_BOOLAND))) {
-            node = new ASTNodeNumericExpression(node, this->parseBinaryOrExpression(), Token::Operator::BitOr);
+            node = this->create<ASTNodeNumericExpression>(node, this->parseBinaryOrExpression(), Token::Operator::BitOr);
         }
 
-        nodeCleanup.release();
-
         return node;
     }
 
@@ -258,14 +216,10 @@ namespace hex::lang {
     ASTNode* Parser::parseBooleanXor() {
         auto node = this->parseBooleanAnd();
 
-        ScopeExit nodeCleanup([&]{ delete node; });
-
         while (MATCHES(sequence(OPERATOR_BOOLXOR))) {
-            node = new ASTNodeNumericExpression(node, this->parseBooleanAnd(), Token::Operator::BitOr);
+            node = this->create<ASTNodeNumericExpression>(node, this->parseBooleanAnd(), Token::Operator::BitOr);
         }
 
-        nodeCleanup.release();
-
         return node;
     }
 
@@ -273,14 +227,10 @@ namespace hex::lang {
     ASTNode* Parser::parseBooleanOr() {
         auto node = this->parseBooleanXor();
 
-        ScopeExit nodeCleanup([&]{ delete node; });
-
         while (MATCHES(sequence(OPERATOR_BOOLOR))) {
-            node = new ASTNodeNumericExpression(node, this->parseBooleanXor(), Token::Operator::BitOr);
+            node = this->create<ASTNodeNumericExpression>(node, this->parseBooleanXor(), Token::Operator::BitOr);
         }
 
-        nodeCleanup.release();
-
         return node;
     }
 
@@ -288,8 +238,6 @@ namespace hex::lang {
     ASTNode* Parser::parseTernaryConditional() {
         auto node = this->parseBooleanOr();
 
-        ScopeExit nodeCleanup([&]{ delete node; });
-
         while (MATCHES(sequence(OPERATOR_TERNARYCONDITIONAL))) {
             auto second = this->parseBooleanOr();
 
@@ -297,11 +245,9 @@ namespace hex::lang {
                 throwParseError("expected ':' in ternary expression");
 
             auto third = this->parseBooleanOr();
-            node = new ASTNodeTernaryExpression(node, second, third, Token::Operator::TernaryConditional);
+            node = this->create<ASTNodeTernaryExpression>(node, second, third, Token::Operator::TernaryConditional);
         }
 
-        nodeCleanup.release();
-
         return node;
     }
 
@@ -319,14 +265,14 @@ namespace hex::lang {
             if (!MATCHES(sequence(IDENTIFIER)))
                 throwParseError("expected attribute expression");
 
-            auto attribute = this->getValue<std::string>(-1);
+            auto attribute = this->getString(-1);
 
             if (MATCHES(sequence(SEPARATOR_ROUNDBRACKETOPEN, STRING, SEPARATOR_ROUNDBRACKETCLOSE))) {
-                auto value = this->getValue<std::string>(-2);
-                currNode->addAttribute(new ASTNodeAttribute(attribute, value));
+                auto value = this->getString(-2);
+                currNode->addAttribute(this->create<ASTNodeAttribute>(attribute, value));
             }
             else
-                currNode->addAttribute(new ASTNodeAttribute(attribute));
+                currNode->addAttribute(this->create<ASTNodeAttribute>(attribute));
 
         } while (MATCHES(sequence(SEPARATOR_COMMA)));
 
@@ -341,14 +287,6 @@ namespace hex::lang {
         auto condition = parseMathematicalExpression();
         std::vector<ASTNode*> trueBody, falseBody;
 
-        ScopeExit cleanup([&]{
-            delete condition;
-            for (auto &statement : trueBody)
-                delete statement;
-            for (auto &statement : falseBody)
-                delete statement;
-        });
-
         if (MATCHES(sequence(SEPARATOR_ROUNDBRACKETCLOSE, SEPARATOR_CURLYBRACKETOPEN))) {
             while (!MATCHES(sequence(SEPARATOR_CURLYBRACKETCLOSE))) {
                 trueBody.push_back(parseMember());
@@ -366,9 +304,7 @@ namespace hex::lang {
             falseBody.push_back(parseMember());
         }
 
-        cleanup.release();
-
-        return new ASTNodeConditionalStatement(condition, trueBody, falseBody);
+        return this->create<ASTNodeConditionalStatement>(condition, trueBody, falseBody);
     }
 
     /* Type declarations */
@@ -383,13 +319,13 @@ namespace hex::lang {
             endian = std::endian::big;
 
         if (getType(startIndex) == Token::Type::Identifier) { // Custom type
-            if (!this->m_types.contains(getValue<std::string>(startIndex)))
+            if (!this->m_types.contains(getIdentifier(startIndex)))
                 throwParseError("failed to parse type");
 
-            return new ASTNodeTypeDecl({ }, this->m_types[getValue<std::string>(startIndex)]->clone(), endian);
+            return this->create<ASTNodeTypeDecl>("", this->m_types[getIdentifier(startIndex)], endian);
         }
         else { // Builtin type
-            return new ASTNodeTypeDecl({ }, new ASTNodeBuiltinType(getValue<Token::ValueType>(startIndex)), endian);
+            return this->create<ASTNodeTypeDecl>("", this->create<ASTNodeBuiltinType>(getValue<Token::ValueType>(startIndex)), endian);
         }
     }
 
@@ -399,40 +335,39 @@ namespace hex::lang {
         if (type == nullptr) throwParseError("invalid type used in variable declaration", -1);
 
         if (peekOptional(KEYWORD_BE) || peekOptional(KEYWORD_LE))
-            return new ASTNodeTypeDecl(getValue<std::string>(-4), type, type->getEndian());
+            return this->create<ASTNodeTypeDecl>(getIdentifier(-4), type, type->getEndian());
         else
-            return new ASTNodeTypeDecl(getValue<std::string>(-3), type, type->getEndian());
+            return this->create<ASTNodeTypeDecl>(getIdentifier(-3), type, type->getEndian());
     }
 
     // padding[(parseMathematicalExpression)]
     ASTNode* Parser::parsePadding() {
         auto size = parseMathematicalExpression();
 
-        if (!MATCHES(sequence(SEPARATOR_SQUAREBRACKETCLOSE))) {
-            delete size;
+        if (!MATCHES(sequence(SEPARATOR_SQUAREBRACKETCLOSE)))
             throwParseError("expected closing ']' at end of array declaration", -1);
-        }
 
-        return new ASTNodeArrayVariableDecl({ }, new ASTNodeTypeDecl({ }, new ASTNodeBuiltinType(Token::ValueType::Padding)), size);;
+        return this->create<ASTNodeArrayVariableDecl>("", this->create<ASTNodeTypeDecl>("", this->create<ASTNodeBuiltinType>(Token::ValueType::Padding)), size);
     }
 
     // (parseType) Identifier
     ASTNode* Parser::parseMemberVariable() {
         auto type = dynamic_cast<ASTNodeTypeDecl *>(parseType(-2));
         if (type == nullptr) throwParseError("invalid type used in variable declaration", -1);
+        if (type->getType() == this->m_currTypeDecl) throwParseError("type cannot contain itself, only point to itself", -2);
 
-        return new ASTNodeVariableDecl(getValue<std::string>(-1), type);
+        return this->create<ASTNodeVariableDecl>(getIdentifier(-1), type);
     }
 
     // (parseType) Identifier[(parseMathematicalExpression)]
     ASTNode* Parser::parseMemberArrayVariable() {
         auto type = dynamic_cast<ASTNodeTypeDecl *>(parseType(-3));
         if (type == nullptr) throwParseError("invalid type used in variable declaration", -1);
+        if (type->getType() == this->m_currTypeDecl) throwParseError("type cannot contain itself, only point to itself", -3);
 
-        auto name = getValue<std::string>(-2);
+        auto name = getIdentifier(-2);
 
         ASTNode *size = nullptr;
-        ScopeExit sizeCleanup([&]{ delete size; });
 
         if (!MATCHES(sequence(SEPARATOR_SQUAREBRACKETCLOSE))) {
             size = parseMathematicalExpression();
@@ -441,14 +376,12 @@ namespace hex::lang {
                 throwParseError("expected closing ']' at end of array declaration", -1);
         }
 
-        sizeCleanup.release();
-
-        return new ASTNodeArrayVariableDecl(name, type, size);
+        return this->create<ASTNodeArrayVariableDecl>(name, type, size);
     }
 
     // (parseType) *Identifier : (parseType)
     ASTNode* Parser::parseMemberPointerVariable() {
-        auto name = getValue<std::string>(-2);
+        auto name = getIdentifier(-2);
 
         auto pointerType = dynamic_cast<ASTNodeTypeDecl *>(parseType(-4));
         if (pointerType == nullptr) throwParseError("invalid type used in variable declaration", -1);
@@ -459,7 +392,7 @@ namespace hex::lang {
         auto sizeType = dynamic_cast<ASTNodeTypeDecl *>(parseType(-1));
         if (sizeType == nullptr) throwParseError("invalid type used for pointer size", -1);
 
-        return new ASTNodePointerVariableDecl(name, pointerType, sizeType);
+        return this->create<ASTNodePointerVariableDecl>(name, pointerType, sizeType);
     }
 
     // [(parsePadding)|(parseMemberVariable)|(parseMemberArrayVariable)|(parseMemberPointerVariable)]
@@ -492,53 +425,61 @@ namespace hex::lang {
 
     // struct Identifier { <(parseMember)...> }
     ASTNode* Parser::parseStruct() {
-        const auto structNode = new ASTNodeStruct();
-        const auto &typeName = getValue<std::string>(-2);
-        ScopeExit structGuard([&]{ delete structNode; });
+        const auto structNode = this->create<ASTNodeStruct>();
+        auto typeName = getIdentifier(-2);
+
+        // The type is known while its members get parsed already, so they can point to it
+        const auto typeDecl = this->create<ASTNodeTypeDecl>(typeName, structNode);
+        this->m_types.insert({ typeName, typeDecl });
+        this->m_currTypeDecl = typeDecl;
+        SCOPE_EXIT( this->m_currTypeDecl = nullptr; );
 
         while (!MATCHES(sequence(SEPARATOR_CURLYBRACKETCLOSE))) {
             structNode->addMember(parseMember());
         }
 
-        structGuard.release();
-
-        return new ASTNodeTypeDecl(typeName, structNode);
+        return typeDecl;
     }
 
     // union Identifier { <(parseMember)...> }
     ASTNode* Parser::parseUnion() {
-        const auto unionNode = new ASTNodeUnion();
-        const auto &typeName = getValue<std::string>(-2);
-        ScopeExit unionGuard([&]{ delete unionNode; });
+        const auto unionNode = this->create<ASTNodeUnion>();
+        auto typeName = getIdentifier(-2);
+
+        // The type is known while its members get parsed already, so they can point to it
+        const auto typeDecl = this->create<ASTNodeTypeDecl>(typeName, unionNode);
+        this->m_types.insert({ typeName, typeDecl });
+        this->m_currTypeDecl = typeDecl;
+        SCOPE_EXIT( this->m_currTypeDecl = nullptr; );
 
         while (!MATCHES(sequence(SEPARATOR_CURLYBRACKETCLOSE))) {
             unionNode->addMember(parseMember());
         }
 
-        unionGuard.release();
-
-        return new ASTNodeTypeDecl(typeName, unionNode);
+        return typeDecl;
     }
 
     // enum Identifier : (parseType) { <<Identifier|Identifier = (parseMathematicalExpression)[,]>...> }
     ASTNode* Parser::parseEnum() {
-        std::string typeName;
+        std::string_view typeName;
         if (peekOptional(KEYWORD_BE) || peekOptional(KEYWORD_LE))
-            typeName = getValue<std::string>(-5);
+            typeName = getIdentifier(-5);
         else
-            typeName = getValue<std::string>(-4);
+            typeName = getIdentifier(-4);
 
         auto underlyingType = dynamic_cast<ASTNodeTypeDecl*>(parseType(-2));
         if (underlyingType == nullptr) throwParseError("failed to parse type", -2);
         if (underlyingType->getEndian().has_value()) throwParseError("underlying type may not have an endian specification", -2);
 
-        const auto enumNode = new ASTNodeEnum(underlyingType);
-        ScopeExit enumGuard([&]{ delete enumNode; });
+        const auto enumNode = this->create<ASTNodeEnum>(underlyingType);
 
         ASTNode *lastEntry = nullptr;
         while (!MATCHES(sequence(SEPARATOR_CURLYBRACKETCLOSE))) {
             if (MATCHES(sequence(IDENTIFIER, OPERATOR_ASSIGNMENT))) {
-                auto name = getValue<std::string>(-2);
+                auto name = getString(-2);
+                if (enumNode->getEntries().contains(name))
+                    throwParseError(hex::format("redefinition of enum constant '{0}'", name), -2);
+
                 auto value = parseMathematicalExpression();
 
                 enumNode->addEntry(name, value);
@@ -546,11 +487,14 @@ namespace hex::lang {
             }
             else if (MATCHES(sequence(IDENTIFIER))) {
                 ASTNode *valueExpr;
-                auto name = getValue<std::string>(-1);
+                auto name = getString(-1);
+                if (enumNode->getEntries().contains(name))
+                    throwParseError(hex::format("redefinition of enum constant '{0}'", name), -1);
+
                 if (enumNode->getEntries().empty())
-                    valueExpr = lastEntry = TO_NUMERIC_EXPRESSION(new ASTNodeIntegerLiteral({ Token::ValueType::Unsigned8Bit, u8(0) }));
+                    valueExpr = lastEntry = TO_NUMERIC_EXPRESSION(this->create<ASTNodeIntegerLiteral>(Token::IntegerLiteral(Token::ValueType::Unsigned8Bit, u8(0))));
                 else
-                    valueExpr = new ASTNodeNumericExpression(lastEntry->clone(), new ASTNodeIntegerLiteral({ Token::ValueType::Any, s32(1) }), Token::Operator::Plus);
+                    valueExpr = this->create<ASTNodeNumericExpression>(lastEntry, this->create<ASTNodeIntegerLiteral>(Token::IntegerLiteral(Token::ValueType::Any, s32(1))), Token::Operator::Plus);
 
                 enumNode->addEntry(name, valueExpr);
             }
@@ -567,21 +511,18 @@ namespace hex::lang {
             }
         }
 
-        enumGuard.release();
-
-        return new ASTNodeTypeDecl(typeName, enumNode);
+        return this->create<ASTNodeTypeDecl>(typeName, enumNode);
     }
 
     // bitfield Identifier { <Identifier : (parseMathematicalExpression)[;]...> }
     ASTNode* Parser::parseBitfield() {
-        std::string typeName = getValue<std::string>(-2);
+        auto typeName = getIdentifier(-2);
 
-        const auto bitfieldNode = new ASTNodeBitfield();
-        ScopeExit enumGuard([&]{ delete bitfieldNode; });
+        const auto bitfieldNode = this->create<ASTNodeBitfield>();
 
         while (!MATCHES(sequence(SEPARATOR_CURLYBRACKETCLOSE))) {
             if (MATCHES(sequence(IDENTIFIER, OPERATOR_INHERIT))) {
-                auto name = getValue<std::string>(-2);
+                auto name = getString(-2);
                 bitfieldNode->addEntry(name, parseMathematicalExpression());
             }
             else if (MATCHES(sequence(SEPARATOR_ENDOFPROGRAM)))
@@ -594,9 +535,7 @@ namespace hex::lang {
             }
         }
 
-        enumGuard.release();
-
-        return new ASTNodeTypeDecl(typeName, bitfieldNode);
+        return this->create<ASTNodeTypeDecl>(typeName, bitfieldNode);
     }
 
     // (parseType) Identifier @ Integer
@@ -604,7 +543,9 @@ namespace hex::lang {
         auto type = dynamic_cast<ASTNodeTypeDecl *>(parseType(-3));
         if (type == nullptr) throwParseError("invalid type used in variable declaration", -1);
 
-        return new ASTNodeVariableDecl(getValue<std::string>(-2), type, parseMathematicalExpression());
+        auto name = getIdentifier(-2);
+
+        return this->create<ASTNodeVariableDecl>(name, type, parseMathematicalExpression());
     }
 
     // (parseType) Identifier[[(parseMathematicalExpression)]] @ Integer
@@ -612,10 +553,9 @@ namespace hex::lang {
         auto type = dynamic_cast<ASTNodeTypeDecl *>(parseType(-3));
         if (type == nullptr) throwParseError("invalid type used in variable declaration", -1);
 
-        auto name = getValue<std::string>(-2);
+        auto name = getIdentifier(-2);
 
         ASTNode *size = nullptr;
-        ScopeExit sizeCleanup([&]{ delete size; });
 
         if (!MATCHES(sequence(SEPARATOR_SQUAREBRACKETCLOSE))) {
             size = parseMathematicalExpression();
@@ -627,14 +567,12 @@ namespace hex::lang {
         if (!MATCHES(sequence(OPERATOR_AT)))
             throwParseError("expected placement instruction", -1);
 
-        sizeCleanup.release();
-
-        return new ASTNodeArrayVariableDecl(name, type, size, parseMathematicalExpression());
+        return this->create<ASTNodeArrayVariableDecl>(name, type, size, parseMathematicalExpression());
     }
 
     // (parseType) *Identifier : (parseType) @ Integer
     ASTNode* Parser::parsePointerVariablePlacement() {
-        auto name = getValue<std::string>(-2);
+        auto name = getIdentifier(-2);
 
         auto temporaryPointerType = dynamic_cast<ASTNodeTypeDecl *>(parseType(-4));
         if (temporaryPointerType == nullptr) throwParseError("invalid type used in variable declaration", -1);
@@ -648,7 +586,7 @@ namespace hex::lang {
         if (!MATCHES(sequence(OPERATOR_AT)))
             throwParseError("expected placement instruction", -1);
 
-        return new ASTNodePointerVariableDecl(name, temporaryPointerType, temporaryPointerSizeType, parseMathematicalExpression());
+        return this->create<ASTNodePointerVariableDecl>(name, temporaryPointerType, temporaryPointerSizeType, parseMathematicalExpression());
     }
 
 
@@ -686,7 +624,7 @@ namespace hex::lang {
             throwParseError("missing ';' at end of expression", -1);
 
         if (auto typeDecl = dynamic_cast<ASTNodeTypeDecl*>(statement); typeDecl != nullptr)
-            this->m_types.insert({ typeDecl->getName().data(), typeDecl });
+            this->m_types.insert({ typeDecl->getName(), typeDecl });
 
         return statement;
     }
@@ -0,0 +1,567 @@
+#include <hex/lang/pattern_exporter.hpp>
+
+#include <hex/helpers/utils.hpp>
+#include <hex/lang/pattern_data.hpp>
+#include <hex/providers/provider.hpp>
+
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <optional>
+
+namespace hex::lang {
+
+    namespace {
+
+        enum class RecordKind : u8 {
+            Name,
+            Begin,
+            End,
+            Value
+        };
+
+        constexpr char BinaryMagic[] = { 'I', 'M', 'H', 'X', 'P', 'A', 'T', '\0' };
+        constexpr u8 BinaryVersion = 1;
+
+        using ValueKind = PatternExporter::ValueKind;
+
+        std::optional<ValueKind> getValueKind(PatternData *pattern) {
+            if (dynamic_cast<PatternDataUnsigned*>(pattern) != nullptr)         return ValueKind::Unsigned;
+            else if (dynamic_cast<PatternDataSigned*>(pattern) != nullptr)      return ValueKind::Signed;
+            else if (dynamic_cast<PatternDataFloat*>(pattern) != nullptr)       return ValueKind::Float;
+            else if (dynamic_cast<PatternDataBoolean*>(pattern) != nullptr)     return ValueKind::Boolean;
+            else if (dynamic_cast<PatternDataCharacter*>(pattern) != nullptr)   return ValueKind::Character;
+            else if (dynamic_cast<PatternDataString*>(pattern) != nullptr)      return ValueKind::String;
+            else if (dynamic_cast<PatternDataEnum*>(pattern) != nullptr)        return ValueKind::Enum;
+            else                                                                return std::nullopt;
+        }
+
+        /* Kinds whose bytes are a number in the pattern's endianess */
+        bool isNumeric(ValueKind kind) {
+            return kind != ValueKind::Boolean && kind != ValueKind::Character && kind != ValueKind::String;
+        }
+
+        void appendNumber(std::string &output, u64 value) {
+            char buffer[20];
+            auto result = std::to_chars(std::begin(buffer), std::end(buffer), value);
+            output.append(buffer, result.ptr);
+        }
+
+        void appendNumber(std::string &output, s64 value) {
+            char buffer[20];
+            auto result = std::to_chars(std::begin(buffer), std::end(buffer), value);
+            output.append(buffer, result.ptr);
+        }
+
+        /* Bytes outside of printable ASCII are escaped one by one, so data that isn't valid UTF-8 still makes valid JSON */
+        void appendJSONString(std::string &output, std::string_view value) {
+            output += '"';
+            for (char c : value) {
+                switch (c) {
+                    case '"':   output += "\\\""; break;
+                    case '\\':  output += "\\\\"; break;
+                    case '\n':  output += "\\n"; break;
+                    case '\r':  output += "\\r"; break;
+                    case '\t':  output += "\\t"; break;
+                    default:
+                        if (u8(c) < 0x20 || u8(c) >= 0x7F)
+                            output += hex::format("\\u{:04x}", u8(c));
+                        else
+                            output += c;
+                }
+            }
+            output += '"';
+        }
+
+        void appendCSVString(std::string &output, std::string_view value) {
+            if (value.find_first_of(",\"\r\n") == std::string_view::npos) {
+                output += value;
+                return;
+            }
+
+            output += '"';
+            for (char c : value) {
+                if (c == '"')
+                    output += '"';
+                output += c;
+            }
+            output += '"';
+        }
+
+        /* Numbers too big for a u64 are written as hex, their bytes are in native endianess already */
+        void appendHexNumber(std::string &output, const u8 *data, u64 size) {
+            output += "0x";
+            for (u64 i = size; i > 0; i--)
+                output += hex::format("{:02X}", data[i - 1]);
+        }
+
+    }
+
+    PatternExporter::PatternExporter(prv::Provider *provider, Format format, Writer writer)
+        : m_provider(provider), m_format(format), m_writer(std::move(writer)) {
+    }
+
+    bool PatternExporter::exportPatterns(const std::vector<PatternData*> &patterns, const std::atomic<bool> &cancelled) {
+        this->m_cancelled = &cancelled;
+        this->m_stopped = false;
+        this->m_buffer.clear();
+        this->m_path.clear();
+        this->m_nameIds.clear();
+
+        switch (this->m_format) {
+            case Format::JSONLines:
+                for (auto pattern : patterns)
+                    this->walk(pattern, pattern->getVariableName(), false, 0);
+                break;
+            case Format::CSV:
+                if (patterns.size() == 1)
+                    this->writeCSV(patterns.front());
+                break;
+            case Format::Binary:
+                this->m_buffer.append(BinaryMagic, sizeof(BinaryMagic));
+                this->m_buffer += char(BinaryVersion);
+
+                for (auto pattern : patterns)
+                    this->walk(pattern, pattern->getVariableName(), false, 0);
+                break;
+        }
+
+        this->flush();
+
+        return !this->m_stopped;
+    }
+
+    PatternData* PatternExporter::findPattern(const std::vector<PatternData*> &patterns, std::string_view path) {
+        const std::vector<PatternData*> *members = &patterns;
+
+        while (members != nullptr) {
+            auto end = std::min(path.find('.'), path.size());
+            auto name = path.substr(0, end);
+
+            auto it = std::find_if(members->begin(), members->end(), [&](auto pattern) { return pattern->getVariableName() == name; });
+            if (it == members->end())
+                return nullptr;
+
+            if (end == path.size())
+                return *it;
+
+            path.remove_prefix(end + 1);
+
+            if (auto structPattern = dynamic_cast<PatternDataStruct*>(*it); structPattern != nullptr)
+                members = &structPattern->getMembers();
+            else if (auto unionPattern = dynamic_cast<PatternDataUnion*>(*it); unionPattern != nullptr)
+                members = &unionPattern->getMembers();
+            else
+                members = nullptr;
+        }
+
+        return nullptr;
+    }
+
+    void PatternExporter::walk(PatternData *pattern, std::string_view name, bool arrayEntry, u64 index) {
+        if (this->m_stopped || *this->m_cancelled) {
+            this->m_stopped = true;
+            return;
+        }
+
+        if (pattern->isHidden())
+            return;
+
+        // Paths are built in a single string, every level appends its part and removes it again afterwards
+        auto pathLength = this->m_path.size();
+        SCOPE_EXIT( this->m_path.resize(pathLength); );
+
+        if (arrayEntry) {
+            this->m_path += '[';
+            appendNumber(this->m_path, index);
+            this->m_path += ']';
+        } else {
+            if (!this->m_path.empty())
+                this->m_path += '.';
+            this->m_path += name;
+        }
+
+        // Array entries are identified by their position, they don't need a name in the binary format
+        if (arrayEntry)
+            name = { };
+
+        if (auto structPattern = dynamic_cast<PatternDataStruct*>(pattern); structPattern != nullptr) {
+            this->beginPattern(pattern, name);
+            for (auto member : structPattern->getMembers())
+                this->walk(member, member->getVariableName(), false, 0);
+            this->endPattern();
+        } else if (auto unionPattern = dynamic_cast<PatternDataUnion*>(pattern); unionPattern != nullptr) {
+            this->beginPattern(pattern, name);
+            for (auto member : unionPattern->getMembers())
+                this->walk(member, member->getVariableName(), false, 0);
+            this->endPattern();
+        } else if (auto arrayPattern = dynamic_cast<PatternDataArray*>(pattern); arrayPattern != nullptr) {
+            this->beginPattern(pattern, name);
+            const auto &entries = arrayPattern->getEntries();
+            for (u64 i = 0; i < entries.size(); i++)
+                this->walk(entries[i], { }, true, i);
+            this->endPattern();
+        } else if (dynamic_cast<PatternDataStaticArray*>(pattern) != nullptr) {
+            this->beginPattern(pattern, name);
+            this->walkStaticArray(pattern);
+            this->endPattern();
+        } else if (auto bitfieldPattern = dynamic_cast<PatternDataBitfield*>(pattern); bitfieldPattern != nullptr) {
+            std::vector<u8> bytes(pattern->getSize(), 0x00);
+            this->m_provider->read(pattern->getOffset(), bytes.data(), bytes.size());
+
+            if (pattern->getEndian() == std::endian::big)
+                std::reverse(bytes.begin(), bytes.end());
+
+            this->beginPattern(pattern, name);
+
+            for (const auto &field : bitfieldPattern->getFields()) {
+                u64 value = PatternDataBitfield::decodeField(field, bytes.data());
+
+                auto fieldPathLength = this->m_path.size();
+                this->m_path += '.';
+                this->m_path += field.name;
+                this->writeValue(pattern, ValueKind::Bits, "bits", field.name, pattern->getOffset() + field.byteOffset, field.size, reinterpret_cast<const u8*>(&value));
+                this->m_path.resize(fieldPathLength);
+            }
+
+            this->endPattern();
+        } else if (auto pointerPattern = dynamic_cast<PatternDataPointer*>(pattern); pointerPattern != nullptr) {
+            u64 address = 0;
+            auto addressSize = std::min<size_t>(pattern->getSize(), sizeof(address));
+            this->m_provider->read(pattern->getOffset(), &address, addressSize);
+            hex::changeEndianess(&address, 1, addressSize, pattern->getEndian());
+
+            this->beginPattern(pattern, name);
+            this->writeValue(pattern, ValueKind::Pointer, pattern->getFormattedName(), { }, pattern->getOffset(), pattern->getSize(), reinterpret_cast<const u8*>(&address));
+            if (pointerPattern->getPointedAtPattern() != nullptr)
+                this->walk(pointerPattern->getPointedAtPattern(), "*", false, 0);
+            this->endPattern();
+        } else if (auto kind = getValueKind(pattern); kind.has_value()) {
+            std::vector<u8> bytes(pattern->getSize(), 0x00);
+            this->m_provider->read(pattern->getOffset(), bytes.data(), bytes.size());
+
+            if (isNumeric(*kind))
+                hex::changeEndianess(bytes.data(), 1, bytes.size(), pattern->getEndian());
+
+            this->writeValue(pattern, *kind, pattern->getFormattedName(), name, pattern->getOffset(), bytes.size(), bytes.data());
+        }
+    }
+
+    void PatternExporter::walkStaticArray(PatternData *pattern) {
+        auto arrayPattern = static_cast<PatternDataStaticArray*>(pattern);
+        auto entryTemplate = arrayPattern->getTemplate();
+        auto entrySize = entryTemplate->getSize();
+        auto entryCount = arrayPattern->getEntryCount();
+
+        if (entrySize == 0)
+            return;
+
+        // Arrays of simple values get read in big blocks instead of entry by entry
+        auto kind = getValueKind(entryTemplate);
+        if (kind.has_value() && *kind != ValueKind::String && !entryTemplate->isHidden()) {
+            auto typeName = entryTemplate->getFormattedName();
+            std::vector<u8> buffer;
+
+            for (u64 start = 0; start < entryCount && !this->m_stopped; start += ArrayReadEntries) {
+                if (*this->m_cancelled) {
+                    this->m_stopped = true;
+                    return;
+                }
+
+                auto count = std::min<u64>(ArrayReadEntries, entryCount - start);
+                buffer.resize(count * entrySize);
+                this->m_provider->read(pattern->getOffset() + start * entrySize, buffer.data(), buffer.size());
+
+                if (isNumeric(*kind))
+                    hex::changeEndianess(buffer.data(), count, entrySize, entryTemplate->getEndian());
+
+                for (u64 i = 0; i < count; i++) {
+                    auto pathLength = this->m_path.size();
+                    this->m_path += '[';
+                    appendNumber(this->m_path, start + i);
+                    this->m_path += ']';
+
+                    this->writeValue(entryTemplate, *kind, typeName, { }, pattern->getOffset() + (start + i) * entrySize, entrySize, buffer.data() + i * entrySize);
+
+                    this->m_path.resize(pathLength);
+                }
+            }
+
+            return;
+        }
+
+        for (u64 i = 0; i < entryCount && !this->m_stopped; i++) {
+            entryTemplate->setOffset(pattern->getOffset() + i * entrySize);
+            this->walk(entryTemplate, { }, true, i);
+        }
+    }
+
+    void PatternExporter::writeValue(PatternData *pattern, ValueKind kind, std::string_view type, std::string_view name, u64 offset, u64 size, const u8 *data) {
+        // Bitfield fields and pointers hand over their value as a u64, the size of fields is in bits
+        u64 dataSize = (kind == ValueKind::Bits || kind == ValueKind::Pointer) ? sizeof(u64) : size;
+
+        switch (this->m_format) {
+            case Format::JSONLines: {
+                auto &output = this->m_buffer;
+
+                output += "{\"path\":";
+                appendJSONString(output, this->m_path);
+                output += ",\"type\":";
+                appendJSONString(output, type);
+                output += ",\"offset\":";
+                appendNumber(output, offset);
+                output += kind == ValueKind::Bits ? ",\"bits\":" : ",\"size\":";
+                appendNumber(output, size);
+                output += ",\"value\":";
+                this->formatValue(output, kind, dataSize, data);
+
+                if (kind == ValueKind::Enum) {
+                    u64 value = 0;
+                    std::memcpy(&value, data, std::min<u64>(dataSize, sizeof(value)));
+
+                    output += ",\"name\":";
+                    if (auto valueName = static_cast<PatternDataEnum*>(pattern)->getValueName(value); valueName != nullptr)
+                        appendJSONString(output, *valueName);
+                    else
+                        output += "null";
+                }
+
+                output += "}\n";
+                break;
+            }
+            case Format::CSV: {
+                auto column = this->m_path.empty() ? std::string_view("value") : std::string_view(this->m_path);
+
+                if (this->m_collectColumns) {
+                    if (this->m_columns.find(column) == this->m_columns.end()) {
+                        this->m_columns.emplace(column, this->m_columnNames.size());
+                        this->m_columnNames.emplace_back(column);
+                    }
+                    return;
+                }
+
+                auto it = this->m_columns.find(std::string_view(column));
+                if (it == this->m_columns.end())
+                    return;
+
+                auto &cell = this->m_row[it->second];
+                cell.clear();
+
+                // Enums show the name of their value where there is one
+                if (kind == ValueKind::Enum) {
+                    u64 value = 0;
+                    std::memcpy(&value, data, std::min<u64>(dataSize, sizeof(value)));
+
+                    if (auto valueName = static_cast<PatternDataEnum*>(pattern)->getValueName(value); valueName != nullptr) {
+                        appendCSVString(cell, *valueName);
+                        return;
+                    }
+                }
+
+                this->formatValue(cell, kind, dataSize, data);
+                return;
+            }
+            case Format::Binary: {
+                u64 nameId = this->getNameId(name);
+                u64 typeId = this->getNameId(type);
+
+                this->m_buffer += char(RecordKind::Value);
+                this->writeNumber(nameId);
+                this->writeNumber(typeId);
+                this->m_buffer += char(kind);
+                this->writeNumber(offset);
+                this->writeNumber(size);
+
+                std::string_view valueName;
+                if (kind == ValueKind::Enum) {
+                    u64 value = 0;
+                    std::memcpy(&value, data, std::min<u64>(dataSize, sizeof(value)));
+
+                    if (auto found = static_cast<PatternDataEnum*>(pattern)->getValueName(value); found != nullptr)
+                        valueName = *found;
+                }
+
+                this->writeNumber(dataSize + valueName.size());
+
+                auto bytesStart = this->m_buffer.size();
+                this->m_buffer.append(reinterpret_cast<const char*>(data), dataSize);
+                if (isNumeric(kind))
+                    hex::changeEndianess(this->m_buffer.data() + bytesStart, 1, dataSize, std::endian::little);
+
+                this->m_buffer += valueName;
+                break;
+            }
+        }
+
+        if (this->m_buffer.size() >= FlushSize)
+            this->flush();
+    }
+
+    void PatternExporter::beginPattern(PatternData *pattern, std::string_view name) {
+        if (this->m_format != Format::Binary)
+            return;
+
+        u64 nameId = this->getNameId(name);
+        u64 typeId = this->getNameId(pattern->getFormattedName());
+
+        this->m_buffer += char(RecordKind::Begin);
+        this->writeNumber(nameId);
+        this->writeNumber(typeId);
+        this->writeNumber(pattern->getOffset());
+        this->writeNumber(pattern->getSize());
+    }
+
+    void PatternExporter::endPattern() {
+        if (this->m_format != Format::Binary)
+            return;
+
+        this->m_buffer += char(RecordKind::End);
+
+        if (this->m_buffer.size() >= FlushSize)
+            this->flush();
+    }
+
+    void PatternExporter::writeCSV(PatternData *pattern) {
+        this->m_columns.clear();
+        this->m_columnNames.clear();
+
+        // Everything but arrays makes up a single row
+        u64 rowCount = 1;
+        std::function<void(u64)> walkRow = [&](u64) { this->walk(pattern, { }, false, 0); };
+
+        if (auto arrayPattern = dynamic_cast<PatternDataArray*>(pattern); arrayPattern != nullptr) {
+            rowCount = arrayPattern->getEntries().size();
+            walkRow = [&, arrayPattern](u64 row) { this->walk(arrayPattern->getEntries()[row], { }, false, 0); };
+        } else if (auto staticArrayPattern = dynamic_cast<PatternDataStaticArray*>(pattern); staticArrayPattern != nullptr) {
+            auto entryTemplate = staticArrayPattern->getTemplate();
+
+            rowCount = staticArrayPattern->getEntryCount();
+            walkRow = [&, entryTemplate](u64 row) {
+                entryTemplate->setOffset(pattern->getOffset() + row * entryTemplate->getSize());
+                this->walk(entryTemplate, { }, false, 0);
+            };
+        }
+
+        if (rowCount == 0)
+            return;
+
+        this->m_collectColumns = true;
+        walkRow(0);
+        this->m_collectColumns = false;
+
+        for (size_t i = 0; i < this->m_columnNames.size(); i++) {
+            if (i > 0)
+                this->m_buffer += ',';
+            appendCSVString(this->m_buffer, this->m_columnNames[i]);
+        }
+        this->m_buffer += '\n';
+
+        for (u64 row = 0; row < rowCount && !this->m_stopped; row++) {
+            this->m_row.assign(this->m_columnNames.size(), { });
+            walkRow(row);
+
+            for (size_t i = 0; i < this->m_row.size(); i++) {
+                if (i > 0)
+                    this->m_buffer += ',';
+                this->m_buffer += this->m_row[i];
+            }
+            this->m_buffer += '\n';
+
+            if (this->m_buffer.size() >= FlushSize)
+                this->flush();
+        }
+    }
+
+    void PatternExporter::formatValue(std::string &output, ValueKind kind, u64 size, const u8 *data) const {
+        const bool json = this->m_format == Format::JSONLines;
+
+        switch (kind) {
+            case ValueKind::Unsigned:
+            case ValueKind::Signed:
+            case ValueKind::Enum:
+            case ValueKind::Bits:
+            case ValueKind::Pointer: {
+                if (size > sizeof(u64)) {
+                    if (json) output += '"';
+                    appendHexNumber(output, data, size);
+                    if (json) output += '"';
+                    break;
+                }
+
+                u64 value = 0;
+                std::memcpy(&value, data, size);
+
+                if (kind == ValueKind::Signed)
+                    appendNumber(output, s64(hex::signExtend(value, size * 8, 64)));
+                else
+                    appendNumber(output, value);
+                break;
+            }
+            case ValueKind::Float: {
+                double value;
+                if (size == sizeof(float)) {
+                    float floatValue;
+                    std::memcpy(&floatValue, data, sizeof(floatValue));
+                    value = floatValue;
+                } else if (size == sizeof(double)) {
+                    std::memcpy(&value, data, sizeof(value));
+                } else {
+                    output += json ? "null" : "";
+                    break;
+                }
+
+                // JSON has no way to write infinity or NaN
+                if (json && !std::isfinite(value))
+                    output += "null";
+                else
+                    output += hex::format("{}", value);
+                break;
+            }
+            case ValueKind::Boolean:
+                output += data[0] != 0x00 ? "true" : "false";
+                break;
+            case ValueKind::Character:
+            case ValueKind::String: {
+                std::string_view value(reinterpret_cast<const char*>(data), size);
+
+                // Strings stop at the first null byte like in the pattern data view
+                value = value.substr(0, value.find('\0'));
+                if (json)
+                    appendJSONString(output, value);
+                else
+                    appendCSVString(output, value);
+                break;
+            }
+        }
+    }
+
+    void PatternExporter::writeNumber(u64 value) {
+        do {
+            u8 byte = value & 0x7F;
+            value >>= 7;
+            this->m_buffer += char(value != 0 ? (byte | 0x80) : byte);
+        } while (value != 0);
+    }
+
+    u64 PatternExporter::getNameId(std::string_view name) {
+        if (auto it = this->m_nameIds.find(name); it != this->m_nameIds.end())
+            return it->second;
+
+        u64 id = this->m_nameIds.size();
+        this->m_nameIds.emplace(name, id);
+
+        this->m_buffer += char(RecordKind::Name);
+        this->writeNumber(name.size());
+        this->m_buffer += name;
+
+        return id;
+    }
+
+    void PatternExporter::flush() {
+        if (!this->m_buffer.empty() && !this->m_stopped && !this->m_writer(this->m_buffer.data(), this->m_buffer.size()))
+            this->m_stopped = true;
+
+        this->m_buffer.clear();
+    }
+
+}
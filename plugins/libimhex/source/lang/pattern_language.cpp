@@ -1,6 +1,8 @@
 #include <hex/lang/pattern_language.hpp>
 
+#include <hex/api/task.hpp>
 #include <hex/providers/provider.hpp>
+#include <hex/helpers/tracing.hpp>
 
 #include <hex/lang/preprocessor.hpp>
 #include <hex/lang/lexer.hpp>
@@ -9,6 +11,9 @@
 #include <hex/lang/evaluator.hpp>
 #include <hex/lang/pattern_data.hpp>
 
+#include <algorithm>
+#include <cstdlib>
+
 #include <unistd.h>
 
 namespace hex::lang {
@@ -16,9 +21,9 @@ namespace hex::lang {
     PatternLanguage::PatternLanguage() {
         this->m_preprocessor = new Preprocessor();
         this->m_lexer = new Lexer();
-        this->m_parser = new Parser();
+        this->m_parser = new Parser(this->m_astArena);
         this->m_validator = new Validator();
-        this->m_evaluator = new Evaluator();
+        this->m_evaluator = new Evaluator(this->m_patternArena);
 
         this->m_preprocessor->addPragmaHandler("endian", [this](std::string value) {
             if (value == "big") {
@@ -33,6 +38,43 @@ namespace hex::lang {
             } else
                 return false;
         });
+        this->m_preprocessor->addPragmaHandler("pattern_limit", [this](std::string value) {
+            auto limit = std::strtoull(value.c_str(), nullptr, 0);
+            if (limit == 0)
+                return false;
+
+            this->m_evaluator->setPatternLimit(limit);
+            return true;
+        });
+
+        this->m_preprocessor->addPragmaHandler("array_limit", [this](std::string value) {
+            auto limit = std::strtoull(value.c_str(), nullptr, 0);
+            if (limit == 0)
+                return false;
+
+            this->m_evaluator->setArrayLimit(limit);
+            return true;
+        });
+
+        this->m_preprocessor->addPragmaHandler("eval_depth", [this](std::string value) {
+            auto depth = std::strtoul(value.c_str(), nullptr, 0);
+            if (depth == 0)
+                return false;
+
+            this->m_evaluator->setEvaluationDepth(depth);
+            return true;
+        });
+
+        this->m_preprocessor->addPragmaHandler("profile", [this](std::string value) {
+            if (value == "true") {
+                this->m_evaluator->setProfiling(true);
+                return true;
+            } else if (value == "false") {
+                this->m_evaluator->setProfiling(false);
+                return true;
+            } else
+                return false;
+        });
         this->m_preprocessor->addDefaultPragmaHandlers();
     }
 
@@ -45,44 +87,138 @@ namespace hex::lang {
     }
 
 
-    std::optional<std::vector<PatternData*>> PatternLanguage::executeString(prv::Provider *provider, std::string_view string) {
+    bool PatternLanguage::compile(std::string_view string) {
         this->m_currError.reset();
-        this->m_evaluator->getConsole().clear();
-        this->m_evaluator->setProvider(provider);
+        this->m_evaluator->setPatternLimit(Evaluator::DefaultPatternLimit);
+        this->m_evaluator->setArrayLimit(Evaluator::DefaultArrayLimit);
+        this->m_evaluator->setEvaluationDepth(Evaluator::DefaultEvaluationDepth);
+        this->m_evaluator->setProfiling(false);
 
-        auto preprocessedCode = this->m_preprocessor->preprocess(string.data());
+        auto preprocessedCode = [&] { TRACE_SCOPE("Preprocess", "lang"); return this->m_preprocessor->preprocess(string.data()); }();
         if (!preprocessedCode.has_value()) {
             this->m_currError = this->m_preprocessor->getError();
-            return { };
+            return false;
         }
 
-        auto tokens = this->m_lexer->lex(preprocessedCode.value());
+        // Only the evaluator has to run again if the code didn't change since the last execution
+        if (this->m_cachedAst.has_value() && preprocessedCode.value() == this->m_cachedCode)
+            return true;
+
+        this->m_cachedAst.reset();
+        this->m_astArena.clear();
+
+        auto tokens = [&] { TRACE_SCOPE("Lex", "lang"); return this->m_lexer->lex(preprocessedCode.value()); }();
         if (!tokens.has_value()) {
             this->m_currError = this->m_lexer->getError();
-            return { };
+            return false;
         }
 
-        auto ast = this->m_parser->parse(tokens.value());
+        auto ast = [&] { TRACE_SCOPE("Parse", "lang"); return this->m_parser->parse(tokens.value()); }();
         if (!ast.has_value()) {
             this->m_currError = this->m_parser->getError();
-            return { };
+            this->m_astArena.clear();
+            return false;
         }
 
-        SCOPE_EXIT( for(auto &node : ast.value()) delete node; );
-
-        auto validatorResult = this->m_validator->validate(ast.value());
+        auto validatorResult = [&] { TRACE_SCOPE("Validate", "lang"); return this->m_validator->validate(ast.value()); }();
         if (!validatorResult) {
             this->m_currError = this->m_validator->getError();
-            return { };
+            this->m_astArena.clear();
+            return false;
         }
 
-        auto patternData = this->m_evaluator->evaluate(ast.value());
-        if (!patternData.has_value())
+        this->m_cachedCode = std::move(preprocessedCode.value());
+        this->m_cachedAst = std::move(ast.value());
+
+        return true;
+    }
+
+    std::optional<std::vector<PatternData*>> PatternLanguage::executeString(prv::Provider *provider, std::string_view string) {
+        this->m_evaluator->getConsole().clear();
+        this->m_evaluator->setProvider(provider);
+        this->m_patternArena.clear();
+        this->m_evaluated = false;
+
+        TRACE_SCOPE("Pattern execution", "lang");
+
+        if (!this->compile(string))
+            return { };
+
+        auto patternData = [&] { TRACE_SCOPE("Evaluate", "lang"); return this->m_evaluator->evaluate(this->m_cachedAst.value()); }();
+        if (!patternData.has_value()) {
+            this->m_patternArena.clear();
             return { };
+        }
+
+        this->m_evaluated = true;
+        this->m_evaluatedArenaSize = this->m_patternArena.getReservedSize();
 
         return patternData.value();
     }
 
+    bool PatternLanguage::executeBatch(const std::vector<prv::Provider*> &providers, std::string_view string, const BatchCallback &callback) {
+        // The AST of the last execution may get replaced, its patterns can't be kept around
+        this->m_evaluator->getConsole().clear();
+        this->m_patternArena.clear();
+        this->m_evaluated = false;
+        this->m_batchAborted = false;
+
+        TRACE_SCOPE("Pattern batch", "lang", providers.size());
+
+        if (!this->compile(string))
+            return false;
+
+        // The AST is only read during evaluation, all workers share it
+        const auto &ast = this->m_cachedAst.value();
+        std::atomic<u32> nextProvider = 0;
+
+        TaskManager::runParallel(std::min<u32>(providers.size(), TaskManager::getWorkerCount()), [&](u32) {
+            Arena arena;
+            Evaluator evaluator(arena);
+            evaluator.copySettings(*this->m_evaluator);
+            evaluator.setIsolated(true);
+
+            {
+                std::scoped_lock lock(this->m_batchMutex);
+                this->m_batchEvaluators.push_back(&evaluator);
+            }
+            SCOPE_EXIT(
+                std::scoped_lock lock(this->m_batchMutex);
+                std::erase(this->m_batchEvaluators, &evaluator);
+            );
+
+            for (u32 index; !this->m_batchAborted && (index = nextProvider++) < providers.size();) {
+                evaluator.getConsole().clear();
+                evaluator.setProvider(providers[index]);
+
+                auto patternData = [&] { TRACE_SCOPE("Evaluate", "lang", index); return evaluator.evaluate(ast); }();
+                callback(index, patternData, evaluator.getConsole().getLog());
+
+                arena.clear();
+            }
+        });
+
+        return true;
+    }
+
+    std::optional<std::vector<PatternData*>> PatternLanguage::reevaluate(prv::Provider *provider, const std::vector<Region> &changedRegions) {
+        if (!this->m_evaluated)
+            return { };
+
+        // Replaced patterns stay in the arena until the next execution, start over once they waste too much memory
+        if (this->m_patternArena.getReservedSize() > std::max(this->m_evaluatedArenaSize * 2, MaxReevaluationArenaSize))
+            return { };
+
+        this->m_evaluator->setProvider(provider);
+
+        TRACE_SCOPE("Reevaluate", "lang");
+        auto patternData = this->m_evaluator->reevaluate(changedRegions);
+        if (!patternData.has_value())
+            this->m_evaluated = false;
+
+        return patternData;
+    }
+
     std::optional<std::vector<PatternData*>> PatternLanguage::executeFile(prv::Provider *provider, std::string_view path) {
         FILE *file = fopen(path.data(), "r");
         if (file == nullptr)
@@ -101,6 +237,23 @@ namespace hex::lang {
     }
 
 
+    void PatternLanguage::abort() {
+        this->m_evaluator->abort();
+
+        std::scoped_lock lock(this->m_batchMutex);
+        this->m_batchAborted = true;
+        for (auto evaluator : this->m_batchEvaluators)
+            evaluator->abort();
+    }
+
+    u64 PatternLanguage::getCreatedPatternCount() const {
+        return this->m_evaluator->getCreatedPatternCount();
+    }
+
+    size_t PatternLanguage::getPatternMemoryUsage() const {
+        return this->m_patternArena.getReservedSize();
+    }
+
     const std::vector<std::pair<LogConsole::Level, std::string>>& PatternLanguage::getConsoleLog() {
         return this->m_evaluator->getConsole().getLog();
     }
@@ -1,13 +1,136 @@
 #include <hex/lang/preprocessor.hpp>
 
+#include <algorithm>
+#include <cstdlib>
 #include <filesystem>
 
 namespace hex::lang {
 
+    static std::optional<std::string> readFile(const std::string &path) {
+        FILE *file = fopen(path.c_str(), "r");
+        if (file == nullptr)
+            return { };
+
+        fseek(file, 0, SEEK_END);
+        size_t size = ftell(file);
+        rewind(file);
+
+        std::string content(size, 0x00);
+        fread(content.data(), size, 1, file);
+
+        fclose(file);
+
+        return content;
+    }
+
     Preprocessor::Preprocessor() {
 
     }
 
+    std::string Preprocessor::resolveInclude(const std::string &name) {
+        if (name[0] == '/')
+            return name;
+
+        std::error_code error;
+        if (auto it = this->m_resolvedIncludes.find(name); it != this->m_resolvedIncludes.end() && std::filesystem::exists(it->second, error))
+            return it->second;
+
+        // Use the first include directory that has the file, falling back to the last one so errors mention a full path
+        std::string path = name;
+        for (const auto &dir : hex::getPath(ImHexPath::PatternsInclude)) {
+            path = hex::format("{0}/{1}", dir.c_str(), name.c_str());
+            if (std::filesystem::exists(path, error))
+                break;
+        }
+
+        this->m_resolvedIncludes[name] = path;
+
+        return path;
+    }
+
+    std::string Preprocessor::preprocessInclude(const std::string &path, u32 lineNumber) {
+        if (this->isIncludeUpToDate(path)) {
+            const auto &include = this->m_includeCache[path];
+
+            this->m_defines.insert(include.defines.begin(), include.defines.end());
+            this->m_pragmas.insert(include.pragmas.begin(), include.pragmas.end());
+            this->m_includes.push_back(path);
+
+            return include.content;
+        }
+
+        std::error_code error;
+        auto lastWriteTime = std::filesystem::last_write_time(path, error);
+
+        auto code = readFile(path);
+        if (!code.has_value())
+            throwPreprocessorError(hex::format("{0}: No such file or directory", path.c_str()), lineNumber);
+
+        // Collect the defines, pragmas and nested includes of this file on their own so they can be cached with it
+        auto outerDefines = std::exchange(this->m_defines, { });
+        auto outerPragmas = std::exchange(this->m_pragmas, { });
+        auto outerIncludes = std::exchange(this->m_includes, { });
+
+        auto preprocessedInclude = this->preprocess(code.value(), false);
+        if (!preprocessedInclude.has_value())
+            throw this->m_error;
+
+        auto content = preprocessedInclude.value();
+
+        std::replace(content.begin(), content.end(), '\n', ' ');
+        std::replace(content.begin(), content.end(), '\r', ' ');
+
+        CachedInclude include = { lastWriteTime, std::hash<std::string>{}(code.value()), content, this->m_defines, this->m_pragmas, this->m_includes };
+
+        this->m_defines.insert(outerDefines.begin(), outerDefines.end());
+        this->m_pragmas.insert(outerPragmas.begin(), outerPragmas.end());
+        this->m_includes = std::move(outerIncludes);
+        this->m_includes.push_back(path);
+
+        if (!error) {
+            this->m_includeCache[path] = std::move(include);
+            this->m_validatedIncludes.insert(path);
+        } else
+            this->m_includeCache.erase(path);
+
+        return content;
+    }
+
+    bool Preprocessor::isIncludeUpToDate(const std::string &path) {
+        auto it = this->m_includeCache.find(path);
+        if (it == this->m_includeCache.end())
+            return false;
+
+        // Files included from multiple places only get checked once per run
+        if (this->m_validatedIncludes.contains(path))
+            return true;
+
+        auto &include = it->second;
+
+        std::error_code error;
+        auto lastWriteTime = std::filesystem::last_write_time(path, error);
+        if (error)
+            return false;
+
+        // The file was touched, only throw away the cached version if its content actually changed
+        if (lastWriteTime != include.lastWriteTime) {
+            auto code = readFile(path);
+            if (!code.has_value() || std::hash<std::string>{}(code.value()) != include.contentHash)
+                return false;
+
+            include.lastWriteTime = lastWriteTime;
+        }
+
+        bool upToDate = std::all_of(include.includes.begin(), include.includes.end(), [this](const auto &nestedInclude) {
+            return this->isIncludeUpToDate(nestedInclude);
+        });
+
+        if (upToDate)
+            this->m_validatedIncludes.insert(path);
+
+        return upToDate;
+    }
+
     std::optional<std::string> Preprocessor::preprocess(const std::string& code, bool initialRun) {
         u32 offset = 0;
         u32 lineNumber = 1;
@@ -15,6 +138,8 @@ namespace hex::lang {
         if (initialRun) {
             this->m_defines.clear();
             this->m_pragmas.clear();
+            this->m_includes.clear();
+            this->m_validatedIncludes.clear();
         }
 
         std::string output;
@@ -49,42 +174,7 @@ namespace hex::lang {
                         }
                         offset += 1;
 
-                        if (includeFile[0] != '/') {
-                            std::string tempPath = includeFile;
-                            for (const auto &dir : hex::getPath(ImHexPath::PatternsInclude)) {
-                               tempPath = hex::format("{0}/{1}", dir.c_str(), includeFile.c_str());
-                                if (std::filesystem::exists(includeFile))
-                                    break;
-                            }
-                            includeFile = tempPath;
-                        }
-
-                        FILE *file = fopen(includeFile.c_str(), "r");
-                        if (file == nullptr)
-                            throwPreprocessorError(hex::format("{0}: No such file or directory", includeFile.c_str()), lineNumber);
-
-                        fseek(file, 0, SEEK_END);
-                        size_t size = ftell(file);
-                        char *buffer = new char[size + 1];
-                        rewind(file);
-
-                        fread(buffer, size, 1, file);
-                        buffer[size] = 0x00;
-
-                        auto preprocessedInclude = this->preprocess(buffer, false);
-                        if (!preprocessedInclude.has_value())
-                            throw this->m_error;
-
-                        auto content = preprocessedInclude.value();
-
-                        std::replace(content.begin(), content.end(), '\n', ' ');
-                        std::replace(content.begin(), content.end(), '\r', ' ');
-
-                        output += content;
-
-                        delete[] buffer;
-
-                        fclose(file);
+                        output += this->preprocessInclude(this->resolveInclude(includeFile), lineNumber);
                     } else if (code.substr(offset, 6) == "define") {
                         offset += 6;
 
@@ -224,6 +314,18 @@ namespace hex::lang {
         this->addPragmaHandler("endian", [](const std::string &value) {
             return value == "big" || value == "little" || value == "native";
         });
+        this->addPragmaHandler("pattern_limit", [](const std::string &value) {
+            return std::strtoull(value.c_str(), nullptr, 0) != 0;
+        });
+        this->addPragmaHandler("array_limit", [](const std::string &value) {
+            return std::strtoull(value.c_str(), nullptr, 0) != 0;
+        });
+        this->addPragmaHandler("eval_depth", [](const std::string &value) {
+            return std::strtoul(value.c_str(), nullptr, 0) != 0;
+        });
+        this->addPragmaHandler("profile", [](const std::string &value) {
+            return value == "true" || value == "false";
+        });
     }
 
 }
\ No newline at end of file
@@ -1,48 +1,79 @@
 #include <hex/lang/validator.hpp>
 
-#include <unordered_set>
+#include <atomic>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <unordered_set>
 
+#include <hex/api/task.hpp>
 #include <hex/helpers/utils.hpp>
 
 namespace hex::lang {
 
-    Validator::Validator() {
+    namespace {
+
+        /* Name a node declares, empty for nodes that don't declare one and for padding */
+        std::string_view getDeclaredName(ASTNode *node) {
+            if (auto variableDeclNode = dynamic_cast<ASTNodeVariableDecl*>(node); variableDeclNode != nullptr)
+                return variableDeclNode->getName();
+            else if (auto arrayDeclNode = dynamic_cast<ASTNodeArrayVariableDecl*>(node); arrayDeclNode != nullptr)
+                return arrayDeclNode->getName();
+            else if (auto pointerDeclNode = dynamic_cast<ASTNodePointerVariableDecl*>(node); pointerDeclNode != nullptr)
+                return pointerDeclNode->getName();
+            else if (auto typeDeclNode = dynamic_cast<ASTNodeTypeDecl*>(node); typeDeclNode != nullptr)
+                return typeDeclNode->getName();
+            else
+                return { };
+        }
 
     }
 
-    bool Validator::validate(const std::vector<ASTNode*>& ast) {
-        std::unordered_set<std::string> identifiers;
+    Validator::Validator() {
 
-        try {
+    }
 
-            for (const auto &node : ast) {
-                if (node == nullptr)
-                    throwValidateError("nullptr in AST. This is a bug!", 1);
-
-                if (auto variableDeclNode = dynamic_cast<ASTNodeVariableDecl*>(node); variableDeclNode != nullptr) {
-                    if (!identifiers.insert(variableDeclNode->getName().data()).second)
-                        throwValidateError(hex::format("redefinition of identifier '{0}'", variableDeclNode->getName().data()), variableDeclNode->getLineNumber());
-
-                    this->validate({ variableDeclNode->getType() });
-                } else if (auto typeDeclNode = dynamic_cast<ASTNodeTypeDecl*>(node); typeDeclNode != nullptr) {
-                    if (!identifiers.insert(typeDeclNode->getName().data()).second)
-                        throwValidateError(hex::format("redefinition of identifier '{0}'", typeDeclNode->getName().data()), typeDeclNode->getLineNumber());
-
-                    this->validate({ typeDeclNode->getType() });
-                } else if (auto structNode = dynamic_cast<ASTNodeStruct*>(node); structNode != nullptr) {
-                    this->validate(structNode->getMembers());
-                } else if (auto unionNode = dynamic_cast<ASTNodeUnion*>(node); unionNode != nullptr) {
-                    this->validate(unionNode->getMembers());
-                } else if (auto enumNode = dynamic_cast<ASTNodeEnum*>(node); enumNode != nullptr) {
-                    std::unordered_set<std::string> enumIdentifiers;
-                    for (auto &[name, value] : enumNode->getEntries()) {
-                        if (!enumIdentifiers.insert(name).second)
-                            throwValidateError(hex::format("redefinition of enum constant '{0}'", name.c_str()), value->getLineNumber());
+    bool Validator::validate(const std::vector<ASTNode*>& ast) {
+        // Members only have to be checked for the declarations before the first one that's invalid by itself
+        size_t end = findRedefinition(ast);
+
+        std::atomic<size_t> firstInvalid = end;
+        std::optional<ValidatorError> memberError;
+        std::mutex errorMutex;
+
+        auto checkDeclarations = [&, this](size_t from, size_t to) {
+            for (size_t i = from; i < to && i < firstInvalid; i++) {
+                try {
+                    this->checkMembers(ast[i]);
+                } catch (ValidatorError &e) {
+                    std::scoped_lock lock(errorMutex);
+                    if (i < firstInvalid) {
+                        firstInvalid = i;
+                        memberError = std::move(e);
                     }
+
+                    return;
                 }
             }
+        };
+
+        if (end < ParallelDeclarationCount)
+            checkDeclarations(0, end);
+        else {
+            u32 jobCount = (end + DeclarationsPerJob - 1) / DeclarationsPerJob;
+            std::atomic<u32> nextJob = 0;
+
+            TaskManager::runParallel(std::min(jobCount, TaskManager::getWorkerCount()), [&](u32) {
+                for (u32 job; (job = nextJob++) < jobCount;)
+                    checkDeclarations(job * DeclarationsPerJob, std::min<size_t>((job + 1) * DeclarationsPerJob, end));
+            });
+        }
 
+        try {
+            if (memberError.has_value())
+                throw memberError.value();
+            else if (end < ast.size())
+                this->throwRedefinitionError(ast[end]);
         } catch (ValidatorError &e) {
             this->m_error = e;
             return false;
@@ -51,6 +82,47 @@ namespace hex::lang {
         return true;
     }
 
+    size_t Validator::findRedefinition(const std::vector<ASTNode*> &nodes) {
+        // Interned names are equal only if they're the same string
+        std::unordered_set<const char*> names;
+        names.reserve(nodes.size());
+
+        for (size_t i = 0; i < nodes.size(); i++) {
+            if (nodes[i] == nullptr)
+                return i;
+
+            auto name = getDeclaredName(nodes[i]);
+            if (!name.empty() && !names.insert(name.data()).second)
+                return i;
+        }
+
+        return nodes.size();
+    }
+
+    void Validator::checkRedefinitions(const std::vector<ASTNode*> &nodes) const {
+        if (auto index = findRedefinition(nodes); index < nodes.size())
+            this->throwRedefinitionError(nodes[index]);
+    }
+
+    void Validator::throwRedefinitionError(ASTNode *node) const {
+        if (node == nullptr)
+            throwValidateError("nullptr in AST. This is a bug!", 1);
+
+        throwValidateError(hex::format("redefinition of identifier '{0}'", getDeclaredName(node)), node->getLineNumber());
+    }
+
+    /* Members of a struct or union only refer to other types, which are declared at the top level and get checked there */
+    void Validator::checkMembers(ASTNode *declaration) const {
+        auto typeDeclNode = dynamic_cast<ASTNodeTypeDecl*>(declaration);
+        if (typeDeclNode == nullptr)
+            return;
+
+        if (auto structNode = dynamic_cast<ASTNodeStruct*>(typeDeclNode->getType()); structNode != nullptr)
+            this->checkRedefinitions(structNode->getMembers());
+        else if (auto unionNode = dynamic_cast<ASTNodeUnion*>(typeDeclNode->getType()); unionNode != nullptr)
+            this->checkRedefinitions(unionNode->getMembers());
+    }
+
     void Validator::printAST(const std::vector<ASTNode*>& ast){
     #if DEBUG
         #define INDENT_VALUE indent, ' '
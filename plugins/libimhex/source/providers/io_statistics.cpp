@@ -0,0 +1,103 @@
+#include <hex/providers/io_statistics.hpp>
+
+#include <algorithm>
+#include <mutex>
+
+namespace hex::prv {
+
+    std::atomic<bool> IOStatistics::s_enabled = false;
+
+    namespace {
+
+        std::mutex tagMutex;
+        std::vector<std::string> tagNames = { "" };
+
+        thread_local u32 currentTag = IOStatistics::UntaggedTag;
+
+    }
+
+    IOStatistics::Scope::Scope(u32 tag) : m_previousTag(currentTag) {
+        currentTag = tag;
+    }
+
+    IOStatistics::Scope::~Scope() {
+        currentTag = this->m_previousTag;
+    }
+
+    void IOStatistics::setEnabled(bool enabled) {
+        IOStatistics::s_enabled = enabled;
+    }
+
+    u32 IOStatistics::getTag(std::string_view name) {
+        std::scoped_lock lock(tagMutex);
+
+        auto it = std::find(tagNames.begin(), tagNames.end(), name);
+        if (it != tagNames.end())
+            return it - tagNames.begin();
+
+        if (tagNames.size() >= MaxTags)
+            return MaxTags - 1;
+
+        tagNames.emplace_back(name);
+        return tagNames.size() - 1;
+    }
+
+    std::string IOStatistics::getTagName(u32 tag) {
+        std::scoped_lock lock(tagMutex);
+
+        return tag < tagNames.size() ? tagNames[tag] : "";
+    }
+
+    u32 IOStatistics::getCurrentTag() {
+        return currentTag;
+    }
+
+    void IOStatistics::countRead(size_t size, bool patched) {
+        auto &counters = this->m_counters[currentTag];
+
+        counters.readCalls.fetch_add(1, std::memory_order_relaxed);
+        counters.bytesRead.fetch_add(size, std::memory_order_relaxed);
+        if (patched)
+            counters.patchHits.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void IOStatistics::countCacheAccess(u64 hits, u64 misses) {
+        auto &counters = this->m_counters[currentTag];
+
+        counters.cacheHits.fetch_add(hits, std::memory_order_relaxed);
+        counters.cacheMisses.fetch_add(misses, std::memory_order_relaxed);
+    }
+
+    void IOStatistics::countRawRead(size_t size, u64 time) {
+        auto &counters = this->m_counters[currentTag];
+
+        counters.rawReadCalls.fetch_add(1, std::memory_order_relaxed);
+        counters.rawBytesRead.fetch_add(size, std::memory_order_relaxed);
+        counters.rawReadTime.fetch_add(time, std::memory_order_relaxed);
+    }
+
+    std::vector<std::pair<std::string, IOStatistics::Counters>> IOStatistics::getCounters() const {
+        std::vector<std::pair<std::string, Counters>> result;
+
+        for (u32 tag = 0; tag < MaxTags; tag++) {
+            const auto &counters = this->m_counters[tag];
+            if (counters.readCalls == 0 && counters.rawReadCalls == 0 && counters.cacheHits == 0)
+                continue;
+
+            result.emplace_back(getTagName(tag), Counters {
+                counters.readCalls, counters.bytesRead, counters.patchHits, counters.cacheHits, counters.cacheMisses,
+                counters.rawReadCalls, counters.rawBytesRead, counters.rawReadTime
+            });
+        }
+
+        return result;
+    }
+
+    void IOStatistics::reset() {
+        for (auto &counters : this->m_counters) {
+            for (auto counter : { &counters.readCalls, &counters.bytesRead, &counters.patchHits, &counters.cacheHits, &counters.cacheMisses, &counters.rawReadCalls, &counters.rawBytesRead, &counters.rawReadTime })
+                *counter = 0;
+        }
+    }
+
+}
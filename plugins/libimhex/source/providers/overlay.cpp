@@ -0,0 +1,196 @@
+#include <hex/providers/overlay.hpp>
+
+#include <hex/providers/provider.hpp>
+
+#include <cstring>
+#include <utility>
+
+#if defined(OS_WINDOWS)
+#include <windows.h>
+#include <io.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace hex::prv {
+
+    OverlayData::OverlayData(std::vector<u8> data) {
+        if (data.size() < SpillThreshold) {
+            this->m_size = data.size();
+            this->m_buffer = std::move(data);
+        } else if (!this->append(data.data(), data.size())) {
+            // If the temporary file can't be written the data simply stays on the heap
+            this->release();
+            this->m_size = data.size();
+            this->m_buffer = std::move(data);
+        }
+    }
+
+    OverlayData::OverlayData(OverlayData &&other) noexcept {
+        *this = std::move(other);
+    }
+
+    OverlayData& OverlayData::operator=(OverlayData &&other) noexcept {
+        if (this != &other) {
+            this->release();
+
+            this->m_size = std::exchange(other.m_size, 0);
+            this->m_finished = std::exchange(other.m_finished, false);
+            this->m_buffer = std::move(other.m_buffer);
+            this->m_file = std::exchange(other.m_file, nullptr);
+            this->m_fileSize = std::exchange(other.m_fileSize, 0);
+            this->m_mapping = std::exchange(other.m_mapping, nullptr);
+            this->m_mappingHandle = std::exchange(other.m_mappingHandle, nullptr);
+        }
+
+        return *this;
+    }
+
+    OverlayData::~OverlayData() {
+        this->release();
+    }
+
+    void OverlayData::release() {
+        #if defined(OS_WINDOWS)
+        if (this->m_mapping != nullptr)
+            UnmapViewOfFile(this->m_mapping);
+        if (this->m_mappingHandle != nullptr)
+            CloseHandle(this->m_mappingHandle);
+        #else
+        if (this->m_mapping != nullptr)
+            munmap(const_cast<u8*>(this->m_mapping), this->m_fileSize);
+        #endif
+
+        // Temporary files get deleted as soon as they're closed
+        if (this->m_file != nullptr)
+            std::fclose(this->m_file);
+
+        this->m_mapping = nullptr;
+        this->m_mappingHandle = nullptr;
+        this->m_file = nullptr;
+        this->m_fileSize = 0;
+        this->m_buffer.clear();
+        this->m_size = 0;
+        this->m_finished = false;
+    }
+
+    bool OverlayData::append(const u8 *data, size_t size) {
+        if (this->m_finished)
+            return false;
+
+        // Large amounts of data get appended in pieces so the whole of it is never on the heap twice
+        while (size > 0) {
+            auto pieceSize = std::min(size, ChunkSize);
+
+            this->m_buffer.insert(this->m_buffer.end(), data, data + pieceSize);
+            this->m_size += pieceSize;
+            data += pieceSize;
+            size -= pieceSize;
+
+            // Without a temporary file everything stays on the heap like small data does
+            if (this->m_file == nullptr && this->m_buffer.size() >= SpillThreshold)
+                this->m_file = std::tmpfile();
+
+            if (this->m_file != nullptr && !this->writeChunks(false))
+                return false;
+        }
+
+        return true;
+    }
+
+    bool OverlayData::writeChunks(bool all) {
+        size_t offset = 0;
+        while (this->m_buffer.size() - offset >= ChunkSize || (all && offset < this->m_buffer.size())) {
+            auto chunk = this->m_buffer.data() + offset;
+            auto chunkSize = std::min(ChunkSize, this->m_buffer.size() - offset);
+
+            // Zero chunks are skipped over, the file gets extended to its full size once everything is written
+            bool zero = chunk[0] == 0x00 && std::memcmp(chunk, chunk + 1, chunkSize - 1) == 0;
+            if (!zero) {
+                #if defined(OS_WINDOWS)
+                bool seeked = _fseeki64(this->m_file, this->m_fileSize, SEEK_SET) == 0;
+                #else
+                bool seeked = fseeko(this->m_file, this->m_fileSize, SEEK_SET) == 0;
+                #endif
+
+                if (!seeked || std::fwrite(chunk, 1, chunkSize, this->m_file) != chunkSize)
+                    return false;
+            }
+
+            this->m_fileSize += chunkSize;
+            offset += chunkSize;
+        }
+
+        this->m_buffer.erase(this->m_buffer.begin(), this->m_buffer.begin() + offset);
+
+        return true;
+    }
+
+    bool OverlayData::finish() {
+        if (this->m_finished)
+            return true;
+
+        if (this->m_file == nullptr) {
+            this->m_finished = true;
+            return true;
+        }
+
+        if (!this->writeChunks(true) || std::fflush(this->m_file) != 0)
+            return false;
+
+        #if defined(OS_WINDOWS)
+        if (_chsize_s(_fileno(this->m_file), this->m_fileSize) != 0)
+            return false;
+
+        auto file = reinterpret_cast<HANDLE>(_get_osfhandle(_fileno(this->m_file)));
+        this->m_mappingHandle = CreateFileMapping(file, nullptr, PAGE_READONLY, DWORD(this->m_fileSize >> 32), DWORD(this->m_fileSize & 0xFFFF'FFFF), nullptr);
+        if (this->m_mappingHandle == nullptr)
+            return false;
+
+        this->m_mapping = static_cast<const u8*>(MapViewOfFile(this->m_mappingHandle, FILE_MAP_READ, 0, 0, this->m_fileSize));
+        if (this->m_mapping == nullptr)
+            return false;
+        #else
+        if (ftruncate(fileno(this->m_file), this->m_fileSize) != 0)
+            return false;
+
+        auto mapping = mmap(nullptr, this->m_fileSize, PROT_READ, MAP_SHARED, fileno(this->m_file), 0);
+        if (mapping == MAP_FAILED)
+            return false;
+
+        this->m_mapping = static_cast<const u8*>(mapping);
+        #endif
+
+        this->m_finished = true;
+        return true;
+    }
+
+    void OverlayData::read(u64 offset, u8 *buffer, size_t size) const {
+        if (this->m_mapping != nullptr)
+            std::memcpy(buffer, this->m_mapping + offset, size);
+        else
+            std::memcpy(buffer, this->m_buffer.data() + offset, size);
+    }
+
+
+    void Overlay::setAddress(u64 address) {
+        std::scoped_lock lock(this->m_provider->m_overlayMutex);
+
+        this->m_address = address;
+        this->m_provider->rebuildOverlayIndex();
+    }
+
+    void Overlay::setData(u64 address, OverlayData data) {
+        // Data that can't be mapped isn't shown at all rather than being read from a half written file
+        if (!data.finish())
+            data = { };
+
+        std::scoped_lock lock(this->m_provider->m_overlayMutex);
+
+        this->m_address = address;
+        this->m_data = std::move(data);
+        this->m_provider->rebuildOverlayIndex();
+    }
+
+}
@@ -0,0 +1,234 @@
+#include <hex/providers/patch_store.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <iterator>
+
+namespace hex::prv {
+
+    namespace {
+
+        std::atomic<u64> generationCounter = 0;
+
+    }
+
+    PatchStore::RunIterator PatchStore::findFirstRunEndingAfter(u64 address) const {
+        auto it = this->m_runs->upper_bound(address);
+
+        if (it != this->m_runs->begin()) {
+            auto prev = std::prev(it);
+            if (prev->first + prev->second.size() > address)
+                return prev;
+        }
+
+        return it;
+    }
+
+    PatchStore::Runs& PatchStore::detach() {
+        this->m_generation = ++generationCounter;
+
+        // Other owners only ever read their runs, if this is the only one left nobody else can see the modification
+        if (this->m_runs.use_count() > 1)
+            this->m_runs = std::make_shared<Runs>(*this->m_runs);
+        else
+            std::atomic_thread_fence(std::memory_order_acquire);    // Pairs with the release of the last other owner
+
+        return *this->m_runs;
+    }
+
+    void PatchStore::write(u64 address, const u8 *data, size_t size) {
+        if (size == 0)
+            return;
+
+        u64 end = address + size;
+        auto &runs = this->detach();
+
+        // Find the first run that overlaps or directly touches the new data so we can merge with it
+        auto first = runs.upper_bound(address);
+        if (first != runs.begin()) {
+            auto prev = std::prev(first);
+            if (prev->first + prev->second.size() >= address)
+                first = prev;
+        }
+
+        auto last = first;
+        while (last != runs.end() && last->first <= end)
+            last++;
+
+        // No neighbours, just insert a new run
+        if (first == last) {
+            runs.emplace(address, std::vector<u8>(data, data + size));
+            this->m_byteCount += size;
+            return;
+        }
+
+        u64 newStart = std::min(address, first->first);
+        u64 newEnd = end;
+        for (auto it = first; it != last; it++) {
+            newEnd = std::max<u64>(newEnd, it->first + it->second.size());
+            this->m_byteCount -= it->second.size();
+        }
+
+        std::vector<u8> merged;
+        auto firstNode = runs.extract(first->first);
+        if (firstNode.key() == newStart)
+            merged = std::move(firstNode.mapped());
+
+        merged.resize(newEnd - newStart);
+        if (firstNode.key() != newStart)
+            std::memcpy(merged.data() + (firstNode.key() - newStart), firstNode.mapped().data(), firstNode.mapped().size());
+
+        auto it = runs.upper_bound(firstNode.key());
+        while (it != runs.end() && it->first <= end) {
+            std::memcpy(merged.data() + (it->first - newStart), it->second.data(), it->second.size());
+            it = runs.erase(it);
+        }
+
+        std::memcpy(merged.data() + (address - newStart), data, size);
+
+        this->m_byteCount += merged.size();
+        runs.emplace(newStart, std::move(merged));
+    }
+
+    void PatchStore::erase(u64 address, size_t size) {
+        if (size == 0)
+            return;
+
+        u64 end = address + size;
+        auto &runs = this->detach();
+
+        auto it = this->findFirstRunEndingAfter(address);
+        while (it != runs.end() && it->first < end) {
+            u64 runStart = it->first;
+            u64 runEnd = runStart + it->second.size();
+
+            auto node = runs.extract(it++);
+            auto &data = node.mapped();
+            this->m_byteCount -= data.size();
+
+            if (runEnd > end) {
+                std::vector<u8> tail(data.begin() + (end - runStart), data.end());
+                this->m_byteCount += tail.size();
+                it = runs.emplace(end, std::move(tail)).first;
+            }
+
+            if (runStart < address) {
+                data.resize(address - runStart);
+                this->m_byteCount += data.size();
+                runs.insert(std::move(node));
+            }
+        }
+    }
+
+    void PatchStore::move(u64 address, s64 distance) {
+        if (distance == 0)
+            return;
+
+        auto &runs = this->detach();
+
+        // A run reaching over the address gets split, only the part behind it moves
+        if (auto it = runs.lower_bound(address); it != runs.begin()) {
+            auto prev = std::prev(it);
+            if (prev->first + prev->second.size() > address) {
+                std::vector<u8> tail(prev->second.begin() + (address - prev->first), prev->second.end());
+                prev->second.resize(address - prev->first);
+                runs.emplace_hint(it, address, std::move(tail));
+            }
+        }
+
+        std::vector<Runs::node_type> moved;
+        for (auto it = runs.lower_bound(address); it != runs.end();)
+            moved.push_back(runs.extract(it++));
+
+        for (auto &node : moved) {
+            node.key() += distance;
+
+            // Removing data can make a moved run touch the one in front of it
+            if (auto it = runs.lower_bound(node.key()); it != runs.begin()) {
+                auto prev = std::prev(it);
+                if (prev->first + prev->second.size() == node.key()) {
+                    prev->second.insert(prev->second.end(), node.mapped().begin(), node.mapped().end());
+                    continue;
+                }
+            }
+
+            runs.insert(std::move(node));
+        }
+    }
+
+    void PatchStore::clear() {
+        this->m_runs = std::make_shared<Runs>();
+        this->m_byteCount = 0;
+        this->m_generation = ++generationCounter;
+    }
+
+    std::optional<u8> PatchStore::get(u64 address) const {
+        auto it = this->findFirstRunEndingAfter(address);
+
+        if (it == this->m_runs->end() || it->first > address)
+            return { };
+
+        return it->second[address - it->first];
+    }
+
+    bool PatchStore::contains(u64 address) const {
+        return this->get(address).has_value();
+    }
+
+    bool PatchStore::overlay(u64 address, u8 *buffer, size_t size) const {
+        u64 end = address + size;
+        bool patched = false;
+
+        for (auto it = this->findFirstRunEndingAfter(address); it != this->m_runs->end() && it->first < end; it++) {
+            u64 copyStart = std::max<u64>(address, it->first);
+            u64 copyEnd = std::min<u64>(end, it->first + it->second.size());
+
+            std::memcpy(buffer + (copyStart - address), it->second.data() + (copyStart - it->first), copyEnd - copyStart);
+            patched = true;
+        }
+
+        return patched;
+    }
+
+    bool PatchStore::overlaps(u64 address, size_t size) const {
+        auto it = this->findFirstRunEndingAfter(address);
+
+        return it != this->m_runs->end() && it->first < address + size;
+    }
+
+    std::map<u64, u8> PatchStore::toByteMap() const {
+        std::map<u64, u8> result;
+
+        for (const auto &[address, data] : *this->m_runs) {
+            for (u64 i = 0; i < data.size(); i++)
+                result.emplace_hint(result.end(), address + i, data[i]);
+        }
+
+        return result;
+    }
+
+    PatchStore PatchStore::fromByteMap(const std::map<u64, u8> &bytes) {
+        PatchStore result;
+
+        std::vector<u8> run;
+        u64 runStart = 0;
+        for (const auto &[address, value] : bytes) {
+            if (!run.empty() && address != runStart + run.size()) {
+                result.write(runStart, run.data(), run.size());
+                run.clear();
+            }
+
+            if (run.empty())
+                runStart = address;
+
+            run.push_back(value);
+        }
+
+        if (!run.empty())
+            result.write(runStart, run.data(), run.size());
+
+        return result;
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,225 @@
+#include <hex/providers/piece_table.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+namespace hex::prv {
+
+    PieceTable::PieceTable(size_t originalSize) {
+        this->reset(originalSize);
+    }
+
+    PieceTable::PieceTable(const PieceTable &other)
+        : m_root(copy(other.m_root.get())), m_addedData(other.m_addedData), m_modified(other.m_modified), m_randomState(other.m_randomState) {
+
+    }
+
+    PieceTable::~PieceTable() = default;
+
+    PieceTable::NodePtr PieceTable::copy(const Node *node) {
+        if (node == nullptr)
+            return nullptr;
+
+        auto result = std::make_unique<Node>();
+        result->piece = node->piece;
+        result->priority = node->priority;
+        result->subtreeSize = node->subtreeSize;
+        result->left = copy(node->left.get());
+        result->right = copy(node->right.get());
+
+        return result;
+    }
+
+    void PieceTable::reset(size_t originalSize) {
+        this->m_root = originalSize > 0 ? this->createNode({ 0, originalSize, false }) : nullptr;
+        this->m_addedData.clear();
+        this->m_modified = false;
+    }
+
+    void PieceTable::update(Node *node) {
+        node->subtreeSize = sizeOf(node->left) + node->piece.size + sizeOf(node->right);
+    }
+
+    PieceTable::NodePtr PieceTable::createNode(const Piece &piece) {
+        // xorshift32, the priorities only need to be spread out, not unpredictable
+        this->m_randomState ^= this->m_randomState << 13;
+        this->m_randomState ^= this->m_randomState >> 17;
+        this->m_randomState ^= this->m_randomState << 5;
+
+        auto node = std::make_unique<Node>();
+        node->piece = piece;
+        node->priority = this->m_randomState;
+        node->subtreeSize = piece.size;
+
+        return node;
+    }
+
+    std::pair<PieceTable::NodePtr, PieceTable::NodePtr> PieceTable::split(NodePtr node, u64 offset) {
+        if (node == nullptr)
+            return { nullptr, nullptr };
+
+        u64 pieceStart = sizeOf(node->left);
+        u64 pieceEnd = pieceStart + node->piece.size;
+
+        if (offset <= pieceStart) {
+            auto [left, right] = this->split(std::move(node->left), offset);
+            node->left = std::move(right);
+            update(node.get());
+
+            return { std::move(left), std::move(node) };
+        } else if (offset >= pieceEnd) {
+            auto [left, right] = this->split(std::move(node->right), offset - pieceEnd);
+            node->right = std::move(left);
+            update(node.get());
+
+            return { std::move(node), std::move(right) };
+        } else {
+            // The tail takes over the priority so it can stay on top of the right subtree
+            u64 cut = offset - pieceStart;
+            auto tail = this->createNode({ node->piece.offset + cut, node->piece.size - cut, node->piece.added });
+            tail->priority = node->priority;
+            tail->right = std::move(node->right);
+            update(tail.get());
+
+            node->piece.size = cut;
+            update(node.get());
+
+            return { std::move(node), std::move(tail) };
+        }
+    }
+
+    PieceTable::NodePtr PieceTable::merge(NodePtr left, NodePtr right) {
+        if (left == nullptr)
+            return right;
+        if (right == nullptr)
+            return left;
+
+        if (left->priority > right->priority) {
+            left->right = merge(std::move(left->right), std::move(right));
+            update(left.get());
+
+            return left;
+        } else {
+            right->left = merge(std::move(left), std::move(right->left));
+            update(right.get());
+
+            return right;
+        }
+    }
+
+    bool PieceTable::extendLast(Node *node, const Piece &piece) {
+        if (node == nullptr)
+            return false;
+
+        if (node->right != nullptr) {
+            if (!extendLast(node->right.get(), piece))
+                return false;
+        } else {
+            if (!node->piece.added || node->piece.offset + node->piece.size != piece.offset)
+                return false;
+
+            node->piece.size += piece.size;
+        }
+
+        node->subtreeSize += piece.size;
+        return true;
+    }
+
+    void PieceTable::insert(u64 offset, const u8 *data, size_t size) {
+        if (size == 0 || offset > this->getSize())
+            return;
+
+        Piece piece = { this->m_addedData.size(), size, true };
+        this->m_addedData.insert(this->m_addedData.end(), data, data + size);
+        this->m_modified = true;
+
+        auto [left, right] = this->split(std::move(this->m_root), offset);
+
+        // Typing appends to the added data right behind the previous input, grow that piece instead of adding one per keystroke
+        if (!extendLast(left.get(), piece))
+            left = merge(std::move(left), this->createNode(piece));
+
+        this->m_root = merge(std::move(left), std::move(right));
+    }
+
+    void PieceTable::erase(u64 offset, size_t size) {
+        if (size == 0 || offset >= this->getSize())
+            return;
+
+        this->m_modified = true;
+
+        auto [left, rest] = this->split(std::move(this->m_root), offset);
+        auto [removed, right] = this->split(std::move(rest), size);
+
+        this->m_root = merge(std::move(left), std::move(right));
+    }
+
+    void PieceTable::appendOriginal(u64 offset, size_t size) {
+        if (size == 0)
+            return;
+
+        this->m_root = merge(std::move(this->m_root), this->createNode({ offset, size, false }));
+    }
+
+    size_t PieceTable::getSize() const {
+        return sizeOf(this->m_root);
+    }
+
+    void PieceTable::visit(const Node *node, u64 nodeStart, u64 offset, u64 end, const std::function<void(const Piece&)> &callback) const {
+        if (node == nullptr || nodeStart >= end || nodeStart + node->subtreeSize <= offset)
+            return;
+
+        this->visit(node->left.get(), nodeStart, offset, end, callback);
+
+        u64 pieceStart = nodeStart + sizeOf(node->left);
+        u64 pieceEnd = pieceStart + node->piece.size;
+        if (pieceStart < end && pieceEnd > offset) {
+            u64 from = std::max(offset, pieceStart);
+            u64 to = std::min(end, pieceEnd);
+
+            callback({ node->piece.offset + (from - pieceStart), to - from, node->piece.added });
+        }
+
+        this->visit(node->right.get(), pieceEnd, offset, end, callback);
+    }
+
+    void PieceTable::forEachPiece(u64 offset, size_t size, const std::function<void(const Piece&)> &callback) const {
+        this->visit(this->m_root.get(), 0, offset, offset + size, callback);
+    }
+
+    void PieceTable::read(u64 offset, u8 *buffer, size_t size, const std::function<void(u64, u8*, size_t)> &readOriginal) const {
+        this->forEachPiece(offset, size, [&](const Piece &piece) {
+            if (piece.added)
+                std::memcpy(buffer, this->m_addedData.data() + piece.offset, piece.size);
+            else
+                readOriginal(piece.offset, buffer, piece.size);
+
+            buffer += piece.size;
+        });
+    }
+
+    std::optional<u64> PieceTable::getOriginalOffset(u64 offset, size_t size) const {
+        const Node *node = this->m_root.get();
+
+        while (node != nullptr) {
+            u64 pieceStart = sizeOf(node->left);
+
+            if (offset < pieceStart)
+                node = node->left.get();
+            else if (offset - pieceStart < node->piece.size) {
+                offset -= pieceStart;
+
+                if (node->piece.added || offset + size > node->piece.size)
+                    return { };
+
+                return node->piece.offset + offset;
+            } else {
+                offset -= pieceStart + node->piece.size;
+                node = node->right.get();
+            }
+        }
+
+        return { };
+    }
+
+}
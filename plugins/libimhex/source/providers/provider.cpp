@@ -1,49 +1,713 @@
 #include <hex/providers/provider.hpp>
 
 #include <hex.hpp>
+#include <hex/api/task.hpp>
+#include <hex/helpers/profiler.hpp>
+#include <hex/helpers/tracing.hpp>
 
+#include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <cstdio>
+#include <cstring>
 #include <map>
 #include <optional>
 #include <string>
 
 namespace hex::prv {
 
-    Provider::Provider() {
-        this->m_patches.emplace_back();
+    Provider::Provider() : m_blockCacheBudget("hex.memory.block_cache", [this](size_t bytes) { return this->evictBlockCache(bytes); }) {
+
     }
 
     Provider::~Provider() {
         for (auto &overlay : this->m_overlays)
-            this->deleteOverlay(overlay);
+            delete overlay;
     }
 
     void Provider::read(u64 offset, void *buffer, size_t size) {
-        this->readRaw(offset, buffer, size);
+        if ((offset + size) > this->getSize() || buffer == nullptr || size == 0)
+            return;
+
+        this->readAbsolute(PageSize * this->m_currPage + offset, buffer, size);
+    }
+
+    void Provider::readAbsolute(u64 address, void *buffer, size_t size) {
+        auto state = this->getReadState();
+
+        if ((address + size) > this->getActualSize(*state) || buffer == nullptr || size == 0)
+            return;
+
+        Profiler::countRead(size);
+        TRACE_SCOPE("Read", "provider", size);
+
+        this->readData(*state, address, reinterpret_cast<u8*>(buffer), size);
+
+        bool patched = state->patches.overlay(address, reinterpret_cast<u8*>(buffer), size);
+        if (!state->transactionPatches.empty())
+            patched = state->transactionPatches.overlay(address, reinterpret_cast<u8*>(buffer), size) || patched;
+
+        if (IOStatistics::isEnabled())
+            this->m_ioStatistics.countRead(size, patched);
+
+        if (this->m_hasOverlayData)
+            this->applyOverlays(address, reinterpret_cast<u8*>(buffer), size);
+    }
+
+    void Provider::readData(const ReadState &state, u64 address, u8 *buffer, size_t size) {
+        auto readOriginal = [this](u64 offset, u8 *buffer, size_t size) {
+            if (this->m_blockCacheSize > 0)
+                this->readCached(offset, buffer, size);
+            else
+                this->readRawCounted(offset, buffer, size);
+        };
+
+        if (state.pieces != nullptr)
+            state.pieces->read(address, buffer, size, readOriginal);
+        else
+            readOriginal(address, buffer, size);
+    }
+
+    std::shared_ptr<const Provider::ReadState> Provider::getReadState() {
+        if (this->m_readStateOutdated) {
+            std::scoped_lock lock(this->m_editMutex);
+
+            if (this->m_readStateOutdated) {
+                auto state = std::make_shared<ReadState>();
+                state->patches = this->m_patches;
+                if (this->m_transactionDepth > 0)
+                    state->transactionPatches = this->m_transactionPatches;
+                if (this->m_pieces->isModified())
+                    state->pieces = this->m_pieces;
+
+                std::atomic_store_explicit(&this->m_readState, std::shared_ptr<const ReadState>(std::move(state)), std::memory_order_release);
+                this->m_readStateOutdated = false;
+            }
+        }
+
+        return std::atomic_load_explicit(&this->m_readState, std::memory_order_acquire);
+    }
+
+    PieceTable& Provider::detachPieces() {
+        // New states only get published while holding the edit lock, so if no state uses the pieces right now none can start to
+        if (this->m_pieces.use_count() > 1)
+            this->m_pieces = std::make_shared<PieceTable>(*this->m_pieces);
+
+        return *this->m_pieces;
     }
 
     void Provider::write(u64 offset, const void *buffer, size_t size) {
-        this->writeRaw(offset, buffer, size);
+        std::scoped_lock lock(this->m_editMutex);
+
+        u64 pageStart = PageSize * this->m_currPage;
+        if ((pageStart + offset + size) > std::min<u64>(this->getEditedSize(), pageStart + PageSize) || buffer == nullptr || size == 0)
+            return;
+
+        this->addPatch(pageStart + offset, buffer, size);
+    }
+
+    void Provider::writeAbsolute(u64 address, const void *buffer, size_t size) {
+        std::scoped_lock lock(this->m_editMutex);
+
+        if ((address + size) > this->getEditedSize() || buffer == nullptr || size == 0)
+            return;
+
+        this->addPatch(address, buffer, size);
     }
 
 
-    std::map<u64, u8>& Provider::getPatches() {
-        return this->m_patches.back();
+    std::optional<std::span<const u8>> Provider::getDirectView(u64 offset, size_t size) {
+        if ((offset + size) > this->getSize())
+            return { };
+
+        return this->getAbsoluteDirectView(PageSize * this->m_currPage + offset, size);
+    }
+
+    std::optional<std::span<const u8>> Provider::getAbsoluteDirectView(u64 address, size_t size) {
+        auto state = this->getReadState();
+
+        auto mappedData = this->getMappedData();
+        if (mappedData == nullptr || (address + size) > this->getActualSize(*state))
+            return { };
+
+        if (state->patches.overlaps(address, size) || state->transactionPatches.overlaps(address, size) || this->overlaysOverlap(address, size))
+            return { };
+
+        if (state->pieces != nullptr) {
+            auto originalAddress = state->pieces->getOriginalOffset(address, size);
+            if (!originalAddress.has_value())
+                return { };
+
+            address = *originalAddress;
+        }
+
+        return std::span<const u8>(mappedData + address, size);
+    }
+
+    bool Provider::hasCapability(Capability capability) {
+        return (this->getCapabilities() & capability) == capability;
+    }
+
+    u32 Provider::getReadWorkerCount(u32 workers) {
+        if (workers == 0)
+            workers = TaskManager::getWorkerCount();
+
+        if (!this->hasCapability(Capability::ThreadSafeReads))
+            workers = std::min<u32>(workers, 2);
+
+        return std::max<u32>(workers, 1);
+    }
+
+    PatchStore Provider::getPatches() {
+        return this->getReadState()->patches;
+    }
+
+    void Provider::setPatches(const PatchStore &patches) {
+        std::scoped_lock lock(this->m_editMutex);
+
+        this->m_patches = patches;
+        this->m_readStateOutdated = true;
+    }
+
+    void Provider::erasePatches(u64 address, size_t size) {
+        std::scoped_lock lock(this->m_editMutex);
+
+        this->m_patches.erase(address, size);
+        this->m_readStateOutdated = true;
     }
 
     void Provider::applyPatches() {
-        for (auto &[patchAddress, patch] : this->m_patches.back())
-            this->writeRaw(patchAddress, &patch, 1);
+        std::scoped_lock lock(this->m_editMutex);
+
+        // Patch addresses don't match the underlying data anymore, the only way to keep them is saving to a new file
+        if (this->m_pieces->isModified())
+            return;
+
+        for (auto &[patchAddress, patch] : this->m_patches.getRuns()) {
+            this->writeRaw(patchAddress, patch.data(), patch.size());
+            this->invalidateBlockCache(patchAddress, patch.size());
+        }
+    }
+
+    bool Provider::saveAs(const std::string &path) {
+        FILE *file = fopen(path.c_str(), "wb");
+        if (file == nullptr)
+            return false;
+        SCOPE_EXIT( fclose(file); );
+
+        // Edits made while saving don't end up in the file, all of it gets written the way it was when saving started
+        auto state = this->getReadState();
+
+        size_t dataSize = this->getActualSize(*state);
+        std::vector<u8> buffer(std::min<u64>(SaveBlockSize, dataSize));
+        for (u64 offset = 0; offset < dataSize; offset += buffer.size()) {
+            size_t blockSize = std::min<u64>(buffer.size(), dataSize - offset);
+
+            this->readData(*state, offset, buffer.data(), blockSize);
+            state->patches.overlay(offset, buffer.data(), blockSize);
+
+            if (fwrite(buffer.data(), 1, blockSize, file) != blockSize)
+                return false;
+        }
+
+        return true;
+    }
+
+    void Provider::insert(u64 address, const void *buffer, size_t size) {
+        std::scoped_lock lock(this->m_editMutex);
+
+        if (address > this->getEditedSize() || buffer == nullptr || size == 0)
+            return;
+
+        auto &pieces = this->detachPieces();
+        if (!pieces.isModified())
+            pieces.reset(this->getRawSize());
+
+        pieces.insert(address, reinterpret_cast<const u8*>(buffer), size);
+        this->m_patches.move(address, size);
+        this->m_transactionPatches.move(address, size);
+        this->m_readStateOutdated = true;
+
+        // Edit records only know about overwritten bytes, undoing them at their old addresses would hit the wrong data
+        this->clearUndoHistory();
+    }
+
+    void Provider::remove(u64 address, size_t size) {
+        std::scoped_lock lock(this->m_editMutex);
+
+        if (address >= this->getEditedSize() || size == 0)
+            return;
+
+        size = std::min<u64>(size, this->getEditedSize() - address);
+
+        auto &pieces = this->detachPieces();
+        if (!pieces.isModified())
+            pieces.reset(this->getRawSize());
+
+        pieces.erase(address, size);
+        this->m_patches.erase(address, size);
+        this->m_patches.move(address + size, -s64(size));
+        this->m_transactionPatches.erase(address, size);
+        this->m_transactionPatches.move(address + size, -s64(size));
+        this->m_readStateOutdated = true;
+
+        this->clearUndoHistory();
+    }
+
+    bool Provider::hasStructuralChanges() {
+        return this->getReadState()->pieces != nullptr;
+    }
+
+    const PieceTable& Provider::getPieces() const {
+        return *this->m_pieces;
+    }
+
+    void Provider::appendRawData(size_t oldSize) {
+        {
+            std::scoped_lock lock(this->m_editMutex);
+
+            if (this->m_pieces->isModified() && this->getRawSize() > oldSize) {
+                this->detachPieces().appendOriginal(oldSize, this->getRawSize() - oldSize);
+                this->m_readStateOutdated = true;
+            }
+        }
+
+        this->invalidateBlockCache(oldSize, this->getRawSize() - oldSize);
+    }
+
+    size_t Provider::getActualSize() {
+        return this->getActualSize(*this->getReadState());
+    }
+
+    size_t Provider::getActualSize(const ReadState &state) {
+        if (state.pieces != nullptr)
+            return state.pieces->getSize();
+        else
+            return this->getRawSize();
+    }
+
+    size_t Provider::getEditedSize() {
+        if (this->m_pieces->isModified())
+            return this->m_pieces->getSize();
+        else
+            return this->getRawSize();
+    }
+
+    void Provider::addPatch(u64 offset, const void *buffer, size_t size) {
+        std::scoped_lock lock(this->m_editMutex);
+        this->m_readStateOutdated = true;
+
+        if (this->m_transactionDepth > 0) {
+            this->m_transactionPatches.write(offset, reinterpret_cast<const u8*>(buffer), size);
+            return;
+        }
+
+        EditRecord record;
+        record.edits.push_back(this->applyEdit(offset, reinterpret_cast<const u8*>(buffer), size));
+
+        this->pushEditRecord(std::move(record));
+    }
+
+    Provider::EditRecord::Edit Provider::applyEdit(u64 offset, const u8 *data, size_t size) {
+        EditRecord::Edit edit;
+        edit.offset = offset;
+        edit.oldValues.resize(size);
+        edit.newValues.assign(data, data + size);
+
+        if (this->m_patches.overlaps(offset, size)) {
+            for (u64 i = 0; i < size; i++)
+                edit.oldValues[i] = this->m_patches.get(offset + i);
+        }
+
+        this->m_patches.write(offset, edit.newValues.data(), size);
+
+        return edit;
+    }
+
+    void Provider::pushEditRecord(EditRecord &&record) {
+        // Any new edit invalidates everything that could have been redone
+        while (this->m_editLog.size() > this->m_editLogPosition) {
+            this->m_editLogMemoryUsage -= this->m_editLog.back().getMemoryUsage();
+            this->m_editLog.pop_back();
+        }
+
+        this->m_editLogMemoryUsage += record.getMemoryUsage();
+        this->m_editLog.push_back(std::move(record));
+        this->m_editLogPosition = this->m_editLog.size();
+
+        this->trimUndoHistory();
+    }
+
+    Region Provider::EditRecord::getRegion() const {
+        if (this->edits.empty())
+            return { 0, 0 };
+
+        u64 start = this->edits.front().offset, end = start;
+        for (const auto &edit : this->edits) {
+            start = std::min(start, edit.offset);
+            end = std::max<u64>(end, edit.offset + edit.newValues.size());
+        }
+
+        return { start, end - start };
+    }
+
+    Region Provider::undo() {
+        std::scoped_lock lock(this->m_editMutex);
+
+        if (!this->canUndo())
+            return { 0, 0 };
+
+        this->m_editLogPosition--;
+
+        const auto &record = this->m_editLog[this->m_editLogPosition];
+        for (auto edit = record.edits.rbegin(); edit != record.edits.rend(); ++edit) {
+            this->m_patches.erase(edit->offset, edit->oldValues.size());
+
+            for (u64 i = 0; i < edit->oldValues.size(); i++) {
+                if (edit->oldValues[i].has_value())
+                    this->m_patches.write(edit->offset + i, &edit->oldValues[i].value(), 1);
+            }
+        }
+        this->m_readStateOutdated = true;
+
+        return record.getRegion();
+    }
+
+    Region Provider::redo() {
+        std::scoped_lock lock(this->m_editMutex);
+
+        if (!this->canRedo())
+            return { 0, 0 };
+
+        const auto &record = this->m_editLog[this->m_editLogPosition];
+        for (const auto &edit : record.edits)
+            this->m_patches.write(edit.offset, edit.newValues.data(), edit.newValues.size());
+
+        this->m_editLogPosition++;
+        this->m_readStateOutdated = true;
+
+        return record.getRegion();
+    }
+
+    void Provider::beginTransaction() {
+        std::scoped_lock lock(this->m_editMutex);
+
+        this->m_transactionDepth++;
+    }
+
+    void Provider::commitTransaction() {
+        std::scoped_lock lock(this->m_editMutex);
+
+        if (this->m_transactionDepth == 0 || --this->m_transactionDepth > 0)
+            return;
+
+        // The collected runs never overlap, so reading the old values of one can't see the new values of another
+        EditRecord record;
+        for (const auto &[address, bytes] : this->m_transactionPatches.getRuns())
+            record.edits.push_back(this->applyEdit(address, bytes.data(), bytes.size()));
+
+        this->m_transactionPatches.clear();
+        this->m_readStateOutdated = true;
+
+        if (!record.edits.empty())
+            this->pushEditRecord(std::move(record));
+    }
+
+    void Provider::rollbackTransaction() {
+        std::scoped_lock lock(this->m_editMutex);
+
+        this->m_transactionDepth = 0;
+        this->m_transactionPatches.clear();
+        this->m_readStateOutdated = true;
+    }
+
+    bool Provider::isInTransaction() const {
+        return this->m_transactionDepth > 0;
+    }
+
+    bool Provider::canUndo() const {
+        return this->m_editLogPosition > 0;
+    }
+
+    bool Provider::canRedo() const {
+        return this->m_editLogPosition < this->m_editLog.size();
+    }
+
+    void Provider::clearUndoHistory() {
+        std::scoped_lock lock(this->m_editMutex);
+
+        this->m_editLog.clear();
+        this->m_editLogPosition = 0;
+        this->m_editLogMemoryUsage = 0;
+    }
+
+    void Provider::setUndoHistoryBudget(size_t budget) {
+        std::scoped_lock lock(this->m_editMutex);
+
+        this->m_undoHistoryBudget = budget;
+        this->trimUndoHistory();
+    }
+
+    size_t Provider::getUndoHistoryBudget() const {
+        return this->m_undoHistoryBudget;
+    }
+
+    void Provider::trimUndoHistory() {
+        // Drop the oldest records first. The patches themselves stay, they just can't be undone anymore
+        while (this->m_editLogMemoryUsage > this->m_undoHistoryBudget && !this->m_editLog.empty()) {
+            this->m_editLogMemoryUsage -= this->m_editLog.front().getMemoryUsage();
+            this->m_editLog.pop_front();
+
+            if (this->m_editLogPosition > 0)
+                this->m_editLogPosition--;
+        }
+    }
+
+
+    void Provider::setBlockCacheSize(size_t size) {
+        std::scoped_lock lock(this->m_blockCacheMutex);
+
+        this->m_blockCacheSize = size;
+        this->trimBlockCache();
+    }
+
+    size_t Provider::getBlockCacheSize() const {
+        return this->m_blockCacheSize;
+    }
+
+    void Provider::invalidateBlockCache() {
+        std::scoped_lock lock(this->m_blockCacheMutex);
+
+        this->m_blockCache.clear();
+        this->m_blockCacheLookup.clear();
+        this->m_blockCacheBudget.update(0);
+    }
+
+    void Provider::invalidateBlockCache(u64 offset, size_t size) {
+        std::scoped_lock lock(this->m_blockCacheMutex);
+
+        if (size == 0 || this->m_blockCache.empty())
+            return;
+
+        u64 firstBlock = offset / BlockCacheBlockSize;
+        u64 lastBlock = (offset + size - 1) / BlockCacheBlockSize;
+
+        // Large ranges touch more blocks than are cached, walk the cache instead of the range then
+        if (lastBlock - firstBlock >= this->m_blockCache.size()) {
+            std::erase_if(this->m_blockCacheLookup, [&](const auto &entry) { return entry.first >= firstBlock && entry.first <= lastBlock; });
+            std::erase_if(this->m_blockCache, [&](const auto &block) { return block.index >= firstBlock && block.index <= lastBlock; });
+        } else {
+            for (u64 block = firstBlock; block <= lastBlock; block++) {
+                if (auto it = this->m_blockCacheLookup.find(block); it != this->m_blockCacheLookup.end()) {
+                    this->m_blockCache.erase(it->second);
+                    this->m_blockCacheLookup.erase(it);
+                }
+            }
+        }
+
+        this->m_blockCacheBudget.update(this->m_blockCache.size() * BlockCacheBlockSize);
+    }
+
+    u64 Provider::getBlockCacheHits() const {
+        return this->m_blockCacheHits;
+    }
+
+    u64 Provider::getBlockCacheMisses() const {
+        return this->m_blockCacheMisses;
+    }
+
+    void Provider::readCached(u64 offset, void *buffer, size_t size) {
+        std::scoped_lock lock(this->m_blockCacheMutex);
+
+        auto output = reinterpret_cast<u8*>(buffer);
+        u64 end = offset + size;
+        size_t actualSize = this->getRawSize();
+
+        while (offset < end) {
+            u64 blockIndex = offset / BlockCacheBlockSize;
+            u64 blockStart = blockIndex * BlockCacheBlockSize;
+
+            const u8 *data;
+            u64 dataStart, dataSize;
+            std::vector<u8> missedData;
+
+            auto it = this->m_blockCacheLookup.find(blockIndex);
+            if (it != this->m_blockCacheLookup.end()) {
+                this->m_blockCacheHits++;
+                if (IOStatistics::isEnabled())
+                    this->m_ioStatistics.countCacheAccess(1, 0);
+
+                // Move the block to the front so it gets evicted last
+                this->m_blockCache.splice(this->m_blockCache.begin(), this->m_blockCache, it->second);
+
+                data = it->second->data.data();
+                dataStart = blockStart;
+                dataSize = it->second->data.size();
+            } else {
+                if (blockStart >= actualSize)
+                    break;
+
+                // Consecutive missing blocks get read with a single call so providers can fetch all of them at once
+                u64 endBlock = (std::min<u64>(end, actualSize) + BlockCacheBlockSize - 1) / BlockCacheBlockSize;
+                u64 lastBlock = blockIndex + 1;
+                while (lastBlock < endBlock && !this->m_blockCacheLookup.contains(lastBlock))
+                    lastBlock++;
+
+                this->m_blockCacheMisses += lastBlock - blockIndex;
+                if (IOStatistics::isEnabled())
+                    this->m_ioStatistics.countCacheAccess(0, lastBlock - blockIndex);
+
+                missedData.resize(std::min<u64>(lastBlock * BlockCacheBlockSize, actualSize) - blockStart);
+                this->readRawCounted(blockStart, missedData.data(), missedData.size());
+
+                // Inserted back to front so the first block of the run ends up being the most recently used one
+                for (u64 block = lastBlock; block > blockIndex; block--) {
+                    u64 blockOffset = (block - 1 - blockIndex) * BlockCacheBlockSize;
+                    u64 blockSize = std::min<u64>(BlockCacheBlockSize, missedData.size() - blockOffset);
+
+                    this->m_blockCache.push_front({ block - 1, std::vector<u8>(missedData.begin() + blockOffset, missedData.begin() + blockOffset + blockSize) });
+                    this->m_blockCacheLookup.emplace(block - 1, this->m_blockCache.begin());
+                }
+
+                data = missedData.data();
+                dataStart = blockStart;
+                dataSize = missedData.size();
+            }
+
+            u64 copyStart = offset - dataStart;
+            if (copyStart >= dataSize)
+                break;
+
+            u64 copySize = std::min<u64>(end - offset, dataSize - copyStart);
+
+            std::memcpy(output, data + copyStart, copySize);
+
+            output += copySize;
+            offset += copySize;
+        }
+
+        this->trimBlockCache();
+    }
+
+    void Provider::readRawCounted(u64 offset, void *buffer, size_t size) {
+        if (!IOStatistics::isEnabled()) {
+            this->readRaw(offset, buffer, size);
+            return;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        this->readRaw(offset, buffer, size);
+        auto time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+        this->m_ioStatistics.countRawRead(size, time);
+    }
+
+    void Provider::trimBlockCache() {
+        while (!this->m_blockCache.empty() && this->m_blockCache.size() * BlockCacheBlockSize > this->m_blockCacheSize) {
+            this->m_blockCacheLookup.erase(this->m_blockCache.back().index);
+            this->m_blockCache.pop_back();
+        }
+
+        this->m_blockCacheBudget.update(this->m_blockCache.size() * BlockCacheBlockSize);
+    }
+
+    size_t Provider::evictBlockCache(size_t bytes) {
+        std::scoped_lock lock(this->m_blockCacheMutex);
+
+        size_t freed = 0;
+        while (!this->m_blockCache.empty() && freed < bytes) {
+            this->m_blockCacheLookup.erase(this->m_blockCache.back().index);
+            this->m_blockCache.pop_back();
+            freed += BlockCacheBlockSize;
+        }
+
+        return freed;
     }
 
 
     Overlay* Provider::newOverlay() {
-        return this->m_overlays.emplace_back(new Overlay());
+        std::scoped_lock lock(this->m_overlayMutex);
+
+        return this->m_overlays.emplace_back(new Overlay(this));
     }
 
     void Provider::deleteOverlay(Overlay *overlay) {
+        std::scoped_lock lock(this->m_overlayMutex);
+
         this->m_overlays.erase(std::find(this->m_overlays.begin(), this->m_overlays.end(), overlay));
         delete overlay;
+
+        this->rebuildOverlayIndex();
+    }
+
+    void Provider::rebuildOverlayIndex() {
+        auto &index = this->m_overlayIndex;
+        index.clear();
+
+        // Later overlays get painted over earlier ones
+        for (const auto overlay : this->m_overlays) {
+            if (overlay->getSize() == 0)
+                continue;
+
+            u64 start = overlay->getAddress();
+            u64 end = start + overlay->getSize();
+
+            auto it = index.upper_bound(start);
+            if (it != index.begin()) {
+                auto prev = std::prev(it);
+                if (prev->second.end > start) {
+                    if (prev->second.end > end)
+                        index.emplace(end, prev->second);
+
+                    if (prev->first == start)
+                        index.erase(prev);
+                    else
+                        prev->second.end = start;
+                }
+            }
+
+            while (it != index.end() && it->first < end) {
+                if (it->second.end > end)
+                    index.emplace(end, it->second);
+
+                it = index.erase(it);
+            }
+
+            index.emplace(start, OverlaySegment { end, overlay });
+        }
+
+        this->m_hasOverlayData = !index.empty();
+    }
+
+    void Provider::applyOverlays(u64 offset, u8 *buffer, size_t size) {
+        std::scoped_lock lock(this->m_overlayMutex);
+
+        u64 end = offset + size;
+
+        auto it = this->m_overlayIndex.upper_bound(offset);
+        if (it != this->m_overlayIndex.begin() && std::prev(it)->second.end > offset)
+            it = std::prev(it);
+
+        for (; it != this->m_overlayIndex.end() && it->first < end; it++) {
+            u64 copyStart = std::max<u64>(offset, it->first);
+            u64 copyEnd = std::min<u64>(end, it->second.end);
+
+            const auto &overlay = *it->second.overlay;
+            overlay.getData().read(copyStart - overlay.getAddress(), buffer + (copyStart - offset), copyEnd - copyStart);
+        }
+    }
+
+    bool Provider::overlaysOverlap(u64 offset, size_t size) {
+        if (!this->m_hasOverlayData)
+            return false;
+
+        std::scoped_lock lock(this->m_overlayMutex);
+
+        auto it = this->m_overlayIndex.upper_bound(offset);
+        if (it != this->m_overlayIndex.begin() && std::prev(it)->second.end > offset)
+            return true;
+
+        return it != this->m_overlayIndex.end() && it->first < offset + size;
     }
 
     const std::list<Overlay*>& Provider::getOverlays() {
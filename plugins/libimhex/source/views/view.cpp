@@ -1,6 +1,7 @@
 #include <hex/views/view.hpp>
 
 #include <imgui.h>
+#include <imgui_internal.h>
 
 #include <functional>
 #include <string>
@@ -24,8 +25,15 @@ namespace hex {
         return SharedData::deferredCalls;
     }
 
-    std::vector<std::any> View::postEvent(Events eventType, const std::any &userData) {
-        return EventManager::post(eventType, userData);
+    void View::requestRedraw() {
+        SharedData::redrawRequested = true;
+
+        if (SharedData::wakeUpMainLoop != nullptr)
+            SharedData::wakeUpMainLoop();
+    }
+
+    void View::postEvent(Events eventType, const std::any &userData) {
+        EventManager::post(eventType, userData);
     }
 
     void View::openFileBrowser(std::string_view title, DialogMode mode, const std::vector<nfdfilteritem_t> &validExtensions, const std::function<void(std::string)> &callback) {
@@ -89,6 +97,23 @@ namespace hex {
         return this->m_windowOpen;
     }
 
+    void View::updateVisibility() {
+        // Windows that weren't begun this frame aren't active, collapsed ones and background tabs of a dock skip all their items
+        auto window = ImGui::FindWindowByName(View::toWindowName(this->m_unlocalizedViewName).c_str());
+
+        this->m_visible = window != nullptr && window->Active && !window->SkipItems;
+    }
+
+    bool View::refreshContent(const std::function<void()> &refresh) {
+        if (!this->m_contentInvalidated)
+            return false;
+
+        this->m_contentInvalidated = false;
+        refresh();
+
+        return true;
+    }
+
     std::string_view View::getUnlocalizedName() const {
         return this->m_unlocalizedViewName;
     }
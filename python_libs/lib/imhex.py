@@ -1,2 +1,15 @@
 from _imhex import *
-import imhex_python.types as types
\ No newline at end of file
+import imhex_python.types as types
+
+from contextlib import contextmanager
+
+@contextmanager
+def transaction():
+    begin_transaction()
+    try:
+        yield
+    except:
+        rollback_transaction()
+        raise
+    else:
+        commit_transaction()
\ No newline at end of file
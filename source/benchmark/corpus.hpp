@@ -0,0 +1,121 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <string_view>
+#include <vector>
+
+namespace hex::benchmark {
+
+    /* Generated from a fixed seed, so results of different builds can be compared with each other */
+    constexpr u64 CorpusSeed = 0x1337'5EED;
+    constexpr size_t SegmentSize = 0x1'0000;
+    constexpr size_t TableEntryCount = 0x1000;
+
+    /*
+        A table the benchmark pattern parses, followed by segments of random bytes, ASCII and UTF-16 text,
+        zeros and repetitive instruction-like data
+    */
+    inline std::vector<u8> generateCorpus(size_t size) {
+        std::mt19937_64 random(CorpusSeed);
+        std::vector<u8> data;
+        data.reserve(size);
+
+        auto append = [&](const void *value, size_t count) {
+            auto bytes = static_cast<const u8*>(value);
+            data.insert(data.end(), bytes, bytes + count);
+        };
+
+        append("BNCH", 4);
+        u32 entryCount = TableEntryCount;
+        append(&entryCount, sizeof(entryCount));
+        for (size_t i = 0; i < TableEntryCount; i++) {
+            u8 type = 1 + random() % 3;
+            u8 flags = random();
+            u16 length = random();
+            u32 value = random();
+
+            append(&type, sizeof(type));
+            append(&flags, sizeof(flags));
+            append(&length, sizeof(length));
+            append(&value, sizeof(value));
+            if (length > 0x8000)
+                append(&value, sizeof(value));
+        }
+
+        constexpr std::string_view Words[] = { "hex", "editor", "pattern", "provider", "entropy", "string", "analysis", "data", "offset", "region", "the", "of", "and" };
+        constexpr u8 Instructions[] = { 0x48, 0x8B, 0x45, 0xF8, 0x89, 0xC7, 0xE8, 0x00, 0x10, 0x00, 0x00, 0x48, 0x83, 0xC4, 0x08, 0xC3 };
+
+        for (u32 segment = 0; data.size() < size; segment++) {
+            size_t end = std::min(data.size() + SegmentSize, size);
+
+            switch (segment % 5) {
+                case 0:
+                    while (data.size() < end)
+                        data.push_back(random());
+                    break;
+                case 1:
+                case 2:
+                    while (data.size() < end) {
+                        auto word = Words[random() % std::size(Words)];
+                        for (char c : word) {
+                            data.push_back(c);
+                            if (segment % 5 == 2)
+                                data.push_back(0x00);
+                        }
+                        data.push_back(random() % 8 == 0 ? 0x00 : ' ');
+                    }
+                    break;
+                case 3:
+                    data.resize(end, 0x00);
+                    break;
+                case 4:
+                    while (data.size() < end)
+                        data.push_back(Instructions[data.size() % std::size(Instructions)] ^ (random() % 16 == 0 ? random() : 0));
+                    break;
+            }
+
+            data.resize(std::min(data.size(), end));
+        }
+
+        return data;
+    }
+
+    /* Parses the table at the start of the corpus */
+    constexpr auto BenchmarkPattern = R"(
+        enum Type : u8 {
+            Header = 1,
+            Data,
+            Padding
+        };
+
+        bitfield Flags {
+            compressed : 1;
+            level : 3;
+            reserved : 4;
+        };
+
+        struct Entry {
+            Type type;
+            Flags flags;
+            u16 length;
+            u32 value;
+
+            if (length > 0x8000) {
+                u32 extra;
+            }
+        };
+
+        struct Table {
+            char magic[4];
+            u32 count;
+            Entry entries[count];
+        };
+
+        Table table @ 0x00;
+    )";
+
+}
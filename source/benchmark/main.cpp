@@ -0,0 +1,312 @@
+#include <hex.hpp>
+
+#include <hex/providers/provider.hpp>
+#include <hex/helpers/arena.hpp>
+#include <hex/helpers/crypto.hpp>
+#include <hex/helpers/entropy.hpp>
+#include <hex/helpers/search.hpp>
+#include <hex/helpers/string_search.hpp>
+#include <hex/helpers/utils.hpp>
+#include <hex/lang/lexer.hpp>
+#include <hex/lang/parser.hpp>
+#include <hex/lang/preprocessor.hpp>
+#include <hex/lang/pattern_language.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <numeric>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "corpus.hpp"
+#include "memory_provider.hpp"
+
+/*
+    Measures the engines behind ImHex's analyses on a synthetic data corpus. The corpus is generated from a fixed seed,
+    so results of different builds can be compared with each other. Results are written out as JSON
+*/
+
+using namespace hex;
+using namespace hex::benchmark;
+
+namespace {
+
+    /* The benchmark pattern with many more type declarations added, so lexing and parsing take long enough to be measured */
+    std::string generateParserSource() {
+        std::string source = BenchmarkPattern;
+
+        for (u32 i = 0; i < 0x400; i++)
+            source += hex::format("struct Generated{0} {{ u32 a; u16 b[4]; Entry entry; be u64 c; padding[{1}]; }};\n", i, i % 16 + 1);
+
+        return source;
+    }
+
+    struct Options {
+        size_t corpusSize = 0x400'0000;
+        u32 iterations = 5;
+        std::string filter;
+        std::string outputPath;
+    };
+
+    class BenchmarkRunner {
+    public:
+        explicit BenchmarkRunner(const Options &options) : m_options(options) { }
+
+        /* Runs the function once to warm up and then as often as requested. bytes is the amount of data one run processes */
+        void run(std::string_view name, u64 bytes, const std::function<u64()> &function) {
+            if (!this->m_options.filter.empty() && name.find(this->m_options.filter) == std::string_view::npos)
+                return;
+
+            std::fprintf(stderr, "%-32.*s", int(name.size()), name.data());
+
+            u64 checksum = function();
+
+            std::vector<double> times;
+            for (u32 i = 0; i < this->m_options.iterations; i++) {
+                auto start = std::chrono::steady_clock::now();
+                checksum ^= function();
+                times.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+            }
+
+            std::sort(times.begin(), times.end());
+            double median = times[times.size() / 2];
+            double mean = std::accumulate(times.begin(), times.end(), 0.0) / times.size();
+
+            std::fprintf(stderr, "%10.3f ms%12.1f MiB/s\n", median * 1000, bytes / median / 0x10'0000);
+
+            // The checksum keeps results from being optimized away and shows if a change altered what got computed
+            this->m_results.push_back({
+                { "name", name },
+                { "bytes", bytes },
+                { "iterations", times.size() },
+                { "min", times.front() },
+                { "median", median },
+                { "mean", mean },
+                { "max", times.back() },
+                { "throughput", bytes / median },
+                { "checksum", checksum }
+            });
+        }
+
+        [[nodiscard]] nlohmann::json getResults() const { return this->m_results; }
+
+    private:
+        const Options &m_options;
+        nlohmann::json m_results = nlohmann::json::array();
+    };
+
+    void benchmarkProvider(BenchmarkRunner &runner, const std::vector<u8> &corpus) {
+        MemoryProvider clean(corpus), patched(corpus);
+
+        // One patched byte in every 4 KiB of data
+        for (u64 offset = 0; offset < corpus.size(); offset += 0x1000) {
+            u8 value = ~corpus[offset];
+            patched.write(offset, &value, sizeof(value));
+        }
+
+        auto readAll = [&](prv::Provider &provider) {
+            std::vector<u8> buffer(0x1'0000);
+            u64 checksum = 0;
+
+            for (u64 offset = 0; offset < corpus.size(); offset += buffer.size()) {
+                auto size = std::min<u64>(buffer.size(), corpus.size() - offset);
+                provider.read(offset, buffer.data(), size);
+                checksum += buffer[0];
+            }
+
+            return checksum;
+        };
+
+        runner.run("provider.read", corpus.size(), [&] { return readAll(clean); });
+        runner.run("provider.read.patched", corpus.size(), [&] { return readAll(patched); });
+
+        // Small reads at random positions, like scrolling through the hex editor and the data inspector do
+        runner.run("provider.read.random", 0x10'0000 * 16, [&] {
+            std::mt19937_64 random(CorpusSeed);
+            u64 checksum = 0;
+            u8 buffer[16];
+
+            for (u32 i = 0; i < 0x10'0000; i++) {
+                patched.read(random() % (corpus.size() - sizeof(buffer)), buffer, sizeof(buffer));
+                checksum += buffer[0];
+            }
+
+            return checksum;
+        });
+    }
+
+    void benchmarkSearch(BenchmarkRunner &runner, prv::Provider *provider) {
+        auto search = [&](const SequenceSearcher &searcher) {
+            u64 occurrences = 0;
+            searcher.search(provider, 0, provider->getActualSize(), [&](u64, size_t) {
+                occurrences++;
+                return true;
+            });
+
+            return occurrences;
+        };
+
+        SequenceSearcher stringSearcher({ { 'p', 'r', 'o', 'v', 'i', 'd', 'e', 'r' } });
+        runner.run("search.string", provider->getActualSize(), [&] { return search(stringSearcher); });
+
+        std::vector<u8> bytes, mask;
+        SequenceSearcher::parseHexPattern("48 8B ?? ?8 89", bytes, mask);
+        SequenceSearcher hexSearcher({ bytes }, { mask });
+        runner.run("search.hex", provider->getActualSize(), [&] { return search(hexSearcher); });
+    }
+
+    void benchmarkHashes(BenchmarkRunner &runner, prv::Provider *provider) {
+        runner.run("crypt.crc32", provider->getActualSize(), [&] {
+            return crypt::crc32(provider, 0, provider->getActualSize(), 0xEDB8'8320, 0xFFFF'FFFF);
+        });
+
+        runner.run("crypt.sha256", provider->getActualSize(), [&] {
+            auto digest = crypt::sha256(provider, 0, provider->getActualSize());
+
+            u64 checksum;
+            std::memcpy(&checksum, digest.data(), sizeof(checksum));
+            return checksum;
+        });
+    }
+
+    void benchmarkStrings(BenchmarkRunner &runner, prv::Provider *provider) {
+        auto findStrings = [&](StringSearchMode mode) {
+            u64 count = 0;
+            for (u64 offset = 0; offset < provider->getActualSize(); offset += StringSearcher::ChunkSize)
+                count += StringSearcher::searchChunk(provider, offset, std::min<u64>(StringSearcher::ChunkSize, provider->getActualSize() - offset), 5, mode).size();
+
+            return count;
+        };
+
+        runner.run("strings.ascii", provider->getActualSize(), [&] { return findStrings(StringSearchMode::ASCII); });
+        runner.run("strings.all", provider->getActualSize(), [&] { return findStrings(StringSearchMode::All); });
+    }
+
+    void benchmarkEntropy(BenchmarkRunner &runner, prv::Provider *provider) {
+        std::atomic<bool> cancelled = false;
+
+        runner.run("entropy.analyze", provider->getActualSize(), [&] {
+            auto analysis = analyzeEntropy(provider, 0, provider->getActualSize(), 0x1000, cancelled);
+            return u64(analysis.averageEntropy * 1'000'000);
+        });
+
+        runner.run("entropy.map", provider->getActualSize(), [&] {
+            EntropyMap map;
+            auto statistics = map.build(provider, 0, provider->getActualSize(), cancelled);
+            return statistics.valueCounts[0];
+        });
+    }
+
+    void benchmarkPatternLanguage(BenchmarkRunner &runner, prv::Provider *provider) {
+        auto source = generateParserSource();
+
+        lang::Preprocessor preprocessor;
+        auto preprocessed = preprocessor.preprocess(source).value_or("");
+
+        lang::Lexer lexer;
+        runner.run("lang.lexer", preprocessed.size(), [&] {
+            return lexer.lex(preprocessed).value_or(std::vector<lang::Token>()).size();
+        });
+
+        auto tokens = lexer.lex(preprocessed).value_or(std::vector<lang::Token>());
+
+        Arena arena;
+        lang::Parser parser(arena);
+        runner.run("lang.parser", preprocessed.size(), [&] {
+            arena.clear();
+            return parser.parse(tokens).value_or(std::vector<lang::ASTNode*>()).size();
+        });
+
+        // Executing the same code again only evaluates it, the parsed code is kept from the first run
+        lang::PatternLanguage runtime;
+        runner.run("lang.evaluator", provider->getActualSize(), [&] {
+            return runtime.executeString(provider, BenchmarkPattern).value_or(std::vector<lang::PatternData*>()).size() + runtime.getCreatedPatternCount();
+        });
+    }
+
+    bool parseArguments(int argc, char **argv, Options &options) {
+        for (int i = 1; i < argc; i++) {
+            std::string_view argument = argv[i];
+
+            if (i + 1 >= argc) {
+                std::fprintf(stderr, "Missing value for %s\n", argv[i]);
+                return false;
+            }
+
+            if (argument == "--size")
+                options.corpusSize = std::max<size_t>(std::strtoull(argv[++i], nullptr, 10), 1) * 0x10'0000;
+            else if (argument == "--iterations")
+                options.iterations = std::max<u32>(std::strtoul(argv[++i], nullptr, 10), 1);
+            else if (argument == "--filter")
+                options.filter = argv[++i];
+            else if (argument == "--output")
+                options.outputPath = argv[++i];
+            else {
+                std::fprintf(stderr, "Unknown option %s\n", argv[i]);
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+}
+
+int main(int argc, char **argv) {
+    Options options;
+    if (!parseArguments(argc, argv, options)) {
+        std::fprintf(stderr,
+            "Usage: %s [options]\n"
+            "\n"
+            "Options:\n"
+            "  --size <MiB>            Size of the generated corpus, 64 MiB by default\n"
+            "  --iterations <count>    Measured runs of every benchmark, 5 by default\n"
+            "  --filter <text>         Only run benchmarks whose name contains the text\n"
+            "  --output <file>         Write the results to a file instead of stdout\n",
+            argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    auto corpus = generateCorpus(options.corpusSize);
+    MemoryProvider provider(corpus);
+
+    BenchmarkRunner runner(options);
+    benchmarkProvider(runner, corpus);
+    benchmarkSearch(runner, &provider);
+    benchmarkHashes(runner, &provider);
+    benchmarkStrings(runner, &provider);
+    benchmarkEntropy(runner, &provider);
+    benchmarkPatternLanguage(runner, &provider);
+
+    nlohmann::json results = {
+        #if defined(GIT_COMMIT_HASH)
+        { "commit", GIT_COMMIT_HASH },
+        #endif
+        #if defined(IMHEX_VERSION)
+        { "version", IMHEX_VERSION },
+        #endif
+        { "corpusSize", corpus.size() },
+        { "corpusSeed", CorpusSeed },
+        { "benchmarks", runner.getResults() }
+    };
+
+    auto output = results.dump(4);
+    if (options.outputPath.empty()) {
+        std::fprintf(stdout, "%s\n", output.c_str());
+    } else {
+        std::ofstream file(options.outputPath);
+        file << output << '\n';
+    }
+
+    return EXIT_SUCCESS;
+}
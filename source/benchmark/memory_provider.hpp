@@ -0,0 +1,41 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <hex/providers/provider.hpp>
+
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace hex {
+
+    /* Keeps all data in memory and hands it out as mapped data, like a memory mapped file would */
+    class MemoryProvider : public prv::Provider {
+    public:
+        explicit MemoryProvider(std::vector<u8> data) : m_data(std::move(data)) { }
+
+        bool isAvailable() override { return true; }
+        bool isReadable() override { return true; }
+        bool isWritable() override { return true; }
+
+        void readRaw(u64 offset, void *buffer, size_t size) override {
+            std::memcpy(buffer, this->m_data.data() + offset, size);
+        }
+
+        void writeRaw(u64 offset, const void *buffer, size_t size) override {
+            std::memcpy(this->m_data.data() + offset, buffer, size);
+        }
+
+        size_t getRawSize() override { return this->m_data.size(); }
+        const u8* getMappedData() override { return this->m_data.data(); }
+        Capability getCapabilities() override { return Capability::DirectAccess | Capability::ThreadSafeReads | Capability::CheapRandomAccess; }
+
+        std::vector<std::pair<std::string, std::string>> getDataInformation() override { return { }; }
+
+    private:
+        std::vector<u8> m_data;
+    };
+
+}
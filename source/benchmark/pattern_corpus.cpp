@@ -0,0 +1,495 @@
+#include <hex.hpp>
+
+#include <hex/helpers/utils.hpp>
+#include <hex/lang/pattern_language.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "memory_provider.hpp"
+
+/*
+    Times the pattern language end to end on realistic patterns. Every <name>.hexpat in the corpus directory is executed
+    on <name>.bin next to it or, for the patterns shipped with the corpus, on data generated to match them. Results can be
+    compared against the output of an earlier build with --baseline
+*/
+
+using namespace hex;
+
+namespace {
+
+    constexpr u64 DataSeed = 0x1337'5EED;
+
+    class DataWriter {
+    public:
+        explicit DataWriter(size_t size) : m_data(size, 0x00) { }
+
+        template<typename T> requires std::is_arithmetic_v<T>
+        void write(u64 offset, T value, std::endian endian = std::endian::little) {
+            if (offset + sizeof(T) > this->m_data.size())
+                this->m_data.resize(offset + sizeof(T));
+
+            std::memcpy(this->m_data.data() + offset, &value, sizeof(T));
+            if (endian != std::endian::native)
+                std::reverse(this->m_data.begin() + offset, this->m_data.begin() + offset + sizeof(T));
+        }
+
+        void writeString(u64 offset, std::string_view string) {
+            if (offset + string.size() > this->m_data.size())
+                this->m_data.resize(offset + string.size());
+            std::memcpy(this->m_data.data() + offset, string.data(), string.size());
+        }
+
+        void fill(u64 offset, size_t size, std::mt19937_64 &random) {
+            if (offset + size > this->m_data.size())
+                this->m_data.resize(offset + size);
+            std::generate_n(this->m_data.begin() + offset, size, [&] { return u8(random()); });
+        }
+
+        [[nodiscard]] std::vector<u8> take() { return std::move(this->m_data); }
+
+    private:
+        std::vector<u8> m_data;
+    };
+
+    std::vector<u8> generatePE() {
+        std::mt19937_64 random(DataSeed);
+
+        constexpr u64 PEHeaderOffset = 0x80, OptionalHeaderOffset = PEHeaderOffset + 24, SectionTableOffset = OptionalHeaderOffset + 240;
+        constexpr u16 SectionCount = 16;
+        constexpr u64 ImportsOffset = 0x1000, ImportDescriptorCount = 0x2000, ImportThunkCount = 0x8000;
+
+        DataWriter data(ImportsOffset + ImportDescriptorCount * 20 + ImportThunkCount * 8);
+
+        data.writeString(0x00, "MZ");
+        data.write<u32>(0x3C, PEHeaderOffset);
+
+        data.writeString(PEHeaderOffset, std::string_view("PE\0\0", 4));
+        data.write<u16>(PEHeaderOffset + 4, 0x8664);
+        data.write<u16>(PEHeaderOffset + 6, SectionCount);
+        data.write<u32>(PEHeaderOffset + 8, 0x6000'0000);
+        data.write<u16>(PEHeaderOffset + 20, 240);
+        data.write<u16>(PEHeaderOffset + 22, 0x0022);
+
+        data.fill(OptionalHeaderOffset, 240, random);
+        data.write<u16>(OptionalHeaderOffset, 0x020B);
+        data.write<u32>(OptionalHeaderOffset + 108, 16);
+
+        constexpr std::string_view SectionNames[] = { ".text", ".rdata", ".data", ".pdata", ".rsrc", ".reloc", ".tls", ".idata" };
+        for (u16 section = 0; section < SectionCount; section++) {
+            u64 offset = SectionTableOffset + section * 40;
+
+            data.fill(offset, 40, random);
+            data.write<u64>(offset, 0);
+            data.writeString(offset, SectionNames[section % std::size(SectionNames)]);
+            data.write<u32>(offset + 20, ImportsOffset + section * 0x1000);
+        }
+
+        data.fill(ImportsOffset, ImportDescriptorCount * 20 + ImportThunkCount * 8, random);
+
+        return data.take();
+    }
+
+    std::vector<u8> generateELF() {
+        std::mt19937_64 random(DataSeed);
+
+        constexpr u64 ProgramHeaderOffset = 0x40, SymbolTableOffset = 0x1000, SymbolCount = 0x8000;
+        constexpr u16 ProgramHeaderCount = 8, SectionHeaderCount = 32;
+        constexpr u64 SectionHeaderOffset = SymbolTableOffset + SymbolCount * 24;
+
+        DataWriter data(SectionHeaderOffset + SectionHeaderCount * 64);
+
+        data.writeString(0x00, "\x7F" "ELF");
+        data.write<u8>(0x04, 2);
+        data.write<u8>(0x05, 1);
+        data.write<u8>(0x06, 1);
+        data.write<u16>(0x10, 3);
+        data.write<u16>(0x12, 0x3E);
+        data.write<u32>(0x14, 1);
+        data.write<u64>(0x18, 0x1040);
+        data.write<u64>(0x20, ProgramHeaderOffset);
+        data.write<u64>(0x28, SectionHeaderOffset);
+        data.write<u16>(0x34, 0x40);
+        data.write<u16>(0x36, 56);
+        data.write<u16>(0x38, ProgramHeaderCount);
+        data.write<u16>(0x3A, 64);
+        data.write<u16>(0x3C, SectionHeaderCount);
+        data.write<u16>(0x3E, SectionHeaderCount - 1);
+
+        for (u16 header = 0; header < ProgramHeaderCount; header++) {
+            u64 offset = ProgramHeaderOffset + header * 56;
+
+            data.fill(offset, 56, random);
+            data.write<u32>(offset, header % 5);
+        }
+
+        data.fill(SymbolTableOffset, SymbolCount * 24 + SectionHeaderCount * 64, random);
+
+        return data.take();
+    }
+
+    std::vector<u8> generatePNG() {
+        std::mt19937_64 random(DataSeed);
+
+        constexpr u32 DataChunkCount = 0x800, DataChunkSize = 0x100;
+
+        DataWriter data(0);
+
+        data.writeString(0x00, "\x89PNG\r\n\x1A\n");
+
+        data.write<u32>(0x08, 13, std::endian::big);
+        data.writeString(0x0C, "IHDR");
+        data.write<u32>(0x10, 1920, std::endian::big);
+        data.write<u32>(0x14, 1080, std::endian::big);
+        data.write<u8>(0x18, 8);
+        data.write<u8>(0x19, 6);
+        data.write<u32>(0x1D, random(), std::endian::big);
+
+        u64 offset = 0x21;
+        for (u32 chunk = 0; chunk < DataChunkCount; chunk++) {
+            data.write<u32>(offset, DataChunkSize, std::endian::big);
+            data.writeString(offset + 4, "IDAT");
+            data.fill(offset + 8, DataChunkSize, random);
+            data.write<u32>(offset + 8 + DataChunkSize, random(), std::endian::big);
+
+            offset += 12 + DataChunkSize;
+        }
+
+        data.write<u32>(offset, 0, std::endian::big);
+        data.writeString(offset + 4, "IEND");
+        data.write<u32>(offset + 8, 0xAE42'6082, std::endian::big);
+
+        return data.take();
+    }
+
+    std::vector<u8> generateStructArray() {
+        std::mt19937_64 random(DataSeed);
+        std::uniform_real_distribution<float> coordinate(-1000.0F, 1000.0F);
+
+        constexpr u32 RecordCount = 0x1'0000;
+
+        DataWriter data(0);
+        data.writeString(0x00, "RECS");
+        data.write<u32>(0x04, RecordCount);
+
+        u64 offset = 0x08;
+        auto writeVector = [&] {
+            for (u32 i = 0; i < 3; i++, offset += sizeof(float))
+                data.write(offset, coordinate(random));
+        };
+
+        for (u32 record = 0; record < RecordCount; record++) {
+            u8 kind = 1 + random() % 3;
+
+            data.write<u8>(offset, kind);
+            data.write<u8>(offset + 1, random());
+            data.write<u16>(offset + 2, record);
+            offset += 4;
+
+            writeVector();
+
+            if (kind == 2) {
+                writeVector();
+            } else if (kind == 3) {
+                u8 vertexCount = 3 + random() % 6;
+
+                data.write<u8>(offset, vertexCount);
+                offset += 1;
+
+                for (u8 vertex = 0; vertex < vertexCount; vertex++)
+                    writeVector();
+            }
+        }
+
+        return data.take();
+    }
+
+    // Data for the patterns that come with the corpus, so no binaries have to be kept in the repository
+    const std::map<std::string, std::function<std::vector<u8>()>> DataGenerators = {
+        { "pe",             generatePE          },
+        { "elf",            generateELF         },
+        { "png",            generatePNG         },
+        { "struct_array",   generateStructArray }
+    };
+
+    /* Peak resident memory is only available on Linux, where it can be reset before every case */
+    void resetPeakMemory() {
+        #if defined(OS_LINUX)
+            std::ofstream("/proc/self/clear_refs") << "5";
+        #endif
+    }
+
+    std::optional<u64> getPeakMemory() {
+        #if defined(OS_LINUX)
+            std::ifstream status("/proc/self/status");
+
+            std::string line;
+            while (std::getline(status, line)) {
+                if (line.starts_with("VmHWM:"))
+                    return std::strtoull(line.c_str() + 6, nullptr, 10) * 1024;
+            }
+        #endif
+
+        return { };
+    }
+
+    std::optional<std::string> readTextFile(const std::filesystem::path &path) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+            return { };
+
+        std::stringstream stream;
+        stream << file.rdbuf();
+
+        return stream.str();
+    }
+
+    struct Options {
+        std::filesystem::path corpusPath = IMHEX_PATTERN_CORPUS;
+        u32 iterations = 5;
+        u32 batchSize = 0;
+        std::string filter;
+        std::string outputPath;
+        std::string baselinePath;
+    };
+
+    nlohmann::json runCase(const std::string &name, const std::string &code, std::vector<u8> &&data, const Options &options) {
+        nlohmann::json result = {
+            { "name", name },
+            { "dataSize", data.size() }
+        };
+
+        MemoryProvider provider(std::move(data));
+
+        resetPeakMemory();
+
+        lang::PatternLanguage runtime;
+
+        // The first execution also preprocesses and parses the pattern, later ones only evaluate it again
+        auto start = std::chrono::steady_clock::now();
+        auto patterns = runtime.executeString(&provider, code);
+        result["first"] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        if (!patterns.has_value()) {
+            // Evaluation errors only end up in the console
+            const auto &error = runtime.getError();
+            const auto &log = runtime.getConsoleLog();
+            if (error.has_value())
+                result["error"] = hex::format("{0}: {1}", error->first, error->second);
+            else if (!log.empty())
+                result["error"] = log.back().second;
+            else
+                result["error"] = "evaluation failed";
+
+            return result;
+        }
+
+        std::vector<double> times;
+        for (u32 i = 0; i < options.iterations; i++) {
+            start = std::chrono::steady_clock::now();
+            runtime.executeString(&provider, code);
+            times.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        }
+
+        std::sort(times.begin(), times.end());
+
+        result["iterations"] = times.size();
+        result["min"] = times.front();
+        result["median"] = times[times.size() / 2];
+        result["mean"] = std::accumulate(times.begin(), times.end(), 0.0) / times.size();
+        result["max"] = times.back();
+        result["patternCount"] = runtime.getCreatedPatternCount();
+        result["patternMemory"] = runtime.getPatternMemoryUsage();
+
+        if (auto peakMemory = getPeakMemory(); peakMemory.has_value())
+            result["peakMemory"] = peakMemory.value();
+
+        // Throughput of evaluating the pattern on many files at once, every one of them being the same data here
+        if (options.batchSize > 0) {
+            std::vector<prv::Provider*> providers(options.batchSize, &provider);
+            std::atomic<u32> failed = 0;
+
+            start = std::chrono::steady_clock::now();
+            runtime.executeBatch(providers, code, [&](u32, const auto &patterns, const auto &) {
+                if (!patterns.has_value())
+                    failed++;
+            });
+            auto time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            result["batch"] = {
+                { "files", providers.size() },
+                { "time", time },
+                { "filesPerSecond", providers.size() / time },
+                { "failed", failed.load() }
+            };
+        }
+
+        return result;
+    }
+
+    void printComparison(const nlohmann::json &baseline, const nlohmann::json &results) {
+        std::map<std::string, double> baselineTimes;
+        if (!baseline.is_object() || !baseline.contains("cases")) {
+            std::fprintf(stderr, "Baseline holds no results to compare against\n");
+            return;
+        }
+
+        for (const auto &entry : baseline["cases"]) {
+            if (entry.contains("median"))
+                baselineTimes[entry["name"].get<std::string>()] = entry["median"].get<double>();
+        }
+
+        std::fprintf(stderr, "\nCompared to %s:\n", baseline.value("commit", std::string("baseline")).c_str());
+        for (const auto &entry : results) {
+            auto name = entry["name"].get<std::string>();
+
+            auto it = baselineTimes.find(name);
+            if (it == baselineTimes.end() || !entry.contains("median"))
+                continue;
+
+            double median = entry["median"].get<double>();
+            std::fprintf(stderr, "%-24s%10.3f ms -> %10.3f ms  %+7.1f%%\n", name.c_str(), it->second * 1000, median * 1000, (median / it->second - 1) * 100);
+        }
+    }
+
+    bool parseArguments(int argc, char **argv, Options &options) {
+        for (int i = 1; i < argc; i++) {
+            std::string_view argument = argv[i];
+
+            if (i + 1 >= argc) {
+                std::fprintf(stderr, "Missing value for %s\n", argv[i]);
+                return false;
+            }
+
+            if (argument == "--corpus")
+                options.corpusPath = argv[++i];
+            else if (argument == "--iterations")
+                options.iterations = std::max<u32>(std::strtoul(argv[++i], nullptr, 10), 1);
+            else if (argument == "--batch")
+                options.batchSize = std::strtoul(argv[++i], nullptr, 10);
+            else if (argument == "--filter")
+                options.filter = argv[++i];
+            else if (argument == "--output")
+                options.outputPath = argv[++i];
+            else if (argument == "--baseline")
+                options.baselinePath = argv[++i];
+            else {
+                std::fprintf(stderr, "Unknown option %s\n", argv[i]);
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+}
+
+int main(int argc, char **argv) {
+    Options options;
+    if (!parseArguments(argc, argv, options)) {
+        std::fprintf(stderr,
+            "Usage: %s [options]\n"
+            "\n"
+            "Options:\n"
+            "  --corpus <directory>    Directory holding the patterns and their data\n"
+            "  --iterations <count>    Measured evaluations of every pattern, 5 by default\n"
+            "  --batch <count>         Also evaluate every pattern on this many copies of its data concurrently\n"
+            "  --filter <text>         Only run cases whose name contains the text\n"
+            "  --output <file>         Write the results to a file instead of stdout\n"
+            "  --baseline <file>       Results of an earlier run to compare against\n",
+            argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    std::vector<std::filesystem::path> patternPaths;
+    std::error_code error;
+    for (const auto &entry : std::filesystem::directory_iterator(options.corpusPath, error)) {
+        if (entry.is_regular_file() && entry.path().extension() == ".hexpat")
+            patternPaths.push_back(entry.path());
+    }
+    std::sort(patternPaths.begin(), patternPaths.end());
+
+    if (patternPaths.empty()) {
+        std::fprintf(stderr, "No patterns found in %s\n", options.corpusPath.string().c_str());
+        return EXIT_FAILURE;
+    }
+
+    auto results = nlohmann::json::array();
+    for (const auto &patternPath : patternPaths) {
+        auto name = patternPath.stem().string();
+        if (!options.filter.empty() && name.find(options.filter) == std::string::npos)
+            continue;
+
+        auto code = readTextFile(patternPath);
+        if (!code.has_value())
+            continue;
+
+        std::vector<u8> data;
+        if (auto dataPath = std::filesystem::path(patternPath).replace_extension(".bin"); std::filesystem::exists(dataPath, error))
+            data = hex::readFile(dataPath.string());
+        else if (auto generator = DataGenerators.find(name); generator != DataGenerators.end())
+            data = generator->second();
+        else {
+            std::fprintf(stderr, "%-24sno data to run the pattern on\n", name.c_str());
+            continue;
+        }
+
+        auto result = runCase(name, code.value(), std::move(data), options);
+
+        if (result.contains("error"))
+            std::fprintf(stderr, "%-24sfailed: %s\n", name.c_str(), result["error"].get<std::string>().c_str());
+        else
+            std::fprintf(stderr, "%-24s%10.3f ms%12llu patterns%10.1f MiB\n", name.c_str(), result["median"].get<double>() * 1000,
+                         static_cast<unsigned long long>(result["patternCount"].get<u64>()), result["patternMemory"].get<double>() / 0x10'0000);
+
+        if (result.contains("batch"))
+            std::fprintf(stderr, "%-24s%10.1f files/s\n", "", result["batch"]["filesPerSecond"].get<double>());
+
+        results.push_back(std::move(result));
+    }
+
+    nlohmann::json output = {
+        #if defined(GIT_COMMIT_HASH)
+        { "commit", GIT_COMMIT_HASH },
+        #endif
+        #if defined(IMHEX_VERSION)
+        { "version", IMHEX_VERSION },
+        #endif
+        { "cases", results }
+    };
+
+    if (!options.baselinePath.empty()) {
+        if (auto baseline = readTextFile(options.baselinePath); baseline.has_value())
+            printComparison(nlohmann::json::parse(baseline.value(), nullptr, false), results);
+        else
+            std::fprintf(stderr, "Failed to read baseline %s\n", options.baselinePath.c_str());
+    }
+
+    if (options.outputPath.empty()) {
+        std::fprintf(stdout, "%s\n", output.dump(4).c_str());
+    } else {
+        std::ofstream file(options.outputPath);
+        file << output.dump(4) << '\n';
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,359 @@
+#include <hex.hpp>
+
+#include <hex/api/content_registry.hpp>
+#include <hex/api/imhex_api.hpp>
+#include <hex/api/task.hpp>
+#include <hex/helpers/shared_data.hpp>
+#include <hex/helpers/utils.hpp>
+#include <hex/lang/pattern_data.hpp>
+#include <hex/providers/provider.hpp>
+
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <imgui.h>
+#define IMGUI_DEFINE_MATH_OPERATORS
+#include <imgui_internal.h>
+
+#include <nlohmann/json.hpp>
+
+#include "window.hpp"
+#include "content.hpp"
+#include "views/view_pattern.hpp"
+
+#include "corpus.hpp"
+
+/*
+    Measures how long ImHex takes to draw its frames while it's being used. A hidden window opens the generated corpus together with the
+    benchmark pattern and a set of bookmarks, then scrolling, selecting, jumping around and opening views are replayed as fake input and
+    every frame is timed. GLFW still needs a display to create the window on, on a headless machine run it under Xvfb
+*/
+
+using namespace hex;
+using namespace hex::benchmark;
+
+namespace {
+
+    struct Options {
+        size_t corpusSize = 0x400'0000;
+        u32 frames = 300;
+        u32 bookmarks = 256;
+        std::string outputPath;
+    };
+
+    /* The input the next frames see instead of the real one */
+    struct ScriptedInput {
+        ImVec2 mousePos = ImVec2(-FLT_MAX, -FLT_MAX);
+        bool mouseDown = false;
+        float mouseWheel = 0;
+    };
+
+    /* Same as View::toWindowName */
+    std::string getWindowName(std::string_view unlocalizedName) {
+        return LangEntry(unlocalizedName) + "##" + std::string(unlocalizedName);
+    }
+
+    class UIBenchmarkRunner {
+    public:
+        explicit UIBenchmarkRunner(Window &window) : m_window(window) {
+            window.setInputOverride([this](ImGuiIO &io) {
+                io.MousePos = this->m_input.mousePos;
+                io.MouseDown[ImGuiMouseButton_Left] = this->m_input.mouseDown;
+                io.MouseWheel = this->m_input.mouseWheel;
+            });
+        }
+
+        ~UIBenchmarkRunner() {
+            this->m_window.setInputOverride(nullptr);
+        }
+
+        /* Draws frames without timing them until no background task is running anymore, so one phase doesn't pay for the previous one */
+        void settle() {
+            this->m_input = { };
+
+            auto deadline = std::chrono::steady_clock::now() + SettleTimeout;
+            u32 idleFrames = 0;
+            while (idleFrames < SettleFrames && std::chrono::steady_clock::now() < deadline) {
+                this->m_window.frame();
+
+                if (TaskManager::getRunningTasks().empty() && View::getDeferedCalls().empty())
+                    idleFrames++;
+                else {
+                    idleFrames = 0;
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+            }
+        }
+
+        /* Brings the window of a view to the front and returns the area inside of it, where the input of a phase goes */
+        ImRect focusView(std::string_view unlocalizedName) {
+            auto windowName = getWindowName(unlocalizedName);
+
+            View::doLater([windowName] { ImGui::SetWindowFocus(windowName.c_str()); });
+            this->settle();
+
+            if (auto window = ImGui::FindWindowByName(windowName.c_str()); window != nullptr)
+                return window->InnerRect;
+            else
+                return ImRect(ImVec2(0, 0), ImGui::GetIO().DisplaySize);
+        }
+
+        /* Calls the script before every frame with the index of the frame in the phase, the script sets up the input and posts events */
+        void run(std::string_view name, u32 frames, const std::function<void(u32)> &script) {
+            std::fprintf(stderr, "%-24.*s", int(name.size()), name.data());
+
+            std::vector<double> times;
+            times.reserve(frames);
+            for (u32 i = 0; i < frames; i++) {
+                script(i);
+
+                auto start = std::chrono::steady_clock::now();
+                this->m_window.frame();
+                times.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+            }
+
+            this->addResult(name, times);
+            this->settle();
+        }
+
+        void addResult(std::string_view name, std::vector<double> times) {
+            if (times.empty())
+                return;
+
+            std::sort(times.begin(), times.end());
+            auto percentile = [&](double fraction) { return times[std::min<size_t>(times.size() * fraction, times.size() - 1)]; };
+            double mean = std::accumulate(times.begin(), times.end(), 0.0) / times.size();
+
+            std::fprintf(stderr, "%6zu frames%10.3f ms%10.3f ms%10.3f ms%10.3f ms%10.3f ms\n",
+                times.size(), mean * 1000, percentile(0.5) * 1000, percentile(0.9) * 1000, percentile(0.99) * 1000, times.back() * 1000);
+
+            this->m_results.push_back({
+                { "name", name },
+                { "frames", times.size() },
+                { "mean", mean },
+                { "p50", percentile(0.5) },
+                { "p90", percentile(0.9) },
+                { "p99", percentile(0.99) },
+                { "max", times.back() }
+            });
+        }
+
+        [[nodiscard]] Window& getWindow() { return this->m_window; }
+        [[nodiscard]] ScriptedInput& getInput() { return this->m_input; }
+        [[nodiscard]] nlohmann::json getResults() const { return this->m_results; }
+
+    private:
+        constexpr static u32 SettleFrames = 10;
+        constexpr static auto SettleTimeout = std::chrono::seconds(60);
+
+        Window &m_window;
+        ScriptedInput m_input;
+        nlohmann::json m_results = nlohmann::json::array();
+    };
+
+    void benchmarkIdle(UIBenchmarkRunner &runner, const Options &options) {
+        runner.run("ui.idle", options.frames, [](u32) { });
+    }
+
+    void benchmarkScrolling(UIBenchmarkRunner &runner, const Options &options, std::string_view resultName, std::string_view viewName) {
+        auto area = runner.focusView(viewName);
+
+        // Down for the first half of the frames and back up for the second one
+        runner.run(resultName, options.frames, [&](u32 frame) {
+            auto &input = runner.getInput();
+            input.mousePos = area.GetCenter();
+            input.mouseWheel = frame < options.frames / 2 ? -3.0F : 3.0F;
+        });
+    }
+
+    void benchmarkSelection(UIBenchmarkRunner &runner, const Options &options) {
+        auto area = runner.focusView("hex.view.hexeditor.name");
+
+        // Drags from the top left of the hex editor towards the bottom right, the button gets released and pressed again every DragFrames frames
+        constexpr static u32 DragFrames = 60;
+        auto from = area.Min + area.GetSize() * 0.1F;
+        auto to = area.Min + area.GetSize() * 0.9F;
+
+        runner.run("ui.hexeditor.select", options.frames, [&](u32 frame) {
+            auto &input = runner.getInput();
+            float progress = float(frame % DragFrames) / (DragFrames - 1);
+
+            input.mousePos = from + (to - from) * progress;
+            input.mouseDown = frame % DragFrames != DragFrames - 1;
+        });
+    }
+
+    void benchmarkJumps(UIBenchmarkRunner &runner, const Options &options) {
+        runner.focusView("hex.view.hexeditor.name");
+
+        std::mt19937_64 random(CorpusSeed);
+        auto size = SharedData::currentProvider->getActualSize();
+
+        runner.run("ui.hexeditor.jump", options.frames, [&](u32) {
+            View::postEvent(Events::SelectionChangeRequest, Region { random() % size, 1 });
+        });
+    }
+
+    /* Closes every view and opens them again one after another, timing the first frames each of them is shown */
+    void benchmarkOpeningViews(UIBenchmarkRunner &runner, const Options &options) {
+        constexpr static u32 FramesPerView = 30;
+
+        std::vector<View*> views;
+        for (auto &view : ContentRegistry::Views::getEntries()) {
+            if (view->hasViewMenuItemEntry())
+                views.push_back(view.get());
+        }
+
+        std::fprintf(stderr, "%-24s", "ui.views.open");
+
+        std::vector<double> times;
+        for (auto view : views) {
+            view->getWindowOpenState() = false;
+            runner.settle();
+
+            view->getWindowOpenState() = true;
+            for (u32 i = 0; i < FramesPerView; i++) {
+                auto start = std::chrono::steady_clock::now();
+                runner.getWindow().frame();
+                times.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+            }
+        }
+
+        runner.addResult("ui.views.open", times);
+        runner.settle();
+    }
+
+    bool parseArguments(int argc, char **argv, Options &options) {
+        for (int i = 1; i < argc; i++) {
+            std::string_view argument = argv[i];
+
+            if (i + 1 >= argc) {
+                std::fprintf(stderr, "Missing value for %s\n", argv[i]);
+                return false;
+            }
+
+            if (argument == "--size")
+                options.corpusSize = std::max<size_t>(std::strtoull(argv[++i], nullptr, 10), 1) * 0x10'0000;
+            else if (argument == "--frames")
+                options.frames = std::max<u32>(std::strtoul(argv[++i], nullptr, 10), 2);
+            else if (argument == "--bookmarks")
+                options.bookmarks = std::strtoul(argv[++i], nullptr, 10);
+            else if (argument == "--output")
+                options.outputPath = argv[++i];
+            else {
+                std::fprintf(stderr, "Unknown option %s\n", argv[i]);
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+}
+
+int main(int argc, char **argv) {
+    Options options;
+    if (!parseArguments(argc, argv, options)) {
+        std::fprintf(stderr,
+            "Usage: %s [options]\n"
+            "\n"
+            "Options:\n"
+            "  --size <MiB>            Size of the generated corpus, 64 MiB by default\n"
+            "  --frames <count>        Timed frames of every interaction, 300 by default\n"
+            "  --bookmarks <count>     Bookmarks placed in the corpus, 256 by default\n"
+            "  --output <file>         Write the results to a file instead of stdout\n",
+            argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    // The hex editor only opens files, so the corpus and the pattern get written to temporary ones
+    auto tempDirectory = std::filesystem::temp_directory_path();
+    auto corpusPath = (tempDirectory / "imhex-ui-benchmark.bin").string();
+    auto patternPath = (tempDirectory / "imhex-ui-benchmark.hexpat").string();
+
+    auto corpus = generateCorpus(options.corpusSize);
+    std::ofstream(corpusPath, std::ios::binary).write(reinterpret_cast<const char*>(corpus.data()), corpus.size());
+    std::ofstream(patternPath) << BenchmarkPattern;
+
+    nlohmann::json results;
+    try {
+        Window window(argc, argv, true);
+
+        std::vector<lang::PatternData*> patternData;
+        registerProviders();
+        registerViews(patternData);
+
+        UIBenchmarkRunner runner(window);
+        runner.settle();
+
+        View::postEvent(Events::FileDropped, corpusPath.c_str());
+        runner.settle();
+
+        if (SharedData::currentProvider == nullptr || !SharedData::currentProvider->isAvailable())
+            throw std::runtime_error("Failed to open the corpus");
+
+        std::mt19937_64 random(CorpusSeed);
+        for (u32 i = 0; i < options.bookmarks; i++) {
+            u64 address = random() % corpus.size();
+            ImHexApi::Bookmarks::add(address, std::min<u64>(random() % 0x100 + 1, corpus.size() - address), hex::format("Bookmark {}", i), "", 0x80000000 | (random() & 0x00FFFFFF));
+        }
+
+        for (auto &view : ContentRegistry::Views::getEntries()) {
+            if (auto patternView = dynamic_cast<ViewPattern*>(view.get()); patternView != nullptr)
+                patternView->loadPatternFile(patternPath);
+        }
+        runner.settle();
+
+        benchmarkIdle(runner, options);
+        benchmarkScrolling(runner, options, "ui.hexeditor.scroll", "hex.view.hexeditor.name");
+        benchmarkSelection(runner, options);
+        benchmarkJumps(runner, options);
+        benchmarkScrolling(runner, options, "ui.pattern_data.scroll", "hex.view.pattern_data.name");
+        benchmarkOpeningViews(runner, options);
+
+        results = {
+            #if defined(GIT_COMMIT_HASH)
+            { "commit", GIT_COMMIT_HASH },
+            #endif
+            #if defined(IMHEX_VERSION)
+            { "version", IMHEX_VERSION },
+            #endif
+            { "corpusSize", corpus.size() },
+            { "corpusSeed", CorpusSeed },
+            { "bookmarks", options.bookmarks },
+            { "benchmarks", runner.getResults() }
+        };
+    } catch (std::runtime_error &e) {
+        std::fprintf(stderr, "%s\n", e.what());
+
+        std::filesystem::remove(corpusPath);
+        std::filesystem::remove(patternPath);
+        return EXIT_FAILURE;
+    }
+
+    std::filesystem::remove(corpusPath);
+    std::filesystem::remove(patternPath);
+
+    auto output = results.dump(4);
+    if (options.outputPath.empty()) {
+        std::fprintf(stdout, "%s\n", output.c_str());
+    } else {
+        std::ofstream file(options.outputPath);
+        file << output << '\n';
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,599 @@
+#include <hex.hpp>
+
+#include <hex/helpers/crypto.hpp>
+#include <hex/helpers/string_search.hpp>
+#include <hex/helpers/utils.hpp>
+#include <hex/lang/pattern_language.hpp>
+#include <hex/lang/pattern_data.hpp>
+#include <hex/lang/pattern_exporter.hpp>
+
+#include "helpers/magic.hpp"
+#include "helpers/plugin_handler.hpp"
+#include "providers/file_provider.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+#include <yara.h>
+
+/*
+    Runs ImHex's analyses over any number of files without opening a window. Every file gets reported as one line of JSON
+    on stdout as soon as it's done. Files are processed in parallel, so the lines can arrive in any order
+*/
+
+using namespace hex;
+
+namespace {
+
+    struct HashOption {
+        std::string_view name;
+        crypt::HashRequest request;
+    };
+
+    // CRC-16/ARC and the CRC-32 used by zip, png and most other formats
+    const HashOption HashOptions[] = {
+        { "crc16",  { crypt::HashFunction::CRC16, 0xA001, 0x0000 } },
+        { "crc32",  { crypt::HashFunction::CRC32, 0xEDB8'8320, 0xFFFF'FFFF } },
+        { "md5",    { crypt::HashFunction::MD5 } },
+        { "sha1",   { crypt::HashFunction::SHA1 } },
+        { "sha224", { crypt::HashFunction::SHA224 } },
+        { "sha256", { crypt::HashFunction::SHA256 } },
+        { "sha384", { crypt::HashFunction::SHA384 } },
+        { "sha512", { crypt::HashFunction::SHA512 } },
+    };
+
+    const std::pair<std::string_view, StringSearchMode> StringModes[] = {
+        { "ascii",      StringSearchMode::ASCII },
+        { "utf8",       StringSearchMode::UTF8 },
+        { "utf16le",    StringSearchMode::UTF16LE },
+        { "utf16be",    StringSearchMode::UTF16BE },
+        { "all",        StringSearchMode::All },
+    };
+
+    struct ExportOption {
+        std::string_view name;
+        lang::PatternExporter::Format format;
+        std::string_view extension;
+    };
+
+    const ExportOption ExportOptions[] = {
+        { "jsonl",  lang::PatternExporter::Format::JSONLines,   ".jsonl" },
+        { "csv",    lang::PatternExporter::Format::CSV,         ".csv" },
+        { "binary", lang::PatternExporter::Format::Binary,      ".bin" },
+    };
+
+    // Patterns that big get their bytes written out as their value
+    constexpr size_t MaxValueSize = 16;
+
+    struct RuleFile {
+        std::string path;
+        YR_RULES *rules;
+    };
+
+    struct Options {
+        std::vector<std::string> files;
+
+        std::vector<const HashOption*> hashes;
+
+        bool strings = false;
+        size_t minimumLength = 5;
+        StringSearchMode stringMode = StringSearchMode::ASCII;
+
+        bool magic = false;
+
+        std::optional<std::string> patternPath;
+        std::string patternSource;
+
+        const ExportOption *exportOption = nullptr;
+        std::optional<std::string> exportDirectory;
+        std::string exportTable;
+
+        std::vector<std::string> rulePaths;
+        std::vector<RuleFile> rules;
+
+        u32 jobs = std::max(std::thread::hardware_concurrency(), 1U);
+
+        bool ioStatistics = false;
+    };
+
+    void printUsage(const char *executable) {
+        std::fprintf(stderr,
+            "Usage: %s [options] <files...>\n"
+            "\n"
+            "Options:\n"
+            "  --hash <names>          Comma separated list of crc16, crc32, md5, sha1, sha224, sha256, sha384 and sha512\n"
+            "  --strings               Extract strings\n"
+            "  --min-length <length>   Minimum length of extracted strings, 5 by default\n"
+            "  --encoding <encoding>   ascii, utf8, utf16le, utf16be or all, ascii by default\n"
+            "  --magic                 Identify the data using libmagic\n"
+            "  --pattern <file>        Evaluate a pattern file\n"
+            "  --export <format>       Stream the pattern results into a file next to each input instead of the report,\n"
+            "                          jsonl, csv or binary\n"
+            "  --export-dir <dir>      Directory the exported pattern results are written to\n"
+            "  --table <path>          Array exported as CSV, e.g. header.entries. The first top level array by default\n"
+            "  --yara <file>           Scan with a YARA rule file, can be given multiple times\n"
+            "  --jobs <count>          Number of files processed at the same time\n"
+            "  --io-stats              Report the reads every analysis did\n",
+            executable);
+    }
+
+    std::vector<std::string_view> splitList(std::string_view list) {
+        std::vector<std::string_view> parts;
+
+        while (!list.empty()) {
+            auto end = std::min(list.find(','), list.size());
+            parts.push_back(list.substr(0, end));
+            list.remove_prefix(std::min(end + 1, list.size()));
+        }
+
+        return parts;
+    }
+
+    bool parseArguments(int argc, char **argv, Options &options) {
+        for (int i = 1; i < argc; i++) {
+            std::string_view argument = argv[i];
+
+            auto nextArgument = [&]() -> std::optional<std::string_view> {
+                if (i + 1 >= argc) {
+                    std::fprintf(stderr, "Missing value for %s\n", argv[i]);
+                    return { };
+                }
+
+                return argv[++i];
+            };
+
+            if (argument == "--hash") {
+                auto value = nextArgument();
+                if (!value.has_value())
+                    return false;
+
+                for (auto name : splitList(value.value())) {
+                    auto option = std::find_if(std::begin(HashOptions), std::end(HashOptions), [&](const auto &option) { return option.name == name; });
+                    if (option == std::end(HashOptions)) {
+                        std::fprintf(stderr, "Unknown hash function %.*s\n", int(name.size()), name.data());
+                        return false;
+                    }
+
+                    options.hashes.push_back(option);
+                }
+            } else if (argument == "--strings") {
+                options.strings = true;
+            } else if (argument == "--min-length" || argument == "--jobs") {
+                auto value = nextArgument();
+                if (!value.has_value())
+                    return false;
+
+                auto number = std::strtoull(std::string(value.value()).c_str(), nullptr, 10);
+                if (number == 0) {
+                    std::fprintf(stderr, "Invalid value for %.*s\n", int(argument.size()), argument.data());
+                    return false;
+                }
+
+                if (argument == "--jobs")
+                    options.jobs = number;
+                else
+                    options.minimumLength = number;
+            } else if (argument == "--encoding") {
+                auto value = nextArgument();
+                if (!value.has_value())
+                    return false;
+
+                auto mode = std::find_if(std::begin(StringModes), std::end(StringModes), [&](const auto &mode) { return mode.first == value.value(); });
+                if (mode == std::end(StringModes)) {
+                    std::fprintf(stderr, "Unknown encoding %s\n", argv[i]);
+                    return false;
+                }
+
+                options.stringMode = mode->second;
+            } else if (argument == "--magic") {
+                options.magic = true;
+            } else if (argument == "--io-stats") {
+                options.ioStatistics = true;
+            } else if (argument == "--pattern") {
+                auto value = nextArgument();
+                if (!value.has_value())
+                    return false;
+
+                options.patternPath = value.value();
+            } else if (argument == "--export") {
+                auto value = nextArgument();
+                if (!value.has_value())
+                    return false;
+
+                auto option = std::find_if(std::begin(ExportOptions), std::end(ExportOptions), [&](const auto &option) { return option.name == value.value(); });
+                if (option == std::end(ExportOptions)) {
+                    std::fprintf(stderr, "Unknown export format %s\n", argv[i]);
+                    return false;
+                }
+
+                options.exportOption = option;
+            } else if (argument == "--export-dir" || argument == "--table") {
+                auto value = nextArgument();
+                if (!value.has_value())
+                    return false;
+
+                if (argument == "--table")
+                    options.exportTable = value.value();
+                else
+                    options.exportDirectory = value.value();
+            } else if (argument == "--yara") {
+                auto value = nextArgument();
+                if (!value.has_value())
+                    return false;
+
+                options.rulePaths.emplace_back(value.value());
+            } else if (argument.starts_with("--")) {
+                std::fprintf(stderr, "Unknown option %s\n", argv[i]);
+                return false;
+            } else {
+                options.files.emplace_back(argument);
+            }
+        }
+
+        return !options.files.empty();
+    }
+
+    std::string toHexString(const std::vector<u8> &bytes) {
+        std::string string;
+        for (u8 byte : bytes)
+            string += hex::format("{:02x}", byte);
+
+        return string;
+    }
+
+    /* Rules are compiled once up front, scanning with them from multiple threads at once is fine */
+    bool compileRules(Options &options) {
+        for (const auto &path : options.rulePaths) {
+            YR_COMPILER *compiler = nullptr;
+            if (yr_compiler_create(&compiler) != ERROR_SUCCESS)
+                return false;
+            SCOPE_EXIT( yr_compiler_destroy(compiler); );
+
+            FILE *file = fopen(path.c_str(), "r");
+            if (file == nullptr) {
+                std::fprintf(stderr, "Failed to open rule file %s\n", path.c_str());
+                return false;
+            }
+            SCOPE_EXIT( fclose(file); );
+
+            if (yr_compiler_add_file(compiler, file, nullptr, path.c_str()) != 0) {
+                std::vector<char> errorMessage(0xFFFF);
+                yr_compiler_get_error_message(compiler, errorMessage.data(), errorMessage.size());
+                std::fprintf(stderr, "%s: %s\n", path.c_str(), errorMessage.data());
+                return false;
+            }
+
+            YR_RULES *rules = nullptr;
+            if (yr_compiler_get_rules(compiler, &rules) != ERROR_SUCCESS)
+                return false;
+
+            options.rules.push_back({ path, rules });
+        }
+
+        return true;
+    }
+
+    nlohmann::json findStrings(prv::Provider *provider, const Options &options) {
+        auto result = nlohmann::json::array();
+
+        u64 dataSize = provider->getActualSize();
+        provider->adviseAccess(0, dataSize, prv::Provider::AccessHint::Sequential);
+        SCOPE_EXIT( provider->adviseAccess(0, dataSize, prv::Provider::AccessHint::Normal); );
+
+        // Files are already processed in parallel, so the chunks of a single one are searched one after another
+        std::vector<u8> buffer;
+        for (u64 chunkOffset = 0; chunkOffset < dataSize; chunkOffset += StringSearcher::ChunkSize) {
+            auto chunkSize = std::min<u64>(StringSearcher::ChunkSize, dataSize - chunkOffset);
+
+            for (const auto &foundString : StringSearcher::searchChunk(provider, chunkOffset, chunkSize, options.minimumLength, options.stringMode)) {
+                buffer.resize(foundString.size);
+                provider->readAbsolute(foundString.offset, buffer.data(), buffer.size());
+
+                result.push_back({
+                    { "offset", foundString.offset },
+                    { "encoding", StringEncodingNames[u8(foundString.encoding)] },
+                    { "string", StringSearcher::decode(buffer.data(), foundString) }
+                });
+            }
+        }
+
+        return result;
+    }
+
+    nlohmann::json patternToJson(prv::Provider *provider, lang::PatternData *pattern) {
+        nlohmann::json result = {
+            { "name", pattern->getVariableName() },
+            { "type", pattern->getFormattedName() },
+            { "offset", pattern->getOffset() },
+            { "size", pattern->getSize() }
+        };
+
+        auto addChildren = [&](const std::vector<lang::PatternData*> &children) {
+            auto &list = result["members"] = nlohmann::json::array();
+            for (auto child : children)
+                list.push_back(patternToJson(provider, child));
+        };
+
+        if (auto structPattern = dynamic_cast<lang::PatternDataStruct*>(pattern); structPattern != nullptr)
+            addChildren(structPattern->getMembers());
+        else if (auto unionPattern = dynamic_cast<lang::PatternDataUnion*>(pattern); unionPattern != nullptr)
+            addChildren(unionPattern->getMembers());
+        else if (auto arrayPattern = dynamic_cast<lang::PatternDataArray*>(pattern); arrayPattern != nullptr)
+            addChildren(arrayPattern->getEntries());
+        else if (auto staticArrayPattern = dynamic_cast<lang::PatternDataStaticArray*>(pattern); staticArrayPattern != nullptr)
+            result["count"] = staticArrayPattern->getEntryCount();
+        else if (pattern->getSize() <= MaxValueSize) {
+            std::vector<u8> bytes(pattern->getSize());
+            provider->read(pattern->getOffset(), bytes.data(), bytes.size());
+
+            result["bytes"] = toHexString(bytes);
+        }
+
+        return result;
+    }
+
+    /* Writes the results straight into a file while walking them, so huge results never exist as JSON or text all at once */
+    nlohmann::json exportPatterns(prv::Provider *provider, const std::string &path, const std::vector<lang::PatternData*> &patterns, const Options &options) {
+        std::filesystem::path outputPath = path;
+        if (options.exportDirectory.has_value())
+            outputPath = std::filesystem::path(options.exportDirectory.value()) / outputPath.filename();
+        outputPath += options.exportOption->extension;
+
+        auto exported = patterns;
+        if (options.exportOption->format == lang::PatternExporter::Format::CSV) {
+            lang::PatternData *table = nullptr;
+            if (!options.exportTable.empty())
+                table = lang::PatternExporter::findPattern(patterns, options.exportTable);
+            else {
+                auto it = std::find_if(patterns.begin(), patterns.end(), [](auto pattern) {
+                    return dynamic_cast<lang::PatternDataArray*>(pattern) != nullptr || dynamic_cast<lang::PatternDataStaticArray*>(pattern) != nullptr;
+                });
+
+                if (it != patterns.end())
+                    table = *it;
+            }
+
+            if (table == nullptr)
+                return { { "error", "No array to export found" } };
+
+            exported = { table };
+        }
+
+        FILE *file = fopen(outputPath.string().c_str(), "wb");
+        if (file == nullptr)
+            return { { "error", hex::format("Failed to create {}", outputPath.string()) } };
+        SCOPE_EXIT( fclose(file); );
+
+        std::atomic<bool> cancelled = false;
+        lang::PatternExporter exporter(provider, options.exportOption->format, [file](const char *data, size_t size) {
+            return std::fwrite(data, 1, size, file) == size;
+        });
+
+        if (!exporter.exportPatterns(exported, cancelled))
+            return { { "error", hex::format("Failed to write {}", outputPath.string()) } };
+
+        return { { "export", outputPath.string() } };
+    }
+
+    nlohmann::json evaluatePattern(prv::Provider *provider, const std::string &path, const Options &options) {
+        // The pattern language numbers pattern colors through shared state, so only one file gets evaluated at a time
+        static std::mutex evaluationMutex;
+        std::scoped_lock lock(evaluationMutex);
+
+        lang::PatternLanguage runtime;
+        auto patterns = runtime.executeString(provider, options.patternSource);
+
+        if (!patterns.has_value()) {
+            const auto &error = runtime.getError();
+            if (error.has_value())
+                return { { "error", hex::format("{0}: {1}", error->first, error->second) } };
+            else
+                return { { "error", "Evaluation failed" } };
+        }
+
+        if (options.exportOption != nullptr)
+            return exportPatterns(provider, path, patterns.value(), options);
+
+        auto result = nlohmann::json::array();
+        for (auto pattern : patterns.value())
+            result.push_back(patternToJson(provider, pattern));
+
+        return result;
+    }
+
+    nlohmann::json scanRules(const std::string &path, const RuleFile &ruleFile) {
+        auto matches = nlohmann::json::array();
+
+        auto result = yr_rules_scan_file(ruleFile.rules, path.c_str(), 0, [](YR_SCAN_CONTEXT *context, int message, void *data, void *userData) -> int {
+            if (message == CALLBACK_MSG_RULE_MATCHING) {
+                auto &matches = *static_cast<nlohmann::json*>(userData);
+                auto rule = static_cast<YR_RULE*>(data);
+
+                auto occurrences = nlohmann::json::array();
+
+                YR_STRING *string;
+                YR_MATCH *match;
+                if (rule->strings != nullptr) {
+                    yr_rule_strings_foreach(rule, string) {
+                        yr_string_matches_foreach(context, string, match) {
+                            occurrences.push_back({ { "identifier", string->identifier }, { "offset", match->offset }, { "size", match->match_length } });
+                        }
+                    }
+                }
+
+                matches.push_back({ { "rule", rule->identifier }, { "matches", std::move(occurrences) } });
+            }
+
+            return CALLBACK_CONTINUE;
+        }, &matches, 0);
+
+        if (result != ERROR_SUCCESS)
+            return { { "error", hex::format("Scanning failed with error {}", result) } };
+
+        return matches;
+    }
+
+    nlohmann::json analyzeFile(const std::string &path, const Options &options) {
+        nlohmann::json result = { { "file", path } };
+
+        prv::FileProvider provider(path, true);
+        if (!provider.isAvailable() || !provider.isReadable()) {
+            result["error"] = "Failed to open file";
+            return result;
+        }
+
+        result["size"] = provider.getActualSize();
+
+        if (!options.hashes.empty()) {
+            std::vector<crypt::HashRequest> requests;
+            for (auto hash : options.hashes)
+                requests.push_back(hash->request);
+
+            PROVIDER_IO_SCOPE("hashes");
+
+            prv::Provider *data = &provider;
+            std::atomic<bool> cancelled = false;
+            auto digests = crypt::hashRegion(data, 0, provider.getActualSize(), requests, cancelled);
+
+            auto &hashes = result["hashes"];
+            for (size_t i = 0; i < options.hashes.size() && i < digests.size(); i++)
+                hashes[std::string(options.hashes[i]->name)] = toHexString(digests[i]);
+        }
+
+        if (options.magic) {
+            PROVIDER_IO_SCOPE("magic");
+
+            result["magic"] = {
+                { "description", Magic::getDescription(&provider) },
+                { "mime", Magic::getMIMEType(&provider) }
+            };
+        }
+
+        if (options.strings) {
+            PROVIDER_IO_SCOPE("strings");
+            result["strings"] = findStrings(&provider, options);
+        }
+
+        if (options.patternPath.has_value()) {
+            PROVIDER_IO_SCOPE("patterns");
+            result["patterns"] = evaluatePattern(&provider, path, options);
+        }
+
+        if (!options.rules.empty()) {
+            auto &yara = result["yara"];
+            for (const auto &ruleFile : options.rules)
+                yara[ruleFile.path] = scanRules(path, ruleFile);
+        }
+
+        if (options.ioStatistics) {
+            auto &io = result["io"];
+            for (const auto &[tag, counters] : provider.getIOStatistics().getCounters()) {
+                io[tag.empty() ? "other" : tag] = {
+                    { "reads", counters.readCalls },
+                    { "bytes", counters.bytesRead },
+                    { "patch_hits", counters.patchHits },
+                    { "cache_hits", counters.cacheHits },
+                    { "cache_misses", counters.cacheMisses },
+                    { "raw_reads", counters.rawReadCalls },
+                    { "raw_bytes", counters.rawBytesRead },
+                    { "raw_time_ms", counters.rawReadTime / 1'000'000.0 }
+                };
+            }
+        }
+
+        return result;
+    }
+
+    void loadPlugins() {
+        for (const auto &dir : hex::getPath(ImHexPath::Plugins)) {
+            try {
+                PluginHandler::load(dir);
+            } catch (std::runtime_error &e) {
+                // Plugin folder not found. Not a problem.
+            }
+        }
+
+        PluginHandler::initializePlugins();
+    }
+
+}
+
+int main(int argc, char **argv) {
+    Options options;
+    if (!parseArguments(argc, argv, options)) {
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (options.patternPath.has_value()) {
+        std::ifstream file(options.patternPath.value());
+        if (!file.good()) {
+            std::fprintf(stderr, "Failed to open pattern file %s\n", options.patternPath->c_str());
+            return EXIT_FAILURE;
+        }
+
+        options.patternSource.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+        // The functions patterns can call are added by plugins
+        loadPlugins();
+    }
+
+    prv::IOStatistics::setEnabled(options.ioStatistics);
+
+    if (!options.rulePaths.empty()) {
+        if (yr_initialize() != ERROR_SUCCESS) {
+            std::fprintf(stderr, "Failed to initialize YARA\n");
+            return EXIT_FAILURE;
+        }
+
+        if (!compileRules(options))
+            return EXIT_FAILURE;
+
+        // YARA only allows this many threads to scan at the same time
+        options.jobs = std::min<u32>(options.jobs, YR_MAX_THREADS);
+    }
+
+    std::mutex outputMutex;
+    std::atomic<size_t> nextFile = 0;
+
+    std::vector<std::thread> workers;
+    for (size_t worker = 0; worker < std::min<size_t>(options.jobs, options.files.size()); worker++) {
+        workers.emplace_back([&] {
+            for (size_t i = nextFile++; i < options.files.size(); i = nextFile++) {
+                // Strings don't have to be valid UTF-8, invalid sequences get replaced instead of failing the whole file
+                auto line = analyzeFile(options.files[i], options).dump(-1, ' ', false, nlohmann::json::error_handler_t::replace);
+
+                std::scoped_lock lock(outputMutex);
+                std::fprintf(stdout, "%s\n", line.c_str());
+                std::fflush(stdout);
+            }
+        });
+    }
+
+    for (auto &worker : workers)
+        worker.join();
+
+    for (const auto &ruleFile : options.rules)
+        yr_rules_destroy(ruleFile.rules);
+
+    if (!options.rulePaths.empty())
+        yr_finalize();
+
+    if (options.patternPath.has_value())
+        PluginHandler::unload();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,74 @@
+#include "content.hpp"
+
+#include <hex/api/content_registry.hpp>
+
+#include "views/view_hexeditor.hpp"
+#include "views/view_pattern.hpp"
+#include "views/view_pattern_data.hpp"
+#include "views/view_hashes.hpp"
+#include "views/view_information.hpp"
+#include "views/view_help.hpp"
+#include "views/view_tools.hpp"
+#include "views/view_strings.hpp"
+#include "views/view_data_inspector.hpp"
+#include "views/view_disassembler.hpp"
+#include "views/view_bookmarks.hpp"
+#include "views/view_patches.hpp"
+#include "views/view_diff.hpp"
+#include "views/view_command_palette.hpp"
+#include "views/view_settings.hpp"
+#include "views/view_data_processor.hpp"
+#include "views/view_yara.hpp"
+
+#include "providers/file_provider.hpp"
+#include "providers/async_file_provider.hpp"
+#include "providers/disk_provider.hpp"
+#include "providers/process_memory_provider.hpp"
+#include "providers/compressed_file_provider.hpp"
+#include "providers/remote_provider.hpp"
+
+#include <cstdlib>
+
+namespace hex {
+
+    /*
+        Mapped files are the default, read-only mapping never writes to the file until saving and async I/O doesn't map the file at all.
+        Disks are read sector by sector without going through the page cache, processes take their ID instead of a path.
+        Compressed files show their decompressed contents and remote files take the server's address
+    */
+    void registerProviders() {
+        ContentRegistry::Providers::add("hex.provider.file", [](const std::string &path) { return new prv::FileProvider(path, false); });
+        ContentRegistry::Providers::add("hex.provider.file.read_only", [](const std::string &path) { return new prv::FileProvider(path, true); });
+        ContentRegistry::Providers::add("hex.provider.file.async", [](const std::string &path) {
+            u32 queueDepth = ContentRegistry::Settings::read("hex.builtin.setting.hex_editor", "hex.builtin.setting.hex_editor.async_queue_depth", prv::AsyncFileProvider::DefaultQueueDepth);
+            size_t blockSize = ContentRegistry::Settings::read("hex.builtin.setting.hex_editor", "hex.builtin.setting.hex_editor.async_block_size", prv::AsyncFileProvider::DefaultBlockSize / 0x400) * 0x400;
+
+            return new prv::AsyncFileProvider(path, queueDepth, blockSize);
+        });
+        ContentRegistry::Providers::add("hex.provider.disk", [](const std::string &path) { return new prv::DiskProvider(path); });
+        ContentRegistry::Providers::add("hex.provider.process", [](const std::string &path) { return new prv::ProcessMemoryProvider(strtoul(path.c_str(), nullptr, 10)); });
+        ContentRegistry::Providers::add("hex.provider.compressed_file", [](const std::string &path) { return new prv::CompressedFileProvider(path); });
+        ContentRegistry::Providers::add("hex.provider.remote", [](const std::string &path) { return new prv::RemoteProvider(path); });
+    }
+
+    void registerViews(std::vector<lang::PatternData*> &patternData) {
+        ContentRegistry::Views::add<ViewHexEditor>(patternData);
+        ContentRegistry::Views::add<ViewPattern>(patternData);
+        ContentRegistry::Views::add<ViewPatternData>(patternData);
+        ContentRegistry::Views::add<ViewDataInspector>();
+        ContentRegistry::Views::add<ViewHashes>(patternData);
+        ContentRegistry::Views::add<ViewInformation>();
+        ContentRegistry::Views::add<ViewStrings>();
+        ContentRegistry::Views::add<ViewDisassembler>(patternData);
+        ContentRegistry::Views::add<ViewBookmarks>();
+        ContentRegistry::Views::add<ViewPatches>();
+        ContentRegistry::Views::add<ViewDiff>();
+        ContentRegistry::Views::add<ViewTools>();
+        ContentRegistry::Views::add<ViewCommandPalette>(patternData);
+        ContentRegistry::Views::add<ViewHelp>();
+        ContentRegistry::Views::add<ViewSettings>();
+        ContentRegistry::Views::add<ViewDataProcessor>();
+        ContentRegistry::Views::add<ViewYara>(patternData);
+    }
+
+}
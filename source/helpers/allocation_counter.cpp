@@ -0,0 +1,50 @@
+#include <hex.hpp>
+
+#include <cstdlib>
+#include <new>
+
+/*
+    Replaces the global operator new to count the allocations of every thread for the profiler.
+    On Windows this only covers allocations made by ImHex itself, plugins bring their own operator new
+*/
+
+namespace {
+
+    thread_local u64 allocationCount = 0;
+
+}
+
+namespace hex {
+
+    u64 getAllocationCount() {
+        return allocationCount;
+    }
+
+}
+
+void* operator new(std::size_t size) {
+    allocationCount++;
+
+    if (auto memory = std::malloc(size == 0 ? 1 : size); memory != nullptr)
+        return memory;
+
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    allocationCount++;
+
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void operator delete(void *memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void *memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void *memory, const std::nothrow_t&) noexcept {
+    std::free(memory);
+}
@@ -0,0 +1,132 @@
+#include "helpers/carver.hpp"
+
+#include <hex/providers/provider.hpp>
+#include <hex/helpers/search.hpp>
+
+#include "helpers/magic.hpp"
+
+#include <algorithm>
+#include <mutex>
+#include <optional>
+#include <string_view>
+
+#include <magic.h>
+
+namespace hex {
+
+    namespace {
+
+        std::vector<u8> toBytes(std::string_view string) {
+            return { string.begin(), string.end() };
+        }
+
+    }
+
+    const std::vector<Carver::Signature>& Carver::getSignatures() {
+        using namespace std::literals::string_view_literals;
+
+        // Signatures shorter than four bytes show up in random data every few megabytes, only the most common formats get to use them
+        static const std::vector<Signature> signatures = {
+            { "PNG",            toBytes("\x89PNG\r\n\x1A\n"sv),                 0x00 },
+            { "JPEG",           toBytes("\xFF\xD8\xFF"sv),                      0x00 },
+            { "GIF",            toBytes("GIF87a"sv),                            0x00 },
+            { "GIF",            toBytes("GIF89a"sv),                            0x00 },
+            { "TIFF",           toBytes("II*\x00"sv),                           0x00 },
+            { "TIFF",           toBytes("MM\x00*"sv),                           0x00 },
+            { "RIFF",           toBytes("RIFF"sv),                              0x00 },
+            { "ISO Media",      toBytes("ftyp"sv),                              0x04 },
+            { "Matroska",       toBytes("\x1A\x45\xDF\xA3"sv),                  0x00 },
+            { "Ogg",            toBytes("OggS"sv),                              0x00 },
+            { "FLAC",           toBytes("fLaC"sv),                              0x00 },
+            { "MP3",            toBytes("ID3"sv),                               0x00 },
+            { "ZIP",            toBytes("PK\x03\x04"sv),                        0x00 },
+            { "gzip",           toBytes("\x1F\x8B\x08"sv),                      0x00 },
+            { "bzip2",          toBytes("BZh"sv),                               0x00 },
+            { "XZ",             toBytes("\xFD" "7zXZ\x00"sv),                   0x00 },
+            { "7-Zip",          toBytes("7z\xBC\xAF\x27\x1C"sv),                0x00 },
+            { "RAR",            toBytes("Rar!\x1A\x07"sv),                      0x00 },
+            { "Zstandard",      toBytes("\x28\xB5\x2F\xFD"sv),                  0x00 },
+            { "LZ4",            toBytes("\x04\x22\x4D\x18"sv),                  0x00 },
+            { "Cabinet",        toBytes("MSCF\x00\x00\x00\x00"sv),              0x00 },
+            { "tar",            toBytes("ustar"sv),                             0x101 },
+            { "ISO 9660",       toBytes("CD001"sv),                             0x8001 },
+            { "ELF",            toBytes("\x7F" "ELF"sv),                        0x00 },
+            { "PE",             toBytes("MZ\x90\x00"sv),                        0x00 },
+            { "Mach-O",         toBytes("\xFE\xED\xFA\xCE"sv),                  0x00 },
+            { "Mach-O",         toBytes("\xFE\xED\xFA\xCF"sv),                  0x00 },
+            { "Mach-O",         toBytes("\xCE\xFA\xED\xFE"sv),                  0x00 },
+            { "Mach-O",         toBytes("\xCF\xFA\xED\xFE"sv),                  0x00 },
+            { "Java / Mach-O",  toBytes("\xCA\xFE\xBA\xBE"sv),                  0x00 },
+            { "DEX",            toBytes("dex\n"sv),                             0x00 },
+            { "WebAssembly",    toBytes("\x00" "asm"sv),                        0x00 },
+            { "PDF",            toBytes("%PDF-"sv),                             0x00 },
+            { "RTF",            toBytes("{\\rtf"sv),                            0x00 },
+            { "XML",            toBytes("<?xml"sv),                             0x00 },
+            { "OLE",            toBytes("\xD0\xCF\x11\xE0\xA1\xB1\x1A\xE1"sv),  0x00 },
+            { "SQLite",         toBytes("SQLite format 3\x00"sv),               0x00 },
+        };
+
+        return signatures;
+    }
+
+    std::vector<CarvedFile> Carver::carve(prv::Provider *provider, const std::atomic<bool> &cancelled, std::atomic<u64> *processedBytes) {
+        const auto &signatures = getSignatures();
+
+        std::vector<std::vector<u8>> needles;
+        for (const auto &signature : signatures)
+            needles.push_back(signature.bytes);
+
+        SequenceSearcher searcher(std::move(needles));
+
+        std::mutex candidatesMutex;
+        std::vector<std::pair<u64, size_t>> candidates;
+
+        searcher.searchParallel(provider, 0x00, provider->getActualSize(), [&](u64, size_t chunkSize, std::vector<std::pair<u64, size_t>> &&occurrences) {
+            {
+                std::scoped_lock lock(candidatesMutex);
+                for (const auto &[address, signature] : occurrences) {
+                    // Files can't start before the data does
+                    if (address >= signatures[signature].offset)
+                        candidates.emplace_back(address - signatures[signature].offset, signature);
+                }
+            }
+
+            if (processedBytes != nullptr)
+                *processedBytes += chunkSize;
+        }, cancelled);
+
+        if (cancelled)
+            return { };
+
+        std::sort(candidates.begin(), candidates.end());
+
+        // Without a magic database nothing can be confirmed, the signatures alone are better than nothing
+        const bool confirm = Magic::hasDatabase();
+
+        std::vector<CarvedFile> files;
+        std::optional<u64> previousAddress;
+        for (const auto &[address, signature] : candidates) {
+            if (cancelled)
+                return { };
+
+            // Formats sharing a signature all match at the same address, libmagic tells them apart
+            if (previousAddress == address)
+                continue;
+            previousAddress = address;
+
+            std::string description;
+            if (confirm) {
+                description = Magic::identify(provider, address, ConfirmationSize, MAGIC_NONE);
+
+                // libmagic falls back to "data" for everything it doesn't recognize
+                if (description.empty() || description == "data")
+                    continue;
+            }
+
+            files.push_back({ address, signatures[signature].name, std::move(description) });
+        }
+
+        return files;
+    }
+
+}
@@ -0,0 +1,277 @@
+#include "helpers/code_discovery.hpp"
+
+#include <hex/api/task.hpp>
+#include <hex/helpers/utils.hpp>
+#include <hex/providers/provider.hpp>
+
+#include <atomic>
+#include <bit>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace hex {
+
+    namespace {
+
+        constexpr size_t ReadChunkSize = 0x1000;
+        constexpr size_t MaxInstructionSize = 64;
+
+        using AtomicBitmap = std::vector<std::atomic<u64>>;
+
+        /* Sets the bits and returns whether the first one was set already */
+        bool setBits(AtomicBitmap &bitmap, u64 offset, u64 count) {
+            bool wasSet = false;
+
+            for (u64 i = 0; i < count; ) {
+                u64 bit = (offset + i) % 64;
+                u64 length = std::min<u64>(64 - bit, count - i);
+                u64 mask = (length == 64 ? ~u64(0) : ((u64(1) << length) - 1)) << bit;
+
+                auto previous = bitmap[(offset + i) / 64].fetch_or(mask, std::memory_order_relaxed);
+                if (i == 0)
+                    wasSet = (previous & (u64(1) << bit)) != 0;
+
+                i += length;
+            }
+
+            return wasSet;
+        }
+
+        template<typename Details, typename OperandType>
+        std::optional<u64> findImmediateOperand(const Details &details, OperandType immediateType) {
+            for (u8 i = 0; i < details.op_count; i++) {
+                if (details.operands[i].type == immediateType)
+                    return details.operands[i].imm;
+            }
+
+            return { };
+        }
+
+        /* Each worker takes addresses from the back of its own queue and steals from the front of the others once it ran out */
+        struct WorkQueue {
+            std::mutex mutex;
+            std::deque<u64> offsets;
+        };
+
+    }
+
+    std::optional<u64> CodeDiscovery::getBranchTarget(csh capstoneHandle, cs_arch architecture, const cs_insn &instruction) {
+        if (!cs_insn_group(capstoneHandle, &instruction, CS_GRP_JUMP) && !cs_insn_group(capstoneHandle, &instruction, CS_GRP_CALL) && !cs_insn_group(capstoneHandle, &instruction, CS_GRP_BRANCH_RELATIVE))
+            return { };
+
+        const auto &detail = *instruction.detail;
+        switch (architecture) {
+            case CS_ARCH_ARM:
+                if (auto target = findImmediateOperand(detail.arm, ARM_OP_IMM); target.has_value())
+                    return u32(*target);
+                return { };
+            case CS_ARCH_ARM64:
+                return findImmediateOperand(detail.arm64, ARM64_OP_IMM);
+            case CS_ARCH_MIPS:
+                return findImmediateOperand(detail.mips, MIPS_OP_IMM);
+            case CS_ARCH_X86:
+                return findImmediateOperand(detail.x86, X86_OP_IMM);
+            case CS_ARCH_PPC:
+                return findImmediateOperand(detail.ppc, PPC_OP_IMM);
+            case CS_ARCH_SPARC:
+                return findImmediateOperand(detail.sparc, SPARC_OP_IMM);
+            default:
+                return { };
+        }
+    }
+
+    bool CodeDiscovery::endsBlock(csh capstoneHandle, cs_arch architecture, const cs_insn &instruction) {
+        if (cs_insn_group(capstoneHandle, &instruction, CS_GRP_RET) || cs_insn_group(capstoneHandle, &instruction, CS_GRP_IRET))
+            return true;
+
+        if (!cs_insn_group(capstoneHandle, &instruction, CS_GRP_JUMP))
+            return false;
+
+        // Conditional jumps fall through. Architectures not listed here are assumed to fall through as well, that only costs decoding some data
+        const auto &detail = *instruction.detail;
+        switch (architecture) {
+            case CS_ARCH_ARM:
+                return detail.arm.cc == ARM_CC_AL || detail.arm.cc == ARM_CC_INVALID;
+            case CS_ARCH_ARM64:
+                return (instruction.id == ARM64_INS_B || instruction.id == ARM64_INS_BR) && (detail.arm64.cc == ARM64_CC_AL || detail.arm64.cc == ARM64_CC_INVALID);
+            case CS_ARCH_MIPS:
+                return instruction.id == MIPS_INS_J || instruction.id == MIPS_INS_JR || instruction.id == MIPS_INS_B;
+            case CS_ARCH_X86:
+                return instruction.id == X86_INS_JMP || instruction.id == X86_INS_LJMP;
+            case CS_ARCH_PPC:
+                return instruction.id == PPC_INS_B || instruction.id == PPC_INS_BA || instruction.id == PPC_INS_BCTR;
+            case CS_ARCH_SPARC:
+                return instruction.id == SPARC_INS_JMP;
+            default:
+                return false;
+        }
+    }
+
+    std::optional<u64> CodeDiscovery::findNextSet(const std::vector<u64> &bitmap, u64 offset) {
+        u64 word = offset / 64;
+        if (word >= bitmap.size())
+            return { };
+
+        u64 bits = bitmap[word] & (~u64(0) << (offset % 64));
+        while (bits == 0) {
+            if (++word >= bitmap.size())
+                return { };
+
+            bits = bitmap[word];
+        }
+
+        return word * 64 + std::countr_zero(bits);
+    }
+
+    std::optional<CodeDiscovery::Result> CodeDiscovery::discover(prv::Provider *provider, cs_arch architecture, cs_mode mode, u64 regionStart, u64 regionSize, u64 baseAddress,
+                                                                 const std::vector<u64> &entryPoints, u32 threadCount, const std::function<bool()> &isCancelled) {
+        // Branches on these architectures execute the instruction right after them before jumping
+        const bool hasDelaySlot = architecture == CS_ARCH_MIPS || architecture == CS_ARCH_SPARC;
+
+        u64 wordCount = (regionSize + 63) / 64;
+        AtomicBitmap instructionStarts(wordCount), codeBytes(wordCount);
+
+        threadCount = std::max<u32>(threadCount, 1);
+        std::vector<WorkQueue> queues(threadCount);
+        std::atomic<u64> pending = 0;
+
+        const auto push = [&](u32 queue, u64 offset) {
+            pending++;
+
+            std::scoped_lock lock(queues[queue].mutex);
+            queues[queue].offsets.push_back(offset);
+        };
+
+        const auto pop = [&](u32 queue) -> std::optional<u64> {
+            for (u32 i = 0; i < threadCount; i++) {
+                auto &workQueue = queues[(queue + i) % threadCount];
+                std::scoped_lock lock(workQueue.mutex);
+
+                if (workQueue.offsets.empty())
+                    continue;
+
+                u64 offset;
+                if (i == 0) {
+                    offset = workQueue.offsets.back();
+                    workQueue.offsets.pop_back();
+                } else {
+                    offset = workQueue.offsets.front();
+                    workQueue.offsets.pop_front();
+                }
+
+                return offset;
+            }
+
+            return { };
+        };
+
+        for (u32 i = 0; i < entryPoints.size(); i++) {
+            if (entryPoints[i] >= baseAddress && entryPoints[i] - baseAddress < regionSize)
+                push(i % threadCount, entryPoints[i] - baseAddress);
+        }
+
+        std::vector<std::vector<std::pair<u64, u64>>> workerReferences(threadCount);
+        std::atomic<u64> instructionCount = 0;
+
+        TaskManager::runParallel(threadCount, [&](u32 worker) {
+            csh capstoneHandle;
+            if (cs_open(architecture, mode, &capstoneHandle) != CS_ERR_OK)
+                return;
+            SCOPE_EXIT( cs_close(&capstoneHandle); );
+
+            cs_option(capstoneHandle, CS_OPT_DETAIL, CS_OPT_ON);
+
+            cs_insn *instruction = cs_malloc(capstoneHandle);
+            if (instruction == nullptr)
+                return;
+            SCOPE_EXIT( cs_free(instruction, 1); );
+
+            std::vector<u8> buffer(ReadChunkSize);
+            auto &references = workerReferences[worker];
+            u64 workerInstructionCount = 0;
+
+            while (pending > 0 && !isCancelled()) {
+                auto start = pop(worker);
+                if (!start.has_value()) {
+                    // Someone else is still decoding and might find more code
+                    std::this_thread::yield();
+                    continue;
+                }
+
+                u64 offset = *start;
+                std::optional<u32> remainingInstructions;
+
+                while (offset < regionSize && remainingInstructions.value_or(1) > 0) {
+                    size_t bufferSize = std::min<u64>(buffer.size(), regionSize - offset);
+                    provider->read(regionStart + offset, buffer.data(), bufferSize);
+
+                    const u8 *code = buffer.data();
+                    size_t codeSize = bufferSize;
+                    u64 address = baseAddress + offset;
+                    bool refill = false;
+
+                    while (remainingInstructions.value_or(1) > 0 && cs_disasm_iter(capstoneHandle, &code, &codeSize, &address, instruction)) {
+                        // Another path already got here, everything from here on is decoded already
+                        if (setBits(instructionStarts, offset, 1)) {
+                            remainingInstructions = 0;
+                            break;
+                        }
+
+                        setBits(codeBytes, offset, std::min<u64>(instruction->size, regionSize - offset));
+                        workerInstructionCount++;
+
+                        if (auto target = getBranchTarget(capstoneHandle, architecture, *instruction); target.has_value()) {
+                            references.emplace_back(*target, instruction->address);
+
+                            if (*target >= baseAddress && *target - baseAddress < regionSize)
+                                push(worker, *target - baseAddress);
+                        }
+
+                        offset += instruction->size;
+
+                        if (remainingInstructions.has_value())
+                            (*remainingInstructions)--;
+                        else if (endsBlock(capstoneHandle, architecture, *instruction))
+                            remainingInstructions = hasDelaySlot ? 1 : 0;
+
+                        // Read the next chunk before an instruction could get cut off at the end of the buffer
+                        if (codeSize < MaxInstructionSize && offset + codeSize < regionSize) {
+                            refill = true;
+                            break;
+                        }
+                    }
+
+                    // Ran into an invalid instruction or the end of the block
+                    if (!refill)
+                        break;
+                }
+
+                pending--;
+            }
+
+            instructionCount += workerInstructionCount;
+        });
+
+        if (isCancelled())
+            return { };
+
+        Result result;
+        result.instructionCount = instructionCount;
+
+        result.instructionStarts.reserve(wordCount);
+        result.codeBytes.reserve(wordCount);
+        for (u64 i = 0; i < wordCount; i++) {
+            result.instructionStarts.push_back(instructionStarts[i].load(std::memory_order_relaxed));
+            result.codeBytes.push_back(codeBytes[i].load(std::memory_order_relaxed));
+        }
+
+        for (auto &references : workerReferences) {
+            result.references.insert(result.references.end(), references.begin(), references.end());
+            references = { };
+        }
+
+        return result;
+    }
+
+}
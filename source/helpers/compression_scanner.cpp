@@ -0,0 +1,495 @@
+#include "helpers/compression_scanner.hpp"
+
+#include <hex/api/task.hpp>
+#include <hex/providers/provider.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <span>
+
+#include <zlib.h>
+
+#if defined(IMHEX_LZMA_SUPPORT)
+    #include <lzma.h>
+#endif
+
+#if defined(IMHEX_ZSTD_SUPPORT)
+    #include <zstd.h>
+#endif
+
+#if defined(IMHEX_LZ4_SUPPORT)
+    #include <lz4frame.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+    #include <immintrin.h>
+#endif
+
+namespace hex {
+
+    namespace {
+
+        constexpr size_t OutputBufferSize = 0x1'0000;
+        constexpr size_t InputBufferSize = 0x1'0000;
+
+        // Headers are never longer than this, candidates at the very end of a chunk still get to see all of theirs
+        constexpr size_t HeaderLookahead = 0x10;
+
+        // Decoders of streams asking for more memory than this fail, every worker has its own
+        constexpr u64 LzmaMemoryLimit = 0x400'0000;
+        constexpr int ZstdWindowLogLimit = 25;
+
+        constexpr std::array<u8, 6> HeaderStartBytes = { 0x78, 0x1F, 0xFD, 0x5D, 0x28, 0x04 };
+
+    #if defined(__x86_64__) || defined(__i386__)
+
+        bool isAVX2Supported() {
+            static bool supported = __builtin_cpu_supports("avx2");
+            return supported;
+        }
+
+        /* Compares whole vectors against every byte a header can start with. Returns how much of the data got searched */
+        __attribute__((target("avx2")))
+        size_t findHeaderStartsVectorized(const u8 *data, size_t size, std::vector<u32> &offsets) {
+            std::array<__m256i, HeaderStartBytes.size()> starts;
+            for (size_t i = 0; i < starts.size(); i++)
+                starts[i] = _mm256_set1_epi8(char(HeaderStartBytes[i]));
+
+            size_t offset = 0;
+            for (; offset + 32 <= size; offset += 32) {
+                auto block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + offset));
+
+                auto hits = _mm256_setzero_si256();
+                for (const auto &start : starts)
+                    hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(block, start));
+
+                for (u32 mask = _mm256_movemask_epi8(hits); mask != 0; mask &= mask - 1)
+                    offsets.push_back(offset + std::countr_zero(mask));
+            }
+
+            return offset;
+        }
+
+    #endif
+
+        /* Offsets of all bytes that could be the start of a header, the headers themselves get checked afterwards */
+        void findHeaderStarts(const u8 *data, size_t size, std::vector<u32> &offsets) {
+            size_t offset = 0;
+
+            #if defined(__x86_64__) || defined(__i386__)
+                if (isAVX2Supported())
+                    offset = findHeaderStartsVectorized(data, size, offsets);
+            #endif
+
+            // Checking a table instead of every value keeps random data from mispredicting a branch on every byte
+            constexpr static auto IsHeaderStart = [] {
+                std::array<bool, 256> table = { };
+                for (u8 byte : HeaderStartBytes)
+                    table[byte] = true;
+                return table;
+            }();
+
+            for (; offset < size; offset++) {
+                if (IsHeaderStart[data[offset]]) [[unlikely]]
+                    offsets.push_back(offset);
+            }
+        }
+
+        bool matches(std::span<const u8> data, std::string_view bytes) {
+            return data.size() >= bytes.size() && std::memcmp(data.data(), bytes.data(), bytes.size()) == 0;
+        }
+
+        /* Format whose header starts at the beginning of the data, if any */
+        std::optional<CompressionFormat> detectHeader(std::span<const u8> data) {
+            using namespace std::literals::string_view_literals;
+
+            switch (data[0]) {
+                case 0x78:
+                    // Deflate with a 32 KiB window, the only one anything uses. The header is a multiple of 31 and no preset dictionary is used
+                    if (data.size() >= 2 && ((data[0] << 8) | data[1]) % 31 == 0 && (data[1] & 0x20) == 0)
+                        return CompressionFormat::Zlib;
+                    break;
+                case 0x1F:
+                    if (matches(data, "\x1F\x8B\x08"sv))
+                        return CompressionFormat::Gzip;
+                    break;
+                case 0xFD:
+                    if (matches(data, "\xFD" "7zXZ\x00"sv))
+                        return CompressionFormat::Xz;
+                    break;
+                case 0x5D:
+                    // Default properties of .lzma files followed by a dictionary size of at least 64 KiB
+                    if (matches(data, "\x5D\x00\x00"sv))
+                        return CompressionFormat::Lzma;
+                    break;
+                case 0x28:
+                    if (matches(data, "\x28\xB5\x2F\xFD"sv))
+                        return CompressionFormat::Zstd;
+                    break;
+                case 0x04:
+                    if (matches(data, "\x04\x22\x4D\x18"sv))
+                        return CompressionFormat::LZ4;
+                    break;
+                default:
+                    break;
+            }
+
+            return std::nullopt;
+        }
+
+    }
+
+    /* Decompression state of every format, reused for all probes of a worker so they don't have to allocate anything */
+    class CompressionScanner::Decoder {
+    public:
+        enum class Result { Running, Finished, Failed };
+
+        Decoder() = default;
+
+        ~Decoder() {
+            if (this->m_zlibInitialized)
+                inflateEnd(&this->m_zlib);
+
+            #if defined(IMHEX_LZMA_SUPPORT)
+                lzma_end(&this->m_lzma);
+            #endif
+
+            #if defined(IMHEX_ZSTD_SUPPORT)
+                ZSTD_freeDCtx(this->m_zstd);
+            #endif
+
+            #if defined(IMHEX_LZ4_SUPPORT)
+                LZ4F_freeDecompressionContext(this->m_lz4);
+            #endif
+        }
+
+        Decoder(const Decoder&) = delete;
+        Decoder& operator=(const Decoder&) = delete;
+
+        /* Decompresses the stream starting at the address until it fails or the budget runs out. Data from the chunk is used where possible */
+        std::optional<CompressedRegion> probe(prv::Provider *provider, std::span<const u8> chunk, u64 chunkAddress, u64 address, CompressionFormat format, u64 regionEnd) {
+            if (!this->reset(format))
+                return std::nullopt;
+
+            u64 dataSize = provider->getActualSize();
+            u64 consumed = 0, produced = 0;
+            auto result = Result::Running;
+            auto start = std::chrono::steady_clock::now();
+
+            while (true) {
+                u64 inputAddress = address + consumed;
+
+                std::span<const u8> input;
+                if (inputAddress < chunkAddress + chunk.size()) {
+                    input = chunk.subspan(inputAddress - chunkAddress);
+                } else if (inputAddress < dataSize) {
+                    size_t size = std::min<u64>(InputBufferSize, dataSize - inputAddress);
+                    provider->readAbsolute(inputAddress, this->m_input.data(), size);
+                    input = { this->m_input.data(), size };
+                } else {
+                    break;
+                }
+
+                size_t inputUsed = 0, outputUsed = 0;
+                result = this->decode(input, inputUsed, outputUsed);
+                consumed += inputUsed;
+                produced += outputUsed;
+
+                if (result != Result::Running)
+                    break;
+
+                // Neither input nor output left any room, whatever this is it doesn't decompress
+                if (inputUsed == 0 && outputUsed == 0) {
+                    result = Result::Failed;
+                    break;
+                }
+
+                if (produced >= ProbeOutputLimit || std::chrono::steady_clock::now() - start > ProbeTimeLimit)
+                    break;
+            }
+
+            if (result == Result::Failed)
+                return std::nullopt;
+
+            bool complete = result == Result::Finished;
+            if (produced < (complete ? MinimumDecompressedSize : ConfirmedDecompressedSize))
+                return std::nullopt;
+
+            // Without a checksum, short streams that ended successfully can just as well be random data that happened to
+            bool checksummed = format != CompressionFormat::RawDeflate && format != CompressionFormat::Lzma;
+            if (complete && !checksummed && consumed < MinimumUncheckedSize)
+                return std::nullopt;
+
+            // Stored data isn't compressed, random data decodes as a stored deflate block surprisingly often
+            if (produced <= consumed)
+                return std::nullopt;
+
+            u64 size = complete ? consumed : std::max(consumed, regionEnd - address);
+            return CompressedRegion { address, size, produced, format, complete };
+        }
+
+    private:
+        bool reset(CompressionFormat format) {
+            this->m_format = format;
+
+            switch (format) {
+                case CompressionFormat::Zlib:
+                case CompressionFormat::Gzip:
+                case CompressionFormat::RawDeflate: {
+                    int windowBits = format == CompressionFormat::Zlib ? MAX_WBITS : format == CompressionFormat::Gzip ? MAX_WBITS + 16 : -MAX_WBITS;
+
+                    if (!this->m_zlibInitialized) {
+                        this->m_zlibInitialized = inflateInit2(&this->m_zlib, windowBits) == Z_OK;
+                        return this->m_zlibInitialized;
+                    }
+
+                    return inflateReset2(&this->m_zlib, windowBits) == Z_OK;
+                }
+                #if defined(IMHEX_LZMA_SUPPORT)
+                case CompressionFormat::Xz:
+                    return lzma_stream_decoder(&this->m_lzma, LzmaMemoryLimit, 0) == LZMA_OK;
+                case CompressionFormat::Lzma:
+                    return lzma_alone_decoder(&this->m_lzma, LzmaMemoryLimit) == LZMA_OK;
+                #endif
+                #if defined(IMHEX_ZSTD_SUPPORT)
+                case CompressionFormat::Zstd:
+                    if (this->m_zstd == nullptr) {
+                        this->m_zstd = ZSTD_createDCtx();
+                        if (this->m_zstd == nullptr)
+                            return false;
+
+                        ZSTD_DCtx_setParameter(this->m_zstd, ZSTD_d_windowLogMax, ZstdWindowLogLimit);
+                    }
+
+                    return !ZSTD_isError(ZSTD_DCtx_reset(this->m_zstd, ZSTD_reset_session_only));
+                #endif
+                #if defined(IMHEX_LZ4_SUPPORT)
+                case CompressionFormat::LZ4:
+                    LZ4F_freeDecompressionContext(this->m_lz4);
+                    this->m_lz4 = nullptr;
+                    return !LZ4F_isError(LZ4F_createDecompressionContext(&this->m_lz4, LZ4F_VERSION));
+                #endif
+                default:
+                    return false;
+            }
+        }
+
+        /* Decompresses as much of the input as fits into the output buffer */
+        Result decode(std::span<const u8> input, size_t &inputUsed, size_t &outputUsed) {
+            auto output = this->m_output.data();
+
+            switch (this->m_format) {
+                case CompressionFormat::Zlib:
+                case CompressionFormat::Gzip:
+                case CompressionFormat::RawDeflate: {
+                    this->m_zlib.next_in = const_cast<u8*>(input.data());
+                    this->m_zlib.avail_in = std::min<size_t>(input.size(), std::numeric_limits<uInt>::max());
+                    this->m_zlib.next_out = output;
+                    this->m_zlib.avail_out = OutputBufferSize;
+
+                    uInt available = this->m_zlib.avail_in;
+                    int result = inflate(&this->m_zlib, Z_NO_FLUSH);
+                    inputUsed = available - this->m_zlib.avail_in;
+                    outputUsed = OutputBufferSize - this->m_zlib.avail_out;
+
+                    if (result == Z_STREAM_END)
+                        return Result::Finished;
+                    else if (result == Z_OK || result == Z_BUF_ERROR)
+                        return Result::Running;
+                    else
+                        return Result::Failed;
+                }
+                #if defined(IMHEX_LZMA_SUPPORT)
+                case CompressionFormat::Xz:
+                case CompressionFormat::Lzma: {
+                    this->m_lzma.next_in = input.data();
+                    this->m_lzma.avail_in = input.size();
+                    this->m_lzma.next_out = output;
+                    this->m_lzma.avail_out = OutputBufferSize;
+
+                    lzma_ret result = lzma_code(&this->m_lzma, LZMA_RUN);
+                    inputUsed = input.size() - this->m_lzma.avail_in;
+                    outputUsed = OutputBufferSize - this->m_lzma.avail_out;
+
+                    if (result == LZMA_STREAM_END)
+                        return Result::Finished;
+                    else if (result == LZMA_OK || result == LZMA_BUF_ERROR)
+                        return Result::Running;
+                    else
+                        return Result::Failed;
+                }
+                #endif
+                #if defined(IMHEX_ZSTD_SUPPORT)
+                case CompressionFormat::Zstd: {
+                    ZSTD_inBuffer in = { input.data(), input.size(), 0 };
+                    ZSTD_outBuffer out = { output, OutputBufferSize, 0 };
+
+                    size_t result = ZSTD_decompressStream(this->m_zstd, &out, &in);
+                    inputUsed = in.pos;
+                    outputUsed = out.pos;
+
+                    if (ZSTD_isError(result))
+                        return Result::Failed;
+                    else if (result == 0)
+                        return Result::Finished;
+                    else
+                        return Result::Running;
+                }
+                #endif
+                #if defined(IMHEX_LZ4_SUPPORT)
+                case CompressionFormat::LZ4: {
+                    inputUsed = input.size();
+                    outputUsed = OutputBufferSize;
+
+                    size_t result = LZ4F_decompress(this->m_lz4, output, &outputUsed, input.data(), &inputUsed, nullptr);
+
+                    if (LZ4F_isError(result))
+                        return Result::Failed;
+                    else if (result == 0)
+                        return Result::Finished;
+                    else
+                        return Result::Running;
+                }
+                #endif
+                default:
+                    return Result::Failed;
+            }
+        }
+
+        CompressionFormat m_format = CompressionFormat::Zlib;
+
+        z_stream m_zlib = { };
+        bool m_zlibInitialized = false;
+
+        #if defined(IMHEX_LZMA_SUPPORT)
+            lzma_stream m_lzma = LZMA_STREAM_INIT;
+        #endif
+
+        #if defined(IMHEX_ZSTD_SUPPORT)
+            ZSTD_DCtx *m_zstd = nullptr;
+        #endif
+
+        #if defined(IMHEX_LZ4_SUPPORT)
+            LZ4F_dctx *m_lz4 = nullptr;
+        #endif
+
+        std::vector<u8> m_input = std::vector<u8>(InputBufferSize);
+        std::vector<u8> m_output = std::vector<u8>(OutputBufferSize);
+    };
+
+    void CompressionScanner::scanChunk(prv::Provider *provider, Decoder &decoder, u64 address, size_t size, u64 regionEnd, bool regionStart,
+                                       const std::atomic<bool> &cancelled, std::vector<CompressedRegion> &results) {
+        std::vector<u8> chunk(std::min<u64>(size + HeaderLookahead, provider->getActualSize() - address));
+        provider->readAbsolute(address, chunk.data(), chunk.size());
+
+        std::vector<u32> headerStarts;
+        findHeaderStarts(chunk.data(), size, headerStarts);
+
+        std::vector<std::pair<u64, CompressionFormat>> candidates;
+        for (u32 offset : headerStarts) {
+            if (auto format = detectHeader(std::span(chunk).subspan(offset)); format.has_value())
+                candidates.emplace_back(offset, *format);
+        }
+
+        if (regionStart) {
+            for (size_t offset = 0; offset < std::min(size, RawDeflateSearchSize); offset++)
+                candidates.emplace_back(offset, CompressionFormat::RawDeflate);
+
+            // Formats with a header are far less likely to match by accident, they get probed first at the same offset
+            std::stable_sort(candidates.begin(), candidates.end(), [](const auto &left, const auto &right) {
+                return left.first != right.first ? left.first < right.first : right.second == CompressionFormat::RawDeflate && left.second != CompressionFormat::RawDeflate;
+            });
+        }
+
+        // Headers inside of a stream that got decompressed already are part of its data
+        u64 coveredUntil = 0;
+        for (const auto &[offset, format] : candidates) {
+            if (cancelled)
+                return;
+
+            if (address + offset < coveredUntil)
+                continue;
+
+            if (auto region = decoder.probe(provider, chunk, address, address + offset, format, regionEnd); region.has_value()) {
+                coveredUntil = region->address + region->size;
+                results.push_back(*region);
+            }
+        }
+    }
+
+    std::vector<CompressedRegion> CompressionScanner::scan(prv::Provider *provider, const std::vector<Region> &regions, const std::atomic<bool> &cancelled, std::atomic<u64> *processedBytes) {
+        struct Work {
+            u64 address;
+            size_t size;
+            u64 regionEnd;
+            bool regionStart;
+        };
+
+        u64 dataSize = provider->getActualSize();
+
+        std::vector<Work> works;
+        for (const auto &region : regions) {
+            if (region.address >= dataSize)
+                continue;
+
+            u64 regionEnd = std::min<u64>(region.address + region.size, dataSize);
+            for (u64 address = region.address; address < regionEnd; address += ChunkSize)
+                works.push_back({ address, size_t(std::min<u64>(ChunkSize, regionEnd - address)), regionEnd, address == region.address });
+        }
+
+        std::vector<std::vector<CompressedRegion>> workResults(works.size());
+        std::atomic<u64> nextWork = 0;
+
+        TaskManager::runParallel(std::min<u64>(provider->getReadWorkerCount(), works.size()), [&](u32) {
+            Decoder decoder;
+
+            for (u64 work = nextWork++; work < works.size() && !cancelled; work = nextWork++) {
+                const auto &[address, size, regionEnd, regionStart] = works[work];
+                scanChunk(provider, decoder, address, size, regionEnd, regionStart, cancelled, workResults[work]);
+
+                if (processedBytes != nullptr)
+                    *processedBytes += size;
+            }
+        });
+
+        if (cancelled)
+            return { };
+
+        std::vector<CompressedRegion> results;
+        for (const auto &workResult : workResults)
+            results.insert(results.end(), workResult.begin(), workResult.end());
+
+        std::sort(results.begin(), results.end(), [](const auto &left, const auto &right) { return left.address < right.address; });
+
+        // A stream reaching into the following chunks has its data probed there as well, anything found inside of it is dropped
+        std::vector<CompressedRegion> merged;
+        u64 coveredUntil = 0;
+        for (const auto &result : results) {
+            if (!merged.empty() && result.address < coveredUntil)
+                continue;
+
+            merged.push_back(result);
+            coveredUntil = result.address + result.size;
+        }
+
+        return merged;
+    }
+
+    std::string_view CompressionScanner::getFormatName(CompressionFormat format) {
+        switch (format) {
+            case CompressionFormat::Zlib:       return "zlib";
+            case CompressionFormat::Gzip:       return "gzip";
+            case CompressionFormat::RawDeflate: return "Deflate";
+            case CompressionFormat::Xz:         return "XZ";
+            case CompressionFormat::Lzma:       return "LZMA";
+            case CompressionFormat::Zstd:       return "Zstandard";
+            case CompressionFormat::LZ4:        return "LZ4";
+            default:                            return "Unknown";
+        }
+    }
+
+}
@@ -15,18 +15,86 @@ namespace hex {
         }
     }
 
-    std::pair<std::string_view, size_t> EncodingFile::getEncodingFor(const std::vector<u8> &buffer) const {
-        for (auto iter = this->m_mapping.rbegin(); iter != this->m_mapping.rend(); iter++) {
-            auto &[size, mapping] = *iter;
+    std::pair<std::string_view, size_t> EncodingFile::getEncodingFor(std::span<const u8> buffer) const {
+        std::pair<std::string_view, size_t> result = { ".", 1 };
+        if (this->m_trie.empty())
+            return result;
 
-            if (size > buffer.size()) continue;
+        u32 node = 0;
+        for (size_t i = 0; i < buffer.size(); i++) {
+            const auto &transition = this->m_trie[node][buffer[i]];
 
-            auto key = std::vector<u8>(buffer.begin(), buffer.begin() + size);
-            if (mapping.contains(key))
-                return { mapping.at(key), size };
+            if (transition.value != NoValue)
+                result = { this->m_values[transition.value], i + 1 };
+
+            if (transition.next == 0)
+                break;
+
+            node = transition.next;
+        }
+
+        return result;
+    }
+
+    size_t EncodingFile::decode(std::span<const u8> data, bool last, std::string &result) const {
+        size_t offset = 0;
+
+        // A sequence that could run past the end of the piece might decode differently once the next one is there
+        while (offset < data.size() && (last || data.size() - offset >= this->m_longestSequence)) {
+            auto [decoded, advance] = this->getEncodingFor(data.subspan(offset));
+
+            result += decoded;
+            offset += advance;
         }
 
-        return { ".", 1 };
+        return offset;
+    }
+
+    std::optional<std::vector<u8>> EncodingFile::encode(std::string_view text) const {
+        std::vector<u8> result;
+
+        while (!text.empty()) {
+            auto mapping = this->m_reverseMapping.end();
+            for (size_t size = std::min(this->m_longestValue, text.size()); size > 0 && mapping == this->m_reverseMapping.end(); size--)
+                mapping = this->m_reverseMapping.find(text.substr(0, size));
+
+            if (mapping == this->m_reverseMapping.end())
+                return std::nullopt;
+
+            std::copy(mapping->second.begin(), mapping->second.end(), std::back_inserter(result));
+            text.remove_prefix(mapping->first.size());
+        }
+
+        return result;
+    }
+
+    void EncodingFile::addMapping(const std::vector<u8> &from, std::string to) {
+        if (this->m_trie.empty())
+            this->m_trie.emplace_back();
+
+        u32 node = 0;
+        for (size_t i = 0; i + 1 < from.size(); i++) {
+            if (this->m_trie[node][from[i]].next == 0) {
+                this->m_trie[node][from[i]].next = this->m_trie.size();
+                this->m_trie.emplace_back();
+            }
+
+            node = this->m_trie[node][from[i]].next;
+        }
+
+        // The first mapping of a sequence wins, the same goes for encoding text that several sequences decode to
+        if (!this->m_reverseMapping.contains(to)) {
+            this->m_reverseMapping.emplace(to, from);
+            this->m_longestValue = std::max(this->m_longestValue, to.size());
+        }
+
+        auto &transition = this->m_trie[node][from.back()];
+        if (transition.value == NoValue) {
+            transition.value = this->m_values.size();
+            this->m_values.push_back(std::move(to));
+        }
+
+        this->m_longestSequence = std::max(this->m_longestSequence, from.size());
     }
 
     void EncodingFile::parseThingyFile(std::ifstream &content) {
@@ -52,11 +120,7 @@ namespace hex {
             auto fromBytes = hex::parseByteString(from);
             if (fromBytes.empty()) continue;
 
-            if (!this->m_mapping.contains(fromBytes.size()))
-                this->m_mapping.insert({ fromBytes.size(), { } });
-            this->m_mapping[fromBytes.size()].insert({ fromBytes, to });
-
-            this->m_longestSequence = std::max(this->m_longestSequence, fromBytes.size());
+            this->addMapping(fromBytes, std::move(to));
         }
     }
 
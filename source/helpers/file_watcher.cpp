@@ -0,0 +1,259 @@
+#include "helpers/file_watcher.hpp"
+
+#include <filesystem>
+
+#if defined(OS_WINDOWS)
+#include <string_view>
+#elif defined(OS_LINUX)
+#include <cerrno>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <fcntl.h>
+#endif
+
+namespace hex {
+
+    #if defined(OS_WINDOWS)
+    static std::wstring toWidePath(std::string_view path) {
+        auto wideLength = MultiByteToWideChar(CP_UTF8, 0, path.data(), path.length(), nullptr, 0);
+
+        std::wstring widePath(wideLength, L'\0');
+        MultiByteToWideChar(CP_UTF8, 0, path.data(), path.length(), widePath.data(), wideLength);
+
+        return widePath;
+    }
+    #elif !defined(OS_LINUX)
+    static std::optional<std::pair<std::filesystem::file_time_type, std::uintmax_t>> getFileState(const std::string &path) {
+        std::error_code error;
+        auto modificationTime = std::filesystem::last_write_time(path, error);
+        if (error)
+            return { };
+
+        auto size = std::filesystem::file_size(path, error);
+        if (error)
+            return { };
+
+        return std::make_pair(modificationTime, size);
+    }
+    #endif
+
+    FileWatcher::FileWatcher(std::string path, std::function<void()> callback) : m_path(std::move(path)), m_callback(std::move(callback)) {
+        this->m_fileName = std::filesystem::path(this->m_path).filename().string();
+
+        // Whatever wakes the thread up to stop has to exist before it starts, it may need to stop right away
+        #if defined(OS_WINDOWS)
+        this->m_stopEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+        #elif defined(OS_LINUX)
+        if (pipe2(this->m_stopPipe, O_CLOEXEC) != 0)
+            this->m_stopPipe[0] = this->m_stopPipe[1] = -1;
+        #endif
+
+        this->m_thread = std::thread([this] { this->run(); });
+    }
+
+    FileWatcher::~FileWatcher() {
+        {
+            std::scoped_lock lock(this->m_stopMutex);
+            this->m_stop = true;
+        }
+        this->m_stopSignal.notify_all();
+
+        #if defined(OS_WINDOWS)
+        if (this->m_stopEvent != nullptr)
+            SetEvent(this->m_stopEvent);
+        #elif defined(OS_LINUX)
+        if (this->m_stopPipe[1] != -1) {
+            u8 byte = 0x00;
+            (void) write(this->m_stopPipe[1], &byte, 1);
+        }
+        #endif
+
+        if (this->m_thread.joinable())
+            this->m_thread.join();
+
+        this->cleanup();
+
+        #if defined(OS_WINDOWS)
+        if (this->m_stopEvent != nullptr)
+            CloseHandle(this->m_stopEvent);
+        #elif defined(OS_LINUX)
+        for (int fd : this->m_stopPipe) {
+            if (fd != -1)
+                close(fd);
+        }
+        #endif
+    }
+
+    bool FileWatcher::setup() {
+        auto directory = std::filesystem::path(this->m_path).parent_path();
+        if (directory.empty())
+            directory = ".";
+
+        // The directory gets watched instead of the file itself, which also catches the file being replaced as build tools and editors tend to do
+        #if defined(OS_WINDOWS)
+        if (this->m_stopEvent == nullptr)
+            return false;
+
+        auto widePath = toWidePath(this->m_path);
+        auto wideDirectory = std::filesystem::path(widePath).parent_path().wstring();
+        if (wideDirectory.empty())
+            wideDirectory = L".";
+
+        this->m_directory = CreateFileW(wideDirectory.c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+        if (this->m_directory == INVALID_HANDLE_VALUE)
+            return false;
+
+        this->m_overlapped.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+        return this->m_overlapped.hEvent != nullptr;
+        #elif defined(OS_LINUX)
+        if (this->m_stopPipe[0] == -1)
+            return false;
+
+        this->m_inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (this->m_inotify == -1)
+            return false;
+
+        return inotify_add_watch(this->m_inotify, directory.c_str(), IN_MODIFY | IN_CLOSE_WRITE | IN_CREATE | IN_MOVED_TO | IN_ATTRIB) != -1;
+        #else
+        this->m_lastState = getFileState(this->m_path);
+        return true;
+        #endif
+    }
+
+    void FileWatcher::cleanup() {
+        #if defined(OS_WINDOWS)
+        if (this->m_readPending) {
+            DWORD size = 0;
+            CancelIo(this->m_directory);
+            GetOverlappedResult(this->m_directory, &this->m_overlapped, &size, TRUE);
+            this->m_readPending = false;
+        }
+
+        if (this->m_overlapped.hEvent != nullptr)
+            CloseHandle(this->m_overlapped.hEvent);
+        if (this->m_directory != INVALID_HANDLE_VALUE)
+            CloseHandle(this->m_directory);
+
+        this->m_overlapped.hEvent = nullptr;
+        this->m_directory = INVALID_HANDLE_VALUE;
+        #elif defined(OS_LINUX)
+        if (this->m_inotify != -1)
+            close(this->m_inotify);
+
+        this->m_inotify = -1;
+        #endif
+    }
+
+    FileWatcher::WaitResult FileWatcher::waitForChange(std::optional<std::chrono::milliseconds> timeout) {
+        #if defined(OS_WINDOWS)
+        auto fileName = toWidePath(this->m_fileName);
+
+        while (true) {
+            if (!this->m_readPending) {
+                ResetEvent(this->m_overlapped.hEvent);
+                if (!ReadDirectoryChangesW(this->m_directory, this->m_changes, sizeof(this->m_changes), FALSE, FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE, nullptr, &this->m_overlapped, nullptr))
+                    return WaitResult::Stopped;
+
+                this->m_readPending = true;
+            }
+
+            HANDLE handles[] = { this->m_overlapped.hEvent, this->m_stopEvent };
+            auto result = WaitForMultipleObjects(2, handles, FALSE, timeout.has_value() ? DWORD(timeout->count()) : INFINITE);
+            if (result == WAIT_TIMEOUT)
+                return WaitResult::Settled;
+            if (result != WAIT_OBJECT_0)
+                return WaitResult::Stopped;
+
+            DWORD size = 0;
+            this->m_readPending = false;
+            if (!GetOverlappedResult(this->m_directory, &this->m_overlapped, &size, FALSE))
+                return WaitResult::Stopped;
+
+            // Changes that didn't fit into the buffer are lost, the file might have been one of them
+            if (size == 0)
+                return WaitResult::Changed;
+
+            bool changed = false;
+            for (DWORD offset = 0; ; ) {
+                auto information = reinterpret_cast<FILE_NOTIFY_INFORMATION*>(this->m_changes + offset);
+                if (CompareStringOrdinal(information->FileName, information->FileNameLength / sizeof(WCHAR), fileName.c_str(), fileName.length(), TRUE) == CSTR_EQUAL)
+                    changed = true;
+
+                if (information->NextEntryOffset == 0)
+                    break;
+                offset += information->NextEntryOffset;
+            }
+
+            if (changed)
+                return WaitResult::Changed;
+        }
+        #elif defined(OS_LINUX)
+        pollfd descriptors[] = { { this->m_inotify, POLLIN, 0 }, { this->m_stopPipe[0], POLLIN, 0 } };
+
+        while (true) {
+            int result = poll(descriptors, 2, timeout.has_value() ? int(timeout->count()) : -1);
+            if (result == -1 && errno == EINTR)
+                continue;
+            if (result == 0)
+                return WaitResult::Settled;
+            if (result < 0 || descriptors[1].revents != 0)
+                return WaitResult::Stopped;
+
+            alignas(inotify_event) char buffer[0x1000];
+            bool changed = false;
+
+            ssize_t size;
+            while ((size = read(this->m_inotify, buffer, sizeof(buffer))) > 0) {
+                for (char *curr = buffer; curr < buffer + size; ) {
+                    auto event = reinterpret_cast<const inotify_event*>(curr);
+                    if (event->len > 0 && this->m_fileName == event->name)
+                        changed = true;
+
+                    curr += sizeof(inotify_event) + event->len;
+                }
+            }
+
+            // Other files in the same directory are of no interest
+            if (changed)
+                return WaitResult::Changed;
+        }
+        #else
+        std::unique_lock lock(this->m_stopMutex);
+
+        while (true) {
+            if (this->m_stopSignal.wait_for(lock, timeout.value_or(PollInterval), [this] { return this->m_stop; }))
+                return WaitResult::Stopped;
+
+            auto state = getFileState(this->m_path);
+            if (state != this->m_lastState) {
+                this->m_lastState = state;
+                return WaitResult::Changed;
+            }
+
+            if (timeout.has_value())
+                return WaitResult::Settled;
+        }
+        #endif
+    }
+
+    void FileWatcher::run() {
+        if (!this->setup())
+            return;
+
+        this->m_callback();
+
+        while (this->waitForChange(std::nullopt) == WaitResult::Changed) {
+            WaitResult result;
+            do {
+                result = this->waitForChange(SettleTime);
+            } while (result == WaitResult::Changed);
+
+            if (result == WaitResult::Stopped)
+                return;
+
+            this->m_callback();
+        }
+    }
+
+}
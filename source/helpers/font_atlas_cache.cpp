@@ -0,0 +1,155 @@
+#include "helpers/font_atlas_cache.hpp"
+
+#include <hex/helpers/crypto.hpp>
+#include <hex/helpers/utils.hpp>
+
+#include <cstring>
+#include <vector>
+
+namespace hex {
+
+    namespace {
+
+        // Bumped whenever the layout of serialized atlases changes, older ones then simply stop being found
+        constexpr u32 FormatVersion = 1;
+
+        template<typename T>
+        std::vector<T> toVector(const ImVector<T> &vector) {
+            return std::vector<T>(vector.begin(), vector.end());
+        }
+
+        template<typename T>
+        void toImVector(const std::vector<T> &vector, ImVector<T> &result) {
+            result.resize(vector.size());
+            if (!vector.empty())
+                std::memcpy(result.Data, vector.data(), vector.size() * sizeof(T));
+        }
+
+    }
+
+    u64 FontAtlasCache::getKey(const std::filesystem::path &fontPath, float fontSize, const ImVector<ImWchar> &ranges) {
+        // Two different polynomials together give a 64 bit hash
+        crypt::Crc<u32> first(0xEDB8'8320, 0xFFFF'FFFF), second(0x82F6'3B78, 0xFFFF'FFFF);
+        const auto hash = [&](const void *data, size_t size) {
+            first.process(static_cast<const u8*>(data), size);
+            second.process(static_cast<const u8*>(data), size);
+        };
+
+        std::error_code error;
+        u64 fileSize = std::filesystem::file_size(fontPath, error);
+        s64 modificationTime = std::filesystem::last_write_time(fontPath, error).time_since_epoch().count();
+        auto path = fontPath.string();
+
+        const u32 versions[] = { FormatVersion, IMGUI_VERSION_NUM, sizeof(ImFontGlyph), sizeof(ImWchar) };
+        hash(versions, sizeof(versions));
+        hash(path.data(), path.size());
+        hash(&fileSize, sizeof(fileSize));
+        hash(&modificationTime, sizeof(modificationTime));
+        hash(&fontSize, sizeof(fontSize));
+        hash(ranges.Data, ranges.size_in_bytes());
+
+        return (u64(first.getValue()) << 32) | second.getValue();
+    }
+
+    AnalysisCache::Writer FontAtlasCache::serialize(ImFontAtlas *atlas) {
+        AnalysisCache::Writer writer;
+
+        // Makes sure the alpha texture exists, it's a quarter of the size of the RGBA one which gets recreated from it when needed
+        u8 *pixels;
+        int width, height;
+        atlas->GetTexDataAsAlpha8(&pixels, &width, &height);
+
+        writer.write<s32>(atlas->Flags);
+        writer.write<s32>(width);
+        writer.write<s32>(height);
+        writer.write(atlas->TexUvScale);
+        writer.write(atlas->TexUvWhitePixel);
+        writer.write(atlas->TexUvLines);
+        writer.write<s32>(atlas->PackIdMouseCursors);
+        writer.write<s32>(atlas->PackIdLines);
+
+        // Rectangles only point at fonts while the atlas is being built, afterwards their glyphs are part of the fonts
+        auto customRects = toVector(atlas->CustomRects);
+        for (auto &rect : customRects)
+            rect.Font = nullptr;
+        writer.writeVector(customRects);
+
+        writer.writeVector(std::vector<u8>(pixels, pixels + size_t(width) * height));
+
+        writer.write<u32>(atlas->Fonts.size());
+        for (const auto font : atlas->Fonts) {
+            writer.write(font->FontSize);
+            writer.write(font->Scale);
+            writer.write(font->Ascent);
+            writer.write(font->Descent);
+            writer.write(font->FallbackChar);
+            writer.write(font->EllipsisChar);
+            writer.write<s32>(font->MetricsTotalSurface);
+            writer.writeVector(toVector(font->Glyphs));
+        }
+
+        return writer;
+    }
+
+    bool FontAtlasCache::deserialize(ImFontAtlas *atlas, AnalysisCache::Reader &reader) {
+        atlas->Clear();
+
+        s32 flags, width, height, packIdMouseCursors, packIdLines;
+        std::vector<ImFontAtlasCustomRect> customRects;
+        std::vector<u8> pixels;
+        u32 fontCount;
+
+        bool valid = reader.read(flags) && reader.read(width) && reader.read(height) &&
+                     reader.read(atlas->TexUvScale) && reader.read(atlas->TexUvWhitePixel) && reader.read(atlas->TexUvLines) &&
+                     reader.read(packIdMouseCursors) && reader.read(packIdLines) &&
+                     reader.readVector(customRects) && reader.readVector(pixels) && reader.read(fontCount);
+
+        if (!valid || width <= 0 || height <= 0 || pixels.size() != size_t(width) * height || fontCount == 0) {
+            atlas->Clear();
+            return false;
+        }
+
+        for (u32 i = 0; i < fontCount; i++) {
+            auto font = IM_NEW(ImFont);
+            atlas->Fonts.push_back(font);
+
+            std::vector<ImFontGlyph> glyphs;
+            s32 metricsTotalSurface;
+            valid = reader.read(font->FontSize) && reader.read(font->Scale) && reader.read(font->Ascent) && reader.read(font->Descent) &&
+                    reader.read(font->FallbackChar) && reader.read(font->EllipsisChar) && reader.read(metricsTotalSurface) &&
+                    reader.readVector(glyphs);
+
+            if (!valid || glyphs.empty()) {
+                atlas->Clear();
+                return false;
+            }
+
+            font->MetricsTotalSurface = metricsTotalSurface;
+            font->ContainerAtlas = atlas;
+            toImVector(glyphs, font->Glyphs);
+            font->BuildLookupTable();
+        }
+
+        atlas->Flags = flags;
+        atlas->TexWidth = width;
+        atlas->TexHeight = height;
+        atlas->PackIdMouseCursors = packIdMouseCursors;
+        atlas->PackIdLines = packIdLines;
+        toImVector(customRects, atlas->CustomRects);
+
+        // The atlas frees its texture with ImGui's allocator
+        atlas->TexPixelsAlpha8 = static_cast<unsigned char*>(IM_ALLOC(pixels.size()));
+        std::memcpy(atlas->TexPixelsAlpha8, pixels.data(), pixels.size());
+
+        return true;
+    }
+
+    void FontAtlasCache::store(u64 key, const AnalysisCache::Writer &writer) {
+        AnalysisCache::storeFile(std::filesystem::path("fonts") / hex::format("{:016X}.bin", key), writer);
+    }
+
+    std::optional<AnalysisCache::Reader> FontAtlasCache::load(u64 key) {
+        return AnalysisCache::loadFile(std::filesystem::path("fonts") / hex::format("{:016X}.bin", key));
+    }
+
+}
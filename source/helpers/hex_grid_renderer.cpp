@@ -0,0 +1,309 @@
+#include "helpers/hex_grid_renderer.hpp"
+
+#include <glad/glad.h>
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+namespace hex {
+
+    namespace {
+
+        // One quad per cell, its corners come from the vertex ID so there are no vertex buffers at all
+        constexpr auto VertexShader = R"(
+            #version 150
+
+            uniform mat4 u_Projection;
+            uniform isampler2D u_Cells;
+            uniform vec2 u_CellSize;
+
+            flat out uvec2 v_Cell;
+            out vec2 v_Local;
+
+            void main() {
+                ivec4 cell = texelFetch(u_Cells, ivec2(gl_InstanceID % 256, gl_InstanceID / 256), 0);
+                vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1);
+
+                v_Cell = uvec2(cell.xy);
+                v_Local = corner * u_CellSize;
+
+                vec2 position = vec2(cell.zw) + v_Local;
+                gl_Position = u_Projection * vec4(position, 0.0, 1.0);
+            }
+        )";
+
+        constexpr auto FragmentShader = R"(
+            #version 150
+
+            uniform sampler2D u_Font;
+            uniform sampler2D u_Glyphs;
+            uniform float u_Advance;
+            uniform vec4 u_TextColor;
+            uniform vec4 u_DisabledColor;
+            uniform vec4 u_HighlightWidths;
+
+            flat in uvec2 v_Cell;
+            in vec2 v_Local;
+
+            out vec4 o_Color;
+
+            vec4 unpackColor(uint color) {
+                return vec4(color & 0xFFu, (color >> 8) & 0xFFu, (color >> 16) & 0xFFu, color >> 24) / 255.0;
+            }
+
+            // Glyph rectangles relative to the pen position are in the first column of the glyph table, their atlas coordinates in the second one
+            float glyphCoverage(uint character, vec2 position) {
+                if (character == 0u)
+                    return 0.0;
+
+                vec4 rect = texelFetch(u_Glyphs, ivec2(0, int(character)), 0);
+                if (any(lessThan(position, rect.xy)) || any(greaterThanEqual(position, rect.zw)))
+                    return 0.0;
+
+                vec4 uv = texelFetch(u_Glyphs, ivec2(1, int(character)), 0);
+                return texture(u_Font, mix(uv.xy, uv.zw, (position - rect.xy) / (rect.zw - rect.xy))).a;
+            }
+
+            void main() {
+                uint glyphs = v_Cell.x;
+
+                vec4 background = vec4(0.0);
+                if (v_Cell.y != 0u && v_Local.x < u_HighlightWidths[int((glyphs >> 15) & 3u)])
+                    background = unpackColor(v_Cell.y);
+
+                bool first = v_Local.x < u_Advance;
+                uint character = first ? (glyphs & 0x7Fu) : ((glyphs >> 7) & 0x7Fu);
+
+                vec4 text = ((glyphs >> 14) & 1u) != 0u ? u_DisabledColor : u_TextColor;
+                text.a *= glyphCoverage(character, vec2(first ? v_Local.x : v_Local.x - u_Advance, v_Local.y));
+
+                // Text goes on top of the highlight, the same way ImGui draws them
+                float alpha = text.a + background.a * (1.0 - text.a);
+                if (alpha <= 0.0)
+                    discard;
+
+                o_Color = vec4((text.rgb * text.a + background.rgb * background.a * (1.0 - text.a)) / alpha, alpha);
+            }
+        )";
+
+        GLuint compileShader(GLenum type, const char *source) {
+            GLuint shader = glCreateShader(type);
+            glShaderSource(shader, 1, &source, nullptr);
+            glCompileShader(shader);
+
+            GLint status = GL_FALSE;
+            glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+            if (status != GL_TRUE) {
+                std::array<char, 0x400> log = { 0 };
+                glGetShaderInfoLog(shader, log.size(), nullptr, log.data());
+                std::fprintf(stderr, "Failed to compile hex grid shader: %s\n", log.data());
+
+                glDeleteShader(shader);
+                return 0;
+            }
+
+            return shader;
+        }
+
+    }
+
+    HexGridRenderer::~HexGridRenderer() {
+        if (!this->m_initialized)
+            return;
+
+        GLuint textures[] = { this->m_cellTexture, this->m_glyphTexture };
+        glDeleteTextures(2, textures);
+
+        GLuint vertexArray = this->m_vertexArray;
+        glDeleteVertexArrays(1, &vertexArray);
+
+        glDeleteProgram(this->m_program);
+    }
+
+    bool HexGridRenderer::isSupported() {
+        if (!this->m_initialized && !this->m_failed)
+            this->m_failed = !this->initialize();
+
+        return !this->m_failed;
+    }
+
+    bool HexGridRenderer::initialize() {
+        GLuint vertexShader = compileShader(GL_VERTEX_SHADER, VertexShader);
+        GLuint fragmentShader = compileShader(GL_FRAGMENT_SHADER, FragmentShader);
+        if (vertexShader == 0 || fragmentShader == 0) {
+            glDeleteShader(vertexShader);
+            glDeleteShader(fragmentShader);
+            return false;
+        }
+
+        GLuint program = glCreateProgram();
+        glAttachShader(program, vertexShader);
+        glAttachShader(program, fragmentShader);
+        glBindFragDataLocation(program, 0, "o_Color");
+        glLinkProgram(program);
+
+        glDeleteShader(vertexShader);
+        glDeleteShader(fragmentShader);
+
+        GLint status = GL_FALSE;
+        glGetProgramiv(program, GL_LINK_STATUS, &status);
+        if (status != GL_TRUE) {
+            glDeleteProgram(program);
+            return false;
+        }
+
+        this->m_program = program;
+        this->m_uniforms = {
+            glGetUniformLocation(program, "u_Projection"),
+            glGetUniformLocation(program, "u_Cells"),
+            glGetUniformLocation(program, "u_Font"),
+            glGetUniformLocation(program, "u_Glyphs"),
+            glGetUniformLocation(program, "u_CellSize"),
+            glGetUniformLocation(program, "u_Advance"),
+            glGetUniformLocation(program, "u_TextColor"),
+            glGetUniformLocation(program, "u_DisabledColor"),
+            glGetUniformLocation(program, "u_HighlightWidths")
+        };
+
+        // Core profiles don't draw anything without a vertex array bound, even if it has no attributes
+        GLuint vertexArray;
+        glGenVertexArrays(1, &vertexArray);
+        this->m_vertexArray = vertexArray;
+
+        GLuint textures[2];
+        glGenTextures(2, textures);
+        for (auto texture : textures) {
+            glBindTexture(GL_TEXTURE_2D, texture);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        }
+        this->m_cellTexture = textures[0];
+        this->m_glyphTexture = textures[1];
+
+        this->m_initialized = true;
+
+        return true;
+    }
+
+    void HexGridRenderer::updateGlyphs() {
+        auto font = ImGui::GetFont();
+        auto fontSize = ImGui::GetFontSize();
+        auto fontTexture = ImGui::GetIO().Fonts->TexID;
+
+        if (font == this->m_font && fontSize == this->m_fontSize && fontTexture == this->m_fontTexture)
+            return;
+
+        this->m_font = font;
+        this->m_fontSize = fontSize;
+        this->m_fontTexture = fontTexture;
+
+        float scale = fontSize / font->FontSize;
+
+        std::vector<ImVec4> table(GlyphCount * 2, ImVec4(0, 0, 0, 0));
+        for (u32 character = ' '; character < GlyphCount; character++) {
+            auto glyph = font->FindGlyphNoFallback(character);
+            if (glyph == nullptr || !glyph->Visible)
+                continue;
+
+            table[character * 2 + 0] = ImVec4(glyph->X0 * scale, glyph->Y0 * scale, glyph->X1 * scale, glyph->Y1 * scale);
+            table[character * 2 + 1] = ImVec4(glyph->U0, glyph->V0, glyph->U1, glyph->V1);
+        }
+
+        // The hex editor assumes a monospace font as well
+        if (auto glyph = font->FindGlyph('0'); glyph != nullptr)
+            this->m_advance = glyph->AdvanceX * scale;
+
+        glBindTexture(GL_TEXTURE_2D, this->m_glyphTexture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, 2, GlyphCount, 0, GL_RGBA, GL_FLOAT, table.data());
+    }
+
+    void HexGridRenderer::draw(ImDrawList *drawList, const MemoryEditor::GridData &grid) {
+        if (!this->isSupported() || grid.Cells.empty())
+            return;
+
+        this->updateGlyphs();
+
+        static_assert(sizeof(MemoryEditor::GridCell) == 4 * sizeof(u32), "Cells are uploaded as they are, one RGBA32I texel each");
+
+        u32 cellCount = grid.Cells.size();
+        u32 fullRows = cellCount / CellTextureWidth;
+        u32 remainder = cellCount % CellTextureWidth;
+        u32 rows = fullRows + (remainder != 0 ? 1 : 0);
+
+        glBindTexture(GL_TEXTURE_2D, this->m_cellTexture);
+        if (rows > this->m_cellTextureRows) {
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32I, CellTextureWidth, rows, 0, GL_RGBA_INTEGER, GL_INT, nullptr);
+            this->m_cellTextureRows = rows;
+        }
+
+        if (fullRows > 0)
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, CellTextureWidth, fullRows, GL_RGBA_INTEGER, GL_INT, grid.Cells.Data);
+        if (remainder > 0)
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, fullRows, remainder, 1, GL_RGBA_INTEGER, GL_INT, grid.Cells.Data + fullRows * CellTextureWidth);
+
+        this->m_cellCount = cellCount;
+        this->m_textColor = ImGui::ColorConvertU32ToFloat4(grid.TextColor);
+        this->m_disabledColor = ImGui::ColorConvertU32ToFloat4(grid.DisabledColor);
+        this->m_highlightWidths = ImVec4(grid.GlyphWidth * 2, grid.CellWidth, grid.CellWidth + grid.MidColsSpacing, 0);
+        this->m_cellSize = ImVec2(grid.CellWidth + grid.MidColsSpacing, grid.LineHeight);
+
+        drawList->AddCallback(HexGridRenderer::renderCallback, this);
+        drawList->AddCallback(ImDrawCallback_ResetRenderState, nullptr);
+    }
+
+    void HexGridRenderer::renderCallback(const ImDrawList *, const ImDrawCmd *command) {
+        static_cast<HexGridRenderer*>(command->UserCallbackData)->render(command);
+    }
+
+    void HexGridRenderer::render(const ImDrawCmd *command) {
+        auto drawData = ImGui::GetDrawData();
+
+        // Callbacks don't get a scissor rectangle set up, the one of the command before would still be active
+        auto clipOffset = drawData->DisplayPos;
+        auto clipScale = drawData->FramebufferScale;
+        float framebufferHeight = drawData->DisplaySize.y * clipScale.y;
+
+        ImVec4 clip((command->ClipRect.x - clipOffset.x) * clipScale.x, (command->ClipRect.y - clipOffset.y) * clipScale.y,
+                    (command->ClipRect.z - clipOffset.x) * clipScale.x, (command->ClipRect.w - clipOffset.y) * clipScale.y);
+        if (clip.z <= clip.x || clip.w <= clip.y)
+            return;
+
+        glScissor(GLint(clip.x), GLint(framebufferHeight - clip.w), GLsizei(clip.z - clip.x), GLsizei(clip.w - clip.y));
+
+        float left = drawData->DisplayPos.x, right = left + drawData->DisplaySize.x;
+        float top = drawData->DisplayPos.y, bottom = top + drawData->DisplaySize.y;
+        const float projection[4][4] = {
+            { 2.0F / (right - left),            0.0F,                               0.0F,   0.0F },
+            { 0.0F,                             2.0F / (top - bottom),              0.0F,   0.0F },
+            { 0.0F,                             0.0F,                               -1.0F,  0.0F },
+            { (right + left) / (left - right),  (top + bottom) / (bottom - top),    0.0F,   1.0F },
+        };
+
+        glUseProgram(this->m_program);
+        glBindVertexArray(this->m_vertexArray);
+
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, GLuint(reinterpret_cast<intptr_t>(this->m_fontTexture)));
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, this->m_cellTexture);
+        glActiveTexture(GL_TEXTURE2);
+        glBindTexture(GL_TEXTURE_2D, this->m_glyphTexture);
+
+        glUniformMatrix4fv(this->m_uniforms.projection, 1, GL_FALSE, &projection[0][0]);
+        glUniform1i(this->m_uniforms.font, 0);
+        glUniform1i(this->m_uniforms.cells, 1);
+        glUniform1i(this->m_uniforms.glyphs, 2);
+        glUniform2f(this->m_uniforms.cellSize, this->m_cellSize.x, this->m_cellSize.y);
+        glUniform1f(this->m_uniforms.advance, this->m_advance);
+        glUniform4f(this->m_uniforms.textColor, this->m_textColor.x, this->m_textColor.y, this->m_textColor.z, this->m_textColor.w);
+        glUniform4f(this->m_uniforms.disabledColor, this->m_disabledColor.x, this->m_disabledColor.y, this->m_disabledColor.z, this->m_disabledColor.w);
+        glUniform4f(this->m_uniforms.highlightWidths, this->m_highlightWidths.x, this->m_highlightWidths.y, this->m_highlightWidths.z, this->m_highlightWidths.w);
+
+        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, this->m_cellCount);
+
+        glActiveTexture(GL_TEXTURE0);
+    }
+
+}
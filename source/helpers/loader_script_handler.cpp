@@ -1,6 +1,8 @@
 #include "helpers/loader_script_handler.hpp"
 
+#include <hex/api/imhex_api.hpp>
 #include <hex/views/view.hpp>
+#include <hex/helpers/shared_data.hpp>
 #include <hex/helpers/utils.hpp>
 #include <hex/providers/provider.hpp>
 
@@ -10,15 +12,81 @@
 
 #include <cstring>
 #include <filesystem>
+#include <set>
+#include <vector>
 
 using namespace std::literals::string_literals;
 
 namespace hex {
 
+    namespace {
+
+        /* Read-only buffer over the provider's data, either pointing straight into the mapped data or into a patched copy of it */
+        struct ProviderData {
+            PyObject_HEAD
+            const u8 *data;
+            Py_ssize_t size;
+            std::vector<u8> *copy;
+        };
+
+        int ProviderData_getBuffer(PyObject *self, Py_buffer *view, int flags) {
+            auto providerData = reinterpret_cast<ProviderData*>(self);
+
+            return PyBuffer_FillInfo(view, self, const_cast<u8*>(providerData->data), providerData->size, 1, flags);
+        }
+
+        void ProviderData_dealloc(PyObject *self) {
+            delete reinterpret_cast<ProviderData*>(self)->copy;
+
+            auto type = Py_TYPE(self);
+            type->tp_free(self);
+            Py_DECREF(type);
+        }
+
+        PyTypeObject *providerDataType = nullptr;
+
+        /*
+            Code of all types the script declared. It gets handed to the pattern editor in one piece once the script is done,
+            so the editor and the pattern language only have to process it once instead of once per type
+        */
+        std::string generatedCode;
+        std::set<std::string> generatedTypes;
+
+    }
+
     PyObject* LoaderScript::Py_getFilePath(PyObject *self, PyObject *args) {
         return PyUnicode_FromString(LoaderScript::s_filePath.c_str());
     }
 
+    PyObject* LoaderScript::Py_getData(PyObject *self, PyObject *args) {
+        auto &provider = LoaderScript::s_dataProvider;
+
+        auto providerData = reinterpret_cast<ProviderData*>(providerDataType->tp_alloc(providerDataType, 0));
+        if (providerData == nullptr)
+            return nullptr;
+
+        size_t size = provider->getActualSize();
+        providerData->size = size;
+
+        // Mapped data without any patches can be handed out directly, otherwise the buffer has to hold a patched copy
+        auto directView = provider->getAbsoluteDirectView(0, size);
+        if (directView.has_value() && LoaderScript::s_patches.empty()) {
+            providerData->data = directView->data();
+        } else {
+            providerData->copy = new std::vector<u8>(size);
+            provider->readAbsolute(0, providerData->copy->data(), size);
+            providerData->data = providerData->copy->data();
+
+            // The script's own patches only get applied once it's done, but it should still see them
+            for (const auto &patch : LoaderScript::s_patches) {
+                if (patch.address < size)
+                    std::memcpy(providerData->copy->data() + patch.address, patch.bytes.data(), std::min<u64>(patch.bytes.size(), size - patch.address));
+            }
+        }
+
+        return reinterpret_cast<PyObject*>(providerData);
+    }
+
     PyObject* LoaderScript::Py_addPatch(PyObject *self, PyObject *args) {
         u64 address;
         u8 *patches;
@@ -39,7 +107,30 @@ namespace hex {
             return nullptr;
         }
 
-        LoaderScript::s_dataProvider->write(address, patches, count);
+        LoaderScript::s_patches.push_back({ address, std::vector<u8>(patches, patches + count) });
+
+        Py_RETURN_NONE;
+    }
+
+    /* All patches get applied as a single undo step anyway, transactions only decide which of them a rollback discards */
+    PyObject* LoaderScript::Py_beginTransaction(PyObject *self, PyObject *args) {
+        LoaderScript::s_transactionStarts.push_back(LoaderScript::s_patches.size());
+
+        Py_RETURN_NONE;
+    }
+
+    PyObject* LoaderScript::Py_commitTransaction(PyObject *self, PyObject *args) {
+        if (!LoaderScript::s_transactionStarts.empty())
+            LoaderScript::s_transactionStarts.pop_back();
+
+        Py_RETURN_NONE;
+    }
+
+    PyObject* LoaderScript::Py_rollbackTransaction(PyObject *self, PyObject *args) {
+        // Like the provider's transactions, rolling back discards everything since the outermost one began
+        if (!LoaderScript::s_transactionStarts.empty())
+            LoaderScript::s_patches.resize(LoaderScript::s_transactionStarts.front());
+        LoaderScript::s_transactionStarts.clear();
 
         Py_RETURN_NONE;
     }
@@ -61,11 +152,35 @@ namespace hex {
             return nullptr;
         }
 
-        ImHexApi::Bookmarks::add(address, size, name, comment);
+        LoaderScript::s_bookmarks.push_back({ Region { address, size }, name, comment });
+
+        Py_RETURN_NONE;
+    }
+
+    PyObject* LoaderScript::Py_setProgress(PyObject *self, PyObject *args) {
+        u64 value, maxValue;
+
+        if (!PyArg_ParseTuple(args, "KK", &value, &maxValue)) {
+            PyErr_BadArgument();
+            return nullptr;
+        }
+
+        LoaderScript::s_currentTask->setMaxValue(maxValue);
+        LoaderScript::s_currentTask->update(value);
+
+        // Gives scripts reporting their progress a natural point to stop at
+        if (LoaderScript::s_currentTask->isInterrupted()) {
+            PyErr_SetString(PyExc_KeyboardInterrupt, "loader script got cancelled");
+            return nullptr;
+        }
 
         Py_RETURN_NONE;
     }
 
+    PyObject* LoaderScript::Py_isCancelled(PyObject *self, PyObject *args) {
+        return PyBool_FromLong(LoaderScript::s_currentTask->isInterrupted());
+    }
+
     static PyObject* createStructureType(std::string keyword, PyObject *args) {
         auto type = PyTuple_GetItem(args, 0);
         if (type == nullptr) {
@@ -86,6 +201,10 @@ namespace hex {
             return nullptr;
         }
 
+        // Declaring the same type again would only make the pattern code fail to parse
+        if (generatedTypes.contains(instance->ob_type->tp_name))
+            Py_RETURN_NONE;
+
         auto dict = instance->ob_type->tp_dict;
         if (dict == nullptr) {
             PyErr_BadArgument();
@@ -163,7 +282,8 @@ namespace hex {
 
         code += "};\n";
 
-        View::postEvent(Events::AppendPatternLanguageCode, code.c_str());
+        generatedCode += code;
+        generatedTypes.insert(instance->ob_type->tp_name);
 
         Py_RETURN_NONE;
     }
@@ -176,7 +296,7 @@ namespace hex {
         return createStructureType("union", args);
     }
 
-    bool LoaderScript::processFile(std::string_view scriptPath) {
+    void LoaderScript::run(Task &task, const std::string &scriptPath) {
         Py_SetProgramName(Py_DecodeLocale((SharedData::mainArgv)[0], nullptr));
 
         for (const auto &dir : hex::getPath(ImHexPath::Python)) {
@@ -189,12 +309,18 @@ namespace hex {
         PyImport_AppendInittab("_imhex", []() -> PyObject* {
 
             static PyMethodDef ImHexMethods[] = {
-                { "get_file_path",  &LoaderScript::Py_getFilePath,  METH_NOARGS,  "Returns the path of the file being loaded."  },
-                { "patch",          &LoaderScript::Py_addPatch,     METH_VARARGS, "Patches a region of memory"                  },
-                { "add_bookmark",   &LoaderScript::Py_addBookmark,  METH_VARARGS, "Adds a bookmark"                             },
-                { "add_struct",     &LoaderScript::Py_addStruct,    METH_VARARGS, "Adds a struct"                               },
-                { "add_union",      &LoaderScript::Py_addUnion,     METH_VARARGS, "Adds a union"                                },
-                { nullptr,          nullptr,               0,     nullptr                                       }
+                { "get_file_path",          &LoaderScript::Py_getFilePath,          METH_NOARGS,  "Returns the path of the file being loaded."                            },
+                { "get_data",               &LoaderScript::Py_getData,              METH_NOARGS,  "Returns a read-only buffer of the data as it currently is"             },
+                { "patch",                  &LoaderScript::Py_addPatch,             METH_VARARGS, "Patches a region of memory"                                            },
+                { "begin_transaction",      &LoaderScript::Py_beginTransaction,     METH_NOARGS,  "Collects all following patches until the transaction gets committed"  },
+                { "commit_transaction",     &LoaderScript::Py_commitTransaction,    METH_NOARGS,  "Applies the collected patches as a single undo step"                   },
+                { "rollback_transaction",   &LoaderScript::Py_rollbackTransaction,  METH_NOARGS,  "Discards the collected patches"                                        },
+                { "add_bookmark",           &LoaderScript::Py_addBookmark,          METH_VARARGS, "Adds a bookmark"                                                       },
+                { "set_progress",           &LoaderScript::Py_setProgress,          METH_VARARGS, "Reports how far the script got, raises KeyboardInterrupt once it got cancelled" },
+                { "is_cancelled",           &LoaderScript::Py_isCancelled,          METH_NOARGS,  "Returns whether the user cancelled the script"                         },
+                { "add_struct",             &LoaderScript::Py_addStruct,            METH_VARARGS, "Adds a struct"                                                         },
+                { "add_union",              &LoaderScript::Py_addUnion,             METH_VARARGS, "Adds a union"                                                          },
+                { nullptr,                  nullptr,                                0,            nullptr                                                                 }
             };
 
             static PyModuleDef ImHexModule = {
@@ -205,9 +331,28 @@ namespace hex {
             if (module == nullptr)
                 return nullptr;
 
+            static PyType_Slot ProviderDataSlots[] = {
+                { Py_bf_getbuffer,  reinterpret_cast<void*>(&ProviderData_getBuffer)    },
+                { Py_tp_dealloc,    reinterpret_cast<void*>(&ProviderData_dealloc)      },
+                { 0,                nullptr                                             }
+            };
+
+            static PyType_Spec ProviderDataSpec = {
+                "_imhex.ProviderData", sizeof(ProviderData), 0, Py_TPFLAGS_DEFAULT, ProviderDataSlots
+            };
+
+            providerDataType = reinterpret_cast<PyTypeObject*>(PyType_FromSpec(&ProviderDataSpec));
+            if (providerDataType == nullptr) {
+                Py_DECREF(module);
+                return nullptr;
+            }
+
             return module;
         });
 
+        generatedCode.clear();
+        generatedTypes.clear();
+
         Py_Initialize();
 
         {
@@ -217,14 +362,67 @@ namespace hex {
             PyList_Insert(sysPath, 0, path);
         }
 
-        FILE *scriptFile = fopen(scriptPath.data(), "r");
-        PyRun_SimpleFile(scriptFile, scriptPath.data());
+        // Scripts that never report their progress still get stopped, the interpreter raises KeyboardInterrupt at its next instruction
+        task.setInterruptCallback([] {
+            Py_AddPendingCall([](void*) -> int {
+                PyErr_SetString(PyExc_KeyboardInterrupt, "loader script got cancelled");
+                return -1;
+            }, nullptr);
+        });
+
+        if (FILE *scriptFile = fopen(scriptPath.c_str(), "r"); scriptFile != nullptr) {
+            PyRun_SimpleFile(scriptFile, scriptPath.c_str());
+            fclose(scriptFile);
+        }
 
-        fclose(scriptFile);
+        task.setInterruptCallback({ });
 
         Py_Finalize();
+    }
+
+    void LoaderScript::apply(std::shared_ptr<prv::Provider> provider, std::vector<Patch> &&patches, std::vector<Bookmark> &&bookmarks, std::string &&code) {
+        // The results belong to the data the script ran on, they're worthless once something else got opened
+        if (SharedData::currentProvider != provider.get())
+            return;
+
+        provider->beginTransaction();
+        for (const auto &patch : patches)
+            provider->write(patch.address, patch.bytes.data(), patch.bytes.size());
+        provider->commitTransaction();
+
+        for (const auto &bookmark : bookmarks)
+            ImHexApi::Bookmarks::add(bookmark.region, bookmark.name, bookmark.comment);
 
-        return true;
+        if (!code.empty())
+            View::postEvent(Events::AppendPatternLanguageCode, code.c_str());
+    }
+
+    void LoaderScript::processFile(std::string_view scriptPath, std::string_view filePath, std::shared_ptr<prv::Provider> provider) {
+        if (LoaderScript::isRunning() || provider == nullptr)
+            return;
+
+        LoaderScript::s_task = TaskManager::createTask("hex.view.hexeditor.script.running", 0, [scriptPath = std::string(scriptPath), filePath = std::string(filePath), provider](Task &task) {
+            LoaderScript::s_currentTask = &task;
+            LoaderScript::s_filePath = filePath;
+            LoaderScript::s_dataProvider = provider;
+
+            LoaderScript::run(task, scriptPath);
+
+            // Scripts that stopped before committing still get their patches applied, cancelled ones don't get anything applied
+            if (!task.isInterrupted()) {
+                View::doLater([provider, patches = std::move(LoaderScript::s_patches), bookmarks = std::move(LoaderScript::s_bookmarks), code = std::move(generatedCode)]() mutable {
+                    LoaderScript::apply(provider, std::move(patches), std::move(bookmarks), std::move(code));
+                });
+            }
+
+            LoaderScript::s_currentTask = nullptr;
+            LoaderScript::s_dataProvider = nullptr;
+            LoaderScript::s_patches.clear();
+            LoaderScript::s_transactionStarts.clear();
+            LoaderScript::s_bookmarks.clear();
+            generatedCode.clear();
+            generatedTypes.clear();
+        });
     }
 
 }
\ No newline at end of file
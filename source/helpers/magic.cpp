@@ -0,0 +1,154 @@
+#include "helpers/magic.hpp"
+
+#include <hex/providers/provider.hpp>
+#include <hex/helpers/utils.hpp>
+
+#include <algorithm>
+#include <filesystem>
+#include <vector>
+
+#include <magic.h>
+
+namespace hex {
+
+    namespace {
+
+        // Matches libmagic's own default in case the library is too old to report it
+        constexpr size_t DefaultMagicBytesMax = 0x10'0000;
+
+        std::string getMagicFiles(bool includeSources) {
+            std::string magicFiles;
+
+            for (const auto &dir : hex::getPath(ImHexPath::Magic)) {
+                // Most of the directories don't exist on any given system, that's no reason to ignore the others
+                std::error_code error;
+                for (const auto &entry : std::filesystem::directory_iterator(dir, error)) {
+                    if (!entry.is_regular_file())
+                        continue;
+
+                    // Sources get parsed on every load, libmagic picks up a compiled version next to them on its own
+                    const auto &path = entry.path();
+                    if (path.extension() == ".mgc")
+                        magicFiles += path.string() + MAGIC_PATH_SEPARATOR;
+                    else if (includeSources && !std::filesystem::exists(path.string() + ".mgc"))
+                        magicFiles += path.string() + MAGIC_PATH_SEPARATOR;
+                }
+            }
+
+            if (magicFiles.empty())
+                return "";
+
+            magicFiles.pop_back();
+
+            return magicFiles;
+        }
+
+    }
+
+    void Magic::CookieDeleter::operator()(magic_set *cookie) const {
+        magic_close(cookie);
+    }
+
+    magic_set* Magic::getCookie(int flags) {
+        // Failed loads are remembered as well so a missing database isn't searched for on every call
+        if (!Magic::s_loaded) {
+            Magic::s_loaded = true;
+
+            // A file in the magic folders that isn't a database at all makes the whole load fail, try again with only the compiled ones then
+            for (bool includeSources : { true, false }) {
+                auto magicFiles = getMagicFiles(includeSources);
+                if (magicFiles.empty())
+                    break;
+
+                Magic::s_cookie.reset(magic_open(MAGIC_NONE));
+                if (Magic::s_cookie != nullptr && magic_load(Magic::s_cookie.get(), magicFiles.c_str()) == 0)
+                    break;
+
+                Magic::s_cookie.reset();
+            }
+        }
+
+        if (Magic::s_cookie == nullptr || magic_setflags(Magic::s_cookie.get(), flags) == -1)
+            return nullptr;
+
+        return Magic::s_cookie.get();
+    }
+
+    std::string Magic::identify(prv::Provider *provider, int flags) {
+        if (provider == nullptr || provider->getSize() == 0)
+            return "";
+
+        std::scoped_lock lock(Magic::s_mutex);
+
+        auto cookie = Magic::getCookie(flags);
+        if (cookie == nullptr)
+            return "";
+
+        // libmagic never looks past the first bytes_max bytes, so don't hand it any more than that
+        size_t bytesMax = DefaultMagicBytesMax;
+        if (magic_getparam(cookie, MAGIC_PARAM_BYTES_MAX, &bytesMax) == -1)
+            bytesMax = DefaultMagicBytesMax;
+
+        size_t size = std::min<u64>(provider->getSize(), bytesMax);
+
+        const char *result;
+        if (auto view = provider->getDirectView(0x00, size); view.has_value()) {
+            result = magic_buffer(cookie, view->data(), view->size());
+        } else {
+            std::vector<u8> buffer(size, 0x00);
+            provider->read(0x00, buffer.data(), buffer.size());
+            result = magic_buffer(cookie, buffer.data(), buffer.size());
+        }
+
+        return result != nullptr ? result : "";
+    }
+
+    std::string Magic::identify(prv::Provider *provider, u64 address, size_t size, int flags) {
+        if (provider == nullptr || address >= provider->getActualSize())
+            return "";
+
+        std::scoped_lock lock(Magic::s_mutex);
+
+        auto cookie = Magic::getCookie(flags);
+        if (cookie == nullptr)
+            return "";
+
+        size_t bytesMax = DefaultMagicBytesMax;
+        if (magic_getparam(cookie, MAGIC_PARAM_BYTES_MAX, &bytesMax) == -1)
+            bytesMax = DefaultMagicBytesMax;
+
+        size = std::min<u64>({ size, bytesMax, provider->getActualSize() - address });
+
+        const char *result;
+        if (auto view = provider->getAbsoluteDirectView(address, size); view.has_value()) {
+            result = magic_buffer(cookie, view->data(), view->size());
+        } else {
+            std::vector<u8> buffer(size, 0x00);
+            provider->readAbsolute(address, buffer.data(), buffer.size());
+            result = magic_buffer(cookie, buffer.data(), buffer.size());
+        }
+
+        return result != nullptr ? result : "";
+    }
+
+    bool Magic::hasDatabase() {
+        std::scoped_lock lock(Magic::s_mutex);
+
+        return Magic::getCookie(MAGIC_NONE) != nullptr;
+    }
+
+    void Magic::preload() {
+        std::scoped_lock lock(Magic::s_mutex);
+
+        Magic::getCookie(MAGIC_NONE);
+    }
+
+    std::string Magic::getDescription(prv::Provider *provider) {
+        return Magic::identify(provider, MAGIC_NONE);
+    }
+
+    std::string Magic::getMIMEType(prv::Provider *provider) {
+        return Magic::identify(provider, MAGIC_MIME);
+    }
+
+}
\ No newline at end of file
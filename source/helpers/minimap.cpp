@@ -0,0 +1,282 @@
+#include "helpers/minimap.hpp"
+
+#include <hex/api/imhex_api.hpp>
+#include <hex/helpers/shared_data.hpp>
+#include <hex/providers/provider.hpp>
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <array>
+
+namespace hex {
+
+    namespace {
+
+        // More queued changes than this aren't worth merging, everything gets recounted instead
+        constexpr size_t MaxChangedRegions = 256;
+
+        // Rows get counted and handed to the texture in batches, so the minimap fills up while large data is still being counted
+        constexpr u32 BatchRowCount = 64;
+
+        const std::array<ImVec4, 4> ByteClassColors = {
+            ImVec4(0.12F, 0.12F, 0.12F, 1.0F),  // Zero
+            ImVec4(0.25F, 0.63F, 1.00F, 1.0F),  // Printable
+            ImVec4(0.25F, 0.82F, 0.38F, 1.0F),  // Control
+            ImVec4(1.00F, 0.50F, 0.19F, 1.0F)   // High
+        };
+
+    }
+
+    Minimap::~Minimap() {
+        this->m_countingTask.interrupt();
+        this->m_countingTask.wait();
+
+        if (this->m_texture != 0) {
+            GLuint texture = this->m_texture;
+            glDeleteTextures(1, &texture);
+        }
+    }
+
+    void Minimap::reset() {
+        {
+            std::scoped_lock lock(this->m_changesMutex);
+            this->m_resetPending = true;
+            this->m_changedRegions.clear();
+        }
+
+        this->m_countingTask.interrupt();
+    }
+
+    void Minimap::markChanged(Region region) {
+        std::scoped_lock lock(this->m_changesMutex);
+
+        if (this->m_resetPending)
+            return;
+
+        if (this->m_changedRegions.size() >= MaxChangedRegions) {
+            this->m_resetPending = true;
+            this->m_changedRegions.clear();
+        } else
+            this->m_changedRegions.push_back(region);
+    }
+
+    void Minimap::colorRow(Rows &rows, u32 row) {
+        const auto &node = rows.nodes[row];
+
+        ImVec4 classColor(0, 0, 0, 1);
+        for (u8 byteClass = 0; byteClass < ByteClassColors.size(); byteClass++) {
+            float ratio = node.getClassRatio(ByteClass(byteClass));
+            classColor.x += ByteClassColors[byteClass].x * ratio;
+            classColor.y += ByteClassColors[byteClass].y * ratio;
+            classColor.z += ByteClassColors[byteClass].z * ratio;
+        }
+
+        // Dark for low entropy, going through red to yellow for random data
+        float entropy = node.averageEntropy;
+        ImVec4 entropyColor(std::min(entropy * 2.0F, 1.0F), std::max(entropy * 2.0F - 1.0F, 0.0F), 0.15F * (1.0F - entropy), 1.0F);
+
+        rows.pixels[row * 2 + 0] = ImGui::ColorConvertFloat4ToU32(classColor);
+        rows.pixels[row * 2 + 1] = ImGui::ColorConvertFloat4ToU32(entropyColor);
+    }
+
+    void Minimap::startCounting(u32 firstRow, u32 lastRow) {
+        auto provider = ImHexApi::Provider::getHandle();
+        std::shared_ptr<Rows> rows;
+        {
+            std::scoped_lock lock(this->m_rowsMutex);
+            rows = this->m_rows;
+        }
+
+        if (provider == nullptr || rows == nullptr)
+            return;
+
+        this->m_countingTask = TaskManager::createTask("hex.view.hexeditor.minimap.counting", lastRow - firstRow + 1, [this, provider, rows, firstRow, lastRow](Task &task) {
+            for (u32 batchStart = firstRow; batchStart <= lastRow && !task.isInterrupted(); batchStart += BatchRowCount) {
+                u32 batchEnd = std::min(batchStart + BatchRowCount - 1, lastRow);
+
+                u64 offset = u64(batchStart) * rows->rowSize;
+                size_t size = std::min<u64>(u64(batchEnd + 1) * rows->rowSize, rows->dataSize) - offset;
+
+                auto counts = countBlocks(provider.get(), offset, size, rows->rowSize, task.getInterruptFlag());
+                if (task.isInterrupted())
+                    return;
+
+                {
+                    std::scoped_lock lock(this->m_rowsMutex);
+
+                    for (u32 row = batchStart; row <= batchEnd; row++) {
+                        size_t rowSize = std::min<u64>(rows->rowSize, rows->dataSize - u64(row) * rows->rowSize);
+
+                        rows->nodes[row] = EntropyMap::createLeaf(counts[row - batchStart], rowSize);
+                        colorRow(*rows, row);
+                    }
+
+                    if (rows->dirty) {
+                        rows->firstDirtyRow = std::min(rows->firstDirtyRow, batchStart);
+                        rows->lastDirtyRow = std::max(rows->lastDirtyRow, batchEnd);
+                    } else {
+                        rows->firstDirtyRow = batchStart;
+                        rows->lastDirtyRow = batchEnd;
+                        rows->dirty = true;
+                    }
+                }
+
+                task.update(batchEnd - firstRow + 1);
+            }
+        });
+    }
+
+    void Minimap::uploadRows() {
+        std::scoped_lock lock(this->m_rowsMutex);
+
+        if (this->m_rows == nullptr)
+            return;
+
+        auto &rows = *this->m_rows;
+        u32 rowCount = rows.nodes.size();
+
+        if (this->m_texture == 0) {
+            GLuint texture;
+            glGenTextures(1, &texture);
+            glBindTexture(GL_TEXTURE_2D, texture);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+            this->m_texture = texture;
+            this->m_textureRows = 0;
+        }
+
+        if (this->m_textureRows != rowCount) {
+            glBindTexture(GL_TEXTURE_2D, this->m_texture);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 2, rowCount, 0, GL_RGBA, GL_UNSIGNED_BYTE, rows.pixels.data());
+
+            this->m_textureRows = rowCount;
+            rows.dirty = false;
+        } else if (rows.dirty) {
+            glBindTexture(GL_TEXTURE_2D, this->m_texture);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, rows.firstDirtyRow, 2, rows.lastDirtyRow - rows.firstDirtyRow + 1, GL_RGBA, GL_UNSIGNED_BYTE, rows.pixels.data() + rows.firstDirtyRow * 2);
+
+            rows.dirty = false;
+        }
+    }
+
+    std::optional<u64> Minimap::draw(ImVec2 size, Region visible) {
+        auto provider = SharedData::currentProvider;
+        if (provider == nullptr || !provider->isReadable() || size.x <= 0 || size.y <= 0)
+            return { };
+
+        // Only one count runs at a time, whatever changes in the meantime waits for it to finish
+        if (!this->m_countingTask.isRunning()) {
+            size_t dataSize = provider->getActualSize();
+
+            std::vector<Region> changedRegions;
+            bool recountAll;
+            {
+                std::scoped_lock lock(this->m_changesMutex);
+                std::swap(changedRegions, this->m_changedRegions);
+                recountAll = this->m_resetPending;
+                this->m_resetPending = false;
+            }
+
+            {
+                std::scoped_lock lock(this->m_rowsMutex);
+                if (this->m_rows == nullptr || this->m_rows->dataSize != dataSize)
+                    recountAll = true;
+            }
+
+            if (recountAll && dataSize == 0) {
+                std::scoped_lock lock(this->m_rowsMutex);
+                this->m_rows = nullptr;
+            } else if (recountAll) {
+                auto rows = std::make_shared<Rows>();
+                rows->dataSize = dataSize;
+                rows->rowSize = std::max<size_t>(MinRowSize, (dataSize + MaxRowCount - 1) / MaxRowCount);
+
+                u32 rowCount = (dataSize + rows->rowSize - 1) / rows->rowSize;
+                rows->nodes.resize(rowCount);
+                rows->pixels.resize(rowCount * 2, 0x00);
+
+                {
+                    std::scoped_lock lock(this->m_rowsMutex);
+                    this->m_rows = rows;
+                }
+
+                this->startCounting(0, rowCount - 1);
+            } else if (!recountAll && !changedRegions.empty()) {
+                size_t rowSize, rowCount;
+                {
+                    std::scoped_lock lock(this->m_rowsMutex);
+                    rowSize = this->m_rows->rowSize;
+                    rowCount = this->m_rows->nodes.size();
+                }
+
+                u64 firstRow = rowCount, lastRow = 0;
+                for (const auto &region : changedRegions) {
+                    if (region.size == 0 || region.address >= dataSize)
+                        continue;
+
+                    firstRow = std::min<u64>(firstRow, region.address / rowSize);
+                    lastRow = std::max<u64>(lastRow, std::min<u64>(region.address + region.size - 1, dataSize - 1) / rowSize);
+                }
+
+                if (firstRow <= lastRow)
+                    this->startCounting(firstRow, lastRow);
+            }
+        }
+
+        this->uploadRows();
+
+        auto start = ImGui::GetCursorScreenPos();
+        float position = std::clamp((ImGui::GetMousePos().y - start.y) / size.y, 0.0F, 1.0F);
+
+        size_t dataSize, rowSize;
+        EntropyMap::Node hoveredNode;
+        {
+            std::scoped_lock lock(this->m_rowsMutex);
+            if (this->m_rows == nullptr || this->m_rows->dataSize == 0) {
+                ImGui::Dummy(size);
+                return { };
+            }
+
+            dataSize = this->m_rows->dataSize;
+            rowSize = this->m_rows->rowSize;
+            hoveredNode = this->m_rows->nodes[std::min<u64>(u64(double(position) * dataSize) / rowSize, this->m_rows->nodes.size() - 1)];
+        }
+
+        auto drawList = ImGui::GetWindowDrawList();
+        auto texture = reinterpret_cast<ImTextureID>(static_cast<intptr_t>(this->m_texture));
+        float columnWidth = size.x / 2;
+
+        ImGui::InvisibleButton("##minimap", size);
+
+        // Sampling the centers of the two texel columns keeps the linear filtering from blending byte classes and entropy together
+        drawList->AddRectFilled(start, ImVec2(start.x + size.x, start.y + size.y), ImGui::GetColorU32(ImGuiCol_FrameBg));
+        drawList->AddImage(texture, start, ImVec2(start.x + columnWidth - 1, start.y + size.y), ImVec2(0.25F, 0.0F), ImVec2(0.25F, 1.0F));
+        drawList->AddImage(texture, ImVec2(start.x + columnWidth, start.y), ImVec2(start.x + size.x, start.y + size.y), ImVec2(0.75F, 0.0F), ImVec2(0.75F, 1.0F));
+
+        float visibleStart = start.y + float(double(visible.address) / dataSize) * size.y;
+        float visibleEnd = std::max(start.y + float(double(visible.address + visible.size) / dataSize) * size.y, visibleStart + 2);
+        drawList->AddRectFilled(ImVec2(start.x, visibleStart), ImVec2(start.x + size.x, visibleEnd), ImGui::GetColorU32(ImGuiCol_Text, 0.25F));
+        drawList->AddRect(ImVec2(start.x, visibleStart), ImVec2(start.x + size.x, visibleEnd), ImGui::GetColorU32(ImGuiCol_Text));
+
+        u64 address = std::min<u64>(u64(double(position) * dataSize), dataSize - 1);
+
+        if (ImGui::IsItemHovered() && hoveredNode.size > 0) {
+            ImGui::BeginTooltip();
+            ImGui::TextUnformatted(hex::format("0x{0:08X} - 0x{1:08X}", (address / rowSize) * rowSize, std::min<u64>((address / rowSize + 1) * rowSize, dataSize) - 1).c_str());
+            ImGui::TextUnformatted(hex::format("hex.view.hexeditor.minimap.entropy"_lang, hoveredNode.averageEntropy).c_str());
+            ImGui::TextUnformatted(hex::format("hex.view.hexeditor.minimap.printable"_lang, hoveredNode.getClassRatio(ByteClass::Printable) * 100).c_str());
+            ImGui::TextUnformatted(hex::format("hex.view.hexeditor.minimap.zeros"_lang, hoveredNode.getClassRatio(ByteClass::Zero) * 100).c_str());
+            ImGui::EndTooltip();
+        }
+
+        if (ImGui::IsItemActivated() || (ImGui::IsItemActive() && ImGui::IsMouseDragging(ImGuiMouseButton_Left)))
+            return address;
+
+        return { };
+    }
+
+}
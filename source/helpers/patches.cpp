@@ -1,217 +1,618 @@
 #include "helpers/patches.hpp"
 
+#include <hex/providers/provider.hpp>
+#include <hex/helpers/crypto.hpp>
+
+#include <algorithm>
 #include <cstring>
+#include <istream>
+#include <ostream>
 #include <string_view>
-#include <type_traits>
-
-#include <hex/helpers/utils.hpp>
+#include <vector>
 
 namespace hex {
 
-    static void pushBytesBack(std::vector<u8> &buffer, const char* bytes) {
-        std::string_view string(bytes);
-        buffer.resize(buffer.size() + string.length());
-        std::memcpy((&buffer.back() - string.length()) + 1, string.begin(), string.length());
-    }
+    namespace {
 
-    template<typename T>
-    static void pushBytesBack(std::vector<u8> &buffer, T bytes) {
-        buffer.resize(buffer.size() + sizeof(T));
-        std::memcpy((&buffer.back() - sizeof(T)) + 1, &bytes, sizeof(T));
-    }
-    
-    std::vector<u8> generateIPSPatch(const Patches &patches) {
-        std::vector<u8> result;
+        constexpr u32 Crc32Polynomial   = 0xEDB8'8320;
+        constexpr size_t ChunkSize      = 0x10'0000;
+        constexpr size_t FooterSize     = 3 * sizeof(u32);
 
-        pushBytesBack(result, "PATCH");
+        // Repeated bytes shorter than this are cheaper to store as they are than in a record of their own
+        constexpr size_t MinRepeatLength = 16;
 
-        std::vector<u64> addresses;
-        std::vector<u8> values;
+        enum class BpsAction : u8 {
+            SourceRead  = 0,
+            TargetRead  = 1,
+            SourceCopy  = 2,
+            TargetCopy  = 3
+        };
 
-        for (const auto &[address, value] : patches) {
-            addresses.push_back(address);
-            values.push_back(value);
-        }
+        /* Writes to the stream while keeping the CRC32 of everything written, which UPS and BPS patches end with */
+        class PatchWriter {
+        public:
+            explicit PatchWriter(std::ostream &stream) : m_stream(stream), m_crc(Crc32Polynomial, 0xFFFF'FFFF) { }
+
+            void write(const u8 *data, size_t size) {
+                this->m_crc.process(data, size);
+                this->m_stream.write(reinterpret_cast<const char*>(data), size);
+            }
+
+            void write(std::string_view string) {
+                this->write(reinterpret_cast<const u8*>(string.data()), string.size());
+            }
+
+            void writeByte(u8 value) {
+                this->write(&value, 1);
+            }
+
+            void writeBigEndian(u64 value, u8 size) {
+                for (u8 i = size; i > 0; i--)
+                    this->writeByte(value >> ((i - 1) * 8));
+            }
+
+            void writeLittleEndian(u64 value, u8 size) {
+                for (u8 i = 0; i < size; i++)
+                    this->writeByte(value >> (i * 8));
+            }
 
-        std::optional<u64> startAddress;
-        std::vector<u8> bytes;
-        for (u32 i = 0; i < addresses.size(); i++) {
-            if (!startAddress.has_value())
-                startAddress = addresses[i];
+            /* Variable length numbers of UPS and BPS. Every byte holds seven bits, the last one has its top bit set */
+            void writeNumber(u64 value) {
+                while (true) {
+                    u8 bits = value & 0x7F;
+                    value >>= 7;
 
-            if (i != addresses.size() - 1 && addresses[i] == (addresses[i + 1] - 1)) {
-                bytes.push_back(values[i]);
-            } else {
-                bytes.push_back(values[i]);
+                    if (value == 0) {
+                        this->writeByte(0x80 | bits);
+                        break;
+                    }
+
+                    this->writeByte(bits);
+                    value--;
+                }
+            }
+
+            void writeSignedNumber(s64 value) {
+                this->writeNumber((u64(value < 0 ? -value : value) << 1) | (value < 0 ? 1 : 0));
+            }
+
+            [[nodiscard]] u32 getChecksum() const { return ~this->m_crc.getValue(); }
+            [[nodiscard]] bool good() const { return this->m_stream.good(); }
+
+        private:
+            std::ostream &m_stream;
+            crypt::Crc<u32> m_crc;
+        };
+
+        /* Counterpart to PatchWriter. Every read fails once the stream ran out of data */
+        class PatchReader {
+        public:
+            explicit PatchReader(std::istream &stream) : m_stream(stream), m_crc(Crc32Polynomial, 0xFFFF'FFFF) {
+                this->m_stream.seekg(0, std::ios::end);
+                this->m_size = this->m_stream.tellg();
+                this->m_stream.seekg(0, std::ios::beg);
+
+                if (!this->m_stream.good())
+                    this->m_size = 0;
+            }
+
+            bool read(u8 *data, size_t size) {
+                this->m_stream.read(reinterpret_cast<char*>(data), size);
+                if (size_t(this->m_stream.gcount()) != size)
+                    return false;
+
+                this->m_crc.process(data, size);
+                this->m_position += size;
+
+                return true;
+            }
+
+            bool readMagic(std::string_view magic) {
+                std::vector<u8> buffer(magic.size());
+                return this->read(buffer.data(), buffer.size()) && std::memcmp(buffer.data(), magic.data(), magic.size()) == 0;
+            }
 
-                if (bytes.size() > 0xFFFF || startAddress > 0xFF'FFFF)
+            std::optional<u8> readByte() {
+                u8 value;
+                if (!this->read(&value, 1))
                     return { };
 
-                u32 address = startAddress.value();
-                auto addressBytes = reinterpret_cast<u8*>(&address);
+                return value;
+            }
 
-                result.push_back(addressBytes[2]); result.push_back(addressBytes[1]); result.push_back(addressBytes[0]);
-                pushBytesBack<u16>(result, changeEndianess<u16>(bytes.size(), std::endian::big));
+            std::optional<u64> readBigEndian(u8 size) {
+                u64 value = 0;
+                for (u8 i = 0; i < size; i++) {
+                    auto byte = this->readByte();
+                    if (!byte.has_value())
+                        return { };
 
-                for (auto byte : bytes)
-                    result.push_back(byte);
+                    value = (value << 8) | byte.value();
+                }
 
-                bytes.clear();
-                startAddress = { };
+                return value;
             }
-        }
 
-        pushBytesBack(result, "EOF");
+            std::optional<u64> readLittleEndian(u8 size) {
+                u64 value = 0;
+                for (u8 i = 0; i < size; i++) {
+                    auto byte = this->readByte();
+                    if (!byte.has_value())
+                        return { };
 
-        return result;
-    }
+                    value |= u64(byte.value()) << (i * 8);
+                }
 
-    std::vector<u8> generateIPS32Patch(const Patches &patches) {
-        std::vector<u8> result;
+                return value;
+            }
 
-        pushBytesBack(result, "IPS32");
+            std::optional<u64> readNumber() {
+                u64 value = 0, shift = 1;
 
-        std::vector<u64> addresses;
-        std::vector<u8> values;
+                while (true) {
+                    auto byte = this->readByte();
+                    if (!byte.has_value())
+                        return { };
 
-        for (const auto &[address, value] : patches) {
-            addresses.push_back(address);
-            values.push_back(value);
-        }
+                    value += (byte.value() & 0x7F) * shift;
+                    if (byte.value() & 0x80)
+                        return value;
 
-        std::optional<u64> startAddress;
-        std::vector<u8> bytes;
-        for (u32 i = 0; i < addresses.size(); i++) {
-            if (!startAddress.has_value())
-                startAddress = addresses[i];
+                    // More bytes than a 64 bit number can need
+                    if (shift >= (u64(1) << 56))
+                        return { };
 
-            if (i != addresses.size() - 1 && addresses[i] == (addresses[i + 1] - 1)) {
-                bytes.push_back(values[i]);
-            } else {
-                bytes.push_back(values[i]);
+                    shift <<= 7;
+                    value += shift;
+                }
+            }
 
-                if (bytes.size() > 0xFFFF || startAddress > 0xFFFF'FFFF)
+            std::optional<s64> readSignedNumber() {
+                auto value = this->readNumber();
+                if (!value.has_value())
                     return { };
 
-                u32 address = startAddress.value();
-                auto addressBytes = reinterpret_cast<u8*>(&address);
+                return (value.value() & 1) ? -s64(value.value() >> 1) : s64(value.value() >> 1);
+            }
+
+            /* CRC32 of everything read so far */
+            [[nodiscard]] u32 getChecksum() const { return ~this->m_crc.getValue(); }
 
-                result.push_back(addressBytes[3]); result.push_back(addressBytes[2]); result.push_back(addressBytes[1]); result.push_back(addressBytes[0]);
-                pushBytesBack<u16>(result, changeEndianess<u16>(bytes.size(), std::endian::big));
+            [[nodiscard]] u64 getPosition() const { return this->m_position; }
+            [[nodiscard]] u64 getSize() const { return this->m_size; }
 
-                for (auto byte : bytes)
-                    result.push_back(byte);
+        private:
+            std::istream &m_stream;
+            crypt::Crc<u32> m_crc;
+            u64 m_position = 0, m_size = 0;
+        };
 
-                bytes.clear();
-                startAddress = { };
+        /* CRC32 of the whole data, with the patches applied if there are any */
+        u32 calculateChecksum(prv::Provider *provider, const prv::PatchStore *patches) {
+            crypt::Crc<u32> crc(Crc32Polynomial, 0xFFFF'FFFF);
+
+            const auto size = provider->getActualSize();
+            std::vector<u8> buffer(std::min<size_t>(ChunkSize, size));
+
+            for (u64 offset = 0; offset < size; offset += buffer.size()) {
+                auto readSize = std::min<u64>(buffer.size(), size - offset);
+
+                provider->readRaw(offset, buffer.data(), readSize);
+                if (patches != nullptr)
+                    patches->overlay(offset, buffer.data(), readSize);
+
+                crc.process(buffer.data(), readSize);
             }
+
+            return ~crc.getValue();
         }
 
-        pushBytesBack(result, "EEOF");
+        size_t getRepeatLength(const std::vector<u8> &data, size_t offset, size_t limit) {
+            size_t length = 1;
+            while (offset + length < data.size() && length < limit && data[offset + length] == data[offset])
+                length++;
 
-        return result;
-    }
+            return length;
+        }
 
-    Patches loadIPSPatch(const std::vector<u8> &ipsPatch) {
-        if (ipsPatch.size() < (5 + 3))
-            return { };
+        /* Adds the data as patches, leaving out the bytes that are the same as the unpatched ones */
+        void writeChanges(prv::PatchStore &patches, prv::Provider *provider, u64 address, const u8 *data, size_t size) {
+            std::vector<u8> original(size);
+            provider->readRaw(address, original.data(), size);
 
-        if (std::memcmp(ipsPatch.data(), "PATCH", 5) != 0)
-            return { };
+            for (size_t i = 0; i < size;) {
+                if (data[i] == original[i]) {
+                    i++;
+                    continue;
+                }
 
-        Patches result;
-        bool foundEOF = false;
+                size_t end = i;
+                while (end < size && data[end] != original[end])
+                    end++;
 
-        u32 ipsOffset = 5;
-        while (ipsOffset < ipsPatch.size() - (5 + 3)) {
-            u32 offset = ipsPatch[ipsOffset + 2] | (ipsPatch[ipsOffset + 1] << 8) | (ipsPatch[ipsOffset + 0] << 16);
-            u16 size = ipsPatch[ipsOffset + 4] | (ipsPatch[ipsOffset + 3] << 8);
+                patches.write(address + i, data + i, end - i);
+                i = end;
+            }
+        }
 
-            ipsOffset += 5;
+        bool writeIPSPatch(PatchWriter &writer, prv::Provider *provider, const prv::PatchStore &patches, bool ips32) {
+            const u8 addressSize    = ips32 ? 4 : 3;
+            const u64 endMarker     = ips32 ? 0x4545'4F46 : 0x45'4F46;
+            const u64 maxAddress    = ips32 ? 0xFFFF'FFFF : 0xFF'FFFF;
+            constexpr size_t MaxRecordSize = 0xFFFF;
 
-            // Handle normal record
-            if (size > 0x0000) {
-                if (ipsOffset + size > ipsPatch.size() - 3)
-                    return { };
+            writer.write(ips32 ? "IPS32" : "PATCH");
+
+            std::vector<u8> extendedRun;
+            for (const auto &[runAddress, run] : patches.getRuns()) {
+                if (runAddress + run.size() - 1 > maxAddress)
+                    return false;
+
+                u64 address = runAddress;
+                const auto *runData = &run;
+
+                // A record starting at the address that reads as the end marker would end the patch, it has to start a byte earlier
+                if (address == endMarker) {
+                    extendedRun.resize(run.size() + 1);
+                    provider->readRaw(address - 1, extendedRun.data(), 1);
+                    std::copy(run.begin(), run.end(), extendedRun.begin() + 1);
+
+                    runData = &extendedRun;
+                    address--;
+                }
+
+                const auto &data = *runData;
 
-                for (u16 i = 0; i < size; i++)
-                    result[offset + i] = ipsPatch[ipsOffset + i];
-                ipsOffset += size;
+                for (size_t i = 0; i < data.size();) {
+                    auto repeatLength = getRepeatLength(data, i, MaxRecordSize);
+
+                    if (repeatLength >= MinRepeatLength && address + i != endMarker) {
+                        writer.writeBigEndian(address + i, addressSize);
+                        writer.writeBigEndian(0x0000, 2);
+                        writer.writeBigEndian(repeatLength, 2);
+                        writer.writeByte(data[i]);
+
+                        i += repeatLength;
+                    } else {
+                        // Same problem inside of a run, the byte before was already written so it simply gets written again
+                        size_t start = address + i == endMarker ? i - 1 : i;
+
+                        size_t end = i + 1;
+                        while (end < data.size() && end - start < MaxRecordSize && getRepeatLength(data, end, MinRepeatLength) < MinRepeatLength)
+                            end++;
+
+                        writer.writeBigEndian(address + start, addressSize);
+                        writer.writeBigEndian(end - start, 2);
+                        writer.write(data.data() + start, end - start);
+
+                        i = end;
+                    }
+                }
             }
-            // Handle RLE record
-            else {
-                if (ipsOffset + 3 > ipsPatch.size() - 3)
+
+            writer.write(ips32 ? "EEOF" : "EOF");
+
+            return writer.good();
+        }
+
+        std::optional<prv::PatchStore> readIPSPatch(PatchReader &reader, bool ips32) {
+            const u8 addressSize    = ips32 ? 4 : 3;
+            const u64 endMarker     = ips32 ? 0x4545'4F46 : 0x45'4F46;
+
+            if (!reader.readMagic(ips32 ? "IPS32" : "PATCH"))
+                return { };
+
+            prv::PatchStore patches;
+            std::vector<u8> buffer;
+
+            while (true) {
+                auto address = reader.readBigEndian(addressSize);
+                if (!address.has_value())
                     return { };
 
-                u16 rleSize = ipsPatch[ipsOffset + 0] | (ipsPatch[ipsOffset + 1] << 8);
+                if (address.value() == endMarker)
+                    break;
+
+                auto size = reader.readBigEndian(2);
+                if (!size.has_value())
+                    return { };
 
-                ipsOffset += 2;
+                if (size.value() > 0) {
+                    buffer.resize(size.value());
+                    if (!reader.read(buffer.data(), buffer.size()))
+                        return { };
+                } else {
+                    auto repeatLength = reader.readBigEndian(2);
+                    auto value = reader.readByte();
+                    if (!repeatLength.has_value() || !value.has_value())
+                        return { };
 
-                for (u16 i = 0; i < rleSize; i++)
-                    result[offset + i] = ipsPatch[ipsOffset + 0];
+                    buffer.assign(repeatLength.value(), value.value());
+                }
 
-                ipsOffset += 1;
+                patches.write(address.value(), buffer.data(), buffer.size());
             }
 
-            if (std::memcmp(ipsPatch.data(), "EOF", 3))
-                foundEOF = true;
+            return patches;
         }
 
-        if (foundEOF)
-            return result;
-        else
-            return { };
-    }
+        void writeFooter(PatchWriter &writer, prv::Provider *provider, const prv::PatchStore &patches) {
+            writer.writeLittleEndian(calculateChecksum(provider, nullptr), sizeof(u32));
+            writer.writeLittleEndian(calculateChecksum(provider, &patches), sizeof(u32));
+            writer.writeLittleEndian(writer.getChecksum(), sizeof(u32));
+        }
+
+        /* The patch has to be intact and made for exactly this data, checking the result catches broken encoders */
+        bool checkFooter(PatchReader &reader, prv::Provider *provider, const prv::PatchStore &patches) {
+            auto sourceChecksum = reader.readLittleEndian(sizeof(u32));
+            auto targetChecksum = reader.readLittleEndian(sizeof(u32));
+            auto patchChecksum  = reader.getChecksum();
+
+            if (reader.readLittleEndian(sizeof(u32)) != patchChecksum)
+                return false;
+
+            return sourceChecksum == calculateChecksum(provider, nullptr) && targetChecksum == calculateChecksum(provider, &patches);
+        }
+
+        bool writeUPSPatch(PatchWriter &writer, prv::Provider *provider, const prv::PatchStore &patches) {
+            const auto size = provider->getActualSize();
+
+            writer.write("UPS1");
+            writer.writeNumber(size);
+            writer.writeNumber(size);
+
+            u64 position = 0;
+            std::vector<u8> original;
+            for (const auto &[address, data] : patches.getRuns()) {
+                original.resize(data.size());
+                provider->readRaw(address, original.data(), data.size());
+
+                // Blocks of changed bytes are stored xor-ed with the original ones and end with a zero byte, which covers the unchanged byte after them
+                for (size_t i = 0; i < data.size();) {
+                    if (data[i] == original[i]) {
+                        i++;
+                        continue;
+                    }
+
+                    writer.writeNumber(address + i - position);
+                    for (; i < data.size() && data[i] != original[i]; i++)
+                        writer.writeByte(data[i] ^ original[i]);
+                    writer.writeByte(0x00);
+
+                    position = address + i + 1;
+                }
+            }
 
-    Patches loadIPS32Patch(const std::vector<u8> &ipsPatch) {
-        if (ipsPatch.size() < (5 + 4))
-            return { };
+            writeFooter(writer, provider, patches);
 
-        if (std::memcmp(ipsPatch.data(), "IPS32", 5) != 0)
-            return { };
+            return writer.good();
+        }
+
+        std::optional<prv::PatchStore> readUPSPatch(PatchReader &reader, prv::Provider *provider) {
+            const auto size = provider->getActualSize();
+
+            if (!reader.readMagic("UPS1"))
+                return { };
+
+            // Providers can't grow or shrink, so patches changing the size can't be applied
+            auto sourceSize = reader.readNumber(), targetSize = reader.readNumber();
+            if (sourceSize != size || targetSize != size || reader.getSize() < FooterSize)
+                return { };
 
-        Patches result;
-        bool foundEEOF = false;
+            prv::PatchStore patches;
+            std::vector<u8> buffer, original;
 
-        u32 ipsOffset = 5;
-        while (ipsOffset < ipsPatch.size() - (5 + 4)) {
-            u32 offset = ipsPatch[ipsOffset + 3] | (ipsPatch[ipsOffset + 2] << 8) | (ipsPatch[ipsOffset + 1] << 16) | (ipsPatch[ipsOffset + 0] << 24);
-            u16 size = ipsPatch[ipsOffset + 5] | (ipsPatch[ipsOffset + 4] << 8);
+            u64 position = 0;
+            while (reader.getPosition() < reader.getSize() - FooterSize) {
+                auto skip = reader.readNumber();
+                if (!skip.has_value())
+                    return { };
+                position += skip.value();
+
+                buffer.clear();
+                while (true) {
+                    auto value = reader.readByte();
+                    if (!value.has_value())
+                        return { };
+                    if (value.value() == 0x00)
+                        break;
 
-            ipsOffset += 6;
+                    buffer.push_back(value.value());
+                }
 
-            // Handle normal record
-            if (size > 0x0000) {
-                if (ipsOffset + size > ipsPatch.size() - 3)
+                if (position > size || buffer.size() > size - position)
                     return { };
 
-                for (u16 i = 0; i < size; i++)
-                    result[offset + i] = ipsPatch[ipsOffset + i];
-                ipsOffset += size;
+                original.resize(buffer.size());
+                provider->readRaw(position, original.data(), original.size());
+                for (size_t i = 0; i < buffer.size(); i++)
+                    buffer[i] ^= original[i];
+
+                patches.write(position, buffer.data(), buffer.size());
+                position += buffer.size() + 1;
+            }
+
+            if (!checkFooter(reader, provider, patches))
+                return { };
+
+            return patches;
+        }
+
+        bool writeBPSPatch(PatchWriter &writer, prv::Provider *provider, const prv::PatchStore &patches) {
+            const auto size = provider->getActualSize();
+
+            writer.write("BPS1");
+            writer.writeNumber(size);
+            writer.writeNumber(size);
+            writer.writeNumber(0);      // No metadata
+
+            const auto writeAction = [&writer](BpsAction action, u64 length) {
+                writer.writeNumber(((length - 1) << 2) | u8(action));
+            };
+
+            u64 outputOffset = 0, targetRelativeOffset = 0;
+            for (const auto &[address, data] : patches.getRuns()) {
+                if (address > outputOffset)
+                    writeAction(BpsAction::SourceRead, address - outputOffset);
+                outputOffset = address;
+
+                for (size_t i = 0; i < data.size();) {
+                    auto repeatLength = getRepeatLength(data, i, data.size());
+
+                    if (repeatLength >= MinRepeatLength) {
+                        // Copying from the byte that was just written repeats it
+                        writeAction(BpsAction::TargetRead, 1);
+                        writer.writeByte(data[i]);
+
+                        writeAction(BpsAction::TargetCopy, repeatLength - 1);
+                        writer.writeSignedNumber(s64(outputOffset + i) - s64(targetRelativeOffset));
+                        targetRelativeOffset = outputOffset + i + repeatLength - 1;
+
+                        i += repeatLength;
+                    } else {
+                        size_t end = i + 1;
+                        while (end < data.size() && getRepeatLength(data, end, MinRepeatLength) < MinRepeatLength)
+                            end++;
+
+                        writeAction(BpsAction::TargetRead, end - i);
+                        writer.write(data.data() + i, end - i);
+
+                        i = end;
+                    }
+                }
+
+                outputOffset = address + data.size();
             }
-            // Handle RLE record
-            else {
-                if (ipsOffset + 3 > ipsPatch.size() - 3)
+
+            if (size > outputOffset)
+                writeAction(BpsAction::SourceRead, size - outputOffset);
+
+            writeFooter(writer, provider, patches);
+
+            return writer.good();
+        }
+
+        std::optional<prv::PatchStore> readBPSPatch(PatchReader &reader, prv::Provider *provider) {
+            const auto size = provider->getActualSize();
+
+            if (!reader.readMagic("BPS1"))
+                return { };
+
+            auto sourceSize = reader.readNumber(), targetSize = reader.readNumber(), metadataSize = reader.readNumber();
+            if (sourceSize != size || targetSize != size || !metadataSize.has_value() || reader.getSize() < FooterSize)
+                return { };
+
+            std::vector<u8> buffer;
+            for (u64 remaining = metadataSize.value(); remaining > 0;) {
+                buffer.resize(std::min<u64>(remaining, ChunkSize));
+                if (!reader.read(buffer.data(), buffer.size()))
                     return { };
 
-                u16 rleSize = ipsPatch[ipsOffset + 0] | (ipsPatch[ipsOffset + 1] << 8);
+                remaining -= buffer.size();
+            }
+
+            prv::PatchStore patches;
 
-                ipsOffset += 2;
+            u64 outputOffset = 0, sourceRelativeOffset = 0, targetRelativeOffset = 0;
+            while (reader.getPosition() < reader.getSize() - FooterSize) {
+                auto command = reader.readNumber();
+                if (!command.has_value())
+                    return { };
 
-                for (u16 i = 0; i < rleSize; i++)
-                    result[offset + i] = ipsPatch[ipsOffset + 0];
+                auto action = BpsAction(command.value() & 0b11);
+                u64 length = (command.value() >> 2) + 1;
+                if (outputOffset > size || length > size - outputOffset)
+                    return { };
 
-                ipsOffset += 1;
+                switch (action) {
+                    case BpsAction::SourceRead:
+                        // Same as the unpatched data, nothing to do
+                        break;
+                    case BpsAction::TargetRead:
+                        for (u64 offset = 0; offset < length; offset += buffer.size()) {
+                            buffer.resize(std::min<u64>(length - offset, ChunkSize));
+                            if (!reader.read(buffer.data(), buffer.size()))
+                                return { };
+
+                            writeChanges(patches, provider, outputOffset + offset, buffer.data(), buffer.size());
+                        }
+                        break;
+                    case BpsAction::SourceCopy: {
+                        auto relativeOffset = reader.readSignedNumber();
+                        if (!relativeOffset.has_value())
+                            return { };
+
+                        sourceRelativeOffset += relativeOffset.value();
+                        if (sourceRelativeOffset > size || length > size - sourceRelativeOffset)
+                            return { };
+
+                        for (u64 offset = 0; offset < length; offset += buffer.size()) {
+                            buffer.resize(std::min<u64>(length - offset, ChunkSize));
+                            provider->readRaw(sourceRelativeOffset + offset, buffer.data(), buffer.size());
+
+                            writeChanges(patches, provider, outputOffset + offset, buffer.data(), buffer.size());
+                        }
+
+                        sourceRelativeOffset += length;
+                        break;
+                    }
+                    case BpsAction::TargetCopy: {
+                        auto relativeOffset = reader.readSignedNumber();
+                        if (!relativeOffset.has_value())
+                            return { };
+
+                        targetRelativeOffset += relativeOffset.value();
+                        if (targetRelativeOffset >= outputOffset)
+                            return { };
+
+                        // The copy may overlap the data it produces, so only what has been produced already is copied at once
+                        for (u64 offset = 0; offset < length; offset += buffer.size()) {
+                            buffer.resize(std::min<u64>({ length - offset, outputOffset + offset - targetRelativeOffset, ChunkSize }));
+                            provider->readRaw(targetRelativeOffset, buffer.data(), buffer.size());
+                            patches.overlay(targetRelativeOffset, buffer.data(), buffer.size());
+
+                            writeChanges(patches, provider, outputOffset + offset, buffer.data(), buffer.size());
+                            targetRelativeOffset += buffer.size();
+                        }
+                        break;
+                    }
+                }
+
+                outputOffset += length;
             }
 
-            if (std::memcmp(ipsPatch.data(), "EEOF", 4))
-                foundEEOF = true;
+            if (outputOffset != size || !checkFooter(reader, provider, patches))
+                return { };
+
+            return patches;
+        }
+
+    }
+
+    bool writePatch(PatchFormat format, std::ostream &stream, prv::Provider *provider, const prv::PatchStore &patches) {
+        PatchWriter writer(stream);
+
+        switch (format) {
+            case PatchFormat::IPS:      return writeIPSPatch(writer, provider, patches, false);
+            case PatchFormat::IPS32:    return writeIPSPatch(writer, provider, patches, true);
+            case PatchFormat::UPS:      return writeUPSPatch(writer, provider, patches);
+            case PatchFormat::BPS:      return writeBPSPatch(writer, provider, patches);
+        }
+
+        return false;
+    }
+
+    std::optional<prv::PatchStore> readPatch(PatchFormat format, std::istream &stream, prv::Provider *provider) {
+        PatchReader reader(stream);
+
+        switch (format) {
+            case PatchFormat::IPS:      return readIPSPatch(reader, false);
+            case PatchFormat::IPS32:    return readIPSPatch(reader, true);
+            case PatchFormat::UPS:      return readUPSPatch(reader, provider);
+            case PatchFormat::BPS:      return readBPSPatch(reader, provider);
         }
 
-        if (foundEEOF)
-            return result;
-        else
-            return { };
+        return { };
     }
 
 }
\ No newline at end of file
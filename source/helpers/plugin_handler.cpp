@@ -1,6 +1,12 @@
 #include "helpers/plugin_handler.hpp"
 
+#include <hex/api/content_registry.hpp>
+#include <hex/api/task.hpp>
+
+#include <algorithm>
 #include <filesystem>
+#include <fstream>
+#include <nlohmann/json.hpp>
 
 namespace hex {
 
@@ -12,13 +18,40 @@ namespace hex {
     constexpr auto GetPluginAuthorSymbol        = "_ZN3hex6plugin{0}{1}8internal15getPluginAuthorEv";
     constexpr auto GetPluginDescriptionSymbol   = "_ZN3hex6plugin{0}{1}8internal20getPluginDescriptionEv";
 
-    Plugin::Plugin(std::string_view path) {
-        this->m_handle = dlopen(path.data(), RTLD_LAZY);
+    Plugin::Plugin(std::string_view path) : m_path(path) {
+        std::ifstream manifestFile(this->m_path + ".json");
+        if (!manifestFile.is_open())
+            return;
+
+        try {
+            auto manifest = nlohmann::json::parse(manifestFile);
+
+            this->m_manifestName        = manifest.value("name", "");
+            this->m_manifestAuthor      = manifest.value("author", "");
+            this->m_manifestDescription = manifest.value("description", "");
+            this->m_lazy                = manifest.value("lazy", false);
+
+            if (manifest.contains("nodes")) {
+                for (auto &node : manifest["nodes"])
+                    this->m_providedNodes.emplace_back(node["category"].get<std::string>(), node["name"].get<std::string>());
+            }
+        } catch (nlohmann::json::exception &e) {
+            // A broken manifest doesn't make the plugin unusable, it just gets opened right away
+            this->m_lazy = false;
+            this->m_providedNodes.clear();
+        }
+    }
+
+    void Plugin::load() {
+        if (this->m_handle != nullptr)
+            return;
+
+        this->m_handle = dlopen(this->m_path.c_str(), RTLD_LAZY);
 
         if (this->m_handle == nullptr)
             return;
 
-        auto pluginName = fs::path(path).stem().string();
+        auto pluginName = fs::path(this->m_path).stem().string();
 
         this->m_initializePluginFunction        = getPluginFunction<InitializePluginFunc>(pluginName, InitializePluginSymbol);
         this->m_getPluginNameFunction           = getPluginFunction<GetPluginNameFunc>(pluginName, GetPluginNameSymbol);
@@ -26,13 +59,32 @@ namespace hex {
         this->m_getPluginDescriptionFunction    = getPluginFunction<GetPluginDescriptionFunc>(pluginName, GetPluginDescriptionSymbol);
     }
 
+    bool Plugin::isLoaded() const {
+        return this->m_handle != nullptr;
+    }
+
+    bool Plugin::isLazy() const {
+        return this->m_lazy;
+    }
+
+    const std::vector<std::pair<std::string, std::string>>& Plugin::getProvidedNodes() const {
+        return this->m_providedNodes;
+    }
+
     Plugin::Plugin(Plugin &&other) noexcept {
+        this->m_path = std::move(other.m_path);
         this->m_handle = other.m_handle;
         this->m_initializePluginFunction        = other.m_initializePluginFunction;
         this->m_getPluginNameFunction           = other.m_getPluginNameFunction;
         this->m_getPluginAuthorFunction         = other.m_getPluginAuthorFunction;
         this->m_getPluginDescriptionFunction    = other.m_getPluginDescriptionFunction;
 
+        this->m_lazy                = other.m_lazy;
+        this->m_manifestName        = std::move(other.m_manifestName);
+        this->m_manifestAuthor      = std::move(other.m_manifestAuthor);
+        this->m_manifestDescription = std::move(other.m_manifestDescription);
+        this->m_providedNodes       = std::move(other.m_providedNodes);
+
         other.m_handle = nullptr;
         other.m_initializePluginFunction        = nullptr;
         other.m_getPluginNameFunction           = nullptr;
@@ -53,6 +105,8 @@ namespace hex {
     std::string Plugin::getPluginName() const {
         if (this->m_getPluginNameFunction != nullptr)
             return this->m_getPluginNameFunction();
+        else if (!this->m_manifestName.empty())
+            return this->m_manifestName;
         else
             return hex::format("Unknown Plugin @ 0x{0:016X}", this->m_handle);
     }
@@ -60,6 +114,8 @@ namespace hex {
     std::string Plugin::getPluginAuthor() const {
         if (this->m_getPluginAuthorFunction != nullptr)
             return this->m_getPluginAuthorFunction();
+        else if (!this->m_manifestAuthor.empty())
+            return this->m_manifestAuthor;
         else
             return "Unknown";
     }
@@ -68,7 +124,7 @@ namespace hex {
         if (this->m_getPluginDescriptionFunction != nullptr)
             return this->m_getPluginDescriptionFunction();
         else
-            return "";
+            return this->m_manifestDescription;
     }
 
     void PluginHandler::load(std::string_view pluginFolder) {
@@ -77,10 +133,94 @@ namespace hex {
 
         PluginHandler::s_pluginFolder = pluginFolder;
 
+        auto firstPlugin = PluginHandler::s_plugins.size();
         for (auto& pluginPath : std::filesystem::directory_iterator(pluginFolder)) {
             if (pluginPath.is_regular_file() && pluginPath.path().extension() == ".hexplug")
                 PluginHandler::s_plugins.emplace_back(pluginPath.path().string());
         }
+
+        // Opening a library mostly waits for the disk and relocations, which works fine for multiple libraries at once
+        TaskManager::runParallel(PluginHandler::s_plugins.size() - firstPlugin, [firstPlugin](u32 index) {
+            auto &plugin = PluginHandler::s_plugins[firstPlugin + index];
+
+            if (!plugin.isLazy())
+                plugin.load();
+        });
+    }
+
+    void PluginHandler::initializePlugins() {
+        for (size_t i = 0; i < PluginHandler::s_plugins.size(); i++) {
+            auto &plugin = PluginHandler::s_plugins[i];
+
+            if (!plugin.isLazy()) {
+                plugin.initializePlugin();
+                continue;
+            }
+
+            for (const auto &[category, name] : plugin.getProvidedNodes()) {
+                ContentRegistry::DataProcessorNode::getEntries().push_back({ category, name, [i, category = category, name = name]() -> dp::Node* {
+                    // Loading the plugin replaces this function, so nothing captured can be used after that
+                    auto nodeCategory = category, nodeName = name;
+                    if (!PluginHandler::loadLazyPlugin(i))
+                        return nullptr;
+
+                    for (const auto &entry : ContentRegistry::DataProcessorNode::getEntries()) {
+                        if (entry.category == nodeCategory && entry.name == nodeName)
+                            return entry.creatorFunction();
+                    }
+
+                    return nullptr;
+                } });
+            }
+        }
+    }
+
+    bool PluginHandler::loadLazyPlugin(size_t index) {
+        auto &plugin = PluginHandler::s_plugins[index];
+        if (plugin.isLoaded())
+            return true;
+
+        plugin.load();
+        if (!plugin.isLoaded())
+            return false;
+
+        auto &entries = ContentRegistry::DataProcessorNode::getEntries();
+        auto &providedNodes = plugin.getProvidedNodes();
+
+        auto isProvided = [&providedNodes](const auto &entry) {
+            return std::find(providedNodes.begin(), providedNodes.end(), std::pair(entry.category, entry.name)) != providedNodes.end();
+        };
+
+        std::vector<size_t> placeholders;
+        for (size_t i = 0; i < entries.size(); i++) {
+            if (isProvided(entries[i]))
+                placeholders.push_back(i);
+        }
+
+        auto firstNewEntry = entries.size();
+        plugin.initializePlugin();
+
+        // The real nodes take the place of their placeholders so the menu keeps its order, placeholders without a real node go away
+        std::vector<bool> removed(entries.size(), false);
+        for (auto placeholder : placeholders) {
+            removed[placeholder] = true;
+
+            for (auto i = firstNewEntry; i < entries.size(); i++) {
+                if (!removed[i] && entries[i].category == entries[placeholder].category && entries[i].name == entries[placeholder].name) {
+                    entries[placeholder].creatorFunction = std::move(entries[i].creatorFunction);
+                    removed[placeholder] = false;
+                    removed[i] = true;
+                    break;
+                }
+            }
+        }
+
+        for (auto i = entries.size(); i > 0; i--) {
+            if (removed[i - 1])
+                entries.erase(entries.begin() + (i - 1));
+        }
+
+        return true;
     }
 
     void PluginHandler::unload() {
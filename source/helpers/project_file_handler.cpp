@@ -1,5 +1,12 @@
 #include "helpers/project_file_handler.hpp"
 
+#include <hex/helpers/utils.hpp>
+#include <hex/views/view.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <filesystem>
 #include <fstream>
 #include <nlohmann/json.hpp>
 
@@ -7,45 +14,239 @@ using json = nlohmann::json;
 
 namespace hex {
 
-    void to_json(json& j, const ImHexApi::Bookmarks::Entry& b) {
-        j = json{ { "address", b.region.address }, { "size", b.region.size }, { "name", b.name.data() }, { "comment", b.comment.data() }, { "locked", b.locked } };
-    }
+    namespace {
+
+        constexpr std::array<char, 8> Magic = { 'I', 'M', 'H', 'X', 'P', 'R', 'O', 'J' };
+        constexpr u32 Version = 1;
+
+        constexpr size_t HeaderSize = Magic.size() + sizeof(u32);
+        constexpr size_t RecordHeaderSize = sizeof(u8) + sizeof(u64);
+
+        /* Everything is stored in little endian */
+        class Writer {
+        public:
+            template<typename T>
+            void write(T value) {
+                for (size_t i = 0; i < sizeof(T); i++)
+                    this->m_data.push_back(u8(u64(value) >> (i * 8)));
+            }
+
+            void write(const void *data, size_t size) {
+                auto bytes = static_cast<const u8*>(data);
+                this->m_data.insert(this->m_data.end(), bytes, bytes + size);
+            }
+
+            void writeString(std::string_view string) {
+                this->write<u64>(string.size());
+                this->write(string.data(), string.size());
+            }
 
-    void from_json(const json& j, ImHexApi::Bookmarks::Entry& b) {
-        std::string name, comment;
+            [[nodiscard]] std::vector<u8>& getData() { return this->m_data; }
 
-        j.at("address").get_to(b.region.address);
-        j.at("size").get_to(b.region.size);
-        j.at("name").get_to(name);
-        j.at("comment").get_to(comment);
-        j.at("locked").get_to(b.locked);
+        private:
+            std::vector<u8> m_data;
+        };
+
+        /* Reads past the end return zeros and mark the reader as failed, so truncated sections can't read out of bounds */
+        class Reader {
+        public:
+            explicit Reader(const std::vector<u8> &data) : m_data(data) { }
+
+            template<typename T>
+            T read() {
+                if (!this->canRead(sizeof(T)))
+                    return T();
+
+                u64 value = 0;
+                for (size_t i = 0; i < sizeof(T); i++)
+                    value |= u64(this->m_data[this->m_offset++]) << (i * 8);
+
+                return T(value);
+            }
+
+            const u8* read(size_t size) {
+                if (!this->canRead(size))
+                    return nullptr;
+
+                auto data = this->m_data.data() + this->m_offset;
+                this->m_offset += size;
+
+                return data;
+            }
+
+            std::string readString() {
+                auto size = this->read<u64>();
+                auto data = this->read(size);
+
+                return data == nullptr ? "" : std::string(reinterpret_cast<const char*>(data), size);
+            }
+
+            [[nodiscard]] bool hasFailed() const { return this->m_failed; }
+
+        private:
+            bool canRead(u64 size) {
+                if (this->m_failed || size > this->m_data.size() - this->m_offset)
+                    this->m_failed = true;
+
+                return !this->m_failed;
+            }
+
+            const std::vector<u8> &m_data;
+            size_t m_offset = 0;
+            bool m_failed = false;
+        };
+
+        void writeRecord(Writer &file, u8 section, const std::vector<u8> &payload) {
+            file.write<u8>(section);
+            file.write<u64>(payload.size());
+            file.write(payload.data(), payload.size());
+        }
+
+        void writeRuns(Writer &writer, const std::vector<std::pair<u64, const std::vector<u8>*>> &runs) {
+            writer.write<u64>(runs.size());
+            for (const auto &[address, bytes] : runs) {
+                writer.write<u64>(address);
+                writer.write<u64>(bytes->size());
+                writer.write(bytes->data(), bytes->size());
+            }
+        }
+
+        bool readRuns(Reader &reader, prv::PatchStore &patches) {
+            auto count = reader.read<u64>();
+            for (u64 i = 0; i < count && !reader.hasFailed(); i++) {
+                auto address = reader.read<u64>();
+                auto size    = reader.read<u64>();
+
+                if (auto bytes = reader.read(size); bytes != nullptr)
+                    patches.write(address, bytes, size);
+            }
+
+            return !reader.hasFailed();
+        }
+
+        /* Regions whose patched bytes differ, runs are always coalesced so equal runs also cover the exact same bytes */
+        std::vector<Region> getChangedRegions(const prv::PatchStore &from, const prv::PatchStore &to) {
+            std::vector<Region> changes;
+
+            auto collect = [&changes](const auto &runs, const auto &otherRuns) {
+                for (const auto &[address, bytes] : runs) {
+                    if (auto other = otherRuns.find(address); other == otherRuns.end() || other->second != bytes)
+                        changes.push_back({ address, bytes.size() });
+                }
+            };
+
+            collect(from.getRuns(), to.getRuns());
+            collect(to.getRuns(), from.getRuns());
+
+            std::sort(changes.begin(), changes.end(), [](const Region &a, const Region &b) { return a.address < b.address; });
+
+            std::vector<Region> merged;
+            for (const auto &change : changes) {
+                if (!merged.empty() && change.address <= merged.back().address + merged.back().size)
+                    merged.back().size = std::max(merged.back().address + merged.back().size, change.address + change.size) - merged.back().address;
+                else
+                    merged.push_back(change);
+            }
+
+            return merged;
+        }
+
+        void from_json(const json& j, ImHexApi::Bookmarks::Entry& b) {
+            std::string name, comment;
+
+            j.at("address").get_to(b.region.address);
+            j.at("size").get_to(b.region.size);
+            j.at("name").get_to(name);
+            j.at("comment").get_to(comment);
+            j.at("locked").get_to(b.locked);
+
+            std::copy(name.begin(), name.end(), std::back_inserter(b.name));
+            std::copy(comment.begin(), comment.end(), std::back_inserter(b.comment));
+        }
+
+        std::string_view getCString(const std::vector<char> &string) {
+            return { string.data(), ::strnlen(string.data(), string.size()) };
+        }
 
-        std::copy(name.begin(), name.end(), std::back_inserter(b.name));
-        std::copy(comment.begin(), comment.end(), std::back_inserter(b.comment));
     }
 
 
     bool ProjectFile::load(std::string_view filePath) {
+        ProjectFile::waitForAutosave();
         ProjectFile::s_hasUnsavedChanged = false;
 
-        json projectFileData;
+        std::ifstream projectFile(std::string(filePath), std::ios::binary);
+        if (!projectFile.is_open())
+            return false;
+
+        std::array<char, Magic.size()> magic = { };
+        projectFile.read(magic.data(), magic.size());
+
+        std::vector<Record> records;
+        if (projectFile && magic == Magic) {
+            std::array<u8, sizeof(u32)> version = { };
+            projectFile.read(reinterpret_cast<char*>(version.data()), version.size());
+            if (!projectFile || Reader({ version.begin(), version.end() }).read<u32>() > Version)
+                return false;
+
+            auto fileSize = std::filesystem::file_size(filePath);
 
-        try {
-            std::ifstream projectFile(filePath.data());
-            projectFile >> projectFileData;
+            // Only the record headers are read here, a record cut off by a crash while appending ends the file
+            u64 offset = HeaderSize;
+            while (offset + RecordHeaderSize <= fileSize) {
+                std::vector<u8> header(RecordHeaderSize);
+                projectFile.seekg(offset);
+                projectFile.read(reinterpret_cast<char*>(header.data()), header.size());
 
-            ProjectFile::s_filePath = projectFileData["filePath"];
-            ProjectFile::s_pattern  = projectFileData["pattern"];
-            ProjectFile::s_patches  = projectFileData["patches"].get<Patches>();
+                Reader reader(header);
+                auto section = Section(reader.read<u8>());
+                auto size    = reader.read<u64>();
 
-            for (auto &element : projectFileData["bookmarks"].items()) {
-                ProjectFile::s_bookmarks.push_back(element.value().get<ImHexApi::Bookmarks::Entry>());
+                if (!projectFile || size > fileSize - offset - RecordHeaderSize)
+                    break;
+
+                records.push_back({ section, offset + RecordHeaderSize, size });
+                offset += RecordHeaderSize + size;
             }
 
-        } catch (json::exception &e) {
-            return false;
-        } catch (std::ofstream::failure &e) {
-            return false;
+            ProjectFile::s_filePath.clear();
+            ProjectFile::s_pattern.clear();
+            ProjectFile::s_patches.clear();
+            ProjectFile::s_bookmarks.clear();
+
+            ProjectFile::s_filePatches.reset();
+            ProjectFile::s_fileSections.clear();
+
+            ProjectFile::s_records = std::move(records);
+            ProjectFile::s_loadedSections.clear();
+            ProjectFile::s_isBinary = true;
+            ProjectFile::s_committedSize = offset;
+        } else {
+            json projectFileData;
+
+            try {
+                projectFile.seekg(0);
+                projectFile.clear();
+                projectFile >> projectFileData;
+
+                ProjectFile::s_filePath = projectFileData["filePath"];
+                ProjectFile::s_pattern  = projectFileData["pattern"];
+                ProjectFile::s_patches  = prv::PatchStore::fromByteMap(projectFileData["patches"].get<std::map<u64, u8>>());
+
+                ProjectFile::s_bookmarks.clear();
+                for (auto &element : projectFileData["bookmarks"].items()) {
+                    ImHexApi::Bookmarks::Entry bookmark;
+                    from_json(element.value(), bookmark);
+                    ProjectFile::s_bookmarks.push_back(bookmark);
+                }
+            } catch (json::exception &e) {
+                return false;
+            }
+
+            ProjectFile::s_records.clear();
+            ProjectFile::s_loadedSections = { Section::FilePath, Section::Pattern, Section::Bookmarks, Section::Patches };
+            ProjectFile::s_isBinary = false;
+            ProjectFile::s_committedSize = 0;
         }
 
         ProjectFile::s_currProjectFilePath = filePath;
@@ -54,33 +255,295 @@ namespace hex {
     }
 
     bool ProjectFile::store(std::string_view filePath) {
-        ProjectFile::s_hasUnsavedChanged = false;
-
-        json projectFileData;
+        ProjectFile::waitForAutosave();
 
         if (filePath.empty())
             filePath = ProjectFile::s_currProjectFilePath;
 
-        try {
-            projectFileData["filePath"] = ProjectFile::s_filePath;
-            projectFileData["pattern"]  = ProjectFile::s_pattern;
-            projectFileData["patches"]  = ProjectFile::s_patches;
+        // Everything still stored in the old file has to be read before it gets overwritten
+        for (auto section : { Section::FilePath, Section::Pattern, Section::Bookmarks, Section::Patches })
+            ProjectFile::loadSection(section);
 
-            for (auto &bookmark : ProjectFile::s_bookmarks) {
-                projectFileData["bookmarks"].push_back(bookmark);
-            }
+        Writer file;
+        file.write(Magic.data(), Magic.size());
+        file.write<u32>(Version);
 
-            std::ofstream projectFile(filePath.data(), std::fstream::trunc);
-            projectFile << projectFileData;
-        } catch (json::exception &e) {
-            return false;
-        } catch (std::ifstream::failure &e) {
-            return false;
+        std::map<Section, std::vector<u8>> sections;
+        for (auto section : { Section::FilePath, Section::Pattern, Section::Bookmarks }) {
+            sections[section] = ProjectFile::serializeSection(section);
+            writeRecord(file, u8(section), sections[section]);
+        }
+
+        {
+            std::vector<std::pair<u64, const std::vector<u8>*>> runs;
+            for (const auto &[address, bytes] : ProjectFile::s_patches.getRuns())
+                runs.emplace_back(address, &bytes);
+
+            Writer section;
+            writeRuns(section, runs);
+            writeRecord(file, u8(Section::Patches), section.getData());
         }
 
+        // Written next to the project and moved over it afterwards, so a crash while saving leaves the old project intact
+        auto tempPath = std::string(filePath) + ".tmp";
+        {
+            std::ofstream projectFile(tempPath, std::ios::binary | std::ios::trunc);
+            projectFile.write(reinterpret_cast<const char*>(file.getData().data()), file.getData().size());
+            projectFile.close();
+
+            if (!projectFile)
+                return false;
+        }
+
+        std::error_code error;
+        std::filesystem::rename(tempPath, filePath, error);
+        if (error)
+            return false;
+
+        // The saved file is compact again, none of the records describe it anymore and everything is already in memory
+        ProjectFile::s_records.clear();
+        ProjectFile::s_isBinary = true;
+        ProjectFile::s_committedSize = file.getData().size();
+        ProjectFile::s_filePatches = ProjectFile::s_patches;
+        ProjectFile::s_fileSections = std::move(sections);
+
+        ProjectFile::s_hasUnsavedChanged = false;
         ProjectFile::s_currProjectFilePath = filePath;
 
         return true;
     }
 
-}
\ No newline at end of file
+    void ProjectFile::autosave() {
+        if (ProjectFile::s_currProjectFilePath.empty() || !ProjectFile::s_isBinary || !ProjectFile::s_hasUnsavedChanged)
+            return;
+
+        auto now = std::chrono::steady_clock::now();
+        if (now - ProjectFile::s_lastAutosave < AutosaveInterval || ProjectFile::s_autosaveTask.isRunning())
+            return;
+        ProjectFile::s_lastAutosave = now;
+
+        // The patches the file replays to have to be known before the views replace them with the current ones
+        if (!ProjectFile::s_filePatches.has_value())
+            ProjectFile::s_filePatches = ProjectFile::getPatches();
+
+        View::postEvent(Events::ProjectFileStore);
+
+        // Only the small sections get serialized here, diffing and writing the patches happens on the task
+        std::map<Section, std::vector<u8>> changedSections;
+        for (auto section : { Section::FilePath, Section::Pattern, Section::Bookmarks }) {
+            auto payload = ProjectFile::serializeSection(section);
+
+            if (auto fileSection = ProjectFile::s_fileSections.find(section); fileSection == ProjectFile::s_fileSections.end() || fileSection->second != payload)
+                changedSections[section] = std::move(payload);
+        }
+
+        ProjectFile::s_autosaveTask = TaskManager::createTask("hex.common.autosaving", 0,
+            [path = ProjectFile::s_currProjectFilePath, patches = ProjectFile::s_patches, changedSections = std::move(changedSections)](Task &) {
+                Writer records;
+                for (const auto &[section, payload] : changedSections)
+                    writeRecord(records, u8(section), payload);
+
+                // Loading replaces everything inside of the changed regions with the runs that follow them
+                auto changes = getChangedRegions(*ProjectFile::s_filePatches, patches);
+                if (!changes.empty()) {
+                    Writer section;
+                    section.write<u64>(changes.size());
+
+                    std::vector<std::pair<u64, const std::vector<u8>*>> runs;
+                    for (const auto &change : changes) {
+                        section.write<u64>(change.address);
+                        section.write<u64>(change.size);
+
+                        auto &allRuns = patches.getRuns();
+                        for (auto it = allRuns.lower_bound(change.address); it != allRuns.end() && it->first < change.address + change.size; ++it)
+                            runs.emplace_back(it->first, &it->second);
+                    }
+                    writeRuns(section, runs);
+
+                    writeRecord(records, u8(Section::PatchChange), section.getData());
+                }
+
+                if (records.getData().empty())
+                    return;
+
+                // Appending never touches what's already in the file, a record cut off by a crash gets ignored when loading
+                std::ofstream projectFile(path, std::ios::binary | std::ios::app);
+                projectFile.write(reinterpret_cast<const char*>(records.getData().data()), records.getData().size());
+                projectFile.close();
+
+                if (!projectFile)
+                    return;
+
+                ProjectFile::s_filePatches = patches;
+                for (const auto &[section, payload] : changedSections)
+                    ProjectFile::s_fileSections[section] = payload;
+            });
+    }
+
+    void ProjectFile::discardAutosave() {
+        ProjectFile::waitForAutosave();
+
+        if (ProjectFile::s_currProjectFilePath.empty() || !ProjectFile::s_isBinary)
+            return;
+
+        std::error_code error;
+        if (std::filesystem::file_size(ProjectFile::s_currProjectFilePath, error) > ProjectFile::s_committedSize && !error)
+            std::filesystem::resize_file(ProjectFile::s_currProjectFilePath, ProjectFile::s_committedSize, error);
+
+        // The changes are gone now, don't save them again before exiting
+        ProjectFile::s_hasUnsavedChanged = false;
+    }
+
+    void ProjectFile::waitForAutosave() {
+        ProjectFile::s_autosaveTask.wait();
+    }
+
+
+    std::string ProjectFile::getFilePath() {
+        ProjectFile::loadSection(Section::FilePath);
+        return ProjectFile::s_filePath;
+    }
+
+    void ProjectFile::setFilePath(std::string_view filePath) {
+        ProjectFile::loadSection(Section::FilePath);
+        ProjectFile::s_hasUnsavedChanged = true;
+        ProjectFile::s_filePath = filePath;
+    }
+
+    std::string ProjectFile::getPattern() {
+        ProjectFile::loadSection(Section::Pattern);
+        return ProjectFile::s_pattern;
+    }
+
+    void ProjectFile::setPattern(std::string_view pattern) {
+        ProjectFile::loadSection(Section::Pattern);
+        ProjectFile::s_hasUnsavedChanged = true;
+        ProjectFile::s_pattern = pattern;
+    }
+
+    const prv::PatchStore& ProjectFile::getPatches() {
+        ProjectFile::loadSection(Section::Patches);
+        return ProjectFile::s_patches;
+    }
+
+    void ProjectFile::setPatches(const prv::PatchStore &patches) {
+        ProjectFile::loadSection(Section::Patches);
+        ProjectFile::s_hasUnsavedChanged = true;
+        ProjectFile::s_patches = patches;
+    }
+
+    const std::list<ImHexApi::Bookmarks::Entry>& ProjectFile::getBookmarks() {
+        ProjectFile::loadSection(Section::Bookmarks);
+        return ProjectFile::s_bookmarks;
+    }
+
+    void ProjectFile::setBookmarks(const std::list<ImHexApi::Bookmarks::Entry> &bookmarks) {
+        ProjectFile::loadSection(Section::Bookmarks);
+        ProjectFile::s_hasUnsavedChanged = true;
+        ProjectFile::s_bookmarks = bookmarks;
+    }
+
+
+    std::vector<u8> ProjectFile::serializeSection(Section section) {
+        Writer writer;
+
+        switch (section) {
+            case Section::FilePath:
+                writer.write(ProjectFile::s_filePath.data(), ProjectFile::s_filePath.size());
+                break;
+            case Section::Pattern:
+                writer.write(ProjectFile::s_pattern.data(), ProjectFile::s_pattern.size());
+                break;
+            case Section::Bookmarks:
+                writer.write<u64>(ProjectFile::s_bookmarks.size());
+                for (const auto &bookmark : ProjectFile::s_bookmarks) {
+                    writer.write<u64>(bookmark.region.address);
+                    writer.write<u64>(bookmark.region.size);
+                    writer.write<u8>(bookmark.locked);
+                    writer.writeString(getCString(bookmark.name));
+                    writer.writeString(getCString(bookmark.comment));
+                }
+                break;
+            default:
+                break;
+        }
+
+        return std::move(writer.getData());
+    }
+
+    std::vector<u8> ProjectFile::readRecord(const Record &record) {
+        std::vector<u8> payload(record.size);
+
+        std::ifstream projectFile(ProjectFile::s_currProjectFilePath, std::ios::binary);
+        projectFile.seekg(record.offset);
+        projectFile.read(reinterpret_cast<char*>(payload.data()), payload.size());
+
+        if (!projectFile)
+            payload.clear();
+
+        return payload;
+    }
+
+    void ProjectFile::loadSection(Section section) {
+        auto &loaded = ProjectFile::s_loadedSections;
+        if (std::find(loaded.begin(), loaded.end(), section) != loaded.end())
+            return;
+        loaded.push_back(section);
+
+        // Sections appearing more than once replace each other, patch changes get applied on top of the last full patch section
+        for (const auto &record : ProjectFile::s_records) {
+            bool isPatchRecord = record.section == Section::Patches || record.section == Section::PatchChange;
+            if (record.section != section && !(section == Section::Patches && isPatchRecord))
+                continue;
+
+            auto payload = ProjectFile::readRecord(record);
+            Reader reader(payload);
+
+            switch (record.section) {
+                case Section::FilePath:
+                    ProjectFile::s_filePath = std::string(payload.begin(), payload.end());
+                    break;
+                case Section::Pattern:
+                    ProjectFile::s_pattern = std::string(payload.begin(), payload.end());
+                    break;
+                case Section::Bookmarks: {
+                    ProjectFile::s_bookmarks.clear();
+
+                    auto count = reader.read<u64>();
+                    for (u64 i = 0; i < count && !reader.hasFailed(); i++) {
+                        ImHexApi::Bookmarks::Entry bookmark = { };
+                        bookmark.region.address = reader.read<u64>();
+                        bookmark.region.size    = reader.read<u64>();
+                        bookmark.locked         = reader.read<u8>() != 0;
+
+                        auto name = reader.readString(), comment = reader.readString();
+                        std::copy(name.begin(), name.end(), std::back_inserter(bookmark.name));
+                        std::copy(comment.begin(), comment.end(), std::back_inserter(bookmark.comment));
+
+                        if (!reader.hasFailed())
+                            ProjectFile::s_bookmarks.push_back(bookmark);
+                    }
+                    break;
+                }
+                case Section::Patches:
+                    ProjectFile::s_patches.clear();
+                    readRuns(reader, ProjectFile::s_patches);
+                    break;
+                case Section::PatchChange: {
+                    auto count = reader.read<u64>();
+                    for (u64 i = 0; i < count && !reader.hasFailed(); i++) {
+                        auto address = reader.read<u64>();
+                        auto size    = reader.read<u64>();
+
+                        if (!reader.hasFailed())
+                            ProjectFile::s_patches.erase(address, size);
+                    }
+
+                    readRuns(reader, ProjectFile::s_patches);
+                    break;
+                }
+            }
+        }
+    }
+
+}
@@ -0,0 +1,138 @@
+#include "helpers/session.hpp"
+
+#include <hex/api/imhex_api.hpp>
+#include <hex/helpers/analysis_cache.hpp>
+#include <hex/helpers/shared_data.hpp>
+#include <hex/views/view.hpp>
+
+#include "helpers/project_file_handler.hpp"
+
+#include <algorithm>
+#include <filesystem>
+
+namespace hex {
+
+    void Session::restore() {
+        auto reader = AnalysisCache::loadFile(SessionFileName);
+        if (!reader.has_value())
+            return;
+
+        std::string filePath, projectFilePath;
+        u64 analysisCount;
+        if (!reader->readString(filePath) || !reader->readString(projectFilePath) || !reader->read(analysisCount))
+            return;
+
+        std::vector<Analysis> analyses;
+        for (u64 i = 0; i < analysisCount; i++) {
+            Analysis analysis;
+            if (!reader->readString(analysis.name) || !reader->readString(analysis.argument))
+                return;
+
+            analyses.push_back(std::move(analysis));
+        }
+
+        std::error_code error;
+        if (filePath.empty() || !std::filesystem::exists(filePath, error))
+            return;
+
+        View::doLater([filePath = std::move(filePath), projectFilePath = std::move(projectFilePath), analyses = std::move(analyses)] {
+            std::error_code error;
+            if (!projectFilePath.empty() && std::filesystem::exists(projectFilePath, error) && ProjectFile::load(projectFilePath))
+                View::postEvent(Events::ProjectFileLoad);
+            else
+                View::postEvent(Events::FileDropped, filePath.c_str());
+
+            std::vector<std::pair<RerunFunction, std::string>> reruns;
+            {
+                std::scoped_lock lock(s_mutex);
+
+                // The file may have failed to open
+                if (s_provider == nullptr || s_provider != SharedData::currentProvider)
+                    return;
+
+                // Analyses are kept in the session until they get rerun, even if ImHex is closed before they finish
+                s_analyses = analyses;
+                store();
+
+                for (const auto &analysis : analyses) {
+                    if (auto it = s_rerunFunctions.find(analysis.name); it != s_rerunFunctions.end())
+                        reruns.emplace_back(it->second, analysis.argument);
+                }
+            }
+
+            for (const auto &[rerun, argument] : reruns)
+                rerun(argument);
+        });
+    }
+
+    void Session::setFile(prv::Provider *provider, std::string_view filePath, std::string_view projectFilePath) {
+        std::scoped_lock lock(s_mutex);
+
+        s_provider = filePath.empty() ? nullptr : provider;
+        s_filePath = filePath;
+        s_projectFilePath = projectFilePath;
+        s_analyses.clear();
+
+        store();
+    }
+
+    void Session::closeProvider(prv::Provider *provider) {
+        std::scoped_lock lock(s_mutex);
+
+        if (provider != s_provider)
+            return;
+
+        s_provider = nullptr;
+        s_filePath.clear();
+        s_projectFilePath.clear();
+        s_analyses.clear();
+
+        store();
+    }
+
+    void Session::registerAnalysis(std::string_view name, const RerunFunction &rerun) {
+        std::scoped_lock lock(s_mutex);
+
+        s_rerunFunctions.insert_or_assign(std::string(name), rerun);
+    }
+
+    void Session::unregisterAnalysis(std::string_view name) {
+        std::scoped_lock lock(s_mutex);
+
+        if (auto it = s_rerunFunctions.find(name); it != s_rerunFunctions.end())
+            s_rerunFunctions.erase(it);
+    }
+
+    void Session::addAnalysis(prv::Provider *provider, std::string_view name, std::string_view argument) {
+        std::scoped_lock lock(s_mutex);
+
+        if (provider == nullptr || provider != s_provider)
+            return;
+
+        auto it = std::find_if(s_analyses.begin(), s_analyses.end(), [name](const auto &analysis) { return analysis.name == name; });
+        if (it != s_analyses.end() && it->argument == argument)
+            return;
+
+        if (it != s_analyses.end())
+            it->argument = argument;
+        else
+            s_analyses.push_back({ std::string(name), std::string(argument) });
+
+        store();
+    }
+
+    void Session::store() {
+        AnalysisCache::Writer writer;
+        writer.writeString(s_filePath);
+        writer.writeString(s_projectFilePath);
+
+        writer.write<u64>(s_analyses.size());
+        for (const auto &analysis : s_analyses) {
+            writer.writeString(analysis.name);
+            writer.writeString(analysis.argument);
+        }
+
+        AnalysisCache::storeFile(SessionFileName, writer);
+    }
+
+}
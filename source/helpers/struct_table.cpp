@@ -0,0 +1,389 @@
+#include "helpers/struct_table.hpp"
+
+#include <hex/api/imhex_api.hpp>
+#include <hex/helpers/utils.hpp>
+#include <hex/lang/pattern_data.hpp>
+#include <hex/providers/provider.hpp>
+#include <hex/views/view.hpp>
+
+#include <imgui.h>
+#include <imgui_imhex_extensions.h>
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
+namespace hex {
+
+    StructArrayTable::~StructArrayTable() {
+        // The filter task publishes its result into the table
+        this->m_filterTask.interrupt();
+        this->m_filterTask.wait();
+    }
+
+    bool StructArrayTable::isSupported(const lang::PatternData *pattern) {
+        auto array = dynamic_cast<const lang::PatternDataStaticArray*>(pattern);
+
+        return array != nullptr && array->getEntryCount() > 0 && dynamic_cast<const lang::PatternDataStruct*>(array->getTemplate()) != nullptr;
+    }
+
+    void StructArrayTable::setArray(const lang::PatternDataStaticArray *array) {
+        this->m_array = array;
+
+        this->m_layout.reset();
+        this->m_filterTask.interrupt();
+        this->m_filterGeneration++;
+        this->m_filterMatches.reset();
+        this->m_filterColumn = 0;
+        this->invalidate();
+
+        if (!isSupported(array))
+            return;
+
+        auto layout = std::make_shared<Layout>();
+
+        // The template gets moved around whenever an entry of the array is drawn, the copy stays at the start of the array
+        auto entry = array->getTemplate()->clone(layout->arena);
+        entry->setOffset(array->getOffset());
+
+        layout->offset = array->getOffset();
+        layout->entrySize = entry->getSize();
+        layout->entryCount = std::min<u64>(array->getEntryCount(), std::numeric_limits<u32>::max());
+        addColumns(*layout, entry, entry->getOffset(), "");
+
+        if (layout->entrySize == 0 || layout->columns.empty())
+            return;
+
+        this->m_layout = std::move(layout);
+    }
+
+    void StructArrayTable::invalidate() {
+        this->m_cachedRows.clear();
+        this->m_sorter.invalidate();
+        this->m_sortDirty = true;
+        this->m_rowsDirty = true;
+
+        if (this->m_filter[0] != 0x00)
+            this->m_filterDirty = true;
+    }
+
+    void StructArrayTable::addColumns(Layout &layout, const lang::PatternData *pattern, u64 entryOffset, const std::string &prefix) {
+        for (auto member : static_cast<const lang::PatternDataStruct*>(pattern)->getMembers()) {
+            if (layout.columns.size() == MaximumColumnCount - 1)
+                return;
+
+            if (member->isHidden() || dynamic_cast<const lang::PatternDataPadding*>(member) != nullptr)
+                continue;
+
+            if (dynamic_cast<const lang::PatternDataStruct*>(member) != nullptr) {
+                addColumns(layout, member, entryOffset, prefix + member->getVariableName() + ".");
+                continue;
+            }
+
+            auto kind = ValueKind::Other;
+            if (dynamic_cast<const lang::PatternDataUnsigned*>(member) != nullptr && member->getSize() <= sizeof(u64))
+                kind = ValueKind::Unsigned;
+            else if (dynamic_cast<const lang::PatternDataSigned*>(member) != nullptr && member->getSize() <= sizeof(u64))
+                kind = ValueKind::Signed;
+            else if (dynamic_cast<const lang::PatternDataFloat*>(member) != nullptr && (member->getSize() == sizeof(float) || member->getSize() == sizeof(double)))
+                kind = ValueKind::Float;
+
+            layout.columns.push_back({ prefix + member->getVariableName(), member->getOffset() - entryOffset, member->getSize(), member->getEndian(), kind, member });
+        }
+    }
+
+    void StructArrayTable::decodeColumn(prv::Provider *provider, const Layout &layout, const Column &column, u64 first, u64 count, std::vector<u8> &values) {
+        u64 entriesPerRead = std::max<u64>(1, ReadSize / layout.entrySize);
+
+        values.resize(count * column.size);
+
+        std::vector<u8> buffer;
+        for (u64 entry = 0; entry < count; entry += entriesPerRead) {
+            u64 entries = std::min(entriesPerRead, count - entry);
+
+            buffer.resize(entries * layout.entrySize);
+            provider->read(layout.offset + (first + entry) * layout.entrySize, buffer.data(), buffer.size());
+
+            for (u64 i = 0; i < entries; i++)
+                std::memcpy(values.data() + (entry + i) * column.size, buffer.data() + i * layout.entrySize + column.offset, column.size);
+        }
+
+        if (column.kind != ValueKind::Other)
+            hex::changeEndianess(values.data(), count, column.size, column.endian);
+    }
+
+    std::string StructArrayTable::formatValue(const Column &column, const u8 *value) {
+        if (column.kind != ValueKind::Other) {
+            if (auto formatted = column.member->formatValue(value); formatted.has_value())
+                return std::move(*formatted);
+        }
+
+        // Everything that isn't a number is shown as its bytes
+        constexpr static size_t MaximumBytes = 16;
+
+        std::string result;
+        for (size_t i = 0; i < std::min(column.size, MaximumBytes); i++)
+            result += hex::format(i == 0 ? "{:02X}" : " {:02X}", value[i]);
+        if (column.size > MaximumBytes)
+            result += " ...";
+
+        return result;
+    }
+
+    /* Entries that follow each other are read at once, then every column is converted and formatted for all of them together */
+    void StructArrayTable::decodeRows(prv::Provider *provider, const std::vector<u32> &entries) {
+        const auto &layout = *this->m_layout;
+
+        std::vector<u32> missing;
+        for (auto entry : entries) {
+            if (!this->m_cachedRows.contains(entry))
+                missing.push_back(entry);
+        }
+
+        if (missing.empty())
+            return;
+
+        if (this->m_cachedRows.size() + missing.size() > MaximumCachedRows)
+            this->m_cachedRows.clear();
+
+        this->m_entryBuffer.resize(missing.size() * layout.entrySize);
+        for (size_t start = 0; start < missing.size();) {
+            size_t end = start + 1;
+            while (end < missing.size() && missing[end] == missing[end - 1] + 1)
+                end++;
+
+            provider->read(layout.offset + u64(missing[start]) * layout.entrySize, this->m_entryBuffer.data() + start * layout.entrySize, (end - start) * layout.entrySize);
+            start = end;
+        }
+
+        for (auto entry : missing)
+            this->m_cachedRows[entry].resize(layout.columns.size());
+
+        for (size_t column = 0; column < layout.columns.size(); column++) {
+            const auto &info = layout.columns[column];
+
+            this->m_valueBuffer.resize(missing.size() * info.size);
+            for (size_t i = 0; i < missing.size(); i++)
+                std::memcpy(this->m_valueBuffer.data() + i * info.size, this->m_entryBuffer.data() + i * layout.entrySize + info.offset, info.size);
+
+            if (info.kind != ValueKind::Other)
+                hex::changeEndianess(this->m_valueBuffer.data(), missing.size(), info.size, info.endian);
+
+            for (size_t i = 0; i < missing.size(); i++)
+                this->m_cachedRows[missing[i]][column] = formatValue(info, this->m_valueBuffer.data() + i * info.size);
+        }
+    }
+
+    /* Every entry's value in the filtered column gets formatted and checked on all task manager workers */
+    void StructArrayTable::startFilter() {
+        this->m_filterDirty = false;
+        this->m_filterTask.interrupt();
+
+        u64 generation = ++this->m_filterGeneration;
+        std::string filter = this->m_filter.data();
+
+        if (filter.empty()) {
+            std::scoped_lock lock(this->m_filterMutex);
+            this->m_filterMatches.reset();
+            return;
+        }
+
+        this->m_filterTask = TaskManager::createTask("hex.view.pattern_data.table.filtering", 0, [this, provider = ImHexApi::Provider::getHandle(), layout = this->m_layout, column = this->m_filterColumn, filter, generation](Task &task) {
+            constexpr static u64 EntriesPerPart = 0x1'0000;
+
+            const auto &info = layout->columns[column];
+            auto matches = std::make_shared<std::vector<u8>>(layout->entryCount, false);
+
+            u64 parts = (layout->entryCount + EntriesPerPart - 1) / EntriesPerPart;
+            std::atomic<u64> nextPart = 0;
+
+            TaskManager::runParallel(std::min<u64>(provider->getReadWorkerCount(), parts), [&](u32) {
+                std::vector<u8> values;
+                for (u64 part = nextPart++; part < parts && !task.isInterrupted(); part = nextPart++) {
+                    u64 first = part * EntriesPerPart;
+                    u64 count = std::min<u64>(EntriesPerPart, layout->entryCount - first);
+
+                    decodeColumn(provider.get(), *layout, info, first, count, values);
+                    for (u64 i = 0; i < count; i++)
+                        (*matches)[first + i] = formatValue(info, values.data() + i * info.size).find(filter) != std::string::npos;
+                }
+            });
+
+            if (task.isInterrupted())
+                return;
+
+            std::scoped_lock lock(this->m_filterMutex);
+            if (this->m_filterGeneration == generation)
+                this->m_filterMatches = std::move(matches);
+        });
+    }
+
+    void StructArrayTable::updateRows() {
+        auto order = this->m_sorter.getOrder();
+
+        std::shared_ptr<const std::vector<u8>> matches;
+        {
+            std::scoped_lock lock(this->m_filterMutex);
+            matches = this->m_filterMatches;
+        }
+
+        if (!this->m_rowsDirty && order == this->m_rowsOrder && matches == this->m_rowsMatches)
+            return;
+
+        this->m_rowsDirty = false;
+        this->m_rowsOrder = order;
+        this->m_rowsMatches = matches;
+
+        u32 entryCount = this->m_layout->entryCount;
+        if (order != nullptr && order->size() != entryCount)
+            order = nullptr;
+        if (matches != nullptr && matches->size() != entryCount)
+            matches = nullptr;
+
+        this->m_rows.clear();
+        for (u32 i = 0; i < entryCount; i++) {
+            u32 entry = order != nullptr ? (*order)[i] : i;
+            if (matches == nullptr || (*matches)[entry])
+                this->m_rows.push_back(entry);
+        }
+    }
+
+    void StructArrayTable::draw() {
+        auto provider = ImHexApi::Provider::getHandle();
+        if (this->m_layout == nullptr || provider == nullptr)
+            return;
+
+        const auto &layout = *this->m_layout;
+
+        ImGui::PushItemWidth(200);
+        if (ImGui::BeginCombo("##filter_column", layout.columns[this->m_filterColumn].name.c_str())) {
+            for (u32 column = 0; column < layout.columns.size(); column++) {
+                if (ImGui::Selectable(layout.columns[column].name.c_str(), column == this->m_filterColumn)) {
+                    this->m_filterColumn = column;
+                    this->m_filterDirty = true;
+                }
+            }
+            ImGui::EndCombo();
+        }
+        ImGui::SameLine();
+        if (ImGui::InputText("hex.view.pattern_data.table.filter"_lang, this->m_filter.data(), this->m_filter.size()))
+            this->m_filterDirty = true;
+        ImGui::PopItemWidth();
+
+        if (this->m_filterDirty)
+            this->startFilter();
+
+        if (this->m_filterTask.isRunning() || this->m_sorter.isSorting()) {
+            ImGui::SameLine();
+            ImGui::TextSpinner("hex.view.pattern_data.table.updating"_lang);
+        }
+
+        if (ImGui::BeginTable("##structarraytable", layout.columns.size() + 1, ImGuiTableFlags_Borders | ImGuiTableFlags_Resizable | ImGuiTableFlags_Sortable | ImGuiTableFlags_Reorderable | ImGuiTableFlags_Hideable | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollX | ImGuiTableFlags_ScrollY)) {
+            ImGui::TableSetupScrollFreeze(1, 1);
+            ImGui::TableSetupColumn("hex.view.pattern_data.table.index"_lang, ImGuiTableColumnFlags_NoHide);
+            for (const auto &column : layout.columns)
+                ImGui::TableSetupColumn(column.name.c_str());
+
+            ImGui::TableHeadersRow();
+
+            auto sortSpecs = ImGui::TableGetSortSpecs();
+            if ((sortSpecs->SpecsDirty || this->m_sortDirty) && sortSpecs->SpecsCount > 0) {
+                auto column = sortSpecs->Specs->ColumnIndex;
+                bool ascending = sortSpecs->Specs->SortDirection == ImGuiSortDirection_Ascending;
+
+                this->m_sorter.sort((u64(column) << 1) | u64(ascending), layout.entryCount, [provider, layout = this->m_layout, column, ascending]() -> TableSorter::Comparator {
+                    auto byKeys = [ascending](auto &&keys) -> TableSorter::Comparator {
+                        return [keys = std::make_shared<std::remove_cvref_t<decltype(keys)>>(std::move(keys)), ascending](u32 left, u32 right) {
+                            return ascending ? (*keys)[left] < (*keys)[right] : (*keys)[right] < (*keys)[left];
+                        };
+                    };
+
+                    if (column == 0) {
+                        return [ascending](u32 left, u32 right) { return ascending ? left < right : right < left; };
+                    }
+
+                    // The whole column gets decoded once, the comparisons only look at the keys
+                    const auto &info = layout->columns[column - 1];
+                    auto values = std::make_shared<std::vector<u8>>();
+                    decodeColumn(provider.get(), *layout, info, 0, layout->entryCount, *values);
+
+                    switch (info.kind) {
+                        case ValueKind::Unsigned: {
+                            std::vector<u64> keys(layout->entryCount);
+                            for (u32 i = 0; i < layout->entryCount; i++)
+                                std::memcpy(&keys[i], values->data() + i * info.size, info.size);
+                            return byKeys(std::move(keys));
+                        }
+                        case ValueKind::Signed: {
+                            std::vector<s64> keys(layout->entryCount);
+                            for (u32 i = 0; i < layout->entryCount; i++) {
+                                u64 value = 0;
+                                std::memcpy(&value, values->data() + i * info.size, info.size);
+                                u8 shift = 64 - info.size * 8;
+                                keys[i] = s64(value << shift) >> shift;
+                            }
+                            return byKeys(std::move(keys));
+                        }
+                        case ValueKind::Float: {
+                            std::vector<double> keys(layout->entryCount);
+                            for (u32 i = 0; i < layout->entryCount; i++) {
+                                if (info.size == sizeof(float)) {
+                                    float value;
+                                    std::memcpy(&value, values->data() + i * info.size, sizeof(value));
+                                    keys[i] = value;
+                                } else
+                                    std::memcpy(&keys[i], values->data() + i * info.size, sizeof(double));
+                            }
+                            return byKeys(std::move(keys));
+                        }
+                        default: {
+                            size_t size = info.size;
+                            return [values, size, ascending](u32 left, u32 right) {
+                                int result = std::memcmp(values->data() + left * size, values->data() + right * size, size);
+                                return ascending ? result < 0 : result > 0;
+                            };
+                        }
+                    }
+                });
+
+                sortSpecs->SpecsDirty = false;
+                this->m_sortDirty = false;
+            }
+
+            this->updateRows();
+
+            ImGuiListClipper clipper;
+            clipper.Begin(this->m_rows.size());
+
+            std::vector<u32> visibleEntries;
+            while (clipper.Step()) {
+                visibleEntries.assign(this->m_rows.begin() + clipper.DisplayStart, this->m_rows.begin() + clipper.DisplayEnd);
+                this->decodeRows(provider.get(), visibleEntries);
+
+                for (auto entry : visibleEntries) {
+                    const auto &values = this->m_cachedRows[entry];
+
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+
+                    ImGui::PushID(entry);
+                    if (ImGui::Selectable("##entry", false, ImGuiSelectableFlags_SpanAllColumns)) {
+                        Region selectRegion = { layout.offset + u64(entry) * layout.entrySize, layout.entrySize };
+                        View::postEvent(Events::SelectionChangeRequest, selectRegion);
+                    }
+                    ImGui::PopID();
+                    ImGui::SameLine();
+                    ImGui::Text("[%u]", entry);
+
+                    for (const auto &value : values) {
+                        ImGui::TableNextColumn();
+                        ImGui::TextUnformatted(value.c_str());
+                    }
+                }
+            }
+
+            ImGui::EndTable();
+        }
+    }
+
+}
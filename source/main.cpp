@@ -6,57 +6,77 @@
 #include <hex/providers/provider.hpp>
 #include <hex/lang/pattern_data.hpp>
 #include <hex/helpers/utils.hpp>
+#include <hex/helpers/profiler.hpp>
+#include <hex/helpers/tracing.hpp>
 
-#include "views/view_hexeditor.hpp"
-#include "views/view_pattern.hpp"
-#include "views/view_pattern_data.hpp"
-#include "views/view_hashes.hpp"
-#include "views/view_information.hpp"
-#include "views/view_help.hpp"
-#include "views/view_tools.hpp"
-#include "views/view_strings.hpp"
-#include "views/view_data_inspector.hpp"
-#include "views/view_disassembler.hpp"
-#include "views/view_bookmarks.hpp"
-#include "views/view_patches.hpp"
-#include "views/view_command_palette.hpp"
-#include "views/view_settings.hpp"
-#include "views/view_data_processor.hpp"
-#include "views/view_yara.hpp"
+#include "content.hpp"
+#include "helpers/session.hpp"
 
+#include <cstdio>
+#include <cstdlib>
+#include <string_view>
 #include <vector>
 
 int main(int argc, char **argv) {
     using namespace hex;
 
+    bool printStartupTimes = false;
+    const char *fileToOpen = nullptr;
+    const char *tracePath = nullptr;
+
+    for (int i = 1; i < argc; i++) {
+        std::string_view argument = argv[i];
+
+        if (argument == "--startup-times")
+            printStartupTimes = true;
+        else if (argument == "--fast-start")
+            SharedData::fastStart = true;
+        else if (argument == "--trace" && i + 1 < argc)
+            tracePath = argv[++i];
+        else if (fileToOpen == nullptr)
+            fileToOpen = argv[i];
+    }
+
+    // Records everything from startup on and writes it out once the window got closed
+    if (tracePath != nullptr)
+        Tracing::setEnabled(true);
+
     Window window(argc, argv);
 
+    if (ContentRegistry::Settings::read("hex.builtin.setting.imhex", "hex.builtin.setting.imhex.fast_start", 0) != 0)
+        SharedData::fastStart = true;
+
     // Shared Data
     std::vector<lang::PatternData*> patternData;
 
-    // Create views
-    ContentRegistry::Views::add<ViewHexEditor>(patternData);
-    ContentRegistry::Views::add<ViewPattern>(patternData);
-    ContentRegistry::Views::add<ViewPatternData>(patternData);
-    ContentRegistry::Views::add<ViewDataInspector>();
-    ContentRegistry::Views::add<ViewHashes>();
-    ContentRegistry::Views::add<ViewInformation>();
-    ContentRegistry::Views::add<ViewStrings>();
-    ContentRegistry::Views::add<ViewDisassembler>();
-    ContentRegistry::Views::add<ViewBookmarks>();
-    ContentRegistry::Views::add<ViewPatches>();
-    ContentRegistry::Views::add<ViewTools>();
-    ContentRegistry::Views::add<ViewCommandPalette>();
-    ContentRegistry::Views::add<ViewHelp>();
-    ContentRegistry::Views::add<ViewSettings>();
-    ContentRegistry::Views::add<ViewDataProcessor>();
-    ContentRegistry::Views::add<ViewYara>();
-
-    if (argc > 1)
-        View::postEvent(Events::FileDropped, const_cast<const char*>(argv[1]));
+    {
+        PROFILE_STARTUP("Providers");
+        registerProviders();
+    }
+
+    {
+        PROFILE_STARTUP("Views");
+        registerViews(patternData);
+    }
+
+    Profiler::finishStartup();
+
+    if (printStartupTimes) {
+        for (const auto &phase : Profiler::getStartupPhases())
+            std::printf("%-12s %9.3f ms\n", phase.name.c_str(), phase.time);
+        std::printf("%-12s %9.3f ms\n", "Total", Profiler::getStartupTime());
+    }
+
+    // A file passed on the command line takes the place of the last session
+    if (fileToOpen != nullptr)
+        View::postEvent(Events::FileDropped, fileToOpen);
+    else if (ContentRegistry::Settings::read("hex.builtin.setting.imhex", "hex.builtin.setting.imhex.restore_session", 1) != 0)
+        Session::restore();
 
     window.loop();
 
+    if (tracePath != nullptr && !Tracing::exportTrace(tracePath))
+        std::fprintf(stderr, "Failed to write the trace to %s\n", tracePath);
 
     return EXIT_SUCCESS;
 }
@@ -0,0 +1,406 @@
+#include "providers/async_file_provider.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+
+#if defined(OS_WINDOWS)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#if defined(OS_LINUX)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+namespace hex::prv {
+
+    AsyncFileProvider::AsyncFileProvider(std::string_view path, u32 queueDepth, size_t blockSize)
+        : Provider(), m_path(path), m_queueDepth(std::max<u32>(queueDepth, 1)), m_blockSize(std::max<size_t>(blockSize, 0x1000)) {
+
+        #if defined(OS_WINDOWS)
+        auto widePath = std::filesystem::path(std::u8string(path.begin(), path.end())).wstring();
+
+        this->m_writable = true;
+        this->m_file = CreateFileW(widePath.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_OVERLAPPED, nullptr);
+        if (this->m_file == INVALID_HANDLE_VALUE) {
+            this->m_file = CreateFileW(widePath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_OVERLAPPED, nullptr);
+            this->m_writable = false;
+        }
+
+        if (this->m_file == INVALID_HANDLE_VALUE)
+            return;
+
+        // One event per request that can be in flight, they get reused for every read
+        for (u32 i = 0; i < this->m_queueDepth; i++)
+            this->m_events.push_back(CreateEvent(nullptr, TRUE, FALSE, nullptr));
+        #else
+        this->m_writable = true;
+        this->m_file = open(this->m_path.c_str(), O_RDWR);
+        if (this->m_file == -1) {
+            this->m_file = open(this->m_path.c_str(), O_RDONLY);
+            this->m_writable = false;
+        }
+
+        if (this->m_file == -1)
+            return;
+        #endif
+
+        this->m_readable = true;
+        this->refreshSize();
+
+        #if defined(OS_LINUX)
+        // Kernels without io_uring or sandboxes that don't allow it get synchronous reads instead
+        this->setupRing();
+        #endif
+
+        // Without caching, every byte the hex editor shows would be a request of its own
+        this->setBlockCacheSize(this->m_queueDepth * this->m_blockSize);
+    }
+
+    AsyncFileProvider::~AsyncFileProvider() {
+        #if defined(OS_LINUX)
+        this->destroyRing();
+        #endif
+
+        #if defined(OS_WINDOWS)
+        for (auto event : this->m_events)
+            CloseHandle(event);
+
+        if (this->m_file != INVALID_HANDLE_VALUE)
+            CloseHandle(this->m_file);
+        #else
+        if (this->m_file != -1)
+            close(this->m_file);
+        #endif
+    }
+
+
+    bool AsyncFileProvider::isAvailable() {
+        #if defined(OS_WINDOWS)
+        return this->m_file != INVALID_HANDLE_VALUE;
+        #else
+        return this->m_file != -1;
+        #endif
+    }
+
+    bool AsyncFileProvider::isReadable() {
+        return isAvailable() && this->m_readable;
+    }
+
+    bool AsyncFileProvider::isWritable() {
+        return isAvailable() && this->m_writable;
+    }
+
+
+    void AsyncFileProvider::readRaw(u64 offset, void *buffer, size_t size) {
+        if ((offset + size) > this->getRawSize() || buffer == nullptr || size == 0)
+            return;
+
+        std::scoped_lock lock(this->m_ioMutex);
+        this->readBlocks(offset, reinterpret_cast<u8*>(buffer), size);
+    }
+
+    void AsyncFileProvider::writeRaw(u64 offset, const void *buffer, size_t size) {
+        if ((offset + size) > this->getRawSize() || buffer == nullptr || size == 0 || !this->m_writable)
+            return;
+
+        std::scoped_lock lock(this->m_ioMutex);
+
+        auto bytes = reinterpret_cast<const u8*>(buffer);
+        while (size > 0) {
+            #if defined(OS_WINDOWS)
+            OVERLAPPED overlapped = { };
+            overlapped.Offset = DWORD(offset & 0xFFFF'FFFF);
+            overlapped.OffsetHigh = DWORD(offset >> 32);
+            overlapped.hEvent = this->m_events.front();
+
+            DWORD written = 0;
+            if (!WriteFile(this->m_file, bytes, DWORD(std::min<size_t>(size, this->m_blockSize)), nullptr, &overlapped) && GetLastError() != ERROR_IO_PENDING)
+                return;
+            if (!GetOverlappedResult(this->m_file, &overlapped, &written, TRUE) || written == 0)
+                return;
+            #else
+            auto written = pwrite(this->m_file, bytes, size, offset);
+            if (written <= 0)
+                return;
+            #endif
+
+            offset += written;
+            bytes += written;
+            size -= written;
+        }
+    }
+
+    size_t AsyncFileProvider::getRawSize() {
+        auto now = std::chrono::steady_clock::now().time_since_epoch();
+        if (now - std::chrono::steady_clock::duration(this->m_lastSizeRefresh.load()) > SizeRefreshInterval)
+            this->refreshSize();
+
+        return this->m_fileSize;
+    }
+
+    Provider::Capability AsyncFileProvider::getCapabilities() {
+        // All reads share the one queue, but a single large read keeps all of it busy
+        return Capability::AsyncReads;
+    }
+
+    void AsyncFileProvider::refreshSize() {
+        #if defined(OS_WINDOWS)
+        LARGE_INTEGER fileSize = { 0 };
+        if (GetFileSizeEx(this->m_file, &fileSize))
+            this->m_fileSize = fileSize.QuadPart;
+        #else
+        // Seeking to the end also works for block devices, which report a size of 0 otherwise. Reads and writes don't use the file position
+        if (auto fileSize = lseek(this->m_file, 0, SEEK_END); fileSize >= 0)
+            this->m_fileSize = fileSize;
+        #endif
+
+        this->m_lastSizeRefresh = std::chrono::steady_clock::now().time_since_epoch().count();
+    }
+
+    void AsyncFileProvider::readBlocks(u64 offset, u8 *buffer, size_t size) {
+        #if defined(OS_LINUX)
+        if (this->m_ring.fd != -1 && this->readRing(offset, buffer, size))
+            return;
+        #endif
+
+        #if defined(OS_WINDOWS)
+        const u64 blockCount = (size + this->m_blockSize - 1) / this->m_blockSize;
+
+        std::vector<OVERLAPPED> requests(this->m_queueDepth);
+        std::vector<bool> issued(this->m_queueDepth);
+
+        // Blocks get requested in batches of the queue depth, a batch is done once all of its requests finished
+        for (u64 firstBlock = 0; firstBlock < blockCount; firstBlock += this->m_queueDepth) {
+            u64 lastBlock = std::min<u64>(firstBlock + this->m_queueDepth, blockCount);
+
+            for (u64 block = firstBlock; block < lastBlock; block++) {
+                auto &request = requests[block - firstBlock];
+                u64 blockOffset = offset + block * this->m_blockSize;
+
+                request = { };
+                request.Offset = DWORD(blockOffset & 0xFFFF'FFFF);
+                request.OffsetHigh = DWORD(blockOffset >> 32);
+                request.hEvent = this->m_events[block - firstBlock];
+
+                DWORD blockSize = DWORD(std::min<u64>(this->m_blockSize, size - block * this->m_blockSize));
+                issued[block - firstBlock] = ReadFile(this->m_file, buffer + block * this->m_blockSize, blockSize, nullptr, &request) || GetLastError() == ERROR_IO_PENDING;
+            }
+
+            for (u64 block = firstBlock; block < lastBlock; block++) {
+                u64 blockSize = std::min<u64>(this->m_blockSize, size - block * this->m_blockSize);
+
+                DWORD read = 0;
+                if (issued[block - firstBlock])
+                    GetOverlappedResult(this->m_file, &requests[block - firstBlock], &read, TRUE);
+
+                if (read < blockSize)
+                    this->readSynchronous(offset + block * this->m_blockSize + read, buffer + block * this->m_blockSize + read, blockSize - read);
+            }
+        }
+        #else
+        this->readSynchronous(offset, buffer, size);
+        #endif
+    }
+
+    void AsyncFileProvider::readSynchronous(u64 offset, u8 *buffer, size_t size) {
+        while (size > 0) {
+            #if defined(OS_WINDOWS)
+            OVERLAPPED overlapped = { };
+            overlapped.Offset = DWORD(offset & 0xFFFF'FFFF);
+            overlapped.OffsetHigh = DWORD(offset >> 32);
+            overlapped.hEvent = this->m_events.front();
+
+            DWORD read = 0;
+            if (!ReadFile(this->m_file, buffer, DWORD(std::min<size_t>(size, this->m_blockSize)), nullptr, &overlapped) && GetLastError() != ERROR_IO_PENDING)
+                break;
+            if (!GetOverlappedResult(this->m_file, &overlapped, &read, TRUE) || read == 0)
+                break;
+            #else
+            auto read = pread(this->m_file, buffer, size, offset);
+            if (read < 0 && errno == EINTR)
+                continue;
+            if (read <= 0)
+                break;
+            #endif
+
+            offset += read;
+            buffer += read;
+            size -= read;
+        }
+
+        // Data that couldn't be read, for example because the file got truncated in the meantime, reads as zeros
+        std::memset(buffer, 0x00, size);
+    }
+
+    #if defined(OS_LINUX)
+
+    bool AsyncFileProvider::setupRing() {
+        io_uring_params params = { };
+        int fd = syscall(__NR_io_uring_setup, this->m_queueDepth, &params);
+        if (fd < 0)
+            return false;
+
+        auto &ring = this->m_ring;
+        ring.fd = fd;
+        ring.entries = params.sq_entries;
+
+        ring.submissionRingSize = params.sq_off.array + params.sq_entries * sizeof(u32);
+        ring.completionRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+        // Newer kernels place both rings in the same mapping
+        bool singleMapping = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (singleMapping)
+            ring.submissionRingSize = ring.completionRingSize = std::max(ring.submissionRingSize, ring.completionRingSize);
+
+        ring.submissionRing = mmap(nullptr, ring.submissionRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+        if (ring.submissionRing == MAP_FAILED) {
+            ring.submissionRing = nullptr;
+            this->destroyRing();
+            return false;
+        }
+
+        if (singleMapping) {
+            ring.completionRing = ring.submissionRing;
+        } else {
+            ring.completionRing = mmap(nullptr, ring.completionRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+            if (ring.completionRing == MAP_FAILED) {
+                ring.completionRing = nullptr;
+                this->destroyRing();
+                return false;
+            }
+        }
+
+        ring.submissionEntriesSize = params.sq_entries * sizeof(io_uring_sqe);
+        ring.submissionEntries = mmap(nullptr, ring.submissionEntriesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+        if (ring.submissionEntries == MAP_FAILED) {
+            ring.submissionEntries = nullptr;
+            this->destroyRing();
+            return false;
+        }
+
+        auto submission = static_cast<u8*>(ring.submissionRing);
+        ring.submissionHead  = reinterpret_cast<u32*>(submission + params.sq_off.head);
+        ring.submissionTail  = reinterpret_cast<u32*>(submission + params.sq_off.tail);
+        ring.submissionMask  = reinterpret_cast<u32*>(submission + params.sq_off.ring_mask);
+        ring.submissionArray = reinterpret_cast<u32*>(submission + params.sq_off.array);
+
+        auto completion = static_cast<u8*>(ring.completionRing);
+        ring.completionHead    = reinterpret_cast<u32*>(completion + params.cq_off.head);
+        ring.completionTail    = reinterpret_cast<u32*>(completion + params.cq_off.tail);
+        ring.completionMask    = reinterpret_cast<u32*>(completion + params.cq_off.ring_mask);
+        ring.completionEntries = completion + params.cq_off.cqes;
+
+        return true;
+    }
+
+    void AsyncFileProvider::destroyRing() {
+        auto &ring = this->m_ring;
+
+        if (ring.submissionEntries != nullptr)
+            munmap(ring.submissionEntries, ring.submissionEntriesSize);
+        if (ring.completionRing != nullptr && ring.completionRing != ring.submissionRing)
+            munmap(ring.completionRing, ring.completionRingSize);
+        if (ring.submissionRing != nullptr)
+            munmap(ring.submissionRing, ring.submissionRingSize);
+        if (ring.fd != -1)
+            close(ring.fd);
+
+        ring = Ring();
+    }
+
+    bool AsyncFileProvider::readRing(u64 offset, u8 *buffer, size_t size) {
+        auto &ring = this->m_ring;
+        auto submissionEntries = static_cast<io_uring_sqe*>(ring.submissionEntries);
+        auto completionEntries = static_cast<io_uring_cqe*>(ring.completionEntries);
+
+        const u64 blockCount = (size + this->m_blockSize - 1) / this->m_blockSize;
+        const u32 queueDepth = std::min(this->m_queueDepth, ring.entries);
+
+        u64 nextBlock = 0, completedBlocks = 0;
+        u32 inFlight = 0, unsubmitted = 0;
+
+        while (completedBlocks < blockCount) {
+            // Top the queue up again with the next blocks every time some requests finished
+            u32 tail = *ring.submissionTail;
+            while (inFlight < queueDepth && nextBlock < blockCount) {
+                u32 index = tail & *ring.submissionMask;
+
+                auto &entry = submissionEntries[index];
+                std::memset(&entry, 0x00, sizeof(entry));
+                entry.opcode    = IORING_OP_READ;
+                entry.fd        = this->m_file;
+                entry.off       = offset + nextBlock * this->m_blockSize;
+                entry.addr      = reinterpret_cast<u64>(buffer + nextBlock * this->m_blockSize);
+                entry.len       = u32(std::min<u64>(this->m_blockSize, size - nextBlock * this->m_blockSize));
+                entry.user_data = nextBlock;
+
+                ring.submissionArray[index] = index;
+
+                tail++;
+                nextBlock++;
+                inFlight++;
+                unsubmitted++;
+            }
+            __atomic_store_n(ring.submissionTail, tail, __ATOMIC_RELEASE);
+
+            auto submitted = syscall(__NR_io_uring_enter, ring.fd, unsubmitted, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+            if (submitted < 0) {
+                if (errno == EINTR || errno == EAGAIN || errno == EBUSY)
+                    continue;
+
+                // Requests still in flight read the same data the synchronous fallback is about to read again, so them finishing late doesn't matter
+                this->destroyRing();
+                return false;
+            }
+            unsubmitted -= submitted;
+
+            u32 head = *ring.completionHead;
+            u32 completionTail = __atomic_load_n(ring.completionTail, __ATOMIC_ACQUIRE);
+            while (head != completionTail) {
+                const auto &completion = completionEntries[head & *ring.completionMask];
+
+                u64 blockOffset = completion.user_data * this->m_blockSize;
+                size_t blockSize = std::min<u64>(this->m_blockSize, size - blockOffset);
+
+                // Short and failed reads are rare, finishing them synchronously keeps the ring simple
+                size_t read = completion.res > 0 ? size_t(completion.res) : 0;
+                if (read < blockSize)
+                    this->readSynchronous(offset + blockOffset + read, buffer + blockOffset + read, blockSize - read);
+
+                head++;
+                inFlight--;
+                completedBlocks++;
+            }
+            __atomic_store_n(ring.completionHead, head, __ATOMIC_RELEASE);
+        }
+
+        return true;
+    }
+
+    #endif
+
+    std::vector<std::pair<std::string, std::string>> AsyncFileProvider::getDataInformation() {
+        std::vector<std::pair<std::string, std::string>> result;
+
+        result.emplace_back("hex.builtin.provider.file.path"_lang, this->m_path);
+        result.emplace_back("hex.builtin.provider.file.size"_lang, hex::toByteString(this->getRawSize()));
+
+        return result;
+    }
+
+    std::string AsyncFileProvider::getName() {
+        return std::filesystem::path(this->m_path).filename().string();
+    }
+
+    std::string AsyncFileProvider::getFilePath() {
+        return this->m_path;
+    }
+
+}
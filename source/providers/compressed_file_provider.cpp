@@ -0,0 +1,747 @@
+#include "providers/compressed_file_provider.hpp"
+
+#include <hex/helpers/utils.hpp>
+#include <hex/views/view.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+namespace hex::prv {
+
+    CompressedFileProvider::CompressedFileProvider(std::string_view path) : Provider(), m_file(path, true), m_path(path) {
+        if (!this->m_file.isAvailable() || !this->m_file.isReadable())
+            return;
+
+        this->m_compressedSize = this->m_file.getActualSize();
+
+        u8 magic[6] = { 0 };
+        size_t magicSize = std::min<u64>(sizeof(magic), this->m_compressedSize);
+        this->m_file.readRaw(0, magic, magicSize);
+
+        this->m_format = detectFormat(magic, magicSize);
+        if (this->m_format == Format::Unknown)
+            return;
+
+        // Reads from the hex editor are tiny, caching the decompressed data keeps them from decoding the same part over and over
+        this->setBlockCacheSize(CompressedCacheSize);
+
+        if (this->loadIndex())
+            return;
+
+        #if defined(IMHEX_LZMA_SUPPORT)
+        if (this->m_format == Format::Xz) {
+            if (!this->buildXzIndex())
+                this->m_format = Format::Unknown;
+            return;
+        }
+        #endif
+
+        #if defined(IMHEX_ZSTD_SUPPORT)
+        if (this->m_format == Format::Zstd && this->buildZstdSeekTable())
+            return;
+        #endif
+
+        // Everything decompressed so far can already be looked at while the rest of the index is being built
+        this->m_indexer = std::thread([this] {
+            #if defined(IMHEX_ZSTD_SUPPORT)
+            if (this->m_format == Format::Zstd)
+                this->buildZstdIndex();
+            else
+                this->buildGzipIndex();
+            #else
+            this->buildGzipIndex();
+            #endif
+
+            if (this->m_indexComplete)
+                this->saveIndex();
+
+            View::requestRedraw();
+        });
+    }
+
+    CompressedFileProvider::~CompressedFileProvider() {
+        this->m_stopIndexing = true;
+        if (this->m_indexer.joinable())
+            this->m_indexer.join();
+
+        this->resetCursor(this->m_cursor);
+
+        #if defined(IMHEX_ZSTD_SUPPORT)
+        if (this->m_cursor.zstd != nullptr)
+            ZSTD_freeDCtx(this->m_cursor.zstd);
+        #endif
+    }
+
+
+    bool CompressedFileProvider::isAvailable() {
+        return this->m_file.isAvailable() && this->m_format != Format::Unknown;
+    }
+
+    bool CompressedFileProvider::isReadable() {
+        return isAvailable();
+    }
+
+    bool CompressedFileProvider::isWritable() {
+        return false;
+    }
+
+
+    void CompressedFileProvider::readRaw(u64 offset, void *buffer, size_t size) {
+        if ((offset + size) > this->getRawSize() || buffer == nullptr || size == 0)
+            return;
+
+        auto output = reinterpret_cast<u8*>(buffer);
+
+        std::scoped_lock lock(this->m_cursorMutex);
+        auto &cursor = this->m_cursor;
+
+        size_t closest = 0;
+        u64 closestOffset = 0;
+        {
+            std::scoped_lock indexLock(this->m_indexMutex);
+            if (this->m_checkpoints.empty()) {
+                std::memset(output, 0x00, size);
+                return;
+            }
+
+            auto checkpoint = std::upper_bound(this->m_checkpoints.begin(), this->m_checkpoints.end(), offset, [](u64 offset, const Checkpoint &checkpoint) {
+                return offset < checkpoint.uncompressedOffset;
+            });
+
+            closest = std::distance(this->m_checkpoints.begin(), checkpoint) - 1;
+            closestOffset = this->m_checkpoints[closest].uncompressedOffset;
+        }
+
+        // Continuing the last decompression is cheaper than starting over, unless there's a checkpoint closer to where the read starts
+        bool canContinue = cursor.valid && cursor.uncompressedOffset <= offset && closestOffset <= cursor.uncompressedOffset;
+        if (!canContinue && !this->seekCursor(cursor, closest)) {
+            std::memset(output, 0x00, size);
+            return;
+        }
+
+        std::vector<u8> discard(std::min<u64>(offset - cursor.uncompressedOffset, InputChunkSize));
+        while (cursor.uncompressedOffset < offset) {
+            if (this->decode(cursor, discard.data(), std::min<u64>(offset - cursor.uncompressedOffset, discard.size())) == 0) {
+                cursor.valid = false;
+                std::memset(output, 0x00, size);
+                return;
+            }
+        }
+
+        size_t decoded = 0;
+        while (decoded < size) {
+            auto produced = this->decode(cursor, output + decoded, size - decoded);
+            if (produced == 0)
+                break;
+
+            decoded += produced;
+        }
+
+        if (decoded < size) {
+            cursor.valid = false;
+            std::memset(output + decoded, 0x00, size - decoded);
+        }
+    }
+
+    void CompressedFileProvider::writeRaw(u64 offset, const void *buffer, size_t size) {
+
+    }
+
+    size_t CompressedFileProvider::getRawSize() {
+        return this->m_uncompressedSize;
+    }
+
+    CompressedFileProvider::Format CompressedFileProvider::detectFormat(const u8 *magic, size_t size) {
+        if (size >= 2 && magic[0] == 0x1F && magic[1] == 0x8B)
+            return Format::Gzip;
+
+        #if defined(IMHEX_LZMA_SUPPORT)
+        if (size >= 6 && std::memcmp(magic, "\xFD" "7zXZ\x00", 6) == 0)
+            return Format::Xz;
+        #endif
+
+        #if defined(IMHEX_ZSTD_SUPPORT)
+        // Seekable zstd files may also start with a skippable frame
+        if (size >= 4 && ((magic[0] == 0x28 && magic[1] == 0xB5 && magic[2] == 0x2F && magic[3] == 0xFD) || ((magic[0] & 0xF0) == 0x50 && magic[1] == 0x2A && magic[2] == 0x4D && magic[3] == 0x18)))
+            return Format::Zstd;
+        #endif
+
+        return Format::Unknown;
+    }
+
+
+    std::string CompressedFileProvider::getIndexPath() const {
+        return this->m_path + ".imhexidx";
+    }
+
+    bool CompressedFileProvider::loadIndex() {
+        FILE *file = fopen(this->getIndexPath().c_str(), "rb");
+        if (file == nullptr)
+            return false;
+
+        SCOPE_EXIT( fclose(file); );
+
+        auto readValue = [file](auto &value) {
+            return fread(&value, sizeof(value), 1, file) == 1;
+        };
+
+        u32 magic = 0, version = 0;
+        u8 format = 0;
+        u64 compressedSize = 0, uncompressedSize = 0, checkpointCount = 0;
+        s64 modificationTime = 0;
+
+        if (!readValue(magic) || !readValue(version) || !readValue(format) || !readValue(compressedSize) || !readValue(modificationTime) || !readValue(uncompressedSize) || !readValue(checkpointCount))
+            return false;
+
+        // An index belonging to an older version of the file would decode garbage
+        std::error_code error;
+        auto lastWriteTime = std::filesystem::last_write_time(this->m_path, error);
+        if (error || magic != IndexMagic || version != IndexVersion || format != u8(this->m_format) || compressedSize != this->m_compressedSize || modificationTime != lastWriteTime.time_since_epoch().count())
+            return false;
+
+        std::vector<Checkpoint> checkpoints;
+        for (u64 i = 0; i < checkpointCount; i++) {
+            Checkpoint checkpoint;
+            u32 dictionarySize = 0;
+
+            if (!readValue(checkpoint.uncompressedOffset) || !readValue(checkpoint.compressedOffset) || !readValue(checkpoint.flags) || !readValue(dictionarySize))
+                return false;
+
+            if (dictionarySize > GzipWindowSize || checkpoint.compressedOffset > this->m_compressedSize)
+                return false;
+
+            checkpoint.dictionary.resize(dictionarySize);
+            if (dictionarySize > 0 && fread(checkpoint.dictionary.data(), 1, dictionarySize, file) != dictionarySize)
+                return false;
+
+            checkpoints.push_back(std::move(checkpoint));
+        }
+
+        if (checkpoints.empty() || checkpoints.front().uncompressedOffset != 0)
+            return false;
+
+        std::scoped_lock lock(this->m_indexMutex);
+        this->m_checkpoints = std::move(checkpoints);
+        this->m_uncompressedSize = uncompressedSize;
+        this->m_indexComplete = true;
+
+        return true;
+    }
+
+    void CompressedFileProvider::saveIndex() {
+        std::error_code error;
+        auto lastWriteTime = std::filesystem::last_write_time(this->m_path, error);
+        if (error)
+            return;
+
+        // Files in read-only locations simply get indexed again next time
+        FILE *file = fopen(this->getIndexPath().c_str(), "wb");
+        if (file == nullptr)
+            return;
+
+        SCOPE_EXIT( fclose(file); );
+
+        auto writeValue = [file](const auto &value) {
+            fwrite(&value, sizeof(value), 1, file);
+        };
+
+        std::scoped_lock lock(this->m_indexMutex);
+
+        writeValue(IndexMagic);
+        writeValue(IndexVersion);
+        writeValue(u8(this->m_format));
+        writeValue(this->m_compressedSize);
+        writeValue(s64(lastWriteTime.time_since_epoch().count()));
+        writeValue(u64(this->m_uncompressedSize));
+        writeValue(u64(this->m_checkpoints.size()));
+
+        for (const auto &checkpoint : this->m_checkpoints) {
+            writeValue(checkpoint.uncompressedOffset);
+            writeValue(checkpoint.compressedOffset);
+            writeValue(checkpoint.flags);
+            writeValue(u32(checkpoint.dictionary.size()));
+            fwrite(checkpoint.dictionary.data(), 1, checkpoint.dictionary.size(), file);
+        }
+    }
+
+    void CompressedFileProvider::addCheckpoint(Checkpoint &&checkpoint) {
+        std::scoped_lock lock(this->m_indexMutex);
+        this->m_checkpoints.push_back(std::move(checkpoint));
+    }
+
+
+    void CompressedFileProvider::buildGzipIndex() {
+        z_stream stream = { };
+        if (inflateInit2(&stream, 47) != Z_OK) {
+            this->m_indexFailed = true;
+            return;
+        }
+
+        SCOPE_EXIT( inflateEnd(&stream); );
+
+        std::vector<u8> input(InputChunkSize), window(GzipWindowSize);
+        u64 compressedOffset = 0, uncompressedOffset = 0, lastCheckpoint = 0;
+        bool memberEnded = false;
+
+        stream.avail_in = 0;
+        stream.avail_out = 0;
+        while (!this->m_stopIndexing) {
+            if (stream.avail_in == 0) {
+                if (compressedOffset >= this->m_compressedSize)
+                    break;
+
+                size_t readSize = std::min<u64>(InputChunkSize, this->m_compressedSize - compressedOffset);
+                this->m_file.readRaw(compressedOffset, input.data(), readSize);
+                compressedOffset += readSize;
+
+                stream.next_in = input.data();
+                stream.avail_in = readSize;
+            }
+
+            // Output goes into a ring buffer, all that's needed of it is the last 32 KiB for the next checkpoint
+            if (stream.avail_out == 0) {
+                stream.next_out = window.data();
+                stream.avail_out = window.size();
+            }
+
+            u32 availableOut = stream.avail_out;
+            int result = inflate(&stream, Z_BLOCK);
+            uncompressedOffset += availableOut - stream.avail_out;
+
+            if (result == Z_STREAM_END) {
+                // Files can consist of multiple gzip members, the next one starts right after this one's trailer
+                inflateReset(&stream);
+                memberEnded = true;
+                continue;
+            } else if (result != Z_OK && result != Z_BUF_ERROR) {
+                // Trailing garbage after a complete member isn't an error, gzip ignores it as well
+                if (!memberEnded)
+                    this->m_indexFailed = true;
+                break;
+            }
+
+            if (availableOut != stream.avail_out)
+                memberEnded = false;
+
+            // Decompression can only resume at the start of a deflate block, except after the last one in a member
+            bool blockBoundary = (stream.data_type & 128) != 0 && (stream.data_type & 64) == 0;
+            if (blockBoundary && (this->m_checkpoints.empty() || uncompressedOffset - lastCheckpoint >= CheckpointSpacing)) {
+                size_t left = stream.avail_out;
+                std::vector<u8> dictionary(GzipWindowSize);
+                std::copy(window.begin() + (GzipWindowSize - left), window.end(), dictionary.begin());
+                std::copy(window.begin(), window.begin() + (GzipWindowSize - left), dictionary.begin() + left);
+
+                // Only as much of the ring buffer as was ever written to is part of the output
+                size_t dictionarySize = std::min<u64>(uncompressedOffset, GzipWindowSize);
+                dictionary.erase(dictionary.begin(), dictionary.end() - dictionarySize);
+
+                this->addCheckpoint({ uncompressedOffset, compressedOffset - stream.avail_in, u32(stream.data_type & 7), std::move(dictionary) });
+                lastCheckpoint = uncompressedOffset;
+            }
+
+            this->m_uncompressedSize = uncompressedOffset;
+        }
+
+        this->m_uncompressedSize = uncompressedOffset;
+        if (!this->m_stopIndexing && !this->m_indexFailed)
+            this->m_indexComplete = true;
+    }
+
+    #if defined(IMHEX_LZMA_SUPPORT)
+    bool CompressedFileProvider::buildXzIndex() {
+        lzma_stream stream = LZMA_STREAM_INIT;
+        lzma_index *index = nullptr;
+
+        if (lzma_file_info_decoder(&stream, &index, UINT64_MAX, this->m_compressedSize) != LZMA_OK)
+            return false;
+
+        SCOPE_EXIT( lzma_end(&stream); );
+
+        // The index sits at the end of every stream, the decoder asks for the parts of the file it needs
+        std::vector<u8> input(InputChunkSize);
+        u64 position = 0;
+        lzma_ret result = LZMA_OK;
+        while (result == LZMA_OK) {
+            if (stream.avail_in == 0 && position < this->m_compressedSize) {
+                size_t readSize = std::min<u64>(InputChunkSize, this->m_compressedSize - position);
+                this->m_file.readRaw(position, input.data(), readSize);
+                position += readSize;
+
+                stream.next_in = input.data();
+                stream.avail_in = readSize;
+            }
+
+            result = lzma_code(&stream, LZMA_RUN);
+
+            if (result == LZMA_SEEK_NEEDED) {
+                position = stream.seek_pos;
+                stream.avail_in = 0;
+                result = LZMA_OK;
+            }
+        }
+
+        if (result != LZMA_STREAM_END || index == nullptr)
+            return false;
+
+        SCOPE_EXIT( lzma_index_end(index, nullptr); );
+
+        lzma_index_iter iterator;
+        lzma_index_iter_init(&iterator, index);
+        while (!lzma_index_iter_next(&iterator, LZMA_INDEX_ITER_NONEMPTY_BLOCK))
+            this->addCheckpoint({ iterator.block.uncompressed_file_offset, iterator.block.compressed_file_offset, u32(iterator.stream.flags->check), { } });
+
+        if (this->m_checkpoints.empty())
+            return false;
+
+        this->m_uncompressedSize = lzma_index_uncompressed_size(index);
+        this->m_indexComplete = true;
+
+        return true;
+    }
+    #endif
+
+    #if defined(IMHEX_ZSTD_SUPPORT)
+    bool CompressedFileProvider::buildZstdSeekTable() {
+        constexpr static u32 SeekTableFooterMagic = 0x8F92EAB1;
+        constexpr static size_t FooterSize = 9, SkippableHeaderSize = 8;
+
+        if (this->m_compressedSize < FooterSize + SkippableHeaderSize)
+            return false;
+
+        auto readLE32 = [](const u8 *data) {
+            return u32(data[0]) | u32(data[1]) << 8 | u32(data[2]) << 16 | u32(data[3]) << 24;
+        };
+
+        // Seekable files end with a skippable frame listing the size of every frame before it
+        u8 footer[FooterSize];
+        this->m_file.readRaw(this->m_compressedSize - FooterSize, footer, FooterSize);
+        if (readLE32(footer + 5) != SeekTableFooterMagic)
+            return false;
+
+        u32 frameCount = readLE32(footer);
+        size_t entrySize = (footer[4] & 0x80) != 0 ? 12 : 8;
+        u64 tableSize = u64(frameCount) * entrySize;
+        if (frameCount == 0 || tableSize + FooterSize + SkippableHeaderSize > this->m_compressedSize)
+            return false;
+
+        std::vector<u8> table(tableSize);
+        this->m_file.readRaw(this->m_compressedSize - FooterSize - tableSize, table.data(), tableSize);
+
+        u64 compressedOffset = 0, uncompressedOffset = 0;
+        for (u32 frame = 0; frame < frameCount; frame++) {
+            this->addCheckpoint({ uncompressedOffset, compressedOffset, 0, { } });
+
+            compressedOffset += readLE32(&table[frame * entrySize]);
+            uncompressedOffset += readLE32(&table[frame * entrySize + 4]);
+        }
+
+        if (compressedOffset > this->m_compressedSize) {
+            std::scoped_lock lock(this->m_indexMutex);
+            this->m_checkpoints.clear();
+            return false;
+        }
+
+        this->m_uncompressedSize = uncompressedOffset;
+        this->m_indexComplete = true;
+
+        return true;
+    }
+
+    void CompressedFileProvider::buildZstdIndex() {
+        ZSTD_DCtx *context = ZSTD_createDCtx();
+        if (context == nullptr) {
+            this->m_indexFailed = true;
+            return;
+        }
+
+        SCOPE_EXIT( ZSTD_freeDCtx(context); );
+
+        std::vector<u8> input(InputChunkSize), output(ZSTD_DStreamOutSize());
+        ZSTD_inBuffer in = { input.data(), 0, 0 };
+        u64 compressedOffset = 0, uncompressedOffset = 0, lastCheckpoint = 0;
+
+        // Frames are independent, so every frame boundary is a checkpoint that needs no state to resume from
+        this->addCheckpoint({ 0, 0, 0, { } });
+
+        bool outputPending = false;
+        while (!this->m_stopIndexing) {
+            if (in.pos == in.size && !outputPending) {
+                if (compressedOffset >= this->m_compressedSize)
+                    break;
+
+                size_t readSize = std::min<u64>(InputChunkSize, this->m_compressedSize - compressedOffset);
+                this->m_file.readRaw(compressedOffset, input.data(), readSize);
+                compressedOffset += readSize;
+
+                in = { input.data(), readSize, 0 };
+            }
+
+            ZSTD_outBuffer out = { output.data(), output.size(), 0 };
+            size_t result = ZSTD_decompressStream(context, &out, &in);
+            if (ZSTD_isError(result)) {
+                this->m_indexFailed = true;
+                break;
+            }
+
+            uncompressedOffset += out.pos;
+            outputPending = out.pos == out.size;
+
+            u64 frameEnd = compressedOffset - (in.size - in.pos);
+            if (result == 0 && frameEnd < this->m_compressedSize && uncompressedOffset - lastCheckpoint >= CheckpointSpacing) {
+                this->addCheckpoint({ uncompressedOffset, frameEnd, 0, { } });
+                lastCheckpoint = uncompressedOffset;
+            }
+
+            this->m_uncompressedSize = uncompressedOffset;
+        }
+
+        this->m_uncompressedSize = uncompressedOffset;
+        if (!this->m_stopIndexing && !this->m_indexFailed)
+            this->m_indexComplete = true;
+    }
+    #endif
+
+
+    bool CompressedFileProvider::fillInput(Cursor &cursor) {
+        if (cursor.inputPosition < cursor.inputSize)
+            return true;
+
+        if (cursor.compressedOffset >= this->m_compressedSize)
+            return false;
+
+        cursor.input.resize(InputChunkSize);
+        cursor.inputSize = std::min<u64>(InputChunkSize, this->m_compressedSize - cursor.compressedOffset);
+        cursor.inputPosition = 0;
+
+        this->m_file.readRaw(cursor.compressedOffset, cursor.input.data(), cursor.inputSize);
+        cursor.compressedOffset += cursor.inputSize;
+
+        return true;
+    }
+
+    void CompressedFileProvider::resetCursor(Cursor &cursor) {
+        if (cursor.zlibInitialized) {
+            inflateEnd(&cursor.zlib);
+            cursor.zlibInitialized = false;
+        }
+
+        #if defined(IMHEX_LZMA_SUPPORT)
+        lzma_end(&cursor.lzma);
+        cursor.lzma = LZMA_STREAM_INIT;
+        #endif
+
+        cursor.valid = false;
+        cursor.inputPosition = cursor.inputSize = 0;
+    }
+
+    bool CompressedFileProvider::seekCursor(Cursor &cursor, size_t index) {
+        this->resetCursor(cursor);
+
+        Checkpoint checkpoint;
+        {
+            std::scoped_lock lock(this->m_indexMutex);
+            if (index >= this->m_checkpoints.size())
+                return false;
+
+            checkpoint = this->m_checkpoints[index];
+        }
+
+        cursor.checkpoint = index;
+        cursor.uncompressedOffset = checkpoint.uncompressedOffset;
+        cursor.compressedOffset = checkpoint.compressedOffset;
+
+        if (this->m_format == Format::Gzip) {
+            // Checkpoints lie within the raw deflate data, the gzip header has been dealt with already
+            cursor.zlib = { };
+            if (inflateInit2(&cursor.zlib, -15) != Z_OK)
+                return false;
+            cursor.zlibInitialized = true;
+            cursor.rawDeflate = true;
+
+            if (checkpoint.flags != 0) {
+                u8 byte = 0;
+                this->m_file.readRaw(checkpoint.compressedOffset - 1, &byte, 1);
+                inflatePrime(&cursor.zlib, checkpoint.flags, byte >> (8 - checkpoint.flags));
+            }
+
+            if (!checkpoint.dictionary.empty())
+                inflateSetDictionary(&cursor.zlib, checkpoint.dictionary.data(), checkpoint.dictionary.size());
+        }
+
+        #if defined(IMHEX_LZMA_SUPPORT)
+        if (this->m_format == Format::Xz) {
+            u8 header[LZMA_BLOCK_HEADER_SIZE_MAX];
+            this->m_file.readRaw(checkpoint.compressedOffset, header, 1);
+
+            lzma_filter filters[LZMA_FILTERS_MAX + 1];
+            lzma_block block = { };
+            block.version = 1;
+            block.check = lzma_check(checkpoint.flags);
+            block.filters = filters;
+            block.header_size = lzma_block_header_size_decode(header[0]);
+
+            if (checkpoint.compressedOffset + block.header_size > this->m_compressedSize)
+                return false;
+
+            this->m_file.readRaw(checkpoint.compressedOffset, header, block.header_size);
+            if (lzma_block_header_decode(&block, nullptr, header) != LZMA_OK)
+                return false;
+
+            // The decoder copies what it needs from the filter options
+            auto result = lzma_block_decoder(&cursor.lzma, &block);
+            lzma_filters_free(filters, nullptr);
+
+            if (result != LZMA_OK)
+                return false;
+
+            cursor.compressedOffset += block.header_size;
+        }
+        #endif
+
+        #if defined(IMHEX_ZSTD_SUPPORT)
+        if (this->m_format == Format::Zstd) {
+            if (cursor.zstd == nullptr)
+                cursor.zstd = ZSTD_createDCtx();
+
+            if (cursor.zstd == nullptr)
+                return false;
+
+            ZSTD_DCtx_reset(cursor.zstd, ZSTD_reset_session_only);
+        }
+        #endif
+
+        cursor.valid = true;
+
+        return true;
+    }
+
+    size_t CompressedFileProvider::decode(Cursor &cursor, u8 *buffer, size_t size) {
+        size_t produced = 0;
+
+        while (produced < size && cursor.valid && this->fillInput(cursor)) {
+            u8 *input = cursor.input.data() + cursor.inputPosition;
+            size_t inputSize = cursor.inputSize - cursor.inputPosition;
+
+            if (this->m_format == Format::Gzip) {
+                cursor.zlib.next_in = input;
+                cursor.zlib.avail_in = inputSize;
+                cursor.zlib.next_out = buffer + produced;
+                cursor.zlib.avail_out = size - produced;
+
+                int result = inflate(&cursor.zlib, Z_NO_FLUSH);
+
+                cursor.inputPosition += inputSize - cursor.zlib.avail_in;
+                produced = size - cursor.zlib.avail_out;
+
+                if (result == Z_STREAM_END) {
+                    // In raw mode the member's trailer is still left over, after that the next member starts with its own header
+                    if (cursor.rawDeflate) {
+                        for (size_t trailer = 8; trailer > 0; ) {
+                            if (!this->fillInput(cursor)) {
+                                cursor.valid = false;
+                                break;
+                            }
+
+                            size_t skipped = std::min(trailer, cursor.inputSize - cursor.inputPosition);
+                            cursor.inputPosition += skipped;
+                            trailer -= skipped;
+                        }
+
+                        inflateReset2(&cursor.zlib, 31);
+                        cursor.rawDeflate = false;
+                    } else {
+                        inflateReset(&cursor.zlib);
+                    }
+                } else if (result != Z_OK) {
+                    cursor.valid = false;
+                }
+            }
+
+            #if defined(IMHEX_LZMA_SUPPORT)
+            if (this->m_format == Format::Xz) {
+                cursor.lzma.next_in = input;
+                cursor.lzma.avail_in = inputSize;
+                cursor.lzma.next_out = buffer + produced;
+                cursor.lzma.avail_out = size - produced;
+
+                auto result = lzma_code(&cursor.lzma, LZMA_RUN);
+
+                cursor.inputPosition += inputSize - cursor.lzma.avail_in;
+                produced = size - cursor.lzma.avail_out;
+
+                if (result == LZMA_STREAM_END) {
+                    // Blocks are decoded one at a time, the next one is the next checkpoint
+                    u64 uncompressedOffset = cursor.uncompressedOffset;
+                    if (!this->seekCursor(cursor, cursor.checkpoint + 1))
+                        cursor.valid = false;
+                    cursor.uncompressedOffset = uncompressedOffset;
+                } else if (result != LZMA_OK) {
+                    cursor.valid = false;
+                }
+            }
+            #endif
+
+            #if defined(IMHEX_ZSTD_SUPPORT)
+            if (this->m_format == Format::Zstd) {
+                ZSTD_inBuffer in = { input, inputSize, 0 };
+                ZSTD_outBuffer out = { buffer, size, produced };
+
+                size_t result = ZSTD_decompressStream(cursor.zstd, &out, &in);
+
+                cursor.inputPosition += in.pos;
+                produced = out.pos;
+
+                if (ZSTD_isError(result))
+                    cursor.valid = false;
+            }
+            #endif
+        }
+
+        cursor.uncompressedOffset += produced;
+
+        return produced;
+    }
+
+
+    std::vector<std::pair<std::string, std::string>> CompressedFileProvider::getDataInformation() {
+        std::vector<std::pair<std::string, std::string>> result;
+
+        std::string format;
+        switch (this->m_format) {
+            case Format::Gzip: format = "gzip"; break;
+            case Format::Xz:   format = "xz"; break;
+            case Format::Zstd: format = "zstd"; break;
+            default:           format = "???"; break;
+        }
+
+        std::string indexState = this->m_indexComplete ? "hex.builtin.provider.compressed.index.complete"_lang
+                               : this->m_indexFailed   ? "hex.builtin.provider.compressed.index.failed"_lang
+                                                       : "hex.builtin.provider.compressed.index.building"_lang;
+
+        size_t checkpointCount = 0;
+        {
+            std::scoped_lock lock(this->m_indexMutex);
+            checkpointCount = this->m_checkpoints.size();
+        }
+
+        result.emplace_back("hex.builtin.provider.compressed.path"_lang, this->m_path);
+        result.emplace_back("hex.builtin.provider.compressed.format"_lang, format);
+        result.emplace_back("hex.builtin.provider.compressed.compressed_size"_lang, hex::toByteString(this->m_compressedSize));
+        result.emplace_back("hex.builtin.provider.compressed.size"_lang, hex::toByteString(this->getRawSize()));
+        result.emplace_back("hex.builtin.provider.compressed.checkpoints"_lang, std::to_string(checkpointCount));
+        result.emplace_back("hex.builtin.provider.compressed.index"_lang, indexState);
+
+        return result;
+    }
+
+    std::string CompressedFileProvider::getName() {
+        return std::filesystem::path(this->m_path).filename().string();
+    }
+
+    std::string CompressedFileProvider::getFilePath() {
+        return this->m_path;
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,295 @@
+#include "providers/disk_provider.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+
+#if defined(OS_WINDOWS)
+#include <winioctl.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#endif
+
+#if defined(OS_LINUX)
+#include <linux/fs.h>
+#elif defined(OS_MACOS)
+#include <sys/disk.h>
+#endif
+
+namespace hex::prv {
+
+    DiskProvider::DiskProvider(std::string_view path) : Provider(), m_path(path) {
+        #if defined(OS_WINDOWS)
+        auto widePath = std::filesystem::path(std::u8string(path.begin(), path.end())).wstring();
+
+        this->m_writable = true;
+        this->m_disk = CreateFileW(widePath.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_FLAG_NO_BUFFERING, nullptr);
+        if (this->m_disk == INVALID_HANDLE_VALUE) {
+            this->m_disk = CreateFileW(widePath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_FLAG_NO_BUFFERING, nullptr);
+            this->m_writable = false;
+        }
+
+        if (this->m_disk == INVALID_HANDLE_VALUE)
+            return;
+
+        this->m_unbuffered = true;
+
+        DWORD returned = 0;
+
+        DISK_GEOMETRY geometry = { };
+        if (DeviceIoControl(this->m_disk, IOCTL_DISK_GET_DRIVE_GEOMETRY, nullptr, 0, &geometry, sizeof(geometry), &returned, nullptr))
+            this->m_sectorSize = geometry.BytesPerSector;
+        else
+            this->m_sectorSize = 0x1000;
+
+        // Disks and volumes know their length, disk image files only report it through their file size
+        GET_LENGTH_INFORMATION lengthInformation = { };
+        LARGE_INTEGER fileSize = { };
+        if (DeviceIoControl(this->m_disk, IOCTL_DISK_GET_LENGTH_INFO, nullptr, 0, &lengthInformation, sizeof(lengthInformation), &returned, nullptr))
+            this->m_diskSize = lengthInformation.Length.QuadPart;
+        else if (GetFileSizeEx(this->m_disk, &fileSize))
+            this->m_diskSize = fileSize.QuadPart;
+        #else
+        int flags = 0;
+        #if defined(OS_LINUX)
+            flags = O_DIRECT;
+        #endif
+
+        this->m_writable = true;
+        this->m_disk = open(this->m_path.c_str(), O_RDWR | flags);
+        if (this->m_disk == -1) {
+            this->m_disk = open(this->m_path.c_str(), O_RDONLY | flags);
+            this->m_writable = false;
+        }
+
+        // Some filesystems don't support direct I/O for disk images stored on them
+        if (this->m_disk == -1 && flags != 0) {
+            flags = 0;
+
+            this->m_writable = true;
+            this->m_disk = open(this->m_path.c_str(), O_RDWR);
+            if (this->m_disk == -1) {
+                this->m_disk = open(this->m_path.c_str(), O_RDONLY);
+                this->m_writable = false;
+            }
+        }
+
+        if (this->m_disk == -1)
+            return;
+
+        #if defined(OS_LINUX)
+            this->m_unbuffered = flags != 0;
+        #elif defined(OS_MACOS)
+            this->m_unbuffered = fcntl(this->m_disk, F_NOCACHE, 1) != -1;
+        #endif
+
+        struct stat fileStats = { };
+        fstat(this->m_disk, &fileStats);
+
+        if (S_ISBLK(fileStats.st_mode) || S_ISCHR(fileStats.st_mode)) {
+            #if defined(OS_LINUX)
+                u64 diskSize = 0;
+                int sectorSize = 0;
+                if (ioctl(this->m_disk, BLKGETSIZE64, &diskSize) == 0)
+                    this->m_diskSize = diskSize;
+                if (ioctl(this->m_disk, BLKSSZGET, &sectorSize) == 0 && sectorSize > 0)
+                    this->m_sectorSize = sectorSize;
+            #elif defined(OS_MACOS)
+                u64 blockCount = 0;
+                u32 blockSize = 0;
+                if (ioctl(this->m_disk, DKIOCGETBLOCKSIZE, &blockSize) == 0 && blockSize > 0)
+                    this->m_sectorSize = blockSize;
+                if (ioctl(this->m_disk, DKIOCGETBLOCKCOUNT, &blockCount) == 0)
+                    this->m_diskSize = blockCount * this->m_sectorSize;
+            #endif
+
+            if (this->m_diskSize == 0) {
+                if (auto diskSize = lseek(this->m_disk, 0, SEEK_END); diskSize > 0)
+                    this->m_diskSize = diskSize;
+            }
+        } else {
+            // Disk images on a filesystem need their direct I/O aligned to the filesystem's blocks instead
+            this->m_diskSize = fileStats.st_size;
+            this->m_sectorSize = std::max<u32>(fileStats.st_blksize, 512);
+        }
+        #endif
+
+        // Sectors are at most a few KiB, a bigger size would mean the device reported something bogus
+        if (this->m_sectorSize == 0 || this->m_sectorSize > BlockCacheBlockSize || (this->m_sectorSize & (this->m_sectorSize - 1)) != 0)
+            this->m_sectorSize = 0x1000;
+
+        #if defined(OS_WINDOWS)
+        this->m_transferBuffer = static_cast<u8*>(_aligned_malloc(TransferSize, this->m_sectorSize));
+        #else
+        this->m_transferBuffer = static_cast<u8*>(std::aligned_alloc(this->m_sectorSize, TransferSize));
+        #endif
+
+        this->m_readable = this->m_transferBuffer != nullptr;
+
+        // Cache blocks always start on a sector boundary, so reads coming through the cache need no realignment
+        this->setBlockCacheSize(SectorCacheSize);
+    }
+
+    DiskProvider::~DiskProvider() {
+        #if defined(OS_WINDOWS)
+        if (this->m_transferBuffer != nullptr)
+            _aligned_free(this->m_transferBuffer);
+
+        if (this->m_disk != INVALID_HANDLE_VALUE)
+            CloseHandle(this->m_disk);
+        #else
+        std::free(this->m_transferBuffer);
+
+        if (this->m_disk != -1)
+            close(this->m_disk);
+        #endif
+    }
+
+
+    bool DiskProvider::isAvailable() {
+        #if defined(OS_WINDOWS)
+        return this->m_disk != INVALID_HANDLE_VALUE && this->m_transferBuffer != nullptr;
+        #else
+        return this->m_disk != -1 && this->m_transferBuffer != nullptr;
+        #endif
+    }
+
+    bool DiskProvider::isReadable() {
+        return isAvailable() && this->m_readable;
+    }
+
+    bool DiskProvider::isWritable() {
+        return isAvailable() && this->m_writable;
+    }
+
+
+    void DiskProvider::readRaw(u64 offset, void *buffer, size_t size) {
+        if ((offset + size) > this->getRawSize() || buffer == nullptr || size == 0 || !this->isReadable())
+            return;
+
+        std::scoped_lock lock(this->m_transferMutex);
+
+        auto output = reinterpret_cast<u8*>(buffer);
+        while (size > 0) {
+            // Every transfer covers whole sectors, only the part that was asked for gets copied out
+            u64 sectorStart = offset - offset % this->m_sectorSize;
+            u64 sectorEnd = std::min<u64>(sectorStart + TransferSize, (offset + size + this->m_sectorSize - 1) / this->m_sectorSize * this->m_sectorSize);
+            size_t copySize = std::min<u64>(sectorEnd - offset, size);
+
+            if (!this->readSectors(sectorStart, this->m_transferBuffer, sectorEnd - sectorStart)) {
+                std::memset(output, 0x00, size);
+                return;
+            }
+
+            std::memcpy(output, this->m_transferBuffer + (offset - sectorStart), copySize);
+
+            output += copySize;
+            offset += copySize;
+            size -= copySize;
+        }
+    }
+
+    void DiskProvider::writeRaw(u64 offset, const void *buffer, size_t size) {
+        if ((offset + size) > this->getRawSize() || buffer == nullptr || size == 0 || !this->isWritable())
+            return;
+
+        std::scoped_lock lock(this->m_transferMutex);
+
+        auto input = reinterpret_cast<const u8*>(buffer);
+        while (size > 0) {
+            u64 sectorStart = offset - offset % this->m_sectorSize;
+            u64 sectorEnd = std::min<u64>(sectorStart + TransferSize, (offset + size + this->m_sectorSize - 1) / this->m_sectorSize * this->m_sectorSize);
+            size_t copySize = std::min<u64>(sectorEnd - offset, size);
+
+            // Sectors that only get partially overwritten have to be read first so the rest of them stays intact
+            bool partial = offset != sectorStart || copySize != sectorEnd - sectorStart;
+            if (partial && !this->readSectors(sectorStart, this->m_transferBuffer, sectorEnd - sectorStart))
+                return;
+
+            std::memcpy(this->m_transferBuffer + (offset - sectorStart), input, copySize);
+
+            if (!this->writeSectors(sectorStart, this->m_transferBuffer, sectorEnd - sectorStart))
+                return;
+
+            input += copySize;
+            offset += copySize;
+            size -= copySize;
+        }
+    }
+
+    bool DiskProvider::readSectors(u64 offset, u8 *buffer, size_t size) {
+        while (size > 0) {
+            #if defined(OS_WINDOWS)
+            LARGE_INTEGER position = { };
+            position.QuadPart = offset;
+
+            DWORD read = 0;
+            if (!SetFilePointerEx(this->m_disk, position, nullptr, FILE_BEGIN) || !ReadFile(this->m_disk, buffer, DWORD(size), &read, nullptr))
+                return false;
+            #else
+            auto read = pread(this->m_disk, buffer, size, offset);
+            if (read < 0)
+                return false;
+            #endif
+
+            // Disk images don't have to end on a sector boundary, the rest of the last sector reads as zeros
+            if (read == 0) {
+                std::memset(buffer, 0x00, size);
+                break;
+            }
+
+            offset += read;
+            buffer += read;
+            size -= read;
+        }
+
+        return true;
+    }
+
+    bool DiskProvider::writeSectors(u64 offset, const u8 *buffer, size_t size) {
+        while (size > 0) {
+            #if defined(OS_WINDOWS)
+            LARGE_INTEGER position = { };
+            position.QuadPart = offset;
+
+            DWORD written = 0;
+            if (!SetFilePointerEx(this->m_disk, position, nullptr, FILE_BEGIN) || !WriteFile(this->m_disk, buffer, DWORD(size), &written, nullptr) || written == 0)
+                return false;
+            #else
+            auto written = pwrite(this->m_disk, buffer, size, offset);
+            if (written <= 0)
+                return false;
+            #endif
+
+            offset += written;
+            buffer += written;
+            size -= written;
+        }
+
+        return true;
+    }
+
+    size_t DiskProvider::getRawSize() {
+        return this->m_diskSize;
+    }
+
+    std::vector<std::pair<std::string, std::string>> DiskProvider::getDataInformation() {
+        std::vector<std::pair<std::string, std::string>> result;
+
+        result.emplace_back("hex.builtin.provider.disk.path"_lang, this->m_path);
+        result.emplace_back("hex.builtin.provider.disk.size"_lang, hex::toByteString(this->getRawSize()));
+        result.emplace_back("hex.builtin.provider.disk.sector_size"_lang, hex::toByteString(this->m_sectorSize));
+        result.emplace_back("hex.builtin.provider.disk.unbuffered"_lang, this->m_unbuffered ? "hex.common.yes"_lang : "hex.common.no"_lang);
+
+        return result;
+    }
+
+    std::string DiskProvider::getName() {
+        return this->m_path;
+    }
+
+}
\ No newline at end of file
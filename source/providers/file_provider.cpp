@@ -1,47 +1,80 @@
 #include "providers/file_provider.hpp"
 
 #include <time.h>
+#include <algorithm>
 #include <cstring>
+#include <filesystem>
+#include <limits>
 
 #include "helpers/project_file_handler.hpp"
 
+#include <hex/views/view.hpp>
+
 #if defined(OS_WINDOWS)
 #include <locale>
 #include <codecvt>
+#include <io.h>
+#elif defined(OS_LINUX)
+#include <linux/fs.h>
+#include <sys/ioctl.h>
 #endif
 
 namespace hex::prv {
 
-    FileProvider::FileProvider(std::string_view path) : Provider(), m_path(path) {
+    #if defined(OS_WINDOWS)
+    static std::wstring toWidePath(std::string_view path) {
+        std::wstring widePath;
+
+        auto length = path.length() + 1;
+        auto wideLength = MultiByteToWideChar(CP_UTF8, 0, path.data(), length, 0, 0);
+        wchar_t* buffer = new wchar_t[wideLength];
+        MultiByteToWideChar(CP_UTF8, 0, path.data(), length, buffer, wideLength);
+        widePath = buffer;
+        delete[] buffer;
+
+        return widePath;
+    }
+    #endif
+
+    FileProvider::FileProvider(std::string_view path, bool readOnly) : Provider(), m_path(path), m_readOnly(readOnly) {
+        this->openFile();
+        this->watch();
+    }
+
+    void FileProvider::openFile() {
+        const auto &path = this->m_path;
+        bool readOnly = this->m_readOnly;
+
         this->m_fileStatsValid = stat(path.data(), &this->m_fileStats) == 0;
 
         this->m_readable = true;
         this->m_writable = true;
 
         #if defined(OS_WINDOWS)
-        std::wstring widePath;
-        {
-            auto length = path.length() + 1;
-            auto wideLength = MultiByteToWideChar(CP_UTF8, 0, path.data(), length, 0, 0);
-            wchar_t* buffer = new wchar_t[wideLength];
-            MultiByteToWideChar(CP_UTF8, 0, path.data(), length, buffer, wideLength);
-            widePath = buffer;
-            delete[] buffer;
-        }
+        std::wstring widePath = toWidePath(path);
+
+        // Read-only files get shared for writing too so saving can open a second handle to write the patches back
+        DWORD access = readOnly ? GENERIC_READ : GENERIC_READ | GENERIC_WRITE;
+        DWORD shareMode = readOnly ? FILE_SHARE_READ | FILE_SHARE_WRITE : FILE_SHARE_READ;
 
         LARGE_INTEGER fileSize = { 0 };
-        this->m_file = reinterpret_cast<HANDLE>(CreateFileW(widePath.data(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr));
+        this->m_file = reinterpret_cast<HANDLE>(CreateFileW(widePath.data(), access, shareMode, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr));
 
         GetFileSizeEx(this->m_file, &fileSize);
         this->m_fileSize = fileSize.QuadPart;
         CloseHandle(this->m_file);
 
-        this->m_file = reinterpret_cast<HANDLE>(CreateFileW(widePath.data(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr));
+        this->m_file = reinterpret_cast<HANDLE>(CreateFileW(widePath.data(), access, shareMode, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr));
         if (this->m_file == nullptr || this->m_file == INVALID_HANDLE_VALUE) {
-            this->m_file = reinterpret_cast<HANDLE>(CreateFileW(widePath.data(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr));
+            this->m_file = reinterpret_cast<HANDLE>(CreateFileW(widePath.data(), GENERIC_READ, shareMode, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr));
             this->m_writable = false;
         }
 
+        if (readOnly) {
+            auto attributes = GetFileAttributesW(widePath.data());
+            this->m_writable = attributes != INVALID_FILE_ATTRIBUTES && (attributes & FILE_ATTRIBUTE_READONLY) == 0;
+        }
+
         ScopeExit fileCleanup([this]{
             this->m_readable = false;
             this->m_file = nullptr;
@@ -51,7 +84,7 @@ namespace hex::prv {
             return;
         }
 
-        this->m_mapping = CreateFileMapping(this->m_file, nullptr, PAGE_READWRITE, fileSize.HighPart, fileSize.LowPart, nullptr);
+        this->m_mapping = CreateFileMapping(this->m_file, nullptr, readOnly ? PAGE_READONLY : PAGE_READWRITE, fileSize.HighPart, fileSize.LowPart, nullptr);
         if (this->m_mapping == nullptr || this->m_mapping == INVALID_HANDLE_VALUE) {
             return;
         }
@@ -62,11 +95,11 @@ namespace hex::prv {
             CloseHandle(this->m_mapping);
         });
 
-        this->m_mappedFile = MapViewOfFile(this->m_mapping, FILE_MAP_ALL_ACCESS, 0, 0, this->m_fileSize);
-        if (this->m_mappedFile == nullptr) {
-            this->m_readable = false;
-            return;
-        }
+        if (this->m_fileSize <= FullMappingLimit)
+            this->m_mappedFile = this->mapWholeFile(this->m_fileSize);
+
+        if (this->m_mappedFile == nullptr)
+            this->m_windowed = true;
 
         fileCleanup.release();
         mappingCleanup.release();
@@ -74,10 +107,16 @@ namespace hex::prv {
         ProjectFile::setFilePath(path);
 
         #else
-            this->m_file = open(path.data(), O_RDWR);
-            if (this->m_file == -1) {
+            if (readOnly) {
+                // Nothing gets written through the mapping, whether patches can be saved back later only depends on the file's permissions
                 this->m_file = open(path.data(), O_RDONLY);
-                this->m_writable = false;
+                this->m_writable = access(path.data(), W_OK) == 0;
+            } else {
+                this->m_file = open(path.data(), O_RDWR);
+                if (this->m_file == -1) {
+                    this->m_file = open(path.data(), O_RDONLY);
+                    this->m_writable = false;
+                }
             }
 
             if (this->m_file == -1) {
@@ -87,12 +126,62 @@ namespace hex::prv {
 
             this->m_fileSize = this->m_fileStats.st_size;
 
-            this->m_mappedFile = mmap(nullptr, this->m_fileSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, this->m_file, 0);
+            if (this->m_fileSize <= FullMappingLimit)
+                this->m_mappedFile = this->mapWholeFile(this->m_fileSize);
+
+            if (this->m_mappedFile == nullptr)
+                this->m_windowed = true;
+
+        #endif
+    }
 
+    void* FileProvider::mapWholeFile(size_t size) {
+        #if defined(OS_WINDOWS)
+        return MapViewOfFile(this->m_mapping, this->m_readOnly ? FILE_MAP_READ : FILE_MAP_ALL_ACCESS, 0, 0, size);
+        #else
+        // A shared read-only mapping never duplicates pages and shares the page cache with everybody else looking at the file
+        void *data;
+        if (this->m_readOnly)
+            data = mmap(nullptr, size, PROT_READ, MAP_SHARED, this->m_file, 0);
+        else
+            data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, this->m_file, 0);
+
+        return data == MAP_FAILED ? nullptr : data;
         #endif
     }
 
+    void FileProvider::watch() {
+        // Without a running watcher nothing else touches the recorded state, the new one records the file again right away
+        this->m_watcher.reset();
+        this->m_hashed = false;
+
+        // Other programs changing the file show up as changed regions, instead of the file having to be opened again
+        if (this->isAvailable() && (this->isFollowing() || this->m_fileSize <= MaximumWatchedSize))
+            this->m_watcher = std::make_unique<FileWatcher>(this->m_path, [this] { this->checkForChanges(); });
+    }
+
+    bool FileProvider::canFollow() {
+        return this->isAvailable();
+    }
+
+    void FileProvider::setFollowing(bool following) {
+        if (following == this->isFollowing())
+            return;
+
+        Provider::setFollowing(following);
+        this->watch();
+    }
+
     FileProvider::~FileProvider() {
+        // The watcher calls back into the provider, it has to be gone before anything else
+        this->m_closing = true;
+        this->m_watcher.reset();
+
+        this->m_windows.clear();
+
+        for (const auto &[data, size] : this->m_retiredMappings)
+            this->unmapWindow(reinterpret_cast<u8*>(data), size);
+
         #if defined(OS_WINDOWS)
         if (this->m_mappedFile != nullptr)
             UnmapViewOfFile(this->m_mappedFile);
@@ -100,18 +189,23 @@ namespace hex::prv {
             CloseHandle(this->m_mapping);
         if (this->m_file != nullptr)
             CloseHandle(this->m_file);
+        if (this->m_writeFile != nullptr)
+            CloseHandle(this->m_writeFile);
         #else
-        munmap(this->m_mappedFile, this->m_fileSize);
+        if (this->m_mappedFile != nullptr)
+            munmap(this->m_mappedFile, this->m_fileSize);
         close(this->m_file);
+        if (this->m_writeFile != -1)
+            close(this->m_writeFile);
         #endif
     }
 
 
     bool FileProvider::isAvailable() {
         #if defined(OS_WINDOWS)
-        return this->m_file != nullptr && this->m_mapping != nullptr && this->m_mappedFile != nullptr;
+        return this->m_file != nullptr && this->m_mapping != nullptr && (this->m_mappedFile != nullptr || this->m_windowed);
         #else
-        return this->m_file != -1 && this->m_mappedFile != nullptr;
+        return this->m_file != -1 && (this->m_mappedFile != nullptr || this->m_windowed);
         #endif
     }
 
@@ -124,41 +218,574 @@ namespace hex::prv {
     }
 
 
-    void FileProvider::read(u64 offset, void *buffer, size_t size) {
-        if ((offset + size) > this->getSize() || buffer == nullptr || size == 0)
-            return;
+    const u8* FileProvider::getMappedData() {
+        if (!this->m_readable || this->m_windowed)
+            return nullptr;
 
-        std::memcpy(buffer, reinterpret_cast<u8*>(this->m_mappedFile) + PageSize * this->m_currPage + offset, size);
+        return reinterpret_cast<const u8*>(this->m_mappedFile);
+    }
 
-        for (u64 i = 0; i < size; i++)
-            if (this->m_patches.back().contains(offset + i))
-                reinterpret_cast<u8*>(buffer)[i] = this->m_patches.back()[offset + PageSize * this->m_currPage + i];
+    Provider::Capability FileProvider::getCapabilities() {
+        // Windowed files only have one window mapped at a time, reads of different windows wait for each other
+        if (this->getMappedData() == nullptr)
+            return Capability::CheapRandomAccess;
+
+        return Capability::DirectAccess | Capability::ThreadSafeReads | Capability::CheapRandomAccess;
     }
 
-    void FileProvider::write(u64 offset, const void *buffer, size_t size) {
-        if ((offset + size) > this->getSize() || buffer == nullptr || size == 0)
+    void FileProvider::adviseAccess(u64 address, size_t size, AccessHint hint) {
+        if (address >= this->m_fileSize || size == 0)
             return;
 
-        this->m_patches.push_back(this->m_patches.back());
+        size = std::min<u64>(size, this->m_fileSize - address);
 
-        for (u64 i = 0; i < size; i++)
-            this->m_patches.back()[offset + this->getBaseAddress() + i] = reinterpret_cast<const u8*>(buffer)[i];
+        #if defined(OS_WINDOWS)
+        // Prefetching is the only hint Windows knows about, windowed mappings get faulted in as they're mapped anyway
+        if ((hint != AccessHint::Sequential && hint != AccessHint::WillNeed) || this->m_mappedFile == nullptr)
+            return;
+
+        WIN32_MEMORY_RANGE_ENTRY range = { reinterpret_cast<u8*>(this->m_mappedFile) + address, size };
+        PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+        #else
+        int memoryAdvice = MADV_NORMAL;
+        switch (hint) {
+            case AccessHint::Normal:     memoryAdvice = MADV_NORMAL;     break;
+            case AccessHint::Sequential: memoryAdvice = MADV_SEQUENTIAL; break;
+            case AccessHint::Random:     memoryAdvice = MADV_RANDOM;     break;
+            case AccessHint::WillNeed:   memoryAdvice = MADV_WILLNEED;   break;
+        }
+
+        if (this->m_mappedFile != nullptr) {
+            // madvise only takes page aligned addresses
+            u64 pageSize = sysconf(_SC_PAGESIZE);
+            u64 alignedAddress = address - address % pageSize;
+
+            madvise(reinterpret_cast<u8*>(this->m_mappedFile) + alignedAddress, size + (address - alignedAddress), memoryAdvice);
+        }
+
+        #if defined(OS_LINUX)
+        // Windowed mappings come and go, advising the file itself also covers the windows that aren't mapped yet
+        int fileAdvice = POSIX_FADV_NORMAL;
+        switch (hint) {
+            case AccessHint::Normal:     fileAdvice = POSIX_FADV_NORMAL;     break;
+            case AccessHint::Sequential: fileAdvice = POSIX_FADV_SEQUENTIAL; break;
+            case AccessHint::Random:     fileAdvice = POSIX_FADV_RANDOM;     break;
+            case AccessHint::WillNeed:   fileAdvice = POSIX_FADV_WILLNEED;   break;
+        }
+
+        posix_fadvise(this->m_file, address, size, fileAdvice);
+        #endif
+        #endif
     }
 
     void FileProvider::readRaw(u64 offset, void *buffer, size_t size) {
-        if ((offset + size) > this->getSize() || buffer == nullptr || size == 0)
+        if ((offset + size) > this->getRawSize() || buffer == nullptr || size == 0)
             return;
 
-        std::memcpy(buffer, reinterpret_cast<u8*>(this->m_mappedFile) + PageSize * this->m_currPage + offset, size);
+        if (this->m_windowed)
+            this->copyWindowed(offset, reinterpret_cast<u8*>(buffer), size, false);
+        else
+            std::memcpy(buffer, reinterpret_cast<u8*>(this->m_mappedFile) + offset, size);
     }
 
     void FileProvider::writeRaw(u64 offset, const void *buffer, size_t size) {
-        if ((offset + size) > this->getSize() || buffer == nullptr || size == 0)
+        if ((offset + size) > this->getRawSize() || buffer == nullptr || size == 0)
             return;
 
-        std::memcpy(reinterpret_cast<u8*>(this->m_mappedFile) + PageSize * this->m_currPage + offset, buffer, size);
+        if (this->m_readOnly) {
+            this->writeToFile(offset, buffer, size);
+        } else if (this->m_windowed) {
+            this->copyWindowed(offset, reinterpret_cast<u8*>(const_cast<void*>(buffer)), size, true);
+        } else {
+            std::memcpy(reinterpret_cast<u8*>(this->m_mappedFile) + offset, buffer, size);
+
+            #if !defined(OS_WINDOWS)
+            // The whole file mapping is private, changes to it never reach the file by themselves
+            this->writeToFile(offset, buffer, size);
+            #endif
+        }
+    }
+
+    #if defined(OS_WINDOWS)
+    static bool writeAt(HANDLE file, u64 offset, const void *buffer, size_t size) {
+        auto bytes = reinterpret_cast<const u8*>(buffer);
+        while (size > 0) {
+            OVERLAPPED overlapped = { };
+            overlapped.Offset = DWORD(offset & 0xFFFF'FFFF);
+            overlapped.OffsetHigh = DWORD(offset >> 32);
+
+            DWORD written = 0;
+            if (!WriteFile(file, bytes, DWORD(std::min<size_t>(size, 0x4000'0000)), &written, &overlapped) || written == 0)
+                return false;
+
+            offset += written;
+            bytes += written;
+            size -= written;
+        }
+
+        return true;
+    }
+    #else
+    static bool writeAt(int file, u64 offset, const void *buffer, size_t size) {
+        auto bytes = reinterpret_cast<const u8*>(buffer);
+        while (size > 0) {
+            auto written = pwrite(file, bytes, size, offset);
+            if (written <= 0)
+                return false;
+
+            offset += written;
+            bytes += written;
+            size -= written;
+        }
+
+        return true;
+    }
+    #endif
+
+    void FileProvider::writeToFile(u64 offset, const void *buffer, size_t size) {
+        if (!this->m_writable)
+            return;
+
+        #if defined(OS_WINDOWS)
+        // The read-only mapping stays untouched, a separate handle only gets opened once there's something to save
+        if (this->m_writeFile == nullptr) {
+            auto handle = CreateFileW(toWidePath(this->m_path).data(), GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (handle == INVALID_HANDLE_VALUE)
+                return;
+
+            this->m_writeFile = handle;
+        }
+
+        writeAt(this->m_writeFile, offset, buffer, size);
+        #else
+        if (!this->m_readOnly) {
+            writeAt(this->m_file, offset, buffer, size);
+            return;
+        }
+
+        if (this->m_writeFile == -1) {
+            this->m_writeFile = open(this->m_path.c_str(), O_WRONLY);
+            if (this->m_writeFile == -1)
+                return;
+        }
+
+        writeAt(this->m_writeFile, offset, buffer, size);
+        #endif
+    }
+
+    bool FileProvider::saveAs(const std::string &path) {
+        // Truncating the output would wipe the file that's being copied
+        std::error_code error;
+        if (std::filesystem::equivalent(this->m_path, path, error)) {
+            if (this->hasStructuralChanges())
+                return false;
+
+            this->applyPatches();
+            return true;
+        }
+
+        // With bytes inserted or removed the patches don't line up with a copy of the file anymore
+        if (this->hasStructuralChanges())
+            return Provider::saveAs(path);
+
+        // Copy the unmodified file the fastest way the system offers, then only write the patched runs on top of it
+        #if defined(OS_WINDOWS)
+        if (!CopyFileW(toWidePath(this->m_path).data(), toWidePath(path).data(), FALSE))
+            return Provider::saveAs(path);
+
+        auto output = CreateFileW(toWidePath(path).data(), GENERIC_WRITE, 0, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (output == INVALID_HANDLE_VALUE)
+            return false;
+        SCOPE_EXIT( CloseHandle(output); );
+        #else
+        int output = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, this->m_fileStatsValid ? (this->m_fileStats.st_mode & 0777) : 0644);
+        if (output == -1)
+            return false;
+        SCOPE_EXIT( close(output); );
+
+        bool copied = false;
+
+        #if defined(OS_LINUX)
+        // Filesystems with reflink support share the data with the original, copy_file_range copies inside the kernel otherwise
+        copied = ioctl(output, FICLONE, this->m_file) == 0;
+
+        if (!copied) {
+            loff_t inputOffset = 0, outputOffset = 0;
+            size_t remaining = this->m_fileSize;
+            while (remaining > 0) {
+                auto copiedSize = copy_file_range(this->m_file, &inputOffset, output, &outputOffset, remaining, 0);
+                if (copiedSize <= 0)
+                    break;
+
+                remaining -= copiedSize;
+            }
+
+            copied = remaining == 0;
+        }
+        #endif
+
+        if (!copied)
+            return Provider::saveAs(path);
+        #endif
+
+        auto patches = this->getPatches();
+        for (const auto &[address, run] : patches.getRuns()) {
+            if (!writeAt(output, address, run.data(), run.size()))
+                return false;
+        }
+
+        return true;
+    }
+
+    void FileProvider::copyWindowed(u64 offset, u8 *buffer, size_t size, bool toFile) {
+        while (size > 0) {
+            auto window = this->getWindow(offset / WindowSize);
+            if (window == nullptr)
+                return;
+
+            u64 windowOffset = offset % WindowSize;
+            size_t copySize = std::min<u64>(size, window->size - windowOffset);
+
+            if (toFile)
+                std::memcpy(window->data + windowOffset, buffer, copySize);
+            else
+                std::memcpy(buffer, window->data + windowOffset, copySize);
+
+            offset += copySize;
+            buffer += copySize;
+            size -= copySize;
+        }
+    }
+
+    std::shared_ptr<FileProvider::MappedWindow> FileProvider::getWindow(u64 index) {
+        std::scoped_lock lock(this->m_windowMutex);
+
+        auto it = std::find_if(this->m_windows.begin(), this->m_windows.end(), [index](const auto &window) { return window->index == index; });
+        if (it != this->m_windows.end()) {
+            this->m_windows.splice(this->m_windows.begin(), this->m_windows, it);
+            return this->m_windows.front();
+        }
+
+        u64 offset = index * WindowSize;
+        size_t size = std::min<u64>(WindowSize, this->m_fileSize - offset);
+
+        auto data = this->mapWindow(offset, size);
+        if (data == nullptr)
+            return nullptr;
+
+        // Readers hold on to the windows they're copying from, evicted windows only get unmapped once nobody uses them anymore
+        auto window = std::shared_ptr<MappedWindow>(new MappedWindow{ index, data, size }, [this](MappedWindow *window) {
+            this->unmapWindow(window->data, window->size);
+            delete window;
+        });
+
+        this->m_windows.push_front(window);
+        if (this->m_windows.size() > MaximumWindowCount)
+            this->m_windows.pop_back();
+
+        return window;
     }
-    size_t FileProvider::getActualSize() {
+
+    u8* FileProvider::mapWindow(u64 offset, size_t size) {
+        #if defined(OS_WINDOWS)
+        auto data = MapViewOfFile(this->m_mapping, (this->m_writable && !this->m_readOnly) ? FILE_MAP_ALL_ACCESS : FILE_MAP_READ, DWORD(offset >> 32), DWORD(offset & 0xFFFF'FFFF), size);
+
+        return reinterpret_cast<u8*>(data);
+        #else
+        // Windows get mapped shared so writes don't get lost when one of them is unmapped again
+        auto data = mmap(nullptr, size, PROT_READ | ((this->m_writable && !this->m_readOnly) ? PROT_WRITE : 0), MAP_SHARED, this->m_file, offset);
+        if (data == MAP_FAILED)
+            return nullptr;
+
+        return reinterpret_cast<u8*>(data);
+        #endif
+    }
+
+    void FileProvider::unmapWindow(u8 *data, size_t size) {
+        #if defined(OS_WINDOWS)
+        UnmapViewOfFile(data);
+        #else
+        munmap(data, size);
+        #endif
+    }
+
+    bool FileProvider::hashFile(std::vector<size_t> &hashes, u64 &firstBlock, u64 &size, std::optional<u64> &fileId, u64 previousSize, std::optional<size_t> &previousTailHash) {
+        // Read through a handle of its own, the mapping may still show the file from before it got replaced
+        #if defined(OS_WINDOWS)
+        FILE *file = _wfopen(toWidePath(this->m_path).c_str(), L"rb");
+        #else
+        FILE *file = fopen(this->m_path.c_str(), "rb");
+        #endif
+        if (file == nullptr)
+            return false;
+        SCOPE_EXIT( fclose(file); );
+
+        #if defined(OS_WINDOWS)
+        // Files opened by ImHex can't be replaced on Windows, only changed in place
+        fileId.reset();
+        s64 fileSize = _filelengthi64(_fileno(file));
+        if (fileSize < 0)
+            return false;
+        #else
+        struct stat fileStats = { 0 };
+        if (fstat(fileno(file), &fileStats) != 0)
+            return false;
+
+        fileId = fileStats.st_ino;
+        u64 fileSize = fileStats.st_size;
+        #endif
+
+        // Hashing starts at the last block at the latest, the end of the file is always hashed
+        firstBlock = std::min<u64>(firstBlock, u64(fileSize) / WatchedBlockSize);
+
+        hashes.clear();
+        size = firstBlock * WatchedBlockSize;
+
+        #if defined(OS_WINDOWS)
+        if (_fseeki64(file, size, SEEK_SET) != 0)
+            return false;
+        #else
+        if (fseeko(file, size, SEEK_SET) != 0)
+            return false;
+        #endif
+
+        std::vector<u8> buffer(WatchedBlockSize);
+        while (!this->m_closing) {
+            auto readSize = fread(buffer.data(), 1, buffer.size(), file);
+            if (readSize == 0)
+                break;
+
+            auto data = reinterpret_cast<const char*>(buffer.data());
+            hashes.push_back(std::hash<std::string_view>{}(std::string_view(data, readSize)));
+
+            // The block the file used to end in only got hashed up to the old end, it has to be compared the same way after growing
+            if (previousSize > size && previousSize < size + readSize)
+                previousTailHash = std::hash<std::string_view>{}(std::string_view(data, previousSize - size));
+
+            size += readSize;
+        }
+
+        return !this->m_closing;
+    }
+
+    void FileProvider::checkForChanges() {
+        // Only the end of a file that's being followed gets hashed again, blocks in front of where it used to end are assumed to stay the same
+        u64 firstBlock = 0;
+        if (this->isFollowing())
+            firstBlock = this->m_hashed ? this->m_hashedSize / WatchedBlockSize : std::numeric_limits<u64>::max();
+
+        std::vector<size_t> hashes;
+        u64 size;
+        std::optional<u64> fileId;
+        std::optional<size_t> previousTailHash;
+
+        // A file that's missing is most likely just being replaced, the new one causes another check
+        if (!this->hashFile(hashes, firstBlock, size, fileId, this->m_hashed ? this->m_hashedSize : 0, previousTailHash))
+            return;
+
+        // The first check happens right after the watch got set up and only records what the file looks like
+        if (!this->m_hashed) {
+            this->m_blockHashes = std::move(hashes);
+            this->m_firstHashedBlock = firstBlock;
+            this->m_hashedSize = size;
+            this->m_hashedFileId = fileId;
+            this->m_hashed = true;
+            return;
+        }
+
+        std::vector<Region> changedRegions;
+        auto addChange = [&](u64 start, u64 end) {
+            if (!changedRegions.empty() && changedRegions.back().address + changedRegions.back().size == start)
+                changedRegions.back().size += end - start;
+            else
+                changedRegions.push_back({ start, size_t(end - start) });
+        };
+
+        // Data that got appended or cut off gets reported once the mapping was adjusted to the new size
+        u64 commonSize = std::min(size, this->m_hashedSize);
+        bool replaced = fileId != this->m_hashedFileId;
+
+        if (replaced && firstBlock > 0) {
+            // Only the end of the replaced file got hashed, nothing in front of it can be told apart from the old file
+            if (commonSize > 0)
+                addChange(0, commonSize);
+        } else {
+            for (size_t i = 0; i < hashes.size(); i++) {
+                u64 block = firstBlock + i;
+                u64 address = block * WatchedBlockSize;
+                if (address >= commonSize)
+                    break;
+
+                auto hash = hashes[i];
+                if (previousTailHash.has_value() && block == this->m_hashedSize / WatchedBlockSize)
+                    hash = *previousTailHash;
+
+                bool known = block >= this->m_firstHashedBlock && block - this->m_firstHashedBlock < this->m_blockHashes.size();
+                if (!known || hash != this->m_blockHashes[block - this->m_firstHashedBlock])
+                    addChange(address, std::min<u64>(address + WatchedBlockSize, commonSize));
+            }
+        }
+
+        bool reloadNeeded = size < this->m_hashedSize || replaced;
+        bool grown = size > this->m_hashedSize;
+
+        this->m_blockHashes = std::move(hashes);
+        this->m_firstHashedBlock = firstBlock;
+        this->m_hashedSize = size;
+        this->m_hashedFileId = fileId;
+
+        if (changedRegions.empty() && !reloadNeeded && !grown)
+            return;
+
+        {
+            std::scoped_lock lock(this->m_changeMutex);
+            this->m_changedRegions.insert(this->m_changedRegions.end(), changedRegions.begin(), changedRegions.end());
+            this->m_reloadNeeded = this->m_reloadNeeded || reloadNeeded;
+            if (grown)
+                this->m_grownSize = size;
+        }
+
+        View::requestRedraw();
+    }
+
+    std::vector<Region> FileProvider::getChangedRegions() {
+        std::vector<Region> changedRegions;
+        bool reloadNeeded;
+        std::optional<u64> grownSize;
+        {
+            std::scoped_lock lock(this->m_changeMutex);
+            std::swap(changedRegions, this->m_changedRegions);
+            reloadNeeded = std::exchange(this->m_reloadNeeded, false);
+            grownSize = std::exchange(this->m_grownSize, std::nullopt);
+        }
+
+        u64 oldSize = this->m_fileSize;
+        u64 oldActualSize = this->getActualSize();
+
+        if (reloadNeeded) {
+            this->reload();
+
+            // Everything past the smaller of both sizes changed, no matter how often the file grew before it got replaced
+            if (this->m_fileSize != oldSize)
+                changedRegions.push_back({ std::min<u64>(oldSize, this->m_fileSize), size_t(std::max<u64>(oldSize, this->m_fileSize) - std::min<u64>(oldSize, this->m_fileSize)) });
+        } else if (!changedRegions.empty())
+            this->remapRegions(changedRegions);
+
+        for (const auto &region : changedRegions)
+            this->invalidateBlockCache(region.address, region.size);
+
+        // Appended data ends up behind everything else, which isn't where the file used to end if bytes were inserted or removed
+        if (!reloadNeeded && grownSize.has_value() && *grownSize > oldSize) {
+            this->grow(*grownSize);
+            this->appendRawData(oldSize);
+
+            changedRegions.push_back({ oldActualSize, size_t(this->m_fileSize - oldSize) });
+        }
+
+        return changedRegions;
+    }
+
+    void FileProvider::grow(u64 size) {
+        {
+            // The last window ends where the file used to end, it has to be mapped again to include the appended data
+            std::scoped_lock lock(this->m_windowMutex);
+            this->m_windows.remove_if([](const auto &window) { return window->size < WindowSize; });
+        }
+
+        #if defined(OS_WINDOWS)
+        // Mappings can't grow past the size they were created with. Views of the old one keep it alive for as long as they exist
+        auto mapping = CreateFileMapping(this->m_file, nullptr, this->m_readOnly ? PAGE_READONLY : PAGE_READWRITE, DWORD(size >> 32), DWORD(size & 0xFFFF'FFFF), nullptr);
+        if (mapping == nullptr) {
+            this->reload();
+            return;
+        }
+
+        CloseHandle(this->m_mapping);
+        this->m_mapping = mapping;
+        #endif
+
+        if (this->m_mappedFile != nullptr) {
+            void *mappedFile = nullptr;
+
+            if (size <= FullMappingLimit) {
+                #if defined(OS_LINUX)
+                // Growing the mapping in place keeps the pages that are mapped in already, it only fails if something else is mapped right behind it
+                mappedFile = mremap(this->m_mappedFile, this->m_fileSize, size, 0);
+                if (mappedFile == MAP_FAILED)
+                    mappedFile = nullptr;
+                #endif
+
+                if (mappedFile == nullptr)
+                    mappedFile = this->mapWholeFile(size);
+            }
+
+            // Other threads may still be reading from the old mapping, files grown too large for a single one get mapped in windows from now on
+            if (mappedFile != this->m_mappedFile) {
+                this->m_retiredMappings.emplace_back(this->m_mappedFile, this->m_fileSize);
+                this->m_mappedFile = mappedFile;
+                this->m_windowed = mappedFile == nullptr;
+            }
+        }
+
+        this->m_fileSize = size;
+        this->m_fileStatsValid = stat(this->m_path.c_str(), &this->m_fileStats) == 0;
+    }
+
+    void FileProvider::reload() {
+        {
+            std::scoped_lock lock(this->m_windowMutex);
+            this->m_windows.clear();
+        }
+
+        if (this->m_mappedFile != nullptr)
+            this->m_retiredMappings.emplace_back(this->m_mappedFile, this->m_fileSize);
+
+        this->m_mappedFile = nullptr;
+        this->m_windowed = false;
+
+        #if defined(OS_WINDOWS)
+        if (this->m_mapping != nullptr)
+            CloseHandle(this->m_mapping);
+        if (this->m_file != nullptr)
+            CloseHandle(this->m_file);
+        if (this->m_writeFile != nullptr)
+            CloseHandle(this->m_writeFile);
+
+        this->m_mapping = nullptr;
+        this->m_file = nullptr;
+        this->m_writeFile = nullptr;
+        #else
+        close(this->m_file);
+        if (this->m_writeFile != -1)
+            close(this->m_writeFile);
+
+        this->m_file = -1;
+        this->m_writeFile = -1;
+        #endif
+
+        this->openFile();
+    }
+
+    void FileProvider::remapRegions(const std::vector<Region> &regions) {
+        #if !defined(OS_WINDOWS)
+        // Pages of the private whole file mapping that were written to are copies which don't see changes to the file anymore, mapping them again drops those.
+        // Shared mappings and windows always show what's in the file
+        if (this->m_readOnly || this->m_mappedFile == nullptr)
+            return;
+
+        u64 pageSize = sysconf(_SC_PAGESIZE);
+        for (const auto &region : regions) {
+            u64 start = region.address - region.address % pageSize;
+            u64 end = std::min<u64>(region.address + region.size, this->m_fileSize);
+            if (start >= end)
+                continue;
+
+            mmap(reinterpret_cast<u8*>(this->m_mappedFile) + start, end - start, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, this->m_file, start);
+        }
+        #endif
+    }
+
+    size_t FileProvider::getRawSize() {
         return this->m_fileSize;
     }
 
@@ -166,7 +793,7 @@ namespace hex::prv {
         std::vector<std::pair<std::string, std::string>> result;
 
         result.emplace_back("hex.builtin.provider.file.path"_lang, this->m_path);
-        result.emplace_back("hex.builtin.provider.file.size"_lang, hex::toByteString(this->getActualSize()));
+        result.emplace_back("hex.builtin.provider.file.size"_lang, hex::toByteString(this->getRawSize()));
 
         if (this->m_fileStatsValid) {
             result.emplace_back("hex.builtin.provider.file.creation"_lang, ctime(&this->m_fileStats.st_ctime));
@@ -177,4 +804,12 @@ namespace hex::prv {
         return result;
     }
 
+    std::string FileProvider::getName() {
+        return std::filesystem::path(this->m_path).filename().string();
+    }
+
+    std::string FileProvider::getFilePath() {
+        return this->m_path;
+    }
+
 }
\ No newline at end of file
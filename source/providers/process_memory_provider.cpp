@@ -0,0 +1,341 @@
+#include "providers/process_memory_provider.hpp"
+
+#include <hex/views/view.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string_view>
+
+#if defined(OS_LINUX)
+#include <climits>
+#include <sys/uio.h>
+#endif
+
+namespace hex::prv {
+
+    ProcessMemoryProvider::ProcessMemoryProvider(u32 processId) : Provider(), m_processId(processId) {
+        #if defined(OS_WINDOWS)
+        this->m_writable = true;
+        this->m_process = OpenProcess(PROCESS_VM_READ | PROCESS_VM_WRITE | PROCESS_VM_OPERATION | PROCESS_QUERY_INFORMATION, FALSE, processId);
+        if (this->m_process == nullptr) {
+            this->m_process = OpenProcess(PROCESS_VM_READ | PROCESS_QUERY_INFORMATION, FALSE, processId);
+            this->m_writable = false;
+        }
+
+        if (this->m_process == nullptr)
+            return;
+
+        char imageName[MAX_PATH] = { 0 };
+        DWORD imageNameSize = sizeof(imageName);
+        if (QueryFullProcessImageNameA(this->m_process, 0, imageName, &imageNameSize))
+            this->m_processName = imageName;
+        #elif defined(OS_LINUX)
+        // Whether the memory can actually be accessed depends on ptrace permissions, that only shows once something gets read
+        std::ifstream comm(hex::format("/proc/{}/comm", processId));
+        if (!comm.is_open())
+            return;
+
+        std::getline(comm, this->m_processName);
+        this->m_writable = true;
+        #else
+        return;
+        #endif
+
+        this->updateRegions();
+        this->m_available = !this->m_regions.empty();
+
+        // The hex editor reads single bytes, without caching every one of them would be a request to the other process
+        this->setBlockCacheSize(MemoryCacheSize);
+
+        this->m_watcher = std::thread([this] {
+            std::unique_lock lock(this->m_watcherMutex);
+            while (!this->m_watcherSignal.wait_for(lock, ChangeCheckInterval, [this] { return this->m_stopWatcher; })) {
+                lock.unlock();
+                this->checkForChanges();
+                lock.lock();
+            }
+        });
+    }
+
+    ProcessMemoryProvider::~ProcessMemoryProvider() {
+        {
+            std::scoped_lock lock(this->m_watcherMutex);
+            this->m_stopWatcher = true;
+        }
+        this->m_watcherSignal.notify_all();
+
+        if (this->m_watcher.joinable())
+            this->m_watcher.join();
+
+        #if defined(OS_WINDOWS)
+        if (this->m_process != nullptr)
+            CloseHandle(this->m_process);
+        #endif
+    }
+
+
+    bool ProcessMemoryProvider::isAvailable() {
+        return this->m_available;
+    }
+
+    bool ProcessMemoryProvider::isReadable() {
+        return isAvailable();
+    }
+
+    bool ProcessMemoryProvider::isWritable() {
+        return isAvailable() && this->m_writable;
+    }
+
+
+    void ProcessMemoryProvider::readRaw(u64 offset, void *buffer, size_t size) {
+        if ((offset + size) > this->getRawSize() || buffer == nullptr || size == 0)
+            return;
+
+        std::memset(buffer, 0x00, size);
+        this->transfer(offset, reinterpret_cast<u8*>(buffer), size, false);
+
+        this->watchBlocks(offset, reinterpret_cast<const u8*>(buffer), size);
+    }
+
+    void ProcessMemoryProvider::writeRaw(u64 offset, const void *buffer, size_t size) {
+        if ((offset + size) > this->getRawSize() || buffer == nullptr || size == 0 || !this->m_writable)
+            return;
+
+        this->transfer(offset, reinterpret_cast<u8*>(const_cast<void*>(buffer)), size, true);
+    }
+
+    size_t ProcessMemoryProvider::getRawSize() {
+        std::scoped_lock lock(this->m_regionMutex);
+
+        if (this->m_regions.empty())
+            return 0;
+
+        return this->m_regions.back().end;
+    }
+
+    Provider::Capability ProcessMemoryProvider::getCapabilities() {
+        return Capability::ThreadSafeReads | Capability::CheapRandomAccess;
+    }
+
+    std::vector<Region> ProcessMemoryProvider::getChangedRegions() {
+        std::scoped_lock lock(this->m_watchMutex);
+
+        return std::move(this->m_changedRegions);
+    }
+
+    void ProcessMemoryProvider::updateRegions() {
+        std::vector<MemoryRegion> regions;
+
+        #if defined(OS_WINDOWS)
+        MEMORY_BASIC_INFORMATION information;
+        for (u64 address = 0; VirtualQueryEx(this->m_process, reinterpret_cast<LPCVOID>(address), &information, sizeof(information)) == sizeof(information); address += information.RegionSize) {
+            if (information.State != MEM_COMMIT || (information.Protect & (PAGE_NOACCESS | PAGE_GUARD)) != 0)
+                continue;
+
+            u64 start = reinterpret_cast<u64>(information.BaseAddress);
+            bool writable = (information.Protect & (PAGE_READWRITE | PAGE_WRITECOPY | PAGE_EXECUTE_READWRITE | PAGE_EXECUTE_WRITECOPY)) != 0;
+
+            regions.push_back({ start, start + information.RegionSize, writable });
+        }
+        #elif defined(OS_LINUX)
+        std::ifstream maps(hex::format("/proc/{}/maps", this->m_processId));
+
+        std::string line;
+        while (std::getline(maps, line)) {
+            u64 start = 0, end = 0;
+            std::string permissions;
+
+            std::istringstream stream(line);
+            char separator;
+            stream >> std::hex >> start >> separator >> end >> permissions;
+
+            if (stream.fail() || permissions.size() < 2 || permissions[0] != 'r')
+                continue;
+
+            regions.push_back({ start, end, permissions[1] == 'w' });
+        }
+        #endif
+
+        // Neighbouring regions with the same access get merged so fewer segments have to be requested
+        std::vector<MemoryRegion> merged;
+        for (const auto &region : regions) {
+            if (!merged.empty() && merged.back().end == region.start && merged.back().writable == region.writable)
+                merged.back().end = region.end;
+            else
+                merged.push_back(region);
+        }
+
+        std::scoped_lock lock(this->m_regionMutex);
+        this->m_regions = std::move(merged);
+    }
+
+    void ProcessMemoryProvider::transfer(u64 address, u8 *buffer, size_t size, bool write) {
+        struct Segment {
+            u64 address;
+            u8 *buffer;
+            size_t size;
+        };
+
+        // Only the parts of the range that lie inside of mapped regions get requested, gaps are never probed
+        std::vector<Segment> segments;
+        {
+            std::scoped_lock lock(this->m_regionMutex);
+
+            u64 end = address + size;
+            auto region = std::upper_bound(this->m_regions.begin(), this->m_regions.end(), address, [](u64 address, const MemoryRegion &region) {
+                return address < region.end;
+            });
+
+            for (; region != this->m_regions.end() && region->start < end; region++) {
+                if (write && !region->writable)
+                    continue;
+
+                u64 segmentStart = std::max(address, region->start);
+                u64 segmentEnd = std::min(end, region->end);
+                segments.push_back({ segmentStart, buffer + (segmentStart - address), segmentEnd - segmentStart });
+            }
+        }
+
+        #if defined(OS_WINDOWS)
+        for (const auto &segment : segments) {
+            SIZE_T transferred = 0;
+            if (write)
+                WriteProcessMemory(this->m_process, reinterpret_cast<LPVOID>(segment.address), segment.buffer, segment.size, &transferred);
+            else
+                ReadProcessMemory(this->m_process, reinterpret_cast<LPCVOID>(segment.address), segment.buffer, segment.size, &transferred);
+        }
+        #elif defined(OS_LINUX)
+        std::vector<iovec> local, remote;
+        for (const auto &segment : segments) {
+            local.push_back({ segment.buffer, segment.size });
+            remote.push_back({ reinterpret_cast<void*>(segment.address), segment.size });
+        }
+
+        // All segments get transferred with as few vectored calls as possible
+        for (size_t first = 0; first < segments.size(); first += IOV_MAX) {
+            size_t count = std::min<size_t>(IOV_MAX, segments.size() - first);
+
+            ssize_t expected = 0;
+            for (size_t i = first; i < first + count; i++)
+                expected += segments[i].size;
+
+            ssize_t transferred = write ? process_vm_writev(this->m_processId, &local[first], count, &remote[first], count, 0)
+                                        : process_vm_readv(this->m_processId, &local[first], count, &remote[first], count, 0);
+            if (transferred == expected)
+                continue;
+
+            // A transfer stops at the first segment that fails, the ones after it get another chance on their own
+            size_t done = std::max<ssize_t>(transferred, 0);
+            for (size_t i = first; i < first + count; i++) {
+                if (done >= segments[i].size) {
+                    done -= segments[i].size;
+                    continue;
+                }
+
+                iovec localSegment  = { segments[i].buffer + done, segments[i].size - done };
+                iovec remoteSegment = { reinterpret_cast<void*>(segments[i].address + done), segments[i].size - done };
+                done = 0;
+
+                if (write)
+                    process_vm_writev(this->m_processId, &localSegment, 1, &remoteSegment, 1, 0);
+                else
+                    process_vm_readv(this->m_processId, &localSegment, 1, &remoteSegment, 1, 0);
+            }
+        }
+        #endif
+    }
+
+    size_t ProcessMemoryProvider::hashBlock(const u8 *data, size_t size) {
+        return std::hash<std::string_view>{}(std::string_view(reinterpret_cast<const char*>(data), size));
+    }
+
+    void ProcessMemoryProvider::watchBlocks(u64 address, const u8 *buffer, size_t size) {
+        std::scoped_lock lock(this->m_watchMutex);
+
+        // Only blocks that were read completely have a known hash
+        u64 firstBlock = (address + WatchedBlockSize - 1) / WatchedBlockSize;
+        u64 lastBlock = (address + size) / WatchedBlockSize;
+        for (u64 block = firstBlock; block < lastBlock; block++) {
+            size_t hash = hashBlock(buffer + (block * WatchedBlockSize - address), WatchedBlockSize);
+
+            if (auto it = this->m_watchedBlocks.find(block); it != this->m_watchedBlocks.end()) {
+                it->second.first = hash;
+                this->m_watchOrder.splice(this->m_watchOrder.begin(), this->m_watchOrder, it->second.second);
+            } else {
+                this->m_watchOrder.push_front(block);
+                this->m_watchedBlocks.emplace(block, std::make_pair(hash, this->m_watchOrder.begin()));
+            }
+        }
+
+        while (this->m_watchOrder.size() > MaximumWatchedBlocks) {
+            this->m_watchedBlocks.erase(this->m_watchOrder.back());
+            this->m_watchOrder.pop_back();
+        }
+    }
+
+    void ProcessMemoryProvider::checkForChanges() {
+        // Mappings come and go while the process runs
+        this->updateRegions();
+
+        std::vector<std::pair<u64, size_t>> blocks;
+        {
+            std::scoped_lock lock(this->m_watchMutex);
+            for (const auto &[block, entry] : this->m_watchedBlocks)
+                blocks.emplace_back(block, entry.first);
+        }
+
+        std::vector<u8> buffer(WatchedBlockSize);
+        std::vector<Region> changedRegions;
+        for (const auto &[block, hash] : blocks) {
+            std::fill(buffer.begin(), buffer.end(), 0x00);
+            this->transfer(block * WatchedBlockSize, buffer.data(), buffer.size(), false);
+
+            if (hashBlock(buffer.data(), buffer.size()) == hash)
+                continue;
+
+            std::scoped_lock lock(this->m_watchMutex);
+            if (auto it = this->m_watchedBlocks.find(block); it != this->m_watchedBlocks.end())
+                it->second.first = hashBlock(buffer.data(), buffer.size());
+
+            changedRegions.push_back({ block * WatchedBlockSize, WatchedBlockSize });
+        }
+
+        for (const auto &region : changedRegions)
+            this->invalidateBlockCache(region.address, region.size);
+
+        if (!changedRegions.empty()) {
+            std::scoped_lock lock(this->m_watchMutex);
+            this->m_changedRegions.insert(this->m_changedRegions.end(), changedRegions.begin(), changedRegions.end());
+        }
+
+        if (!changedRegions.empty())
+            View::requestRedraw();
+    }
+
+    std::vector<std::pair<std::string, std::string>> ProcessMemoryProvider::getDataInformation() {
+        std::vector<std::pair<std::string, std::string>> result;
+
+        u64 mappedSize = 0;
+        size_t regionCount = 0;
+        {
+            std::scoped_lock lock(this->m_regionMutex);
+            for (const auto &region : this->m_regions)
+                mappedSize += region.end - region.start;
+            regionCount = this->m_regions.size();
+        }
+
+        result.emplace_back("hex.builtin.provider.process.id"_lang, std::to_string(this->m_processId));
+        result.emplace_back("hex.builtin.provider.process.name"_lang, this->m_processName);
+        result.emplace_back("hex.builtin.provider.process.regions"_lang, std::to_string(regionCount));
+        result.emplace_back("hex.builtin.provider.process.mapped_size"_lang, hex::toByteString(mappedSize));
+
+        return result;
+    }
+
+    std::string ProcessMemoryProvider::getName() {
+        return hex::format("{} ({})", this->m_processName, this->m_processId);
+    }
+
+}
\ No newline at end of file
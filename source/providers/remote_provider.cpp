@@ -0,0 +1,354 @@
+#include "providers/remote_provider.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#if !defined(OS_WINDOWS)
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#endif
+
+namespace hex::prv {
+
+    RemoteProvider::RemoteProvider(std::string_view address) : Provider(), m_address(address) {
+        #if defined(OS_WINDOWS)
+        WSADATA wsaData;
+        WSAStartup(MAKEWORD(2, 2), &wsaData);
+        #endif
+
+        this->connect();
+    }
+
+    RemoteProvider::~RemoteProvider() {
+        this->disconnect();
+
+        #if defined(OS_WINDOWS)
+        WSACleanup();
+        #endif
+    }
+
+
+    bool RemoteProvider::isAvailable() {
+        return this->m_socket != remote::InvalidSocket;
+    }
+
+    bool RemoteProvider::isReadable() {
+        return isAvailable();
+    }
+
+    bool RemoteProvider::isWritable() {
+        return isAvailable() && this->m_writable;
+    }
+
+
+    bool RemoteProvider::connect() {
+        std::string host = this->m_address, port = std::to_string(remote::DefaultPort);
+
+        // IPv6 addresses contain colons themselves and need to be put in brackets to have a port added
+        if (host.starts_with('[')) {
+            auto closingBracket = host.find(']');
+            if (closingBracket == std::string::npos)
+                return false;
+
+            if (closingBracket + 1 < host.size() && host[closingBracket + 1] == ':')
+                port = host.substr(closingBracket + 2);
+            host = host.substr(1, closingBracket - 1);
+        } else if (auto separator = host.find(':'); separator != std::string::npos && host.find(':', separator + 1) == std::string::npos) {
+            port = host.substr(separator + 1);
+            host = host.substr(0, separator);
+        }
+
+        addrinfo hints = { };
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+
+        addrinfo *addresses = nullptr;
+        if (getaddrinfo(host.c_str(), port.c_str(), &hints, &addresses) != 0)
+            return false;
+
+        for (auto address = addresses; address != nullptr; address = address->ai_next) {
+            auto socket = ::socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+            if (socket == remote::InvalidSocket)
+                continue;
+
+            if (::connect(socket, address->ai_addr, address->ai_addrlen) == 0) {
+                this->m_socket = socket;
+                break;
+            }
+
+            remote::closeSocket(socket);
+        }
+
+        freeaddrinfo(addresses);
+
+        if (this->m_socket == remote::InvalidSocket)
+            return false;
+
+        // Requests are small and need to go out right away, while answers come in large amounts
+        int noDelay = 1, receiveBufferSize = MaximumReadAhead;
+        setsockopt(this->m_socket, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&noDelay), sizeof(noDelay));
+        setsockopt(this->m_socket, SOL_SOCKET, SO_RCVBUF, reinterpret_cast<const char*>(&receiveBufferSize), sizeof(receiveBufferSize));
+
+        u8 request[remote::RequestHeaderSize];
+        remote::encodeRequest(request, remote::Command::Hello, remote::ProtocolMagic, remote::ProtocolVersion);
+
+        u8 response[remote::ResponseHeaderSize];
+        u8 information[sizeof(u64) + sizeof(u8)];
+        if (!remote::sendAll(this->m_socket, request, sizeof(request)) || !remote::receiveAll(this->m_socket, response, sizeof(response))
+            || response[0] != u8(remote::Status::Ok) || remote::decodeLE(response + 1, sizeof(u64)) != sizeof(information)
+            || !remote::receiveAll(this->m_socket, information, sizeof(information))) {
+            this->disconnect();
+            return false;
+        }
+
+        this->m_dataSize = remote::decodeLE(information, sizeof(u64));
+        this->m_writable = information[sizeof(u64)] != 0x00;
+
+        return true;
+    }
+
+    void RemoteProvider::disconnect() {
+        if (this->m_socket != remote::InvalidSocket)
+            remote::closeSocket(this->m_socket);
+
+        this->m_socket = remote::InvalidSocket;
+        this->m_pendingRequests.clear();
+        this->m_pendingBlocks.clear();
+    }
+
+
+    void RemoteProvider::requestBlocks(u64 firstBlock, u64 lastBlock, std::vector<u8> &requests) {
+        constexpr static u64 MaximumBlocksPerRequest = MaximumRequestSize / BlockSize;
+
+        // Runs of blocks that are neither cached nor already on their way get requested together
+        u64 block = firstBlock;
+        while (block <= lastBlock) {
+            if (this->m_cache.contains(block) || this->m_pendingBlocks.contains(block)) {
+                block++;
+                continue;
+            }
+
+            u64 runStart = block;
+            while (block <= lastBlock && block - runStart < MaximumBlocksPerRequest && !this->m_cache.contains(block) && !this->m_pendingBlocks.contains(block)) {
+                this->m_pendingBlocks.insert(block);
+                block++;
+            }
+
+            u64 offset = runStart * BlockSize;
+            u64 size = std::min<u64>((block - runStart) * BlockSize, this->m_dataSize - offset);
+
+            u8 request[remote::RequestHeaderSize];
+            remote::encodeRequest(request, remote::Command::Read, offset, size);
+            requests.insert(requests.end(), request, request + sizeof(request));
+
+            this->m_pendingRequests.push_back({ remote::Command::Read, runStart, block - runStart });
+        }
+    }
+
+    bool RemoteProvider::receiveResponse() {
+        if (this->m_pendingRequests.empty())
+            return false;
+
+        auto request = this->m_pendingRequests.front();
+        this->m_pendingRequests.pop_front();
+
+        u8 response[remote::ResponseHeaderSize];
+        if (!remote::receiveAll(this->m_socket, response, sizeof(response)))
+            return false;
+
+        auto status = remote::Status(response[0]);
+        u64 size = remote::decodeLE(response + 1, sizeof(u64));
+        if (size > remote::MaximumTransferSize)
+            return false;
+
+        std::vector<u8> data(size);
+        if (size > 0 && !remote::receiveAll(this->m_socket, data.data(), size))
+            return false;
+
+        this->m_bytesReceived += size;
+        this->m_requestCount++;
+
+        if (request.command != remote::Command::Read)
+            return status == remote::Status::Ok;
+
+        // Blocks the server couldn't read show up as zeros instead of being requested over and over again
+        data.resize(request.blockCount * BlockSize, 0x00);
+        if (status != remote::Status::Ok)
+            std::fill(data.begin(), data.end(), 0x00);
+
+        for (u64 i = 0; i < request.blockCount; i++) {
+            this->m_pendingBlocks.erase(request.firstBlock + i);
+            this->cacheBlock(request.firstBlock + i, std::vector<u8>(data.begin() + i * BlockSize, data.begin() + (i + 1) * BlockSize));
+        }
+
+        return true;
+    }
+
+    void RemoteProvider::cacheBlock(u64 block, std::vector<u8> &&data) {
+        if (auto it = this->m_cache.find(block); it != this->m_cache.end()) {
+            it->second.first = std::move(data);
+            this->m_cacheOrder.splice(this->m_cacheOrder.begin(), this->m_cacheOrder, it->second.second);
+        } else {
+            this->m_cacheOrder.push_front(block);
+            this->m_cache.emplace(block, std::make_pair(std::move(data), this->m_cacheOrder.begin()));
+        }
+
+        while (this->m_cacheOrder.size() * BlockSize > RemoteCacheSize) {
+            this->m_cache.erase(this->m_cacheOrder.back());
+            this->m_cacheOrder.pop_back();
+        }
+    }
+
+
+    void RemoteProvider::readRaw(u64 offset, void *buffer, size_t size) {
+        if ((offset + size) > this->getRawSize() || buffer == nullptr || size == 0)
+            return;
+
+        auto output = reinterpret_cast<u8*>(buffer);
+
+        std::scoped_lock lock(this->m_requestMutex);
+
+        if (!this->isAvailable()) {
+            std::memset(output, 0x00, size);
+            return;
+        }
+
+        // Reads that keep moving forward get more and more data requested ahead of them, jumping somewhere else stops that
+        bool movesForward = offset >= this->m_lastReadStart && offset <= this->m_lastReadEnd && offset + size > this->m_lastReadEnd;
+        bool isRepeated = offset >= this->m_lastReadStart && offset + size <= this->m_lastReadEnd;
+        if (movesForward)
+            this->m_readAhead = std::clamp<size_t>(this->m_readAhead * 2, MinimumReadAhead, MaximumReadAhead);
+        else if (!isRepeated)
+            this->m_readAhead = 0;
+
+        this->m_lastReadStart = offset;
+        this->m_lastReadEnd = offset + size;
+
+        u64 firstBlock = offset / BlockSize;
+        u64 lastBlock = (offset + size - 1) / BlockSize;
+
+        std::vector<u8> requests;
+        this->requestBlocks(firstBlock, lastBlock, requests);
+
+        if (this->m_readAhead > 0) {
+            u64 readAheadEnd = std::min<u64>(offset + size + this->m_readAhead, this->m_dataSize);
+            u64 lastReadAheadBlock = (readAheadEnd - 1) / BlockSize;
+
+            if (lastReadAheadBlock > lastBlock)
+                this->requestBlocks(lastBlock + 1, lastReadAheadBlock, requests);
+        }
+
+        if (!requests.empty() && !remote::sendAll(this->m_socket, requests.data(), requests.size())) {
+            this->disconnect();
+            std::memset(output, 0x00, size);
+            return;
+        }
+
+        for (u64 block = firstBlock; block <= lastBlock; block++) {
+            // Answers arrive in the order the requests were sent in, the ones for read ahead blocks get cached on the way
+            while (!this->m_cache.contains(block)) {
+                if (!this->m_pendingBlocks.contains(block)) {
+                    requests.clear();
+                    this->requestBlocks(block, block, requests);
+
+                    if (!remote::sendAll(this->m_socket, requests.data(), requests.size())) {
+                        this->disconnect();
+                        break;
+                    }
+                }
+
+                if (!this->receiveResponse()) {
+                    this->disconnect();
+                    break;
+                }
+            }
+
+            if (!this->isAvailable()) {
+                std::memset(output, 0x00, size);
+                return;
+            }
+
+            auto &[data, position] = this->m_cache[block];
+            this->m_cacheOrder.splice(this->m_cacheOrder.begin(), this->m_cacheOrder, position);
+
+            u64 blockStart = block * BlockSize;
+            u64 copyStart = std::max(offset, blockStart);
+            u64 copyEnd = std::min(offset + size, blockStart + BlockSize);
+
+            std::memcpy(output + (copyStart - offset), data.data() + (copyStart - blockStart), copyEnd - copyStart);
+        }
+    }
+
+    void RemoteProvider::writeRaw(u64 offset, const void *buffer, size_t size) {
+        if ((offset + size) > this->getRawSize() || buffer == nullptr || size == 0 || !this->isWritable())
+            return;
+
+        auto input = reinterpret_cast<const u8*>(buffer);
+
+        std::scoped_lock lock(this->m_requestMutex);
+
+        // Blocks that are still on their way contain the old data, they need to be in the cache to get updated below
+        while (!this->m_pendingRequests.empty()) {
+            if (!this->receiveResponse()) {
+                this->disconnect();
+                return;
+            }
+        }
+
+        for (u64 written = 0; written < size; ) {
+            u64 chunkSize = std::min<u64>(size - written, remote::MaximumTransferSize);
+
+            u8 request[remote::RequestHeaderSize];
+            remote::encodeRequest(request, remote::Command::Write, offset + written, chunkSize);
+
+            this->m_pendingRequests.push_back({ remote::Command::Write, 0, 0 });
+            if (!remote::sendAll(this->m_socket, request, sizeof(request)) || !remote::sendAll(this->m_socket, input + written, chunkSize)) {
+                this->disconnect();
+                return;
+            }
+
+            written += chunkSize;
+        }
+
+        while (!this->m_pendingRequests.empty()) {
+            if (!this->receiveResponse())
+                break;
+        }
+
+        for (u64 block = offset / BlockSize; block <= (offset + size - 1) / BlockSize; block++) {
+            auto it = this->m_cache.find(block);
+            if (it == this->m_cache.end())
+                continue;
+
+            u64 blockStart = block * BlockSize;
+            u64 copyStart = std::max(offset, blockStart);
+            u64 copyEnd = std::min(offset + size, blockStart + BlockSize);
+
+            std::memcpy(it->second.first.data() + (copyStart - blockStart), input + (copyStart - offset), copyEnd - copyStart);
+        }
+    }
+
+    size_t RemoteProvider::getRawSize() {
+        return this->m_dataSize;
+    }
+
+    std::vector<std::pair<std::string, std::string>> RemoteProvider::getDataInformation() {
+        std::vector<std::pair<std::string, std::string>> result;
+
+        std::scoped_lock lock(this->m_requestMutex);
+
+        result.emplace_back("hex.builtin.provider.remote.address"_lang, this->m_address);
+        result.emplace_back("hex.builtin.provider.remote.size"_lang, hex::toByteString(this->getRawSize()));
+        result.emplace_back("hex.builtin.provider.remote.cached"_lang, hex::toByteString(this->m_cache.size() * BlockSize));
+        result.emplace_back("hex.builtin.provider.remote.received"_lang, hex::toByteString(this->m_bytesReceived));
+        result.emplace_back("hex.builtin.provider.remote.requests"_lang, std::to_string(this->m_requestCount));
+
+        return result;
+    }
+
+    std::string RemoteProvider::getName() {
+        return this->m_address;
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,245 @@
+#include "providers/remote_protocol.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#if !defined(OS_WINDOWS)
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/stat.h>
+#endif
+
+/*
+    Serves a single file or disk to ImHex's remote provider. Clients are handled one after another,
+    every request gets answered in the order it arrived in
+*/
+
+using namespace hex::prv;
+
+namespace {
+
+    struct ServedFile {
+        #if defined(OS_WINDOWS)
+        HANDLE handle = INVALID_HANDLE_VALUE;
+        #else
+        int handle = -1;
+        #endif
+
+        bool writable = false;
+    };
+
+    bool openFile(ServedFile &file, const char *path, bool writable) {
+        file.writable = writable;
+
+        #if defined(OS_WINDOWS)
+        file.handle = CreateFileA(path, GENERIC_READ | (writable ? GENERIC_WRITE : 0), FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        return file.handle != INVALID_HANDLE_VALUE;
+        #else
+        file.handle = open(path, writable ? O_RDWR : O_RDONLY);
+        return file.handle != -1;
+        #endif
+    }
+
+    u64 getFileSize(const ServedFile &file) {
+        #if defined(OS_WINDOWS)
+        LARGE_INTEGER size = { };
+        GetFileSizeEx(file.handle, &size);
+        return size.QuadPart;
+        #else
+        // Block devices report their size through seeking to the end, not through stat
+        auto size = lseek(file.handle, 0, SEEK_END);
+        return size < 0 ? 0 : size;
+        #endif
+    }
+
+    bool transfer(const ServedFile &file, u64 offset, u8 *buffer, u64 size, bool write) {
+        while (size > 0) {
+            #if defined(OS_WINDOWS)
+            OVERLAPPED overlapped = { };
+            overlapped.Offset = offset & 0xFFFF'FFFF;
+            overlapped.OffsetHigh = offset >> 32;
+
+            DWORD transferred = 0;
+            bool success = write ? WriteFile(file.handle, buffer, DWORD(size), &transferred, &overlapped) : ReadFile(file.handle, buffer, DWORD(size), &transferred, &overlapped);
+            if (!success || transferred == 0)
+                return false;
+            #else
+            auto transferred = write ? pwrite(file.handle, buffer, size, offset) : pread(file.handle, buffer, size, offset);
+            if (transferred <= 0)
+                return false;
+            #endif
+
+            offset += transferred;
+            buffer += transferred;
+            size -= transferred;
+        }
+
+        return true;
+    }
+
+    bool respond(remote::Socket socket, remote::Status status, const void *data, u64 size) {
+        u8 header[remote::ResponseHeaderSize];
+        remote::encodeResponse(header, status, size);
+
+        return remote::sendAll(socket, header, sizeof(header)) && (size == 0 || remote::sendAll(socket, data, size));
+    }
+
+    void serveClient(remote::Socket socket, const ServedFile &file) {
+        int noDelay = 1;
+        setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&noDelay), sizeof(noDelay));
+
+        std::vector<u8> buffer;
+        while (true) {
+            u8 request[remote::RequestHeaderSize];
+            if (!remote::receiveAll(socket, request, sizeof(request)))
+                return;
+
+            auto command = remote::Command(request[0]);
+            u64 offset = remote::decodeLE(request + 1, sizeof(u64));
+            u64 size = remote::decodeLE(request + 9, sizeof(u64));
+
+            switch (command) {
+                case remote::Command::Hello: {
+                    if (offset != remote::ProtocolMagic || size != remote::ProtocolVersion) {
+                        respond(socket, remote::Status::Error, nullptr, 0);
+                        return;
+                    }
+
+                    u8 information[sizeof(u64) + sizeof(u8)];
+                    remote::encodeLE(information, getFileSize(file), sizeof(u64));
+                    information[sizeof(u64)] = file.writable;
+
+                    if (!respond(socket, remote::Status::Ok, information, sizeof(information)))
+                        return;
+                    break;
+                }
+                case remote::Command::Read: {
+                    if (size > remote::MaximumTransferSize) {
+                        respond(socket, remote::Status::Error, nullptr, 0);
+                        return;
+                    }
+
+                    buffer.resize(size);
+                    bool success = offset + size <= getFileSize(file) && transfer(file, offset, buffer.data(), size, false);
+
+                    if (!(success ? respond(socket, remote::Status::Ok, buffer.data(), size) : respond(socket, remote::Status::Error, nullptr, 0)))
+                        return;
+                    break;
+                }
+                case remote::Command::Write: {
+                    // The data has to be received either way, otherwise it would be mistaken for the next request
+                    if (size > remote::MaximumTransferSize) {
+                        respond(socket, remote::Status::Error, nullptr, 0);
+                        return;
+                    }
+
+                    buffer.resize(size);
+                    if (!remote::receiveAll(socket, buffer.data(), size))
+                        return;
+
+                    bool success = file.writable && offset + size <= getFileSize(file) && transfer(file, offset, buffer.data(), size, true);
+
+                    if (!respond(socket, success ? remote::Status::Ok : remote::Status::Error, nullptr, 0))
+                        return;
+                    break;
+                }
+                case remote::Command::Size: {
+                    u8 fileSize[sizeof(u64)];
+                    remote::encodeLE(fileSize, getFileSize(file), sizeof(u64));
+
+                    if (!respond(socket, remote::Status::Ok, fileSize, sizeof(fileSize)))
+                        return;
+                    break;
+                }
+                default:
+                    return;
+            }
+        }
+    }
+
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        std::printf("Usage: %s <file> [port] [--writable]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    std::string port = std::to_string(remote::DefaultPort);
+    bool writable = false;
+    for (int i = 2; i < argc; i++) {
+        if (std::strcmp(argv[i], "--writable") == 0)
+            writable = true;
+        else
+            port = argv[i];
+    }
+
+    #if defined(OS_WINDOWS)
+    WSADATA wsaData;
+    WSAStartup(MAKEWORD(2, 2), &wsaData);
+    #endif
+
+    ServedFile file;
+    if (!openFile(file, argv[1], writable)) {
+        std::printf("Failed to open %s\n", argv[1]);
+        return EXIT_FAILURE;
+    }
+
+    addrinfo hints = { };
+    hints.ai_family = AF_INET6;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_PASSIVE;
+
+    // Listening on IPv6 with IPv4 mapped addresses enabled accepts both, plain IPv4 is the fallback
+    remote::Socket server = remote::InvalidSocket;
+    for (auto family : { AF_INET6, AF_INET }) {
+        hints.ai_family = family;
+
+        addrinfo *addresses = nullptr;
+        if (getaddrinfo(nullptr, port.c_str(), &hints, &addresses) != 0)
+            continue;
+
+        for (auto address = addresses; address != nullptr && server == remote::InvalidSocket; address = address->ai_next) {
+            server = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+            if (server == remote::InvalidSocket)
+                continue;
+
+            int enabled = 1, disabled = 0;
+            setsockopt(server, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&enabled), sizeof(enabled));
+            if (family == AF_INET6)
+                setsockopt(server, IPPROTO_IPV6, IPV6_V6ONLY, reinterpret_cast<const char*>(&disabled), sizeof(disabled));
+
+            if (bind(server, address->ai_addr, address->ai_addrlen) != 0 || listen(server, 1) != 0) {
+                remote::closeSocket(server);
+                server = remote::InvalidSocket;
+            }
+        }
+
+        freeaddrinfo(addresses);
+
+        if (server != remote::InvalidSocket)
+            break;
+    }
+
+    if (server == remote::InvalidSocket) {
+        std::printf("Failed to listen on port %s\n", port.c_str());
+        return EXIT_FAILURE;
+    }
+
+    std::printf("Serving %s (%llu bytes, %s) on port %s\n", argv[1], static_cast<unsigned long long>(getFileSize(file)), writable ? "writable" : "read-only", port.c_str());
+    std::fflush(stdout);
+
+    while (true) {
+        auto client = accept(server, nullptr, nullptr);
+        if (client == remote::InvalidSocket)
+            continue;
+
+        serveClient(client, file);
+        remote::closeSocket(client);
+    }
+}
\ No newline at end of file
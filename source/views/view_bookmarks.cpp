@@ -3,139 +3,289 @@
 #include <hex/providers/provider.hpp>
 #include "helpers/project_file_handler.hpp"
 
+#include <imgui_imhex_extensions.h>
+
+#include <algorithm>
+#include <cctype>
 #include <cstring>
 
 namespace hex {
 
+    namespace {
+
+        constexpr size_t PreviewSize = 10;
+
+        // Names and comments loaded from project files aren't null terminated
+        std::string_view getCString(const std::vector<char> &string) {
+            return { string.data(), ::strnlen(string.data(), string.size()) };
+        }
+
+        void setCString(std::vector<char> &string, std::string_view value) {
+            string.assign(value.begin(), value.end());
+            string.push_back(0x00);
+        }
+
+        bool containsIgnoreCase(std::string_view string, std::string_view part) {
+            return std::search(string.begin(), string.end(), part.begin(), part.end(), [](char left, char right) {
+                return std::tolower(left) == std::tolower(right);
+            }) != string.end();
+        }
+
+    }
+
     ViewBookmarks::ViewBookmarks() : View("hex.view.bookmarks.name") {
         View::subscribeEvent(Events::AddBookmark, [](auto userData) {
             auto bookmark = std::any_cast<ImHexApi::Bookmarks::Entry>(userData);
-            bookmark.comment.resize(0xF'FFFF);
 
             if (bookmark.name.empty()) {
-                bookmark.name.resize(64);
-                std::memset(bookmark.name.data(), 0x00, 64);
-                std::strcpy(bookmark.name.data(), hex::format("hex.view.bookmarks.default_title"_lang,
-                                                              bookmark.region.address,
-                                                              bookmark.region.address + bookmark.region.size - 1).c_str());
+                setCString(bookmark.name, hex::format("hex.view.bookmarks.default_title"_lang,
+                                                      bookmark.region.address,
+                                                      bookmark.region.address + bookmark.region.size - 1));
             }
 
-            if (bookmark.comment.empty())
-                std::memset(bookmark.comment.data(), 0x00, 0xF'FFFF);
-
             bookmark.color = ImGui::GetColorU32(ImGuiCol_Header);
 
             SharedData::bookmarkEntries.push_back(bookmark);
+            ImHexApi::Bookmarks::invalidate();
+            View::postEvent(Events::BookmarksChanged);
             ProjectFile::markDirty();
         });
 
-        View::subscribeEvent(Events::ProjectFileLoad, [](auto) {
+        View::subscribeEvent(Events::ProjectFileLoad, [this](auto) {
+            this->m_selectedBookmark = nullptr;
+
             SharedData::bookmarkEntries = ProjectFile::getBookmarks();
+            ImHexApi::Bookmarks::invalidate();
+            View::postEvent(Events::BookmarksChanged);
         });
         View::subscribeEvent(Events::ProjectFileStore, [](auto) {
             ProjectFile::setBookmarks(SharedData::bookmarkEntries);
         });
+
+        View::subscribeEvent(Events::BookmarksChanged, [this](auto) {
+            this->m_sortedBookmarksDirty = true;
+            this->m_previews.clear();
+        });
+        View::subscribeEvent(Events::DataChanged, [this](auto) {
+            this->m_previews.clear();
+        });
+        View::subscribeEvent(Events::ProviderChanged, [this](auto) {
+            this->m_previews.clear();
+        });
     }
 
     ViewBookmarks::~ViewBookmarks() {
         View::unsubscribeEvent(Events::AddBookmark);
         View::unsubscribeEvent(Events::ProjectFileLoad);
         View::unsubscribeEvent(Events::ProjectFileStore);
+        View::unsubscribeEvent(Events::BookmarksChanged);
+        View::unsubscribeEvent(Events::DataChanged);
+        View::unsubscribeEvent(Events::ProviderChanged);
     }
 
-    void ViewBookmarks::drawContent() {
-        if (ImGui::Begin(View::toWindowName("hex.view.bookmarks.name").c_str(), &this->getWindowOpenState())) {
-            if (ImGui::BeginChild("##scrolling")) {
+    void ViewBookmarks::updateSortedBookmarks(ImGuiTableSortSpecs *sortSpecs) {
+        this->m_sortedBookmarks.clear();
 
-                auto &bookmarks = ImHexApi::Bookmarks::getEntries();
+        for (auto &bookmark : ImHexApi::Bookmarks::getEntries()) {
+            if (this->m_filter.empty() || containsIgnoreCase(getCString(bookmark.name), this->m_filter) || containsIgnoreCase(getCString(bookmark.comment), this->m_filter))
+                this->m_sortedBookmarks.push_back(&bookmark);
+        }
 
-                if (bookmarks.empty()) {
-                    ImGui::NewLine();
-                    ImGui::Indent(30);
-                    ImGui::TextWrapped("%s", static_cast<const char*>("hex.view.bookmarks.no_bookmarks"_lang));
-                }
+        if (sortSpecs != nullptr && sortSpecs->SpecsCount > 0) {
+            const auto &spec = sortSpecs->Specs[0];
+            bool ascending = spec.SortDirection == ImGuiSortDirection_Ascending;
 
-                u32 id = 1;
-                auto bookmarkToRemove = bookmarks.end();
-                for (auto iter = bookmarks.begin(); iter != bookmarks.end(); iter++) {
-                    auto &[region, name, comment, color, locked] = *iter;
-
-                    auto headerColor = ImColor(color);
-                    auto hoverColor = ImColor(color);
-                    hoverColor.Value.w *= 1.3F;
-
-                    ImGui::PushID(id);
-                    ImGui::PushStyleColor(ImGuiCol_Header, color);
-                    ImGui::PushStyleColor(ImGuiCol_HeaderActive, color);
-                    ImGui::PushStyleColor(ImGuiCol_HeaderHovered, u32(hoverColor));
-                    if (ImGui::CollapsingHeader((std::string(name.data()) + "###" + std::to_string((u64)comment.data())).c_str())) {
-                        ImGui::TextUnformatted("hex.view.bookmarks.title.info"_lang);
-                        ImGui::Separator();
-                        ImGui::TextUnformatted(hex::format("hex.view.bookmarks.address"_lang, region.address, region.address + region.size - 1, region.size).c_str());
-
-                        {
-                            u8 bytes[10] = { 0 };
-                            (SharedData::currentProvider)->read(region.address, bytes, std::min(region.size, size_t(10)));
-
-                            std::string bytesString;
-                            for (u8 i = 0; i < std::min(region.size, size_t(10)); i++) {
-                                bytesString += hex::format("{0:02X} ", bytes[i]);
-                            }
-
-                            if (region.size > 10) {
-                                bytesString.pop_back();
-                                bytesString += "...";
-                            }
-
-                            ImGui::TextColored(ImColor(0xFF9BC64D), "%s", bytesString.c_str());
-                        }
-                        if (ImGui::Button("hex.view.bookmarks.button.jump"_lang))
-                            View::postEvent(Events::SelectionChangeRequest, region);
-                        ImGui::SameLine(0, 15);
+            bool byName = spec.ColumnUserID == ImGui::GetID("name");
+            bool bySize = spec.ColumnUserID == ImGui::GetID("size");
+
+            std::stable_sort(this->m_sortedBookmarks.begin(), this->m_sortedBookmarks.end(), [=](const Bookmark *left, const Bookmark *right) {
+                if (!ascending)
+                    std::swap(left, right);
+
+                if (byName)
+                    return getCString(left->name) < getCString(right->name);
+                else if (bySize)
+                    return left->region.size < right->region.size;
+                else
+                    return left->region.address < right->region.address;
+            });
+
+            sortSpecs->SpecsDirty = false;
+        }
+
+        this->m_sortedBookmarksDirty = false;
+    }
+
+    const std::string& ViewBookmarks::getPreview(const Bookmark &bookmark) {
+        auto [it, inserted] = this->m_previews.try_emplace(&bookmark);
+        if (!inserted)
+            return it->second;
+
+        auto provider = SharedData::currentProvider;
+        auto &preview = it->second;
+
+        if (provider != nullptr && provider->isReadable()) {
+            u8 bytes[PreviewSize] = { 0 };
+            auto size = std::min(bookmark.region.size, PreviewSize);
+            provider->read(bookmark.region.address, bytes, size);
+
+            for (u8 i = 0; i < size; i++)
+                preview += hex::format("{0:02X} ", bytes[i]);
+
+            if (bookmark.region.size > PreviewSize) {
+                preview.pop_back();
+                preview += "...";
+            }
+        }
+
+        return preview;
+    }
+
+    void ViewBookmarks::drawBookmarkList() {
+        ImGui::SetNextItemWidth(-1);
+        if (ImGui::InputText("##filter", this->m_filter))
+            this->m_sortedBookmarksDirty = true;
+
+        // The list shares the window with the details of the selected bookmark
+        float listHeight = this->m_selectedBookmark != nullptr ? ImGui::GetContentRegionAvail().y * 0.45F : 0.0F;
 
-                        if (ImGui::Button("hex.view.bookmarks.button.remove"_lang))
-                            bookmarkToRemove = iter;
-                        ImGui::SameLine(0, 15);
+        if (ImGui::BeginTable("##bookmarks", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_Resizable | ImGuiTableFlags_Sortable | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY, ImVec2(0, listHeight))) {
+            ImGui::TableSetupScrollFreeze(0, 1);
+            ImGui::TableSetupColumn("hex.view.bookmarks.header.name"_lang, 0, -1, ImGui::GetID("name"));
+            ImGui::TableSetupColumn("hex.common.address"_lang, ImGuiTableColumnFlags_DefaultSort, -1, ImGui::GetID("address"));
+            ImGui::TableSetupColumn("hex.common.size"_lang, 0, -1, ImGui::GetID("size"));
+            ImGui::TableSetupColumn("hex.view.bookmarks.header.preview"_lang, ImGuiTableColumnFlags_NoSort, -1, ImGui::GetID("preview"));
 
-                        if (locked) {
-                            if (ImGui::Button(ICON_FA_LOCK)) locked = false;
-                        } else {
-                            if (ImGui::Button(ICON_FA_UNLOCK)) locked = true;
-                        }
+            auto sortSpecs = ImGui::TableGetSortSpecs();
+            if (this->m_sortedBookmarksDirty || (sortSpecs != nullptr && sortSpecs->SpecsDirty))
+                this->updateSortedBookmarks(sortSpecs);
 
-                        ImGui::NewLine();
-                        ImGui::TextUnformatted("hex.view.bookmarks.header.name"_lang);
-                        ImGui::Separator();
+            ImGui::TableHeadersRow();
 
-                        ImGui::ColorEdit4("hex.view.bookmarks.header.color"_lang, (float*)&headerColor.Value, ImGuiColorEditFlags_NoInputs | ImGuiColorEditFlags_NoLabel | ImGuiColorEditFlags_NoAlpha | (locked ? ImGuiColorEditFlags_NoPicker : ImGuiColorEditFlags_None));
-                        color = headerColor;
-                        ImGui::SameLine();
+            ImGuiListClipper clipper;
+            clipper.Begin(this->m_sortedBookmarks.size());
 
-                        if (locked)
-                            ImGui::TextUnformatted(name.data());
-                        else
-                            ImGui::InputText("##nameInput", name.data(), 64);
+            while (clipper.Step()) {
+                for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
+                    auto bookmark = this->m_sortedBookmarks[i];
+                    const auto &[region, name, comment, color, locked] = *bookmark;
 
-                        ImGui::NewLine();
-                        ImGui::TextUnformatted("hex.view.bookmarks.header.comment"_lang);
-                        ImGui::Separator();
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+                    ImGui::PushID(bookmark);
 
-                        if (locked)
-                            ImGui::TextWrapped("%s", comment.data());
-                        else
-                            ImGui::InputTextMultiline("##commentInput", comment.data(), 0xF'FFFF);
+                    ImGui::ColorButton("##color", ImColor(color).Value, ImGuiColorEditFlags_NoTooltip | ImGuiColorEditFlags_NoDragDrop, ImVec2(ImGui::GetTextLineHeight(), ImGui::GetTextLineHeight()));
+                    ImGui::SameLine();
 
-                        ImGui::NewLine();
+                    auto label = getCString(name);
+                    if (ImGui::Selectable(std::string(label).c_str(), bookmark == this->m_selectedBookmark, ImGuiSelectableFlags_SpanAllColumns | ImGuiSelectableFlags_AllowDoubleClick)) {
+                        this->m_selectedBookmark = bookmark;
 
+                        if (ImGui::IsMouseDoubleClicked(ImGuiMouseButton_Left))
+                            View::postEvent(Events::SelectionChangeRequest, region);
                     }
                     ImGui::PopID();
-                    ImGui::PopStyleColor(3);
-                    id++;
+
+                    ImGui::TableNextColumn();
+                    ImGui::Text("0x%llX : 0x%llX", region.address, region.address + region.size - 1);
+                    ImGui::TableNextColumn();
+                    ImGui::Text("0x%lX", region.size);
+                    ImGui::TableNextColumn();
+                    ImGui::TextColored(ImColor(0xFF9BC64D), "%s", this->getPreview(*bookmark).c_str());
+                }
+            }
+
+            clipper.End();
+
+            ImGui::EndTable();
+        }
+    }
+
+    void ViewBookmarks::drawBookmarkDetails(Bookmark &bookmark) {
+        auto &[region, name, comment, color, locked] = bookmark;
+
+        ImGui::NewLine();
+        ImGui::TextUnformatted("hex.view.bookmarks.title.info"_lang);
+        ImGui::Separator();
+        ImGui::TextUnformatted(hex::format("hex.view.bookmarks.address"_lang, region.address, region.address + region.size - 1, region.size).c_str());
+
+        if (ImGui::Button("hex.view.bookmarks.button.jump"_lang))
+            View::postEvent(Events::SelectionChangeRequest, region);
+        ImGui::SameLine(0, 15);
+
+        if (ImGui::Button("hex.view.bookmarks.button.remove"_lang)) {
+            auto &bookmarks = ImHexApi::Bookmarks::getEntries();
+            bookmarks.remove_if([&bookmark](const auto &entry) { return &entry == &bookmark; });
+            this->m_selectedBookmark = nullptr;
+
+            ImHexApi::Bookmarks::invalidate();
+            View::postEvent(Events::BookmarksChanged);
+            ProjectFile::markDirty();
+            return;
+        }
+        ImGui::SameLine(0, 15);
+
+        if (locked) {
+            if (ImGui::Button(ICON_FA_LOCK)) locked = false;
+        } else {
+            if (ImGui::Button(ICON_FA_UNLOCK)) locked = true;
+        }
+
+        ImGui::NewLine();
+        ImGui::TextUnformatted("hex.view.bookmarks.header.name"_lang);
+        ImGui::Separator();
+
+        auto headerColor = ImColor(color);
+        if (ImGui::ColorEdit4("hex.view.bookmarks.header.color"_lang, (float*)&headerColor.Value, ImGuiColorEditFlags_NoInputs | ImGuiColorEditFlags_NoLabel | ImGuiColorEditFlags_NoAlpha | (locked ? ImGuiColorEditFlags_NoPicker : ImGuiColorEditFlags_None))) {
+            color = headerColor;
+            View::postEvent(Events::BookmarksChanged);
+        }
+        ImGui::SameLine();
+
+        // Only the selected bookmark gets edited, so its text is copied into growable strings instead of every bookmark owning huge buffers
+        std::string nameString(getCString(name));
+        if (locked)
+            ImGui::TextUnformatted(nameString.c_str());
+        else if (ImGui::InputText("##nameInput", nameString)) {
+            setCString(name, nameString);
+            this->m_sortedBookmarksDirty = true;
+            ProjectFile::markDirty();
+        }
+
+        ImGui::NewLine();
+        ImGui::TextUnformatted("hex.view.bookmarks.header.comment"_lang);
+        ImGui::Separator();
+
+        std::string commentString(getCString(comment));
+        if (locked)
+            ImGui::TextWrapped("%s", commentString.c_str());
+        else if (ImGui::InputTextMultiline("##commentInput", commentString)) {
+            setCString(comment, commentString);
+            ProjectFile::markDirty();
+        }
+    }
+
+    void ViewBookmarks::drawContent() {
+        if (ImGui::Begin(View::toWindowName("hex.view.bookmarks.name").c_str(), &this->getWindowOpenState())) {
+            if (ImGui::BeginChild("##scrolling")) {
+
+                auto provider = SharedData::currentProvider;
+                if (provider != this->m_lastProvider || (provider != nullptr && provider->getCurrentPage() != this->m_lastPage)) {
+                    this->m_previews.clear();
+
+                    this->m_lastProvider = provider;
+                    this->m_lastPage = provider != nullptr ? provider->getCurrentPage() : 0;
                 }
 
-                if (bookmarkToRemove != bookmarks.end()) {
-                    bookmarks.erase(bookmarkToRemove);
-                    ProjectFile::markDirty();
+                if (ImHexApi::Bookmarks::getEntries().empty()) {
+                    ImGui::NewLine();
+                    ImGui::Indent(30);
+                    ImGui::TextWrapped("%s", static_cast<const char*>("hex.view.bookmarks.no_bookmarks"_lang));
+                } else {
+                    this->drawBookmarkList();
+
+                    if (this->m_selectedBookmark != nullptr)
+                        this->drawBookmarkDetails(*this->m_selectedBookmark);
                 }
 
                 ImGui::EndChild();
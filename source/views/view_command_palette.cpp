@@ -1,10 +1,12 @@
 #include "views/view_command_palette.hpp"
 
+#include <hex/api/imhex_api.hpp>
+
 #include <GLFW/glfw3.h>
 
 namespace hex {
 
-    ViewCommandPalette::ViewCommandPalette() : View("hex.view.command_palette.name") {
+    ViewCommandPalette::ViewCommandPalette(std::vector<lang::PatternData*> &patternData) : View("hex.view.command_palette.name"), m_patternData(patternData) {
         this->m_commandBuffer.resize(1024, 0x00);
     }
 
@@ -39,6 +41,7 @@ namespace hex {
 
             if (this->m_justOpened) {
                 focusInputTextBox();
+                this->buildIndex();
                 this->m_lastResults = this->getCommandResults("");
                 std::memset(this->m_commandBuffer.data(), 0x00, this->m_commandBuffer.size());
                 this->m_justOpened = false;
@@ -80,6 +83,67 @@ namespace hex {
         return false;
     }
 
+    void ViewCommandPalette::buildIndex() {
+        this->m_indexedItems.clear();
+        this->m_index.clear();
+
+        const auto addItem = [this](std::string_view name, std::string display, std::function<void()> callback) {
+            this->m_index.add(name, this->m_indexedItems.size());
+            this->m_indexedItems.push_back({ std::move(display), std::move(callback) });
+        };
+
+        for (const auto &[type, command, unlocalizedDescription, displayCallback, executeCallback] : ContentRegistry::CommandPaletteCommands::getEntries()) {
+            auto completion = type == ContentRegistry::CommandPaletteCommands::Type::KeywordCommand ? command + " " : command;
+
+            addItem(command, command + " (" + LangEntry(unlocalizedDescription) + ")", [this, completion] {
+                focusInputTextBox();
+                std::strncpy(this->m_commandBuffer.data(), completion.c_str(), this->m_commandBuffer.size());
+                this->m_lastResults = this->getCommandResults(completion);
+            });
+        }
+
+        for (const auto &path : ContentRegistry::Settings::read("hex.builtin.setting.imhex", "hex.builtin.setting.imhex.recent_files")) {
+            addItem(path, path + " (" + LangEntry("hex.view.command_palette.file") + ")", [path] {
+                View::postEvent(Events::FileDropped, path.c_str());
+            });
+        }
+
+        for (const auto &bookmark : ImHexApi::Bookmarks::getEntries()) {
+            std::string name = bookmark.name.data();
+            auto region = bookmark.region;
+
+            addItem(name, name + " (" + LangEntry("hex.view.command_palette.bookmark") + ")", [region] {
+                View::postEvent(Events::SelectionChangeRequest, region);
+            });
+        }
+
+        for (auto &pattern : this->m_patternData)
+            this->indexPattern(pattern, pattern->getVariableName());
+
+        this->m_index.build();
+    }
+
+    void ViewCommandPalette::indexPattern(lang::PatternData *pattern, const std::string &path) {
+        Region region = { pattern->getOffset(), pattern->getSize() };
+        this->m_index.add(path, this->m_indexedItems.size());
+        this->m_indexedItems.push_back({ hex::format("{} : {} ({})", path, pattern->getTypeName(), LangEntry("hex.view.command_palette.pattern").get()), [region] {
+            View::postEvent(Events::SelectionChangeRequest, region);
+        } });
+
+        std::vector<lang::PatternData*> children;
+        if (auto structPattern = dynamic_cast<lang::PatternDataStruct*>(pattern); structPattern != nullptr)
+            children = structPattern->getMembers();
+        else if (auto unionPattern = dynamic_cast<lang::PatternDataUnion*>(pattern); unionPattern != nullptr)
+            children = unionPattern->getMembers();
+        else if (auto arrayPattern = dynamic_cast<lang::PatternDataArray*>(pattern); arrayPattern != nullptr)
+            children = arrayPattern->getEntries();
+
+        for (auto &child : children) {
+            const auto &name = child->getVariableName();
+            this->indexPattern(child, name.starts_with('[') ? path + name : path + "." + name);
+        }
+    }
+
     std::vector<ViewCommandPalette::CommandResult> ViewCommandPalette::getCommandResults(std::string_view input) {
         constexpr auto MatchCommand = [](std::string_view currCommand, std::string_view commandToMatch) -> std::pair<MatchType, std::string_view> {
             if (currCommand.empty()) {
@@ -131,6 +195,14 @@ namespace hex {
 
         }
 
+        // Inputs a command takes care of are left to it, anything else is looked up in the index
+        if (results.empty()) {
+            for (const auto &[id, score] : this->m_index.find(input, MaxIndexedResults)) {
+                const auto &item = this->m_indexedItems[id];
+                results.push_back({ item.displayResult, "", [&item](auto) { item.executeCallback(); } });
+            }
+        }
+
         return results;
     }
 
@@ -1,8 +1,13 @@
 #include "views/view_data_inspector.hpp"
 
+#include <hex/api/imhex_api.hpp>
 #include <hex/providers/provider.hpp>
 
+#include <imgui_imhex_extensions.h>
+
+#include <algorithm>
 #include <cstring>
+#include <span>
 
 extern int ImTextCharFromUtf8(unsigned int* out_char, const char* in_text, const char* in_text_end);
 
@@ -11,9 +16,7 @@ namespace hex {
     using NumberDisplayStyle = ContentRegistry::DataInspector::NumberDisplayStyle;
 
     ViewDataInspector::ViewDataInspector() : View("hex.view.data_inspector.name") {
-        View::subscribeEvent(Events::RegionSelected, [this](auto userData) {
-            auto region = std::any_cast<Region>(userData);
-
+        View::subscribeEvent<Region>(Events::RegionSelected, [this](const Region &region) {
             auto provider = SharedData::currentProvider;
 
             if (provider == nullptr) {
@@ -29,60 +32,224 @@ namespace hex {
             this->m_validBytes = u64(provider->getSize() - region.address);
             this->m_startAddress = region.address;
 
-            this->m_shouldInvalidate = true;
+            // Selected regions are page relative, the statistics are read with absolute addresses
+            this->m_selectionAddress = region.address + u64(provider->getCurrentPage()) * prv::Provider::PageSize;
+            this->m_selectionSize = region.size;
+            this->m_statisticsDirty = true;
+
+            this->invalidateContent();
+        });
+
+        View::subscribeEvent(Events::DataChanged, [this](auto) {
+            this->m_statisticsDirty = true;
         });
     }
 
     ViewDataInspector::~ViewDataInspector() {
+        this->m_statisticsTask.interrupt();
+        this->m_statisticsTask.wait();
+
         View::unsubscribeEvent(Events::RegionSelected);
+        View::unsubscribeEvent(Events::DataChanged);
     }
 
-    void ViewDataInspector::drawContent() {
-        if (this->m_shouldInvalidate) {
-            this->m_shouldInvalidate = false;
+    /* Reads the bytes all entries need at once, every entry then formats its value from the part it requires */
+    void ViewDataInspector::updateValues() {
+        auto provider = SharedData::currentProvider;
+        const auto &entries = ContentRegistry::DataInspector::getEntries();
 
-            this->m_cachedData.clear();
-            auto provider = SharedData::currentProvider;
-            for (auto &entry : ContentRegistry::DataInspector::getEntries()) {
-                if (this->m_validBytes < entry.requiredSize)
-                    continue;
+        this->m_cachedData.resize(entries.size());
+
+        size_t readSize = std::min<size_t>(this->m_validBytes, this->m_buffer.size());
+        if (provider != nullptr && readSize > 0)
+            provider->read(this->m_startAddress, this->m_buffer.data(), readSize);
+
+        for (size_t i = 0; i < entries.size(); i++) {
+            auto &cachedEntry = this->m_cachedData[i];
+
+            cachedEntry.valid = provider != nullptr && this->m_validBytes >= entries[i].requiredSize;
+            if (!cachedEntry.valid)
+                continue;
+
+            cachedEntry.value.clear();
+            entries[i].formatFunction(std::span(this->m_buffer.data(), entries[i].requiredSize), this->m_endian, this->m_numberDisplayStyle, cachedEntry.value);
+        }
+    }
+
+    void ViewDataInspector::startStatistics() {
+        this->m_statisticsTask.interrupt();
+        this->m_statisticsTask.wait();
 
-                std::vector<u8> buffer(entry.requiredSize);
-                provider->read(this->m_startAddress, buffer.data(), buffer.size());
+        this->m_statisticsDirty = false;
+        this->m_statisticsDone = false;
+        this->m_statisticsBytes = 0;
+        this->m_statistics.clear();
+        this->m_statisticsRows.clear();
 
-                this->m_cachedData.push_back({ entry.unlocalizedName, entry.generatorFunction(buffer, this->m_endian, this->m_numberDisplayStyle) });
+        if (SharedData::currentProvider == nullptr || this->m_selectionSize == 0)
+            return;
+
+        // Every entry that decodes a plain number gets its statistics, in the order the entries were registered
+        const auto &entries = ContentRegistry::DataInspector::getEntries();
+        std::vector<u32> entryIndices;
+        std::vector<ValueType> types;
+        for (u32 i = 0; i < entries.size(); i++) {
+            if (entries[i].valueType.has_value()) {
+                entryIndices.push_back(i);
+                types.push_back(*entries[i].valueType);
             }
         }
 
+        this->m_statisticsTask = TaskManager::createTask("hex.view.data_inspector.statistics.calculating", 0,
+            [this, handle = ImHexApi::Provider::getHandle(), address = this->m_selectionAddress, size = this->m_selectionSize, endian = this->m_endian,
+             entryIndices = std::move(entryIndices), types = std::move(types)](Task &task) mutable {
+            auto statistics = ValueStatisticsCalculator::calculate(handle.get(), address, size, types, endian, task.getInterruptFlag(), &this->m_statisticsBytes);
+
+            if (task.isInterrupted())
+                return;
+
+            this->m_statisticsEntries = std::move(entryIndices);
+            this->m_statistics = std::move(statistics);
+            this->m_statisticsRowsDirty = true;
+            this->m_statisticsDone = true;
+        });
+    }
+
+    void ViewDataInspector::updateStatisticsRows() {
+        this->m_statisticsRows.clear();
+
+        for (size_t i = 0; i < this->m_statistics.size() && i < this->m_statisticsEntries.size(); i++) {
+            const auto &statistics = this->m_statistics[i];
+            if (statistics.count == 0)
+                continue;
+
+            auto &row = this->m_statisticsRows.emplace_back();
+            row.entry = this->m_statisticsEntries[i];
+
+            auto formatNumber = [this](const ValueStatistics::Number &number, std::string &string) {
+                std::visit([&](auto value) {
+                    if constexpr (std::is_floating_point_v<decltype(value)>)
+                        hex::formatTo(string, "{0:E}", value);
+                    else {
+                        switch (this->m_numberDisplayStyle) {
+                            case NumberDisplayStyle::Decimal:       hex::formatTo(string, "{0:d}", value);  break;
+                            case NumberDisplayStyle::Hexadecimal:   hex::formatTo(string, "0x{0:X}", value); break;
+                            case NumberDisplayStyle::Octal:         hex::formatTo(string, "{0:#o}", value); break;
+                        }
+                    }
+                }, number);
+            };
 
+            formatNumber(statistics.minimum, row.minimum);
+            formatNumber(statistics.maximum, row.maximum);
+            hex::formatTo(row.mean, "{0:G}", statistics.mean);
+
+            std::transform(statistics.histogram.begin(), statistics.histogram.end(), row.histogram.begin(), [](u64 count) { return float(count); });
+        }
+
+        this->m_statisticsRowsDirty = false;
+    }
+
+    void ViewDataInspector::drawStatistics() {
+        if (this->m_statisticsDirty)
+            this->startStatistics();
+
+        if (this->m_statisticsTask.isRunning()) {
+            // Both passes read the whole selection
+            float progress = this->m_selectionSize == 0 ? 1.0F : float(this->m_statisticsBytes) / (this->m_selectionSize * 2.0F);
+
+            ImGui::TextSpinner("hex.view.data_inspector.statistics.calculating"_lang);
+            ImGui::ProgressBar(std::min(progress, 1.0F), ImVec2(200, 0));
+            return;
+        }
+
+        if (!this->m_statisticsDone)
+            return;
+
+        if (this->m_statisticsRowsDirty)
+            this->updateStatisticsRows();
+
+        ImGui::TextUnformatted(hex::format("hex.view.data_inspector.statistics.region"_lang, this->m_selectionAddress, this->m_selectionAddress + this->m_selectionSize - 1, this->m_selectionSize).c_str());
+
+        if (ImGui::BeginTable("##statistics", 5,
+            ImGuiTableFlags_ScrollY | ImGuiTableFlags_Borders | ImGuiTableFlags_Resizable | ImGuiTableFlags_RowBg,
+            ImVec2(0, ImGui::GetTextLineHeightWithSpacing() * 2 * (this->m_statisticsRows.size() + 1)))) {
+            ImGui::TableSetupScrollFreeze(0, 1);
+            ImGui::TableSetupColumn("hex.view.data_inspector.table.name"_lang);
+            ImGui::TableSetupColumn("hex.view.data_inspector.statistics.minimum"_lang);
+            ImGui::TableSetupColumn("hex.view.data_inspector.statistics.maximum"_lang);
+            ImGui::TableSetupColumn("hex.view.data_inspector.statistics.mean"_lang);
+            ImGui::TableSetupColumn("hex.view.data_inspector.statistics.histogram"_lang);
+
+            ImGui::TableHeadersRow();
+
+            const auto &entries = ContentRegistry::DataInspector::getEntries();
+            for (const auto &row : this->m_statisticsRows) {
+                if (row.entry >= entries.size())
+                    continue;
+
+                ImGui::PushID(row.entry);
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(LangEntry(entries[row.entry].unlocalizedName));
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(row.minimum.c_str());
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(row.maximum.c_str());
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(row.mean.c_str());
+                ImGui::TableNextColumn();
+                ImGui::PlotHistogram("##histogram", row.histogram.data(), row.histogram.size(), 0, nullptr, 0.0F, FLT_MAX,
+                                     ImVec2(-1, ImGui::GetTextLineHeightWithSpacing() * 2 - ImGui::GetStyle().CellPadding.y * 2));
+                ImGui::PopID();
+            }
+
+            ImGui::EndTable();
+        }
+    }
+
+    void ViewDataInspector::drawContent() {
         if (ImGui::Begin(View::toWindowName("hex.view.data_inspector.name").c_str(), &this->getWindowOpenState(), ImGuiWindowFlags_NoCollapse)) {
+            // Selecting bytes while the inspector is hidden only invalidates the values, they're formatted once it's shown again
+            this->refreshContent([this] { this->updateValues(); });
+
             auto provider = SharedData::currentProvider;
 
             if (provider != nullptr && provider->isReadable()) {
-                if (ImGui::BeginTable("##datainspector", 2,
+                if (this->m_selectionMode)
+                    this->drawStatistics();
+                else if (ImGui::BeginTable("##datainspector", 2,
                     ImGuiTableFlags_ScrollY | ImGuiTableFlags_Borders | ImGuiTableFlags_Resizable | ImGuiTableFlags_RowBg,
-                    ImVec2(0, ImGui::GetTextLineHeightWithSpacing() * (this->m_cachedData.size() + 1)))) {
+                    ImVec2(0, ImGui::GetTextLineHeightWithSpacing() * (std::count_if(this->m_cachedData.begin(), this->m_cachedData.end(), [](const auto &entry) { return entry.valid; }) + 1)))) {
                     ImGui::TableSetupScrollFreeze(0, 1);
                     ImGui::TableSetupColumn("hex.view.data_inspector.table.name"_lang);
                     ImGui::TableSetupColumn("hex.view.data_inspector.table.value"_lang);
 
                     ImGui::TableHeadersRow();
 
-                    u32 i = 0;
-                    for (const auto &[unlocalizedName, function] : this->m_cachedData) {
+                    const auto &entries = ContentRegistry::DataInspector::getEntries();
+                    for (u32 i = 0; i < this->m_cachedData.size() && i < entries.size(); i++) {
+                        const auto &[valid, value] = this->m_cachedData[i];
+                        if (!valid)
+                            continue;
+
+                        const auto &entry = entries[i];
+
                         ImGui::PushID(i);
                         ImGui::TableNextRow();
                         ImGui::TableNextColumn();
-                        ImGui::TextUnformatted(LangEntry(unlocalizedName));
+                        ImGui::TextUnformatted(LangEntry(entry.unlocalizedName));
                         ImGui::TableNextColumn();
-                        const auto &copyValue = function();
+                        if (entry.drawFunction)
+                            entry.drawFunction(std::span(this->m_buffer.data(), entry.requiredSize), this->m_endian, value);
+                        else
+                            ImGui::TextUnformatted(value.c_str());
                         ImGui::SameLine();
                         if (ImGui::Selectable("##InspectorLine", false, ImGuiSelectableFlags_SpanAllColumns | ImGuiSelectableFlags_AllowItemOverlap)) {
-                            ImGui::SetClipboardText(copyValue.c_str());
+                            ImGui::SetClipboardText(value.c_str());
                         }
 
                         ImGui::PopID();
-                        i++;
                     }
 
                     ImGui::EndTable();
@@ -92,27 +259,39 @@ namespace hex {
 
                 if (ImGui::RadioButton("hex.common.little_endian"_lang, this->m_endian == std::endian::little)) {
                     this->m_endian = std::endian::little;
-                    this->m_shouldInvalidate = true;
+                    this->m_statisticsDirty = true;
+                    this->invalidateContent();
                 }
                 ImGui::SameLine();
                 if (ImGui::RadioButton("hex.common.big_endian"_lang, this->m_endian == std::endian::big)) {
                     this->m_endian = std::endian::big;
-                    this->m_shouldInvalidate = true;
+                    this->m_statisticsDirty = true;
+                    this->invalidateContent();
                 }
 
                 if (ImGui::RadioButton("hex.common.decimal"_lang, this->m_numberDisplayStyle == NumberDisplayStyle::Decimal)) {
                     this->m_numberDisplayStyle = NumberDisplayStyle::Decimal;
-                    this->m_shouldInvalidate = true;
+                    this->m_statisticsRowsDirty = true;
+                    this->invalidateContent();
                 }
                 ImGui::SameLine();
                 if (ImGui::RadioButton("hex.common.hexadecimal"_lang, this->m_numberDisplayStyle == NumberDisplayStyle::Hexadecimal)) {
                     this->m_numberDisplayStyle = NumberDisplayStyle::Hexadecimal;
-                    this->m_shouldInvalidate = true;
+                    this->m_statisticsRowsDirty = true;
+                    this->invalidateContent();
                 }
                 ImGui::SameLine();
                 if (ImGui::RadioButton("hex.common.octal"_lang, this->m_numberDisplayStyle == NumberDisplayStyle::Octal)) {
                     this->m_numberDisplayStyle = NumberDisplayStyle::Octal;
-                    this->m_shouldInvalidate = true;
+                    this->m_statisticsRowsDirty = true;
+                    this->invalidateContent();
+                }
+
+                if (ImGui::Checkbox("hex.view.data_inspector.selection"_lang, &this->m_selectionMode)) {
+                    if (this->m_selectionMode)
+                        this->m_statisticsDirty = true;
+                    else
+                        this->m_statisticsTask.interrupt();
                 }
             }
         }
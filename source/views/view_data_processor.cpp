@@ -1,9 +1,17 @@
 #include "views/view_data_processor.hpp"
 
+#include <hex/api/imhex_api.hpp>
 #include <hex/providers/provider.hpp>
 
 #include <imnodes.h>
 
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <set>
+
 namespace hex {
 
     ViewDataProcessor::ViewDataProcessor() : View("hex.view.data_processor.name") {
@@ -38,15 +46,32 @@ namespace hex {
             }
         });
 
-        View::subscribeEvent(Events::FileLoaded, [this](auto) {
+        View::subscribeEvent(Events::ProviderChanged, [this](auto) {
+            this->waitForProcessing();
+
             for (auto &node : this->m_nodes) {
                 node->setCurrentOverlay(nullptr);
+                node->markDirty();
             }
             this->m_dataOverlays.clear();
+            this->m_previewedNodes.clear();
+
+            this->publishResults();
+        });
+
+        View::subscribeEvent(Events::DataChanged, [this](auto) {
+            for (auto &node : this->m_nodes)
+                node->markDirty();
         });
     }
 
     ViewDataProcessor::~ViewDataProcessor() {
+        View::unsubscribeEvent(Events::SettingsChanged);
+        View::unsubscribeEvent(Events::ProviderChanged);
+        View::unsubscribeEvent(Events::DataChanged);
+
+        this->waitForProcessing();
+
         for (auto &node : this->m_nodes)
             delete node;
 
@@ -57,6 +82,9 @@ namespace hex {
 
 
     void ViewDataProcessor::eraseLink(u32 id) {
+        this->waitForProcessing();
+        this->publishResults();
+
         auto link = std::find_if(this->m_links.begin(), this->m_links.end(), [&id](auto link){ return link.getID() == id; });
 
         if (link == this->m_links.end())
@@ -64,6 +92,9 @@ namespace hex {
 
         for (auto &node : this->m_nodes) {
             for (auto &attribute : node->getAttributes()) {
+                if (attribute.getIOType() == dp::Attribute::IOType::In && attribute.getConnectedAttributes().contains(id))
+                    node->markDirty();
+
                 attribute.removeConnectedAttribute(id);
             }
         }
@@ -72,6 +103,9 @@ namespace hex {
     }
 
     void ViewDataProcessor::eraseNodes(const std::vector<int> &ids) {
+        this->waitForProcessing();
+        this->publishResults();
+
         for (const int id : ids) {
             auto node = std::find_if(this->m_nodes.begin(), this->m_nodes.end(), [&id](auto node){ return node->getID() == id; });
 
@@ -89,6 +123,7 @@ namespace hex {
             auto node = std::find_if(this->m_nodes.begin(), this->m_nodes.end(), [&id](auto node){ return node->getID() == id; });
 
             std::erase_if(this->m_endNodes, [&id](auto node){ return node->getID() == id; });
+            this->m_previewedNodes.erase(*node);
 
             delete *node;
 
@@ -97,6 +132,21 @@ namespace hex {
     }
 
     void ViewDataProcessor::processNodes() {
+        if (this->m_processingTask.isRunning()) {
+            // Scrolling away from the previewed data drops the full run so the data that's visible now gets previewed first
+            if (this->m_job.background && this->m_previewMode && this->m_lastPreviewRegion.has_value()) {
+                auto visible = SharedData::hexEditorVisibleRegion;
+                auto preview = *this->m_lastPreviewRegion;
+
+                if (visible.address < preview.address || visible.address + visible.size > preview.address + preview.size)
+                    this->m_processingTask.interrupt();
+            }
+
+            return;
+        }
+
+        this->publishResults();
+
         if (this->m_dataOverlays.size() != this->m_endNodes.size()) {
             for (auto overlay : this->m_dataOverlays)
                 SharedData::currentProvider->deleteOverlay(overlay);
@@ -108,28 +158,313 @@ namespace hex {
             u32 overlayIndex = 0;
             for (auto endNode : this->m_endNodes) {
                 endNode->setCurrentOverlay(this->m_dataOverlays[overlayIndex]);
+                endNode->markDirty();
                 overlayIndex++;
             }
         }
 
-        this->m_currNodeError.reset();
+        // Order every node that feeds into an end node so it comes after all nodes connected to its inputs
+        std::vector<dp::Node*> order;
+        std::set<dp::Node*> visited;
+
+        auto visit = [&](auto &&visit, dp::Node *node) -> void {
+            // Also stops at nodes that are still being visited, they're part of a cycle
+            if (visited.contains(node))
+                return;
+            visited.insert(node);
+
+            for (auto &attribute : node->getAttributes()) {
+                if (attribute.getIOType() != dp::Attribute::IOType::In)
+                    continue;
+
+                for (auto &[linkId, connectedAttribute] : attribute.getConnectedAttributes())
+                    visit(visit, connectedAttribute->getParentNode());
+            }
+
+            order.push_back(node);
+        };
+
+        for (auto &endNode : this->m_endNodes)
+            visit(visit, endNode);
+
+        // The output of a streamable node may be fused into the next one if it only goes to that node's streamed input, nothing else ever sees the data in between
+        auto getStreamSuccessor = [&](dp::Node *node) -> dp::Node* {
+            auto stream = node->getStream();
+            if (!stream.has_value() || !stream->output.has_value())
+                return nullptr;
+
+            auto &attributes = node->getAttributes();
+            for (u32 i = 0; i < attributes.size(); i++) {
+                if (attributes[i].getIOType() == dp::Attribute::IOType::Out && i != *stream->output && !attributes[i].getConnectedAttributes().empty())
+                    return nullptr;
+            }
+
+            auto &connectedAttributes = attributes[*stream->output].getConnectedAttributes();
+            if (connectedAttributes.size() != 1)
+                return nullptr;
+
+            auto connectedAttribute = connectedAttributes.begin()->second;
+            auto next = connectedAttribute->getParentNode();
+            if (!visited.contains(next))
+                return nullptr;
+
+            auto nextStream = next->getStream();
+            if (!nextStream.has_value() || !nextStream->input.has_value() || &next->getAttributes()[*nextStream->input] != connectedAttribute)
+                return nullptr;
+
+            return next;
+        };
+
+        // Linear chains starting at a stream source run as one step that passes the data through all of their nodes block by block
+        std::map<dp::Node*, std::vector<dp::Node*>> chains;
+        std::set<dp::Node*> chainedNodes;
+
+        for (auto node : order) {
+            auto stream = node->getStream();
+            if (!stream.has_value() || stream->input.has_value())
+                continue;
 
-        try {
-            for (auto &endNode : this->m_endNodes) {
-                endNode->resetOutputData();
-                endNode->process();
+            std::vector<dp::Node*> chain = { node };
+            while (auto next = getStreamSuccessor(chain.back())) {
+                if (std::find(chain.begin(), chain.end(), next) != chain.end())
+                    break;
+
+                chain.push_back(next);
             }
-        } catch (dp::Node::NodeError &e) {
-            this->m_currNodeError = e;
-        } catch (std::runtime_error &e) {
-            printf("Node implementation bug! %s\n", e.what());
+
+            if (chain.size() < 2)
+                continue;
+
+            chainedNodes.insert(chain.begin(), chain.end());
+            chains[chain.back()] = std::move(chain);
+        }
+
+        // Chains that only got processed around the visible data get processed fully once nothing else changed anymore
+        bool background = false;
+        if (std::none_of(order.begin(), order.end(), [](auto node) { return node->isDirty(); }) && !this->m_previewedNodes.empty()) {
+            for (auto node : this->m_previewedNodes)
+                node->markDirty();
+
+            this->m_previewedNodes.clear();
+            background = true;
         }
 
+        // Every node gets processed at most once, and only if it or one of the nodes it reads from changed
+        ProcessingJob job;
+        std::map<dp::Node*, size_t> jobIndices;
+
+        job.background = background;
+        if (this->m_previewMode && !background) {
+            constexpr static u64 PreviewMargin = 0x1'0000;
+
+            auto visible = SharedData::hexEditorVisibleRegion;
+            u64 start = visible.address > PreviewMargin ? visible.address - PreviewMargin : 0;
+
+            job.previewRegion = Region { start, (visible.address - start) + visible.size + PreviewMargin };
+        }
+
+        for (auto node : order) {
+            // Fused chains are placed where their last node is, all nodes they read from come before that
+            std::vector<dp::Node*> step;
+            if (auto chain = chains.find(node); chain != chains.end())
+                step = chain->second;
+            else if (!chainedNodes.contains(node))
+                step = { node };
+            else
+                continue;
+
+            bool dirty = false;
+            std::vector<size_t> inputs;
+            for (auto member : step) {
+                // A node that only streamed its output last time needs to produce it again if anything reads it now
+                if (member->isDirty() || (member == step.back() && member->isOutputStreamed()))
+                    dirty = true;
+
+                for (auto &attribute : member->getAttributes()) {
+                    if (attribute.getIOType() != dp::Attribute::IOType::In)
+                        continue;
+
+                    for (auto &[linkId, connectedAttribute] : attribute.getConnectedAttributes()) {
+                        auto inputNode = connectedAttribute->getParentNode();
+                        if (std::find(step.begin(), step.end(), inputNode) != step.end())
+                            continue;
+
+                        if (auto input = jobIndices.find(inputNode); input != jobIndices.end())
+                            inputs.push_back(input->second);
+                    }
+                }
+            }
+
+            if (!dirty && inputs.empty())
+                continue;
+
+            auto index = job.steps.size();
+
+            job.dependents.emplace_back();
+            job.pendingInputs.push_back(inputs.size());
+
+            for (auto input : inputs)
+                job.dependents[input].push_back(index);
+
+            for (auto member : step) {
+                jobIndices[member] = index;
+
+                // Changes made while the job is running mark the node dirty again so it gets picked up by the next one
+                member->clearDirty();
+                member->setOutputStreamed(member != step.back());
+            }
+
+            job.windowed.push_back(job.previewRegion.has_value() && step.size() > 1 && dp::Node::isStreamWindowable(step));
+            job.steps.push_back(std::move(step));
+        }
+
+        if (job.steps.empty())
+            return;
+
+        job.processed.resize(job.steps.size(), false);
+
+        job.provider = ImHexApi::Provider::getHandle();
+        for (auto &step : job.steps) {
+            for (auto node : step)
+                node->setProvider(job.provider.get());
+        }
+
+        this->m_job = std::move(job);
+        this->m_jobPending = true;
+
+        this->m_processingTask = TaskManager::createTask("hex.view.data_processor.processing", this->m_job.steps.size(), [this](auto &task) {
+            this->runJob(task);
+        });
+    }
+
+    /*
+        Runs the steps of the current job on all cores. A step is started as soon as all steps it reads from are done,
+        so independent branches of the graph get processed in parallel
+    */
+    void ViewDataProcessor::runJob(Task &task) {
+        auto &job = this->m_job;
+
+        std::mutex queueMutex;
+        std::condition_variable queueCondition;
+        std::deque<size_t> readyNodes;
+        u32 runningNodes = 0;
+        u64 finishedNodes = 0;
+
+        for (size_t i = 0; i < job.steps.size(); i++) {
+            if (job.pendingInputs[i] == 0)
+                readyNodes.push_back(i);
+        }
+
+        auto worker = [&] {
+            std::unique_lock lock(queueMutex);
+
+            while (true) {
+                queueCondition.wait(lock, [&] { return !readyNodes.empty() || runningNodes == 0; });
+
+                // An interrupted job just stops, nodes that didn't get processed stay dirty for the next one
+                if (readyNodes.empty() || task.isInterrupted())
+                    break;
+
+                auto index = readyNodes.front();
+                readyNodes.pop_front();
+                runningNodes++;
+
+                lock.unlock();
+
+                bool failed = true, completed = true;
+                std::optional<dp::Node::NodeError> error;
+                try {
+                    auto &step = job.steps[index];
+                    if (step.size() == 1)
+                        step.front()->process();
+                    else
+                        completed = dp::Node::processStream(step, job.windowed[index] ? job.previewRegion : std::nullopt, [&task] { return task.isInterrupted(); });
+                    failed = false;
+                } catch (dp::Node::NodeError &e) {
+                    error = e;
+                } catch (std::runtime_error &e) {
+                    printf("Node implementation bug! %s\n", e.what());
+                }
+
+                lock.lock();
+                runningNodes--;
+                task.update(++finishedNodes);
+
+                if (failed) {
+                    // Don't start anything new, nodes already running still get to finish
+                    if (!job.error.has_value())
+                        job.error = error;
+
+                    readyNodes.clear();
+                    job.failed = true;
+                } else if (!job.failed && completed) {
+                    job.processed[index] = true;
+
+                    for (auto dependent : job.dependents[index]) {
+                        if (--job.pendingInputs[dependent] == 0)
+                            readyNodes.push_back(dependent);
+                    }
+                }
+
+                queueCondition.notify_all();
+            }
+        };
+
+        TaskManager::runParallel(std::min<size_t>(TaskManager::getWorkerCount(), job.steps.size()), [&](u32) { worker(); });
+    }
+
+    void ViewDataProcessor::waitForProcessing() {
+        // Full runs in the background are never waited for, they get started again after whatever changes next got previewed
+        if (this->m_job.background)
+            this->m_processingTask.interrupt();
+
+        this->m_processingTask.wait();
+    }
+
+    void ViewDataProcessor::publishResults() {
+        if (this->m_processingTask.isRunning() || !this->m_jobPending)
+            return;
+
+        this->m_jobPending = false;
+
+        if (this->m_job.failed)
+            this->m_currNodeError = this->m_job.error;
+        else
+            this->m_currNodeError.reset();
+
+        // Overlays are only touched from here so the hex editor never sees half written data
+        for (size_t i = 0; i < this->m_job.steps.size(); i++) {
+            for (auto node : this->m_job.steps[i]) {
+                if (!this->m_job.processed[i]) {
+                    node->markDirty();
+                    continue;
+                }
+
+                node->publishOverlayData();
+
+                if (this->m_job.windowed[i])
+                    this->m_previewedNodes.insert(node);
+                else
+                    this->m_previewedNodes.erase(node);
+            }
+        }
+
+        if (this->m_job.previewRegion.has_value())
+            this->m_lastPreviewRegion = this->m_job.previewRegion;
+
+        this->m_job = { };
     }
 
     void ViewDataProcessor::drawContent() {
         if (ImGui::Begin(View::toWindowName("hex.view.data_processor.name").c_str(), &this->getWindowOpenState(), ImGuiWindowFlags_NoCollapse)) {
 
+            ImGui::Checkbox("hex.view.data_processor.preview"_lang, &this->m_previewMode);
+            if (ImGui::IsItemHovered()) {
+                ImGui::BeginTooltip();
+                ImGui::TextUnformatted("hex.view.data_processor.preview.tooltip"_lang);
+                ImGui::EndTooltip();
+            }
+
             if (ImGui::IsMouseReleased(ImGuiMouseButton_Right) && ImGui::IsWindowHovered(ImGuiHoveredFlags_ChildWindows)) {
                 imnodes::ClearNodeSelection();
                 imnodes::ClearLinkSelection();
@@ -165,23 +500,28 @@ namespace hex {
                     }
                 }
 
+                // Creating a node can load a plugin which changes the entries, so it only happens once they're not used anymore
+                ContentRegistry::DataProcessorNode::CreatorFunction creatorFunction;
                 for (const auto &[category, name, function] : ContentRegistry::DataProcessorNode::getEntries()) {
                     if (category.empty() && name.empty()) {
                         ImGui::Separator();
                     } else if (category.empty()) {
                         if (ImGui::MenuItem(name.c_str())) {
-                            node = function();
+                            creatorFunction = function;
                         }
                     } else {
                         if (ImGui::BeginMenu(category.c_str())) {
                             if (ImGui::MenuItem(name.c_str())) {
-                                node = function();
+                                creatorFunction = function;
                             }
                             ImGui::EndMenu();
                         }
                     }
                 }
 
+                if (creatorFunction)
+                    node = creatorFunction();
+
                 if (node != nullptr) {
                     this->m_nodes.push_back(node);
 
@@ -310,10 +650,17 @@ namespace hex {
                         if (!toAttr->getConnectedAttributes().empty())
                             break;
 
+                        this->waitForProcessing();
+
                         auto newLink = this->m_links.emplace_back(from, to);
 
                         fromAttr->addConnectedAttribute(newLink.getID(), toAttr);
                         toAttr->addConnectedAttribute(newLink.getID(), fromAttr);
+
+                        if (toAttr->getIOType() == dp::Attribute::IOType::In)
+                            toAttr->getParentNode()->markDirty();
+                        else
+                            fromAttr->getParentNode()->markDirty();
                     } while (false);
 
                 }
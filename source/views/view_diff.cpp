@@ -0,0 +1,238 @@
+#include "views/view_diff.hpp"
+
+#include <hex/api/imhex_api.hpp>
+#include <hex/providers/provider.hpp>
+#include <hex/helpers/utils.hpp>
+
+#include "providers/file_provider.hpp"
+
+#include <imgui_imhex_extensions.h>
+
+namespace hex {
+
+    namespace {
+
+        constexpr auto HighlightName = "hex.view.diff.name";
+
+        u32 getDifferenceColor(BinaryDiffer::DifferenceType type) {
+            switch (type) {
+                case BinaryDiffer::DifferenceType::Inserted:    return IM_COL32(0x40, 0xC0, 0x40, 0xFF);
+                case BinaryDiffer::DifferenceType::Removed:     return IM_COL32(0xE0, 0x40, 0x40, 0xFF);
+                default:                                        return IM_COL32(0xE0, 0xA0, 0x30, 0xFF);
+            }
+        }
+
+        const char* getDifferenceName(BinaryDiffer::DifferenceType type) {
+            switch (type) {
+                case BinaryDiffer::DifferenceType::Inserted:    return "hex.view.diff.type.inserted"_lang;
+                case BinaryDiffer::DifferenceType::Removed:     return "hex.view.diff.type.removed"_lang;
+                default:                                        return "hex.view.diff.type.changed"_lang;
+            }
+        }
+
+    }
+
+    ViewDiff::ViewDiff() : View("hex.view.diff.name") {
+        // Differences are only shown for the provider they were found in
+        View::subscribeEvent(Events::ProviderChanged, [this](auto) {
+            this->cancelDiff();
+
+            this->m_differences.clear();
+            this->m_selectedDifference.reset();
+            ImHexApi::Highlighting::clear(HighlightName);
+        });
+
+        View::subscribeEvent(Events::DataChanged, [this](auto) {
+            if (!this->m_differences.empty() || this->m_diffTask.isRunning())
+                this->m_outdated = true;
+        });
+    }
+
+    ViewDiff::~ViewDiff() {
+        this->cancelDiff();
+
+        View::unsubscribeEvent(Events::ProviderChanged);
+        View::unsubscribeEvent(Events::DataChanged);
+    }
+
+    void ViewDiff::openCompareFile(const std::string &path) {
+        this->cancelDiff();
+
+        auto provider = std::make_shared<prv::FileProvider>(path, true);
+        if (!provider->isAvailable() || !provider->isReadable()) {
+            View::showErrorPopup("hex.view.diff.open_error"_lang);
+            return;
+        }
+
+        this->m_comparePath = path;
+        this->m_compareProvider = std::move(provider);
+
+        this->startDiff();
+    }
+
+    void ViewDiff::cancelDiff() {
+        this->m_diffTask.interrupt();
+        this->m_diffTask.wait();
+
+        std::scoped_lock lock(this->m_differencesMutex);
+        this->m_pendingDifferences.clear();
+    }
+
+    /* Streams through both files once. Differences are handed to the UI thread as they're found, so the list fills up while comparing */
+    void ViewDiff::startDiff() {
+        auto handle = ImHexApi::Provider::getHandle();
+        if (handle == nullptr || !handle->isReadable() || this->m_compareProvider == nullptr)
+            return;
+
+        this->cancelDiff();
+
+        this->m_differences.clear();
+        this->m_selectedDifference.reset();
+        this->m_outdated = false;
+        this->m_highlightsDirty = true;
+
+        this->m_diffTask = TaskManager::createTask("hex.view.diff.comparing", handle->getActualSize(), [this, handle, compareProvider = this->m_compareProvider](Task &task) {
+            handle->adviseAccess(0, handle->getActualSize(), prv::Provider::AccessHint::Sequential);
+            SCOPE_EXIT( handle->adviseAccess(0, handle->getActualSize(), prv::Provider::AccessHint::Normal); );
+
+            std::vector<BinaryDiffer::Difference> differences;
+            const auto handOver = [&] {
+                std::scoped_lock lock(this->m_differencesMutex);
+                this->m_pendingDifferences.insert(this->m_pendingDifferences.end(), differences.begin(), differences.end());
+                differences.clear();
+            };
+
+            BinaryDiffer differ;
+            differ.diff(handle.get(), compareProvider.get(), [&](const BinaryDiffer::Difference &difference) {
+                differences.push_back(difference);
+                return true;
+            }, [&](u64 offset) {
+                task.update(offset);
+                handOver();
+            }, task.getInterruptFlag());
+
+            handOver();
+        });
+    }
+
+    void ViewDiff::collectDifferences() {
+        {
+            std::scoped_lock lock(this->m_differencesMutex);
+            if (!this->m_pendingDifferences.empty()) {
+                this->m_differences.insert(this->m_differences.end(), this->m_pendingDifferences.begin(), this->m_pendingDifferences.end());
+                this->m_pendingDifferences.clear();
+            }
+        }
+
+        // Rebuilding the hex editor's highlights for every batch would be wasted work, they're only set once comparing is done
+        if (this->m_highlightsDirty && !this->m_diffTask.isRunning())
+            this->updateHighlights();
+    }
+
+    void ViewDiff::updateHighlights() {
+        std::vector<ImHexApi::Highlighting::Entry> entries;
+        entries.reserve(this->m_differences.size());
+
+        for (const auto &[left, right, type] : this->m_differences) {
+            // Insertions have nothing to highlight on this side, the byte they're inserted before gets marked instead
+            Region region = left.size > 0 ? left : Region { left.address, 1 };
+            entries.push_back({ region, getDifferenceColor(type) });
+        }
+
+        ImHexApi::Highlighting::set(HighlightName, std::move(entries));
+        this->m_highlightsDirty = false;
+    }
+
+    void ViewDiff::drawDifferenceList() {
+        if (ImGui::BeginTable("##differences", 5, ImGuiTableFlags_Borders | ImGuiTableFlags_Resizable | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY)) {
+            ImGui::TableSetupScrollFreeze(0, 1);
+            ImGui::TableSetupColumn("hex.view.diff.type"_lang);
+            ImGui::TableSetupColumn("hex.view.diff.address.current"_lang);
+            ImGui::TableSetupColumn("hex.common.size"_lang);
+            ImGui::TableSetupColumn("hex.view.diff.address.compared"_lang);
+            ImGui::TableSetupColumn("hex.common.size"_lang);
+
+            ImGui::TableHeadersRow();
+
+            ImGuiListClipper clipper;
+            clipper.Begin(this->m_differences.size());
+
+            while (clipper.Step()) {
+                for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
+                    const auto &[left, right, type] = this->m_differences[i];
+
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+                    ImGui::PushID(i);
+
+                    ImGui::ColorButton("##color", ImColor(getDifferenceColor(type)).Value, ImGuiColorEditFlags_NoTooltip | ImGuiColorEditFlags_NoDragDrop, ImVec2(ImGui::GetTextLineHeight(), ImGui::GetTextLineHeight()));
+                    ImGui::SameLine();
+
+                    if (ImGui::Selectable(getDifferenceName(type), this->m_selectedDifference == size_t(i), ImGuiSelectableFlags_SpanAllColumns)) {
+                        this->m_selectedDifference = i;
+                        View::postEvent(Events::SelectionChangeRequest, Region { left.address, std::max<size_t>(left.size, 1) });
+                    }
+                    ImGui::PopID();
+
+                    ImGui::TableNextColumn();
+                    ImGui::Text("0x%08llX", left.address);
+                    ImGui::TableNextColumn();
+                    ImGui::Text("0x%08zX", left.size);
+                    ImGui::TableNextColumn();
+                    ImGui::Text("0x%08llX", right.address);
+                    ImGui::TableNextColumn();
+                    ImGui::Text("0x%08zX", right.size);
+                }
+            }
+
+            clipper.End();
+
+            ImGui::EndTable();
+        }
+    }
+
+    void ViewDiff::drawContent() {
+        if (ImGui::Begin(View::toWindowName("hex.view.diff.name").c_str(), &this->getWindowOpenState(), ImGuiWindowFlags_NoCollapse)) {
+            auto provider = SharedData::currentProvider;
+
+            if (provider != nullptr && provider->isReadable()) {
+                this->collectDifferences();
+
+                if (ImGui::Button("hex.view.diff.open_file"_lang)) {
+                    View::openFileBrowser("hex.view.diff.open_file"_lang, DialogMode::Open, { }, [this](auto path) {
+                        this->openCompareFile(path);
+                    });
+                }
+                ImGui::SameLine();
+
+                ImGui::Disabled([this] {
+                    if (ImGui::Button("hex.view.diff.compare"_lang))
+                        this->startDiff();
+                }, this->m_compareProvider == nullptr || this->m_diffTask.isRunning());
+
+                if (this->m_diffTask.isRunning()) {
+                    ImGui::SameLine();
+                    ImGui::TextSpinner("hex.view.diff.comparing"_lang);
+                }
+
+                ImGui::TextUnformatted(this->m_comparePath.empty() ? static_cast<const char*>("hex.view.diff.no_file"_lang) : this->m_comparePath.c_str());
+                ImGui::TextUnformatted(hex::format("hex.view.diff.differences"_lang, this->m_differences.size()).c_str());
+
+                if (this->m_outdated) {
+                    ImGui::SameLine();
+                    ImGui::TextColored(ImColor(0xFF4040E0), "%s", static_cast<const char*>("hex.view.diff.outdated"_lang));
+                }
+
+                ImGui::Separator();
+
+                this->drawDifferenceList();
+            }
+        }
+        ImGui::End();
+    }
+
+    void ViewDiff::drawMenu() {
+
+    }
+
+}
\ No newline at end of file
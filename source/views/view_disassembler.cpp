@@ -1,10 +1,19 @@
 #include "views/view_disassembler.hpp"
 
+#include <hex/api/imhex_api.hpp>
+#include <hex/lang/pattern_data.hpp>
 #include <hex/providers/provider.hpp>
+#include <hex/helpers/regex.hpp>
 #include <hex/helpers/utils.hpp>
 
+#include "helpers/code_discovery.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
 #include <cstring>
-#include <thread>
+#include <limits>
+#include <optional>
 
 #include <imgui_imhex_extensions.h>
 
@@ -12,14 +21,42 @@ using namespace std::literals::string_literals;
 
 namespace hex {
 
-    ViewDisassembler::ViewDisassembler() : View("hex.view.disassembler.name") {
-        View::subscribeEvent(Events::DataChanged, [this](auto){
-            this->disassemble();
+    namespace {
+
+        constexpr auto HighlightName = "hex.view.disassembler.name";
+
+        constexpr u32 CodeColor = IM_COL32(0x40, 0x90, 0xE0, 0x60);
+        constexpr u32 DataColor = IM_COL32(0x80, 0x80, 0x80, 0x60);
+
+    }
+
+    ViewDisassembler::ViewDisassembler(std::vector<lang::PatternData*> &patternData) : View("hex.view.disassembler.name"), m_patternData(patternData), m_memoryBudget("hex.memory.disassembly", [this](size_t bytes) { return this->evictCache(bytes); }) {
+        View::subscribeEvent(Events::DataChanged, [this](auto userData) {
+            auto region = std::any_cast<Region>(&userData);
+
+            this->invalidateCache(region);
+
+            if (!this->m_capstoneHandleOpen)
+                return;
+
+            // A hidden view indexes the code again once it's shown, not for every edit in the meantime
+            if (region == nullptr || (region->address < this->m_indexedRegionStart + this->m_indexedRegionSize && region->address + region->size > this->m_indexedRegionStart))
+                this->invalidateContent();
+        });
+
+        // Indices of other providers stay cached, switching back to one of them shows its disassembly right away
+        View::subscribeEvent<prv::Provider*>(Events::ProviderChanged, [this](prv::Provider*) {
+            if (this->m_capstoneHandleOpen)
+                this->disassemble(true);
         });
 
-        View::subscribeEvent(Events::RegionSelected, [this](auto userData) {
-            auto region = std::any_cast<Region>(userData);
+        View::subscribeEvent<prv::Provider*>(Events::ProviderClosed, [this](prv::Provider *provider) {
+            std::scoped_lock lock(this->m_indexMutex);
+            this->m_cache.remove_if([provider](const CacheEntry &entry) { return entry.key.provider == provider; });
+            this->updateMemoryUsage();
+        });
 
+        View::subscribeEvent<Region>(Events::RegionSelected, [this](const Region &region) {
             if (this->m_shouldMatchSelection) {
                 this->m_codeRegion[0] = region.address;
                 this->m_codeRegion[1] = region.address + region.size - 1;
@@ -29,78 +66,1051 @@ namespace hex {
 
     ViewDisassembler::~ViewDisassembler() {
         View::unsubscribeEvent(Events::DataChanged);
+        View::unsubscribeEvent(Events::ProviderChanged);
+        View::unsubscribeEvent(Events::ProviderClosed);
         View::unsubscribeEvent(Events::RegionSelected);
+
+        // Stops the indexing and search tasks
+        this->m_indexGeneration++;
+        this->m_disassemblerTask.wait();
+        this->m_searchTask.interrupt();
+        this->m_searchTask.wait();
+
+        if (this->m_capstoneHandleOpen)
+            cs_close(&this->m_capstoneHandle);
+    }
+
+    /*
+        Decodes one instruction after another starting at an offset into the code region. Stops once the callback returns false,
+        the end of the region is reached or an invalid instruction is found
+    */
+    template<typename Callback>
+    static void decodeInstructions(csh capstoneHandle, prv::Provider *provider, u64 regionStart, u64 regionSize, u64 baseAddress, u64 offset, Callback &&callback) {
+        constexpr static size_t ReadChunkSize = 0x1'0000;
+        constexpr static size_t MaxInstructionSize = 64;
+
+        cs_insn *instruction = cs_malloc(capstoneHandle);
+        if (instruction == nullptr)
+            return;
+        SCOPE_EXIT( cs_free(instruction, 1); );
+
+        std::vector<u8> buffer(ReadChunkSize, 0x00);
+        while (offset < regionSize) {
+            size_t bufferSize = std::min<u64>(buffer.size(), regionSize - offset);
+            provider->read(regionStart + offset, buffer.data(), bufferSize);
+
+            const u8 *code = buffer.data();
+            size_t codeSize = bufferSize;
+            u64 address = baseAddress + offset;
+            bool refill = false;
+
+            while (cs_disasm_iter(capstoneHandle, &code, &codeSize, &address, instruction)) {
+                if (!callback(*instruction, offset))
+                    return;
+
+                offset += instruction->size;
+
+                // Read the next chunk before an instruction could get cut off at the end of the buffer
+                if (codeSize < MaxInstructionSize && offset + codeSize < regionSize) {
+                    refill = true;
+                    break;
+                }
+            }
+
+            if (!refill && codeSize != 0)
+                return;
+        }
+    }
+
+    cs_mode ViewDisassembler::getMode() const {
+        cs_mode mode = cs_mode(this->m_modeBasicARM | this->m_modeExtraARM | this->m_modeBasicMIPS | this->m_modeBasicX86 | this->m_modeBasicPPC);
+
+        if (this->m_littleEndianMode)
+            mode = cs_mode(mode | CS_MODE_LITTLE_ENDIAN);
+        else
+            mode = cs_mode(mode | CS_MODE_BIG_ENDIAN);
+
+        if (this->m_micoMode)
+            mode = cs_mode(mode | CS_MODE_MICRO);
+
+        if (this->m_sparcV9Mode)
+            mode = cs_mode(mode | CS_MODE_V9);
+
+        return mode;
+    }
+
+    u32 ViewDisassembler::getInstructionAlignment() const {
+        switch (this->m_architecture) {
+            case Architecture::ARM:
+                return this->m_modeBasicARM == CS_MODE_THUMB ? 2 : 4;
+            case Architecture::MIPS:
+                return this->m_micoMode ? 2 : 4;
+            case Architecture::ARM64:
+            case Architecture::PPC:
+            case Architecture::SPARC:
+                return 4;
+            default:
+                return 1;
+        }
+    }
+
+    bool ViewDisassembler::isIndexOutdated(const Task &task, u64 generation) const {
+        return generation != this->m_indexGeneration || task.isInterrupted();
+    }
+
+    void ViewDisassembler::indexInstructions(const Task &task, prv::Provider *provider, u64 generation, cs_arch architecture, cs_mode mode, u64 regionStart, u64 regionSize, u64 baseAddress) {
+        csh capstoneHandle;
+        if (cs_open(architecture, mode, &capstoneHandle) != CS_ERR_OK)
+            return;
+        SCOPE_EXIT( cs_close(&capstoneHandle); );
+
+        cs_option(capstoneHandle, CS_OPT_DETAIL, CS_OPT_OFF);
+
+        u64 instructionCount = 0;
+
+        decodeInstructions(capstoneHandle, provider, regionStart, regionSize, baseAddress, 0, [&](const cs_insn &instruction, u64 offset) {
+            if (this->isIndexOutdated(task, generation))
+                return false;
+
+            if (instructionCount % IndexInterval == 0) {
+                std::scoped_lock lock(this->m_indexMutex);
+                this->m_instructionIndex.push_back({ instructionCount, offset });
+            }
+
+            // Rows become visible as soon as they're indexed
+            this->m_instructionCount = ++instructionCount;
+
+            return true;
+        });
     }
 
-    void ViewDisassembler::disassemble() {
-        this->m_disassembly.clear();
-        this->m_disassembling = true;
+    /*
+        Splits the code region into chunks which get decoded on all cores, each one starting at its first byte. For fixed-width
+        architectures that's always where the previous chunk's instructions end. Variable-length code gets resynchronized by
+        decoding past the end of the previous chunk until it lands on an instruction boundary the next chunk also found
+    */
+    void ViewDisassembler::indexInstructionsParallel(const Task &task, prv::Provider *provider, u64 generation, cs_arch architecture, cs_mode mode, u32 alignment, u64 regionStart, u64 regionSize, u64 baseAddress, u32 threadCount) {
+        constexpr static u64 SyncInstructionCount = 64;
+
+        struct Chunk {
+            u64 start, end;
+            std::vector<IndexEntry> index;
+            std::vector<u64> syncOffsets;
+            u64 instructionCount = 0;
+            u64 endOffset = 0;
+        };
+
+        u64 chunkSize = std::max<u64>(regionSize / (threadCount * 4), MinimumIndexChunkSize);
+        chunkSize -= chunkSize % alignment;
+        u64 chunkCount = (regionSize + chunkSize - 1) / chunkSize;
+
+        std::vector<Chunk> chunks(chunkCount);
+        for (u64 i = 0; i < chunkCount; i++) {
+            chunks[i].start = i * chunkSize;
+            chunks[i].end = std::min(chunks[i].start + chunkSize, regionSize);
+        }
+
+        std::atomic<u64> nextChunk = 0;
 
-        std::thread([this] {
+        auto worker = [&] {
             csh capstoneHandle;
-            cs_insn *instructions = nullptr;
+            if (cs_open(architecture, mode, &capstoneHandle) != CS_ERR_OK)
+                return;
+            SCOPE_EXIT( cs_close(&capstoneHandle); );
+
+            cs_option(capstoneHandle, CS_OPT_DETAIL, CS_OPT_OFF);
+
+            for (u64 i = nextChunk++; i < chunkCount; i = nextChunk++) {
+                auto &chunk = chunks[i];
+                chunk.endOffset = chunk.start;
+
+                decodeInstructions(capstoneHandle, provider, regionStart, regionSize, baseAddress, chunk.start, [&](const cs_insn &instruction, u64 offset) {
+                    if (offset >= chunk.end || this->isIndexOutdated(task, generation))
+                        return false;
+
+                    if (chunk.instructionCount % IndexInterval == 0)
+                        chunk.index.push_back({ chunk.instructionCount, offset });
+                    if (chunk.instructionCount < SyncInstructionCount)
+                        chunk.syncOffsets.push_back(offset);
+
+                    chunk.instructionCount++;
+                    chunk.endOffset = offset + instruction.size;
+
+                    return true;
+                });
+            }
+        };
+
+        TaskManager::runParallel(std::min<u64>(threadCount, chunkCount), [&](u32) { worker(); });
+
+        if (this->isIndexOutdated(task, generation))
+            return;
+
+        csh capstoneHandle;
+        if (cs_open(architecture, mode, &capstoneHandle) != CS_ERR_OK)
+            return;
+        SCOPE_EXIT( cs_close(&capstoneHandle); );
+
+        cs_option(capstoneHandle, CS_OPT_DETAIL, CS_OPT_OFF);
+
+        std::vector<IndexEntry> index;
+        u64 row = 0, offset = 0;
+
+        for (auto &chunk : chunks) {
+            /*
+                Continue the instruction stream until it meets one of the chunk's first instructions. If it never does, or a chunk
+                couldn't be decoded at all, the rest of the region simply gets decoded here one instruction after another
+            */
+            std::optional<u64> skippedInstructions;
+            decodeInstructions(capstoneHandle, provider, regionStart, regionSize, baseAddress, offset, [&](const cs_insn &instruction, u64 instructionOffset) {
+                if (this->isIndexOutdated(task, generation))
+                    return false;
+
+                auto syncOffset = std::lower_bound(chunk.syncOffsets.begin(), chunk.syncOffsets.end(), instructionOffset);
+                if (syncOffset != chunk.syncOffsets.end() && *syncOffset == instructionOffset) {
+                    skippedInstructions = syncOffset - chunk.syncOffsets.begin();
+                    return false;
+                }
+
+                if (index.empty() || row - index.back().row >= IndexInterval)
+                    index.push_back({ row, instructionOffset });
+
+                row++;
+                offset = instructionOffset + instruction.size;
+
+                return true;
+            });
+
+            if (!skippedInstructions.has_value())
+                break;
+
+            if (index.empty() || index.back().row != row)
+                index.push_back({ row, offset });
+
+            for (const auto &entry : chunk.index) {
+                if (entry.row > *skippedInstructions)
+                    index.push_back({ row + entry.row - *skippedInstructions, entry.offset });
+            }
+
+            row += chunk.instructionCount - *skippedInstructions;
+            offset = chunk.endOffset;
+
+            // The chunk ran into an invalid instruction, nothing after it is code anymore
+            if (chunk.endOffset < chunk.end)
+                break;
+        }
+
+        std::scoped_lock lock(this->m_indexMutex);
+        if (!this->isIndexOutdated(task, generation)) {
+            this->m_instructionIndex = std::move(index);
+            this->m_instructionCount = row;
+        }
+    }
+
+    /* Decodes the single instruction at an offset into the code region */
+    static bool decodeInstruction(csh capstoneHandle, prv::Provider *provider, u64 regionStart, u64 regionSize, u64 baseAddress, u64 offset, cs_insn *instruction) {
+        constexpr static size_t MaxInstructionSize = 64;
+
+        if (offset >= regionSize)
+            return false;
+
+        u8 buffer[MaxInstructionSize];
+        size_t size = std::min<u64>(sizeof(buffer), regionSize - offset);
+        provider->read(regionStart + offset, buffer, size);
+
+        const u8 *code = buffer;
+        u64 address = baseAddress + offset;
+
+        return cs_disasm_iter(capstoneHandle, &code, &size, &address, instruction);
+    }
+
+    /*
+        Decodes all indexed instructions once more with instruction details turned on, which is a lot slower than indexing, so it's done
+        on all cores. Every worker takes a range of entries of the finished instruction index and decodes exactly the instructions between them.
+        This builds the mnemonic index and, unless recursive descent already found them, the references
+    */
+    void ViewDisassembler::indexDetails(const Task &task, prv::Provider *provider, u64 generation, const CacheKey &key, u32 threadCount) {
+        constexpr static u64 EntriesPerChunk = 64;
+
+        const bool collectReferences = key.entryPoints.empty();
+
+        std::vector<IndexEntry> index;
+        u64 instructionCount;
+        {
+            std::scoped_lock lock(this->m_indexMutex);
+            index = this->m_instructionIndex;
+            instructionCount = this->m_instructionCount;
+        }
+
+        if (index.empty())
+            return;
+
+        struct Chunk {
+            std::vector<std::pair<u64, u64>> references;
+            std::vector<std::pair<u32, u64>> instructions;
+        };
+
+        u64 chunkCount = (index.size() + EntriesPerChunk - 1) / EntriesPerChunk;
+        std::vector<Chunk> chunks(chunkCount);
+        std::atomic<u64> nextChunk = 0;
+
+        TaskManager::runParallel(std::min<u64>(threadCount, chunkCount), [&](u32) {
+            csh capstoneHandle;
+            if (cs_open(key.architecture, key.mode, &capstoneHandle) != CS_ERR_OK)
+                return;
+            SCOPE_EXIT( cs_close(&capstoneHandle); );
+
+            cs_option(capstoneHandle, CS_OPT_DETAIL, CS_OPT_ON);
+
+            cs_insn *instruction = cs_malloc(capstoneHandle);
+            if (instruction == nullptr)
+                return;
+            SCOPE_EXIT( cs_free(instruction, 1); );
+
+            for (u64 i = nextChunk++; i < chunkCount; i = nextChunk++) {
+                auto &chunk = chunks[i];
+                u64 firstEntry = i * EntriesPerChunk;
+                u64 row = index[firstEntry].row;
+                u64 endRow = firstEntry + EntriesPerChunk < index.size() ? index[firstEntry + EntriesPerChunk].row : instructionCount;
+
+                const auto addInstruction = [&](const cs_insn &decoded, u64 offset) {
+                    chunk.instructions.emplace_back(decoded.id, offset);
+
+                    if (collectReferences) {
+                        if (auto target = CodeDiscovery::getBranchTarget(capstoneHandle, key.architecture, decoded); target.has_value())
+                            chunk.references.emplace_back(*target, decoded.address);
+                    }
+                };
+
+                // The instruction starts only get replaced by this task or while no task is running, they can be read without the lock
+                if (this->m_instructionStarts.empty()) {
+                    decodeInstructions(capstoneHandle, provider, key.regionStart, key.regionSize, key.baseAddress, index[firstEntry].offset, [&](const cs_insn &decoded, u64 offset) {
+                        if (row++ >= endRow || this->isIndexOutdated(task, generation))
+                            return false;
+
+                        addInstruction(decoded, offset);
+
+                        return true;
+                    });
+                } else {
+                    std::optional<u64> offset = index[firstEntry].offset;
+                    for (; offset.has_value() && row < endRow && !this->isIndexOutdated(task, generation); row++) {
+                        if (decodeInstruction(capstoneHandle, provider, key.regionStart, key.regionSize, key.baseAddress, *offset, instruction))
+                            addInstruction(*instruction, *offset);
+
+                        offset = CodeDiscovery::findNextSet(this->m_instructionStarts, *offset + 1);
+                    }
+                }
+            }
+        });
+
+        if (this->isIndexOutdated(task, generation))
+            return;
+
+        // Counting sort by instruction id. Chunks are in address order, so the offsets of every id end up sorted as well
+        auto mnemonicIndex = std::make_shared<MnemonicIndex>();
+        {
+            u32 maxId = 0;
+            u64 totalCount = 0;
+            for (const auto &chunk : chunks) {
+                for (const auto &[id, offset] : chunk.instructions)
+                    maxId = std::max(maxId, id);
+                totalCount += chunk.instructions.size();
+            }
+
+            mnemonicIndex->starts.resize(maxId + 2, 0);
+            for (const auto &chunk : chunks) {
+                for (const auto &[id, offset] : chunk.instructions)
+                    mnemonicIndex->starts[id + 1]++;
+            }
+
+            for (u32 id = 1; id < mnemonicIndex->starts.size(); id++)
+                mnemonicIndex->starts[id] += mnemonicIndex->starts[id - 1];
+
+            std::vector<u64> positions(mnemonicIndex->starts.begin(), mnemonicIndex->starts.end() - 1);
+            mnemonicIndex->offsets.resize(totalCount);
+            for (auto &chunk : chunks) {
+                for (const auto &[id, offset] : chunk.instructions)
+                    mnemonicIndex->offsets[positions[id]++] = offset;
+
+                chunk.instructions = { };
+            }
+        }
+
+        std::optional<References> references;
+        if (collectReferences) {
+            std::vector<std::pair<u64, u64>> pairs;
+            for (auto &chunk : chunks) {
+                pairs.insert(pairs.end(), chunk.references.begin(), chunk.references.end());
+                chunk.references = { };
+            }
+
+            std::sort(pairs.begin(), pairs.end());
+
+            references.emplace();
+            references->targets.reserve(pairs.size());
+            references->sources.reserve(pairs.size());
+            for (const auto &[target, source] : pairs) {
+                references->targets.push_back(target);
+                references->sources.push_back(source);
+            }
+        }
+
+        std::scoped_lock lock(this->m_indexMutex);
+        if (!this->isIndexOutdated(task, generation)) {
+            auto cached = std::find_if(this->m_cache.begin(), this->m_cache.end(), [&](const CacheEntry &entry) { return entry.key == key; });
+            if (cached != this->m_cache.end()) {
+                cached->mnemonicIndex = mnemonicIndex;
+                if (references.has_value())
+                    cached->references = *references;
+            }
+
+            this->m_mnemonicIndex = mnemonicIndex;
+            if (references.has_value())
+                this->m_references = std::move(*references);
+
+            this->m_resultsVersion++;
+            this->updateMemoryUsage();
+        }
+    }
+
+    void ViewDisassembler::discoverCode(const Task &task, prv::Provider *provider, u64 generation, const CacheKey &key, u32 threadCount) {
+        auto result = CodeDiscovery::discover(provider, key.architecture, key.mode, key.regionStart, key.regionSize, key.baseAddress, key.entryPoints, threadCount, [&] {
+            return this->isIndexOutdated(task, generation);
+        });
+
+        if (!result.has_value())
+            return;
+
+        // Rows are numbered in address order, no matter in which order the instructions were found
+        std::vector<IndexEntry> index;
+        u64 row = 0;
+        for (auto offset = CodeDiscovery::findNextSet(result->instructionStarts, 0); offset.has_value(); offset = CodeDiscovery::findNextSet(result->instructionStarts, *offset + 1)) {
+            if (row % IndexInterval == 0)
+                index.push_back({ row, *offset });
+            row++;
+        }
+
+        // Anything in the region that wasn't reached counts as data
+        std::vector<ImHexApi::Highlighting::Entry> highlights;
+        for (u64 offset = 0; offset < key.regionSize; ) {
+            bool isCode = (result->codeBytes[offset / 64] >> (offset % 64)) & 1;
+
+            u64 end = offset + 1;
+            while (end < key.regionSize && bool((result->codeBytes[end / 64] >> (end % 64)) & 1) == isCode) {
+                // Skip whole words that don't change
+                if (end % 64 == 0 && end + 64 <= key.regionSize && result->codeBytes[end / 64] == (isCode ? ~u64(0) : 0))
+                    end += 64;
+                else
+                    end++;
+            }
+
+            highlights.push_back({ Region { key.regionStart + offset, end - offset }, isCode ? CodeColor : DataColor });
+            offset = end;
+        }
+
+        std::sort(result->references.begin(), result->references.end());
+
+        References references;
+        references.targets.reserve(result->references.size());
+        references.sources.reserve(result->references.size());
+        for (const auto &[target, source] : result->references) {
+            references.targets.push_back(target);
+            references.sources.push_back(source);
+        }
+
+        std::scoped_lock lock(this->m_indexMutex);
+        if (!this->isIndexOutdated(task, generation)) {
+            this->m_instructionIndex = std::move(index);
+            this->m_instructionCount = row;
+            this->m_instructionStarts = std::move(result->instructionStarts);
+            this->m_codeHighlights = std::move(highlights);
+            this->m_references = std::move(references);
+            this->m_resultsVersion++;
+        }
+    }
+
+    std::vector<u64> ViewDisassembler::getEntryPoints() const {
+        std::vector<u64> entryPoints = this->m_entryPoints;
+
+        /*
+            Patterns marked with [[entry_point]] supply entry points too. Integers and pointers hold the address of the code,
+            for anything else the code starts where the pattern is placed
+        */
+        std::vector<lang::PatternData*> patterns(this->m_patternData.begin(), this->m_patternData.end());
+        while (!patterns.empty()) {
+            auto pattern = patterns.back();
+            patterns.pop_back();
+
+            if (auto structPattern = dynamic_cast<lang::PatternDataStruct*>(pattern); structPattern != nullptr)
+                patterns.insert(patterns.end(), structPattern->getMembers().begin(), structPattern->getMembers().end());
+            else if (auto unionPattern = dynamic_cast<lang::PatternDataUnion*>(pattern); unionPattern != nullptr)
+                patterns.insert(patterns.end(), unionPattern->getMembers().begin(), unionPattern->getMembers().end());
+            else if (auto arrayPattern = dynamic_cast<lang::PatternDataArray*>(pattern); arrayPattern != nullptr)
+                patterns.insert(patterns.end(), arrayPattern->getEntries().begin(), arrayPattern->getEntries().end());
+
+            if (!pattern->isEntryPoint())
+                continue;
+
+            if (dynamic_cast<lang::PatternDataUnsigned*>(pattern) != nullptr || dynamic_cast<lang::PatternDataPointer*>(pattern) != nullptr) {
+                u64 value = 0;
+                SharedData::currentProvider->read(pattern->getOffset(), &value, std::min<size_t>(pattern->getSize(), sizeof(value)));
+                entryPoints.push_back(hex::changeEndianess(value, std::min<size_t>(pattern->getSize(), sizeof(value)), pattern->getEndian()));
+            } else if (pattern->getOffset() >= this->m_codeRegion[0]) {
+                entryPoints.push_back(this->m_baseAddress + (pattern->getOffset() - this->m_codeRegion[0]));
+            }
+        }
+
+        // Without any entry points, the code is assumed to start at the beginning of the region
+        if (entryPoints.empty())
+            entryPoints.push_back(this->m_baseAddress);
+
+        std::sort(entryPoints.begin(), entryPoints.end());
+        entryPoints.erase(std::unique(entryPoints.begin(), entryPoints.end()), entryPoints.end());
+
+        return entryPoints;
+    }
+
+    void ViewDisassembler::disassemble(bool onlyCached) {
+        auto generation = ++this->m_indexGeneration;
 
-            cs_mode mode = cs_mode(this->m_modeBasicARM | this->m_modeExtraARM | this->m_modeBasicMIPS | this->m_modeBasicX86 | this->m_modeBasicPPC);
+        // The previous run stops at its next instruction once it sees the new generation
+        this->m_disassemblerTask.wait();
 
-            if (this->m_littleEndianMode)
-                mode = cs_mode(mode | CS_MODE_LITTLE_ENDIAN);
+        // Search results are offsets into the old code region
+        this->m_searchTask.interrupt();
+        this->m_searchTask.wait();
+        {
+            std::scoped_lock lock(this->m_searchMutex);
+            this->m_searchResults.clear();
+        }
+
+        {
+            std::scoped_lock lock(this->m_indexMutex);
+            this->m_instructionIndex.clear();
+            this->m_instructionCount = 0;
+            this->m_references = { };
+            this->m_mnemonicIndex = nullptr;
+            this->m_instructionStarts.clear();
+            this->m_codeHighlights.clear();
+            this->m_resultsVersion++;
+        }
+
+        this->m_window.clear();
+
+        if (this->m_capstoneHandleOpen) {
+            cs_close(&this->m_capstoneHandle);
+            this->m_capstoneHandleOpen = false;
+        }
+
+        if (SharedData::currentProvider == nullptr)
+            return;
+
+        auto architecture = Disassembler::toCapstoneArchictecture(this->m_architecture);
+        auto mode = this->getMode();
+
+        if (cs_open(architecture, mode, &this->m_capstoneHandle) != CS_ERR_OK)
+            return;
+
+        // Only the text of each instruction is used, don't let capstone fill in all the details
+        cs_option(this->m_capstoneHandle, CS_OPT_DETAIL, CS_OPT_OFF);
+
+        this->m_capstoneHandleOpen = true;
+        this->m_indexedRegionStart = this->m_codeRegion[0];
+        this->m_indexedRegionSize = this->m_codeRegion[1] >= this->m_codeRegion[0] ? this->m_codeRegion[1] - this->m_codeRegion[0] + 1 : 0;
+        this->m_indexedBaseAddress = this->m_baseAddress;
+
+        CacheKey key = { SharedData::currentProvider, SharedData::currentProvider->getCurrentPage(), architecture, mode, this->m_indexedBaseAddress, this->m_indexedRegionStart, this->m_indexedRegionSize };
+        if (this->m_recursiveDescent)
+            key.entryPoints = this->getEntryPoints();
+
+        {
+            std::scoped_lock lock(this->m_indexMutex);
+
+            auto cached = std::find_if(this->m_cache.begin(), this->m_cache.end(), [&](const CacheEntry &entry) { return entry.key == key; });
+            if (cached != this->m_cache.end()) {
+                this->m_cache.splice(this->m_cache.begin(), this->m_cache, cached);
+
+                this->m_instructionIndex = cached->index;
+                this->m_instructionCount = cached->instructionCount;
+                this->m_references = cached->references;
+                this->m_mnemonicIndex = cached->mnemonicIndex;
+                this->m_instructionStarts = cached->instructionStarts;
+                this->m_codeHighlights = cached->codeHighlights;
+                this->m_resultsVersion++;
+                this->m_memoryBudget.touch();
+
+                return;
+            }
+        }
+
+        if (onlyCached) {
+            cs_close(&this->m_capstoneHandle);
+            this->m_capstoneHandleOpen = false;
+            return;
+        }
+
+        this->m_disassemblerTask = TaskManager::createTask("hex.view.disassembler.disassembling", 0, [this, provider = ImHexApi::Provider::getHandle(), generation, key, alignment = this->getInstructionAlignment()](Task &task) {
+            auto threadCount = TaskManager::getWorkerCount();
+
+            if (!key.entryPoints.empty())
+                this->discoverCode(task, provider.get(), generation, key, threadCount);
+            else if (threadCount > 1 && key.regionSize >= ParallelIndexThreshold)
+                this->indexInstructionsParallel(task, provider.get(), generation, key.architecture, key.mode, alignment, key.regionStart, key.regionSize, key.baseAddress, threadCount);
             else
-                mode = cs_mode(mode | CS_MODE_BIG_ENDIAN);
+                this->indexInstructions(task, provider.get(), generation, key.architecture, key.mode, key.regionStart, key.regionSize, key.baseAddress);
+
+            {
+                std::scoped_lock lock(this->m_indexMutex);
+
+                // An interrupted run only indexed part of the region, it must not end up in the cache
+                if (this->isIndexOutdated(task, generation))
+                    return;
+
+                this->m_cache.push_front({ key, this->m_instructionIndex, this->m_instructionCount, this->m_references, this->m_mnemonicIndex, this->m_instructionStarts, this->m_codeHighlights });
+
+                if (this->m_cache.size() > CacheSize)
+                    this->m_cache.pop_back();
+
+                this->updateMemoryUsage();
+            }
+
+            // The rows are usable already, references and the mnemonic index follow once they're built
+            this->indexDetails(task, provider.get(), generation, key, threadCount);
+        });
+
+    }
+
+    void ViewDisassembler::invalidateCache(const Region *region) {
+        std::scoped_lock lock(this->m_indexMutex);
+
+        // Without a region anything in the current provider could have changed
+        this->m_cache.remove_if([&](const CacheEntry &entry) {
+            if (entry.key.provider != SharedData::currentProvider)
+                return false;
+
+            return region == nullptr || (region->address < entry.key.regionStart + entry.key.regionSize && region->address + region->size > entry.key.regionStart);
+        });
+
+        this->updateMemoryUsage();
+    }
+
+    size_t ViewDisassembler::evictCache(size_t bytes) {
+        std::scoped_lock lock(this->m_indexMutex);
+
+        size_t freed = 0;
+        while (freed < bytes && !this->m_cache.empty()) {
+            const auto &entry = this->m_cache.back();
+            freed += entry.index.size() * sizeof(IndexEntry) + (entry.references.targets.size() + entry.references.sources.size() + entry.instructionStarts.size()) * sizeof(u64) +
+                     entry.codeHighlights.size() * sizeof(ImHexApi::Highlighting::Entry);
+            if (entry.mnemonicIndex != nullptr)
+                freed += (entry.mnemonicIndex->starts.size() + entry.mnemonicIndex->offsets.size()) * sizeof(u64);
+            this->m_cache.pop_back();
+        }
+
+        return freed;
+    }
+
+    void ViewDisassembler::updateMemoryUsage() {
+        size_t usage = 0;
+        for (const auto &entry : this->m_cache) {
+            usage += entry.index.size() * sizeof(IndexEntry) + (entry.references.targets.size() + entry.references.sources.size() + entry.instructionStarts.size()) * sizeof(u64) +
+                     entry.codeHighlights.size() * sizeof(ImHexApi::Highlighting::Entry);
+            if (entry.mnemonicIndex != nullptr)
+                usage += (entry.mnemonicIndex->starts.size() + entry.mnemonicIndex->offsets.size()) * sizeof(u64);
+        }
+
+        this->m_memoryBudget.update(usage);
+    }
+
+    void ViewDisassembler::decodeWindow(u64 firstRow, u64 rowCount) {
+        constexpr static u64 WindowMargin = 64;
+
+        if (!this->m_capstoneHandleOpen)
+            return;
+
+        // The decoded rows are still valid, instructions never change without the index being rebuilt
+        if (firstRow >= this->m_windowStart && firstRow + rowCount <= this->m_windowStart + this->m_window.size())
+            return;
+
+        u64 windowStart = firstRow > WindowMargin ? firstRow - WindowMargin : 0;
+        u64 windowEnd = std::min<u64>(firstRow + rowCount + WindowMargin, this->m_instructionCount);
+
+        IndexEntry indexEntry;
+        bool recursiveDescent;
+        std::vector<u64> instructionOffsets;
+        {
+            std::scoped_lock lock(this->m_indexMutex);
+
+            auto it = std::upper_bound(this->m_instructionIndex.begin(), this->m_instructionIndex.end(), windowStart, [](u64 row, const IndexEntry &entry) {
+                return row < entry.row;
+            });
+
+            if (it == this->m_instructionIndex.begin())
+                return;
+
+            indexEntry = *std::prev(it);
+
+            // Code found by recursive descent can have data in between, so the rows are wherever an instruction starts
+            recursiveDescent = !this->m_instructionStarts.empty();
+            if (recursiveDescent) {
+                u64 row = indexEntry.row;
+                for (auto offset = std::optional<u64>(indexEntry.offset); offset.has_value() && row < windowEnd; offset = CodeDiscovery::findNextSet(this->m_instructionStarts, *offset + 1)) {
+                    if (row++ >= windowStart)
+                        instructionOffsets.push_back(*offset);
+                }
+            }
+        }
+
+        this->m_window.clear();
+        this->m_windowStrings.clear();
+        this->m_windowStart = windowStart;
+
+        auto addString = [this](std::string_view string) {
+            u32 offset = this->m_windowStrings.size();
+            this->m_windowStrings.append(string);
+            this->m_windowStrings.push_back('\0');
+
+            return offset;
+        };
+
+        auto addInstruction = [&](const cs_insn &instruction, u64 offset) {
+            Disassembly disassembly = { 0 };
+            disassembly.address = instruction.address;
+            disassembly.offset = this->m_indexedRegionStart + offset;
+            disassembly.size = instruction.size;
+            disassembly.mnemonic = addString(instruction.mnemonic);
+            disassembly.operators = addString(instruction.op_str);
+
+            char bytes[std::size(instruction.bytes) * 3];
+            for (u8 i = 0; i < instruction.size; i++)
+                std::snprintf(bytes + i * 3, 4, "%02X ", instruction.bytes[i]);
+            disassembly.bytes = addString({ bytes, instruction.size * 3U - 1 });
+
+            this->m_window.push_back(disassembly);
+        };
+
+        if (recursiveDescent) {
+            cs_insn *instruction = cs_malloc(this->m_capstoneHandle);
+            if (instruction == nullptr)
+                return;
+            SCOPE_EXIT( cs_free(instruction, 1); );
+
+            for (u64 offset : instructionOffsets) {
+                if (!decodeInstruction(this->m_capstoneHandle, SharedData::currentProvider, this->m_indexedRegionStart, this->m_indexedRegionSize, this->m_indexedBaseAddress, offset, instruction))
+                    break;
+
+                addInstruction(*instruction, offset);
+            }
+
+            return;
+        }
+
+        u64 row = indexEntry.row;
+        decodeInstructions(this->m_capstoneHandle, SharedData::currentProvider, this->m_indexedRegionStart, this->m_indexedRegionSize, this->m_indexedBaseAddress, indexEntry.offset, [&](const cs_insn &instruction, u64 offset) {
+            if (row >= windowEnd)
+                return false;
+
+            if (row++ >= windowStart)
+                addInstruction(instruction, offset);
+
+            return true;
+        });
+    }
+
+    void ViewDisassembler::findReferences(u64 target) {
+        std::scoped_lock lock(this->m_indexMutex);
+
+        const auto &targets = this->m_references.targets;
+        auto [begin, end] = std::equal_range(targets.begin(), targets.end(), target);
+
+        const auto sources = this->m_references.sources.begin();
+        this->m_referenceResults.assign(sources + (begin - targets.begin()), sources + (end - targets.begin()));
 
-            if (this->m_micoMode)
-                mode = cs_mode(mode | CS_MODE_MICRO);
+        this->m_referenceTarget = target;
+        this->m_referenceResultsVersion = this->m_resultsVersion;
+    }
+
+    void ViewDisassembler::drawReferences() {
+        ImGui::TextUnformatted("hex.view.disassembler.references.title"_lang);
+        ImGui::Separator();
+
+        u64 target = this->m_referenceTarget;
+        if (ImGui::InputScalar("hex.view.disassembler.references.target"_lang, ImGuiDataType_U64, &target, nullptr, nullptr, "%08llX", ImGuiInputTextFlags_CharsHexadecimal) || this->m_referenceResultsVersion != this->m_resultsVersion)
+            this->findReferences(target);
+
+        if (this->m_disassemblerTask.isRunning()) {
+            ImGui::TextSpinner("hex.view.disassembler.references.indexing"_lang);
+            return;
+        }
+
+        ImGui::TextUnformatted(hex::format("hex.view.disassembler.references.count"_lang, this->m_referenceResults.size()).c_str());
+
+        if (this->m_referenceResults.empty())
+            return;
+
+        if (ImGui::BeginChild("##references", ImVec2(0, ImGui::GetTextLineHeightWithSpacing() * 4), true)) {
+            ImGuiListClipper clipper;
+            clipper.Begin(std::min<u64>(this->m_referenceResults.size(), std::numeric_limits<int>::max()));
+
+            while (clipper.Step()) {
+                for (u64 i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
+                    u64 source = this->m_referenceResults[i];
+
+                    ImGui::PushID(static_cast<int>(i));
+                    if (ImGui::Selectable(hex::format("0x{:08X}", source).c_str())) {
+                        Region selectRegion = { this->m_indexedRegionStart + (source - this->m_indexedBaseAddress), 1 };
+                        View::postEvent(Events::SelectionChangeRequest, selectRegion);
+                    }
+                    ImGui::PopID();
+                }
+            }
+
+            clipper.End();
+        }
+        ImGui::EndChild();
+    }
+
+    void ViewDisassembler::searchInstructions() {
+        auto provider = SharedData::currentProvider;
+        if (this->m_searchTask.isRunning() || provider == nullptr || !this->m_capstoneHandleOpen)
+            return;
+
+        std::shared_ptr<const MnemonicIndex> mnemonicIndex;
+        {
+            std::scoped_lock lock(this->m_indexMutex);
+            mnemonicIndex = this->m_mnemonicIndex;
+        }
+
+        if (mnemonicIndex == nullptr)
+            return;
 
-            if (this->m_sparcV9Mode)
-                mode = cs_mode(mode | CS_MODE_V9);
+        // Compiling is quick, doing it right away lets mistakes in the pattern show up before anything gets searched
+        auto pattern = this->m_searchOperands;
+        if (!pattern.empty()) {
+            try {
+                RegexSearcher searcher(pattern, true);
+            } catch (const std::invalid_argument &e) {
+                this->m_searchError = e.what();
+                return;
+            }
+        }
+        this->m_searchError.clear();
+
+        // There are only a few thousand ids, looking up all their names is quick. Without a mnemonic every instruction is a candidate
+        auto mnemonic = this->m_searchMnemonic;
+        hex::trim(mnemonic);
+        std::vector<u32> ids;
+        for (u32 id = 0; id + 1 < mnemonicIndex->starts.size(); id++) {
+            if (mnemonicIndex->starts[id] == mnemonicIndex->starts[id + 1])
+                continue;
+
+            const char *name = cs_insn_name(this->m_capstoneHandle, id);
+            if (name == nullptr)
+                continue;
+
+            std::string_view nameView = name;
+            if (mnemonic.empty() || std::equal(mnemonic.begin(), mnemonic.end(), nameView.begin(), nameView.end(), [](char a, char b) { return std::tolower(static_cast<unsigned char>(a)) == std::tolower(static_cast<unsigned char>(b)); }))
+                ids.push_back(id);
+        }
+
+        {
+            std::scoped_lock lock(this->m_searchMutex);
+            this->m_searchResults.clear();
+        }
+
+        if (ids.empty())
+            return;
+
+        this->m_searchTask = TaskManager::createTask("hex.view.disassembler.search.searching", 0, [this, handle = ImHexApi::Provider::getHandle(), mnemonicIndex, ids, pattern,
+                                                      architecture = Disassembler::toCapstoneArchictecture(this->m_architecture), mode = this->getMode(),
+                                                      regionStart = this->m_indexedRegionStart, regionSize = this->m_indexedRegionSize, baseAddress = this->m_indexedBaseAddress](Task &task) {
+            constexpr static u64 CandidatesPerChunk = 0x1000;
 
-            if (cs_open(Disassembler::toCapstoneArchictecture(this->m_architecture), mode, &capstoneHandle) == CS_ERR_OK) {
+            std::vector<u64> candidates;
+            for (u32 id : ids)
+                candidates.insert(candidates.end(), mnemonicIndex->offsets.begin() + mnemonicIndex->starts[id], mnemonicIndex->offsets.begin() + mnemonicIndex->starts[id + 1]);
 
-                auto provider = SharedData::currentProvider;
-                std::vector<u8> buffer(2048, 0x00);
-                for (u64 address = 0; address < (this->m_codeRegion[1] - this->m_codeRegion[0] + 1); address += 2048) {
-                    size_t bufferSize = std::min(u64(2048), (this->m_codeRegion[1] - this->m_codeRegion[0] + 1) - address);
-                    provider->read(this->m_codeRegion[0] + address, buffer.data(), bufferSize);
+            if (ids.size() > 1)
+                std::sort(candidates.begin(), candidates.end());
 
-                    size_t instructionCount = cs_disasm(capstoneHandle, buffer.data(), bufferSize, this->m_baseAddress + address, 0, &instructions);
+            // Without an operand pattern the index already has the answer, otherwise the operands have to be decoded on all cores
+            std::vector<u64> results;
+            if (pattern.empty()) {
+                results = std::move(candidates);
+            } else {
+                u64 chunkCount = (candidates.size() + CandidatesPerChunk - 1) / CandidatesPerChunk;
+                std::vector<std::vector<u64>> chunkResults(chunkCount);
+                std::atomic<u64> nextChunk = 0;
 
-                    if (instructionCount == 0)
-                        break;
+                task.setMaxValue(chunkCount);
 
-                    u64 usedBytes = 0;
-                    for (u32 instr = 0; instr < instructionCount; instr++) {
-                        Disassembly disassembly = { 0 };
-                        disassembly.address = instructions[instr].address;
-                        disassembly.offset = this->m_codeRegion[0] + address + usedBytes;
-                        disassembly.size = instructions[instr].size;
-                        disassembly.mnemonic = instructions[instr].mnemonic;
-                        disassembly.operators = instructions[instr].op_str;
+                TaskManager::runParallel(std::min<u64>(TaskManager::getWorkerCount(), chunkCount), [&](u32) {
+                    csh capstoneHandle;
+                    if (cs_open(architecture, mode, &capstoneHandle) != CS_ERR_OK)
+                        return;
+                    SCOPE_EXIT( cs_close(&capstoneHandle); );
 
-                        for (u8 i = 0; i < instructions[instr].size; i++)
-                            disassembly.bytes += hex::format("{0:02X} ", instructions[instr].bytes[i]);
-                        disassembly.bytes.pop_back();
+                    cs_insn *instruction = cs_malloc(capstoneHandle);
+                    if (instruction == nullptr)
+                        return;
+                    SCOPE_EXIT( cs_free(instruction, 1); );
 
-                        this->m_disassembly.push_back(disassembly);
+                    // Searchers build their DFA while searching, so every worker needs its own
+                    RegexSearcher searcher(pattern, true);
 
-                        usedBytes += instructions[instr].size;
+                    for (u64 i = nextChunk++; i < chunkCount && !task.isInterrupted(); i = nextChunk++) {
+                        u64 end = std::min<u64>((i + 1) * CandidatesPerChunk, candidates.size());
+                        for (u64 j = i * CandidatesPerChunk; j < end; j++) {
+                            if (!decodeInstruction(capstoneHandle, handle.get(), regionStart, regionSize, baseAddress, candidates[j], instruction))
+                                continue;
+
+                            bool found = false;
+                            searcher.searchBuffer(reinterpret_cast<const u8*>(instruction->op_str), std::strlen(instruction->op_str), 0, [&](u64, size_t) {
+                                found = true;
+                                return false;
+                            });
+
+                            if (found)
+                                chunkResults[i].push_back(candidates[j]);
+                        }
+
+                        task.update(i);
                     }
+                });
+
+                for (auto &chunk : chunkResults)
+                    results.insert(results.end(), chunk.begin(), chunk.end());
+            }
+
+            if (task.isInterrupted())
+                return;
+
+            std::scoped_lock lock(this->m_searchMutex);
+            this->m_searchResults = std::move(results);
+        });
+    }
 
-                    if (instructionCount < bufferSize)
-                        address -= (bufferSize - usedBytes);
+    void ViewDisassembler::drawSearch() {
+        ImGui::TextUnformatted("hex.view.disassembler.search.title"_lang);
+        ImGui::Separator();
 
-                    cs_free(instructions, instructionCount);
+        bool search = ImGui::InputText("hex.view.disassembler.search.mnemonic"_lang, this->m_searchMnemonic, ImGuiInputTextFlags_EnterReturnsTrue);
+        search = ImGui::InputText("hex.view.disassembler.search.operands"_lang, this->m_searchOperands, ImGuiInputTextFlags_EnterReturnsTrue) || search;
+
+        if (!this->m_searchError.empty())
+            ImGui::TextColored(ImGui::GetStyleColorVec4(ImGuiCol_PlotLinesHovered), "%s", this->m_searchError.c_str());
+
+        if (this->m_disassemblerTask.isRunning()) {
+            ImGui::TextSpinner("hex.view.disassembler.references.indexing"_lang);
+            return;
+        }
+
+        ImGui::Disabled([&] {
+            if (ImGui::Button("hex.view.disassembler.search.find"_lang) || search)
+                this->searchInstructions();
+        }, this->m_searchTask.isRunning());
+
+        if (this->m_searchTask.isRunning()) {
+            ImGui::SameLine();
+            ImGui::TextSpinner("hex.view.disassembler.search.searching"_lang);
+            return;
+        }
+
+        std::scoped_lock lock(this->m_searchMutex);
+
+        ImGui::SameLine();
+        ImGui::TextUnformatted(hex::format("hex.view.disassembler.search.count"_lang, this->m_searchResults.size()).c_str());
+
+        if (this->m_searchResults.empty() || !this->m_capstoneHandleOpen)
+            return;
+
+        cs_insn *instruction = cs_malloc(this->m_capstoneHandle);
+        if (instruction == nullptr)
+            return;
+        SCOPE_EXIT( cs_free(instruction, 1); );
+
+        if (ImGui::BeginChild("##search_results", ImVec2(0, ImGui::GetTextLineHeightWithSpacing() * 6), true)) {
+            ImGuiListClipper clipper;
+            clipper.Begin(std::min<u64>(this->m_searchResults.size(), std::numeric_limits<int>::max()));
+
+            while (clipper.Step()) {
+                for (u64 i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
+                    u64 offset = this->m_searchResults[i];
+                    if (!decodeInstruction(this->m_capstoneHandle, SharedData::currentProvider, this->m_indexedRegionStart, this->m_indexedRegionSize, this->m_indexedBaseAddress, offset, instruction))
+                        continue;
+
+                    ImGui::PushID(static_cast<int>(i));
+                    if (ImGui::Selectable(hex::format("0x{:08X}  {} {}", instruction->address, instruction->mnemonic, instruction->op_str).c_str())) {
+                        Region selectRegion = { this->m_indexedRegionStart + offset, instruction->size };
+                        View::postEvent(Events::SelectionChangeRequest, selectRegion);
+                    }
+                    ImGui::PopID();
                 }
+            }
+
+            clipper.End();
+        }
+        ImGui::EndChild();
+    }
+
+    void ViewDisassembler::drawEntryPoints() {
+        ImGui::Checkbox("hex.view.disassembler.recursive"_lang, &this->m_recursiveDescent);
+        if (!this->m_recursiveDescent)
+            return;
+
+        ImGui::InputScalar("##entry_point", ImGuiDataType_U64, &this->m_newEntryPoint, nullptr, nullptr, "%08llX", ImGuiInputTextFlags_CharsHexadecimal);
+        ImGui::SameLine();
+        if (ImGui::Button("hex.view.disassembler.entry_points.add"_lang) && std::find(this->m_entryPoints.begin(), this->m_entryPoints.end(), this->m_newEntryPoint) == this->m_entryPoints.end())
+            this->m_entryPoints.push_back(this->m_newEntryPoint);
 
-                cs_close(&capstoneHandle);
+        if (this->m_entryPoints.empty()) {
+            ImGui::TextUnformatted("hex.view.disassembler.entry_points.none"_lang);
+            return;
+        }
+
+        if (ImGui::BeginChild("##entry_points", ImVec2(0, ImGui::GetTextLineHeightWithSpacing() * 4), true)) {
+            for (auto it = this->m_entryPoints.begin(); it != this->m_entryPoints.end(); ) {
+                ImGui::PushID(&*it);
+                bool remove = ImGui::SmallButton("x");
+                ImGui::SameLine();
+                ImGui::Text("0x%08llX", *it);
+                ImGui::PopID();
+
+                if (remove)
+                    it = this->m_entryPoints.erase(it);
+                else
+                    ++it;
             }
+        }
+        ImGui::EndChild();
+    }
 
-            this->m_disassembling = false;
-        }).detach();
+    void ViewDisassembler::updateHighlights() {
+        if (this->m_highlightsVersion == this->m_resultsVersion)
+            return;
 
+        std::vector<ImHexApi::Highlighting::Entry> highlights;
+        {
+            std::scoped_lock lock(this->m_indexMutex);
+            highlights = this->m_codeHighlights;
+            this->m_highlightsVersion = this->m_resultsVersion;
+        }
+
+        if (highlights.empty())
+            ImHexApi::Highlighting::clear(HighlightName);
+        else
+            ImHexApi::Highlighting::set(HighlightName, std::move(highlights));
     }
 
     void ViewDisassembler::drawContent() {
+        this->updateHighlights();
 
         if (ImGui::Begin(View::toWindowName("hex.view.disassembler.name").c_str(), &this->getWindowOpenState(), ImGuiWindowFlags_NoCollapse)) {
+            this->refreshContent([this] {
+                if (this->m_capstoneHandleOpen)
+                    this->disassemble();
+            });
 
             auto provider = SharedData::currentProvider;
             if (provider != nullptr && provider->isReadable()) {
@@ -242,18 +1252,28 @@ namespace hex {
                 }
                 ImGui::EndChild();
 
+                this->drawEntryPoints();
+
                 ImGui::Disabled([this] {
                     if (ImGui::Button("hex.view.disassembler.disassemble"_lang))
                         this->disassemble();
-                }, this->m_disassembling);
+                }, this->m_disassemblerTask.isRunning());
 
-                if (this->m_disassembling) {
+                if (this->m_disassemblerTask.isRunning()) {
                     ImGui::SameLine();
                     ImGui::TextSpinner("hex.view.disassembler.disassembling"_lang);
                 }
 
                 ImGui::NewLine();
 
+                this->drawReferences();
+
+                ImGui::NewLine();
+
+                this->drawSearch();
+
+                ImGui::NewLine();
+
                 ImGui::TextUnformatted("hex.view.disassembler.disassembly.title"_lang);
                 ImGui::Separator();
 
@@ -265,27 +1285,41 @@ namespace hex {
                     ImGui::TableSetupColumn("hex.view.disassembler.disassembly.title"_lang);
 
                     ImGuiListClipper clipper;
-                    clipper.Begin(this->m_disassembly.size());
+                    clipper.Begin(std::min<u64>(this->m_instructionCount, std::numeric_limits<int>::max()));
 
                     ImGui::TableHeadersRow();
                     while (clipper.Step()) {
+                        this->decodeWindow(clipper.DisplayStart, clipper.DisplayEnd - clipper.DisplayStart);
+
                         for (u64 i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
+                            if (i < this->m_windowStart || i >= this->m_windowStart + this->m_window.size()) {
+                                ImGui::TableNextRow();
+                                continue;
+                            }
+
+                            const auto &disassembly = this->m_window[i - this->m_windowStart];
+
                             ImGui::TableNextRow();
                             ImGui::TableNextColumn();
                             if (ImGui::Selectable(("##DisassemblyLine"s + std::to_string(i)).c_str(), false, ImGuiSelectableFlags_SpanAllColumns)) {
-                                Region selectRegion = { this->m_disassembly[i].offset, this->m_disassembly[i].size };
+                                Region selectRegion = { disassembly.offset, disassembly.size };
                                 View::postEvent(Events::SelectionChangeRequest, selectRegion);
                             }
+                            if (ImGui::BeginPopupContextItem()) {
+                                if (ImGui::MenuItem("hex.view.disassembler.references.find"_lang))
+                                    this->findReferences(disassembly.address);
+                                ImGui::EndPopup();
+                            }
                             ImGui::SameLine();
-                            ImGui::Text("0x%llx", this->m_disassembly[i].address);
+                            ImGui::Text("0x%llx", disassembly.address);
                             ImGui::TableNextColumn();
-                            ImGui::Text("0x%llx", this->m_disassembly[i].offset);
+                            ImGui::Text("0x%llx", disassembly.offset);
                             ImGui::TableNextColumn();
-                            ImGui::TextUnformatted(this->m_disassembly[i].bytes.c_str());
+                            ImGui::TextUnformatted(&this->m_windowStrings[disassembly.bytes]);
                             ImGui::TableNextColumn();
-                            ImGui::TextColored(ImColor(0xFFD69C56), "%s", this->m_disassembly[i].mnemonic.c_str());
+                            ImGui::TextColored(ImColor(0xFFD69C56), "%s", &this->m_windowStrings[disassembly.mnemonic]);
                             ImGui::SameLine();
-                            ImGui::TextUnformatted(this->m_disassembly[i].operators.c_str());
+                            ImGui::TextUnformatted(&this->m_windowStrings[disassembly.operators]);
                         }
                     }
 
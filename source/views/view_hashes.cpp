@@ -1,224 +1,608 @@
 #include "views/view_hashes.hpp"
 
+#include <hex/api/imhex_api.hpp>
 #include <hex/providers/provider.hpp>
 #include <hex/helpers/utils.hpp>
 #include <hex/helpers/crypto.hpp>
+#include <hex/lang/pattern_data.hpp>
 
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <numeric>
+#include <span>
 #include <vector>
 
+#include <imgui_imhex_extensions.h>
+
 
 namespace hex {
 
-    ViewHashes::ViewHashes() : View("hex.view.hashes.name") {
-        View::subscribeEvent(Events::DataChanged, [this](auto) {
-            this->m_shouldInvalidate = true;
-        });
+    /* Hash regions are absolute so they can span more than the page currently shown in the hex editor */
+    static u64 getPageAddress() {
+        auto provider = SharedData::currentProvider;
+        if (provider == nullptr)
+            return 0;
+
+        return u64(provider->getCurrentPage()) * prv::Provider::PageSize;
+    }
 
-        View::subscribeEvent(Events::RegionSelected, [this](auto userData) {
-            auto region = std::any_cast<const Region>(userData);
+    static std::string toHexString(const std::vector<u8> &bytes) {
+        std::string result;
+        for (u8 byte : bytes)
+            result += hex::format("{:02X}", byte);
+
+        return result;
+    }
+
+    ViewHashes::ViewHashes(std::vector<lang::PatternData*> &patternData) : View("hex.view.hashes.name"), m_patternData(patternData) {
+        View::subscribeEvent(Events::DataChanged, [this](auto userData) {
+            // Edits tell which region changed, anything else might have changed everything. Those regions are page relative
+            if (auto region = std::any_cast<Region>(&userData); region != nullptr)
+                this->m_changedRegions.push_back({ region->address + getPageAddress(), region->size });
+            else
+                this->m_shouldInvalidate = true;
+        });
 
+        View::subscribeEvent<Region>(Events::RegionSelected, [this](const Region &region) {
             if (this->m_shouldMatchSelection) {
-                this->m_hashRegion[0] = region.address;
-                this->m_hashRegion[1] = region.address + region.size - 1;
+                this->m_hashRegion[0] = region.address + getPageAddress();
+                this->m_hashRegion[1] = region.address + getPageAddress() + region.size - 1;
                 this->m_shouldInvalidate = true;
+                this->m_lastRegionChange = std::chrono::steady_clock::now();
             }
         });
+
+        View::subscribeEvent<prv::Provider*>(Events::ProviderChanged, [this](prv::Provider *previous) {
+            this->switchProvider(previous);
+
+            this->stopBatch();
+            this->m_batchEntries.clear();
+        });
+
+        View::subscribeEvent<prv::Provider*>(Events::ProviderClosed, [this](prv::Provider *provider) {
+            this->m_cachedHashes.erase(provider);
+        });
+
+        // Other views hand over the regions they found, e.g. the YARA matches
+        View::subscribeEvent<std::vector<std::pair<std::string, Region>>>(Events::HashRegions, [this](const std::vector<std::pair<std::string, Region>> &regions) {
+            this->getWindowOpenState() = true;
+            this->startBatch({ regions.begin(), regions.end() });
+        });
     }
 
     ViewHashes::~ViewHashes() {
+        this->m_hashingTask.interrupt();
+        this->m_hashingTask.wait();
+        this->stopBatch();
+
         View::unsubscribeEvent(Events::DataChanged);
         View::unsubscribeEvent(Events::RegionSelected);
+        View::unsubscribeEvent(Events::ProviderChanged);
+        View::unsubscribeEvent(Events::ProviderClosed);
+        View::unsubscribeEvent(Events::HashRegions);
     }
 
+    void ViewHashes::switchProvider(prv::Provider *previous) {
+        this->m_hashingTask.interrupt();
+        this->m_hashingTask.wait();
 
-    template<size_t Size>
-    static void formatBigHexInt(std::array<u8, Size> dataArray, char *buffer, size_t bufferSize) {
-        for (int i = 0; i < dataArray.size(); i++)
-            snprintf(buffer + 2 * i, bufferSize - 2 * i, "%02X", dataArray[i]);
+        // Whatever finished before the switch still belongs to the previous provider, so do edits that weren't applied yet
+        this->collectHashResults();
+        if (previous != nullptr && !this->m_shouldInvalidate) {
+            this->applyDataChanges(previous);
+            this->m_cachedHashes[previous] = { { this->m_hashRegion[0], this->m_hashRegion[1] }, this->m_hashJobs };
+        }
+
+        this->m_changedRegions.clear();
+        this->m_hashGeneration++;
+
+        auto it = this->m_cachedHashes.find(SharedData::currentProvider);
+        if (it == this->m_cachedHashes.end()) {
+            this->m_shouldInvalidate = true;
+            return;
+        }
+
+        // Hash functions added or removed in the meantime are added to or removed from the cached results as well
+        auto &cached = it->second;
+        for (auto &job : this->m_hashJobs) {
+            auto cachedJob = std::find_if(cached.hashJobs.begin(), cached.hashJobs.end(), [id = job.id](const auto &entry) { return entry.id == id; });
+
+            if (cachedJob != cached.hashJobs.end()) {
+                job.result = std::move(cachedJob->result);
+                job.tree = std::move(cachedJob->tree);
+            } else {
+                job.result.reset();
+                job.tree.reset();
+            }
+        }
+
+        this->m_hashRegion[0] = cached.hashRegion[0];
+        this->m_hashRegion[1] = cached.hashRegion[1];
+        this->m_shouldInvalidate = false;
+        this->m_shouldHash = true;
+
+        this->m_cachedHashes.erase(it);
     }
 
-    void ViewHashes::drawContent() {
-        if (ImGui::Begin(View::toWindowName("hex.view.hashes.name").c_str(), &this->getWindowOpenState(), ImGuiWindowFlags_NoCollapse)) {
-            ImGui::BeginChild("##scrolling", ImVec2(0, 0), false, ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoNav);
 
-            auto provider = SharedData::currentProvider;
-            if (provider != nullptr && provider->isAvailable()) {
+    void ViewHashes::startHashing() {
+        u64 offset = this->m_hashRegion[0];
+        u64 size = this->m_hashRegion[1] - this->m_hashRegion[0] + 1;
 
-                ImGui::TextUnformatted("hex.common.region"_lang);
-                ImGui::Separator();
+        std::vector<u32> ids;
+        std::vector<crypt::HashRequest> requests;
+        for (const auto &job : this->m_hashJobs) {
+            if (!job.result.has_value()) {
+                auto request = job.request;
+                if (crypt::HashTree::isSupported(request.function))
+                    request.tree = std::make_shared<crypt::HashTree>(request.function, request.polynomial, request.init, size);
 
-                ImGui::InputScalarN("##nolabel", ImGuiDataType_U64, this->m_hashRegion, 2, nullptr, nullptr, "%08X", ImGuiInputTextFlags_CharsHexadecimal);
-                if (ImGui::IsItemEdited()) this->m_shouldInvalidate = true;
+                ids.push_back(job.id);
+                requests.push_back(std::move(request));
+            }
+        }
 
-                ImGui::Checkbox("hex.common.match_selection"_lang, &this->m_shouldMatchSelection);
-                if (ImGui::IsItemEdited()) this->m_shouldInvalidate = true;
+        if (requests.empty())
+            return;
 
-                ImGui::NewLine();
-                ImGui::TextUnformatted("hex.view.hashes.settings"_lang);
-                ImGui::Separator();
+        this->m_hashedBytes = 0;
+        this->m_hashingSize = size;
 
-                if (ImGui::Combo("hex.view.hashes.function"_lang, &this->m_currHashFunction, HashFunctionNames,sizeof(HashFunctionNames) / sizeof(const char *)))
-                    this->m_shouldInvalidate = true;
+        this->m_hashingTask = TaskManager::createTask("hex.view.hashes.hashing", 0, [this, ids = std::move(ids), requests = std::move(requests), offset, size, generation = this->m_hashGeneration, handle = ImHexApi::Provider::getHandle()](Task &task) {
+            auto provider = handle.get();
+            auto results = crypt::hashRegion(provider, offset, size, requests, task.getInterruptFlag(), &this->m_hashedBytes);
 
-                size_t dataSize = provider->getSize();
-                if (this->m_hashRegion[1] >= dataSize)
-                    this->m_hashRegion[1] = dataSize - 1;
+            {
+                std::scoped_lock lock(this->m_hashResultsMutex);
+                for (size_t i = 0; i < results.size(); i++)
+                    this->m_pendingHashResults.emplace_back(ids[i], std::move(results[i]), requests[i].tree);
+                this->m_pendingHashGeneration = generation;
+            }
+        });
+    }
+
+    void ViewHashes::collectHashResults() {
+        std::scoped_lock lock(this->m_hashResultsMutex);
+
+        // Results of a run that got started before the region or the data changed are outdated
+        if (this->m_pendingHashGeneration == this->m_hashGeneration) {
+            for (auto &[id, result, tree] : this->m_pendingHashResults) {
+                auto job = std::find_if(this->m_hashJobs.begin(), this->m_hashJobs.end(), [id = id](const auto &job) { return job.id == id; });
+                if (job != this->m_hashJobs.end()) {
+                    job->result = std::move(result);
+                    job->tree = std::move(tree);
+                }
+            }
+        }
 
+        this->m_pendingHashResults.clear();
+    }
 
-                if (this->m_hashRegion[1] >= this->m_hashRegion[0]) {
+    void ViewHashes::applyDataChanges(prv::Provider *provider) {
+        if (this->m_changedRegions.empty())
+            return;
 
-                    switch (this->m_currHashFunction) {
-                        case 0: // CRC16
-                        {
-                            static int polynomial = 0, init = 0;
+        auto changes = std::move(this->m_changedRegions);
+        this->m_changedRegions.clear();
 
-                            ImGui::InputInt("hex.view.hashes.iv"_lang, &init, 0, 0, ImGuiInputTextFlags_CharsHexadecimal);
-                            if (ImGui::IsItemEdited()) this->m_shouldInvalidate = true;
+        u64 regionStart = this->m_hashRegion[0], regionEnd = this->m_hashRegion[1];
+        if (regionEnd < regionStart)
+            return;
 
-                            ImGui::InputInt("hex.view.hashes.poly"_lang, &polynomial, 0, 0, ImGuiInputTextFlags_CharsHexadecimal);
-                            if (ImGui::IsItemEdited()) this->m_shouldInvalidate = true;
+        for (const auto &change : changes) {
+            if (change.size == 0 || change.address > regionEnd || change.address + change.size <= regionStart)
+                continue;
 
-                            ImGui::NewLine();
+            // A run that's in progress might have read the old data already
+            if (this->m_hashingTask.isRunning()) {
+                this->m_shouldInvalidate = true;
+                return;
+            }
 
-                            static u16 result = 0;
+            u64 offset = std::max(change.address, regionStart) - regionStart;
+            u64 size = std::min(change.address + change.size - 1, regionEnd) - regionStart + 1 - offset;
+
+            // Jobs with a hash tree only need the changed leaves hashed again, everything else starts over
+            for (auto &job : this->m_hashJobs) {
+                if (!job.result.has_value())
+                    continue;
+
+                if (job.tree != nullptr && size <= MaxIncrementalRehashSize) {
+                    job.tree->rehash(provider, regionStart, offset, size);
+                    job.result = job.tree->getResult();
+                } else {
+                    job.result.reset();
+                    job.tree.reset();
+                    this->m_shouldHash = true;
+                }
+            }
+        }
+    }
 
-                            if (this->m_shouldInvalidate)
-                                result = crypt::crc16(provider, this->m_hashRegion[0], this->m_hashRegion[1] - this->m_hashRegion[0] + 1, polynomial, init);
+    std::string ViewHashes::getHashFunctionName(const crypt::HashRequest &request) {
+        if (request.function == crypt::HashFunction::CRC16 || request.function == crypt::HashFunction::CRC32)
+            return hex::format("{} (0x{:X}, 0x{:X})", HashFunctionNames[u8(request.function)], request.polynomial, request.init);
+        else
+            return HashFunctionNames[u8(request.function)];
+    }
 
-                            char buffer[sizeof(result) * 2 + 1];
-                            snprintf(buffer, sizeof(buffer), "%04X", result);
+    std::vector<std::pair<std::string, Region>> ViewHashes::getPatternRegions() const {
+        std::vector<std::pair<std::string, Region>> regions;
+
+        // Arrays are what batches are most useful for, so they get one region per entry instead of a single one for all of them
+        for (const auto &pattern : this->m_patternData) {
+            if (auto array = dynamic_cast<lang::PatternDataArray*>(pattern); array != nullptr) {
+                for (const auto &entry : array->getEntries())
+                    regions.emplace_back(array->getVariableName() + entry->getVariableName(), Region { entry->getOffset(), entry->getSize() });
+            } else if (auto staticArray = dynamic_cast<lang::PatternDataStaticArray*>(pattern); staticArray != nullptr) {
+                auto entrySize = staticArray->getTemplate()->getSize();
+                for (u64 i = 0; i < staticArray->getEntryCount(); i++)
+                    regions.emplace_back(hex::format("{}[{}]", staticArray->getVariableName(), i), Region { staticArray->getOffset() + i * entrySize, entrySize });
+            } else {
+                regions.emplace_back(pattern->getVariableName(), Region { pattern->getOffset(), pattern->getSize() });
+            }
+        }
 
-                            ImGui::TextUnformatted("hex.view.hashes.result"_lang);
-                            ImGui::Separator();
-                            ImGui::InputText("##nolabel", buffer, ImGuiInputTextFlags_ReadOnly);
-                        }
-                            break;
-                        case 1: // CRC32
-                        {
-                            static int polynomial = 0, init = 0;
+        return regions;
+    }
 
-                            ImGui::InputInt("hex.view.hashes.iv"_lang, &init, 0, 0, ImGuiInputTextFlags_CharsHexadecimal);
-                            if (ImGui::IsItemEdited()) this->m_shouldInvalidate = true;
+    void ViewHashes::stopBatch() {
+        this->m_batchTask.interrupt();
+        this->m_batchTask.wait();
+    }
 
-                            ImGui::InputInt("hex.view.hashes.poly"_lang, &polynomial, 0, 0, ImGuiInputTextFlags_CharsHexadecimal);
-                            if (ImGui::IsItemEdited()) this->m_shouldInvalidate = true;
+    void ViewHashes::startBatch(std::vector<std::pair<std::string, Region>> &&regions) {
+        this->stopBatch();
 
-                            ImGui::NewLine();
+        auto provider = SharedData::currentProvider;
+        if (provider == nullptr || !provider->isAvailable())
+            return;
 
-                            static u32 result = 0;
+        std::vector<crypt::HashRequest> requests;
+        this->m_batchFunctionNames.clear();
+        for (const auto &job : this->m_hashJobs) {
+            requests.push_back(job.request);
+            this->m_batchFunctionNames.push_back(getHashFunctionName(job.request));
+        }
 
-                            if (this->m_shouldInvalidate)
-                                result = crypt::crc32(provider, this->m_hashRegion[0], this->m_hashRegion[1] - this->m_hashRegion[0] + 1, polynomial, init);
+        // Regions reaching past the end of the data only get the part that exists hashed
+        size_t dataSize = provider->getActualSize();
+        this->m_batchEntries.clear();
+        for (auto &[name, region] : regions) {
+            if (region.size == 0 || region.address >= dataSize)
+                continue;
 
-                            char buffer[sizeof(result) * 2 + 1];
-                            snprintf(buffer, sizeof(buffer), "%08X", result);
+            this->m_batchEntries.push_back({ std::move(name), { region.address, std::min<size_t>(region.size, dataSize - region.address) }, { } });
+        }
 
-                            ImGui::TextUnformatted("hex.view.hashes.result"_lang);
-                            ImGui::Separator();
-                            ImGui::InputText("##nolabel", buffer, ImGuiInputTextFlags_ReadOnly);
+        this->m_batchSortOrder.resize(this->m_batchEntries.size());
+        std::iota(this->m_batchSortOrder.begin(), this->m_batchSortOrder.end(), 0);
+        this->m_batchSortDirty = true;
+        this->m_batchHashedRegions = 0;
+
+        if (requests.empty() || this->m_batchEntries.empty())
+            return;
+
+        // The entries don't get touched by anything else until the task is done, every worker only writes the results of the entries it took
+        this->m_batchTask = TaskManager::createTask("hex.view.hashes.batch.hashing", this->m_batchEntries.size(), [this, requests = std::move(requests), handle = ImHexApi::Provider::getHandle()](Task &task) {
+            auto provider = handle.get();
+            auto &entries = this->m_batchEntries;
+            std::atomic<u64> nextEntry = 0;
+
+            /*
+                Regions are handed out one at a time so a few large ones don't leave the other workers idle.
+                Providers that are slow to jump around in get one worker, which reads the regions one after the other
+            */
+            u32 workerCount = provider->hasCapability(prv::Provider::Capability::CheapRandomAccess) ? provider->getReadWorkerCount() : 1;
+            TaskManager::runParallel(std::min<u64>(workerCount, entries.size()), [&](u32) {
+                std::vector<u8> buffer;
+
+                for (u64 i = nextEntry++; i < entries.size(); i = nextEntry++) {
+                    auto &entry = entries[i];
+
+                    std::vector<std::unique_ptr<crypt::Digest>> digests;
+                    for (const auto &request : requests)
+                        digests.push_back(std::make_unique<crypt::Digest>(request, entry.region.size));
+
+                    // Every block gets read once for all hash functions
+                    for (u64 offset = 0; offset < entry.region.size; offset += crypt::Digest::DefaultBlockSize) {
+                        if (task.isInterrupted())
+                            return;
+
+                        u64 blockAddress = entry.region.address + offset;
+                        size_t blockSize = std::min<u64>(crypt::Digest::DefaultBlockSize, entry.region.size - offset);
+
+                        std::span<const u8> block;
+                        if (auto view = provider->getAbsoluteDirectView(blockAddress, blockSize); view.has_value()) {
+                            block = *view;
+                        } else {
+                            buffer.resize(blockSize);
+                            provider->readAbsolute(blockAddress, buffer.data(), buffer.size());
+                            block = buffer;
                         }
-                            break;
-                        case 2: // MD5
-                        {
-                            static std::array<u8, 16> result = { 0 };
 
-                            if (this->m_shouldInvalidate)
-                                result = crypt::md5(provider, this->m_hashRegion[0], this->m_hashRegion[1] - this->m_hashRegion[0] + 1);
+                        for (auto &digest : digests)
+                            digest->update(block);
+                    }
 
-                            char buffer[sizeof(result) * 2 + 1];
-                            formatBigHexInt(result, buffer, sizeof(buffer));
+                    for (auto &digest : digests)
+                        entry.results.push_back(digest->finish());
 
-                            ImGui::NewLine();
-                            ImGui::TextUnformatted("hex.view.hashes.result"_lang);
-                            ImGui::Separator();
-                            ImGui::InputText("##nolabel", buffer, ImGuiInputTextFlags_ReadOnly);
-                        }
-                            break;
-                        case 3: // SHA-1
-                        {
-                            static std::array<u8, 20> result = { 0 };
+                    task.update(++this->m_batchHashedRegions);
+                }
+            });
 
-                            if (this->m_shouldInvalidate)
-                                result = crypt::sha1(provider, this->m_hashRegion[0], this->m_hashRegion[1] - this->m_hashRegion[0] + 1);
+            View::requestRedraw();
+        });
+    }
 
-                            char buffer[sizeof(result) * 2 + 1];
-                            formatBigHexInt(result, buffer, sizeof(buffer));
+    void ViewHashes::exportBatch(const std::string &path) {
+        FILE *file = fopen(path.c_str(), "wb");
+        if (file == nullptr) {
+            View::showErrorPopup("hex.view.hashes.batch.export.error"_lang);
+            return;
+        }
+        SCOPE_EXIT( fclose(file); );
+
+        // Names are quoted since pattern and rule names may contain commas
+        auto quote = [](const std::string &string) {
+            std::string result = "\"";
+            for (char c : string) {
+                if (c == '"')
+                    result += '"';
+                result += c;
+            }
 
-                            ImGui::NewLine();
-                            ImGui::TextUnformatted("hex.view.hashes.result"_lang);
-                            ImGui::Separator();
-                            ImGui::InputText("##nolabel", buffer, ImGuiInputTextFlags_ReadOnly);
-                        }
-                            break;
-                        case 4: // SHA-224
-                        {
-                            static std::array<u8, 28> result = { 0 };
+            return result + "\"";
+        };
 
-                            if (this->m_shouldInvalidate)
-                                result = crypt::sha224(provider, this->m_hashRegion[0], this->m_hashRegion[1] - this->m_hashRegion[0] + 1);
+        std::string line = "Name,Address,Size";
+        for (const auto &name : this->m_batchFunctionNames)
+            line += "," + quote(name);
+        line += "\n";
+        fwrite(line.data(), 1, line.size(), file);
 
-                            char buffer[sizeof(result) * 2 + 1];
-                            formatBigHexInt(result, buffer, sizeof(buffer));
+        for (u32 index : this->m_batchSortOrder) {
+            const auto &entry = this->m_batchEntries[index];
 
-                            ImGui::NewLine();
-                            ImGui::TextUnformatted("hex.view.hashes.result"_lang);
-                            ImGui::Separator();
-                            ImGui::InputText("##nolabel", buffer, ImGuiInputTextFlags_ReadOnly);
-                        }
-                            break;
-                        case 5: // SHA-256
-                        {
-                            static std::array<u8, 32> result;
+            line = hex::format("{},0x{:X},0x{:X}", quote(entry.name), entry.region.address, entry.region.size);
+            for (const auto &result : entry.results)
+                line += "," + toHexString(result);
+            line += "\n";
 
-                            if (this->m_shouldInvalidate)
-                                result = crypt::sha256(provider, this->m_hashRegion[0], this->m_hashRegion[1] - this->m_hashRegion[0] + 1);
+            fwrite(line.data(), 1, line.size(), file);
+        }
+    }
 
-                            char buffer[sizeof(result) * 2 + 1];
-                            formatBigHexInt(result, buffer, sizeof(buffer));
+    void ViewHashes::drawBatch() {
+        ImGui::NewLine();
+        ImGui::TextUnformatted("hex.view.hashes.batch"_lang);
+        ImGui::Separator();
 
-                            ImGui::NewLine();
-                            ImGui::TextUnformatted("hex.view.hashes.result"_lang);
-                            ImGui::Separator();
-                            ImGui::InputText("##nolabel", buffer, ImGuiInputTextFlags_ReadOnly);
-                        }
-                            break;
-                        case 6: // SHA-384
-                        {
-                            static std::array<u8, 48> result;
+        ImGui::Disabled([this] {
+            if (ImGui::Button("hex.view.hashes.batch.bookmarks"_lang)) {
+                std::vector<std::pair<std::string, Region>> regions;
+                for (const auto &bookmark : ImHexApi::Bookmarks::getEntries())
+                    regions.emplace_back(bookmark.name.data(), bookmark.region);
 
-                            if (this->m_shouldInvalidate)
-                                result = crypt::sha384(provider, this->m_hashRegion[0], this->m_hashRegion[1] - this->m_hashRegion[0] + 1);
+                this->startBatch(std::move(regions));
+            }
+            ImGui::SameLine();
+            if (ImGui::Button("hex.view.hashes.batch.patterns"_lang))
+                this->startBatch(this->getPatternRegions());
+        }, this->m_hashJobs.empty() || this->m_batchTask.isRunning());
+
+        if (this->m_batchTask.isRunning()) {
+            ImGui::ProgressBar(float(this->m_batchHashedRegions) / this->m_batchEntries.size(), ImVec2(200, 0));
+            ImGui::SameLine();
+            ImGui::PushID("batch");
+            if (ImGui::Button("hex.common.cancel"_lang))
+                this->m_batchTask.interrupt();
+            ImGui::PopID();
+
+            return;
+        }
+
+        if (this->m_batchEntries.empty())
+            return;
 
-                            char buffer[sizeof(result) * 2 + 1];
-                            formatBigHexInt(result, buffer, sizeof(buffer));
+        ImGui::SameLine();
+        if (ImGui::Button("hex.view.hashes.batch.export"_lang)) {
+            View::openFileBrowser("hex.view.hashes.batch.export"_lang, DialogMode::Save, { { "CSV", "csv" } }, [this](auto path) {
+                this->exportBatch(path);
+            });
+        }
 
-                            ImGui::NewLine();
-                            ImGui::TextUnformatted("hex.view.hashes.result"_lang);
-                            ImGui::Separator();
-                            ImGui::InputText("##nolabel", buffer, ImGuiInputTextFlags_ReadOnly);
+        if (ImGui::BeginTable("##batch", 3 + this->m_batchFunctionNames.size(), ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_Resizable | ImGuiTableFlags_Sortable | ImGuiTableFlags_ScrollX | ImGuiTableFlags_ScrollY)) {
+            ImGui::TableSetupScrollFreeze(1, 1);
+            ImGui::TableSetupColumn("hex.view.hashes.batch.name"_lang, ImGuiTableColumnFlags_DefaultSort);
+            ImGui::TableSetupColumn("hex.common.address"_lang);
+            ImGui::TableSetupColumn("hex.common.size"_lang);
+            for (const auto &name : this->m_batchFunctionNames)
+                ImGui::TableSetupColumn(name.c_str());
+
+            auto sortSpecs = ImGui::TableGetSortSpecs();
+            if (sortSpecs != nullptr && sortSpecs->SpecsCount > 0 && (sortSpecs->SpecsDirty || this->m_batchSortDirty)) {
+                const auto &spec = sortSpecs->Specs[0];
+                const bool ascending = spec.SortDirection == ImGuiSortDirection_Ascending;
+
+                auto compare = [ascending](const auto &left, const auto &right) {
+                    return ascending ? left < right : right < left;
+                };
+
+                std::stable_sort(this->m_batchSortOrder.begin(), this->m_batchSortOrder.end(), [&](u32 leftIndex, u32 rightIndex) {
+                    const auto &left = this->m_batchEntries[leftIndex];
+                    const auto &right = this->m_batchEntries[rightIndex];
+
+                    switch (spec.ColumnIndex) {
+                        case 0:  return compare(left.name, right.name);
+                        case 1:  return compare(left.region.address, right.region.address);
+                        case 2:  return compare(left.region.size, right.region.size);
+                        default: {
+                            // Entries of a cancelled batch may not have all results
+                            size_t result = spec.ColumnIndex - 3;
+                            if (result >= left.results.size() || result >= right.results.size())
+                                return compare(left.results.size(), right.results.size());
+
+                            return compare(left.results[result], right.results[result]);
                         }
-                            break;
-                        case 7: // SHA-512
-                        {
-                            static std::array<u8, 64> result;
+                    }
+                });
+
+                sortSpecs->SpecsDirty = false;
+                this->m_batchSortDirty = false;
+            }
+
+            ImGui::TableHeadersRow();
+
+            ImGuiListClipper clipper;
+            clipper.Begin(this->m_batchSortOrder.size());
+
+            while (clipper.Step()) {
+                for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; row++) {
+                    const auto &entry = this->m_batchEntries[this->m_batchSortOrder[row]];
 
-                            if (this->m_shouldInvalidate)
-                                result = crypt::sha512(provider, this->m_hashRegion[0], this->m_hashRegion[1] - this->m_hashRegion[0] + 1);
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+                    ImGui::PushID(row);
+                    if (ImGui::Selectable(entry.name.c_str(), false, ImGuiSelectableFlags_SpanAllColumns))
+                        View::postEvent(Events::SelectionChangeRequest, entry.region);
+                    ImGui::PopID();
 
-                            char buffer[sizeof(result) * 2 + 1];
-                            formatBigHexInt(result, buffer, sizeof(buffer));
+                    ImGui::TableNextColumn();
+                    ImGui::Text("0x%llX : 0x%llX", entry.region.address, entry.region.address + entry.region.size - 1);
+                    ImGui::TableNextColumn();
+                    ImGui::Text("0x%lX", entry.region.size);
+
+                    for (const auto &result : entry.results) {
+                        ImGui::TableNextColumn();
+                        ImGui::TextUnformatted(toHexString(result).c_str());
+                    }
+                }
+            }
+
+            clipper.End();
+
+            ImGui::EndTable();
+        }
+    }
+
+    void ViewHashes::drawContent() {
+        if (ImGui::Begin(View::toWindowName("hex.view.hashes.name").c_str(), &this->getWindowOpenState(), ImGuiWindowFlags_NoCollapse)) {
+            ImGui::BeginChild("##scrolling", ImVec2(0, 0), false, ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoNav);
+
+            auto provider = SharedData::currentProvider;
+            if (provider != nullptr && provider->isAvailable()) {
+
+                ImGui::TextUnformatted("hex.common.region"_lang);
+                ImGui::Separator();
 
-                            ImGui::NewLine();
-                            ImGui::TextUnformatted("hex.view.hashes.result"_lang);
-                            ImGui::Separator();
-                            ImGui::InputText("##nolabel", buffer, ImGuiInputTextFlags_ReadOnly);
+                ImGui::InputScalarN("##nolabel", ImGuiDataType_U64, this->m_hashRegion, 2, nullptr, nullptr, "%08X", ImGuiInputTextFlags_CharsHexadecimal);
+                if (ImGui::IsItemEdited()) {
+                    this->m_shouldInvalidate = true;
+                    this->m_lastRegionChange = std::chrono::steady_clock::now();
+                }
+
+                ImGui::Checkbox("hex.common.match_selection"_lang, &this->m_shouldMatchSelection);
+                if (ImGui::IsItemEdited()) this->m_shouldInvalidate = true;
+
+                ImGui::NewLine();
+                ImGui::TextUnformatted("hex.view.hashes.settings"_lang);
+                ImGui::Separator();
+
+                ImGui::Combo("hex.view.hashes.function"_lang, &this->m_currHashFunction, HashFunctionNames, sizeof(HashFunctionNames) / sizeof(const char *));
+
+                auto function = crypt::HashFunction(this->m_currHashFunction);
+                if (function == crypt::HashFunction::CRC16 || function == crypt::HashFunction::CRC32) {
+                    ImGui::InputInt("hex.view.hashes.iv"_lang, &this->m_init, 0, 0, ImGuiInputTextFlags_CharsHexadecimal);
+                    ImGui::InputInt("hex.view.hashes.poly"_lang, &this->m_polynomial, 0, 0, ImGuiInputTextFlags_CharsHexadecimal);
+                }
+
+                if (ImGui::Button("hex.view.hashes.add"_lang)) {
+                    this->m_hashJobs.push_back({ this->m_nextJobId++, { function, u32(this->m_polynomial), u32(this->m_init) }, std::nullopt });
+                    this->m_shouldHash = true;
+                }
+
+                size_t dataSize = provider->getActualSize();
+                if (this->m_hashRegion[1] >= dataSize)
+                    this->m_hashRegion[1] = dataSize - 1;
+
+                if (this->m_shouldInvalidate) {
+                    this->m_hashGeneration++;
+                    this->m_hashingTask.interrupt();
+
+                    for (auto &job : this->m_hashJobs) {
+                        job.result.reset();
+                        job.tree.reset();
+                    }
+
+                    this->m_shouldInvalidate = false;
+                    this->m_shouldHash = true;
+                }
+
+                this->collectHashResults();
+                this->applyDataChanges(provider);
+
+                // Only jobs without a result get hashed, all of them together in a single pass over the region
+                // Wait for the selection to settle before hashing so dragging it doesn't start a new run every frame
+                bool regionSettled = std::chrono::steady_clock::now() - this->m_lastRegionChange >= RegionChangeDebounceTime;
+
+                if (this->m_shouldHash && regionSettled && !this->m_hashingTask.isRunning() && this->m_hashRegion[1] >= this->m_hashRegion[0]) {
+                    this->m_shouldHash = false;
+                    this->startHashing();
+                }
+
+                ImGui::NewLine();
+                ImGui::TextUnformatted("hex.view.hashes.result"_lang);
+                ImGui::Separator();
+
+                if (this->m_hashingTask.isRunning()) {
+                    ImGui::ProgressBar(this->m_hashingSize == 0 ? 1.0F : float(this->m_hashedBytes) / this->m_hashingSize, ImVec2(200, 0));
+                    ImGui::SameLine();
+                    if (ImGui::Button("hex.common.cancel"_lang))
+                        this->m_hashingTask.interrupt();
+                }
+
+                if (ImGui::BeginTable("##hashes", 3, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_Resizable)) {
+                    ImGui::TableSetupColumn("hex.view.hashes.function"_lang);
+                    ImGui::TableSetupColumn("hex.view.hashes.result"_lang, ImGuiTableColumnFlags_WidthStretch);
+                    ImGui::TableSetupColumn("##remove", ImGuiTableColumnFlags_WidthFixed);
+                    ImGui::TableHeadersRow();
+
+                    std::optional<u32> removedJob;
+                    for (auto &job : this->m_hashJobs) {
+                        ImGui::PushID(job.id);
+                        ImGui::TableNextRow();
+
+                        ImGui::TableNextColumn();
+                        ImGui::TextUnformatted(getHashFunctionName(job.request).c_str());
+
+                        ImGui::TableNextColumn();
+                        if (job.result.has_value()) {
+                            auto result = toHexString(*job.result);
+
+                            ImGui::PushItemWidth(-1);
+                            ImGui::InputText("##result", result.data(), result.size() + 1, ImGuiInputTextFlags_ReadOnly);
+                            ImGui::PopItemWidth();
+                        } else {
+                            ImGui::TextSpinner("");
                         }
-                            break;
+
+                        ImGui::TableNextColumn();
+                        if (ImGui::Button("x"))
+                            removedJob = job.id;
+
+                        ImGui::PopID();
                     }
 
+                    ImGui::EndTable();
+
+                    if (removedJob.has_value())
+                        std::erase_if(this->m_hashJobs, [id = *removedJob](const auto &job) { return job.id == id; });
                 }
 
-                this->m_shouldInvalidate = false;
+                this->drawBatch();
             }
             ImGui::EndChild();
         }
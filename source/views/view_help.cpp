@@ -1,5 +1,7 @@
 #include "views/view_help.hpp"
 
+#include <hex/helpers/profiler.hpp>
+
 #include <imgui_imhex_extensions.h>
 
 namespace hex {
@@ -85,6 +87,16 @@ namespace hex {
             Link("Mbed TLS", "https://github.com/ARMmbed/mbedtls");
 
             ImGui::PopStyleColor();
+            ImGui::NewLine();
+
+            ImGui::TextUnformatted(hex::format("{} ({:.1f} ms)", static_cast<const char*>("hex.view.help.about.startup"_lang), Profiler::getStartupTime()).c_str());
+            ImGui::Separator();
+            for (const auto &phase : Profiler::getStartupPhases()) {
+                if (phase.deferred)
+                    ImGui::BulletText("%s: %.1f ms (%s)", phase.name.c_str(), phase.time, static_cast<const char*>("hex.view.help.about.startup.deferred"_lang));
+                else
+                    ImGui::BulletText("%s: %.1f ms", phase.name.c_str(), phase.time);
+            }
 
             if (ImGui::IsKeyDown(ImGui::GetKeyIndex(ImGuiKey_Escape)))
                 ImGui::CloseCurrentPopup();
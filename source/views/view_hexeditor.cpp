@@ -2,18 +2,26 @@
 
 #include <hex/providers/provider.hpp>
 #include <hex/api/imhex_api.hpp>
+#include <hex/api/task.hpp>
 #include <hex/helpers/crypto.hpp>
+#include <hex/helpers/regex.hpp>
+#include <hex/helpers/search.hpp>
+#include <hex/helpers/value_search.hpp>
 
 #include <GLFW/glfw3.h>
 
-#include "providers/file_provider.hpp"
 #include "helpers/patches.hpp"
 #include "helpers/project_file_handler.hpp"
 #include "helpers/loader_script_handler.hpp"
 
 #undef __STRICT_ANSI__
+#include <cerrno>
 #include <cstdio>
 
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+
 namespace hex {
 
     ViewHexEditor::ViewHexEditor(std::vector<lang::PatternData*> &patternData)
@@ -21,56 +29,66 @@ namespace hex {
 
         this->m_searchStringBuffer.resize(0xFFF, 0x00);
         this->m_searchHexBuffer.resize(0xFFF, 0x00);
+        this->m_searchEncodedBuffer.resize(0xFFF, 0x00);
+        this->m_searchRegexBuffer.resize(0xFFF, 0x00);
+        this->m_searchValueBuffer.resize(0xFF, 0x00);
+        this->m_searchValueLimitBuffer.resize(0xFF, 0x00);
+
+        this->m_memoryEditor.PrefetchFn = [](const ImU8 *data, size_t off, size_t size) {
+            ViewHexEditor *_this = (ViewHexEditor *) data;
+
+            auto provider = SharedData::currentProvider;
+            if (!provider->isAvailable() || !provider->isReadable()) {
+                _this->m_visibleData.clear();
+                return;
+            }
+
+            _this->m_visibleDataOffset = off;
+            _this->m_visibleData.resize(size);
+            provider->read(off, _this->m_visibleData.data(), size);
+
+            SharedData::hexEditorVisibleRegion = { provider->getCurrentPage() * prv::Provider::PageSize + off, size };
+        };
 
         this->m_memoryEditor.ReadFn = [](const ImU8 *data, size_t off) -> ImU8 {
+            ViewHexEditor *_this = (ViewHexEditor *) data;
+
+            if (off >= _this->m_visibleDataOffset && off < _this->m_visibleDataOffset + _this->m_visibleData.size())
+                return _this->m_visibleData[off - _this->m_visibleDataOffset];
+
             auto provider = SharedData::currentProvider;
             if (!provider->isAvailable() || !provider->isReadable())
                 return 0x00;
 
+            PROVIDER_IO_SCOPE("hex.view.hexeditor.io.read_fn");
+
             ImU8 byte;
             provider->read(off, &byte, sizeof(ImU8));
 
-            for (auto &overlay : SharedData::currentProvider->getOverlays()) {
-                auto overlayAddress = overlay->getAddress();
-                if (off >= overlayAddress && off < overlayAddress + overlay->getSize())
-                    byte = overlay->getData()[off - overlayAddress];
-            }
-
             return byte;
         };
 
         this->m_memoryEditor.WriteFn = [](ImU8 *data, size_t off, ImU8 d) -> void {
+            ViewHexEditor *_this = (ViewHexEditor *) data;
+
             auto provider = SharedData::currentProvider;
             if (!provider->isAvailable() || !provider->isWritable())
                 return;
 
             provider->write(off, &d, sizeof(ImU8));
-            View::postEvent(Events::DataChanged);
+            _this->m_visibleData.clear();
+            View::postEvent(Events::DataChanged, Region { off, sizeof(ImU8) });
             ProjectFile::markDirty();
         };
 
         this->m_memoryEditor.HighlightFn = [](const ImU8 *data, size_t off, bool next) -> bool {
             ViewHexEditor *_this = (ViewHexEditor *) data;
 
-            std::optional<u32> currColor, prevColor;
-
             off += SharedData::currentProvider->getBaseAddress();
 
-            for (const auto &[region, name, comment, color, locked] : ImHexApi::Bookmarks::getEntries()) {
-                if (off >= region.address && off < (region.address + region.size))
-                    currColor = (color & 0x00FFFFFF) | 0x80000000;
-                if ((off - 1) >= region.address && (off - 1) < (region.address + region.size))
-                    prevColor = (color & 0x00FFFFFF) | 0x80000000;
-            }
-
-            if (_this->m_highlightedBytes.contains(off)) {
-                auto color = (_this->m_highlightedBytes[off] & 0x00FFFFFF) | 0x80000000;
-                currColor = currColor.has_value() ? ImAlphaBlendColors(color, currColor.value()) : color;
-            }
-            if (_this->m_highlightedBytes.contains(off - 1)) {
-                auto color = (_this->m_highlightedBytes[off - 1] & 0x00FFFFFF) | 0x80000000;
-                prevColor = prevColor.has_value() ? ImAlphaBlendColors(color, prevColor.value()) : color;
-            }
+            // Query the previous byte first so the span cursor only ever has to move forward
+            auto prevColor = _this->getHighlightColor(off - 1);
+            auto currColor = _this->getHighlightColor(off);
 
             if (next && prevColor != currColor) {
                 return false;
@@ -90,16 +108,14 @@ namespace hex {
 
             off += SharedData::currentProvider->getBaseAddress();
 
-            for (const auto &[region, name, comment, color, locked] : ImHexApi::Bookmarks::getEntries()) {
-                if (off >= region.address && off < (region.address + region.size)) {
-                    if (!tooltipShown) {
-                        ImGui::BeginTooltip();
-                        tooltipShown = true;
-                    }
-                    ImGui::ColorButton(name.data(), ImColor(color).Value);
-                    ImGui::SameLine(0, 10);
-                    ImGui::TextUnformatted(name.data());
+            for (const auto bookmark : ImHexApi::Bookmarks::getOverlapping(off, 1)) {
+                if (!tooltipShown) {
+                    ImGui::BeginTooltip();
+                    tooltipShown = true;
                 }
+                ImGui::ColorButton(bookmark->name.data(), ImColor(bookmark->color).Value);
+                ImGui::SameLine(0, 10);
+                ImGui::TextUnformatted(bookmark->name.data());
             }
 
             if (tooltipShown)
@@ -115,8 +131,13 @@ namespace hex {
             auto &provider = SharedData::currentProvider;
             size_t size = std::min<size_t>(_this->m_currEncodingFile.getLongestSequence(), provider->getActualSize() - addr);
 
-            std::vector<u8> buffer(size);
-            provider->read(addr, buffer.data(), size);
+            // Called for every visible cell, the buffer is kept around so decoding doesn't allocate
+            auto &buffer = _this->m_encodingBuffer;
+            buffer.resize(size);
+            {
+                PROVIDER_IO_SCOPE("hex.view.hexeditor.io.decode_fn");
+                provider->read(addr, buffer.data(), size);
+            }
 
             auto [decoded, advance] = _this->m_currEncodingFile.getEncodingFor(buffer);
 
@@ -130,6 +151,22 @@ namespace hex {
             return { std::string(decoded), advance, color };
         };
 
+        this->m_memoryEditor.GridFn = [](const ImU8 *data, ImDrawList *drawList, const MemoryEditor::GridData &grid) {
+            ViewHexEditor *_this = (ViewHexEditor *) data;
+
+            _this->m_gridRenderer.draw(drawList, grid);
+        };
+
+        this->m_memoryEditor.MinimapFn = [](const ImU8 *data, size_t visibleStart, size_t visibleEnd, ImVec2 size) {
+            ViewHexEditor *_this = (ViewHexEditor *) data;
+
+            // The memory editor only knows about the current page, the minimap always shows all of the data
+            u64 pageAddress = u64(SharedData::currentProvider->getCurrentPage()) * prv::Provider::PageSize;
+
+            if (auto address = _this->m_minimap.draw(size, { pageAddress + visibleStart, visibleEnd - visibleStart }); address.has_value())
+                View::postEvent(Events::SelectionChangeRequest, Region { *address, 1 });
+        };
+
         View::subscribeEvent(Events::FileDropped, [this](auto userData) {
             auto filePath = std::any_cast<const char*>(userData);
 
@@ -137,17 +174,17 @@ namespace hex {
                 this->openFile(filePath);
         });
 
-        View::subscribeEvent(Events::SelectionChangeRequest, [this](auto userData) {
-            const Region &region = std::any_cast<Region>(userData);
-
+        View::subscribeEvent<Region>(Events::SelectionChangeRequest, [this](const Region &region) {
             auto provider = SharedData::currentProvider;
             auto page = provider->getPageOfAddress(region.address);
             if (!page.has_value())
                 return;
 
+            // Requested regions are absolute, the memory editor only knows about the current page
             provider->setCurrentPage(page.value());
-            this->m_memoryEditor.GotoAddrAndHighlight(region.address, region.address + region.size - 1);
-            View::postEvent(Events::RegionSelected, region);
+            Region pageRegion = { region.address - u64(page.value()) * prv::Provider::PageSize, region.size };
+            this->m_memoryEditor.GotoAddrAndHighlight(pageRegion.address, pageRegion.address + pageRegion.size - 1);
+            View::postEvent(Events::RegionSelected, pageRegion);
         });
 
         View::subscribeEvent(Events::ProjectFileLoad, [this](auto) {
@@ -163,11 +200,69 @@ namespace hex {
             }
         });
 
+        View::subscribeEvent(Events::SettingsChanged, [this](auto) {
+            auto provider = SharedData::currentProvider;
+
+            if (provider != nullptr)
+                provider->setUndoHistoryBudget(ContentRegistry::Settings::read("hex.builtin.setting.hex_editor", "hex.builtin.setting.hex_editor.undo_history", 16) * 0x10'0000);
+
+            this->m_showMinimap = ContentRegistry::Settings::read("hex.builtin.setting.hex_editor", "hex.builtin.setting.hex_editor.minimap", 1) != 0;
+            this->m_drawGrid = ContentRegistry::Settings::read("hex.builtin.setting.hex_editor", "hex.builtin.setting.hex_editor.gpu_grid", 0) != 0;
+        });
+
+        View::subscribeEvent(Events::DataChanged, [this](auto userData) {
+            auto provider = SharedData::currentProvider;
+            auto region = std::any_cast<Region>(&userData);
+
+            // Changes without a region may have moved all of the data around
+            if (region != nullptr && provider != nullptr)
+                this->m_minimap.markChanged({ region->address + u64(provider->getCurrentPage()) * prv::Provider::PageSize, region->size });
+            else
+                this->m_minimap.reset();
+        });
+
         View::subscribeEvent(Events::PatternChanged, [this](auto) {
-            this->m_highlightedBytes.clear();
+            this->m_highlightedRanges.clear();
+
+            for (const auto &pattern : this->m_patternData) {
+                const auto &ranges = pattern->getHighlightedAddresses();
+                this->m_highlightedRanges.insert(this->m_highlightedRanges.end(), ranges.begin(), ranges.end());
+            }
+
+            this->m_highlightSpansDirty = true;
+        });
+
+        View::subscribeEvent(Events::AddBookmark, [this](auto) {
+            this->m_highlightSpansDirty = true;
+        });
+
+        View::subscribeEvent(Events::BookmarksChanged, [this](auto) {
+            this->m_highlightSpansDirty = true;
+        });
+
+        View::subscribeEvent(Events::HighlightingChanged, [this](auto) {
+            this->m_highlightSpansDirty = true;
+        });
+
+        View::subscribeEvent(Events::ProviderChanged, [this](auto) {
+            auto provider = SharedData::currentProvider;
 
-            for (const auto &pattern : this->m_patternData)
-                this->m_highlightedBytes.merge(pattern->getHighlightedAddresses());
+            // Search results and the selection only make sense for the provider they were made in
+            this->cancelSearch();
+            this->m_lastStringSearch.clear();
+            this->m_lastHexSearch.clear();
+            this->m_lastEncodedSearch.clear();
+            this->m_lastRegexSearch.clear();
+            this->m_lastValueSearch.clear();
+
+            this->m_memoryEditor.ReadOnly = provider == nullptr || !provider->isWritable();
+            this->m_memoryEditor.DataPreviewAddr = this->m_memoryEditor.DataPreviewAddrEnd = 0;
+            this->m_memoryEditor.DataPreviewAddrOld = this->m_memoryEditor.DataPreviewAddrEndOld = 0;
+            this->m_highlightSpansDirty = true;
+            this->m_selectProviderTab = true;
+            this->m_minimap.reset();
+
+            View::postEvent(Events::RegionSelected, Region { 0, 1 });
         });
 
         View::subscribeEvent(Events::OpenWindow, [this](auto name) {
@@ -187,14 +282,75 @@ namespace hex {
     }
 
     ViewHexEditor::~ViewHexEditor() {
+        this->cancelSearch();
+    }
+
+    void ViewHexEditor::drawProviderTabs() {
+        const auto &providers = ImHexApi::Provider::getProviders();
+        if (providers.empty())
+            return;
+
+        prv::Provider *selected = nullptr, *closed = nullptr;
+
+        // Goes into the hex editor window before the memory editor draws its contents, so the flags need to match the ones it uses
+        if (ImGui::Begin(View::toWindowName("hex.view.hexeditor.name").c_str(), &this->getWindowOpenState(), ImGuiWindowFlags_NoScrollbar | ImGuiWindowFlags_NoCollapse | ImGuiWindowFlags_NoNavInputs)) {
+            if (ImGui::BeginTabBar("##providers", ImGuiTabBarFlags_Reorderable | ImGuiTabBarFlags_FittingPolicyScroll)) {
+                for (const auto &provider : providers) {
+                    auto name = provider->getName();
+                    bool open = true;
+
+                    ImGuiTabItemFlags flags = ImGuiTabItemFlags_None;
+                    if (this->m_selectProviderTab && provider.get() == SharedData::currentProvider)
+                        flags |= ImGuiTabItemFlags_SetSelected;
+                    if (provider->canUndo())
+                        flags |= ImGuiTabItemFlags_UnsavedDocument;
+
+                    ImGui::PushID(provider.get());
+                    if (ImGui::BeginTabItem(name.empty() ? static_cast<const char*>("hex.view.hexeditor.unnamed"_lang) : name.c_str(), &open, flags)) {
+                        selected = provider.get();
+                        ImGui::EndTabItem();
+                    }
+                    ImGui::PopID();
+
+                    if (!open)
+                        closed = provider.get();
+                }
 
+                ImGui::EndTabBar();
+            }
+        }
+        ImGui::End();
+
+        // Selecting a tab from code only shows up a frame later, until then the old tab still reports being selected
+        if (this->m_selectProviderTab) {
+            if (selected == SharedData::currentProvider)
+                this->m_selectProviderTab = false;
+        } else if (selected != nullptr && selected != SharedData::currentProvider) {
+            ImHexApi::Provider::setCurrent(selected);
+        }
+
+        if (closed != nullptr)
+            ImHexApi::Provider::remove(closed);
     }
 
     void ViewHexEditor::drawContent() {
+        this->drawProviderTabs();
+
         auto provider = SharedData::currentProvider;
 
+        if (this->m_highlightSpansDirty)
+            this->rebuildHighlightSpans();
+
+        this->collectSearchResults();
+        this->collectProviderChanges();
+
+        // Live data may have grown, the size has to be the one after collecting the changes
         size_t dataSize = (provider == nullptr || !provider->isReadable()) ? 0x00 : provider->getSize();
 
+        this->m_memoryEditor.MinimapWidth = this->m_showMinimap ? ImGui::GetTextLineHeight() * 1.5F : 0.0F;
+
+        // Cells get drawn as text again if the GPU can't build the grid shaders
+        this->m_memoryEditor.OptDrawGrid = this->m_drawGrid && this->m_gridRenderer.isSupported();
         this->m_memoryEditor.DrawWindow(View::toWindowName("hex.view.hexeditor.name").c_str(), &this->getWindowOpenState(), this, dataSize, dataSize == 0 ? 0x00 : provider->getBaseAddress());
 
         if (dataSize != 0x00) {
@@ -207,28 +363,6 @@ namespace hex {
                     this->drawEditPopup();
                     ImGui::EndPopup();
                 }
-
-                ImGui::SameLine();
-                ImGui::Spacing();
-                ImGui::SameLine();
-                ImGui::TextUnformatted(hex::format("hex.view.hexeditor.page"_lang, provider->getCurrentPage() + 1, provider->getPageCount()).c_str());
-                ImGui::SameLine();
-
-                if (ImGui::ArrowButton("prevPage", ImGuiDir_Left)) {
-                    provider->setCurrentPage(provider->getCurrentPage() - 1);
-
-                    Region dataPreview = { std::min(this->m_memoryEditor.DataPreviewAddr, this->m_memoryEditor.DataPreviewAddrEnd), 1 };
-                    View::postEvent(Events::RegionSelected, dataPreview);
-                }
-
-                ImGui::SameLine();
-
-                if (ImGui::ArrowButton("nextPage", ImGuiDir_Right)) {
-                    provider->setCurrentPage(provider->getCurrentPage() + 1);
-
-                    Region dataPreview = { std::min(this->m_memoryEditor.DataPreviewAddr, this->m_memoryEditor.DataPreviewAddrEnd), 1 };
-                    View::postEvent(Events::RegionSelected, dataPreview);
-                }
             }
             ImGui::End();
 
@@ -237,45 +371,35 @@ namespace hex {
         }
     }
 
-    static void save() {
-        auto provider = SharedData::currentProvider;
-        for (const auto &[address, value] : provider->getPatches())
-            provider->writeRaw(address, &value, sizeof(u8));
-    }
-
     static void saveAs() {
         View::openFileBrowser("hex.view.hexeditor.save_as"_lang, View::DialogMode::Save, { }, [](auto path) {
-            FILE *file = fopen(path.c_str(), "wb");
-
-            if (file != nullptr) {
-                std::vector<u8> buffer(0xFF'FFFF, 0x00);
-                size_t bufferSize = buffer.size();
-
-                fseek(file, 0, SEEK_SET);
-
-                auto provider = SharedData::currentProvider;
-                for (u64 offset = 0; offset < provider->getActualSize(); offset += bufferSize) {
-                    if (bufferSize > provider->getActualSize() - offset)
-                        bufferSize = provider->getActualSize() - offset;
-
-                    provider->read(offset, buffer.data(), bufferSize);
-                    fwrite(buffer.data(), 1, bufferSize, file);
-                }
-
-                fclose(file);
-            }
+            if (!SharedData::currentProvider->saveAs(path))
+                View::showErrorPopup("hex.view.hexeditor.error.save"_lang);
         });
     }
 
+    static void save() {
+        // Inserted or removed bytes can't be written back in place, they need a new file
+        if (SharedData::currentProvider->hasStructuralChanges())
+            saveAs();
+        else
+            SharedData::currentProvider->applyPatches();
+    }
+
     void ViewHexEditor::drawAlwaysVisible() {
         auto provider = SharedData::currentProvider;
 
+        ProjectFile::autosave();
+
         if (ImGui::BeginPopupModal("hex.view.hexeditor.save_changes.title"_lang, nullptr, ImGuiWindowFlags_AlwaysAutoResize)) {
             ImGui::NewLine();
             ImGui::TextUnformatted("hex.view.hexeditor.save_changes.desc"_lang);
             ImGui::NewLine();
 
-            confirmButtons("hex.common.yes"_lang, "hex.common.no"_lang, [] { View::postEvent(Events::CloseImHex); }, [] { ImGui::CloseCurrentPopup(); });
+            confirmButtons("hex.common.yes"_lang, "hex.common.no"_lang, [] {
+                ProjectFile::discardAutosave();
+                View::postEvent(Events::CloseImHex);
+            }, [] { ImGui::CloseCurrentPopup(); });
 
             if (ImGui::IsKeyDown(ImGui::GetKeyIndex(ImGuiKey_Escape)))
                 ImGui::CloseCurrentPopup();
@@ -308,12 +432,10 @@ namespace hex {
             ImGui::NewLine();
 
             confirmButtons("hex.common.load"_lang, "hex.common.cancel"_lang,
-                           [this, &provider] {
-                               if (!this->m_loaderScriptScriptPath.empty() && !this->m_loaderScriptFilePath.empty()) {
+                           [this] {
+                               if (!this->m_loaderScriptScriptPath.empty() && !this->m_loaderScriptFilePath.empty() && !LoaderScript::isRunning()) {
                                    this->openFile(this->m_loaderScriptFilePath);
-                                   LoaderScript::setFilePath(this->m_loaderScriptFilePath);
-                                   LoaderScript::setDataProvider(provider);
-                                   LoaderScript::processFile(this->m_loaderScriptScriptPath);
+                                   LoaderScript::processFile(this->m_loaderScriptScriptPath, this->m_loaderScriptFilePath, ImHexApi::Provider::getHandle());
                                    ImGui::CloseCurrentPopup();
                                }
                            },
@@ -326,6 +448,69 @@ namespace hex {
 
         }
 
+        if (ImGui::BeginPopupModal("hex.view.hexeditor.open_disk.title"_lang, nullptr, ImGuiWindowFlags_AlwaysAutoResize)) {
+            ImGui::TextUnformatted("hex.view.hexeditor.open_disk.desc"_lang);
+            ImGui::NewLine();
+            ImGui::InputText("##nolabel", this->m_diskPathBuffer, sizeof(this->m_diskPathBuffer));
+            ImGui::NewLine();
+
+            confirmButtons("hex.common.load"_lang, "hex.common.cancel"_lang,
+                           [this]{
+                               if (this->m_diskPathBuffer[0] != 0x00)
+                                   this->openFile(this->m_diskPathBuffer, "hex.provider.disk");
+                               ImGui::CloseCurrentPopup();
+                           }, []{
+                        ImGui::CloseCurrentPopup();
+                    });
+
+            if (ImGui::IsKeyDown(ImGui::GetKeyIndex(ImGuiKey_Escape)))
+                ImGui::CloseCurrentPopup();
+
+            ImGui::EndPopup();
+        }
+
+        if (ImGui::BeginPopupModal("hex.view.hexeditor.open_remote.title"_lang, nullptr, ImGuiWindowFlags_AlwaysAutoResize)) {
+            ImGui::TextUnformatted("hex.view.hexeditor.open_remote.desc"_lang);
+            ImGui::NewLine();
+            ImGui::InputText("##nolabel", this->m_remoteAddressBuffer, sizeof(this->m_remoteAddressBuffer));
+            ImGui::NewLine();
+
+            confirmButtons("hex.common.load"_lang, "hex.common.cancel"_lang,
+                           [this]{
+                               if (this->m_remoteAddressBuffer[0] != 0x00)
+                                   this->openFile(this->m_remoteAddressBuffer, "hex.provider.remote");
+                               ImGui::CloseCurrentPopup();
+                           }, []{
+                        ImGui::CloseCurrentPopup();
+                    });
+
+            if (ImGui::IsKeyDown(ImGui::GetKeyIndex(ImGuiKey_Escape)))
+                ImGui::CloseCurrentPopup();
+
+            ImGui::EndPopup();
+        }
+
+        if (ImGui::BeginPopupModal("hex.view.hexeditor.attach_process.title"_lang, nullptr, ImGuiWindowFlags_AlwaysAutoResize)) {
+            ImGui::TextUnformatted("hex.view.hexeditor.attach_process.desc"_lang);
+            ImGui::NewLine();
+            ImGui::InputText("##nolabel", this->m_processIdBuffer, sizeof(this->m_processIdBuffer), ImGuiInputTextFlags_CharsDecimal);
+            ImGui::NewLine();
+
+            confirmButtons("hex.common.load"_lang, "hex.common.cancel"_lang,
+                           [this]{
+                               if (this->m_processIdBuffer[0] != 0x00)
+                                   this->openFile(this->m_processIdBuffer, "hex.provider.process");
+                               ImGui::CloseCurrentPopup();
+                           }, []{
+                        ImGui::CloseCurrentPopup();
+                    });
+
+            if (ImGui::IsKeyDown(ImGui::GetKeyIndex(ImGuiKey_Escape)))
+                ImGui::CloseCurrentPopup();
+
+            ImGui::EndPopup();
+        }
+
         if (ImGui::BeginPopupModal("hex.view.hexeditor.menu.edit.set_base"_lang, nullptr, ImGuiWindowFlags_AlwaysAutoResize)) {
             ImGui::InputText("hex.common.address"_lang, this->m_baseAddressBuffer, 16, ImGuiInputTextFlags_CharsHexadecimal);
             ImGui::NewLine();
@@ -343,6 +528,90 @@ namespace hex {
 
             ImGui::EndPopup();
         }
+
+        if (ImGui::BeginPopupModal("hex.view.hexeditor.menu.edit.modify"_lang, nullptr, ImGuiWindowFlags_AlwaysAutoResize)) {
+            constexpr static std::array OperationNames = {
+                "hex.view.hexeditor.modify.fill", "hex.view.hexeditor.modify.xor", "hex.view.hexeditor.modify.and", "hex.view.hexeditor.modify.or",
+                "hex.view.hexeditor.modify.add", "hex.view.hexeditor.modify.swap_endian", "hex.view.hexeditor.modify.reverse"
+            };
+            constexpr static std::array<u8, 4> Widths = { 1, 2, 4, 8 };
+
+            auto operation = this->m_modifyOperation;
+            if (ImGui::BeginCombo("hex.view.hexeditor.modify.operation"_lang, LangEntry(OperationNames[int(operation)]))) {
+                for (int i = 0; i < int(OperationNames.size()); i++) {
+                    if (ImGui::Selectable(LangEntry(OperationNames[i]), i == int(operation)))
+                        this->m_modifyOperation = ByteOperation(i);
+                }
+                ImGui::EndCombo();
+            }
+
+            if (operation == ByteOperation::Add)
+                ImGui::InputText("hex.view.hexeditor.modify.value"_lang, this->m_modifyOperandBuffer, sizeof(this->m_modifyOperandBuffer));
+            else if (operation != ByteOperation::SwapEndian && operation != ByteOperation::Reverse)
+                ImGui::InputText("hex.view.hexeditor.modify.pattern"_lang, this->m_modifyOperandBuffer, sizeof(this->m_modifyOperandBuffer));
+
+            if (operation == ByteOperation::Add || operation == ByteOperation::SwapEndian) {
+                // Swapping single bytes does nothing, so swapping starts at two of them
+                auto firstWidth = operation == ByteOperation::SwapEndian ? Widths.begin() + 1 : Widths.begin();
+                if (*firstWidth > this->m_modifyWidth)
+                    this->m_modifyWidth = *firstWidth;
+
+                for (auto width = firstWidth; width != Widths.end(); width++) {
+                    if (width != firstWidth)
+                        ImGui::SameLine();
+                    if (ImGui::RadioButton(hex::format("hex.view.hexeditor.modify.width"_lang, *width * 8).c_str(), this->m_modifyWidth == *width))
+                        this->m_modifyWidth = *width;
+                }
+            }
+
+            if (operation == ByteOperation::Add) {
+                if (ImGui::RadioButton("hex.common.little_endian"_lang, this->m_modifyEndian == std::endian::little))
+                    this->m_modifyEndian = std::endian::little;
+                ImGui::SameLine();
+                if (ImGui::RadioButton("hex.common.big_endian"_lang, this->m_modifyEndian == std::endian::big))
+                    this->m_modifyEndian = std::endian::big;
+            }
+
+            if (!this->m_modifyError.empty())
+                ImGui::TextColored(ImVec4(0.92F, 0.25F, 0.2F, 1.0F), "%s", this->m_modifyError.c_str());
+
+            ImGui::NewLine();
+
+            confirmButtons("hex.view.hexeditor.modify.apply"_lang, "hex.common.cancel"_lang,
+                           [this]{
+                               std::vector<u8> operand;
+                               std::string_view input = this->m_modifyOperandBuffer;
+
+                               if (this->m_modifyOperation == ByteOperation::Add) {
+                                   // Negative values wrap around, so subtracting works the same as adding
+                                   char *end = nullptr;
+                                   errno = 0;
+                                   u64 value = input.starts_with('-') ? u64(std::strtoll(input.data(), &end, 0)) : std::strtoull(input.data(), &end, 0);
+                                   if (!input.empty() && end == input.data() + input.size() && errno == 0)
+                                       operand = hex::toBytes(value);
+                               } else {
+                                   operand = hex::parseByteString(input);
+                               }
+
+                               bool parsed = this->m_modifyOperation != ByteOperation::Add || !operand.empty();
+                               ByteOperator byteOperator(this->m_modifyOperation, std::move(operand), this->m_modifyWidth, this->m_modifyEndian);
+                               if (!parsed || !byteOperator.isValid()) {
+                                   this->m_modifyError = std::string("hex.view.hexeditor.modify.invalid"_lang);
+                                   return;
+                               }
+
+                               this->m_modifyError.clear();
+                               this->modifySelection(std::move(byteOperator));
+                               ImGui::CloseCurrentPopup();
+                           }, []{
+                        ImGui::CloseCurrentPopup();
+                    });
+
+            if (ImGui::IsKeyDown(ImGui::GetKeyIndex(ImGuiKey_Escape)))
+                ImGui::CloseCurrentPopup();
+
+            ImGui::EndPopup();
+        }
     }
 
     void ViewHexEditor::drawMenu() {
@@ -357,6 +626,39 @@ namespace hex {
                 });
             }
 
+            if (ImGui::MenuItem("hex.view.hexeditor.menu.file.open_file_read_only"_lang)) {
+                View::openFileBrowser("hex.view.hexeditor.open_file"_lang, DialogMode::Open, { }, [this](auto path) {
+                    this->openFile(path, "hex.provider.file.read_only");
+                    this->getWindowOpenState() = true;
+                });
+            }
+
+            if (ImGui::MenuItem("hex.view.hexeditor.menu.file.open_file_async"_lang)) {
+                View::openFileBrowser("hex.view.hexeditor.open_file"_lang, DialogMode::Open, { }, [this](auto path) {
+                    this->openFile(path, "hex.provider.file.async");
+                    this->getWindowOpenState() = true;
+                });
+            }
+
+            if (ImGui::MenuItem("hex.view.hexeditor.menu.file.open_compressed"_lang)) {
+                View::openFileBrowser("hex.view.hexeditor.open_file"_lang, DialogMode::Open, { }, [this](auto path) {
+                    this->openFile(path, "hex.provider.compressed_file");
+                    this->getWindowOpenState() = true;
+                });
+            }
+
+            if (ImGui::MenuItem("hex.view.hexeditor.menu.file.open_disk"_lang)) {
+                View::doLater([]{ ImGui::OpenPopup("hex.view.hexeditor.open_disk.title"_lang); });
+            }
+
+            if (ImGui::MenuItem("hex.view.hexeditor.menu.file.open_remote"_lang)) {
+                View::doLater([]{ ImGui::OpenPopup("hex.view.hexeditor.open_remote.title"_lang); });
+            }
+
+            if (ImGui::MenuItem("hex.view.hexeditor.menu.file.attach_process"_lang)) {
+                View::doLater([]{ ImGui::OpenPopup("hex.view.hexeditor.attach_process.title"_lang); });
+            }
+
             if (ImGui::MenuItem("hex.view.hexeditor.menu.file.save"_lang, "CTRL + S", false, provider != nullptr && provider->isWritable())) {
                 save();
             }
@@ -416,31 +718,14 @@ namespace hex {
 
                 ImGui::Separator();
 
-                if (ImGui::MenuItem("hex.view.hexeditor.menu.file.import.ips"_lang)) {
-
-                   View::openFileBrowser("hex.view.hexeditor.open_file"_lang, DialogMode::Open, { }, [this](auto path) {
-                        auto patchData = hex::readFile(path);
-                        auto patch = hex::loadIPSPatch(patchData);
-
-                        for (auto &[address, value] : patch) {
-                            SharedData::currentProvider->write(address, &value, 1);
-                        }
-                       this->getWindowOpenState() = true;
-                   });
-
-
-                }
-
-                if (ImGui::MenuItem("hex.view.hexeditor.menu.file.import.ips32"_lang)) {
-                    View::openFileBrowser("hex.view.hexeditor.open_file"_lang, DialogMode::Open, { }, [this](auto path) {
-                        auto patchData = hex::readFile(path);
-                        auto patch = hex::loadIPS32Patch(patchData);
-
-                        for (auto &[address, value] : patch) {
-                            SharedData::currentProvider->write(address, &value, 1);
-                        }
-                        this->getWindowOpenState() = true;
-                    });
+                for (auto [format, name] : { std::pair { PatchFormat::IPS, "hex.view.hexeditor.menu.file.import.ips" }, { PatchFormat::IPS32, "hex.view.hexeditor.menu.file.import.ips32" },
+                                             { PatchFormat::UPS, "hex.view.hexeditor.menu.file.import.ups" }, { PatchFormat::BPS, "hex.view.hexeditor.menu.file.import.bps" } }) {
+                    if (ImGui::MenuItem(LangEntry(name), nullptr, false, !this->m_patchTask.isRunning())) {
+                        View::openFileBrowser("hex.view.hexeditor.open_file"_lang, DialogMode::Open, { }, [this, format = format](auto path) {
+                            this->importPatch(path, format);
+                            this->getWindowOpenState() = true;
+                        });
+                    }
                 }
 
                 if (ImGui::MenuItem("hex.view.hexeditor.menu.file.import.script"_lang)) {
@@ -453,30 +738,23 @@ namespace hex {
             }
 
             if (ImGui::BeginMenu("hex.view.hexeditor.menu.file.export"_lang, provider != nullptr && provider->isWritable())) {
-                if (ImGui::MenuItem("hex.view.hexeditor.menu.file.export.ips"_lang)) {
-                    Patches patches = provider->getPatches();
-                    if (!patches.contains(0x00454F45) && patches.contains(0x00454F46)) {
-                        u8 value = 0;
-                        provider->read(0x00454F45, &value, sizeof(u8));
-                        patches[0x00454F45] = value;
+                for (auto [format, name] : { std::pair { PatchFormat::IPS, "hex.view.hexeditor.menu.file.export.ips" }, { PatchFormat::IPS32, "hex.view.hexeditor.menu.file.export.ips32" },
+                                             { PatchFormat::UPS, "hex.view.hexeditor.menu.file.export.ups" }, { PatchFormat::BPS, "hex.view.hexeditor.menu.file.export.bps" } }) {
+                    if (ImGui::MenuItem(LangEntry(name), nullptr, false, !this->m_patchTask.isRunning())) {
+                        View::openFileBrowser("hex.view.hexeditor.menu.file.export.title"_lang, DialogMode::Save, { }, [this, format = format](auto path) {
+                            this->exportPatch(path, format);
+                        });
                     }
-
-                    this->m_dataToSave = generateIPSPatch(patches);
-                    View::openFileBrowser("hex.view.hexeditor.menu.file.export.title"_lang, DialogMode::Save, { }, [this](auto path) {
-                        this->saveToFile(path, this->m_dataToSave);
-                    });
                 }
-                if (ImGui::MenuItem("hex.view.hexeditor.menu.file.export.ips32"_lang)) {
-                    Patches patches = provider->getPatches();
-                    if (!patches.contains(0x00454F45) && patches.contains(0x45454F46)) {
-                        u8 value = 0;
-                        provider->read(0x45454F45, &value, sizeof(u8));
-                        patches[0x45454F45] = value;
-                    }
-
-                    this->m_dataToSave = generateIPS32Patch(patches);
-                    View::openFileBrowser("hex.view.hexeditor.menu.file.export.title"_lang, DialogMode::Save, { }, [this](auto path) {
-                        this->saveToFile(path, this->m_dataToSave);
+                if (ImGui::MenuItem("hex.view.hexeditor.menu.file.export.decoded"_lang, nullptr, false, this->m_currEncodingFile.getLongestSequence() > 0 && !this->m_exportTask.isRunning())) {
+                    size_t start = std::min(this->m_memoryEditor.DataPreviewAddr, this->m_memoryEditor.DataPreviewAddrEnd);
+                    size_t end = std::max(this->m_memoryEditor.DataPreviewAddr, this->m_memoryEditor.DataPreviewAddrEnd);
+                    u64 pageStart = u64(provider->getCurrentPage()) * prv::Provider::PageSize;
+
+                    // Without a selection of more than a single byte everything gets exported
+                    Region region = end > start ? Region { pageStart + start, end - start + 1 } : Region { 0, provider->getActualSize() };
+                    View::openFileBrowser("hex.view.hexeditor.menu.file.export.title"_lang, DialogMode::Save, { { "Text File", "txt" } }, [this, region](auto path) {
+                        this->exportDecoded(path, region);
                     });
                 }
 
@@ -523,40 +801,54 @@ namespace hex {
             View::doLater([]{ ImGui::OpenPopup("hex.view.hexeditor.open_file"_lang); });
             return true;
         } else if (mods == (GLFW_MOD_CONTROL | GLFW_MOD_ALT) && key == GLFW_KEY_C) {
-            this->copyBytes();
+            this->copySelection(CopyFormat::Bytes);
             return true;
         } else if (mods == (GLFW_MOD_CONTROL | GLFW_MOD_SHIFT) && key == GLFW_KEY_C) {
             this->copyString();
             return true;
+        } else if (mods == GLFW_MOD_CONTROL && key == GLFW_KEY_Z) {
+            this->undo();
+            return true;
+        } else if (mods == GLFW_MOD_CONTROL && key == GLFW_KEY_Y) {
+            this->redo();
+            return true;
+        } else if (mods == GLFW_MOD_CONTROL && key == GLFW_KEY_B) {
+            this->gotoBookmark(true);
+            return true;
+        } else if (mods == (GLFW_MOD_CONTROL | GLFW_MOD_SHIFT) && key == GLFW_KEY_B) {
+            this->gotoBookmark(false);
+            return true;
         }
 
         return false;
     }
 
 
-    void ViewHexEditor::openFile(std::string path) {
-        auto& provider = SharedData::currentProvider;
-
-        if (provider != nullptr)
-            delete provider;
-
-        provider = new prv::FileProvider(path);
-        if (!provider->isWritable()) {
-            this->m_memoryEditor.ReadOnly = true;
-            View::showErrorPopup("hex.view.hexeditor.error.read_only"_lang);
-        } else {
-            this->m_memoryEditor.ReadOnly = false;
-        }
+    void ViewHexEditor::openFile(std::string path, std::string_view providerName) {
+        auto provider = ContentRegistry::Providers::create(providerName, path);
+        if (provider == nullptr)
+            return;
 
+        // Providers that couldn't be opened never get a tab, the other open ones stay as they were
         if (!provider->isAvailable()) {
             View::showErrorPopup("hex.view.hexeditor.error.open"_lang);
             delete provider;
-            provider = nullptr;
 
             return;
         }
 
-        ProjectFile::setFilePath(path);
+        provider->setUndoHistoryBudget(ContentRegistry::Settings::read("hex.builtin.setting.hex_editor", "hex.builtin.setting.hex_editor.undo_history", 16) * 0x10'0000);
+
+        ImHexApi::Provider::add(provider);
+
+        if (!provider->isWritable())
+            View::showErrorPopup("hex.view.hexeditor.error.read_only"_lang);
+
+        // A process ID can't be reopened later, so it doesn't end up in projects or the recent files
+        if (providerName == "hex.provider.process")
+            path.clear();
+        else
+            ProjectFile::setFilePath(path);
 
         this->getWindowOpenState() = true;
 
@@ -577,6 +869,84 @@ namespace hex {
         return true;
     }
 
+    /* Decodes the region chunk by chunk through the custom encoding and streams the text into the file */
+    void ViewHexEditor::exportDecoded(const std::string &path, Region region) {
+        this->m_exportTask = TaskManager::createTask("hex.view.hexeditor.export.decoding", region.size, [handle = ImHexApi::Provider::getHandle(), encoding = this->m_currEncodingFile, path, region](Task &task) {
+            constexpr static size_t ChunkSize = 0x10'0000;
+
+            FILE *file = fopen(path.c_str(), "wb");
+            if (file == nullptr) {
+                View::doLater([] { View::showErrorPopup("hex.view.hexeditor.export.decoded.error"_lang); });
+                return;
+            }
+            SCOPE_EXIT( fclose(file); );
+
+            auto provider = handle.get();
+            provider->adviseAccess(region.address, region.size, prv::Provider::AccessHint::Sequential);
+            SCOPE_EXIT( provider->adviseAccess(region.address, region.size, prv::Provider::AccessHint::Normal); );
+
+            std::vector<u8> buffer;
+            std::string text;
+            size_t carried = 0;
+
+            for (u64 offset = 0; offset < region.size && !task.isInterrupted();) {
+                size_t readSize = std::min<u64>(ChunkSize, region.size - offset);
+                buffer.resize(carried + readSize);
+                provider->readAbsolute(region.address + offset, buffer.data() + carried, readSize);
+                offset += readSize;
+
+                text.clear();
+                size_t decoded = encoding.decode(buffer, offset == region.size, text);
+                fwrite(text.data(), 1, text.size(), file);
+
+                // The end of the chunk may be the start of a sequence that continues in the next one
+                carried = buffer.size() - decoded;
+                std::copy(buffer.end() - carried, buffer.end(), buffer.begin());
+
+                task.update(offset);
+            }
+        });
+    }
+
+    /* Decodes the patch on a worker thread and applies it in one go as a single undo step */
+    void ViewHexEditor::importPatch(const std::string &path, PatchFormat format) {
+        this->m_patchTask = TaskManager::createTask("hex.view.hexeditor.patch.importing", 0, [handle = ImHexApi::Provider::getHandle(), path, format](Task &) {
+            std::ifstream stream(path, std::ios::binary);
+            auto patches = stream.is_open() ? readPatch(format, stream, handle.get()) : std::nullopt;
+
+            View::doLater([handle, patches = std::move(patches)] {
+                if (!patches.has_value()) {
+                    View::showErrorPopup("hex.view.hexeditor.patch.import_error"_lang);
+                    return;
+                }
+
+                auto provider = handle.get();
+                if (provider != SharedData::currentProvider)
+                    return;
+
+                provider->beginTransaction();
+                for (const auto &[address, data] : patches->getRuns())
+                    provider->writeAbsolute(address, data.data(), data.size());
+                provider->commitTransaction();
+
+                View::postEvent(Events::DataChanged);
+            });
+        });
+    }
+
+    /* The patches are snapshotted here, so the file gets written in the background while editing goes on */
+    void ViewHexEditor::exportPatch(const std::string &path, PatchFormat format) {
+        auto handle = ImHexApi::Provider::getHandle();
+        if (handle == nullptr)
+            return;
+
+        this->m_patchTask = TaskManager::createTask("hex.view.hexeditor.patch.exporting", 0, [handle, patches = handle->getPatches(), path, format](Task &) {
+            std::ofstream stream(path, std::ios::binary);
+            if (!stream.is_open() || !writePatch(format, stream, handle.get(), patches))
+                View::doLater([] { View::showErrorPopup("hex.view.hexeditor.patch.export_error"_lang); });
+        });
+    }
+
     bool ViewHexEditor::loadFromFile(std::string path, std::vector<u8>& data) {
         FILE *file = fopen(path.c_str(), "rb");
 
@@ -594,349 +964,569 @@ namespace hex {
         return true;
     }
 
-    void ViewHexEditor::copyBytes() {
+    Region ViewHexEditor::getSelection() const {
         auto provider = SharedData::currentProvider;
 
         size_t start = std::min(this->m_memoryEditor.DataPreviewAddr, this->m_memoryEditor.DataPreviewAddrEnd);
         size_t end = std::max(this->m_memoryEditor.DataPreviewAddr, this->m_memoryEditor.DataPreviewAddrEnd);
 
-        size_t copySize = (end - start) + 1;
+        return { u64(provider->getCurrentPage()) * prv::Provider::PageSize + start, (end - start) + 1 };
+    }
 
-        std::vector<u8> buffer(copySize, 0x00);
-        provider->read(start, buffer.data(), buffer.size());
+    /*
+        Formats the region in one of the copy formats. The region is read and formatted chunk by chunk and every chunk's text
+        is handed to the callback on its own, so neither the whole region nor its text ever have to be in memory at once
+    */
+    void ViewHexEditor::formatSelection(prv::Provider *provider, Region region, CopyFormat format, const std::function<void(std::string_view)> &output, Task *task) {
+        constexpr static size_t ChunkSize = 0x10'0000;
 
-        std::string str;
-        for (const auto &byte : buffer)
-            str += hex::format("{0:02X} ", byte);
-        str.pop_back();
+        std::vector<u8> buffer;
+        std::string text;
 
-        ImGui::SetClipboardText(str.c_str());
-    }
+        auto flush = [&](u64 done) {
+            output(text);
+            text.clear();
 
-    void ViewHexEditor::copyString() {
-        auto provider = SharedData::currentProvider;
+            if (task != nullptr)
+                task->update(done);
+        };
 
-        size_t start = std::min(this->m_memoryEditor.DataPreviewAddr, this->m_memoryEditor.DataPreviewAddrEnd);
-        size_t end = std::max(this->m_memoryEditor.DataPreviewAddr, this->m_memoryEditor.DataPreviewAddrEnd);
+        auto interrupted = [&] { return task != nullptr && task->isInterrupted(); };
 
-        size_t copySize = (end - start) + 1;
+        if (format == CopyFormat::HexView || format == CopyFormat::HexViewHTML) {
+            bool html = format == CopyFormat::HexViewHTML;
 
-        std::string buffer(copySize, 0x00);
-        buffer.reserve(copySize + 1);
-        provider->read(start, buffer.data(), copySize);
+            if (html) {
+                text +=
+R"(
+<div>
+    <style type="text/css">
+        .offsetheader { color:#0000A0; line-height:200% }
+        .offsetcolumn { color:#0000A0 }
+        .hexcolumn { color:#000000 }
+        .textcolumn { color:#000000 }
+    </style>
 
-        ImGui::SetClipboardText(buffer.c_str());
-    }
+    <code>
+        <span class="offsetheader">Hex View&nbsp&nbsp00 01 02 03 04 05 06 07&nbsp 08 09 0A 0B 0C 0D 0E 0F</span><br/>
+)";
+            } else
+                text += "Hex View  00 01 02 03 04 05 06 07  08 09 0A 0B 0C 0D 0E 0F\n\n";
+
+            const u64 start = region.address, end = region.address + region.size - 1;
+            constexpr static u64 RowsPerChunk = ChunkSize / 0x10;
+
+            for (u64 firstRow = start >> 4; firstRow <= (end >> 4) && !interrupted(); firstRow += RowsPerChunk) {
+                u64 lastRow = std::min(firstRow + RowsPerChunk - 1, end >> 4);
+                u64 chunkStart = std::max(firstRow << 4, start), chunkEnd = std::min((lastRow << 4) | 0xF, end);
+
+                buffer.resize(chunkEnd - chunkStart + 1);
+                provider->readAbsolute(chunkStart, buffer.data(), buffer.size());
+                text.reserve(text.size() + (lastRow - firstRow + 1) * (html ? 200 : 78));
+
+                for (u64 row = firstRow; row <= lastRow; row++) {
+                    if (html)
+                        text += hex::format("        <span class=\"offsetcolumn\">{0:08X}</span>&nbsp&nbsp<span class=\"hexcolumn\">", row << 4);
+                    else
+                        text += hex::format("{0:08X}  ", row << 4);
+
+                    for (u64 i = 0; i < 16; i++) {
+                        u64 address = (row << 4) + i;
+
+                        if (address < start || address > end)
+                            text += html ? "&nbsp&nbsp " : "   ";
+                        else {
+                            hex::appendHexString(text, { &buffer[address - chunkStart], 1 });
+                            text += ' ';
+                        }
 
-    void ViewHexEditor::copyLanguageArray(Language language) {
-        auto provider = SharedData::currentProvider;
+                        if (i == 7)
+                            text += html ? "&nbsp" : " ";
+                    }
 
-        size_t start = std::min(this->m_memoryEditor.DataPreviewAddr, this->m_memoryEditor.DataPreviewAddrEnd);
-        size_t end = std::max(this->m_memoryEditor.DataPreviewAddr, this->m_memoryEditor.DataPreviewAddrEnd);
+                    text += html ? "</span>&nbsp&nbsp<span class=\"textcolumn\">" : " ";
 
-        size_t copySize = (end - start) + 1;
+                    for (u64 i = 0; i < 16; i++) {
+                        u64 address = (row << 4) + i;
 
-        std::vector<u8> buffer(copySize, 0x00);
-        provider->read(start, buffer.data(), buffer.size());
+                        if (address < start || address > end)
+                            text += html ? "&nbsp" : " ";
+                        else {
+                            u8 c = buffer[address - chunkStart];
+                            text += (c < 32 || c >= 128) ? '.' : char(c);
+                        }
+                    }
 
-        std::string str;
-        switch (language) {
-            case Language::C:
-                str += "const unsigned char data[" + std::to_string(buffer.size()) + "] = { ";
+                    text += html ? "</span><br/>\n" : "\n";
+                }
 
-                for (const auto &byte : buffer)
-                    str += hex::format("0x{0:02X}, ", byte);
+                flush(chunkEnd - start + 1);
+            }
 
-                // Remove trailing comma
-                str.pop_back();
-                str.pop_back();
+            if (html) {
+                text +=
+R"(
+    </code>
+</div>
+)";
+            }
 
-                str += " };";
-                break;
-            case Language::Cpp:
-                str += "constexpr std::array<unsigned char, " + std::to_string(buffer.size()) + "> data = { ";
+            output(text);
+            return;
+        }
+
+        const auto size = std::to_string(region.size);
+        std::string prefix, separator = ", ", footer;
+        switch (format) {
+            case CopyFormat::Bytes:         separator = " "; break;
+            case CopyFormat::C:             prefix = "0x"; text = "const unsigned char data[" + size + "] = { ";                  footer = " };";  break;
+            case CopyFormat::Cpp:           prefix = "0x"; text = "constexpr std::array<unsigned char, " + size + "> data = { "; footer = " };";  break;
+            case CopyFormat::Java:          prefix = "0x"; text = "final byte[] data = { ";                                     footer = " };";  break;
+            case CopyFormat::CSharp:        prefix = "0x"; text = "const byte[] data = { ";                                     footer = " };";  break;
+            case CopyFormat::Rust:          prefix = "0x"; text = "let data: [u8, " + size + "] = [ ";                           footer = " ];";  break;
+            case CopyFormat::Python:        prefix = "0x"; text = "data = bytes([ ";                                            footer = " ]);"; break;
+            case CopyFormat::JavaScript:    prefix = "0x"; text = "const data = new Uint8Array([ ";                             footer = " ]);"; break;
+            default: break;
+        }
 
-                for (const auto &byte : buffer)
-                    str += hex::format("0x{0:02X}, ", byte);
+        for (u64 offset = 0; offset < region.size && !interrupted();) {
+            buffer.resize(std::min<u64>(ChunkSize, region.size - offset));
+            provider->readAbsolute(region.address + offset, buffer.data(), buffer.size());
 
-                // Remove trailing comma
-                str.pop_back();
-                str.pop_back();
+            // The separator between the last byte of the previous chunk and the first one of this chunk
+            if (offset != 0)
+                text += separator;
+            hex::appendHexString(text, buffer, prefix, separator);
 
-                str += " };";
-                break;
-            case Language::Java:
-                str += "final byte[] data = { ";
+            offset += buffer.size();
+            flush(offset);
+        }
 
-                for (const auto &byte : buffer)
-                    str += hex::format("0x{0:02X}, ", byte);
+        text += footer;
+        output(text);
+    }
 
-                // Remove trailing comma
-                str.pop_back();
-                str.pop_back();
+    void ViewHexEditor::copySelection(CopyFormat format) {
+        std::string text;
+        formatSelection(SharedData::currentProvider, this->getSelection(), format, [&text](std::string_view chunk) { text += chunk; });
 
-                str += " };";
-                break;
-            case Language::CSharp:
-                str += "const byte[] data = { ";
+        ImGui::SetClipboardText(text.c_str());
+    }
 
-                for (const auto &byte : buffer)
-                    str += hex::format("0x{0:02X}, ", byte);
+    /* Writes the formatted selection straight into the file, for selections too big to go through the clipboard */
+    void ViewHexEditor::exportSelection(const std::string &path, CopyFormat format) {
+        auto region = this->getSelection();
 
-                // Remove trailing comma
-                str.pop_back();
-                str.pop_back();
+        this->m_exportTask = TaskManager::createTask("hex.view.hexeditor.export.selection.exporting", region.size, [handle = ImHexApi::Provider::getHandle(), path, region, format](Task &task) {
+            FILE *file = fopen(path.c_str(), "wb");
+            if (file == nullptr) {
+                View::doLater([] { View::showErrorPopup("hex.view.hexeditor.export.selection.error"_lang); });
+                return;
+            }
+            SCOPE_EXIT( fclose(file); );
 
-                str += " };";
-                break;
-            case Language::Rust:
-                str += "let data: [u8, " + std::to_string(buffer.size()) + "] = [ ";
+            auto provider = handle.get();
+            provider->adviseAccess(region.address, region.size, prv::Provider::AccessHint::Sequential);
+            SCOPE_EXIT( provider->adviseAccess(region.address, region.size, prv::Provider::AccessHint::Normal); );
+
+            formatSelection(provider, region, format, [file](std::string_view chunk) { fwrite(chunk.data(), 1, chunk.size(), file); }, &task);
+        });
+    }
 
-                for (const auto &byte : buffer)
-                    str += hex::format("0x{0:02X}, ", byte);
+    void ViewHexEditor::copyString() {
+        auto provider = SharedData::currentProvider;
 
-                // Remove trailing comma
-                str.pop_back();
-                str.pop_back();
+        size_t start = std::min(this->m_memoryEditor.DataPreviewAddr, this->m_memoryEditor.DataPreviewAddrEnd);
+        size_t end = std::max(this->m_memoryEditor.DataPreviewAddr, this->m_memoryEditor.DataPreviewAddrEnd);
 
-                str += " ];";
-                break;
-            case Language::Python:
-                str += "data = bytes([ ";
+        size_t copySize = (end - start) + 1;
 
-                for (const auto &byte : buffer)
-                    str += hex::format("0x{0:02X}, ", byte);
+        std::string buffer(copySize, 0x00);
+        buffer.reserve(copySize + 1);
+        provider->read(start, buffer.data(), copySize);
 
-                // Remove trailing comma
-                str.pop_back();
-                str.pop_back();
+        ImGui::SetClipboardText(buffer.c_str());
+    }
 
-                str += " ]);";
-                break;
-            case Language::JavaScript:
-                str += "const data = new Uint8Array([ ";
 
-                for (const auto &byte : buffer)
-                    str += hex::format("0x{0:02X}, ", byte);
+    static std::pair<std::vector<u8>, std::vector<u8>> findString(std::string string) {
+        return { std::vector<u8>(string.begin(), string.end()), { } };
+    }
 
-                // Remove trailing comma
-                str.pop_back();
-                str.pop_back();
+    static std::pair<std::vector<u8>, std::vector<u8>> findHex(std::string string) {
+        std::vector<u8> bytes, mask;
 
-                str += " ]);";
-                break;
-        }
+        // Allows wildcards for whole bytes "??" or single nibbles "?F"
+        if (!SequenceSearcher::parseHexPattern(string, bytes, mask))
+            return { };
 
-        ImGui::SetClipboardText(str.c_str());
+        return { bytes, mask };
     }
 
-    void ViewHexEditor::copyHexView() {
+    void ViewHexEditor::startSearch(const std::pair<std::vector<u8>, std::vector<u8>> &sequence) {
         auto provider = SharedData::currentProvider;
+        if (this->m_searchTask.isRunning() || provider == nullptr || sequence.first.empty())
+            return;
 
-        size_t start = std::min(this->m_memoryEditor.DataPreviewAddr, this->m_memoryEditor.DataPreviewAddrEnd);
-        size_t end = std::max(this->m_memoryEditor.DataPreviewAddr, this->m_memoryEditor.DataPreviewAddrEnd);
+        auto results = this->m_lastSearchBuffer;
+        results->clear(sequence.first.size());
+        this->m_lastSearchIndex = 0;
+        this->m_narrowError.clear();
 
-        size_t copySize = (end - start) + 1;
+        this->m_searchTask = TaskManager::createTask("hex.view.hexeditor.search.searching", provider->getActualSize(), [this, handle = ImHexApi::Provider::getHandle(), sequence, results](auto &task) {
+            auto provider = handle.get();
 
-        std::vector<u8> buffer(copySize, 0x00);
-        provider->read(start, buffer.data(), buffer.size());
+            auto &[bytes, mask] = sequence;
+            std::atomic<u64> searchedBytes = 0;
 
-        std::string str = "Hex View  00 01 02 03 04 05 06 07  08 09 0A 0B 0C 0D 0E 0F\n\n";
+            SequenceSearcher searcher({ bytes }, { mask });
+            searcher.searchParallel(provider, 0, provider->getActualSize(), [&](u64, size_t chunkSize, auto &&occurrences) {
+                std::vector<u64> addresses;
+                addresses.reserve(occurrences.size());
+                for (const auto &[address, needle] : occurrences)
+                    addresses.push_back(address);
 
+                // Wildcards may have matched anything, the bytes actually found are what narrowing compares against later
+                auto snapshot = SearchResults::readSnapshot(provider, addresses, bytes.size());
 
-        for (u32 col = start >> 4; col <= (end >> 4); col++) {
-            str += hex::format("{0:08X}  ", col << 4);
-            for (u64 i = 0 ; i < 16; i++) {
+                {
+                    std::scoped_lock lock(this->m_searchResultsMutex);
+                    this->m_pendingSearchResults.push_back({ results, std::move(addresses), { }, std::move(snapshot) });
+                }
 
-                if (col == (start >> 4) && i < (start & 0xF) || col == (end >> 4) && i > (end & 0xF))
-                    str += "   ";
-                else
-                    str += hex::format("{0:02X} ", buffer[((col << 4) - start) + i]);
+                task.update(searchedBytes += chunkSize);
+            }, task.getInterruptFlag());
+        });
+    }
 
-                if ((i & 0xF) == 0x7)
-                    str += " ";
-            }
+    void ViewHexEditor::startRegexSearch(const std::string &pattern) {
+        auto provider = SharedData::currentProvider;
+        if (this->m_searchTask.isRunning() || provider == nullptr)
+            return;
 
-            str += " ";
+        // Compiling is quick, doing it right away lets mistakes in the pattern show up before anything gets searched
+        std::shared_ptr<RegexSearcher> searcher;
+        try {
+            searcher = std::make_shared<RegexSearcher>(pattern, this->m_regexCaseInsensitive);
+            this->m_regexError.clear();
+        } catch (const std::invalid_argument &e) {
+            this->m_regexError = e.what();
+            return;
+        }
 
-            for (u64 i = 0 ; i < 16; i++) {
+        // Matches have varying sizes, so these results can't be narrowed
+        auto results = this->m_lastSearchBuffer;
+        results->clear(0);
+        this->m_lastSearchIndex = 0;
+        this->m_narrowError.clear();
+
+        this->m_searchTask = TaskManager::createTask("hex.view.hexeditor.search.searching", provider->getActualSize(), [this, handle = ImHexApi::Provider::getHandle(), searcher, results](auto &task) {
+            auto provider = handle.get();
+
+            // Matches found so far get handed over every time the search moves on to the next chunk
+            std::vector<u64> addresses;
+            std::vector<u32> sizes;
+            const auto flushResults = [&] {
+                if (addresses.empty())
+                    return;
+
+                std::scoped_lock lock(this->m_searchResultsMutex);
+                this->m_pendingSearchResults.push_back({ results, std::move(addresses), std::move(sizes), { } });
+                addresses.clear();
+                sizes.clear();
+            };
+
+            searcher->search(provider, 0, provider->getActualSize(), [&](u64 address, size_t size) {
+                addresses.push_back(address);
+                sizes.push_back(size);
+                return true;
+            }, task.getInterruptFlag(), [&](u64 searchedBytes) {
+                flushResults();
+                task.update(searchedBytes);
+            });
 
-                if (col == (start >> 4) && i < (start & 0xF) || col == (end >> 4) && i > (end & 0xF))
-                    str += " ";
-                else {
-                    u8 c = buffer[((col << 4) - start) + i];
-                    char displayChar = (c < 32 || c >= 128) ? '.' : c;
-                    str += hex::format("{0}", displayChar);
+            flushResults();
+        });
+    }
+
+    std::optional<ValueSearcher> ViewHexEditor::makeValueSearcher() {
+        auto type = this->m_valueSearchType;
+        auto mode = this->m_valueSearchMode;
+        std::string_view first = this->m_searchValueBuffer.data(), second = this->m_searchValueLimitBuffer.data();
+        u32 alignment = this->m_valueSearchAligned ? ValueSearcher::getSize(type) : 1;
+
+        // Exact values and tolerances are searched as ranges as well, tolerances saturate instead of wrapping around
+        std::optional<ValueSearcher> searcher;
+        if (ValueSearcher::isFloatingPoint(type)) {
+            auto value = ValueSearcher::parseFloat(first);
+            auto limit = mode == ValueSearchMode::Exact ? value : ValueSearcher::parseFloat(second);
+
+            if (value.has_value() && limit.has_value()) {
+                if (mode == ValueSearchMode::Exact || mode == ValueSearchMode::Range)
+                    searcher.emplace(type, this->m_valueSearchEndian, alignment, *value, *limit);
+                else if (*limit >= 0)
+                    searcher.emplace(type, this->m_valueSearchEndian, alignment, *value - *limit, *value + *limit);
+            }
+        } else {
+            auto value = ValueSearcher::parseInteger(type, first);
+            auto limit = mode == ValueSearchMode::Exact ? value : ValueSearcher::parseInteger(type, second);
+
+            if (value.has_value() && limit.has_value()) {
+                if (mode == ValueSearchMode::Exact || mode == ValueSearchMode::Range)
+                    searcher.emplace(type, this->m_valueSearchEndian, alignment, *value, *limit);
+                else if (ValueSearcher::isSigned(type)) {
+                    s64 low, high;
+                    if (s64(*limit) >= 0) {
+                        if (__builtin_sub_overflow(s64(*value), s64(*limit), &low))
+                            low = std::numeric_limits<s64>::min();
+                        if (__builtin_add_overflow(s64(*value), s64(*limit), &high))
+                            high = std::numeric_limits<s64>::max();
+
+                        searcher.emplace(type, this->m_valueSearchEndian, alignment, u64(low), u64(high));
+                    }
+                } else {
+                    u64 low, high;
+                    if (__builtin_sub_overflow(*value, *limit, &low))
+                        low = 0;
+                    if (__builtin_add_overflow(*value, *limit, &high))
+                        high = std::numeric_limits<u64>::max();
+
+                    searcher.emplace(type, this->m_valueSearchEndian, alignment, low, high);
                 }
             }
-
-            str += "\n";
         }
 
+        if (!searcher.has_value())
+            this->m_valueSearchError = hex::format("hex.view.hexeditor.search.value.invalid"_lang, ValueTypeNames[u8(type)]);
+        else
+            this->m_valueSearchError.clear();
 
-        ImGui::SetClipboardText(str.c_str());
+        return searcher;
     }
 
-    void ViewHexEditor::copyHexViewHTML() {
+    void ViewHexEditor::startValueSearch() {
         auto provider = SharedData::currentProvider;
+        if (this->m_searchTask.isRunning() || provider == nullptr)
+            return;
 
-        size_t start = std::min(this->m_memoryEditor.DataPreviewAddr, this->m_memoryEditor.DataPreviewAddrEnd);
-        size_t end = std::max(this->m_memoryEditor.DataPreviewAddr, this->m_memoryEditor.DataPreviewAddrEnd);
+        auto searcher = this->makeValueSearcher();
+        if (!searcher.has_value())
+            return;
 
-        size_t copySize = (end - start) + 1;
+        auto results = this->m_lastSearchBuffer;
+        results->clear(searcher->getSize());
+        this->m_lastSearchIndex = 0;
+        this->m_narrowError.clear();
+        this->m_valueResultType = this->m_valueSearchType;
+        this->m_valueResultEndian = this->m_valueSearchEndian;
 
-        std::vector<u8> buffer(copySize, 0x00);
-        provider->read(start, buffer.data(), buffer.size());
+        this->m_searchTask = TaskManager::createTask("hex.view.hexeditor.search.searching", provider->getActualSize(), [this, handle = ImHexApi::Provider::getHandle(), searcher = std::move(searcher.value()), results](auto &task) {
+            auto provider = handle.get();
 
-        std::string str =
-R"(
-<div>
-    <style type="text/css">
-        .offsetheader { color:#0000A0; line-height:200% }
-        .offsetcolumn { color:#0000A0 }
-        .hexcolumn { color:#000000 }
-        .textcolumn { color:#000000 }
-    </style>
+            std::atomic<u64> searchedBytes = 0;
+            size_t valueSize = searcher.getSize();
 
-    <code>
-        <span class="offsetheader">Hex View&nbsp&nbsp00 01 02 03 04 05 06 07&nbsp 08 09 0A 0B 0C 0D 0E 0F</span><br/>
-)";
+            searcher.searchParallel(provider, 0, provider->getActualSize(), [&](u64, size_t chunkSize, std::vector<u64> &&addresses) {
+                auto snapshot = SearchResults::readSnapshot(provider, addresses, valueSize);
 
+                {
+                    std::scoped_lock lock(this->m_searchResultsMutex);
+                    this->m_pendingSearchResults.push_back({ results, std::move(addresses), { }, std::move(snapshot) });
+                }
 
-        for (u32 col = start >> 4; col <= (end >> 4); col++) {
-            str += hex::format("        <span class=\"offsetcolumn\">{0:08X}</span>&nbsp&nbsp<span class=\"hexcolumn\">", col << 4);
-            for (u64 i = 0 ; i < 16; i++) {
+                task.update(searchedBytes += chunkSize);
+            }, task.getInterruptFlag());
+        });
+    }
 
-                if (col == (start >> 4) && i < (start & 0xF) || col == (end >> 4) && i > (end & 0xF))
-                    str += "&nbsp&nbsp ";
-                else
-                    str += hex::format("{0:02X} ", buffer[((col << 4) - start) + i]);
+    static std::string formatValue(ValueType type, std::endian endian, const u8 *data) {
+        u64 bits = 0;
+        size_t size = ValueSearcher::getSize(type);
+        std::memcpy(&bits, data, size);
+        hex::changeEndianess(&bits, 1, size, endian);
+
+        switch (type) {
+            case ValueType::S8:     return hex::format("{}", s8(bits));
+            case ValueType::S16:    return hex::format("{}", s16(bits));
+            case ValueType::S32:    return hex::format("{}", s32(bits));
+            case ValueType::S64:    return hex::format("{}", s64(bits));
+            case ValueType::Float:  return hex::format("{}", std::bit_cast<float>(u32(bits)));
+            case ValueType::Double: return hex::format("{}", std::bit_cast<double>(bits));
+            default:                return hex::format("{}", bits);
+        }
+    }
 
-                if ((i & 0xF) == 0x7)
-                    str += "&nbsp";
-            }
+    void ViewHexEditor::drawValueSearchResults() {
+        auto provider = SharedData::currentProvider;
+        if (provider == nullptr || this->m_lastValueSearch.empty())
+            return;
 
-            str += "</span>&nbsp&nbsp<span class=\"textcolumn\">";
+        if (ImGui::BeginTable("##valueResults", 3, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY, ImVec2(0, 200))) {
+            ImGui::TableSetupScrollFreeze(0, 1);
+            ImGui::TableSetupColumn("hex.common.address"_lang);
+            ImGui::TableSetupColumn("hex.view.hexeditor.search.value.value"_lang);
+            ImGui::TableSetupColumn("hex.view.hexeditor.search.value.previous"_lang);
+            ImGui::TableHeadersRow();
+
+            // Values are read when their row gets shown so they're current even after edits, next to the ones found by the last search or narrowing
+            ImGuiListClipper clipper;
+            clipper.Begin(this->m_lastValueSearch.size());
+
+            std::array<u8, sizeof(u64)> bytes = { };
+            while (clipper.Step()) {
+                for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
+                    auto result = this->m_lastValueSearch[i];
+
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+                    ImGui::PushID(i);
+                    if (ImGui::Selectable("##result", this->m_lastSearchIndex == i, ImGuiSelectableFlags_SpanAllColumns | ImGuiSelectableFlags_AllowItemOverlap)) {
+                        this->m_lastSearchIndex = i;
+                        this->gotoSearchResult(result);
+                    }
+                    ImGui::PopID();
+                    ImGui::SameLine();
+                    ImGui::Text("0x%08llX", result.first);
 
-            for (u64 i = 0 ; i < 16; i++) {
+                    ImGui::TableNextColumn();
+                    provider->readAbsolute(result.first, bytes.data(), result.second - result.first);
+                    ImGui::TextUnformatted(formatValue(this->m_valueResultType, this->m_valueResultEndian, bytes.data()).c_str());
 
-                if (col == (start >> 4) && i < (start & 0xF) || col == (end >> 4) && i > (end & 0xF))
-                    str += "&nbsp";
-                else {
-                    u8 c = buffer[((col << 4) - start) + i];
-                    char displayChar = (c < 32 || c >= 128) ? '.' : c;
-                    str += hex::format("{0}", displayChar);
+                    ImGui::TableNextColumn();
+                    ImGui::TextUnformatted(formatValue(this->m_valueResultType, this->m_valueResultEndian, this->m_lastValueSearch.getSnapshot(i)).c_str());
                 }
             }
 
-            str += "</span><br/>\n";
+            ImGui::EndTable();
         }
-
-        str +=
-R"(
-    </code>
-</div>
-)";
-
-
-        ImGui::SetClipboardText(str.c_str());
     }
 
-    static std::vector<std::pair<u64, u64>> findString(prv::Provider* &provider, std::string string) {
-        std::vector<std::pair<u64, u64>> results;
-
-        u32 foundCharacters = 0;
-
-        std::vector<u8> buffer(1024, 0x00);
-        size_t dataSize = provider->getSize();
-        for (u64 offset = 0; offset < dataSize; offset += 1024) {
-            size_t usedBufferSize = std::min(u64(buffer.size()), dataSize - offset);
-            provider->read(offset, buffer.data(), usedBufferSize);
+    void ViewHexEditor::narrowSearchResults(SearchResults::Filter filter, const char *input) {
+        auto provider = SharedData::currentProvider;
+        auto results = this->m_lastSearchBuffer;
+        if (this->m_searchTask.isRunning() || provider == nullptr || !results->canNarrow())
+            return;
 
-            for (u64 i = 0; i < usedBufferSize; i++) {
-                if (buffer[i] == string[foundCharacters])
-                    foundCharacters++;
-                else
-                    foundCharacters = 0;
+        // Matching checks the previous results against what's entered now, which has to be just as large as them
+        SearchResults::Predicate predicate;
+        if (filter == SearchResults::Filter::Matching) {
+            if (results == &this->m_lastValueSearch) {
+                auto searcher = this->makeValueSearcher();
+                if (!searcher.has_value())
+                    return;
+
+                if (searcher->getSize() == results->getResultSize()) {
+                    predicate = [searcher = std::move(searcher.value())](const u8 *data) { return searcher.matches(data); };
+                    this->m_valueResultType = this->m_valueSearchType;
+                    this->m_valueResultEndian = this->m_valueSearchEndian;
+                }
+            } else if (this->m_searchFunction != nullptr) {
+                auto [bytes, mask] = this->m_searchFunction(input);
 
-                if (foundCharacters == string.size()) {
-                    results.emplace_back(offset + i - foundCharacters + 1, offset + i + 1);
-                    foundCharacters = 0;
+                if (!bytes.empty() && bytes.size() == results->getResultSize()) {
+                    auto searcher = std::make_shared<SequenceSearcher>(std::vector<std::vector<u8>> { bytes }, std::vector<std::vector<u8>> { mask });
+                    predicate = [searcher](const u8 *data) { return searcher->matches(data, 0); };
                 }
             }
+
+            if (predicate == nullptr) {
+                this->m_narrowError = hex::format("hex.view.hexeditor.search.narrow.size_mismatch"_lang, results->getResultSize());
+                return;
+            }
         }
 
-        return results;
+        this->m_narrowError.clear();
+        results->narrow(provider, filter, predicate);
+        this->m_lastSearchIndex = 0;
+    }
+
+    void ViewHexEditor::cancelSearch() {
+        // The search reads from the provider so it has to be done before the provider can go away
+        this->m_searchTask.interrupt();
+        this->m_searchTask.wait();
+
+        std::scoped_lock lock(this->m_searchResultsMutex);
+        this->m_pendingSearchResults.clear();
     }
 
-    static std::vector<std::pair<u64, u64>> findHex(prv::Provider* &provider, std::string string) {
-        std::vector<std::pair<u64, u64>> results;
+    void ViewHexEditor::collectSearchResults() {
+        std::scoped_lock lock(this->m_searchResultsMutex);
 
-        if ((string.size() % 2) == 1)
-            string = "0" + string;
+        for (auto &[results, addresses, sizes, snapshot] : this->m_pendingSearchResults) {
+            if (addresses.empty())
+                continue;
 
-        std::vector<u8> hex;
-        hex.reserve(string.size() / 2);
+            bool firstResults = results->empty();
+            results->insert(std::move(addresses), std::move(sizes), std::move(snapshot));
 
-        for (u32 i = 0; i < string.size(); i += 2) {
-            char byte[3] = { string[i], string[i + 1], 0 };
-            hex.push_back(strtoul(byte, nullptr, 16));
+            if (firstResults && results == this->m_lastSearchBuffer)
+                this->gotoSearchResult((*results)[0]);
         }
 
-        u32 foundCharacters = 0;
+        this->m_pendingSearchResults.clear();
+    }
 
-        std::vector<u8> buffer(1024, 0x00);
-        size_t dataSize = provider->getSize();
-        for (u64 offset = 0; offset < dataSize; offset += 1024) {
-            size_t usedBufferSize = std::min(u64(buffer.size()), dataSize - offset);
-            provider->read(offset, buffer.data(), usedBufferSize);
+    void ViewHexEditor::gotoSearchResult(const std::pair<u64, u64> &result) {
+        auto provider = SharedData::currentProvider;
 
-            for (u64 i = 0; i < usedBufferSize; i++) {
-                if (buffer[i] == hex[foundCharacters])
-                    foundCharacters++;
-                else
-                    foundCharacters = 0;
+        // Search results are absolute addresses and may lie on a different page than the one being shown
+        auto page = provider->getPageOfAddress(result.first);
+        if (!page.has_value())
+            return;
 
-                if (foundCharacters == hex.size()) {
-                    results.emplace_back(offset + i - foundCharacters + 1, offset + i + 1);
-                    foundCharacters = 0;
-                }
-            }
-        }
+        if (page.value() != provider->getCurrentPage())
+            provider->setCurrentPage(page.value());
 
-        return results;
+        u64 pageStart = u64(page.value()) * prv::Provider::PageSize;
+        this->m_memoryEditor.GotoAddrAndHighlight(result.first - pageStart, result.second - pageStart);
     }
 
+    void ViewHexEditor::gotoBookmark(bool next) {
+        auto provider = SharedData::currentProvider;
+        if (provider == nullptr)
+            return;
+
+        // Bookmarks include the base address but not the page, the same as the addresses the memory editor selects
+        u64 address = provider->getBaseAddress();
+        if (this->m_memoryEditor.DataPreviewAddr != -1)
+            address += std::min(this->m_memoryEditor.DataPreviewAddr, this->m_memoryEditor.DataPreviewAddrEnd);
+
+        auto bookmark = next ? ImHexApi::Bookmarks::getNext(address) : ImHexApi::Bookmarks::getPrevious(address);
+        if (bookmark != nullptr)
+            View::postEvent(Events::SelectionChangeRequest, bookmark->region);
+    }
 
     void ViewHexEditor::drawSearchPopup() {
         static auto InputCallback = [](ImGuiInputTextCallbackData* data) -> int {
             auto _this = static_cast<ViewHexEditor*>(data->UserData);
-            auto provider = SharedData::currentProvider;
 
-            *_this->m_lastSearchBuffer = _this->m_searchFunction(provider, data->Buf);
-            _this->m_lastSearchIndex = 0;
+            // Hex searches accept wildcards and spaces on top of hex digits
+            if (data->EventFlag == ImGuiInputTextFlags_CallbackCharFilter)
+                return !(data->EventChar < 0x80 && (std::isxdigit(data->EventChar) || data->EventChar == '?' || data->EventChar == ' '));
 
-            if (_this->m_lastSearchBuffer->size() > 0)
-                _this->m_memoryEditor.GotoAddrAndHighlight((*_this->m_lastSearchBuffer)[0].first, (*_this->m_lastSearchBuffer)[0].second);
+            if (_this->m_lastSearchBuffer == &_this->m_lastValueSearch)
+                _this->startValueSearch();
+            else if (_this->m_searchFunction == nullptr)
+                _this->startRegexSearch(data->Buf);
+            else
+                _this->startSearch(_this->m_searchFunction(data->Buf));
 
             return 0;
         };
 
         static auto Find = [this](char *buffer) {
-            auto provider = SharedData::currentProvider;
-
-            *this->m_lastSearchBuffer = this->m_searchFunction(provider, buffer);
-            this->m_lastSearchIndex = 0;
-
-            if (this->m_lastSearchBuffer->size() > 0)
-                this->m_memoryEditor.GotoAddrAndHighlight((*this->m_lastSearchBuffer)[0].first, (*this->m_lastSearchBuffer)[0].second);
+            if (this->m_lastSearchBuffer == &this->m_lastValueSearch)
+                this->startValueSearch();
+            else if (this->m_searchFunction == nullptr)
+                this->startRegexSearch(buffer);
+            else
+                this->startSearch(this->m_searchFunction(buffer));
         };
 
         static auto FindNext = [this]() {
             if (this->m_lastSearchBuffer->size() > 0) {
                 ++this->m_lastSearchIndex %= this->m_lastSearchBuffer->size();
-                this->m_memoryEditor.GotoAddrAndHighlight((*this->m_lastSearchBuffer)[this->m_lastSearchIndex].first,
-                                                          (*this->m_lastSearchBuffer)[this->m_lastSearchIndex].second);
+                this->gotoSearchResult((*this->m_lastSearchBuffer)[this->m_lastSearchIndex]);
             }
         };
 
@@ -949,8 +1539,7 @@ R"(
 
                 this->m_lastSearchIndex %= this->m_lastSearchBuffer->size();
 
-                this->m_memoryEditor.GotoAddrAndHighlight((*this->m_lastSearchBuffer)[this->m_lastSearchIndex].first,
-                                                          (*this->m_lastSearchBuffer)[this->m_lastSearchIndex].second);
+                this->gotoSearchResult((*this->m_lastSearchBuffer)[this->m_lastSearchIndex]);
             }
         };
 
@@ -974,14 +1563,97 @@ R"(
                     currBuffer = &this->m_searchHexBuffer;
 
                     ImGui::InputText("##nolabel", currBuffer->data(), currBuffer->size(),
-                                     ImGuiInputTextFlags_CharsHexadecimal | ImGuiInputTextFlags_CallbackCompletion,
+                                     ImGuiInputTextFlags_CallbackCharFilter | ImGuiInputTextFlags_CallbackCompletion,
+                                     InputCallback, this);
+                    ImGui::EndTabItem();
+                }
+
+                // Text in the loaded custom encoding, encoded through its table before searching for the bytes
+                if (this->m_currEncodingFile.getLongestSequence() > 0 && ImGui::BeginTabItem("hex.view.hexeditor.search.encoding"_lang)) {
+                    this->m_searchFunction = [this](std::string string) -> std::pair<std::vector<u8>, std::vector<u8>> {
+                        auto bytes = this->m_currEncodingFile.encode(string);
+                        if (!bytes.has_value())
+                            return { };
+
+                        return { std::move(bytes.value()), { } };
+                    };
+                    this->m_lastSearchBuffer = &this->m_lastEncodedSearch;
+                    currBuffer = &this->m_searchEncodedBuffer;
+
+                    ImGui::InputText("##nolabel", currBuffer->data(), currBuffer->size(), ImGuiInputTextFlags_CallbackCompletion,
+                                     InputCallback, this);
+                    ImGui::EndTabItem();
+                }
+
+                // Regular expressions over the raw bytes, searched by startRegexSearch instead of a search function
+                if (ImGui::BeginTabItem("hex.view.hexeditor.search.regex"_lang)) {
+                    this->m_searchFunction = nullptr;
+                    this->m_lastSearchBuffer = &this->m_lastRegexSearch;
+                    currBuffer = &this->m_searchRegexBuffer;
+
+                    ImGui::InputText("##nolabel", currBuffer->data(), currBuffer->size(), ImGuiInputTextFlags_CallbackCompletion,
                                      InputCallback, this);
+                    ImGui::Checkbox("hex.view.hexeditor.search.regex.case_insensitive"_lang, &this->m_regexCaseInsensitive);
+
+                    if (!this->m_regexError.empty())
+                        ImGui::TextColored(ImVec4(0.92F, 0.25F, 0.2F, 1.0F), "%s", this->m_regexError.c_str());
+
+                    ImGui::EndTabItem();
+                }
+
+                // Numbers of a chosen type, at every offset or only at offsets aligned to their size, searched by startValueSearch
+                if (ImGui::BeginTabItem("hex.view.hexeditor.search.value"_lang)) {
+                    this->m_searchFunction = nullptr;
+                    this->m_lastSearchBuffer = &this->m_lastValueSearch;
+                    currBuffer = &this->m_searchValueBuffer;
+
+                    int type = int(this->m_valueSearchType);
+                    if (ImGui::Combo("hex.view.hexeditor.search.value.type"_lang, &type, ValueTypeNames, IM_ARRAYSIZE(ValueTypeNames)))
+                        this->m_valueSearchType = ValueType(type);
+
+                    if (ImGui::RadioButton("hex.view.hexeditor.search.value.exact"_lang, this->m_valueSearchMode == ValueSearchMode::Exact))
+                        this->m_valueSearchMode = ValueSearchMode::Exact;
+                    ImGui::SameLine();
+                    if (ImGui::RadioButton("hex.view.hexeditor.search.value.range"_lang, this->m_valueSearchMode == ValueSearchMode::Range))
+                        this->m_valueSearchMode = ValueSearchMode::Range;
+                    ImGui::SameLine();
+                    if (ImGui::RadioButton("hex.view.hexeditor.search.value.tolerance"_lang, this->m_valueSearchMode == ValueSearchMode::Tolerance))
+                        this->m_valueSearchMode = ValueSearchMode::Tolerance;
+
+                    if (ImGui::RadioButton("hex.common.little_endian"_lang, this->m_valueSearchEndian == std::endian::little))
+                        this->m_valueSearchEndian = std::endian::little;
+                    ImGui::SameLine();
+                    if (ImGui::RadioButton("hex.common.big_endian"_lang, this->m_valueSearchEndian == std::endian::big))
+                        this->m_valueSearchEndian = std::endian::big;
+                    ImGui::SameLine();
+                    ImGui::Checkbox("hex.view.hexeditor.search.value.aligned"_lang, &this->m_valueSearchAligned);
+
+                    const char *firstLabel = this->m_valueSearchMode == ValueSearchMode::Range ? "hex.view.hexeditor.search.value.min"_lang : "hex.view.hexeditor.search.value.value"_lang;
+                    ImGui::InputText(firstLabel, currBuffer->data(), currBuffer->size(), ImGuiInputTextFlags_CallbackCompletion, InputCallback, this);
+
+                    if (this->m_valueSearchMode != ValueSearchMode::Exact) {
+                        const char *secondLabel = this->m_valueSearchMode == ValueSearchMode::Range ? "hex.view.hexeditor.search.value.max"_lang : "hex.view.hexeditor.search.value.tolerance"_lang;
+                        ImGui::InputText(secondLabel, this->m_searchValueLimitBuffer.data(), this->m_searchValueLimitBuffer.size(), ImGuiInputTextFlags_CallbackCompletion, InputCallback, this);
+                    }
+
+                    if (!this->m_valueSearchError.empty())
+                        ImGui::TextColored(ImVec4(0.92F, 0.25F, 0.2F, 1.0F), "%s", this->m_valueSearchError.c_str());
+
                     ImGui::EndTabItem();
                 }
 
                 if (currBuffer != nullptr) {
-                    if (ImGui::Button("hex.view.hexeditor.search.find"_lang))
-                        Find(currBuffer->data());
+                    if (this->m_searchTask.isRunning()) {
+                        ImGui::ProgressBar(this->m_searchTask.getProgress(), ImVec2(200, 0));
+                        ImGui::SameLine();
+                        if (ImGui::Button("hex.common.cancel"_lang))
+                            this->m_searchTask.interrupt();
+                    } else {
+                        if (ImGui::Button("hex.view.hexeditor.search.find"_lang))
+                            Find(currBuffer->data());
+                    }
+
+                    ImGui::TextUnformatted(hex::format("hex.view.hexeditor.search.matches"_lang, this->m_lastSearchBuffer->size()).c_str());
 
                     if (this->m_lastSearchBuffer->size() > 0) {
                         if ((ImGui::Button("hex.view.hexeditor.search.find_next"_lang)))
@@ -991,7 +1663,30 @@ R"(
 
                         if ((ImGui::Button("hex.view.hexeditor.search.find_prev"_lang)))
                             FindPrevious();
+
+                        // Re-checks only the previous results, after the data was edited or refreshed
+                        if (this->m_lastSearchBuffer->canNarrow()) {
+                            ImGui::Disabled([&] {
+                                ImGui::TextUnformatted("hex.view.hexeditor.search.narrow"_lang);
+                                ImGui::SameLine();
+                                if (ImGui::Button("hex.view.hexeditor.search.narrow.matching"_lang))
+                                    this->narrowSearchResults(SearchResults::Filter::Matching, currBuffer->data());
+                                ImGui::SameLine();
+                                if (ImGui::Button("hex.view.hexeditor.search.narrow.changed"_lang))
+                                    this->narrowSearchResults(SearchResults::Filter::Changed, currBuffer->data());
+                                ImGui::SameLine();
+                                if (ImGui::Button("hex.view.hexeditor.search.narrow.unchanged"_lang))
+                                    this->narrowSearchResults(SearchResults::Filter::Unchanged, currBuffer->data());
+                            }, this->m_searchTask.isRunning());
+
+                            if (!this->m_narrowError.empty())
+                                ImGui::TextColored(ImVec4(0.92F, 0.25F, 0.2F, 1.0F), "%s", this->m_narrowError.c_str());
+                        }
                     }
+
+                    // Value searches list their results with the values found, they tend to be too many to step through
+                    if (this->m_lastSearchBuffer == &this->m_lastValueSearch)
+                        this->drawValueSearchResults();
                 }
 
                 ImGui::EndTabBar();
@@ -1065,36 +1760,266 @@ R"(
         }
     }
 
+    /* Tells other views which part of the current page changed, or that everything may have changed if it's outside of it */
+    static void postDataChanged(Region region) {
+        auto provider = SharedData::currentProvider;
+        u64 pageStart = u64(provider->getCurrentPage()) * prv::Provider::PageSize;
+
+        if (region.address >= pageStart && region.address + region.size <= pageStart + provider->getSize())
+            View::postEvent(Events::DataChanged, Region { region.address - pageStart, region.size });
+        else
+            View::postEvent(Events::DataChanged);
+    }
+
+    void ViewHexEditor::collectProviderChanges() {
+        auto provider = SharedData::currentProvider;
+        if (provider == nullptr)
+            return;
+
+        size_t oldSize = provider->getActualSize();
+        auto changedRegions = provider->getChangedRegions();
+
+        // Following keeps the end of the data in view, even once it grew onto a new page
+        if (provider->isFollowing() && provider->getActualSize() > oldSize) {
+            provider->setCurrentPage(provider->getPageCount() - 1);
+            this->m_memoryEditor.ScrollToEnd = true;
+        }
+
+        // Live data keeps changing all over the place, only changes on the current page are worth having the other views react to
+        u64 pageStart = u64(provider->getCurrentPage()) * prv::Provider::PageSize;
+        u64 pageEnd = pageStart + provider->getSize();
+        for (const auto &region : changedRegions) {
+            u64 start = std::max(region.address, pageStart);
+            u64 end = std::min(region.address + region.size, pageEnd);
+
+            if (start < end)
+                postDataChanged({ start, end - start });
+        }
+    }
+
+    void ViewHexEditor::undo() {
+        auto provider = SharedData::currentProvider;
+        if (provider == nullptr || !provider->canUndo())
+            return;
+
+        postDataChanged(provider->undo());
+        ProjectFile::markDirty();
+    }
+
+    void ViewHexEditor::redo() {
+        auto provider = SharedData::currentProvider;
+        if (provider == nullptr || !provider->canRedo())
+            return;
+
+        postDataChanged(provider->redo());
+        ProjectFile::markDirty();
+    }
+
+    /* The selection is read and changed on a worker thread, the result gets written back in one go as a single undo step */
+    void ViewHexEditor::modifySelection(ByteOperator byteOperator) {
+        auto handle = ImHexApi::Provider::getHandle();
+        if (handle == nullptr)
+            return;
+
+        this->m_modifyTask = TaskManager::createTask("hex.view.hexeditor.modify.running", this->getSelection().size, [handle, region = this->getSelection(), byteOperator = std::move(byteOperator)](Task &task) {
+            constexpr static size_t ChunkSize = 0x10'0000;
+
+            auto provider = handle.get();
+            provider->adviseAccess(region.address, region.size, prv::Provider::AccessHint::Sequential);
+            SCOPE_EXIT( provider->adviseAccess(region.address, region.size, prv::Provider::AccessHint::Normal); );
+
+            std::vector<u8> data(region.size);
+            for (u64 offset = 0; offset < region.size; offset += ChunkSize) {
+                if (task.isInterrupted())
+                    return;
+
+                provider->readAbsolute(region.address + offset, data.data() + offset, std::min<u64>(ChunkSize, region.size - offset));
+                task.update(offset);
+            }
+
+            byteOperator.apply(data.data(), data.size());
+
+            View::doLater([handle, region, data = std::move(data)] {
+                auto provider = handle.get();
+                if (provider != SharedData::currentProvider)
+                    return;
+
+                provider->writeAbsolute(region.address, data.data(), data.size());
+
+                postDataChanged(region);
+                ProjectFile::markDirty();
+            });
+        });
+    }
+
+    void ViewHexEditor::rebuildHighlightSpans() {
+        // Every bookmark and pattern run becomes a begin and an end boundary. Sweeping over them in order
+        // yields all ranges in which the set of active highlights stays the same
+        struct Boundary {
+            u64 address;
+            bool begin;
+            bool bookmark;
+            size_t index;
+            u32 color;
+        };
+
+        std::vector<Boundary> boundaries;
+
+        size_t bookmarkIndex = 0;
+        for (const auto &[region, name, comment, color, locked] : ImHexApi::Bookmarks::getEntries()) {
+            if (region.size > 0) {
+                boundaries.push_back({ region.address, true, true, bookmarkIndex, color });
+                boundaries.push_back({ region.address + region.size, false, true, bookmarkIndex, color });
+            }
+            bookmarkIndex++;
+        }
+
+        size_t patternIndex = 0;
+        for (const auto &[start, end, color] : this->m_highlightedRanges) {
+            if (end > start) {
+                boundaries.push_back({ start, true, false, patternIndex, color });
+                boundaries.push_back({ end, false, false, patternIndex, color });
+            }
+            patternIndex++;
+        }
+
+        // Highlights of other views are blended like pattern highlights, after the ones of the patterns
+        for (const auto &[name, entries] : ImHexApi::Highlighting::getEntries()) {
+            for (const auto &[region, color] : entries) {
+                if (region.size > 0) {
+                    boundaries.push_back({ region.address, true, false, patternIndex, color });
+                    boundaries.push_back({ region.address + region.size, false, false, patternIndex, color });
+                }
+                patternIndex++;
+            }
+        }
+
+        std::sort(boundaries.begin(), boundaries.end(), [](const auto &left, const auto &right) { return left.address < right.address; });
+
+        this->m_highlightSpans.clear();
+        this->m_highlightCursor = 0;
+        this->m_highlightSpansDirty = false;
+
+        // Later bookmarks are drawn on top of earlier ones, the first matching pattern color gets blended over them
+        std::map<size_t, u32> activeBookmarks, activePatterns;
+
+        for (size_t i = 0; i < boundaries.size();) {
+            u64 address = boundaries[i].address;
+
+            for (; i < boundaries.size() && boundaries[i].address == address; i++) {
+                const auto &boundary = boundaries[i];
+
+                auto &active = boundary.bookmark ? activeBookmarks : activePatterns;
+                if (boundary.begin) active[boundary.index] = boundary.color;
+                else active.erase(boundary.index);
+            }
+
+            if (i == boundaries.size())
+                break;
+
+            std::optional<u32> color;
+            if (!activeBookmarks.empty())
+                color = (activeBookmarks.rbegin()->second & 0x00FFFFFF) | 0x80000000;
+            if (!activePatterns.empty()) {
+                u32 patternColor = (activePatterns.begin()->second & 0x00FFFFFF) | 0x80000000;
+                color = color.has_value() ? ImAlphaBlendColors(patternColor, color.value()) : patternColor;
+            }
+
+            if (!color.has_value())
+                continue;
+
+            u64 nextAddress = boundaries[i].address;
+            if (!this->m_highlightSpans.empty() && this->m_highlightSpans.back().end == address && this->m_highlightSpans.back().color == color.value())
+                this->m_highlightSpans.back().end = nextAddress;
+            else
+                this->m_highlightSpans.push_back({ address, nextAddress, color.value() });
+        }
+    }
+
+    std::optional<u32> ViewHexEditor::getHighlightColor(u64 address) {
+        auto &spans = this->m_highlightSpans;
+        auto &cursor = this->m_highlightCursor;
+
+        // Bytes are usually queried in ascending order, so walking forward a few spans is enough most of the time.
+        // Jumps backwards or far ahead fall back to a binary search
+        if (cursor > spans.size() || (cursor > 0 && spans[cursor - 1].end > address)) {
+            cursor = std::partition_point(spans.begin(), spans.end(), [address](const auto &span) { return span.end <= address; }) - spans.begin();
+        } else {
+            for (u8 step = 0; cursor < spans.size() && spans[cursor].end <= address; step++) {
+                if (step == 8) {
+                    cursor = std::partition_point(spans.begin() + cursor, spans.end(), [address](const auto &span) { return span.end <= address; }) - spans.begin();
+                    break;
+                }
+
+                cursor++;
+            }
+        }
+
+        if (cursor < spans.size() && spans[cursor].start <= address)
+            return spans[cursor].color;
+
+        return { };
+    }
+
     void ViewHexEditor::drawEditPopup() {
-        if (ImGui::BeginMenu("hex.view.hexeditor.menu.edit.copy"_lang, this->m_memoryEditor.DataPreviewAddr != -1 && this->m_memoryEditor.DataPreviewAddrEnd != -1)) {
+        auto provider = SharedData::currentProvider;
+
+        if (ImGui::MenuItem("hex.view.hexeditor.menu.edit.undo"_lang, "CTRL + Z", false, provider != nullptr && provider->canUndo()))
+            this->undo();
+        if (ImGui::MenuItem("hex.view.hexeditor.menu.edit.redo"_lang, "CTRL + Y", false, provider != nullptr && provider->canRedo()))
+            this->redo();
+
+        ImGui::Separator();
+
+        bool hasSelection = this->m_memoryEditor.DataPreviewAddr != -1 && this->m_memoryEditor.DataPreviewAddrEnd != -1;
+
+        constexpr static std::array<std::pair<CopyFormat, const char*>, 7> LanguageFormats = {{
+            { CopyFormat::C, "hex.view.hexeditor.copy.c" }, { CopyFormat::Cpp, "hex.view.hexeditor.copy.cpp" }, { CopyFormat::CSharp, "hex.view.hexeditor.copy.csharp" },
+            { CopyFormat::Rust, "hex.view.hexeditor.copy.rust" }, { CopyFormat::Python, "hex.view.hexeditor.copy.python" }, { CopyFormat::Java, "hex.view.hexeditor.copy.java" },
+            { CopyFormat::JavaScript, "hex.view.hexeditor.copy.js" }
+        }};
+
+        // Everything but the raw string can be copied and exported alike
+        auto drawFormats = [](const std::function<void(CopyFormat)> &callback) {
+            for (auto [format, name] : LanguageFormats) {
+                if (ImGui::MenuItem(LangEntry(name)))
+                    callback(format);
+            }
+
+            ImGui::Separator();
+
+            if (ImGui::MenuItem("hex.view.hexeditor.copy.ascii"_lang))
+                callback(CopyFormat::HexView);
+            if (ImGui::MenuItem("hex.view.hexeditor.copy.html"_lang))
+                callback(CopyFormat::HexViewHTML);
+        };
+
+        if (ImGui::BeginMenu("hex.view.hexeditor.menu.edit.copy"_lang, hasSelection)) {
             if (ImGui::MenuItem("hex.view.hexeditor.copy.bytes"_lang, "CTRL + ALT + C"))
-                this->copyBytes();
+                this->copySelection(CopyFormat::Bytes);
             if (ImGui::MenuItem("hex.view.hexeditor.copy.hex"_lang, "CTRL + SHIFT + C"))
                 this->copyString();
 
             ImGui::Separator();
 
-            if (ImGui::MenuItem("hex.view.hexeditor.copy.c"_lang))
-                this->copyLanguageArray(Language::C);
-            if (ImGui::MenuItem("hex.view.hexeditor.copy.cpp"_lang))
-                this->copyLanguageArray(Language::Cpp);
-            if (ImGui::MenuItem("hex.view.hexeditor.copy.csharp"_lang))
-                this->copyLanguageArray(Language::CSharp);
-            if (ImGui::MenuItem("hex.view.hexeditor.copy.rust"_lang))
-                this->copyLanguageArray(Language::Rust);
-            if (ImGui::MenuItem("hex.view.hexeditor.copy.python"_lang))
-                this->copyLanguageArray(Language::Python);
-            if (ImGui::MenuItem("hex.view.hexeditor.copy.java"_lang))
-                this->copyLanguageArray(Language::Java);
-            if (ImGui::MenuItem("hex.view.hexeditor.copy.js"_lang))
-                this->copyLanguageArray(Language::JavaScript);
+            drawFormats([this](CopyFormat format) { this->copySelection(format); });
+
+            ImGui::EndMenu();
+        }
+
+        if (ImGui::BeginMenu("hex.view.hexeditor.menu.edit.export_selection"_lang, hasSelection && !this->m_exportTask.isRunning())) {
+            auto exportAs = [this](CopyFormat format) {
+                View::openFileBrowser("hex.view.hexeditor.menu.file.export.title"_lang, DialogMode::Save, { }, [this, format](auto path) {
+                    this->exportSelection(path, format);
+                });
+            };
+
+            if (ImGui::MenuItem("hex.view.hexeditor.copy.bytes"_lang))
+                exportAs(CopyFormat::Bytes);
 
             ImGui::Separator();
 
-            if (ImGui::MenuItem("hex.view.hexeditor.copy.ascii"_lang))
-                this->copyHexView();
-            if (ImGui::MenuItem("hex.view.hexeditor.copy.html"_lang))
-                this->copyHexViewHTML();
+            drawFormats(exportAs);
 
             ImGui::EndMenu();
         }
@@ -1108,11 +2033,31 @@ R"(
             ImHexApi::Bookmarks::add(start, end - start + 1, { }, { });
         }
 
-        auto provider = SharedData::currentProvider;
+        if (ImGui::MenuItem("hex.view.hexeditor.menu.edit.next_bookmark"_lang, "CTRL + B", false, provider != nullptr && !ImHexApi::Bookmarks::getEntries().empty()))
+            this->gotoBookmark(true);
+        if (ImGui::MenuItem("hex.view.hexeditor.menu.edit.previous_bookmark"_lang, "CTRL + SHIFT + B", false, provider != nullptr && !ImHexApi::Bookmarks::getEntries().empty()))
+            this->gotoBookmark(false);
+
         if (ImGui::MenuItem("hex.view.hexeditor.menu.edit.set_base"_lang, nullptr, false, provider != nullptr && provider->isReadable())) {
             std::memset(this->m_baseAddressBuffer, 0x00, sizeof(this->m_baseAddressBuffer));
             View::doLater([]{ ImGui::OpenPopup("hex.view.hexeditor.menu.edit.set_base"_lang); });
         }
+
+        if (ImGui::MenuItem("hex.view.hexeditor.menu.edit.modify"_lang, nullptr, false, hasSelection && provider != nullptr && provider->isWritable() && !this->m_modifyTask.isRunning())) {
+            this->m_modifyError.clear();
+            View::doLater([]{ ImGui::OpenPopup("hex.view.hexeditor.menu.edit.modify"_lang); });
+        }
+
+        ImGui::Separator();
+
+        if (ImGui::MenuItem("hex.view.hexeditor.menu.edit.follow"_lang, nullptr, provider != nullptr && provider->isFollowing(), provider != nullptr && provider->canFollow())) {
+            provider->setFollowing(!provider->isFollowing());
+
+            if (provider->isFollowing()) {
+                provider->setCurrentPage(provider->getPageCount() - 1);
+                this->m_memoryEditor.ScrollToEnd = true;
+            }
+        }
     }
 
 }
\ No newline at end of file
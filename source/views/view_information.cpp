@@ -1,138 +1,667 @@
 #include "views/view_information.hpp"
 
+#include <hex/api/imhex_api.hpp>
 #include <hex/providers/provider.hpp>
 #include <hex/helpers/utils.hpp>
+#include <hex/helpers/entropy.hpp>
+#include <hex/helpers/analysis_cache.hpp>
+
+#include "helpers/magic.hpp"
+#include "helpers/session.hpp"
 
 #include <cstring>
 #include <cmath>
-#include <filesystem>
 #include <span>
-#include <thread>
+#include <mutex>
 #include <vector>
 
-#include <magic.h>
-
 #include <imgui_imhex_extensions.h>
 #include <implot.h>
 #include <implot_internal.h>
 
 namespace hex {
 
-    ViewInformation::ViewInformation() : View("hex.view.information.name") {
-        View::subscribeEvent(Events::DataChanged, [this](auto) {
-            this->m_dataValid = false;
-            this->m_highestBlockEntropy = 0;
-            this->m_blockEntropy.clear();
-            this->m_averageEntropy = 0;
-            this->m_blockSize = 0;
-            this->m_valueCounts.fill(0x00);
-            this->m_mimeType = "";
-            this->m_fileDescription = "";
-            this->m_analyzedRegion = { 0, 0 };
+    namespace {
+
+        constexpr auto CacheEntryName = "information";
+
+        // Compressed and encrypted data both get close to the highest entropy possible, text and code stay far below it
+        constexpr float HighEntropyThreshold = 0.9F;
+
+    }
+
+    ViewInformation::ViewInformation() : View("hex.view.information.name"), m_memoryBudget("hex.memory.information", [this](size_t bytes) { return this->evictCachedAnalyses(bytes); }) {
+        View::subscribeEvent(Events::DataChanged, [this](auto userData) {
+            // Edits only invalidate the entropy map blocks they touched, those get recomputed on the next frame
+            if (auto region = std::any_cast<Region>(&userData); region != nullptr && (this->m_dataValid || this->m_analyzerTask.isRunning())) {
+                // The whole file gets analyzed, changed regions are relative to the page they were made in
+                auto pageAddress = prv::Provider::PageSize * SharedData::currentProvider->getCurrentPage();
+
+                std::scoped_lock lock(this->m_changedRegionsMutex);
+                this->m_changedRegions.push_back({ region->address + pageAddress, region->size });
+                return;
+            }
+
+            this->resetAnalysis();
+        });
+
+        View::subscribeEvent<prv::Provider*>(Events::ProviderChanged, [this](prv::Provider *previous) {
+            this->switchProvider(previous);
+
+            this->m_carverTask.interrupt();
+            this->m_carverTask.wait();
+            this->m_carvedFiles.clear();
+            this->m_carvingDone = false;
+
+            this->m_compressionTask.interrupt();
+            this->m_compressionTask.wait();
+            this->m_compressedRegions.clear();
+            this->m_compressionDone = false;
+
+            this->m_duplicatesTask.interrupt();
+            this->m_duplicatesTask.wait();
+            this->m_duplicateGroups.clear();
+            this->m_duplicateRows.clear();
+            this->m_duplicatesDone = false;
+        });
+
+        View::subscribeEvent<prv::Provider*>(Events::ProviderClosed, [this](prv::Provider *provider) {
+            this->m_cachedAnalyses.erase(provider);
+            this->updateMemoryUsage();
+        });
+
+        // A restored session gets its analysis back, only computed again if the data changed since
+        Session::registerAnalysis(CacheEntryName, [this](const std::string&) {
+            if (this->m_dataValid || this->m_analyzerTask.isRunning())
+                return;
+
+            this->m_cacheChecked = true;
+            this->analyze();
+        });
+
+        // Loading large magic databases takes a while, get it done before the first analysis needs them
+        this->m_magicLoaderTask = TaskManager::createTask("hex.view.information.loading_magic", 0, [](Task&) {
+            Magic::preload();
         });
     }
 
     ViewInformation::~ViewInformation() {
+        this->m_analyzerTask.interrupt();
+        this->m_analyzerTask.wait();
+        this->m_carverTask.interrupt();
+        this->m_carverTask.wait();
+        this->m_compressionTask.interrupt();
+        this->m_compressionTask.wait();
+        this->m_duplicatesTask.interrupt();
+        this->m_duplicatesTask.wait();
+        this->m_magicLoaderTask.wait();
+
+        Session::unregisterAnalysis(CacheEntryName);
+
         View::unsubscribeEvent(Events::DataChanged);
+        View::unsubscribeEvent(Events::ProviderChanged);
+        View::unsubscribeEvent(Events::ProviderClosed);
     }
 
-    static float calculateEntropy(std::array<ImU64, 256> &valueCounts, size_t numBytes) {
-        float entropy = 0;
+    void ViewInformation::resetAnalysis() {
+        this->m_dataValid = false;
+        this->m_distributionOutdated = false;
+        this->m_highestBlockEntropy = 0;
+        this->m_highestEntropyBlockAddress = 0;
+        this->m_entropyMap.clear();
+        this->m_averageEntropy = 0;
+        this->m_valueCounts.fill(0x00);
+        this->m_digraphHeatmap.clear();
+        this->m_mimeType = "";
+        this->m_fileDescription = "";
+        this->m_analyzedRegion = { 0, 0 };
+        this->m_cacheChecked = false;
+    }
 
-        if (numBytes == 0)
-            return 0.0F;
+    void ViewInformation::switchProvider(prv::Provider *previous) {
+        this->m_analyzerTask.interrupt();
+        this->m_analyzerTask.wait();
 
-        std::array<float, 256> floatValueCounts{ 0 };
-        std::copy(valueCounts.begin(), valueCounts.end(), floatValueCounts.begin());
+        // Only finished analyses are kept. Edits that weren't applied yet still belong to the previous provider
+        if (previous != nullptr && this->m_dataValid) {
+            this->applyDataChanges(previous);
+
+            this->m_cachedAnalyses[previous] = {
+                this->m_distributionOutdated, this->m_averageEntropy, this->m_highestBlockEntropy, this->m_highestEntropyBlockAddress,
+                std::move(this->m_entropyMap), this->m_valueCounts, std::move(this->m_digraphHeatmap), this->m_analyzedRegion,
+                std::move(this->m_fileDescription), std::move(this->m_mimeType), this->m_cacheCounter++
+            };
+        }
 
-        for (u16 i = 0; i < 256; i++) {
-            floatValueCounts[i] /= float(numBytes);
+        SCOPE_EXIT( this->updateMemoryUsage(); );
 
-            if (floatValueCounts[i] > 0)
-                entropy -= (floatValueCounts[i] * std::log2(floatValueCounts[i]));
+        {
+            std::scoped_lock lock(this->m_changedRegionsMutex);
+            this->m_changedRegions.clear();
         }
 
-        return entropy / 8;
+        this->resetAnalysis();
+        this->m_resetEntropyPlot = true;
+
+        auto it = this->m_cachedAnalyses.find(SharedData::currentProvider);
+        if (it == this->m_cachedAnalyses.end())
+            return;
+
+        auto &cached = it->second;
+        this->m_dataValid = true;
+        this->m_distributionOutdated = cached.distributionOutdated;
+        this->m_averageEntropy = cached.averageEntropy;
+        this->m_highestBlockEntropy = cached.highestBlockEntropy;
+        this->m_highestEntropyBlockAddress = cached.highestEntropyBlockAddress;
+        this->m_entropyMap = std::move(cached.entropyMap);
+        this->m_valueCounts = cached.valueCounts;
+        this->m_digraphHeatmap = std::move(cached.digraphHeatmap);
+        this->m_analyzedRegion = cached.analyzedRegion;
+        this->m_fileDescription = std::move(cached.fileDescription);
+        this->m_mimeType = std::move(cached.mimeType);
+
+        this->m_cachedAnalyses.erase(it);
     }
 
-    void ViewInformation::analyze() {
-        this->m_analyzing = true;
+    namespace {
 
-        std::thread([this]{
-            auto provider = SharedData::currentProvider;
+        size_t getMemoryUsage(const EntropyMap &entropyMap, const std::vector<float> &digraphHeatmap) {
+            return entropyMap.getMemoryUsage() + digraphHeatmap.size() * sizeof(float);
+        }
+
+    }
+
+    size_t ViewInformation::evictCachedAnalyses(size_t bytes) {
+        size_t freed = 0;
+        while (freed < bytes && !this->m_cachedAnalyses.empty()) {
+            auto oldest = std::min_element(this->m_cachedAnalyses.begin(), this->m_cachedAnalyses.end(), [](const auto &left, const auto &right) { return left.second.cachedAt < right.second.cachedAt; });
 
-            this->m_analyzedRegion = { provider->getBaseAddress(), provider->getBaseAddress() + provider->getSize() };
+            freed += getMemoryUsage(oldest->second.entropyMap, oldest->second.digraphHeatmap);
+            this->m_cachedAnalyses.erase(oldest);
+        }
+
+        return freed;
+    }
+
+    void ViewInformation::updateMemoryUsage() {
+        size_t usage = 0;
+        for (const auto &[provider, cached] : this->m_cachedAnalyses)
+            usage += getMemoryUsage(cached.entropyMap, cached.digraphHeatmap);
+
+        this->m_memoryBudget.update(usage);
+    }
+
+    void ViewInformation::analyze(bool onlyCached) {
+        this->m_analyzerTask = TaskManager::createTask("hex.view.information.analyzing", 0, [this, handle = ImHexApi::Provider::getHandle(), onlyCached](Task &task) {
+            auto provider = handle.get();
+
+            u64 baseAddress = provider->getBaseAddress() - prv::Provider::PageSize * provider->getCurrentPage();
+            this->m_analyzedRegion = { baseAddress, baseAddress + provider->getActualSize() };
+
+            if (this->loadCachedAnalysis(provider)) {
+                this->m_resetEntropyPlot = true;
+                this->m_dataValid = true;
+                Session::addAnalysis(provider, CacheEntryName);
+                return;
+            } else if (onlyCached) {
+                this->m_analyzedRegion = { 0, 0 };
+                return;
+            }
 
             {
-                this->m_blockSize = std::max<u32>(std::ceil(provider->getSize() / 2048.0F), 256);
-                std::vector<u8> buffer(this->m_blockSize, 0x00);
-                std::memset(this->m_valueCounts.data(), 0x00, this->m_valueCounts.size() * sizeof(u32));
-                this->m_blockEntropy.clear();
-
-                for (u64 i = 0; i < provider->getSize(); i += this->m_blockSize) {
-                    std::array<ImU64, 256> blockValueCounts = { 0 };
-                    provider->read(i, buffer.data(), std::min(u64(this->m_blockSize), provider->getSize() - i));
-
-                    for (size_t j = 0; j < this->m_blockSize; j++) {
-                        blockValueCounts[buffer[j]]++;
-                        this->m_valueCounts[buffer[j]]++;
-                    }
-                    this->m_blockEntropy.push_back(calculateEntropy(blockValueCounts, this->m_blockSize));
+                auto statistics = this->m_entropyMap.build(provider, 0x00, provider->getActualSize(), task.getInterruptFlag());
+
+                std::copy(statistics.valueCounts.begin(), statistics.valueCounts.end(), this->m_valueCounts.begin());
+                this->m_averageEntropy = calculateEntropy(statistics.valueCounts, provider->getActualSize());
+
+                // Pair counts span many orders of magnitude, a log scale keeps the rare pairs visible
+                auto maxPairCount = *std::max_element(statistics.digraphCounts.begin(), statistics.digraphCounts.end());
+                this->m_digraphHeatmap.resize(DigraphCount);
+                for (size_t pair = 0; pair < DigraphCount; pair++)
+                    this->m_digraphHeatmap[pair] = maxPairCount == 0 ? 0.0F : float(std::log1p(statistics.digraphCounts[pair]) / std::log1p(maxPairCount));
+                this->m_distributionOutdated = false;
+                this->updateHighestEntropyBlock();
+            }
+
+            this->m_resetEntropyPlot = true;
+
+            if (task.isInterrupted())
+                return;
+
+            this->m_fileDescription = Magic::getDescription(provider);
+            this->m_mimeType = Magic::getMIMEType(provider);
+            this->m_dataValid = true;
+
+            this->storeAnalysis(provider);
+            Session::addAnalysis(provider, CacheEntryName);
+        });
+    }
+
+    /* Only the leaves of the entropy map get stored, the levels above them are quick to recompute */
+    void ViewInformation::storeAnalysis(prv::Provider *provider) {
+        AnalysisCache::Writer writer;
+        writer.write(this->m_averageEntropy);
+        writer.write(this->m_valueCounts);
+        writer.writeVector(this->m_digraphHeatmap);
+        writer.writeVector(this->m_entropyMap.getLevel(0));
+        writer.writeString(this->m_fileDescription);
+        writer.writeString(this->m_mimeType);
+
+        AnalysisCache::store(provider, CacheEntryName, writer);
+    }
+
+    bool ViewInformation::loadCachedAnalysis(prv::Provider *provider) {
+        auto reader = AnalysisCache::load(provider, CacheEntryName);
+        if (!reader.has_value())
+            return false;
+
+        float averageEntropy;
+        std::array<ImU64, 256> valueCounts = { 0 };
+        std::vector<float> digraphHeatmap;
+        std::vector<EntropyMap::Node> leaves;
+        std::string fileDescription, mimeType;
+
+        if (!reader->read(averageEntropy) || !reader->read(valueCounts) || !reader->readVector(digraphHeatmap) || !reader->readVector(leaves) || !reader->readString(fileDescription) || !reader->readString(mimeType))
+            return false;
+
+        if (digraphHeatmap.size() != DigraphCount || !this->m_entropyMap.restore(0x00, provider->getActualSize(), std::move(leaves)))
+            return false;
+
+        this->m_averageEntropy = averageEntropy;
+        this->m_valueCounts = valueCounts;
+        this->m_digraphHeatmap = std::move(digraphHeatmap);
+        this->m_fileDescription = std::move(fileDescription);
+        this->m_mimeType = std::move(mimeType);
+        this->m_distributionOutdated = false;
+        this->updateHighestEntropyBlock();
+
+        return true;
+    }
+
+    void ViewInformation::updateHighestEntropyBlock() {
+        if (this->m_entropyMap.empty())
+            return;
+
+        this->m_highestBlockEntropy = this->m_entropyMap.getRoot().maxEntropy;
+        this->m_highestEntropyBlockAddress = this->m_analyzedRegion.first + this->m_entropyMap.getHighestEntropyBlock() * EntropyMap::BlockSize;
+    }
+
+    void ViewInformation::applyDataChanges(prv::Provider *provider) {
+        std::vector<Region> changedRegions;
+
+        {
+            std::scoped_lock lock(this->m_changedRegionsMutex);
+            std::swap(changedRegions, this->m_changedRegions);
+        }
+
+        if (changedRegions.empty())
+            return;
+
+        // Data appended to the end only needs its own blocks computed, the map grows along with it
+        u64 analyzedEnd = this->m_entropyMap.getOffset() + this->m_entropyMap.getSize();
+        for (const auto &region : changedRegions) {
+            if (region.address + region.size > analyzedEnd && provider->getActualSize() > this->m_entropyMap.getSize()) {
+                this->m_entropyMap.grow(provider, provider->getActualSize());
+                this->m_analyzedRegion.second = this->m_analyzedRegion.first + provider->getActualSize();
+
+                bool appended = region.address >= analyzedEnd;
+                analyzedEnd = this->m_entropyMap.getOffset() + this->m_entropyMap.getSize();
+                if (appended)
+                    continue;
+            }
+
+            this->m_entropyMap.update(provider, region.address, region.size);
+        }
+
+        this->updateHighestEntropyBlock();
+        this->m_distributionOutdated = true;
+    }
+
+    void ViewInformation::drawEntropyPlot() {
+        const auto &map = this->m_entropyMap;
+        const u64 baseAddress = this->m_analyzedRegion.first;
+
+        ImPlot::SetNextPlotLimits(baseAddress, baseAddress + map.getSize(), -0.1, 1.1, this->m_resetEntropyPlot ? ImGuiCond_Always : ImGuiCond_Once);
+        this->m_resetEntropyPlot = false;
+
+        if (ImPlot::BeginPlot("##entropy", "Address", "Entropy", ImVec2(-1,0), ImPlotFlags_CanvasOnly, ImPlotAxisFlags_None, ImPlotAxisFlags_Lock)) {
+            auto limits = ImPlot::GetPlotLimits();
+
+            u64 visibleStart = std::clamp<double>(limits.X.Min - baseAddress, 0, map.getSize());
+            u64 visibleEnd = std::clamp<double>(limits.X.Max - baseAddress, 0, map.getSize());
+
+            // Show about one node per pixel, taken from whichever level matches the current zoom
+            size_t level = map.selectLevel(visibleEnd - visibleStart, ImPlot::GetPlotSize().x);
+            u64 levelBlockSize = EntropyMap::getBlockSize(level);
+            const auto &nodes = map.getLevel(level);
+
+            size_t firstNode = std::min<u64>(visibleStart / levelBlockSize, nodes.size() - 1);
+            size_t lastNode = std::min<u64>(visibleEnd / levelBlockSize + 1, nodes.size() - 1);
+
+            std::vector<double> addresses, averages, minimums, maximums, printable;
+            for (size_t node = firstNode; node <= lastNode; node++) {
+                addresses.push_back(baseAddress + node * levelBlockSize);
+                averages.push_back(nodes[node].averageEntropy);
+                minimums.push_back(nodes[node].minEntropy);
+                maximums.push_back(nodes[node].maxEntropy);
+                printable.push_back(nodes[node].getClassRatio(ByteClass::Printable));
+            }
+
+            ImPlot::PlotShaded("##entropy_range", addresses.data(), minimums.data(), maximums.data(), addresses.size());
+            ImPlot::PlotLine("##printable_line", addresses.data(), printable.data(), addresses.size());
+            ImPlot::PlotLine("##entropy_line", addresses.data(), averages.data(), addresses.size());
+
+            if (ImGui::IsItemClicked())
+                View::postEvent(Events::SelectionChangeRequest, Region{ u64(ImPlot::GetPlotMousePos().x), 1 });
+
+            ImPlot::EndPlot();
+        }
+    }
+
+    void ViewInformation::carve() {
+        this->m_carvedBytes = 0;
+        this->m_carvingDone = false;
+        this->m_carvedFiles.clear();
+
+        this->m_carverTask = TaskManager::createTask("hex.view.information.carving.searching", 0, [this, handle = ImHexApi::Provider::getHandle()](Task &task) {
+            auto files = Carver::carve(handle.get(), task.getInterruptFlag(), &this->m_carvedBytes);
+
+            if (task.isInterrupted())
+                return;
+
+            this->m_carvedFiles = std::move(files);
+            this->m_carvingDone = true;
+        });
+    }
+
+    /* Where a file ends isn't known, its bookmark reaches up to the next file found or the end of the data */
+    void ViewInformation::bookmarkCarvedFiles() {
+        u64 dataSize = SharedData::currentProvider->getActualSize();
+
+        for (size_t i = 0; i < this->m_carvedFiles.size(); i++) {
+            const auto &file = this->m_carvedFiles[i];
+            u64 end = i + 1 < this->m_carvedFiles.size() ? this->m_carvedFiles[i + 1].address : dataSize;
+
+            ImHexApi::Bookmarks::add(file.address, end - file.address, file.signature, file.description);
+        }
+    }
+
+    void ViewInformation::drawCarvedFiles() {
+        ImGui::NewLine();
+        ImGui::TextUnformatted("hex.view.information.carving"_lang);
+        ImGui::Separator();
+
+        ImGui::Disabled([this] {
+            if (ImGui::Button("hex.view.information.carving.search"_lang))
+                this->carve();
+        }, this->m_carverTask.isRunning());
+
+        if (this->m_carverTask.isRunning()) {
+            auto dataSize = SharedData::currentProvider->getActualSize();
+
+            ImGui::SameLine();
+            ImGui::ProgressBar(dataSize == 0 ? 1.0F : float(this->m_carvedBytes) / dataSize, ImVec2(200, 0));
+            return;
+        }
+
+        if (!this->m_carvingDone)
+            return;
+
+        if (this->m_carvedFiles.empty()) {
+            ImGui::TextUnformatted("hex.view.information.carving.none"_lang);
+            return;
+        }
+
+        ImGui::SameLine();
+        if (ImGui::Button("hex.view.information.carving.bookmark"_lang))
+            this->bookmarkCarvedFiles();
+
+        if (ImGui::BeginTable("##carved", 3, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_Resizable)) {
+            ImGui::TableSetupColumn("hex.common.address"_lang);
+            ImGui::TableSetupColumn("hex.view.information.carving.type"_lang);
+            ImGui::TableSetupColumn("hex.view.information.carving.description"_lang, ImGuiTableColumnFlags_WidthStretch);
+            ImGui::TableHeadersRow();
+
+            ImGuiListClipper clipper;
+            clipper.Begin(this->m_carvedFiles.size());
+
+            while (clipper.Step()) {
+                for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
+                    const auto &file = this->m_carvedFiles[i];
+
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+                    ImGui::PushID(i);
+                    if (ImGui::Selectable(hex::format("0x{:08X}", file.address).c_str(), false, ImGuiSelectableFlags_SpanAllColumns))
+                        View::postEvent(Events::SelectionChangeRequest, Region { file.address, 1 });
+                    ImGui::PopID();
+
+                    ImGui::TableNextColumn();
+                    ImGui::TextUnformatted(file.signature.c_str());
+                    ImGui::TableNextColumn();
+                    ImGui::TextUnformatted(file.description.c_str());
                 }
+            }
+
+            clipper.End();
+
+            ImGui::EndTable();
+        }
+    }
 
-                this->m_averageEntropy = calculateEntropy(this->m_valueCounts, provider->getSize());
-                this->m_highestBlockEntropy = *std::max_element(this->m_blockEntropy.begin(), this->m_blockEntropy.end());
+    void ViewInformation::findCompressedRegions() {
+        this->m_compressionBytes = 0;
+        this->m_compressionDone = false;
+        this->m_compressedRegions.clear();
+
+        // Runs of high entropy blocks get probed, starting a bit earlier since the entropy of a block only rises once enough compressed data is in it
+        std::vector<Region> regions;
+        const auto &leaves = this->m_entropyMap.getLevel(0);
+        u64 previousEnd = this->m_entropyMap.getOffset();
+        for (size_t i = 0; i < leaves.size(); i++) {
+            if (leaves[i].averageEntropy < HighEntropyThreshold)
+                continue;
+
+            u64 address = this->m_entropyMap.getOffset() + i * EntropyMap::BlockSize;
+            if (!regions.empty() && regions.back().address + regions.back().size == address) {
+                regions.back().size += leaves[i].size;
+            } else {
+                u64 start = std::max(previousEnd, address - std::min<u64>(address, CompressionScanner::RawDeflateSearchSize));
+                regions.push_back({ start, address + leaves[i].size - start });
             }
 
-            {
-                std::vector<u8> buffer(provider->getSize(), 0x00);
-                provider->read(0x00, buffer.data(), buffer.size());
+            previousEnd = address + leaves[i].size;
+        }
 
-                this->m_fileDescription.clear();
-                this->m_mimeType.clear();
+        this->m_compressionTotalBytes = 0;
+        for (const auto &region : regions)
+            this->m_compressionTotalBytes += region.size;
 
-                std::string magicFiles;
+        this->m_compressionTask = TaskManager::createTask("hex.view.information.compression.searching", 0, [this, regions = std::move(regions), handle = ImHexApi::Provider::getHandle()](Task &task) {
+            auto compressedRegions = CompressionScanner::scan(handle.get(), regions, task.getInterruptFlag(), &this->m_compressionBytes);
 
-                std::error_code error;
-                for (const auto &dir : hex::getPath(ImHexPath::Magic)) {
-                    for (const auto &entry : std::filesystem::directory_iterator(dir, error)) {
-                        if (entry.is_regular_file() && entry.path().extension() == ".mgc")
-                            magicFiles += entry.path().string() + MAGIC_PATH_SEPARATOR;
-                    }
+            if (task.isInterrupted())
+                return;
+
+            this->m_compressedRegions = std::move(compressedRegions);
+            this->m_compressionDone = true;
+        });
+    }
+
+    void ViewInformation::bookmarkCompressedRegions() {
+        for (const auto &region : this->m_compressedRegions) {
+            auto comment = hex::format(region.complete ? "hex.view.information.compression.comment"_lang : "hex.view.information.compression.comment_partial"_lang, region.decompressedSize);
+            ImHexApi::Bookmarks::add(region.address, region.size, CompressionScanner::getFormatName(region.format), comment);
+        }
+    }
+
+    void ViewInformation::drawCompressedRegions() {
+        ImGui::NewLine();
+        ImGui::TextUnformatted("hex.view.information.compression"_lang);
+        ImGui::Separator();
+
+        // The entropy map tells where to look, nothing can be searched before the analysis is done
+        ImGui::Disabled([this] {
+            if (ImGui::Button("hex.view.information.compression.search"_lang))
+                this->findCompressedRegions();
+        }, this->m_compressionTask.isRunning() || !this->m_dataValid || this->m_entropyMap.empty());
+
+        if (this->m_compressionTask.isRunning()) {
+            ImGui::SameLine();
+            ImGui::ProgressBar(this->m_compressionTotalBytes == 0 ? 1.0F : float(this->m_compressionBytes) / this->m_compressionTotalBytes, ImVec2(200, 0));
+            return;
+        }
+
+        if (!this->m_compressionDone)
+            return;
+
+        if (this->m_compressedRegions.empty()) {
+            ImGui::TextUnformatted("hex.view.information.compression.none"_lang);
+            return;
+        }
+
+        ImGui::SameLine();
+        if (ImGui::Button("hex.view.information.compression.bookmark"_lang))
+            this->bookmarkCompressedRegions();
+
+        if (ImGui::BeginTable("##compressed", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_Resizable)) {
+            ImGui::TableSetupColumn("hex.common.address"_lang);
+            ImGui::TableSetupColumn("hex.view.information.compression.format"_lang);
+            ImGui::TableSetupColumn("hex.common.size"_lang);
+            ImGui::TableSetupColumn("hex.view.information.compression.decompressed_size"_lang, ImGuiTableColumnFlags_WidthStretch);
+            ImGui::TableHeadersRow();
+
+            ImGuiListClipper clipper;
+            clipper.Begin(this->m_compressedRegions.size());
+
+            while (clipper.Step()) {
+                for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
+                    const auto &region = this->m_compressedRegions[i];
+
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+                    ImGui::PushID(i);
+                    if (ImGui::Selectable(hex::format("0x{:08X}", region.address).c_str(), false, ImGuiSelectableFlags_SpanAllColumns))
+                        View::postEvent(Events::SelectionChangeRequest, Region { region.address, region.size });
+                    ImGui::PopID();
+
+                    ImGui::TableNextColumn();
+                    ImGui::TextUnformatted(CompressionScanner::getFormatName(region.format).data());
+                    ImGui::TableNextColumn();
+                    ImGui::TextUnformatted(hex::toByteString(region.size).c_str());
+                    ImGui::TableNextColumn();
+                    // Streams that didn't end within the budget decompress to at least this much
+                    ImGui::TextUnformatted(hex::format(region.complete ? "{}" : "> {}", hex::toByteString(region.decompressedSize)).c_str());
                 }
+            }
+
+            clipper.End();
+
+            ImGui::EndTable();
+        }
+    }
 
-                if (!error) {
-                    magicFiles.pop_back();
+    void ViewInformation::findDuplicates() {
+        this->m_duplicatesBytes = 0;
+        this->m_duplicatesDone = false;
+        this->m_duplicateGroups.clear();
+        this->m_duplicateRows.clear();
 
-                    {
-                        magic_t cookie = magic_open(MAGIC_NONE);
-                        if (magic_load(cookie, magicFiles.c_str()) != -1)
-                            this->m_fileDescription = magic_buffer(cookie, buffer.data(), buffer.size());
-                        else
-                            this->m_fileDescription = "";
+        this->m_duplicatesTask = TaskManager::createTask("hex.view.information.duplicates.searching", 0, [this, handle = ImHexApi::Provider::getHandle()](Task &task) {
+            auto provider = handle.get();
+            auto groups = DuplicateFinder::find(provider, 0x00, provider->getActualSize(), task.getInterruptFlag(), &this->m_duplicatesBytes);
 
-                        magic_close(cookie);
-                    }
+            if (task.isInterrupted())
+                return;
 
-                    {
-                        magic_t cookie = magic_open(MAGIC_MIME);
-                        if (magic_load(cookie, magicFiles.c_str()) != -1)
-                            this->m_mimeType = magic_buffer(cookie, buffer.data(), buffer.size());
-                        else
-                            this->m_mimeType = "";
+            std::vector<std::pair<u32, u32>> rows;
+            for (u32 group = 0; group < groups.size(); group++) {
+                for (u32 address = 0; address < groups[group].addresses.size(); address++)
+                    rows.emplace_back(group, address);
+            }
 
-                        magic_close(cookie);
-                    }
+            this->m_duplicateGroups = std::move(groups);
+            this->m_duplicateRows = std::move(rows);
+            this->m_duplicatesDone = true;
+        });
+    }
+
+    void ViewInformation::drawDuplicates() {
+        ImGui::NewLine();
+        ImGui::TextUnformatted("hex.view.information.duplicates"_lang);
+        ImGui::Separator();
+
+        ImGui::Disabled([this] {
+            if (ImGui::Button("hex.view.information.duplicates.search"_lang))
+                this->findDuplicates();
+        }, this->m_duplicatesTask.isRunning());
+
+        if (this->m_duplicatesTask.isRunning()) {
+            auto dataSize = SharedData::currentProvider->getActualSize();
+
+            ImGui::SameLine();
+            ImGui::ProgressBar(dataSize == 0 ? 1.0F : float(this->m_duplicatesBytes) / dataSize, ImVec2(200, 0));
+            return;
+        }
+
+        if (!this->m_duplicatesDone)
+            return;
+
+        if (this->m_duplicateGroups.empty()) {
+            ImGui::TextUnformatted("hex.view.information.duplicates.none"_lang);
+            return;
+        }
 
-                    this->m_dataValid = true;
+        // Every copy but the first one could go
+        u64 duplicatedBytes = 0;
+        for (const auto &group : this->m_duplicateGroups)
+            duplicatedBytes += group.size * (group.addresses.size() - 1);
+        ImGui::TextUnformatted(hex::format("hex.view.information.duplicates.summary"_lang, this->m_duplicateGroups.size(), duplicatedBytes).c_str());
+
+        if (ImGui::BeginTable("##duplicates", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_Resizable | ImGuiTableFlags_ScrollY, ImVec2(0, 300))) {
+            ImGui::TableSetupScrollFreeze(0, 1);
+            ImGui::TableSetupColumn("hex.view.information.duplicates.group"_lang);
+            ImGui::TableSetupColumn("hex.common.address"_lang);
+            ImGui::TableSetupColumn("hex.common.size"_lang);
+            ImGui::TableSetupColumn("hex.view.information.duplicates.copies"_lang, ImGuiTableColumnFlags_WidthStretch);
+            ImGui::TableHeadersRow();
+
+            ImGuiListClipper clipper;
+            clipper.Begin(this->m_duplicateRows.size());
+
+            while (clipper.Step()) {
+                for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
+                    const auto &[groupIndex, addressIndex] = this->m_duplicateRows[i];
+                    const auto &group = this->m_duplicateGroups[groupIndex];
+                    u64 address = group.addresses[addressIndex];
+
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+                    ImGui::PushID(i);
+                    if (ImGui::Selectable(hex::format("{}", groupIndex + 1).c_str(), false, ImGuiSelectableFlags_SpanAllColumns))
+                        View::postEvent(Events::SelectionChangeRequest, Region { address, group.size });
+                    ImGui::PopID();
+
+                    ImGui::TableNextColumn();
+                    ImGui::TextUnformatted(hex::format("0x{:08X}", address).c_str());
+                    ImGui::TableNextColumn();
+                    ImGui::TextUnformatted(hex::format("0x{:X}", group.size).c_str());
+                    ImGui::TableNextColumn();
+                    ImGui::TextUnformatted(hex::format("{}", group.addresses.size()).c_str());
                 }
             }
 
-            this->m_analyzing = false;
-        }).detach();
+            clipper.End();
+
+            ImGui::EndTable();
+        }
     }
 
     void ViewInformation::drawContent() {
+        if (!this->m_analyzerTask.isRunning() && this->m_dataValid)
+            this->applyDataChanges(SharedData::currentProvider);
+
+
         if (ImGui::Begin(View::toWindowName("hex.view.information.name").c_str(), &this->getWindowOpenState(), ImGuiWindowFlags_NoCollapse)) {
             ImGui::BeginChild("##scrolling", ImVec2(0, 0), false, ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoNav);
 
@@ -141,12 +670,17 @@ namespace hex {
                 ImGui::TextUnformatted("hex.view.information.control"_lang);
                 ImGui::Separator();
 
+                if (!this->m_cacheChecked && !this->m_dataValid && !this->m_analyzerTask.isRunning()) {
+                    this->m_cacheChecked = true;
+                    this->analyze(true);
+                }
+
                 ImGui::Disabled([this] {
                     if (ImGui::Button("hex.view.information.analyze"_lang))
                         this->analyze();
-                }, this->m_analyzing);
+                }, this->m_analyzerTask.isRunning());
 
-                if (this->m_analyzing) {
+                if (this->m_analyzerTask.isRunning()) {
                     ImGui::SameLine();
                     ImGui::TextSpinner("hex.view.information.analyzing"_lang);
                 }
@@ -188,6 +722,9 @@ namespace hex {
                     ImGui::PushStyleColor(ImGuiCol_FrameBg, ImGui::GetColorU32(ImGuiCol_WindowBg));
 
                     ImGui::TextUnformatted("hex.view.information.distribution"_lang);
+                    if (this->m_distributionOutdated)
+                        ImGui::TextWrapped("%s", static_cast<const char*>("hex.view.information.outdated"_lang));
+
                     ImPlot::SetNextPlotLimits(0, 256, 0, float(*std::max_element(this->m_valueCounts.begin(), this->m_valueCounts.end())) * 1.1F, ImGuiCond_Always);
                     if (ImPlot::BeginPlot("##distribution", "Address", "Count", ImVec2(-1,0), ImPlotFlags_NoLegend | ImPlotFlags_NoMenus | ImPlotFlags_NoBoxSelect, ImPlotAxisFlags_Lock, ImPlotAxisFlags_Lock))  {
                         static auto x = []{
@@ -202,25 +739,43 @@ namespace hex {
 
                     ImGui::NewLine();
 
-                    ImGui::TextUnformatted("hex.view.information.entropy"_lang);
+                    ImGui::TextUnformatted("hex.view.information.digraph"_lang);
 
-                    ImPlot::SetNextPlotLimits(0, this->m_blockEntropy.size(), -0.1, 1.1, ImGuiCond_Always);
-                    if (ImPlot::BeginPlot("##entropy", "Address", "Entropy", ImVec2(-1,0), ImPlotFlags_CanvasOnly, ImPlotAxisFlags_Lock | ImPlotAxisFlags_NoTickLabels, ImPlotAxisFlags_Lock)) {
-                        ImPlot::PlotLine("##entropy_line", this->m_blockEntropy.data(), this->m_blockEntropy.size());
-
-                        if (ImGui::IsItemClicked())
-                            View::postEvent(Events::SelectionChangeRequest, Region{ u64(ImPlot::GetPlotMousePos().x) * this->m_blockSize, 1 });
+                    ImPlot::PushColormap(ImPlotColormap_Viridis);
+                    ImPlot::SetNextPlotLimits(0, 256, 0, 256, ImGuiCond_Always);
+                    if (ImPlot::BeginPlot("##digraph", "Second byte", "First byte", ImVec2(-1, ImGui::GetContentRegionAvail().x), ImPlotFlags_NoLegend | ImPlotFlags_NoMenus | ImPlotFlags_NoBoxSelect, ImPlotAxisFlags_Lock, ImPlotAxisFlags_Lock | ImPlotAxisFlags_Invert)) {
+                        if (!this->m_digraphHeatmap.empty())
+                            ImPlot::PlotHeatmap<float>("##pairs", this->m_digraphHeatmap.data(), 256, 256, 0.0, 1.0, nullptr, ImPlotPoint(0, 256), ImPlotPoint(256, 0));
 
                         ImPlot::EndPlot();
                     }
+                    ImPlot::PopColormap();
+
+                    ImGui::NewLine();
+
+                    ImGui::TextUnformatted("hex.view.information.entropy"_lang);
+
+                    this->drawEntropyPlot();
 
                     ImGui::PopStyleColor();
 
                     ImGui::NewLine();
 
-                    ImGui::LabelText("hex.view.information.block_size"_lang, "hex.view.information.block_size.desc"_lang, this->m_blockEntropy.size(), this->m_blockSize);
+                    ImGui::LabelText("hex.view.information.block_size"_lang, "hex.view.information.block_size.desc"_lang, this->m_entropyMap.getLevel(0).size(), EntropyMap::BlockSize);
                     ImGui::LabelText("hex.view.information.file_entropy"_lang, "%.8f", this->m_averageEntropy);
                     ImGui::LabelText("hex.view.information.highest_entropy"_lang, "%.8f", this->m_highestBlockEntropy);
+                    ImGui::LabelText("hex.view.information.highest_entropy_address"_lang, "0x%llx", this->m_highestEntropyBlockAddress);
+
+                    ImGui::NewLine();
+
+                    ImGui::TextUnformatted("hex.view.information.byte_classes"_lang);
+                    ImGui::Separator();
+
+                    const auto &root = this->m_entropyMap.getRoot();
+                    ImGui::LabelText("hex.view.information.byte_classes.zero"_lang, "%.2f%%", root.getClassRatio(ByteClass::Zero) * 100);
+                    ImGui::LabelText("hex.view.information.byte_classes.printable"_lang, "%.2f%%", root.getClassRatio(ByteClass::Printable) * 100);
+                    ImGui::LabelText("hex.view.information.byte_classes.control"_lang, "%.2f%%", root.getClassRatio(ByteClass::Control) * 100);
+                    ImGui::LabelText("hex.view.information.byte_classes.high"_lang, "%.2f%%", root.getClassRatio(ByteClass::High) * 100);
 
                     if (this->m_averageEntropy > 0.83 && this->m_highestBlockEntropy > 0.9) {
                         ImGui::NewLine();
@@ -228,6 +783,10 @@ namespace hex {
                     }
 
                 }
+
+                this->drawCarvedFiles();
+                this->drawCompressedRegions();
+                this->drawDuplicates();
             }
 
             ImGui::EndChild();
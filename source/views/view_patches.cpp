@@ -5,6 +5,7 @@
 #include <hex/helpers/utils.hpp>
 #include "helpers/project_file_handler.hpp"
 
+#include <algorithm>
 #include <string>
 
 using namespace std::literals::string_literals;
@@ -20,8 +21,10 @@ namespace hex {
 
         View::subscribeEvent(Events::ProjectFileLoad, [](auto) {
             auto provider = SharedData::currentProvider;
-            if (provider != nullptr)
-                provider->getPatches() = ProjectFile::getPatches();
+            if (provider != nullptr) {
+                provider->setPatches(ProjectFile::getPatches());
+                provider->clearUndoHistory();
+            }
         });
     }
 
@@ -30,51 +33,98 @@ namespace hex {
         View::unsubscribeEvent(Events::ProjectFileLoad);
     }
 
+    void ViewPatches::updatePatchRuns(prv::Provider *provider) {
+        const auto &patches = provider->getPatches();
+        if (provider == this->m_lastProvider && patches.getGeneration() == this->m_lastGeneration && !this->m_patchRuns.empty())
+            return;
+
+        this->m_patchRuns.clear();
+        this->m_patchRuns.reserve(patches.getRuns().size());
+        for (const auto &[address, run] : patches.getRuns())
+            this->m_patchRuns.push_back({ address, &run });
+
+        this->m_lastProvider = provider;
+        this->m_lastGeneration = patches.getGeneration();
+    }
+
+    static std::string formatBytes(const u8 *bytes, size_t size, size_t totalSize) {
+        std::string result;
+        for (size_t i = 0; i < size; i++)
+            result += hex::format("{0:02X} ", bytes[i]);
+
+        if (totalSize > size)
+            result += "...";
+        else if (!result.empty())
+            result.pop_back();
+
+        return result;
+    }
+
     void ViewPatches::drawContent() {
+        // Long runs only show their first few bytes, the rest can be looked at in the hex editor
+        constexpr static size_t PreviewSize = 8;
+
         if (ImGui::Begin(View::toWindowName("hex.view.patches.name").c_str(), &this->getWindowOpenState(), ImGuiWindowFlags_NoCollapse)) {
             auto provider = SharedData::currentProvider;
 
             if (provider != nullptr && provider->isReadable()) {
 
-                if (ImGui::BeginTable("##patchesTable", 3, ImGuiTableFlags_Borders | ImGuiTableFlags_Resizable | ImGuiTableFlags_Sortable |
+                if (ImGui::BeginTable("##patchesTable", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_Resizable |
                                                         ImGuiTableFlags_Reorderable | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY)) {
                     ImGui::TableSetupScrollFreeze(0, 1);
                     ImGui::TableSetupColumn("hex.view.patches.offset"_lang);
+                    ImGui::TableSetupColumn("hex.common.size"_lang);
                     ImGui::TableSetupColumn("hex.view.patches.orig"_lang);
                     ImGui::TableSetupColumn("hex.view.patches.patch"_lang);
 
                     ImGui::TableHeadersRow();
 
-                    auto& patches = provider->getPatches();
-                    u32 index = 0;
-                    for (const auto &[address, patch] : patches) {
-
-                        ImGui::TableNextRow();
-                        ImGui::TableNextColumn();
-                        if (ImGui::Selectable(("##patchLine" + std::to_string(index)).c_str(), false, ImGuiSelectableFlags_SpanAllColumns)) {
-                            Region selectRegion = { address, 1 };
-                            View::postEvent(Events::SelectionChangeRequest, selectRegion);
+                    this->updatePatchRuns(provider);
+
+                    ImGuiListClipper clipper;
+                    clipper.Begin(this->m_patchRuns.size());
+
+                    // Only the visible runs get their bytes read and formatted
+                    while (clipper.Step()) {
+                        for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
+                            const auto &[address, run] = this->m_patchRuns[i];
+                            auto previewSize = std::min(run->size(), PreviewSize);
+
+                            ImGui::TableNextRow();
+                            ImGui::TableNextColumn();
+                            ImGui::PushID(i);
+                            if (ImGui::Selectable("##patchLine", false, ImGuiSelectableFlags_SpanAllColumns)) {
+                                Region selectRegion = { address, run->size() };
+                                View::postEvent(Events::SelectionChangeRequest, selectRegion);
+                            }
+                            if (ImGui::IsMouseReleased(1) && ImGui::IsItemHovered()) {
+                                ImGui::OpenPopup("PatchContextMenu");
+                                this->m_selectedPatch = address;
+                                this->m_selectedPatchSize = run->size();
+                            }
+                            ImGui::PopID();
+                            ImGui::SameLine();
+                            ImGui::Text("0x%08lX : 0x%08lX", address, address + run->size() - 1);
+
+                            ImGui::TableNextColumn();
+                            ImGui::Text("0x%lX", run->size());
+
+                            ImGui::TableNextColumn();
+                            u8 previousValues[PreviewSize] = { 0 };
+                            provider->readRaw(address, previousValues, previewSize);
+                            ImGui::TextUnformatted(formatBytes(previousValues, previewSize, run->size()).c_str());
+
+                            ImGui::TableNextColumn();
+                            ImGui::TextUnformatted(formatBytes(run->data(), previewSize, run->size()).c_str());
                         }
-                        if (ImGui::IsMouseReleased(1) && ImGui::IsItemHovered()) {
-                            ImGui::OpenPopup("PatchContextMenu");
-                            this->m_selectedPatch = address;
-                        }
-                        ImGui::SameLine();
-                        ImGui::Text("0x%08lX", address);
-
-                        ImGui::TableNextColumn();
-                        u8 previousValue = 0x00;
-                        provider->readRaw(address, &previousValue, sizeof(u8));
-                        ImGui::Text("0x%02X", previousValue);
-
-                        ImGui::TableNextColumn();
-                        ImGui::Text("0x%02X", patch);
-                        index += 1;
                     }
 
+                    clipper.End();
+
                     if (ImGui::BeginPopup("PatchContextMenu")) {
                         if (ImGui::MenuItem("hex.view.patches.remove"_lang)) {
-                            patches.erase(this->m_selectedPatch);
+                            provider->erasePatches(this->m_selectedPatch, this->m_selectedPatchSize);
+                            View::postEvent(Events::DataChanged);
                             ProjectFile::markDirty();
                         }
                         ImGui::EndPopup();
@@ -1,6 +1,9 @@
 #include "views/view_pattern.hpp"
 
 #include "helpers/project_file_handler.hpp"
+#include "helpers/magic.hpp"
+#include "helpers/session.hpp"
+#include <hex/api/imhex_api.hpp>
 #include <hex/helpers/utils.hpp>
 #include <hex/lang/preprocessor.hpp>
 
@@ -45,7 +48,7 @@ namespace hex {
                     paletteIndex = TextEditor::PaletteIndex::Default;
                 }
                 else if (TokenizeCStyleIdentifier(inBegin, inEnd, outBegin, outEnd)) {
-                    if (SharedData::patternLanguageFunctions.contains(std::string(outBegin, outEnd - outBegin)))
+                    if (ContentRegistry::PatternLanguageFunctions::exists(std::string_view(outBegin, outEnd - outBegin)))
                         paletteIndex = TextEditor::PaletteIndex::LineNumber;
                     else
                         paletteIndex = TextEditor::PaletteIndex::Identifier;
@@ -76,7 +79,7 @@ namespace hex {
     }
 
 
-    ViewPattern::ViewPattern(std::vector<lang::PatternData*> &patternData) : View("hex.view.pattern.name"), m_patternData(patternData) {
+    ViewPattern::ViewPattern(std::vector<lang::PatternData*> &patternData) : View("hex.view.pattern.name"), m_patternData(patternData), m_memoryBudget("hex.memory.patterns", [this](size_t bytes) { return this->evictCachedPatterns(bytes); }) {
         this->m_patternLanguageRuntime = new lang::PatternLanguage();
 
         this->m_textEditor.SetLanguageDefinition(PatternLanguage());
@@ -91,6 +94,37 @@ namespace hex {
             this->parsePattern(this->m_textEditor.GetText().data());
         });
 
+        View::subscribeEvent(Events::DataChanged, [this](auto userData) {
+            std::scoped_lock lock(this->m_changedRegionsMutex);
+
+            // Edits inside the current page only re-evaluate the patterns that depended on the changed bytes
+            if (auto region = std::any_cast<Region>(&userData); region != nullptr) {
+                if (!this->m_patternData.empty() || this->m_evaluatorRunning)
+                    this->m_changedRegions.push_back(*region);
+            } else if (this->m_runAutomatically)
+                this->m_rerunPattern = true;
+        });
+
+        View::subscribeEvent<prv::Provider*>(Events::ProviderChanged, [this](prv::Provider *previous) {
+            this->switchProvider(previous);
+        });
+
+        View::subscribeEvent<prv::Provider*>(Events::ProviderClosed, [this](prv::Provider *provider) {
+            auto it = this->m_cachedPatterns.find(provider);
+            if (it == this->m_cachedPatterns.end())
+                return;
+
+            delete it->second.runtime;
+            this->m_cachedPatterns.erase(it);
+            this->updateMemoryUsage();
+        });
+
+        // Pattern results can't be cached, the pattern of the last session always gets evaluated again
+        Session::registerAnalysis("pattern", [this](const std::string &source) {
+            this->m_textEditor.SetText(source);
+            this->parsePattern(this->m_textEditor.GetText().data());
+        });
+
         View::subscribeEvent(Events::AppendPatternLanguageCode, [this](auto userData) {
              auto code = std::any_cast<const char*>(userData);
 
@@ -103,34 +137,13 @@ namespace hex {
                 return;
 
             lang::Preprocessor preprocessor;
-            std::string magicFiles;
-
-            std::error_code error;
-            for (const auto &dir : hex::getPath(ImHexPath::Magic)) {
-                for (const auto &entry : std::filesystem::directory_iterator(dir, error)) {
-                    if (entry.is_regular_file() && entry.path().extension() == ".mgc")
-                        magicFiles += entry.path().string() + MAGIC_PATH_SEPARATOR;
-                }
-            }
-
-            if (error)
-                return;
 
             auto provider = SharedData::currentProvider;
 
             if (provider == nullptr)
                 return;
 
-            std::vector<u8> buffer(std::min(provider->getSize(), size_t(0xFFFF)), 0x00);
-            provider->read(0, buffer.data(), buffer.size());
-
-            std::string mimeType;
-
-            magic_t cookie = magic_open(MAGIC_MIME_TYPE);
-            if (magic_load(cookie, magicFiles.c_str()) != -1)
-                mimeType = magic_buffer(cookie, buffer.data(), buffer.size());
-
-            magic_close(cookie);
+            std::string mimeType = Magic::identify(provider, MAGIC_MIME_TYPE);
 
             bool foundCorrectType = false;
             preprocessor.addPragmaHandler("MIME", [&mimeType, &foundCorrectType](std::string value) {
@@ -202,10 +215,96 @@ namespace hex {
     }
 
     ViewPattern::~ViewPattern() {
+        this->m_evaluatorTask.interrupt();
+        this->m_evaluatorTask.wait();
+
         delete this->m_patternLanguageRuntime;
+        for (auto &[provider, cached] : this->m_cachedPatterns)
+            delete cached.runtime;
 
         View::unsubscribeEvent(Events::ProjectFileStore);
         View::unsubscribeEvent(Events::ProjectFileLoad);
+        View::unsubscribeEvent(Events::DataChanged);
+        View::unsubscribeEvent(Events::ProviderChanged);
+        View::unsubscribeEvent(Events::ProviderClosed);
+
+        Session::unregisterAnalysis("pattern");
+    }
+
+    void ViewPattern::switchProvider(prv::Provider *previous) {
+        this->m_evaluatorTask.interrupt();
+        this->m_evaluatorTask.wait();
+        this->m_evaluationGeneration++;
+
+        bool outdated;
+        {
+            std::scoped_lock lock(this->m_changedRegionsMutex);
+            outdated = this->m_evaluatorRunning || this->m_pendingPattern.has_value() || this->m_rerunPattern || !this->m_changedRegions.empty();
+
+            this->m_changedRegions.clear();
+            this->m_rerunPattern = false;
+        }
+
+        this->m_evaluatorRunning = false;
+        this->m_pendingPattern.reset();
+
+        if (previous != nullptr)
+            this->m_cachedPatterns[previous] = { this->m_patternLanguageRuntime, std::move(this->m_patternData), std::move(this->m_console), outdated, this->m_cacheCounter++ };
+        else
+            delete this->m_patternLanguageRuntime;
+
+        this->m_patternData.clear();
+        this->m_console.clear();
+        this->m_textEditor.SetErrorMarkers({ });
+
+        if (auto it = this->m_cachedPatterns.find(SharedData::currentProvider); it != this->m_cachedPatterns.end()) {
+            auto &cached = it->second;
+            this->m_patternLanguageRuntime = cached.runtime != nullptr ? cached.runtime : new lang::PatternLanguage();
+            this->m_patternData = std::move(cached.patternData);
+            this->m_console = std::move(cached.console);
+            this->m_rerunPattern = cached.outdated;
+
+            this->m_cachedPatterns.erase(it);
+        } else {
+            this->m_patternLanguageRuntime = new lang::PatternLanguage();
+        }
+
+        this->updateMemoryUsage();
+        View::postEvent(Events::PatternChanged);
+    }
+
+    size_t ViewPattern::evictCachedPatterns(size_t bytes) {
+        size_t freed = 0;
+        while (freed < bytes) {
+            auto oldest = this->m_cachedPatterns.end();
+            for (auto it = this->m_cachedPatterns.begin(); it != this->m_cachedPatterns.end(); it++) {
+                if (it->second.runtime != nullptr && (oldest == this->m_cachedPatterns.end() || it->second.cachedAt < oldest->second.cachedAt))
+                    oldest = it;
+            }
+
+            if (oldest == this->m_cachedPatterns.end())
+                break;
+
+            // The console stays so it's clear what ran last, the patterns come back by evaluating again
+            auto &cached = oldest->second;
+            freed += cached.runtime->getPatternMemoryUsage();
+            delete cached.runtime;
+            cached.runtime = nullptr;
+            cached.patternData.clear();
+            cached.outdated = true;
+        }
+
+        return freed;
+    }
+
+    void ViewPattern::updateMemoryUsage() {
+        size_t usage = 0;
+        for (const auto &[provider, cached] : this->m_cachedPatterns) {
+            if (cached.runtime != nullptr)
+                usage += cached.runtime->getPatternMemoryUsage();
+        }
+
+        this->m_memoryBudget.update(usage);
     }
 
     void ViewPattern::drawMenu() {
@@ -271,14 +370,25 @@ namespace hex {
                 }, this->m_evaluatorRunning);
 
                 ImGui::SameLine();
-                if (this->m_evaluatorRunning)
-                     ImGui::TextSpinner("hex.view.pattern.evaluating"_lang);
-                else
+                if (this->m_evaluatorRunning) {
+                    if (ImGui::SmallButton("hex.common.cancel"_lang))
+                        this->m_patternLanguageRuntime->abort();
+
+                    ImGui::SameLine();
+                    ImGui::TextSpinner(hex::format("hex.view.pattern.evaluating"_lang, this->m_patternLanguageRuntime->getCreatedPatternCount()).c_str());
+                } else
                     ImGui::Checkbox("hex.view.pattern.auto"_lang, &this->m_runAutomatically);
 
                 if (this->m_textEditor.IsTextChanged() && this->m_runAutomatically) {
                     this->parsePattern(this->m_textEditor.GetText().data());
                 }
+
+                if (!this->m_evaluatorRunning) {
+                    if (auto pendingPattern = std::exchange(this->m_pendingPattern, std::nullopt); pendingPattern.has_value())
+                        this->parsePattern(pendingPattern->data());
+                    else
+                        this->applyDataChanges();
+                }
             }
 
             View::discardNavigationRequests();
@@ -341,14 +451,19 @@ namespace hex {
     }
 
     void ViewPattern::clearPatternData() {
-        for (auto &data : this->m_patternData)
-            delete data;
-
+        // The patterns themselves are owned by the pattern language runtime and freed when it runs again
         this->m_patternData.clear();
         lang::PatternData::resetPalette();
     }
 
     void ViewPattern::parsePattern(char *buffer) {
+        // Only one evaluation runs at a time, stop the current one and start over once it finished
+        if (this->m_evaluatorRunning) {
+            this->m_pendingPattern = buffer;
+            this->m_patternLanguageRuntime->abort();
+            return;
+        }
+
         this->m_evaluatorRunning = true;
 
         this->clearPatternData();
@@ -356,24 +471,83 @@ namespace hex {
         this->m_console.clear();
         View::postEvent(Events::PatternChanged);
 
-        std::thread([this, buffer = std::string(buffer)] {
-            auto result = this->m_patternLanguageRuntime->executeString(SharedData::currentProvider, buffer);
+        this->m_evaluatorTask = TaskManager::createTask("hex.view.pattern.running", 0, [this, provider = ImHexApi::Provider::getHandle(), buffer = std::string(buffer), generation = this->m_evaluationGeneration](Task &task) {
+            task.setInterruptCallback([this] { this->m_patternLanguageRuntime->abort(); });
 
+            auto result = this->m_patternLanguageRuntime->executeString(provider.get(), buffer);
             auto error = this->m_patternLanguageRuntime->getError();
-            if (error.has_value()) {
-                this->m_textEditor.SetErrorMarkers({ error.value() });
-            }
+            auto console = this->m_patternLanguageRuntime->getConsoleLog();
 
-            this->m_console = this->m_patternLanguageRuntime->getConsoleLog();
+            View::doLater([this, provider, buffer, result = std::move(result), error = std::move(error), console = std::move(console), generation]() mutable {
+                if (this->m_evaluationGeneration != generation)
+                    return;
 
-            if (result.has_value()) {
-                this->m_patternData = std::move(result.value());
-                View::doLater([]{ View::postEvent(Events::PatternChanged); });
-            }
+                this->m_evaluatorRunning = false;
+
+                // Results of an evaluation that got superseded in the meantime are stale
+                if (this->m_pendingPattern.has_value())
+                    return;
 
-            this->m_evaluatorRunning = false;
-        }).detach();
+                if (error.has_value())
+                    this->m_textEditor.SetErrorMarkers({ error.value() });
 
+                this->m_console = std::move(console);
+
+                if (result.has_value()) {
+                    this->m_patternData = std::move(result.value());
+                    View::postEvent(Events::PatternChanged);
+
+                    // Projects bring their pattern along already
+                    if (ProjectFile::getProjectFilePath().empty())
+                        Session::addAnalysis(provider.get(), "pattern", buffer);
+                }
+            });
+        });
+
+    }
+
+    void ViewPattern::applyDataChanges() {
+        std::vector<Region> changedRegions;
+        bool rerunPattern;
+
+        {
+            std::scoped_lock lock(this->m_changedRegionsMutex);
+            std::swap(changedRegions, this->m_changedRegions);
+            rerunPattern = std::exchange(this->m_rerunPattern, false);
+        }
+
+        if (rerunPattern) {
+            this->parsePattern(this->m_textEditor.GetText().data());
+            return;
+        }
+
+        if (changedRegions.empty())
+            return;
+
+        this->m_evaluatorRunning = true;
+
+        this->m_evaluatorTask = TaskManager::createTask("hex.view.pattern.running", 0, [this, provider = ImHexApi::Provider::getHandle(), changedRegions = std::move(changedRegions), generation = this->m_evaluationGeneration](Task &task) {
+            task.setInterruptCallback([this] { this->m_patternLanguageRuntime->abort(); });
+
+            auto result = this->m_patternLanguageRuntime->reevaluate(provider.get(), changedRegions);
+
+            View::doLater([this, result = std::move(result), generation]() mutable {
+                if (this->m_evaluationGeneration != generation)
+                    return;
+
+                this->m_evaluatorRunning = false;
+
+                if (this->m_pendingPattern.has_value())
+                    return;
+
+                // Fall back to running the whole pattern again if the changes couldn't be applied incrementally
+                if (result.has_value()) {
+                    this->m_patternData = std::move(result.value());
+                    View::postEvent(Events::PatternChanged);
+                } else
+                    this->parsePattern(this->m_textEditor.GetText().data());
+            });
+        });
     }
 
 }
\ No newline at end of file
@@ -3,6 +3,8 @@
 #include <hex/providers/provider.hpp>
 #include <hex/lang/pattern_data.hpp>
 
+#include <algorithm>
+
 namespace hex {
 
     ViewPatternData::ViewPatternData(std::vector<lang::PatternData*> &patternData)
@@ -10,11 +12,30 @@ namespace hex {
 
         this->subscribeEvent(Events::PatternChanged, [this](auto data) {
             this->m_sortedPatternData.clear();
+
+            this->m_tableArrays.clear();
+            this->m_tableArraysDirty = true;
+            this->m_structTable.setArray(nullptr);
+        });
+
+        // Sorting by value depends on the data, so the order has to be recomputed after an edit
+        this->subscribeEvent(Events::DataChanged, [this](auto userData) {
+            this->m_sortedPatternData.clear();
+
+            // Only values whose bytes were overwritten need to be formatted again
+            if (auto region = std::any_cast<Region>(&userData); region != nullptr) {
+                for (auto &pattern : this->m_patternData)
+                    pattern->invalidateValues(*region);
+            } else
+                lang::PatternData::invalidateValueCache();
+
+            this->m_structTable.invalidate();
         });
     }
 
     ViewPatternData::~ViewPatternData() {
         this->unsubscribeEvent(Events::PatternChanged);
+        this->unsubscribeEvent(Events::DataChanged);
     }
 
     static bool beginPatternDataTable(prv::Provider* &provider, const std::vector<lang::PatternData*> &patterns, std::vector<lang::PatternData*> &sortedPatterns) {
@@ -32,9 +53,7 @@ namespace hex {
             if (sortSpecs->SpecsDirty || sortedPatterns.empty()) {
                 sortedPatterns = patterns;
 
-                std::sort(sortedPatterns.begin(), sortedPatterns.end(), [&sortSpecs, &provider](lang::PatternData* left, lang::PatternData* right) -> bool {
-                    return lang::PatternData::sortPatternDataTable(sortSpecs, provider, left, right);
-                });
+                lang::PatternData::sortPatterns(sortSpecs, provider, sortedPatterns);
 
                 for (auto &pattern : sortedPatterns)
                     pattern->sort(sortSpecs, provider);
@@ -53,16 +72,37 @@ namespace hex {
             auto provider = SharedData::currentProvider;
             if (provider != nullptr && provider->isReadable()) {
 
-                if (beginPatternDataTable(provider, this->m_patternData, this->m_sortedPatternData)) {
-                    ImGui::TableHeadersRow();
-                    if (this->m_sortedPatternData.size() > 0) {
+                // Values are read relative to the current page, the cached ones are outdated once a different one is shown
+                if (provider != this->m_lastProvider || provider->getCurrentPage() != this->m_lastPage) {
+                    lang::PatternData::invalidateValueCache();
 
-                        for (auto &patternData : this->m_sortedPatternData)
-                            patternData->createEntry(provider);
+                    this->m_lastProvider = provider;
+                    this->m_lastPage = provider->getCurrentPage();
+                }
+
+                if (ImGui::BeginTabBar("##patterndatatabs")) {
+                    if (ImGui::BeginTabItem("hex.view.pattern_data.tree"_lang)) {
+                        if (beginPatternDataTable(provider, this->m_patternData, this->m_sortedPatternData)) {
+                            ImGui::TableHeadersRow();
+                            if (this->m_sortedPatternData.size() > 0) {
+
+                                for (auto &patternData : this->m_sortedPatternData)
+                                    patternData->createEntry(provider);
+
+                            }
+
+                            ImGui::EndTable();
+                        }
+
+                        ImGui::EndTabItem();
+                    }
 
+                    if (ImGui::BeginTabItem("hex.view.pattern_data.table"_lang)) {
+                        this->drawTable();
+                        ImGui::EndTabItem();
                     }
 
-                    ImGui::EndTable();
+                    ImGui::EndTabBar();
                 }
 
             }
@@ -70,6 +110,49 @@ namespace hex {
         ImGui::End();
     }
 
+    /* Arrays inside of structs and unions are found too, arrays inside of other arrays would need an entry to be picked first */
+    void ViewPatternData::collectTableArrays(const std::vector<lang::PatternData*> &patterns, const std::string &prefix) {
+        for (auto pattern : patterns) {
+            auto path = prefix + pattern->getVariableName();
+
+            if (StructArrayTable::isSupported(pattern))
+                this->m_tableArrays.emplace_back(path, static_cast<lang::PatternDataStaticArray*>(pattern));
+            else if (auto structPattern = dynamic_cast<lang::PatternDataStruct*>(pattern); structPattern != nullptr)
+                this->collectTableArrays(structPattern->getMembers(), path + ".");
+            else if (auto unionPattern = dynamic_cast<lang::PatternDataUnion*>(pattern); unionPattern != nullptr)
+                this->collectTableArrays(unionPattern->getMembers(), path + ".");
+        }
+    }
+
+    void ViewPatternData::drawTable() {
+        if (this->m_tableArraysDirty) {
+            this->m_tableArraysDirty = false;
+            this->collectTableArrays(this->m_patternData, "");
+
+            if (!this->m_tableArrays.empty())
+                this->m_structTable.setArray(this->m_tableArrays.front().second);
+        }
+
+        if (this->m_tableArrays.empty()) {
+            ImGui::TextUnformatted("hex.view.pattern_data.table.none"_lang);
+            return;
+        }
+
+        auto selected = std::find_if(this->m_tableArrays.begin(), this->m_tableArrays.end(), [this](const auto &entry) { return entry.second == this->m_structTable.getArray(); });
+
+        if (ImGui::BeginCombo("hex.view.pattern_data.table.array"_lang, selected != this->m_tableArrays.end() ? selected->first.c_str() : "")) {
+            for (const auto &[path, array] : this->m_tableArrays) {
+                ImGui::PushID(array);
+                if (ImGui::Selectable(path.c_str(), array == this->m_structTable.getArray()))
+                    this->m_structTable.setArray(array);
+                ImGui::PopID();
+            }
+            ImGui::EndCombo();
+        }
+
+        this->m_structTable.draw();
+    }
+
     void ViewPatternData::drawMenu() {
 
     }
@@ -26,8 +26,10 @@ namespace hex {
                 ImGui::TextUnformatted(LangEntry(category));
                 ImGui::Separator();
                 for (auto &[name, callback] : entries) {
-                    if (callback(LangEntry(name), ContentRegistry::Settings::getSettingsData()[category][name]))
+                    if (callback(LangEntry(name), ContentRegistry::Settings::getSettingsData()[category][name])) {
                         View::postEvent(Events::SettingsChanged);
+                        ContentRegistry::Settings::storeLater();
+                    }
                 }
                 ImGui::NewLine();
             }
@@ -1,10 +1,18 @@
 #include "views/view_strings.hpp"
 
+#include <hex/api/imhex_api.hpp>
 #include <hex/providers/provider.hpp>
 #include <hex/helpers/utils.hpp>
+#include <hex/helpers/analysis_cache.hpp>
 
+#include "helpers/session.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <charconv>
 #include <cstring>
-#include <thread>
+#include <optional>
 
 #include <llvm/Demangle/Demangle.h>
 #include <imgui_imhex_extensions.h>
@@ -13,9 +21,40 @@ using namespace std::literals::string_literals;
 
 namespace hex {
 
-    ViewStrings::ViewStrings() : View("hex.view.strings.name") {
-        View::subscribeEvent(Events::DataChanged, [this](auto){
-            this->m_foundStrings.clear();
+    ViewStrings::ViewStrings() : View("hex.view.strings.name"), m_memoryBudget("hex.memory.strings", [this](size_t bytes) { return this->evictCachedResults(bytes); }) {
+        View::subscribeEvent(Events::DataChanged, [this](auto userData) {
+            if (this->m_searching)
+                return;
+
+            // Data appended behind what was searched only needs the new part searched, any other change invalidates the results
+            if (auto region = std::any_cast<Region>(&userData); region != nullptr && this->m_searchedSize != 0) {
+                u64 pageAddress = prv::Provider::PageSize * SharedData::currentProvider->getCurrentPage();
+                if (region->address + pageAddress >= this->m_searchedSize) {
+                    this->m_appendPending = true;
+                    return;
+                }
+            }
+
+            this->clearResults();
+        });
+
+        View::subscribeEvent<prv::Provider*>(Events::ProviderChanged, [this](prv::Provider *previous) {
+            this->switchProvider(previous);
+        });
+
+        View::subscribeEvent<prv::Provider*>(Events::ProviderClosed, [this](prv::Provider *provider) {
+            this->m_cachedResults.erase(provider);
+            this->updateMemoryUsage();
+        });
+
+        // The search mode of the last session is searched again, the results come from the analysis cache unless the data changed
+        Session::registerAnalysis("strings", [this](const std::string &argument) {
+            u8 mode;
+            if (this->m_searching || std::from_chars(argument.data(), argument.data() + argument.size(), mode).ec != std::errc() || mode > u8(StringSearchMode::All))
+                return;
+
+            this->m_searchMode = StringSearchMode(mode);
+            this->searchStrings();
         });
 
         this->m_filter.resize(0xFFFF, 0x00);
@@ -23,13 +62,86 @@ namespace hex {
 
     ViewStrings::~ViewStrings() {
         View::unsubscribeEvent(Events::DataChanged);
+        View::unsubscribeEvent(Events::ProviderChanged);
+        View::unsubscribeEvent(Events::ProviderClosed);
+
+        Session::unregisterAnalysis("strings");
+
+        this->stopTasks();
+    }
+
+    void ViewStrings::stopTasks() {
+        for (auto task : { &this->m_searchTask, &this->m_filterTask, &this->m_demangleTask }) {
+            task->interrupt();
+            task->wait();
+        }
+
+        this->m_searching = false;
+        this->m_filtering = false;
+    }
+
+    void ViewStrings::switchProvider(prv::Provider *previous) {
+        // A search that got interrupted halfway has nothing worth keeping, it has to be started again for that provider
+        this->stopTasks();
+
+        if (previous != nullptr) {
+            std::scoped_lock lock(this->m_filterMutex);
+
+            size_t memoryUsage = this->m_foundStrings->size() * sizeof(FoundString) + (this->m_sortOrder != nullptr ? this->m_sortOrder->size() * sizeof(u32) : 0);
+            if (this->m_stringIndex != nullptr) {
+                for (const auto &[trigram, postings] : this->m_stringIndex->trigrams)
+                    memoryUsage += sizeof(trigram) + sizeof(postings) + postings.size() * sizeof(u32);
+            }
+
+            this->m_cachedResults[previous] = { this->m_foundStrings, std::move(this->m_stringIndex), std::move(this->m_sortOrder), this->m_minimumLength, this->m_searchMode, memoryUsage, this->m_cacheCounter++ };
+        }
+
+        this->clearResults();
+        SCOPE_EXIT( this->updateMemoryUsage(); );
+
+        auto it = this->m_cachedResults.find(SharedData::currentProvider);
+        if (it == this->m_cachedResults.end())
+            return;
+
+        auto &cached = it->second;
+        this->m_foundStrings = std::move(cached.foundStrings);
+        this->m_sortOrder = std::move(cached.sortOrder);
+        this->m_sortedStrings = this->m_foundStrings;
+        this->m_minimumLength = cached.minimumLength;
+        this->m_searchMode = cached.searchMode;
+        {
+            std::scoped_lock lock(this->m_filterMutex);
+            this->m_stringIndex = std::move(cached.stringIndex);
+        }
+
+        this->m_cachedResults.erase(it);
+    }
+
+    size_t ViewStrings::evictCachedResults(size_t bytes) {
+        size_t freed = 0;
+        while (freed < bytes && !this->m_cachedResults.empty()) {
+            auto oldest = std::min_element(this->m_cachedResults.begin(), this->m_cachedResults.end(), [](const auto &left, const auto &right) { return left.second.cachedAt < right.second.cachedAt; });
+
+            freed += oldest->second.memoryUsage;
+            this->m_cachedResults.erase(oldest);
+        }
+
+        return freed;
+    }
+
+    void ViewStrings::updateMemoryUsage() {
+        size_t usage = 0;
+        for (const auto &[provider, cached] : this->m_cachedResults)
+            usage += cached.memoryUsage;
+
+        this->m_memoryBudget.update(usage);
     }
 
 
     void ViewStrings::createStringContextMenu(const FoundString &foundString) {
-        if (ImGui::TableGetColumnFlags(2) == ImGuiTableColumnFlags_IsHovered && ImGui::IsMouseReleased(1) && ImGui::IsItemHovered()) {
+        if (ImGui::TableGetColumnFlags(3) == ImGuiTableColumnFlags_IsHovered && ImGui::IsMouseReleased(1) && ImGui::IsItemHovered()) {
             ImGui::OpenPopup("StringContextMenu");
-            this->m_selectedString = foundString.string;
+            this->m_selectedString = this->readString(foundString);
         }
         if (ImGui::BeginPopup("StringContextMenu")) {
             if (ImGui::MenuItem("hex.view.strings.copy"_lang)) {
@@ -45,57 +157,476 @@ namespace hex {
         }
     }
 
-    void ViewStrings::searchStrings() {
-        this->m_foundStrings.clear();
-        this->m_searching = true;
+    namespace {
 
-        std::thread([this] {
-            auto provider = SharedData::currentProvider;
+        /*
+            Decodes all strings in order. They're sorted by offset so the data can be read in large blocks instead of one string at a time.
+            Strings of providers with direct access get decoded in place unless they're patched
+        */
+        template<typename Callback>
+        void forEachString(prv::Provider *provider, const FoundStrings &strings, Callback &&callback, u32 first = 0) {
+            std::vector<u8> buffer;
+            u64 bufferOffset = 0;
 
-            std::vector<u8> buffer(1024, 0x00);
-            u32 foundCharacters = 0;
+            bool directAccess = provider->hasCapability(prv::Provider::Capability::DirectAccess);
 
-            for (u64 offset = 0; offset < provider->getSize(); offset += buffer.size()) {
-                size_t readSize = std::min(u64(buffer.size()), provider->getSize() - offset);
-                provider->read(offset,  buffer.data(), readSize);
+            for (u32 i = first; i < strings.size(); i++) {
+                const auto &foundString = strings[i];
 
-                for (u32 i = 0; i < readSize; i++) {
-                    if (buffer[i] >= 0x20 && buffer[i] <= 0x7E)
-                        foundCharacters++;
-                    else {
-                        if (foundCharacters >= this->m_minimumLength) {
-                            FoundString foundString;
+                if (directAccess) {
+                    if (auto view = provider->getAbsoluteDirectView(foundString.offset, foundString.size); view.has_value()) {
+                        if (!callback(i, StringSearcher::decode(view->data(), foundString)))
+                            return;
 
-                            foundString.offset = offset + i - foundCharacters;
-                            foundString.size = foundCharacters;
-                            foundString.string.reserve(foundCharacters);
-                            foundString.string.resize(foundCharacters);
-                            provider->read(foundString.offset, foundString.string.data(), foundCharacters);
+                        continue;
+                    }
+                }
 
-                            this->m_foundStrings.push_back(foundString);
-                        }
+                if (foundString.offset < bufferOffset || foundString.offset + foundString.size > bufferOffset + buffer.size()) {
+                    bufferOffset = foundString.offset;
+                    buffer.resize(std::min<u64>(std::max<u64>(StringSearcher::ChunkSize, foundString.size), provider->getActualSize() - bufferOffset));
+                    provider->readAbsolute(bufferOffset, buffer.data(), buffer.size());
+                }
 
-                        foundCharacters = 0;
-                    }
+                if (!callback(i, StringSearcher::decode(buffer.data() + (foundString.offset - bufferOffset), foundString)))
+                    return;
+            }
+        }
+
+        bool looksMangled(const std::string &string) {
+            if (string.starts_with('?'))
+                return true;
+
+            // Itanium names start with one to four underscores followed by a Z
+            size_t underscores = string.find_first_not_of('_');
+            return underscores > 0 && underscores <= 4 && underscores != std::string::npos && string[underscores] == 'Z';
+        }
+
+        u32 getTrigram(const char *string) {
+            return (u8(string[0]) << 16) | (u8(string[1]) << 8) | u8(string[2]);
+        }
+
+        std::string getCacheEntryName(StringSearchMode mode) {
+            return hex::format("strings.{}", u8(mode));
+        }
+
+        /* Searches all chunks from the first one to the end of the data on all cores. Nothing is returned if the task got interrupted */
+        std::optional<FoundStrings> searchChunks(prv::Provider *provider, Task &task, u64 firstChunk, size_t minimumLength, StringSearchMode mode) {
+            u64 dataSize = provider->getActualSize();
+            u64 chunkCount = (dataSize + StringSearcher::ChunkSize - 1) / StringSearcher::ChunkSize;
+            u64 startOffset = std::min(firstChunk * StringSearcher::ChunkSize, dataSize);
+
+            provider->adviseAccess(startOffset, dataSize - startOffset, prv::Provider::AccessHint::Sequential);
+            SCOPE_EXIT( provider->adviseAccess(startOffset, dataSize - startOffset, prv::Provider::AccessHint::Normal); );
+
+            // Every chunk gets its own result list so they can be joined in order once all workers are done
+            std::vector<std::vector<FoundString>> chunkResults(chunkCount > firstChunk ? chunkCount - firstChunk : 0);
+            std::atomic<u64> nextChunk = firstChunk;
+
+            auto worker = [&] {
+                for (u64 chunk = nextChunk++; chunk < chunkCount && !task.isInterrupted(); chunk = nextChunk++) {
+                    u64 chunkOffset = chunk * StringSearcher::ChunkSize;
+                    chunkResults[chunk - firstChunk] = StringSearcher::searchChunk(provider, chunkOffset, std::min<u64>(StringSearcher::ChunkSize, dataSize - chunkOffset), minimumLength, mode);
+                    task.update((std::min<u64>(nextChunk, chunkCount) - firstChunk) * StringSearcher::ChunkSize);
+                }
+            };
+
+            TaskManager::runParallel(std::min<u64>(provider->getReadWorkerCount(), chunkResults.size()), [&](u32) { worker(); });
+
+            if (task.isInterrupted())
+                return { };
+
+            FoundStrings foundStrings;
+            for (auto &results : chunkResults)
+                std::move(results.begin(), results.end(), std::back_inserter(foundStrings));
+
+            return foundStrings;
+        }
+
+    }
+
+    std::string ViewStrings::readString(const FoundString &foundString) {
+        std::vector<u8> data(foundString.size);
+        SharedData::currentProvider->readAbsolute(foundString.offset, data.data(), data.size());
+
+        return StringSearcher::decode(data.data(), foundString);
+    }
+
+    void ViewStrings::clearResults() {
+        this->m_foundStrings = std::make_shared<FoundStrings>();
+        this->m_sortOrder.reset();
+        this->m_sortedStrings.reset();
+        this->m_sorter.invalidate();
+        this->m_filteredIndices.clear();
+        this->m_filterDirty = true;
+        this->m_cacheChecked = false;
+        this->m_searchedSize = 0;
+        this->m_appendPending = false;
+
+        std::scoped_lock lock(this->m_demangleMutex);
+        this->m_demangleGeneration++;
+        this->m_demangledNames.clear();
+        this->m_demangleQueue.clear();
+    }
+
+    std::optional<std::string> ViewStrings::getDemangledName(const FoundString &foundString, const std::string &string) {
+        if (!looksMangled(string))
+            return "";
+
+        std::scoped_lock lock(this->m_demangleMutex);
+
+        // Strings are queued the first time they're shown and stay pending until a worker demangled them
+        auto [it, inserted] = this->m_demangledNames.try_emplace(foundString.offset);
+        if (inserted)
+            this->m_demangleQueue.emplace_back(foundString.offset, string);
+
+        return it->second;
+    }
+
+    void ViewStrings::demangleQueuedStrings() {
+        if (this->m_demangleTask.isRunning())
+            return;
+
+        std::vector<std::pair<u64, std::string>> queue;
+        {
+            std::scoped_lock lock(this->m_demangleMutex);
+            if (this->m_demangleQueue.empty())
+                return;
+
+            queue = std::move(this->m_demangleQueue);
+            this->m_demangleQueue.clear();
+        }
+
+        this->m_demangleTask = TaskManager::createTask("hex.view.strings.demangling", 0, [this, queue = std::move(queue), generation = u64(this->m_demangleGeneration)](Task &task) {
+            std::vector<std::string> results(queue.size());
+            std::atomic<size_t> nextString = 0;
+
+            auto worker = [&] {
+                for (size_t i = nextString++; i < queue.size() && !task.isInterrupted(); i = nextString++) {
+                    auto demangled = llvm::demangle(queue[i].second);
+                    if (demangled != queue[i].second)
+                        results[i] = std::move(demangled);
+                }
+            };
+
+            TaskManager::runParallel(std::min<u64>(TaskManager::getWorkerCount(), (queue.size() + 63) / 64), [&](u32) { worker(); });
+
+            {
+                std::scoped_lock lock(this->m_demangleMutex);
+                if (this->m_demangleGeneration == generation && !task.isInterrupted()) {
+                    for (size_t i = 0; i < queue.size(); i++)
+                        this->m_demangledNames[queue[i].first] = std::move(results[i]);
+                }
+            }
+        });
+    }
+
+    void ViewStrings::buildIndex(prv::Provider *provider, std::shared_ptr<const FoundStrings> strings, std::shared_ptr<const StringIndex> previous, u32 keptStrings) {
+        auto index = std::make_shared<StringIndex>();
+        index->strings = strings;
+
+        // Strings that were kept have the same indices as before, only the ones behind them need to be decoded
+        if (previous != nullptr && previous->strings != nullptr && keptStrings <= previous->strings->size()) {
+            index->trigrams = previous->trigrams;
+            for (auto it = index->trigrams.begin(); it != index->trigrams.end();) {
+                auto &postings = it->second;
+                postings.erase(std::lower_bound(postings.begin(), postings.end(), keptStrings), postings.end());
+
+                if (postings.empty())
+                    it = index->trigrams.erase(it);
+                else
+                    ++it;
+            }
+        } else
+            keptStrings = 0;
+
+        forEachString(provider, *strings, [&](u32 i, const std::string &string) {
+            for (size_t j = 0; j + 3 <= string.size(); j++) {
+                auto &postings = index->trigrams[getTrigram(string.data() + j)];
+
+                if (postings.empty() || postings.back() != i)
+                    postings.push_back(i);
+            }
+
+            return true;
+        }, keptStrings);
+
+        std::scoped_lock lock(this->m_filterMutex);
+        this->m_stringIndex = std::move(index);
+    }
+
+    void ViewStrings::updateFilter() {
+        this->m_filterDirty = false;
+        this->m_filteredIndices.clear();
+
+        u64 generation = ++this->m_filterGeneration;
+        std::string filter = this->m_filter.data();
+        auto strings = this->m_foundStrings;
+        u16 minimumLength = this->m_minimumLength;
+
+        if (filter.empty() || strings->empty()) {
+            // Hiding the strings that are too short only needs the table, none of them has to be read again
+            if (minimumLength > LowestMinimumLength) {
+                auto addIfLongEnough = [&](u32 i) {
+                    if ((*strings)[i].characters >= minimumLength)
+                        this->m_filteredIndices.push_back(i);
+                };
+
+                if (this->m_sortOrder == nullptr) {
+                    for (u32 i = 0; i < strings->size(); i++)
+                        addIfLongEnough(i);
+                } else {
+                    for (u32 i : *this->m_sortOrder)
+                        addIfLongEnough(i);
+                }
+            }
+
+            this->m_filtering = false;
+            return;
+        }
+
+        std::shared_ptr<const StringIndex> index;
+        {
+            std::scoped_lock lock(this->m_filterMutex);
+            index = this->m_stringIndex;
+            this->m_pendingFilterMatches.clear();
+            this->m_pendingFilterDone = false;
+        }
+
+        if (index != nullptr && index->strings == strings && filter.size() >= 3) {
+            // Only strings containing every trigram of the filter can match, start intersecting with the shortest list
+            std::vector<const std::vector<u32>*> postings;
+            for (size_t i = 0; i + 3 <= filter.size(); i++) {
+                auto it = index->trigrams.find(getTrigram(filter.data() + i));
+                if (it == index->trigrams.end()) {
+                    this->m_filtering = false;
+                    return;
+                }
+
+                postings.push_back(&it->second);
+            }
+
+            std::sort(postings.begin(), postings.end(), [](auto left, auto right) { return left->size() < right->size(); });
+
+            std::vector<u32> candidates = *postings.front();
+            for (auto it = postings.begin() + 1; it != postings.end() && !candidates.empty(); it++) {
+                std::vector<u32> intersection;
+                std::set_intersection(candidates.begin(), candidates.end(), (*it)->begin(), (*it)->end(), std::back_inserter(intersection));
+                candidates = std::move(intersection);
+            }
+
+            std::erase_if(candidates, [&](u32 i) { return (*strings)[i].characters < minimumLength || this->readString((*strings)[i]).find(filter) == std::string::npos; });
+
+            this->m_filteredIndices = this->applySortOrder(std::move(candidates));
+            this->m_filtering = false;
+            return;
+        }
+
+        // No index yet or a filter too short to use it, check all strings in the background and show matches as they come in
+        this->m_filtering = true;
+        this->m_filterTask = TaskManager::createTask("hex.view.strings.filtering", strings->size(), [this, provider = ImHexApi::Provider::getHandle(), generation, filter, strings, minimumLength](Task &task) {
+            std::vector<u32> matches;
+
+            forEachString(provider.get(), *strings, [&](u32 i, const std::string &string) {
+                if ((*strings)[i].characters >= minimumLength && string.find(filter) != std::string::npos)
+                    matches.push_back(i);
+
+                if ((i % 0x1'0000) == 0) {
+                    task.update(i);
+
+                    std::scoped_lock lock(this->m_filterMutex);
+                    if (this->m_filterGeneration != generation || task.isInterrupted())
+                        return false;
+
+                    std::move(matches.begin(), matches.end(), std::back_inserter(this->m_pendingFilterMatches));
+                    matches.clear();
                 }
+
+                return true;
+            });
+
+            std::scoped_lock lock(this->m_filterMutex);
+            if (this->m_filterGeneration == generation) {
+                std::move(matches.begin(), matches.end(), std::back_inserter(this->m_pendingFilterMatches));
+                this->m_pendingFilterDone = true;
             }
+        });
+    }
+
+    void ViewStrings::collectFilterResults() {
+        if (!this->m_filtering)
+            return;
+
+        std::scoped_lock lock(this->m_filterMutex);
+
+        std::move(this->m_pendingFilterMatches.begin(), this->m_pendingFilterMatches.end(), std::back_inserter(this->m_filteredIndices));
+        this->m_pendingFilterMatches.clear();
+
+        // Partial results are shown in extraction order, put them in the sorted order once everything has been checked
+        if (this->m_pendingFilterDone) {
+            this->m_filteredIndices = this->applySortOrder(std::move(this->m_filteredIndices));
+            this->m_pendingFilterDone = false;
+            this->m_filtering = false;
+        }
+    }
+
+    std::vector<u32> ViewStrings::applySortOrder(std::vector<u32> &&matches) const {
+        if (this->m_sortOrder == nullptr)
+            return std::move(matches);
 
+        std::vector<bool> matching(this->m_foundStrings->size(), false);
+        for (u32 i : matches)
+            matching[i] = true;
+
+        std::vector<u32> result;
+        result.reserve(matches.size());
+        for (u32 i : *this->m_sortOrder) {
+            if (matching[i])
+                result.push_back(i);
+        }
+
+        return result;
+    }
+
+    void ViewStrings::searchStrings(bool onlyCached) {
+        this->clearResults();
+        this->m_searching = true;
+        this->m_cacheChecked = true;
+
+        auto provider = ImHexApi::Provider::getHandle();
+        this->m_searchTask = TaskManager::createTask("hex.view.strings.searching", provider->getActualSize(), [this, provider, mode = this->m_searchMode, onlyCached](Task &task) {
+            // Results depend on the search mode, every mode gets its own cache entry
+            auto cacheEntryName = getCacheEntryName(mode);
+
+            if (auto reader = AnalysisCache::load(provider.get(), cacheEntryName); reader.has_value()) {
+                auto foundStrings = std::make_shared<FoundStrings>();
+                if (reader->readVector(*foundStrings)) {
+                    this->m_foundStrings = foundStrings;
+                    this->m_searchedSize = provider->getActualSize();
+                    this->m_filterDirty = true;
+                    this->m_searching = false;
+
+                    Session::addAnalysis(provider.get(), "strings", std::to_string(u8(mode)));
+
+                    this->buildIndex(provider.get(), foundStrings);
+                    return;
+                }
+            }
+
+            if (onlyCached) {
+                this->m_searching = false;
+                return;
+            }
+
+            u64 dataSize = provider->getActualSize();
+            auto results = searchChunks(provider.get(), task, 0, LowestMinimumLength, mode);
+            if (!results.has_value()) {
+                this->m_searching = false;
+                return;
+            }
+
+            auto foundStrings = std::make_shared<FoundStrings>(std::move(*results));
+
+            this->m_foundStrings = foundStrings;
+            this->m_searchedSize = dataSize;
+            this->m_filterDirty = true;
             this->m_searching = false;
-        }).detach();
+
+            AnalysisCache::Writer writer;
+            writer.writeVector(*foundStrings);
+            AnalysisCache::store(provider.get(), cacheEntryName, writer);
+            Session::addAnalysis(provider.get(), "strings", std::to_string(u8(mode)));
+
+            this->buildIndex(provider.get(), foundStrings);
+        });
 
     }
 
+    void ViewStrings::searchAppended() {
+        this->m_appendPending = false;
+
+        auto provider = ImHexApi::Provider::getHandle();
+        auto previous = this->m_foundStrings;
+        std::shared_ptr<const StringIndex> previousIndex;
+        {
+            std::scoped_lock lock(this->m_filterMutex);
+            previousIndex = this->m_stringIndex;
+        }
+
+        auto mode = this->m_searchMode;
+
+        // Strings that reached the old end or were too short to count may continue in the appended data, the chunks they start in get searched again.
+        // Characters take up to four bytes
+        u64 searchedSize = this->m_searchedSize;
+        u64 firstChunk = (searchedSize - std::min<u64>(searchedSize, LowestMinimumLength * 4)) / StringSearcher::ChunkSize;
+        if (!previous->empty() && previous->back().offset + previous->back().size >= searchedSize)
+            firstChunk = std::min<u64>(firstChunk, previous->back().offset / StringSearcher::ChunkSize);
+
+        u64 restartOffset = firstChunk * StringSearcher::ChunkSize;
+        u32 keptStrings = std::lower_bound(previous->begin(), previous->end(), restartOffset, [](const FoundString &foundString, u64 offset) { return foundString.offset < offset; }) - previous->begin();
+
+        this->m_searchTask = TaskManager::createTask("hex.view.strings.searching", provider->getActualSize() - restartOffset, [this, provider, previous, previousIndex, firstChunk, keptStrings, mode](Task &task) {
+            u64 dataSize = provider->getActualSize();
+            auto results = searchChunks(provider.get(), task, firstChunk, LowestMinimumLength, mode);
+            if (!results.has_value())
+                return;
+
+            auto foundStrings = std::make_shared<FoundStrings>(previous->begin(), previous->begin() + keptStrings);
+            std::move(results->begin(), results->end(), std::back_inserter(*foundStrings));
+
+            AnalysisCache::Writer writer;
+            writer.writeVector(*foundStrings);
+            AnalysisCache::store(provider.get(), getCacheEntryName(mode), writer);
+
+            this->buildIndex(provider.get(), foundStrings, previousIndex, keptStrings);
+
+            // The old results stay visible during the search, they only get replaced if nothing cleared them in the meantime
+            View::doLater([this, provider = provider.get(), previous, foundStrings, dataSize] {
+                if (this->m_foundStrings != previous || SharedData::currentProvider != provider)
+                    return;
+
+                this->m_foundStrings = foundStrings;
+                this->m_searchedSize = dataSize;
+                this->m_filterDirty = true;
+            });
+        });
+    }
+
     void ViewStrings::drawContent() {
         auto provider = SharedData::currentProvider;
 
 
         if (ImGui::Begin(View::toWindowName("hex.view.strings.name").c_str(), &this->getWindowOpenState(), ImGuiWindowFlags_NoCollapse)) {
             if (provider != nullptr && provider->isReadable()) {
+                if (!this->m_cacheChecked && !this->m_searching && this->m_foundStrings->empty())
+                    this->searchStrings(true);
+                else if (this->m_appendPending && !this->m_searching && !this->m_searchTask.isRunning())
+                    this->searchAppended();
+
                 ImGui::Disabled([this]{
-                    if (ImGui::InputInt("hex.view.strings.min_length"_lang, &this->m_minimumLength, 1, 0))
-                        this->m_foundStrings.clear();
+                    if (ImGui::InputInt("hex.view.strings.min_length"_lang, &this->m_minimumLength, 1, 0)) {
+                        this->m_minimumLength = std::clamp(this->m_minimumLength, LowestMinimumLength, 0xFFFF);
+                        this->m_filterDirty = true;
+                    }
 
-                    ImGui::InputText("hex.view.strings.filter"_lang, this->m_filter.data(), this->m_filter.size());
+                    auto modeName = [](StringSearchMode mode) -> const char* {
+                        if (mode == StringSearchMode::All)
+                            return "hex.view.strings.encoding.all"_lang;
+                        return StringEncodingNames[u8(mode)];
+                    };
+
+                    if (ImGui::BeginCombo("hex.view.strings.encoding"_lang, modeName(this->m_searchMode))) {
+                        for (auto mode : { StringSearchMode::ASCII, StringSearchMode::UTF8, StringSearchMode::UTF16LE, StringSearchMode::UTF16BE, StringSearchMode::All }) {
+                            if (ImGui::Selectable(modeName(mode), mode == this->m_searchMode)) {
+                                this->m_searchMode = mode;
+                                this->clearResults();
+                            }
+                        }
+                        ImGui::EndCombo();
+                    }
+
+                    if (ImGui::InputText("hex.view.strings.filter"_lang, this->m_filter.data(), this->m_filter.size()))
+                        this->m_filterDirty = true;
                     if (ImGui::Button("hex.view.strings.extract"_lang))
                         this->searchStrings();
                 }, this->m_searching);
@@ -103,60 +634,101 @@ namespace hex {
                 if (this->m_searching) {
                     ImGui::SameLine();
                     ImGui::TextSpinner("hex.view.strings.searching"_lang);
+                } else if (this->m_filtering) {
+                    ImGui::SameLine();
+                    ImGui::TextSpinner("hex.view.strings.filtering"_lang);
                 }
 
 
                 ImGui::Separator();
                 ImGui::NewLine();
 
-                if (ImGui::BeginTable("##strings", 3,
+                if (ImGui::BeginTable("##strings", 5,
                                       ImGuiTableFlags_Borders | ImGuiTableFlags_Resizable | ImGuiTableFlags_Sortable |
                                       ImGuiTableFlags_Reorderable | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY)) {
                     ImGui::TableSetupScrollFreeze(0, 1);
                     ImGui::TableSetupColumn("hex.view.strings.offset"_lang, 0, -1, ImGui::GetID("offset"));
                     ImGui::TableSetupColumn("hex.view.strings.size"_lang, 0, -1, ImGui::GetID("size"));
+                    ImGui::TableSetupColumn("hex.view.strings.encoding"_lang, 0, -1, ImGui::GetID("encoding"));
                     ImGui::TableSetupColumn("hex.view.strings.string"_lang, 0, -1, ImGui::GetID("string"));
+                    ImGui::TableSetupColumn("hex.view.strings.demangled"_lang, ImGuiTableColumnFlags_NoSort, -1, ImGui::GetID("demangled"));
 
                     auto sortSpecs = ImGui::TableGetSortSpecs();
 
-                    if (sortSpecs->SpecsDirty) {
-                        std::sort(this->m_foundStrings.begin(), this->m_foundStrings.end(),
-                                  [&sortSpecs](FoundString &left, FoundString &right) -> bool {
-                                      if (sortSpecs->Specs->ColumnUserID == ImGui::GetID("offset")) {
-                                          if (sortSpecs->Specs->SortDirection == ImGuiSortDirection_Ascending)
-                                              return left.offset > right.offset;
-                                          else
-                                              return left.offset < right.offset;
-                                      } else if (sortSpecs->Specs->ColumnUserID == ImGui::GetID("size")) {
-                                          if (sortSpecs->Specs->SortDirection == ImGuiSortDirection_Ascending)
-                                              return left.size > right.size;
-                                          else
-                                              return left.size < right.size;
-                                      } else if (sortSpecs->Specs->ColumnUserID == ImGui::GetID("string")) {
-                                          if (sortSpecs->Specs->SortDirection == ImGuiSortDirection_Ascending)
-                                              return left.string > right.string;
-                                          else
-                                              return left.string < right.string;
-                                      }
-
-                                      return false;
-                                  });
+                    // Results that changed since they were sorted last get sorted again, none of the orders of the old ones fit anymore
+                    if (this->m_sortedStrings != this->m_foundStrings && !this->m_searching) {
+                        this->m_sorter.invalidate();
+                        this->m_sortOrder.reset();
+                        this->m_sortedStrings = this->m_foundStrings;
+                        this->m_filterDirty = true;
+                        sortSpecs->SpecsDirty = true;
+                    }
+
+                    if (sortSpecs->SpecsDirty && !this->m_searching) {
+                        auto strings = this->m_foundStrings;
+                        bool ascending = sortSpecs->Specs->SortDirection == ImGuiSortDirection_Ascending;
+                        auto column = sortSpecs->Specs->ColumnUserID;
+
+                        // Column IDs can only be looked up here, the comparator gets created on the sorting task
+                        bool byString = column == ImGui::GetID("string"), byOffset = column == ImGui::GetID("offset"), bySize = column == ImGui::GetID("size"), byEncoding = column == ImGui::GetID("encoding");
+
+                        this->m_sorter.sort((u64(column) << 1) | u64(ascending), strings->size(), [provider = ImHexApi::Provider::getHandle(), strings, ascending, byString, byOffset, bySize, byEncoding]() -> TableSorter::Comparator {
+                            if (byString) {
+                                // Strings aren't stored in the table, decode them once for the duration of the sort
+                                auto decoded = std::make_shared<std::vector<std::string>>();
+                                decoded->reserve(strings->size());
+                                forEachString(provider.get(), *strings, [&](u32, std::string &&string) {
+                                    decoded->push_back(std::move(string));
+                                    return true;
+                                });
+
+                                return [decoded, ascending](u32 left, u32 right) {
+                                    return ascending ? (*decoded)[left] > (*decoded)[right] : (*decoded)[left] < (*decoded)[right];
+                                };
+                            }
+
+                            return [strings, ascending, byOffset, bySize, byEncoding](u32 leftIndex, u32 rightIndex) -> bool {
+                                const auto &left = (*strings)[leftIndex], &right = (*strings)[rightIndex];
+
+                                if (byOffset) {
+                                    return ascending ? left.offset > right.offset : left.offset < right.offset;
+                                } else if (bySize) {
+                                    return ascending ? left.size > right.size : left.size < right.size;
+                                } else if (byEncoding) {
+                                    return ascending ? left.encoding > right.encoding : left.encoding < right.encoding;
+                                }
+
+                                return false;
+                            };
+                        });
 
                         sortSpecs->SpecsDirty = false;
                     }
 
+                    // Orders sorted in the background replace the one in use once they're done
+                    if (auto order = this->m_sorter.getOrder(); order != nullptr && order != this->m_sortOrder) {
+                        this->m_sortOrder = std::move(order);
+                        this->m_filterDirty = true;
+                    }
+
+                    if (this->m_filterDirty && !this->m_searching)
+                        this->updateFilter();
+                    this->collectFilterResults();
+
                     ImGui::TableHeadersRow();
 
+                    bool filtered = this->m_filter[0] != 0x00 || this->m_minimumLength > LowestMinimumLength;
+
                     ImGuiListClipper clipper;
-                    clipper.Begin(this->m_foundStrings.size());
+                    if (this->m_searching)
+                        clipper.Begin(0);
+                    else
+                        clipper.Begin(filtered ? this->m_filteredIndices.size() : this->m_foundStrings->size());
 
                     while (clipper.Step()) {
-                        for (u64 i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
-                            auto &foundString = this->m_foundStrings[i];
-
-                            if (strlen(this->m_filter.data()) != 0 &&
-                                foundString.string.find(this->m_filter.data()) == std::string::npos)
-                                continue;
+                        for (u64 row = clipper.DisplayStart; row < clipper.DisplayEnd; row++) {
+                            u64 i = filtered ? this->m_filteredIndices[row] : (this->m_sortOrder == nullptr ? row : (*this->m_sortOrder)[row]);
+                            auto &foundString = (*this->m_foundStrings)[i];
 
                             ImGui::TableNextRow();
                             ImGui::TableNextColumn();
@@ -172,11 +744,21 @@ namespace hex {
                             ImGui::TableNextColumn();
                             ImGui::Text("0x%04lx", foundString.size);
                             ImGui::TableNextColumn();
-                            ImGui::Text("%s", foundString.string.c_str());
+                            ImGui::TextUnformatted(StringEncodingNames[u8(foundString.encoding)]);
+                            ImGui::TableNextColumn();
+                            auto string = this->readString(foundString);
+                            ImGui::TextUnformatted(string.c_str());
+                            ImGui::TableNextColumn();
+                            if (auto demangled = this->getDemangledName(foundString, string); demangled.has_value())
+                                ImGui::TextUnformatted(demangled->c_str());
+                            else
+                                ImGui::TextSpinner("");
                         }
                     }
                     clipper.End();
 
+                    this->demangleQueuedStrings();
+
                     ImGui::EndTable();
                 }
             }
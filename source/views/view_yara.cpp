@@ -1,29 +1,226 @@
 #include "views/view_yara.hpp"
 
+#include <hex/api/imhex_api.hpp>
+#include <hex/helpers/profiler.hpp>
+#include <hex/helpers/analysis_cache.hpp>
+#include <hex/helpers/crypto.hpp>
+#include <hex/lang/pattern_data.hpp>
 #include <hex/providers/provider.hpp>
 
+#include "helpers/session.hpp"
+
 #include <yara.h>
+#include <atomic>
+#include <cctype>
 #include <filesystem>
-#include <thread>
+#include <fstream>
 
 #include <imgui_imhex_extensions.h>
 
 namespace hex {
 
-    ViewYara::ViewYara() : View("hex.view.yara.name") {
-        yr_initialize();
+    /*
+        Checks whether every rule of a rule file only depends on the bytes its strings matched, which is the case if each condition just
+        ORs together some of the rule's strings and every string has a fixed length. Returns the length of the longest string if so
+    */
+    static std::optional<size_t> getLocalMatchMargin(std::string_view source) {
+        enum class Section { None, Meta, Strings, Condition };
+
+        Section section = Section::None;
+        size_t margin = 0;
+        size_t stringLength = 0;
+        bool wide = false;
+
+        auto finishString = [&] {
+            margin = std::max(margin, stringLength * (wide ? 2 : 1));
+            stringLength = 0;
+            wide = false;
+        };
+
+        for (size_t i = 0; i < source.size();) {
+            char c = source[i];
+
+            if (std::isspace(static_cast<unsigned char>(c))) {
+                i++;
+            } else if (source.substr(i, 2) == "//") {
+                i = source.find('\n', i);
+                if (i == std::string_view::npos) break;
+            } else if (source.substr(i, 2) == "/*") {
+                i = source.find("*/", i);
+                if (i == std::string_view::npos) break;
+                i += 2;
+            } else if (std::isalpha(static_cast<unsigned char>(c)) || c == '_') {
+                size_t end = i;
+                while (end < source.size() && (std::isalnum(static_cast<unsigned char>(source[end])) || source[end] == '_'))
+                    end++;
+
+                auto word = source.substr(i, end - i);
+                i = end;
+
+                if (end < source.size() && source[end] == ':' && (word == "meta" || word == "strings" || word == "condition")) {
+                    if (section == Section::Strings)
+                        finishString();
+
+                    section = word == "meta" ? Section::Meta : word == "strings" ? Section::Strings : Section::Condition;
+                    i++;
+                } else if (section == Section::None) {
+                    // Global rules and included files may affect any rule, imports can only be used in conditions
+                    if (word == "global" || word == "include")
+                        return { };
+                } else if (section == Section::Strings) {
+                    if (word == "wide")
+                        wide = true;
+                    else if (word != "ascii" && word != "nocase" && word != "fullword" && word != "private")
+                        return { };
+                } else if (section == Section::Condition) {
+                    if (word != "or" && word != "any" && word != "of" && word != "them")
+                        return { };
+                }
+            } else if (section == Section::Meta) {
+                // Metadata values don't matter, just skip over strings so they can't be mistaken for anything else
+                if (c == '"') {
+                    for (i++; i < source.size() && source[i] != '"'; i++)
+                        if (source[i] == '\\') i++;
+                }
+                i++;
+            } else if (c == '}' && section != Section::Strings) {
+                section = Section::None;
+                i++;
+            } else if (section == Section::Strings) {
+                if (c == '$') {
+                    finishString();
+                    for (i++; i < source.size() && (std::isalnum(static_cast<unsigned char>(source[i])) || source[i] == '_'); i++);
+                } else if (c == '=') {
+                    i++;
+                } else if (c == '"') {
+                    for (i++; i < source.size() && source[i] != '"'; i++, stringLength++) {
+                        if (source[i] != '\\') continue;
+
+                        i++;
+                        if (i < source.size() && source[i] == 'x') i += 2;
+                    }
+                    i++;
+                } else if (c == '{') {
+                    // Hex strings with jumps or alternatives don't have a fixed length
+                    for (i++; i < source.size() && source[i] != '}'; i++) {
+                        if (source[i] == '[' || source[i] == '(' || source[i] == '|')
+                            return { };
+                        else if (std::isxdigit(static_cast<unsigned char>(source[i])) || source[i] == '?') {
+                            stringLength++;
+                            i++;
+                        }
+                    }
+                    i++;
+                } else {
+                    // Regular expressions and everything else
+                    return { };
+                }
+            } else if (section == Section::Condition) {
+                if (c == '$') {
+                    for (i++; i < source.size() && (std::isalnum(static_cast<unsigned char>(source[i])) || source[i] == '_' || source[i] == '*'); i++);
+                } else if (c == '(' || c == ')' || c == ',') {
+                    i++;
+                } else {
+                    // Counts, offsets, lengths, numbers, comparisons and so on depend on the whole data
+                    return { };
+                }
+            } else {
+                // Rule names, tags and the braces around rules
+                i++;
+            }
+        }
 
-        this->reloadRules();
+        return margin;
+    }
+
+    ViewYara::ViewYara(std::vector<lang::PatternData*> &patternData) : View("hex.view.yara.name"), m_patternData(patternData) {
+        if (!SharedData::fastStart)
+            this->initialize();
+
+        View::subscribeEvent<Region>(Events::RegionSelected, [this](const Region &region) {
+            this->m_selection = region;
+        });
+
+        View::subscribeEvent(Events::DataChanged, [this](auto userData) {
+            if (this->m_scannedRules.empty())
+                return;
+
+            std::scoped_lock lock(this->m_changedRegionsMutex);
+
+            if (auto region = std::any_cast<Region>(&userData); region != nullptr)
+                this->m_changedRegions.push_back(*region);
+            else
+                this->m_rescanAll = true;
+        });
+
+        // Matches aren't kept per provider, the rules that were scanned get scanned again for the new one
+        View::subscribeEvent(Events::ProviderChanged, [this](auto) {
+            if (this->m_scannedRules.empty())
+                return;
+
+            std::scoped_lock lock(this->m_changedRegionsMutex);
+            this->m_rescanAll = true;
+        });
+
+        // The rule files of the last session are matched again, their matches come from the analysis cache unless the data or the rules changed
+        Session::registerAnalysis("yara", [this](const std::string &argument) {
+            if (this->m_matchingTask.isRunning())
+                return;
+
+            this->initialize();
+
+            std::set<std::string> selectedRules;
+            for (const auto &path : hex::splitString(argument, "\n")) {
+                if (std::find(this->m_rules.begin(), this->m_rules.end(), path) != this->m_rules.end())
+                    selectedRules.insert(path);
+            }
+
+            if (selectedRules.empty())
+                return;
+
+            this->m_selectedRules = std::move(selectedRules);
+            this->m_scanScope = ScanScope::WholeData;
+            this->applyRules();
+        });
     }
 
     ViewYara::~ViewYara() {
-        yr_finalize();
+        View::unsubscribeEvent(Events::RegionSelected);
+        View::unsubscribeEvent(Events::DataChanged);
+        View::unsubscribeEvent(Events::ProviderChanged);
+
+        Session::unregisterAnalysis("yara");
+
+        this->m_matchingTask.interrupt();
+        this->m_matchingTask.wait();
+
+        for (auto &[path, compiledRules] : this->m_compiledRules)
+            yr_rules_destroy(compiledRules.rules);
+
+        if (this->m_initialized)
+            yr_finalize();
+    }
+
+    void ViewYara::initialize() {
+        if (this->m_initialized)
+            return;
+
+        PROFILE_STARTUP("YARA");
+
+        yr_initialize();
+        this->reloadRules();
+
+        this->m_initialized = true;
     }
 
     void ViewYara::drawContent() {
+        if (!this->m_matchingTask.isRunning())
+            this->applyDataChanges();
+
         if (ImGui::Begin(View::toWindowName("hex.view.yara.name").c_str(), &this->getWindowOpenState(), ImGuiWindowFlags_NoCollapse)) {
+            this->initialize();
 
-            if (!this->m_matching && !this->m_errorMessage.empty()) {
+            if (!this->m_matchingTask.isRunning() && !this->m_errorMessage.empty()) {
                 View::showErrorPopup("hex.view.yara.error"_lang + this->m_errorMessage.data());
                 this->m_errorMessage.clear();
             }
@@ -37,23 +234,40 @@ namespace hex {
                 if (ImGui::Button("hex.view.yara.reload"_lang)) this->reloadRules();
             } else {
                 ImGui::Disabled([this]{
-                    if (ImGui::BeginCombo("hex.view.yara.header.rules"_lang, this->m_rules[this->m_selectedRule].c_str())) {
-                        for (u32 i = 0; i < this->m_rules.size(); i++) {
-                            const bool selected = (this->m_selectedRule == i);
-                            if (ImGui::Selectable(this->m_rules[i].c_str(), selected))
-                                this->m_selectedRule = i;
-
-                            if (selected)
-                                ImGui::SetItemDefaultFocus();
+                    if (ImGui::ListBoxHeader("##rules", this->m_rules.size(), 5)) {
+                        for (const auto &path : this->m_rules) {
+                            const bool selected = this->m_selectedRules.contains(path);
+                            if (ImGui::Selectable(path.c_str(), selected)) {
+                                if (selected)
+                                    this->m_selectedRules.erase(path);
+                                else
+                                    this->m_selectedRules.insert(path);
+                            }
                         }
-                        ImGui::EndCombo();
+                        ImGui::ListBoxFooter();
                     }
+
+                    if (ImGui::Button("hex.view.yara.select_all"_lang))
+                        this->m_selectedRules.insert(this->m_rules.begin(), this->m_rules.end());
                     ImGui::SameLine();
                     if (ImGui::Button("hex.view.yara.reload"_lang)) this->reloadRules();
-                    if (ImGui::Button("hex.view.yara.match"_lang)) this->applyRules();
-                }, this->m_matching);
+                    ImGui::SameLine();
+                    ImGui::Disabled([this] {
+                        if (ImGui::Button("hex.view.yara.match"_lang)) this->applyRules();
+                    }, this->m_selectedRules.empty());
+
+                    constexpr static const char* ScopeNames[] = { "hex.view.yara.scope.whole_data", "hex.view.yara.scope.selection", "hex.view.yara.scope.bookmarks", "hex.view.yara.scope.patterns" };
+
+                    if (ImGui::BeginCombo("hex.view.yara.scope"_lang, LangEntry(ScopeNames[u8(this->m_scanScope)]))) {
+                        for (auto scope : { ScanScope::WholeData, ScanScope::Selection, ScanScope::Bookmarks, ScanScope::Patterns }) {
+                            if (ImGui::Selectable(LangEntry(ScopeNames[u8(scope)]), scope == this->m_scanScope))
+                                this->m_scanScope = scope;
+                        }
+                        ImGui::EndCombo();
+                    }
+                }, this->m_matchingTask.isRunning());
 
-                if (this->m_matching) {
+                if (this->m_matchingTask.isRunning()) {
                     ImGui::SameLine();
                     ImGui::TextSpinner("hex.view.yara.matching"_lang);
                 }
@@ -63,20 +277,98 @@ namespace hex {
             ImGui::TextUnformatted("hex.view.yara.header.matches"_lang);
             ImGui::Separator();
 
-            if (ImGui::BeginTable("matches", 3, ImGuiTableFlags_Borders | ImGuiTableFlags_Resizable | ImGuiTableFlags_Sortable | ImGuiTableFlags_Reorderable | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY)) {
+            ImGui::Disabled([this] {
+                if (ImGui::Button("hex.view.yara.hash_matches"_lang)) {
+                    std::vector<std::pair<std::string, Region>> regions;
+
+                    {
+                        std::scoped_lock lock(this->m_matchesMutex);
+                        for (const auto &[identifier, ruleFile, address, size, wholeDataMatch, scopeRegion] : this->m_matches) {
+                            if (wholeDataMatch)
+                                regions.emplace_back(identifier, Region { 0, SharedData::currentProvider->getSize() });
+                            else
+                                regions.emplace_back(identifier, Region { u64(address), size_t(size) });
+                        }
+                    }
+
+                    View::postEvent(Events::HashRegions, regions);
+                }
+            }, this->m_matchingTask.isRunning() || SharedData::currentProvider == nullptr);
+
+            if (ImGui::BeginTable("matches", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_Resizable | ImGuiTableFlags_Sortable | ImGuiTableFlags_Reorderable | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY)) {
                 ImGui::TableSetupScrollFreeze(0, 1);
                 ImGui::TableSetupColumn("hex.view.yara.matches.identifier"_lang);
+                ImGui::TableSetupColumn("hex.view.yara.matches.file"_lang);
                 ImGui::TableSetupColumn("hex.common.address"_lang);
                 ImGui::TableSetupColumn("hex.common.size"_lang);
 
                 ImGui::TableHeadersRow();
 
+                // Matches keep coming in while the scan is still running
+                std::scoped_lock lock(this->m_matchesMutex);
+
+                // They're shown in the order they were found until the scan is done, any change after that needs them sorted again
+                auto sortSpecs = ImGui::TableGetSortSpecs();
+                bool scanning = this->m_matchingTask.isRunning();
+
+                if (!scanning && this->m_sortedGeneration != this->m_matchesGeneration) {
+                    this->m_sorter.invalidate();
+                    this->m_sortedGeneration = this->m_matchesGeneration;
+                    sortSpecs->SpecsDirty = true;
+                }
+
+                if (!scanning && sortSpecs->SpecsDirty && sortSpecs->SpecsCount > 0) {
+                    auto column = sortSpecs->Specs->ColumnIndex;
+                    bool ascending = sortSpecs->Specs->SortDirection == ImGuiSortDirection_Ascending;
+
+                    this->m_sorter.sort((u64(column) << 1) | u64(ascending), this->m_matches.size(), [this, column, ascending, generation = this->m_matchesGeneration]() -> TableSorter::Comparator {
+                        auto byKeys = [ascending](auto &&keys) -> TableSorter::Comparator {
+                            return [keys = std::make_shared<std::remove_cvref_t<decltype(keys)>>(std::move(keys)), ascending](u32 left, u32 right) {
+                                return ascending ? (*keys)[left] < (*keys)[right] : (*keys)[right] < (*keys)[left];
+                            };
+                        };
+
+                        // Only the sorted column gets copied, the matches themselves may change while they're being sorted
+                        std::scoped_lock lock(this->m_matchesMutex);
+                        if (this->m_matchesGeneration != generation)
+                            return { };
+
+                        switch (column) {
+                            case 0:
+                            case 1: {
+                                std::vector<std::string> keys;
+                                keys.reserve(this->m_matches.size());
+                                for (const auto &match : this->m_matches)
+                                    keys.push_back(column == 0 ? match.identifier : match.ruleFile);
+                                return byKeys(std::move(keys));
+                            }
+                            case 2:
+                            case 3: {
+                                std::vector<s64> keys;
+                                keys.reserve(this->m_matches.size());
+                                for (const auto &match : this->m_matches)
+                                    keys.push_back(column == 2 ? match.address : match.size);
+                                return byKeys(std::move(keys));
+                            }
+                            default:
+                                return { };
+                        }
+                    });
+
+                    sortSpecs->SpecsDirty = false;
+                }
+
+                auto order = scanning ? nullptr : this->m_sorter.getOrder();
+                if (order != nullptr && order->size() != this->m_matches.size())
+                    order = nullptr;
+
                 ImGuiListClipper clipper;
                 clipper.Begin(this->m_matches.size());
 
                 while (clipper.Step()) {
-                    for (u32 i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
-                        auto &[identifier, address, size, wholeDataMatch] = this->m_matches[i];
+                    for (u32 row = clipper.DisplayStart; row < clipper.DisplayEnd; row++) {
+                        u32 i = order == nullptr ? row : (*order)[row];
+                        auto &[identifier, ruleFile, address, size, wholeDataMatch, scopeRegion] = this->m_matches[i];
                         ImGui::TableNextRow();
                         ImGui::TableNextColumn();
                         ImGui::PushID(i);
@@ -87,6 +379,8 @@ namespace hex {
                         ImGui::PopID();
                         ImGui::SameLine();
                         ImGui::TextUnformatted(identifier.c_str());
+                        ImGui::TableNextColumn();
+                        ImGui::TextUnformatted(ruleFile.c_str());
 
                         if (!wholeDataMatch) {
                             ImGui::TableNextColumn();
@@ -118,126 +412,510 @@ namespace hex {
     void ViewYara::reloadRules() {
         this->m_rules.clear();
 
-        if (!std::filesystem::exists("./yara"))
+        if (!std::filesystem::exists("./yara")) {
+            this->m_selectedRules.clear();
             return;
+        }
 
         for (const auto &entry : std::filesystem::directory_iterator("yara")) {
             if (entry.is_regular_file())
                 this->m_rules.push_back(entry.path().string());
         }
+
+        std::erase_if(this->m_selectedRules, [this](const auto &path) {
+            return std::find(this->m_rules.begin(), this->m_rules.end(), path) == this->m_rules.end();
+        });
+
+        if (this->m_selectedRules.empty() && !this->m_rules.empty())
+            this->m_selectedRules.insert(this->m_rules.front());
     }
 
     void ViewYara::applyRules() {
-        this->m_matches.clear();
+        {
+            std::scoped_lock lock(this->m_matchesMutex);
+            this->m_matches.clear();
+            this->m_matchesGeneration++;
+        }
+
+        {
+            std::scoped_lock lock(this->m_changedRegionsMutex);
+            this->m_changedRegions.clear();
+            this->m_rescanAll = false;
+        }
+
         this->m_errorMessage.clear();
-        this->m_matching = true;
 
-        std::thread([this] {
+        this->m_scannedRules.clear();
+        for (const auto &path : this->m_rules) {
+            if (this->m_selectedRules.contains(path))
+                this->m_scannedRules.push_back(path);
+        }
 
-            YR_COMPILER *compiler = nullptr;
-            yr_compiler_create(&compiler);
+        this->m_scannedScope = this->m_scanScope;
+        this->m_scopeRegions = this->getScopeRegions(this->m_scannedScope);
 
-            FILE *file = fopen(this->m_rules[this->m_selectedRule].c_str(), "r");
-            if (file == nullptr) return;
-            SCOPE_EXIT( fclose(file); );
+        this->scanRuleFiles(this->m_scannedRules, std::nullopt);
+    }
 
-            if (yr_compiler_add_file(compiler, file, nullptr, nullptr) != 0) {
-                this->m_errorMessage.resize(0xFFFF);
-                yr_compiler_get_error_message(compiler, this->m_errorMessage.data(), this->m_errorMessage.size());
-                this->m_matching = false;
-                return;
+    void ViewYara::applyDataChanges() {
+        std::vector<Region> changedRegions;
+        bool rescanAll;
+
+        {
+            std::scoped_lock lock(this->m_changedRegionsMutex);
+            std::swap(changedRegions, this->m_changedRegions);
+            rescanAll = std::exchange(this->m_rescanAll, false);
+        }
+
+        if (changedRegions.empty() && !rescanAll)
+            return;
+
+        // The regions of the scope may be different for the new data, they get looked up again
+        if (rescanAll && this->m_scannedScope != ScanScope::WholeData)
+            this->m_scopeRegions = this->getScopeRegions(this->m_scannedScope);
+
+        if (rescanAll)
+            this->scanRuleFiles(this->m_scannedRules, std::nullopt);
+        else
+            this->scanRuleFiles(this->m_scannedRules, std::move(changedRegions));
+    }
+
+    /*
+        Scans the data with every rule file on as many threads as there are cores. Without changed regions the whole data gets scanned
+        and replaces all matches of a rule file. Otherwise rule files whose matches only depend on the bytes they cover just get the data
+        around the changes scanned again
+    */
+    void ViewYara::scanRuleFiles(std::vector<std::string> paths, std::optional<std::vector<Region>> changedRegions) {
+        if (this->m_scannedScope != ScanScope::WholeData) {
+            this->scanScopeRegions(std::move(paths), std::move(changedRegions));
+            return;
+        }
+
+        auto ruleFileCount = paths.size();
+
+        this->m_matchingTask = TaskManager::createTask("hex.view.yara.matching", ruleFileCount, [this, provider = ImHexApi::Provider::getHandle(), paths = std::move(paths), changedRegions = std::move(changedRegions)](Task &task) {
+            std::atomic<size_t> nextRuleFile = 0;
+
+            TaskManager::runParallel(std::min<size_t>(paths.size(), TaskManager::getWorkerCount()), [&, this](u32) {
+                for (size_t index; !task.isInterrupted() && (index = nextRuleFile++) < paths.size();) {
+                    task.update(index);
+
+                    auto ruleFile = std::filesystem::path(paths[index]).filename().string();
+                    auto compiledRules = this->getCompiledRules(paths[index]);
+
+                    auto providerSize = provider->getSize();
+
+                    auto replaceMatches = [&, this](u64 address, size_t size, std::vector<YaraMatch> &&newMatches) {
+                        // Matches touching the edges of a partial scan weren't affected by the change but may look different at a block boundary
+                        auto isInside = [&](const YaraMatch &match) {
+                            u64 start = match.address, end = match.address + match.size;
+                            return match.ruleFile == ruleFile && start >= address && end <= address + size &&
+                                   (start > address || address == 0) && (end < address + size || address + size == providerSize);
+                        };
+
+                        std::scoped_lock lock(this->m_matchesMutex);
+
+                        std::erase_if(this->m_matches, isInside);
+                        std::copy_if(newMatches.begin(), newMatches.end(), std::back_inserter(this->m_matches), isInside);
+                        this->m_matchesGeneration++;
+                    };
+
+                    if (!compiledRules.has_value())
+                        replaceMatches(0, providerSize, { });
+                    else if (!changedRegions.has_value() || !compiledRules->localMatchMargin.has_value()) {
+                        // Full scans of unchanged files with an unchanged rule file are taken from the analysis cache
+                        auto cacheEntryName = getCacheEntryName(provider.get(), paths[index], compiledRules->lastWriteTime);
+
+                        auto matches = loadCachedMatches(provider.get(), cacheEntryName, ruleFile);
+                        if (!matches.has_value()) {
+                            matches = scanRules(provider.get(), compiledRules->rules, ruleFile, 0, providerSize);
+
+                            if (!task.isInterrupted())
+                                storeMatches(provider.get(), cacheEntryName, matches.value());
+                        }
+
+                        replaceMatches(0, providerSize, std::move(matches.value()));
+                    } else {
+                        // Anything that overlaps a changed region lies completely inside of the region extended by the longest string
+                        auto margin = *compiledRules->localMatchMargin + 1;
+
+                        std::vector<std::pair<u64, u64>> windows;
+                        for (const auto &region : *changedRegions) {
+                            u64 start = region.address > margin ? region.address - margin : 0;
+                            u64 end = std::min<u64>(region.address + region.size + margin, providerSize);
+                            if (start < end)
+                                windows.emplace_back(start, end);
+                        }
+
+                        std::sort(windows.begin(), windows.end());
+                        for (size_t window = 0; window < windows.size() && !task.isInterrupted(); window++) {
+                            auto [start, end] = windows[window];
+                            while (window + 1 < windows.size() && windows[window + 1].first <= end)
+                                end = std::max(end, windows[++window].second);
+
+                            replaceMatches(start, end - start, scanRules(provider.get(), compiledRules->rules, ruleFile, start, end - start));
+                        }
+                    }
+                }
+            });
+
+            // Only scans of all of the data end up in the session, partial ones just update what's there already
+            if (!changedRegions.has_value() && !task.isInterrupted()) {
+                std::string scannedRules;
+                for (const auto &path : paths)
+                    scannedRules += path + "\n";
+
+                Session::addAnalysis(provider.get(), "yara", scannedRules);
+            }
+        });
+    }
+
+    /*
+        Scans every region of the scope on its own, as if it was all of the data, with the offsets of the matches moved back to where the region
+        lies in the data. Each pair of rule file and region gets scanned independently on as many threads as there are cores, changes only
+        get the regions they touch scanned again
+    */
+    void ViewYara::scanScopeRegions(std::vector<std::string> paths, std::optional<std::vector<Region>> changedRegions) {
+        std::vector<u32> regionIndices;
+        for (u32 i = 0; i < this->m_scopeRegions.size(); i++) {
+            const auto &region = this->m_scopeRegions[i];
+
+            bool changed = !changedRegions.has_value() || std::any_of(changedRegions->begin(), changedRegions->end(), [&](const Region &change) {
+                return change.address < region.address + region.size && change.address + change.size > region.address;
+            });
+
+            if (changed)
+                regionIndices.push_back(i);
+        }
+
+        u64 scanCount = paths.size() * regionIndices.size();
+
+        this->m_matchingTask = TaskManager::createTask("hex.view.yara.matching", scanCount, [this, provider = ImHexApi::Provider::getHandle(), paths = std::move(paths), regions = this->m_scopeRegions, regionIndices = std::move(regionIndices), scanCount, rescanAll = !changedRegions.has_value()](Task &task) {
+            // Rules get compiled up front so no rule file gets compiled by several threads at once
+            std::vector<std::optional<CompiledRules>> compiledRules(paths.size());
+            std::atomic<size_t> nextRuleFile = 0;
+
+            TaskManager::runParallel(std::min<size_t>(paths.size(), TaskManager::getWorkerCount()), [&, this](u32) {
+                for (size_t index; !task.isInterrupted() && (index = nextRuleFile++) < paths.size();)
+                    compiledRules[index] = this->getCompiledRules(paths[index]);
+            });
+
+            // The regions may have been looked up again, none of the old matches belong to them anymore
+            if (rescanAll) {
+                std::scoped_lock lock(this->m_matchesMutex);
+                this->m_matches.clear();
+                this->m_matchesGeneration++;
             }
 
-            YR_RULES *rules;
-            yr_compiler_get_rules(compiler, &rules);
+            std::atomic<u64> nextScan = 0;
 
-            auto &provider = SharedData::currentProvider;
+            TaskManager::runParallel(std::min<u64>(scanCount, TaskManager::getWorkerCount()), [&, this](u32) {
+                for (u64 scan; !task.isInterrupted() && (scan = nextScan++) < scanCount;) {
+                    task.update(scan);
 
-            std::vector<YaraMatch> newMatches;
+                    auto ruleFileIndex = scan % paths.size();
+                    auto regionIndex = regionIndices[scan / paths.size()];
+                    auto &region = regions[regionIndex];
 
-            YR_MEMORY_BLOCK_ITERATOR iterator;
+                    auto ruleFile = std::filesystem::path(paths[ruleFileIndex]).filename().string();
 
-            struct ScanContext {
-                std::vector<u8> buffer;
-                YR_MEMORY_BLOCK currBlock;
-            };
+                    std::vector<YaraMatch> matches;
+                    if (auto &rules = compiledRules[ruleFileIndex]; rules.has_value())
+                        matches = scanRules(provider.get(), rules->rules, ruleFile, region.address, region.size, regionIndex);
 
-            ScanContext context;
-            context.currBlock.base = 0;
-            context.currBlock.fetch_data = [](auto *block) -> const u8* {
-                auto &context = *static_cast<ScanContext*>(block->context);
+                    if (task.isInterrupted())
+                        break;
 
-                auto &provider = SharedData::currentProvider;
+                    std::scoped_lock lock(this->m_matchesMutex);
 
-                context.buffer.resize(std::min<u64>(0xF'FFFF, provider->getSize() - context.currBlock.base));
+                    std::erase_if(this->m_matches, [&](const YaraMatch &match) { return match.ruleFile == ruleFile && match.scopeRegion == regionIndex; });
+                    std::move(matches.begin(), matches.end(), std::back_inserter(this->m_matches));
+                    this->m_matchesGeneration++;
+                }
+            });
+        });
+    }
 
-                if (context.buffer.empty()) return nullptr;
+    std::vector<Region> ViewYara::getScopeRegions(ScanScope scope) const {
+        auto provider = SharedData::currentProvider;
+        if (provider == nullptr)
+            return { };
+
+        // Bookmarks and patterns include the base address, the scans work on offsets into the current page
+        u64 baseAddress = provider->getBaseAddress();
+        std::vector<Region> regions;
+
+        auto addRegion = [&](u64 address, size_t size) {
+            if (address >= baseAddress)
+                regions.push_back({ address - baseAddress, size });
+        };
+
+        switch (scope) {
+            case ScanScope::WholeData:
+                break;
+            case ScanScope::Selection:
+                regions.push_back(this->m_selection);
+                break;
+            case ScanScope::Bookmarks:
+                for (const auto &bookmark : ImHexApi::Bookmarks::getEntries())
+                    addRegion(bookmark.region.address, bookmark.region.size);
+                break;
+            case ScanScope::Patterns:
+                // Each entry of an array gets scanned on its own, the same way arrays get hashed in batches
+                for (const auto &pattern : this->m_patternData) {
+                    if (auto array = dynamic_cast<lang::PatternDataArray*>(pattern); array != nullptr) {
+                        for (const auto &entry : array->getEntries())
+                            addRegion(entry->getOffset(), entry->getSize());
+                    } else if (auto staticArray = dynamic_cast<lang::PatternDataStaticArray*>(pattern); staticArray != nullptr) {
+                        auto entrySize = staticArray->getTemplate()->getSize();
+                        for (u64 i = 0; i < staticArray->getEntryCount(); i++)
+                            addRegion(staticArray->getOffset() + i * entrySize, entrySize);
+                    } else {
+                        addRegion(pattern->getOffset(), pattern->getSize());
+                    }
+                }
+                break;
+        }
 
-                provider->read(context.currBlock.base, context.buffer.data(), context.buffer.size());
+        // Only the part of a region that lies inside of the page gets scanned
+        u64 dataSize = provider->getSize();
+        std::erase_if(regions, [dataSize](const Region &region) { return region.size == 0 || region.address >= dataSize; });
+        for (auto &region : regions)
+            region.size = std::min<u64>(region.size, dataSize - region.address);
 
-                return context.buffer.data();
-            };
-            iterator.file_size = [](auto *iterator) -> u64 {
-                return SharedData::currentProvider->getSize();
-            };
+        return regions;
+    }
 
-            iterator.context = &context;
-            iterator.first = [](YR_MEMORY_BLOCK_ITERATOR* iterator) -> YR_MEMORY_BLOCK* {
-                auto &context = *static_cast<ScanContext*>(iterator->context);
+    /* Matches are page relative, so every page gets its own entry */
+    std::string ViewYara::getCacheEntryName(prv::Provider *provider, const std::string &rulePath, std::filesystem::file_time_type lastWriteTime) {
+        crypt::Crc<u32> crc(0xEDB8'8320, 0xFFFF'FFFF);
+        crc.process(reinterpret_cast<const u8*>(rulePath.data()), rulePath.size());
 
-                context.currBlock.base = 0;
-                context.currBlock.size = 0;
-                context.buffer.clear();
-                iterator->last_error = ERROR_SUCCESS;
+        return hex::format("yara.{:08X}.{:X}.{}", crc.getValue(), u64(lastWriteTime.time_since_epoch().count()), provider->getCurrentPage());
+    }
 
-                return iterator->next(iterator);
-            };
-            iterator.next = [](YR_MEMORY_BLOCK_ITERATOR* iterator) -> YR_MEMORY_BLOCK* {
-                auto &context = *static_cast<ScanContext*>(iterator->context);
+    std::optional<std::vector<ViewYara::YaraMatch>> ViewYara::loadCachedMatches(prv::Provider *provider, const std::string &entryName, const std::string &ruleFile) {
+        auto reader = AnalysisCache::load(provider, entryName);
+        if (!reader.has_value())
+            return { };
 
-                u64 address = context.currBlock.base + context.currBlock.size;
+        u64 count;
+        if (!reader->read(count))
+            return { };
 
-                iterator->last_error = ERROR_SUCCESS;
-                context.currBlock.base = address;
-                context.currBlock.size = std::min<u64>(0xF'FFFF, SharedData::currentProvider->getSize() - address);
-                context.currBlock.context = &context;
+        std::vector<YaraMatch> matches;
+        for (u64 i = 0; i < count; i++) {
+            YaraMatch match = { "", ruleFile, 0, 0, false };
+            if (!reader->readString(match.identifier) || !reader->read(match.address) || !reader->read(match.size) || !reader->read(match.wholeDataMatch))
+                return { };
 
-                if (context.currBlock.size == 0) return nullptr;
+            matches.push_back(std::move(match));
+        }
 
-                return &context.currBlock;
-            };
+        return matches;
+    }
 
+    void ViewYara::storeMatches(prv::Provider *provider, const std::string &entryName, const std::vector<YaraMatch> &matches) {
+        AnalysisCache::Writer writer;
 
-            yr_rules_scan_mem_blocks(rules, &iterator, 0, [](YR_SCAN_CONTEXT* context, int message, void *data, void *userData) -> int {
-                if (message == CALLBACK_MSG_RULE_MATCHING) {
-                    auto &newMatches = *static_cast<std::vector<YaraMatch>*>(userData);
-                    auto rule  = static_cast<YR_RULE*>(data);
+        writer.write<u64>(matches.size());
+        for (const auto &match : matches) {
+            writer.writeString(match.identifier);
+            writer.write(match.address);
+            writer.write(match.size);
+            writer.write(match.wholeDataMatch);
+        }
 
-                    YR_STRING *string;
-                    YR_MATCH *match;
+        AnalysisCache::store(provider, entryName, writer);
+    }
 
-                    if (rule->strings != nullptr) {
-                        yr_rule_strings_foreach(rule, string) {
-                            yr_string_matches_foreach(context, string, match) {
-                                newMatches.push_back({ rule->identifier, match->offset, match->match_length, false });
-                            }
+    /*
+        Scans the part of the data with the rules. Parts of a scan over all of the data are scanned at their offsets, scope regions are scanned
+        as if they were all of the data, starting at offset 0 and as large as the region. Their matches get moved back to the region's offset
+    */
+    std::vector<ViewYara::YaraMatch> ViewYara::scanRules(prv::Provider *provider, YR_RULES *rules, const std::string &ruleFile, u64 address, size_t size, std::optional<u32> scopeRegion) {
+        struct ScanContext {
+            prv::Provider *provider;
+            std::vector<u8> buffer;
+            YR_MEMORY_BLOCK currBlock;
+            u64 start, end;
+            u64 dataOffset;
+            std::optional<u32> scopeRegion;
+            const std::string *ruleFile;
+            std::vector<YaraMatch> matches;
+        };
+
+        ScanContext context;
+        context.provider = provider;
+        context.dataOffset = scopeRegion.has_value() ? address : 0;
+        context.start = address - context.dataOffset;
+        context.end = address + size - context.dataOffset;
+        context.scopeRegion = scopeRegion;
+        context.ruleFile = &ruleFile;
+
+        YR_SCANNER *scanner = nullptr;
+        if (yr_scanner_create(rules, &scanner) != ERROR_SUCCESS)
+            return { };
+        SCOPE_EXIT( yr_scanner_destroy(scanner); );
+
+        // Yara scans page relative addresses while access hints take absolute ones
+        u64 scanStart = u64(provider->getCurrentPage()) * prv::Provider::PageSize + address;
+        provider->adviseAccess(scanStart, size, prv::Provider::AccessHint::Sequential);
+        SCOPE_EXIT( provider->adviseAccess(scanStart, size, prv::Provider::AccessHint::Normal); );
+
+        YR_MEMORY_BLOCK_ITERATOR iterator;
+
+        context.currBlock.base = context.start;
+        context.currBlock.fetch_data = [](auto *block) -> const u8* {
+            auto &context = *static_cast<ScanContext*>(block->context);
+            auto provider = context.provider;
+
+            size_t size = std::min<u64>(0xF'FFFF, context.end - context.currBlock.base);
+            if (size == 0) return nullptr;
+
+            u64 offset = context.dataOffset + context.currBlock.base;
+
+            // Hand mapped data to yara directly instead of copying it first
+            if (auto view = provider->getDirectView(offset, size); view.has_value())
+                return view->data();
+
+            context.buffer.resize(size);
+            provider->read(offset, context.buffer.data(), context.buffer.size());
+
+            return context.buffer.data();
+        };
+        iterator.file_size = [](auto *iterator) -> u64 {
+            auto &context = *static_cast<ScanContext*>(iterator->context);
+            return context.scopeRegion.has_value() ? context.end : context.provider->getSize();
+        };
+
+        iterator.context = &context;
+        iterator.first = [](YR_MEMORY_BLOCK_ITERATOR* iterator) -> YR_MEMORY_BLOCK* {
+            auto &context = *static_cast<ScanContext*>(iterator->context);
+
+            context.currBlock.base = context.start;
+            context.currBlock.size = 0;
+            context.buffer.clear();
+            iterator->last_error = ERROR_SUCCESS;
+
+            return iterator->next(iterator);
+        };
+        iterator.next = [](YR_MEMORY_BLOCK_ITERATOR* iterator) -> YR_MEMORY_BLOCK* {
+            auto &context = *static_cast<ScanContext*>(iterator->context);
+
+            u64 address = context.currBlock.base + context.currBlock.size;
+
+            iterator->last_error = ERROR_SUCCESS;
+            context.currBlock.base = address;
+            context.currBlock.size = std::min<u64>(0xF'FFFF, context.end - address);
+            context.currBlock.context = &context;
+
+            if (context.currBlock.size == 0) return nullptr;
+
+            return &context.currBlock;
+        };
+
+        yr_scanner_set_callback(scanner, [](YR_SCAN_CONTEXT* context, int message, void *data, void *userData) -> int {
+            if (message == CALLBACK_MSG_RULE_MATCHING) {
+                auto &scanContext = *static_cast<ScanContext*>(userData);
+                auto rule  = static_cast<YR_RULE*>(data);
+
+                YR_STRING *string;
+                YR_MATCH *match;
+
+                if (rule->strings != nullptr) {
+                    yr_rule_strings_foreach(rule, string) {
+                        yr_string_matches_foreach(context, string, match) {
+                            scanContext.matches.push_back({ rule->identifier, *scanContext.ruleFile, s64(scanContext.dataOffset + match->offset), match->match_length, false, scanContext.scopeRegion });
                         }
-                    } else {
-                        newMatches.push_back({ rule->identifier, 0, 0, true });
                     }
+                } else if (scanContext.scopeRegion.has_value()) {
+                    // Rules without strings match all of the data they're scanned over, which is just the region here
+                    scanContext.matches.push_back({ rule->identifier, *scanContext.ruleFile, s64(scanContext.dataOffset), s32(scanContext.end), false, scanContext.scopeRegion });
+                } else {
+                    scanContext.matches.push_back({ rule->identifier, *scanContext.ruleFile, 0, 0, true });
+                }
+
+            }
+
+            return CALLBACK_CONTINUE;
+        }, &context);
 
+        yr_scanner_scan_mem_blocks(scanner, &iterator);
+
+        return std::move(context.matches);
+    }
+
+    /*
+        Returns the compiled rules of a rule file, compiling them only if they haven't been used before or the file changed since.
+        Compiled rules also get saved next to the rule files so they don't need to be compiled again after a restart
+    */
+    std::optional<ViewYara::CompiledRules> ViewYara::getCompiledRules(const std::string &path) {
+        std::error_code error;
+        auto lastWriteTime = std::filesystem::last_write_time(path, error);
+
+        {
+            std::scoped_lock lock(this->m_compiledRulesMutex);
+
+            if (auto it = this->m_compiledRules.find(path); it != this->m_compiledRules.end()) {
+                if (!error && it->second.lastWriteTime == lastWriteTime)
+                    return it->second;
+
+                yr_rules_destroy(it->second.rules);
+                this->m_compiledRules.erase(it);
+            }
+        }
+
+        auto compiledPath = std::filesystem::path("yara") / "compiled" / (std::filesystem::path(path).filename().string() + ".yarc");
+
+        YR_RULES *rules = nullptr;
+
+        std::error_code compiledError;
+        auto compiledWriteTime = std::filesystem::last_write_time(compiledPath, compiledError);
+        if (!error && !compiledError && compiledWriteTime >= lastWriteTime) {
+            if (yr_rules_load(compiledPath.string().c_str(), &rules) != ERROR_SUCCESS)
+                rules = nullptr;
+        }
+
+        if (rules == nullptr) {
+            YR_COMPILER *compiler = nullptr;
+            if (yr_compiler_create(&compiler) != ERROR_SUCCESS)
+                return { };
+            SCOPE_EXIT( yr_compiler_destroy(compiler); );
+
+            FILE *file = fopen(path.c_str(), "r");
+            if (file == nullptr) return { };
+            SCOPE_EXIT( fclose(file); );
+
+            if (yr_compiler_add_file(compiler, file, nullptr, nullptr) != 0) {
+                std::vector<char> errorMessage(0xFFFF);
+                yr_compiler_get_error_message(compiler, errorMessage.data(), errorMessage.size());
+
+                // Only the first error gets reported if several rule files fail to compile
+                std::scoped_lock lock(this->m_compiledRulesMutex);
+                if (this->m_errorMessage.empty()) {
+                    auto message = hex::format("{0}: {1}", std::filesystem::path(path).filename().string(), errorMessage.data());
+                    this->m_errorMessage.assign(message.c_str(), message.c_str() + message.size() + 1);
                 }
 
-                return CALLBACK_CONTINUE;
-            }, &newMatches, 0);
+                return { };
+            }
 
-            std::copy(newMatches.begin(), newMatches.end(), std::back_inserter(this->m_matches));
+            if (yr_compiler_get_rules(compiler, &rules) != ERROR_SUCCESS)
+                return { };
 
-            yr_compiler_destroy(compiler);
+            // Failing to save the compiled rules only means they'll get compiled again next time
+            std::filesystem::create_directories(compiledPath.parent_path(), compiledError);
+            if (!compiledError)
+                yr_rules_save(rules, compiledPath.string().c_str());
+        }
 
-            this->m_matching = false;
-        }).detach();
+        std::string source;
+        if (std::ifstream file(path); file.good())
+            source.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
 
+        std::scoped_lock lock(this->m_compiledRulesMutex);
+        return this->m_compiledRules[path] = { lastWriteTime, rules, getLocalMatchMargin(source) };
     }
 
 }
\ No newline at end of file
@@ -2,7 +2,13 @@
 
 #include <hex.hpp>
 #include <hex/api/content_registry.hpp>
+#include <hex/api/task.hpp>
+#include <hex/helpers/memory_budget.hpp>
+#include <hex/helpers/profiler.hpp>
+#include <hex/helpers/tracing.hpp>
+#include <hex/providers/provider.hpp>
 
+#include <algorithm>
 #include <iostream>
 #include <numeric>
 #include <typeinfo>
@@ -19,13 +25,19 @@
 
 #include <fontawesome_font.h>
 
+#include "helpers/font_atlas_cache.hpp"
 #include "helpers/plugin_handler.hpp"
+#include "helpers/project_file_handler.hpp"
+#include "helpers/session.hpp"
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
 namespace hex {
 
+    // Defined in allocation_counter.cpp
+    u64 getAllocationCount();
+
     void *ImHexSettingsHandler_ReadOpenFn(ImGuiContext *ctx, ImGuiSettingsHandler *, const char *) {
         return ctx; // Unused, but the return value has to be non-null
     }
@@ -49,12 +61,19 @@ namespace hex {
         buf->append("\n");
     }
 
-    Window::Window(int &argc, char **&argv) {
+    Window::Window(int &argc, char **&argv, bool offscreen) : m_offscreen(offscreen) {
+        Tracing::setThreadName("Main");
+
         hex::SharedData::mainArgc = argc;
         hex::SharedData::mainArgv = argv;
 
         this->createDirectories();
-        this->initGLFW();
+
+        {
+            PROFILE_STARTUP("GLFW");
+            this->initGLFW();
+        }
+
         this->initImGui();
 
         EventManager::subscribe(Events::SettingsChanged, this, [](auto) -> std::any {
@@ -91,12 +110,21 @@ namespace hex {
                     LangEntry::loadLanguage(static_cast<std::string>(language.value()));
             }
 
+            MemoryBudget::setLimit(size_t(ContentRegistry::Settings::read("hex.builtin.setting.imhex", "hex.builtin.setting.imhex.memory_budget", 2048)) * 0x10'0000);
+
             return { };
         });
 
         EventManager::subscribe(Events::FileLoaded, this, [this](auto userData) -> std::any {
             auto path = std::any_cast<std::string>(userData);
 
+            // Files opened by a benchmark aren't what the user worked on last
+            if (!this->m_offscreen)
+                Session::setFile(SharedData::currentProvider, path, ProjectFile::getProjectFilePath());
+
+            if (path.empty())
+                return { };
+
             this->m_recentFiles.push_front(path);
 
             {
@@ -128,47 +156,80 @@ namespace hex {
             return { };
         });
 
+        EventManager::subscribe(Events::ProviderClosed, this, [](auto userData) -> std::any {
+            Session::closeProvider(std::any_cast<prv::Provider*>(userData));
+
+            return { };
+        });
+
         EventManager::subscribe(Events::CloseImHex, this, [this](auto) -> std::any {
             glfwSetWindowShouldClose(this->m_window, true);
 
             return { };
         });
 
-        this->initPlugins();
+        {
+            PROFILE_STARTUP("Plugins");
+            this->initPlugins();
+        }
 
-        ContentRegistry::Settings::load();
-        View::postEvent(Events::SettingsChanged);
+        {
+            PROFILE_STARTUP("Settings");
+            if (!this->m_offscreen)
+                ContentRegistry::Settings::load();
+            View::postEvent(Events::SettingsChanged);
+        }
 
         for (const auto &path : ContentRegistry::Settings::read("hex.builtin.setting.imhex", "hex.builtin.setting.imhex.recent_files"))
             this->m_recentFiles.push_back(path);
     }
 
     Window::~Window() {
+        // Tasks may be running code of plugins that are about to be unloaded
+        TaskManager::interruptAndWaitForAll();
+
         this->deinitImGui();
         this->deinitGLFW();
-        ContentRegistry::Settings::store();
+        if (!this->m_offscreen)
+            ContentRegistry::Settings::store();
 
         this->deinitPlugins();
 
         EventManager::unsubscribe(Events::SettingsChanged, this);
         EventManager::unsubscribe(Events::FileLoaded, this);
+        EventManager::unsubscribe(Events::ProviderClosed, this);
         EventManager::unsubscribe(Events::CloseImHex, this);
     }
 
     void Window::loop() {
-        while (!glfwWindowShouldClose(this->m_window)) {
-            this->frameBegin();
+        while (!glfwWindowShouldClose(this->m_window))
+            this->frame();
+    }
+
+    void Window::frame() {
+        TRACE_SCOPE("Frame", "frame");
+
+        this->frameBegin();
+
+        for (const auto &call : View::getDeferedCalls())
+            call();
+        View::getDeferedCalls().clear();
+
+        EventManager::deliverCoalesced();
+        if (!this->m_offscreen)
+            ContentRegistry::Settings::storePending();
 
-            for (const auto &call : View::getDeferedCalls())
-                call();
-            View::getDeferedCalls().clear();
+        Profiler::setEnabled(this->m_profilerVisible);
+        prv::IOStatistics::setEnabled(this->m_profilerVisible);
 
-            for (auto &view : ContentRegistry::Views::getEntries()) {
-                view->drawAlwaysVisible();
+        for (auto &view : ContentRegistry::Views::getEntries()) {
+            PROFILE_SCOPE(view->getUnlocalizedName());
+            TRACE_SCOPE(view->getUnlocalizedName(), "view");
+            prv::IOStatistics::Scope ioScope(prv::IOStatistics::isEnabled() ? prv::IOStatistics::getTag(view->getUnlocalizedName()) : prv::IOStatistics::UntaggedTag);
 
-                if (!view->shouldProcess())
-                    continue;
+            view->drawAlwaysVisible();
 
+            if (view->shouldProcess()) {
                 auto minSize = view->getMinSize();
                 minSize.x *= this->m_globalScale;
                 minSize.y *= this->m_globalScale;
@@ -177,19 +238,273 @@ namespace hex {
                 view->drawContent();
             }
 
-            View::drawCommonInterfaces();
+            view->updateVisibility();
+        }
+
+        View::drawCommonInterfaces();
+
+        if (this->m_profilerVisible)
+            this->drawProfiler();
+
+        MemoryBudget::enforce();
+
+        #ifdef DEBUG
+            if (this->m_demoWindowOpen) {
+                ImGui::ShowDemoWindow(&this->m_demoWindowOpen);
+                ImPlot::ShowDemoWindow(&this->m_demoWindowOpen);
+            }
+        #endif
+
+        if (this->hasActivity())
+            this->m_framesToRender = ActiveFrameCount;
+        else if (this->m_framesToRender > 0)
+            this->m_framesToRender--;
+
+        Profiler::nextFrame();
+
+        this->frameEnd();
+    }
+
+    bool Window::hasActivity() {
+        auto &io = ImGui::GetIO();
+
+        if (SharedData::redrawRequested.exchange(false))
+            return true;
+
+        if (!View::getDeferedCalls().empty() || !SharedData::coalescedEvents.empty() || ContentRegistry::Settings::hasPendingStore())
+            return true;
+
+        if (io.MouseDelta.x != 0 || io.MouseDelta.y != 0 || io.MouseWheel != 0 || io.MouseWheelH != 0 || ImGui::IsAnyMouseDown())
+            return true;
+
+        if (!io.InputQueueCharacters.empty() || std::any_of(std::begin(io.KeysDown), std::end(io.KeysDown), [](bool down) { return down; }))
+            return true;
+
+        // Active widgets like text fields have a blinking cursor, spinners show that background tasks are still running
+        return ImGui::IsAnyItemActive() || ImGui::IsAnimationActive() || Profiler::isEnabled();
+    }
+
+    void Window::drawProfiler() {
+        ImGui::SetNextWindowSize(ImVec2(700, 450) * this->m_globalScale, ImGuiCond_FirstUseEver);
+        if (ImGui::Begin("hex.profiler.title"_lang, &this->m_profilerVisible)) {
+            if (ImGui::BeginTabBar("##profilerTabs")) {
+                if (ImGui::BeginTabItem("hex.profiler.sections"_lang)) {
+                    const auto &sections = Profiler::getSections();
+
+                    double highestTime = 0;
+                    for (const auto &[name, section] : sections)
+                        for (const auto &counters : section.history)
+                            highestTime = std::max(highestTime, counters.time);
+
+                    ImPlot::SetNextPlotLimits(0, Profiler::HistorySize, 0, std::max(highestTime * 1.1, 1.0), ImGuiCond_Always);
+                    if (ImPlot::BeginPlot("##profiler", nullptr, "ms", ImVec2(-1, 200 * this->m_globalScale), ImPlotFlags_NoMenus | ImPlotFlags_NoBoxSelect, ImPlotAxisFlags_Lock | ImPlotAxisFlags_NoTickLabels, ImPlotAxisFlags_Lock)) {
+                        // The histories are ring buffers, the offset makes the plot start with the oldest frame
+                        for (const auto &[name, section] : sections)
+                            ImPlot::PlotLine(LangEntry(name), &section.history[0].time, Profiler::HistorySize, 1, 0, Profiler::getHistoryOffset(), sizeof(Profiler::Counters));
+
+                        ImPlot::EndPlot();
+                    }
+
+                    if (ImGui::BeginTable("##sections", 6, ImGuiTableFlags_Borders | ImGuiTableFlags_Resizable | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY)) {
+                        ImGui::TableSetupScrollFreeze(0, 1);
+                        ImGui::TableSetupColumn("hex.profiler.section"_lang);
+                        ImGui::TableSetupColumn("hex.profiler.time"_lang);
+                        ImGui::TableSetupColumn("hex.profiler.peak"_lang);
+                        ImGui::TableSetupColumn("hex.profiler.allocations"_lang);
+                        ImGui::TableSetupColumn("hex.profiler.reads"_lang);
+                        ImGui::TableSetupColumn("hex.profiler.read_bytes"_lang);
+                        ImGui::TableHeadersRow();
+
+                        for (const auto &[name, section] : sections) {
+                            Profiler::Counters average;
+                            double peakTime = 0;
+                            for (const auto &counters : section.history) {
+                                average.time += counters.time;
+                                average.allocations += counters.allocations;
+                                average.readCalls += counters.readCalls;
+                                average.readBytes += counters.readBytes;
+                                peakTime = std::max(peakTime, counters.time);
+                            }
+
+                            ImGui::TableNextRow();
+                            ImGui::TableNextColumn();
+                            ImGui::TextUnformatted(LangEntry(name));
+                            ImGui::TableNextColumn();
+                            ImGui::Text("%.3f ms", average.time / Profiler::HistorySize);
+                            ImGui::TableNextColumn();
+                            ImGui::Text("%.3f ms", peakTime);
+                            ImGui::TableNextColumn();
+                            ImGui::Text("%.1f", average.allocations / Profiler::HistorySize);
+                            ImGui::TableNextColumn();
+                            ImGui::Text("%.1f", average.readCalls / Profiler::HistorySize);
+                            ImGui::TableNextColumn();
+                            ImGui::TextUnformatted(hex::toByteString(u64(average.readBytes / Profiler::HistorySize)).c_str());
+                        }
+
+                        ImGui::EndTable();
+                    }
+                    ImGui::EndTabItem();
+                }
+
+                if (ImGui::BeginTabItem("hex.profiler.memory"_lang)) {
+                    this->drawMemoryUsage();
+                    ImGui::EndTabItem();
+                }
 
-            #ifdef DEBUG
-                if (this->m_demoWindowOpen) {
-                    ImGui::ShowDemoWindow(&this->m_demoWindowOpen);
-                    ImPlot::ShowDemoWindow(&this->m_demoWindowOpen);
+                if (ImGui::BeginTabItem("hex.profiler.io"_lang)) {
+                    this->drawIOStatistics();
+                    ImGui::EndTabItem();
                 }
-            #endif
 
-            this->frameEnd();
+                if (ImGui::BeginTabItem("hex.profiler.trace"_lang)) {
+                    this->drawTracing();
+                    ImGui::EndTabItem();
+                }
+
+                ImGui::EndTabBar();
+            }
+        }
+        ImGui::End();
+    }
+
+    void Window::drawMemoryUsage() {
+        ImGui::TextUnformatted(hex::format("hex.profiler.memory.total"_lang, hex::toByteString(MemoryBudget::getTotalUsage()), hex::toByteString(MemoryBudget::getLimit())).c_str());
+
+        if (ImGui::BeginTable("##memory", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_Resizable | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY)) {
+            ImGui::TableSetupScrollFreeze(0, 1);
+            ImGui::TableSetupColumn("hex.profiler.memory.subsystem"_lang);
+            ImGui::TableSetupColumn("hex.profiler.memory.caches"_lang);
+            ImGui::TableSetupColumn("hex.profiler.memory.usage"_lang);
+            ImGui::TableSetupColumn("hex.profiler.memory.evicted"_lang);
+            ImGui::TableHeadersRow();
+
+            for (const auto &usage : MemoryBudget::getUsage()) {
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(LangEntry(usage.subsystem));
+                ImGui::TableNextColumn();
+                ImGui::Text("%u", usage.caches);
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(hex::toByteString(usage.usage).c_str());
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(hex::toByteString(usage.evicted).c_str());
+            }
+
+            ImGui::EndTable();
+        }
+    }
+
+    void Window::drawTracing() {
+        ImGui::TextUnformatted("hex.profiler.trace.description"_lang);
+
+        bool enabled = Tracing::isEnabled();
+        if (ImGui::Checkbox("hex.profiler.trace.record"_lang, &enabled))
+            Tracing::setEnabled(enabled);
+
+        ImGui::TextUnformatted(hex::format("hex.profiler.trace.events"_lang, Tracing::getEventCount()).c_str());
+
+        if (ImGui::Button("hex.profiler.trace.export"_lang)) {
+            View::openFileBrowser("hex.profiler.trace.export"_lang, View::DialogMode::Save, { { "Chrome Trace", "json" } }, [](auto path) {
+                if (!Tracing::exportTrace(path))
+                    View::showErrorPopup("hex.profiler.trace.export_error"_lang);
+            });
         }
     }
 
+    void Window::drawIOStatistics() {
+        auto provider = SharedData::currentProvider;
+        if (provider == nullptr)
+            return;
+
+        auto &statistics = provider->getIOStatistics();
+
+        ImGui::TextUnformatted("hex.profiler.io.description"_lang);
+        ImGui::SameLine();
+        if (ImGui::Button("hex.profiler.io.reset"_lang))
+            statistics.reset();
+
+        if (ImGui::BeginTable("##io", 9, ImGuiTableFlags_Borders | ImGuiTableFlags_Resizable | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY | ImGuiTableFlags_ScrollX)) {
+            ImGui::TableSetupScrollFreeze(1, 1);
+            ImGui::TableSetupColumn("hex.profiler.io.cause"_lang);
+            ImGui::TableSetupColumn("hex.profiler.io.reads"_lang);
+            ImGui::TableSetupColumn("hex.profiler.io.read_bytes"_lang);
+            ImGui::TableSetupColumn("hex.profiler.io.patch_hits"_lang);
+            ImGui::TableSetupColumn("hex.profiler.io.cache_hits"_lang);
+            ImGui::TableSetupColumn("hex.profiler.io.cache_misses"_lang);
+            ImGui::TableSetupColumn("hex.profiler.io.raw_reads"_lang);
+            ImGui::TableSetupColumn("hex.profiler.io.raw_read_bytes"_lang);
+            ImGui::TableSetupColumn("hex.profiler.io.raw_read_time"_lang);
+            ImGui::TableHeadersRow();
+
+            for (const auto &[tag, counters] : statistics.getCounters()) {
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(LangEntry(tag.empty() ? "hex.profiler.io.untagged" : tag));
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(hex::format("{}", counters.readCalls).c_str());
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(hex::toByteString(counters.bytesRead).c_str());
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(hex::format("{}", counters.patchHits).c_str());
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(hex::format("{}", counters.cacheHits).c_str());
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(hex::format("{}", counters.cacheMisses).c_str());
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(hex::format("{}", counters.rawReadCalls).c_str());
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(hex::toByteString(counters.rawBytesRead).c_str());
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f ms", counters.rawReadTime / 1'000'000.0);
+            }
+
+            ImGui::EndTable();
+        }
+    }
+
+    namespace {
+
+        /* The scripts most text is in come first, the huge CJK ranges only get added by a later build */
+        ImVector<ImWchar> getGlyphRanges(ImFontAtlas *atlas, bool includeCJK) {
+            ImVector<ImWchar> ranges;
+            ImFontGlyphRangesBuilder glyphRangesBuilder;
+
+            glyphRangesBuilder.AddRanges(atlas->GetGlyphRangesDefault());
+            glyphRangesBuilder.AddRanges(atlas->GetGlyphRangesCyrillic());
+            glyphRangesBuilder.AddRanges(atlas->GetGlyphRangesThai());
+            glyphRangesBuilder.AddRanges(atlas->GetGlyphRangesVietnamese());
+
+            if (includeCJK) {
+                glyphRangesBuilder.AddRanges(atlas->GetGlyphRangesJapanese());
+                glyphRangesBuilder.AddRanges(atlas->GetGlyphRangesChineseFull());
+                glyphRangesBuilder.AddRanges(atlas->GetGlyphRangesKorean());
+            }
+
+            glyphRangesBuilder.BuildRanges(&ranges);
+
+            return ranges;
+        }
+
+        void buildFontAtlas(ImFontAtlas *atlas, const std::filesystem::path &path, float fontScale, const ImVector<ImWchar> &ranges) {
+            ImWchar fontAwesomeRange[] = {
+                    ICON_MIN_FA, ICON_MAX_FA,
+                    0
+            };
+
+            ImFontConfig cfg;
+            cfg.OversampleH = cfg.OversampleV = 1, cfg.PixelSnapH = true;
+            cfg.SizePixels = 13.0f * fontScale;
+
+            atlas->AddFontFromFileTTF(path.string().c_str(), std::floor(14.0f * fontScale), &cfg, ranges.Data); // Needs conversion to char for Windows
+            cfg.MergeMode = true;
+
+            atlas->AddFontFromMemoryCompressedTTF(font_awesome_compressed_data, font_awesome_compressed_size, 13.0f * fontScale, &cfg, fontAwesomeRange);
+
+            ImGuiFreeType::BuildFontAtlas(atlas, ImGuiFreeType::Monochrome);
+        }
+
+    }
+
     bool Window::setFont(const std::filesystem::path &path) {
         if (!std::filesystem::exists(path))
             return false;
@@ -199,37 +514,47 @@ namespace hex {
         // If we have a custom font, then rescaling is unnecessary and will make it blurry
         io.FontGlobalScale = 1.0f;
 
-        // Load font data & build atlas
-        std::uint8_t *px;
-        int w, h;
+        // Load font data & build atlas. Rasterizing all CJK glyphs takes a while, so an atlas built in an earlier run gets used if there is one
+        auto fullRanges = getGlyphRanges(io.Fonts, true);
+        auto fullKey = FontAtlasCache::getKey(path, this->m_fontScale, fullRanges);
 
-        ImVector<ImWchar> ranges;
-        ImFontGlyphRangesBuilder glyphRangesBuilder;
+        auto cached = FontAtlasCache::load(fullKey);
+        if (!cached.has_value() || !FontAtlasCache::deserialize(io.Fonts, cached.value())) {
+            auto baseRanges = getGlyphRanges(io.Fonts, false);
+            auto baseKey = FontAtlasCache::getKey(path, this->m_fontScale, baseRanges);
 
-        glyphRangesBuilder.AddRanges(io.Fonts->GetGlyphRangesDefault());
-        glyphRangesBuilder.AddRanges(io.Fonts->GetGlyphRangesJapanese());
-        glyphRangesBuilder.AddRanges(io.Fonts->GetGlyphRangesChineseFull());
-        glyphRangesBuilder.AddRanges(io.Fonts->GetGlyphRangesCyrillic());
-        glyphRangesBuilder.AddRanges(io.Fonts->GetGlyphRangesKorean());
-        glyphRangesBuilder.AddRanges(io.Fonts->GetGlyphRangesThai());
-        glyphRangesBuilder.AddRanges(io.Fonts->GetGlyphRangesVietnamese());
-        glyphRangesBuilder.BuildRanges(&ranges);
+            cached = FontAtlasCache::load(baseKey);
+            if (!cached.has_value() || !FontAtlasCache::deserialize(io.Fonts, cached.value())) {
+                buildFontAtlas(io.Fonts, path, this->m_fontScale, baseRanges);
+                FontAtlasCache::store(baseKey, FontAtlasCache::serialize(io.Fonts));
+            }
+
+            // The full atlas gets built in the background and replaces the current one once it's done
+            this->m_fontAtlasTask = TaskManager::createTask("hex.common.font_atlas.building", 0, [this, path, fullRanges, fullKey, fontScale = this->m_fontScale](Task &task) {
+                ImFontAtlas atlas;
+                buildFontAtlas(&atlas, path, fontScale, fullRanges);
+
+                if (task.isInterrupted())
+                    return;
 
-        ImWchar fontAwesomeRange[] = {
-                ICON_MIN_FA, ICON_MAX_FA,
-                0
-        };
+                auto writer = FontAtlasCache::serialize(&atlas);
+                FontAtlasCache::store(fullKey, writer);
+
+                std::scoped_lock lock(this->m_fontAtlasMutex);
+                this->m_pendingFontAtlas = writer.getData();
+            });
+        }
 
-        ImFontConfig cfg;
-        cfg.OversampleH = cfg.OversampleV = 1, cfg.PixelSnapH = true;
-        cfg.SizePixels = 13.0f * this->m_fontScale;
+        this->uploadFontAtlas();
 
-        io.Fonts->AddFontFromFileTTF(path.string().c_str(), std::floor(14.0f * this->m_fontScale), &cfg, ranges.Data); // Needs conversion to char for Windows
-        cfg.MergeMode = true;
+        return true;
+    }
 
-        io.Fonts->AddFontFromMemoryCompressedTTF(font_awesome_compressed_data, font_awesome_compressed_size, 13.0f * this->m_fontScale, &cfg, fontAwesomeRange);
+    void Window::uploadFontAtlas() {
+        auto &io = ImGui::GetIO();
 
-        ImGuiFreeType::BuildFontAtlas(io.Fonts, ImGuiFreeType::Monochrome);
+        std::uint8_t *px;
+        int w, h;
         io.Fonts->GetTexDataAsRGBA32(&px, &w, &h);
 
         // Create new font atlas
@@ -240,15 +565,44 @@ namespace hex {
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
         glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, w, h, 0, GL_RGBA8, GL_UNSIGNED_INT, px);
         io.Fonts->SetTexID(reinterpret_cast<ImTextureID>(tex));
+    }
 
-        return true;
+    void Window::swapFontAtlas() {
+        std::optional<std::vector<u8>> pending;
+        {
+            std::scoped_lock lock(this->m_fontAtlasMutex);
+            std::swap(pending, this->m_pendingFontAtlas);
+        }
+
+        if (!pending.has_value())
+            return;
+
+        // Has to happen between frames, nothing may still point at the old fonts
+        // Has to happen between frames, nothing may still point at the old fonts. Broken data leaves the atlas empty and ImGui falls back to its default font
+        AnalysisCache::Reader reader(std::move(pending.value()));
+        ImGui_ImplOpenGL3_DestroyFontsTexture();
+        FontAtlasCache::deserialize(ImGui::GetIO().Fonts, reader);
+        ImGui_ImplOpenGL3_CreateFontsTexture();
     }
 
     void Window::frameBegin() {
-        glfwPollEvents();
+        // Nothing on screen changes without input or a background task finishing, so the loop sleeps until either happens
+        if (this->m_offscreen)
+            glfwPollEvents();
+        else if (glfwGetWindowAttrib(this->m_window, GLFW_ICONIFIED))
+            glfwWaitEvents();
+        else if (this->m_framesToRender > 0)
+            glfwPollEvents();
+        else
+            glfwWaitEventsTimeout(IdleRedrawInterval);
 
         ImGui_ImplOpenGL3_NewFrame();
+        this->swapFontAtlas();
         ImGui_ImplGlfw_NewFrame();
+
+        if (this->m_inputOverride)
+            this->m_inputOverride(ImGui::GetIO());
+
         ImGui::NewFrame();
 
         ImGuiViewport* viewport = ImGui::GetMainViewport();
@@ -305,6 +659,7 @@ namespace hex {
                 if (ImGui::BeginMenu("hex.menu.view"_lang)) {
                     ImGui::Separator();
                     ImGui::MenuItem("hex.menu.view.fps"_lang, "", &this->m_fpsVisible);
+                    ImGui::MenuItem("hex.menu.view.profiler"_lang, "", &this->m_profilerVisible);
                     #ifdef DEBUG
                         ImGui::MenuItem("hex.menu.view.demo"_lang, "", &this->m_demoWindowOpen);
                     #endif
@@ -373,6 +728,10 @@ namespace hex {
         glfwMakeContextCurrent(backup_current_context);
 
         glfwSwapBuffers(this->m_window);
+
+        // Nothing waits for a hidden window's frame to be shown, without this the GPU's work wouldn't count towards the frame time
+        if (this->m_offscreen)
+            glFinish();
     }
 
     void Window::drawWelcomeScreen() {
@@ -542,7 +901,7 @@ namespace hex {
             glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
         #endif
 
-        if (auto *monitor = glfwGetPrimaryMonitor(); monitor) {
+        if (auto *monitor = glfwGetPrimaryMonitor(); monitor != nullptr && !this->m_offscreen) {
             float xscale, yscale;
             glfwGetMonitorContentScale(monitor, &xscale, &yscale);
 
@@ -554,6 +913,9 @@ namespace hex {
         glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 2);
         glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 
+        if (this->m_offscreen)
+            glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
 
         this->m_window = glfwCreateWindow(1280 * this->m_globalScale, 720 * this->m_globalScale, "ImHex", nullptr, nullptr);
 
@@ -562,7 +924,7 @@ namespace hex {
             throw std::runtime_error("Failed to create window!");
 
         glfwMakeContextCurrent(this->m_window);
-        glfwSwapInterval(1);
+        glfwSwapInterval(this->m_offscreen ? 0 : 1);
 
          {
              int x = 0, y = 0;
@@ -582,6 +944,7 @@ namespace hex {
 
         glfwSetWindowSizeCallback(this->m_window, [](GLFWwindow *window, int width, int height) {
             SharedData::windowSize = ImVec2(width, height);
+            View::requestRedraw();
         });
 
         glfwSetKeyCallback(this->m_window, [](GLFWwindow *window, int key, int scancode, int action, int mods) {
@@ -614,6 +977,9 @@ namespace hex {
         });
 
 
+        SharedData::wakeUpMainLoop = glfwPostEmptyEvent;
+        Profiler::setAllocationCounter(getAllocationCount);
+
         glfwSetWindowSizeLimits(this->m_window, 720, 480, GLFW_DONT_CARE, GLFW_DONT_CARE);
 
         if (gladLoadGL() == 0)
@@ -664,45 +1030,38 @@ namespace hex {
         if (this->m_globalScale != 0.0f)
             style.ScaleAllSizes(this->m_globalScale);
 
-        std::string fontFile;
-        for (const auto &dir : hex::getPath(ImHexPath::Resources)) {
-            fontFile = dir + "/font.ttf";
-            if (std::filesystem::exists(fontFile))
-                break;
-        }
+        {
+            PROFILE_STARTUP("Font atlas");
 
-        if (this->setFont(fontFile)) {
+            std::string fontFile;
+            for (const auto &dir : hex::getPath(ImHexPath::Resources)) {
+                fontFile = dir + "/font.ttf";
+                if (std::filesystem::exists(fontFile))
+                    break;
+            }
 
-        }
-        else {
-            io.Fonts->Clear();
+            if (this->setFont(fontFile)) {
 
-            ImFontConfig cfg;
-            cfg.OversampleH = cfg.OversampleV = 1, cfg.PixelSnapH = true;
-            cfg.SizePixels = 13.0f * this->m_fontScale;
-            io.Fonts->AddFontDefault(&cfg);
+            }
+            else {
+                io.Fonts->Clear();
 
-            cfg.MergeMode = true;
+                ImFontConfig cfg;
+                cfg.OversampleH = cfg.OversampleV = 1, cfg.PixelSnapH = true;
+                cfg.SizePixels = 13.0f * this->m_fontScale;
+                io.Fonts->AddFontDefault(&cfg);
 
-            ImWchar fontAwesomeRange[] = {
-                    ICON_MIN_FA, ICON_MAX_FA,
-                    0
-            };
-            std::uint8_t *px;
-            int w, h;
-            io.Fonts->AddFontFromMemoryCompressedTTF(font_awesome_compressed_data, font_awesome_compressed_size, 13.0f * this->m_fontScale, &cfg, fontAwesomeRange);
-            io.Fonts->GetTexDataAsRGBA32(&px, &w, &h);
-
-            // Create new font atlas
-            GLuint tex;
-            glGenTextures(1, &tex);
-            glBindTexture(GL_TEXTURE_2D, tex);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, w, h, 0, GL_RGBA8, GL_UNSIGNED_INT, px);
-            io.Fonts->SetTexID(reinterpret_cast<ImTextureID>(tex));
-        }
+                cfg.MergeMode = true;
 
+                ImWchar fontAwesomeRange[] = {
+                        ICON_MIN_FA, ICON_MAX_FA,
+                        0
+                };
+                io.Fonts->AddFontFromMemoryCompressedTTF(font_awesome_compressed_data, font_awesome_compressed_size, 13.0f * this->m_fontScale, &cfg, fontAwesomeRange);
+
+                this->uploadFontAtlas();
+            }
+        }
 
         style.WindowMenuButtonPosition = ImGuiDir_None;
         style.IndentSpacing = 10.0F;
@@ -724,7 +1083,7 @@ namespace hex {
                 break;
             }
         }
-        io.IniFilename = iniFileName.c_str();
+        io.IniFilename = this->m_offscreen ? nullptr : iniFileName.c_str();
 
         ImGui_ImplGlfw_InitForOpenGL(this->m_window, true);
         ImGui_ImplOpenGL3_Init("#version 150");
@@ -739,17 +1098,20 @@ namespace hex {
             }
         }
 
-        for (const auto &plugin : PluginHandler::getPlugins()) {
-            plugin.initializePlugin();
-        }
+        PluginHandler::initializePlugins();
     }
 
     void Window::deinitGLFW() {
+        SharedData::wakeUpMainLoop = nullptr;
+
         glfwDestroyWindow(this->m_window);
         glfwTerminate();
     }
 
     void Window::deinitImGui() {
+        this->m_fontAtlasTask.interrupt();
+        this->m_fontAtlasTask.wait();
+
         delete static_cast<ImGui::ImHexCustomData*>(ImGui::GetIO().UserData);
 
         ImGui_ImplOpenGL3_Shutdown();